@@ -4,16 +4,26 @@
 set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/platform.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/threading.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/costmodel.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/tuning.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/qgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/quantize.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/spgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/bqgemm.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/winograd.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/reorder.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/transpose.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/activate.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/erf.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/log.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
 )
 
 if(MSVC)
@@ -35,7 +45,11 @@ if(MSVC)
         COMMAND
             armasm64.exe ${ARMASM_FLAGS} ${pre_filename} ${obj_filename}
     )
-    set(mlas_platform_srcs ${obj_filename})
+    set(mlas_platform_srcs
+      ${obj_filename}
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/sconv_kernel_neon.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/spool_kernel_neon.cpp
+    )
   elseif(CMAKE_GENERATOR_PLATFORM STREQUAL "ARM" OR CMAKE_GENERATOR MATCHES "ARM")
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/arm/sgemmc.cpp
@@ -59,10 +73,13 @@ if(MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SpoolKernelAvx.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SpoolKernelAvx512F.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/sgemma.asm
-      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/cvtfp16a.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm_kernel_f16c.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/bqgemm_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_avx512f.cpp
     )
   else()
     enable_language(ASM_MASM)
@@ -113,6 +130,8 @@ else()
 
     set(mlas_platform_srcs
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/aarch64/SgemmKernelNeon.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/sconv_kernel_neon.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/spool_kernel_neon.cpp
     )
   elseif(X86)
     enable_language(ASM)
@@ -164,6 +183,8 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/bqgemm_kernel_fma3.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
@@ -171,6 +192,7 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SconvKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SpoolKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute_kernel_avx512f.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -180,16 +202,37 @@ else()
     )
     set_source_files_properties(${mlas_platform_srcs_avx512bw} PROPERTIES COMPILE_FLAGS "-mavx512bw")
 
+    set(mlas_platform_srcs_f16c
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm_kernel_f16c.cpp
+    )
+    set_source_files_properties(${mlas_platform_srcs_f16c} PROPERTIES COMPILE_FLAGS "-mavx -mf16c")
+
+    # The AVX512_BF16 intrinsics require a recent compiler, so the BF16 GEMM
+    # kernel is only built if the compiler supports them.
+    include(CheckCXXCompilerFlag)
+    check_cxx_compiler_flag("-mavx512bf16" HAS_AVX512BF16)
+    if(HAS_AVX512BF16)
+      set(mlas_platform_srcs_avx512bf16
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/halfgemm_kernel_avx512bf16.cpp
+      )
+      set_source_files_properties(${mlas_platform_srcs_avx512bf16} PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bf16")
+    endif()
+
     set(mlas_platform_srcs
       ${mlas_platform_srcs_sse2}
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
       ${mlas_platform_srcs_avx512f}
       ${mlas_platform_srcs_avx512bw}
+      ${mlas_platform_srcs_f16c}
+      ${mlas_platform_srcs_avx512bf16}
     )
   endif()
 endif()
 
 add_library(onnxruntime_mlas STATIC ${mlas_common_srcs} ${mlas_platform_srcs})
 target_include_directories(onnxruntime_mlas PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc ${ONNXRUNTIME_ROOT}/core/mlas/lib ${eigen_INCLUDE_DIRS})
+if(HAS_AVX512BF16)
+  target_compile_definitions(onnxruntime_mlas PRIVATE MLAS_AVX512BF16_INTRINSICS)
+endif()
 set_target_properties(onnxruntime_mlas PROPERTIES FOLDER "ONNXRuntime")
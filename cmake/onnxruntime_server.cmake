@@ -50,7 +50,7 @@ set(_GRPC_PY_PLUGIN_EXECUTABLE $<TARGET_FILE:grpc_python_plugin>)
 
 
 # Generate .h and .cc files from protobuf file
-add_library(server_proto ${ONNXRUNTIME_ROOT}/server/protobuf/predict.proto ${ONNXRUNTIME_ROOT}/server/protobuf/onnx-ml.proto)
+add_library(server_proto ${ONNXRUNTIME_ROOT}/server/protobuf/predict.proto ${ONNXRUNTIME_ROOT}/server/protobuf/embedding.proto ${ONNXRUNTIME_ROOT}/server/protobuf/onnx-ml.proto)
 if(WIN32)
   target_compile_options(server_proto PRIVATE "/wd4125" "/wd4456")
 endif()
@@ -61,6 +61,7 @@ add_dependencies(server_proto ${onnxruntime_EXTERNAL_DEPENDENCIES})
 if(NOT WIN32)
   if(HAS_UNUSED_PARAMETER)
      set_source_files_properties(${CMAKE_CURRENT_BINARY_DIR}/predict.pb.cc PROPERTIES COMPILE_FLAGS -Wno-unused-parameter)
+     set_source_files_properties(${CMAKE_CURRENT_BINARY_DIR}/embedding.pb.cc PROPERTIES COMPILE_FLAGS -Wno-unused-parameter)
      set_source_files_properties(${CMAKE_CURRENT_BINARY_DIR}/onnx-ml.pb.cc PROPERTIES COMPILE_FLAGS -Wno-unused-parameter)
   endif()
 endif()
@@ -72,23 +73,29 @@ set(SPDLOG_BUILD_EXAMPLES OFF)
 add_subdirectory(${REPO_ROOT}/cmake/external/spdlog)
 
 # Generate GRPC service source and headers.
-get_filename_component(grpc_proto "${ONNXRUNTIME_ROOT}/server/protobuf/prediction_service.proto" ABSOLUTE)
-get_filename_component(grpc_proto_path "${grpc_proto}" PATH)
-
-set(grpc_srcs "${CMAKE_CURRENT_BINARY_DIR}/prediction_service.grpc.pb.cc")
-set(grpc_hdrs "${CMAKE_CURRENT_BINARY_DIR}/prediction_service.grpc.pb.h")
-add_custom_command(
-      OUTPUT "${grpc_srcs}" "${grpc_hdrs}"
-      COMMAND $<TARGET_FILE:protobuf::protoc>
-      ARGS 
-        --cpp_out "${CMAKE_CURRENT_BINARY_DIR}"
-        --grpc_out "${CMAKE_CURRENT_BINARY_DIR}"
-        --plugin=protoc-gen-grpc="${_GRPC_CPP_PLUGIN_EXECUTABLE}"
-        -I ${grpc_proto_path}
-        "${grpc_proto}"
-      DEPENDS "${grpc_proto}" ${_GRPC_CPP_PLUGIN_EXECUTABLE}
-      COMMENT "Running ${_GRPC_CPP_PLUGIN_EXECUTABLE} on ${grpc_proto}"
-    )
+set(grpc_srcs)
+set(grpc_hdrs)
+foreach(grpc_service prediction_service embedding_service)
+  get_filename_component(grpc_proto "${ONNXRUNTIME_ROOT}/server/protobuf/${grpc_service}.proto" ABSOLUTE)
+  get_filename_component(grpc_proto_path "${grpc_proto}" PATH)
+
+  set(grpc_service_src "${CMAKE_CURRENT_BINARY_DIR}/${grpc_service}.grpc.pb.cc")
+  set(grpc_service_hdr "${CMAKE_CURRENT_BINARY_DIR}/${grpc_service}.grpc.pb.h")
+  add_custom_command(
+        OUTPUT "${grpc_service_src}" "${grpc_service_hdr}"
+        COMMAND $<TARGET_FILE:protobuf::protoc>
+        ARGS 
+          --cpp_out "${CMAKE_CURRENT_BINARY_DIR}"
+          --grpc_out "${CMAKE_CURRENT_BINARY_DIR}"
+          --plugin=protoc-gen-grpc="${_GRPC_CPP_PLUGIN_EXECUTABLE}"
+          -I ${grpc_proto_path}
+          "${grpc_proto}"
+        DEPENDS "${grpc_proto}" ${_GRPC_CPP_PLUGIN_EXECUTABLE}
+        COMMENT "Running ${_GRPC_CPP_PLUGIN_EXECUTABLE} on ${grpc_proto}"
+      )
+  list(APPEND grpc_srcs "${grpc_service_src}")
+  list(APPEND grpc_hdrs "${grpc_service_hdr}")
+endforeach()
 
 add_library(server_grpc_proto ${grpc_srcs})
 target_include_directories(server_grpc_proto PUBLIC $<TARGET_PROPERTY:protobuf::libprotobuf,INTERFACE_INCLUDE_DIRECTORIES> "${CMAKE_CURRENT_BINARY_DIR}" ${CMAKE_CURRENT_BINARY_DIR}/onnx PRIVATE)
@@ -110,15 +117,29 @@ endif()
 # Setup source code
 set(onnxruntime_server_lib_srcs
   "${ONNXRUNTIME_ROOT}/server/http/json_handling.cc"
+  "${ONNXRUNTIME_ROOT}/server/http/metrics_handler.cc"
+  "${ONNXRUNTIME_ROOT}/server/http/model_control_handler.cc"
   "${ONNXRUNTIME_ROOT}/server/http/predict_request_handler.cc"
   "${ONNXRUNTIME_ROOT}/server/http/util.cc"
+  "${ONNXRUNTIME_ROOT}/server/admission.cc"
+  "${ONNXRUNTIME_ROOT}/server/batcher.cc"
   "${ONNXRUNTIME_ROOT}/server/environment.cc"
   "${ONNXRUNTIME_ROOT}/server/executor.cc"
+  "${ONNXRUNTIME_ROOT}/server/metrics.cc"
+  "${ONNXRUNTIME_ROOT}/server/model_repository.cc"
+  "${ONNXRUNTIME_ROOT}/server/response_cache.cc"
+  "${ONNXRUNTIME_ROOT}/server/shared_memory.cc"
+  "${ONNXRUNTIME_ROOT}/server/tracing.cc"
   "${ONNXRUNTIME_ROOT}/server/converter.cc"
+  "${ONNXRUNTIME_ROOT}/server/embedding_shard.cc"
+  "${ONNXRUNTIME_ROOT}/server/remote_embedding.cc"
   "${ONNXRUNTIME_ROOT}/server/util.cc"
   "${ONNXRUNTIME_ROOT}/server/core/request_id.cc"
   "${ONNXRUNTIME_ROOT}/server/grpc/prediction_service_impl.cc"
+  "${ONNXRUNTIME_ROOT}/server/grpc/embedding_client.cc"
+  "${ONNXRUNTIME_ROOT}/server/grpc/embedding_service_impl.cc"
   "${ONNXRUNTIME_ROOT}/server/grpc/grpc_app.cc"
+  "${ONNXRUNTIME_ROOT}/server/serializing/raw_tensors.cc"
   "${ONNXRUNTIME_ROOT}/server/serializing/tensorprotoutils.cc"
   )
 if(NOT WIN32)
@@ -178,6 +199,11 @@ target_link_libraries(onnxruntime_server_lib PRIVATE
   onnxruntime
 )
 
+# shm_open of the shared memory regions is in librt on older glibc
+if (UNIX AND NOT APPLE)
+  target_link_libraries(onnxruntime_server_lib PUBLIC rt)
+endif()
+
 if (onnxruntime_USE_SYSLOG)
   target_compile_definitions(onnxruntime_server_lib PUBLIC USE_SYSLOG="1")
 endif()
@@ -540,7 +540,11 @@ install(TARGETS onnx_test_runner
         RUNTIME  DESTINATION ${CMAKE_INSTALL_BINDIR})
 
 if(onnxruntime_BUILD_BENCHMARKS)
-  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc)
+  add_executable(onnxruntime_benchmark
+    ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/mlas.cc
+    ${TEST_SRC_DIR}/onnx/microbenchmark/cpu_kernels.cc)
   target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} benchmark)
   onnxruntime_add_include_to_target(onnxruntime_benchmark gsl)
   if(WIN32)
@@ -745,3 +749,8 @@ endif()
 list(APPEND onnxruntime_mlas_test_libs Threads::Threads)
 target_link_libraries(onnxruntime_mlas_test PRIVATE ${onnxruntime_mlas_test_libs})
 set_target_properties(onnxruntime_mlas_test PROPERTIES FOLDER "ONNXRuntimeTest")
+
+add_executable(onnxruntime_mlas_tuning ${TEST_SRC_DIR}/mlas/tuning.cpp)
+target_include_directories(onnxruntime_mlas_tuning PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc)
+target_link_libraries(onnxruntime_mlas_tuning PRIVATE ${onnxruntime_mlas_test_libs})
+set_target_properties(onnxruntime_mlas_tuning PROPERTIES FOLDER "ONNXRuntimeTest")
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+using Microsoft.ML.OnnxRuntime.Tensors;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// A tensor whose managed buffer stays pinned, and whose native value is created once, for as long as it lives.
+    /// Passing it to InferenceSession.Run() repeatedly neither pins nor wraps the buffer again, and an output written to
+    /// it by a run lands directly in the buffer. The buffer must not be modified while a run uses it.
+    /// </summary>
+    public class FixedBufferOnnxValue : IDisposable
+    {
+        private IntPtr _nativeValue;
+        private MemoryHandle _pinnedMemory;
+
+        internal IntPtr Value
+        {
+            get
+            {
+                if (_nativeValue == IntPtr.Zero)
+                {
+                    throw new ObjectDisposedException(nameof(FixedBufferOnnxValue));
+                }
+                return _nativeValue;
+            }
+        }
+
+        private FixedBufferOnnxValue(IntPtr nativeValue, MemoryHandle pinnedMemory)
+        {
+            _nativeValue = nativeValue;
+            _pinnedMemory = pinnedMemory;
+        }
+
+        /// <summary>
+        /// Creates a value over the buffer of a DenseTensor without copying it. Other tensors are copied once into a
+        /// dense buffer, so only a DenseTensor can receive an output.
+        /// </summary>
+        /// <typeparam name="T">Type of the tensor elements</typeparam>
+        /// <param name="value"></param>
+        public static FixedBufferOnnxValue CreateFromTensor<T>(Tensor<T> value)
+        {
+            IntPtr nativeValue;
+            MemoryHandle pinnedMemory;
+            NamedOnnxValue.CreateFromTensor(string.Empty, value).ToNativeOnnxValue(out nativeValue, out pinnedMemory);
+            return new FixedBufferOnnxValue(nativeValue, pinnedMemory);
+        }
+
+        /// <summary>
+        /// Creates a value over <paramref name="memory"/> without copying it.
+        /// </summary>
+        /// <typeparam name="T">Type of the tensor elements</typeparam>
+        /// <param name="memory">the tensor elements, in row-major order</param>
+        /// <param name="dimensions">the tensor shape</param>
+        public static FixedBufferOnnxValue CreateFromMemory<T>(Memory<T> memory, ReadOnlySpan<int> dimensions)
+        {
+            return CreateFromTensor(new DenseTensor<T>(memory, dimensions));
+        }
+
+        #region destructors disposers
+
+        ~FixedBufferOnnxValue()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            // release the native value before unpinning the buffer it refers to
+            if (_nativeValue != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseValue(_nativeValue);
+                _nativeValue = IntPtr.Zero;
+                _pinnedMemory.Dispose();
+            }
+        }
+
+        #endregion
+    }
+}
@@ -6,6 +6,7 @@ using System.Runtime.InteropServices;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Threading.Tasks;
 
 
 namespace Microsoft.ML.OnnxRuntime
@@ -169,6 +170,277 @@ namespace Microsoft.ML.OnnxRuntime
 
         }
 
+        /// <summary>
+        /// Runs the loaded model for each of several sets of inputs in one native call, and fetches the outputs specified
+        /// in <paramref name="outputNames"/> for each set. If dimension 0 of the inputs and outputs is symbolic in the model,
+        /// the sets are run as one batch, concatenated along dimension 0, whose outputs are split back into the sets.
+        /// This assumes the rows of a batch are computed independently of each other. Otherwise the sets are run one after the other.
+        /// </summary>
+        /// <param name="inputSets">sets of inputs, which all have the same names</param>
+        /// <param name="outputNames"></param>
+        /// <returns>Output Tensors of each set, in the order of <paramref name="inputSets"/>. User must dispose the output.</returns>
+        public IReadOnlyList<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunMany(IReadOnlyList<IReadOnlyCollection<NamedOnnxValue>> inputSets, IReadOnlyCollection<string> outputNames)
+        {
+            return RunMany(inputSets, outputNames, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for each of several sets of inputs in one native call, and fetches the outputs specified
+        /// in <paramref name="outputNames"/> for each set. Uses the given RunOptions for the runs.
+        /// </summary>
+        /// <param name="inputSets">sets of inputs, which all have the same names</param>
+        /// <param name="outputNames"></param>
+        /// <param name="options"></param>
+        /// <returns>Output Tensors of each set, in the order of <paramref name="inputSets"/>. User must dispose the output.</returns>
+        public IReadOnlyList<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunMany(IReadOnlyList<IReadOnlyCollection<NamedOnnxValue>> inputSets, IReadOnlyCollection<string> outputNames, RunOptions options)
+        {
+            if (inputSets.Count == 0)
+            {
+                return new List<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>();
+            }
+
+            // the names of the first set give the order of the inputs of every set
+            var inputNames = new string[inputSets[0].Count];
+            int inputIndex = 0;
+            foreach (var input in inputSets[0])
+            {
+                inputNames[inputIndex++] = input.Name;
+            }
+
+            int inputCount = inputNames.Length;
+            var inputTensors = new IntPtr[inputSets.Count * inputCount];
+            var pinnedBufferHandles = new System.Buffers.MemoryHandle[inputTensors.Length];
+            string[] outputNamesArray = outputNames.ToArray();
+            IntPtr[] outputValueArray = new IntPtr[inputSets.Count * outputNamesArray.Length];
+
+            try
+            {
+                for (int s = 0; s < inputSets.Count; s++)
+                {
+                    if (inputSets[s].Count != inputCount)
+                    {
+                        throw new ArgumentException($"Input set {s} has {inputSets[s].Count} inputs, but the first set has {inputCount}.");
+                    }
+                    foreach (var input in inputSets[s])
+                    {
+                        inputIndex = Array.IndexOf(inputNames, input.Name);
+                        if (inputIndex < 0)
+                        {
+                            throw new ArgumentException($"Input set {s} has input {input.Name}, which the first set doesn't have.");
+                        }
+                        int offset = s * inputCount + inputIndex;
+                        input.ToNativeOnnxValue(out inputTensors[offset], out pinnedBufferHandles[offset]);
+                    }
+                }
+
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtRunMany(
+                                                this._nativeHandle,
+                                                options.Handle,
+                                                inputNames,
+                                                inputTensors,
+                                                (UIntPtr)inputCount,
+                                                (UIntPtr)inputSets.Count,
+                                                outputNamesArray,
+                                                (UIntPtr)outputNamesArray.Length,
+                                                outputValueArray));
+
+                var results = new List<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>(inputSets.Count);
+                int outputIndex = 0;
+                try
+                {
+                    for (int s = 0; s < inputSets.Count; s++)
+                    {
+                        var result = new DisposableList<DisposableNamedOnnxValue>();
+                        results.Add(result);
+                        for (int i = 0; i < outputNamesArray.Length; i++, outputIndex++)
+                        {
+                            result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(outputNamesArray[i], outputValueArray[outputIndex]));
+                        }
+                    }
+                }
+                catch (Exception)
+                {
+                    foreach (var result in results)
+                    {
+                        result.Dispose();
+                    }
+                    // release the outputs that weren't taken over by the results
+                    for (; outputIndex < outputValueArray.Length; outputIndex++)
+                    {
+                        NativeMethods.OrtReleaseValue(outputValueArray[outputIndex]);
+                    }
+                    throw;
+                }
+
+                return results;
+            }
+            finally
+            {
+                // always unpin the input buffers, and delete the native Onnx value objects
+                for (int i = 0; i < inputTensors.Length; i++)
+                {
+                    if (inputTensors[i] != IntPtr.Zero)
+                    {
+                        NativeMethods.OrtReleaseValue(inputTensors[i]);
+                    }
+                    pinnedBufferHandles[i].Dispose();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs, and writes the outputs into the given preallocated values.
+        /// The values are pinned and wrapped once when created, so a run allocates no managed memory.
+        /// </summary>
+        /// <param name="inputNames"></param>
+        /// <param name="inputValues">the values of the inputs, in the order of <paramref name="inputNames"/></param>
+        /// <param name="outputNames"></param>
+        /// <param name="outputValues">the values the outputs are written to, in the order of <paramref name="outputNames"/></param>
+        public void Run(string[] inputNames, FixedBufferOnnxValue[] inputValues, string[] outputNames, FixedBufferOnnxValue[] outputValues)
+        {
+            Run(inputNames, inputValues, outputNames, outputValues, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs, and writes the outputs into the given preallocated values.
+        /// Uses the given RunOptions for this run.
+        /// </summary>
+        /// <param name="inputNames"></param>
+        /// <param name="inputValues">the values of the inputs, in the order of <paramref name="inputNames"/></param>
+        /// <param name="outputNames"></param>
+        /// <param name="outputValues">the values the outputs are written to, in the order of <paramref name="outputNames"/></param>
+        /// <param name="options"></param>
+        public void Run(string[] inputNames, FixedBufferOnnxValue[] inputValues, string[] outputNames, FixedBufferOnnxValue[] outputValues, RunOptions options)
+        {
+            if (inputNames.Length != inputValues.Length)
+            {
+                throw new ArgumentException($"Length of {nameof(inputNames)} ({inputNames.Length}) must match that of {nameof(inputValues)} ({inputValues.Length}).");
+            }
+            if (outputNames.Length != outputValues.Length)
+            {
+                throw new ArgumentException($"Length of {nameof(outputNames)} ({outputNames.Length}) must match that of {nameof(outputValues)} ({outputValues.Length}).");
+            }
+
+            unsafe
+            {
+                IntPtr* inputTensors = stackalloc IntPtr[inputValues.Length];
+                for (int i = 0; i < inputValues.Length; i++)
+                {
+                    inputTensors[i] = inputValues[i].Value;
+                }
+                IntPtr* outputTensors = stackalloc IntPtr[outputValues.Length];
+                for (int i = 0; i < outputValues.Length; i++)
+                {
+                    outputTensors[i] = outputValues[i].Value;
+                }
+
+                // the outputs are preallocated, so the run writes into them rather than returning new values
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtRun(
+                                                this._nativeHandle,
+                                                options.Handle,
+                                                inputNames,
+                                                inputTensors,
+                                                (UIntPtr)inputValues.Length,
+                                                outputNames,
+                                                (UIntPtr)outputValues.Length,
+                                                outputTensors));
+            }
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs without blocking, and fetches the outputs specified in <paramref name="outputNames"/>.
+        /// </summary>
+        /// <param name="inputs"></param>
+        /// <param name="outputNames"></param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames)
+        {
+            // the native default options live as long as the library, whereas the built-in ones are disposed with the session
+            return RunAsync(inputs, outputNames, null);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs without blocking, and fetches the specified outputs in <paramref name="outputNames"/>. Uses the given RunOptions for this run.
+        /// The RunOptions must not be disposed until the returned task completes.
+        /// </summary>
+        /// <param name="inputs"></param>
+        /// <param name="outputNames"></param>
+        /// <param name="options"></param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames, RunOptions options)
+        {
+            var inputNames = new string[inputs.Count];
+            var inputTensors = new IntPtr[inputs.Count];
+            var state = new RunAsyncState(outputNames.ToArray(), inputs.Count, options);
+
+            int inputIndex = 0;
+            foreach (var input in inputs)
+            {
+                inputNames[inputIndex] = input.Name;
+                input.ToNativeOnnxValue(out inputTensors[inputIndex], out state.PinnedBufferHandles[inputIndex]);
+                inputIndex++;
+            }
+
+            GCHandle stateHandle = GCHandle.Alloc(state);
+            IntPtr status = NativeMethods.OrtRunAsync(
+                                                this._nativeHandle,
+                                                options == null ? IntPtr.Zero : options.Handle,
+                                                inputNames,
+                                                inputTensors,
+                                                (UIntPtr)(inputTensors.Length),
+                                                state.OutputNames,
+                                                (UIntPtr)state.OutputNames.Length,
+                                                s_runAsyncCallback,
+                                                GCHandle.ToIntPtr(stateHandle));
+
+            // the run holds on to the native tensors, but the buffers they refer to stay pinned until it completes
+            for (int i = 0; i < inputTensors.Length; i++)
+            {
+                NativeMethods.OrtReleaseValue(inputTensors[i]);
+            }
+
+            try
+            {
+                NativeApiStatus.VerifySuccess(status);
+            }
+            catch (OnnxRuntimeException)
+            {
+                stateHandle.Free();
+                state.UnpinInputs();
+                throw;
+            }
+
+            return state.Completion.Task;
+        }
+
+        /// <summary>
+        /// Creates an OrtIoBinding for this session, to bind inputs and outputs once and run repeatedly without copying them.
+        /// </summary>
+        /// <returns>The binding. User must dispose it before the session.</returns>
+        public OrtIoBinding CreateIoBinding()
+        {
+            return new OrtIoBinding(_nativeHandle);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound to <paramref name="ioBinding"/>.
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        public void RunWithBinding(OrtIoBinding ioBinding)
+        {
+            RunWithBinding(ioBinding, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model with the inputs and outputs bound to <paramref name="ioBinding"/>. Uses the given RunOptions for this run.
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        /// <param name="options"></param>
+        public void RunWithBinding(OrtIoBinding ioBinding, RunOptions options)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRunWithBinding(_nativeHandle, options.Handle, ioBinding.Handle));
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -182,6 +454,77 @@ namespace Microsoft.ML.OnnxRuntime
 
         #region private methods
 
+        // What a run enqueued by RunAsync needs until it completes.
+        private class RunAsyncState
+        {
+            public readonly string[] OutputNames;
+            public readonly System.Buffers.MemoryHandle[] PinnedBufferHandles;
+            public readonly RunOptions Options;  // keeps the native options alive
+            public readonly TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> Completion =
+                new TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>();
+
+            public RunAsyncState(string[] outputNames, int inputCount, RunOptions options)
+            {
+                OutputNames = outputNames;
+                PinnedBufferHandles = new System.Buffers.MemoryHandle[inputCount];
+                Options = options;
+            }
+
+            public void UnpinInputs()
+            {
+                foreach (var handle in PinnedBufferHandles)
+                {
+                    handle.Dispose();
+                }
+            }
+        }
+
+        // kept in a static field so that the delegate the native callbacks go through is never collected
+        private static readonly NativeMethods.DOrtRunAsyncCallback s_runAsyncCallback = OnRunAsyncCompleted;
+
+        private static void OnRunAsyncCompleted(IntPtr userData, IntPtr outputValues, UIntPtr outputCount, IntPtr status)
+        {
+            GCHandle stateHandle = GCHandle.FromIntPtr(userData);
+            var state = (RunAsyncState)stateHandle.Target;
+            stateHandle.Free();
+            state.UnpinInputs();
+
+            var result = new DisposableList<DisposableNamedOnnxValue>();
+            Exception error = null;
+            try
+            {
+                NativeApiStatus.VerifySuccess(status);
+                for (int i = 0; i < (int)outputCount; i++)
+                {
+                    IntPtr value = Marshal.ReadIntPtr(outputValues, i * IntPtr.Size);
+                    result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(state.OutputNames[i], value));
+                }
+            }
+            catch (Exception e)
+            {
+                // release the outputs that weren't taken over by the result
+                for (int i = result.Count; i < (int)outputCount; i++)
+                {
+                    NativeMethods.OrtReleaseValue(Marshal.ReadIntPtr(outputValues, i * IntPtr.Size));
+                }
+                result.Dispose();
+                error = e;
+            }
+
+            // complete the task on the thread pool, so that continuations don't run on, and block, a thread of the session
+            Task.Run(() =>
+            {
+                if (error != null)
+                {
+                    state.Completion.SetException(error);
+                }
+                else
+                {
+                    state.Completion.SetResult(result);
+                }
+            });
+        }
+
         protected void Init(string modelPath, SessionOptions options)
         {
             var envHandle = OnnxRuntime.Handle;
@@ -28,6 +28,19 @@ namespace Microsoft.ML.OnnxRuntime
             return new NamedOnnxValue(name, value); 
         }
 
+        /// <summary>
+        /// Creates a tensor value over <paramref name="memory"/> without copying it. The memory is pinned only while a run
+        /// uses it, so it must not be modified until the run completes.
+        /// </summary>
+        /// <typeparam name="T">Type of the tensor elements</typeparam>
+        /// <param name="name">input or output name</param>
+        /// <param name="memory">the tensor elements, in row-major order</param>
+        /// <param name="dimensions">the tensor shape</param>
+        public static NamedOnnxValue CreateFromMemory<T>(string name, Memory<T> memory, ReadOnlySpan<int> dimensions)
+        {
+            return new NamedOnnxValue(name, new DenseTensor<T>(memory, dimensions));
+        }
+
         public string Name { get { return _name; } }
 
         /// <summary>
@@ -65,6 +65,52 @@ namespace Microsoft.ML.OnnxRuntime
                                                 IntPtr[] outputValues /* An array of output value pointers. Array must be allocated by the caller */
                                                 );
 
+        // takes the values as pointers, so that the caller can pass them in stack memory
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern unsafe IntPtr /*(ONNStatus*)*/ OrtRun(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr* /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                IntPtr* /* (OrtValue*[])*/ outputValues
+                                                );
+
+        // called on a thread of the session when a run enqueued by OrtRunAsync completes
+        [UnmanagedFunctionPointer(CallingConvention.Winapi)]
+        public delegate void DOrtRunAsyncCallback(
+                                                IntPtr /*(void*)*/ userData,
+                                                IntPtr /*(OrtValue**)*/ outputValues,  // null if the run failed
+                                                UIntPtr outputCount,
+                                                IntPtr /*(OrtStatus*)*/ status);  // null if the run succeeded
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtRunAsync(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                DOrtRunAsyncCallback callback,
+                                                IntPtr /*(void*)*/ userData);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtRunMany(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,  // inputCount values per run, run after run
+                                                UIntPtr inputCount,
+                                                UIntPtr runCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                [Out] IntPtr[] /* (OrtValue*[])*/ outputValues  // outputCount values per run, run after run
+                                                );
+
 
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern IntPtr /*(OrtStatus*)*/ OrtSessionGetInputCount(
@@ -113,6 +159,60 @@ namespace Microsoft.ML.OnnxRuntime
 
         #endregion InferenceSession API
 
+        #region IoBinding API
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtCreateIoBinding(IntPtr /*(OrtSession*)*/ session, out IntPtr /*(OrtIoBinding**)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern void OrtReleaseIoBinding(IntPtr /*(OrtIoBinding*)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingBindInput(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtValue*)*/ value);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingBindOutput(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtValue*)*/ value);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingBindOutputToDevice(IntPtr /*(OrtIoBinding*)*/ binding, string name, IntPtr /*(const OrtMemoryInfo*)*/ memoryInfo);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingSynchronizeInputs(IntPtr /*(OrtIoBinding*)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingSynchronizeOutputs(IntPtr /*(OrtIoBinding*)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingClearInputs(IntPtr /*(OrtIoBinding*)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingClearOutputs(IntPtr /*(OrtIoBinding*)*/ binding);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingGetOutputCount(IntPtr /*(const OrtIoBinding*)*/ binding, out UIntPtr count);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingGetOutputName(
+                                                IntPtr /*(const OrtIoBinding*)*/ binding,
+                                                UIntPtr index,
+                                                IntPtr /*(OrtAllocator*)*/ allocator,
+                                                out IntPtr /*(char**)*/ name);
+
+        // release the value using OrtReleaseValue
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtIoBindingGetOutputValue(
+                                                IntPtr /*(const OrtIoBinding*)*/ binding,
+                                                UIntPtr index,
+                                                out IntPtr /*(OrtValue**)*/ value);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtRunWithBinding(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                IntPtr /*(OrtIoBinding*)*/ binding);
+
+        #endregion IoBinding API
+
         #region SessionOptions API
 
         [DllImport(nativeLib, CharSet = charSet)]
@@ -163,6 +263,21 @@ namespace Microsoft.ML.OnnxRuntime
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionThreadPoolSize(IntPtr /* OrtSessionOptions* */ options, int sessionThreadPoolSize);
 
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionInterOpThreadPoolSize(IntPtr /* OrtSessionOptions* */ options, int interOpThreadPoolSize);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionThreadPoolAffinity(IntPtr /* OrtSessionOptions* */ options, UIntPtr[] /* const size_t* */ logicalProcessors, UIntPtr /* size_t */ count);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionInterOpThreadPoolAffinity(IntPtr /* OrtSessionOptions* */ options, UIntPtr[] /* const size_t* */ logicalProcessors, UIntPtr /* size_t */ count);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionThreadPoolNumaNode(IntPtr /* OrtSessionOptions* */ options, int numaNode);
+
+        [DllImport(nativeLib, CharSet = charSet)]
+        public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionInterOpThreadPoolNumaNode(IntPtr /* OrtSessionOptions* */ options, int numaNode);
+
         [DllImport(nativeLib, CharSet = charSet)]
         public static extern IntPtr /*(OrtStatus*)*/ OrtSetSessionGraphOptimizationLevel(IntPtr /* OrtSessionOptions* */ options, GraphOptimizationLevel graphOptimizationLevel);
 
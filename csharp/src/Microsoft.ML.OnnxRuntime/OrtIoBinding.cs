@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// Binds inputs and outputs to an InferenceSession, so that repeated runs reuse them without copying.
+    /// Outputs can be bound to a device, in which case they are allocated on that device by each run and are not
+    /// copied to CPU. Create it with InferenceSession.CreateIoBinding() and run it with InferenceSession.RunWithBinding().
+    /// </summary>
+    public class OrtIoBinding : IDisposable
+    {
+        private IntPtr _nativePtr;
+        // the native values of the bound inputs and outputs refer to the pinned managed buffers, so both are kept until cleared
+        private List<IntPtr> _inputValues = new List<IntPtr>();
+        private List<MemoryHandle> _inputHandles = new List<MemoryHandle>();
+        private List<IntPtr> _outputValues = new List<IntPtr>();
+        private List<MemoryHandle> _outputHandles = new List<MemoryHandle>();
+
+        internal IntPtr Handle
+        {
+            get
+            {
+                return _nativePtr;
+            }
+        }
+
+        internal OrtIoBinding(IntPtr session)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateIoBinding(session, out _nativePtr));
+        }
+
+        /// <summary>
+        /// Binds an input. The value is copied to the device the input is consumed on, if needed.
+        /// </summary>
+        /// <param name="input"></param>
+        public void BindInput(NamedOnnxValue input)
+        {
+            IntPtr value;
+            MemoryHandle pinnedHandle;
+            input.ToNativeOnnxValue(out value, out pinnedHandle);
+            _inputValues.Add(value);
+            _inputHandles.Add(pinnedHandle);
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingBindInput(_nativePtr, input.Name, value));
+        }
+
+        /// <summary>
+        /// Binds an output to a preallocated tensor, which each run writes into.
+        /// </summary>
+        /// <param name="output"></param>
+        public void BindOutput(NamedOnnxValue output)
+        {
+            IntPtr value;
+            MemoryHandle pinnedHandle;
+            output.ToNativeOnnxValue(out value, out pinnedHandle);
+            _outputValues.Add(value);
+            _outputHandles.Add(pinnedHandle);
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingBindOutput(_nativePtr, output.Name, value));
+        }
+
+        /// <summary>
+        /// Binds an input to a fixed buffer value, which stays owned by the caller and must outlive the binding.
+        /// </summary>
+        /// <param name="name">input name</param>
+        /// <param name="input"></param>
+        public void BindInput(string name, FixedBufferOnnxValue input)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingBindInput(_nativePtr, name, input.Value));
+        }
+
+        /// <summary>
+        /// Binds an output to a fixed buffer value, which each run writes into. The value stays owned by the caller and
+        /// must outlive the binding.
+        /// </summary>
+        /// <param name="name">output name</param>
+        /// <param name="output"></param>
+        public void BindOutput(string name, FixedBufferOnnxValue output)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingBindOutput(_nativePtr, name, output.Value));
+        }
+
+        /// <summary>
+        /// Binds an output to a device, e.g. "Cpu" or "Cuda". The output is allocated on the device by each run.
+        /// </summary>
+        /// <param name="name">output name</param>
+        /// <param name="deviceName">name of the device allocator, "Cpu" or "Cuda"</param>
+        /// <param name="deviceId">id of the device</param>
+        public void BindOutputToDevice(string name, string deviceName = "Cpu", int deviceId = 0)
+        {
+            IntPtr deviceNamePtr = Marshal.StringToHGlobalAnsi(deviceName);
+            IntPtr memoryInfo = IntPtr.Zero;
+            try
+            {
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateAllocatorInfo(deviceNamePtr,
+                                                                                   NativeMethods.AllocatorType.DeviceAllocator,
+                                                                                   deviceId,
+                                                                                   NativeMethods.MemoryType.Default,
+                                                                                   out memoryInfo));
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingBindOutputToDevice(_nativePtr, name, memoryInfo));
+            }
+            finally
+            {
+                if (memoryInfo != IntPtr.Zero)
+                {
+                    NativeMethods.OrtReleaseMemoryInfo(memoryInfo);
+                }
+                Marshal.FreeHGlobal(deviceNamePtr);
+            }
+        }
+
+        public void SynchronizeInputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingSynchronizeInputs(_nativePtr));
+        }
+
+        public void SynchronizeOutputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingSynchronizeOutputs(_nativePtr));
+        }
+
+        public void ClearInputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingClearInputs(_nativePtr));
+            ReleaseValues(_inputValues, _inputHandles);
+        }
+
+        public void ClearOutputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingClearOutputs(_nativePtr));
+            ReleaseValues(_outputValues, _outputHandles);
+        }
+
+        /// <summary>
+        /// Returns the outputs of the last run. Only outputs in CPU memory can be read from the returned values.
+        /// </summary>
+        /// <returns>Output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public IDisposableReadOnlyCollection<DisposableNamedOnnxValue> GetOutputValues()
+        {
+            UIntPtr count;
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingGetOutputCount(_nativePtr, out count));
+
+            var result = new DisposableList<DisposableNamedOnnxValue>();
+            try
+            {
+                for (ulong i = 0; i < (ulong)count; i++)
+                {
+                    string name = GetOutputName(i);
+                    IntPtr value;
+                    NativeApiStatus.VerifySuccess(NativeMethods.OrtIoBindingGetOutputValue(_nativePtr, (UIntPtr)i, out value));
+                    result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(name, value));
+                }
+            }
+            catch (OnnxRuntimeException e)
+            {
+                result.Dispose();
+                throw e;
+            }
+            return result;
+        }
+
+        private string GetOutputName(ulong index)
+        {
+            IntPtr nameHandle = IntPtr.Zero;
+            string str = null;
+
+            IntPtr status = NativeMethods.OrtIoBindingGetOutputName(
+                                                _nativePtr,
+                                                (UIntPtr)index,
+                                                NativeMemoryAllocator.DefaultInstance.Handle,
+                                                out nameHandle);
+            try
+            {
+                NativeApiStatus.VerifySuccess(status);
+                str = Marshal.PtrToStringAnsi(nameHandle); //assumes charset = ANSI
+            }
+            finally
+            {
+                if (nameHandle != IntPtr.Zero)
+                {
+                    NativeMemoryAllocator.DefaultInstance.FreeMemory(nameHandle);
+                }
+            }
+
+            return str;
+        }
+
+        private static void ReleaseValues(List<IntPtr> values, List<MemoryHandle> handles)
+        {
+            foreach (var value in values)
+            {
+                NativeMethods.OrtReleaseValue(value);
+            }
+            foreach (var handle in handles)
+            {
+                handle.Dispose();
+            }
+            values.Clear();
+            handles.Clear();
+        }
+
+        #region destructors disposers
+
+        ~OrtIoBinding()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            // release the native binding before the values it refers to
+            if (_nativePtr != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseIoBinding(_nativePtr);
+                _nativePtr = IntPtr.Zero;
+            }
+            ReleaseValues(_inputValues, _inputHandles);
+            ReleaseValues(_outputValues, _outputHandles);
+        }
+
+        #endregion
+    }
+}
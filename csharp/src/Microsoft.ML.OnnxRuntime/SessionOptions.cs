@@ -334,6 +334,103 @@ namespace Microsoft.ML.OnnxRuntime
         private int _threadPoolSize = 0; // set to what is set in C++ SessionOptions by default;
 
 
+        /// <summary>
+        /// Threadpool size used to run independent nodes concurrently. Only used if sequential execution is disabled.
+        /// Default = -1, meaning threadpool size is automatically selected from number of available cores.
+        /// </summary>
+        public int InterOpThreadPoolSize
+        {
+            get
+            {
+                return _interOpThreadPoolSize;
+            }
+            set
+            {
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtSetSessionInterOpThreadPoolSize(_nativePtr, value));
+                _interOpThreadPoolSize = value;
+            }
+        }
+        private int _interOpThreadPoolSize = -1; // set to what is set in C++ SessionOptions by default;
+
+
+        /// <summary>
+        /// Logical processors to pin the threads of the session threadpool to. Thread i runs on element i % Length.
+        /// Default = empty, meaning the threads are not pinned.
+        /// </summary>
+        public int[] ThreadPoolAffinity
+        {
+            get
+            {
+                return _threadPoolAffinity;
+            }
+            set
+            {
+                var logicalProcessors = ToLogicalProcessors(value);
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtSetSessionThreadPoolAffinity(_nativePtr, logicalProcessors, (UIntPtr)logicalProcessors.Length));
+                _threadPoolAffinity = value ?? new int[0];
+            }
+        }
+        private int[] _threadPoolAffinity = new int[0];
+
+
+        /// <summary>
+        /// Logical processors to pin the threads of the inter-op threadpool to. Thread i runs on element i % Length.
+        /// Default = empty, meaning the threads are not pinned.
+        /// </summary>
+        public int[] InterOpThreadPoolAffinity
+        {
+            get
+            {
+                return _interOpThreadPoolAffinity;
+            }
+            set
+            {
+                var logicalProcessors = ToLogicalProcessors(value);
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtSetSessionInterOpThreadPoolAffinity(_nativePtr, logicalProcessors, (UIntPtr)logicalProcessors.Length));
+                _interOpThreadPoolAffinity = value ?? new int[0];
+            }
+        }
+        private int[] _interOpThreadPoolAffinity = new int[0];
+
+
+        /// <summary>
+        /// NUMA node whose logical processors the threads of the session threadpool are restricted to.
+        /// Ignored if ThreadPoolAffinity is set. Default = -1, meaning no restriction.
+        /// </summary>
+        public int ThreadPoolNumaNode
+        {
+            get
+            {
+                return _threadPoolNumaNode;
+            }
+            set
+            {
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtSetSessionThreadPoolNumaNode(_nativePtr, value));
+                _threadPoolNumaNode = value;
+            }
+        }
+        private int _threadPoolNumaNode = -1; // set to what is set in C++ SessionOptions by default;
+
+
+        /// <summary>
+        /// NUMA node whose logical processors the threads of the inter-op threadpool are restricted to.
+        /// Ignored if InterOpThreadPoolAffinity is set. Default = -1, meaning no restriction.
+        /// </summary>
+        public int InterOpThreadPoolNumaNode
+        {
+            get
+            {
+                return _interOpThreadPoolNumaNode;
+            }
+            set
+            {
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtSetSessionInterOpThreadPoolNumaNode(_nativePtr, value));
+                _interOpThreadPoolNumaNode = value;
+            }
+        }
+        private int _interOpThreadPoolNumaNode = -1; // set to what is set in C++ SessionOptions by default;
+
+
         /// <summary>
         /// Sets the graph optimization level for the session. Default is set to ORT_ENABLE_BASIC.        
         /// </summary>
@@ -355,6 +452,24 @@ namespace Microsoft.ML.OnnxRuntime
 
 #region Private Methods
 
+        private static UIntPtr[] ToLogicalProcessors(int[] affinity)
+        {
+            if (affinity == null)
+            {
+                return new UIntPtr[0];
+            }
+            var logicalProcessors = new UIntPtr[affinity.Length];
+            for (int i = 0; i < affinity.Length; ++i)
+            {
+                if (affinity[i] < 0)
+                {
+                    throw new ArgumentOutOfRangeException(nameof(affinity), "Logical processor indices must be 0 or more.");
+                }
+                logicalProcessors[i] = (UIntPtr)affinity[i];
+            }
+            return logicalProcessors;
+        }
+
 
         // Declared, but called only if OS = Windows.
         [DllImport("kernel32.dll")]
@@ -198,6 +198,154 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             }
         }
 
+        [Fact]
+        private async Task CanRunInferenceAsync()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                var inputMeta = session.InputMetadata;
+                var container = new List<NamedOnnxValue>();
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+
+                foreach (var name in inputMeta.Keys)
+                {
+                    var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                    container.Add(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                }
+
+                // run concurrently
+                var tasks = new Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>[4];
+                for (int i = 0; i < tasks.Length; i++)
+                {
+                    tasks[i] = session.RunAsync(container, new[] { "softmaxout_1" });
+                }
+                foreach (var results in await Task.WhenAll(tasks))
+                {
+                    using (results)
+                    {
+                        validateRunResults(results);
+                    }
+                }
+
+                // a failed run faults the task
+                var invalidOutputs = new[] { "invalid_output_name" };
+                await Assert.ThrowsAsync<OnnxRuntimeException>(() => session.RunAsync(container, invalidOutputs));
+            }
+        }
+
+        [Fact]
+        private void CanRunManyInputSets()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                var inputMeta = session.InputMetadata;
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+
+                var inputSets = new List<IReadOnlyCollection<NamedOnnxValue>>();
+                for (int i = 0; i < 3; i++)
+                {
+                    var container = new List<NamedOnnxValue>();
+                    foreach (var name in inputMeta.Keys)
+                    {
+                        var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                        container.Add(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                    }
+                    inputSets.Add(container);
+                }
+
+                var results = session.RunMany(inputSets, new[] { "softmaxout_1" });
+                Assert.Equal(inputSets.Count, results.Count);
+                foreach (var result in results)
+                {
+                    using (result)
+                    {
+                        validateRunResults(result);
+                    }
+                }
+
+                // every set must have the inputs of the first one
+                inputSets.Add(new List<NamedOnnxValue>());
+                Assert.Throws<ArgumentException>(() => session.RunMany(inputSets, new[] { "softmaxout_1" }));
+            }
+        }
+
+        [Fact]
+        private void CanRunInferenceWithIoBinding()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            using (var ioBinding = session.CreateIoBinding())
+            {
+                var inputMeta = session.InputMetadata;
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+
+                foreach (var name in inputMeta.Keys)
+                {
+                    var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                    ioBinding.BindInput(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                }
+                ioBinding.BindOutputToDevice("softmaxout_1");
+
+                // run twice to check the bound inputs and outputs are reusable
+                for (int i = 0; i < 2; i++)
+                {
+                    session.RunWithBinding(ioBinding);
+                    using (var results = ioBinding.GetOutputValues())
+                    {
+                        validateRunResults(results);
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        private void CanRunInferenceWithFixedBuffers()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                var inputMeta = session.InputMetadata;
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+                float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
+                string inputName = inputMeta.Keys.First();
+
+                // a value created over managed memory is read in place by a regular run
+                var container = new List<NamedOnnxValue>();
+                container.Add(NamedOnnxValue.CreateFromMemory<float>(inputName, new Memory<float>(inputData), inputMeta[inputName].Dimensions));
+                using (var results = session.Run(container))
+                {
+                    validateRunResults(results);
+                }
+
+                float[] outputData = new float[expectedOutput.Length];
+                int[] outputDimensions = { 1, 1000, 1, 1 };  // hardcoded for now for the test data
+                using (var input = FixedBufferOnnxValue.CreateFromMemory<float>(inputData, inputMeta[inputName].Dimensions))
+                using (var output = FixedBufferOnnxValue.CreateFromMemory<float>(outputData, outputDimensions))
+                {
+                    var inputNames = new[] { inputName };
+                    var inputValues = new[] { input };
+                    var outputNames = new[] { "softmaxout_1" };
+                    var outputValues = new[] { output };
+
+                    // run twice to check the values are reusable, and that the output is written into its buffer
+                    for (int i = 0; i < 2; i++)
+                    {
+                        Array.Clear(outputData, 0, outputData.Length);
+                        session.Run(inputNames, inputValues, outputNames, outputValues);
+                        Assert.Equal(expectedOutput, outputData, new floatComparer());
+                    }
+
+                    Assert.Throws<ArgumentException>(() => session.Run(inputNames, inputValues, outputNames, new FixedBufferOnnxValue[0]));
+                }
+            }
+        }
+
         private void validateRunResults(IDisposableReadOnlyCollection<DisposableNamedOnnxValue> results)
         {
             float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
@@ -815,7 +963,11 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             "OrtGetAllocatorWithDefaultOptions","OrtAllocatorFree","OrtAllocatorGetInfo",
             "OrtCreateTensorWithDataAsOrtValue","OrtGetTensorMutableData", "OrtReleaseMemoryInfo",
             "OrtCastTypeInfoToTensorInfo","OrtGetTensorTypeAndShape","OrtGetTensorElementType","OrtGetDimensionsCount",
-            "OrtGetDimensions","OrtGetTensorShapeElementCount","OrtReleaseValue"
+            "OrtGetDimensions","OrtGetTensorShapeElementCount","OrtReleaseValue",
+            "OrtCreateIoBinding","OrtReleaseIoBinding","OrtIoBindingBindInput","OrtIoBindingBindOutput","OrtIoBindingBindOutputToDevice",
+            "OrtIoBindingSynchronizeInputs","OrtIoBindingSynchronizeOutputs","OrtIoBindingClearInputs","OrtIoBindingClearOutputs",
+            "OrtIoBindingGetOutputCount","OrtIoBindingGetOutputName","OrtIoBindingGetOutputValue","OrtRunWithBinding",
+            "OrtRunAsync","OrtRunMany"
 #if USE_MKLDNN
             ,"OrtSessionOptionsAppendExecutionProvider_Mkldnn"
 #endif
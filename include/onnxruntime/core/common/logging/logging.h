@@ -55,6 +55,7 @@ namespace profiling {
 enum EventCategory {
   SESSION_EVENT = 0,
   NODE_EVENT,
+  MEMORY_EVENT,
   EVENT_CATEGORY_MAX
 };
 
@@ -63,7 +64,8 @@ Event descriptions for the above session events.
 */
 static constexpr const char* event_categor_names_[EVENT_CATEGORY_MAX] = {
     "Session",
-    "Node"};
+    "Node",
+    "Memory"};
 
 /*
 Timing record for all events.
@@ -206,6 +208,15 @@ class LoggingManager final {
     @param Profiling Event Record
   */
   void SendProfileEvent(profiling::EventRecord& eventRecord) const;
+
+  /**
+     Sends the messages to the sink from a background thread, so that logging them doesn't wait for the sink to format
+     and write them. Messages logged while max_queued_messages are waiting to be sent are dropped, except fatal ones.
+     Must be called before the loggers of the instance are used from other threads.
+     @param max_queued_messages The number of messages that can wait to be sent. Must be positive.
+  */
+  void EnableAsyncSink(size_t max_queued_messages);
+
   ~LoggingManager();
 
  private:
@@ -253,6 +264,24 @@ class Logger {
         max_vlog_level_{severity > Severity::kVERBOSE ? -1 : vlog_level} {  // disable unless logging VLOG messages
   }
 
+  /**
+     Initializes a new instance of the Logger class for a run of a session. Its identifier is the session identifier
+     and the run tag, joined with ':' if both are set. It's only built when a message is logged, so that a run whose
+     messages are all filtered doesn't pay for it.
+     @param loggingManager The logging manager.
+     @param session_id The identifier of the session. Must outlive the logger.
+     @param run_tag The tag of the run. Must outlive the logger.
+     @param severity Minimum severity for messages to be created and logged.
+     @param filter_user_data Should USER data be filtered from output.
+     @param vlog_level Minimum level for VLOG messages to be created.
+  */
+  Logger(const LoggingManager& loggingManager, const std::string& session_id, const std::string& run_tag,
+         Severity severity, bool filter_user_data, int vlog_level)
+      : Logger(loggingManager, std::string{}, severity, filter_user_data, vlog_level) {
+    session_id_ = &session_id;
+    run_tag_ = &run_tag;
+  }
+
   /**
      Get the minimum severity level for log messages to be output.
      @returns The severity.
@@ -287,7 +316,11 @@ class Logger {
      @param message The log message.
   */
   void Log(const Capture& message) const {
-    logging_manager_->Log(id_, message);
+    if (run_tag_ == nullptr) {
+      logging_manager_->Log(id_, message);
+    } else {
+      logging_manager_->Log(*session_id_ + (session_id_->empty() || run_tag_->empty() ? "" : ":") + *run_tag_, message);
+    }
   }
 
   /**
@@ -301,6 +334,9 @@ class Logger {
  private:
   const LoggingManager* logging_manager_;
   const std::string id_;
+  // the parts of the identifier of the logger of a run, for which id_ is empty
+  const std::string* session_id_ = nullptr;
+  const std::string* run_tag_ = nullptr;
   Severity min_severity_;
   const bool filter_user_data_;
   const int max_vlog_level_;
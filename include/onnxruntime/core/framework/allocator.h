@@ -8,11 +8,13 @@
 #include <string>
 #include <cstring>
 #include <type_traits>
+#include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/common/status.h"
 #include "core/framework/fence.h"
+#include "core/platform/ort_mutex.h"
 #include "core/session/onnxruntime_c_api.h"
 
 // Struct to represent a physical device.
@@ -254,6 +256,16 @@ class IDeviceAllocator : public IAllocator {
   virtual bool AllowsArena() const { return true; }
 };
 
+// How CPUAllocator backs large allocations, such as the regions of an arena and the initializers it reserves.
+struct CPUAllocatorConfig {
+  // Back them with huge pages, to reduce TLB misses when kernels such as GEMMs stream through large buffers.
+  // Explicit huge pages are used if the system has them reserved, else transparent huge pages on Linux.
+  bool use_huge_pages = false;
+  // Place them on this NUMA node, e.g. the node the intra-op threads run on. -1 leaves the placement to the
+  // system.
+  int numa_node = -1;
+};
+
 class CPUAllocator : public IDeviceAllocator {
  public:
   explicit CPUAllocator(std::unique_ptr<OrtMemoryInfo> allocator_info) {
@@ -265,12 +277,22 @@ class CPUAllocator : public IDeviceAllocator {
     allocator_info_ = std::make_unique<OrtMemoryInfo>(CPU, OrtAllocatorType::OrtDeviceAllocator);
   }
 
+  explicit CPUAllocator(const CPUAllocatorConfig& config) : CPUAllocator() {
+    config_ = config;
+  }
+
   void* Alloc(size_t size) override;
   void Free(void* p) override;
   const OrtMemoryInfo& Info() const override;
 
  private:
+  bool UsesPages() const { return config_.use_huge_pages || config_.numa_node >= 0; }
+
   std::unique_ptr<OrtMemoryInfo> allocator_info_;
+  CPUAllocatorConfig config_;
+  // the allocations made with Env::AllocatePages, which need their size to be freed
+  OrtMutex page_allocations_mutex_;
+  std::unordered_map<void*, size_t> page_allocations_;
 };
 
 using AllocatorPtr = std::shared_ptr<IAllocator>;
@@ -14,6 +14,9 @@
 namespace onnxruntime {
 class GraphViewer;
 class Node;
+namespace profiling {
+class Profiler;
+}
 }  // namespace onnxruntime
 namespace onnxruntime {
 
@@ -79,6 +82,14 @@ class IExecutionProvider {
   GetCapability(const onnxruntime::GraphViewer& graph_viewer,
                 const std::vector<const KernelRegistry*>& kernel_registries) const;
 
+  /**
+     Whether GetCapability claims the same nodes among those not yet assigned, whatever nodes the providers before
+     this one assigned or fused. The partitioner may then ask for the capability concurrently with those providers,
+     on the graph as it is before any placement. The default GetCapability, which claims each node this provider has
+     a kernel for, does. An override usually doesn't, so this is false unless overridden too.
+  */
+  virtual bool IsCapabilityIndependentOfPlacement() const;
+
   /**
      Get kernel registry per execution provider type.
      The KernelRegistry share pointer returned is shared across sessions.
@@ -135,8 +146,47 @@ class IExecutionProvider {
   */
   virtual common::Status OnRunEnd();
 
+  /**
+     Graph capture: a provider that supports it records the device work submitted between BeginGraphCapture and
+     EndGraphCapture instead of running it, and ReplayGraph submits the recorded work again with a single launch.
+     Captured work is keyed by the caller, who ensures a replay reads and writes the same buffers, with the same
+     shapes, as the captured run, and that nothing else submits work to the provider during a capture.
+  */
+  virtual bool IsGraphCaptureEnabled() const;
+  virtual bool IsGraphCaptured(const std::string& key) const;
+  virtual common::Status BeginGraphCapture();
+  /**
+     Ends the capture begun by BeginGraphCapture. The captured work is kept under key if keep is true, or discarded,
+     e.g. if the run failed. Fails if the work couldn't be captured, in which case none of it ran.
+  */
+  virtual common::Status EndGraphCapture(const std::string& key, bool keep);
+  virtual common::Status ReplayGraph(const std::string& key);
+
+  /**
+     Device timing of kernels, for providers whose kernels only submit their work to the device, so that the host time
+     of a kernel is the time it took to submit it. While the session is profiled, the executors call
+     StartKernelTiming before the Compute of each kernel of the provider and EndKernelTiming after it, on the same
+     thread. The provider adds the device time of the kernel to profiler once the work has completed, at the latest
+     when FlushKernelTimings is called, which blocks until then.
+  */
+  virtual void StartKernelTiming(const Node& node) const;
+  virtual void EndKernelTiming(const Node& node, const TimePoint& start_time, profiling::Profiler& profiler) const;
+  virtual common::Status FlushKernelTimings() const;
+
+  /**
+     Get a native resource of a GPU provider, e.g. the stream its kernels run on, for kernels registered through the
+     custom op API. The per thread resources are those of the calling thread.
+  */
+  virtual common::Status GetGPUResource(OrtGPUResource resource, void** out) const;
+
   void InsertAllocator(AllocatorPtr allocator);
 
+  /**
+     Replace the allocator with the same name, device id and memory type as allocator by it, e.g. by an allocator
+     shared with other sessions. Returns false, leaving the allocators unchanged, if there is no such allocator.
+  */
+  bool ReplaceAllocator(AllocatorPtr allocator);
+
   /**
   Given a list of fused_node, return create_state/compute/release_state func for each node.
   */
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -64,6 +65,15 @@ class KernelDef {
     return alias_map_;
   }
 
+  const std::vector<std::pair<int, int>>& MayStridedOutput() const {
+    return strided_output_map_;
+  }
+
+  bool MayStridedInput(int input_index) const {
+    return all_inputs_may_be_strided_ ||
+           std::find(strided_inputs_.begin(), strided_inputs_.end(), input_index) != strided_inputs_.end();
+  }
+
   OrtMemType InputMemoryType(size_t input_index) const {
     auto it = input_memory_type_args_.find(input_index);
     if (it == input_memory_type_args_.end())
@@ -118,6 +128,13 @@ class KernelDef {
   // An element <i, j> means that output j is an alias of input i.
   std::vector<std::pair<int, int>> alias_map_;
 
+  // An element <i, j> means that output j may be a strided view of input i.
+  std::vector<std::pair<int, int>> strided_output_map_;
+
+  // The inputs that may be strided views, or all of them.
+  std::vector<int> strided_inputs_;
+  bool all_inputs_may_be_strided_ = false;
+
   // The memory types of inputs/outputs of this kernel
   MemTypeMap input_memory_type_args_;
   MemTypeMap output_memory_type_args_;
@@ -201,6 +218,20 @@ class KernelDefBuilder {
   KernelDefBuilder& Alias(const std::vector<std::pair<int, int>>& aliases);
   KernelDefBuilder& Alias(int input_index, int output_index);
 
+  /**
+     The output may be a strided view of the input (see Tensor::IsContiguous()) instead of a copy of its elements,
+     such as a Slice or an Expand. The output is then planned to share the memory of the input, and the kernel
+     creates the view through OpKernelContextInternal::OutputView when the plan allows it.
+  */
+  KernelDefBuilder& MayStridedOutput(int input_index, int output_index);
+
+  /**
+     The kernel reads the input through its strides, so it may be a strided view. Other inputs that are strided
+     views are made contiguous before the kernel runs.
+  */
+  KernelDefBuilder& MayStridedInput(int input_index);
+  KernelDefBuilder& MayStridedInputs();
+
   /**
      Specify that this kernel requires an input arg
      in certain memory type (instead of the default, device memory).
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 /**
@@ -35,7 +38,7 @@ class KernelRegistry {
   // Check if an execution provider can create kernel for a node and return
   // the kernel if so
   const KernelCreateInfo* TryFindKernel(const onnxruntime::Node& node,
-                                        onnxruntime::ProviderType exec_provider) const;
+                                        const onnxruntime::ProviderType& exec_provider) const;
 
   bool IsEmpty() const { return kernel_creator_fn_map_.empty(); }
 
@@ -67,7 +70,37 @@ class KernelRegistry {
                               std::string& error_str,
                               onnxruntime::ProviderType exec_provider = "");
 
+  // A type constraint of a kernel resolved against an op schema: the formal parameters the constraint applies to,
+  // as indices into the schema inputs followed by the schema outputs, in the order they are checked.
+  struct ResolvedTypeConstraint {
+    const std::vector<MLDataType>* allowed_types;
+    std::vector<size_t> formal_params;
+  };
+  using ResolvedTypeConstraints = std::vector<ResolvedTypeConstraint>;
+
+  // A kernel in the lookup index, with its version range unpacked and its type constraints resolved against the
+  // op schemas of the nodes it has been matched with.
+  struct IndexedKernel {
+    const KernelCreateInfo* create_info;
+    int start_version;
+    int end_version;
+    // guarded by resolved_type_constraints_mutex_
+    std::unordered_map<const ONNX_NAMESPACE::OpSchema*, ResolvedTypeConstraints> resolved_type_constraints;
+  };
+
+  static size_t IndexKey(const std::string& op_type, const std::string& domain, const std::string& provider);
+
+  void AddToIndex(const KernelCreateInfo& create_info);
+
+  // The fast equivalent of the type check of VerifyKernelDef for a kernel whose domain, provider and version match.
+  bool VerifyTypeConstraints(const onnxruntime::Node& node, IndexedKernel& indexed_kernel) const;
+
   // Kernel create function map from op name to kernel creation info.
   KernelCreateMap kernel_creator_fn_map_;
+
+  // The kernels keyed by a hash of their op type, domain and provider, so a lookup is a single hash
+  // probe without building a key string. Kernels whose keys collide share a vector.
+  mutable std::unordered_map<size_t, std::vector<IndexedKernel>> kernel_index_;
+  mutable OrtMutex resolved_type_constraints_mutex_;
 };
 }  // namespace onnxruntime
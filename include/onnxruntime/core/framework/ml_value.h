@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
@@ -27,6 +28,12 @@ struct OrtValue {
     type_ = type;
   }
 
+  // deleter may hold state, e.g. a copy of another OrtValue whose data has to outlive this one
+  void Init(void* pData, onnxruntime::MLDataType type, const std::function<void(void*)>& deleter) {
+    data_.reset(pData, deleter);
+    type_ = type;
+  }
+
   bool IsAllocated() const {
     return data_ && type_;
   }
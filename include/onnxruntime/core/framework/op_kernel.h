@@ -22,6 +22,7 @@
 
 namespace onnxruntime {
 class IExecutionFrame;
+class NodeShapeCache;
 class OpKernelContext;
 class OpKernelWrapper;
 
@@ -65,7 +66,7 @@ class OpKernelContext {
                            const OpKernel* kernel,
                            const logging::Logger& logger);
 
-  virtual ~OpKernelContext() = default;
+  virtual ~OpKernelContext();
 
   /**
   Return the number of inputs for a variadic argument.
@@ -134,6 +135,46 @@ class OpKernelContext {
    */
   Status GetTempSpaceAllocator(AllocatorPtr* output) const;
 
+  /**
+  Return a scratch buffer of size bytes from the temp space allocator, for the temporaries of the kernel.
+  The buffer is valid until the context is destroyed, when the kernel returns. With memory patterns enabled it is
+  planned like an intermediate tensor, so the runs with the same input shapes take it from the pre-allocated chunk
+  instead of allocating it. A kernel gets one scratch buffer per call, and carves its temporaries out of it.
+  @param size The size in bytes. A size of 0 returns nullptr.
+  */
+  Status GetScratchBuffer(size_t size, void** buffer);
+
+  template <typename T>
+  Status GetScratchBuffer(size_t count, T** buffer) {
+    size_t size;
+    if (!IAllocator::CalcMemSizeForArray(count, sizeof(T), &size))
+      return Status(common::ONNXRUNTIME, common::FAIL, "scratch buffer size overflow");
+    void* raw = nullptr;
+    ORT_RETURN_IF_ERROR(GetScratchBuffer(size, &raw));
+    *buffer = static_cast<T*>(raw);
+    return Status::OK();
+  }
+
+  /**
+  Return the state this kernel cached with SetShapeCachedState in an earlier call with the same input shapes, or
+  nullptr. Kernels cache what they derive from the input shapes, such as their output shapes and helpers, so that
+  runs with fixed shapes skip that work. Always nullptr unless the session enables its shape cache.
+  */
+  template <typename T>
+  std::shared_ptr<const T> GetShapeCachedState() const {
+    return std::static_pointer_cast<const T>(GetShapeCachedStateImpl());
+  }
+
+  /**
+  Cache state derived from the current input shapes for the next calls of this kernel, replacing the previous
+  state. The state must not change once cached, as concurrent runs may share it. No-op unless the session enables
+  its shape cache.
+  */
+  template <typename T>
+  void SetShapeCachedState(std::shared_ptr<const T> state) {
+    SetShapeCachedStateImpl(std::move(state));
+  }
+
   /**
   Return the fence of current node's input.
   @param index The index of the input.
@@ -170,6 +211,9 @@ class OpKernelContext {
   const OrtValue* GetImplicitInputMLValue(int index) const;
   OrtValue* GetOutputMLValue(int index);
 
+  // Set by OpKernelContextInternal when the session enables the shape cache.
+  void SetShapeCache(NodeShapeCache* shape_cache) { shape_cache_ = shape_cache; }
+
   // Creates the OrtValue* based on the shape, if it does not exist
   // The parameter nnz is used only for sparse-tensors and indicates the
   // number of non-zero values (the number of elements in the values buffer allocated).
@@ -180,6 +224,9 @@ class OpKernelContext {
 
   OrtValue* GetOrCreateOutputMLValue(int index);
 
+  std::shared_ptr<const void> GetShapeCachedStateImpl() const;
+  void SetShapeCachedStateImpl(std::shared_ptr<const void> state);
+
   int GetInputArgIndex(int index) const;
   int GetImplicitInputArgIndex(int index) const;
   int GetOutputArgIndex(int index) const;
@@ -188,6 +235,13 @@ class OpKernelContext {
   const OpKernel* kernel_{nullptr};
   const logging::Logger* logger_{nullptr};
 
+  // Could be NULL
+  NodeShapeCache* shape_cache_{nullptr};
+
+  // The scratch buffer handed out by GetScratchBuffer, released by the destructor.
+  AllocatorPtr scratch_allocator_;
+  void* scratch_buffer_{nullptr};
+
   // The argument starting index in ExecutionFrame.
   int node_input_start_index_{-1};
   int node_implicit_input_start_index_{-1};
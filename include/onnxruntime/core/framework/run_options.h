@@ -22,6 +22,15 @@ struct OrtRunOptions {
   // be forced to terminate with an error status.
   bool terminate = false;
 
+  // If greater than 0, a Run() call using this OrtRunOptions instance fails once it has been executing
+  // for longer than this many milliseconds. The check is made before each node, including the nodes
+  // of control flow subgraphs, so a single long running node isn't interrupted.
+  int64_t run_timeout_ms = 0;
+
+  // Set to 'true' to record a per node trace of this run into the session's trace buffer, whether or not the
+  // run is picked by SessionOptions::trace_sample_rate. See InferenceSession::DumpRunTraces.
+  bool trace_run = false;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
@@ -161,6 +161,7 @@ class Tensor final {
    * @warning this function is NOT thread-safe.
    */
   inline void Reshape(const TensorShape& new_shape) {
+    ORT_ENFORCE(IsContiguous(), "Can't reshape a strided view");
     ORT_ENFORCE(shape_.Size() == new_shape.Size(),
                 "Tensor size (" + std::to_string(shape_.Size()) +
                     ") != new size (" + std::to_string(new_shape.Size()) + ")");
@@ -182,6 +183,24 @@ class Tensor final {
     return ret;
   }
 
+  /**
+     Whether the elements are stored densely in row-major order, which is always the case unless the tensor is a
+     strided view of another tensor's buffer (e.g. the output of a Slice). Kernels read strided inputs only if their
+     KernelDef allows it, and the executor makes the other inputs contiguous first.
+  */
+  bool IsContiguous() const noexcept { return strides_.empty(); }
+
+  /**
+     The distance in elements between consecutive indices along each axis. May be 0 for a broadcast axis.
+  */
+  std::vector<int64_t> Strides() const;
+
+  /**
+     Makes the tensor a strided view with the given shape, which doesn't touch the underlying storage.
+     strides has an entry for each axis, in elements. Row-major strides make the tensor contiguous again.
+  */
+  void SetShapeAndStrides(const TensorShape& new_shape, const std::vector<int64_t>& strides);
+
   // More API methods.
  private:
   void Init(MLDataType p_type,
@@ -204,6 +223,8 @@ class Tensor final {
   MLDataType dtype_;
   OrtMemoryInfo alloc_info_;
   int64_t byte_offset_;
+  // empty unless the tensor is a strided view, see IsContiguous()
+  std::vector<int64_t> strides_;
 };
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
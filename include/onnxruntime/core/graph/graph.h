@@ -503,6 +503,11 @@ class Graph {
   /** Removes all initializer tensors from this Graph and releases the memory they were using. */
   void CleanAllInitializedTensors() noexcept;
 
+  /** Releases the memory used by the data of the initializer tensor with the provided name, once the data has
+  been copied elsewhere, e.g. into an OrtValue. The initializer keeps its name, type and shape, but its data
+  must not be read afterwards. */
+  void ReleaseInitializedTensorData(const std::string& tensor_name);
+
   /** Returns true if an initializer value can be overridden by a graph input with the same name. */
   bool CanOverrideInitializer() const noexcept { return ir_version_ >= 4; }
 
@@ -952,6 +957,10 @@ class Graph {
   // The topological order of node index used to do node and op match verification temporarily.
   std::vector<NodeIndex> nodes_in_topological_order_;
 
+  // Signature of the inputs, attributes and outputs of each node when its types and shapes were
+  // last inferred. Used to skip inferencing of unchanged nodes when the graph is resolved again.
+  std::unordered_map<NodeIndex, std::string> inferred_node_signatures_;
+
   // Full list of graph inputs. Matches number and order of inputs in the GraphProto.
   std::vector<const NodeArg*> graph_inputs_including_initializers_;
   bool graph_inputs_manually_set_ = false;
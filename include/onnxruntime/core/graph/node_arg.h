@@ -67,6 +67,11 @@ class NodeArg {
   @returns Success unless there is existing type or shape info that can't be cleanly updated. */
   common::Status UpdateTypeAndShape(const NodeArg& node_arg);
 
+  /** Replaces the type, and with it any shape info.
+  @remarks Used by graph transformers that change the type produced for this NodeArg. Type inference doesn't
+  change an existing type, so the type must match what the producer node is inferred to output. */
+  void SetType(const ONNX_NAMESPACE::TypeProto& type_proto);
+
   /** Gets this NodeArg as a ValueInfoProto. */
   const NodeArgInfo& ToProto() const noexcept { return node_arg_info_; }
 
@@ -79,7 +84,6 @@ class NodeArg {
   friend class Graph;
 
   void SetType(ONNX_NAMESPACE::DataType p_type);
-  void SetType(const ONNX_NAMESPACE::TypeProto& type_proto);
 
   NodeArg& operator=(NodeArg&& other) = delete;
 
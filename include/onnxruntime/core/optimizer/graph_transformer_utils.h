@@ -19,9 +19,24 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
 
 /** Generates all predefined (both rule-based and non-rule-based) transformers for this level.
     If transformers_and_rules_to_enable is not empty, it returns the intersection between the predefined transformers/rules 
-	and the transformers_and_rules_to_enable. */
+	and the transformers_and_rules_to_enable.
+    constant_folding_max_output_size_in_bytes is the size budget for outputs created by constant folding (0 means no limit).
+    enable_dynamic_quantization adds the transformer that converts float MatMul/Gemm nodes with constant weights to
+    DynamicQuantizeMatMul nodes.
+    nchwc_min_isolated_conv_flops_per_reorder is the cost threshold passed to the NCHWc transformer (0 means no limit).
+    enable_zipmap_elimination adds the transformer that replaces the ZipMap nodes producing graph outputs by their
+    probability tensors.
+    weight_only_quantization_bits (4 or 8, 0 for none) adds the transformer that converts float MatMul/Gemm nodes
+    with constant weights to MatMulNBits nodes, with a scale for each block of weight_only_quantization_block_size
+    rows of the weights. */
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
-                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {});
+                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {},
+                                                                    size_t constant_folding_max_output_size_in_bytes = 0,
+                                                                    bool enable_dynamic_quantization = false,
+                                                                    float nchwc_min_isolated_conv_flops_per_reorder = 0.0f,
+                                                                    bool enable_zipmap_elimination = false,
+                                                                    int weight_only_quantization_bits = 0,
+                                                                    int weight_only_quantization_block_size = 32);
 
 /** Given a TransformerLevel, this method generates a name for the rule-based graph transformer of that level. */
 std::string GenerateRuleBasedTransformerName(TransformerLevel level);
@@ -25,6 +25,24 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+/**
+ * Options that control where the threads of a ThreadPool run.
+ */
+struct ThreadOptions {
+  // Logical processors to pin the pool threads to. Thread i is pinned to
+  // affinity[i % affinity.size()]. Takes precedence over numa_node.
+  std::vector<size_t> affinity;
+
+  // If non-negative and affinity is empty, the pool threads may run on any
+  // logical processor of this NUMA node.
+  int numa_node = -1;
+
+  // Microseconds a thread that ran out of ParallelFor work keeps spinning for
+  // the next loop before it blocks. Spinning avoids the wake-up latency of the
+  // next loop at the cost of CPU time. 0 blocks right away.
+  int spin_duration_us = 0;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
@@ -36,6 +54,14 @@ class ThreadPool {
   */
   ThreadPool(const std::string& name, int num_threads);
 
+  /*
+  Initializes a thread pool whose threads are placed according to thread_options.
+  Placement is best effort; a failure to set affinity is logged and otherwise ignored.
+  */
+  ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options);
+
+  ~ThreadPool();
+
   /*
   Enqueue a unit of work.
   */
@@ -43,25 +69,60 @@ class ThreadPool {
 
   /*
   Schedule work in the interval [0, total).
+  The calling thread participates and iterations are claimed dynamically by at
+  most NumThreads() + 1 threads, so fn may be invoked concurrently.
   */
   void ParallelFor(int32_t total, std::function<void(int32_t)> fn);
 
   /*
-  Schedule work in the interval [first, last].
+  Schedule work in the interval [first, last).
+  The interval is partitioned into blocks that shrink as the range is consumed and
+  fn is invoked once per block with the half-open sub-range [block_first, block_last).
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Schedule work in the interval [first, last), where processing one element costs
+  roughly cost_per_unit cycles. Cheap loops run on fewer threads, or inline on the
+  calling thread, and blocks are sized so that their cost dominates scheduling overhead.
+  */
+  void ParallelForRange(int64_t first, int64_t last, double cost_per_unit,
+                        std::function<void(int64_t, int64_t)> fn);
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
+  /*
+  Keeps the pool threads spinning for ParallelFor work until the matching
+  EndLowLatency(), so the loops in between don't wait for threads to wake up.
+  The calls may nest and come from several threads. The threads block again
+  after the last EndLowLatency() and their spin duration. Work scheduled in the
+  meantime takes the place of a spinning thread.
+  */
+  void StartLowLatency();
+  void EndLowLatency();
+
   int NumThreads() const;
 
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler() { return *impl_; }
 
  private:
-  Eigen::ThreadPool impl_;
+  void RunParallelForRange(int64_t first, int64_t last, int64_t min_block_size, int64_t max_threads,
+                           const std::function<void(int64_t, int64_t)>& fn);
+
+  // Schedules fn on impl_, counting it as queued until a thread starts it, so
+  // that the spinning threads make room for it.
+  void ScheduleTask(std::function<void()> fn);
+
+  // Runs the loops published to the spinning threads until the thread has been
+  // idle for the spin duration, outside of low latency sections.
+  void SpinForWork();
+
+  struct SpinState;
+  std::unique_ptr<SpinState> spin_state_;
+  std::unique_ptr<Eigen::ThreadPoolInterface> impl_;
 };
 
 }  // namespace concurrency
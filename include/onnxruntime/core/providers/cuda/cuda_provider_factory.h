@@ -12,6 +12,51 @@ extern "C" {
  */
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_CUDA, but all the kernels, copies, cuBLAS and cuDNN calls of the
+ * sessions are issued on a stream of the caller, and the sessions only synchronize with this stream. The stream must
+ * outlive the sessions.
+ * \param device_id cuda device id, starts from zero.
+ * \param cuda_stream the cudaStream_t, created on device_id.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream, _In_ OrtSessionOptions* options,
+               int device_id, _In_ void* cuda_stream);
+
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream, but the runs of the sessions are captured into CUDA
+ * graphs and replayed with a single launch. A run is captured the first time its inputs and outputs, all bound to
+ * CUDA memory with an IOBinding, have a given set of shapes and addresses, and later runs with the same ones replay
+ * the graph. Other runs are executed as usual. The runs of a session are serialized. Requires CUDA 10.0 or later.
+ * \param device_id cuda device id, starts from zero.
+ * \param cuda_stream the cudaStream_t, created on device_id, or nullptr for a stream created by the sessions.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithGraphCapture, _In_ OrtSessionOptions* options,
+               int device_id, _In_opt_ void* cuda_stream);
+
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_CUDA, with control over how the convolution kernels choose their cuDNN
+ * algorithms for the shapes they haven't run before. By default each algorithm is benchmarked, which can take seconds
+ * for the first runs of a process.
+ * \param device_id cuda device id, starts from zero.
+ * \param cudnn_conv_algo_cache_path a file of benchmarked algorithms, loaded when the sessions are created and saved
+ * with the algorithms they benchmarked when they are released, so that the next processes don't benchmark them again.
+ * nullptr for none.
+ * \param heuristic_conv_algo_search non-zero to take the algorithms the cuDNN heuristics rank first, for the shapes
+ * that aren't in the cache, instead of benchmarking them. It starts faster, but the algorithms may run slower.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithConvAlgoCache, _In_ OrtSessionOptions* options,
+               int device_id, _In_opt_ const ORTCHAR_T* cudnn_conv_algo_cache_path, int heuristic_conv_algo_search);
+
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_CUDA, but the float GEMMs and convolutions the sessions run on CUDA
+ * are computed in float16 on the Tensor Cores, with the element-wise and data movement ops around them, and Casts are
+ * inserted where the float16 values meet the rest of the graph. Softmax, the reductions and the normalizations stay
+ * in float. The outputs are less accurate than in float.
+ * \param device_id cuda device id, starts from zero.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_CUDA_WithFloat16, _In_ OrtSessionOptions* options,
+               int device_id);
+
 #ifdef __cplusplus
 }
 #endif
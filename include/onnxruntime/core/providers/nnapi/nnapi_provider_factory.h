@@ -6,8 +6,27 @@
 extern "C" {
 #endif
 
+/**
+ * The execution preferences of NNAPI compilations, with the values of the PreferenceCode of NNAPI.
+ */
+typedef enum OrtNnapiExecutionPreference {
+  ORT_NNAPI_PREFER_LOW_POWER = 0,           // prefer executing in a way that minimizes battery drain
+  ORT_NNAPI_PREFER_FAST_SINGLE_ANSWER = 1,  // prefer returning a single answer as fast as possible
+  ORT_NNAPI_PREFER_SUSTAINED_SPEED = 2,     // prefer maximizing the throughput of successive frames
+} OrtNnapiExecutionPreference;
+
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSessionOptions* options);
 
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_Nnapi, but chooses how the NNAPI models are compiled.
+ * OrtSessionOptionsAppendExecutionProvider_Nnapi relaxes float32 to float16 and prefers sustained speed.
+ * \param relax_fp32_to_fp16 non-zero to let NNAPI compute float32 tensors with the range and precision of float16,
+ * which is faster on most accelerators. Zero to keep float32 precision.
+ * \param execution_preference one of OrtNnapiExecutionPreference.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Nnapi_WithOptions, _In_ OrtSessionOptions* options,
+               int relax_fp32_to_fp16, OrtNnapiExecutionPreference execution_preference);
+
 #ifdef __cplusplus
 }
 #endif
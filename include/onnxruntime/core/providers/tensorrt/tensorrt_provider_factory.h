@@ -9,6 +9,32 @@ extern "C" {
 
 ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Tensorrt, _In_ OrtSessionOptions* options, int device_id);
 
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_Tensorrt, but the TensorRT engines built for the subgraphs are
+ * serialized to a directory, and the sessions created later load them from it instead of building them again.
+ * An engine is reused for the same subgraph, TensorRT version, GPU model, maximum batch size and workspace size,
+ * and precision. The directory must exist.
+ * \param device_id cuda device id, starts from zero.
+ * \param engine_cache_path the directory of the engines, nullptr for none. When nullptr, the
+ * ORT_TENSORRT_ENGINE_CACHE_PATH environment variable is used if set.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Tensorrt_WithEngineCache, _In_ OrtSessionOptions* options,
+               int device_id, _In_opt_ const ORTCHAR_T* engine_cache_path);
+
+/**
+ * Like OrtSessionOptionsAppendExecutionProvider_Tensorrt, but TensorRT may run the layers of the engines in float16
+ * or int8 where it is faster than float. The outputs are less accurate than in float. They can also be enabled with
+ * the ORT_TENSORRT_FP16_ENABLE and ORT_TENSORRT_INT8_ENABLE environment variables.
+ * \param device_id cuda device id, starts from zero.
+ * \param fp16_enable non-zero to allow float16.
+ * \param int8_enable non-zero to allow int8.
+ * \param int8_calibration_table_path the calibration table TensorRT wrote for the model, which gives the dynamic
+ * ranges of its tensors, required for int8. When nullptr, the ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH environment
+ * variable is used.
+ */
+ORT_API_STATUS(OrtSessionOptionsAppendExecutionProvider_Tensorrt_WithPrecision, _In_ OrtSessionOptions* options,
+               int device_id, int fp16_enable, int int8_enable, _In_opt_ const ORTCHAR_T* int8_calibration_table_path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,10 +5,31 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
+class SharedInitializerCache;
+
+/**
+   Configuration of the thread pools owned by an Environment and shared by all
+   sessions that set SessionOptions::use_global_thread_pools.
+*/
+struct GlobalThreadPoolOptions {
+  // Size of the pool kernels use for intra-op parallelism.
+  // <0 lets the runtime choose a default. 0 doesn't create a pool.
+  int intra_op_thread_pool_size = -1;
+  concurrency::ThreadOptions intra_op_thread_options;
+
+  // Size of the pool the parallel executor uses for inter-op parallelism.
+  // <0 lets the runtime choose a default. 0 doesn't create a pool.
+  int inter_op_thread_pool_size = -1;
+  concurrency::ThreadOptions inter_op_thread_options;
+};
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -20,6 +41,11 @@ class Environment {
   */
   static Status Create(std::unique_ptr<Environment>& environment);
 
+  /**
+     Create and initialize the runtime environment with thread pools that sessions can share.
+  */
+  static Status Create(std::unique_ptr<Environment>& environment, const GlobalThreadPoolOptions& thread_pool_options);
+
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
   */
@@ -30,6 +56,33 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns whether this environment owns thread pools that sessions can share.
+  */
+  bool HasGlobalThreadPools() const { return has_global_thread_pools_; }
+
+  /**
+     Global thread pools. Could be nullptr if the environment was created without them,
+     or if the corresponding pool size resolved to 0 threads.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_.get(); }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_.get(); }
+
+  /**
+     Cache of the initializers shared by the sessions that set SessionOptions::use_shared_initializers.
+  */
+  SharedInitializerCache* GetSharedInitializerCache() const { return shared_initializer_cache_.get(); }
+
+  /**
+     Register an allocator that the sessions setting SessionOptions::use_env_allocators use in place of the
+     allocator of their execution providers with the same name, device id and memory type, e.g. to back their
+     tensors and initializers by a custom pool, or to share one arena among all the sessions on a device.
+     The allocators must be registered before the sessions using them are created.
+  */
+  Status RegisterAllocator(AllocatorPtr allocator);
+
+  const std::vector<AllocatorPtr>& GetRegisteredAllocators() const { return registered_allocators_; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -37,5 +90,11 @@ class Environment {
   Status Initialize();
 
   static std::atomic<bool> is_initialized_;
+
+  bool has_global_thread_pools_ = false;
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
+  std::unique_ptr<SharedInitializerCache> shared_initializer_cache_;
+  std::vector<AllocatorPtr> registered_allocators_;
 };
 }  // namespace onnxruntime
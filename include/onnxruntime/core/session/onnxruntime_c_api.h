@@ -7,7 +7,7 @@
 #include <string.h>
 
 // This value is used in structures passed to ORT so that a newer version of ORT will still work with
-#define ORT_API_VERSION 1
+#define ORT_API_VERSION 2
 
 #ifdef __cplusplus
 extern "C" {
@@ -154,6 +154,8 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(IoBinding);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -182,6 +184,40 @@ ORT_API_STATUS(OrtCreateEnvWithCustomLogger, OrtLoggingFunction logging_function
                _In_ const char* logid,
                _Outptr_ OrtEnv** out);
 
+/**
+ * Create an environment that owns thread pools which sessions can share by calling OrtEnableGlobalThreadPools.
+ * Use this when hosting many sessions in one process to avoid creating thread pools per session.
+ * \param intra_op_thread_pool_size <0, let the runtime choose a default. =0, Don't create the pool.
+ * \param inter_op_thread_pool_size <0, let the runtime choose a default. =0, Don't create the pool.
+ * \param out Should be freed by `OrtReleaseEnv` after use. All sessions using it must be released first.
+ */
+ORT_API_STATUS(OrtCreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+               int intra_op_thread_pool_size, int inter_op_thread_pool_size, _Outptr_ OrtEnv** out);
+
+/**
+ * Register an allocator with the environment. The sessions that call OrtEnableEnvAllocators use it in place of the
+ * allocator of their execution providers with the same name, device id and memory type as its OrtMemoryInfo,
+ * for their tensors and initializers. Register the allocators before creating those sessions.
+ * \param allocator must be thread-safe, and outlive env and all the sessions using it.
+ * \param use_arena nonzero to have the sessions share one arena that gets its memory from allocator, e.g. to keep
+ * one arena for all the sessions on a device. Zero to have them call allocator for every allocation.
+ */
+ORT_API_STATUS(OrtRegisterAllocator, _Inout_ OrtEnv* env, _In_ OrtAllocator* allocator, int use_arena);
+
+/**
+ * Send the log messages of env to its sink or logging function from a background thread, so that the threads logging
+ * them don't wait for it. Up to max_queued_messages wait to be sent, more are dropped, except fatal ones, and the
+ * number dropped is logged. Call it before creating sessions with env.
+ */
+ORT_API_STATUS(OrtEnableAsyncLogging, _Inout_ OrtEnv* env, size_t max_queued_messages);
+
+/**
+ * Same as OrtCreateEnvWithGlobalThreadPools, with the logging of OrtCreateEnvWithCustomLogger.
+ */
+ORT_API_STATUS(OrtCreateEnvWithCustomLoggerAndGlobalThreadPools, OrtLoggingFunction logging_function,
+               _In_opt_ void* logger_param, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+               int intra_op_thread_pool_size, int inter_op_thread_pool_size, _Outptr_ OrtEnv** out);
+
 // TODO: document the path separator convention? '/' vs '\'
 // TODO: should specify the access characteristics of model_path. Is this read only during the
 // execution of OrtCreateSession, or does the OrtSession retain a handle to the file/directory
@@ -193,11 +229,119 @@ ORT_API_STATUS(OrtCreateSession, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* m
 ORT_API_STATUS(OrtCreateSessionFromArray, _In_ const OrtEnv* env, _In_ const void* model_data, size_t model_data_length,
                _In_ const OrtSessionOptions* options, _Outptr_ OrtSession** out);
 
+/**
+ * \param out A null entry is set to a new value that should be freed by OrtReleaseValue after use.
+ *            A non-null entry is a pre-allocated value of the output's shape, which the run writes into
+ *            instead of allocating the output.
+ */
 ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_opt_ const OrtRunOptions* run_options,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtValue** out);
 
+/**
+ * Bind the inputs and outputs of a session to OrtValues or devices once, and run it repeatedly with
+ * OrtRunWithBinding. Inputs are copied to the device that consumes them when they are bound, and outputs bound
+ * to a device stay there, so tensors can remain on the device across runs.
+ * \param out Should be freed by OrtReleaseIoBinding after use, before the session is released.
+ */
+ORT_API_STATUS(OrtCreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out);
+
+/**
+ * Bind an input. The value is copied to the device of the nodes consuming it if it is not already there,
+ * which may be asynchronous. Call OrtIoBindingSynchronizeInputs before running if so.
+ */
+ORT_API_STATUS(OrtIoBindingBindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+               _In_ const OrtValue* value);
+
+/**
+ * Bind an output to a pre-allocated value that the run writes into.
+ */
+ORT_API_STATUS(OrtIoBindingBindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+               _In_ const OrtValue* value);
+
+/**
+ * Bind an output to a device. The output is allocated on that device by every run and is not copied to CPU.
+ * \param info must describe an allocator of one of the session's execution providers.
+ */
+ORT_API_STATUS(OrtIoBindingBindOutputToDevice, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+               _In_ const OrtMemoryInfo* info);
+
+// Wait for asynchronous copies of bound inputs, or for the devices producing bound outputs, to complete.
+ORT_API_STATUS(OrtIoBindingSynchronizeInputs, _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS(OrtIoBindingSynchronizeOutputs, _Inout_ OrtIoBinding* binding);
+
+// Remove all bound inputs or outputs.
+ORT_API_STATUS(OrtIoBindingClearInputs, _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS(OrtIoBindingClearOutputs, _Inout_ OrtIoBinding* binding);
+
+/**
+ * The outputs are in the order they were first bound.
+ * \param name is set to a null terminated string allocated using 'allocator'. The caller is responsible for freeing it.
+ * \param value Should be freed by OrtReleaseValue after use. It shares the data of the bound output, so it is only
+ *              valid until the next run if the output is bound to a device.
+ */
+ORT_API_STATUS(OrtIoBindingGetOutputCount, _In_ const OrtIoBinding* binding, _Out_ size_t* out);
+ORT_API_STATUS(OrtIoBindingGetOutputName, _In_ const OrtIoBinding* binding, size_t index,
+               _Inout_ OrtAllocator* allocator, _Outptr_ char** name);
+ORT_API_STATUS(OrtIoBindingGetOutputValue, _In_ const OrtIoBinding* binding, size_t index, _Outptr_ OrtValue** value);
+
+ORT_API_STATUS(OrtRunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+               _Inout_ OrtIoBinding* binding);
+
+/**
+ * Prepare runs of a session for fixed input and output names. The names are resolved and validated once,
+ * so OrtRunPrepared only has to validate the types and shapes of the inputs.
+ * A prepared run reuses its state across calls, so it must not be used by more than one thread at a time.
+ * \param out Should be freed by OrtReleasePreparedRun after use, before the session is released.
+ */
+ORT_API_STATUS(OrtCreatePreparedRun, _Inout_ OrtSession* sess,
+               _In_ const char* const* input_names, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtPreparedRun** out);
+
+/**
+ * Run a prepared run. input and out are in the order of the names the prepared run was created with.
+ * As for OrtRun, a null entry of out is set to a new value that should be freed by OrtReleaseValue after use,
+ * and a non-null entry is a pre-allocated value the output is written into.
+ */
+ORT_API_STATUS(OrtRunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+               _Inout_ OrtPreparedRun* prepared_run, _In_ const OrtValue* const* input, _Inout_ OrtValue** out);
+
+/**
+ * Called by OrtRunAsync when the run completes. It's called on a thread of the session and must not release
+ * the session.
+ * \param outputs If status is null, the outputs in the order of the output names. Each should be freed by
+ *                OrtReleaseValue after use. The array itself is only valid during the call.
+ * \param status If the run failed, the error, which should be freed by OrtReleaseStatus after use.
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallback)(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                                OrtStatus* status);
+
+/**
+ * Enqueue a run and return without waiting for it to complete. callback is called with user_data when it does.
+ * The names and values are copied, so they can be released once OrtRunAsync returns, but run_options must
+ * stay alive until the callback is called. Releasing the session waits for its pending runs.
+ * If OrtRunAsync returns an error the run was not enqueued and callback is not called.
+ */
+ORT_API_STATUS(OrtRunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len,
+               _In_ OrtRunAsyncCallback callback, _In_opt_ void* user_data);
+
+/**
+ * Run the model for each of run_count sets of inputs in one call. input holds input_len values per set, set after
+ * set, and output receives output_names_len new values per set in the same layout. Each should be freed by
+ * OrtReleaseValue after use.
+ * If dimension 0 of the inputs and outputs is symbolic in the model and the inputs are CPU tensors whose other
+ * dimensions match between the sets, the sets are run as one batch, concatenated along dimension 0, whose outputs
+ * are split back into the sets. This assumes the rows of a batch are computed independently of each other.
+ * Otherwise the sets are run one after the other.
+ */
+ORT_API_STATUS(OrtRunMany, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+               _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+               size_t run_count, _In_ const char* const* output_names, size_t output_names_len,
+               _Outptr_ OrtValue** output);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -211,10 +355,81 @@ ORT_API_STATUS(OrtCloneSessionOptions, _In_ const OrtSessionOptions* in_options,
 ORT_API_STATUS(OrtEnableSequentialExecution, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtDisableSequentialExecution, _Inout_ OrtSessionOptions* options);
 
+// When parallel execution is enabled, dispatch ready nodes in order of the longest remaining path to the end of the
+// graph, weighted by the kernel times observed in previous runs.
+ORT_API_STATUS(OrtEnableCriticalPathScheduling, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableCriticalPathScheduling, _Inout_ OrtSessionOptions* options);
+
 // Enable profiling for this session.
 ORT_API_STATUS(OrtEnableProfiling, _Inout_ OrtSessionOptions* options, _In_ const ORTCHAR_T* profile_file_prefix);
 ORT_API_STATUS(OrtDisableProfiling, _Inout_ OrtSessionOptions* options);
 
+// Add the cycles, instructions and last level cache misses of each kernel computation to its profile event, with
+// the GFLOP/s and GB/s it achieved according to a static estimate of its work. Only counts the thread running the
+// kernel, and requires Linux perf_event access; the profile is written without the counters otherwise.
+ORT_API_STATUS(OrtEnableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableProfilingHardwareCounters, _Inout_ OrtSessionOptions* options);
+
+// Count the kernel runs of each node of the main graph, with their compute time and output bytes. Unlike
+// profiling, this takes no lock and allocates nothing per run, so it can be left enabled in production.
+// See OrtSessionGetNodeCounters.
+ORT_API_STATUS(OrtEnableNodeCounters, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableNodeCounters, _Inout_ OrtSessionOptions* options);
+
+// Let the kernels of the main graph cache what they derive from their input shapes, such as their output shapes,
+// and reuse it while the shapes of their inputs stay the same.
+ORT_API_STATUS(OrtEnableShapeCache, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableShapeCache, _Inout_ OrtSessionOptions* options);
+
+// Watch a graph input that often holds the same value in consecutive runs, such as an encoder output fed to each
+// step of a decoder. The nodes of the main graph that only depend on the watched inputs and on the initializers are
+// memoized: the runs whose watched inputs hold the same values as in the previous run reuse their outputs instead of
+// running them. Only applies to sequential execution.
+ORT_API_STATUS(OrtAddIncrementalExecutionInput, _Inout_ OrtSessionOptions* options, _In_ const char* input_name);
+
+// Record the allocations, reuses and releases of the tensors of each run and the extensions of the arenas. With
+// profiling enabled, they're written to the profile as "Memory" events, followed by the tensors in use at the peak
+// memory of the runs.
+ORT_API_STATUS(OrtEnableMemoryProfiling, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableMemoryProfiling, _Inout_ OrtSessionOptions* options);
+
+// Record a per node trace of one in every sample_rate runs into a ring buffer of the buffer_size most recent traces,
+// which OrtSessionDumpRunTraces returns on demand. A sample_rate of 0 samples no runs, but the runs whose
+// OrtRunOptions set OrtRunOptionsSetTraceRun are still traced. A buffer_size of 0 disables tracing.
+// By default no runs are sampled and 16 traces are kept.
+ORT_API_STATUS(OrtSetRunTraceSampling, _Inout_ OrtSessionOptions* options, int64_t sample_rate, size_t buffer_size);
+
+// The phases of a run reported to the callbacks of OrtSetRunTraceCallbacks.
+typedef enum OrtRunTraceSpanKind {
+  ORT_RUN_TRACE_SPAN_RUN = 0,     // an OrtRun call, which all the other spans of the run are in
+  ORT_RUN_TRACE_SPAN_FEED_COPY,   // the copy of the inputs to the devices of the nodes reading them
+  ORT_RUN_TRACE_SPAN_PARTITION,   // consecutive nodes run by one execution provider, with sequential execution
+  ORT_RUN_TRACE_SPAN_MEMCPY,      // a MemcpyFromHost or MemcpyToHost node
+  ORT_RUN_TRACE_SPAN_FETCH_COPY,  // the copy of the outputs to the devices they're requested on
+} OrtRunTraceSpanKind;
+
+typedef struct OrtRunTraceSpan {
+  OrtRunTraceSpanKind kind;
+  const char* name;      // the run tag for a run, the node name for a memcpy, the provider for a partition
+  const char* provider;  // the execution provider of a partition or memcpy, empty otherwise
+  const char* run_tag;   // the run tag of the run
+  int64_t run_id;        // the number of the run in the session, the same for all its spans
+  int64_t span_id;       // unique in the run, 0 for the run span
+  int64_t start_time_ns;  // wall clock time the span began, in nanoseconds since the Unix epoch
+  int64_t end_time_ns;    // wall clock time the span ended, 0 when it begins
+  size_t node_count;      // the nodes a partition ran, 0 when it begins
+  OrtErrorCode status;    // ORT_OK, or the error the span ended with
+} OrtRunTraceSpan;
+
+typedef void(ORT_API_CALL* OrtRunTraceCallback)(_In_ void* user_data, _In_ const OrtRunTraceSpan* span);
+
+// Report the phases of every run of the sessions created with options as spans, e.g. to export them to a distributed
+// tracing system: begin_span is called when a phase begins and end_span when it ends, on the thread running it, with
+// user_data. Only the nodes of the main graph are traced. The strings of a span are only valid during the call.
+// Either callback may be null. The callbacks must be thread safe, since concurrent runs call them concurrently.
+ORT_API_STATUS(OrtSetRunTraceCallbacks, _Inout_ OrtSessionOptions* options, _In_opt_ OrtRunTraceCallback begin_span,
+               _In_opt_ OrtRunTraceCallback end_span, _In_opt_ void* user_data);
+
 // Enable the memory pattern optimization.
 // The idea is if the input shapes are the same, we could trace the internal memory allocation
 // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -223,12 +438,53 @@ ORT_API_STATUS(OrtDisableProfiling, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtEnableMemPattern, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtDisableMemPattern, _Inout_ OrtSessionOptions* options);
 
+/**
+ * Configure the cache of memory patterns.
+ * \param shape_bucket_size input dims are rounded up to a multiple of this value to find a pattern, so that
+ *                          inputs of similar size share one. Must be positive. 1 requires exact shapes.
+ * \param max_patterns maximum number of patterns kept, least recently used evicted first. 0 for no limit.
+ */
+ORT_API_STATUS(OrtSetSessionMemPatternCacheOptions, _Inout_ OrtSessionOptions* options, int64_t shape_bucket_size,
+               size_t max_patterns);
+
 // Enable the memory arena on CPU
 // Arena may pre-allocate memory for future usage.
 // set this option to false if you don't want it.
 ORT_API_STATUS(OrtEnableCpuMemArena, _Inout_ OrtSessionOptions* options);
 ORT_API_STATUS(OrtDisableCpuMemArena, _Inout_ OrtSessionOptions* options);
 
+/**
+ * Back the large CPU allocations of the session, such as the regions of the CPU memory arena and the
+ * initializers, with huge pages to reduce TLB misses. Explicit huge pages are used if the system has them
+ * reserved, else transparent huge pages on Linux. Large pages on Windows need the SeLockMemoryPrivilege.
+ * Applies to the CPU execution provider created by the session, and to those appended to these options
+ * afterwards.
+ */
+ORT_API_STATUS(OrtEnableCpuMemHugePages, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableCpuMemHugePages, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Place the large CPU allocations of the session on a NUMA node. The default of -1 places them on the node
+ * set with OrtSetSessionThreadPoolNumaNode, if any, so that the intra-op threads read local memory.
+ */
+ORT_API_STATUS(OrtSetCpuMemNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+
+typedef enum OrtArenaExtendStrategy {
+  ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO = 0,
+  ORT_ARENA_EXTEND_SAME_AS_REQUESTED = 1
+} OrtArenaExtendStrategy;
+
+/**
+ * Configure the memory arenas of the CPU execution provider created by the session, and of the CPU and
+ * CUDA execution providers appended to these options afterwards.
+ * \param max_mem upper bound on the memory an arena holds. 0 for no limit.
+ * \param initial_chunk_size_bytes size of the first region an arena allocates. 0 for the default (1MB).
+ * \param idle_shrink_timeout_ms regions that have been unused for this long are freed. 0 to disable.
+ */
+ORT_API_STATUS(OrtSetSessionArenaConfig, _Inout_ OrtSessionOptions* options, size_t max_mem,
+               OrtArenaExtendStrategy arena_extend_strategy, size_t initial_chunk_size_bytes,
+               int64_t idle_shrink_timeout_ms);
+
 // < logger id to use for session output
 ORT_API_STATUS(OrtSetSessionLogId, _Inout_ OrtSessionOptions* options, const char* logid);
 
@@ -255,6 +511,80 @@ ORT_API_STATUS(OrtSetSessionGraphOptimizationLevel, _Inout_ OrtSessionOptions* o
  */
 ORT_API_STATUS(OrtSetSessionThreadPoolSize, _Inout_ OrtSessionOptions* options, int session_thread_pool_size);
 
+/**
+ * How many threads in the thread pool used to run independent nodes concurrently.
+ * Only used if sequential execution is disabled.
+ * \param inter_op_thread_pool_size <0, let the runtime choose a default. =0, Don't create extra threads.
+ *                                  >0, create a thread pool with size of this value.
+ */
+ORT_API_STATUS(OrtSetSessionInterOpThreadPoolSize, _Inout_ OrtSessionOptions* options, int inter_op_thread_pool_size);
+
+/**
+ * Pin the threads of the session thread pool (or the inter-op thread pool) to logical processors.
+ * Thread i runs on logical_processors[i % count]. Pass count = 0 to clear a previously set affinity.
+ */
+ORT_API_STATUS(OrtSetSessionThreadPoolAffinity, _Inout_ OrtSessionOptions* options,
+               _In_ const size_t* logical_processors, size_t count);
+ORT_API_STATUS(OrtSetSessionInterOpThreadPoolAffinity, _Inout_ OrtSessionOptions* options,
+               _In_ const size_t* logical_processors, size_t count);
+
+/**
+ * Restrict the threads of the session thread pool (or the inter-op thread pool) to the logical processors
+ * of a NUMA node. Ignored if an affinity was set for the same pool. Pass -1 to clear.
+ */
+ORT_API_STATUS(OrtSetSessionThreadPoolNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+ORT_API_STATUS(OrtSetSessionInterOpThreadPoolNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+
+/**
+ * How many microseconds a thread of the session thread pool (or the inter-op thread pool) keeps spinning for
+ * more work before it blocks. Spinning avoids the wake-up latency of the next parallel loop at the cost of
+ * CPU time. Default is 0.
+ */
+ORT_API_STATUS(OrtSetSessionThreadPoolSpinDuration, _Inout_ OrtSessionOptions* options, int spin_duration_us);
+ORT_API_STATUS(OrtSetSessionInterOpThreadPoolSpinDuration, _Inout_ OrtSessionOptions* options, int spin_duration_us);
+
+// Keep the threads of the session thread pool spinning for work during each Run, and let them block between runs.
+ORT_API_STATUS(OrtEnableLowLatencyRuns, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableLowLatencyRuns, _Inout_ OrtSessionOptions* options);
+
+// Use the thread pools owned by the OrtEnv instead of per session thread pools.
+// The OrtEnv must have been created with OrtCreateEnvWithGlobalThreadPools.
+ORT_API_STATUS(OrtEnableGlobalThreadPools, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableGlobalThreadPools, _Inout_ OrtSessionOptions* options);
+
+// Share the CPU initializers with the other sessions of the same model created from the same OrtEnv with this
+// enabled, instead of each session holding its own copy of the weights. The shared weights are read-only.
+ORT_API_STATUS(OrtEnableSharedInitializers, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableSharedInitializers, _Inout_ OrtSessionOptions* options);
+
+// Use the allocators registered with the OrtEnv through OrtRegisterAllocator.
+ORT_API_STATUS(OrtEnableEnvAllocators, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableEnvAllocators, _Inout_ OrtSessionOptions* options);
+
+// Replace the ZipMap nodes that produce graph outputs by their input, so that those outputs are float tensors with a
+// row of probabilities per sample, in the order of the class labels, instead of sequences of maps. The outputs keep
+// their names. Requires graph optimization level ORT_ENABLE_BASIC or higher.
+ORT_API_STATUS(OrtEnableZipMapElimination, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableZipMapElimination, _Inout_ OrtSessionOptions* options);
+
+// Quantize the constant weights of float MatMul and Gemm nodes to bits (4 or 8) with a scale for each block of
+// block_size rows (a power of 2, at least 16), and compute them with a kernel that dequantizes the weights on the fly
+// while the activations stay in float. This speeds up the matrix-vector products of decoders and trades accuracy for
+// it. bits 0 disables it. Requires graph optimization level ORT_ENABLE_EXTENDED or higher.
+ORT_API_STATUS(OrtSetSessionWeightOnlyQuantization, _Inout_ OrtSessionOptions* options, int bits, int block_size);
+
+// Run the nodes in an order that lowers the peak memory use of the intermediate tensors, estimated from their
+// inferred shapes, instead of the topological order of the graph. Only applies to sequential execution.
+ORT_API_STATUS(OrtEnableMemoryEfficientExecutionOrder, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS(OrtDisableMemoryEfficientExecutionOrder, _Inout_ OrtSessionOptions* options);
+
+/**
+ * Add a set of input shapes the session is warmed up for when it's created. See OrtSessionWarmup.
+ */
+ORT_API_STATUS(OrtAddSessionWarmupInputShapes, _Inout_ OrtSessionOptions* options,
+               _In_ const char* const* input_names, _In_ const int64_t* const* input_shapes,
+               _In_ const size_t* input_shape_lens, size_t input_len);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -269,6 +599,94 @@ ORT_API_STATUS(OrtSetSessionThreadPoolSize, _Inout_ OrtSessionOptions* options,
 ORT_API_STATUS(OrtSessionGetInputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 ORT_API_STATUS(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 
+/**
+ * Return the memory of the session's arenas that is not in use to the devices.
+ */
+ORT_API_STATUS(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess);
+
+/**
+ * Get the bytes of the session's arenas that are in use, e.g. to export them as a metric. Safe to call while
+ * the session runs.
+ */
+ORT_API_STATUS(OrtSessionGetMemoryArenaBytesInUse, _In_ const OrtSession* sess, _Out_ size_t* out);
+
+/**
+ * Get the bytes the session's arenas reserved from their devices and the bytes of those in use.
+ * \param allocator_name  the name of the allocators of the arenas to count, e.g. "Cpu" or "Cuda" to get the device
+ *                        memory held by CUDA, or NULL to count all of them.
+ */
+ORT_API_STATUS(OrtSessionGetMemoryArenaStats, _In_ const OrtSession* sess, _In_opt_ const char* allocator_name,
+               _Out_ size_t* bytes_reserved, _Out_ size_t* bytes_in_use);
+
+/**
+ * The time the phases of creating a session took, in microseconds. A phase that hasn't run is 0.
+ */
+typedef struct OrtSessionInitializationTimes {
+  int64_t load_us;                  // loading the model
+  int64_t initialize_us;            // initializing the session, including the phases below and any warm-up runs
+  int64_t graph_transformation_us;  // applying the graph optimizations, excluding the partitioning
+  int64_t graph_partitioning_us;    // assigning the nodes to the execution providers
+  int64_t initializer_loading_us;   // placing the initializers of the main graph on their devices
+  int64_t kernel_creation_us;       // creating the kernels of the main graph
+} OrtSessionInitializationTimes;
+
+ORT_API_STATUS(OrtSessionGetInitializationTimes, _In_ const OrtSession* sess,
+               _Out_ OrtSessionInitializationTimes* out);
+
+/**
+ * Counters of the kernel runs of a node since the session was created or the counters were reset.
+ */
+typedef struct OrtNodeCounters {
+  int64_t count;            // number of runs
+  int64_t total_ns;         // total compute time of the runs in nanoseconds
+  int64_t max_ns;           // longest compute time of a run in nanoseconds
+  int64_t bytes_allocated;  // total bytes of the output tensors of the runs
+} OrtNodeCounters;
+
+/**
+ * Get the number of nodes the session counts the kernel runs of, which is 0 unless OrtEnableNodeCounters was
+ * called on its options. The nodes are those of the main graph, in topological order.
+ */
+ORT_API_STATUS(OrtSessionGetNodeCounterCount, _In_ const OrtSession* sess, _Out_ size_t* out);
+
+/**
+ * \param value  name of the node at index, which should be freed by allocator after use
+ */
+ORT_API_STATUS(OrtSessionGetNodeCounterName, _In_ const OrtSession* sess, size_t index,
+               _Inout_ OrtAllocator* allocator, _Outptr_ char** value);
+
+/**
+ * Take a snapshot of the counters of the first count nodes into counters, without allocating, so that it can be
+ * called periodically while the session runs, e.g. to export the counters as metrics. The counters of a node that
+ * is running while they're read may be off by that run.
+ */
+ORT_API_STATUS(OrtSessionGetNodeCounters, _In_ const OrtSession* sess, _Out_ OrtNodeCounters* counters,
+               size_t count);
+
+/**
+ * Set the counters of all nodes to zero.
+ */
+ORT_API_STATUS(OrtSessionResetNodeCounters, _Inout_ OrtSession* sess);
+
+/**
+ * Get the buffered traces of the most recent sampled or requested runs in chrome tracing format, oldest first.
+ * Safe to call while the session runs.
+ * \param clear  if non-zero, the returned traces are dropped from the buffer
+ * \param out  should be freed by allocator after use
+ */
+ORT_API_STATUS(OrtSessionDumpRunTraces, _Inout_ OrtSession* sess, int clear, _Inout_ OrtAllocator* allocator,
+               _Outptr_ char** out);
+
+/**
+ * Run the session once with zero-filled inputs of the given shapes, so that the costs of a first run for those
+ * shapes (growing arenas, tracing memory patterns, per shape searches or compilation of execution providers)
+ * aren't paid by later runs. An input that isn't listed gets the shape of the model input, with 1 for symbolic
+ * dimensions. input_shapes[i] has input_shape_lens[i] dimensions.
+ */
+ORT_API_STATUS(OrtSessionWarmup, _Inout_ OrtSession* sess,
+               _In_ const char* const* input_names, _In_ const int64_t* const* input_shapes,
+               _In_ const size_t* input_shape_lens, size_t input_len);
+
 /**
  * \param out  should be freed by OrtReleaseTypeInfo after use
  */
@@ -306,6 +724,19 @@ ORT_API_STATUS(OrtRunOptionsSetTerminate, _Inout_ OrtRunOptions* options);
 // Unset the terminate flag to enable this OrtRunOptions instance being used in new OrtRun calls.
 ORT_API_STATUS(OrtRunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options);
 
+/**
+ * Make the OrtRun calls using this instance of OrtRunOptions fail once they have been executing for longer
+ * than timeout_in_ms milliseconds. Execution stops before the next node is run. 0 disables the timeout.
+ */
+ORT_API_STATUS(OrtRunOptionsSetRunTimeout, _Inout_ OrtRunOptions* options, int64_t timeout_in_ms);
+ORT_API_STATUS(OrtRunOptionsGetRunTimeout, _In_ const OrtRunOptions* options, _Out_ int64_t* out);
+
+/**
+ * If value is non-zero, the OrtRun calls using this instance of OrtRunOptions are traced into the session's trace
+ * buffer whether or not they're sampled. See OrtSetRunTraceSampling.
+ */
+ORT_API_STATUS(OrtRunOptionsSetTraceRun, _Inout_ OrtRunOptions* options, int value);
+
 /**
  * Create a tensor from an allocator. OrtReleaseValue will also release the buffer inside the output value
  * \param out Should be freed by calling OrtReleaseValue
@@ -353,6 +784,27 @@ ORT_API_STATUS(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ s
 ORT_API_STATUS(OrtGetStringTensorContent, _In_ const OrtValue* value, _Out_ void* s, size_t s_len,
                _Out_ size_t* offsets, size_t offsets_len);
 
+/**
+ * Fills a string tensor from the layout returned by OrtGetStringTensorContent, so the strings don't need to be
+ * null terminated or listed in a separate array of pointers.
+ * \param value A tensor created from OrtCreateTensor... function.
+ * \param s string contents. Each string is NOT null-terminated.
+ * \param s_len total data length. The last string ends at s_len.
+ * \param offsets offset of each string in s, one per element of the tensor
+ */
+ORT_API_STATUS(OrtFillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_ const void* s, size_t s_len,
+               _In_ const size_t* offsets, size_t offsets_len);
+
+/**
+ * Returns a view of each string of the tensor without copying it. data[i] points to the null-terminated contents of
+ * element i and lengths[i] is its length, not including the '\0'. The views are valid until the tensor is modified or
+ * released.
+ * \param value A tensor created from OrtCreateTensor... function, or a string output of a session.
+ * \param len length of data and lengths, at least the number of elements of the tensor
+ */
+ORT_API_STATUS(OrtGetStringTensorViews, _In_ const OrtValue* value, _Out_ const char** data, _Out_ size_t* lengths,
+               size_t len);
+
 /**
  * Don't free the 'out' value
  */
@@ -533,6 +985,16 @@ typedef struct OrtKernelInfo OrtKernelInfo;
 struct OrtKernelContext;
 typedef struct OrtKernelContext OrtKernelContext;
 
+// Native resources of a GPU execution provider that custom op kernels issue their work with
+typedef enum OrtGPUResource {
+  ORT_GPU_RESOURCE_COMPUTE_STREAM = 0,  // cudaStream_t the provider's kernels run on, nullptr for the default stream
+  ORT_GPU_RESOURCE_CUBLAS_HANDLE = 1,   // cublasHandle_t of the calling thread, bound to the compute stream
+  ORT_GPU_RESOURCE_CUDNN_HANDLE = 2,    // cudnnHandle_t of the calling thread, bound to the compute stream
+} OrtGPUResource;
+
+// Processes the elements [first, last) of a KernelContext_ParallelFor loop
+typedef void(ORT_API_CALL* OrtKernelParallelForFunc)(_In_opt_ void* param, size_t first, size_t last);
+
 struct OrtCustomOpApi {
   /*
    * These allow reading node attributes during kernel creation
@@ -557,6 +1019,26 @@ struct OrtCustomOpApi {
   OrtStatus*(ORT_API_CALL* KernelContext_GetInput)(_In_ const OrtKernelContext* context, _In_ size_t index, _Out_ const OrtValue** out);
   OrtStatus*(ORT_API_CALL* KernelContext_GetOutputCount)(_In_ const OrtKernelContext* context, _Out_ size_t* out);
   OrtStatus*(ORT_API_CALL* KernelContext_GetOutput)(_Inout_ OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count, _Outptr_ OrtValue** out);
+
+  /*
+   * Run fn over blocks of [0, total) on the intra-op thread pool of the session, which the calling thread joins, or
+   * on the calling thread if the session has none. cost_per_unit estimates the cycles an element takes, so that
+   * cheap loops run on fewer threads. fn is called concurrently.
+  */
+  OrtStatus*(ORT_API_CALL* KernelContext_ParallelFor)(_Inout_ OrtKernelContext* context, _In_ OrtKernelParallelForFunc fn, _In_opt_ void* param, size_t total, double cost_per_unit);
+
+  /*
+   * Allocate scratch memory from the allocator of the kernel's execution provider, e.g. its arena, rather than from
+   * the heap on every call. Free it with KernelContext_FreeScratch before KernelCompute returns.
+  */
+  OrtStatus*(ORT_API_CALL* KernelContext_AllocateScratch)(_Inout_ OrtKernelContext* context, size_t size, _Outptr_ void** out);
+  OrtStatus*(ORT_API_CALL* KernelContext_FreeScratch)(_Inout_ OrtKernelContext* context, _In_opt_ void* p);
+
+  /*
+   * Get a resource of the GPU execution provider the kernel runs on, so that the kernel enqueues its work in stream
+   * order with the other kernels instead of synchronizing the device. Fails for other execution providers.
+  */
+  OrtStatus*(ORT_API_CALL* KernelContext_GetGPUResource)(_In_ const OrtKernelContext* context, OrtGPUResource resource, _Out_ void** out);
 };
 typedef struct OrtCustomOpApi OrtCustomOpApi;
 
@@ -585,6 +1067,14 @@ struct OrtCustomOp {
   // Op kernel callbacks
   void(ORT_API_CALL* KernelCompute)(_In_ void* op_kernel, _In_ OrtKernelContext* context);
   void(ORT_API_CALL* KernelDestroy)(_In_ void* op_kernel);
+
+  // Since version 2. Hints for the memory planner, per output. Either may be nullptr.
+  // Returns the index of an input whose buffer the output may reuse if the input isn't used afterwards, or -1.
+  // The kernel must then produce the right result when the output and the input are the same buffer.
+  int(ORT_API_CALL* GetMayInplaceInput)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
+  // Returns the index of an input whose buffer the output always is, e.g. for an op that only changes the shape,
+  // or -1.
+  int(ORT_API_CALL* GetAliasInput)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
 };
 typedef struct OrtCustomOp OrtCustomOp;
 
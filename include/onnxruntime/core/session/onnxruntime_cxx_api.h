@@ -46,6 +46,8 @@ struct Exception : std::exception {
 ORT_DEFINE_RELEASE(MemoryInfo);
 ORT_DEFINE_RELEASE(CustomOpDomain);
 ORT_DEFINE_RELEASE(Env);
+ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(PreparedRun);
 ORT_DEFINE_RELEASE(RunOptions);
 ORT_DEFINE_RELEASE(Session);
 ORT_DEFINE_RELEASE(SessionOptions);
@@ -95,6 +97,8 @@ struct Unowned : T {
 struct AllocatorWithDefaultOptions;
 struct AllocatorInfo;
 struct Env;
+struct IoBinding;
+struct PreparedRun;
 struct TypeInfo;
 struct Value;
 
@@ -102,7 +106,14 @@ struct Env : Base<OrtEnv> {
   Env(nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level, _In_ const char* logid);
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
+  Env(OrtLoggingLevel default_logging_level, const char* logid, int intra_op_thread_pool_size,
+      int inter_op_thread_pool_size);
+  Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function,
+      void* logger_param, int intra_op_thread_pool_size, int inter_op_thread_pool_size);
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
+
+  Env& RegisterAllocator(OrtAllocator* allocator, bool use_arena);
+  Env& EnableAsyncLogging(size_t max_queued_messages);
 };
 
 struct CustomOpDomain : Base<OrtCustomOpDomain> {
@@ -129,6 +140,15 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // fail the Session::Run calls made using this RunOptions instance that execute for longer than timeout_in_ms.
+  // 0 disables the timeout.
+  RunOptions& SetRunTimeout(int64_t timeout_in_ms);
+  int64_t GetRunTimeout() const;
+
+  // trace the Session::Run calls made using this RunOptions instance whether or not they're sampled.
+  // See SessionOptions::SetRunTraceSampling.
+  RunOptions& SetTraceRun(bool trace_run);
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -139,21 +159,59 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions Clone() const;
 
   SessionOptions& SetThreadPoolSize(int session_thread_pool_size);
+  SessionOptions& SetInterOpThreadPoolSize(int inter_op_thread_pool_size);
+  SessionOptions& SetThreadPoolAffinity(const std::vector<size_t>& logical_processors);
+  SessionOptions& SetInterOpThreadPoolAffinity(const std::vector<size_t>& logical_processors);
+  SessionOptions& SetThreadPoolNumaNode(int numa_node);
+  SessionOptions& SetInterOpThreadPoolNumaNode(int numa_node);
+  SessionOptions& SetThreadPoolSpinDuration(int spin_duration_us);
+  SessionOptions& SetInterOpThreadPoolSpinDuration(int spin_duration_us);
+  SessionOptions& EnableLowLatencyRuns();
+  SessionOptions& DisableLowLatencyRuns();
+
+  SessionOptions& EnableGlobalThreadPools();
+  SessionOptions& AddWarmupInputShapes(const char* const* input_names, const int64_t* const* input_shapes,
+                                       const size_t* input_shape_lens, size_t input_count);
+  SessionOptions& DisableGlobalThreadPools();
+  SessionOptions& EnableSharedInitializers();
+  SessionOptions& DisableSharedInitializers();
+  SessionOptions& EnableEnvAllocators();
+  SessionOptions& DisableEnvAllocators();
+  SessionOptions& EnableZipMapElimination();
+  SessionOptions& DisableZipMapElimination();
+  SessionOptions& SetWeightOnlyQuantization(int bits, int block_size);
+  SessionOptions& EnableMemoryEfficientExecutionOrder();
+  SessionOptions& DisableMemoryEfficientExecutionOrder();
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
 
   SessionOptions& EnableCpuMemArena();
   SessionOptions& DisableCpuMemArena();
+  SessionOptions& EnableCpuMemHugePages();
+  SessionOptions& DisableCpuMemHugePages();
+  SessionOptions& SetCpuMemNumaNode(int numa_node);
+  SessionOptions& SetArenaConfig(size_t max_mem, OrtArenaExtendStrategy arena_extend_strategy,
+                                 size_t initial_chunk_size_bytes, int64_t idle_shrink_timeout_ms);
 
   SessionOptions& SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_file);
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
   SessionOptions& DisableProfiling();
+  SessionOptions& EnableProfilingHardwareCounters();
+  SessionOptions& DisableProfilingHardwareCounters();
+  SessionOptions& SetRunTraceSampling(int64_t sample_rate, size_t buffer_size);
+  SessionOptions& SetRunTraceCallbacks(OrtRunTraceCallback begin_span, OrtRunTraceCallback end_span,
+                                       void* user_data);
+  SessionOptions& EnableMemoryProfiling();
+  SessionOptions& DisableMemoryProfiling();
 
   SessionOptions& EnableMemPattern();
   SessionOptions& DisableMemPattern();
+  SessionOptions& SetMemPatternCacheOptions(int64_t shape_bucket_size, size_t max_patterns);
 
   SessionOptions& EnableSequentialExecution();
   SessionOptions& DisableSequentialExecution();
+  SessionOptions& EnableCriticalPathScheduling();
+  SessionOptions& DisableCriticalPathScheduling();
 
   SessionOptions& SetLogId(const char* logid);
 
@@ -171,13 +229,37 @@ struct Session : Base<OrtSession> {
   // Run for when there is a list of prealloated outputs
   void Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
+  // Run with the inputs and outputs of an IoBinding created for this session
+  void Run(const RunOptions& run_options, IoBinding& io_binding);
+  // Run with the input and output names of a PreparedRun created for this session. input_values and
+  // output_values have an entry per name, and a null output value is set to a newly allocated output.
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, Value* output_values);
+  // Enqueue a run that calls callback when it completes. See OrtRunAsync for the lifetime of the arguments.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, size_t output_count, OrtRunAsyncCallback callback, void* user_data);
+
+  // Run for each of run_count sets of input_count input values, which are laid out set after set, as are the
+  // run_count * output_count returned values. See OrtRunMany for when the sets are run as one batch.
+  std::vector<Value> RunMany(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                             size_t input_count, size_t run_count, const char* const* output_names, size_t output_count);
 
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
 
+  void ShrinkMemoryArenas();
+  size_t GetMemoryArenaBytesInUse() const;
+  // allocator_name is e.g. "Cpu" or "Cuda", or nullptr for all arenas. See OrtSessionGetMemoryArenaStats.
+  void GetMemoryArenaStats(const char* allocator_name, size_t& bytes_reserved, size_t& bytes_in_use) const;
+  OrtSessionInitializationTimes GetInitializationTimes() const;
+  void Warmup(const char* const* input_names, const int64_t* const* input_shapes, const size_t* input_shape_lens,
+              size_t input_count);
+
   char* GetInputName(size_t index, OrtAllocator* allocator) const;
   char* GetOutputName(size_t index, OrtAllocator* allocator) const;
 
+  // The traces of the most recent sampled runs. See OrtSessionDumpRunTraces.
+  char* DumpRunTraces(bool clear, OrtAllocator* allocator);
+
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
 };
@@ -223,6 +305,8 @@ struct Value : Base<OrtValue> {
 
   size_t GetStringTensorDataLength() const;
   void GetStringTensorContent(void* buffer, size_t buffer_length, size_t* offsets, size_t offsets_count) const;
+  void GetStringTensorViews(const char** data, size_t* lengths, size_t count) const;
+  void FillStringTensor(const void* buffer, size_t buffer_length, const size_t* offsets, size_t offsets_count);
 
   template <typename T>
   T* GetTensorMutableData();
@@ -231,6 +315,32 @@ struct Value : Base<OrtValue> {
   TensorTypeAndShapeInfo GetTensorTypeAndShapeInfo() const;
 };
 
+struct IoBinding : Base<OrtIoBinding> {
+  explicit IoBinding(nullptr_t) {}
+  explicit IoBinding(Session& session);
+
+  void BindInput(const char* name, const Value& value);
+  void BindOutput(const char* name, const Value& value);
+  // bind an output that is allocated by the run on the device described by memory_info
+  void BindOutput(const char* name, const OrtMemoryInfo* memory_info);
+
+  void SynchronizeInputs();
+  void SynchronizeOutputs();
+
+  void ClearInputs();
+  void ClearOutputs();
+
+  size_t GetOutputCount() const;
+  char* GetOutputName(size_t index, OrtAllocator* allocator) const;
+  std::vector<Value> GetOutputValues() const;
+};
+
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(nullptr_t) {}
+  PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
+};
+
 struct AllocatorWithDefaultOptions {
   AllocatorWithDefaultOptions();
 
@@ -284,6 +394,13 @@ struct CustomOpApi {
   size_t KernelContext_GetOutputCount(const OrtKernelContext* context);
   OrtValue* KernelContext_GetOutput(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
 
+  // Calls fn(first, last) on blocks of [0, total) on the intra-op thread pool of the session
+  template <typename Fn>
+  void KernelContext_ParallelFor(OrtKernelContext* context, size_t total, double cost_per_unit, const Fn& fn);
+  void* KernelContext_AllocateScratch(OrtKernelContext* context, size_t size);
+  void KernelContext_FreeScratch(OrtKernelContext* context, void* p);
+  void* KernelContext_GetGPUResource(const OrtKernelContext* context, OrtGPUResource resource);
+
  private:
   const OrtCustomOpApi& api_;
 };
@@ -305,10 +422,17 @@ struct CustomOpBase : OrtCustomOp {
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) { static_cast<TKernel*>(op_kernel)->Compute(context); };
     OrtCustomOp::KernelDestroy = [](void* op_kernel) { delete static_cast<TKernel*>(op_kernel); };
+
+    OrtCustomOp::GetMayInplaceInput = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetMayInplaceInput(index); };
+    OrtCustomOp::GetAliasInput = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetAliasInput(index); };
   }
 
   // Default implementation of GetExecutionProviderType that returns nullptr to default to the CPU provider
   const char* GetExecutionProviderType() const { return nullptr; }
+
+  // Default implementations of the memory planner hints, which don't let outputs share the buffers of inputs
+  int GetMayInplaceInput(size_t /*output_index*/) const { return -1; }
+  int GetAliasInput(size_t /*output_index*/) const { return -1; }
 };
 
 }  // namespace Ort
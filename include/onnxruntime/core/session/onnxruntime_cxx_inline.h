@@ -77,6 +77,30 @@ inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLog
   ORT_THROW_ON_ERROR(OrtCreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
 
+inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, int intra_op_thread_pool_size,
+                int inter_op_thread_pool_size) {
+  ORT_THROW_ON_ERROR(OrtCreateEnvWithGlobalThreadPools(default_warning_level, logid, intra_op_thread_pool_size,
+                                                       inter_op_thread_pool_size, &p_));
+}
+
+inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLoggingFunction logging_function,
+                void* logger_param, int intra_op_thread_pool_size, int inter_op_thread_pool_size) {
+  ORT_THROW_ON_ERROR(OrtCreateEnvWithCustomLoggerAndGlobalThreadPools(logging_function, logger_param,
+                                                                      default_warning_level, logid,
+                                                                      intra_op_thread_pool_size,
+                                                                      inter_op_thread_pool_size, &p_));
+}
+
+inline Env& Env::RegisterAllocator(OrtAllocator* allocator, bool use_arena) {
+  ORT_THROW_ON_ERROR(OrtRegisterAllocator(p_, allocator, use_arena ? 1 : 0));
+  return *this;
+}
+
+inline Env& Env::EnableAsyncLogging(size_t max_queued_messages) {
+  ORT_THROW_ON_ERROR(OrtEnableAsyncLogging(p_, max_queued_messages));
+  return *this;
+}
+
 inline CustomOpDomain::CustomOpDomain(const char* domain) {
   ORT_THROW_ON_ERROR(OrtCreateCustomOpDomain(domain, &p_));
 }
@@ -126,6 +150,22 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetRunTimeout(int64_t timeout_in_ms) {
+  ORT_THROW_ON_ERROR(OrtRunOptionsSetRunTimeout(p_, timeout_in_ms));
+  return *this;
+}
+
+inline int64_t RunOptions::GetRunTimeout() const {
+  int64_t out;
+  ORT_THROW_ON_ERROR(OrtRunOptionsGetRunTimeout(p_, &out));
+  return out;
+}
+
+inline RunOptions& RunOptions::SetTraceRun(bool trace_run) {
+  ORT_THROW_ON_ERROR(OrtRunOptionsSetTraceRun(p_, trace_run ? 1 : 0));
+  return *this;
+}
+
 inline SessionOptions::SessionOptions() {
   ORT_THROW_ON_ERROR(OrtCreateSessionOptions(&p_));
 }
@@ -141,6 +181,51 @@ inline SessionOptions& SessionOptions::SetThreadPoolSize(int session_thread_pool
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetInterOpThreadPoolSize(int inter_op_thread_pool_size) {
+  ORT_THROW_ON_ERROR(OrtSetSessionInterOpThreadPoolSize(p_, inter_op_thread_pool_size));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetThreadPoolAffinity(const std::vector<size_t>& logical_processors) {
+  ORT_THROW_ON_ERROR(OrtSetSessionThreadPoolAffinity(p_, logical_processors.data(), logical_processors.size()));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetInterOpThreadPoolAffinity(const std::vector<size_t>& logical_processors) {
+  ORT_THROW_ON_ERROR(OrtSetSessionInterOpThreadPoolAffinity(p_, logical_processors.data(), logical_processors.size()));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetThreadPoolNumaNode(int numa_node) {
+  ORT_THROW_ON_ERROR(OrtSetSessionThreadPoolNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetInterOpThreadPoolNumaNode(int numa_node) {
+  ORT_THROW_ON_ERROR(OrtSetSessionInterOpThreadPoolNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetThreadPoolSpinDuration(int spin_duration_us) {
+  ORT_THROW_ON_ERROR(OrtSetSessionThreadPoolSpinDuration(p_, spin_duration_us));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetInterOpThreadPoolSpinDuration(int spin_duration_us) {
+  ORT_THROW_ON_ERROR(OrtSetSessionInterOpThreadPoolSpinDuration(p_, spin_duration_us));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableLowLatencyRuns() {
+  ORT_THROW_ON_ERROR(OrtEnableLowLatencyRuns(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableLowLatencyRuns() {
+  ORT_THROW_ON_ERROR(OrtDisableLowLatencyRuns(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level) {
   ORT_THROW_ON_ERROR(OrtSetSessionGraphOptimizationLevel(p_, graph_optimization_level));
   return *this;
@@ -161,6 +246,37 @@ inline SessionOptions& SessionOptions::DisableProfiling() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableProfilingHardwareCounters() {
+  ORT_THROW_ON_ERROR(OrtEnableProfilingHardwareCounters(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableProfilingHardwareCounters() {
+  ORT_THROW_ON_ERROR(OrtDisableProfilingHardwareCounters(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetRunTraceSampling(int64_t sample_rate, size_t buffer_size) {
+  ORT_THROW_ON_ERROR(OrtSetRunTraceSampling(p_, sample_rate, buffer_size));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetRunTraceCallbacks(OrtRunTraceCallback begin_span,
+                                                            OrtRunTraceCallback end_span, void* user_data) {
+  ORT_THROW_ON_ERROR(OrtSetRunTraceCallbacks(p_, begin_span, end_span, user_data));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableMemoryProfiling() {
+  ORT_THROW_ON_ERROR(OrtEnableMemoryProfiling(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableMemoryProfiling() {
+  ORT_THROW_ON_ERROR(OrtDisableMemoryProfiling(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableMemPattern() {
   ORT_THROW_ON_ERROR(OrtEnableMemPattern(p_));
   return *this;
@@ -171,6 +287,72 @@ inline SessionOptions& SessionOptions::DisableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetMemPatternCacheOptions(int64_t shape_bucket_size, size_t max_patterns) {
+  ORT_THROW_ON_ERROR(OrtSetSessionMemPatternCacheOptions(p_, shape_bucket_size, max_patterns));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableGlobalThreadPools() {
+  ORT_THROW_ON_ERROR(OrtEnableGlobalThreadPools(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::AddWarmupInputShapes(const char* const* input_names, const int64_t* const* input_shapes,
+                                                            const size_t* input_shape_lens, size_t input_count) {
+  ORT_THROW_ON_ERROR(OrtAddSessionWarmupInputShapes(p_, input_names, input_shapes, input_shape_lens, input_count));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableGlobalThreadPools() {
+  ORT_THROW_ON_ERROR(OrtDisableGlobalThreadPools(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableSharedInitializers() {
+  ORT_THROW_ON_ERROR(OrtEnableSharedInitializers(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableSharedInitializers() {
+  ORT_THROW_ON_ERROR(OrtDisableSharedInitializers(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableEnvAllocators() {
+  ORT_THROW_ON_ERROR(OrtEnableEnvAllocators(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableEnvAllocators() {
+  ORT_THROW_ON_ERROR(OrtDisableEnvAllocators(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableZipMapElimination() {
+  ORT_THROW_ON_ERROR(OrtEnableZipMapElimination(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableZipMapElimination() {
+  ORT_THROW_ON_ERROR(OrtDisableZipMapElimination(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetWeightOnlyQuantization(int bits, int block_size) {
+  ORT_THROW_ON_ERROR(OrtSetSessionWeightOnlyQuantization(p_, bits, block_size));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableMemoryEfficientExecutionOrder() {
+  ORT_THROW_ON_ERROR(OrtEnableMemoryEfficientExecutionOrder(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableMemoryEfficientExecutionOrder() {
+  ORT_THROW_ON_ERROR(OrtDisableMemoryEfficientExecutionOrder(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableCpuMemArena() {
   ORT_THROW_ON_ERROR(OrtEnableCpuMemArena(p_));
   return *this;
@@ -181,6 +363,28 @@ inline SessionOptions& SessionOptions::DisableCpuMemArena() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableCpuMemHugePages() {
+  ORT_THROW_ON_ERROR(OrtEnableCpuMemHugePages(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCpuMemHugePages() {
+  ORT_THROW_ON_ERROR(OrtDisableCpuMemHugePages(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetCpuMemNumaNode(int numa_node) {
+  ORT_THROW_ON_ERROR(OrtSetCpuMemNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetArenaConfig(size_t max_mem, OrtArenaExtendStrategy arena_extend_strategy,
+                                                      size_t initial_chunk_size_bytes, int64_t idle_shrink_timeout_ms) {
+  ORT_THROW_ON_ERROR(OrtSetSessionArenaConfig(p_, max_mem, arena_extend_strategy, initial_chunk_size_bytes,
+                                              idle_shrink_timeout_ms));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableSequentialExecution() {
   ORT_THROW_ON_ERROR(OrtEnableSequentialExecution(p_));
   return *this;
@@ -191,6 +395,16 @@ inline SessionOptions& SessionOptions::DisableSequentialExecution() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableCriticalPathScheduling() {
+  ORT_THROW_ON_ERROR(OrtEnableCriticalPathScheduling(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCriticalPathScheduling() {
+  ORT_THROW_ON_ERROR(OrtDisableCriticalPathScheduling(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetLogId(const char* logid) {
   ORT_THROW_ON_ERROR(OrtSetSessionLogId(p_, logid));
   return *this;
@@ -225,6 +439,36 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ORT_THROW_ON_ERROR(OrtRun(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline void Session::Run(const RunOptions& run_options, IoBinding& io_binding) {
+  ORT_THROW_ON_ERROR(OrtRunWithBinding(p_, run_options, io_binding));
+}
+
+inline void Session::Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, Value* output_values) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ORT_THROW_ON_ERROR(OrtRunPrepared(p_, run_options, prepared_run, ort_input_values, ort_output_values));
+}
+
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, size_t output_count, OrtRunAsyncCallback callback, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  ORT_THROW_ON_ERROR(OrtRunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, callback, user_data));
+}
+
+inline std::vector<Value> Session::RunMany(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                                           size_t input_count, size_t run_count, const char* const* output_names, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < run_count * output_count; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ORT_THROW_ON_ERROR(OrtRunMany(p_, run_options, input_names, ort_input_values, input_count, run_count, output_names, output_count, ort_output_values));
+  return output_values;
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ORT_THROW_ON_ERROR(OrtSessionGetInputCount(p_, &out));
@@ -237,6 +481,32 @@ inline size_t Session::GetOutputCount() const {
   return out;
 }
 
+inline void Session::ShrinkMemoryArenas() {
+  ORT_THROW_ON_ERROR(OrtSessionShrinkMemoryArenas(p_));
+}
+
+inline size_t Session::GetMemoryArenaBytesInUse() const {
+  size_t out;
+  ORT_THROW_ON_ERROR(OrtSessionGetMemoryArenaBytesInUse(p_, &out));
+  return out;
+}
+
+inline void Session::GetMemoryArenaStats(const char* allocator_name, size_t& bytes_reserved,
+                                         size_t& bytes_in_use) const {
+  ORT_THROW_ON_ERROR(OrtSessionGetMemoryArenaStats(p_, allocator_name, &bytes_reserved, &bytes_in_use));
+}
+
+inline OrtSessionInitializationTimes Session::GetInitializationTimes() const {
+  OrtSessionInitializationTimes out;
+  ORT_THROW_ON_ERROR(OrtSessionGetInitializationTimes(p_, &out));
+  return out;
+}
+
+inline void Session::Warmup(const char* const* input_names, const int64_t* const* input_shapes,
+                            const size_t* input_shape_lens, size_t input_count) {
+  ORT_THROW_ON_ERROR(OrtSessionWarmup(p_, input_names, input_shapes, input_shape_lens, input_count));
+}
+
 inline char* Session::GetInputName(size_t index, OrtAllocator* allocator) const {
   char* out;
   ORT_THROW_ON_ERROR(OrtSessionGetInputName(p_, index, allocator, &out));
@@ -249,6 +519,12 @@ inline char* Session::GetOutputName(size_t index, OrtAllocator* allocator) const
   return out;
 }
 
+inline char* Session::DumpRunTraces(bool clear, OrtAllocator* allocator) {
+  char* out;
+  ORT_THROW_ON_ERROR(OrtSessionDumpRunTraces(p_, clear ? 1 : 0, allocator, &out));
+  return out;
+}
+
 inline TypeInfo Session::GetInputTypeInfo(size_t index) const {
   OrtTypeInfo* out;
   ORT_THROW_ON_ERROR(OrtSessionGetInputTypeInfo(p_, index, &out));
@@ -370,6 +646,14 @@ inline void Value::GetStringTensorContent(void* buffer, size_t buffer_length, si
   ORT_THROW_ON_ERROR(OrtGetStringTensorContent(p_, buffer, buffer_length, offsets, offsets_count));
 }
 
+inline void Value::GetStringTensorViews(const char** data, size_t* lengths, size_t count) const {
+  ORT_THROW_ON_ERROR(OrtGetStringTensorViews(p_, data, lengths, count));
+}
+
+inline void Value::FillStringTensor(const void* buffer, size_t buffer_length, const size_t* offsets, size_t offsets_count) {
+  ORT_THROW_ON_ERROR(OrtFillStringTensorFromBuffer(p_, buffer, buffer_length, offsets, offsets_count));
+}
+
 template <typename T>
 T* Value::GetTensorMutableData() {
   T* out;
@@ -389,6 +673,66 @@ inline TensorTypeAndShapeInfo Value::GetTensorTypeAndShapeInfo() const {
   return TensorTypeAndShapeInfo{output};
 }
 
+inline PreparedRun::PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ORT_THROW_ON_ERROR(OrtCreatePreparedRun(session, input_names, input_count, output_names, output_count, &p_));
+}
+
+inline IoBinding::IoBinding(Session& session) {
+  ORT_THROW_ON_ERROR(OrtCreateIoBinding(session, &p_));
+}
+
+inline void IoBinding::BindInput(const char* name, const Value& value) {
+  ORT_THROW_ON_ERROR(OrtIoBindingBindInput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const Value& value) {
+  ORT_THROW_ON_ERROR(OrtIoBindingBindOutput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const OrtMemoryInfo* memory_info) {
+  ORT_THROW_ON_ERROR(OrtIoBindingBindOutputToDevice(p_, name, memory_info));
+}
+
+inline void IoBinding::SynchronizeInputs() {
+  ORT_THROW_ON_ERROR(OrtIoBindingSynchronizeInputs(p_));
+}
+
+inline void IoBinding::SynchronizeOutputs() {
+  ORT_THROW_ON_ERROR(OrtIoBindingSynchronizeOutputs(p_));
+}
+
+inline void IoBinding::ClearInputs() {
+  ORT_THROW_ON_ERROR(OrtIoBindingClearInputs(p_));
+}
+
+inline void IoBinding::ClearOutputs() {
+  ORT_THROW_ON_ERROR(OrtIoBindingClearOutputs(p_));
+}
+
+inline size_t IoBinding::GetOutputCount() const {
+  size_t out;
+  ORT_THROW_ON_ERROR(OrtIoBindingGetOutputCount(p_, &out));
+  return out;
+}
+
+inline char* IoBinding::GetOutputName(size_t index, OrtAllocator* allocator) const {
+  char* out;
+  ORT_THROW_ON_ERROR(OrtIoBindingGetOutputName(p_, index, allocator, &out));
+  return out;
+}
+
+inline std::vector<Value> IoBinding::GetOutputValues() const {
+  std::vector<Value> output_values;
+  const size_t count = GetOutputCount();
+  for (size_t i = 0; i < count; i++) {
+    OrtValue* out;
+    ORT_THROW_ON_ERROR(OrtIoBindingGetOutputValue(p_, i, &out));
+    output_values.emplace_back(out);
+  }
+  return output_values;
+}
+
 //
 // Custom OP API Inlines
 //
@@ -503,4 +847,29 @@ inline OrtValue* CustomOpApi::KernelContext_GetOutput(OrtKernelContext* context,
   return out;
 }
 
+template <typename Fn>
+inline void CustomOpApi::KernelContext_ParallelFor(OrtKernelContext* context, size_t total, double cost_per_unit,
+                                                   const Fn& fn) {
+  OrtKernelParallelForFunc call_fn = [](void* param, size_t first, size_t last) {
+    (*static_cast<const Fn*>(param))(first, last);
+  };
+  ORT_THROW_ON_ERROR(api_.KernelContext_ParallelFor(context, call_fn, const_cast<Fn*>(&fn), total, cost_per_unit));
+}
+
+inline void* CustomOpApi::KernelContext_AllocateScratch(OrtKernelContext* context, size_t size) {
+  void* out;
+  ORT_THROW_ON_ERROR(api_.KernelContext_AllocateScratch(context, size, &out));
+  return out;
+}
+
+inline void CustomOpApi::KernelContext_FreeScratch(OrtKernelContext* context, void* p) {
+  ORT_THROW_ON_ERROR(api_.KernelContext_FreeScratch(context, p));
+}
+
+inline void* CustomOpApi::KernelContext_GetGPUResource(const OrtKernelContext* context, OrtGPUResource resource) {
+  void* out;
+  ORT_THROW_ON_ERROR(api_.KernelContext_GetGPUResource(context, resource, &out));
+  return out;
+}
+
 }  // namespace Ort
@@ -17,5 +17,5 @@ __author__ = "Microsoft"
 
 from onnxruntime.capi import onnxruntime_validation
 onnxruntime_validation.check_distro_info()
-from onnxruntime.capi.session import InferenceSession
-from onnxruntime.capi._pybind_state import get_device, RunOptions, SessionOptions, NodeArg, ModelMetadata, GraphOptimizationLevel
+from onnxruntime.capi.session import InferenceSession, IOBinding
+from onnxruntime.capi._pybind_state import get_device, RunOptions, SessionOptions, NodeArg, ModelMetadata, GraphOptimizationLevel, ArenaExtendStrategy, OrtValue
@@ -4,6 +4,8 @@
 #include "core/common/common.h"
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 #include "core/automl/featurizers/src/FeaturizerPrep/Featurizers/DateTimeFeaturizer.h"
 
@@ -38,5 +40,120 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>())
         .TypeConstraint("T2", DataTypeImpl::GetType<Microsoft::Featurizer::DateTimeFeaturizer::TimePoint>()),
     DateTimeTransformer);
+
+namespace {
+
+constexpr int64_t kSecondsPerDay = 24 * 60 * 60;
+
+// Floor division so that timestamps before the epoch land on the previous day.
+inline int64_t FloorDiv(int64_t a, int64_t b) {
+  const int64_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+inline bool IsLeapYear(int64_t y) {
+  return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+// Columns written by DateTimeTransformerBatch, one element per input timestamp.
+struct DatePartColumns {
+  int32_t* year;
+  uint8_t* month;
+  uint8_t* day;
+  uint8_t* hour;
+  uint8_t* minute;
+  uint8_t* second;
+  uint8_t* day_of_week;
+  uint16_t* day_of_year;
+  uint8_t* quarter_of_year;
+  uint8_t* week_of_month;
+};
+
+// Splits timestamps [first, last) into their UTC date parts. The calendar date is derived from the
+// day number with the proleptic Gregorian civil-from-days algorithm, which only needs integer
+// arithmetic on a 400 year era, so unlike gmtime there is no call into the C runtime per element.
+void ComputeDateParts(const int64_t* input, int64_t first, int64_t last, const DatePartColumns& out) {
+  for (int64_t i = first; i < last; ++i) {
+    const int64_t days = FloorDiv(input[i], kSecondsPerDay);
+    const int64_t seconds_of_day = input[i] - days * kSecondsPerDay;
+
+    // Shift the epoch to 0000-03-01 so that the leap day is the last day of the year.
+    const int64_t z = days + 719468;
+    const int64_t era = FloorDiv(z, 146097);
+    const int64_t doe = z - era * 146097;                                       // [0, 146096]
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const int64_t doy_from_march = doe - (365 * yoe + yoe / 4 - yoe / 100);     // [0, 365]
+    const int64_t mp = (5 * doy_from_march + 2) / 153;                          // [0, 11]
+    const int64_t d = doy_from_march - (153 * mp + 2) / 5 + 1;                  // [1, 31]
+    const int64_t m = mp < 10 ? mp + 3 : mp - 9;                                // [1, 12]
+    const int64_t y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+    const int64_t yday = m <= 2 ? doy_from_march - 306 : doy_from_march + 59 + (IsLeapYear(y) ? 1 : 0);
+
+    out.year[i] = static_cast<int32_t>(y);
+    out.month[i] = static_cast<uint8_t>(m);
+    out.day[i] = static_cast<uint8_t>(d);
+    out.hour[i] = static_cast<uint8_t>(seconds_of_day / 3600);
+    out.minute[i] = static_cast<uint8_t>(seconds_of_day / 60 % 60);
+    out.second[i] = static_cast<uint8_t>(seconds_of_day % 60);
+    // 1970-01-01 was a Thursday.
+    out.day_of_week[i] = static_cast<uint8_t>((days % 7 + 11) % 7);
+    out.day_of_year[i] = static_cast<uint16_t>(yday);
+    out.quarter_of_year[i] = static_cast<uint8_t>((m + 2) / 3);
+    out.week_of_month[i] = static_cast<uint8_t>((d - 1) / 7);
+  }
+}
+
+}  // namespace
+
+class DateTimeTransformerBatch final : public OpKernel {
+ public:
+  explicit DateTimeTransformerBatch(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+Status DateTimeTransformerBatch::Compute(OpKernelContext* ctx) const {
+  const auto* input_tensor = ctx->Input<Tensor>(0);
+  const TensorShape& shape = input_tensor->Shape();
+
+  DatePartColumns out;
+  out.year = ctx->Output(0, shape)->MutableData<int32_t>();
+  out.month = ctx->Output(1, shape)->MutableData<uint8_t>();
+  out.day = ctx->Output(2, shape)->MutableData<uint8_t>();
+  out.hour = ctx->Output(3, shape)->MutableData<uint8_t>();
+  out.minute = ctx->Output(4, shape)->MutableData<uint8_t>();
+  out.second = ctx->Output(5, shape)->MutableData<uint8_t>();
+  out.day_of_week = ctx->Output(6, shape)->MutableData<uint8_t>();
+  out.day_of_year = ctx->Output(7, shape)->MutableData<uint16_t>();
+  out.quarter_of_year = ctx->Output(8, shape)->MutableData<uint8_t>();
+  out.week_of_month = ctx->Output(9, shape)->MutableData<uint8_t>();
+
+  const int64_t* input = input_tensor->Data<int64_t>();
+  const int64_t total = shape.Size();
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    ComputeDateParts(input, 0, total, out);
+  } else {
+    // Each element is a few dozen integer operations and ten narrow stores.
+    constexpr double kCostPerElement = 64.0;
+    tp->ParallelForRange(0, total, kCostPerElement, [input, &out](int64_t first, int64_t last) {
+      ComputeDateParts(input, first, last, out);
+    });
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    DateTimeTransformerBatch,
+    kMSAutoMLDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T4", DataTypeImpl::GetTensorType<uint16_t>()),
+    DateTimeTransformerBatch);
 }  // namespace automl
 }  // namespace onnxruntime
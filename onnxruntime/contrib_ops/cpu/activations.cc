@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/activation/activations.h"
 #include "activations.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -25,5 +27,51 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     ThresholdedRelu<float>);
 
-} // namespace contrib
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    Gelu,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Gelu<float>);
+
+template <>
+Status ScaledTanh<float>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  Tensor* Y = context->Output(0, X->Shape());
+  const float* x_data = X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+  const float alpha = alpha_;
+  const float beta = beta_;
+
+  ParallelForElements(*context, X->Shape().Size(), 10.0, [alpha, beta, x_data, y_data](int64_t first, int64_t last) {
+    EigenVectorArrayMap<float> ym(y_data + first, last - first);
+    ym = ConstEigenVectorArrayMap<float>(x_data + first, last - first) * beta;
+    MlasComputeTanh(ym.data(), ym.data(), static_cast<size_t>(last - first));
+    ym *= alpha;
+  });
+
+  return Status::OK();
+}
+
+template <>
+Status Gelu<float>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  Tensor* Y = context->Output(0, X->Shape());
+  const float* x_data = X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasGeluActivation;
+
+  // The MLAS activation runs in place, so each block of X is copied to Y first.
+  ParallelForElements(*context, X->Shape().Size(), 16.0, [&activation, x_data, y_data](int64_t first, int64_t last) {
+    const size_t count = static_cast<size_t>(last - first);
+    std::copy_n(x_data + first, count, y_data + first);
+    MlasActivation(&activation, y_data + first, nullptr, 1, count, count);
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
 }  // namespace onnxruntime
@@ -28,5 +28,16 @@ class ScaledTanh final : public OpKernel {
   const float beta_;
 };
 
+template <>
+Status ScaledTanh<float>::Compute(OpKernelContext* context) const;
+
+template <typename T>
+class Gelu final : public OpKernel {
+ public:
+  Gelu(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
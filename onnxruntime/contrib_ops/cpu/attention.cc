@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/attention.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    ScaledDotProductAttention,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ScaledDotProductAttention<float>);
+
+namespace {
+
+// Multiplies the matrices of the broadcast batch dimensions as one batch.
+void BatchedSgemm(const MatMulComputeHelper& helper, float alpha, const float* A, const float* B, float* C,
+                  concurrency::ThreadPool* thread_pool) {
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  const size_t batch_size = helper.OutputOffsets().size();
+  std::vector<MLAS_SGEMM_PARAMETERS> gemm_params(batch_size);
+  for (size_t i = 0; i < batch_size; i++) {
+    auto& params = gemm_params[i];
+    params.M = M;
+    params.N = N;
+    params.K = K;
+    params.alpha = alpha;
+    params.A = A + helper.LeftOffsets()[i];
+    params.lda = K;
+    params.B = B + helper.RightOffsets()[i];
+    params.ldb = N;
+    params.C = C + helper.OutputOffsets()[i];
+    params.ldc = N;
+  }
+  MlasSgemmBatch(gemm_params.data(), batch_size, thread_pool);
+}
+
+// Adds the mask to the attention scores, broadcasting the mask like numpy.
+Status AddMask(const TensorShape& scores_shape, const Tensor& mask, float* scores,
+               concurrency::ThreadPool* thread_pool) {
+  const size_t rank = scores_shape.NumDimensions();
+  const auto& mask_dims = mask.Shape().GetDims();
+  if (mask_dims.size() > rank) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "mask ", mask.Shape(),
+                           " does not broadcast to the attention scores ", scores_shape);
+  }
+
+  // Compute the strides of the mask padded to the rank of the scores, where the broadcast
+  // dimensions have a stride of zero.
+  std::vector<int64_t> mask_strides(rank, 0);
+  int64_t stride = 1;
+  for (size_t i = 0; i < mask_dims.size(); i++) {
+    const size_t mask_axis = mask_dims.size() - 1 - i;
+    const size_t scores_axis = rank - 1 - i;
+    if (mask_dims[mask_axis] == scores_shape[scores_axis]) {
+      mask_strides[scores_axis] = stride;
+    } else if (mask_dims[mask_axis] != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "mask ", mask.Shape(),
+                             " does not broadcast to the attention scores ", scores_shape);
+    }
+    stride *= mask_dims[mask_axis];
+  }
+
+  const int64_t L = scores_shape[rank - 1];
+  const int64_t rows = scores_shape.SizeToDimension(rank - 1);
+  const float* mask_data = mask.Data<float>();
+  const bool broadcast_row = mask_strides[rank - 1] == 0;
+
+  auto add_rows = [&](int64_t first, int64_t last) {
+    for (int64_t row = first; row < last; row++) {
+      // Map the row index to the offset of the matching row of the mask.
+      int64_t mask_offset = 0;
+      int64_t index = row;
+      for (size_t axis = rank - 1; axis-- > 0;) {
+        mask_offset += (index % scores_shape[axis]) * mask_strides[axis];
+        index /= scores_shape[axis];
+      }
+      EigenVectorArrayMap<float> scores_row(scores + row * L, L);
+      if (broadcast_row) {
+        scores_row += mask_data[mask_offset];
+      } else {
+        scores_row += ConstEigenVectorArrayMap<float>(mask_data + mask_offset, L);
+      }
+    }
+  };
+
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelForRange(0, rows, static_cast<double>(L), add_rows);
+  } else {
+    add_rows(0, rows);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+template <>
+Status ScaledDotProductAttention<float>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* Q = context->Input<Tensor>(0);
+  const auto* K = context->Input<Tensor>(1);
+  const auto* V = context->Input<Tensor>(2);
+  const auto* mask = context->Input<Tensor>(3);
+
+  if (Q->Shape().NumDimensions() < 2 || K->Shape().NumDimensions() < 2 || V->Shape().NumDimensions() < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Q, K and V must have at least two dimensions");
+  }
+
+  MatMulComputeHelper scores_helper;
+  ORT_RETURN_IF_ERROR(scores_helper.Compute(Q->Shape(), K->Shape()));
+  const TensorShape& scores_shape = scores_helper.OutputShape();
+
+  MatMulComputeHelper output_helper;
+  ORT_RETURN_IF_ERROR(output_helper.Compute(scores_shape, V->Shape()));
+
+  Tensor* Y = context->Output(0, output_helper.OutputShape());
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto scores_buffer = IAllocator::MakeUniquePtr<float>(alloc, static_cast<size_t>(scores_shape.Size()));
+  float* scores = scores_buffer.get();
+
+  BatchedSgemm(scores_helper, scale_, Q->Data<float>(), K->Data<float>(), scores, thread_pool);
+
+  if (mask != nullptr) {
+    ORT_RETURN_IF_ERROR(AddMask(scores_shape, *mask, scores, thread_pool));
+  }
+
+  const size_t L = static_cast<size_t>(scores_shape[scores_shape.NumDimensions() - 1]);
+  const size_t rows = static_cast<size_t>(scores_shape.SizeToDimension(scores_shape.NumDimensions() - 1));
+  MlasComputeSoftmax(scores, scores, rows, L, false, thread_pool);
+
+  BatchedSgemm(output_helper, 1.0f, scores, V->Data<float>(), Y->MutableData<float>(), thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+Computes Y = Softmax(scale * Q * K + mask) * V over the last dimension of the attention scores.
+This replaces the MatMul/Div/Add/Softmax/MatMul chain of a transformer attention block with two
+batched GEMMs that are each dispatched to the thread pool once for all heads.
+*/
+template <typename T>
+class ScaledDotProductAttention final : public OpKernel {
+ public:
+  ScaledDotProductAttention(const OpKernelInfo& info)
+      : OpKernel(info), scale_(info.GetAttrOrDefault("scale", 1.0f)) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  const float scale_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
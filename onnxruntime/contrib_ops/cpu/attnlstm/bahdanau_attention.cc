@@ -20,6 +20,7 @@ BahdanauAttention<T>::BahdanauAttention(AllocatorPtr allocator, const logging::L
   values_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * memory_depth_, values_ptr_, true);
   keys_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, keys_ptr_, true);
   processed_query_ = Allocate(allocator_, batch_size_ * attn_depth_, processed_query_ptr_, true);
+  hidden_ = Allocate(allocator_, batch_size_ * max_memory_steps_ * attn_depth_, hidden_ptr_, false);
   mem_seq_lengths_ = Allocate(allocator_, batch_size_, mem_seq_lengths_ptr_, true);
 
   ORT_ENFORCE(!normalize_, "not support normalize yet.");
@@ -33,6 +34,11 @@ void BahdanauAttention<T>::SetWeights(
   attention_v_ = attn_weights;                   //[attn_depth_]
   query_layer_weights_ = query_layer_weights;    //[query_depth_, attn_depth_]
   memory_layer_weights_ = memory_layer_weights;  //[memory_depth_, attn_depth_]
+
+  packed_query_layer_weights_ =
+      IAllocator::MakeUniquePtr<void>(allocator_, MlasGemmPackBSize(attn_depth_, query_depth_));
+  MlasGemmPackB(CblasNoTrans, attn_depth_, query_depth_, query_layer_weights_.data(), attn_depth_,
+                packed_query_layer_weights_.get());
 }
 
 template <typename T>
@@ -79,30 +85,6 @@ void BahdanauAttention<T>::PrepareMemory(
                   keys_.data(), attn_depth_, ttp_);
 }
 
-template <typename T>
-static void SoftmaxInplace(const gsl::span<T>& alignments) {
-  T* x = alignments.data();
-  size_t len = alignments.size();
-
-  double sum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    T e = exp(x[i]);
-    sum += e;
-    x[i] = e;
-  }
-
-  if (sum == 0.0) {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(1.0 / len);
-    }
-  } else {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(x[i] / sum);
-    }
-  }
-}
-
 /**
   * Args:
   *     queries: Tensor, shape `[batch_size_, query_depth_]` to compare to keys.
@@ -115,43 +97,74 @@ void BahdanauAttention<T>::Compute(
     const gsl::span<T>& output,
     const gsl::span<T>& aligns) const {
   //process query in dense query layer without bias
-  math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                  batch_size_, attn_depth_, query_depth_, T{1.0},
-                  queries.data(), query_depth_,
-                  query_layer_weights_.data(), attn_depth_, T{0.0},
+  MlasSgemmPacked(CblasNoTrans, batch_size_, attn_depth_, query_depth_, 1.0f,
+                  queries.data(), query_depth_, packed_query_layer_weights_.get(), 0.0f,
                   processed_query_.data(), attn_depth_, ttp_);
 
   std::fill(aligns.begin(), aligns.end(), T{});
 
-  // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
-  for (int b = 0; b < batch_size_; b++) {
-    T* alignments = aligns.data() + b * max_memory_steps_;
-    const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
-    const T* query = processed_query_.data() + b * attn_depth_;
-
-    int mem_steps = mem_seq_lengths_[b];
-    for (int step = 0; step < mem_steps; step++) {
-      const T* keys_on_step = keys + step * attn_depth_;
-      T* dest = alignments + step;
+  // hidden = tanh(keys + processed_query) for the steps within the memory of each batch, one row per step.
+  auto hidden_rows = [this](int64_t first, int64_t last) {
+    for (int64_t row = first; row < last; row++) {
+      const int b = static_cast<int>(row / max_memory_steps_);
+      const int step = static_cast<int>(row % max_memory_steps_);
+      if (step >= mem_seq_lengths_[b]) {
+        continue;
+      }
 
-      // reduce_sum(v * tanh(keys[step] + query)) on last dimension
-      *dest = T(0.0);
+      const T* keys_on_step = keys_.data() + row * attn_depth_;
+      const T* query = processed_query_.data() + b * attn_depth_;
+      T* hidden = hidden_.data() + row * attn_depth_;
       for (int i = 0; i < attn_depth_; i++) {
-        *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
+        hidden[i] = keys_on_step[i] + query[i];
       }
+      MlasComputeTanh(hidden, hidden, attn_depth_);
     }
+  };
+
+  const int64_t num_rows = static_cast<int64_t>(batch_size_) * max_memory_steps_;
+  if (ttp_ != nullptr) {
+    ttp_->ParallelForRange(0, num_rows, static_cast<double>(attn_depth_) * 8, hidden_rows);
+  } else {
+    hidden_rows(0, num_rows);
+  }
 
-    SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
+  // alignments = reduce_sum(v * hidden, [2]) is a matrix/vector multiply per batch, and the context is the
+  // alignments times the values of the same steps. Each is one batched GEMM over the batches.
+  std::vector<MLAS_SGEMM_PARAMETERS> gemm_params(batch_size_);
+  for (int b = 0; b < batch_size_; b++) {
+    auto& params = gemm_params[b];
+    params.M = static_cast<size_t>(mem_seq_lengths_[b]);
+    params.N = 1;
+    params.K = attn_depth_;
+    params.A = hidden_.data() + b * max_memory_steps_ * attn_depth_;
+    params.lda = attn_depth_;
+    params.B = attention_v_.data();
+    params.ldb = 1;
+    params.C = aligns.data() + b * max_memory_steps_;
+    params.ldc = 1;
+  }
+  MlasSgemmBatch(gemm_params.data(), batch_size_, ttp_);
 
-    // Calculate the context
-    auto outspan = output.subspan(b * memory_depth_);
-    auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    1, memory_depth_, max_memory_steps_, T{1.0},
-                    alignments, max_memory_steps_,
-                    values.data(), memory_depth_, T{0.0},
-                    outspan.data(), memory_depth_, ttp_);
+  // Softmax over the steps within the memory, so the alignments of the steps past its end stay zero.
+  for (int b = 0; b < batch_size_; b++) {
+    T* alignments = aligns.data() + b * max_memory_steps_;
+    MlasComputeSoftmax(alignments, alignments, 1, static_cast<size_t>(mem_seq_lengths_[b]), false, nullptr);
+  }
+
+  for (int b = 0; b < batch_size_; b++) {
+    auto& params = gemm_params[b];
+    params.M = 1;
+    params.N = memory_depth_;
+    params.K = static_cast<size_t>(mem_seq_lengths_[b]);
+    params.A = aligns.data() + b * max_memory_steps_;
+    params.lda = max_memory_steps_;
+    params.B = values_.data() + b * max_memory_steps_ * memory_depth_;
+    params.ldb = memory_depth_;
+    params.C = output.data() + b * memory_depth_;
+    params.ldc = memory_depth_;
   }
+  MlasSgemmBatch(gemm_params.data(), batch_size_, ttp_);
 }
 
 template class BahdanauAttention<float>;
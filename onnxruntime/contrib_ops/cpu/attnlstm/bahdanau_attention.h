@@ -73,6 +73,13 @@ class BahdanauAttention : public IAttentionMechanism<T> {
   IAllocatorUniquePtr<T> processed_query_ptr_;
   gsl::span<T> processed_query_;
 
+  // query_layer_weights_ packed by MlasGemmPackB in SetWeights, as the query layer runs on every step.
+  IAllocatorUniquePtr<void> packed_query_layer_weights_;
+
+  // tanh(keys + processed query) of each memory step, [batch_size_, max_memory_steps_, attn_depth_].
+  IAllocatorUniquePtr<T> hidden_ptr_;
+  gsl::span<T> hidden_;
+
   IAllocatorUniquePtr<int> mem_seq_lengths_ptr_;
   gsl::span<int> mem_seq_lengths_;
 
@@ -0,0 +1,513 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(BeamSearch,
+                        kMSDomain,
+                        1,
+                        kCpuExecutionProvider,
+                        KernelDefBuilder()
+                            .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>())
+                            .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                        BeamSearch);
+
+struct BeamSearch::Info {
+  Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in, int num_caches)
+      : subgraph{subgraph_in} {
+    num_implicit_inputs = static_cast<int>(node.ImplicitInputDefs().size());
+    num_subgraph_inputs = 2 + num_caches;   // input_ids, position, past caches
+    num_subgraph_outputs = 1 + num_caches;  // logits, present caches
+
+    auto& subgraph_inputs = subgraph.GetInputs();
+    auto& subgraph_outputs = subgraph.GetOutputs();
+
+    ORT_ENFORCE(static_cast<size_t>(num_subgraph_inputs) == subgraph_inputs.size(),
+                "Graph in 'decoder' attribute of BeamSearch should have ", num_subgraph_inputs, " inputs. Found:",
+                subgraph_inputs.size());
+    ORT_ENFORCE(static_cast<size_t>(num_subgraph_outputs) == subgraph_outputs.size(),
+                "Graph in 'decoder' attribute of BeamSearch should have ", num_subgraph_outputs, " outputs. Found:",
+                subgraph_outputs.size());
+
+    subgraph_input_names.reserve(num_subgraph_inputs);
+    for (const auto* input : subgraph_inputs) {
+      subgraph_input_names.push_back(input->Name());
+    }
+
+    subgraph_output_names.reserve(num_subgraph_outputs);
+    for (const auto* output : subgraph_outputs) {
+      subgraph_output_names.push_back(output->Name());
+    }
+  }
+
+  const GraphViewer& subgraph;
+
+  int num_implicit_inputs;
+  int num_subgraph_inputs;
+  int num_subgraph_outputs;
+
+  std::vector<std::string> subgraph_input_names;
+  std::vector<std::string> subgraph_output_names;
+};
+
+namespace {
+
+template <typename T>
+OrtValue AllocateTensorValue(AllocatorPtr& allocator, const TensorShape& shape) {
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<T>(), shape, allocator);
+  return OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+struct Hypothesis {
+  std::vector<int64_t> tokens;
+  float score;
+};
+
+// The finished hypotheses of a batch entry, of which the num_beams best by length normalized score are kept.
+class BeamHypotheses {
+ public:
+  BeamHypotheses(size_t num_beams, float length_penalty) : num_beams_{num_beams}, length_penalty_{length_penalty} {}
+
+  float Normalize(float sum_log_probs, int64_t length) const {
+    return sum_log_probs / std::pow(static_cast<float>(length), length_penalty_);
+  }
+
+  void Add(std::vector<int64_t> tokens, int64_t length, float sum_log_probs) {
+    const float score = Normalize(sum_log_probs, length);
+    if (hypotheses_.size() == num_beams_ && !(score > hypotheses_.back().score)) {
+      return;
+    }
+    auto position = std::find_if(hypotheses_.begin(), hypotheses_.end(),
+                                 [score](const Hypothesis& hypothesis) { return hypothesis.score < score; });
+    hypotheses_.insert(position, Hypothesis{std::move(tokens), score});
+    if (hypotheses_.size() > num_beams_) {
+      hypotheses_.pop_back();
+    }
+  }
+
+  // Checks whether no running beam can improve on the finished hypotheses.
+  bool IsDone(float best_sum_log_probs, int64_t length) const {
+    return hypotheses_.size() == num_beams_ && hypotheses_.back().score >= Normalize(best_sum_log_probs, length);
+  }
+
+  const Hypothesis& Best() const { return hypotheses_.front(); }
+
+ private:
+  size_t num_beams_;
+  float length_penalty_;
+  std::vector<Hypothesis> hypotheses_;
+};
+
+// Selects the count largest logits of a row in descending order, the equal logits by token, as log probabilities.
+// The top elements are kept sorted while scanning the row, as count is small compared to the vocabulary.
+void SelectCandidates(const float* logits, int64_t vocab_size, int64_t count, float* scores, int64_t* tokens) {
+  const float max_logit = *std::max_element(logits, logits + vocab_size);
+  double sum = 0.0;
+  for (int64_t v = 0; v < vocab_size; ++v) {
+    sum += std::exp(static_cast<double>(logits[v] - max_logit));
+  }
+  const float log_sum_exp = max_logit + static_cast<float>(std::log(sum));
+
+  int64_t size = 0;
+  for (int64_t v = 0; v < vocab_size; ++v) {
+    const float logit = logits[v];
+    if (size == count && !(logit > scores[count - 1])) {
+      continue;
+    }
+    int64_t position = size < count ? size++ : count - 1;
+    while (position > 0 && scores[position - 1] < logit) {
+      scores[position] = scores[position - 1];
+      tokens[position] = tokens[position - 1];
+      --position;
+    }
+    scores[position] = logit;
+    tokens[position] = v;
+  }
+
+  for (int64_t i = 0; i < count; ++i) {
+    scores[i] -= log_sum_exp;
+  }
+}
+
+// Reorders the beams of a cache in place so that each beam holds the first positions of its parent beam. The beams
+// that continue themselves are not moved, and the parents that are overwritten are first saved to scratch.
+void ReorderCache(float* cache, float* scratch, const std::vector<int64_t>& parents, std::vector<char>& saved,
+                  int64_t num_heads, int64_t head_stride, int64_t prefix_size, concurrency::ThreadPool* tp) {
+  const int64_t num_rows = static_cast<int64_t>(parents.size());
+  const int64_t beam_stride = num_heads * head_stride;
+
+  std::fill(saved.begin(), saved.end(), static_cast<char>(0));
+  for (int64_t n = 0; n < num_rows; ++n) {
+    const int64_t parent = parents[n];
+    if (parent != n && parents[parent] != parent) {
+      saved[parent] = 1;
+    }
+  }
+
+  auto copy_beam = [num_heads, head_stride, prefix_size](const float* source, float* target) {
+    for (int64_t h = 0; h < num_heads; ++h) {
+      std::copy_n(source + h * head_stride, prefix_size, target + h * head_stride);
+    }
+  };
+
+  auto save_beams = [&](int64_t first, int64_t last) {
+    for (int64_t n = first; n < last; ++n) {
+      if (saved[n]) {
+        copy_beam(cache + n * beam_stride, scratch + n * beam_stride);
+      }
+    }
+  };
+
+  auto move_beams = [&](int64_t first, int64_t last) {
+    for (int64_t n = first; n < last; ++n) {
+      const int64_t parent = parents[n];
+      if (parent != n) {
+        const float* source = saved[parent] ? scratch : cache;
+        copy_beam(source + parent * beam_stride, cache + n * beam_stride);
+      }
+    }
+  };
+
+  const double cost = static_cast<double>(num_heads * prefix_size);
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, num_rows, cost, save_beams);
+    tp->ParallelForRange(0, num_rows, cost, move_beams);
+  } else {
+    save_beams(0, num_rows);
+    move_beams(0, num_rows);
+  }
+}
+
+}  // namespace
+
+BeamSearch::BeamSearch(const OpKernelInfo& info) : OpKernel(info) {
+  // make sure the attribute was present even though we don't need it here.
+  // The GraphProto is loaded as a Graph instance by main Graph::Resolve,
+  // and a SessionState instance for executing the subgraph is created by InferenceSession.
+  // This is available via Info().GetSubgraphSessionState("attribute_name") when Compute is called.
+  ONNX_NAMESPACE::GraphProto proto;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+  ORT_IGNORE_RETURN_VALUE(proto);
+
+  num_beams_ = info.GetAttrOrDefault<int64_t>("num_beams", 1);
+  ORT_ENFORCE(info.GetAttr<int64_t>("eos_token_id", &eos_token_id_).IsOK());
+  pad_token_id_ = info.GetAttrOrDefault<int64_t>("pad_token_id", 0);
+  length_penalty_ = info.GetAttrOrDefault<float>("length_penalty", 1.0f);
+  ORT_ENFORCE(info.GetAttr<int64_t>("num_layers", &num_layers_).IsOK());
+  ORT_ENFORCE(info.GetAttr<int64_t>("num_heads", &num_heads_).IsOK());
+  ORT_ENFORCE(info.GetAttr<int64_t>("head_size", &head_size_).IsOK());
+  ORT_ENFORCE(num_beams_ > 0 && num_layers_ > 0 && num_heads_ > 0 && head_size_ > 0,
+              "num_beams, num_layers, num_heads and head_size must be positive");
+}
+
+// we need this to be in the .cc so 'unique_ptr<Info> info_' can be handled
+BeamSearch::~BeamSearch() = default;
+
+common::Status BeamSearch::SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                                      const std::string& attribute_name,
+                                                      const SessionState& subgraph_session_state) {
+  ORT_ENFORCE(info_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+  ORT_UNUSED_PARAMETER(attribute_name);
+
+  const auto& node = Node();
+  info_ = std::make_unique<BeamSearch::Info>(node, *subgraph_session_state.GetGraphViewer(),
+                                             static_cast<int>(2 * num_layers_));
+
+  // the input_ids, position and cache feeds are created on CPU by Compute, so only the implicit inputs are
+  // looked up in the SessionState of the BeamSearch node
+  std::vector<std::string> feed_names = info_->subgraph_input_names;
+  for (auto& entry : node.ImplicitInputDefs()) {
+    feed_names.push_back(entry->Name());
+  }
+
+  std::vector<OrtDevice> feed_locations;
+  size_t start_at = info_->num_subgraph_inputs;
+  ORT_RETURN_IF_ERROR(controlflow::detail::FindDevicesForValues(session_state, feed_names, feed_locations, start_at));
+
+  std::unique_ptr<FeedsFetchesManager> ffm;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, info_->subgraph_output_names,
+                                                  subgraph_session_state.GetOrtValueNameIdxMap(), ffm));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(subgraph_session_state, *ffm));
+
+  // the logits and present caches are read on CPU. after the first step the fetches of the previous step are
+  // provided, so the subgraph writes its outputs to the same buffers in each step.
+  const auto& fetch_location = utils::FindMemoryInfoForValue(session_state, node.OutputDefs()[0]->Name());
+  std::vector<const OrtMemoryInfo*> fetch_locations(info_->num_subgraph_outputs, &fetch_location);
+  utils::FinalizeFeedFetchCopyInfo(subgraph_session_state, *ffm, feed_locations, fetch_locations);
+
+  feeds_fetches_manager_ = std::move(ffm);
+
+  return Status::OK();
+}
+
+Status BeamSearch::Compute(OpKernelContext* ctx) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  auto* session_state = ctx_internal->SubgraphSessionState("decoder");
+  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'decoder' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
+
+  const Tensor* input_ids = ctx->Input<Tensor>(0);
+  const Tensor* max_length_tensor = ctx->Input<Tensor>(1);
+
+  const auto& input_ids_dims = input_ids->Shape().GetDims();
+  if (input_ids_dims.size() != 2 || input_ids_dims[1] == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'BeamSearch' input 'input_ids' should have shape [batch_size, prompt_length] with a "
+                           "non-empty prompt. Got shape of ", input_ids->Shape());
+  }
+  if (max_length_tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "'BeamSearch' input 'max_length' should be a scalar tensor. Got shape of ",
+                           max_length_tensor->Shape());
+  }
+
+  const int64_t batch_size = input_ids_dims[0];
+  const int64_t prompt_length = input_ids_dims[1];
+  const int64_t max_length = *max_length_tensor->Data<int64_t>();
+  if (max_length < prompt_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "'BeamSearch' max_length ", max_length,
+                           " is shorter than the prompt length ", prompt_length);
+  }
+
+  Tensor* sequences_output = ctx->Output(0, {batch_size, max_length});
+  Tensor* scores_output = ctx->Output(1, {batch_size});
+  if (batch_size == 0) {
+    return Status::OK();
+  }
+
+  const int64_t num_beams = num_beams_;
+  const int64_t num_rows = batch_size * num_beams;
+  const int64_t num_caches = 2 * num_layers_;
+  const int64_t num_row_heads = num_rows * num_heads_;
+  const int64_t head_stride = max_length * head_size_;
+  const float lowest_score = -std::numeric_limits<float>::infinity();
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  // The caches hold all positions of each beam, so the decoder attends to the first position + 1 of them and masks
+  // the rest, which are zeroed so that they stay finite. The scratch buffer holds the beams moved by a reordering.
+  std::vector<OrtValue> caches;
+  caches.reserve(num_caches);
+  for (int64_t c = 0; c < num_caches; ++c) {
+    caches.push_back(AllocateTensorValue<float>(allocator, {num_rows, num_heads_, max_length, head_size_}));
+    std::fill_n(caches.back().GetMutable<Tensor>()->MutableData<float>(), num_row_heads * head_stride, 0.0f);
+  }
+  auto scratch = IAllocator::MakeUniquePtr<float>(allocator, static_cast<size_t>(num_row_heads * head_stride));
+  std::vector<char> saved(num_rows);
+
+  auto* position_shape = info_->subgraph.GetInputs()[1]->Shape();
+  const bool is_position_1d = position_shape != nullptr && position_shape->dim_size() == 1;
+  OrtValue input_ids_value = AllocateTensorValue<int64_t>(allocator, {num_rows, 1});
+  OrtValue position_value = AllocateTensorValue<int64_t>(allocator, is_position_1d ? TensorShape({1}) : TensorShape({}));
+  int64_t* step_input_ids = input_ids_value.GetMutable<Tensor>()->MutableData<int64_t>();
+  int64_t* position = position_value.GetMutable<Tensor>()->MutableData<int64_t>();
+
+  // This ordering is the same as used in SetupSubgraphExecutionInfo
+  std::vector<OrtValue> feeds;
+  feeds.reserve(info_->num_subgraph_inputs + info_->num_implicit_inputs);
+  feeds.push_back(input_ids_value);
+  feeds.push_back(position_value);
+  feeds.insert(feeds.end(), caches.begin(), caches.end());
+  for (const auto* entry : ctx_internal->GetImplicitInputs()) {
+    feeds.push_back(*entry);
+  }
+
+  // The sequences of the beams start with the prompt of their batch entry. Only the first beam of each batch entry
+  // is live at first, so that the first expansion does not select the same tokens for each beam.
+  std::vector<int64_t> sequences(num_rows * max_length);
+  std::vector<int64_t> next_sequences(num_rows * max_length);
+  const int64_t* prompts = input_ids->Data<int64_t>();
+  for (int64_t n = 0; n < num_rows; ++n) {
+    std::copy_n(prompts + (n / num_beams) * prompt_length, prompt_length, &sequences[n * max_length]);
+  }
+  std::vector<float> beam_scores(num_rows, lowest_score);
+  for (int64_t b = 0; b < batch_size; ++b) {
+    beam_scores[b * num_beams] = 0.0f;
+  }
+
+  std::vector<BeamHypotheses> hypotheses(batch_size, BeamHypotheses(num_beams, length_penalty_));
+  std::vector<char> done(batch_size, 0);
+
+  std::vector<float> candidate_scores;
+  std::vector<int64_t> candidate_tokens;
+  std::vector<int64_t> candidate_order;
+  std::vector<int64_t> parents(num_rows);
+  std::vector<int64_t> next_tokens(num_rows);
+  std::vector<float> next_scores(num_rows);
+
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  std::vector<OrtValue> fetches;
+  int64_t length = prompt_length;
+
+  // Each step feeds the token at position to the decoder, which attends to the caches of the previous positions and
+  // returns the keys and values of the position. The prompt is fed one token per step before the first selection.
+  for (int64_t pos = 0; pos + 1 < max_length; ++pos) {
+    for (int64_t n = 0; n < num_rows; ++n) {
+      step_input_ids[n] = sequences[n * max_length + pos];
+    }
+    *position = pos;
+
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*session_state, *feeds_fetches_manager_, feeds, fetches, {},
+                                               /*sequential_execution*/ true, ctx_internal->GetTerminationCheck(),
+                                               ctx_internal->Logger()));
+
+    for (int64_t c = 0; c < num_caches; ++c) {
+      const Tensor& present = fetches[c + 1].Get<Tensor>();
+      if (present.Shape().Size() != num_row_heads * head_size_) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "'BeamSearch' decoder output ", c + 1,
+                               " should have shape [batch_size * num_beams, num_heads, 1, head_size]. Got shape of ",
+                               present.Shape());
+      }
+      const float* present_data = present.Data<float>();
+      float* cache_data = caches[c].GetMutable<Tensor>()->MutableData<float>();
+      for (int64_t h = 0; h < num_row_heads; ++h) {
+        std::copy_n(present_data + h * head_size_, head_size_, cache_data + h * head_stride + pos * head_size_);
+      }
+    }
+
+    if (pos + 1 < prompt_length) {
+      continue;
+    }
+
+    const Tensor& logits = fetches[0].Get<Tensor>();
+    const auto& logits_dims = logits.Shape().GetDims();
+    if (logits_dims.size() != 2 || logits_dims[0] != num_rows || logits_dims[1] == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "'BeamSearch' decoder output 0 should have shape "
+                             "[batch_size * num_beams, vocab_size]. Got shape of ", logits.Shape());
+    }
+    const int64_t vocab_size = logits_dims[1];
+    const float* logits_data = logits.Data<float>();
+
+    // Each beam proposes its best 2 * num_beams tokens, so that num_beams of the candidates of a batch entry do not
+    // end the sequence.
+    const int64_t num_candidates = std::min(2 * num_beams, vocab_size);
+    candidate_scores.resize(num_rows * num_candidates);
+    candidate_tokens.resize(num_rows * num_candidates);
+    auto select_candidates = [&](int64_t first, int64_t last) {
+      for (int64_t n = first; n < last; ++n) {
+        float* scores = &candidate_scores[n * num_candidates];
+        SelectCandidates(logits_data + n * vocab_size, vocab_size, num_candidates, scores,
+                         &candidate_tokens[n * num_candidates]);
+        for (int64_t i = 0; i < num_candidates; ++i) {
+          scores[i] += beam_scores[n];
+        }
+      }
+    };
+    if (tp != nullptr) {
+      tp->ParallelForRange(0, num_rows, static_cast<double>(vocab_size) * 4, select_candidates);
+    } else {
+      select_candidates(0, num_rows);
+    }
+
+    const int64_t current_length = pos + 1;
+    candidate_order.resize(num_beams * num_candidates);
+    for (int64_t b = 0; b < batch_size; ++b) {
+      const int64_t first_row = b * num_beams;
+
+      // a finished batch entry decodes padding until the others finish
+      if (done[b]) {
+        for (int64_t k = 0; k < num_beams; ++k) {
+          parents[first_row + k] = first_row + k;
+          next_tokens[first_row + k] = pad_token_id_;
+          next_scores[first_row + k] = beam_scores[first_row + k];
+        }
+        continue;
+      }
+
+      const float* batch_scores = &candidate_scores[first_row * num_candidates];
+      const int64_t* batch_tokens = &candidate_tokens[first_row * num_candidates];
+      std::iota(candidate_order.begin(), candidate_order.end(), 0);
+      std::stable_sort(candidate_order.begin(), candidate_order.end(),
+                       [batch_scores](int64_t lhs, int64_t rhs) { return batch_scores[lhs] > batch_scores[rhs]; });
+
+      int64_t next_beam = 0;
+      for (int64_t rank = 0; rank < static_cast<int64_t>(candidate_order.size()) && next_beam < num_beams; ++rank) {
+        const int64_t candidate = candidate_order[rank];
+        const int64_t parent = first_row + candidate / num_candidates;
+        const int64_t token = batch_tokens[candidate];
+        if (token == eos_token_id_) {
+          // only an end of sequence among the best num_beams candidates finishes a hypothesis
+          if (rank < num_beams) {
+            std::vector<int64_t> tokens(&sequences[parent * max_length],
+                                        &sequences[parent * max_length] + current_length);
+            tokens.push_back(token);
+            hypotheses[b].Add(std::move(tokens), current_length, batch_scores[candidate]);
+          }
+          continue;
+        }
+        parents[first_row + next_beam] = parent;
+        next_tokens[first_row + next_beam] = token;
+        next_scores[first_row + next_beam] = batch_scores[candidate];
+        ++next_beam;
+      }
+      for (; next_beam < num_beams; ++next_beam) {
+        parents[first_row + next_beam] = first_row;
+        next_tokens[first_row + next_beam] = pad_token_id_;
+        next_scores[first_row + next_beam] = lowest_score;
+      }
+
+      done[b] = hypotheses[b].IsDone(next_scores[first_row], current_length);
+    }
+
+    // append the selected tokens to the sequences of their parents, and move the caches of the parents
+    for (int64_t n = 0; n < num_rows; ++n) {
+      std::copy_n(&sequences[parents[n] * max_length], current_length, &next_sequences[n * max_length]);
+      next_sequences[n * max_length + current_length] = next_tokens[n];
+    }
+    std::swap(sequences, next_sequences);
+    std::swap(beam_scores, next_scores);
+    length = current_length + 1;
+
+    for (int64_t c = 0; c < num_caches; ++c) {
+      ReorderCache(caches[c].GetMutable<Tensor>()->MutableData<float>(), scratch.get(), parents, saved,
+                   num_heads_, head_stride, current_length * head_size_, tp);
+    }
+
+    if (std::all_of(done.cbegin(), done.cend(), [](char is_done) { return is_done != 0; })) {
+      break;
+    }
+  }
+
+  // the running beams of the unfinished batch entries are hypotheses of the full length
+  for (int64_t b = 0; b < batch_size; ++b) {
+    if (done[b]) {
+      continue;
+    }
+    for (int64_t n = b * num_beams; n < (b + 1) * num_beams; ++n) {
+      hypotheses[b].Add(std::vector<int64_t>(&sequences[n * max_length], &sequences[n * max_length] + length),
+                        length, beam_scores[n]);
+    }
+  }
+
+  int64_t* sequences_data = sequences_output->MutableData<int64_t>();
+  float* scores_data = scores_output != nullptr ? scores_output->MutableData<float>() : nullptr;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const Hypothesis& best = hypotheses[b].Best();
+    int64_t* sequence = sequences_data + b * max_length;
+    std::copy(best.tokens.cbegin(), best.tokens.cend(), sequence);
+    std::fill(sequence + best.tokens.size(), sequence + max_length, pad_token_id_);
+    if (scores_data != nullptr) {
+      scores_data[b] = best.score;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/controlflow/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Runs the autoregressive decoding of a batch of prompts with beam search, calling the decoder subgraph once per
+// generated position. The key/value caches of the decoder are preallocated for the maximum length and updated in
+// place, and the selection and reordering of the beams happen in the kernel.
+class BeamSearch final : public OpKernel, public controlflow::IControlFlowKernel {
+ public:
+  BeamSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+  common::Status SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                            const std::string& attribute_name,
+                                            const SessionState& subgraph_session_state) override;
+
+  // hide internal implementation details via forward declaration.
+  struct Info;
+  ~BeamSearch();
+
+ private:
+  int64_t num_beams_;
+  int64_t eos_token_id_;
+  int64_t pad_token_id_;
+  float length_penalty_;
+  int64_t num_layers_;
+  int64_t num_heads_;
+  int64_t head_size_;
+
+  // Info and FeedsFetchesManager re-used for each subgraph execution.
+  std::unique_ptr<Info> info_;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/dynamic_quantize_matmul.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeMatMul<uint8_t>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    int8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>()),
+    DynamicQuantizeMatMul<int8_t>);
+
+template <typename T2>
+DynamicQuantizeMatMul<T2>::DynamicQuantizeMatMul(const OpKernelInfo& info) : OpKernel(info) {
+  // Pack a constant B once so it isn't repacked on every call.
+  const Tensor* b;
+  if (info.TryGetConstantInput(1, &b) && b->Shape().NumDimensions() == 2 &&
+      b->Shape()[0] > 0 && b->Shape()[1] > 0) {
+    const size_t K = static_cast<size_t>(b->Shape()[0]);
+    const size_t N = static_cast<size_t>(b->Shape()[1]);
+    const bool b_is_signed = std::is_same<T2, int8_t>::value;
+    auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+    packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, MlasGemmPackBSize(N, K, b_is_signed));
+    MlasGemmPackB(N, K, static_cast<const uint8_t*>(b->DataRaw()), N, b_is_signed, packed_b_.get());
+  }
+}
+
+template <typename T2>
+Status DynamicQuantizeMatMul<T2>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* a = context->Input<Tensor>(0);
+  const auto* b = context->Input<Tensor>(1);
+  const auto* b_scale = context->Input<Tensor>(2);
+  const auto* b_zero_point = context->Input<Tensor>(3);
+  const auto* bias = context->Input<Tensor>(4);
+
+  if (b->Shape().NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "DynamicQuantizeMatMul : B must be a 2-D tensor");
+  }
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = context->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  // validate the per column parameters of B
+  auto is_per_column = [N](const Tensor& tensor) {
+    return tensor.Shape().NumDimensions() == 1 && static_cast<size_t>(tensor.Shape()[0]) == N;
+  };
+
+  const float* b_scale_data = b_scale->template Data<float>();
+  const bool b_scale_per_column = !IsScalarOr1ElementVector(b_scale);
+  if (b_scale_per_column && !is_per_column(*b_scale)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "DynamicQuantizeMatMul : b_scale must be a scalar or 1D tensor with a value for each column");
+  }
+
+  uint8_t b_offset = 0;
+  const uint8_t* b_offsets = &b_offset;
+  bool per_column_zero_points = false;
+  if (b_zero_point != nullptr) {
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      b_offset = *static_cast<const uint8_t*>(b_zero_point->DataRaw());
+    } else {
+      if (!is_per_column(*b_zero_point)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "DynamicQuantizeMatMul : b_zero_point must be a scalar or 1D tensor with a value for each column");
+      }
+      b_offsets = static_cast<const uint8_t*>(b_zero_point->DataRaw());
+      per_column_zero_points = true;
+    }
+  }
+
+  const float* bias_data = nullptr;
+  if (bias != nullptr) {
+    if (!is_per_column(*bias)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DynamicQuantizeMatMul : bias must be a 1D tensor with a value for each column");
+    }
+    bias_data = bias->template Data<float>();
+  }
+
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // Quantize A to uint8 with a range that includes zero, so that zero is exactly representable.
+  const float* a_data = a->template Data<float>();
+  const size_t a_size = static_cast<size_t>(a->Shape().Size());
+
+  float a_min = 0.0f;
+  float a_max = 0.0f;
+  for (size_t i = 0; i < a_size; i++) {
+    a_min = std::min(a_min, a_data[i]);
+    a_max = std::max(a_max, a_data[i]);
+  }
+
+  float a_scale = (a_max - a_min) / 255.0f;
+  if (a_scale == 0.0f) {
+    a_scale = 1.0f;
+  }
+  const float a_zero_point = std::nearbyintf(std::min(255.0f, std::max(0.0f, -a_min / a_scale)));
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto a_quantized_buffer = IAllocator::MakeUniquePtr<uint8_t>(alloc, a_size);
+  uint8_t* a_quantized = a_quantized_buffer.get();
+
+  const float a_inverse_scale = 1.0f / a_scale;
+  for (size_t i = 0; i < a_size; i++) {
+    const float q = std::nearbyintf(a_data[i] * a_inverse_scale) + a_zero_point;
+    a_quantized[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, q)));
+  }
+
+  auto c_buffer = IAllocator::MakeUniquePtr<int32_t>(alloc, M * N);
+  int32_t* c = c_buffer.get();
+
+  MLAS_GEMM_U8X8_PARAMETERS gemm_params;
+  gemm_params.M = M;
+  gemm_params.N = N;
+  gemm_params.K = K;
+  gemm_params.lda = K;
+  gemm_params.ZeroPointA = static_cast<uint8_t>(a_zero_point);
+  gemm_params.ldb = N;
+  gemm_params.ZeroPointB = b_offsets;
+  gemm_params.BIsPacked = packed_b_ != nullptr;
+  gemm_params.BIsSigned = std::is_same<T2, int8_t>::value;
+  gemm_params.PerColumnZeroPoints = per_column_zero_points;
+  gemm_params.C = c;
+  gemm_params.ldc = N;
+
+  float* y_data = y->template MutableData<float>();
+
+  for (size_t batch = 0; batch < helper.OutputOffsets().size(); batch++) {
+    gemm_params.A = a_quantized + helper.LeftOffsets()[batch];
+    gemm_params.B = packed_b_ != nullptr ? packed_b_.get()
+                                         : static_cast<const uint8_t*>(b->DataRaw()) + helper.RightOffsets()[batch];
+    MlasGemm(&gemm_params, thread_pool);
+
+    // Dequantize the integer product and add the bias in a single pass.
+    float* y_batch = y_data + helper.OutputOffsets()[batch];
+    for (size_t m = 0; m < M; m++) {
+      const int32_t* c_row = c + m * N;
+      float* y_row = y_batch + m * N;
+      for (size_t n = 0; n < N; n++) {
+        const float scale = a_scale * b_scale_data[b_scale_per_column ? n : 0];
+        y_row[n] = static_cast<float>(c_row[n]) * scale + (bias_data != nullptr ? bias_data[n] : 0.0f);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
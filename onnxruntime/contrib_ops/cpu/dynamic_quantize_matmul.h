@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+Computes Y = A * B + bias for a float A and a quantized B. A is quantized to uint8 with a single
+scale and zero point computed from the range of its values, the product is computed by the MLAS
+integer GEMM and the dequantization by the scales of A and B is fused with the bias addition.
+*/
+template <typename T2>
+class DynamicQuantizeMatMul final : public OpKernel {
+ public:
+  DynamicQuantizeMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // B packed by MlasGemmPackB when it is a constant 2-D initializer
+  IAllocatorUniquePtr<void> packed_b_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    EmbeddingBag,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag<float>);
+
+template <typename T>
+Status EmbeddingBag<T>::Compute(OpKernelContext* context) const {
+  const auto* data = context->Input<Tensor>(0);
+  const auto* indices = context->Input<Tensor>(1);
+  const auto* offsets = context->Input<Tensor>(2);
+  const auto* per_sample_weights = context->Input<Tensor>(3);
+
+  int64_t num_bags;
+  ORT_RETURN_IF_ERROR(ValidateInputShapes(*data, *indices, offsets, per_sample_weights, num_bags));
+
+  Tensor* Y = context->Output(0, {num_bags, data->Shape()[1]});
+
+  MLDataType Tind_type = indices->DataType();
+  if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
+    return ComputeImpl<int32_t>(context, *data, *indices, offsets, per_sample_weights, *Y);
+  }
+  if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
+    return ComputeImpl<int64_t>(context, *data, *indices, offsets, per_sample_weights, *Y);
+  }
+
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in EmbeddingBag.");
+}
+
+template <typename T>
+template <typename Tind>
+Status EmbeddingBag<T>::ComputeImpl(OpKernelContext* context, const Tensor& data, const Tensor& indices,
+                                    const Tensor* offsets, const Tensor* per_sample_weights, Tensor& Y) const {
+  const int64_t num_embeddings = data.Shape()[0];
+  const int64_t D = data.Shape()[1];
+  const int64_t num_indices = indices.Shape().Size();
+  const int64_t num_bags = Y.Shape()[0];
+
+  const T* data_base = data.template Data<T>();
+  const Tind* indices_data = indices.template Data<Tind>();
+  const Tind* offsets_data = offsets != nullptr ? offsets->template Data<Tind>() : nullptr;
+  const T* weights_data = per_sample_weights != nullptr ? per_sample_weights->template Data<T>() : nullptr;
+  T* y_data = Y.template MutableData<T>();
+
+  // Check the values up front so that the pooling of the bags cannot fail midway.
+  for (int64_t i = 0; i < num_indices; i++) {
+    if (indices_data[i] < 0 || indices_data[i] >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", indices_data[i],
+                             " must be within the inclusive range [0,", num_embeddings - 1, "]");
+    }
+  }
+  if (offsets_data != nullptr) {
+    int64_t previous = 0;
+    for (int64_t b = 0; b < num_bags; b++) {
+      const int64_t offset = static_cast<int64_t>(offsets_data[b]);
+      if (offset < previous || offset > num_indices) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "offsets must be non-decreasing and within [0,", num_indices, "], offset=", offset);
+      }
+      previous = offset;
+    }
+  }
+
+  if (num_bags == 0 || D == 0) {
+    return Status::OK();
+  }
+
+  // Bags without offsets are the rows of the 2-D indices.
+  const int64_t bag_size = offsets_data == nullptr ? indices.Shape()[1] : 0;
+  auto bag_begin = [&](int64_t b) {
+    return offsets_data != nullptr ? static_cast<int64_t>(offsets_data[b]) : b * bag_size;
+  };
+
+  // Each bag accumulates its rows directly into the output row.
+  auto pool_bags = [&](int64_t first, int64_t last) {
+    for (int64_t b = first; b < last; b++) {
+      const int64_t begin = bag_begin(b);
+      const int64_t end = b + 1 < num_bags ? bag_begin(b + 1) : num_indices;
+      EigenVectorArrayMap<T> y_row(y_data + b * D, D);
+      y_row.setZero();
+      for (int64_t i = begin; i < end; i++) {
+        ConstEigenVectorArrayMap<T> data_row(data_base + static_cast<int64_t>(indices_data[i]) * D, D);
+        if (weights_data != nullptr) {
+          y_row += weights_data[i] * data_row;
+        } else {
+          y_row += data_row;
+        }
+      }
+      if (mean_ && end > begin) {
+        y_row /= static_cast<T>(end - begin);
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    const double rows_per_bag = static_cast<double>(num_indices) / static_cast<double>(num_bags);
+    tp->ParallelForRange(0, num_bags, (rows_per_bag + 1) * static_cast<double>(D), pool_bags);
+  } else {
+    pool_bags(0, num_bags);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
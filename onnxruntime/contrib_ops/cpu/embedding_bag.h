@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class EmbeddingBagBase {
+ protected:
+  EmbeddingBagBase(const OpKernelInfo& info) {
+    std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    ORT_ENFORCE(mode == "sum" || mode == "mean", "Invalid EmbeddingBag mode: ", mode);
+    mean_ = mode == "mean";
+  }
+
+  // Checks the shapes of the inputs and computes the number of bags. The values of indices and
+  // offsets are checked by the kernels that read them.
+  Status ValidateInputShapes(const Tensor& data, const Tensor& indices, const Tensor* offsets,
+                             const Tensor* per_sample_weights, int64_t& num_bags) const {
+    if (data.Shape().NumDimensions() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data must have two dimensions: ", data.Shape());
+    }
+    if (offsets != nullptr) {
+      if (indices.Shape().NumDimensions() != 1 || offsets->Shape().NumDimensions() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "indices and offsets must have one dimension: ", indices.Shape(), ", ",
+                               offsets->Shape());
+      }
+      num_bags = offsets->Shape()[0];
+    } else {
+      if (indices.Shape().NumDimensions() != 2) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "indices must have two dimensions without offsets: ", indices.Shape());
+      }
+      num_bags = indices.Shape()[0];
+    }
+    if (per_sample_weights != nullptr && per_sample_weights->Shape() != indices.Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "per_sample_weights must have the shape of indices: ", per_sample_weights->Shape(),
+                             ", ", indices.Shape());
+    }
+    return Status::OK();
+  }
+
+  bool mean_;
+};
+
+template <typename T>
+class EmbeddingBag final : public OpKernel, protected EmbeddingBagBase {
+ public:
+  EmbeddingBag(const OpKernelInfo& info) : OpKernel(info), EmbeddingBagBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(OpKernelContext* context, const Tensor& data, const Tensor& indices, const Tensor* offsets,
+                     const Tensor* per_sample_weights, Tensor& Y) const;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
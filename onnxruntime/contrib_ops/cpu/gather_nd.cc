@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "contrib_ops/cpu/gather_nd.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace contrib     {
@@ -93,31 +94,62 @@ Status GatherND::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ? 
                               PrepareForCompute<int32_t>(context, p) : PrepareForCompute<int64_t>(context, p));
 
-  return nullptr == p.input_str_base ? GatherNumber(p) : GatherString(p);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
-Status GatherND::GatherNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + i * p.bytes_to_copy,
-           p.input_base + p.element_offsets[i] * p.element_bytes,
-           p.bytes_to_copy);
+// Copies the slices of the offsets in [first, last) as elements of type T, for slices of a single element.
+template <typename T>
+static void GatherElements(const uint8_t* input_base, uint8_t* output_base, const uint64_t* element_offsets,
+                           int64_t first, int64_t last) {
+  const auto* input = reinterpret_cast<const T*>(input_base);
+  auto* output = reinterpret_cast<T*>(output_base);
+  for (int64_t i = first; i < last; ++i) {
+    output[i] = input[element_offsets[i]];
+  }
+}
+
+static void RunOnThreadPool(concurrency::ThreadPool* tp, int64_t total, double cost_per_unit,
+                            const std::function<void(int64_t, int64_t)>& fn) {
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, total, cost_per_unit, fn);
+  } else {
+    fn(0, total);
+  }
+}
+
+Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
+  const auto total = static_cast<int64_t>(p.element_offsets.size());
+  if (p.bytes_to_copy == sizeof(uint32_t)) {
+    RunOnThreadPool(tp, total, sizeof(uint32_t), [&p](int64_t first, int64_t last) {
+      GatherElements<uint32_t>(p.input_base, p.output_base, p.element_offsets.data(), first, last);
+    });
+  } else if (p.bytes_to_copy == sizeof(uint64_t)) {
+    RunOnThreadPool(tp, total, sizeof(uint64_t), [&p](int64_t first, int64_t last) {
+      GatherElements<uint64_t>(p.input_base, p.output_base, p.element_offsets.data(), first, last);
+    });
+  } else {
+    RunOnThreadPool(tp, total, static_cast<double>(p.bytes_to_copy), [&p](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) {
+        memcpy(p.output_base + i * p.bytes_to_copy,
+               p.input_base + p.element_offsets[i] * p.element_bytes,
+               p.bytes_to_copy);
+      }
+    });
   }
 
   return Status::OK();
 }
 
-Status GatherND::GatherString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) const {
+  const auto total = static_cast<int64_t>(p.element_offsets.size());
+  RunOnThreadPool(tp, total, static_cast<double>(p.bytes_to_copy), [&p](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) {
+      for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
+        p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+      }
     }
-  }
+  });
 
   return Status::OK();
 }
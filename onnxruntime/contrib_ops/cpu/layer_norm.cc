@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/layer_norm.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/common.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    LayerNormalization,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    LayerNorm<float>);
+
+template <typename T>
+Status LayerNorm<T>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  const auto* X = context->Input<Tensor>(0);
+  const auto* scale = context->Input<Tensor>(1);
+  const auto* bias = context->Input<Tensor>(2);
+  const TensorShape& x_shape = X->Shape();
+
+  const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+  const int64_t N = x_shape.SizeToDimension(axis);
+  const int64_t D = x_shape.SizeFromDimension(axis);
+
+  if (scale->Shape().Size() != D || (bias != nullptr && bias->Shape().Size() != D)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Scale and B must have the shape of the normalized dimensions of X: ", x_shape,
+                           ", axis: ", axis_);
+  }
+
+  Tensor* Y = context->Output(0, x_shape);
+
+  const T* x_data = X->template Data<T>();
+  const T* scale_data = scale->template Data<T>();
+  const T* bias_data = bias != nullptr ? bias->template Data<T>() : nullptr;
+  T* y_data = Y->template MutableData<T>();
+  const T epsilon = static_cast<T>(epsilon_);
+
+  // Each row is normalized independently with two passes over the row, one to reduce the
+  // mean and one to reduce the variance of the centered row.
+  auto normalize_rows = [&](int64_t first, int64_t last) {
+    ConstEigenVectorArrayMap<T> scale_vec(scale_data, D);
+    for (int64_t row = first; row < last; row++) {
+      ConstEigenVectorArrayMap<T> x_row(x_data + row * D, D);
+      EigenVectorArrayMap<T> y_row(y_data + row * D, D);
+      const T mean = x_row.mean();
+      y_row = x_row - mean;
+      const T inv_std_dev = static_cast<T>(1) / std::sqrt(y_row.square().mean() + epsilon);
+      if (bias_data != nullptr) {
+        y_row = y_row * inv_std_dev * scale_vec + ConstEigenVectorArrayMap<T>(bias_data, D);
+      } else {
+        y_row = y_row * inv_std_dev * scale_vec;
+      }
+    }
+  };
+
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, N, static_cast<double>(D) * 8, normalize_rows);
+  } else {
+    normalize_rows(0, N);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/matmul_nbits.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+namespace {
+Status ValidateQuantizedB(const Tensor& b, const Tensor& scales, size_t K, size_t N, size_t bits, size_t block_size) {
+  const size_t block_count = (K + block_size - 1) / block_size;
+  if (static_cast<size_t>(b.Shape().Size()) != N * block_count * block_size * bits / 8) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "MatMulNBits : B must have N * ceil(K / block_size) * block_size * bits / 8 elements");
+  }
+  if (static_cast<size_t>(scales.Shape().Size()) != N * block_count) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "MatMulNBits : scales must have N * ceil(K / block_size) elements");
+  }
+  return Status::OK();
+}
+}  // namespace
+
+MatMulNBits::MatMulNBits(const OpKernelInfo& info) : OpKernel(info) {
+  K_ = static_cast<size_t>(info.GetAttrOrDefault<int64_t>("K", 0));
+  N_ = static_cast<size_t>(info.GetAttrOrDefault<int64_t>("N", 0));
+  bits_ = static_cast<size_t>(info.GetAttrOrDefault<int64_t>("bits", 0));
+  block_size_ = static_cast<size_t>(info.GetAttrOrDefault<int64_t>("block_size", 0));
+
+  ORT_ENFORCE(K_ > 0 && N_ > 0, "MatMulNBits : K and N must be positive");
+  ORT_ENFORCE(bits_ == 4 || bits_ == 8, "MatMulNBits : bits must be 4 or 8");
+  ORT_ENFORCE(block_size_ >= 16 && (block_size_ & (block_size_ - 1)) == 0,
+              "MatMulNBits : block_size must be a power of 2 and at least 16");
+
+  // Pack constant weights and scales once so they aren't repacked on every call.
+  const Tensor* b;
+  const Tensor* scales;
+  if (info.TryGetConstantInput(1, &b) && info.TryGetConstantInput(2, &scales)) {
+    ORT_THROW_IF_ERROR(ValidateQuantizedB(*b, *scales, K_, N_, bits_, block_size_));
+    auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+    packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, MlasBlockQuantGemmPackBSize(N_, K_, bits_, block_size_));
+    MlasBlockQuantGemmPackB(N_, K_, bits_, block_size_, b->Data<uint8_t>(), scales->Data<float>(), packed_b_.get());
+  }
+}
+
+Status MatMulNBits::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* a = context->Input<Tensor>(0);
+  const auto* bias = context->Input<Tensor>(3);
+
+  const auto& a_shape = a->Shape();
+  if (a_shape.NumDimensions() == 0 || static_cast<size_t>(a_shape[a_shape.NumDimensions() - 1]) != K_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MatMulNBits : the last dimension of A must be K");
+  }
+
+  std::vector<int64_t> y_dims(a_shape.GetDims());
+  y_dims.back() = static_cast<int64_t>(N_);
+  Tensor* y = context->Output(0, y_dims);
+
+  const float* bias_data = nullptr;
+  if (bias != nullptr) {
+    if (bias->Shape().NumDimensions() != 1 || static_cast<size_t>(bias->Shape()[0]) != N_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "MatMulNBits : bias must be a 1D tensor with a value for each column");
+    }
+    bias_data = bias->Data<float>();
+  }
+
+  const size_t M = static_cast<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+  if (M == 0) {
+    return Status::OK();
+  }
+
+  const void* packed_b = packed_b_.get();
+  IAllocatorUniquePtr<void> packed_b_buffer;
+  if (packed_b == nullptr) {
+    const auto* b = context->Input<Tensor>(1);
+    const auto* scales = context->Input<Tensor>(2);
+    ORT_RETURN_IF_ERROR(ValidateQuantizedB(*b, *scales, K_, N_, bits_, block_size_));
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    packed_b_buffer = IAllocator::MakeUniquePtr<void>(alloc, MlasBlockQuantGemmPackBSize(N_, K_, bits_, block_size_));
+    MlasBlockQuantGemmPackB(N_, K_, bits_, block_size_, b->Data<uint8_t>(), scales->Data<float>(),
+                            packed_b_buffer.get());
+    packed_b = packed_b_buffer.get();
+  }
+
+  MlasBlockQuantGemm(M, N_, K_, a->Data<float>(), K_, packed_b, bias_data, y->MutableData<float>(), N_, thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+Computes Y = A * B + bias for a float A and a B of 4-bit or 8-bit weights quantized in blocks of rows,
+each block of each column with its own scale. The weights are dequantized on the fly by the MLAS block
+quantized GEMM, which reads a quarter or an eighth of the bytes of float weights, so a decoder step with a
+few rows of A is faster and the weights take less memory.
+*/
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  size_t K_;
+  size_t N_;
+  size_t bits_;
+  size_t block_size_;
+
+  // B and the scales packed by MlasBlockQuantGemmPackB when both are constant initializers
+  IAllocatorUniquePtr<void> packed_b_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
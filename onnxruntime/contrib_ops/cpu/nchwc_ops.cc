@@ -68,6 +68,14 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Upsample,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcUpsample);
+
 template <typename T>
 Status ReorderInput<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -144,6 +152,59 @@ Status NchwcConv::Compute(OpKernelContext* context) const {
     }
   }
 
+  const auto* Bdata = B != nullptr ? B->template Data<float>() : nullptr;
+  auto* thread_pool = const_cast<concurrency::ThreadPool*>(static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
+
+  // Use the Winograd algorithm if MLAS selects it for a single group of blocked channels with a
+  // constant W.
+  if (winograd_alloc_ != nullptr && ConvBase::group_ == 1 && (X_shape[1] % nchwc_block_size) == 0) {
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+    MlasConvPrepare(&Parameters,
+                    kernel_shape.size(),
+                    static_cast<size_t>(X_shape[0]),
+                    1,
+                    static_cast<size_t>(X_shape[1]),
+                    X_shape.GetDims().data() + 2,
+                    kernel_shape.data(),
+                    dilations.data(),
+                    pads.data(),
+                    strides.data(),
+                    Y_dims.data() + 2,
+                    static_cast<size_t>(W_shape[0]),
+                    &activation_,
+                    &WorkingBufferSize,
+                    thread_pool);
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+      const float* transformed_filter;
+      {
+        std::lock_guard<OrtMutex> lock(winograd_mutex_);
+        auto& winograd_filter = winograd_filters_[Parameters.u.Winograd.TileSize == 4 ? 1 : 0];
+        if (!winograd_filter) {
+          winograd_filter = IAllocator::MakeUniquePtr<float>(winograd_alloc_, MlasConvWinogradFilterSize(&Parameters));
+          MlasNchwcConvWinogradTransformFilter(&Parameters, W->template Data<float>(), winograd_filter.get());
+        }
+        transformed_filter = winograd_filter.get();
+      }
+
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+      BufferUniquePtr working_buffer(alloc->Alloc(sizeof(float) * WorkingBufferSize), BufferDeleter(alloc));
+
+      MlasNchwcConvWinograd(&Parameters,
+                            X->template Data<float>(),
+                            transformed_filter,
+                            Bdata,
+                            static_cast<float*>(working_buffer.get()),
+                            y_data,
+                            Sum == nullptr,
+                            thread_pool);
+
+      return Status::OK();
+    }
+  }
+
   MlasNchwcConv(kernel_shape.size(),
                 X_shape.GetDims().data(),
                 kernel_shape.data(),
@@ -154,11 +215,11 @@ Status NchwcConv::Compute(OpKernelContext* context) const {
                 static_cast<size_t>(ConvBase::group_),
                 X->template Data<float>(),
                 W->template Data<float>(),
-                B != nullptr ? B->template Data<float>() : nullptr,
+                Bdata,
                 y_data,
                 &activation_,
                 Sum == nullptr,
-                const_cast<concurrency::ThreadPool*>(static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool()));
+                thread_pool);
 
   return Status::OK();
 }
@@ -198,5 +259,33 @@ Status NchwcAveragePool::Compute(OpKernelContext* context) const {
   return NchwcPoolBase::NchwcPool(context, count_include_pad_ ? MlasAveragePoolingIncludePad : MlasAveragePoolingExcludePad);
 }
 
+Status NchwcUpsample::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+
+  const auto& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+
+  auto* Y = context->Output(0, {X_shape[0], X_shape[1], X_shape[2] * scales_[0], X_shape[3] * scales_[1]});
+
+  auto* thread_pool = const_cast<concurrency::ThreadPool*>(static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
+
+  if (linear_) {
+    MlasNchwcUpsampleLinear(X_shape.GetDims().data(),
+                            scales_.data(),
+                            X->template Data<float>(),
+                            Y->template MutableData<float>(),
+                            thread_pool);
+  } else {
+    MlasNchwcUpsample(X_shape.GetDims().data(),
+                      scales_.data(),
+                      X->template Data<float>(),
+                      Y->template MutableData<float>(),
+                      thread_pool);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
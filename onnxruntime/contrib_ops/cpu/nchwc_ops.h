@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cpu/nn/conv_base.h"
 #include "core/providers/cpu/nn/pool.h"
 #include "contrib_ops/cpu/fused_activation.h"
@@ -39,12 +40,23 @@ class NchwcConv : public OpKernel, public ConvBase {
  public:
   NchwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
     ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+
+    // A constant W is transformed once for the Winograd algorithm on first use.
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W)) {
+      winograd_alloc_ = info.GetAllocator(0, OrtMemTypeDefault);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
   MLAS_ACTIVATION activation_;
+
+  // W transformed by MlasNchwcConvWinogradTransformFilter for output tile sizes 2 and 4.
+  AllocatorPtr winograd_alloc_;
+  mutable OrtMutex winograd_mutex_;
+  mutable IAllocatorUniquePtr<float> winograd_filters_[2];
 };
 
 class NchwcPoolBase : public PoolBase {
@@ -73,5 +85,23 @@ class NchwcAveragePool : public OpKernel, public NchwcPoolBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
+class NchwcUpsample : public OpKernel {
+ public:
+  NchwcUpsample(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttrs<int64_t>("scales", scales_).IsOK());
+    ORT_ENFORCE(scales_.size() == 2, "scales must have two spatial dimensions");
+    ORT_ENFORCE(scales_[0] > 0 && scales_[1] > 0, "scales must be positive");
+    std::string mode = info.GetAttrOrDefault<std::string>("mode", "nearest");
+    ORT_ENFORCE(mode == "nearest" || mode == "linear", "mode must be nearest or linear");
+    linear_ = mode == "linear";
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<int64_t> scales_;
+  bool linear_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -4,12 +4,16 @@
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/graph/onnx_protobuf.h"
 #include "onnx/defs/schema.h"
 
 #include "core/common/utf8_util.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
+#include <limits>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -33,6 +37,14 @@ class Tokenizer final : public OpKernel {
                          size_t N, size_t C,
                          const std::vector<int64_t>& input_dims) const;
 
+  // Tokenize a single input string into row
+  Status SeparateString(const std::string& s, std::vector<re2::StringPiece>& row) const;
+  Status MatchTokens(const std::string& s, std::vector<re2::StringPiece>& row) const;
+
+  // Pads the rows of tokens to the longest one and writes them to the output
+  Status OutputRows(OpKernelContext* ctx, const std::vector<int64_t>& input_dims,
+                    const std::vector<std::vector<re2::StringPiece>>& rows) const;
+
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
@@ -54,6 +66,20 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 namespace tokenizer_details {
 const char start_text = 0x2;
 const char end_text = 0x3;
+
+// Runs fn(first, last) over the num_strings strings of the input. The strings are independent of each other, so
+// they are processed in ranges on the intra-op thread pool when there is one.
+template <typename Fn>
+void ForEachString(OpKernelContext* ctx, size_t num_strings, Fn fn) {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, static_cast<int64_t>(num_strings), 512.0, [&fn](int64_t first, int64_t last) {
+      fn(static_cast<size_t>(first), static_cast<size_t>(last));
+    });
+  } else {
+    fn(0, num_strings);
+  }
+}
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
@@ -121,21 +147,30 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t tokens = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       tokens)) {
+  const size_t num_strings = N * C;
+  // length in utf8 chars, or invalid_string when the string is not valid utf8
+  const size_t invalid_string = std::numeric_limits<size_t>::max();
+  std::vector<size_t> string_tokens(num_strings);
+  ForEachString(ctx, num_strings, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
+      size_t tokens = 0;
+      if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(), tokens)) {
+        tokens = invalid_string;
+      }
+      string_tokens[i] = tokens;
+    }
+  });
+
+  size_t max_tokens = 0;
+  for (size_t i = 0; i < num_strings; ++i) {
+    if (string_tokens[i] == invalid_string) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+                    "Input string contains invalid utf8 chars: " + input_data[i]);
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
+    max_tokens = std::max(max_tokens, string_tokens[i]);
   }
 
   std::vector<int64_t> output_dims(input_dims);
@@ -155,252 +190,166 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    size_t tokens = 0;
-    const size_t str_len = s.size();
-    for (size_t token_idx = 0; token_idx < str_len;) {
-      size_t tlen = 0;
-      bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
-      assert(result);
-      (void)result;
-      assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
-      token_idx += tlen;
-      ++tokens;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    // Padding strings
-    assert(tokens + (mark_ * 2) <= max_tokens);
-    const size_t pads = max_tokens - (mark_ * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  ForEachString(ctx, num_strings, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& s = input_data[i];
+      size_t output_index = i * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      size_t tokens = 0;
+      const size_t str_len = s.size();
+      for (size_t token_idx = 0; token_idx < str_len;) {
+        size_t tlen = 0;
+        bool result = utf8_bytes(static_cast<unsigned char>(s[token_idx]), tlen);
+        assert(result);
+        (void)result;
+        assert(token_idx + tlen <= str_len);
+        (output_data + output_index)->assign(s, token_idx, tlen);
+        ++output_index;
+        token_idx += tlen;
+        ++tokens;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      // Padding strings
+      assert(tokens + (mark_ * 2) <= max_tokens);
+      const size_t pads = max_tokens - (mark_ * 2) - tokens;
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
     }
-    ++curr_input;
-  }
+  });
   return Status::OK();
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               const std::vector<int64_t>& input_dims) const {
+Status Tokenizer::SeparateString(const std::string& s, std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  size_t utf8_chars = 0;  // length in utf8 chars
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
 
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + submatch.as_string());
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
+  row.assign(1, StringPiece(s));
+
+  for (const auto& sep : separators_) {
+    std::vector<StringPiece> tokens;
+    for (const auto& text : row) {
+      const auto end_pos = text.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - text.data();
+          assert(match_pos >= start_pos);
+          auto token_len = match_pos - start_pos;
+          utf8_chars = 0;
+          bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                token_len, utf8_chars);
+          if (!valid) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + submatch.as_string());
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, token_len);
+          }
+          // Update starting position
+          // Guard against empty string match
+          auto match_len = submatch.length();
+          if (match_len > 0) {
+            start_pos = match_pos + match_len;
           } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
           }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
-  }
-
-  std::vector<int64_t> output_dims(input_dims);
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
+        } else {
+          // record trailing token
+          auto trailing_len = end_pos - start_pos;
+          utf8_chars = 0;
+          utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                   trailing_len, utf8_chars);
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, trailing_len);
+          }
+        }
+      } while (match);
+    }  // row
+    // Replace the row with the results of this tokenezation
+    row.swap(tokens);
+  }  // separators_
   return Status::OK();
 }
 
-Status Tokenizer::TokenExpression(OpKernelContext* ctx,
-                                  size_t N, size_t C,
-                                  const std::vector<int64_t>& input_dims) const {
+Status Tokenizer::MatchTokens(const std::string& s, std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
-
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  size_t utf8_chars = 0;
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
 
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+  StringPiece text(s);
+  const auto end_pos = s.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+
+  bool match = true;
+  do {
+    match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - s.data();
+      assert(match_pos >= start_pos);
+      // Guard against empty match and make
+      // sure we make progress either way
+      auto token_len = submatch.length();
+      utf8_chars = 0;
+      if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + submatch.as_string());
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        row.push_back(submatch);
+        start_pos = match_pos + token_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
     }
+  } while (match);
+  return Status::OK();
+}
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + submatch.as_string());
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
-        }
-      }
-    } while (match);
+Status Tokenizer::OutputRows(OpKernelContext* ctx, const std::vector<int64_t>& input_dims,
+                             const std::vector<std::vector<re2::StringPiece>>& rows) const {
+  size_t max_tokens = 0;
+  for (const auto& row : rows) {
     max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
   }
 
-  // Check for empty output
   std::vector<int64_t> output_dims(input_dims);
   // Check if we have no output due to either empty input
   // everything is a separator
@@ -421,42 +370,75 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+  ForEachString(ctx, rows.size(), [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const auto& row = rows[i];
+      size_t output_index = i * max_tokens;
+      if (mark_) {
+        (output_data + output_index)->assign(&start_text, 1);
+        ++output_index;
+      }
+      // Output tokens for this row
+      for (const auto& token : row) {
+        (output_data + output_index)->assign(token.data(), token.size());
+        ++output_index;
+      }
+      if (mark_) {
+        (output_data + output_index)->assign(&end_text, 1);
+        ++output_index;
+      }
+      const size_t pads = max_tokens - (mark_ * 2) - row.size();
+      for (size_t p = 0; p < pads; ++p) {
+        *(output_data + output_index) = pad_value_;
+        ++output_index;
+      }
+      assert(output_index == (i + 1) * max_tokens);
     }
-    const size_t pads = max_tokens - (mark_ * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
+  });
+
+  return Status::OK();
+}
+
+Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
+                                               size_t N, size_t C,
+                                               const std::vector<int64_t>& input_dims) const {
+  // Scan all strings and attempt to find separators in them
+  // collect all the output tokens here
+  auto X = ctx->Input<Tensor>(0);
+  auto const input_data = X->template Data<std::string>();
+  std::vector<std::vector<re2::StringPiece>> rows(N * C);
+  std::vector<Status> row_status(N * C);
+  ForEachString(ctx, N * C, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      row_status[i] = SeparateString(input_data[i], rows[i]);
     }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+  });
+
+  for (auto& status : row_status) {
+    ORT_RETURN_IF_ERROR(status);
   }
+  return OutputRows(ctx, input_dims, rows);
+}
 
-  return Status::OK();
+Status Tokenizer::TokenExpression(OpKernelContext* ctx,
+                                  size_t N, size_t C,
+                                  const std::vector<int64_t>& input_dims) const {
+  // Represents a token that will be output after
+  // first is the index, second is the size;
+  auto X = ctx->Input<Tensor>(0);
+  auto const input_data = X->template Data<std::string>();
+  std::vector<std::vector<re2::StringPiece>> tokens(N * C);
+  std::vector<Status> row_status(N * C);
+  ForEachString(ctx, N * C, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      row_status[i] = MatchTokens(input_data[i], tokens[i]);
+    }
+  });
+
+  for (auto& status : row_status) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return OutputRows(ctx, input_dims, tokens);
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
@@ -22,6 +22,18 @@ namespace cuda {
           .MayInplace(0, 0),                                     \
       x<T>);
 
+#define REGISTER_MS_ACTIVATION_KERNEL(x, ver, T)                 \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                 \
+      x,                                                         \
+      kMSDomain,                                                 \
+      ver,                                                       \
+      T,                                                         \
+      kCudaExecutionProvider,                                    \
+      KernelDefBuilder()                                         \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()) \
+          .MayInplace(0, 0),                                     \
+      x<T>);
+
 #define UNARY_ACTIVATION_COMPUTE(x, T)                                                                     \
   template <>                                                                                              \
   Status x<T>::ComputeInternal(OpKernelContext* context) const {                                           \
@@ -46,10 +58,21 @@ namespace cuda {
   UNARY_ACTIVATION_OP_TYPED(name, ver, float)     \
   UNARY_ACTIVATION_OP_TYPED(name, ver, double)
 
+#define UNARY_MS_ACTIVATION_OP_TYPED(name, ver, T) \
+  REGISTER_MS_ACTIVATION_KERNEL(name, ver, T)      \
+  UNARY_ACTIVATION_COMPUTE(name, T)
+
+#define UNARY_MS_ACTIVATION_OP_HFD(name, ver)        \
+  UNARY_MS_ACTIVATION_OP_TYPED(name, ver, MLFloat16) \
+  UNARY_MS_ACTIVATION_OP_TYPED(name, ver, float)     \
+  UNARY_MS_ACTIVATION_OP_TYPED(name, ver, double)
+
 UNARY_ACTIVATION_OP_HFD(Affine, 1);
 UNARY_ACTIVATION_OP_HFD(ParametricSoftplus, 1);
 UNARY_ACTIVATION_OP_HFD(ScaledTanh, 1);
 
+UNARY_MS_ACTIVATION_OP_HFD(Gelu, 1);
+
 
 REGISTER_ACTIVATION_KERNEL(ThresholdedRelu, 1, MLFloat16)
 REGISTER_ACTIVATION_KERNEL(ThresholdedRelu, 1, float)
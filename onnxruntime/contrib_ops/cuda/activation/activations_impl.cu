@@ -36,6 +36,13 @@ struct OP_ScaledTanh : public CtxScaledTanh {
   }
 };
 
+template <typename T>
+struct OP_Gelu : public CtxGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    return (T)0.5f * a * ((T)1 + _Erf(a * (T)0.70710678118654752f));
+  }
+};
+
 #define UNARY_ACTIVATION_IMPL(name)                                        \
   UNARY_ACTIVATION_IMPL_DECLARATION(name) {                                \
     UnaryElementWiseImpl(input_data,                                       \
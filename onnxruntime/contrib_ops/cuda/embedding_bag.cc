@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "embedding_bag.h"
+#include "embedding_bag_impl.h"
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                                                    \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                    \
+      EmbeddingBag,                                                                                 \
+      kMSDomain,                                                                                    \
+      1,                                                                                            \
+      T,                                                                                            \
+      kCudaExecutionProvider,                                                                       \
+      KernelDefBuilder()                                                                            \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                                    \
+          .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),   \
+                                                          DataTypeImpl::GetTensorType<int64_t>()}), \
+      EmbeddingBag<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+Status EmbeddingBag<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* data = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  int64_t num_bags;
+  ORT_RETURN_IF_ERROR(ValidateInputShapes(*data, *indices, offsets, per_sample_weights, num_bags));
+
+  const int64_t D = data->Shape()[1];
+  Tensor* Y = context->Output(0, {num_bags, D});
+  if (num_bags == 0 || D == 0) {
+    return Status::OK();
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const auto* data_ptr = reinterpret_cast<const CudaT*>(data->template Data<T>());
+  const auto* weights_ptr = per_sample_weights != nullptr
+                                ? reinterpret_cast<const CudaT*>(per_sample_weights->template Data<T>())
+                                : nullptr;
+  auto* y_ptr = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  const int64_t num_embeddings = data->Shape()[0];
+  const int64_t num_indices = indices->Shape().Size();
+  const int64_t bag_size = offsets == nullptr ? indices->Shape()[1] : 0;
+
+  MLDataType Tind_type = indices->DataType();
+  if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
+    EmbeddingBagImpl<CudaT, int32_t>(
+        data_ptr, indices->template Data<int32_t>(),
+        offsets != nullptr ? offsets->template Data<int32_t>() : nullptr,
+        weights_ptr, y_ptr, num_embeddings, D, num_indices, num_bags, bag_size, mean_);
+  } else if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
+    EmbeddingBagImpl<CudaT, int64_t>(
+        data_ptr, indices->template Data<int64_t>(),
+        offsets != nullptr ? offsets->template Data<int64_t>() : nullptr,
+        weights_ptr, y_ptr, num_embeddings, D, num_indices, num_bags, bag_size, mean_);
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in EmbeddingBag.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "contrib_ops/cpu/embedding_bag.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+template <typename T>
+class EmbeddingBag final : public CudaKernel, protected EmbeddingBagBase {
+ public:
+  EmbeddingBag(const OpKernelInfo& info) : CudaKernel(info), EmbeddingBagBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "embedding_bag_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The bags of half precision rows are accumulated in single precision.
+template <typename T>
+struct EmbeddingBagAccumulator {
+  typedef float type;
+};
+
+template <>
+struct EmbeddingBagAccumulator<double> {
+  typedef double type;
+};
+
+constexpr int kEmbeddingBagThreadsPerBlock = 256;
+
+// Each block pools one bag, with the threads of the block striding over the columns of the rows, so the
+// gathered rows are read once and never written out.
+template <typename T, typename U, typename Tind>
+__global__ void _EmbeddingBagKernel(
+    const T* data,
+    const Tind* indices,
+    const Tind* offsets,
+    const T* per_sample_weights,
+    T* output,
+    const int64_t num_embeddings,
+    const int64_t D,
+    const int64_t num_indices,
+    const int64_t num_bags,
+    const int64_t bag_size,
+    const bool mean) {
+  const int64_t bag = blockIdx.x;
+  int64_t begin;
+  int64_t end;
+  if (offsets != nullptr) {
+    begin = offsets[bag];
+    end = bag + 1 < num_bags ? int64_t(offsets[bag + 1]) : num_indices;
+  } else {
+    begin = bag * bag_size;
+    end = begin + bag_size;
+  }
+  begin = max(int64_t(0), min(begin, num_indices));
+  end = max(begin, min(end, num_indices));
+
+  T* y = output + bag * D;
+  for (int64_t j = threadIdx.x; j < D; j += blockDim.x) {
+    U sum = 0;
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t row = indices[i];
+      if (row < 0 || row >= num_embeddings) {
+        continue;
+      }
+      const U value = U(data[row * D + j]);
+      sum += per_sample_weights != nullptr ? U(per_sample_weights[i]) * value : value;
+    }
+    if (mean && end > begin) {
+      sum /= U(end - begin);
+    }
+    y[j] = T(sum);
+  }
+}
+
+template <typename T, typename Tind>
+void EmbeddingBagImpl(
+    const T* data,
+    const Tind* indices,
+    const Tind* offsets,
+    const T* per_sample_weights,
+    T* output,
+    const int64_t num_embeddings,
+    const int64_t D,
+    const int64_t num_indices,
+    const int64_t num_bags,
+    const int64_t bag_size,
+    const bool mean) {
+  typedef typename EmbeddingBagAccumulator<T>::type U;
+  const int threads = static_cast<int>(std::min<int64_t>(D, kEmbeddingBagThreadsPerBlock));
+  _EmbeddingBagKernel<T, U, Tind><<<static_cast<int>(num_bags), threads, 0, CurrentStream()>>>(
+      data, indices, offsets, per_sample_weights, output, num_embeddings, D, num_indices, num_bags, bag_size, mean);
+}
+
+#define SPECIALIZED_IMPL(T, Tind) \
+  template void EmbeddingBagImpl<T, Tind>(const T* data, const Tind* indices, const Tind* offsets, const T* per_sample_weights, T* output, const int64_t num_embeddings, const int64_t D, const int64_t num_indices, const int64_t num_bags, const int64_t bag_size, const bool mean);
+
+SPECIALIZED_IMPL(float, int32_t)
+SPECIALIZED_IMPL(float, int64_t)
+SPECIALIZED_IMPL(double, int32_t)
+SPECIALIZED_IMPL(double, int64_t)
+SPECIALIZED_IMPL(half, int32_t)
+SPECIALIZED_IMPL(half, int64_t)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
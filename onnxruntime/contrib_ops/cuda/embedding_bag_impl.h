@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Pools the rows of data selected by each bag of indices into one row of output. The bags are delimited
+// by offsets, or hold bag_size indices each when offsets is nullptr. The values of indices and offsets
+// are not checked on the host, so rows outside of data are skipped and the bags are clamped to indices.
+template <typename T, typename Tind>
+void EmbeddingBagImpl(
+    const T* data,
+    const Tind* indices,
+    const Tind* offsets,
+    const T* per_sample_weights,
+    T* output,
+    const int64_t num_embeddings,
+    const int64_t D,
+    const int64_t num_indices,
+    const int64_t num_bags,
+    const int64_t bag_size,
+    const bool mean);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "layer_norm.h"
+#include "layer_norm_impl.h"
+#include "core/providers/common.h"
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      LayerNormalization,                                         \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      LayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+Status LayerNorm<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* scale = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const TensorShape& x_shape = X->Shape();
+
+  const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+  const int64_t N = x_shape.SizeToDimension(axis);
+  const int64_t D = x_shape.SizeFromDimension(axis);
+
+  if (scale->Shape().Size() != D || (bias != nullptr && bias->Shape().Size() != D)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Scale and B must have the shape of the normalized dimensions of X: ", x_shape,
+                           ", axis: ", axis_);
+  }
+
+  Tensor* Y = context->Output(0, x_shape);
+  if (N == 0 || D == 0) {
+    return Status::OK();
+  }
+
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  LayerNormImpl<CudaT>(
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      reinterpret_cast<const CudaT*>(scale->template Data<T>()),
+      bias != nullptr ? reinterpret_cast<const CudaT*>(bias->template Data<T>()) : nullptr,
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+      N,
+      D,
+      epsilon_);
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
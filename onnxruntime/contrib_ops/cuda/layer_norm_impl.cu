@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "layer_norm_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The statistics of half precision rows are accumulated in single precision.
+template <typename T>
+struct LayerNormAccumulator {
+  typedef float type;
+};
+
+template <>
+struct LayerNormAccumulator<double> {
+  typedef double type;
+};
+
+// The number of threads that cooperate on one row, which must be a power of two.
+constexpr int kLayerNormThreadsPerBlock = 256;
+
+template <typename U>
+__device__ U _BlockReduceSum(U value, U* partial_sums) {
+  partial_sums[threadIdx.x] = value;
+  __syncthreads();
+  for (int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+    if (static_cast<int>(threadIdx.x) < stride) {
+      partial_sums[threadIdx.x] += partial_sums[threadIdx.x + stride];
+    }
+    __syncthreads();
+  }
+  U sum = partial_sums[0];
+  __syncthreads();
+  return sum;
+}
+
+// Each block normalizes one row, reducing the mean and then the variance of the centered row.
+template <typename T, typename U>
+__global__ void _LayerNormKernel(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t D,
+    const U epsilon) {
+  __shared__ U partial_sums[kLayerNormThreadsPerBlock];
+
+  const T* x = input_data + blockIdx.x * D;
+  T* y = output_data + blockIdx.x * D;
+
+  U sum = 0;
+  for (int64_t i = threadIdx.x; i < D; i += blockDim.x) {
+    sum += U(x[i]);
+  }
+  const U mean = _BlockReduceSum(sum, partial_sums) / U(D);
+
+  U sum_squares = 0;
+  for (int64_t i = threadIdx.x; i < D; i += blockDim.x) {
+    const U centered = U(x[i]) - mean;
+    sum_squares += centered * centered;
+  }
+  const U variance = _BlockReduceSum(sum_squares, partial_sums) / U(D);
+  const U inv_std_dev = U(1) / _Sqrt(variance + epsilon);
+
+  for (int64_t i = threadIdx.x; i < D; i += blockDim.x) {
+    U value = (U(x[i]) - mean) * inv_std_dev * U(scale_data[i]);
+    if (bias_data != nullptr) {
+      value += U(bias_data[i]);
+    }
+    y[i] = T(value);
+  }
+}
+
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t N,
+    const int64_t D,
+    const float epsilon) {
+  typedef typename LayerNormAccumulator<T>::type U;
+  _LayerNormKernel<T, U><<<static_cast<int>(N), kLayerNormThreadsPerBlock, 0, CurrentStream()>>>(
+      input_data, scale_data, bias_data, output_data, D, U(epsilon));
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void LayerNormImpl<T>(const T* input_data, const T* scale_data, const T* bias_data, T* output_data, const int64_t N, const int64_t D, const float epsilon);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
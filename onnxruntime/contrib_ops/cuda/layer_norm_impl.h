@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t N,
+    const int64_t D,
+    const float epsilon);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+#include "core/providers/cpu/tensor/utils.h"
+#include <algorithm>
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedElementwise,                                           \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedElementwise<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+static const std::pair<const char*, FusedElementwiseOp> kFusedElementwiseOps[] = {
+    {"Add", FusedElementwiseOp::Add},
+    {"Sub", FusedElementwiseOp::Sub},
+    {"RSub", FusedElementwiseOp::RSub},
+    {"Mul", FusedElementwiseOp::Mul},
+    {"Div", FusedElementwiseOp::Div},
+    {"RDiv", FusedElementwiseOp::RDiv},
+    {"Relu", FusedElementwiseOp::Relu},
+    {"Sigmoid", FusedElementwiseOp::Sigmoid},
+    {"Tanh", FusedElementwiseOp::Tanh},
+    {"Neg", FusedElementwiseOp::Neg},
+    {"Abs", FusedElementwiseOp::Abs},
+    {"Exp", FusedElementwiseOp::Exp},
+    {"Log", FusedElementwiseOp::Log},
+    {"Sqrt", FusedElementwiseOp::Sqrt},
+    {"Reciprocal", FusedElementwiseOp::Reciprocal},
+    {"Erf", FusedElementwiseOp::Erf},
+};
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK());
+  ORT_ENFORCE(!ops.empty() && ops.size() <= kMaxFusedElementwiseSteps,
+              "FusedElementwise supports 1 to ", kMaxFusedElementwiseSteps, " ops");
+  for (const auto& name : ops) {
+    auto it = std::find_if(std::begin(kFusedElementwiseOps), std::end(kFusedElementwiseOps),
+                           [&name](const std::pair<const char*, FusedElementwiseOp>& op) { return name == op.first; });
+    ORT_ENFORCE(it != std::end(kFusedElementwiseOps), "Unsupported FusedElementwise op: ", name);
+    ops_.push_back(it->second);
+    if (it->second <= FusedElementwiseOp::RDiv) {
+      ++num_operands_;
+    }
+  }
+  ORT_ENFORCE(num_operands_ <= kMaxFusedElementwiseOperands,
+              "FusedElementwise supports up to ", kMaxFusedElementwiseOperands, " binary ops");
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  if (context->InputCount() != num_operands_ + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise expects ", num_operands_ + 1,
+                           " inputs for its ops, got ", context->InputCount());
+  }
+
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& output_shape = X->Shape();
+  const auto& output_dims = output_shape.GetDims();
+  const size_t output_rank = output_dims.size();
+  Tensor* Y = context->Output(0, output_shape);
+  if (output_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  FusedElementwiseProgram<CudaT> program;
+  program.num_steps = static_cast<int>(ops_.size());
+  std::copy(ops_.begin(), ops_.end(), program.ops);
+
+  CudaAsyncBuffer<int64_t> operand_padded_strides(this);
+  CudaAsyncBuffer<fast_divmod> fdm_output_strides(this);
+  for (int i = 0; i < num_operands_; ++i) {
+    const Tensor* operand = context->Input<Tensor>(i + 1);
+    const TensorShape& operand_shape = operand->Shape();
+    const auto& operand_dims = operand_shape.GetDims();
+    program.operands[i] = reinterpret_cast<const CudaT*>(operand->template Data<T>());
+
+    // the operands broadcast to the shape of X, which is the shape of every intermediate value
+    bool broadcastable = operand_dims.size() <= output_rank;
+    for (size_t j = 0; broadcastable && j < operand_dims.size(); ++j) {
+      const auto dim = operand_dims[operand_dims.size() - 1 - j];
+      broadcastable = dim == 1 || dim == output_dims[output_rank - 1 - j];
+    }
+    if (!broadcastable) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise operand ", i + 1, " of shape ",
+                             operand_shape, " doesn't broadcast to the shape of X: ", output_shape);
+    }
+
+    if (operand_shape == output_shape) {
+      program.broadcast[i] = FusedElementwiseBroadcast::None;
+    } else if (operand_shape.Size() == 1) {
+      program.broadcast[i] = FusedElementwiseBroadcast::Scalar;
+    } else {
+      program.broadcast[i] = FusedElementwiseBroadcast::Strided;
+      if (operand_padded_strides.CpuPtr() == nullptr) {
+        operand_padded_strides.AllocCpuPtr(GetDeviceId(), num_operands_ * (output_rank + 1));
+        fdm_output_strides.AllocCpuPtr(GetDeviceId(), output_rank);
+        ORT_RETURN_IF_NOT(CalculateFdmStrides(fdm_output_strides.CpuSpan(), output_dims));
+      }
+      // compute strides with 1 more dim than the output rank, like BinaryElementwisePreparation
+      auto strides = operand_padded_strides.CpuSpan().subspan(static_cast<ptrdiff_t>(i * (output_rank + 1)),
+                                                              static_cast<ptrdiff_t>(output_rank + 1));
+      ORT_RETURN_IF_NOT(TensorPitches::Calculate(strides, operand_dims));
+      if (operand_dims[0] > 1 && operand_dims.size() == output_rank)
+        strides[0] = 0;
+    }
+  }
+  ORT_RETURN_IF_ERROR(operand_padded_strides.CopyToGpu());
+  ORT_RETURN_IF_ERROR(fdm_output_strides.CopyToGpu());
+
+  FusedElementwiseImpl<CudaT>(
+      program,
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      output_rank,
+      operand_padded_strides.GpuPtr(),
+      fdm_output_strides.GpuPtr(),
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+      output_shape.Size());
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
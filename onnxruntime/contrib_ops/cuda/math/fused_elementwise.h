@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "fused_elementwise_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Runs a chain of elementwise ops, fused by the ElementwiseFusion transformer, with a single kernel.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<FusedElementwiseOp> ops_;
+  int num_operands_ = 0;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
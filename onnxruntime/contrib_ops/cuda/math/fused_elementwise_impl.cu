@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The value of half precision chains is kept in single precision between the steps.
+template <typename T>
+struct FusedElementwiseAccumulator {
+  typedef float type;
+};
+
+template <>
+struct FusedElementwiseAccumulator<double> {
+  typedef double type;
+};
+
+// compute the index of a broadcast operand from the output offset, like _BinaryElementWise
+__device__ __inline__ CUDA_LONG _OperandIndex(
+    FusedElementwiseBroadcast broadcast,
+    const int64_t* padded_strides,
+    const fast_divmod* fdm_output_strides,
+    size_t output_rank,
+    CUDA_LONG id) {
+  if (broadcast == FusedElementwiseBroadcast::None) {
+    return id;
+  }
+  if (broadcast == FusedElementwiseBroadcast::Scalar) {
+    return 0;
+  }
+  CUDA_LONG index = 0;
+  CUDA_LONG offset = id;
+  for (int dim = 0; dim < output_rank; dim++) {
+    int q, r;
+    fdm_output_strides[dim].divmod(offset, q, r);
+    // stride[i-1] == stride[i] means dim[i] is 1 (broadcasting)
+    if (padded_strides[dim] != padded_strides[dim + 1])
+      index += static_cast<int>(padded_strides[dim + 1]) * q;
+    offset = r;
+  }
+  return index;
+}
+
+// Each thread runs all the steps on one element, so the intermediate values never go to global memory.
+template <typename T, typename U>
+__global__ void _FusedElementwiseKernel(
+    const FusedElementwiseProgram<T> program,
+    const T* input_data,
+    size_t output_rank,
+    const int64_t* operand_padded_strides,
+    const fast_divmod* fdm_output_strides,
+    T* output_data,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  U value = U(input_data[id]);
+  int operand = 0;
+  for (int step = 0; step < program.num_steps; step++) {
+    const FusedElementwiseOp op = program.ops[step];
+    U other = 0;
+    if (op <= FusedElementwiseOp::RDiv) {
+      const CUDA_LONG index = _OperandIndex(program.broadcast[operand],
+                                            operand_padded_strides + operand * (output_rank + 1),
+                                            fdm_output_strides, output_rank, id);
+      other = U(program.operands[operand][index]);
+      operand++;
+    }
+    switch (op) {
+      case FusedElementwiseOp::Add:
+        value = value + other;
+        break;
+      case FusedElementwiseOp::Sub:
+        value = value - other;
+        break;
+      case FusedElementwiseOp::RSub:
+        value = other - value;
+        break;
+      case FusedElementwiseOp::Mul:
+        value = value * other;
+        break;
+      case FusedElementwiseOp::Div:
+        value = value / other;
+        break;
+      case FusedElementwiseOp::RDiv:
+        value = other / value;
+        break;
+      case FusedElementwiseOp::Relu:
+        value = value > U(0) ? value : U(0);
+        break;
+      case FusedElementwiseOp::Sigmoid:
+        value = value > U(0) ? U(1) / (U(1) + _Exp(-value)) : U(1) - U(1) / (U(1) + _Exp(value));
+        break;
+      case FusedElementwiseOp::Tanh:
+        value = _Tanh(value);
+        break;
+      case FusedElementwiseOp::Neg:
+        value = -value;
+        break;
+      case FusedElementwiseOp::Abs:
+        value = _Abs(value);
+        break;
+      case FusedElementwiseOp::Exp:
+        value = _Exp(value);
+        break;
+      case FusedElementwiseOp::Log:
+        value = _Log(value);
+        break;
+      case FusedElementwiseOp::Sqrt:
+        value = _Sqrt(value);
+        break;
+      case FusedElementwiseOp::Reciprocal:
+        value = U(1) / value;
+        break;
+      case FusedElementwiseOp::Erf:
+        value = _Erf(value);
+        break;
+    }
+  }
+  output_data[id] = T(value);
+}
+
+template <typename T>
+void FusedElementwiseImpl(
+    const FusedElementwiseProgram<T>& program,
+    const T* input_data,
+    size_t output_rank,
+    const int64_t* operand_padded_strides,
+    const fast_divmod* fdm_output_strides,
+    T* output_data,
+    size_t count) {
+  typedef typename FusedElementwiseAccumulator<T>::type U;
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _FusedElementwiseKernel<T, U><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      program, input_data, output_rank, operand_padded_strides, fdm_output_strides, output_data, N);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void FusedElementwiseImpl<T>(const FusedElementwiseProgram<T>& program, const T* input_data, size_t output_rank, const int64_t* operand_padded_strides, const fast_divmod* fdm_output_strides, T* output_data, size_t count);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
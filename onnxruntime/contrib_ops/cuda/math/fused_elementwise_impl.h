@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using onnxruntime::cuda::fast_divmod;
+
+// The steps of a FusedElementwise node. The binary steps come first: they take the next operand, on the right of
+// the value except for RSub and RDiv.
+enum class FusedElementwiseOp : int {
+  Add,
+  Sub,
+  RSub,
+  Mul,
+  Div,
+  RDiv,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Neg,
+  Abs,
+  Exp,
+  Log,
+  Sqrt,
+  Reciprocal,
+  Erf,
+};
+
+constexpr int kMaxFusedElementwiseSteps = 16;
+constexpr int kMaxFusedElementwiseOperands = 8;
+
+// How an operand is indexed from the index of the output element.
+enum class FusedElementwiseBroadcast : int {
+  None,    // the operand has the shape of the output
+  Scalar,  // the operand has a single element
+  Strided  // the operand is broadcast with its padded strides
+};
+
+// Passed by value to the kernel, so that the steps and the operands don't take a copy to the device.
+template <typename T>
+struct FusedElementwiseProgram {
+  int num_steps;
+  FusedElementwiseOp ops[kMaxFusedElementwiseSteps];
+  const T* operands[kMaxFusedElementwiseOperands];
+  FusedElementwiseBroadcast broadcast[kMaxFusedElementwiseOperands];
+};
+
+// operand_padded_strides holds output_rank + 1 strides for each operand, and is only read for the Strided operands.
+template <typename T>
+void FusedElementwiseImpl(
+    const FusedElementwiseProgram<T>& program,
+    const T* input_data,
+    size_t output_rank,
+    const int64_t* operand_padded_strides,
+    const fast_divmod* fdm_output_strides,
+    T* output_data,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
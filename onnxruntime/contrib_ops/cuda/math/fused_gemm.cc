@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/gemm.h"
+#include "core/providers/cuda/activation/activations_impl.h"
+
+using namespace onnxruntime::cuda;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Gemm followed by the activation GemmActivationFusion folded into it. Relu is applied by the epilogue of the
+// multiplication when cuBLASLt runs it, the other activations by a kernel over the output.
+template <typename T>
+class FusedGemm final : public Gemm<T> {
+ public:
+  FusedGemm(const OpKernelInfo& info) : Gemm<T>(info) {
+    Gemm<T>::activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+    leaky_relu_alpha_ = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+    const auto& activation = Gemm<T>::activation_;
+    ORT_ENFORCE(activation.empty() || activation == "Relu" || activation == "LeakyRelu" ||
+                    activation == "Sigmoid" || activation == "Tanh",
+                "Unsupported activation ", activation);
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override {
+    typedef typename ToCudaType<T>::MappedType CudaT;
+
+    Tensor* Y = nullptr;
+    bool activation_fused = false;
+    ORT_RETURN_IF_ERROR(Gemm<T>::ComputeGemm(context, Y, activation_fused));
+    const auto& activation = Gemm<T>::activation_;
+    if (activation_fused || activation.empty()) {
+      return Status::OK();
+    }
+
+    CudaT* y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+    const size_t count = Y->Shape().Size();
+    if (activation == "Relu") {
+      CtxRelu ctx;
+      Impl_Relu<CudaT>(y_data, y_data, &ctx, count);
+    } else if (activation == "LeakyRelu") {
+      CtxLeakyRelu ctx{leaky_relu_alpha_};
+      Impl_LeakyRelu<CudaT>(y_data, y_data, &ctx, count);
+    } else if (activation == "Sigmoid") {
+      CtxSigmoid ctx;
+      Impl_Sigmoid<CudaT>(y_data, y_data, &ctx, count);
+    } else {
+      CtxTanh ctx;
+      Impl_Tanh<CudaT>(y_data, y_data, &ctx, count);
+    }
+    return Status::OK();
+  }
+
+ private:
+  float leaky_relu_alpha_;
+};
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -64,35 +64,36 @@ namespace onnxruntime {
   VARIADIC_OP(Min)          \
   VARIADIC_OP(Sum)
 
-#define LIST_ALL_GENERIC_OPS() \
-  LIST_BINARY_OPS()            \
-  LIST_BINARY_CMP_OPS()        \
-  LIST_REDUCE_OPS()            \
-  LIST_POOL_OPS()              \
-  LIST_UNARY_OPS()             \
-  LIST_VARIADIC_OPS()          \
-  ADD_OP_ITEM(Cast)            \
-  ADD_OP_ITEM(Clip)            \
-  ADD_OP_ITEM(Concat)          \
-  ADD_OP_ITEM(Conv)            \
-  ADD_OP_ITEM(Crop)            \
-  ADD_OP_ITEM(Dropout)         \
-  ADD_OP_ITEM(Flatten)         \
-  ADD_OP_ITEM(Gather)          \
-  ADD_OP_ITEM(Gemm)            \
-  ADD_OP_ITEM(Identity)        \
-  ADD_OP_ITEM(LogSoftmax)      \
-  ADD_OP_ITEM(LSTM)            \
-  ADD_OP_ITEM(MatMul)          \
-  ADD_OP_ITEM(MatMulInteger)   \
-  ADD_OP_ITEM(Pad)             \
-  ADD_OP_ITEM(Reshape)         \
-  ADD_OP_ITEM(Slice)           \
-  ADD_OP_ITEM(Softmax)         \
-  ADD_OP_ITEM(Split)           \
-  ADD_OP_ITEM(Squeeze)         \
-  ADD_OP_ITEM(Transpose)       \
-  ADD_OP_ITEM(Unsqueeze)       \
+#define LIST_ALL_GENERIC_OPS()    \
+  LIST_BINARY_OPS()               \
+  LIST_BINARY_CMP_OPS()           \
+  LIST_REDUCE_OPS()               \
+  LIST_POOL_OPS()                 \
+  LIST_UNARY_OPS()                \
+  LIST_VARIADIC_OPS()             \
+  ADD_OP_ITEM(Cast)               \
+  ADD_OP_ITEM(Clip)               \
+  ADD_OP_ITEM(Concat)             \
+  ADD_OP_ITEM(Conv)               \
+  ADD_OP_ITEM(Crop)               \
+  ADD_OP_ITEM(Dropout)            \
+  ADD_OP_ITEM(Flatten)            \
+  ADD_OP_ITEM(Gather)             \
+  ADD_OP_ITEM(Gemm)               \
+  ADD_OP_ITEM(Identity)           \
+  ADD_OP_ITEM(LayerNormalization) \
+  ADD_OP_ITEM(LogSoftmax)         \
+  ADD_OP_ITEM(LSTM)               \
+  ADD_OP_ITEM(MatMul)             \
+  ADD_OP_ITEM(MatMulInteger)      \
+  ADD_OP_ITEM(Pad)                \
+  ADD_OP_ITEM(Reshape)            \
+  ADD_OP_ITEM(Slice)              \
+  ADD_OP_ITEM(Softmax)            \
+  ADD_OP_ITEM(Split)              \
+  ADD_OP_ITEM(Squeeze)            \
+  ADD_OP_ITEM(Transpose)          \
+  ADD_OP_ITEM(Unsqueeze)          \
   ADD_OP_ITEM(Where)
 
 }  // namespace onnxruntime
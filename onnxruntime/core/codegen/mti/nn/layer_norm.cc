@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/codegen/mti/nn/layer_norm.h"
+
+#include "core/codegen/mti/math/binary_ops.h"
+#include "core/codegen/mti/math/reduce_ops.h"
+#include "core/codegen/mti/math/unary_ops.h"
+#include "core/codegen/mti/mti_tvm_utils.h"
+#include "gsl/gsl_util"
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+tvm::Tensor LayerNormalization(const tvm::Tensor& X,
+                               const tvm::Tensor& scale,
+                               const tvm::Tensor& bias,
+                               int64_t axis,
+                               float epsilon,
+                               const std::string& name) {
+  int64_t rank = gsl::narrow<int64_t>(X->shape.size());
+  axis = HandleNegativeAxis(axis, rank);
+
+  std::vector<int64_t> axes;
+  for (int64_t i = axis; i < rank; ++i)
+    axes.push_back(i);
+
+  // mean and variance are kept as reductions so the schedulers root them,
+  // while the elementwise parts get inlined into the consumers
+  tvm::Tensor mean = ReduceMean(X, axes, /*keep_dims*/ true, name + "_mean");
+  tvm::Tensor centered = Sub(X, mean, name + "_centered");
+  tvm::Tensor variance = ReduceMean(Mul(centered, centered, name + "_square"), axes, /*keep_dims*/ true,
+                                    name + "_variance");
+  tvm::Tensor std_dev = Sqrt(Add(variance, tvm::make_const(X->dtype, epsilon), name + "_add_epsilon"),
+                             name + "_std_dev");
+  tvm::Tensor normalized = Div(centered, std_dev, name + "_normalized");
+
+  if (!bias.defined())
+    return Mul(normalized, scale, name);
+
+  return Add(Mul(normalized, scale, name + "_scale"), bias, name);
+}
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <string>
+#include <tvm/tvm.h>
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+// Normalizes X over the dimensions starting at axis, then applies scale and the optional bias,
+// which have the shape of the normalized dimensions. Pass an undefined tensor to skip the bias.
+tvm::Tensor LayerNormalization(const tvm::Tensor& X,
+                               const tvm::Tensor& scale,
+                               const tvm::Tensor& bias,
+                               int64_t axis,
+                               float epsilon,
+                               const std::string& name = "layer_norm");
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
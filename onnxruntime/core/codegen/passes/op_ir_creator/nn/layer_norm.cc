@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/codegen/passes/op_ir_creator/all_ops.h"
+
+#include "core/codegen/mti/nn/layer_norm.h"
+#include "core/framework/op_kernel_info.h"
+
+namespace onnxruntime {
+namespace tvm_codegen {
+
+// Evaluate of LayerNormalization OpIRCreator
+Status GENERIC_OP_IR_CREATOR_CLASS(LayerNormalization)::Evaluate(
+    const tvm::Array<tvm::Tensor>& inputs,
+    const Node& node,
+    CodeGenContext&,
+    tvm::Array<tvm::Tensor>& outputs) {
+  ProtoHelperNodeContext ctx(node);
+  OpNodeProtoHelper<ProtoHelperNodeContext> attrs(&ctx);
+
+  int64_t axis = attrs.GetAttrOrDefault<int64_t>("axis", -1);
+  float epsilon = attrs.GetAttrOrDefault<float>("epsilon", 1e-5f);
+
+  // B is optional
+  bool has_B = node.InputDefs().size() > 2 && node.InputDefs()[2]->Exists();
+  tvm::Tensor B = has_B ? inputs[2] : tvm::Tensor();
+
+  tvm::Tensor Y = LayerNormalization(inputs[0], inputs[1], B, axis, epsilon, node.Name() + "_LayerNormalization");
+  outputs.push_back(Y);
+  return Status::OK();
+}
+
+}  // namespace tvm_codegen
+}  // namespace onnxruntime
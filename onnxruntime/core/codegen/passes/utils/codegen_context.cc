@@ -4,6 +4,7 @@
 #include "core/codegen/passes/utils/codegen_context.h"
 
 #include "core/codegen/common/common.h"
+#include "gsl/gsl_util"
 
 namespace onnxruntime {
 namespace tvm_codegen {
@@ -19,6 +20,18 @@ tvm::Var CodeGenContext::GetOrCreateDynamicDim(const std::string& name) {
   return dynamic_dims_.at(name);
 }
 
+void CodeGenContext::SpecializeDynamicDim(const std::string& name, int64_t value) {
+  specialized_dims_[name] = value;
+}
+
+tvm::Expr CodeGenContext::GetDimExpr(const std::string& name) {
+  auto iter = specialized_dims_.find(name);
+  if (iter != specialized_dims_.end())
+    return tvm::Expr(gsl::narrow_cast<int32_t>(iter->second));
+
+  return GetOrCreateDynamicDim(name);
+}
+
 std::string CodeGenContext::CreateUnnamedSymbol() {
   return "unnamed_" + std::to_string(unname_symbol_counter_++);
 }
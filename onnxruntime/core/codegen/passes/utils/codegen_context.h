@@ -23,6 +23,12 @@ class CodeGenContext {
   // returns tvm::Var for the dynamic dim
   tvm::Var GetOrCreateDynamicDim(const std::string& name);
 
+  // generates code for the dynamic dim with the given value
+  void SpecializeDynamicDim(const std::string& name, int64_t value);
+
+  // returns the value of a specialized dim, or tvm::Var for the dynamic dim
+  tvm::Expr GetDimExpr(const std::string& name);
+
   const codegen::CodeGenHandle* GetCodeGenHandle() const {
     return handle_;
   }
@@ -32,6 +38,8 @@ class CodeGenContext {
  protected:
   std::unordered_map<std::string, tvm::Var> dynamic_dims_;
 
+  std::unordered_map<std::string, int64_t> specialized_dims_;
+
   const codegen::CodeGenHandle* handle_;
 
   int unname_symbol_counter_;
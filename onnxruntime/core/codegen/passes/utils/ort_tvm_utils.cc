@@ -91,7 +91,7 @@ tvm::Array<tvm::Expr> ShapeToTvmArray(const NodeArg* def, CodeGenContext& ctx) {
 
 tvm::Expr ShapeDimToTvmDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim, CodeGenContext& ctx) {
   if (utils::HasDimParam(dim)) {
-    return ctx.GetOrCreateDynamicDim(dim.dim_param());
+    return ctx.GetDimExpr(dim.dim_param());
   } else if (utils::HasDimValue(dim)) {
     return tvm::Expr(gsl::narrow_cast<int32_t>(dim.dim_value()));
   }
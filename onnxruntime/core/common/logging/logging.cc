@@ -8,6 +8,7 @@
 #include "core/common/exceptions.h"
 #include "core/common/logging/isink.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -153,6 +154,13 @@ void LoggingManager::SendProfileEvent(profiling::EventRecord& eventRecord) const
   sink_->SendProfileEvent(eventRecord);
 }
 
+void LoggingManager::EnableAsyncSink(size_t max_queued_messages) {
+  if (max_queued_messages == 0) {
+    throw std::logic_error("max_queued_messages must be positive.");
+  }
+  sink_ = std::make_unique<AsyncSink>(std::move(sink_), max_queued_messages);
+}
+
 static minutes InitLocaltimeOffset(const time_point<system_clock>& epoch) noexcept {
   // convert the system_clock time_point (UTC) to localtime and gmtime to calculate the difference.
   // we do this once, and apply that difference in GetTimestamp().
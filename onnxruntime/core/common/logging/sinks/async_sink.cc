@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace logging {
+
+static size_t QueueCapacity(size_t max_queued_messages) {
+  size_t capacity = 2;
+  while (capacity < max_queued_messages) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, size_t max_queued_messages)
+    : sink_{std::move(sink)},
+      cells_{new Cell[QueueCapacity(max_queued_messages)]},
+      mask_{QueueCapacity(max_queued_messages) - 1} {
+  if (sink_ == nullptr) {
+    throw std::logic_error("ISink must be provided.");
+  }
+
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  thread_ = std::thread([this]() { SendQueuedMessages(); });
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_one();
+  thread_.join();
+}
+
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  // the message is formatted by the other sink on the background thread, only its fields are copied here
+  QueuedMessage queued;
+  queued.timestamp = timestamp;
+  queued.logger_id = logger_id;
+  queued.severity = message.Severity();
+  queued.category = message.Category();
+  queued.data_type = message.DataType();
+  queued.file = message.Location().file_and_path;
+  queued.line = message.Location().line_num;
+  queued.function = message.Location().function;
+  queued.message = message.Message();
+
+  const bool fatal = message.Severity() == Severity::kFATAL;
+  if (Enqueue(queued, !fatal) && fatal) {
+    Flush();
+  }
+}
+
+void AsyncSink::SendProfileEvent(profiling::EventRecord& eventRecord) const {
+  QueuedMessage queued;
+  queued.profile_event = std::make_unique<profiling::EventRecord>(eventRecord);
+  Enqueue(queued, false);
+}
+
+bool AsyncSink::Enqueue(QueuedMessage& message, bool can_drop) const {
+  while (!TryEnqueue(message)) {
+    if (can_drop) {
+      ++dropped_messages_;
+      return false;
+    }
+    std::this_thread::yield();
+  }
+
+  // The fence orders the enqueue before the load of waiting_, like the background thread orders the store of
+  // waiting_ before it checks the queue again, so that either sees the other.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    queued_.notify_one();
+  }
+  return true;
+}
+
+bool AsyncSink::TryEnqueue(QueuedMessage& message) const {
+  size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+    if (difference == 0) {
+      // the cell is free, claim the position
+      if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // the cell still holds the message of the previous round, the queue is full
+      return false;
+    } else {
+      // another thread claimed the position
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->message = std::move(message);
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+bool AsyncSink::TryDequeue(QueuedMessage& message) {
+  Cell& cell = cells_[dequeue_position_ & mask_];
+  if (cell.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+    return false;
+  }
+
+  message = std::move(cell.message);
+  // free the cell for the enqueue of the next round
+  cell.sequence.store(dequeue_position_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_position_;
+  return true;
+}
+
+void AsyncSink::Flush() {
+  const size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  std::unique_lock<OrtMutex> lock(mutex_);
+  queued_.notify_one();
+  while (sent_position_ < position && !stopping_) {
+    sent_.wait(lock);
+  }
+}
+
+void AsyncSink::SendQueuedMessages() {
+  static constexpr size_t kMessagesPerProgressUpdate = 256;
+
+  QueuedMessage message;
+  while (true) {
+    size_t sent = 0;
+    while (TryDequeue(message)) {
+      Send(message);
+      if (++sent % kMessagesPerProgressUpdate == 0) {
+        std::lock_guard<OrtMutex> lock(mutex_);
+        sent_position_ = dequeue_position_;
+        sent_.notify_all();
+      }
+    }
+
+    std::unique_lock<OrtMutex> lock(mutex_);
+    sent_position_ = dequeue_position_;
+    sent_.notify_all();
+
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool empty = cells_[dequeue_position_ & mask_].sequence.load(std::memory_order_acquire) !=
+                       dequeue_position_ + 1;
+    if (empty) {
+      if (stopping_) {
+        return;
+      }
+      // bounded, in case a message is enqueued while it's being claimed
+      queued_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    waiting_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void AsyncSink::Send(const QueuedMessage& message) {
+  if (message.profile_event != nullptr) {
+    sink_->SendProfileEvent(*message.profile_event);
+    return;
+  }
+
+  const CodeLocation location{message.file.c_str(), message.line, message.function.c_str()};
+  const Capture capture{message.severity, message.category.c_str(), message.data_type, location, message.message};
+  sink_->Send(message.timestamp, message.logger_id, capture);
+
+  const size_t dropped = dropped_messages_.load(std::memory_order_relaxed);
+  if (dropped != reported_dropped_messages_) {
+    const Capture report{Severity::kWARNING, Category::onnxruntime, DataType::SYSTEM, ORT_WHERE,
+                         std::to_string(dropped - reported_dropped_messages_) +
+                             " log messages were dropped because the queue of the asynchronous sink was full"};
+    sink_->Send(message.timestamp, message.logger_id, report);
+    reported_dropped_messages_ = dropped;
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/common/logging/isink.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// ISink that sends the messages to another sink from a background thread, so that the threads logging them don't
+/// wait for the other sink to format and write them, or for each other.
+/// </summary>
+/// <remarks>
+/// The messages and profile events wait in a bounded lock-free queue. When it's full, new messages are dropped, and
+/// the number dropped is reported with the next message sent. Fatal messages are never dropped, and are sent before
+/// the call logging them returns. Profile events are never dropped either. The other sink is only called from the
+/// background thread, so it doesn't need to be thread safe.
+/// </remarks>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncSink"/> class.
+  /// </summary>
+  /// <param name="sink">The sink to send the messages to.</param>
+  /// <param name="max_queued_messages">The number of messages the queue holds, rounded up to a power of 2.</param>
+  AsyncSink(std::unique_ptr<ISink> sink, size_t max_queued_messages);
+
+  /// <summary>
+  /// Sends the queued messages, and stops the background thread.
+  /// </summary>
+  ~AsyncSink() override;
+
+  /// <summary>
+  /// Waits until the messages queued before the call are sent.
+  /// </summary>
+  void Flush();
+
+  /// <summary>
+  /// The number of messages dropped because the queue was full.
+  /// </summary>
+  size_t DroppedMessages() const noexcept { return dropped_messages_; }
+
+  /// <summary>
+  /// Queues a copy of the profile event, to send it from the background thread.
+  /// </summary>
+  void SendProfileEvent(profiling::EventRecord& eventRecord) const override;
+
+ private:
+  // A message copied out of its Capture, which doesn't outlive the call logging it, or a copy of a profile event.
+  struct QueuedMessage {
+    Timestamp timestamp;
+    std::string logger_id;
+    Severity severity = Severity::kVERBOSE;
+    std::string category;
+    DataType data_type = DataType::SYSTEM;
+    std::string file;
+    int line = 0;
+    std::string function;
+    std::string message;
+    std::unique_ptr<profiling::EventRecord> profile_event;  // set for a profile event, instead of the fields above
+  };
+
+  // A slot of the queue. Its sequence tells whether it's free for the enqueue at the same position, or holds the
+  // message the dequeue at the same position takes.
+  struct Cell {
+    std::atomic<size_t> sequence;
+    QueuedMessage message;
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  // Queues the message, waiting for room if the queue is full and it can't be dropped. Returns false if it was dropped.
+  bool Enqueue(QueuedMessage& message, bool can_drop) const;
+  // Returns false if the queue is full.
+  bool TryEnqueue(QueuedMessage& message) const;
+  // Returns false if the queue is empty. Only called from the background thread.
+  bool TryDequeue(QueuedMessage& message);
+
+  void SendQueuedMessages();
+  void Send(const QueuedMessage& message);
+
+  const std::unique_ptr<ISink> sink_;
+  const std::unique_ptr<Cell[]> cells_;
+  const size_t mask_;
+  // the members used to queue messages are mutable, as ISink::SendProfileEvent is const
+  mutable std::atomic<size_t> enqueue_position_{0};
+  size_t dequeue_position_ = 0;  // only used by the background thread
+  mutable std::atomic<size_t> dropped_messages_{0};
+  size_t reported_dropped_messages_ = 0;  // only used by the background thread
+
+  // The background thread waits on queued_ when the queue is empty, and Flush waits on sent_.
+  mutable OrtMutex mutex_;
+  mutable OrtCondVar queued_;
+  OrtCondVar sent_;
+  std::atomic<bool> waiting_{false};
+  size_t sent_position_ = 0;  // protected by mutex_, the position of the next message to send
+  bool stopping_ = false;     // protected by mutex_
+  std::thread thread_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -65,13 +65,28 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
 
   EventRecord event(category, logging::GetProcessId(),
                     logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+  //TODO: sync_gpu if needed.
+  AddEvent(std::move(event));
+}
+
+void Profiler::RecordEvent(EventCategory category,
+                           const std::string& event_name,
+                           const TimePoint& start_time,
+                           long long duration,
+                           int thread_id,
+                           std::unordered_map<std::string, std::string>&& event_args) {
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+  AddEvent(EventRecord(category, logging::GetProcessId(), thread_id, event_name, ts, duration,
+                       std::move(event_args)));
+}
+
+void Profiler::AddEvent(EventRecord&& event) {
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
-    //TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
-      events_.emplace_back(event);
+      events_.emplace_back(std::move(event));
     } else {
       if (session_logger_ && !max_events_reached) {
         LOGS(*session_logger_, ERROR)
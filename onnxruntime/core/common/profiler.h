@@ -67,6 +67,17 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event that started at start_time and took duration microseconds, for an event whose duration is
+  only known after the fact, e.g. the device time of an asynchronous kernel.
+  */
+  void RecordEvent(EventCategory category,
+                   const std::string& event_name,
+                   const TimePoint& start_time,
+                   long long duration,
+                   int thread_id,
+                   std::unordered_map<std::string, std::string>&& event_args);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -85,6 +96,8 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  void AddEvent(EventRecord&& event);
+
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
   bool enabled_{false};
@@ -3,34 +3,303 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#else
-#pragma warning(push)
-#pragma warning(disable : 4267)
+#if defined(_M_AMD64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
 #endif
-#include <unsupported/Eigen/CXX11/src/ThreadPool/Barrier.h>
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
+
+namespace onnxruntime {
+
+namespace concurrency {
+
+namespace {
+
+// Number of blocks the range is split into per participating thread. Splitting
+// into more blocks than threads lets threads that finish early pick up work
+// from threads that were descheduled or are running slower.
+constexpr int64_t kBlocksPerThread = 4;
+
+// Approximate cost, in cycles, below which it is not worthwhile to involve
+// another thread. Used by the cost based overload of ParallelForRange.
+constexpr double kMinCostPerThread = 40000.0;
+
+// Spinning threads check the clock once per this many iterations.
+constexpr unsigned kSpinIterationsPerClockCheck = 64;
+
+inline void SpinPause() {
+#if defined(_M_AMD64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
 #else
-#pragma warning(pop)
+  std::this_thread::yield();
 #endif
+}
 
-using Eigen::Barrier;
+// Shared state for a single ParallelForRange invocation. Helper tasks hold a
+// reference to this state, so it must outlive the calling frame: a helper may
+// be dequeued after every block has already been claimed and the call has
+// returned.
+struct ParallelForState {
+  ParallelForState(int64_t first, int64_t last, int64_t min_block_size, int64_t num_threads,
+                   const std::function<void(int64_t, int64_t)>& fn)
+      : fn(fn),
+        next(first),
+        last(last),
+        min_block_size(min_block_size),
+        num_threads(num_threads),
+        remaining(last - first) {}
 
-namespace onnxruntime {
+  // Claims the next block of iterations. Blocks start large and shrink as the
+  // range is consumed so that the tail of the loop is balanced across threads.
+  bool ClaimBlock(int64_t& block_first, int64_t& block_last) {
+    int64_t current = next.load(std::memory_order_relaxed);
+    while (current < last) {
+      int64_t block_size = std::max(min_block_size, (last - current) / (num_threads * kBlocksPerThread));
+      int64_t block_end = std::min(last, current + block_size);
+      if (next.compare_exchange_weak(current, block_end, std::memory_order_relaxed)) {
+        block_first = current;
+        block_last = block_end;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs blocks until the range is exhausted. Returns when no more blocks can
+  // be claimed by this thread; other threads may still be finishing theirs.
+  void Run() {
+    int64_t block_first;
+    int64_t block_last;
+    while (ClaimBlock(block_first, block_last)) {
+      fn(block_first, block_last);
+      if (remaining.fetch_sub(block_last - block_first, std::memory_order_acq_rel) == block_last - block_first) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+      }
+    }
+  }
+
+  // Spins for up to spin_duration before blocking, so a loop whose blocks are
+  // about to finish on other threads doesn't pay for a wake-up.
+  void Wait(std::chrono::microseconds spin_duration) {
+    if (remaining.load(std::memory_order_acquire) == 0) return;
+    if (spin_duration.count() > 0) {
+      const auto spin_end = std::chrono::steady_clock::now() + spin_duration;
+      for (unsigned iteration = 1; remaining.load(std::memory_order_acquire) != 0; ++iteration) {
+        if (iteration % kSpinIterationsPerClockCheck == 0 && std::chrono::steady_clock::now() >= spin_end) break;
+        SpinPause();
+      }
+      if (remaining.load(std::memory_order_acquire) == 0) return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+  }
+
+  // Only dereferenced while a block is outstanding. The caller does not return
+  // until every block completes, so the referenced function outlives all uses.
+  const std::function<void(int64_t, int64_t)>& fn;
+  std::atomic<int64_t> next;
+  const int64_t last;
+  const int64_t min_block_size;
+  const int64_t num_threads;
+  std::atomic<int64_t> remaining;
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+// Eigen thread environment that applies ThreadOptions to each thread before it
+// starts processing work. Eigen copies the environment, so the per pool state is
+// shared between the copies.
+class PlacedThreadEnvironment : public Eigen::StlThreadEnvironment {
+ public:
+  PlacedThreadEnvironment(const std::string& name, const ThreadOptions& thread_options)
+      : placement_(std::make_shared<Placement>(name, thread_options)) {}
+
+  EnvThread* CreateThread(std::function<void()> f) {
+    std::vector<size_t> processors = placement_->NextThreadProcessors();
+    if (processors.empty()) {
+      return Eigen::StlThreadEnvironment::CreateThread(std::move(f));
+    }
+
+    std::shared_ptr<Placement> placement = placement_;
+    return new EnvThread([placement, processors, f]() {
+      Status status = Env::Default().SetCurrentThreadAffinity(processors);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(WARNING) << "Failed to set the affinity of a thread in pool '" << placement->name
+                              << "': " << status.ErrorMessage();
+      }
+      f();
+    });
+  }
+
+ private:
+  struct Placement {
+    Placement(const std::string& name, const ThreadOptions& thread_options)
+        : name(name), affinity(thread_options.affinity) {
+      if (affinity.empty() && thread_options.numa_node >= 0) {
+        numa_processors = Env::Default().GetNumaNodeProcessors(thread_options.numa_node);
+        if (numa_processors.empty()) {
+          LOGS_DEFAULT(WARNING) << "NUMA node " << thread_options.numa_node << " requested for thread pool '"
+                                << name << "' has no processors. Threads will not be pinned.";
+        }
+      }
+    }
+
+    std::vector<size_t> NextThreadProcessors() {
+      if (!affinity.empty()) {
+        size_t index = next_thread.fetch_add(1, std::memory_order_relaxed);
+        return {affinity[index % affinity.size()]};
+      }
+      return numa_processors;
+    }
+
+    const std::string name;
+    const std::vector<size_t> affinity;
+    std::vector<size_t> numa_processors;
+    std::atomic<size_t> next_thread{0};
+  };
+
+  std::shared_ptr<Placement> placement_;
+};
+
+}  // namespace
+
+// Threads that spin pick up the published loop directly instead of waiting for
+// a helper task to be scheduled on them.
+struct ThreadPool::SpinState {
+  explicit SpinState(int spin_duration_us) : spin_duration(std::max(spin_duration_us, 0)) {}
+
+  bool ShouldSpin() const {
+    return spin_duration.count() > 0 || low_latency_sections.load(std::memory_order_relaxed) > 0;
+  }
+
+  const std::chrono::microseconds spin_duration;
+
+  // The last published loop. Its version changes with every loop, so a thread
+  // only takes the mutex when there is new work.
+  std::mutex mutex;
+  std::shared_ptr<ParallelForState> work;
+  std::atomic<uint64_t> work_version{0};
+
+  std::atomic<int> spinning{0};
+  std::atomic<int> low_latency_sections{0};
+  // Tasks scheduled on the pool that no thread has started yet, and the spinning
+  // threads that returned to the pool to run them. Every task that starts
+  // releases one of the returned threads, so a queued task is never left behind
+  // threads that all spin, whichever task the returned thread is given.
+  std::atomic<int> queued{0};
+  std::atomic<int> yielding{0};
+  std::atomic<bool> stopping{false};
+};
 
-namespace concurrency {
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadPool::ThreadPool(const std::string&, int num_threads)
+    : spin_state_(std::make_unique<SpinState>(0)),
+      impl_(std::make_unique<Eigen::ThreadPool>(num_threads)) {}
+
+ThreadPool::ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options)
+    : spin_state_(std::make_unique<SpinState>(thread_options.spin_duration_us)) {
+  if (thread_options.affinity.empty() && thread_options.numa_node < 0) {
+    impl_ = std::make_unique<Eigen::ThreadPool>(num_threads);
+  } else {
+    impl_ = std::make_unique<Eigen::ThreadPoolTempl<PlacedThreadEnvironment>>(
+        num_threads, PlacedThreadEnvironment(name, thread_options));
+  }
+}
 
-void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
+ThreadPool::~ThreadPool() {
+  // the pool threads finish their tasks before impl_ is destroyed, so the spinning ones must stop
+  spin_state_->stopping = true;
+  impl_.reset();
+}
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  SpinState& spin = *spin_state_;
+  if (spin.low_latency_sections.load(std::memory_order_relaxed) > 0) {
+    // a spinning thread returns to the pool to run fn, and fn's thread spins afterwards instead
+    ScheduleTask([this, fn]() {
+      fn();
+      SpinForWork();
+    });
+    return;
+  }
+
+  ScheduleTask(std::move(fn));
+}
+
+void ThreadPool::ScheduleTask(std::function<void()> fn) {
+  SpinState& spin = *spin_state_;
+  spin.queued.fetch_add(1);
+  impl_->Schedule([&spin, fn]() {
+    spin.queued.fetch_sub(1);
+    int yielding = spin.yielding.load();
+    while (yielding > 0 && !spin.yielding.compare_exchange_weak(yielding, yielding - 1)) {
+    }
+    fn();
+  });
+}
+
+void ThreadPool::StartLowLatency() {
+  SpinState& spin = *spin_state_;
+  if (spin.low_latency_sections.fetch_add(1) == 0) {
+    for (int i = spin.spinning.load(); i < NumThreads(); ++i) {
+      ScheduleTask([this]() { SpinForWork(); });
+    }
+  }
+}
+
+void ThreadPool::EndLowLatency() {
+  SpinState& spin = *spin_state_;
+  spin.low_latency_sections.fetch_sub(1);
+}
+
+void ThreadPool::SpinForWork() {
+  SpinState& spin = *spin_state_;
+  if (!spin.ShouldSpin()) return;
+
+  ++spin.spinning;
+  uint64_t seen_version = 0;
+  auto idle_since = std::chrono::steady_clock::now();
+  for (unsigned iteration = 1; !spin.stopping.load(std::memory_order_relaxed); ++iteration) {
+    if (spin.work_version.load(std::memory_order_acquire) != seen_version) {
+      std::shared_ptr<ParallelForState> work;
+      {
+        std::lock_guard<std::mutex> lock(spin.mutex);
+        work = spin.work;
+        seen_version = spin.work_version.load(std::memory_order_relaxed);
+      }
+      if (work != nullptr) {
+        work->Run();
+        idle_since = std::chrono::steady_clock::now();
+      }
+      continue;
+    }
+
+    int yielding = spin.yielding.load();
+    if (spin.queued.load() > yielding && spin.yielding.compare_exchange_weak(yielding, yielding + 1)) {
+      break;
+    }
+
+    if (iteration % kSpinIterationsPerClockCheck == 0 &&
+        spin.low_latency_sections.load(std::memory_order_relaxed) == 0 &&
+        std::chrono::steady_clock::now() - idle_since >= spin.spin_duration) {
+      break;
+    }
+    SpinPause();
+  }
+  --spin.spinning;
+}
 
 void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
   if (total <= 0) return;
@@ -40,51 +309,105 @@ void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(total - 1));
-  std::function<void(int32_t)> handle_iteration = [&barrier, &fn](int iteration) {
-    fn(iteration);
-    barrier.Notify();
-  };
+  // Each iteration is treated as an independently stealable unit. Callers such
+  // as MLAS already size the iteration count to the amount of parallelism they
+  // want, so there is no benefit in coarsening further.
+  RunParallelForRange(0, total, 1, total, [&fn](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) {
+      fn(static_cast<int32_t>(i));
+    }
+  });
+}
 
-  for (int32_t id = 1; id < total; ++id) {
-    Schedule([=, &handle_iteration]() { handle_iteration(id); });
+void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn) {
+  if (last <= first) return;
+  if (last - first == 1) {
+    fn(first, last);
+    return;
   }
 
-  fn(0);
-  barrier.Wait();
+  RunParallelForRange(first, last, 1, last - first, fn);
 }
 
-void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn) {
+void ThreadPool::ParallelForRange(int64_t first, int64_t last, double cost_per_unit,
+                                  std::function<void(int64_t, int64_t)> fn) {
   if (last <= first) return;
-  if (last - first == 1) {
+
+  const int64_t total = last - first;
+  const double total_cost = static_cast<double>(total) * std::max(cost_per_unit, 0.0);
+
+  // Limit the number of participating threads to the amount of work available
+  // and choose a minimum block size that keeps the per block cost well above
+  // the scheduling overhead.
+  int64_t max_threads = static_cast<int64_t>(total_cost / kMinCostPerThread);
+  if (max_threads <= 1) {
     fn(first, last);
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(last - first));
-  std::function<void(int64_t, int64_t)> handle_range = [&barrier, &fn](int64_t first, int64_t last) {
+  int64_t min_block_size = 1;
+  if (cost_per_unit > 0.0) {
+    min_block_size = std::max<int64_t>(1, static_cast<int64_t>(kMinCostPerThread / kBlocksPerThread / cost_per_unit));
+  }
+
+  RunParallelForRange(first, last, min_block_size, max_threads, fn);
+}
+
+void ThreadPool::RunParallelForRange(int64_t first, int64_t last, int64_t min_block_size, int64_t max_threads,
+                                     const std::function<void(int64_t, int64_t)>& fn) {
+  // The calling thread participates, so only schedule helpers for the
+  // remaining threads and never more helpers than there are blocks.
+  int64_t num_threads = std::min<int64_t>(max_threads, static_cast<int64_t>(NumThreads()) + 1);
+  num_threads = std::min(num_threads, (last - first + min_block_size - 1) / min_block_size);
+
+  if (num_threads <= 1) {
     fn(first, last);
-    barrier.Notify();
-  };
+    return;
+  }
 
-  for (int64_t id = first + 1; id <= last; ++id) {
-    Schedule([=, &handle_range]() { handle_range(id, id + 1); });
+  auto state = std::make_shared<ParallelForState>(first, last, min_block_size, num_threads, fn);
+
+  // The spinning threads join the loop as soon as it's published, and helpers
+  // are only scheduled for the rest.
+  SpinState& spin = *spin_state_;
+  int64_t num_helpers = num_threads - 1;
+  const bool published = spin.spinning.load() > 0;
+  if (published) {
+    {
+      std::lock_guard<std::mutex> lock(spin.mutex);
+      spin.work = state;
+      spin.work_version.fetch_add(1, std::memory_order_release);
+    }
+    num_helpers -= spin.spinning.load();
+  }
+
+  for (int64_t i = 0; i < num_helpers; ++i) {
+    ScheduleTask([this, state]() {
+      state->Run();
+      // the helper is likely to be needed by the next loop too
+      SpinForWork();
+    });
   }
 
-  fn(first, first + 1);
-  barrier.Wait();
+  // Claiming blocks on the calling thread guarantees forward progress even if
+  // no helper is ever dequeued, e.g. when called from inside a pool thread.
+  state->Run();
+  state->Wait(spin.spin_duration);
+
+  if (published) {
+    std::lock_guard<std::mutex> lock(spin.mutex);
+    if (spin.work == state) {
+      spin.work.reset();
+    }
+  }
 }
 
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
 //   impl_->SetStealPartitions(partitions);
 // }
 
-int ThreadPool::NumThreads() const { return impl_.NumThreads(); }
+int ThreadPool::NumThreads() const { return impl_->NumThreads(); }
 
-int ThreadPool::CurrentThreadId() const { return impl_.CurrentThreadId(); }
+int ThreadPool::CurrentThreadId() const { return impl_->CurrentThreadId(); }
 }  // namespace concurrency
 }  // namespace onnxruntime
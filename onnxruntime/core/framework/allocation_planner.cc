@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/framework/allocation_planner.h"
+#include <limits>
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <sstream>
 #include "core/common/exceptions.h"
@@ -63,6 +65,8 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.inplace_output >= 0) out << ", in place of output " << elt_plan.inplace_output;
+      if (elt_plan.view_of >= 0) out << ", view of " << elt_plan.view_of;
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -97,6 +101,29 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
     }
   }
 
+  out << "\n" << plan.planner_stats << std::endl;
+
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const SequentialExecutionPlan::PlannerStats& stats) {
+  out << "Planner Stats:\n";
+  out << "Reused buffers: " << stats.num_inplace_reuses << " in-place, " << stats.num_same_size_reuses
+      << " of the same size, " << stats.num_best_fit_reuses << " larger (best fit)\n";
+  if (stats.num_inplace_output_candidates > 0) {
+    out << "Tensors written into pre-allocated outputs: " << stats.num_inplace_output_candidates << "\n";
+  }
+  if (stats.num_output_views > 0) {
+    out << "Outputs sharing the buffer of their input: " << stats.num_output_views << "\n";
+  }
+  if (stats.num_strided_views > 0) {
+    out << "Strided views of their input: " << stats.num_strided_views << "\n";
+  }
+  out << "Allocated: " << stats.allocated_bytes << " bytes, " << stats.allocated_bytes_without_reuse
+      << " bytes without reuse. Peak working set: " << stats.peak_bytes << " bytes";
+  if (stats.num_unknown_size_tensors > 0) {
+    out << " (excluding " << stats.num_unknown_size_tensors << " tensors with a size unknown until run time)";
+  }
   return out;
 }
 
@@ -203,6 +230,30 @@ class PlannerImpl {
     symplan.reused_buffer = original;
   }
 
+  // Find the input that output_arg may be a strided view of (e.g. the output of Slice), which is only planned for
+  // sequential execution: the executor makes the view contiguous before a kernel that can't read it.
+  bool FindStridedViewInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* viewed_input) {
+    if (context_.IsParallelExecutionEnabled()) return false;
+
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(node, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) {
+      return false;
+    }
+
+    auto input_args = node.InputDefs();
+    for (auto pair : ci->kernel_def->MayStridedOutput()) {
+      if (pair.second == output_arg_num && 0 <= pair.first && static_cast<size_t>(pair.first) < input_args.size()) {
+        auto p_input_arg = input_args[pair.first];
+        if (p_input_arg->Exists() && !IsNonTensor(*p_input_arg)) {
+          *viewed_input = Index(p_input_arg->Name());
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   // Find if there exists some input tensor that we can use in-place for output_arg
   bool FindReusableInput(const onnxruntime::Node& node, int output_arg_num, OrtValueIndex* reusable_input) {
     auto p_output_arg = node.OutputDefs()[output_arg_num];
@@ -219,7 +270,9 @@ class PlannerImpl {
         // we _must_ reuse this input to satisfy aliasing requirement: (e.g., for reshape)
         if ((0 <= pair.first) && (static_cast<size_t>(pair.first) < input_args.size())) {
           auto p_input_arg = input_args[pair.first];
-          if (p_input_arg->Exists()) {
+          // the kernel gets a contiguous copy of a strided view, so the output can't share the buffer of the viewed
+          // tensor. It's planned like any other output instead, and the kernel copies into it.
+          if (p_input_arg->Exists() && AllocPlan(Index(p_input_arg->Name())).view_of < 0) {
             *reusable_input = Index(p_input_arg->Name());
             return true;
           }
@@ -235,8 +288,9 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
-              if (SameSize(*p_input_arg, *p_output_arg)) {
+            // a strided view doesn't cover the buffer it shares, which may be smaller than the view (e.g. Expand)
+            if (1 == UseCount(original) && AllocPlan(input_arg_index).view_of < 0) {
+              if (SameSize(*p_input_arg, *p_output_arg) || BroadcastsOntoInput(node, pair.first)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
                 return true;
@@ -308,30 +362,229 @@ class PlannerImpl {
     return SameSize(*p_shape1, arg1.Type(), *p_shape2, arg2.Type());
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
+  // Whether node is an elementwise op with numpy-style broadcasting whose other inputs broadcast onto input
+  // input_arg_num without growing it. The output then has the shape of that input, even when some of its dims
+  // (and so the output's inferred shape) are unknown, e.g. for a bias added to [batch, ?, C].
+  bool BroadcastsOntoInput(const onnxruntime::Node& node, int input_arg_num) {
+    static const std::unordered_set<std::string> broadcasting_ops{"Add", "Sub", "Mul", "Div", "Pow", "PRelu",
+                                                                  "Sum", "Min", "Max", "Mean", "And", "Or", "Xor"};
+    if ((node.Domain() != kOnnxDomain && node.Domain() != kOnnxDomainAlias) ||
+        broadcasting_ops.find(node.OpType()) == broadcasting_ops.end()) {
+      return false;
+    }
+
+    auto input_args = node.InputDefs();
+    auto p_shape = context_.GetShape(*input_args[input_arg_num]);
+    if (nullptr == p_shape) return false;
+
+    const int rank = p_shape->dim_size();
+    for (size_t i = 0; i < input_args.size(); ++i) {
+      if (static_cast<int>(i) == input_arg_num || !input_args[i]->Exists()) continue;
+
+      auto p_other_shape = context_.GetShape(*input_args[i]);
+      if (nullptr == p_other_shape || p_other_shape->dim_size() > rank) return false;
+
+      // compare the trailing dims, which are the ones the other input is broadcast along
+      const int offset = rank - p_other_shape->dim_size();
+      for (int d = 0; d < p_other_shape->dim_size(); ++d) {
+        const auto& other_dim = p_other_shape->dim(d);
+        const auto& dim = p_shape->dim(d + offset);
+        if (utils::HasDimValue(other_dim) && other_dim.dim_value() == 1) continue;
+        if (utils::HasDimValue(other_dim) && utils::HasDimValue(dim) && other_dim.dim_value() == dim.dim_value())
+          continue;
+        if (utils::HasDimParam(other_dim) && utils::HasDimParam(dim) && !dim.dim_param().empty() &&
+            other_dim.dim_param() == dim.dim_param())
+          continue;
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Byte size of a tensor: constant_bytes times the product of the symbolic dims in symbols (sorted).
+  struct TensorSize {
+    size_t constant_bytes{0};
+    std::vector<std::string> symbols;
+  };
+
+  static bool IsStringTensor(const DataType& tensor_type) {
+    const TypeProto& type_proto = ONNX_NAMESPACE::Utils::DataTypeUtils::ToTypeProto(tensor_type);
+    const TensorTypeBase* tensor_type_base = DataTypeImpl::TypeFromProto(type_proto)->AsTensorType();
+    return tensor_type_base == nullptr || tensor_type_base->GetElementType() == DataTypeImpl::GetType<std::string>();
+  }
+
+  // Returns false if the size can't be expressed from the shape, e.g. because a dim is unknown.
+  static bool GetTensorSize(const TensorShapeProto& shape, const DataType& tensor_type, TensorSize& size) {
+    size.constant_bytes = GetElementSize(tensor_type);
+    size.symbols.clear();
+    for (const auto& dim : shape.dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() >= 0) {
+        size.constant_bytes *= static_cast<size_t>(dim.dim_value());
+      } else if (utils::HasDimParam(dim) && !dim.dim_param().empty()) {
+        size.symbols.push_back(dim.dim_param());
+      } else {
+        return false;
+      }
+    }
+    std::sort(size.symbols.begin(), size.symbols.end());
+    return true;
+  }
+
+  // Find the buffer in the freelist that fits output_arg best: one of the same size if there is any, otherwise
+  // the smallest one that is larger. Sizes with symbolic dims are only comparable if they have the same symbols.
+  // Among equally good buffers, the most recently freed one is used.
   bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, OrtValueIndex* reusable_tensor) {
     auto p_required_buffer_shape = context_.GetShape(output_arg);
     if (nullptr == p_required_buffer_shape) return false;
     auto required_buffer_type = output_arg.Type();
     auto& required_allocator_info = AllocPlan(output_arg.Name()).location;
 
+    // string tensors are constructed in place, so they can only reuse a buffer of the same shape
+    TensorSize required_size;
+    bool fit_by_size = !IsStringTensor(required_buffer_type) &&
+                       GetTensorSize(*p_required_buffer_shape, required_buffer_type, required_size);
+
+    auto best_fit = freelist_.end();
+    size_t best_fit_bytes = 0;
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
       size_t reusable = static_cast<size_t>(it->ml_value);
       const onnxruntime::NodeArg* p_node_arg = ort_value_info_.at(reusable).p_def_site;
       auto& available_allocator_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_allocator_info == required_allocator_info)) continue;
       auto p_available_buffer_shape = context_.GetShape(*p_node_arg);
-      if (nullptr != p_available_buffer_shape) {
-        auto available_buffer_type = p_node_arg->Type();
-        if (SameSize(*p_available_buffer_shape, available_buffer_type,
-                     *p_required_buffer_shape, required_buffer_type)) {
-          *reusable_tensor = it->ml_value;
-          freelist_.erase(it);
-          return true;
+      if (nullptr == p_available_buffer_shape) continue;
+
+      auto available_buffer_type = p_node_arg->Type();
+      if (SameSize(*p_available_buffer_shape, available_buffer_type,
+                   *p_required_buffer_shape, required_buffer_type)) {
+        best_fit = it;
+        break;
+      }
+
+      TensorSize available_size;
+      if (fit_by_size && !IsStringTensor(available_buffer_type) &&
+          GetTensorSize(*p_available_buffer_shape, available_buffer_type, available_size) &&
+          available_size.symbols == required_size.symbols &&
+          available_size.constant_bytes >= required_size.constant_bytes &&
+          (best_fit == freelist_.end() || available_size.constant_bytes < best_fit_bytes)) {
+        best_fit = it;
+        best_fit_bytes = available_size.constant_bytes;
+        if (best_fit_bytes == required_size.constant_bytes) break;
+      }
+    }
+
+    if (best_fit == freelist_.end()) return false;
+    *reusable_tensor = best_fit->ml_value;
+    freelist_.erase(best_fit);
+    return true;
+  }
+
+  // Estimated size of a value in bytes, for comparing the memory use of execution orders. Symbolic and unknown dims
+  // count as 1 and an unknown shape as a scalar, and non-tensor values as 0.
+  size_t EstimateBytes(const onnxruntime::NodeArg& arg) const {
+    if (!arg.Exists() || IsNonTensor(arg)) return 0;
+    size_t bytes = GetElementSize(arg.Type());
+    auto p_shape = context_.GetShape(arg);
+    if (p_shape != nullptr) {
+      for (const auto& dim : p_shape->dim()) {
+        if (utils::HasDimValue(dim) && dim.dim_value() > 0) bytes *= static_cast<size_t>(dim.dim_value());
+      }
+    }
+    return bytes;
+  }
+
+  // Orders the nodes so the estimated peak of the bytes of the live intermediate values is low, with a greedy list
+  // schedule: of the nodes whose inputs are ready, the one that adds the fewest bytes runs next, that is, the one
+  // whose outputs are smallest relative to the inputs it is the last consumer of. Ties keep the topological order
+  // of the graph, which is returned if the graph can't be ordered.
+  std::vector<NodeIndex> ComputeMemoryEfficientOrder(const std::vector<NodeIndex>& topological_order) {
+    const size_t num_nodes = static_cast<size_t>(graph_viewer_.MaxNodeIndex());
+    std::vector<size_t> position(num_nodes, 0);
+    std::vector<size_t> pending_input_edges(num_nodes, 0);
+    std::vector<NodeIndex> ready;
+    for (size_t i = 0; i < topological_order.size(); ++i) {
+      const Node& node = *graph_viewer_.GetNode(topological_order[i]);
+      position[node.Index()] = i;
+      pending_input_edges[node.Index()] = node.GetInputEdgesCount();
+      if (node.GetInputEdgesCount() == 0) ready.push_back(node.Index());
+    }
+
+    // the distinct values each node reads, and how many nodes read each value
+    std::vector<std::vector<OrtValueIndex>> node_inputs(num_nodes);
+    std::vector<int> remaining_consumers(ort_value_info_.size(), 0);
+    for (auto node_index : topological_order) {
+      const Node& node = *graph_viewer_.GetNode(node_index);
+      auto& inputs = node_inputs[node_index];
+      for (const auto* input : node.InputDefs()) {
+        if (input->Exists()) inputs.push_back(Index(input->Name()));
+      }
+      for (const auto* input : node.ImplicitInputDefs()) {
+        if (input->Exists()) inputs.push_back(Index(input->Name()));
+      }
+      std::sort(inputs.begin(), inputs.end());
+      inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+      for (auto input : inputs) {
+        ++remaining_consumers[input];
+      }
+    }
+
+    // only the values produced by the nodes that aren't graph outputs are freed during the run
+    std::vector<bool> freeable(ort_value_info_.size(), false);
+    std::vector<size_t> bytes(ort_value_info_.size(), 0);
+    for (auto node_index : topological_order) {
+      for (const auto* output : graph_viewer_.GetNode(node_index)->OutputDefs()) {
+        if (!output->Exists()) continue;
+        const OrtValueIndex index = Index(output->Name());
+        freeable[index] = true;
+        bytes[index] = EstimateBytes(*output);
+      }
+    }
+    for (const auto* output : graph_viewer_.GetOutputs()) {
+      freeable[Index(output->Name())] = false;
+    }
+
+    auto added_bytes = [&](NodeIndex node_index) {
+      int64_t added = 0;
+      for (const auto* output : graph_viewer_.GetNode(node_index)->OutputDefs()) {
+        if (output->Exists()) added += static_cast<int64_t>(bytes[Index(output->Name())]);
+      }
+      for (auto input : node_inputs[node_index]) {
+        if (freeable[input] && remaining_consumers[input] == 1) added -= static_cast<int64_t>(bytes[input]);
+      }
+      return added;
+    };
+
+    std::vector<NodeIndex> order;
+    order.reserve(topological_order.size());
+    while (!ready.empty()) {
+      size_t best = 0;
+      int64_t best_added = added_bytes(ready[0]);
+      for (size_t i = 1; i < ready.size(); ++i) {
+        const int64_t added = added_bytes(ready[i]);
+        if (added < best_added || (added == best_added && position[ready[i]] < position[ready[best]])) {
+          best = i;
+          best_added = added;
         }
       }
+
+      const NodeIndex node_index = ready[best];
+      ready[best] = ready.back();
+      ready.pop_back();
+      order.push_back(node_index);
+
+      for (auto input : node_inputs[node_index]) {
+        --remaining_consumers[input];
+      }
+      const Node& node = *graph_viewer_.GetNode(node_index);
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        const NodeIndex consumer = it->GetNode().Index();
+        if (--pending_input_edges[consumer] == 0) ready.push_back(consumer);
+      }
     }
-    return false;
+
+    if (order.size() != topological_order.size()) return topological_order;
+    return order;
   }
 
   void Initialize(size_t num_graph_nodes, size_t num_ml_values) {
@@ -560,8 +813,19 @@ class PlannerImpl {
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
+          ++plan_.planner_stats.num_inplace_reuses;
+        } else if (FindStridedViewInput(*pnode, output_arg_num, &reused)) {
+          // The output may be a view of the input with strides, which shares the input buffer
+          Reuse(reused, current, AllocKind::kReuse);
+          AllocPlan(current).view_of = reused;
+          ++plan_.planner_stats.num_strided_views;
         } else if (!context_.IsParallelExecutionEnabled() && FindReusableTensor(*node_output, &reused)) {
           // Reuse an available (dead) buffer for this output, this is only for sequential execution.
+          if (SameSize(*ort_value_info_[reused].p_def_site, *node_output)) {
+            ++plan_.planner_stats.num_same_size_reuses;
+          } else {
+            ++plan_.planner_stats.num_best_fit_reuses;
+          }
           Reuse(reused, current, AllocKind::kReuse);
         } else {
           // otherwise: allocate a new buffer for this output
@@ -598,9 +862,164 @@ class PlannerImpl {
         }
       }
     }
+
+    // A strided view holds a reference to the value it views, so it is released along with the buffer it shares.
+    for (size_t index = 0; index < plan_.allocation_plan.size(); ++index) {
+      const auto& value_plan = plan_.allocation_plan[index];
+      if (value_plan.alloc_kind != AllocKind::kReuse || value_plan.view_of < 0) continue;
+      auto original = Buffer(static_cast<OrtValueIndex>(index));
+      auto it = std::find_if(freelist_.begin(), freelist_.end(),
+                             [original](const FreeBufferInfo& info) { return info.ml_value == original; });
+      if (it != freelist_.end()) {
+        freelist_.insert(it, FreeBufferInfo(static_cast<OrtValueIndex>(index), it->deallocate_point));
+      }
+    }
+    return Status::OK();
+  }
+
+  // Find the intermediate tensors that could be written straight into the buffer of a graph output: those
+  // whose only use is as an input of the node producing the output, when that node may compute the output
+  // in place from it. Whether the caller pre-allocated the output is only known at run time.
+  // When the node aliases its output to such an input instead (Reshape, Squeeze, Identity, ...), the output is
+  // planned as a view of the input, so the input gets its own buffer that outlives the run and isn't copied.
+  Status ComputeInplaceOutputs() {
+    std::vector<int> num_uses(ort_value_info_.size(), 0);
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      for (auto node_input : pnode->InputDefs()) {
+        if (node_input->Exists()) ++num_uses[Index(node_input->Name())];
+      }
+      for (auto node_input : pnode->ImplicitInputDefs()) {
+        if (node_input->Exists()) ++num_uses[Index(node_input->Name())];
+      }
+    }
+
+    // a buffer that other ml-values reuse has to stay where it is
+    std::vector<bool> is_reused(ort_value_info_.size(), false);
+    for (const auto& value_plan : plan_.allocation_plan) {
+      if (value_plan.alloc_kind == AllocKind::kReuse || value_plan.alloc_kind == AllocKind::kShare) {
+        is_reused[value_plan.reused_buffer] = true;
+      }
+    }
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      const KernelCreateInfo* ci;
+      ORT_RETURN_IF_ERROR(kernel_registry_.SearchKernelRegistry(*pnode, &ci));
+      if (ci == nullptr || ci->kernel_def == nullptr) continue;
+
+      auto input_args = pnode->InputDefs();
+      auto output_args = pnode->OutputDefs();
+      for (auto pair : ci->kernel_def->MayInplace()) {
+        if (pair.first < 0 || static_cast<size_t>(pair.first) >= input_args.size() ||
+            pair.second < 0 || static_cast<size_t>(pair.second) >= output_args.size()) {
+          continue;
+        }
+
+        auto p_input_arg = input_args[pair.first];
+        auto p_output_arg = output_args[pair.second];
+        if (!p_input_arg->Exists() || !p_output_arg->Exists() || IsNonTensor(*p_input_arg)) continue;
+
+        auto input_index = Index(p_input_arg->Name());
+        auto output_index = Index(p_output_arg->Name());
+        auto& input_plan = AllocPlan(input_index);
+        const auto& output_plan = AllocPlan(output_index);
+        if (output_plan.alloc_kind != AllocKind::kAllocateOutput ||
+            (input_plan.alloc_kind != AllocKind::kAllocate && input_plan.alloc_kind != AllocKind::kReuse) ||
+            num_uses[input_index] != 1 || is_reused[input_index] ||
+            !(input_plan.location == output_plan.location) || !SameSize(*p_input_arg, *p_output_arg)) {
+          continue;
+        }
+
+        input_plan.inplace_output = output_index;
+        ++plan_.planner_stats.num_inplace_output_candidates;
+      }
+
+      for (auto pair : ci->kernel_def->Alias()) {
+        if (pair.first < 0 || static_cast<size_t>(pair.first) >= input_args.size() ||
+            pair.second < 0 || static_cast<size_t>(pair.second) >= output_args.size()) {
+          continue;
+        }
+
+        auto p_input_arg = input_args[pair.first];
+        auto p_output_arg = output_args[pair.second];
+        if (!p_input_arg->Exists() || !p_output_arg->Exists() || IsNonTensor(*p_input_arg)) continue;
+
+        auto input_index = Index(p_input_arg->Name());
+        auto output_index = Index(p_output_arg->Name());
+        auto& input_plan = AllocPlan(input_index);
+        auto& output_plan = AllocPlan(output_index);
+        if (output_plan.alloc_kind != AllocKind::kAllocateOutput || output_plan.view_of >= 0 ||
+            input_plan.alloc_kind != AllocKind::kAllocate || input_plan.inplace_output >= 0 ||
+            num_uses[input_index] != 1 || is_reused[input_index] ||
+            !(input_plan.location == output_plan.location)) {
+          continue;
+        }
+
+        input_plan.alloc_kind = AllocKind::kAllocateOutput;
+        output_plan.view_of = input_index;
+        ++plan_.planner_stats.num_output_views;
+      }
+    }
+
     return Status::OK();
   }
 
+  // Sum up the bytes of the tensors with a statically known size, with and without the buffer reuse in the
+  // plan, and the peak of the bytes live at once. A buffer is live from the step producing it to the step
+  // freeing it, or to the end if it isn't freed.
+  void ComputePlannerStats() {
+    auto& stats = plan_.planner_stats;
+    const auto num_steps = plan_.execution_plan.size();
+    if (num_steps == 0) return;
+
+    const size_t not_produced = std::numeric_limits<size_t>::max();
+    std::vector<size_t> def_step(ort_value_info_.size(), not_produced);
+    for (size_t program_counter = 0; program_counter < num_steps; ++program_counter) {
+      auto pnode = graph_viewer_.GetNode(plan_.execution_plan[program_counter].node_index);
+      for (auto node_output : pnode->OutputDefs()) {
+        if (node_output->Exists()) def_step[Index(node_output->Name())] = program_counter;
+      }
+    }
+
+    std::vector<size_t> free_step(ort_value_info_.size(), num_steps - 1);
+    for (const auto& info : freelist_) {
+      free_step[info.ml_value] = info.deallocate_point;
+    }
+
+    // bytes becoming live and dead at each step
+    std::vector<size_t> allocated(num_steps, 0), freed(num_steps, 0);
+    for (size_t index = 0; index < ort_value_info_.size(); ++index) {
+      if (def_step[index] == not_produced) continue;
+      const auto* p_def_site = ort_value_info_[index].p_def_site;
+      auto alloc_kind = plan_.allocation_plan[index].alloc_kind;
+      if (IsNonTensor(*p_def_site) || alloc_kind == AllocKind::kShare || plan_.allocation_plan[index].view_of >= 0) {
+        continue;
+      }
+
+      auto p_shape = context_.GetShape(*p_def_site);
+      TensorSize size;
+      if (nullptr == p_shape || !GetTensorSize(*p_shape, p_def_site->Type(), size) || !size.symbols.empty()) {
+        ++stats.num_unknown_size_tensors;
+        continue;
+      }
+
+      stats.allocated_bytes_without_reuse += size.constant_bytes;
+      if (alloc_kind == AllocKind::kAllocate || alloc_kind == AllocKind::kAllocateOutput) {
+        stats.allocated_bytes += size.constant_bytes;
+        allocated[def_step[index]] += size.constant_bytes;
+        freed[std::max(def_step[index], free_step[index])] += size.constant_bytes;
+      }
+    }
+
+    size_t live = 0;
+    for (size_t program_counter = 0; program_counter < num_steps; ++program_counter) {
+      live += allocated[program_counter];
+      stats.peak_bytes = std::max(stats.peak_bytes, live);
+      live -= freed[program_counter];
+    }
+  }
+
   // Whether a given NodeArg has fence or not.
   // If the buffer is reused, need to check whether original OrtValue has fence or not.
   bool HasFence(const onnxruntime::NodeArg* arg) {
@@ -689,10 +1108,17 @@ Status PlannerImpl::CreatePlan() {
 
   Initialize(p_graph_nodes.size(), static_cast<size_t>(num_ml_values));
 
-  // Determine execution order: we use the default topological sort order for now. We can later
-  // explore more efficient orderings (from a memory usage perspective).
-  for (auto n : p_graph_nodes) {
-    plan_.execution_plan.emplace_back(n);
+  // Determine execution order: the topological sort order of the graph, or one with a lower peak memory use.
+  // The parallel executor doesn't follow the order of the plan, so the latter is only computed for sequential
+  // execution.
+  if (context_.IsMemoryEfficientOrderEnabled() && !context_.IsParallelExecutionEnabled()) {
+    for (auto n : ComputeMemoryEfficientOrder(p_graph_nodes)) {
+      plan_.execution_plan.emplace_back(n);
+    }
+  } else {
+    for (auto n : p_graph_nodes) {
+      plan_.execution_plan.emplace_back(n);
+    }
   }
 
   // compute use counts for all ml-values
@@ -701,6 +1127,10 @@ Status PlannerImpl::CreatePlan() {
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
+  ORT_RETURN_IF_ERROR(ComputeInplaceOutputs());
+
+  ComputePlannerStats();
+
   // Determine nodes that need fence check. This needs to be done after ComputeUseCounts and ComputeReusePlan.
   ORT_RETURN_IF_ERROR(ComputeFenceCheck());
 
@@ -25,12 +25,17 @@ class ISequentialPlannerContext {
   // If it returns true, planner won't reuse output tensors
   // see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
+  // If it returns true, the nodes are executed in an order that lowers the peak memory use instead of the
+  // topological order of the graph
+  // see PlannerImpl::ComputeMemoryEfficientOrder
+  virtual bool IsMemoryEfficientOrderEnabled() const { return false; }
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(bool p_enable_parallel_execution)
-      : m_enable_parallel_execution(p_enable_parallel_execution) {
+  SequentialPlannerContext(bool p_enable_parallel_execution, bool p_enable_memory_efficient_order = false)
+      : m_enable_parallel_execution(p_enable_parallel_execution),
+        m_enable_memory_efficient_order(p_enable_memory_efficient_order) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -39,8 +44,11 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool IsParallelExecutionEnabled() const override { return m_enable_parallel_execution; }
 
+  bool IsMemoryEfficientOrderEnabled() const override { return m_enable_memory_efficient_order; }
+
  private:
   bool m_enable_parallel_execution{false};
+  bool m_enable_memory_efficient_order{false};
 };
 
 class SequentialPlanner {
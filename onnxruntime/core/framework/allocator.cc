@@ -4,16 +4,55 @@
 #include "core/framework/allocator.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/utils.h"
+#include "core/platform/env.h"
 #include <cstdlib>
 #include <sstream>
 
 namespace onnxruntime {
 
+namespace {
+// Smaller allocations come from the heap. Arena regions start at 1 MB by default.
+constexpr size_t kMinPageAllocationSize = 1024 * 1024;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+}  // namespace
+
 void* CPUAllocator::Alloc(size_t size) {
-  return utils::DefaultAlloc(size);
+  if (!UsesPages() || size < kMinPageAllocationSize) {
+    return utils::DefaultAlloc(size);
+  }
+
+  // whole huge pages, so that explicit huge pages can be used
+  size_t page_allocation_size = size;
+  if (config_.use_huge_pages && size >= kHugePageSize) {
+    page_allocation_size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+
+  void* p = Env::Default().AllocatePages(page_allocation_size, config_.use_huge_pages, config_.numa_node);
+  if (p == nullptr) {
+    return utils::DefaultAlloc(size);
+  }
+
+  std::lock_guard<OrtMutex> lock(page_allocations_mutex_);
+  page_allocations_[p] = page_allocation_size;
+  return p;
 }
 
 void CPUAllocator::Free(void* p) {
+  if (UsesPages() && p != nullptr) {
+    size_t page_allocation_size = 0;
+    {
+      std::lock_guard<OrtMutex> lock(page_allocations_mutex_);
+      auto it = page_allocations_.find(p);
+      if (it != page_allocations_.end()) {
+        page_allocation_size = it->second;
+        page_allocations_.erase(it);
+      }
+    }
+    if (page_allocation_size != 0) {
+      Env::Default().FreePages(p, page_allocation_size);
+      return;
+    }
+  }
   utils::DefaultFree(p);
 }
 
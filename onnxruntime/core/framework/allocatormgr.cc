@@ -14,9 +14,11 @@ using namespace ::onnxruntime::common;
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
-  if (device_allocator->AllowsArena())
+  if (device_allocator->AllowsArena()) {
+    size_t max_mem = info.arena_config.max_mem == 0 ? info.max_mem : std::min(info.max_mem, info.arena_config.max_mem);
     return std::shared_ptr<IArenaAllocator>(
-        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem));
+        std::make_unique<BFCArena>(std::move(device_allocator), max_mem, info.arena_config));
+  }
 
   return device_allocator;
 }
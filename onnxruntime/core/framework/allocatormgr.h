@@ -14,6 +14,7 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  ArenaConfig arena_config;
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
@@ -9,6 +9,26 @@
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+
+// How an arena sizes the next region it requests from the device allocator.
+enum class ArenaExtendStrategy {
+  // Each region is twice the size of the previous one, or larger if needed.
+  kNextPowerOfTwo = 0,
+  // Each region is just big enough for the allocation that triggered it.
+  kSameAsRequested = 1,
+};
+
+struct ArenaConfig {
+  // Upper bound on the memory the arena holds. 0 keeps the limit of the device allocator registration.
+  size_t max_mem = 0;
+  // Size of the first region.
+  size_t initial_chunk_size_bytes = 1 << 20;
+  ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+  // Regions that stay completely unused for this long are returned to the device allocator.
+  // The check runs as the arena is used. 0 disables it.
+  int64_t idle_shrink_timeout_ms = 0;
+};
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -27,6 +47,8 @@ class IArenaAllocator : public IAllocator {
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
   const OrtMemoryInfo& Info() const override = 0;
+  // Return memory that is not in use to the device allocator, if the arena supports it.
+  virtual Status Shrink() { return Status::OK(); }
   // allocate host pinned memory?
 };
 
@@ -3,14 +3,23 @@
 
 #include "core/framework/bfc_arena.h"
 
+#include <thread>
+
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   const ArenaConfig& config)
+    : initial_chunk_size_bytes_(config.initial_chunk_size_bytes),
+      arena_extend_strategy_(config.arena_extend_strategy),
+      idle_shrink_timeout_(config.idle_shrink_timeout_ms),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
-  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      thread_caches_(new ThreadCache[kNumThreadCaches]),
+      last_idle_check_(std::chrono::steady_clock::now()) {
+  ORT_ENFORCE(initial_chunk_size_bytes_ > 0, "initial_chunk_size_bytes must be positive");
+  curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, initial_chunk_size_bytes_));
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -68,13 +77,17 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   // allocation, keep multiplying by a power of two until that is
   // sufficient.
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo) {
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= 2;
+      increased_allocation = true;
+    }
   }
 
   // Try allocating.
-  size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
+  size_t bytes = arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo
+                     ? std::min(curr_region_allocation_bytes_, available_bytes)
+                     : rounded_bytes;
   void* mem_addr = device_allocator_->Alloc(bytes);
   if (mem_addr == nullptr && !started_backpedal_) {
     // Only backpedal once.
@@ -94,7 +107,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  if (!increased_allocation) {
+  if (arena_extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo && !increased_allocation) {
     // Increase the region size of the next required allocation.
     curr_region_allocation_bytes_ *= 2;
   }
@@ -121,6 +134,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
   c->next = kInvalidChunkHandle;
 
   region_manager_.set_handle(c->ptr, h);
+  idle_regions_[mem_addr] = std::chrono::steady_clock::now();
 
   // TODO(vrv): Try to merge this new region with an existing region,
   // if the address space is contiguous, to avoid fragmentation
@@ -184,6 +198,15 @@ size_t BFCArena::RequestedSize(const void* ptr) {
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
   BFCArena::Chunk* c = ChunkFromHandle(h);
+  if (c->thread_cache != kNoThreadCache) {
+    // A chunk reused from a cache keeps the requested size in the cache.
+    ThreadCache& cache = thread_caches_[c->thread_cache];
+    std::lock_guard<OrtMutex> cache_lock(cache.mutex);
+    auto it = cache.granted.find(ptr);
+    if (it != cache.granted.end()) {
+      return it->second.requested_size;
+    }
+  }
   return c->requested_size;
 }
 
@@ -209,18 +232,35 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
+  int cache_index = kNoThreadCache;
+  if (bin_num < kNumCachedBins) {
+    ThreadCache& cache = CacheForCurrentThread();
+    void* ptr = AllocateFromCache(cache, bin_num, rounded_bytes, num_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+    cache_index = static_cast<int>(&cache - thread_caches_.get());
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-  if (ptr != nullptr) {
-    return ptr;
-  }
 
   // Try to extend
-  if (Extend(rounded_bytes)) {
+  if (ptr == nullptr && Extend(rounded_bytes)) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
-    if (ptr != nullptr) {
-      return ptr;
+  }
+
+  // Chunks parked in the thread caches may coalesce into something big
+  // enough once they are returned to the bins.
+  if (ptr == nullptr && FlushThreadCaches() > 0) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
+  }
+
+  if (ptr != nullptr) {
+    if (cache_index != kNoThreadCache) {
+      GrantToCache(cache_index, ptr, num_bytes);
     }
+    return ptr;
   }
 
   // We searched all bins for an existing free chunk to use and
@@ -235,9 +275,117 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   return nullptr;
 }
 
+BFCArena::ThreadCache& BFCArena::CacheForCurrentThread() {
+  size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % kNumThreadCaches;
+  return thread_caches_[index];
+}
+
+void* BFCArena::AllocateFromCache(ThreadCache& cache, BinNum bin_num, size_t rounded_bytes, size_t num_bytes) {
+  std::lock_guard<OrtMutex> lock(cache.mutex);
+  auto& free_chunks = cache.free_chunks[bin_num];
+  // Most recently freed first, as it is the most likely to still be warm.
+  for (auto it = free_chunks.rbegin(); it != free_chunks.rend(); ++it) {
+    if (it->size >= rounded_bytes) {
+      void* ptr = it->ptr;
+      cache.granted[ptr] = {it->size, num_bytes};
+      *it = free_chunks.back();
+      free_chunks.pop_back();
+      ++cache.num_allocs;
+      return ptr;
+    }
+  }
+  return nullptr;
+}
+
+bool BFCArena::FreeToCache(ThreadCache& cache, void* ptr) {
+  std::vector<ThreadCache::FreeEntry> to_return;
+  {
+    std::lock_guard<OrtMutex> lock(cache.mutex);
+    auto it = cache.granted.find(ptr);
+    if (it == cache.granted.end()) {
+      return false;
+    }
+
+    auto& free_chunks = cache.free_chunks[BinNumForSize(it->second.size)];
+    if (free_chunks.size() >= kMaxCachedChunksPerBin) {
+      // Hand the oldest half back to the bins in one go.
+      const auto half = free_chunks.begin() + kMaxCachedChunksPerBin / 2;
+      to_return.assign(free_chunks.begin(), half);
+      free_chunks.erase(free_chunks.begin(), half);
+    }
+    free_chunks.push_back({ptr, it->second.size});
+    cache.granted.erase(it);
+  }
+
+  if (!to_return.empty()) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    for (const auto& entry : to_return) {
+      ReturnCachedChunk(entry.ptr);
+    }
+  }
+  return true;
+}
+
+void BFCArena::GrantToCache(int cache_index, void* ptr, size_t num_bytes) {
+  BFCArena::Chunk* c = ChunkFromHandle(region_manager_.get_handle(ptr));
+  // Large free chunks get split, so a chunk from a cached bin may end up in
+  // a bigger bin. Only keep the ones that fit the cache.
+  if (BinNumForSize(c->size) >= kNumCachedBins) {
+    return;
+  }
+  c->thread_cache = cache_index;
+  ThreadCache& cache = thread_caches_[cache_index];
+  std::lock_guard<OrtMutex> lock(cache.mutex);
+  cache.granted[ptr] = {c->size, num_bytes};
+}
+
+void BFCArena::ReturnCachedChunk(void* ptr) {
+  BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+  ORT_ENFORCE(h != kInvalidChunkHandle);
+  ChunkFromHandle(h)->thread_cache = kNoThreadCache;
+  FreeAndMaybeCoalesce(h);
+}
+
+size_t BFCArena::FlushThreadCaches() {
+  size_t num_returned = 0;
+  for (size_t i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    std::vector<ThreadCache::FreeEntry> to_return;
+    {
+      std::lock_guard<OrtMutex> lock(cache.mutex);
+      stats_.num_allocs += cache.num_allocs;
+      cache.num_allocs = 0;
+      for (auto& free_chunks : cache.free_chunks) {
+        to_return.insert(to_return.end(), free_chunks.begin(), free_chunks.end());
+        free_chunks.clear();
+      }
+    }
+    for (const auto& entry : to_return) {
+      ReturnCachedChunk(entry.ptr);
+    }
+    num_returned += to_return.size();
+  }
+  return num_returned;
+}
+
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
+  // Parked chunks are not in use by any client, so leave them out of
+  // bytes_in_use without disturbing the caches.
+  int64_t cached_bytes = 0;
+  for (size_t i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    std::lock_guard<OrtMutex> cache_lock(cache.mutex);
+    stats_.num_allocs += cache.num_allocs;
+    cache.num_allocs = 0;
+    for (const auto& free_chunks : cache.free_chunks) {
+      for (const auto& entry : free_chunks) {
+        cached_bytes += static_cast<int64_t>(entry.size);
+      }
+    }
+  }
   *stats = stats_;
+  stats->bytes_in_use -= cached_bytes;
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -256,6 +404,10 @@ void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         // We found an existing chunk that fits us that wasn't in use, so remove
         // it from the free bin structure prior to using.
         RemoveFreeChunkIterFromBin(&b->free_chunks, citer);
+        if (chunk->prev == kInvalidChunkHandle && chunk->next == kInvalidChunkHandle) {
+          // This chunk spans a whole region, which is no longer idle.
+          idle_regions_.erase(chunk->ptr);
+        }
 
         // If we can break the size of the chunk into two reasonably large
         // pieces, do so.  In any case don't waste more than
@@ -328,6 +480,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (FreeToCache(CacheForCurrentThread(), p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -338,6 +493,64 @@ void BFCArena::Free(void* p) {
   } else {
     DeallocateRawInternal(p);
   }
+  MaybeShrinkIdleRegions();
+}
+
+Status BFCArena::Shrink() {
+  std::lock_guard<OrtMutex> lock(lock_);
+  ShrinkInternal(false);
+  return Status::OK();
+}
+
+void BFCArena::MaybeShrinkIdleRegions() {
+  if (idle_shrink_timeout_.count() == 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_idle_check_ < idle_shrink_timeout_) {
+    return;
+  }
+  last_idle_check_ = now;
+  ShrinkInternal(true);
+}
+
+void BFCArena::ShrinkInternal(bool idle_only) {
+  // Parked chunks keep their regions busy.
+  FlushThreadCaches();
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<void*> to_free;
+  for (const auto& region : region_manager_.regions()) {
+    auto it = idle_regions_.find(region.ptr());
+    if (it == idle_regions_.end()) {
+      continue;
+    }
+    if (idle_only && now - it->second < idle_shrink_timeout_) {
+      continue;
+    }
+    to_free.push_back(region.ptr());
+  }
+
+  for (void* ptr : to_free) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    const Chunk* c = ChunkFromHandle(h);
+    ORT_ENFORCE(!c->in_use() && c->next == kInvalidChunkHandle);
+    size_t bytes = c->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    idle_regions_.erase(ptr);
+    device_allocator_->Free(ptr);
+    stats_.total_allocated_bytes -= bytes;
+    LOGS_DEFAULT(INFO) << "Freed region of " << bytes << " bytes at " << ptr;
+  }
+
+  if (region_manager_.regions().empty()) {
+    // Start over from the configured size rather than the last doubled one.
+    curr_region_allocation_bytes_ = RoundedBytes(std::min(memory_limit_, initial_chunk_size_bytes_));
+    started_backpedal_ = false;
+  }
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -345,6 +558,17 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
 
+  // Freed by a thread other than the ones sharing the cache it came from.
+  Chunk* c = ChunkFromHandle(h);
+  if (c->thread_cache != kNoThreadCache) {
+    ThreadCache& cache = thread_caches_[c->thread_cache];
+    {
+      std::lock_guard<OrtMutex> cache_lock(cache.mutex);
+      cache.granted.erase(ptr);
+    }
+    c->thread_cache = kNoThreadCache;
+  }
+
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
 }
@@ -460,6 +684,11 @@ void BFCArena::FreeAndMaybeCoalesce(BFCArena::ChunkHandle h) {
     }
   }
 
+  c = ChunkFromHandle(chunk_to_reassign);
+  if (c->prev == kInvalidChunkHandle && c->next == kInvalidChunkHandle) {
+    idle_regions_[c->ptr] = std::chrono::steady_clock::now();
+  }
+
   InsertFreeChunkIntoBin(chunk_to_reassign);
 }
 
@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -83,7 +86,8 @@ struct AllocatorStats {
 // all requests to allocate memory go through this interface.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           const ArenaConfig& config = ArenaConfig());
 
   ~BFCArena() override;
 
@@ -97,6 +101,11 @@ class BFCArena : public IArenaAllocator {
 
   void* Reserve(size_t size) override;
 
+  // Return every region that holds no allocations to the device allocator.
+  Status Shrink() override;
+
+  // Chunks parked in the per-thread caches are counted as used until they
+  // are returned to the bins. GetStats() reports the exact figure.
   size_t Used() const override {
     return stats_.bytes_in_use;
   }
@@ -133,6 +142,16 @@ class BFCArena : public IArenaAllocator {
   static const int kInvalidBinNum = -1;
   static const int kNumBins = 21;
 
+  // Chunks from the first kNumCachedBins bins (i.e. smaller than 64KB) are
+  // kept in per-thread caches when freed instead of being coalesced back
+  // into the bins straight away.
+  static const int kNumCachedBins = 8;
+  // Number of free chunks a cache keeps per bin before it returns half of
+  // them to the bins in one batch.
+  static const size_t kMaxCachedChunksPerBin = 32;
+  static const size_t kNumThreadCaches = 16;
+  static const int kNoThreadCache = -1;
+
   // Chunks point to memory.  Their prev/next pointers form a
   // doubly-linked list of addresses sorted by base address that
   // must be contiguous.  Chunks contain information about whether
@@ -167,6 +186,11 @@ class BFCArena : public IArenaAllocator {
     // What bin are we in?
     BinNum bin_num = kInvalidBinNum;
 
+    // Index of the thread cache that manages this chunk, or kNoThreadCache.
+    // While set, the chunk is in use as far as the bins are concerned, and
+    // the cache tracks whether a client holds it or it is parked for reuse.
+    int thread_cache = kNoThreadCache;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -217,6 +241,32 @@ class BFCArena : public IArenaAllocator {
         : bin_size(bs), free_chunks(ChunkComparator(allocator)) {}
   };
 
+  // A cache of small chunks for the threads that hash onto it. Alloc/Free
+  // of a chunk the cache knows about only takes the cache's own mutex, which
+  // is normally uncontended, rather than lock_.
+  //
+  // Lock order is lock_ before ThreadCache::mutex.
+  struct ThreadCache {
+    struct FreeEntry {
+      void* ptr;
+      size_t size;
+    };
+
+    struct GrantedEntry {
+      size_t size;
+      size_t requested_size;
+    };
+
+    OrtMutex mutex;
+    // Chunks that were freed by clients and can be handed out again,
+    // indexed by the bin of their size.
+    std::array<std::vector<FreeEntry>, kNumCachedBins> free_chunks;
+    // Chunks currently held by clients.
+    std::unordered_map<const void*, GrantedEntry> granted;
+    // Allocations served from this cache not yet folded into stats_.
+    int64_t num_allocs = 0;
+  };
+
   static const size_t kMinAllocationBits = 8;
   static const size_t kMinAllocationSize = 1 << kMinAllocationBits;
 
@@ -315,6 +365,13 @@ class BFCArena : public IArenaAllocator {
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr);
+      regions_.erase(entry);
+    }
+
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
    private:
@@ -344,6 +401,25 @@ class BFCArena : public IArenaAllocator {
     std::vector<AllocationRegion> regions_;
   };
 
+  ThreadCache& CacheForCurrentThread();
+
+  // Tries to serve an allocation from 'cache' without taking lock_.
+  void* AllocateFromCache(ThreadCache& cache, BinNum bin_num, size_t rounded_bytes, size_t num_bytes);
+
+  // Tries to park 'ptr' in 'cache' without taking lock_. Returns false if
+  // the cache does not manage 'ptr'.
+  bool FreeToCache(ThreadCache& cache, void* ptr);
+
+  // Hands the chunk at 'ptr' to the cache 'cache_index'. Requires lock_.
+  void GrantToCache(int cache_index, void* ptr, size_t num_bytes);
+
+  // Returns a parked chunk to the bins. Requires lock_.
+  void ReturnCachedChunk(void* ptr);
+
+  // Returns every parked chunk to the bins and folds the cache counters into
+  // stats_. Returns the number of chunks returned. Requires lock_.
+  size_t FlushThreadCaches();
+
   // Returns 'bytes' rounded up to the next highest kMinAllocationSize.
   size_t RoundedBytes(size_t bytes);
 
@@ -352,6 +428,15 @@ class BFCArena : public IArenaAllocator {
   // failure.
   bool Extend(size_t rounded_bytes);
 
+  // Frees the regions that hold no allocations. With 'idle_only' only the
+  // ones that have been unused for idle_shrink_timeout_ are freed.
+  // Requires lock_.
+  void ShrinkInternal(bool idle_only);
+
+  // Runs ShrinkInternal(true) if idle_shrink_timeout_ has passed since the
+  // last check. Requires lock_.
+  void MaybeShrinkIdleRegions();
+
   // Returns a pointer to an underlying allocated chunk of size
   // 'rounded_bytes'.
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes);
@@ -402,6 +487,9 @@ class BFCArena : public IArenaAllocator {
 
   // Structures immutable after construction
   size_t memory_limit_ = 0;
+  size_t initial_chunk_size_bytes_;
+  ArenaExtendStrategy arena_extend_strategy_;
+  std::chrono::milliseconds idle_shrink_timeout_;
 
   int Log2FloorNonZeroSlow(uint64_t n) {
     int r = 0;
@@ -480,6 +568,12 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+
+  // Regions that currently hold no allocations, and since when.
+  std::unordered_map<const void*, std::chrono::steady_clock::time_point> idle_regions_;
+  std::chrono::steady_clock::time_point last_idle_check_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
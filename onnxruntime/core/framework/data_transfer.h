@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "core/common/status.h"
 #include "core/framework/tensor.h"
 
@@ -17,6 +20,16 @@ class IDataTransfer {
 
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const = 0;
+
+  struct SrcDstPair {
+    std::reference_wrapper<const Tensor> src;
+    std::reference_wrapper<Tensor> dst;
+    int exec_queue_id;
+  };
+
+  // Copies the tensors one by one by default. Providers may override it to share the staging and synchronization
+  // of the copies, which dominate the cost of copying many small tensors.
+  virtual common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const;
 };
 
 class CPUDataTransfer : public IDataTransfer {
@@ -51,4 +51,45 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst, int exec_
                          dst.Location().device.ToString());
 }
 
+Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs) const {
+  if (src_dst_pairs.empty()) {
+    return Status::OK();
+  }
+
+  const IDataTransfer* first_data_transfer = nullptr;
+  bool single_data_transfer = true;
+  for (const auto& pair : src_dst_pairs) {
+    const Tensor& src = pair.src;
+    const Tensor& dst = pair.dst;
+    if (src.Shape().Size() != dst.Shape().Size()) {
+      return Status(ONNXRUNTIME, FAIL, "Tensor size mismatch");
+    }
+
+    const IDataTransfer* data_transfer = GetDataTransfer(src.Location().device, dst.Location().device);
+    if (data_transfer == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME,
+                             FAIL,
+                             "There's no data transfer registered for copying tensors from ",
+                             src.Location().device.ToString(),
+                             " to ",
+                             dst.Location().device.ToString());
+    }
+
+    if (first_data_transfer == nullptr) {
+      first_data_transfer = data_transfer;
+    } else if (data_transfer != first_data_transfer) {
+      single_data_transfer = false;
+    }
+  }
+
+  if (single_data_transfer) {
+    return first_data_transfer->CopyTensors(src_dst_pairs);
+  }
+
+  for (const auto& pair : src_dst_pairs) {
+    ORT_RETURN_IF_ERROR(CopyTensor(pair.src, pair.dst, pair.exec_queue_id));
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
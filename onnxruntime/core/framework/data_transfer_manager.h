@@ -23,6 +23,9 @@ class DataTransferManager {
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const;
 
+  // Copies the tensors in one batch if a single data transfer handles all of them, otherwise one by one.
+  common::Status CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DataTransferManager);
 
@@ -13,6 +13,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/framework/utils.h"
+#include "core/providers/cpu/tensor/copy.h"
 
 using namespace onnxruntime::common;
 
@@ -21,7 +22,8 @@ namespace onnxruntime {
 IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                                  const std::unordered_map<int, OrtValue>& initializers,
                                  const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
-                                 const OrtValueNameIdxMap& ort_value_idx_map, const NodeIndexInfo& node_index_info)
+                                 const OrtValueNameIdxMap& ort_value_idx_map, const NodeIndexInfo& node_index_info,
+                                 std::unique_ptr<std::vector<OrtValue>> values)
     : node_index_info_{node_index_info},
       all_values_size_{static_cast<size_t>(ort_value_idx_map.MaxIdx()) + 1},
       fetch_mlvalue_idxs_{fetch_mlvalue_idxs} {
@@ -30,7 +32,7 @@ IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, cons
   ORT_ENFORCE(node_index_info_.GetMaxMLValueIdx() == ort_value_idx_map.MaxIdx(),
               "node_index_info and ort_value_idx_map are out of sync and cannot be used");
 
-  Init(feed_mlvalue_idxs, feeds, initializers, fetches);
+  Init(feed_mlvalue_idxs, feeds, initializers, fetches, std::move(values));
 }
 
 IExecutionFrame::~IExecutionFrame() = default;
@@ -76,12 +78,69 @@ Status IExecutionFrame::GetOrCreateNodeOutputMLValue(int index, const TensorShap
   return status;
 }
 
+// Makes ort_value a tensor over the buffer of viewed_value, starting offset elements into it, with the given strides
+// (row-major if empty). The deleter holds a reference to the viewed value, so its buffer lives as long as the view.
+static void MakeTensorView(OrtValue& ort_value, OrtValue& viewed_value, MLDataType element_type,
+                           const TensorShape& shape, const std::vector<int64_t>& strides, int64_t offset) {
+  auto* viewed_tensor = viewed_value.GetMutable<Tensor>();
+  void* data = static_cast<char*>(viewed_tensor->MutableDataRaw()) +
+               offset * static_cast<int64_t>(element_type->Size());
+  auto p_tensor = std::make_unique<Tensor>(element_type, shape, data, viewed_tensor->Location());
+  if (!strides.empty()) {
+    p_tensor->SetShapeAndStrides(shape, strides);
+  }
+
+  auto delete_tensor = DataTypeImpl::GetType<Tensor>()->GetDeleteFunc();
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                 [viewed_value, delete_tensor](void* p) { delete_tensor(p); });
+  ort_value.ShareFenceWith(viewed_value);
+}
+
+Status IExecutionFrame::CreateNodeOutputView(int index, int input_index, const TensorShape& shape,
+                                             const std::vector<int64_t>& strides, int64_t offset,
+                                             OrtValue*& p_ort_value) {
+  p_ort_value = nullptr;
+  int ort_value_idx = GetNodeIdxToMLValueIdx(index);
+  int viewed_idx = GetNodeIdxToMLValueIdx(input_index);
+  if (ort_value_idx == NodeIndexInfo::kInvalidEntry || viewed_idx == NodeIndexInfo::kInvalidEntry ||
+      !IsPlannedView(ort_value_idx, viewed_idx)) {
+    return Status::OK();
+  }
+
+  OrtValue& ort_value = all_values_[ort_value_idx];
+  OrtValue& viewed_value = all_values_[viewed_idx];
+  if (ort_value.IsAllocated() || !viewed_value.IsAllocated() || !viewed_value.IsTensor()) {
+    return Status::OK();
+  }
+
+  const auto& viewed_tensor = viewed_value.Get<Tensor>();
+  MakeTensorView(ort_value, viewed_value, viewed_tensor.DataType(), shape, strides, offset);
+  p_ort_value = &ort_value;
+  return Status::OK();
+}
+
 AllocatorPtr IExecutionFrame::GetAllocator(const OrtMemoryInfo& info) const {
   return GetAllocatorImpl(info);
 }
 
 Status IExecutionFrame::ReleaseMLValue(int ort_value_idx) { return ReleaseMLValueImpl(ort_value_idx); }
 
+void* IExecutionFrame::AllocateScratchBuffer(NodeIndex node_index, const AllocatorPtr& alloc, size_t size) {
+  return AllocateScratchBufferImpl(node_index, alloc, size);
+}
+
+void IExecutionFrame::ReleaseScratchBuffer(NodeIndex node_index, const AllocatorPtr& alloc, void* buffer) {
+  ReleaseScratchBufferImpl(node_index, alloc, buffer);
+}
+
+void* IExecutionFrame::AllocateScratchBufferImpl(NodeIndex /*node_index*/, const AllocatorPtr& alloc, size_t size) {
+  return alloc->Alloc(size);
+}
+
+void IExecutionFrame::ReleaseScratchBufferImpl(NodeIndex /*node_index*/, const AllocatorPtr& alloc, void* buffer) {
+  alloc->Free(buffer);
+}
+
 Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   if (ort_value_idx == NodeIndexInfo::kInvalidEntry || static_cast<size_t>(ort_value_idx) >= all_values_size_) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index ", ort_value_idx);
@@ -106,9 +165,16 @@ int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
 
 void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                            const std::unordered_map<int, OrtValue>& initializers,
-                           const std::vector<OrtValue>& fetches) {
-  // 1. resize the all_value_ vector
-  all_values_.resize(all_values_size_);
+                           const std::vector<OrtValue>& fetches, std::unique_ptr<std::vector<OrtValue>> values) {
+  // 1. resize the all_value_ vector, or take the table that already has the weights
+  const bool has_initializers = values != nullptr;
+  if (has_initializers) {
+    ORT_ENFORCE(values->size() == all_values_size_, "The table of values doesn't match the OrtValue indices");
+    all_values_.swap(*values);
+    values_table_ = std::move(values);
+  } else {
+    all_values_.resize(all_values_size_);
+  }
 
   // 2. Handle non-empty output vector
   if (!fetches.empty()) {
@@ -116,6 +182,10 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std:
 
     for (size_t idx = 0; idx < num_fetches; ++idx) {
       int ort_value_idx = fetch_mlvalue_idxs_[idx];
+      // the weights take precedence, see below
+      if (has_initializers && initializers.find(ort_value_idx) != initializers.end()) {
+        continue;
+      }
       all_values_[ort_value_idx] = fetches[idx];
     }
   }
@@ -127,9 +197,11 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std:
   // A non-empty fetches vector will overwrite the actual weight in all_values_[ort_value_idx] if we did this earlier.
   // This makes the ONNX Constant test (onnx\backend\test\data\node\test_constant) happy as that
   // involves a graph with a single Constant node.
-  for (const auto& entry : initializers) {
-    int ort_value_index = entry.first;
-    all_values_[ort_value_index] = entry.second;
+  if (!has_initializers) {
+    for (const auto& entry : initializers) {
+      int ort_value_index = entry.first;
+      all_values_[ort_value_index] = entry.second;
+    }
   }
 
   // 4. handle feed in values. these can override initializer values so must be last
@@ -140,6 +212,12 @@ void IExecutionFrame::Init(const std::vector<int>& feed_mlvalue_idxs, const std:
   }
 }
 
+std::unique_ptr<std::vector<OrtValue>> IExecutionFrame::TakeValues() {
+  auto values = values_table_ ? std::move(values_table_) : std::make_unique<std::vector<OrtValue>>();
+  values->swap(all_values_);
+  return values;
+}
+
 Status IExecutionFrame::GetOutputs(std::vector<OrtValue>& fetches) {
   auto num_fetches = fetch_mlvalue_idxs_.size();
 
@@ -170,10 +248,25 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                const SessionState& session_state)
     : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
-                      session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
+                      session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(),
+                      session_state.AcquireOrtValueTable()),
       session_state_{session_state},
       mem_patterns_{nullptr},
       planner_{nullptr} {
+  const auto& initializers = session_state.GetInitializedTensors();
+  if (!initializers.empty()) {
+    for (int ort_value_idx : feed_mlvalue_idxs) {
+      if (initializers.find(ort_value_idx) != initializers.end()) {
+        feeds_override_initializers_ = true;
+        break;
+      }
+    }
+  }
+
+  if (session_state.GetMemoryProfiler() != nullptr) {
+    memory_profiler_run_ = std::make_unique<MemoryProfiler::Run>(*session_state.GetMemoryProfiler());
+  }
+
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
@@ -205,7 +298,7 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
 
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
+      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes, feed_mlvalue_idxs);
       // if no existing patterns, generate one in this executionframe
       if (!mem_patterns_) {
         planner_ = std::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
@@ -220,12 +313,18 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
                              : nullptr;
           buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
         }
+        if (memory_profiler_run_ != nullptr) {
+          memory_profiler_run_->CheckArenas("memory_pattern");
+        }
       }
     }
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  // the values of the run are released before the pre-allocated chunks of the memory pattern they may point into
+  session_state_.ReleaseOrtValueTable(TakeValues(), feeds_override_initializers_);
+}
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
@@ -272,19 +371,21 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // a block is planned for the largest inputs in the shape bucket, so smaller tensors fit too.
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
+          // there's no planner while a memory pattern is used, so this only traces the block for memory profiling
+          TraceAllocate(ort_value_index, size);
           return status;
         }
-        if (block->size_ != size) {
+        if (size > block->size_) {
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
-          // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
+          mem_pattern_missed_ = true;
           LOGS_DEFAULT(VERBOSE) << "For ort_value with index: " << ort_value_index
                                 << ", block in memory pattern size is: " << block->size_
                                 << " but the actually size is: " << size
@@ -311,6 +412,41 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   return Status::OK();
 }
 
+void ExecutionFrame::AllocateMLValueTensorView(OrtValue& ort_value, OrtValue& viewed_value, MLDataType element_type,
+                                               const TensorShape& shape) {
+  MakeTensorView(ort_value, viewed_value, element_type, shape, {}, 0);
+}
+
+Status ExecutionFrame::MaterializeStridedInputs(const OpKernel& kernel) {
+  const auto& node = kernel.Node();
+  const int node_offset = GetNodeOffset(node.Index());
+  const int num_inputs = static_cast<int>(node.InputDefs().size());
+  const int num_implicit_inputs = static_cast<int>(node.ImplicitInputDefs().size());
+
+  for (int i = 0; i < num_inputs + num_implicit_inputs; ++i) {
+    // implicit inputs are read by the kernels of a subgraph, which may not read them strided
+    if (i < num_inputs && kernel.KernelDef().MayStridedInput(i)) continue;
+
+    int ort_value_idx = GetNodeIdxToMLValueIdx(node_offset + i);
+    if (ort_value_idx == NodeIndexInfo::kInvalidEntry) continue;
+    OrtValue& ort_value = GetMutableMLValue(ort_value_idx);
+    if (!ort_value.IsAllocated() || !ort_value.IsTensor() || ort_value.Get<Tensor>().IsContiguous()) continue;
+
+    const auto& strided = ort_value.Get<Tensor>();
+    auto p_tensor = std::make_unique<Tensor>(strided.DataType(), strided.Shape(), GetAllocator(strided.Location()));
+    StridedCopy(session_state_.GetThreadPool(), strided.DataType(), p_tensor->MutableDataRaw(), p_tensor->Strides(),
+                strided.Shape().GetDims(), strided.DataRaw(), strided.Strides());
+
+    // the copy replaces the view for this and the later consumers, and the view releases the buffer it shares
+    OrtValue contiguous;
+    contiguous.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    ort_value = contiguous;
+  }
+
+  return Status::OK();
+}
+
 Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_value, int ort_value_index_reuse,
                                                               MLDataType element_type, const OrtMemoryInfo& location,
                                                               const TensorShape& shape, bool create_fence) {
@@ -320,22 +456,19 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
   auto buffer_num_elements = reuse_tensor->Shape().Size();
   auto required_num_elements = shape.Size();
 
-  // check number of elements matches. shape may not be an exact match (e.g. Reshape op)
-  if (buffer_num_elements != required_num_elements) {
+  // the planner may reuse a buffer for a tensor of a different shape or type (e.g. Reshape, or a best fit
+  // of a larger dead buffer), so it is enough for the tensor to fit.
+  auto buffer_bytes = buffer_num_elements * static_cast<int64_t>(reuse_tensor->DataType()->Size());
+  auto required_bytes = required_num_elements * static_cast<int64_t>(element_type->Size());
+  if (buffer_bytes < required_bytes) {
     // could be an allocation planner bug (less likely) or the model incorrectly uses something like 'None'
     // as a dim_param, or -1 in dim_value in multiple places making the planner think those shapes are equal.
-    auto message = onnxruntime::MakeString(
-        "Shape mismatch attempting to re-use buffer. ",
-        reuse_tensor->Shape(), " != ", shape,
-        ". Validate usage of dim_value (values should be > 0) and "
-        "dim_param (all values with the same string should equate to the same size) in shapes in the model.");
-
-    // be generous and use the buffer if it's large enough. log a warning though as it indicates a bad model
-    if (buffer_num_elements >= required_num_elements) {
-      LOGS_DEFAULT(WARNING) << message;
-    } else {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, message);
-    }
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Shape mismatch attempting to re-use buffer. ",
+                           reuse_tensor->Shape(), " != ", shape,
+                           ". Validate usage of dim_value (values should be > 0) and "
+                           "dim_param (all values with the same string should equate to the same size) in shapes "
+                           "in the model.");
   }
 
   void* reuse_buffer = reuse_tensor->MutableDataRaw();
@@ -415,6 +548,36 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
     // tensors
     const auto* ml_data_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
 
+    // write the tensor straight into the pre-allocated output its consumer computes in place from it
+    if (per_alloc_plan.inplace_output >= 0) {
+      const OrtValue& output = GetMLValue(per_alloc_plan.inplace_output);
+      if (output.IsAllocated() && output.IsTensor()) {
+        const auto& output_tensor = output.Get<Tensor>();
+        if (output_tensor.Location().device == alloc_info.device &&
+            output_tensor.Shape().Size() * static_cast<int64_t>(output_tensor.DataType()->Size()) ==
+                shape->Size() * static_cast<int64_t>(ml_data_type->Size())) {
+          TraceReuse(ort_value_index, per_alloc_plan.inplace_output);
+          return AllocateMLValueTensorPreAllocateBuffer(ort_value, per_alloc_plan.inplace_output, ml_data_type,
+                                                        alloc_info, *shape, per_alloc_plan.create_fence_if_async);
+        }
+      }
+    }
+
+    // a graph output that is a view of the input of its aliasing kernel (e.g. Reshape) shares the input buffer
+    if (per_alloc_plan.view_of >= 0 && per_alloc_plan.alloc_kind == AllocKind::kAllocateOutput) {
+      OrtValue& input = GetMutableMLValue(per_alloc_plan.view_of);
+      if (input.IsAllocated() && input.IsTensor()) {
+        auto* input_tensor = input.GetMutable<Tensor>();
+        if (input_tensor->Location().device == alloc_info.device &&
+            input_tensor->Shape().Size() * static_cast<int64_t>(input_tensor->DataType()->Size()) ==
+                shape->Size() * static_cast<int64_t>(ml_data_type->Size())) {
+          AllocateMLValueTensorView(ort_value, input, ml_data_type, *shape);
+          TraceReuse(ort_value_index, per_alloc_plan.view_of);
+          return Status::OK();
+        }
+      }
+    }
+
     AllocKind alloc_kind = per_alloc_plan.alloc_kind;
     switch (alloc_kind) {
       // Right now for kAllocate and kAllocateOutput we are using same approach.
@@ -426,15 +589,23 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
         break;
       }
       case AllocKind::kReuse: {
+        // the kernel didn't create the strided view it may produce, so the output can't share the input buffer
+        if (per_alloc_plan.view_of >= 0) {
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, ml_data_type, alloc_info,
+                                                                 *shape, per_alloc_plan.create_fence_if_async));
+          break;
+        }
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
         ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
             ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, per_alloc_plan.create_fence_if_async));
+        TraceReuse(ort_value_index, reuse_mlvalue_index);
         break;
       }
       case AllocKind::kShare: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
         // copy at the OrtValue level so the shared_ptr for the data is shared between the two OrtValue instances
         ort_value = GetMutableMLValue(reuse_mlvalue_index);
+        TraceReuse(ort_value_index, reuse_mlvalue_index);
         break;
       }
       default: {
@@ -469,6 +640,12 @@ Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   return Status::OK();
 }
 
+bool ExecutionFrame::IsPlannedView(int ort_value_idx, int viewed_idx) {
+  if (custom_allocators_.count(ort_value_idx) != 0) return false;
+  const auto& per_alloc_plan = GetAllocationPlan(ort_value_idx);
+  return per_alloc_plan.alloc_kind == AllocKind::kReuse && per_alloc_plan.view_of == viewed_idx;
+}
+
 const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
   const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
   const auto& alloc_plan = p_seq_exec_plan->allocation_plan;
@@ -477,6 +654,10 @@ const AllocPlanPerValue& ExecutionFrame::GetAllocationPlan(int ort_value_idx) {
 }
 
 void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
+  if (memory_profiler_run_ != nullptr) {
+    memory_profiler_run_->RecordAllocation(ort_value_idx, static_cast<int64_t>(size));
+  }
+
   if (planner_) {
     // don't trace the output tensors.
     auto& allocation_plan = GetAllocationPlan(ort_value_idx);
@@ -488,7 +669,17 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
   }
 }
 
+void ExecutionFrame::TraceReuse(int ort_value_idx, int reused_ort_value_idx) {
+  if (memory_profiler_run_ != nullptr) {
+    memory_profiler_run_->RecordReuse(ort_value_idx, reused_ort_value_idx);
+  }
+}
+
 void ExecutionFrame::TraceFree(int ort_value_idx) {
+  if (memory_profiler_run_ != nullptr) {
+    memory_profiler_run_->RecordRelease(ort_value_idx);
+  }
+
   // don't trace free on output tensors.
   if (planner_ && !IsOutput(ort_value_idx)) {
     const SequentialExecutionPlan* p_seq_exec_plan = session_state_.GetExecutionPlan();
@@ -496,9 +687,9 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
     ORT_ENFORCE(ort_value_idx >= 0 && static_cast<size_t>(ort_value_idx) < alloc_plan.size());
     const auto& per_alloc_plan = alloc_plan[ort_value_idx];
 
-    // only trace tensors
+    // only trace tensors, and not those allocated like outputs (see TraceAllocate)
     auto ml_type = per_alloc_plan.value_type;
-    if (ml_type->IsTensorType()) {
+    if (ml_type->IsTensorType() && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput) {
       // tensors
       auto ml_data_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
       // don't trace string tensors
@@ -513,6 +704,61 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
   }
 }
 
+const MemoryBlock* ExecutionFrame::GetScratchBufferBlock(NodeIndex node_index, const OrtMemoryInfo& location) const {
+  if (!mem_patterns_ || buffers_.find(location) == buffers_.end()) {
+    return nullptr;
+  }
+
+  auto pattern = mem_patterns_->GetPatterns(location);
+  return pattern ? pattern->GetBlock(GetScratchBufferIdx(node_index)) : nullptr;
+}
+
+// Scratch buffers are traced like intermediate tensors that are freed when their kernel returns, so the runs that
+// use the memory pattern take them from the pre-allocated chunk instead of the allocator.
+void* ExecutionFrame::AllocateScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, size_t size) {
+  const auto& location = alloc->Info();
+  auto block = GetScratchBufferBlock(node_index, location);
+  if (block) {
+    if (size <= block->size_) {
+      return static_cast<char*>(buffers_.at(location).get()) + block->offset_;
+    }
+
+    mem_pattern_missed_ = true;
+    LOGS_DEFAULT(VERBOSE) << "For the scratch buffer of node " << node_index
+                          << ", block in memory pattern size is: " << block->size_
+                          << " but the actually size is: " << size << ", fall back to default allocation behavior";
+  }
+
+  void* buffer = alloc->Alloc(size);
+  if (planner_) {
+    auto status = planner_->TraceAllocation(location, GetScratchBufferIdx(node_index), size);
+    if (!status.IsOK())
+      LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for the scratch buffer of node " << node_index
+                                             << " size=" << size << " failed: " << status.ErrorMessage();
+  }
+
+  return buffer;
+}
+
+void ExecutionFrame::ReleaseScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, void* buffer) {
+  const auto& location = alloc->Info();
+  auto block = GetScratchBufferBlock(node_index, location);
+  if (block && buffer == static_cast<char*>(buffers_.at(location).get()) + block->offset_) {
+    // the block belongs to the pre-allocated chunk
+    return;
+  }
+
+  if (planner_) {
+    auto status = planner_->TraceFree(location, GetScratchBufferIdx(node_index));
+    if (!status.IsOK()) {
+      LOGS(session_state_.Logger(), WARNING)
+          << "TraceFree for the scratch buffer of node " << node_index << " failed: " << status.ErrorMessage();
+    }
+  }
+
+  alloc->Free(buffer);
+}
+
 // generate memory pattern based on the tracing of memory allocation/free in current execution
 // return error if the planner is not setup.
 Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup* out) const {
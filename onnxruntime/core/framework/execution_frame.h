@@ -3,12 +3,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/memory_profiler.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -21,14 +23,19 @@ class SessionState;
 class OrtValueNameIdxMap;
 class OrtValuePatternPlanner;
 struct MemoryPatternGroup;
+struct MemoryBlock;
 class NodeIndexInfo;
+class OpKernel;
 
 class IExecutionFrame {
  protected:
+  // If values is given, it is a table of all the values with the initializers already filled in, which the frame
+  // uses instead of building one. TakeValues returns it after the run.
   IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                   const std::unordered_map<int, OrtValue>& initializers, const std::vector<int>& fetch_mlvalue_idxs,
                   const std::vector<OrtValue>& fetches, const OrtValueNameIdxMap& ort_value_idx_map,
-                  const NodeIndexInfo& node_index_info);
+                  const NodeIndexInfo& node_index_info,
+                  std::unique_ptr<std::vector<OrtValue>> values = nullptr);
 
  public:
   virtual ~IExecutionFrame();
@@ -48,6 +55,13 @@ class IExecutionFrame {
   // Shape is required for tensors but not traditional ML values.
   Status GetOrCreateNodeOutputMLValue(int index, const TensorShape* shape, OrtValue*& p_ort_value, size_t nnz = 0);
 
+  // Creates the output at index as a view of the input at input_index, with the given strides (in elements) and
+  // the offset of its first element from that of the input. The input buffer is shared instead of copied.
+  // Return S_OK and nullptr if the plan doesn't make the output a view of that input: the caller then allocates
+  // the output as usual.
+  Status CreateNodeOutputView(int index, int input_index, const TensorShape& shape,
+                              const std::vector<int64_t>& strides, int64_t offset, OrtValue*& p_ort_value);
+
   /**
    * write the output values to the 'fetches' vector
    * Don't access the values after SessionState is destroyed 
@@ -58,6 +72,16 @@ class IExecutionFrame {
 
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Get the value of ort_value_idx, or set it in place of running the node that produces it, such as to memoize
+  // the value of a run and restore it in the next run (see IncrementalExecutionCache).
+  const OrtValue& GetValue(int ort_value_idx) const { return GetMLValue(ort_value_idx); }
+  void SetValue(int ort_value_idx, const OrtValue& value) { GetMutableMLValue(ort_value_idx) = value; }
+
+  // Allocates a scratch buffer of size bytes from alloc for the temporaries of the kernel of node_index.
+  // The buffer is only used while the kernel runs, and must be released with ReleaseScratchBuffer when it returns.
+  void* AllocateScratchBuffer(NodeIndex node_index, const AllocatorPtr& alloc, size_t size);
+  void ReleaseScratchBuffer(NodeIndex node_index, const AllocatorPtr& alloc, void* buffer);
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
@@ -66,15 +90,24 @@ class IExecutionFrame {
 
   virtual Status ReleaseMLValueImpl(int ort_value_idx);
 
+  virtual void* AllocateScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, size_t size);
+  virtual void ReleaseScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, void* buffer);
+
+  // returns true if the plan makes the ort_value_idx a strided view of viewed_idx
+  virtual bool IsPlannedView(int /*ort_value_idx*/, int /*viewed_idx*/) { return false; }
+
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // Moves the values out of the frame, into the table given to the constructor if there was one.
+  std::unique_ptr<std::vector<OrtValue>> TakeValues();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
   void Init(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
             const std::unordered_map<int, OrtValue>& initializers,
-            const std::vector<OrtValue>& fetches);
+            const std::vector<OrtValue>& fetches, std::unique_ptr<std::vector<OrtValue>> values);
 
   const OrtValue& GetMLValue(int ort_value_index) const {
     ORT_ENFORCE(ort_value_index >= 0 && static_cast<size_t>(ort_value_index) < all_values_size_);
@@ -91,6 +124,9 @@ class IExecutionFrame {
   // Input and Output values are passed in by executors
   std::vector<OrtValue> all_values_;
 
+  // The table the values were swapped out of, if the constructor was given one. Empty while the frame runs.
+  std::unique_ptr<std::vector<OrtValue>> values_table_;
+
   // perf optimization to avoid calling all_values_.size() repeatedly as the size is fixed once constructed
   const size_t all_values_size_;
 
@@ -118,6 +154,14 @@ class ExecutionFrame final : public IExecutionFrame {
                                                 const OrtMemoryInfo& location, const TensorShape& shape,
                                                 bool create_fence = false);
 
+  // makes ort_value a tensor of the given shape over the buffer of viewed_value, which it keeps alive
+  void AllocateMLValueTensorView(OrtValue& ort_value, OrtValue& viewed_value, MLDataType element_type,
+                                 const TensorShape& shape);
+
+  // Replaces the inputs of kernel that are strided views by contiguous copies, unless the kernel reads them
+  // strided (KernelDef::MayStridedInput). This is a no-op when the plan has no strided views.
+  Status MaterializeStridedInputs(const OpKernel& kernel);
+
   // thread-safe
   Status GeneratePatterns(MemoryPatternGroup* out) const;
 
@@ -125,12 +169,25 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_ != nullptr;
   }
 
+  // True if a tensor was larger than its block in the cached memory pattern.
+  bool MemoryPatternMissed() const {
+    return mem_pattern_missed_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
   AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const override;
   Status ReleaseMLValueImpl(int ort_value_idx) override;
+  bool IsPlannedView(int ort_value_idx, int viewed_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
+  void* AllocateScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, size_t size) override;
+  void ReleaseScratchBufferImpl(NodeIndex node_index, const AllocatorPtr& alloc, void* buffer) override;
+
+  // Returns the block of the scratch buffer of node_index in the memory pattern, or nullptr if there is none.
+  // Scratch buffers are traced in the memory pattern with negative indices, apart from the OrtValue indices.
+  const MemoryBlock* GetScratchBufferBlock(NodeIndex node_index, const OrtMemoryInfo& location) const;
+  static int GetScratchBufferIdx(NodeIndex node_index) { return -2 - static_cast<int>(node_index); }
 
   common::Status AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_value_index, const TensorShape* shape,
                                              size_t nnz);
@@ -143,6 +200,7 @@ class ExecutionFrame final : public IExecutionFrame {
                                                    const OrtMemoryInfo& location, const TensorShape& shape);
 
   void TraceAllocate(int ort_value_idx, size_t size);
+  void TraceReuse(int ort_value_idx, int reused_ort_value_idx);
   void TraceFree(int ort_value_idx);
 
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
@@ -155,7 +213,11 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // Shared with the cache in SessionState, which may evict it while this frame runs.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // Set from the threads allocating node outputs.
+  std::atomic<bool> mem_pattern_missed_{false};
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -163,5 +225,11 @@ class ExecutionFrame final : public IExecutionFrame {
 
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
+
+  // Records the memory used by this run if the session profiles its memory.
+  std::unique_ptr<MemoryProfiler::Run> memory_profiler_run_;
+
+  // True if a feed replaced an initializer in the pooled table, which must then be restored.
+  bool feeds_override_initializers_ = false;
 };
 }  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #include "core/framework/execution_provider.h"
 
+#include <algorithm>
+
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -43,12 +45,41 @@ IExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+bool IExecutionProvider::IsCapabilityIndependentOfPlacement() const { return false; }
+
 common::Status IExecutionProvider::Sync() const { return Status::OK(); };
 
 common::Status IExecutionProvider::OnRunStart() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
+bool IExecutionProvider::IsGraphCaptureEnabled() const { return false; }
+
+bool IExecutionProvider::IsGraphCaptured(const std::string& /*key*/) const { return false; }
+
+common::Status IExecutionProvider::BeginGraphCapture() {
+  return Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED, Type() + " doesn't support graph capture");
+}
+
+common::Status IExecutionProvider::EndGraphCapture(const std::string& /*key*/, bool /*keep*/) {
+  return Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED, Type() + " doesn't support graph capture");
+}
+
+common::Status IExecutionProvider::ReplayGraph(const std::string& /*key*/) {
+  return Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED, Type() + " doesn't support graph capture");
+}
+
+void IExecutionProvider::StartKernelTiming(const Node& /*node*/) const {}
+
+void IExecutionProvider::EndKernelTiming(const Node& /*node*/, const TimePoint& /*start_time*/,
+                                         profiling::Profiler& /*profiler*/) const {}
+
+common::Status IExecutionProvider::FlushKernelTimings() const { return Status::OK(); }
+
+common::Status IExecutionProvider::GetGPUResource(OrtGPUResource /*resource*/, void** /*out*/) const {
+  return Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED, Type() + " has no GPU resources");
+}
+
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtMemoryInfo& info = allocator->Info();
   const int key = MakeKey(info.id, info.mem_type);
@@ -60,6 +91,20 @@ void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   allocator_list_.emplace_back(gsl::not_null<IAllocator*>(allocator.get()));
 }
 
+bool IExecutionProvider::ReplaceAllocator(AllocatorPtr allocator) {
+  const OrtMemoryInfo& info = allocator->Info();
+  auto iter = allocators_.find(MakeKey(info.id, info.mem_type));
+  if (iter == allocators_.end() || strcmp(iter->second->Info().name, info.name) != 0) {
+    return false;
+  }
+  const IAllocator* replaced = iter->second.get();
+  auto list_iter = std::find_if(allocator_list_.begin(), allocator_list_.end(),
+                                [replaced](gsl::not_null<const IAllocator*> a) { return a.get() == replaced; });
+  *list_iter = gsl::not_null<IAllocator*>(allocator.get());
+  iter->second = std::move(allocator);
+  return true;
+}
+
 common::Status IExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& /*fused_node*/,
                                            std::vector<NodeComputeInfo>& /*node_compute_funcs*/) {
   return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
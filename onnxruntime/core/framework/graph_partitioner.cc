@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <exception>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +13,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/platform/threadpool.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -143,11 +147,54 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // TODO: when the graph contain a function node, and user pass in the dll which could
   // run the function by SessionOption, we should create a function kernel for it and
   // delegate the compute to the functions inside the dlls.
+  auto get_capability = [this, &graph_viewer](const IExecutionProvider& provider) {
+    return provider.GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider.Type()));
+  };
+
+  // The first provider, and the providers whose capability doesn't depend on the nodes placed before them, are
+  // asked for their capabilities concurrently, on the graph as it is before any placement. The other providers are
+  // asked in turn on the updated graph, e.g. CUDA looks at where the inputs of a node come from. PlaceNode skips the
+  // nodes an early answer claims that were assigned or fused in the meantime.
+  const size_t num_providers = providers_.NumProviders();
+  std::vector<std::vector<std::unique_ptr<ComputeCapability>>> early_capabilities(num_providers);
+  std::vector<bool> asked_early(num_providers, false);
+  if (thread_pool_ != nullptr) {
+    std::vector<size_t> early_providers;
+    std::vector<const IExecutionProvider*> providers;
+    for (auto& provider : providers_) {
+      if (providers.empty() || provider->IsCapabilityIndependentOfPlacement()) {
+        early_providers.push_back(providers.size());
+      }
+      providers.push_back(provider.get());
+    }
+
+    if (early_providers.size() > 1) {
+      std::vector<std::exception_ptr> exceptions(early_providers.size());
+      thread_pool_->ParallelFor(static_cast<int32_t>(early_providers.size()), [&](int32_t i) {
+        try {
+          early_capabilities[early_providers[i]] = get_capability(*providers[early_providers[i]]);
+        } catch (...) {
+          exceptions[i] = std::current_exception();
+        }
+      });
+      for (const auto& exception : exceptions) {
+        if (exception) {
+          std::rethrow_exception(exception);
+        }
+      }
+      for (auto provider_index : early_providers) {
+        asked_early[provider_index] = true;
+      }
+    }
+  }
+
+  size_t provider_index = 0;
   for (auto& provider : providers_) {
     int count = 0;
     std::vector<Node*> nodes_need_compile;
     std::vector<std::unique_ptr<ComputeCapability>> capabilities =
-        provider->GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
+        asked_early[provider_index] ? std::move(early_capabilities[provider_index]) : get_capability(*provider);
+    ++provider_index;
     for (auto& capability : capabilities) {
       Node* n = PlaceNode(graph, std::move(capability->sub_graph), kernel_registry_mgr_, provider->Type(), count);
       if (n != nullptr) {
@@ -9,6 +9,9 @@
 #include "core/framework/fuse_nodes_funcs.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 class ExecutionProviders;
 class KernelRegistryManager;
@@ -16,9 +19,12 @@ class KernelRegistryManager;
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  //If thread_pool is given, the capabilities of the providers that can be asked early are computed on it concurrently.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   concurrency::ThreadPool* thread_pool = nullptr)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {}
+        providers_(providers),
+        thread_pool_(thread_pool) {}
 
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
@@ -27,5 +33,6 @@ class GraphPartitioner {
 
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  concurrency::ThreadPool* thread_pool_;
 };
 }  // namespace onnxruntime
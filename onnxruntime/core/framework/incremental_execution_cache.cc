@@ -0,0 +1,338 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/incremental_execution_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
+
+#include "core/framework/data_transfer_manager.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+#include "core/providers/cpu/tensor/copy.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// A copy of a watched feed, on CPU.
+struct FeedSnapshot {
+  bool present = false;
+  MLDataType type = nullptr;
+  std::vector<int64_t> dims;
+  std::vector<char> bytes;
+  std::vector<std::string> strings;
+};
+
+bool IsStringTensor(const Tensor& tensor) {
+  return tensor.DataType() == DataTypeImpl::GetType<std::string>();
+}
+
+bool IsNondeterministic(const Node& node) {
+  static const std::unordered_set<std::string> nondeterministic_ops{
+      "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial"};
+  return node.Domain() == kOnnxDomain && nondeterministic_ops.count(node.OpType()) != 0;
+}
+
+Status CopyTensorValue(const OrtValue& source, const AllocatorPtr& allocator,
+                       const DataTransferManager& data_transfer_mgr, OrtValue& target) {
+  const Tensor& source_tensor = source.Get<Tensor>();
+  auto tensor = std::make_unique<Tensor>(source_tensor.DataType(), source_tensor.Shape(), allocator);
+  if (!source_tensor.IsContiguous()) {
+    // a strided view, such as the output of Slice or Expand, doesn't hold its elements in order in its buffer, and
+    // may hold fewer of them. Views are only made by CPU kernels.
+    StridedCopy(nullptr, source_tensor.DataType(), tensor->MutableDataRaw(), tensor->Strides(),
+                source_tensor.Shape().GetDims(), source_tensor.DataRaw(), source_tensor.Strides());
+  } else if (IsStringTensor(source_tensor)) {
+    const std::string* source_strings = source_tensor.Data<std::string>();
+    std::copy(source_strings, source_strings + source_tensor.Shape().Size(), tensor->MutableData<std::string>());
+  } else {
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(source_tensor, *tensor));
+  }
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  target.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return Status::OK();
+}
+
+bool SnapshotEquals(const FeedSnapshot& snapshot, const Tensor* tensor) {
+  if (tensor == nullptr) {
+    return !snapshot.present;
+  }
+  if (!snapshot.present || snapshot.type != tensor->DataType() || snapshot.dims != tensor->Shape().GetDims()) {
+    return false;
+  }
+  if (IsStringTensor(*tensor)) {
+    return std::equal(snapshot.strings.cbegin(), snapshot.strings.cend(), tensor->Data<std::string>());
+  }
+  return std::memcmp(tensor->DataRaw(), snapshot.bytes.data(), snapshot.bytes.size()) == 0;
+}
+
+FeedSnapshot TakeSnapshot(const Tensor* tensor) {
+  FeedSnapshot snapshot;
+  if (tensor != nullptr) {
+    snapshot.present = true;
+    snapshot.type = tensor->DataType();
+    snapshot.dims = tensor->Shape().GetDims();
+    if (IsStringTensor(*tensor)) {
+      const std::string* strings = tensor->Data<std::string>();
+      snapshot.strings.assign(strings, strings + tensor->Shape().Size());
+    } else {
+      const auto* data = static_cast<const char*>(tensor->DataRaw());
+      snapshot.bytes.assign(data, data + tensor->SizeInBytes());
+    }
+  }
+  return snapshot;
+}
+
+}  // namespace
+
+struct IncrementalExecutionCache::Entry {
+  // indexed like input_idxs_
+  std::vector<FeedSnapshot> feeds;
+  // indexed like frontier_values_
+  std::vector<OrtValue> values;
+};
+
+Status IncrementalExecutionCache::Create(const GraphViewer& graph_viewer,
+                                         const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                         const SequentialExecutionPlan& exec_plan,
+                                         const std::unordered_map<int, OrtValue>& initializers,
+                                         const std::vector<std::string>& input_names,
+                                         std::unique_ptr<IncrementalExecutionCache>& cache) {
+  std::unique_ptr<IncrementalExecutionCache> new_cache(new IncrementalExecutionCache());
+  const size_t num_values = exec_plan.allocation_plan.size();
+  const size_t num_nodes = graph_viewer.MaxNodeIndex();
+
+  std::vector<bool> inputs_and_initializers(num_values, false);
+  for (const auto& name : input_names) {
+    const auto& graph_inputs = graph_viewer.GetInputs();
+    if (std::none_of(graph_inputs.cbegin(), graph_inputs.cend(),
+                     [&name](const NodeArg* input) { return input->Name() == name; })) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Incremental execution input '", name,
+                             "' is not an input of the graph.");
+    }
+    int idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(name, idx));
+    new_cache->input_idxs_.push_back(idx);
+    inputs_and_initializers[idx] = true;
+  }
+  for (const auto& initializer : initializers) {
+    inputs_and_initializers[initializer.first] = true;
+  }
+
+  std::vector<int> graph_output_idxs;
+  for (const auto* output : graph_viewer.GetOutputs()) {
+    int idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(output->Name(), idx));
+    graph_output_idxs.push_back(idx);
+  }
+
+  // Calls fn with the ort value index of each input of the node, implicit ones included.
+  auto for_each_input = [&ort_value_name_idx_map](const Node& node, const std::function<void(int)>& fn) -> Status {
+    auto visit = [&](const NodeArg& def, size_t) -> Status {
+      int idx;
+      ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(def.Name(), idx));
+      fn(idx);
+      return Status::OK();
+    };
+    ORT_RETURN_IF_ERROR(Node::ForEachWithIndex(node.InputDefs(), visit));
+    return Node::ForEachWithIndex(node.ImplicitInputDefs(), visit);
+  };
+
+  // The nodes whose outputs the memoization can't handle are excluded, until the memoized part is stable.
+  std::vector<bool> excluded_nodes(num_nodes, false);
+  std::vector<NodeIndex> producers(num_values, 0);
+  std::vector<bool> memoized_values;
+  std::vector<bool> frontier;
+  bool stable = false;
+  while (!stable) {
+    new_cache->memoized_nodes_.assign(num_nodes, false);
+    memoized_values.assign(num_values, false);
+    for (const auto& node_plan : exec_plan.execution_plan) {
+      const Node& node = *graph_viewer.GetNode(node_plan.node_index);
+      // the subgraphs of control flow nodes aren't inspected for nondeterministic nodes
+      bool memoize = !excluded_nodes[node.Index()] && !IsNondeterministic(node) && !node.ContainsSubgraph();
+      ORT_RETURN_IF_ERROR(for_each_input(node, [&](int idx) {
+        memoize = memoize && (inputs_and_initializers[idx] || memoized_values[idx]);
+      }));
+      if (!memoize) {
+        continue;
+      }
+      new_cache->memoized_nodes_[node.Index()] = true;
+      ORT_RETURN_IF_ERROR(Node::ForEachWithIndex(node.OutputDefs(), [&](const NodeArg& def, size_t) -> Status {
+        int idx;
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(def.Name(), idx));
+        memoized_values[idx] = true;
+        producers[idx] = node.Index();
+        return Status::OK();
+      }));
+    }
+
+    // the frontier is the memoized values read by the other nodes, and the memoized graph outputs
+    frontier.assign(num_values, false);
+    for (const auto& node_plan : exec_plan.execution_plan) {
+      if (!new_cache->memoized_nodes_[node_plan.node_index]) {
+        ORT_RETURN_IF_ERROR(for_each_input(*graph_viewer.GetNode(node_plan.node_index), [&](int idx) {
+          frontier[idx] = frontier[idx] || memoized_values[idx];
+        }));
+      }
+    }
+    for (int idx : graph_output_idxs) {
+      frontier[idx] = frontier[idx] || memoized_values[idx];
+    }
+
+    // Only tensors are memoized. The values of the other nodes can't reuse the buffer of a memoized value that isn't
+    // in the frontier, since runs that skip the memoized nodes don't allocate it.
+    stable = true;
+    for (size_t idx = 0; idx < num_values; ++idx) {
+      const auto& value_plan = exec_plan.allocation_plan[idx];
+      if (frontier[idx] && (value_plan.value_type == nullptr || !value_plan.value_type->IsTensorType())) {
+        excluded_nodes[producers[idx]] = true;
+        stable = false;
+      }
+      const int reused = value_plan.reused_buffer;
+      if (!memoized_values[idx] &&
+          (value_plan.alloc_kind == AllocKind::kReuse || value_plan.alloc_kind == AllocKind::kShare) &&
+          memoized_values[reused] && !frontier[reused]) {
+        excluded_nodes[producers[reused]] = true;
+        stable = false;
+      }
+    }
+  }
+
+  new_cache->num_memoized_nodes_ = static_cast<size_t>(
+      std::count(new_cache->memoized_nodes_.cbegin(), new_cache->memoized_nodes_.cend(), true));
+  new_cache->node_frontier_values_.resize(num_nodes);
+  for (size_t idx = 0; idx < num_values; ++idx) {
+    if (!frontier[idx]) {
+      continue;
+    }
+
+    // the runs may write into a frontier value if it's a graph output, or if another value reuses or views its buffer
+    bool copy = std::find(graph_output_idxs.cbegin(), graph_output_idxs.cend(), static_cast<int>(idx)) !=
+                graph_output_idxs.cend();
+    for (const auto& value_plan : exec_plan.allocation_plan) {
+      copy = copy ||
+             ((value_plan.alloc_kind == AllocKind::kReuse || value_plan.alloc_kind == AllocKind::kShare) &&
+              value_plan.reused_buffer == static_cast<OrtValueIndex>(idx)) ||
+             value_plan.view_of == static_cast<OrtValueIndex>(idx);
+    }
+
+    new_cache->node_frontier_values_[producers[idx]].push_back(new_cache->frontier_values_.size());
+    new_cache->frontier_values_.push_back(static_cast<OrtValueIndex>(idx));
+    new_cache->copy_frontier_values_.push_back(copy);
+  }
+
+  cache = std::move(new_cache);
+  return Status::OK();
+}
+
+Status IncrementalExecutionCache::BeginRun(const std::vector<int>& feed_mlvalue_idxs,
+                                           const std::vector<OrtValue>& feeds, bool has_preallocated_fetches,
+                                           const ExecutionProviders& execution_providers,
+                                           const DataTransferManager& data_transfer_mgr, RunState& run) const {
+  run.hit = nullptr;
+  run.miss = nullptr;
+  if (has_preallocated_fetches || num_memoized_nodes_ == 0) {
+    return Status::OK();
+  }
+
+  // the watched feeds, copied to CPU if they're on a device
+  std::vector<const Tensor*> tensors(input_idxs_.size(), nullptr);
+  std::vector<OrtValue> cpu_copies(input_idxs_.size());
+  for (size_t i = 0; i < input_idxs_.size(); ++i) {
+    auto it = std::find(feed_mlvalue_idxs.cbegin(), feed_mlvalue_idxs.cend(), input_idxs_[i]);
+    if (it == feed_mlvalue_idxs.cend()) {
+      continue;
+    }
+    const OrtValue& feed = feeds[it - feed_mlvalue_idxs.cbegin()];
+    if (!feed.IsTensor()) {
+      // other values can't be compared, so the run neither uses nor memoizes the values
+      return Status::OK();
+    }
+    if (feed.Get<Tensor>().Location().device.Type() == OrtDevice::CPU) {
+      tensors[i] = &feed.Get<Tensor>();
+    } else {
+      auto cpu_allocator = execution_providers.Get(kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+      ORT_RETURN_IF_ERROR(CopyTensorValue(feed, cpu_allocator, data_transfer_mgr, cpu_copies[i]));
+      tensors[i] = &cpu_copies[i].Get<Tensor>();
+    }
+  }
+
+  std::shared_ptr<const Entry> entry;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    entry = entry_;
+  }
+
+  bool hit = entry != nullptr;
+  for (size_t i = 0; hit && i < input_idxs_.size(); ++i) {
+    hit = SnapshotEquals(entry->feeds[i], tensors[i]);
+  }
+  if (hit) {
+    run.hit = std::move(entry);
+    return Status::OK();
+  }
+
+  run.miss = std::make_shared<Entry>();
+  for (const Tensor* tensor : tensors) {
+    run.miss->feeds.push_back(TakeSnapshot(tensor));
+  }
+  run.miss->values.resize(frontier_values_.size());
+  return Status::OK();
+}
+
+Status IncrementalExecutionCache::RestoreValues(const RunState& run, const DataTransferManager& data_transfer_mgr,
+                                                ExecutionFrame& frame) const {
+  if (run.hit == nullptr) {
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < frontier_values_.size(); ++i) {
+    const OrtValue& value = run.hit->values[i];
+    if (!value.IsAllocated()) {
+      continue;
+    }
+    if (copy_frontier_values_[i]) {
+      OrtValue copy;
+      ORT_RETURN_IF_ERROR(CopyTensorValue(value, frame.GetAllocator(value.Get<Tensor>().Location()),
+                                          data_transfer_mgr, copy));
+      frame.SetValue(frontier_values_[i], copy);
+    } else {
+      frame.SetValue(frontier_values_[i], value);
+    }
+  }
+  return Status::OK();
+}
+
+Status IncrementalExecutionCache::RecordNode(NodeIndex node_index, const DataTransferManager& data_transfer_mgr,
+                                             const ExecutionFrame& frame, RunState& run) const {
+  if (run.miss == nullptr) {
+    return Status::OK();
+  }
+
+  // the buffers of the values are reused by the run or freed at its end, so they're copied
+  for (size_t i : node_frontier_values_[node_index]) {
+    const OrtValue& value = frame.GetValue(frontier_values_[i]);
+    if (value.IsAllocated()) {
+      ORT_RETURN_IF_ERROR(CopyTensorValue(value, frame.GetAllocator(value.Get<Tensor>().Location()),
+                                          data_transfer_mgr, run.miss->values[i]));
+    }
+  }
+  return Status::OK();
+}
+
+void IncrementalExecutionCache::EndRun(RunState& run) {
+  if (run.miss != nullptr) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    entry_ = std::move(run.miss);
+  }
+  run.hit = nullptr;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class DataTransferManager;
+class ExecutionFrame;
+class ExecutionProviders;
+class GraphViewer;
+class OrtValueNameIdxMap;
+
+// Memoizes the part of a graph that only depends on some of its inputs, such as an encoder whose outputs are fed to
+// every step of a decoder, so that the runs in which these inputs hold the same values as in the previous run reuse
+// its results instead of computing it again.
+//
+// The memoized nodes are those whose inputs are all watched inputs, initializers or outputs of memoized nodes, apart
+// from the nodes that aren't deterministic, like RandomNormal. Only the outputs of the memoized nodes that are read
+// by the other nodes or are graph outputs are kept: the frontier of the memoized part. A run compares the watched
+// feeds with those of the run that memoized the frontier. If they're equal, it skips the memoized nodes and starts
+// with the memoized frontier. Otherwise it runs all the nodes and memoizes its frontier in place of the previous one.
+//
+// Runs may use and replace the memoized values concurrently. The memoized values of a run are immutable, and shared
+// with the runs that use them, so replacing them doesn't affect a run still using the previous ones.
+class IncrementalExecutionCache final {
+ public:
+  // The values a run memoized: its watched feeds and the frontier of the memoized nodes.
+  struct Entry;
+
+  // The memoization state of a run.
+  struct RunState {
+    // the memoized values the run starts with, if its watched feeds are the same as in the run that memoized them
+    std::shared_ptr<const Entry> hit;
+    // otherwise, the values the run memoizes, or nullptr if it can't memoize them
+    std::shared_ptr<Entry> miss;
+
+    bool SkipsNode(NodeIndex node_index, const IncrementalExecutionCache& cache) const {
+      return hit != nullptr && cache.memoized_nodes_[node_index];
+    }
+  };
+
+  // Memoizes the nodes that only depend on the inputs named input_names and on the initializers, in the order of
+  // exec_plan. Fails if a name isn't an input of the graph.
+  static Status Create(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                       const SequentialExecutionPlan& exec_plan,
+                       const std::unordered_map<int, OrtValue>& initializers,
+                       const std::vector<std::string>& input_names,
+                       std::unique_ptr<IncrementalExecutionCache>& cache);
+
+  // Compares the watched feeds of a run with the memoized ones. Runs that write their outputs to pre-allocated
+  // fetches neither use nor memoize the values, since the memoized outputs wouldn't be written there.
+  Status BeginRun(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                  bool has_preallocated_fetches, const ExecutionProviders& execution_providers,
+                  const DataTransferManager& data_transfer_mgr, RunState& run) const;
+
+  // Puts the memoized frontier in the frame of a run that hit the cache. The values that the plan lets other values
+  // reuse or view the buffer of, or that are graph outputs, are copied so that the run can't overwrite them.
+  Status RestoreValues(const RunState& run, const DataTransferManager& data_transfer_mgr, ExecutionFrame& frame) const;
+
+  // Memoizes the frontier values a node computed in a run that missed the cache. Called after the node runs, before
+  // its values are released.
+  Status RecordNode(NodeIndex node_index, const DataTransferManager& data_transfer_mgr, const ExecutionFrame& frame,
+                    RunState& run) const;
+
+  // Replaces the memoized values with those of a run that missed the cache and completed.
+  void EndRun(RunState& run);
+
+  size_t NumMemoizedNodes() const { return num_memoized_nodes_; }
+  const std::vector<OrtValueIndex>& FrontierValues() const { return frontier_values_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IncrementalExecutionCache);
+
+  IncrementalExecutionCache() = default;
+
+  // the ort value indices of the watched inputs
+  std::vector<OrtValueIndex> input_idxs_;
+
+  // indexed by NodeIndex
+  std::vector<bool> memoized_nodes_;
+  size_t num_memoized_nodes_ = 0;
+
+  std::vector<OrtValueIndex> frontier_values_;
+  // for each frontier value, whether a run gets a copy of it instead of the memoized value
+  std::vector<bool> copy_frontier_values_;
+  // for each node, the positions in frontier_values_ of its outputs, indexed by NodeIndex
+  std::vector<std::vector<size_t>> node_frontier_values_;
+
+  mutable OrtMutex mutex_;
+  std::shared_ptr<const Entry> entry_;
+};
+
+}  // namespace onnxruntime
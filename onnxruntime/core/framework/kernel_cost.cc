@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_cost.h"
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+
+namespace onnxruntime {
+
+static const Tensor* InputTensor(const OpKernelContextInternal& context, int index) {
+  if (index >= context.InputCount()) return nullptr;
+  const OrtValue* value = context.GetInputMLValue(index);
+  return value != nullptr && value->IsAllocated() && value->IsTensor() ? &value->Get<Tensor>() : nullptr;
+}
+
+static const Tensor* OutputTensor(OpKernelContextInternal& context, int index) {
+  if (index >= context.OutputCount()) return nullptr;
+  const OrtValue* value = context.GetOutputMLValue(index);
+  return value != nullptr && value->IsAllocated() && value->IsTensor() ? &value->Get<Tensor>() : nullptr;
+}
+
+// The multiply-adds per element of the output of a convolution with weight, or per element of the input of a
+// transposed convolution: the size of the filter of one output channel, or of one input channel respectively.
+static int64_t FilterSize(const Tensor* weight) {
+  if (weight == nullptr || weight->Shape().NumDimensions() == 0 || weight->Shape()[0] == 0) return 0;
+  return weight->Shape().Size() / weight->Shape()[0];
+}
+
+KernelCost EstimateKernelCost(const OpKernel& kernel, OpKernelContextInternal& context) {
+  KernelCost cost{0, 0};
+  for (int i = 0, end = context.InputCount(); i < end; ++i) {
+    const Tensor* input = InputTensor(context, i);
+    if (input != nullptr) cost.bytes += static_cast<int64_t>(input->SizeInBytes());
+  }
+  int64_t output_elements = 0;
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const Tensor* output = OutputTensor(context, i);
+    if (output != nullptr) {
+      cost.bytes += static_cast<int64_t>(output->SizeInBytes());
+      output_elements += output->Shape().Size();
+    }
+  }
+
+  const std::string& op_type = kernel.Node().OpType();
+  const Tensor* a = InputTensor(context, 0);
+  const Tensor* y = OutputTensor(context, 0);
+  if (a == nullptr || y == nullptr) {
+    cost.flops = output_elements;
+  } else if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul") {
+    const auto& a_shape = a->Shape();
+    const int64_t k = a_shape.NumDimensions() == 0 ? 1 : a_shape[a_shape.NumDimensions() - 1];
+    cost.flops = 2 * y->Shape().Size() * k;
+  } else if (op_type == "Gemm" || op_type == "FusedGemm") {
+    // A is M x K or K x M, and Y is M x N
+    const int64_t m = y->Shape().NumDimensions() == 2 ? y->Shape()[0] : 0;
+    const int64_t k = m == 0 ? 0 : a->Shape().Size() / m;
+    cost.flops = 2 * y->Shape().Size() * k + y->Shape().Size();
+  } else if (op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvInteger") {
+    cost.flops = 2 * y->Shape().Size() * FilterSize(InputTensor(context, 1));
+  } else if (op_type == "QLinearConv") {
+    cost.flops = 2 * y->Shape().Size() * FilterSize(InputTensor(context, 3));
+  } else if (op_type == "ConvTranspose") {
+    cost.flops = 2 * a->Shape().Size() * FilterSize(InputTensor(context, 1));
+  } else {
+    cost.flops = output_elements;
+  }
+
+  return cost;
+}
+
+}  // namespace onnxruntime
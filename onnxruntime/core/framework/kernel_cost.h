@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace onnxruntime {
+class OpKernel;
+class OpKernelContextInternal;
+
+// A static estimate of the work of a kernel computation, for comparing the rates a kernel achieves with what the
+// hardware can do.
+struct KernelCost {
+  // Floating point (or integer) operations, counting a multiply-add as 2. The matrix multiplications and
+  // convolutions are estimated from their shapes, other ops as one operation per output element.
+  int64_t flops;
+  // Bytes of the input and output tensors, each read or written once.
+  int64_t bytes;
+};
+
+// Estimate the cost of a computation of kernel with context, once it's done and the outputs have their shapes.
+KernelCost EstimateKernelCost(const OpKernel& kernel, OpKernelContextInternal& context);
+
+}  // namespace onnxruntime
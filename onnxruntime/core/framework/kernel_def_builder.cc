@@ -156,4 +156,19 @@ KernelDefBuilder& KernelDefBuilder::Alias(int input_index, int output_index) {
   return *this;
 }
 
+KernelDefBuilder& KernelDefBuilder::MayStridedOutput(int input_index, int output_index) {
+  kernel_def_->strided_output_map_.emplace_back(input_index, output_index);
+  return *this;
+}
+
+KernelDefBuilder& KernelDefBuilder::MayStridedInput(int input_index) {
+  kernel_def_->strided_inputs_.push_back(input_index);
+  return *this;
+}
+
+KernelDefBuilder& KernelDefBuilder::MayStridedInputs() {
+  kernel_def_->all_inputs_may_be_strided_ = true;
+  return *this;
+}
+
 }  // namespace onnxruntime
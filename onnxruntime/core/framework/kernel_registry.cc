@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include "core/framework/kernel_registry.h"
 #include "core/framework/session_state.h"
@@ -111,6 +113,55 @@ class TypeBindingResolver {
   const Node& node_;
   std::unique_ptr<TypeBindingMap> type_binding_map_;
 };
+
+// Ideal case is, if schema is Since(5), current opset version is opset 7,
+// kernel_def Since(8)     Invalid
+// kernel_def Since(6)     Valid
+// kernel_def Since(5)     Valid
+// kernel_def Since(4)     Invalid
+// kernel_def Since(4, 6)  Valid
+
+// Right now there is no "until version" on schema, it is difficult to get opset version here.(require a lot of interface change.)
+// As a trade off, we will temporary require kernel definition to have the same since version as schema definition.
+// so kernel_def Since(6) will become invalid now.
+// After ONNX add "until version" on the schema object, we will update this place
+bool IsVersionSupported(int node_since_version, int kernel_start_version, int kernel_end_version) {
+  return kernel_start_version == node_since_version  // the idea case this branch should be kernel_start_version >= node_version && kernel_start_version <= until_version
+         || (kernel_start_version < node_since_version && kernel_end_version != INT_MAX && kernel_end_version >= node_since_version);
+}
+
+// Returns the type of the first present actual argument of a formal parameter of the node's op schema, given as an
+// index into the schema inputs followed by the schema outputs, or nullptr if there is none. This visits the
+// arguments in the same way as TraverseFormalParametersWithTypeProto.
+const ONNX_NAMESPACE::TypeProto* FirstActualType(const Node& node, size_t formal_param) {
+  const ONNX_NAMESPACE::OpSchema& op_schema = *node.Op();
+  const size_t num_formal_inputs = op_schema.inputs().size();
+  if (formal_param < num_formal_inputs) {
+    const auto& input_arg_count = node.InputArgCount();
+    if (formal_param >= input_arg_count.size()) return nullptr;
+    int actual_index = 0;
+    for (size_t i = 0; i != formal_param; ++i) {
+      actual_index += input_arg_count[i];
+    }
+    for (int i = 0, end = input_arg_count[formal_param]; i < end; ++i) {
+      const NodeArg* arg = node.InputDefs()[actual_index + i];
+      if (arg->Exists()) return arg->TypeAsProto();
+    }
+    return nullptr;
+  }
+
+  // the last formal output takes the remaining actual outputs if it is variadic
+  const size_t formal_output = formal_param - num_formal_inputs;
+  auto actual_outputs = node.OutputDefs();
+  const size_t last_formal = op_schema.outputs().size() - 1;
+  const size_t end = formal_output == last_formal ? actual_outputs.size()
+                                                  : std::min(formal_output + 1, actual_outputs.size());
+  for (size_t i = formal_output; i < end; ++i) {
+    const NodeArg* arg = actual_outputs[i];
+    if (arg->Exists()) return arg->TypeAsProto();
+  }
+  return nullptr;
+}
 };  // namespace
 
 bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
@@ -147,19 +198,7 @@ bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
   kernel_def.SinceVersion(&kernel_start_version, &kernel_end_version);
 
   int node_since_version = node.Op()->since_version();
-  // Ideal case is, if schema is Since(5), current opset version is opset 7,
-  // kernel_def Since(8)     Invalid
-  // kernel_def Since(6)     Valid
-  // kernel_def Since(5)     Valid
-  // kernel_def Since(4)     Invalid
-  // kernel_def Since(4, 6)  Valid
-
-  // Right now there is no "until version" on schema, it is difficult to get opset version here.(require a lot of interface change.)
-  // As a trade off, we will temporary require kernel definition to have the same since version as schema definition.
-  // so kernel_def Since(6) will become invalid now.
-  // After ONNX add "until version" on the schema object, we will update this place
-  bool valid_version = kernel_start_version == node_since_version  // the idea case this branch should be kernel_start_version >= node_version && kernel_start_version <= until_version
-                       || (kernel_start_version < node_since_version && kernel_end_version != INT_MAX && kernel_end_version >= node_since_version);
+  bool valid_version = IsVersionSupported(node_since_version, kernel_start_version, kernel_end_version);
   if (!valid_version) {
     std::ostringstream ostr;
     ostr << "Op: " << node.OpType()
@@ -229,17 +268,96 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
                      ": Conflicting with a registered kernel with op versions.");
       // For invalid entries, we keep them in the map now. Must check for status
       // when using the entries from the map.
-      kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+      AddToIndex(kernel_creator_fn_map_.emplace(op_name, std::move(create_info))->second);
       return st;
     }
   }
 
   // Register the kernel.
   // Ownership of the KernelDef is transferred to the map.
-  kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+  AddToIndex(kernel_creator_fn_map_.emplace(op_name, std::move(create_info))->second);
   return Status::OK();
 }
 
+size_t KernelRegistry::IndexKey(const std::string& op_type, const std::string& domain, const std::string& provider) {
+  std::hash<std::string> hash;
+  size_t key = hash(op_type);
+  key ^= hash(domain) + 0x9e3779b9 + (key << 6) + (key >> 2);
+  key ^= hash(provider) + 0x9e3779b9 + (key << 6) + (key >> 2);
+  return key;
+}
+
+void KernelRegistry::AddToIndex(const KernelCreateInfo& create_info) {
+  const KernelDef& kernel_def = *create_info.kernel_def;
+  IndexedKernel indexed_kernel;
+  indexed_kernel.create_info = &create_info;
+  kernel_def.SinceVersion(&indexed_kernel.start_version, &indexed_kernel.end_version);
+  kernel_index_[IndexKey(kernel_def.OpName(), kernel_def.Domain(), kernel_def.Provider())].push_back(
+      std::move(indexed_kernel));
+}
+
+bool KernelRegistry::VerifyTypeConstraints(const onnxruntime::Node& node, IndexedKernel& indexed_kernel) const {
+  const ONNX_NAMESPACE::OpSchema* op_schema = node.Op();
+  const ResolvedTypeConstraints* resolved_type_constraints = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(resolved_type_constraints_mutex_);
+    auto it = indexed_kernel.resolved_type_constraints.find(op_schema);
+    if (it != indexed_kernel.resolved_type_constraints.end()) {
+      resolved_type_constraints = &it->second;
+    }
+  }
+
+  ResolvedTypeConstraints uncached_type_constraints;
+  if (resolved_type_constraints == nullptr) {
+    // match the constraint names against the names and type strings of the formal parameters once per schema
+    const size_t num_formal_inputs = op_schema->inputs().size();
+    for (auto& constraint : indexed_kernel.create_info->kernel_def->TypeConstraints()) {
+      ResolvedTypeConstraint resolved{&constraint.second, {}};
+      auto matches = [&constraint](const ONNX_NAMESPACE::OpSchema::FormalParameter& param) {
+        return param.GetName() == constraint.first || param.GetTypeStr() == constraint.first;
+      };
+      for (size_t i = 0; i != num_formal_inputs; ++i) {
+        if (matches(op_schema->inputs()[i])) resolved.formal_params.push_back(i);
+      }
+      for (size_t i = 0; i != op_schema->outputs().size(); ++i) {
+        if (matches(op_schema->outputs()[i])) resolved.formal_params.push_back(num_formal_inputs + i);
+      }
+      uncached_type_constraints.push_back(std::move(resolved));
+    }
+
+    // The schemas of the static ONNX registry live as long as the process, but a schema of a custom registry is freed
+    // with its session and another may later be allocated at its address, so only the former are cached.
+    if (ONNX_NAMESPACE::OpSchemaRegistry::Schema(node.OpType(), op_schema->since_version(), node.Domain()) ==
+        op_schema) {
+      std::lock_guard<OrtMutex> lock(resolved_type_constraints_mutex_);
+      resolved_type_constraints =
+          &indexed_kernel.resolved_type_constraints.emplace(op_schema, std::move(uncached_type_constraints))
+               .first->second;
+    } else {
+      resolved_type_constraints = &uncached_type_constraints;
+    }
+  }
+
+  for (const auto& constraint : *resolved_type_constraints) {
+    // the type of the first present argument of the constraint, as TypeBindingResolver resolves it
+    const ONNX_NAMESPACE::TypeProto* actual_type = nullptr;
+    for (size_t formal_param : constraint.formal_params) {
+      actual_type = FirstActualType(node, formal_param);
+      if (actual_type != nullptr) break;
+    }
+
+    // a type constraint on a missing optional parameter is skipped
+    if (actual_type != nullptr &&
+        !std::any_of(constraint.allowed_types->begin(), constraint.allowed_types->end(),
+                     [actual_type](const DataTypeImpl* expected_type) {
+                       return expected_type->IsCompatible(*actual_type);
+                     })) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Status KernelRegistry::TryCreateKernel(const onnxruntime::Node& node,
                                        const IExecutionProvider& execution_provider,
                                        const std::unordered_map<int, OrtValue>& constant_initialized_tensors,
@@ -277,25 +395,46 @@ static std::string ToString(const std::vector<std::string>& error_strs) {
 // In this case, the kernel's provider must equal to exec_provider
 // otherwise, kernel_def.provider must equal to node.provider. exec_provider is ignored.
 const KernelCreateInfo* KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
-                                                      onnxruntime::ProviderType exec_provider) const {
-  auto range = kernel_creator_fn_map_.equal_range(node.OpType());
-  std::vector<std::string> error_strs;
-  for (auto i = range.first; i != range.second; ++i) {
-    if (!i->second.status.IsOK()) {
-      LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
-                          << " since it was ill-formed during registration";
-      continue;
+                                                      const onnxruntime::ProviderType& exec_provider) const {
+  const auto& node_provider = node.GetExecutionProviderType();
+  const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
+  auto index_it = kernel_index_.find(IndexKey(node.OpType(), node.Domain(), expected_provider));
+  if (index_it != kernel_index_.end()) {
+    const int node_since_version = node.Op()->since_version();
+    for (auto& indexed_kernel : index_it->second) {
+      const KernelCreateInfo& create_info = *indexed_kernel.create_info;
+      const KernelDef& kernel_def = *create_info.kernel_def;
+      // skip the kernels of other keys with the same hash
+      if (kernel_def.OpName() != node.OpType() || kernel_def.Domain() != node.Domain() ||
+          kernel_def.Provider() != expected_provider) {
+        continue;
+      }
+      if (!create_info.status.IsOK()) {
+        LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
+                            << " since it was ill-formed during registration";
+        continue;
+      }
+      if (IsVersionSupported(node_since_version, indexed_kernel.start_version, indexed_kernel.end_version) &&
+          VerifyTypeConstraints(node, indexed_kernel)) {
+        return &create_info;
+      }
     }
-    std::string error_str;
-    if (VerifyKernelDef(node, *i->second.kernel_def, error_str, exec_provider)) {
-      return &i->second;
+  }
+
+  // No kernel matched, which is expected for most providers. Only describe why when it would be logged.
+  if (logging::LoggingManager::DefaultLogger().OutputIsEnabled(logging::Severity::kINFO,
+                                                               logging::DataType::SYSTEM)) {
+    auto range = kernel_creator_fn_map_.equal_range(node.OpType());
+    std::vector<std::string> error_strs;
+    for (auto i = range.first; i != range.second; ++i) {
+      if (!i->second.status.IsOK()) continue;
+      std::string error_str;
+      VerifyKernelDef(node, *i->second.kernel_def, error_str, exec_provider);
+      error_strs.push_back(error_str);
     }
-    error_strs.push_back(error_str);
+    LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
+                       << " Encountered following errors: " << ToString(error_strs);
   }
-  std::string expected_provider =
-      (node.GetExecutionProviderType().empty() ? exec_provider : node.GetExecutionProviderType());
-  LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
-                     << " Encountered following errors: " << ToString(error_strs);
   return nullptr;
 }
 
@@ -12,10 +12,23 @@ Memcpy::Memcpy(const OpKernelInfo& info)
 }
 
 Status Memcpy::Compute(OpKernelContext* ctx) const {
-  const auto* X = ctx->Input<Tensor>(0);
-  Tensor* Y = ctx->Output(0, X->Shape());
-  Status retval = Info().GetDataTransferManager().CopyTensor(*X, *Y, Info().GetKernelDef().ExecQueueId());
-  return retval;
+  const int exec_queue_id = Info().GetKernelDef().ExecQueueId();
+  const int num_inputs = ctx->InputCount();
+  if (num_inputs == 1) {
+    const auto* X = ctx->Input<Tensor>(0);
+    Tensor* Y = ctx->Output(0, X->Shape());
+    return Info().GetDataTransferManager().CopyTensor(*X, *Y, exec_queue_id);
+  }
+
+  // the tensors crossing the device boundary at the same point are copied in one batch
+  std::vector<IDataTransfer::SrcDstPair> src_dst_pairs;
+  src_dst_pairs.reserve(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    const auto* X = ctx->Input<Tensor>(i);
+    Tensor* Y = ctx->Output(i, X->Shape());
+    src_dst_pairs.push_back({*X, *Y, exec_queue_id});
+  }
+  return Info().GetDataTransferManager().CopyTensors(src_dst_pairs);
 }
 
 }  // namespace onnxruntime
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_profiler.h"
+
+#include <algorithm>
+
+#include "core/framework/bfc_arena.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+static int64_t ArenaAllocatedBytes(BFCArena& arena) {
+  AllocatorStats stats;
+  arena.GetStats(&stats);
+  return stats.total_allocated_bytes;
+}
+
+MemoryProfiler::MemoryProfiler(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                               std::vector<std::shared_ptr<BFCArena>> arenas, profiling::Profiler& profiler)
+    : tensor_names_(ort_value_name_idx_map.MaxIdx() + 1),
+      producer_names_(ort_value_name_idx_map.MaxIdx() + 1),
+      arenas_(std::move(arenas)),
+      profiler_(profiler) {
+  for (const auto& entry : ort_value_name_idx_map) {
+    tensor_names_[entry.second] = entry.first;
+  }
+
+  for (const auto& node : graph_viewer.Nodes()) {
+    for (const auto* output_def : node.OutputDefs()) {
+      int ort_value_idx;
+      if (output_def->Exists() && ort_value_name_idx_map.GetIdx(output_def->Name(), ort_value_idx).IsOK()) {
+        producer_names_[ort_value_idx] = node.Name();
+      }
+    }
+  }
+}
+
+MemoryProfiler::PeakSummary MemoryProfiler::GetPeakSummary() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return summary_;
+}
+
+void MemoryProfiler::Reset() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  summary_ = PeakSummary();
+}
+
+void MemoryProfiler::AddRun(const Run& run) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  summary_.arena_extensions += run.arena_extensions_;
+  summary_.arena_extension_bytes += run.arena_extension_bytes_;
+  if (run.peak_bytes_ <= summary_.peak_bytes) {
+    return;
+  }
+
+  summary_.peak_bytes = run.peak_bytes_;
+  summary_.tensors.clear();
+  for (const auto& entry : run.live_bytes_at_peak_) {
+    summary_.tensors.push_back({tensor_names_[entry.first], producer_names_[entry.first], entry.second});
+  }
+  std::sort(summary_.tensors.begin(), summary_.tensors.end(), [](const TensorBytes& a, const TensorBytes& b) {
+    return a.bytes != b.bytes ? a.bytes > b.bytes : a.tensor_name < b.tensor_name;
+  });
+}
+
+MemoryProfiler::Run::Run(MemoryProfiler& memory_profiler) : memory_profiler_{memory_profiler} {
+  arena_bytes_.reserve(memory_profiler_.arenas_.size());
+  for (const auto& arena : memory_profiler_.arenas_) {
+    arena_bytes_.push_back(ArenaAllocatedBytes(*arena));
+  }
+}
+
+MemoryProfiler::Run::~Run() {
+  if (memory_profiler_.profiler_.IsEnabled() && peak_bytes_ > 0) {
+    RecordEvent("peak", "", peak_bytes_);
+  }
+  memory_profiler_.AddRun(*this);
+}
+
+void MemoryProfiler::Run::RecordAllocation(int ort_value_idx, int64_t bytes) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  const std::string& tensor_name = memory_profiler_.tensor_names_[ort_value_idx];
+  CheckArenasLocked(tensor_name);
+
+  live_bytes_[ort_value_idx] = bytes;
+  bytes_in_use_ += bytes;
+  if (bytes_in_use_ > peak_bytes_) {
+    peak_bytes_ = bytes_in_use_;
+    live_bytes_at_peak_ = live_bytes_;
+  }
+  RecordEvent("allocate", tensor_name, bytes);
+}
+
+void MemoryProfiler::Run::RecordReuse(int ort_value_idx, int reused_ort_value_idx) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  RecordEvent("reuse", memory_profiler_.tensor_names_[ort_value_idx], 0,
+              memory_profiler_.tensor_names_[reused_ort_value_idx]);
+}
+
+void MemoryProfiler::Run::RecordRelease(int ort_value_idx) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto entry = live_bytes_.find(ort_value_idx);
+  if (entry == live_bytes_.end()) {
+    return;
+  }
+
+  bytes_in_use_ -= entry->second;
+  RecordEvent("free", memory_profiler_.tensor_names_[ort_value_idx], -entry->second);
+  live_bytes_.erase(entry);
+}
+
+void MemoryProfiler::Run::CheckArenas(const char* reason) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  CheckArenasLocked(reason);
+}
+
+void MemoryProfiler::Run::CheckArenasLocked(const std::string& reason) {
+  // concurrent runs extend the same arenas, so an extension may be attributed to an allocation of another run
+  for (size_t i = 0, end = arena_bytes_.size(); i < end; ++i) {
+    const int64_t allocated_bytes = ArenaAllocatedBytes(*memory_profiler_.arenas_[i]);
+    if (allocated_bytes > arena_bytes_[i]) {
+      ++arena_extensions_;
+      arena_extension_bytes_ += allocated_bytes - arena_bytes_[i];
+      RecordEvent("arena_extend", reason, allocated_bytes - arena_bytes_[i]);
+    }
+    arena_bytes_[i] = allocated_bytes;
+  }
+}
+
+void MemoryProfiler::Run::RecordEvent(const char* kind, const std::string& tensor_name, int64_t bytes,
+                                      const std::string& buffer_of) {
+  auto& profiler = memory_profiler_.profiler_;
+  if (!profiler.IsEnabled()) {
+    return;
+  }
+
+  TimePoint now = profiler.StartTime();
+  profiler.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, tensor_name.empty() ? kind : tensor_name, now,
+                                 {{"kind", kind},
+                                  {"bytes", std::to_string(bytes)},
+                                  {"bytes_in_use", std::to_string(bytes_in_use_)},
+                                  {"buffer_of", buffer_of}});
+}
+
+}  // namespace onnxruntime
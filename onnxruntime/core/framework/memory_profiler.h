@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/profiler.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class BFCArena;
+class GraphViewer;
+class OrtValueNameIdxMap;
+
+// Records the memory used by the tensors of the runs of a session, to find out which nodes and tensors drive its
+// peak memory. Each run counts the bytes of the tensors that own their buffer from their allocation to their release;
+// tensors that reuse the buffer of another tensor, in place or as a view, add no bytes. The arenas the session
+// allocates from are watched for extensions, which are attributed to the allocation that caused them.
+//
+// If the session's profiler is enabled, every allocation, reuse, release and arena extension is also recorded as a
+// "Memory" event with the bytes in use by the run at that point, which gives a timeline next to the node events.
+class MemoryProfiler final {
+ public:
+  struct TensorBytes {
+    std::string tensor_name;
+    std::string node_name;  // the node producing the tensor, empty for graph inputs
+    int64_t bytes;
+  };
+
+  // The run that used the most memory so far.
+  struct PeakSummary {
+    int64_t peak_bytes = 0;
+    // the tensors in use at the peak, largest first
+    std::vector<TensorBytes> tensors;
+    // the extensions of the arenas during all the recorded runs
+    int64_t arena_extensions = 0;
+    int64_t arena_extension_bytes = 0;
+  };
+
+  // The memory accounting of a single run, which is kept by its ExecutionFrame. Safe to use from the threads of
+  // the parallel executor.
+  class Run final {
+   public:
+    explicit Run(MemoryProfiler& memory_profiler);
+    ~Run();
+
+    // The tensor ort_value_idx was allocated a buffer of bytes of its own.
+    void RecordAllocation(int ort_value_idx, int64_t bytes);
+
+    // The tensor ort_value_idx uses the buffer of reused_ort_value_idx.
+    void RecordReuse(int ort_value_idx, int reused_ort_value_idx);
+
+    // The tensor ort_value_idx was released.
+    void RecordRelease(int ort_value_idx);
+
+    // Checks the arenas for extensions caused by an allocation other than of a tensor, e.g. the buffers of a
+    // memory pattern.
+    void CheckArenas(const char* reason);
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Run);
+
+    // Called with mutex_ held.
+    void CheckArenasLocked(const std::string& reason);
+    void RecordEvent(const char* kind, const std::string& tensor_name, int64_t bytes,
+                     const std::string& buffer_of = std::string());
+
+    MemoryProfiler& memory_profiler_;
+    OrtMutex mutex_;
+    std::unordered_map<int, int64_t> live_bytes_;
+    int64_t bytes_in_use_ = 0;
+    int64_t peak_bytes_ = 0;
+    std::unordered_map<int, int64_t> live_bytes_at_peak_;
+    std::vector<int64_t> arena_bytes_;
+    int64_t arena_extensions_ = 0;
+    int64_t arena_extension_bytes_ = 0;
+  };
+
+  MemoryProfiler(const GraphViewer& graph_viewer, const OrtValueNameIdxMap& ort_value_name_idx_map,
+                 std::vector<std::shared_ptr<BFCArena>> arenas, profiling::Profiler& profiler);
+
+  PeakSummary GetPeakSummary() const;
+
+  // Forget the recorded runs.
+  void Reset();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryProfiler);
+
+  // Folds a finished run into the summary.
+  void AddRun(const Run& run);
+
+  std::vector<std::string> tensor_names_;
+  std::vector<std::string> producer_names_;
+  const std::vector<std::shared_ptr<BFCArena>> arenas_;
+  profiling::Profiler& profiler_;
+
+  mutable OrtMutex mutex_;
+  PeakSummary summary_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_counters.h"
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+NodeCounters::NodeCounters(const GraphViewer& graph_viewer)
+    : nodes_(graph_viewer.GetNodesInTopologicalOrder()),
+      counters_(std::make_unique<Counters[]>(graph_viewer.MaxNodeIndex())) {
+  node_names_.reserve(nodes_.size());
+  for (NodeIndex node_index : nodes_) {
+    node_names_.push_back(graph_viewer.GetNode(node_index)->Name());
+  }
+  // only the counters of the nodes of the graph are used, so those are all that need initializing
+  Reset();
+}
+
+NodeCounters::Values NodeCounters::Get(NodeIndex node_index) const {
+  const Counters& counters = counters_[node_index];
+  return {counters.count.load(std::memory_order_relaxed),
+          counters.total_ns.load(std::memory_order_relaxed),
+          counters.max_ns.load(std::memory_order_relaxed),
+          counters.bytes_allocated.load(std::memory_order_relaxed)};
+}
+
+void NodeCounters::Reset() {
+  for (NodeIndex node_index : nodes_) {
+    Counters& counters = counters_[node_index];
+    counters.count.store(0, std::memory_order_relaxed);
+    counters.total_ns.store(0, std::memory_order_relaxed);
+    counters.max_ns.store(0, std::memory_order_relaxed);
+    counters.bytes_allocated.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace onnxruntime
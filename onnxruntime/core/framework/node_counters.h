@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+// Counts the kernel runs of each node of a graph: how many, the total and the longest compute time, and the bytes of
+// the output tensors. Unlike the profiler, recording a run neither takes a lock nor allocates, so the counters can
+// stay enabled in production.
+//
+// Runs may be recorded and the counters read concurrently from multiple runs. The counters of a node that are read
+// while it's being recorded may be off by that run.
+class NodeCounters final {
+ public:
+  struct Values {
+    int64_t count;
+    int64_t total_ns;
+    int64_t max_ns;
+    int64_t bytes_allocated;
+  };
+
+  explicit NodeCounters(const GraphViewer& graph_viewer);
+
+  // Record a run of the node that computed for nanoseconds and produced outputs of bytes_allocated bytes.
+  void RecordNodeRun(NodeIndex node_index, int64_t nanoseconds, int64_t bytes_allocated) {
+    Counters& counters = counters_[node_index];
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.total_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+    counters.bytes_allocated.fetch_add(bytes_allocated, std::memory_order_relaxed);
+    int64_t max_ns = counters.max_ns.load(std::memory_order_relaxed);
+    while (nanoseconds > max_ns &&
+           !counters.max_ns.compare_exchange_weak(max_ns, nanoseconds, std::memory_order_relaxed)) {
+    }
+  }
+
+  // The nodes that are counted, in topological order, and their names.
+  const std::vector<NodeIndex>& Nodes() const { return nodes_; }
+  const std::vector<std::string>& NodeNames() const { return node_names_; }
+
+  Values Get(NodeIndex node_index) const;
+
+  // Set all counters to zero.
+  void Reset();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeCounters);
+
+  struct Counters {
+    std::atomic<int64_t> count;
+    std::atomic<int64_t> total_ns;
+    std::atomic<int64_t> max_ns;
+    std::atomic<int64_t> bytes_allocated;
+  };
+
+  std::vector<NodeIndex> nodes_;
+  std::vector<std::string> node_names_;
+  std::unique_ptr<Counters[]> counters_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_priorities.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+NodePriorities::NodePriorities(const GraphViewer& graph_viewer)
+    : graph_viewer_(graph_viewer),
+      num_nodes_(graph_viewer.MaxNodeIndex()),
+      costs_(std::make_unique<std::atomic<int64_t>[]>(num_nodes_)),
+      priorities_(std::make_unique<std::atomic<int64_t>[]>(num_nodes_)) {
+  for (size_t i = 0; i < num_nodes_; ++i) {
+    costs_[i].store(0, std::memory_order_relaxed);
+    priorities_[i].store(0, std::memory_order_relaxed);
+  }
+  UpdatePriorities();
+}
+
+void NodePriorities::RecordNodeCost(NodeIndex node_index, int64_t microseconds) {
+  // Keep an exponential moving average weighted 1/4 towards the new sample. A failed
+  // compare_exchange only means another run recorded a sample concurrently, so retry.
+  int64_t previous = costs_[node_index].load(std::memory_order_relaxed);
+  int64_t updated;
+  do {
+    updated = previous == 0 ? microseconds : previous + (microseconds - previous) / 4;
+    // a node that was observed must never look unobserved
+    updated = std::max<int64_t>(updated, 1);
+  } while (!costs_[node_index].compare_exchange_weak(previous, updated, std::memory_order_relaxed));
+}
+
+void NodePriorities::UpdatePriorities() {
+  std::lock_guard<OrtMutex> lock(update_mutex_);
+
+  const std::vector<NodeIndex>& order = graph_viewer_.GetNodesInTopologicalOrder();
+  std::vector<int64_t> path_costs(num_nodes_, 0);
+
+  // visit consumers before producers so the longest path from each successor is known
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const Node* node = graph_viewer_.GetNode(*it);
+    if (node == nullptr) continue;
+
+    int64_t longest_successor_path = 0;
+    for (auto edge = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); edge != end; ++edge) {
+      longest_successor_path = std::max(longest_successor_path, path_costs[edge->GetNode().Index()]);
+    }
+
+    int64_t cost = costs_[*it].load(std::memory_order_relaxed);
+    path_costs[*it] = longest_successor_path + (cost > 0 ? cost : 1);
+    priorities_[*it].store(path_costs[*it], std::memory_order_relaxed);
+  }
+}
+
+}  // namespace onnxruntime
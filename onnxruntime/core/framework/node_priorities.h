@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+// Ranks the nodes of a graph by the length of the longest path from the node to the end of the graph.
+// Each node on a path is weighted by its average kernel time observed in previous runs, or by a unit
+// cost until it has been observed. The ParallelExecutor dispatches ready nodes with a higher
+// priority first so that the critical path isn't delayed by work that has more slack.
+//
+// Priorities and costs may be read and recorded concurrently from multiple runs.
+class NodePriorities final {
+ public:
+  explicit NodePriorities(const GraphViewer& graph_viewer);
+
+  // Priority of the node. Nodes with a larger value should be run first.
+  int64_t Priority(NodeIndex node_index) const {
+    return priorities_[node_index].load(std::memory_order_relaxed);
+  }
+
+  // Record the time spent computing the node in one run.
+  void RecordNodeCost(NodeIndex node_index, int64_t microseconds);
+
+  // Recompute the priorities from the costs recorded so far.
+  void UpdatePriorities();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodePriorities);
+
+  const GraphViewer& graph_viewer_;
+  size_t num_nodes_;
+
+  // smoothed per node cost in microseconds. 0 if the node hasn't been observed.
+  std::unique_ptr<std::atomic<int64_t>[]> costs_;
+  std::unique_ptr<std::atomic<int64_t>[]> priorities_;
+
+  // serializes UpdatePriorities
+  OrtMutex update_mutex_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_shape_cache.h"
+
+namespace onnxruntime {
+
+NodeShapeCache::NodeShapeCache(size_t max_node_index)
+    : entries_(std::make_unique<std::shared_ptr<const Entry>[]>(max_node_index)) {
+}
+
+void NodeShapeCache::Store(NodeIndex node_index, std::vector<int64_t> signature, std::shared_ptr<const void> state) {
+  auto entry = std::make_shared<Entry>();
+  entry->signature = std::move(signature);
+  entry->state = std::move(state);
+  std::atomic_store(&entries_[node_index], std::shared_ptr<const Entry>(std::move(entry)));
+}
+
+}  // namespace onnxruntime
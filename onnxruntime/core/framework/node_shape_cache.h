@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+// Caches the state a kernel derives from the shapes of its inputs, such as its output shapes and the setup of its
+// computation, so that a node run with the same input shapes as its previous run can skip that work. Each node
+// keeps the state of its latest input shapes only, which is all that runs with fixed shapes need.
+//
+// The input shapes are summarized in a signature: for each input, its rank followed by its dims, or -1 if it's
+// missing. Runs may look up and store states concurrently. A stored state is immutable and shared with the runs
+// that use it, so replacing it doesn't affect a run still using the previous one.
+class NodeShapeCache final {
+ public:
+  explicit NodeShapeCache(size_t max_node_index);
+
+  // Returns the state stored for the node if its signature is accepted by matches, or nullptr.
+  template <typename TMatch>
+  std::shared_ptr<const void> Lookup(NodeIndex node_index, const TMatch& matches) const {
+    auto entry = std::atomic_load(&entries_[node_index]);
+    if (entry == nullptr || !matches(entry->signature)) {
+      return nullptr;
+    }
+    return entry->state;
+  }
+
+  void Store(NodeIndex node_index, std::vector<int64_t> signature, std::shared_ptr<const void> state);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeShapeCache);
+
+  struct Entry {
+    std::vector<int64_t> signature;
+    std::shared_ptr<const void> state;
+  };
+
+  std::unique_ptr<std::shared_ptr<const Entry>[]> entries_;
+};
+
+}  // namespace onnxruntime
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/framework/op_kernel.h"
+
+#include <algorithm>
+
 #include "core/framework/execution_frame.h"
+#include "core/framework/node_shape_cache.h"
 #include "core/framework/session_state.h"
 #include "core/graph/op.h"
 #include "core/common/logging/logging.h"
@@ -23,6 +27,12 @@ OpKernelContext::OpKernelContext(IExecutionFrame* frame,
   node_output_start_index_ = node_implicit_input_start_index_ + ImplicitInputCount();
 }
 
+OpKernelContext::~OpKernelContext() {
+  if (scratch_buffer_) {
+    execution_frame_->ReleaseScratchBuffer(kernel_->Node().Index(), scratch_allocator_, scratch_buffer_);
+  }
+}
+
 Tensor* OpKernelContext::Output(int index, const TensorShape& shape) {
   auto p_ml_value = OutputMLValue(index, shape);
   return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
@@ -63,6 +73,77 @@ Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
   return Status::OK();
 }
 
+Status OpKernelContext::GetScratchBuffer(size_t size, void** buffer) {
+  if (scratch_buffer_) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "The scratch buffer of a kernel can only be requested once");
+  }
+
+  *buffer = nullptr;
+  if (size == 0) {
+    return Status::OK();
+  }
+
+  // rounded up like the tensors, so the blocks planned after it in the memory pattern stay aligned
+  size_t aligned_size;
+  if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(size, 1, &aligned_size)) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "scratch buffer size overflow");
+  }
+
+  ORT_RETURN_IF_ERROR(GetTempSpaceAllocator(&scratch_allocator_));
+  scratch_buffer_ = execution_frame_->AllocateScratchBuffer(kernel_->Node().Index(), scratch_allocator_,
+                                                            aligned_size);
+  *buffer = scratch_buffer_;
+  return Status::OK();
+}
+
+std::shared_ptr<const void> OpKernelContext::GetShapeCachedStateImpl() const {
+  if (shape_cache_ == nullptr) {
+    return nullptr;
+  }
+
+  // compare the signature with the input shapes in place, so that a hit doesn't allocate
+  return shape_cache_->Lookup(kernel_->Node().Index(), [this](const std::vector<int64_t>& signature) {
+    size_t pos = 0;
+    for (int i = 0, end = InputCount(); i < end; ++i) {
+      const OrtValue* value = GetInputMLValue(i);
+      if (value == nullptr || !value->IsAllocated()) {
+        if (pos >= signature.size() || signature[pos++] != -1) return false;
+        continue;
+      }
+      if (!value->IsTensor()) return false;
+      const auto& dims = value->Get<Tensor>().Shape().GetDims();
+      if (pos + 1 + dims.size() > signature.size() || signature[pos] != static_cast<int64_t>(dims.size()) ||
+          !std::equal(dims.begin(), dims.end(), signature.begin() + pos + 1)) {
+        return false;
+      }
+      pos += 1 + dims.size();
+    }
+    return pos == signature.size();
+  });
+}
+
+void OpKernelContext::SetShapeCachedStateImpl(std::shared_ptr<const void> state) {
+  if (shape_cache_ == nullptr) {
+    return;
+  }
+
+  std::vector<int64_t> signature;
+  for (int i = 0, end = InputCount(); i < end; ++i) {
+    const OrtValue* value = GetInputMLValue(i);
+    if (value == nullptr || !value->IsAllocated()) {
+      signature.push_back(-1);
+      continue;
+    }
+    // only tensor inputs have shapes to key the state with
+    if (!value->IsTensor()) return;
+    const auto& dims = value->Get<Tensor>().Shape().GetDims();
+    signature.push_back(static_cast<int64_t>(dims.size()));
+    signature.insert(signature.end(), dims.begin(), dims.end());
+  }
+
+  shape_cache_->Store(kernel_->Node().Index(), std::move(signature), std::move(state));
+}
+
 MLDataType OpKernelContext::InputType(int index) const {
   int input_arg_index = GetInputArgIndex(index);
   const OrtValue* p_ml_value = execution_frame_->GetNodeInputOrOutputMLValue(input_arg_index);
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "core/framework/execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/termination_check.h"
 #include "core/session/onnxruntime_c_api.h"
 
 // onnxruntime internal OpKernelContext derived class to provide additional
@@ -20,10 +22,14 @@ class OpKernelContextInternal : public OpKernelContext {
                                    IExecutionFrame& frame,
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
-                                   const bool& terminate_flag)
+                                   const TerminationCheck& termination_check)
       : OpKernelContext(&frame, &kernel, logger),
         session_state_{session_state},
-        terminate_flag_{terminate_flag} {
+        frame_{frame},
+        termination_check_{termination_check},
+        execution_provider_{kernel.Info().GetExecutionProvider()} {
+    SetShapeCache(session_state.GetNodeShapeCache());
+
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
     int num_implicit_inputs = static_cast<int>(implicit_inputs.size());
     implicit_input_values_.reserve(num_implicit_inputs);
@@ -52,19 +58,40 @@ class OpKernelContextInternal : public OpKernelContext {
     return OpKernelContext::OutputMLValue(index, shape);
   }
 
+  // Returns output index as a view of input input_index with the given strides (in elements) and offset of its
+  // first element from that of the input, or nullptr if the plan doesn't make the output a view of that input, in
+  // which case the kernel calls Output() and copies the elements. Only kernels whose KernelDef declares
+  // MayStridedOutput(input_index, index) get views.
+  Tensor* OutputView(int index, int input_index, const TensorShape& shape, const std::vector<int64_t>& strides,
+                     int64_t offset) {
+    if (index < 0 || index >= OutputCount() || input_index < 0 || input_index >= InputCount())
+      return nullptr;
+
+    const int node_offset = frame_.GetNodeOffset(GetNodeIndex());
+    OrtValue* p_ml_value = nullptr;
+    auto status = frame_.CreateNodeOutputView(node_offset + InputCount() + ImplicitInputCount() + index,
+                                              node_offset + input_index, shape, strides, offset, p_ml_value);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    return p_ml_value ? p_ml_value->GetMutable<Tensor>() : nullptr;
+  }
+
   // Get the OrtValue's for all implicit inputs. Order is same as Node::ImplicitInputDefs(). No nullptr entries.
   const std::vector<const OrtValue*>& GetImplicitInputs() const {
     return implicit_input_values_;
   }
 
-  const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
+  const TerminationCheck& GetTerminationCheck() const noexcept { return termination_check_; }
 
   _Ret_maybenull_ const onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() const { return session_state_.GetThreadPool(); }
   _Ret_maybenull_ onnxruntime::concurrency::ThreadPool* GetOperatorThreadPool() { return session_state_.GetThreadPool(); }
 
+  const IExecutionProvider* GetExecutionProvider() const noexcept { return execution_provider_; }
+
  private:
   const SessionState& session_state_;
-  const bool& terminate_flag_;
+  IExecutionFrame& frame_;
+  const TerminationCheck& termination_check_;
+  const IExecutionProvider* execution_provider_;
   std::vector<const OrtValue*> implicit_input_values_;
 };
 
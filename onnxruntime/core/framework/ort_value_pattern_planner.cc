@@ -14,24 +14,30 @@ OrtValuePatternPlanner::OrtValuePatternPlanner(const ExecutionPlanBase& executio
 }
 
 common::Status OrtValuePatternPlanner::TraceAllocation(int ort_value_idx, size_t size) {
-  auto location = execution_planner_.GetLocation(ort_value_idx);
+  return TraceAllocation(execution_planner_.GetLocation(ort_value_idx), ort_value_idx, size);
+}
+
+common::Status OrtValuePatternPlanner::TraceFree(int ort_value_index) {
+  return TraceFree(execution_planner_.GetLocation(ort_value_index), ort_value_index);
+}
+
+common::Status OrtValuePatternPlanner::TraceAllocation(const OrtMemoryInfo& location, int index, size_t size) {
   auto it = planner_map_.find(location);
   if (it == planner_map_.end()) {
     return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
   }
 
-  it->second->TraceAllocation(ort_value_idx, size);
+  it->second->TraceAllocation(index, size);
   return common::Status::OK();
 }
 
-common::Status OrtValuePatternPlanner::TraceFree(int ort_value_index) {
-  auto location = execution_planner_.GetLocation(ort_value_index);
+common::Status OrtValuePatternPlanner::TraceFree(const OrtMemoryInfo& location, int index) {
   auto it = planner_map_.find(location);
   if (it == planner_map_.end()) {
     return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT);
   }
 
-  it->second->TraceFree(ort_value_index);
+  it->second->TraceFree(index);
   return common::Status::OK();
 }
 
@@ -21,6 +21,10 @@ class OrtValuePatternPlanner {
   explicit OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan);
   common::Status TraceAllocation(int ort_value_idx, size_t size);
   common::Status TraceFree(int ort_value_index);
+  // Traces a buffer that is not an OrtValue of the plan, like a kernel scratch buffer, in the given location.
+  // index must not collide with the OrtValue indices.
+  common::Status TraceAllocation(const OrtMemoryInfo& location, int index, size_t size);
+  common::Status TraceFree(const OrtMemoryInfo& location, int index);
   common::Status GeneratePatterns(MemoryPatternGroup* out);
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OrtValuePatternPlanner);
 
@@ -3,9 +3,11 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -14,19 +16,36 @@
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/perf_counters.h"
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_{terminate_flag} {
+ParallelExecutor::ParallelExecutor(const SessionState& session_state, const TerminationCheck& termination_check,
+                                   RunTrace* run_trace)
+    : out_standings_(0),
+      has_errors_(false),
+      node_priorities_(session_state.GetNodePriorities()),
+      node_counters_(session_state.GetNodeCounters()),
+      termination_check_{termination_check},
+      run_trace_{run_trace} {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
+  node_refs_ = std::make_unique<std::atomic<size_t>[]>(graph_viewer->MaxNodeIndex());
+  runs_on_device_.resize(graph_viewer->MaxNodeIndex());
+  const auto& execution_providers = session_state.GetExecutionProviders();
   for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()].store(node.GetInputEdgesCount(), std::memory_order_relaxed);
+    const IExecutionProvider* provider = execution_providers.Get(node);
+    AllocatorPtr allocator = provider != nullptr ? provider->GetAllocator(0, OrtMemTypeDefault) : nullptr;
+    runs_on_device_[node.Index()] = allocator != nullptr && allocator->Info().device.Type() != OrtDevice::CPU;
   }
 
-  executor_pool_ = std::make_unique<onnxruntime::concurrency::ThreadPool>("EXECUTOR", 32);
+  executor_pool_ = session_state.GetInterOpThreadPool();
+  if (executor_pool_ == nullptr) {
+    // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
+    owned_executor_pool_ = std::make_unique<onnxruntime::concurrency::ThreadPool>("EXECUTOR", 32);
+    executor_pool_ = owned_executor_pool_.get();
+  }
 }
 
 Status ParallelExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
@@ -42,13 +61,29 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
 
   root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                  fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
+  std::vector<NodeIndex> root_nodes;
   for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
-    auto p_op_kernel = session_state.GetKernel(node_index);
-    if (!p_op_kernel)
-      continue;
+    if (session_state.GetKernel(node_index))
+      root_nodes.push_back(node_index);
+  }
+
+  if (node_priorities_ != nullptr) {
+    // Sorted by a snapshot of the priorities, which concurrent runs may update during the sort.
+    std::vector<std::pair<int64_t, NodeIndex>> prioritized_root_nodes;
+    prioritized_root_nodes.reserve(root_nodes.size());
+    for (auto node_index : root_nodes) {
+      prioritized_root_nodes.emplace_back(node_priorities_->Priority(node_index), node_index);
+    }
+    std::stable_sort(prioritized_root_nodes.begin(), prioritized_root_nodes.end(),
+                     [](const std::pair<int64_t, NodeIndex>& a, const std::pair<int64_t, NodeIndex>& b) {
+                       return a.first > b.first;
+                     });
+    for (size_t i = 0; i < root_nodes.size(); ++i) {
+      root_nodes[i] = prioritized_root_nodes[i].second;
+    }
+  }
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
+  for (auto node_index : root_nodes) {
     EnqueueNode(node_index, session_state, logger);
   }
 
@@ -83,7 +118,7 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   ORT_RETURN_IF_ERROR(root_frame_->GetOutputs(fetches));
   VLOGS(logger, 1) << "Done execution.";
 
-  if (root_frame_->HasMemoryPatternPlanner()) {
+  if (root_frame_->HasMemoryPatternPlanner() || root_frame_->MemoryPatternMissed()) {
     std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -95,13 +130,19 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
       input_shapes.push_back(std::cref(tensor.Shape()));
     }
 
-    if (all_tensors) {
+    if (all_tensors && root_frame_->HasMemoryPatternPlanner()) {
       auto mem_patterns = std::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns.get()));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
+    } else if (all_tensors) {
+      session_state.RequestMemoryPatternRetrace(input_shapes);
     }
   }
 
+  if (node_priorities_ != nullptr) {
+    node_priorities_->UpdatePriorities();
+  }
+
   if (is_profiler_enabled) {
     session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
   }
@@ -123,14 +164,18 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  // The ready successors with their priorities, read once so that updates by concurrent runs can't change the order
+  // of the nodes while they are sorted.
+  std::vector<std::pair<int64_t, NodeIndex>> ready_nodes;
 
   // Avoid context switching if possible.
   while (keep_running) {
     // TODO: Convert RunNodeAsync return Status.
     // to also handle exception propagation
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
+    Status termination_status = termination_check_.Check();
+    if (!termination_status.IsOK()) {
+      LOGS(logger, WARNING) << termination_status.ErrorMessage();
+      ORT_THROW(termination_status.ErrorMessage());
     }
 
     auto p_op_kernel = session_state.GetKernel(node_index);
@@ -141,7 +186,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                 graph_viewer->GetNode(node_index)->Name());
     }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, termination_check_);
 
     if (f_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -179,6 +224,8 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       }
     }
 
+    PerfCounterValues counters_before;
+    bool has_counters_before = false;
     if (f_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      p_op_kernel->Node().Name() + "_fence_before",
@@ -186,13 +233,47 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
       kernel_begin_time = session_state.Profiler().StartTime();
+      has_counters_before = session_state.GetProfileHardwareCounters() && ReadThreadPerfCounters(counters_before);
+      p_op_kernel->Info().GetExecutionProvider()->StartKernelTiming(p_op_kernel->Node());
     }
 
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
-    // Execute the kernel.
+    // Execute the kernel. The nodes run concurrently, so only the memcpy nodes get spans of their own.
+    RunTraceSpan memcpy_span;
+    if (utils::IsMemcpyNode(p_op_kernel->Node())) {
+      memcpy_span.Begin(run_trace_, ORT_RUN_TRACE_SPAN_MEMCPY, p_op_kernel->Node().Name(),
+                        p_op_kernel->Node().GetExecutionProviderType());
+    }
+    RunTrace* const node_trace = run_trace_ != nullptr && run_trace_->RecordsNodes() ? run_trace_ : nullptr;
+    std::chrono::steady_clock::time_point compute_begin_time;
+    const bool is_timed = node_priorities_ != nullptr || node_counters_ != nullptr || node_trace != nullptr;
+    if (is_timed) {
+      compute_begin_time = std::chrono::steady_clock::now();
+    }
+
     status = p_op_kernel->Compute(&op_kernel_context);
+    memcpy_span.End(status);
+
+    if (is_timed) {
+      const auto compute_end_time = std::chrono::steady_clock::now();
+      auto compute_time = std::chrono::duration_cast<std::chrono::nanoseconds>(compute_end_time - compute_begin_time);
+      if (node_priorities_ != nullptr) {
+        node_priorities_->RecordNodeCost(node_index, compute_time.count() / 1000);
+      }
+      if (node_counters_ != nullptr) {
+        node_counters_->RecordNodeRun(node_index, compute_time.count(),
+                                      utils::GetOutputTensorBytes(op_kernel_context));
+      }
+      if (node_trace != nullptr) {
+        node_trace->RecordNode(p_op_kernel->Node(), compute_begin_time, compute_end_time);
+      }
+    }
+    if (f_profiler_enabled) {
+      p_op_kernel->Info().GetExecutionProvider()->EndKernelTiming(p_op_kernel->Node(), kernel_begin_time,
+                                                                  session_state.Profiler());
+    }
     if (!status.IsOK()) {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                                "Compute failed for node: ", graph_viewer->GetNode(node_index)->Name(),
@@ -201,10 +282,8 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     }
 
     if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+      utils::RecordKernelComputeEvent(session_state, *p_op_kernel, op_kernel_context, kernel_begin_time,
+                                      has_counters_before ? &counters_before : nullptr);
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -244,17 +323,30 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     keep_running = false;
 
     // Checking which output nodes ready for running.
+    // Exactly one thread observes a node's count dropping to zero, so no lock is needed. The acq_rel ordering
+    // makes the outputs written by every producer visible to the thread that goes on to run the consumer.
     {
       auto begin = p_op_kernel->Node().OutputEdgesBegin();
       auto end = p_op_kernel->Node().OutputEdgesEnd();
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
+      if (node_priorities_ != nullptr) {
+        ready_nodes.clear();
+      }
+
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
+        if (node_refs_[idx].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          if (node_priorities_ != nullptr) {
+            ready_nodes.emplace_back(node_priorities_->Priority(idx), idx);
+          } else if (!keep_running) {
+            // Continue with the first ready successor on this thread to keep its inputs in cache.
             node_index = idx;
             keep_running = true;
+          } else if (runs_on_device_[idx] && !runs_on_device_[node_index]) {
+            // A device node only queues its work, so continue with it, and let another thread run the CPU node
+            // while the device computes.
+            EnqueueNode(node_index, session_state, logger);
+            node_index = idx;
           } else {
             EnqueueNode(idx, session_state, logger);
           }
@@ -264,6 +356,21 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
         // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
         // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
       }
+
+      if (!ready_nodes.empty()) {
+        // Continue with the highest priority node on this thread. The pool runs work queued by a thread
+        // most recently queued first, so enqueue the remaining nodes in ascending priority order.
+        std::sort(ready_nodes.begin(), ready_nodes.end(),
+                  [](const std::pair<int64_t, NodeIndex>& a, const std::pair<int64_t, NodeIndex>& b) {
+                    return a.first < b.first;
+                  });
+        node_index = ready_nodes.back().second;
+        keep_running = true;
+        ready_nodes.pop_back();
+        for (const auto& ready_node : ready_nodes) {
+          EnqueueNode(ready_node.second, session_state, logger);
+        }
+      }
     }
   }
 
@@ -271,14 +378,11 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
 }
 
 void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
+  // if there are errors there's no point queuing more work
+  if (has_errors_.load(std::memory_order_relaxed))
+    return;
 
-    out_standings_++;
-  }
+  out_standings_.fetch_add(1, std::memory_order_relaxed);
 
   executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
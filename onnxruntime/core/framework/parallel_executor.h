@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <condition_variable>
 #include "core/common/common.h"
@@ -12,7 +13,9 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/run_trace.h"
 #include "core/framework/session_state.h"
+#include "core/framework/termination_check.h"
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
@@ -21,7 +24,9 @@ class ExecutionFrame;
 
 class ParallelExecutor : public IExecutor {
  public:
-  ParallelExecutor(const SessionState& session_state, const bool& terminate_flag = false);
+  ParallelExecutor(const SessionState& session_state,
+                   const TerminationCheck& termination_check = TerminationCheck::Never(),
+                   RunTrace* run_trace = nullptr);
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -37,31 +42,46 @@ class ParallelExecutor : public IExecutor {
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
   void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
-      std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
+    // The count is decremented and the waiting thread notified under the mutex: once Execute sees it reach zero it
+    // returns and the executor may be destroyed, so this thread must be done with complete_cv_ by then.
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    if (!status.IsOK()) {
+      errors_.push_back(status);
+      has_errors_ = true;
     }
 
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
+    if (out_standings_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
       complete_cv_.notify_all();
     }
   }
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // Number of input edges of each node that haven't been satisfied yet.
+  // A node is ready to run when its count drops to zero.
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+  // Whether each node is assigned to a provider computing on a device, e.g. CUDA, whose kernels return once their
+  // work is queued. Inputs crossing devices are synchronized by the fences of the execution plan.
+  std::vector<bool> runs_on_device_;
+  std::atomic<int> out_standings_;
+  std::atomic<bool> has_errors_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::vector<Status> errors_;  //protected by complete_mutex_
 
-  const bool& terminate_flag_;
-  // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
-  std::unique_ptr<onnxruntime::concurrency::ThreadPool> executor_pool_;
+  // Ready nodes are dispatched in priority order if set. Owned by the SessionState.
+  NodePriorities* node_priorities_;
+
+  // Kernel runs are counted per node if set. Owned by the SessionState.
+  NodeCounters* node_counters_;
+
+  const TerminationCheck& termination_check_;
+
+  // Receives the compute time of each node if set. Owned by the caller of the run.
+  RunTrace* const run_trace_;
+
+  // Pool used to run nodes. Owned by the session, or by owned_executor_pool_ if the
+  // session didn't provide an inter-op thread pool.
+  onnxruntime::concurrency::ThreadPool* executor_pool_;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> owned_executor_pool_;
 };
 }  // namespace onnxruntime
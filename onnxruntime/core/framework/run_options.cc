@@ -52,3 +52,20 @@ ORT_API_STATUS_IMPL(OrtRunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options)
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetRunTimeout, _Inout_ OrtRunOptions* options, int64_t timeout_in_ms) {
+  if (timeout_in_ms < 0)
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "timeout_in_ms must not be negative.");
+  options->run_timeout_ms = timeout_in_ms;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtRunOptionsGetRunTimeout, _In_ const OrtRunOptions* options, _Out_ int64_t* out) {
+  *out = options->run_timeout_ms;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtRunOptionsSetTraceRun, _Inout_ OrtRunOptions* options, int value) {
+  options->trace_run = value != 0;
+  return nullptr;
+}
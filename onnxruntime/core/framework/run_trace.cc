@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_trace.h"
+
+#include <sstream>
+
+#include "core/common/logging/logging.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+void RunTrace::RecordNode(const Node& node, Clock::time_point start, Clock::time_point end) {
+  NodeEvent event{node.Name(), node.OpType(), node.GetExecutionProviderType(), logging::GetThreadId(), start,
+                  end - start};
+  std::lock_guard<OrtMutex> lock(mutex_);
+  events_.push_back(std::move(event));
+}
+
+static int64_t WallClockNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+RunTraceSpan::~RunTraceSpan() {
+  if (IsOpen()) {
+    End(common::Status(common::ONNXRUNTIME, common::FAIL));
+  }
+}
+
+OrtRunTraceSpan RunTraceSpan::MakeSpan() const {
+  OrtRunTraceSpan span{};
+  span.kind = kind_;
+  span.name = name_.c_str();
+  span.provider = provider_.c_str();
+  span.run_tag = trace_->RunTag().c_str();
+  span.run_id = trace_->RunId();
+  span.span_id = span_id_;
+  span.start_time_ns = start_time_ns_;
+  span.status = ORT_OK;
+  return span;
+}
+
+void RunTraceSpan::Begin(RunTrace* trace, OrtRunTraceSpanKind kind, const std::string& name,
+                         const std::string& provider) {
+  if (trace == nullptr || trace->Hook() == nullptr) {
+    return;
+  }
+
+  trace_ = trace;
+  kind_ = kind;
+  name_ = name;
+  provider_ = provider;
+  span_id_ = kind == ORT_RUN_TRACE_SPAN_RUN ? 0 : trace->NextSpanId();
+  start_time_ns_ = WallClockNanoseconds();
+  trace->Hook()->BeginSpan(MakeSpan());
+}
+
+void RunTraceSpan::End(const common::Status& status, size_t node_count) {
+  if (!IsOpen()) {
+    return;
+  }
+
+  OrtRunTraceSpan span = MakeSpan();
+  span.end_time_ns = WallClockNanoseconds();
+  span.node_count = node_count;
+  span.status = static_cast<OrtErrorCode>(status.Code());
+  trace_->Hook()->EndSpan(span);
+  trace_ = nullptr;
+}
+
+std::unique_ptr<RunTrace> RunTraceBuffer::StartRun(const RunOptions& run_options) {
+  if (capacity_ == 0 && hook_ == nullptr) {
+    return nullptr;
+  }
+
+  const int64_t run_id = run_count_.fetch_add(1, std::memory_order_relaxed);
+  const bool records_nodes =
+      capacity_ != 0 && (run_options.trace_run || (sample_rate_ > 0 && run_id % sample_rate_ == 0));
+  if (!records_nodes && hook_ == nullptr) {
+    return nullptr;
+  }
+
+  return std::make_unique<RunTrace>(run_id, run_options.run_tag, records_nodes, hook_.get());
+}
+
+void RunTraceBuffer::Add(std::unique_ptr<RunTrace> trace) {
+  trace->Finish();
+  if (!trace->RecordsNodes()) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (traces_.size() == capacity_) {
+    traces_.pop_front();
+  }
+  traces_.push_back(std::move(trace));
+}
+
+static long long MicroSecondsBetween(RunTrace::Clock::time_point from, RunTrace::Clock::time_point to) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+std::string RunTraceBuffer::Dump(bool clear) {
+  std::ostringstream out;
+  const int pid = logging::GetProcessId();
+  bool is_first_event = true;
+  auto write_event = [&](const char* category, const std::string& name, unsigned int tid, long long ts,
+                         long long dur, const std::string& args) {
+    out << (is_first_event ? "[\n" : ",\n");
+    is_first_event = false;
+    out << R"({"cat" : ")" << category << "\",";
+    out << "\"pid\" :" << pid << ",";
+    out << "\"tid\" :" << tid << ",";
+    out << "\"dur\" :" << dur << ",";
+    out << "\"ts\" :" << ts << ",";
+    out << R"("ph" : "X",)";
+    out << R"("name" :")" << name << "\",";
+    out << "\"args\" : {" << args << "}}";
+  };
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& trace : traces_) {
+    const std::string run_args = "\"run_id\" : \"" + std::to_string(trace->RunId()) + "\"";
+    write_event("Session", trace->RunTag().empty() ? "model_run" : trace->RunTag(), 0,
+                MicroSecondsBetween(created_, trace->StartTime()),
+                MicroSecondsBetween(trace->StartTime(), trace->EndTime()), run_args);
+    for (const auto& event : trace->Events()) {
+      write_event("Node", event.node_name + "_kernel_time", event.thread_id,
+                  MicroSecondsBetween(created_, event.start),
+                  std::chrono::duration_cast<std::chrono::microseconds>(event.duration).count(),
+                  run_args + ", \"op_name\" : \"" + event.op_type + "\", \"provider\" : \"" + event.provider + "\"");
+    }
+  }
+  out << (is_first_event ? "[]\n" : "\n]\n");
+  if (clear) {
+    traces_.clear();
+  }
+  return out.str();
+}
+
+size_t RunTraceBuffer::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return traces_.size();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+class Node;
+
+// Receives the spans of the phases of every run of a session as they begin and end, on the threads running them.
+// See OrtSetRunTraceCallbacks.
+class RunTraceHook {
+ public:
+  virtual ~RunTraceHook() = default;
+  virtual void BeginSpan(const OrtRunTraceSpan& span) = 0;
+  virtual void EndSpan(const OrtRunTraceSpan& span) = 0;
+};
+
+// The hook of the callbacks set with OrtSetRunTraceCallbacks.
+class CallbackRunTraceHook final : public RunTraceHook {
+ public:
+  CallbackRunTraceHook(OrtRunTraceCallback begin_span, OrtRunTraceCallback end_span, void* user_data)
+      : begin_span_{begin_span}, end_span_{end_span}, user_data_{user_data} {}
+
+  void BeginSpan(const OrtRunTraceSpan& span) override {
+    if (begin_span_ != nullptr) begin_span_(user_data_, &span);
+  }
+  void EndSpan(const OrtRunTraceSpan& span) override {
+    if (end_span_ != nullptr) end_span_(user_data_, &span);
+  }
+
+ private:
+  const OrtRunTraceCallback begin_span_;
+  const OrtRunTraceCallback end_span_;
+  void* const user_data_;
+};
+
+// The trace of a single run. If it records nodes, it holds when each kernel of the main graph started computing, for
+// how long, on which thread and execution provider. Nodes may be recorded concurrently by the parallel executor. If
+// the session has a RunTraceHook, the RunTraceSpans of the run are reported to it.
+class RunTrace final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct NodeEvent {
+    std::string node_name;
+    std::string op_type;
+    std::string provider;
+    unsigned int thread_id;
+    Clock::time_point start;
+    Clock::duration duration;
+  };
+
+  RunTrace(int64_t run_id, std::string run_tag, bool records_nodes = true, RunTraceHook* hook = nullptr)
+      : run_id_{run_id}, run_tag_{std::move(run_tag)}, records_nodes_{records_nodes}, hook_{hook},
+        start_{Clock::now()} {}
+
+  // Whether the executors should call RecordNode, i.e. the run was sampled or asked to be traced.
+  bool RecordsNodes() const { return records_nodes_; }
+  void RecordNode(const Node& node, Clock::time_point start, Clock::time_point end);
+
+  RunTraceHook* Hook() const { return hook_; }
+  int64_t NextSpanId() { return next_span_id_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Called when the run is over.
+  void Finish() { end_ = Clock::now(); }
+
+  int64_t RunId() const { return run_id_; }
+  const std::string& RunTag() const { return run_tag_; }
+  Clock::time_point StartTime() const { return start_; }
+  Clock::time_point EndTime() const { return end_; }
+  const std::vector<NodeEvent>& Events() const { return events_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunTrace);
+
+  const int64_t run_id_;
+  const std::string run_tag_;
+  const bool records_nodes_;
+  RunTraceHook* const hook_;
+  std::atomic<int64_t> next_span_id_{1};  // 0 is the span of the run
+  const Clock::time_point start_;
+  Clock::time_point end_;
+  OrtMutex mutex_;
+  std::vector<NodeEvent> events_;
+};
+
+// A phase of a run reported to the hook of its trace, from Begin until End. A span still open when it's destroyed,
+// e.g. when its phase returned early with an error, ends with ORT_FAIL. Does nothing if the run isn't traced or the
+// session has no hook.
+class RunTraceSpan final {
+ public:
+  RunTraceSpan() = default;
+  ~RunTraceSpan();
+
+  void Begin(RunTrace* trace, OrtRunTraceSpanKind kind, const std::string& name, const std::string& provider = {});
+  void End(const common::Status& status, size_t node_count = 0);
+  bool IsOpen() const { return trace_ != nullptr; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunTraceSpan);
+
+  OrtRunTraceSpan MakeSpan() const;
+
+  RunTrace* trace_ = nullptr;
+  OrtRunTraceSpanKind kind_ = ORT_RUN_TRACE_SPAN_RUN;
+  std::string name_;
+  std::string provider_;
+  int64_t span_id_ = 0;
+  int64_t start_time_ns_ = 0;
+};
+
+// Keeps the traces of the most recent sampled runs of a session, so a production session can be profiled without
+// paying for a trace on every run or waiting for EndProfiling. One in every sample_rate runs is traced, as is every
+// run whose RunOptions set trace_run. Once capacity traces are held, the oldest is dropped for each new one.
+// With a hook, every run is traced for its spans, but only the sampled ones record their nodes into the buffer.
+class RunTraceBuffer final {
+ public:
+  RunTraceBuffer(size_t capacity, int64_t sample_rate, std::shared_ptr<RunTraceHook> hook = nullptr)
+      : capacity_{capacity}, sample_rate_{sample_rate}, hook_{std::move(hook)}, created_{RunTrace::Clock::now()} {}
+
+  // Starts the trace of a run if it's sampled, run_options asks for one or there's a hook. Returns null for runs
+  // that aren't traced.
+  std::unique_ptr<RunTrace> StartRun(const RunOptions& run_options);
+
+  // Finishes trace and adds it to the buffer if it recorded nodes.
+  void Add(std::unique_ptr<RunTrace> trace);
+
+  // The buffered traces in chrome tracing format, oldest first, with one "complete event (X)" for each run and for
+  // each node of each run. Timestamps are in microseconds since the buffer was created. If clear is set, the
+  // returned traces are dropped from the buffer.
+  std::string Dump(bool clear);
+
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunTraceBuffer);
+
+  const size_t capacity_;
+  const int64_t sample_rate_;
+  const std::shared_ptr<RunTraceHook> hook_;
+  const RunTrace::Clock::time_point created_;
+  std::atomic<int64_t> run_count_{0};
+  mutable OrtMutex mutex_;
+  std::deque<std::unique_ptr<RunTrace>> traces_;
+};
+
+}  // namespace onnxruntime
@@ -28,6 +28,15 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // inplace_output is the graph output that the only consumer of this ml-value computes in place from it,
+  // or -1 if there is none. If the caller pre-allocates that output, this ml-value is written into its buffer.
+  OrtValueIndex inplace_output{-1};
+  // view_of is valid only for a graph output produced by an aliasing kernel (e.g. Reshape). It is the intermediate
+  // ml-value the output is a view of: the output shares its buffer instead of being copied from it, and keeps it
+  // alive after the run. The intermediate is then planned as kAllocateOutput so nothing else reuses its buffer.
+  // With alloc_kind == kReuse, it is instead the input that the output of a kernel declaring MayStridedOutput
+  // (e.g. Slice) may be a strided view of. A kernel that doesn't create the view gets a buffer of its own.
+  OrtValueIndex view_of{-1};
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -72,6 +81,26 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
+  // PlannerStats: how the planner reused buffers, and the resulting memory use of the intermediate
+  // and output tensors whose size is known statically.
+  struct PlannerStats {
+    size_t num_inplace_reuses{0};
+    size_t num_same_size_reuses{0};
+    size_t num_best_fit_reuses{0};
+    // tensors written into the buffer of a graph output if the caller pre-allocates it
+    size_t num_inplace_output_candidates{0};
+    // graph outputs sharing the buffer of the input of the aliasing kernel producing them
+    size_t num_output_views{0};
+    // outputs that may be strided views of an input instead of copies (sequential execution only)
+    size_t num_strided_views{0};
+    size_t num_unknown_size_tensors{0};
+    size_t allocated_bytes{0};
+    size_t allocated_bytes_without_reuse{0};
+    // most bytes of the allocated buffers live at once
+    size_t peak_bytes{0};
+  };
+  PlannerStats planner_stats;
+
   const OrtMemoryInfo& GetLocation(size_t ort_value_index) const override {
     return allocation_plan[ort_value_index].location;
   }
@@ -96,4 +125,5 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
 
 // Output details of an execution plan:
 std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionPlan*, const SessionState*> planinfo);
+std::ostream& operator<<(std::ostream& out, const SequentialExecutionPlan::PlannerStats& stats);
 }  // namespace onnxruntime
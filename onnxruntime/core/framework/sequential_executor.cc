@@ -3,6 +3,7 @@
 
 #include "core/framework/sequential_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <vector>
@@ -11,9 +12,11 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/incremental_execution_cache.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/platform/perf_counters.h"
 
 namespace onnxruntime {
 
@@ -28,6 +31,7 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
                                    const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
                                    const logging::Logger& logger) {
   const bool is_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeCounters* const node_counters = session_state.GetNodeCounters();
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
@@ -38,6 +42,19 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
 
   ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
 
+  // if the watched feeds are the same as in the previous run, start from the memoized values
+  IncrementalExecutionCache* const incremental_cache = session_state.GetIncrementalExecutionCache();
+  IncrementalExecutionCache::RunState incremental_run;
+  if (incremental_cache != nullptr) {
+    const bool has_preallocated_fetches =
+        !fetch_allocators.empty() ||
+        std::any_of(fetches.cbegin(), fetches.cend(), [](const OrtValue& fetch) { return fetch.IsAllocated(); });
+    ORT_RETURN_IF_ERROR(incremental_cache->BeginRun(feed_mlvalue_idxs, feeds, has_preallocated_fetches,
+                                                    session_state.GetExecutionProviders(),
+                                                    session_state.GetDataTransferMgr(), incremental_run));
+    ORT_RETURN_IF_ERROR(incremental_cache->RestoreValues(incremental_run, session_state.GetDataTransferMgr(), frame));
+  }
+
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
@@ -46,13 +63,28 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   // uncomment the line below to dump execution plan
   //std::cout << std::make_pair(p_seq_exec_plan, &session_state) << "\n";
 
+  // the hook of the session gets a span for each run of consecutive nodes of an execution provider, and for each
+  // memcpy node, while the node events are only recorded for the sampled runs
+  RunTrace* const node_trace = run_trace_ != nullptr && run_trace_->RecordsNodes() ? run_trace_ : nullptr;
+  const bool traces_spans = run_trace_ != nullptr && run_trace_->Hook() != nullptr;
+  RunTraceSpan partition_span;
+  const std::string* partition_provider = nullptr;
+  size_t partition_node_count = 0;
+
   for (const auto& node_exec_plan : exec_plan_vec) {
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    Status termination_status = termination_check_.Check();
+    if (!termination_status.IsOK()) {
+      LOGS(logger, WARNING) << termination_status.ErrorMessage();
+      return termination_status;
     }
 
     auto node_index = node_exec_plan.node_index;
+
+    // the values of a memoized node were restored, and those only it reads were never created
+    if (incremental_cache != nullptr && incremental_run.SkipsNode(node_index, *incremental_cache)) {
+      continue;
+    }
+
     auto p_op_kernel = session_state.GetKernel(node_index);
 
     // if a kernel has been added in the session state, it better be NON-null.
@@ -60,9 +92,34 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Got nullptr from GetKernel for node: ",
                              session_state.GetGraphViewer()->GetNode(node_index)->Name());
 
+    RunTraceSpan memcpy_span;
+    if (traces_spans) {
+      const Node& node = p_op_kernel->Node();
+      const std::string& provider = node.GetExecutionProviderType();
+      const bool is_memcpy = utils::IsMemcpyNode(node);
+      if (partition_span.IsOpen() && (is_memcpy || provider != *partition_provider)) {
+        partition_span.End(Status::OK(), partition_node_count);
+      }
+      if (is_memcpy) {
+        memcpy_span.Begin(run_trace_, ORT_RUN_TRACE_SPAN_MEMCPY, node.Name(), provider);
+      } else {
+        if (!partition_span.IsOpen()) {
+          partition_span.Begin(run_trace_, ORT_RUN_TRACE_SPAN_PARTITION, provider, provider);
+          partition_provider = &provider;
+          partition_node_count = 0;
+        }
+        ++partition_node_count;
+      }
+    }
+
+    // kernels read strided views of tensors only when they declare it
+    if (seq_exec_plan.planner_stats.num_strided_views > 0) {
+      ORT_RETURN_IF_ERROR(frame.MaterializeStridedInputs(*p_op_kernel));
+    }
+
     // construct OpKernelContext
     // TODO: log kernel inputs?
-    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, terminate_flag_);
+    OpKernelContextInternal op_kernel_context(session_state, frame, *p_op_kernel, logger, termination_check_);
     // TODO: log kernel outputs?
     if (is_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -105,6 +162,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     utils::DumpNodeInputs(op_kernel_context, p_op_kernel->Node());
 #endif
 
+    PerfCounterValues counters_before;
+    bool has_counters_before = false;
     if (is_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      p_op_kernel->Node().Name() + "_fence_before",
@@ -115,9 +174,32 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
       kernel_begin_time = session_state.Profiler().StartTime();
+      has_counters_before = session_state.GetProfileHardwareCounters() && ReadThreadPerfCounters(counters_before);
+      p_op_kernel->Info().GetExecutionProvider()->StartKernelTiming(p_op_kernel->Node());
+    }
+
+    std::chrono::steady_clock::time_point compute_begin_time;
+    if (node_counters != nullptr || node_trace != nullptr) {
+      compute_begin_time = std::chrono::steady_clock::now();
     }
 
     const auto& compute_status = p_op_kernel->Compute(&op_kernel_context);
+    memcpy_span.End(compute_status);
+
+    if (node_counters != nullptr || node_trace != nullptr) {
+      const auto compute_end_time = std::chrono::steady_clock::now();
+      if (node_counters != nullptr) {
+        auto compute_time = std::chrono::duration_cast<std::chrono::nanoseconds>(compute_end_time - compute_begin_time);
+        node_counters->RecordNodeRun(node_index, compute_time.count(), utils::GetOutputTensorBytes(op_kernel_context));
+      }
+      if (node_trace != nullptr) {
+        node_trace->RecordNode(p_op_kernel->Node(), compute_begin_time, compute_end_time);
+      }
+    }
+    if (is_profiler_enabled) {
+      p_op_kernel->Info().GetExecutionProvider()->EndKernelTiming(p_op_kernel->Node(), kernel_begin_time,
+                                                                  session_state.Profiler());
+    }
     if (!compute_status.IsOK()) {
       std::ostringstream ss;
       ss << "Non-zero status code returned while running Node: " <<
@@ -130,10 +212,8 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 
     if (is_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     p_op_kernel->Node().Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+      utils::RecordKernelComputeEvent(session_state, *p_op_kernel, op_kernel_context, kernel_begin_time,
+                                      has_counters_before ? &counters_before : nullptr);
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -173,17 +253,29 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     utils::DumpNodeOutputs(op_kernel_context, p_op_kernel->Node(), session_state);
 #endif
 
+    if (incremental_cache != nullptr) {
+      ORT_RETURN_IF_ERROR(incremental_cache->RecordNode(node_index, session_state.GetDataTransferMgr(), frame,
+                                                        incremental_run));
+    }
+
     // free ml-values corresponding to this node
     VLOGS(logger, 1) << "Releasing node ML values after computing kernel: " << p_op_kernel->Node().Name();
     ORT_RETURN_IF_ERROR(ReleaseNodeMLValues(frame, seq_exec_plan, node_exec_plan, logger));
   }
+  partition_span.End(Status::OK(), partition_node_count);
 
   VLOGS(logger, 1) << "Fetching output.";
   // ExecutionFrame::Finalize will update 'fetches' with the final output
   ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
   VLOGS(logger, 1) << "Done with execution.";
 
-  if (frame.HasMemoryPatternPlanner()) {
+  // a run that skipped the memoized nodes didn't allocate their values, so its allocations don't make a pattern
+  const bool skipped_nodes = incremental_run.hit != nullptr;
+  if (incremental_cache != nullptr) {
+    incremental_cache->EndRun(incremental_run);
+  }
+
+  if (!skipped_nodes && (frame.HasMemoryPatternPlanner() || frame.MemoryPatternMissed())) {
     std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
     bool all_tensors = true;
     for (const auto& feed : feeds) {
@@ -195,10 +287,12 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       input_shapes.push_back(std::cref(tensor.Shape()));
     }
 
-    if (all_tensors) {
+    if (all_tensors && frame.HasMemoryPatternPlanner()) {
       auto mem_patterns = std::make_unique<MemoryPatternGroup>();
       ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
+    } else if (all_tensors) {
+      session_state.RequestMemoryPatternRetrace(input_shapes);
     }
   }
 
@@ -11,13 +11,19 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ml_value.h"
+#include "core/framework/run_trace.h"
 #include "core/framework/session_state.h"
+#include "core/framework/termination_check.h"
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
 class SequentialExecutor : public IExecutor {
  public:
-  SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
+  // run_trace, if not null, receives the compute time of each node if it records nodes, and the spans of the runs
+  // of consecutive nodes of an execution provider and of the memcpy nodes if it has a hook.
+  SequentialExecutor(const TerminationCheck& termination_check = TerminationCheck::Never(),
+                     RunTrace* run_trace = nullptr)
+      : termination_check_{termination_check}, run_trace_{run_trace} {}
 
   common::Status Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                          const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
@@ -27,6 +33,7 @@ class SequentialExecutor : public IExecutor {
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
-  const bool& terminate_flag_;
+  const TerminationCheck& termination_check_;
+  RunTrace* const run_trace_;
 };
 }  // namespace onnxruntime
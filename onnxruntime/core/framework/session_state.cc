@@ -9,6 +9,7 @@
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
+#include "core/graph/constants.h"
 
 using namespace ::onnxruntime::common;
 
@@ -68,7 +69,8 @@ Status SessionState::SetGraph(const Graph& graph) {
   return Status::OK();
 }
 
-Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_manager) {
+Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_manager,
+                                   concurrency::ThreadPool* thread_pool) {
   const GraphNodes& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
     size_t max_nodeid = 0;
@@ -77,8 +79,9 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
-    for (auto& node : graph_viewer_->Nodes()) {
-      // construct and save the kernels
+
+    // construct and save the kernel of a node
+    auto create_kernel = [this, &custom_registry_manager](const Node& node) -> Status {
       std::unique_ptr<OpKernel> op_kernel;
       onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
 
@@ -97,6 +100,28 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
       assert(session_kernels_[node.Index()] == nullptr);
       // assumes vector is already resize()'ed to the number of nodes in the graph
       session_kernels_[node.Index()] = op_kernel.release();
+      return Status::OK();
+    };
+
+    // kernels of other providers may compile or set up device state that isn't safe to do concurrently
+    std::vector<const Node*> concurrent_nodes;
+    for (auto& node : graph_viewer_->Nodes()) {
+      if (thread_pool != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        concurrent_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
+    }
+
+    if (!concurrent_nodes.empty()) {
+      std::vector<Status> statuses(concurrent_nodes.size());
+      thread_pool->ParallelFor(static_cast<int32_t>(concurrent_nodes.size()),
+                               [&concurrent_nodes, &statuses, &create_kernel](int32_t i) {
+                                 statuses[i] = create_kernel(*concurrent_nodes[i]);
+                               });
+      for (const auto& status : statuses) {
+        ORT_RETURN_IF_ERROR(status);
+      }
     }
   }
   node_index_info_ = std::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
@@ -148,41 +173,157 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
+void SessionState::SetMemoryPatternCacheOptions(int64_t shape_bucket_size, size_t max_patterns) {
+  ORT_ENFORCE(shape_bucket_size > 0, "Memory pattern shape bucket size must be positive.");
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  mem_pattern_shape_bucket_size_ = shape_bucket_size;
+  max_mem_patterns_ = max_patterns;
+  mem_patterns_.clear();
+  mem_patterns_lru_.clear();
+}
+
+SessionState::MemoryPatternKey SessionState::CalculateMemoryPatternsKey(
+    const std::vector<std::reference_wrapper<const TensorShape>>& shapes) const {
+  MemoryPatternKey key;
   for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    const auto& dims = shape.get().GetDims();
+    key.push_back(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      key.push_back(dim > 0 ? (dim + mem_pattern_shape_bucket_size_ - 1) / mem_pattern_shape_bucket_size_ : dim);
+    }
   }
   return key;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
-    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+static size_t TotalPeakSize(const MemoryPatternGroup& patterns) {
+  size_t total = 0;
+  for (const auto& pattern : patterns.patterns) {
+    total += pattern.PeakSize();
+  }
+  return total;
+}
 
+void SessionState::SetSymbolicMemPatternPlanner(std::unique_ptr<SymbolicMemPatternPlanner> planner) {
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  symbolic_mem_pattern_planner_ = std::move(planner);
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto key = CalculateMemoryPatternsKey(input_shapes);
   auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  if (it == mem_patterns_.end() || it->second.retrace) return nullptr;
+
+  mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, it->second.lru_position);
+  return it->second.patterns;
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+    const std::vector<int>& feed_mlvalue_idxs) const {
+  auto mem_patterns = GetMemoryPatternGroup(input_shapes);
+  if (mem_patterns) return mem_patterns;
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto key = CalculateMemoryPatternsKey(input_shapes);
+  // a pattern flagged for retrace didn't fit, so the run has to be traced
+  if (!symbolic_mem_pattern_planner_ || mem_patterns_.find(key) != mem_patterns_.end()) return nullptr;
+
+  mem_patterns = symbolic_mem_pattern_planner_->GeneratePatterns(feed_mlvalue_idxs, input_shapes,
+                                                                 mem_pattern_shape_bucket_size_);
+  if (mem_patterns) {
+    InsertMemoryPatternGroup(std::move(key), mem_patterns);
+  }
+  return mem_patterns;
+}
+
+void SessionState::InsertMemoryPatternGroup(MemoryPatternKey key,
+                                            std::shared_ptr<const MemoryPatternGroup> mem_patterns) const {
+  mem_patterns_lru_.push_front(key);
+  auto& entry = mem_patterns_[std::move(key)];
+  entry.patterns = std::move(mem_patterns);
+  entry.lru_position = mem_patterns_lru_.begin();
 
-  return it->second.get();
+  while (max_mem_patterns_ > 0 && mem_patterns_.size() > max_mem_patterns_) {
+    mem_patterns_.erase(mem_patterns_lru_.back());
+    mem_patterns_lru_.pop_back();
+  }
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto key = CalculateMemoryPatternsKey(input_shapes);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+    InsertMemoryPatternGroup(std::move(key), std::move(mem_patterns));
+  } else if (it->second.retrace) {
+    // keep whichever pattern covers the bigger inputs
+    if (TotalPeakSize(*mem_patterns) > TotalPeakSize(*it->second.patterns)) {
+      it->second.patterns = std::move(mem_patterns);
+    }
+    it->second.retrace = false;
   }
 
   return Status::OK();
 }
 
+void SessionState::RequestMemoryPatternRetrace(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = mem_patterns_.find(CalculateMemoryPatternsKey(input_shapes));
+  if (it != mem_patterns_.end()) {
+    it->second.retrace = true;
+  }
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
+std::unique_ptr<std::vector<OrtValue>> SessionState::AcquireOrtValueTable() const {
+  std::lock_guard<OrtMutex> lock(ort_value_tables_lock_);
+  if (!ort_value_tables_.empty()) {
+    auto table = std::move(ort_value_tables_.back());
+    ort_value_tables_.pop_back();
+    return table;
+  }
+
+  // the initialized tensors are all added before the first run, so the first table fixes the layout
+  const size_t num_values = static_cast<size_t>(ort_value_name_idx_map_.MaxIdx()) + 1;
+  if (non_initializer_idxs_.empty()) {
+    for (size_t idx = 0; idx < num_values; ++idx) {
+      if (initialized_tensors_.find(static_cast<int>(idx)) == initialized_tensors_.end()) {
+        non_initializer_idxs_.push_back(static_cast<int>(idx));
+      }
+    }
+  }
+
+  auto table = std::make_unique<std::vector<OrtValue>>(num_values);
+  for (const auto& entry : initialized_tensors_) {
+    (*table)[entry.first] = entry.second;
+  }
+
+  return table;
+}
+
+void SessionState::ReleaseOrtValueTable(std::unique_ptr<std::vector<OrtValue>> table,
+                                        bool restore_initializers) const {
+  // release the values of the run outside of the lock, this may free their buffers
+  for (int idx : non_initializer_idxs_) {
+    (*table)[idx] = OrtValue();
+  }
+
+  if (restore_initializers) {
+    for (const auto& entry : initialized_tensors_) {
+      (*table)[entry.first] = entry.second;
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(ort_value_tables_lock_);
+  ort_value_tables_.push_back(std::move(table));
+}
+
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
   // Graph partitioning should ensure an input is only consumed from one device. Copy nodes should have been inserted
   // to handle a scenario where an input is required on different devices by different nodes. Validate that.
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -17,12 +18,18 @@
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/incremental_execution_cache.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/memory_profiler.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/node_counters.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/node_priorities.h"
+#include "core/framework/node_shape_cache.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/platform/threadpool.h"
@@ -50,8 +57,12 @@ struct MemoryPatternGroup;
 class SessionState {
  public:
   SessionState(const ExecutionProviders& execution_providers, bool enable_mem_pattern,
-               concurrency::ThreadPool* thread_pool)
-      : execution_providers_{execution_providers}, enable_mem_pattern_(enable_mem_pattern), thread_pool_(thread_pool) {}
+               concurrency::ThreadPool* thread_pool,
+               concurrency::ThreadPool* inter_op_thread_pool = nullptr)
+      : execution_providers_{execution_providers},
+        enable_mem_pattern_(enable_mem_pattern),
+        thread_pool_(thread_pool),
+        inter_op_thread_pool_(inter_op_thread_pool) {}
 
   ~SessionState() {
     for (auto* p : session_kernels_) {
@@ -90,7 +101,10 @@ class SessionState {
   Status AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d, bool constant);
 
   Status SetGraph(const Graph& graph);
-  Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
+  // Creates the kernels of all the nodes. If thread_pool is given, the kernels of the nodes assigned to the
+  // CPU execution provider are created concurrently on it, so their constructors must be thread-safe.
+  Status CreateKernels(const KernelRegistryManager& custom_registry_manager,
+                       concurrency::ThreadPool* thread_pool = nullptr);
   Status SetGraphAndCreateKernels(const Graph& graph, const KernelRegistryManager& custom_registry_manager) {
     ORT_RETURN_IF_ERROR(SetGraph(graph));
     return CreateKernels(custom_registry_manager);
@@ -135,12 +149,32 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const;
 
+  /**
+  Configure the memory pattern cache. Input dims are rounded up to a multiple of shape_bucket_size
+  to look up a pattern, so inputs of similar size (e.g. sequence lengths) share one. At most
+  max_patterns are kept, evicting the least recently used. 0 means no limit.
+  */
+  void SetMemoryPatternCacheOptions(int64_t shape_bucket_size, size_t max_patterns);
+
+  /**
+  Set the planner used to create memory patterns from the feed shapes without tracing a run.
+  */
+  void SetSymbolicMemPatternPlanner(std::unique_ptr<SymbolicMemPatternPlanner> planner);
+
   /**
   Get cached memory pattern based on input shapes
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
+  /**
+  Get cached memory pattern based on input shapes. If there is none and a symbolic planner is set,
+  a pattern is planned from the shapes of the feeds with the given OrtValue indices and cached.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
+      const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+      const std::vector<int>& feed_mlvalue_idxs) const;
+
   /**
   Set generated memory pattern with a given input shapes.
   Const as it's an internal cache update only.
@@ -148,11 +182,31 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Report that a run had tensors that did not fit the cached pattern for its input shapes.
+  The next run in the same bucket traces a new pattern, which replaces the cached one if it is bigger,
+  so the pattern of a bucket grows towards the largest inputs seen in it.
+  */
+  void RequestMemoryPatternRetrace(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
+
   /**
   Get enable memory pattern flag
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Take a table of the OrtValues of a run, indexed by ort_value_index, with the initialized tensors filled in.
+  The tables are pooled, one per concurrent run, so setting up an execution frame doesn't size a new table and
+  copy every initializer into it.
+  */
+  std::unique_ptr<std::vector<OrtValue>> AcquireOrtValueTable() const;
+
+  /**
+  Give back a table from AcquireOrtValueTable once the run is done with it. The values that are not initializers
+  are released. If the run fed values over some initializers, restore_initializers puts the initializers back.
+  */
+  void ReleaseOrtValueTable(std::unique_ptr<std::vector<OrtValue>> table, bool restore_initializers) const;
+
   struct NodeInfo {
     /**
      *
@@ -198,6 +252,53 @@ class SessionState {
 
   concurrency::ThreadPool* GetThreadPool() const { return thread_pool_; }
 
+  // Thread pool used by the parallel executor to run nodes concurrently. Could be NULL.
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_; }
+
+  // Enable critical path scheduling in the parallel executor. Must be called after the graph is set.
+  void EnableNodePriorities() { node_priorities_ = std::make_unique<NodePriorities>(*GetGraphViewer()); }
+
+  // Priorities the parallel executor uses to order ready nodes. Could be NULL.
+  NodePriorities* GetNodePriorities() const { return node_priorities_.get(); }
+
+  // Count the kernel runs of each node. Must be called after the graph is set.
+  void EnableNodeCounters() { node_counters_ = std::make_unique<NodeCounters>(*GetGraphViewer()); }
+
+  // Counters the executors record the kernel runs of each node in. Could be NULL.
+  NodeCounters* GetNodeCounters() const { return node_counters_.get(); }
+
+  // Let the kernels cache the state they derive from their input shapes. Must be called after the graph is set.
+  void EnableNodeShapeCache() {
+    node_shape_cache_ = std::make_unique<NodeShapeCache>(GetGraphViewer()->MaxNodeIndex());
+  }
+
+  // Cache of the state the kernels derive from their input shapes. Could be NULL.
+  NodeShapeCache* GetNodeShapeCache() const { return node_shape_cache_.get(); }
+
+  // Memoize the nodes that only depend on the given inputs and the initializers between runs. Must be called after
+  // the execution plan and the initializers are set.
+  Status EnableIncrementalExecution(const std::vector<std::string>& input_names) {
+    return IncrementalExecutionCache::Create(*GetGraphViewer(), GetOrtValueNameIdxMap(), *GetExecutionPlan(),
+                                             GetInitializedTensors(), input_names, incremental_execution_cache_);
+  }
+
+  // Memoized values of the nodes that only depend on inputs that didn't change since the previous run. Could be NULL.
+  IncrementalExecutionCache* GetIncrementalExecutionCache() const { return incremental_execution_cache_.get(); }
+
+  // Profile the memory used by the runs, watching arenas for extensions. Must be called after the graph and the
+  // profiler are set.
+  void EnableMemoryProfiler(std::vector<std::shared_ptr<BFCArena>> arenas) {
+    memory_profiler_ = std::make_unique<MemoryProfiler>(*GetGraphViewer(), GetOrtValueNameIdxMap(), std::move(arenas),
+                                                        Profiler());
+  }
+
+  // Records the memory used by each run in its ExecutionFrame. Could be NULL.
+  MemoryProfiler* GetMemoryProfiler() const { return memory_profiler_.get(); }
+
+  // Whether the profiler events of the kernel computations have the hardware counters of the computations.
+  void SetProfileHardwareCounters(bool enable) { profile_hardware_counters_ = enable; }
+  bool GetProfileHardwareCounters() const { return profile_hardware_counters_; }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -239,8 +340,29 @@ class SessionState {
   const bool enable_mem_pattern_;
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
+  // the bucketed dims of all inputs, each shape prefixed with its rank
+  using MemoryPatternKey = std::vector<int64_t>;
+  MemoryPatternKey CalculateMemoryPatternsKey(
+      const std::vector<std::reference_wrapper<const TensorShape>>& shapes) const;
+  struct MemoryPatternCacheEntry {
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    bool retrace = false;
+    std::list<MemoryPatternKey>::iterator lru_position;
+  };
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  mutable std::map<MemoryPatternKey, MemoryPatternCacheEntry> mem_patterns_;
+  // keys of mem_patterns_, most recently used first
+  mutable std::list<MemoryPatternKey> mem_patterns_lru_;
+  int64_t mem_pattern_shape_bucket_size_ = 1;
+  size_t max_mem_patterns_ = 0;
+  void InsertMemoryPatternGroup(MemoryPatternKey key, std::shared_ptr<const MemoryPatternGroup> mem_patterns) const;
+  std::unique_ptr<SymbolicMemPatternPlanner> symbolic_mem_pattern_planner_;
+
+  // pool of the OrtValue tables of the execution frames, see AcquireOrtValueTable
+  mutable OrtMutex ort_value_tables_lock_;
+  mutable std::vector<std::unique_ptr<std::vector<OrtValue>>> ort_value_tables_;
+  // ort_value_index of the values that are not initializers, which are cleared when a table is released
+  mutable std::vector<int> non_initializer_idxs_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -253,6 +375,25 @@ class SessionState {
 
   // It could be NULL
   concurrency::ThreadPool* const thread_pool_;
+  // It could be NULL
+  concurrency::ThreadPool* const inter_op_thread_pool_;
+
+  // It could be NULL
+  std::unique_ptr<NodePriorities> node_priorities_;
+
+  // It could be NULL
+  std::unique_ptr<NodeCounters> node_counters_;
+
+  // It could be NULL
+  std::unique_ptr<NodeShapeCache> node_shape_cache_;
+
+  // It could be NULL
+  std::unique_ptr<IncrementalExecutionCache> incremental_execution_cache_;
+
+  // It could be NULL
+  std::unique_ptr<MemoryProfiler> memory_profiler_;
+
+  bool profile_hardware_counters_ = false;
 
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_set>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -20,6 +21,8 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_cache.h"
+#include "core/framework/symbolic_mem_pattern_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -30,11 +33,14 @@ namespace onnxruntime {
 // T should have signature of '(int idx, const OrtValue& value, const OrtCallback& d) -> Status'
 template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                             const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
+                                             onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                             const SequentialExecutionPlan& exec_plan,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             SharedInitializerCache* shared_initializer_cache,
+                                             concurrency::ThreadPool* thread_pool);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -46,19 +52,23 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
                                                  const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                                  onnxruntime::Graph& graph, SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 SharedInitializerCache* shared_initializer_cache,
+                                                 concurrency::ThreadPool* thread_pool)
     : graph_loc_(graph_loc),
       graph_{graph},
       session_state_{session_state},
       execution_providers_{providers},
       kernel_registry_manager_{kernel_registry_manager},
       logger_{session_state.Logger()},
-      enable_mem_pattern_(enable_mem_pattern) {}
+      enable_mem_pattern_(enable_mem_pattern),
+      shared_initializer_cache_(shared_initializer_cache),
+      thread_pool_(thread_pool) {}
 
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
     const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-    bool enable_sequential_execution) {
+    bool enable_sequential_execution, bool enable_memory_efficient_order) {
   session_state_.SetGraph(graph_);
   const GraphViewer* graph_viewer = session_state_.GetGraphViewer();
 
@@ -78,7 +88,7 @@ common::Status SessionStateInitializer::CreatePlan(
   }
 
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
-  SequentialPlannerContext context(!enable_sequential_execution);
+  SequentialPlannerContext context(!enable_sequential_execution, enable_memory_efficient_order);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_registry_manager_,
                                                     ort_value_name_idx_map, context, exec_plan));
@@ -86,24 +96,47 @@ common::Status SessionStateInitializer::CreatePlan(
 
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
+  LOGS(logger_, VERBOSE) << exec_plan_ptr->planner_stats;
+
+  // the parallel executor doesn't run the nodes in the order of the plan, so only plan patterns statically
+  // for sequential execution.
+  if (enable_mem_pattern_ && enable_sequential_execution) {
+    auto symbolic_planner = SymbolicMemPatternPlanner::Create(*graph_viewer, *exec_plan_ptr, ort_value_name_idx_map);
+    if (!symbolic_planner) {
+      LOGS(logger_, VERBOSE) << "Memory patterns will be traced as not all tensor shapes are known in terms of "
+                                "the graph inputs.";
+    }
+    session_state_.SetSymbolicMemPatternPlanner(std::move(symbolic_planner));
+  }
 
   std::unique_ptr<ITensorAllocator> tensor_allocator_(ITensorAllocator::Create(
       enable_mem_pattern_, *exec_plan_ptr, execution_providers_, session_state_.GetMutableWeightsBuffers()));
 
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
+  profiling::Profiler& profiler = session_state_.Profiler();
+  TimePoint tp = profiler.StartTime();
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
+      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, *exec_plan_ptr, tensor_allocator_.get(),
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), shared_initializer_cache_, thread_pool_));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
   graph_.CleanAllInitializedTensors();
+  initializer_loading_us_ = TimeDiffMicroSeconds(tp);
+  if (profiler.IsEnabled()) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_loading", tp);
+  }
 
-  ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_));
+  tp = profiler.StartTime();
+  ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_, thread_pool_));
+  kernel_creation_us_ = TimeDiffMicroSeconds(tp);
+  if (profiler.IsEnabled()) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernel_creation", tp);
+  }
   ORT_RETURN_IF_ERROR(
       SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_, outer_scope_node_args));
   return Status::OK();
@@ -170,43 +203,131 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
-                                      const Graph& graph, const ExecutionProviders& exec_providers,
-                                      const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
+                                      Graph& graph, const ExecutionProviders& exec_providers,
+                                      const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                      const SequentialExecutionPlan& exec_plan, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      SharedInitializerCache* shared_initializer_cache,
+                                      concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
 
   //1. first plan the memory
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
   std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
+  // initializers on CPU are taken from the shared cache if there's one, and need no buffer from the planner
+  std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_shared_initialized_tensor;
+  // initializers on CPU whose data is in an external file are mapped from the file and need no buffer either
+  std::unordered_set<int> mapped_initialized_tensors;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
-    id_to_initialized_tensor[ort_value_index] = entry.second;
+    const OrtMemoryInfo& location = exec_plan.GetLocation(ort_value_index);
+    bool on_cpu = strcmp(location.name, CPU) == 0 && location.mem_type == OrtMemTypeDefault;
+    if (shared_initializer_cache != nullptr && on_cpu) {
+      id_to_shared_initialized_tensor[ort_value_index] = entry.second;
+    } else {
+      id_to_initialized_tensor[ort_value_index] = entry.second;
+      if (on_cpu && utils::CanUseMappedExternalData(*entry.second)) {
+        mapped_initialized_tensors.insert(ort_value_index);
+      }
+    }
   }
   for (const auto& entry : id_to_initialized_tensor) {
-    ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    if (mapped_initialized_tensors.count(entry.first) == 0) {
+      ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
+    }
   }
 
   //2. allocate weight buffer on different locations
   ORT_RETURN_IF_ERROR(planner->FinalizePlan());
-  OrtCallback deleter;
+
   //3. create weight tensors based on weights buffer
+  struct DeserializedTensor {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::unique_ptr<MemBuffer> m;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+  std::vector<DeserializedTensor> tensors;
+  tensors.reserve(id_to_initialized_tensor.size());
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
     std::unique_ptr<MemBuffer> m;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+    if (mapped_initialized_tensors.count(ort_value_index) != 0) {
+      m = std::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(ort_value_index));
+    } else {
+      // TODO: if the tensor need be copied, does it have enough room?
+      ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+    }
 #ifndef NDEBUG
     ORT_ENFORCE(m != nullptr);
     ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
 #endif
+    tensors.emplace_back();
+    tensors.back().ort_value_index = ort_value_index;
+    tensors.back().tensor_proto = entry.second;
+    tensors.back().m = std::move(m);
+  }
+
+  auto deserialize = [&env, &graph_loc, &exec_providers, &data_transfer_mgr](DeserializedTensor& tensor) {
+    tensor.status = DeserializeTensorProto(env, graph_loc, *tensor.tensor_proto, *tensor.m, exec_providers,
+                                           tensor.ort_value, tensor.deleter, data_transfer_mgr);
+  };
+  // tensors deserialized into CPU memory are independent of each other. copies to other devices stay serial.
+  std::vector<DeserializedTensor*> concurrent_tensors;
+  for (auto& tensor : tensors) {
+    const OrtMemoryInfo& alloc_info = tensor.m->GetAllocInfo();
+    if (thread_pool != nullptr && (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput)) {
+      concurrent_tensors.push_back(&tensor);
+    } else {
+      deserialize(tensor);
+    }
+  }
+  if (!concurrent_tensors.empty()) {
+    thread_pool->ParallelFor(static_cast<int32_t>(concurrent_tensors.size()),
+                             [&concurrent_tensors, &deserialize](int32_t i) { deserialize(*concurrent_tensors[i]); });
+  }
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    DeserializedTensor& tensor = tensors[i];
+    const std::string name = tensor.tensor_proto->name();
+    Status st = tensor.status;
+    if (st.IsOK()) {
+      bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
+      st = save_tensor_func(tensor.ort_value_index, tensor.ort_value, tensor.deleter, constant);
+    }
+    if (!st.IsOK()) {
+      // the tensors that won't be saved still own their file data
+      for (size_t j = i; j < tensors.size(); ++j) {
+        if (tensors[j].deleter.f != nullptr) tensors[j].deleter.f(tensors[j].deleter.param);
+      }
+      if (!tensor.status.IsOK()) {
+        std::ostringstream oss;
+        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
+        return Status(st.Category(), st.Code(), oss.str());
+      }
+      return st;
+    }
+
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << tensor.ort_value_index;
+
+    // the graph's copy of the data isn't needed anymore, so don't keep it until all the tensors are saved
+    graph.ReleaseInitializedTensorData(name);
+  }
+
+  for (const auto& entry : id_to_shared_initialized_tensor) {
+    int ort_value_index = entry.first;
+    const std::string name = entry.second->name();
+
     OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, exec_providers, ort_value, deleter, data_transfer_mgr);
+    OrtCallback deleter;
+    Status st = shared_initializer_cache->GetOrCreate(env, graph_loc, *entry.second, ort_value, deleter);
     if (!st.IsOK()) {
       std::ostringstream oss;
       oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -216,7 +337,8 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
     ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added shared weight with name : " << name << " with index: " << ort_value_index;
+    graph.ReleaseInitializedTensorData(name);
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -19,27 +19,42 @@ class KernelRegistryManager;
 class Node;
 class NodeArg;
 class SessionState;
+class SharedInitializerCache;
 
 namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 // Don't use this class before graph partition is done
 class SessionStateInitializer {
  public:
   /**
    *
    * \param graph_loc The file path of where the graph was loaded. e.g. /tmp/test_squeezenet/model.onnx
+   * \param shared_initializer_cache Optional cache the CPU initializers are taken from instead of being
+   *                                 deserialized into buffers owned by the session state.
+   * \param thread_pool Optional thread pool the CPU initializers are deserialized and the CPU kernels are created
+   *                    on concurrently.
    */
   SessionStateInitializer(bool enable_mem_pattern, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                           onnxruntime::Graph& graph, SessionState& session_state, const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager,
+                          SharedInitializerCache* shared_initializer_cache = nullptr,
+                          concurrency::ThreadPool* thread_pool = nullptr);
 
   // First perform any transformations and create the execution plan
   // Then initialize tensors, and save. save kernels and input/output node mappings
   common::Status CreatePlan(_In_opt_ const Node* parent_node,
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-                            bool enable_sequential_execution);
+                            bool enable_sequential_execution, bool enable_memory_efficient_order = false);
+
+  // The time CreatePlan took to save the initializers into the session state and to create the kernels.
+  long long InitializerLoadingMicroSeconds() const { return initializer_loading_us_; }
+  long long KernelCreationMicroSeconds() const { return kernel_creation_us_; }
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
@@ -50,5 +65,9 @@ class SessionStateInitializer {
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  SharedInitializerCache* shared_initializer_cache_;
+  concurrency::ThreadPool* thread_pool_;
+  long long initializer_loading_us_ = 0;
+  long long kernel_creation_us_ = 0;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/onnx_protobuf.h"
+#include "core/framework/shared_initializer_cache.h"
+
+#include <sstream>
+
+#include "core/framework/mem_buffer.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+struct SharedInitializerCache::Entry {
+  // declared first so that it's freed after the tensor in value is destroyed
+  BufferUniquePtr buffer;
+  OrtValue value;
+  OrtCallback deleter{nullptr, nullptr};
+
+  ~Entry() {
+    if (deleter.f != nullptr) deleter.f(deleter.param);
+  }
+};
+
+struct SharedInitializerCache::Reference {
+  SharedInitializerCache* cache;
+  std::string key;
+  std::shared_ptr<Entry> entry;
+};
+
+SharedInitializerCache::SharedInitializerCache() : allocator_(std::make_shared<CPUAllocator>()) {}
+
+void SharedInitializerCache::ReleaseReference(void* param) noexcept {
+  std::unique_ptr<Reference> reference(static_cast<Reference*>(param));
+  SharedInitializerCache& cache = *reference->cache;
+  std::lock_guard<OrtMutex> lock(cache.mutex_);
+  reference->entry.reset();
+  auto it = cache.entries_.find(reference->key);
+  if (it != cache.entries_.end() && it->second.expired()) {
+    cache.entries_.erase(it);
+  }
+}
+
+static std::string GetKey(const std::basic_string<PATH_CHAR_TYPE>& model_location,
+                          const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  // the content is hashed from the serialized proto as a graph transformer may have rewritten the tensor
+  // without renaming it. its size is part of the key to make a collision of the hashes harmless in practice.
+  std::string content = tensor_proto.SerializeAsString();
+  std::ostringstream key;
+  key << std::hash<std::basic_string<PATH_CHAR_TYPE>>{}(model_location) << ':' << tensor_proto.name() << ':'
+      << std::hash<std::string>{}(content) << ':' << content.size();
+  return key.str();
+}
+
+common::Status SharedInitializerCache::GetOrCreate(const Env& env,
+                                                   const std::basic_string<PATH_CHAR_TYPE>& model_location,
+                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto, OrtValue& value,
+                                                   OrtCallback& deleter) {
+  std::string key = GetKey(model_location, tensor_proto);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  std::shared_ptr<Entry> entry = entries_[key].lock();
+  if (!entry) {
+    // deserialize with the lock held so that sessions of the same model loaded concurrently create it only once
+    // data in an external file is mapped from it rather than copied into a buffer
+    size_t len = 0;
+    if (!utils::CanUseMappedExternalData(tensor_proto)) {
+      ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<256>(tensor_proto, &len));
+    }
+    auto new_entry = std::make_shared<Entry>();
+    void* buffer = len > 0 ? allocator_->Alloc(len) : nullptr;
+    new_entry->buffer = BufferUniquePtr(buffer, BufferDeleter(allocator_));
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToMLValue(env, model_location.c_str(), tensor_proto,
+                                                    MemBuffer(buffer, len, allocator_->Info()), new_entry->value,
+                                                    new_entry->deleter));
+    entries_[key] = new_entry;
+    entry = std::move(new_entry);
+  }
+
+  value = entry->value;
+  deleter.f = ReleaseReference;
+  deleter.param = new Reference{this, std::move(key), std::move(entry)};
+  return Status::OK();
+}
+
+size_t SharedInitializerCache::NumEntries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t num_entries = 0;
+  for (const auto& entry : entries_) {
+    if (!entry.second.expired()) ++num_entries;
+  }
+  return num_entries;
+}
+}  // namespace onnxruntime
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/callback.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/path_lib.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class Env;
+
+/**
+ * Initialized tensors shared by the sessions that load the same model, so that each of them doesn't hold its own
+ * copy of the weights. An entry is keyed by the model location, the tensor name and a hash of the tensor's
+ * content, so initializers that a graph transformer rewrote differently in two sessions aren't mixed up.
+ *
+ * Only CPU initializers are shared. An entry is kept alive by the sessions using it and is dropped with the last
+ * of them. The shared tensors must be treated as read-only.
+ */
+class SharedInitializerCache {
+ public:
+  SharedInitializerCache();
+
+  /**
+   * Gets the tensor for tensor_proto from the cache, deserializing it into a new entry if there's none.
+   * @param deleter Set to release the session's reference to the entry. It must be run once the value
+   *                is no longer used.
+   */
+  common::Status GetOrCreate(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& model_location,
+                             const ONNX_NAMESPACE::TensorProto& tensor_proto, OrtValue& value, OrtCallback& deleter);
+
+  // Number of entries that are in use by a session.
+  size_t NumEntries() const;
+
+ private:
+  struct Entry;
+  struct Reference;
+
+  // The OrtCallback a session runs to release its Reference. The entry is dropped with the last reference.
+  static void ReleaseReference(void* param) noexcept;
+
+  AllocatorPtr allocator_;
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<Entry>> entries_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerCache);
+};
+}  // namespace onnxruntime
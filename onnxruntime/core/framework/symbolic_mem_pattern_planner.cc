@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_mem_pattern_planner.h"
+
+#include <limits>
+#include <string>
+
+#include "core/graph/graph_viewer.h"
+#include "core/framework/ort_value_pattern_planner.h"
+
+namespace onnxruntime {
+
+std::unique_ptr<SymbolicMemPatternPlanner> SymbolicMemPatternPlanner::Create(
+    const GraphViewer& graph_viewer, const SequentialExecutionPlan& execution_plan,
+    const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  std::unique_ptr<SymbolicMemPatternPlanner> planner{new SymbolicMemPatternPlanner(execution_plan)};
+  std::unordered_map<std::string, size_t> symbol_ids;
+
+  // the symbols are bound from the dims of the graph inputs
+  for (const auto* input : graph_viewer.GetInputs()) {
+    const auto* shape = input->Shape();
+    int ort_value_idx;
+    if (shape == nullptr || !ort_value_name_idx_map.GetIdx(input->Name(), ort_value_idx).IsOK()) {
+      continue;
+    }
+
+    for (int i = 0, end = shape->dim_size(); i < end; ++i) {
+      const auto& dim = shape->dim(i);
+      if (dim.has_dim_param()) {
+        auto entry = symbol_ids.emplace(dim.dim_param(), symbol_ids.size());
+        planner->input_symbols_[ort_value_idx].emplace_back(static_cast<size_t>(i), entry.first->second);
+      }
+    }
+  }
+  planner->num_symbols_ = symbol_ids.size();
+
+  const auto& allocation_plan = execution_plan.allocation_plan;
+  const auto& to_be_freed = execution_plan.to_be_freed;
+  for (const auto& node_plan : execution_plan.execution_plan) {
+    const auto* node = graph_viewer.GetNode(node_plan.node_index);
+    if (node == nullptr) {
+      return nullptr;
+    }
+
+    for (const auto* output : node->OutputDefs()) {
+      int ort_value_idx;
+      if (!output->Exists() || !ort_value_name_idx_map.GetIdx(output->Name(), ort_value_idx).IsOK()) {
+        continue;
+      }
+
+      // only the tensors the frame traces are part of a pattern
+      const auto& per_alloc_plan = allocation_plan[ort_value_idx];
+      if (per_alloc_plan.alloc_kind != AllocKind::kAllocate || !per_alloc_plan.value_type->IsTensorType()) {
+        continue;
+      }
+      auto element_type = static_cast<const TensorTypeBase*>(per_alloc_plan.value_type)->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) {
+        continue;
+      }
+
+      const auto* shape = output->Shape();
+      if (shape == nullptr) {
+        return nullptr;
+      }
+
+      SymbolicSize size;
+      size.element_size = element_type->Size();
+      for (const auto& dim : shape->dim()) {
+        if (dim.has_dim_value() && dim.dim_value() >= 0) {
+          size.constant_dims *= dim.dim_value();
+        } else if (dim.has_dim_param() && symbol_ids.count(dim.dim_param()) > 0) {
+          size.symbols.push_back(symbol_ids[dim.dim_param()]);
+        } else {
+          return nullptr;
+        }
+      }
+
+      planner->sizes_.emplace(ort_value_idx, std::move(size));
+      planner->steps_.push_back({ort_value_idx, true});
+    }
+
+    for (int i = node_plan.free_from_index; i <= node_plan.free_to_index; ++i) {
+      if (planner->sizes_.count(to_be_freed[i]) > 0) {
+        planner->steps_.push_back({to_be_freed[i], false});
+      }
+    }
+  }
+
+  return planner;
+}
+
+std::unique_ptr<MemoryPatternGroup> SymbolicMemPatternPlanner::GeneratePatterns(
+    const std::vector<int>& feed_mlvalue_idxs,
+    const std::vector<std::reference_wrapper<const TensorShape>>& feed_shapes,
+    int64_t shape_bucket_size) const {
+  if (feed_mlvalue_idxs.size() != feed_shapes.size()) {
+    return nullptr;
+  }
+
+  std::vector<int64_t> symbol_values(num_symbols_, -1);
+  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+    auto it = input_symbols_.find(feed_mlvalue_idxs[i]);
+    if (it == input_symbols_.end()) {
+      continue;
+    }
+
+    const auto& dims = feed_shapes[i].get().GetDims();
+    for (const auto& input_symbol : it->second) {
+      if (input_symbol.first >= dims.size()) {
+        return nullptr;
+      }
+
+      int64_t value = dims[input_symbol.first];
+      if (value > 0) {
+        value = (value + shape_bucket_size - 1) / shape_bucket_size * shape_bucket_size;
+      }
+
+      auto& bound_value = symbol_values[input_symbol.second];
+      if (bound_value >= 0 && bound_value != value) {
+        return nullptr;
+      }
+      bound_value = value;
+    }
+  }
+
+  for (auto value : symbol_values) {
+    if (value < 0) {
+      return nullptr;
+    }
+  }
+
+  OrtValuePatternPlanner planner(execution_plan_);
+  for (const auto& step : steps_) {
+    if (!step.allocate) {
+      if (!planner.TraceFree(step.ort_value_idx).IsOK()) {
+        return nullptr;
+      }
+      continue;
+    }
+
+    const auto& size = sizes_.at(step.ort_value_idx);
+    size_t num_elements = static_cast<size_t>(size.constant_dims);
+    for (auto symbol : size.symbols) {
+      auto value = static_cast<size_t>(symbol_values[symbol]);
+      if (value != 0 && num_elements > std::numeric_limits<size_t>::max() / value) {
+        return nullptr;
+      }
+      num_elements *= value;
+    }
+
+    size_t bytes;
+    if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(num_elements, size.element_size, &bytes) ||
+        !planner.TraceAllocation(step.ort_value_idx, bytes).IsOK()) {
+      return nullptr;
+    }
+  }
+
+  auto patterns = std::make_unique<MemoryPatternGroup>();
+  if (!planner.GeneratePatterns(patterns.get()).IsOK()) {
+    return nullptr;
+  }
+  return patterns;
+}
+
+}  // namespace onnxruntime
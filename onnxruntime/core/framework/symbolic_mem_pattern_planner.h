@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+class GraphViewer;
+
+// SymbolicMemPatternPlanner builds memory patterns at session initialization instead of tracing a run.
+// The size of every tensor the execution plan allocates is recorded in terms of the symbolic dims (dim_param)
+// of the graph inputs. For a request the symbols are bound from the feed shapes and the allocation/free steps
+// of the plan are replayed through the pattern planner, so no run is needed to get a pattern for a new shape.
+// Thread-safe, as it is const after the construction.
+class SymbolicMemPatternPlanner {
+ public:
+  // Returns nullptr if a tensor allocated by the plan has a shape that can't be expressed with
+  // the dims of the graph inputs, e.g. because shape inference didn't produce it or it is data dependent.
+  static std::unique_ptr<SymbolicMemPatternPlanner> Create(const GraphViewer& graph_viewer,
+                                                           const SequentialExecutionPlan& execution_plan,
+                                                           const OrtValueNameIdxMap& ort_value_name_idx_map);
+
+  // Plan the memory patterns for the given feeds. Symbolic dims are rounded up to a multiple of
+  // shape_bucket_size so the patterns fit every input in the same memory pattern cache bucket.
+  // Returns nullptr if the feeds don't bind every symbol, or bind one to different values.
+  std::unique_ptr<MemoryPatternGroup> GeneratePatterns(
+      const std::vector<int>& feed_mlvalue_idxs,
+      const std::vector<std::reference_wrapper<const TensorShape>>& feed_shapes,
+      int64_t shape_bucket_size) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicMemPatternPlanner);
+
+ private:
+  explicit SymbolicMemPatternPlanner(const SequentialExecutionPlan& execution_plan)
+      : execution_plan_{execution_plan} {}
+
+  // number of elements is constant_dims times the product of the listed symbols
+  struct SymbolicSize {
+    size_t element_size{0};
+    int64_t constant_dims{1};
+    std::vector<size_t> symbols;
+  };
+
+  struct Step {
+    int ort_value_idx;
+    bool allocate;
+  };
+
+  const SequentialExecutionPlan& execution_plan_;
+  size_t num_symbols_{0};
+  // graph input ort_value_idx -> (dim index, symbol) for its symbolic dims
+  std::unordered_map<int, std::vector<std::pair<size_t, size_t>>> input_symbols_;
+  std::unordered_map<int, SymbolicSize> sizes_;
+  // allocations and frees in the order the sequential executor makes them
+  std::vector<Step> steps_;
+};
+}  // namespace onnxruntime
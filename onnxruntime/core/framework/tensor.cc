@@ -53,7 +53,9 @@ Tensor::Tensor(Tensor&& other) noexcept
       shape_(other.shape_),
       dtype_(other.dtype_),
       alloc_info_(other.alloc_info_),
-      byte_offset_(other.byte_offset_) {
+      byte_offset_(other.byte_offset_),
+      strides_(std::move(other.strides_)) {
+  other.strides_.clear();
   other.dtype_ = DataTypeImpl::GetType<float>();
   other.shape_ = TensorShape(vector<int64_t>(1, 0));
   other.p_data_ = nullptr;
@@ -71,7 +73,9 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
     byte_offset_ = other.byte_offset_;
     p_data_ = other.p_data_;
     buffer_deleter_ = other.buffer_deleter_;
+    strides_ = std::move(other.strides_);
 
+    other.strides_.clear();
     other.dtype_ = DataTypeImpl::GetType<float>();
     other.shape_ = TensorShape(vector<int64_t>(1, 0));
     other.p_data_ = nullptr;
@@ -81,6 +85,39 @@ Tensor& Tensor::operator=(Tensor&& other) noexcept {
   return *this;
 }
 
+std::vector<int64_t> Tensor::Strides() const {
+  if (!strides_.empty()) {
+    return strides_;
+  }
+
+  std::vector<int64_t> strides(shape_.NumDimensions());
+  int64_t stride = 1;
+  for (size_t axis = strides.size(); axis-- > 0;) {
+    strides[axis] = stride;
+    stride *= shape_[axis];
+  }
+  return strides;
+}
+
+void Tensor::SetShapeAndStrides(const TensorShape& new_shape, const std::vector<int64_t>& strides) {
+  ORT_ENFORCE(strides.size() == new_shape.NumDimensions(), "Strides must have an entry for each axis");
+  shape_ = new_shape;
+  strides_.clear();
+
+  // the stride of an axis of size 1 doesn't matter, and an empty tensor has no elements to lay out
+  if (shape_.Size() == 0) {
+    return;
+  }
+
+  const auto row_major = Strides();
+  for (size_t axis = 0; axis < strides.size(); ++axis) {
+    if (shape_[axis] != 1 && strides[axis] != row_major[axis]) {
+      strides_ = strides;
+      return;
+    }
+  }
+}
+
 Tensor::~Tensor() {
   ReleaseBuffer();
 }
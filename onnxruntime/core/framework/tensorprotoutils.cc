@@ -360,6 +360,25 @@ static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   from.param = nullptr;
 }
 
+static bool CanMapExternalData(const DataTypeImpl& element_type, const ExternalDataInfo& external_data_info) {
+  // a length of 0 means the rest of the file, which would have to be opened to know the size to map
+  return IsLittleEndianOrder() && external_data_info.GetLength() > 0 &&
+         external_data_info.GetOffset() % static_cast<int64_t>(element_type.Size()) == 0;
+}
+
+bool CanUseMappedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return false;
+  }
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    return false;
+  }
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  return CanMapExternalData(*type, *external_data_info);
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, OrtValue& value,
                             OrtCallback& deleter) {
@@ -389,9 +408,20 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       raw_data_len = external_data_info->GetLength();
       // load the file
       {
-        void* file_data;
-        ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), external_data_info->GetOffset(),
-                                                 file_data, raw_data_len, deleter_for_file_data.d));
+        void* file_data = nullptr;
+        // no buffer was allocated for the tensor, so map the data rather than read a copy of it
+        if (m.GetBuffer() == nullptr && CanMapExternalData(*type, *external_data_info)) {
+          Status st = env.MapFileIntoMemory(full_path.c_str(), external_data_info->GetOffset(), raw_data_len,
+                                            file_data, deleter_for_file_data.d);
+          if (!st.IsOK()) {
+            LOGS_DEFAULT(WARNING) << "Reading external data instead of mapping it. " << st.ErrorMessage();
+            file_data = nullptr;
+          }
+        }
+        if (file_data == nullptr) {
+          ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), external_data_info->GetOffset(),
+                                                   file_data, raw_data_len, deleter_for_file_data.d));
+        }
         raw_data = file_data;
       }
     } else if (utils::HasRawData(tensor_proto)) {
@@ -400,7 +430,9 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       raw_data = tensor_proto.raw_data().data();
       raw_data_len = tensor_proto.raw_data().size();
     }
-    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr) {
+    // the file data is used in place unless there's a buffer to deserialize into
+    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr &&
+        m.GetBuffer() == nullptr) {
       tensor_data = const_cast<void*>(raw_data);
       MoveOrtCallback(deleter_for_file_data.d, deleter);
     } else {
@@ -27,6 +27,8 @@ namespace utils {
 TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShapeProto& tensor_shape_proto);
 /**
  * deserialize a TensorProto into a preallocated memory buffer.
+ * If the buffer of m is null, data in an external file is used in place from the file instead, which is mapped
+ * into memory if CanUseMappedExternalData is true for the tensor.
  * \param tensor_proto_path A local file path of where the 'input' was loaded from. Can be NULL if the tensor proto doesn't
  *                        have any external data or it was loaded from current working dir. This path could be either a
  *                        relative path or an absolute path.
@@ -34,6 +36,15 @@ TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShape
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
+
+/**
+ * Returns true if the data of tensor_proto is in an external file and can be used in place from a memory mapping
+ * of the file, i.e. the platform is little-endian and the data's offset is aligned for the element type.
+ * TensorProtoToMLValue maps such a tensor instead of copying it if it's given a MemBuffer without a buffer,
+ * so no memory needs to be allocated for it.
+ */
+bool CanUseMappedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/termination_check.h"
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+TerminationCheck TerminationCheck::ForRun(const RunOptions& run_options) {
+  if (run_options.run_timeout_ms <= 0) {
+    return TerminationCheck(run_options.terminate);
+  }
+
+  return TerminationCheck(run_options.terminate, Clock::now() + std::chrono::milliseconds(run_options.run_timeout_ms));
+}
+
+const TerminationCheck& TerminationCheck::Never() {
+  static const bool never_terminate = false;
+  static const TerminationCheck never{never_terminate};
+  return never;
+}
+
+common::Status TerminationCheck::Check() const {
+  if (terminate_flag_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+
+  // reading the clock is skipped for the common case of a run without a deadline
+  if (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting as the run timeout has been exceeded.");
+  }
+
+  return common::Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include "core/common/status.h"
+#include "core/framework/run_options.h"
+
+namespace onnxruntime {
+
+/**
+ * Tells the executors of a run whether they have to stop before running the next node: either the terminate flag
+ * of the run's RunOptions was set, possibly from another thread, or the run's deadline has passed.
+ * It's handed down to the executors of control flow subgraphs, so a long running Loop or Scan stops as well.
+ */
+class TerminationCheck {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TerminationCheck(const bool& terminate_flag, Clock::time_point deadline = Clock::time_point::max())
+      : terminate_flag_{terminate_flag}, deadline_{deadline} {}
+
+  // The check for a run using run_options. Its deadline, if any, is counted from now.
+  static TerminationCheck ForRun(const RunOptions& run_options);
+
+  // A check that never stops execution, for executors that aren't created for a Run call.
+  static const TerminationCheck& Never();
+
+  // Returns a failed status explaining why execution must stop, or OK to keep going.
+  common::Status Check() const;
+
+ private:
+  const bool& terminate_flag_;
+  Clock::time_point deadline_;
+};
+}  // namespace onnxruntime
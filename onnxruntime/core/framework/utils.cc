@@ -4,12 +4,14 @@
 #include "core/framework/utils.h"
 
 #include <iomanip>
+#include <sstream>
 
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/kernel_cost.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -17,6 +19,7 @@
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/perf_counters.h"
 
 namespace onnxruntime {
 namespace utils {
@@ -302,7 +305,8 @@ void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
 static void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
                                       FeedsFetchesManager& feeds_fetches_manager,
                                       const std::vector<OrtValue>& feeds,
-                                      std::vector<OrtValue>& fetches) {
+                                      std::vector<OrtValue>& fetches,
+                                      const std::vector<const OrtMemoryInfo*>* fetch_locations) {
   if (feeds_fetches_manager.GetDeviceCopyChecks().status == DeviceCopyCheck::NoCopy)
     return;
 
@@ -326,6 +330,8 @@ static void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
     const auto& fetch = fetches[i];
     if (fetch.IsAllocated() && fetch.IsTensor()) {
       fetch_alloc_info[i] = &fetch.Get<Tensor>().Location();
+    } else if (fetch_locations != nullptr && !fetch.IsAllocated()) {
+      fetch_alloc_info[i] = (*fetch_locations)[i];
     }
   }
 
@@ -382,29 +388,22 @@ static common::Status CopyOutputsAcrossDevices(const SessionState& session_state
   return Status::OK();
 }
 
-static common::Status ExecuteGraphImpl(const SessionState& session_state,
-                                       const FeedsFetchesManager& feeds_fetches_manager,
-                                       const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                                       bool sequential_execution, const bool& terminate_flag,
-                                       const logging::Logger& logger) {
-  std::unique_ptr<IExecutor> p_exec;
-  if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
-  } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
-  }
-
+static common::Status ExecuteGraphWithExecutor(IExecutor& executor, const SessionState& session_state,
+                                               const FeedsFetchesManager& feeds_fetches_manager,
+                                               const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                               const std::unordered_map<size_t, IExecutor::CustomAllocator>&
+                                                   fetch_allocators,
+                                               RunTrace* run_trace, const logging::Logger& logger) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   const auto& device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 
   // see if we can skip copies due to the types of execution providers available
   if (device_copy_checks.status == DeviceCopyCheck::NoCopy) {
     // no device copies are needed so simple execute
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(executor.Execute(session_state,
+                                         feeds_fetches_info.feeds_mlvalue_idxs, feeds,
+                                         feeds_fetches_info.fetches_mlvalue_idxs, fetches, fetch_allocators,
+                                         logger));
   } else {
     const std::vector<OrtValue>* p_feeds = &feeds;
     std::vector<OrtValue>* p_fetches = &fetches;
@@ -413,8 +412,11 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
 
     if (device_copy_checks.input_copy_needed == DeviceCopyCheck::Copy) {
       const auto& feed_copy_info = feeds_fetches_manager.GetFeedsDeviceCopyInfo();
+      RunTraceSpan copy_span;
+      copy_span.Begin(run_trace, ORT_RUN_TRACE_SPAN_FEED_COPY, "feed_copy");
       ORT_RETURN_IF_ERROR(CopyInputsAcrossDevices(feeds, device_feeds, feed_copy_info,
                                                   session_state.GetDataTransferMgr()));
+      copy_span.End(Status::OK());
       p_feeds = &device_feeds;
     }
 
@@ -437,44 +439,172 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
       p_fetches = &device_fetches;
     }
 
-    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state,
-                                        feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
-                                        feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
-                                        logger));
+    ORT_RETURN_IF_ERROR(executor.Execute(session_state,
+                                         feeds_fetches_info.feeds_mlvalue_idxs, *p_feeds,
+                                         feeds_fetches_info.fetches_mlvalue_idxs, *p_fetches, fetch_allocators,
+                                         logger));
 
     if (device_copy_checks.output_copy_needed == DeviceCopyCheck::Copy) {
+      RunTraceSpan copy_span;
+      copy_span.Begin(run_trace, ORT_RUN_TRACE_SPAN_FETCH_COPY, "fetch_copy");
       ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, fetch_copy_info));
+      copy_span.End(Status::OK());
     }
   }
 
   return Status::OK();
 }
 
+static common::Status ExecuteGraphImpl(const SessionState& session_state,
+                                       const FeedsFetchesManager& feeds_fetches_manager,
+                                       const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                       bool sequential_execution, const TerminationCheck& termination_check,
+                                       RunTrace* run_trace, const logging::Logger& logger) {
+  // the executor is created for every call, which for a subgraph is every iteration of a Loop or Scan, so keep it
+  // off the heap. the FeedsFetchesManager and the memory patterns are cached by the caller and the SessionState.
+  if (sequential_execution) {
+    SequentialExecutor executor(termination_check, run_trace);
+    return ExecuteGraphWithExecutor(executor, session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                    run_trace, logger);
+  }
+
+  ParallelExecutor executor(session_state, termination_check, run_trace);
+  return ExecuteGraphWithExecutor(executor, session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                  run_trace, logger);
+}
+
 common::Status ExecuteGraph(const SessionState& session_state,
                             FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                            bool sequential_execution, const bool& terminate_flag,
-                            const logging::Logger& logger) {
+                            bool sequential_execution, const TerminationCheck& termination_check,
+                            RunTrace* run_trace, const logging::Logger& logger,
+                            const std::vector<const OrtMemoryInfo*>* fetch_locations) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
-  FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches);
+  FinalizeFeedFetchCopyInfo(session_state, feeds_fetches_manager, feeds, fetches, fetch_locations);
 
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
-                                 sequential_execution, terminate_flag, logger);
+                                 sequential_execution, termination_check, run_trace, logger);
 
   return status;
 }
 
+common::Status ExecuteFinalizedGraph(const SessionState& session_state,
+                                     const FeedsFetchesManager& feeds_fetches_manager,
+                                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                     bool sequential_execution, const TerminationCheck& termination_check,
+                                     RunTrace* run_trace, const logging::Logger& logger) {
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+                          sequential_execution, termination_check, run_trace, logger);
+}
+
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger) {
+                               bool sequential_execution, const TerminationCheck& termination_check,
+                               const logging::Logger& logger) {
   auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 sequential_execution, terminate_flag, logger);
+                                 sequential_execution, termination_check, nullptr, logger);
   return status;
 }
 
+int64_t GetOutputTensorBytes(OpKernelContextInternal& context) {
+  int64_t bytes = 0;
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const OrtValue* value = context.GetOutputMLValue(i);
+    if (value != nullptr && value->IsAllocated() && value->IsTensor()) {
+      bytes += static_cast<int64_t>(value->Get<Tensor>().SizeInBytes());
+    }
+  }
+  return bytes;
+}
+
+// Bytes read from memory for each last level cache miss
+static constexpr int64_t kCacheLineBytes = 64;
+
+// The types and shapes of the inputs of a computation, separated by ';' with "-" for a missing or non-tensor input,
+// e.g. "tensor(float);tensor(int64)" and "[1,3,224,224];[2]", which are enough to replay the node on its own.
+static void GetInputTypesAndShapes(const OpKernel& kernel, const OpKernelContextInternal& context,
+                                   std::string& types, std::string& shapes) {
+  const auto& input_defs = kernel.Node().InputDefs();
+  std::ostringstream types_stream;
+  std::ostringstream shapes_stream;
+  for (int i = 0, end = context.InputCount(); i < end; ++i) {
+    if (i > 0) {
+      types_stream << ';';
+      shapes_stream << ';';
+    }
+    const OrtValue* value = context.GetInputMLValue(i);
+    const std::string* type = static_cast<size_t>(i) < input_defs.size() ? input_defs[i]->Type() : nullptr;
+    if (value == nullptr || !value->IsAllocated() || !value->IsTensor() || type == nullptr) {
+      types_stream << '-';
+      shapes_stream << '-';
+      continue;
+    }
+    types_stream << *type;
+    shapes_stream << '[';
+    const auto& dims = value->Get<Tensor>().Shape().GetDims();
+    for (size_t d = 0; d < dims.size(); ++d) {
+      shapes_stream << (d > 0 ? "," : "") << dims[d];
+    }
+    shapes_stream << ']';
+  }
+  types = types_stream.str();
+  shapes = shapes_stream.str();
+}
+
+void RecordKernelComputeEvent(const SessionState& session_state, const OpKernel& kernel,
+                              OpKernelContextInternal& context, TimePoint& kernel_begin_time,
+                              const PerfCounterValues* counters_before) {
+  auto& profiler = session_state.Profiler();
+  const std::string event_name = kernel.Node().Name() + "_kernel_time";
+  PerfCounterValues counters_after;
+  const bool has_counters = counters_before != nullptr && ReadThreadPerfCounters(counters_after);
+  std::string input_types;
+  std::string input_shapes;
+  GetInputTypesAndShapes(kernel, context, input_types, input_shapes);
+  if (!has_counters) {
+    profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT, event_name, kernel_begin_time,
+                                   {{"op_name", kernel.KernelDef().OpName()},
+                                    {"provider", kernel.KernelDef().Provider()},
+                                    {"input_types", input_types},
+                                    {"input_shapes", input_shapes}});
+    return;
+  }
+
+  const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::high_resolution_clock::now() - kernel_begin_time)
+                               .count();
+  const KernelCost cost = EstimateKernelCost(kernel, context);
+
+  // -1 for a counter the hardware doesn't provide
+  auto count = [](int64_t before, int64_t after) { return before < 0 || after < 0 ? -1 : after - before; };
+  const int64_t llc_misses = count(counters_before->llc_misses, counters_after.llc_misses);
+  // amount per nanosecond is giga-amount per second
+  auto rate = [nanoseconds](int64_t amount) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3) << (nanoseconds > 0 ? static_cast<double>(amount) / nanoseconds : 0.0);
+    return ss.str();
+  };
+
+  profiler.EndTimeAndRecordEvent(
+      profiling::NODE_EVENT, event_name, kernel_begin_time,
+      {{"op_name", kernel.KernelDef().OpName()},
+       {"provider", kernel.KernelDef().Provider()},
+       {"input_types", input_types},
+       {"input_shapes", input_shapes},
+       {"cycles", std::to_string(count(counters_before->cycles, counters_after.cycles))},
+       {"instructions", std::to_string(count(counters_before->instructions, counters_after.instructions))},
+       {"llc_misses", std::to_string(llc_misses)},
+       {"memory_bytes", std::to_string(llc_misses < 0 ? -1 : llc_misses * kCacheLineBytes)},
+       {"flops", std::to_string(cost.flops)},
+       {"tensor_bytes", std::to_string(cost.bytes)},
+       {"gflops_per_sec", rate(cost.flops)},
+       {"gbytes_per_sec", rate(cost.bytes)}});
+}
+
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 std::ostream& operator<<(std::ostream& out, const BFloat16& value) {
   return out << value.ToFloat();
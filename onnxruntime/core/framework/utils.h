@@ -20,7 +20,12 @@ class KernelDef;
 class KernelRegistryManager;
 class IExecutionProvider;
 class Node;
+class OpKernel;
+class OpKernelContextInternal;
+struct PerfCounterValues;
+class RunTrace;
 class Tensor;
+class TerminationCheck;
 
 namespace logging {
 class Logger;
@@ -58,16 +63,46 @@ void FinalizeFeedFetchCopyInfo(const SessionState& session_state,
                                const std::vector<const OrtMemoryInfo*>& fetch_alloc_info);
 
 // Execute the main graph. The feed_fetches_manager will be finalized based on the provided feeds and fetches.
+// fetch_locations optionally provides the location for each fetch that is not pre-allocated. Those are returned
+// on CPU otherwise. run_trace, if not null, receives the compute time of each node of the main graph if it records
+// nodes, and the spans of the copies of the feeds and fetches across devices and of the nodes if it has a hook.
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
-                            bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
+                            bool sequential_execution, const TerminationCheck& termination_check,
+                            RunTrace* run_trace, const logging::Logger& logger,
+                            const std::vector<const OrtMemoryInfo*>* fetch_locations = nullptr);
+
+// Execute the main graph with a feeds_fetches_manager that was already finalized for the locations of the provided
+// feeds and fetches, so that repeated runs of the same inputs and outputs skip that setup.
+common::Status ExecuteFinalizedGraph(const SessionState& session_state,
+                                     const FeedsFetchesManager& feeds_fetches_manager,
+                                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                     bool sequential_execution, const TerminationCheck& termination_check,
+                                     RunTrace* run_trace, const logging::Logger& logger);
 
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
-                               bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
+                               bool sequential_execution, const TerminationCheck& termination_check,
+                               const logging::Logger& logger);
+
+// Whether node is a MemcpyFromHost or MemcpyToHost node inserted to copy values between devices.
+inline bool IsMemcpyNode(const Node& node) {
+  return node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost";
+}
+
+// Total bytes of the output tensors of a node that was computed with context, which the node counters record.
+int64_t GetOutputTensorBytes(OpKernelContextInternal& context);
+
+// Record the profiler event of a computation of kernel with context that started at kernel_begin_time, with the
+// types and shapes of its inputs. If counters_before holds the hardware counters of the thread from before the
+// computation, the event also has the counts of the computation, the bytes it moved from memory according to the
+// last level cache misses, and the rates of operations and bytes it achieved according to EstimateKernelCost.
+void RecordKernelComputeEvent(const SessionState& session_state, const OpKernel& kernel,
+                              OpKernelContextInternal& context, TimePoint& kernel_begin_time,
+                              const PerfCounterValues* counters_before);
 
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 // to create a build with these enabled run the build script with
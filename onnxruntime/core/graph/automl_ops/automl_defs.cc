@@ -41,6 +41,44 @@ void RegisterAutoMLSchemas() {
           "Constrain output type to an AutoML specific Microsoft::Featurizers::TimePoint type"
           "currently not part of ONNX standard. When it becomes a part of the standard we will adjust this"
           "kernel definition and move it to ONNX repo");
+
+  static const char* DateTimeTransformerBatch_ver1_doc = R"DOC(
+    DateTimeTransformerBatch accepts an int64 tensor of any shape holding numbers of seconds since
+    the epoch (UTC) and splits every element into its date and time components in a single pass.
+    Each component is returned as a separate tensor with the same shape as the input, so the
+    result can be consumed column-wise without going through the opaque TimePoint type.
+    Timestamps before 1970 are supported.
+  )DOC";
+
+  MS_AUTOML_OPERATOR_SCHEMA(DateTimeTransformerBatch)
+      .SinceVersion(1)
+      .SetDomain(kMSAutoMLDomain)
+      .SetDoc(DateTimeTransformerBatch_ver1_doc)
+      .Input(0, "X", "Number of seconds passed since the epoch for each element.", "T1")
+      .Output(0, "year", "Year of each element.", "T2")
+      .Output(1, "month", "Month of each element, 1-12.", "T3")
+      .Output(2, "day", "Day of the month of each element, 1-31.", "T3")
+      .Output(3, "hour", "Hour of each element, 0-23.", "T3")
+      .Output(4, "minute", "Minute of each element, 0-59.", "T3")
+      .Output(5, "second", "Second of each element, 0-59.", "T3")
+      .Output(6, "dayOfWeek", "Day of the week of each element, 0-6 starting with Sunday.", "T3")
+      .Output(7, "dayOfYear", "Zero based day of the year of each element, 0-365.", "T4")
+      .Output(8, "quarterOfYear", "Quarter of the year of each element, 1-4.", "T3")
+      .Output(9, "weekOfMonth", "Zero based week of the month of each element, 0-4.", "T3")
+      .TypeConstraint("T1", {"tensor(int64)"}, "Constrain input type to int64 tensor.")
+      .TypeConstraint("T2", {"tensor(int32)"}, "Constrain year output to int32 tensor.")
+      .TypeConstraint("T3", {"tensor(uint8)"}, "Constrain small component outputs to uint8 tensor.")
+      .TypeConstraint("T4", {"tensor(uint16)"}, "Constrain dayOfYear output to uint16 tensor.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        using ONNX_NAMESPACE::TensorProto;
+        for (size_t i = 0; i < ctx.getNumOutputs(); ++i) {
+          const auto elem_type = i == 0 ? TensorProto::INT32 : i == 7 ? TensorProto::UINT16 : TensorProto::UINT8;
+          ONNX_NAMESPACE::updateOutputElemType(ctx, i, elem_type);
+          if (ONNX_NAMESPACE::hasInputShape(ctx, 0)) {
+            ONNX_NAMESPACE::propagateShapeFromInputToOutput(ctx, 0, i);
+          }
+        }
+      });
 }
 }  // namespace automl
 }  // namespace onnxruntime
@@ -189,6 +189,54 @@ void RegisterNchwcSchemas() {
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
       .FillUsing(NchwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "scales",
+          "",
+          AttributeProto::INTS)
+      .Attr(
+          "mode",
+          "",
+          AttributeProto::STRING,
+          std::string("nearest"))
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("tensor must have rank 4");
+        }
+
+        std::vector<int64_t> scales;
+        auto* scales_attr = ctx.getAttribute("scales");
+        if (scales_attr != nullptr) {
+          scales.assign(scales_attr->ints().begin(), scales_attr->ints().end());
+        }
+        if (scales.size() != 2 || scales[0] <= 0 || scales[1] <= 0) {
+          fail_shape_inference("invalid scales attribute");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        *output_shape->add_dim() = input_shape.dim(1);
+        for (int i = 0; i < 2; i++) {
+          auto& input_dim = input_shape.dim(2 + i);
+          auto* output_dim = output_shape->add_dim();
+          if (input_dim.has_dim_value()) {
+            output_dim->set_dim_value(input_dim.dim_value() * scales[i]);
+          }
+        }
+      });
 }
 
 void RegisterContribSchemas() {
@@ -1309,6 +1357,70 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         matmulShapeInference(ctx, 0, 1);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product of a float matrix A and a quantized matrix B that behaves like numpy.matmul.
+A is quantized to uint8 at runtime from the range of its values, the product is computed with
+integer arithmetic, and the result is dequantized with the scale of A and the scales of B.
+The optional bias is added to each row of the result.)DOC")
+      .Input(0, "A", "N-dimensional matrix A", "T1")
+      .Input(1, "B", "2-dimensional quantized matrix B", "T2")
+      .Input(2, "b_scale", "Scale of B. Scalar or 1-D tensor with a value for each column of B.", "T1")
+      .Input(3, "b_zero_point",
+             "Zero point of B. Scalar or 1-D tensor with a value for each column of B. Default is 0.",
+             "T2", OpSchema::Optional)
+      .Input(4, "bias", "1-D bias with a value for each column of B.", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, scales, bias and output Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain input B to 8-bit integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        matmulShapeInference(ctx, 0, 1);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBits)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product of a float matrix A and a matrix B of K x N weights quantized to 4 or 8 bits, that behaves
+like numpy.matmul with a 2-D B. The weights of each column of B are quantized in blocks of block_size rows,
+each block with its own scale, and are dequantized on the fly with float accumulation.
+B holds the weights of each column, then of each block, with block_size * bits / 8 bytes for each block.
+Each weight is stored offset by 2^(bits-1) as an unsigned value, so a stored value q and the scale s of its
+block represent (q - 2^(bits-1)) * s. Two 4-bit weights of consecutive rows share a byte, the first in the
+low nibble. The optional bias is added to each row of the result.)DOC")
+      .Attr("K", "Number of rows of B, which is the last dimension of A.", AttributeProto::INT)
+      .Attr("N", "Number of columns of B.", AttributeProto::INT)
+      .Attr("bits", "Number of bits of a quantized weight, 4 or 8.", AttributeProto::INT)
+      .Attr("block_size", "Number of rows of B in a quantization block, a power of 2 and at least 16.",
+            AttributeProto::INT)
+      .Input(0, "A", "N-dimensional matrix A", "T1")
+      .Input(1, "B", "Quantized weights of B with N * ceil(K / block_size) * block_size * bits / 8 bytes", "T2")
+      .Input(2, "scales", "Scales of B with N * ceil(K / block_size) values, ordered by column then by block", "T1")
+      .Input(3, "bias", "1-D bias with a value for each column of B.", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, scales, bias and output Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain input B to uint8 tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        auto& a_shape = getInputShape(ctx, 0);
+        if (a_shape.dim_size() == 0) {
+          fail_shape_inference("A must have at least one dimension");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < a_shape.dim_size() - 1; i++) {
+          *output_shape->add_dim() = a_shape.dim(i);
+        }
+        output_shape->add_dim()->set_dim_value(getAttribute(ctx, "N", 0));
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReduceSumInteger)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1739,6 +1851,244 @@ Example 4:
         a fixed size = [crop_height, crop_width]. The result is a 4-D tensor [num_boxes, crop_height, crop_width, depth].
         The resizing is corner aligned.)DOC");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(LayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Normalizes the input over the dimensions starting at axis to zero mean and unit variance,
+then applies the elementwise affine transform Y = (X - mean) / sqrt(variance + epsilon) * Scale + B.
+Scale and B have the shape of the normalized dimensions.)DOC")
+      .Attr("axis",
+            "The first normalization dimension. Negative values count from the back.",
+            AttributeProto::INT,
+            static_cast<int64_t>(-1))
+      .Attr("epsilon",
+            "The epsilon value added to the variance to avoid division by zero.",
+            AttributeProto::FLOAT,
+            1e-5f)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Input(1, "Scale", "Scale tensor with the shape of the normalized dimensions.", "T")
+      .Input(2, "B", "Bias tensor with the shape of the normalized dimensions.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output data tensor with the shape of X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Gelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Gaussian error linear unit, Y = 0.5 * X * (1 + erf(X / sqrt(2))), applied elementwise.)DOC")
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Applies a chain of elementwise ops to X, in the order of the ops attribute. Each binary op takes the next of the
+operands, which broadcast to the shape of X: Add, Sub, Mul and Div compute value op operand, and RSub and RDiv
+compute operand - value and operand / value. The unary ops are Relu, Sigmoid, Tanh, Neg, Abs, Exp, Log, Sqrt,
+Reciprocal and Erf.)DOC")
+      .Attr("ops",
+            "The ops of the chain.",
+            AttributeProto::STRINGS)
+      .Input(0, "X", "Input data tensor, followed by one operand per binary op.", "T", OpSchema::Variadic)
+      .Output(0, "Y", "Output data tensor with the shape of X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ScaledDotProductAttention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Scaled dot product attention, Y = Softmax(scale * Q * K + mask) * V, where the softmax is
+computed over the last dimension. The key tensor is supplied already transposed. The batch
+dimensions of Q, K and V broadcast like numpy.matmul, and the mask broadcasts to the shape
+of the attention scores [..., S, L].)DOC")
+      .Attr("scale",
+            "The scale applied to the attention scores.",
+            AttributeProto::FLOAT,
+            1.0f)
+      .Input(0, "Q", "Query tensor with shape [..., S, D].", "T")
+      .Input(1, "K", "Transposed key tensor with shape [..., D, L].", "T")
+      .Input(2, "V", "Value tensor with shape [..., L, Dv].", "T")
+      .Input(3, "mask", "Additive mask broadcastable to the attention scores [..., S, L].", "T", OpSchema::Optional)
+      .Output(0, "Y", "Output tensor with shape [..., S, Dv].", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 3)) {
+          return;
+        }
+        const ONNX_NAMESPACE::TensorShapeProto* shapes[] = {
+            &getInputShape(ctx, 0), &getInputShape(ctx, 1), &getInputShape(ctx, 2)};
+        int batch_rank = 0;
+        for (const auto* shape : shapes) {
+          if (shape->dim_size() < 2) {
+            fail_shape_inference("Q, K and V must have at least two dimensions");
+          }
+          batch_rank = std::max(batch_rank, shape->dim_size() - 2);
+        }
+        // The batch dimensions broadcast across Q, K and V. A dimension is left unknown
+        // unless it is resolved by a dimension with a value other than one.
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        for (int i = 0; i < batch_rank; i++) {
+          auto* output_dim = output_shape.add_dim();
+          bool all_ones = true;
+          for (const auto* shape : shapes) {
+            int dim_index = i - (batch_rank - (shape->dim_size() - 2));
+            if (dim_index < 0) {
+              continue;
+            }
+            const auto& dim = shape->dim(dim_index);
+            if (dim.has_dim_value() && dim.dim_value() != 1) {
+              *output_dim = dim;
+              all_ones = false;
+              break;
+            }
+            if (!dim.has_dim_value()) {
+              all_ones = false;
+            }
+          }
+          if (all_ones) {
+            output_dim->set_dim_value(1);
+          }
+        }
+        *output_shape.add_dim() = shapes[0]->dim(shapes[0]->dim_size() - 2);
+        *output_shape.add_dim() = shapes[2]->dim(shapes[2]->dim_size() - 1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Pools bags of rows of an embedding table, Y[b] = reduce(per_sample_weights[i] * data[indices[i]]) over the
+indices i of bag b, without materializing the gathered rows. With offsets, indices is 1-D and bag b holds
+the indices [offsets[b], offsets[b + 1]), where the last bag extends to the end of indices. Without offsets,
+indices is 2-D and each row is a bag. An empty bag produces a row of zeros.)DOC")
+      .Attr("mode",
+            "The reduction of each bag, 'sum' or 'mean'.",
+            AttributeProto::STRING,
+            std::string("sum"))
+      .Input(0, "data", "Embedding table with shape [num_embeddings, embedding_dim].", "T")
+      .Input(1, "indices", "Rows of data to pool, 1-D with offsets or 2-D [num_bags, bag_size] without.", "Tind")
+      .Input(2, "offsets", "1-D non-decreasing start of each bag in indices.", "Tind", OpSchema::Optional)
+      .Input(3, "per_sample_weights", "Weights of the rows with the shape of indices.", "T", OpSchema::Optional)
+      .Output(0, "Y", "Pooled bags with shape [num_bags, embedding_dim].", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeConstraint(
+          "Tind",
+          {"tensor(int32)", "tensor(int64)"},
+          "Constrain indices and offsets to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        const bool has_offsets = ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr;
+        const size_t bags_input = has_offsets ? 2 : 1;
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, bags_input)) {
+          return;
+        }
+        const auto& data_shape = getInputShape(ctx, 0);
+        const auto& bags_shape = getInputShape(ctx, bags_input);
+        if (data_shape.dim_size() != 2) {
+          fail_shape_inference("data must have two dimensions");
+        }
+        if (bags_shape.dim_size() != (has_offsets ? 1 : 2)) {
+          fail_shape_inference("offsets must have one dimension, or indices two dimensions without offsets");
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = bags_shape.dim(0);
+        *output_shape.add_dim() = data_shape.dim(1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BeamSearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Generates sequences from prompts with beam search, running the decoder subgraph once per position. The prompt
+is fed to the decoder one token per step, after which each step keeps the num_beams best continuations of each
+batch entry. A continuation that ends with eos_token_id becomes a hypothesis scored by its sum of log
+probabilities divided by length ** length_penalty, and the best hypothesis of each batch entry is returned,
+padded with pad_token_id. With num_beams = 1 this is greedy decoding.
+
+The decoder is called with the tokens [batch_size * num_beams, 1] and the position of the tokens, followed by
+the past key and value caches of the layers, each [batch_size * num_beams, num_heads, max_length, head_size], of
+which the positions before the current one are filled. It returns the logits [batch_size * num_beams,
+vocab_size] followed by the present key and value of each layer, [batch_size * num_beams, num_heads, 1,
+head_size], which are written to the caches at the position.)DOC")
+      .Attr("decoder", "Decoder graph run for each position.", AttributeProto::GRAPH)
+      .Attr("num_beams", "Number of beams of each batch entry.", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("eos_token_id", "Token that ends a sequence.", AttributeProto::INT)
+      .Attr("pad_token_id", "Token that pads the sequences.", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("length_penalty", "Exponent of the length that normalizes the hypothesis scores.",
+            AttributeProto::FLOAT, 1.0f)
+      .Attr("num_layers", "Number of decoder layers, each with a key and a value cache.", AttributeProto::INT)
+      .Attr("num_heads", "Number of attention heads of the caches.", AttributeProto::INT)
+      .Attr("head_size", "Size of each attention head of the caches.", AttributeProto::INT)
+      .Input(0, "input_ids", "Prompts with shape [batch_size, prompt_length].", "I")
+      .Input(1, "max_length", "Length of the generated sequences, including the prompt.", "I")
+      .Output(0, "sequences", "Generated sequences with shape [batch_size, max_length].", "I")
+      .Output(1, "sequences_scores", "Scores of the generated sequences with shape [batch_size].", "T",
+              OpSchema::Optional)
+      .TypeConstraint("I", {"tensor(int64)"}, "Constrain token ids to int64 tensors.")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the scores and caches to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        const int64_t num_layers = getAttribute(ctx, "num_layers", static_cast<int64_t>(0));
+
+        // infer the decoder with the types of the feeds created by the kernel
+        auto* graph_inferencer = ctx.getGraphAttributeInferencer("decoder");
+        if (graph_inferencer != nullptr) {
+          ONNX_NAMESPACE::TypeProto int64_type;
+          int64_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto::INT64);
+          ONNX_NAMESPACE::TypeProto cache_type;
+          cache_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+
+          std::vector<const ONNX_NAMESPACE::TypeProto*> input_types{&int64_type, &int64_type};
+          input_types.insert(input_types.end(), static_cast<size_t>(2 * num_layers), &cache_type);
+          std::vector<const ONNX_NAMESPACE::TensorProto*> input_data(input_types.size(), nullptr);
+          graph_inferencer->doInferencing(input_types, input_data);
+        }
+
+        ONNX_NAMESPACE::updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT64);
+        if (ctx.getNumOutputs() > 1) {
+          ONNX_NAMESPACE::updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT);
+        }
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        const auto& input_ids_shape = getInputShape(ctx, 0);
+        if (input_ids_shape.dim_size() != 2) {
+          fail_shape_inference("input_ids must have two dimensions");
+        }
+        ONNX_NAMESPACE::TensorShapeProto sequences_shape;
+        *sequences_shape.add_dim() = input_ids_shape.dim(0);
+        sequences_shape.add_dim();
+        updateOutputShape(ctx, 0, sequences_shape);
+        if (ctx.getNumOutputs() > 1) {
+          ONNX_NAMESPACE::TensorShapeProto scores_shape;
+          *scores_shape.add_dim() = input_ids_shape.dim(0);
+          updateOutputShape(ctx, 1, scores_shape);
+        }
+      });
+
   // Register the NCHWc schemas if supported by the platform.
   if (MlasNchwcGetBlockSize() > 1) {
     RegisterNchwcSchemas();
@@ -723,6 +723,8 @@ Status Graph::VerifyNoDuplicateName() {
 
   output_args.clear();
   node_name_to_index.clear();
+  output_args.reserve(static_cast<size_t>(NumberOfNodes()));
+  node_name_to_index.reserve(static_cast<size_t>(NumberOfNodes()));
   // inputs_and_initializers: this is passed in as a parameter, since functions don't have initializers
   // but graphs have them.
 
@@ -898,7 +900,6 @@ void Graph::RemoveEdge(NodeIndex src_node_index, NodeIndex dst_node_index, int s
 GSL_SUPPRESS(es .84)  // ignoring return value from unordered_map::insert causes noisy complaint
 Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node_args_consumed) {
   const std::unordered_set<std::string>& outer_scope_node_args = resolve_context_.outer_scope_node_args;
-  std::unordered_set<Node*> inner_nodes;
 
   // recurse into subgraphs first so we can update any nodes in this graph that are used by those subgraphs
   if (!resolve_context_.nodes_with_subgraphs.empty()) {
@@ -954,8 +955,6 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
             Node& output_node = *entry->second.first;
             AddEdge(output_node.Index(), node->Index(), entry->second.second, input_slot_index);
 
-            inner_nodes.insert(&output_node);
-
             // If this Graph was built manually, remove the implicit input from the graph outputs if it is present there
             // and not explicitly listed in the ordered graph outputs (as that implies we should leave it as an output).
             // If the Graph was loaded from a GraphProto, honor the explicit graph outputs and leave as is.
@@ -992,8 +991,6 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
           // Create relationship between this node (node), and the node providing the output (output_node).
           Node& output_node = *output_arg_iter->second.first;
           AddEdge(output_node.Index(), node.Index(), output_arg_iter->second.second, input_slot_index);
-
-          inner_nodes.insert(&output_node);
         } else {
           // the value is either an input, an initializer, or coming from outer scope. we only need to take action
           // if coming from outer scope, so first check if this is a subgraph (otherwise there is no outer scope).
@@ -1089,11 +1086,15 @@ void Graph::ReverseDFSFrom(const std::vector<const Node*>& from,
 GSL_SUPPRESS(es .84)  // noisy warning about ignoring return value from insert(...)
 Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
   nodes_in_topological_order_.clear();
+  nodes_in_topological_order_.reserve(static_cast<size_t>(NumberOfNodes()));
+  // the state of each node is kept in flat arrays indexed by NodeIndex rather than hash sets, as this is
+  // run on every Resolve and dominates it for large graphs.
   // nodes that have been processed and added to nodes_in_topological_order.
-  std::unordered_set<NodeIndex> processed_nodes;
-  std::unordered_set<NodeIndex> output_nodes;
-  std::unordered_set<NodeIndex> nodes_added_for_processing;
-  std::stack<NodeIndex> stack;
+  std::vector<bool> processed_nodes(MaxNodeIndex(), false);
+  // nodes on the current path from a leaf node, used to detect cycles.
+  std::vector<bool> output_nodes(MaxNodeIndex(), false);
+  std::vector<bool> nodes_added_for_processing(MaxNodeIndex(), false);
+  std::stack<NodeIndex, std::vector<NodeIndex>> stack;
 
   // push the top level nodes into nodes_in_topological_order in the order they were added
   // to ensure that is consistent.
@@ -1105,7 +1106,7 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
                   // find the top level nodes in the graph.
                   // need to also consider nodes that only have Constants as inputs as top level nodes,
                   // as the constant will get replaced by an initializer.
-                  auto input_edges = node.GetRelationships().input_edges;
+                  const auto& input_edges = node.GetRelationships().input_edges;
                   auto has_inputs = std::any_of(input_edges.cbegin(), input_edges.cend(), [](const Node::EdgeEnd& edge) {
                     return edge.GetNode().OpType() != kConstant;
                   });
@@ -1113,10 +1114,10 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
                   if (!has_inputs) {
                     // add to the topological list, and ensure we skip these nodes when walking the graph
                     nodes_in_topological_order_.push_back(index);
-                    processed_nodes.insert(index);
+                    processed_nodes[index] = true;
 
                     // mark this as added as we've fully processed it and don't need to do it again later
-                    nodes_added_for_processing.insert(index);
+                    nodes_added_for_processing[index] = true;
                   }
                 });
 
@@ -1132,16 +1133,16 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
     const NodeIndex current = stack.top();
     stack.pop();
 
-    if (processed_nodes.find(current) != processed_nodes.end()) {
+    if (processed_nodes[current]) {
       continue;
     }
 
-    if (nodes_added_for_processing.find(current) != nodes_added_for_processing.end()) {
+    if (nodes_added_for_processing[current]) {
       // we popped the stack and are back to a node that was added previously,
       // so we know all the upstream nodes from it have been fully processed,
       nodes_in_topological_order_.push_back(current);
-      processed_nodes.insert(current);
-      output_nodes.erase(current);
+      processed_nodes[current] = true;
+      output_nodes[current] = false;
       continue;
     }
 
@@ -1151,22 +1152,22 @@ Status Graph::PerformTopologicalSortAndCheckIsAcyclic() {
     }
 
     stack.push(current);
-    output_nodes.insert(current);
+    output_nodes[current] = true;
 
     for (auto iter = node->InputNodesBegin(); iter != node->InputNodesEnd(); ++iter) {
       const NodeIndex idx = (*iter).Index();
-      if (output_nodes.find(idx) != output_nodes.end()) {
+      if (output_nodes[idx]) {
         Status status(ONNXRUNTIME, FAIL, "This is an invalid model. Error: the graph is not acyclic.");
         return status;
       }
 
       // avoid re-processing nodes
-      if (nodes_added_for_processing.find(idx) == nodes_added_for_processing.end()) {
+      if (!nodes_added_for_processing[idx]) {
         stack.push(idx);
       }
     }
 
-    nodes_added_for_processing.insert(current);
+    nodes_added_for_processing[current] = true;
   }
 
   if (num_of_nodes_ >= 0 && static_cast<size_t>(num_of_nodes_) == nodes_in_topological_order_.size()) {
@@ -1646,34 +1647,96 @@ common::Status Graph::TypeCheckInputsAndInitializers() {
   return Status::OK();
 }
 
+// Returns a string that changes whenever something that the type and shape inferencing of the
+// node depends on changes: the input types and shapes, the values of small initializer inputs
+// (which some ops read as shape-like parameters), the attributes and the output types and shapes.
+// Type inferencing of a node with a matching signature from the previous Resolve is skipped.
+static std::string ComputeInferenceSignature(const Node& node, const InitializedTensorSet& initializers) {
+  // Initializers larger than this are weights that inferencing does not read.
+  constexpr int64_t kMaxInitializerElementsInSignature = 1024;
+
+  std::string signature;
+  auto append_defs = [&signature](const std::vector<NodeArg*>& defs) {
+    for (const auto* def : defs) {
+      signature += def->Name();
+      signature += '\0';
+      const auto* type = def->TypeAsProto();
+      if (type != nullptr) {
+        signature += type->SerializeAsString();
+      }
+      signature += '\0';
+    }
+    signature += '\1';
+  };
+
+  append_defs(node.InputDefs());
+  append_defs(node.OutputDefs());
+
+  for (const auto* input_def : node.InputDefs()) {
+    auto it = initializers.find(input_def->Name());
+    if (it != initializers.end()) {
+      const auto& tensor_proto = *it->second;
+      int64_t size = 1;
+      for (auto dim : tensor_proto.dims()) {
+        size *= dim;
+      }
+      if (size <= kMaxInitializerElementsInSignature) {
+        signature += tensor_proto.SerializeAsString();
+      } else {
+        signature += std::to_string(tensor_proto.data_type());
+        for (auto dim : tensor_proto.dims()) {
+          signature += ',';
+          signature += std::to_string(dim);
+        }
+      }
+    }
+    signature += '\0';
+  }
+  signature += '\1';
+
+  for (const auto& attr : node.GetAttributes()) {
+    signature += attr.first;
+    signature += '\0';
+    signature += attr.second.SerializeAsString();
+    signature += '\0';
+  }
+
+  return signature;
+}
+
 Status Graph::VerifyNodeAndOpMatch() {
   CheckerContext ctx;
   ctx.set_ir_version(gsl::narrow_cast<int>(IrVersion()));
   ctx.set_opset_imports(DomainToVersionMap());
   ctx.set_schema_registry(schema_registry_.get());
 
+  // Only nodes without an op schema are checked, which after the first Resolve are just the nodes added since,
+  // so the names in scope for the checker are only collected if there are any.
+  const bool check_nodes = std::any_of(nodes_in_topological_order_.cbegin(), nodes_in_topological_order_.cend(),
+                                       [this](NodeIndex index) { return GetNode(index)->Op() == nullptr; });
+
   LexicalScopeContext lsc;
-  lsc.output_names.insert(resolve_context_.inputs_and_initializers.cbegin(),
-                          resolve_context_.inputs_and_initializers.cend());
+  if (check_nodes) {
+    lsc.output_names.insert(resolve_context_.inputs_and_initializers.cbegin(),
+                            resolve_context_.inputs_and_initializers.cend());
 
-  // technically we could add values from Node.GetDefinitions().implicit_input_defs on a per-node basis inside
-  // the below loop so that we only check against the specific outer dependencies of the node.
-  // doing that requires lots of copies of LexicalScopeContext.output_names to clear out the per-Node values
-  // after each loop. instead add all the outer scope values upfront so we can just accumulate new inner scope values
-  // during each loop iteration.
-  lsc.output_names.insert(resolve_context_.outer_scope_node_args.cbegin(),
-                          resolve_context_.outer_scope_node_args.cend());
+    // technically we could add values from Node.GetDefinitions().implicit_input_defs on a per-node basis inside
+    // the below loop so that we only check against the specific outer dependencies of the node.
+    // doing that requires lots of copies of LexicalScopeContext.output_names to clear out the per-Node values
+    // after each loop. instead add all the outer scope values upfront so we can just accumulate new inner scope values
+    // during each loop iteration.
+    lsc.output_names.insert(resolve_context_.outer_scope_node_args.cbegin(),
+                            resolve_context_.outer_scope_node_args.cend());
 
-  // we may have some locally defined outer scope args if we're in the middle of constructing a subgraph
-  // and need to call Resolve
-  lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
+    // we may have some locally defined outer scope args if we're in the middle of constructing a subgraph
+    // and need to call Resolve
+    lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
+  }
 
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
@@ -1686,6 +1749,8 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       try {
         checker::check_node(node_proto, ctx, lsc);
       } catch (const std::exception& ex) {
@@ -1742,11 +1807,26 @@ Status Graph::VerifyNodeAndOpMatch() {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    // Nodes with subgraphs are always inferred, as the subgraphs need to be inferred as well.
+    // For other nodes, the outputs are unchanged from the previous Resolve if nothing that the
+    // inferencing depends on has changed, so only nodes downstream of a change are inferred.
+    if (node.ContainsSubgraph()) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    } else {
+      auto& inferred_signature = inferred_node_signatures_[node_index];
+      if (inferred_signature.empty() ||
+          inferred_signature != ComputeInferenceSignature(node, name_to_initial_tensor_)) {
+        inferred_signature.clear();
+        NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+        inferred_signature = ComputeInferenceSignature(node, name_to_initial_tensor_);
+      }
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    if (check_nodes) {
+      for (const auto* output_def : node.OutputDefs()) {
+        lsc.output_names.insert(output_def->Name());
+      }
     }
   }
 
@@ -1981,6 +2061,22 @@ void Graph::CleanAllInitializedTensors() noexcept {
   }
 }
 
+void Graph::ReleaseInitializedTensorData(const std::string& tensor_name) {
+  auto iter = name_to_initial_tensor_.find(tensor_name);
+  if (name_to_initial_tensor_.end() == iter) {
+    return;
+  }
+
+  // all the initializers are owned by graph_proto_, which is mutable.
+  // clearing the data fields would keep their capacity, so swap the data out into a temporary that frees it.
+  TensorProto* tensor = const_cast<TensorProto*>(iter->second);
+  TensorProto stripped;
+  stripped.set_name(tensor->name());
+  stripped.set_data_type(tensor->data_type());
+  *stripped.mutable_dims() = tensor->dims();
+  tensor->Swap(&stripped);
+}
+
 const InitializedTensorSet& Graph::GetAllInitializedTensors() const noexcept {
   return name_to_initial_tensor_;
 }
@@ -2481,6 +2577,7 @@ bool Graph::ReleaseNode(NodeIndex index) {
 
   // index is valid, but the entry may already be empty
   if (nodes_[index] != nullptr) {
+    inferred_node_signatures_.erase(index);
     nodes_[index] = nullptr;
     --num_of_nodes_;
     graph_proto_sync_needed_ = true;
@@ -204,6 +204,19 @@ const ModelMetaData& Model::MetaData() const noexcept {
   return model_metadata_;
 }
 
+void Model::SetMetaData(const std::string& key, const std::string& value) {
+  model_metadata_[key] = value;
+  for (auto& prop : *model_proto_->mutable_metadata_props()) {
+    if (prop.key() == key) {
+      prop.set_value(value);
+      return;
+    }
+  }
+  const gsl::not_null<StringStringEntryProto*> prop{model_proto_->add_metadata_props()};
+  prop->set_key(key);
+  prop->set_value(value);
+}
+
 Graph& Model::MainGraph() noexcept {
   return *graph_;
 }
@@ -75,6 +75,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Set a metadata property of the model, replacing any existing value for the key.
+  void SetMetaData(const std::string& key, const std::string& value);
 
   // Get model's main graph.
   Graph& MainGraph() noexcept;
@@ -30,6 +30,7 @@ PyOpLibProxy::PyOpLibProxy() {
   LOAD_PYOP_LIB(LIB_PYOP, handle_, "Failed to load pyop library");
   LOAD_PYOP_SYM("Initialize", initialize_, "Failed to import function: Initialize");
   LOAD_PYOP_SYM("NewInstance", new_instance_, "Failed to import function: NewInstance");
+  LOAD_PYOP_SYM("NewFunction", new_function_, "Failed to import function: NewFunction");
   LOAD_PYOP_SYM("InvokePythonFunc", invoke_python_func_, "Failed to import function: InvokePythonFunc");
   LOAD_PYOP_SYM("ReleaseInstance", release_instance_, "Failed to import function: ReleaseInstance");
   LOAD_PYOP_SYM("GetLastErrorMessage", get_last_error_message_, "Failed to import function: GetLastErrorMessage");
@@ -49,9 +50,15 @@ PyCustomKernel::PyCustomKernel(Ort::CustomOpApi ort,
   std::string err;
   instance_ = PyOpLibProxy::GetInstance().new_instance_(module.c_str(), class_name_.c_str(), attrs_);
   ORT_ENFORCE(nullptr != instance_, PyOpLibProxy::GetInstance().get_last_error_message_(err));
+  compute_func_ = PyOpLibProxy::GetInstance().new_function_(instance_, compute_.c_str());
+  ORT_ENFORCE(nullptr != compute_func_, PyOpLibProxy::GetInstance().get_last_error_message_(err));
 }
 
 PyCustomKernel::~PyCustomKernel() {
+  if (nullptr != compute_func_) {
+    PyOpLibProxy::GetInstance().release_instance_(compute_func_);
+    compute_func_ = nullptr;
+  }
   if (nullptr != instance_) {
     PyOpLibProxy::GetInstance().release_instance_(instance_);
     instance_ = nullptr;
@@ -65,9 +72,8 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
   ORT_ENFORCE(nullptr != context);
   auto inputs_count = (size_t) reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->InputCount();
   std::vector<const void*> inputs;
-  std::vector<std::unique_ptr<char[]>> outputs;
-  std::vector<int32_t> inputs_type, outputs_elem_size;
-  std::vector<std::vector<int64_t>> inputs_dim, outputs_dim;
+  std::vector<int32_t> inputs_type;
+  std::vector<std::vector<int64_t>> inputs_dim;
 
   for (size_t i = 0; i < inputs_count; ++i) {
     auto ort_value = ort_.KernelContext_GetInput(context, i);
@@ -76,18 +82,18 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
     inputs_dim.push_back(const_cast<MLValue*>(ort_value)->Get<Tensor>().Shape().GetDims());
   }
 
+  // the results of the python function are copied straight into the outputs, which are allocated once their shapes
+  // are known
+  auto allocate_output = [this, context](size_t index, const std::vector<int64_t>& dim, int32_t& numpy_type) -> void* {
+    auto ort_output = ort_.KernelContext_GetOutput(context, index, dim.data(), dim.size());
+    numpy_type = GetType(ort_output);
+    return ort_.GetTensorMutableData<char>(ort_output);
+  };
+
   std::string err;
-  ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, compute_.c_str(), inputs, inputs_type,
-                                                              inputs_dim, outputs, outputs_elem_size,
-                                                              outputs_dim, logging_func_),
+  ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(compute_func_, inputs, inputs_type, inputs_dim,
+                                                              allocate_output, logging_func_),
               PyOpLibProxy::GetInstance().get_last_error_message_(err));  //ORT_ENFORCE
-
-  for (size_t i = 0; i < outputs.size(); ++i) {
-    auto ort_output = ort_.KernelContext_GetOutput(context, i, outputs_dim[i].data(), outputs_dim[i].size());
-    auto output_mem_addr = ort_.GetTensorMutableData<char>(ort_output);
-    auto output_len = std::accumulate(begin(outputs_dim[i]), end(outputs_dim[i]), static_cast<int64_t>(outputs_elem_size[i]), std::multiplies<int64_t>());
-    memcpy(output_mem_addr, outputs[i].get(), output_len);
-  }
 }
 
 int32_t PyCustomKernel::GetType(const OrtValue* input) const {
@@ -19,19 +19,20 @@ using OnnxTypes   = std::vector<ONNXTensorElementDataType>;
 using OnnxAttrs   = std::unordered_map<std::string, std::string>;
 using PyOpLogFunc = std::function<void(const char*)>;
 
+//returns the buffer of output i with the given shape, and its numpy type
+using PyOpAllocateOutputFunc = std::function<void*(size_t, const std::vector<int64_t>&, int32_t&)>;
+
 typedef bool Initialize();
 typedef void ReleaseInstance(void*);
 typedef bool InvokePythonFunc(void*,
-                              const char*,
                               const std::vector<const void*>&,
                               const std::vector<int32_t>&,
                               const std::vector<std::vector<int64_t>>&,
-                              std::vector<std::unique_ptr<char[]>>&,
-                              std::vector<int32_t>&,
-                              std::vector<std::vector<int64_t>>&,
+                              PyOpAllocateOutputFunc,
                               std::function<void(const char*)>);
 typedef const char* GetLastErrorMessage(std::string&);
 typedef void* NewInstance(const char*, const char*, const OnnxAttrs&);
+typedef void* NewFunction(void*, const char*);
 
 class PyOpLibProxy {
 
@@ -40,6 +41,7 @@ public:
     HMODULE              handle_                 = nullptr;
     Initialize*          initialize_             = nullptr;
     NewInstance*         new_instance_           = nullptr;
+    NewFunction*         new_function_           = nullptr;
     InvokePythonFunc*    invoke_python_func_     = nullptr;
     ReleaseInstance*     release_instance_       = nullptr;
     GetLastErrorMessage* get_last_error_message_ = nullptr;
@@ -67,6 +69,7 @@ private:
     std::string      class_name_;
     std::string      compute_;
     void*            instance_ = nullptr;
+    void*            compute_func_ = nullptr;
     PyOpLogFunc      logging_func_;
 };
 
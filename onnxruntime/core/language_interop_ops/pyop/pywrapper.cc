@@ -23,6 +23,8 @@
 using namespace std;
 namespace onnxruntime {
 
+using AllocateOutputFunc = std::function<void*(size_t, const std::vector<int64_t>&, int32_t&)>;
+
 #ifdef _WIN32
 #define PYOP_EXPORT extern "C" __declspec(dllexport)
 #else
@@ -90,44 +92,39 @@ PYOP_EXPORT const char* GetLastErrorMessage(std::string& err) {
     return err.c_str();
 }
 
-PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim) {
+//wrap a tensor buffer as a numpy array without copying it, read-only unless writable is set
+PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim, bool writable = false) {
     std::vector<npy_intp> np_dim;
     for (auto d: dim) {
         np_dim.push_back(static_cast<npy_intp>(d));
     }
-    auto pyObj = static_cast<PyObject*>(PyArray_EMPTY(static_cast<int>(np_dim.size()), np_dim.data(), type, 0));
-    auto data_len = std::accumulate(begin(np_dim), end(np_dim),
-                                    static_cast<int64_t>(PyArray_DescrFromType(type)->elsize),
-                                    std::multiplies<int64_t>());
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    memcpy(PyArray_DATA(np_array), data, data_len);
-    return pyObj;
+    int flags = NPY_ARRAY_C_CONTIGUOUS | NPY_ARRAY_ALIGNED | (writable ? NPY_ARRAY_WRITEABLE : 0);
+    return PyArray_New(&PyArray_Type, static_cast<int>(np_dim.size()), np_dim.data(), type, nullptr,
+                       const_cast<void*>(data), 0, flags, nullptr);
 }
 
-bool ExtractOutput(PyObject*                   pyObj,
-                   vector<unique_ptr<char[]>>& outputs,
-                   vector<int32_t>&            outputs_elem_size,
-                   vector<vector<int64_t>>&    outputs_dim) {
+//copy a result into the output buffer allocate_output returns for its shape, the only copy of the output
+bool ExtractOutput(PyObject* pyObj, size_t index, const AllocateOutputFunc& allocate_output) {
     if (!PyArray_Check(pyObj)) {
         return false;
     }
 
-    outputs_dim.push_back({});
     auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
-
-    for (int i = 0; i < PyArray_NDIM(np_array); ++i) {
-        outputs_dim.back().push_back(PyArray_SHAPE(np_array)[i]);
+    vector<int64_t> dim(PyArray_SHAPE(np_array), PyArray_SHAPE(np_array) + PyArray_NDIM(np_array));
+    int32_t type = 0;
+    void* data = allocate_output(index, dim, type);
+    if (nullptr == data) {
+        return false;
     }
 
-    auto data_len = std::accumulate(begin(outputs_dim.back()),
-                                    end(outputs_dim.back()),
-                                    static_cast<int64_t>(outputs_elem_size.back()),
-                                    std::multiplies<int64_t>());
-
-    outputs.push_back(unique_ptr<char[]>(new char[data_len]));
-    memcpy(static_cast<void*>(outputs.back().get()), PyArray_DATA(np_array), data_len);
-    return true;
+    //numpy handles results that are strided views or of another element type
+    auto output = MakePyObj(data, type, dim, true);
+    if (nullptr == output) {
+        return false;
+    }
+    bool copied = PyArray_CopyInto(reinterpret_cast<PyArrayObject*>(output), np_array) == 0;
+    Py_DECREF(output);
+    return copied;
 }
 
 PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const unordered_map<string, string>& args) {
@@ -155,33 +152,32 @@ PYOP_EXPORT void* NewInstance(const char* module, const char* class_name, const
     return PyObject_Call(pyClass, empty_args, named_args);
 }
 
+PYOP_EXPORT void* NewFunction(void* instance, const char* function) {
+    Scope scope;
+    if (nullptr == instance || nullptr == function) {
+        return nullptr;
+    }
+    return PyObject_GetAttrString(static_cast<PyObject*>(instance), function);
+}
+
 PYOP_EXPORT void ReleaseInstance(void* instance) {
     Scope scope({static_cast<PyObject*>(instance)});
 }
 
-PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
-                                  const char*                      function,
+//the inputs are passed as read-only views of the input tensors, which are only valid during the call
+PYOP_EXPORT bool InvokePythonFunc(void*                            raw_func,
                                   const vector<const void*>&       inputs,
                                   const vector<int32_t>&           inputs_type,
                                   const vector<vector<int64_t>>&   inputs_dim,
-                                  vector<unique_ptr<char[]>>&      outputs,
-                                  vector<int32_t>&                 outputs_elem_size,
-                                  vector<vector<int64_t>>&         outputs_dim,
+                                  AllocateOutputFunc               allocate_output,
                                   std::function<void(const char*)> logging_func) {
     Scope scope;
-    auto instance = static_cast<PyObject*>(raw_inst);
-    if (nullptr == instance || nullptr == function) {
-        logging_func("InvokePythonFunc: found invalid instance or function");
-        return false;
-    }
-
-    auto pyFunc = PyObject_GetAttrString(instance, function);
+    auto pyFunc = static_cast<PyObject*>(raw_func);
     if (nullptr == pyFunc) {
-        logging_func("InvokePythonFunc: failed to create function object");
+        logging_func("InvokePythonFunc: found invalid function");
         return false;
     }
 
-    scope.Add(pyFunc);
     auto pyArgs = PyTuple_New(inputs.size());
     for (size_t i = 0; i < inputs.size(); ++i) {
         PyTuple_SetItem(pyArgs, i, MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]));
@@ -196,10 +192,13 @@ PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
 
     scope.Add(pyResult);
     if (PyArray_Check(pyResult)) {
-        ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim);
+        if (!ExtractOutput(pyResult, 0, allocate_output)) {
+            logging_func("InvokePythonFunc: failed to extract output");
+            return false;
+        }
     } else if (PyTuple_Check(pyResult)) {
         for (int32_t i = 0; i < PyTuple_Size(pyResult); ++i) {
-            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim)) {
+            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), i, allocate_output)) {
                 logging_func("InvokePythonFunc: failed to extract output");
                 return false;
             }
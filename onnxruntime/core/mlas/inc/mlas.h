@@ -68,6 +68,124 @@ MlasGetPreferredBufferAlignment(
     void
     );
 
+//
+// Threading policy routines.
+//
+// The threading policy bounds the number of threads that a single operation
+// may use. A host that already parallelizes across independent requests can
+// set MaximumThreadCount to one to force the library to run single threaded.
+// A MaximumThreadCount of zero removes the limit.
+//
+// N.B. The policy is process wide and is not synchronized with operations
+// that are in progress on other threads.
+//
+
+struct MLAS_THREADING_POLICY {
+    int32_t MaximumThreadCount;
+};
+
+void
+MLASCALL
+MlasGetThreadingPolicy(
+    MLAS_THREADING_POLICY* Policy
+    );
+
+void
+MLASCALL
+MlasSetThreadingPolicy(
+    const MLAS_THREADING_POLICY* Policy
+    );
+
+//
+// Cost model routines.
+//
+// The cost model supplies the parameters used to select the number of threads
+// and the per thread tile strides for an operation:
+//
+//     GemmThreadComplexity - the number of multiply/adds of a GEMM operation
+//         assigned to each thread before another thread is used.
+//
+//     ConvThreadComplexity - the number of multiply/adds of a convolution
+//         operation assigned to each thread before another thread is used.
+//
+//     ThreadStrideNAlign - the alignment of the N dimension when a GEMM
+//         operation is segmented across threads. This must be a power of two
+//         that is at least 16.
+//
+//     ComputeThreadElements - the number of elements of an elementwise or
+//         reduction operation assigned to each thread before another thread
+//         is used.
+//
+// The default values are derived from performance results across a range of
+// workloads. MlasCalibrateCostModel replaces the thread complexities with
+// values measured on the current machine and thread pool.
+//
+// N.B. The cost model is process wide and is not synchronized with operations
+// that are in progress on other threads.
+//
+
+struct MLAS_COST_MODEL {
+    double GemmThreadComplexity;
+    double ConvThreadComplexity;
+    size_t ThreadStrideNAlign;
+    size_t ComputeThreadElements;
+};
+
+void
+MLASCALL
+MlasGetCostModel(
+    MLAS_COST_MODEL* CostModel
+    );
+
+bool
+MLASCALL
+MlasSetCostModel(
+    const MLAS_COST_MODEL* CostModel
+    );
+
+void
+MLASCALL
+MlasCalibrateCostModel(
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Tuning routines.
+//
+// A tuning parameter overrides a choice that the library otherwise makes from
+// the processor features. The following parameters are supported:
+//
+//     GemmThreadComplexity, ConvThreadComplexity, ThreadStrideNAlign and
+//     ComputeThreadElements - the fields of the cost model.
+//
+//     SgemmKernel - the instruction set of the SGEMM kernel: sse, avx, fma3 or
+//         avx512f. The processor must support the instruction set.
+//
+//     NchwcBlockSize - the NCHWc block size: 8 or 16. A block size of 16
+//         requires AVX512F.
+//
+// A tuning cache is a text file with one "Name=Value" line per parameter.
+// Blank lines and text following a '#' are ignored. The library loads the
+// tuning cache named by the MLAS_TUNING_CACHE environment variable when the
+// process starts, before any operation can observe the NCHWc block size.
+//
+// N.B. Changing the NCHWc block size invalidates any buffers that have been
+// reordered for the previous block size.
+//
+
+bool
+MLASCALL
+MlasSetTuningParameter(
+    const char* Name,
+    const char* Value
+    );
+
+bool
+MLASCALL
+MlasLoadTuningCache(
+    const char* FileName
+    );
+
 //
 // Activation routines.
 //
@@ -79,8 +197,16 @@ enum MLAS_ACTIVATION_KIND {
     MlasTanhActivation,
     MlasLogisticActivation,
     MlasClipActivation,
+    MlasGeluActivation,
+    MlasSwishActivation,
+    MlasHardSigmoidActivation,
 };
 
+//
+// Gelu computes 0.5 * x * (1 + erf(x / sqrt(2))), Swish computes x * logistic(x)
+// and HardSigmoid computes max(0, min(1, alpha * x + beta)).
+//
+
 struct MLAS_ACTIVATION {
     MLAS_ACTIVATION_KIND ActivationKind;
     union {
@@ -91,6 +217,10 @@ struct MLAS_ACTIVATION {
             float minimum;
             float maximum;
         } Clip;
+        struct {
+            float alpha;
+            float beta;
+        } HardSigmoid;
         float Values[2];
     } Parameters;
 };
@@ -106,6 +236,26 @@ MlasActivation(
     size_t ldc
     );
 
+//
+// Post processing applied by the single precision matrix/matrix multiply
+// routines to each tile of the output matrix once its products have been
+// accumulated, while the tile is still cache resident:
+//
+//     C = Activation(alpha * A * B + beta * C + ColumnBias + RowBias + Residual)
+//
+// ColumnBias supplies N elements that are added to each row, RowBias supplies
+// M elements that are added to each column, and Residual supplies an M by N
+// matrix with the leading dimension ldr. Fields set to nullptr are skipped.
+//
+
+struct MLAS_SGEMM_EPILOGUE {
+    const float* ColumnBias = nullptr;
+    const float* RowBias = nullptr;
+    const float* Residual = nullptr;
+    size_t ldr = 0;
+    const MLAS_ACTIVATION* Activation = nullptr;
+};
+
 //
 // Single precision matrix/matrix multiply routine.
 //
@@ -126,13 +276,254 @@ MlasSgemm(
     float beta,
     float* C,
     size_t ldc,
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routine for a batch of independent
+// multiplies.
+//
+// N.B. The batch is partitioned across the thread pool as a whole, so a batch
+// of small multiplies dispatches to the thread pool once instead of once per
+// multiply. Each multiply must write to a distinct output matrix.
+//
+
+struct MLAS_SGEMM_PARAMETERS {
+    CBLAS_TRANSPOSE TransA = CblasNoTrans;
+    CBLAS_TRANSPOSE TransB = CblasNoTrans;
+    size_t M = 0;
+    size_t N = 0;
+    size_t K = 0;
+    float alpha = 1.0f;
+    const float* A = nullptr;
+    size_t lda = 0;
+    const float* B = nullptr;
+    size_t ldb = 0;
+    float beta = 0.0f;
+    float* C = nullptr;
+    size_t ldc = 0;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+};
+
+void
+MLASCALL
+MlasSgemmBatch(
+    const MLAS_SGEMM_PARAMETERS* Parameters,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routines with a packed matrix B.
+//
+// N.B. Matrices that are used for many multiplies, such as constant weights,
+// can be packed once with MlasGemmPackB and then be reused by MlasSgemmPacked
+// without packing them again on each call.
+//
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmPacked(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routines with a sparse matrix B.
+//
+// N.B. MlasSparsePackBSize returns zero if matrix B has too many nonzero
+// elements for MlasSgemmSparse to be faster than MlasSgemmPacked, in which
+// case matrix B should be packed with MlasGemmPackB instead. Only the nonzero
+// elements of matrix B are packed, so the product of a zero of matrix B with
+// an infinity or a NaN of matrix A is zero instead of a NaN.
+//
+
+size_t
+MLASCALL
+MlasSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmSparse(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Single precision matrix/matrix multiply routines with a matrix B of 8-bit
+// or 4-bit weights quantized in blocks of BlockSize rows, with a scale for
+// each block of each column.
+//
+// MlasQuantizeBlockwise quantizes a non-transposed matrix B with symmetric
+// scales. The quantized weights are ordered by column then by block, with
+// BlockSize * Bits / 8 bytes for each block, offset by 2^(Bits-1) to unsigned
+// values. Two 4-bit weights of consecutive rows share a byte, the first in the
+// low nibble. MlasBlockQuantGemmPackBSize returns zero if the parameters
+// aren't supported.
+//
+
+void
+MLASCALL
+MlasQuantizeBlockwise(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize,
+    const float* B,
+    size_t ldb,
+    uint8_t* QuantB,
+    float* Scales
+    );
+
+size_t
+MLASCALL
+MlasBlockQuantGemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize
+    );
+
+void
+MLASCALL
+MlasBlockQuantGemmPackB(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize,
+    const uint8_t* QuantB,
+    const float* Scales,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasBlockQuantGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    const float* Bias,
+    float* C,
+    size_t ldc,
     MLAS_THREADPOOL* ThreadPool
     );
 
 //
-// Quantized integer matrix/matrix multiply routine.
+// Quantized integer matrix/matrix multiply routines.
+//
+// N.B. Signed matrices hold int8_t elements, and their zero point offsets are
+// also int8_t values supplied through the uint8_t fields.
+//
+// If BIsPacked is true, B is the buffer from MlasGemmPackB and ldb is ignored.
+// ZeroPointB supplies a single zero point offset, or else one for each column
+// of matrix B if PerColumnZeroPoints is true.
 //
 
+struct MLAS_GEMM_U8X8_PARAMETERS {
+    size_t M = 0;
+    size_t N = 0;
+    size_t K = 0;
+    const uint8_t* A = nullptr;
+    size_t lda = 0;
+    uint8_t ZeroPointA = 0;
+    bool AIsSigned = false;
+    const void* B = nullptr;
+    size_t ldb = 0;
+    const uint8_t* ZeroPointB = nullptr;
+    bool BIsPacked = false;
+    bool BIsSigned = false;
+    bool PerColumnZeroPoints = false;
+    int32_t* C = nullptr;
+    size_t ldc = 0;
+};
+
+void
+MLASCALL
+MlasGemm(
+    const MLAS_GEMM_U8X8_PARAMETERS* Parameters,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    bool BIsSigned
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    );
+
 void
 MLASCALL
 MlasQgemm(
@@ -150,6 +541,86 @@ MlasQgemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Requantization routines.
+//
+// Converts the int32 output of a quantized matrix multiply to uint8 as
+// saturate(round(Scale * (Input + Bias)) + ZeroPoint), rounding to nearest
+// even. The channels of the output are its rows (a NCHW convolution, where
+// the rows are the output channels) or else its columns if ChannelIsColumn is
+// true (a MatMul). Bias is optional and holds a value for each channel, and
+// Scale holds a single value, or else one for each channel if
+// PerChannelScale is true.
+//
+
+struct MLAS_REQUANTIZE_PARAMETERS {
+    size_t M = 0;
+    size_t N = 0;
+    const int32_t* Input = nullptr;
+    size_t ldi = 0;
+    uint8_t* Output = nullptr;
+    size_t ldo = 0;
+    const int32_t* Bias = nullptr;
+    const float* Scale = nullptr;
+    bool PerChannelScale = false;
+    bool ChannelIsColumn = false;
+    uint8_t ZeroPoint = 0;
+};
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const MLAS_REQUANTIZE_PARAMETERS* Parameters
+    );
+
+//
+// Linear quantization routines.
+//
+// Quantizes as saturate(round(Input / Scale) + ZeroPoint), rounding to nearest
+// even, and dequantizes as (Input - ZeroPoint) * Scale. The int8 values
+// saturate to [-127, 127] so that the range is symmetric around zero.
+//
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    );
+
 //
 // Convolution routines.
 //
@@ -158,6 +629,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
+    MlasConvAlgorithmDepthwise,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -186,6 +659,12 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileSize;
+            size_t TileCount;
+            size_t BlockTileCount;
+            size_t ThreadStrideTiles;
+        } Winograd;
     } u;
 };
 
@@ -221,6 +700,41 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd convolution routines.
+//
+// MlasConvPrepare selects MlasConvAlgorithmWinograd for 3x3 convolutions with
+// unit stride and dilation. The filter passed to MlasConv must then be
+// transformed by MlasConvWinogradTransformFilter. The transformed filter only
+// depends on the filter tensor and the tile size, so the caller may cache it.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradTileSize(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    );
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
 //
 // Pooling routines.
 //
@@ -275,9 +789,105 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+//
+// Softmax and reduction routines.
+//
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasReduceSum(
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasReduceMaximum(
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasReduceMinimumMaximum(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasReduceMeanVariance(
+    const float* Input,
+    float* Mean,
+    float* Variance,
+    size_t RowCount,
+    size_t RowSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Shift,
+    size_t ScaleCount,
+    size_t RowCount,
+    size_t RowSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
+// The conversions to half precision round to the nearest even value.
+//
 
 extern "C"
 void
@@ -288,6 +898,68 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+extern "C"
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+//
+// Reduced precision matrix/matrix multiply routines.
+//
+// The matrices hold IEEE half precision (FP16) or bfloat16 (BF16) elements.
+// The products are accumulated in single precision and each element of the
+// output matrix is rounded once when it is stored:
+//
+//     C = alpha * A * B + beta * C
+//
+// If beta is zero, matrix C is not read.
+//
+
+typedef uint16_t MLAS_FP16;
+typedef uint16_t MLAS_BF16;
+
+void
+MLASCALL
+MlasHalfGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_FP16* A,
+    size_t lda,
+    const MLAS_FP16* B,
+    size_t ldb,
+    float beta,
+    MLAS_FP16* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasBf16Gemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_BF16* A,
+    size_t lda,
+    const MLAS_BF16* B,
+    size_t ldb,
+    float beta,
+    MLAS_BF16* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -324,6 +996,32 @@ MlasReorderFilterOIHWBo(
     float* D
     );
 
+//
+// Transpose routines.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    );
+
 //
 // Single precision NCHWc routines.
 //
@@ -354,6 +1052,33 @@ MlasNchwcConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// The NCHWc Winograd convolution uses the parameters from MlasConvPrepare
+// with the NCHWc channel counts and a single group. It is used when the
+// prepared algorithm is MlasConvAlgorithmWinograd.
+//
+
+void
+MLASCALL
+MlasNchwcConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    );
+
+void
+MLASCALL
+MlasNchwcConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    bool ZeroMode,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasNchwcPool(
@@ -369,3 +1094,23 @@ MlasNchwcPool(
     float* Output,
     MLAS_THREADPOOL* ThreadPool
     );
+
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasNchwcUpsampleLinear(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
@@ -192,6 +192,44 @@ struct MLAS_ACTIVATION_FUNCTION<MlasClipActivation>
     }
 };
 
+template<>
+struct MLAS_ACTIVATION_FUNCTION<MlasHardSigmoidActivation>
+{
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 OneFloat32x4 = MlasBroadcastFloat32x4(1.0f);
+
+    MLAS_FLOAT32X4 AlphaBroadcast;
+    MLAS_FLOAT32X4 BetaBroadcast;
+
+    MLAS_ACTIVATION_FUNCTION(const MLAS_ACTIVATION* Activation)
+    {
+        AlphaBroadcast = MlasBroadcastFloat32x4(&Activation->Parameters.HardSigmoid.alpha);
+        BetaBroadcast = MlasBroadcastFloat32x4(&Activation->Parameters.HardSigmoid.beta);
+    }
+
+    MLAS_FLOAT32X4 Activate(MLAS_FLOAT32X4 Value)
+    {
+        Value = MlasMultiplyAddFloat32x4(Value, AlphaBroadcast, BetaBroadcast);
+        Value = MlasMinimumFloat32x4(OneFloat32x4, Value);
+        Value = MlasMaximumFloat32x4(ZeroFloat32x4, Value);
+
+        return Value;
+    }
+
+    float Activate(float Value)
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        return _mm_cvtss_f32(Activate(_mm_set_ss(Value)));
+#else
+        Value = Value * MlasExtractLaneFloat32x4<0>(AlphaBroadcast) + MlasExtractLaneFloat32x4<0>(BetaBroadcast);
+        Value = (std::min)(Value, 1.0f);
+        Value = (std::max)(Value, 0.0f);
+
+        return Value;
+#endif
+    }
+};
+
 template<MLAS_ACTIVATION_KIND ActivationKind, bool AddBias>
 void
 MlasActivationKernel(
@@ -364,6 +402,93 @@ Return Value:
     }
 }
 
+template<MLAS_ACTIVATION_KIND ActivationKind>
+void
+MlasGatedActivationKernel(
+    float* Buffer,
+    size_t M,
+    size_t N,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies an activation that multiplies each element by a
+    function of itself computed by a vectorized transcendental routine. The
+    function is evaluated in blocks of a stack buffer while the elements are
+    cache resident.
+
+Arguments:
+
+    Buffer - Supplies the output matrix.
+
+    M - Supplies the number of rows in the output matrix.
+
+    N - Supplies the number of columns of the output matrix.
+
+    ldc - Supplies the number of elements per row of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = 256;
+    constexpr float SqrtHalf = 0.70710678118654752440f;
+
+    MLAS_DECLSPEC_ALIGN(float Gate[BlockSize], 16);
+
+    if (N == ldc) {
+        N *= M;
+        M = 1;
+    }
+
+    while (M-- > 0) {
+
+        for (size_t n = 0; n < N; n += BlockSize) {
+
+            float* buffer = Buffer + n;
+            const size_t count = (std::min)(BlockSize, N - n);
+
+            //
+            // Gelu gates each element by 0.5 * (1 + erf(x / sqrt(2))) and Swish
+            // by logistic(x).
+            //
+
+            if (ActivationKind == MlasGeluActivation) {
+
+                for (size_t i = 0; i < count; i++) {
+                    Gate[i] = buffer[i] * SqrtHalf;
+                }
+
+                MlasComputeErf(Gate, Gate, count);
+
+                for (size_t i = 0; i < count; i++) {
+                    Gate[i] = 0.5f * Gate[i] + 0.5f;
+                }
+
+            } else {
+
+                MlasComputeLogistic(buffer, Gate, count);
+            }
+
+            size_t i = 0;
+
+            for (; i + 4 <= count; i += 4) {
+                MlasStoreFloat32x4(buffer + i, MlasMultiplyFloat32x4(MlasLoadFloat32x4(buffer + i), MlasLoadFloat32x4(Gate + i)));
+            }
+
+            for (; i < count; i++) {
+                buffer[i] *= Gate[i];
+            }
+        }
+
+        Buffer += ldc;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -463,5 +588,31 @@ Return Value:
             MlasActivationKernel<MlasClipActivation>(Activation, Buffer, Bias, M, N, ldc);
             break;
         }
+
+        case MlasGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            MlasGatedActivationKernel<MlasGeluActivation>(Buffer, M, N, ldc);
+            break;
+        }
+
+        case MlasSwishActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            MlasGatedActivationKernel<MlasSwishActivation>(Buffer, M, N, ldc);
+            break;
+        }
+
+        case MlasHardSigmoidActivation:
+        {
+            MlasActivationKernel<MlasHardSigmoidActivation>(Activation, Buffer, Bias, M, N, ldc);
+            break;
+        }
     }
 }
@@ -0,0 +1,844 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bqgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a matrix B of 8-bit or 4-bit weights quantized in blocks
+    of rows, each block of each column with its own scale.
+
+    The weights are dequantized on the fly and accumulated in single
+    precision. For the few rows of matrix A of a decoder step the operation
+    is bound by the bandwidth to read matrix B, so reading quantized weights
+    instead of single precision weights is 4 or 8 times less memory traffic.
+
+    Matrix B is packed in panels of 16 columns. Each panel holds the scales
+    of its blocks followed by the quantized weights of each row, so that the
+    16 weights of a row are decoded to four vectors of single precision
+    values with a few integer instructions.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+#include <memory>
+
+//
+// Define the number of columns of a panel of the packed matrix B.
+//
+
+#define MLAS_BQGEMM_STRIDEN                 16
+
+//
+// Define the number of rows of matrix A up to which the weights are decoded
+// and accumulated by a vector kernel for each row. Above this count, a panel
+// of matrix B is dequantized to a buffer once and multiplied by the SGEMM
+// kernels.
+//
+
+#define MLAS_BQGEMM_GEMV_THRESHOLD          4
+
+//
+// Define the header of a packed matrix B. The header is padded to a multiple
+// of 64 bytes and is followed by the panels of matrix B.
+//
+
+struct MLAS_BQGEMM_PACKED_B {
+    size_t N;
+    size_t K;
+    size_t Bits;
+    size_t BlockSize;
+    size_t BlockCount;
+    size_t PanelSize;
+};
+
+#define MLAS_BQGEMM_HEADER_SIZE \
+    ((sizeof(MLAS_BQGEMM_PACKED_B) + 63) & ~size_t(63))
+
+//
+// Define the parameters to execute segments of a block quantized GEMM
+// operation on worker threads.
+//
+
+struct MLAS_BQGEMM_WORK_BLOCK {
+    int32_t ThreadCount;
+    size_t M;
+    size_t N;
+    size_t K;
+    const float* A;
+    size_t lda;
+    const MLAS_BQGEMM_PACKED_B* PackedB;
+    const float* Bias;
+    float* C;
+    size_t ldc;
+};
+
+void
+MLASCALL
+MlasQuantizeBlockwise(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize,
+    const float* B,
+    size_t ldb,
+    uint8_t* QuantB,
+    float* Scales
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes matrix B with a symmetric scale for each block of
+    rows of each column.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Bits - Supplies the number of bits of a quantized weight, 4 or 8.
+
+    BlockSize - Supplies the number of rows of a block, a multiple of 2.
+
+    B - Supplies the address of matrix B, which is not transposed.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    QuantB - Supplies the address of the quantized weights, ordered by column
+        then by row, with BlockSize * Bits / 8 bytes for each block of each
+        column. The weights are offset by 2^(Bits-1) to unsigned values and
+        two 4-bit weights of consecutive rows share a byte, the first in the
+        low nibble. The padding rows of the last block are zero weights.
+
+    Scales - Supplies the address of the scales, ordered by column then by
+        block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+    const size_t BlockBytes = BlockSize * Bits / 8;
+    const int32_t Offset = int32_t(1) << (Bits - 1);
+    const float MaximumValue = float(Offset - 1);
+
+    for (size_t n = 0; n < N; n++) {
+
+        for (size_t b = 0; b < BlockCount; b++) {
+
+            const size_t StartK = b * BlockSize;
+            const size_t CountK = std::min(K - StartK, BlockSize);
+
+            float AbsMaximum = 0.0f;
+
+            for (size_t k = StartK; k < StartK + CountK; k++) {
+                AbsMaximum = std::max(AbsMaximum, std::fabs(B[k * ldb + n]));
+            }
+
+            const float Scale = AbsMaximum / MaximumValue;
+            const float ReciprocalScale = (Scale != 0.0f) ? (1.0f / Scale) : 0.0f;
+
+            Scales[n * BlockCount + b] = Scale;
+
+            uint8_t* q = QuantB + (n * BlockCount + b) * BlockBytes;
+
+            for (size_t i = 0; i < BlockSize; i++) {
+
+                int32_t Value = 0;
+
+                if (i < CountK) {
+                    const float Scaled = std::nearbyint(B[(StartK + i) * ldb + n] * ReciprocalScale);
+                    Value = int32_t(std::min(std::max(Scaled, -MaximumValue), MaximumValue));
+                }
+
+                const uint8_t Stored = uint8_t(Value + Offset);
+
+                if (Bits == 8) {
+                    q[i] = Stored;
+                } else if ((i & 1) == 0) {
+                    q[i / 2] = Stored;
+                } else {
+                    q[i / 2] |= uint8_t(Stored << 4);
+                }
+            }
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasBlockQuantGemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed block quantized
+    matrix B buffer.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Bits - Supplies the number of bits of a quantized weight, 4 or 8.
+
+    BlockSize - Supplies the number of rows of a block.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer, else zero if
+    the parameters aren't supported.
+
+--*/
+{
+    if (N == 0 || K == 0 || (Bits != 4 && Bits != 8) || BlockSize == 0 || (BlockSize % 2) != 0) {
+        return 0;
+    }
+
+    const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+    const size_t PanelCount = (N + MLAS_BQGEMM_STRIDEN - 1) / MLAS_BQGEMM_STRIDEN;
+    const size_t PanelSize = BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float) +
+        K * (MLAS_BQGEMM_STRIDEN * Bits / 8);
+
+    return MLAS_BQGEMM_HEADER_SIZE + PanelCount * PanelSize;
+}
+
+void
+MLASCALL
+MlasBlockQuantGemmPackB(
+    size_t N,
+    size_t K,
+    size_t Bits,
+    size_t BlockSize,
+    const uint8_t* QuantB,
+    const float* Scales,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the quantized weights and the scales produced by
+    MlasQuantizeBlockwise to panels of columns.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    Bits - Supplies the number of bits of a quantized weight, 4 or 8.
+
+    BlockSize - Supplies the number of rows of a block.
+
+    QuantB - Supplies the address of the quantized weights.
+
+    Scales - Supplies the address of the scales.
+
+    PackedB - Supplies the address of the packed matrix B buffer, of the size
+        returned by MlasBlockQuantGemmPackBSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+    const size_t BlockBytes = BlockSize * Bits / 8;
+    const size_t RowBytes = MLAS_BQGEMM_STRIDEN * Bits / 8;
+    const size_t PanelCount = (N + MLAS_BQGEMM_STRIDEN - 1) / MLAS_BQGEMM_STRIDEN;
+
+    auto* Header = reinterpret_cast<MLAS_BQGEMM_PACKED_B*>(PackedB);
+
+    Header->N = N;
+    Header->K = K;
+    Header->Bits = Bits;
+    Header->BlockSize = BlockSize;
+    Header->BlockCount = BlockCount;
+    Header->PanelSize = BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float) + K * RowBytes;
+
+    uint8_t* Panel = reinterpret_cast<uint8_t*>(PackedB) + MLAS_BQGEMM_HEADER_SIZE;
+
+    for (size_t p = 0; p < PanelCount; p++) {
+
+        const size_t StartN = p * MLAS_BQGEMM_STRIDEN;
+        const size_t CountN = std::min(N - StartN, size_t(MLAS_BQGEMM_STRIDEN));
+
+        //
+        // Store the scales of each block for the columns of the panel. The
+        // padding columns have zero scales.
+        //
+
+        float* PanelScales = reinterpret_cast<float*>(Panel);
+
+        for (size_t b = 0; b < BlockCount; b++) {
+            for (size_t n = 0; n < MLAS_BQGEMM_STRIDEN; n++) {
+                PanelScales[b * MLAS_BQGEMM_STRIDEN + n] =
+                    (n < CountN) ? Scales[(StartN + n) * BlockCount + b] : 0.0f;
+            }
+        }
+
+        //
+        // Store the weights of each row. The 8-bit weights are stored as
+        // signed values. The 4-bit weights keep the offset of 8, with the
+        // first 8 columns in the low nibbles and the last 8 columns in the
+        // high nibbles. The padding columns are zero weights.
+        //
+
+        uint8_t* PanelData = Panel + BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float);
+
+        for (size_t k = 0; k < K; k++) {
+
+            const size_t Block = k / BlockSize;
+            const size_t Index = k % BlockSize;
+
+            uint8_t Values[MLAS_BQGEMM_STRIDEN];
+
+            for (size_t n = 0; n < MLAS_BQGEMM_STRIDEN; n++) {
+
+                if (n >= CountN) {
+                    Values[n] = (Bits == 8) ? 0x80 : 0x08;
+                    continue;
+                }
+
+                const uint8_t* q = QuantB + ((StartN + n) * BlockCount + Block) * BlockBytes;
+
+                if (Bits == 8) {
+                    Values[n] = q[Index];
+                } else {
+                    Values[n] = (q[Index / 2] >> ((Index & 1) * 4)) & 0x0F;
+                }
+            }
+
+            uint8_t* Row = PanelData + k * RowBytes;
+
+            if (Bits == 8) {
+                for (size_t n = 0; n < MLAS_BQGEMM_STRIDEN; n++) {
+                    Row[n] = uint8_t(Values[n] ^ 0x80);
+                }
+            } else {
+                for (size_t n = 0; n < MLAS_BQGEMM_STRIDEN / 2; n++) {
+                    Row[n] = uint8_t(Values[n] | (Values[n + MLAS_BQGEMM_STRIDEN / 2] << 4));
+                }
+            }
+        }
+
+        Panel += Header->PanelSize;
+    }
+}
+
+template<size_t Bits>
+MLAS_FORCEINLINE
+void
+MlasBlockQuantGemmDecodeRow(
+    const uint8_t* Row,
+    MLAS_FLOAT32X4 Weights[4]
+    )
+/*++
+
+Routine Description:
+
+    This routine decodes the 16 quantized weights of a row of a panel to
+    single precision values, without the scales applied.
+
+Arguments:
+
+    Row - Supplies the address of the row of the panel.
+
+    Weights - Receives the weights of the 16 columns of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON_INTRINSICS)
+
+    int8x16_t Bytes;
+
+    if (Bits == 8) {
+        Bytes = vld1q_s8(reinterpret_cast<const int8_t*>(Row));
+    } else {
+        const uint8x8_t Packed = vld1_u8(Row);
+        const uint8x16_t Nibbles = vcombine_u8(vand_u8(Packed, vdup_n_u8(0x0F)), vshr_n_u8(Packed, 4));
+        Bytes = vsubq_s8(vreinterpretq_s8_u8(Nibbles), vdupq_n_s8(8));
+    }
+
+    const int16x8_t Low = vmovl_s8(vget_low_s8(Bytes));
+    const int16x8_t High = vmovl_s8(vget_high_s8(Bytes));
+
+    Weights[0] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(Low)));
+    Weights[1] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(Low)));
+    Weights[2] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(High)));
+    Weights[3] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(High)));
+
+#elif defined(MLAS_SSE2_INTRINSICS)
+
+    __m128i Bytes;
+
+    if (Bits == 8) {
+        Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row));
+    } else {
+        const __m128i Packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Row));
+        const __m128i LowMask = _mm_set1_epi8(0x0F);
+        const __m128i Nibbles = _mm_unpacklo_epi64(_mm_and_si128(Packed, LowMask),
+            _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask));
+        Bytes = _mm_sub_epi8(Nibbles, _mm_set1_epi8(8));
+    }
+
+    //
+    // Sign extend the bytes by unpacking each to the high byte of a word and
+    // shifting arithmetically, then the same for the words.
+    //
+
+    const __m128i Low = _mm_srai_epi16(_mm_unpacklo_epi8(Bytes, Bytes), 8);
+    const __m128i High = _mm_srai_epi16(_mm_unpackhi_epi8(Bytes, Bytes), 8);
+
+    Weights[0] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Low, Low), 16));
+    Weights[1] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Low, Low), 16));
+    Weights[2] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(High, High), 16));
+    Weights[3] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(High, High), 16));
+
+#endif
+}
+
+template<size_t Bits>
+MLAS_FORCEINLINE
+void
+MlasBlockQuantGemvKernel(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of matrix B. The
+    unscaled products of each block are accumulated separately and scaled
+    once at the end of the block.
+
+Arguments:
+
+    A - Supplies the address of the row of matrix A.
+
+    Panel - Supplies the address of the panel of matrix B.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    BlockSize - Supplies the number of rows of a block.
+
+    Bias - Supplies the bias of the 16 columns of the panel, else nullptr.
+
+    Output - Receives the 16 output values of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+    const size_t RowBytes = MLAS_BQGEMM_STRIDEN * Bits / 8;
+
+    const float* PanelScales = reinterpret_cast<const float*>(Panel);
+    const uint8_t* Row = Panel + BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float);
+
+    MLAS_FLOAT32X4 Accumulators[4];
+
+    for (size_t v = 0; v < 4; v++) {
+        Accumulators[v] = (Bias != nullptr) ? MlasLoadFloat32x4(Bias + v * 4) : MlasZeroFloat32x4();
+    }
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const size_t StartK = b * BlockSize;
+        const size_t EndK = std::min(StartK + BlockSize, K);
+
+        MLAS_FLOAT32X4 BlockAccumulators[4];
+
+        for (size_t v = 0; v < 4; v++) {
+            BlockAccumulators[v] = MlasZeroFloat32x4();
+        }
+
+        for (size_t k = StartK; k < EndK; k++) {
+
+            MLAS_FLOAT32X4 Weights[4];
+
+            MlasBlockQuantGemmDecodeRow<Bits>(Row, Weights);
+
+            const MLAS_FLOAT32X4 ValueA = MlasBroadcastFloat32x4(A[k]);
+
+            for (size_t v = 0; v < 4; v++) {
+                BlockAccumulators[v] = MlasMultiplyAddFloat32x4(Weights[v], ValueA, BlockAccumulators[v]);
+            }
+
+            Row += RowBytes;
+        }
+
+        for (size_t v = 0; v < 4; v++) {
+            Accumulators[v] = MlasMultiplyAddFloat32x4(BlockAccumulators[v],
+                MlasLoadFloat32x4(PanelScales + b * MLAS_BQGEMM_STRIDEN + v * 4), Accumulators[v]);
+        }
+    }
+
+    for (size_t v = 0; v < 4; v++) {
+        MlasStoreFloat32x4(Output + v * 4, Accumulators[v]);
+    }
+}
+
+void
+MLASCALL
+MlasBlockQuantGemvQ8Kernel(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of 8-bit weights.
+
+Arguments:
+
+    See MlasBlockQuantGemvKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBlockQuantGemvKernel<8>(A, Panel, K, BlockSize, Bias, Output);
+}
+
+void
+MLASCALL
+MlasBlockQuantGemvQ4Kernel(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of 4-bit weights.
+
+Arguments:
+
+    See MlasBlockQuantGemvKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBlockQuantGemvKernel<4>(A, Panel, K, BlockSize, Bias, Output);
+}
+
+template<size_t Bits>
+void
+MlasBlockQuantGemmDequantizePanel(
+    const MLAS_BQGEMM_PACKED_B* PackedB,
+    const uint8_t* Panel,
+    float* PanelB
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a panel of matrix B to single precision values.
+
+Arguments:
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    Panel - Supplies the address of the panel of matrix B.
+
+    PanelB - Receives the K rows of 16 values of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t K = PackedB->K;
+    const size_t BlockSize = PackedB->BlockSize;
+    const size_t RowBytes = MLAS_BQGEMM_STRIDEN * Bits / 8;
+
+    const float* PanelScales = reinterpret_cast<const float*>(Panel);
+    const uint8_t* Row = Panel + PackedB->BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float);
+
+    for (size_t k = 0; k < K; k++) {
+
+        const float* s = PanelScales + (k / BlockSize) * MLAS_BQGEMM_STRIDEN;
+
+        MLAS_FLOAT32X4 Weights[4];
+
+        MlasBlockQuantGemmDecodeRow<Bits>(Row, Weights);
+
+        for (size_t v = 0; v < 4; v++) {
+            MlasStoreFloat32x4(PanelB + v * 4, MlasMultiplyFloat32x4(Weights[v], MlasLoadFloat32x4(s + v * 4)));
+        }
+
+        Row += RowBytes;
+        PanelB += MLAS_BQGEMM_STRIDEN;
+    }
+}
+
+template<size_t Bits>
+void
+MlasBlockQuantGemmOperation(
+    const MLAS_BQGEMM_WORK_BLOCK* WorkBlock,
+    size_t PanelStart,
+    size_t PanelCount
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies matrix A by a range of panels of matrix B.
+
+Arguments:
+
+    WorkBlock - Supplies the parameters of the operation.
+
+    PanelStart - Supplies the first panel of matrix B.
+
+    PanelCount - Supplies the number of panels of matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_BQGEMM_PACKED_B* PackedB = WorkBlock->PackedB;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+    const float* Bias = WorkBlock->Bias;
+
+    const uint8_t* Panels = reinterpret_cast<const uint8_t*>(PackedB) + MLAS_BQGEMM_HEADER_SIZE;
+
+#if defined(MLAS_TARGET_AMD64)
+    const PMLAS_BLOCK_QUANT_GEMV_KERNEL GemvKernel =
+        (Bits == 8) ? MlasPlatform.BlockQuantGemvQ8Kernel : MlasPlatform.BlockQuantGemvQ4Kernel;
+#else
+    const PMLAS_BLOCK_QUANT_GEMV_KERNEL GemvKernel =
+        (Bits == 8) ? MlasBlockQuantGemvQ8Kernel : MlasBlockQuantGemvQ4Kernel;
+#endif
+
+    std::unique_ptr<float[]> PanelB;
+
+    if (M > MLAS_BQGEMM_GEMV_THRESHOLD) {
+        PanelB.reset(new float[K * MLAS_BQGEMM_STRIDEN]);
+    }
+
+    for (size_t p = PanelStart; p < PanelStart + PanelCount; p++) {
+
+        const size_t StartN = p * MLAS_BQGEMM_STRIDEN;
+        const size_t CountN = std::min(N - StartN, size_t(MLAS_BQGEMM_STRIDEN));
+        const uint8_t* Panel = Panels + p * PackedB->PanelSize;
+
+        MLAS_DECLSPEC_ALIGN(float PanelBias[MLAS_BQGEMM_STRIDEN], 16);
+
+        if (Bias != nullptr) {
+            for (size_t n = 0; n < MLAS_BQGEMM_STRIDEN; n++) {
+                PanelBias[n] = (n < CountN) ? Bias[StartN + n] : 0.0f;
+            }
+        }
+
+        if (M <= MLAS_BQGEMM_GEMV_THRESHOLD) {
+
+            //
+            // The weights of the panel are decoded again for each row and
+            // are read from the cache after the first row.
+            //
+
+            MLAS_DECLSPEC_ALIGN(float Output[MLAS_BQGEMM_STRIDEN], 16);
+
+            for (size_t m = 0; m < M; m++) {
+
+                GemvKernel(WorkBlock->A + m * WorkBlock->lda, Panel, K, PackedB->BlockSize,
+                    (Bias != nullptr) ? PanelBias : nullptr, Output);
+
+                std::copy_n(Output, CountN, WorkBlock->C + m * WorkBlock->ldc + StartN);
+            }
+
+        } else {
+
+            MlasBlockQuantGemmDequantizePanel<Bits>(PackedB, Panel, PanelB.get());
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, M, CountN, K, 1.0f, WorkBlock->A, WorkBlock->lda,
+                PanelB.get(), MLAS_BQGEMM_STRIDEN, 0.0f, WorkBlock->C + StartN, WorkBlock->ldc);
+
+            if (Bias != nullptr) {
+                for (size_t m = 0; m < M; m++) {
+                    float* c = WorkBlock->C + m * WorkBlock->ldc + StartN;
+                    for (size_t n = 0; n < CountN; n++) {
+                        c[n] += PanelBias[n];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasBlockQuantGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    block quantized GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_BQGEMM_WORK_BLOCK*)Context;
+
+    const size_t PanelCount = (WorkBlock->N + MLAS_BQGEMM_STRIDEN - 1) / MLAS_BQGEMM_STRIDEN;
+
+    size_t PanelStart;
+    size_t PanelCountThisThread;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, PanelCount, &PanelStart, &PanelCountThisThread);
+
+    if (PanelCountThisThread == 0) {
+        return;
+    }
+
+    if (WorkBlock->PackedB->Bits == 8) {
+        MlasBlockQuantGemmOperation<8>(WorkBlock, PanelStart, PanelCountThisThread);
+    } else {
+        MlasBlockQuantGemmOperation<4>(WorkBlock, PanelStart, PanelCountThisThread);
+    }
+}
+
+void
+MLASCALL
+MlasBlockQuantGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    const float* Bias,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation with a matrix B packed by MlasBlockQuantGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    Bias - Supplies the address of the bias vector of N elements, else
+        nullptr.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    //
+    // Partition the panels of matrix B across the threads, so that each
+    // thread reads a disjoint part of the weights.
+    //
+
+    const size_t PanelCount = (N + MLAS_BQGEMM_STRIDEN - 1) / MLAS_BQGEMM_STRIDEN;
+
+    MLAS_BQGEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ThreadCount = MlasComputeThreadCount(PanelCount, M * N * K, ThreadPool);
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = reinterpret_cast<const MLAS_BQGEMM_PACKED_B*>(PackedB);
+    WorkBlock.Bias = Bias;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    MlasExecuteThreaded(MlasBlockQuantGemmThreaded, &WorkBlock, WorkBlock.ThreadCount, ThreadPool);
+}
@@ -0,0 +1,233 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bqgemm_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the kernels that multiply a row of matrix A by a
+    panel of a block quantized matrix B using the AVX2 and FMA3 instructions.
+
+    The weights of a row of the panel are sign or zero extended directly to
+    32-bit integers, so decoding 16 weights takes a few instructions instead
+    of the unpack sequences of the SSE2 kernel in bqgemm.cpp.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of a panel of the packed matrix B, which must
+// match the value in bqgemm.cpp.
+//
+
+#define MLAS_BQGEMM_STRIDEN                 16
+
+template<size_t Bits>
+MLAS_FORCEINLINE
+void
+MlasBlockQuantGemmDecodeRowFma3(
+    const uint8_t* Row,
+    __m256& Weights0,
+    __m256& Weights1
+    )
+/*++
+
+Routine Description:
+
+    This routine decodes the 16 quantized weights of a row of a panel to
+    single precision values, without the scales applied.
+
+Arguments:
+
+    Row - Supplies the address of the row of the panel.
+
+    Weights0 - Receives the weights of the first 8 columns of the panel.
+
+    Weights1 - Receives the weights of the last 8 columns of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Bits == 8) {
+        Weights0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)Row)));
+        Weights1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(Row + 8))));
+    } else {
+        const __m256i Bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)Row));
+        const __m256i Offset = _mm256_set1_epi32(8);
+        Weights0 = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(Bytes, _mm256_set1_epi32(0x0F)), Offset));
+        Weights1 = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(Bytes, 4), Offset));
+    }
+}
+
+template<size_t Bits>
+MLAS_FORCEINLINE
+void
+MlasBlockQuantGemvKernelFma3(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of matrix B. The
+    unscaled products of each block are accumulated separately and scaled
+    once at the end of the block. Two rows of the panel are multiplied at a
+    time to two sets of accumulators to hide the latency of the FMA.
+
+Arguments:
+
+    A - Supplies the address of the row of matrix A.
+
+    Panel - Supplies the address of the panel of matrix B.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    BlockSize - Supplies the number of rows of a block.
+
+    Bias - Supplies the bias of the 16 columns of the panel, else nullptr.
+
+    Output - Receives the 16 output values of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+    const size_t RowBytes = MLAS_BQGEMM_STRIDEN * Bits / 8;
+
+    const float* PanelScales = reinterpret_cast<const float*>(Panel);
+    const uint8_t* Row = Panel + BlockCount * MLAS_BQGEMM_STRIDEN * sizeof(float);
+
+    __m256 Accumulator0 = (Bias != nullptr) ? _mm256_loadu_ps(Bias) : _mm256_setzero_ps();
+    __m256 Accumulator1 = (Bias != nullptr) ? _mm256_loadu_ps(Bias + 8) : _mm256_setzero_ps();
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const size_t StartK = b * BlockSize;
+        const size_t EndK = std::min(StartK + BlockSize, K);
+
+        __m256 BlockAccumulator0 = _mm256_setzero_ps();
+        __m256 BlockAccumulator1 = _mm256_setzero_ps();
+        __m256 BlockAccumulator2 = _mm256_setzero_ps();
+        __m256 BlockAccumulator3 = _mm256_setzero_ps();
+
+        size_t k = StartK;
+
+        for (; k + 2 <= EndK; k += 2) {
+
+            __m256 Weights0, Weights1, Weights2, Weights3;
+
+            MlasBlockQuantGemmDecodeRowFma3<Bits>(Row, Weights0, Weights1);
+            MlasBlockQuantGemmDecodeRowFma3<Bits>(Row + RowBytes, Weights2, Weights3);
+
+            const __m256 ValueA0 = _mm256_broadcast_ss(A + k);
+            const __m256 ValueA1 = _mm256_broadcast_ss(A + k + 1);
+
+            BlockAccumulator0 = _mm256_fmadd_ps(Weights0, ValueA0, BlockAccumulator0);
+            BlockAccumulator1 = _mm256_fmadd_ps(Weights1, ValueA0, BlockAccumulator1);
+            BlockAccumulator2 = _mm256_fmadd_ps(Weights2, ValueA1, BlockAccumulator2);
+            BlockAccumulator3 = _mm256_fmadd_ps(Weights3, ValueA1, BlockAccumulator3);
+
+            Row += 2 * RowBytes;
+        }
+
+        if (k < EndK) {
+
+            __m256 Weights0, Weights1;
+
+            MlasBlockQuantGemmDecodeRowFma3<Bits>(Row, Weights0, Weights1);
+
+            const __m256 ValueA0 = _mm256_broadcast_ss(A + k);
+
+            BlockAccumulator0 = _mm256_fmadd_ps(Weights0, ValueA0, BlockAccumulator0);
+            BlockAccumulator1 = _mm256_fmadd_ps(Weights1, ValueA0, BlockAccumulator1);
+
+            Row += RowBytes;
+        }
+
+        const float* s = PanelScales + b * MLAS_BQGEMM_STRIDEN;
+
+        Accumulator0 = _mm256_fmadd_ps(_mm256_add_ps(BlockAccumulator0, BlockAccumulator2),
+            _mm256_loadu_ps(s), Accumulator0);
+        Accumulator1 = _mm256_fmadd_ps(_mm256_add_ps(BlockAccumulator1, BlockAccumulator3),
+            _mm256_loadu_ps(s + 8), Accumulator1);
+    }
+
+    _mm256_storeu_ps(Output, Accumulator0);
+    _mm256_storeu_ps(Output + 8, Accumulator1);
+}
+
+void
+MLASCALL
+MlasBlockQuantGemvQ8KernelFma3(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of 8-bit weights.
+
+Arguments:
+
+    See MlasBlockQuantGemvKernelFma3.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBlockQuantGemvKernelFma3<8>(A, Panel, K, BlockSize, Bias, Output);
+}
+
+void
+MLASCALL
+MlasBlockQuantGemvQ4KernelFma3(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a row of matrix A by a panel of 4-bit weights.
+
+Arguments:
+
+    See MlasBlockQuantGemvKernelFma3.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasBlockQuantGemvKernelFma3<4>(A, Panel, K, BlockSize, Bias, Output);
+}
@@ -0,0 +1,1352 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements routines to compute the exponential function, the
+    softmax and log softmax functions, sum and maximum reductions, and the
+    mean/variance and scale/shift steps of the normalization operators.
+
+    The exponential function uses the range reduction and polynomial
+    coefficients found in Cephes. The implementation below targets the base
+    instruction set (SSE2 or NEON) while the implementations in the compute
+    kernel modules target newer instruction sets (such as FMA3 and AVX512F).
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Bundles the floating point constants for use by the kernels.
+//
+
+MLAS_INTERNAL_DATA const MLAS_EXP_CONSTANTS MlasExpConstants = {
+    -103.9720840454f,
+    88.7762626647950f,
+    -87.3365402222f,
+    12582912.0f,
+    1.44269504088896341f,
+    -0.693359375f,
+    2.12194440e-4f,
+    1.9875691500e-4f,
+    1.3981999507e-3f,
+    8.3334519073e-3f,
+    4.1665795894e-2f,
+    1.6666665459e-1f,
+    5.0000001201e-1f,
+    -126.0f,
+    127.0f,
+};
+
+//
+// Define the number of columns of a strided reduction that are accumulated by
+// a single work item.
+//
+
+#define MLAS_REDUCE_STRIDED_BLOCK                   256
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector,
+    float LowerRange
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+    LowerRange - Supplies the value that the input is clamped to from below.
+        If the value is no less than MlasExpConstants.MinimumExponent * ln(2),
+        then a single power of two scales the result.
+
+Return Value:
+
+    Returns the exponential of each element.
+
+--*/
+{
+    Vector = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(LowerRange), Vector);
+    Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+
+    //
+    // Round Vector/ln(2) to the nearest integer m by adding and subtracting a
+    // bias that pushes the fractional bits out of the mantissa.
+    //
+
+    MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+    MLAS_FLOAT32X4 m = MlasMultiplyAddFloat32x4(Vector, MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = MlasSubtractFloat32x4(m, RoundingBias);
+
+    //
+    // Compute the reduced argument r = Vector - m * ln(2) in two steps so that
+    // the product of the high part is exact.
+    //
+
+    MLAS_FLOAT32X4 r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), r);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasExpConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(1.0f));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(1.0f));
+
+    //
+    // Scale by 2^m. If m may be outside the normal exponent range, then split
+    // the scale into two powers of two that are each in range.
+    //
+
+    if (LowerRange < MlasExpConstants.LowerRangeSumExp) {
+
+        MLAS_FLOAT32X4 m1 = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.MinimumExponent), m);
+        m1 = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.MaximumExponent), m1);
+
+        p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(MlasSubtractFloat32x4(m, m1)));
+        m = m1;
+    }
+
+    return MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m));
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+    float Buffer[4];
+    MlasStoreFloat32x4(Buffer, Vector);
+    return (Buffer[0] + Buffer[1]) + (Buffer[2] + Buffer[3]);
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceMaximumFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+    float Buffer[4];
+    MlasStoreFloat32x4(Buffer, Vector);
+    return (std::max)((std::max)(Buffer[0], Buffer[1]), (std::max)(Buffer[2], Buffer[3]));
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceMinimumFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+    float Buffer[4];
+    MlasStoreFloat32x4(Buffer, Vector);
+    return (std::min)((std::min)(Buffer[0], Buffer[1]), (std::min)(Buffer[2], Buffer[3]));
+}
+
+void
+MLASCALL
+MlasComputeExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeExpVector(MlasLoadFloat32x4(Input), MlasExpConstants.LowerRange));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+
+        float Buffer[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        std::copy_n(Input, N, Buffer);
+        MlasStoreFloat32x4(Buffer, MlasComputeExpVector(MlasLoadFloat32x4(Buffer), MlasExpConstants.LowerRange));
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for computing the sum of the
+    exponential function of the input shifted by a constant.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. If not null, then each
+        exponential is also stored to this buffer.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the value added to each element before computing
+        the exponential, typically the negated maximum of the input so that the
+        exponentials do not overflow.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(*NegativeMaximum);
+    MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+        MLAS_FLOAT32X4 Vector1 = MlasAddFloat32x4(MlasLoadFloat32x4(Input + 4), NegativeMaximumVector);
+
+        Vector0 = MlasComputeExpVector(Vector0, MlasExpConstants.LowerRangeSumExp);
+        Vector1 = MlasComputeExpVector(Vector1, MlasExpConstants.LowerRangeSumExp);
+
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, Vector0);
+        Accumulator1 = MlasAddFloat32x4(Accumulator1, Vector1);
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector0);
+            MlasStoreFloat32x4(Output + 4, Vector1);
+            Output += 8;
+        }
+
+        Input += 8;
+        N -= 8;
+    }
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+
+        Vector = MlasComputeExpVector(Vector, MlasExpConstants.LowerRangeSumExp);
+
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, Vector);
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector);
+            Output += 4;
+        }
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+
+    if (N > 0) {
+
+        float Buffer[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        std::copy_n(Input, N, Buffer);
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Buffer), NegativeMaximumVector);
+        MlasStoreFloat32x4(Buffer, MlasComputeExpVector(Vector, MlasExpConstants.LowerRangeSumExp));
+
+        for (size_t n = 0; n < N; n++) {
+            Sum += Buffer[n];
+        }
+
+        if (Output != nullptr) {
+            std::copy_n(Buffer, N, Output);
+        }
+    }
+
+    return Sum;
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for computing the maximum of a
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum element.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Maximum0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Maximum1 = Maximum0;
+
+        Input += 4;
+        N -= 4;
+
+        while (N >= 8) {
+
+            Maximum0 = MlasMaximumFloat32x4(Maximum0, MlasLoadFloat32x4(Input));
+            Maximum1 = MlasMaximumFloat32x4(Maximum1, MlasLoadFloat32x4(Input + 4));
+
+            Input += 8;
+            N -= 8;
+        }
+
+        while (N >= 4) {
+
+            Maximum0 = MlasMaximumFloat32x4(Maximum0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Maximum = MlasReduceMaximumFloat32x4(MlasMaximumFloat32x4(Maximum0, Maximum1));
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input++);
+
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+void
+MLASCALL
+MlasReduceMinimumMaximumF32Kernel(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for computing the minimum and
+    maximum of a buffer in a single pass.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Minimum - Supplies the address that receives the minimum element.
+
+    Maximum - Supplies the address that receives the maximum element.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float MinimumValue = std::numeric_limits<float>::max();
+    float MaximumValue = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Minimum0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Minimum1 = Minimum0;
+        MLAS_FLOAT32X4 Maximum0 = Minimum0;
+        MLAS_FLOAT32X4 Maximum1 = Minimum0;
+
+        Input += 4;
+        N -= 4;
+
+        while (N >= 8) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+            MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+            Minimum0 = MlasMinimumFloat32x4(Minimum0, Vector0);
+            Minimum1 = MlasMinimumFloat32x4(Minimum1, Vector1);
+            Maximum0 = MlasMaximumFloat32x4(Maximum0, Vector0);
+            Maximum1 = MlasMaximumFloat32x4(Maximum1, Vector1);
+
+            Input += 8;
+            N -= 8;
+        }
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+
+            Minimum0 = MlasMinimumFloat32x4(Minimum0, Vector0);
+            Maximum0 = MlasMaximumFloat32x4(Maximum0, Vector0);
+
+            Input += 4;
+            N -= 4;
+        }
+
+        MinimumValue = MlasReduceMinimumFloat32x4(MlasMinimumFloat32x4(Minimum0, Minimum1));
+        MaximumValue = MlasReduceMaximumFloat32x4(MlasMaximumFloat32x4(Maximum0, Maximum1));
+    }
+
+    while (N > 0) {
+
+        MinimumValue = (std::min)(MinimumValue, *Input);
+        MaximumValue = (std::max)(MaximumValue, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    *Minimum = MinimumValue;
+    *Maximum = MaximumValue;
+}
+
+float
+MLASCALL
+MlasReduceSumF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for computing the sum of a
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the sum of the elements.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+    while (N >= 8) {
+
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(Input));
+        Accumulator1 = MlasAddFloat32x4(Accumulator1, MlasLoadFloat32x4(Input + 4));
+
+        Input += 8;
+        N -= 8;
+    }
+
+    while (N >= 4) {
+
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(Input));
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+
+    while (N > 0) {
+
+        Sum += *Input++;
+
+        N -= 1;
+    }
+
+    return Sum;
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ComputeExpF32Kernel(Input, Output, N);
+#else
+    MlasComputeExpF32Kernel(Input, Output, N);
+#endif
+}
+
+//
+// Stores the parameters for a threaded softmax or reduction operation.
+//
+
+struct MLAS_COMPUTE_WORK_BLOCK {
+    int32_t ThreadCountN;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    size_t InnerCount;
+    bool LogSoftmax;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_COMPUTE_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    const size_t D = WorkBlock->D;
+    const bool LogSoftmax = WorkBlock->LogSoftmax;
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+    while (CountN > 0) {
+
+#if defined(MLAS_TARGET_AMD64)
+        float Maximum = MlasPlatform.ReduceMaximumF32Kernel(Input, D);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+#endif
+        float NegativeMaximum = -Maximum;
+
+        //
+        // The log softmax only needs the sum of the exponentials, while the
+        // softmax also keeps the exponentials to be scaled by the reciprocal
+        // of the sum.
+        //
+
+#if defined(MLAS_TARGET_AMD64)
+        float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, LogSoftmax ? nullptr : Output, D, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(Input, LogSoftmax ? nullptr : Output, D, &NegativeMaximum);
+#endif
+
+        if (LogSoftmax) {
+
+            float Offset = NegativeMaximum - std::log(Accumulation);
+            MLAS_FLOAT32X4 OffsetVector = MlasBroadcastFloat32x4(Offset);
+
+            size_t d = 0;
+
+            for (; d + 4 <= D; d += 4) {
+                MlasStoreFloat32x4(Output + d, MlasAddFloat32x4(MlasLoadFloat32x4(Input + d), OffsetVector));
+            }
+
+            for (; d < D; d++) {
+                Output[d] = Input[d] + Offset;
+            }
+
+        } else {
+
+            float Scale = 1.0f / Accumulation;
+            MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+            size_t d = 0;
+
+            for (; d + 4 <= D; d += 4) {
+                MlasStoreFloat32x4(Output + d, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output + d), ScaleVector));
+            }
+
+            for (; d < D; d++) {
+                Output[d] *= Scale;
+            }
+        }
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+int32_t
+MlasComputeThreadCount(
+    size_t WorkCount,
+    size_t ElementCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of threads to use for an operation that
+    touches the specified number of elements split into the specified number
+    of independent work items.
+
+Arguments:
+
+    WorkCount - Supplies the number of independent work items.
+
+    ElementCount - Supplies the total number of elements.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns the number of threads.
+
+--*/
+{
+    const size_t ThreadElements = MlasPlatform.CostModel.ComputeThreadElements;
+
+    size_t ThreadCount = (ElementCount + ThreadElements - 1) / ThreadElements;
+
+    const size_t MaximumThreadCount = size_t(MlasGetMaximumThreadCount(ThreadPool));
+
+    if (ThreadCount > MaximumThreadCount) {
+        ThreadCount = MaximumThreadCount;
+    }
+
+    if (ThreadCount > WorkCount) {
+        ThreadCount = WorkCount;
+    }
+
+    return ThreadCount > 0 ? int32_t(ThreadCount) : 1;
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for each row of
+    a matrix.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    Output - Supplies the output matrix. The output may alias the input.
+
+    N - Supplies the number of rows.
+
+    D - Supplies the number of columns, which are normalized together.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed
+        instead of the softmax function.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    MLAS_COMPUTE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ThreadCountN = MlasComputeThreadCount(N, N * D, ThreadPool);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.InnerCount = 1;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, WorkBlock.ThreadCountN, ThreadPool);
+}
+
+template<bool IsMaximum>
+void
+MlasReduceThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    sum or maximum reduction.
+
+    Each work item is either a block of rows reduced along the innermost axis
+    or, for a strided reduction, a block of columns of one outer slice, where
+    each column is reduced across the rows with vector operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_COMPUTE_WORK_BLOCK*)Context;
+
+    const size_t ReduceCount = WorkBlock->D;
+    const size_t InnerCount = WorkBlock->InnerCount;
+
+    if (InnerCount == 1) {
+
+        size_t n;
+        size_t CountN;
+
+        MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+        const float* Input = WorkBlock->Input + n * ReduceCount;
+        float* Output = WorkBlock->Output + n;
+
+        for (size_t i = 0; i < CountN; i++) {
+#if defined(MLAS_TARGET_AMD64)
+            Output[i] = IsMaximum ? MlasPlatform.ReduceMaximumF32Kernel(Input, ReduceCount) :
+                MlasPlatform.ReduceSumF32Kernel(Input, ReduceCount);
+#else
+            Output[i] = IsMaximum ? MlasReduceMaximumF32Kernel(Input, ReduceCount) :
+                MlasReduceSumF32Kernel(Input, ReduceCount);
+#endif
+            Input += ReduceCount;
+        }
+
+        return;
+    }
+
+    //
+    // Partition the blocks of columns of every outer slice.
+    //
+
+    const size_t BlockCountPerSlice = (InnerCount + MLAS_REDUCE_STRIDED_BLOCK - 1) / MLAS_REDUCE_STRIDED_BLOCK;
+
+    size_t WorkIndex;
+    size_t WorkCount;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N * BlockCountPerSlice, &WorkIndex, &WorkCount);
+
+    while (WorkCount > 0) {
+
+        const size_t Slice = WorkIndex / BlockCountPerSlice;
+        const size_t Column = (WorkIndex % BlockCountPerSlice) * MLAS_REDUCE_STRIDED_BLOCK;
+        const size_t ColumnCount = (std::min)(InnerCount - Column, size_t(MLAS_REDUCE_STRIDED_BLOCK));
+
+        const float* Input = WorkBlock->Input + Slice * ReduceCount * InnerCount + Column;
+        float* Output = WorkBlock->Output + Slice * InnerCount + Column;
+
+        //
+        // Initialize the output from the first row and then accumulate the
+        // remaining rows.
+        //
+
+        std::copy_n(Input, ColumnCount, Output);
+
+        for (size_t r = 1; r < ReduceCount; r++) {
+
+            Input += InnerCount;
+
+            size_t c = 0;
+
+            for (; c + 4 <= ColumnCount; c += 4) {
+
+                MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(Output + c);
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + c);
+
+                Accumulator = IsMaximum ? MlasMaximumFloat32x4(Accumulator, Vector) :
+                    MlasAddFloat32x4(Accumulator, Vector);
+
+                MlasStoreFloat32x4(Output + c, Accumulator);
+            }
+
+            for (; c < ColumnCount; c++) {
+                Output[c] = IsMaximum ? (std::max)(Output[c], Input[c]) : Output[c] + Input[c];
+            }
+        }
+
+        WorkIndex++;
+        WorkCount--;
+    }
+}
+
+template<bool IsMaximum>
+void
+MlasReduce(
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the middle axis of a tensor viewed as the shape
+    [OuterCount, ReduceCount, InnerCount].
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor of shape [OuterCount, InnerCount].
+
+    OuterCount - Supplies the product of the dimensions before the reduced axes.
+
+    ReduceCount - Supplies the product of the reduced dimensions.
+
+    InnerCount - Supplies the product of the dimensions after the reduced axes.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OuterCount == 0 || InnerCount == 0) {
+        return;
+    }
+
+    //
+    // The reduction of an empty axis is the identity of the operation.
+    //
+
+    if (ReduceCount == 0) {
+        std::fill_n(Output, OuterCount * InnerCount,
+            IsMaximum ? std::numeric_limits<float>::lowest() : 0.0f);
+        return;
+    }
+
+    size_t WorkCount = OuterCount;
+
+    if (InnerCount > 1) {
+        WorkCount *= (InnerCount + MLAS_REDUCE_STRIDED_BLOCK - 1) / MLAS_REDUCE_STRIDED_BLOCK;
+    }
+
+    MLAS_COMPUTE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ThreadCountN = MlasComputeThreadCount(WorkCount, OuterCount * ReduceCount * InnerCount, ThreadPool);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = OuterCount;
+    WorkBlock.D = ReduceCount;
+    WorkBlock.InnerCount = InnerCount;
+    WorkBlock.LogSoftmax = false;
+
+    MlasExecuteThreaded(MlasReduceThreaded<IsMaximum>, &WorkBlock, WorkBlock.ThreadCountN, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReduceSum(
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the middle axis of a tensor viewed as the
+    shape [OuterCount, ReduceCount, InnerCount].
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor of shape [OuterCount, InnerCount].
+
+    OuterCount - Supplies the product of the dimensions before the reduced axes.
+
+    ReduceCount - Supplies the product of the reduced dimensions.
+
+    InnerCount - Supplies the product of the dimensions after the reduced axes.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasReduce<false>(Input, Output, OuterCount, ReduceCount, InnerCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReduceMaximum(
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum of the middle axis of a tensor viewed as
+    the shape [OuterCount, ReduceCount, InnerCount].
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor of shape [OuterCount, InnerCount].
+
+    OuterCount - Supplies the product of the dimensions before the reduced axes.
+
+    ReduceCount - Supplies the product of the reduced dimensions.
+
+    InnerCount - Supplies the product of the dimensions after the reduced axes.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasReduce<true>(Input, Output, OuterCount, ReduceCount, InnerCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasReduceMinimumMaximum(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the minimum and maximum of a buffer in a single
+    pass.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Minimum - Supplies the address that receives the minimum element, or the
+        largest float value if the buffer is empty.
+
+    Maximum - Supplies the address that receives the maximum element, or the
+        lowest float value if the buffer is empty.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ReduceMinimumMaximumF32Kernel(Input, Minimum, Maximum, N);
+#else
+    MlasReduceMinimumMaximumF32Kernel(Input, Minimum, Maximum, N);
+#endif
+}
+
+//
+// Stores the parameters for a threaded mean/variance or scale/shift operation.
+//
+
+struct MLAS_NORMALIZE_WORK_BLOCK {
+    int32_t ThreadCountN;
+    const float* Input;
+    float* Output;
+    float* Mean;
+    float* Variance;
+    const float* Scale;
+    const float* Shift;
+    size_t RowCount;
+    size_t RowSize;
+    size_t ScaleCount;
+};
+
+void
+MlasReduceMeanVarianceThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to compute the mean and
+    variance of a block of rows.
+
+    Each row is read twice: once for the sum and once for the squared
+    deviations from the mean, which is more accurate than accumulating the sum
+    of squares and usually reads the second time from the cache.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NORMALIZE_WORK_BLOCK*)Context;
+
+    const size_t RowSize = WorkBlock->RowSize;
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->RowCount, &n, &CountN);
+
+    const float* Input = WorkBlock->Input + n * RowSize;
+
+    for (size_t row = n; row < n + CountN; row++) {
+
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+        size_t i = 0;
+
+        for (; i + 8 <= RowSize; i += 8) {
+            Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(Input + i));
+            Accumulator1 = MlasAddFloat32x4(Accumulator1, MlasLoadFloat32x4(Input + i + 4));
+        }
+
+        float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+
+        for (; i < RowSize; i++) {
+            Sum += Input[i];
+        }
+
+        const float Mean = Sum / float(RowSize);
+        const MLAS_FLOAT32X4 MeanBroadcast = MlasBroadcastFloat32x4(Mean);
+
+        Accumulator0 = MlasZeroFloat32x4();
+        Accumulator1 = MlasZeroFloat32x4();
+
+        i = 0;
+
+        for (; i + 8 <= RowSize; i += 8) {
+            MLAS_FLOAT32X4 Deviation0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + i), MeanBroadcast);
+            MLAS_FLOAT32X4 Deviation1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + i + 4), MeanBroadcast);
+            Accumulator0 = MlasMultiplyAddFloat32x4(Deviation0, Deviation0, Accumulator0);
+            Accumulator1 = MlasMultiplyAddFloat32x4(Deviation1, Deviation1, Accumulator1);
+        }
+
+        float SquaredDeviations = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+
+        for (; i < RowSize; i++) {
+            const float Deviation = Input[i] - Mean;
+            SquaredDeviations += Deviation * Deviation;
+        }
+
+        WorkBlock->Mean[row] = Mean;
+        WorkBlock->Variance[row] = SquaredDeviations / float(RowSize);
+
+        Input += RowSize;
+    }
+}
+
+void
+MLASCALL
+MlasReduceMeanVariance(
+    const float* Input,
+    float* Mean,
+    float* Variance,
+    size_t RowCount,
+    size_t RowSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the population variance of each row of
+    a matrix.
+
+Arguments:
+
+    Input - Supplies the input matrix of shape [RowCount, RowSize].
+
+    Mean - Supplies the buffer that receives the RowCount means.
+
+    Variance - Supplies the buffer that receives the RowCount variances.
+
+    RowCount - Supplies the number of rows.
+
+    RowSize - Supplies the number of elements of each row, which must not be
+        zero.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (RowCount == 0) {
+        return;
+    }
+
+    MLAS_NORMALIZE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ThreadCountN = MlasComputeThreadCount(RowCount, 2 * RowCount * RowSize, ThreadPool);
+    WorkBlock.Input = Input;
+    WorkBlock.Mean = Mean;
+    WorkBlock.Variance = Variance;
+    WorkBlock.RowCount = RowCount;
+    WorkBlock.RowSize = RowSize;
+
+    MlasExecuteThreaded(MlasReduceMeanVarianceThreaded, &WorkBlock, WorkBlock.ThreadCountN, ThreadPool);
+}
+
+void
+MlasComputeScaleShiftThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to scale and shift a block of
+    rows.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NORMALIZE_WORK_BLOCK*)Context;
+
+    const size_t RowSize = WorkBlock->RowSize;
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->RowCount, &n, &CountN);
+
+    const float* Input = WorkBlock->Input + n * RowSize;
+    float* Output = WorkBlock->Output + n * RowSize;
+
+    for (size_t row = n; row < n + CountN; row++) {
+
+        const float Scale = WorkBlock->Scale[row % WorkBlock->ScaleCount];
+        const float Shift = WorkBlock->Shift[row % WorkBlock->ScaleCount];
+
+        const MLAS_FLOAT32X4 ScaleBroadcast = MlasBroadcastFloat32x4(Scale);
+        const MLAS_FLOAT32X4 ShiftBroadcast = MlasBroadcastFloat32x4(Shift);
+
+        size_t i = 0;
+
+        for (; i + 8 <= RowSize; i += 8) {
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + i);
+            MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + i + 4);
+            MlasStoreFloat32x4(Output + i, MlasMultiplyAddFloat32x4(Vector0, ScaleBroadcast, ShiftBroadcast));
+            MlasStoreFloat32x4(Output + i + 4, MlasMultiplyAddFloat32x4(Vector1, ScaleBroadcast, ShiftBroadcast));
+        }
+
+        for (; i < RowSize; i++) {
+            Output[i] = Input[i] * Scale + Shift;
+        }
+
+        Input += RowSize;
+        Output += RowSize;
+    }
+}
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Shift,
+    size_t ScaleCount,
+    size_t RowCount,
+    size_t RowSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies each row of a matrix by a scale and adds a shift,
+    which is the final step of the batch, instance and mean/variance
+    normalizations once the statistics are folded into the scale and shift.
+
+Arguments:
+
+    Input - Supplies the input matrix of shape [RowCount, RowSize].
+
+    Output - Supplies the output matrix of shape [RowCount, RowSize]. The
+        output may be the same buffer as the input.
+
+    Scale - Supplies the ScaleCount scales. Row i uses Scale[i % ScaleCount].
+
+    Shift - Supplies the ScaleCount shifts. Row i uses Shift[i % ScaleCount].
+
+    ScaleCount - Supplies the number of scales and shifts, such as the channel
+        count of a NCHW tensor viewed as [N * C, H * W].
+
+    RowCount - Supplies the number of rows.
+
+    RowSize - Supplies the number of elements of each row.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (RowCount == 0 || RowSize == 0) {
+        return;
+    }
+
+    MLAS_NORMALIZE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ThreadCountN = MlasComputeThreadCount(RowCount, RowCount * RowSize, ThreadPool);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Shift = Shift;
+    WorkBlock.RowCount = RowCount;
+    WorkBlock.RowSize = RowSize;
+    WorkBlock.ScaleCount = ScaleCount;
+
+    MlasExecuteThreaded(MlasComputeScaleShiftThreaded, &WorkBlock, WorkBlock.ThreadCountN, ThreadPool);
+}
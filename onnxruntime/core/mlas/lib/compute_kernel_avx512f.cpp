@@ -0,0 +1,404 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_avx512f.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential function, the sum
+    of exponentials and the maximum, sum and minimum/maximum reductions using
+    the AVX512F instructions.
+
+    The exponential function uses the same algorithm and constants as the
+    generic kernel in compute.cpp, except that the scale by the power of two is
+    done by VSCALEFPS, which handles the full exponent range directly.
+
+--*/
+
+//
+// GCC 12 reports the _mm512_undefined_ps() used by the AVX512F intrinsics as
+// uninitialized (GCC bug 105593), so disable the warning before the intrinsic
+// headers are included.
+//
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+__m512
+MlasComputeExpVectorAvx512F(
+    __m512 Vector,
+    float LowerRange
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+    LowerRange - Supplies the value that the input is clamped to from below.
+
+Return Value:
+
+    Returns the exponential of each element.
+
+--*/
+{
+    Vector = _mm512_max_ps(_mm512_set1_ps(LowerRange), Vector);
+    Vector = _mm512_min_ps(_mm512_set1_ps(MlasExpConstants.UpperRange), Vector);
+
+    const __m512 RoundingBias = _mm512_set1_ps(MlasExpConstants.RoundingBias);
+    __m512 m = _mm512_fmadd_ps(Vector, _mm512_set1_ps(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = _mm512_sub_ps(m, RoundingBias);
+
+    __m512 r = _mm512_fmadd_ps(m, _mm512_set1_ps(MlasExpConstants.Log2High), Vector);
+    r = _mm512_fmadd_ps(m, _mm512_set1_ps(MlasExpConstants.Log2Low), r);
+
+    __m512 p = _mm512_set1_ps(MlasExpConstants.poly_0);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(MlasExpConstants.poly_1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(MlasExpConstants.poly_2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(MlasExpConstants.poly_3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(MlasExpConstants.poly_4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(MlasExpConstants.poly_5));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.0f));
+
+    return _mm512_scalef_ps(p, m);
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasTailMaskAvx512F(
+    size_t N
+    )
+{
+    return __mmask16((1u << N) - 1);
+}
+
+void
+MLASCALL
+MlasComputeExpF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 16) {
+
+        _mm512_storeu_ps(Output, MlasComputeExpVectorAvx512F(_mm512_loadu_ps(Input), MlasExpConstants.LowerRange));
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+
+        __mmask16 Mask = MlasTailMaskAvx512F(N);
+        __m512 Vector = MlasComputeExpVectorAvx512F(_mm512_maskz_loadu_ps(Mask, Input), MlasExpConstants.LowerRange);
+        _mm512_mask_storeu_ps(Output, Mask, Vector);
+    }
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32KernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the sum of the
+    exponential function of the input shifted by a constant.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. If not null, then each
+        exponential is also stored to this buffer.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the value added to each element before computing
+        the exponential.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    const __m512 NegativeMaximumVector = _mm512_set1_ps(*NegativeMaximum);
+    __m512 Accumulator0 = _mm512_setzero_ps();
+    __m512 Accumulator1 = _mm512_setzero_ps();
+
+    while (N >= 32) {
+
+        __m512 Vector0 = _mm512_add_ps(_mm512_loadu_ps(Input), NegativeMaximumVector);
+        __m512 Vector1 = _mm512_add_ps(_mm512_loadu_ps(Input + 16), NegativeMaximumVector);
+
+        Vector0 = MlasComputeExpVectorAvx512F(Vector0, MlasExpConstants.LowerRangeSumExp);
+        Vector1 = MlasComputeExpVectorAvx512F(Vector1, MlasExpConstants.LowerRangeSumExp);
+
+        Accumulator0 = _mm512_add_ps(Accumulator0, Vector0);
+        Accumulator1 = _mm512_add_ps(Accumulator1, Vector1);
+
+        if (Output != nullptr) {
+            _mm512_storeu_ps(Output, Vector0);
+            _mm512_storeu_ps(Output + 16, Vector1);
+            Output += 32;
+        }
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N > 0) {
+
+        __mmask16 Mask = MlasTailMaskAvx512F((std::min)(N, size_t(16)));
+        __m512 Vector = _mm512_add_ps(_mm512_maskz_loadu_ps(Mask, Input), NegativeMaximumVector);
+
+        Vector = MlasComputeExpVectorAvx512F(Vector, MlasExpConstants.LowerRangeSumExp);
+
+        Accumulator0 = _mm512_mask_add_ps(Accumulator0, Mask, Accumulator0, Vector);
+
+        if (Output != nullptr) {
+            _mm512_mask_storeu_ps(Output, Mask, Vector);
+            Output += 16;
+        }
+
+        Input += 16;
+        N -= (std::min)(N, size_t(16));
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(Accumulator0, Accumulator1));
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32KernelAvx512F(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the maximum of
+    a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum element.
+
+--*/
+{
+    const __m512 Lowest = _mm512_set1_ps(std::numeric_limits<float>::lowest());
+    __m512 Maximum0 = Lowest;
+    __m512 Maximum1 = Lowest;
+    __m512 Maximum2 = Lowest;
+    __m512 Maximum3 = Lowest;
+
+    while (N >= 64) {
+
+        Maximum0 = _mm512_max_ps(Maximum0, _mm512_loadu_ps(Input));
+        Maximum1 = _mm512_max_ps(Maximum1, _mm512_loadu_ps(Input + 16));
+        Maximum2 = _mm512_max_ps(Maximum2, _mm512_loadu_ps(Input + 32));
+        Maximum3 = _mm512_max_ps(Maximum3, _mm512_loadu_ps(Input + 48));
+
+        Input += 64;
+        N -= 64;
+    }
+
+    while (N >= 16) {
+
+        Maximum0 = _mm512_max_ps(Maximum0, _mm512_loadu_ps(Input));
+
+        Input += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+        Maximum1 = _mm512_max_ps(Maximum1, _mm512_mask_loadu_ps(Lowest, MlasTailMaskAvx512F(N), Input));
+    }
+
+    Maximum0 = _mm512_max_ps(_mm512_max_ps(Maximum0, Maximum1), _mm512_max_ps(Maximum2, Maximum3));
+
+    return _mm512_reduce_max_ps(Maximum0);
+}
+
+void
+MLASCALL
+MlasReduceMinimumMaximumF32KernelAvx512F(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the minimum and
+    maximum of a buffer in a single pass.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Minimum - Supplies the address that receives the minimum element.
+
+    Maximum - Supplies the address that receives the maximum element.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m512 Largest = _mm512_set1_ps(std::numeric_limits<float>::max());
+    const __m512 Lowest = _mm512_set1_ps(std::numeric_limits<float>::lowest());
+    __m512 Minimum0 = Largest;
+    __m512 Minimum1 = Largest;
+    __m512 Maximum0 = Lowest;
+    __m512 Maximum1 = Lowest;
+
+    while (N >= 32) {
+
+        __m512 Vector0 = _mm512_loadu_ps(Input);
+        __m512 Vector1 = _mm512_loadu_ps(Input + 16);
+
+        Minimum0 = _mm512_min_ps(Minimum0, Vector0);
+        Minimum1 = _mm512_min_ps(Minimum1, Vector1);
+        Maximum0 = _mm512_max_ps(Maximum0, Vector0);
+        Maximum1 = _mm512_max_ps(Maximum1, Vector1);
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N >= 16) {
+
+        __m512 Vector0 = _mm512_loadu_ps(Input);
+
+        Minimum0 = _mm512_min_ps(Minimum0, Vector0);
+        Maximum0 = _mm512_max_ps(Maximum0, Vector0);
+
+        Input += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+
+        __mmask16 Mask = MlasTailMaskAvx512F(N);
+
+        Minimum1 = _mm512_min_ps(Minimum1, _mm512_mask_loadu_ps(Largest, Mask, Input));
+        Maximum1 = _mm512_max_ps(Maximum1, _mm512_mask_loadu_ps(Lowest, Mask, Input));
+    }
+
+    *Minimum = _mm512_reduce_min_ps(_mm512_min_ps(Minimum0, Minimum1));
+    *Maximum = _mm512_reduce_max_ps(_mm512_max_ps(Maximum0, Maximum1));
+}
+
+float
+MLASCALL
+MlasReduceSumF32KernelAvx512F(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the sum of a
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the sum of the elements.
+
+--*/
+{
+    __m512 Accumulator0 = _mm512_setzero_ps();
+    __m512 Accumulator1 = _mm512_setzero_ps();
+    __m512 Accumulator2 = _mm512_setzero_ps();
+    __m512 Accumulator3 = _mm512_setzero_ps();
+
+    while (N >= 64) {
+
+        Accumulator0 = _mm512_add_ps(Accumulator0, _mm512_loadu_ps(Input));
+        Accumulator1 = _mm512_add_ps(Accumulator1, _mm512_loadu_ps(Input + 16));
+        Accumulator2 = _mm512_add_ps(Accumulator2, _mm512_loadu_ps(Input + 32));
+        Accumulator3 = _mm512_add_ps(Accumulator3, _mm512_loadu_ps(Input + 48));
+
+        Input += 64;
+        N -= 64;
+    }
+
+    while (N >= 16) {
+
+        Accumulator0 = _mm512_add_ps(Accumulator0, _mm512_loadu_ps(Input));
+
+        Input += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+        Accumulator1 = _mm512_add_ps(Accumulator1, _mm512_maskz_loadu_ps(MlasTailMaskAvx512F(N), Input));
+    }
+
+    Accumulator0 = _mm512_add_ps(_mm512_add_ps(Accumulator0, Accumulator1), _mm512_add_ps(Accumulator2, Accumulator3));
+
+    return _mm512_reduce_add_ps(Accumulator0);
+}
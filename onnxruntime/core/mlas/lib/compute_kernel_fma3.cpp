@@ -0,0 +1,448 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_kernel_fma3.cpp
+
+Abstract:
+
+    This module implements the kernels for the exponential function, the sum
+    of exponentials and the maximum, sum and minimum/maximum reductions using
+    the AVX2 and FMA3 instructions.
+
+    The exponential function uses the same algorithm and constants as the
+    generic kernel in compute.cpp.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+__m256
+MlasComputeExpVectorFma3(
+    __m256 Vector,
+    float LowerRange
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+    LowerRange - Supplies the value that the input is clamped to from below.
+        If the value is less than MlasExpConstants.LowerRangeSumExp, then the
+        scale is split into two powers of two to extend the range.
+
+Return Value:
+
+    Returns the exponential of each element.
+
+--*/
+{
+    Vector = _mm256_max_ps(_mm256_set1_ps(LowerRange), Vector);
+    Vector = _mm256_min_ps(_mm256_set1_ps(MlasExpConstants.UpperRange), Vector);
+
+    const __m256 RoundingBias = _mm256_set1_ps(MlasExpConstants.RoundingBias);
+    __m256 m = _mm256_fmadd_ps(Vector, _mm256_set1_ps(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = _mm256_sub_ps(m, RoundingBias);
+
+    __m256 r = _mm256_fmadd_ps(m, _mm256_set1_ps(MlasExpConstants.Log2High), Vector);
+    r = _mm256_fmadd_ps(m, _mm256_set1_ps(MlasExpConstants.Log2Low), r);
+
+    __m256 p = _mm256_set1_ps(MlasExpConstants.poly_0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(MlasExpConstants.poly_1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(MlasExpConstants.poly_2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(MlasExpConstants.poly_3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(MlasExpConstants.poly_4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(MlasExpConstants.poly_5));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+
+    if (LowerRange < MlasExpConstants.LowerRangeSumExp) {
+
+        __m256 m1 = _mm256_max_ps(_mm256_set1_ps(MlasExpConstants.MinimumExponent), m);
+        m1 = _mm256_min_ps(_mm256_set1_ps(MlasExpConstants.MaximumExponent), m1);
+
+        __m256i e2 = _mm256_add_epi32(_mm256_cvttps_epi32(_mm256_sub_ps(m, m1)), _mm256_set1_epi32(0x7f));
+        p = _mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_slli_epi32(e2, 23)));
+        m = m1;
+    }
+
+    __m256i e = _mm256_add_epi32(_mm256_cvttps_epi32(m), _mm256_set1_epi32(0x7f));
+
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)));
+}
+
+MLAS_FORCEINLINE
+__m256i
+MlasTailMaskFma3(
+    size_t N
+    )
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(N)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceMaximumFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_max_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_max_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_max_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceMinimumFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_min_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_min_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_min_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasComputeExpF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 8) {
+
+        _mm256_storeu_ps(Output, MlasComputeExpVectorFma3(_mm256_loadu_ps(Input), MlasExpConstants.LowerRange));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        __m256i Mask = MlasTailMaskFma3(N);
+        __m256 Vector = MlasComputeExpVectorFma3(_mm256_maskload_ps(Input, Mask), MlasExpConstants.LowerRange);
+        _mm256_maskstore_ps(Output, Mask, Vector);
+    }
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32KernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the sum of the
+    exponential function of the input shifted by a constant.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. If not null, then each
+        exponential is also stored to this buffer.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the value added to each element before computing
+        the exponential.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    const __m256 NegativeMaximumVector = _mm256_broadcast_ss(NegativeMaximum);
+    __m256 Accumulator0 = _mm256_setzero_ps();
+    __m256 Accumulator1 = _mm256_setzero_ps();
+
+    while (N >= 16) {
+
+        __m256 Vector0 = _mm256_add_ps(_mm256_loadu_ps(Input), NegativeMaximumVector);
+        __m256 Vector1 = _mm256_add_ps(_mm256_loadu_ps(Input + 8), NegativeMaximumVector);
+
+        Vector0 = MlasComputeExpVectorFma3(Vector0, MlasExpConstants.LowerRangeSumExp);
+        Vector1 = MlasComputeExpVectorFma3(Vector1, MlasExpConstants.LowerRangeSumExp);
+
+        Accumulator0 = _mm256_add_ps(Accumulator0, Vector0);
+        Accumulator1 = _mm256_add_ps(Accumulator1, Vector1);
+
+        if (Output != nullptr) {
+            _mm256_storeu_ps(Output, Vector0);
+            _mm256_storeu_ps(Output + 8, Vector1);
+            Output += 16;
+        }
+
+        Input += 16;
+        N -= 16;
+    }
+
+    while (N > 0) {
+
+        __m256i Mask = MlasTailMaskFma3(N);
+        __m256 Vector = _mm256_add_ps(_mm256_maskload_ps(Input, Mask), NegativeMaximumVector);
+
+        Vector = MlasComputeExpVectorFma3(Vector, MlasExpConstants.LowerRangeSumExp);
+        Vector = _mm256_and_ps(Vector, _mm256_castsi256_ps(Mask));
+
+        Accumulator0 = _mm256_add_ps(Accumulator0, Vector);
+
+        if (Output != nullptr) {
+            _mm256_maskstore_ps(Output, Mask, Vector);
+            Output += 8;
+        }
+
+        Input += 8;
+        N -= (std::min)(N, size_t(8));
+    }
+
+    return MlasReduceAddFloat32x8(_mm256_add_ps(Accumulator0, Accumulator1));
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32KernelFma3(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the maximum of
+    a buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum element.
+
+--*/
+{
+    const __m256 Lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    __m256 Maximum0 = Lowest;
+    __m256 Maximum1 = Lowest;
+    __m256 Maximum2 = Lowest;
+    __m256 Maximum3 = Lowest;
+
+    while (N >= 32) {
+
+        Maximum0 = _mm256_max_ps(Maximum0, _mm256_loadu_ps(Input));
+        Maximum1 = _mm256_max_ps(Maximum1, _mm256_loadu_ps(Input + 8));
+        Maximum2 = _mm256_max_ps(Maximum2, _mm256_loadu_ps(Input + 16));
+        Maximum3 = _mm256_max_ps(Maximum3, _mm256_loadu_ps(Input + 24));
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N >= 8) {
+
+        Maximum0 = _mm256_max_ps(Maximum0, _mm256_loadu_ps(Input));
+
+        Input += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        __m256i Mask = MlasTailMaskFma3(N);
+        __m256 Vector = _mm256_blendv_ps(Lowest, _mm256_maskload_ps(Input, Mask), _mm256_castsi256_ps(Mask));
+
+        Maximum1 = _mm256_max_ps(Maximum1, Vector);
+    }
+
+    Maximum0 = _mm256_max_ps(_mm256_max_ps(Maximum0, Maximum1), _mm256_max_ps(Maximum2, Maximum3));
+
+    return MlasReduceMaximumFloat32x8(Maximum0);
+}
+
+void
+MLASCALL
+MlasReduceMinimumMaximumF32KernelFma3(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the minimum and
+    maximum of a buffer in a single pass.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Minimum - Supplies the address that receives the minimum element.
+
+    Maximum - Supplies the address that receives the maximum element.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256 Largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+    const __m256 Lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    __m256 Minimum0 = Largest;
+    __m256 Minimum1 = Largest;
+    __m256 Maximum0 = Lowest;
+    __m256 Maximum1 = Lowest;
+
+    while (N >= 16) {
+
+        __m256 Vector0 = _mm256_loadu_ps(Input);
+        __m256 Vector1 = _mm256_loadu_ps(Input + 8);
+
+        Minimum0 = _mm256_min_ps(Minimum0, Vector0);
+        Minimum1 = _mm256_min_ps(Minimum1, Vector1);
+        Maximum0 = _mm256_max_ps(Maximum0, Vector0);
+        Maximum1 = _mm256_max_ps(Maximum1, Vector1);
+
+        Input += 16;
+        N -= 16;
+    }
+
+    while (N >= 8) {
+
+        __m256 Vector0 = _mm256_loadu_ps(Input);
+
+        Minimum0 = _mm256_min_ps(Minimum0, Vector0);
+        Maximum0 = _mm256_max_ps(Maximum0, Vector0);
+
+        Input += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        __m256i Mask = MlasTailMaskFma3(N);
+        __m256 Vector = _mm256_maskload_ps(Input, Mask);
+
+        Minimum1 = _mm256_min_ps(Minimum1, _mm256_blendv_ps(Largest, Vector, _mm256_castsi256_ps(Mask)));
+        Maximum1 = _mm256_max_ps(Maximum1, _mm256_blendv_ps(Lowest, Vector, _mm256_castsi256_ps(Mask)));
+    }
+
+    *Minimum = MlasReduceMinimumFloat32x8(_mm256_min_ps(Minimum0, Minimum1));
+    *Maximum = MlasReduceMaximumFloat32x8(_mm256_max_ps(Maximum0, Maximum1));
+}
+
+float
+MLASCALL
+MlasReduceSumF32KernelFma3(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel for computing the sum of a
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the sum of the elements.
+
+--*/
+{
+    __m256 Accumulator0 = _mm256_setzero_ps();
+    __m256 Accumulator1 = _mm256_setzero_ps();
+    __m256 Accumulator2 = _mm256_setzero_ps();
+    __m256 Accumulator3 = _mm256_setzero_ps();
+
+    while (N >= 32) {
+
+        Accumulator0 = _mm256_add_ps(Accumulator0, _mm256_loadu_ps(Input));
+        Accumulator1 = _mm256_add_ps(Accumulator1, _mm256_loadu_ps(Input + 8));
+        Accumulator2 = _mm256_add_ps(Accumulator2, _mm256_loadu_ps(Input + 16));
+        Accumulator3 = _mm256_add_ps(Accumulator3, _mm256_loadu_ps(Input + 24));
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N >= 8) {
+
+        Accumulator0 = _mm256_add_ps(Accumulator0, _mm256_loadu_ps(Input));
+
+        Input += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+        Accumulator1 = _mm256_add_ps(Accumulator1, _mm256_maskload_ps(Input, MlasTailMaskFma3(N)));
+    }
+
+    Accumulator0 = _mm256_add_ps(_mm256_add_ps(Accumulator0, Accumulator1), _mm256_add_ps(Accumulator2, Accumulator3));
+
+    return MlasReduceAddFloat32x8(Accumulator0);
+}
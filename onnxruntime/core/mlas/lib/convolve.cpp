@@ -558,6 +558,16 @@ Return Value:
 
     size_t CountN;
 
+    //
+    // Apply the activation with optional bias to each tile of the output
+    // from the GEMM for the last slice along the K dimension.
+    //
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+
+    Epilogue.RowBias = Bias;
+    Epilogue.Activation = Parameters->Activation;
+
     for (size_t n = 0; n < SegmentCountN; n += CountN) {
 
         CountN = SegmentCountN - n;
@@ -592,17 +602,10 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, (k + CountK == K) ? &Epilogue : nullptr);
 
             beta = 1.0f;
         }
-
-        //
-        // Apply the activation with optional bias.
-        //
-
-        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
-            CountN, OutputSize);
     }
 }
 
@@ -714,25 +717,224 @@ Return Value:
         float* output = WorkBlock->Output + bg * OutputGroupSize;
 
         //
-        // Invoke the non-threaded GEMM directly with the input tensor.
+        // Invoke the non-threaded GEMM directly with the input tensor and
+        // apply the activation with optional bias to each output tile.
         //
 
+        MLAS_SGEMM_EPILOGUE Epilogue;
+
+        Epilogue.RowBias = WorkBlock->Bias;
+        Epilogue.Activation = Parameters->Activation;
+
+        if (Epilogue.RowBias != nullptr) {
+            Epilogue.RowBias += group * FilterCount;
+        }
+
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
             OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            output, OutputSize, &Epilogue);
+    }
+}
 
-        //
-        // Apply the activation with optional bias.
-        //
+//
+// Define the parameters to execute a depthwise convolution on a worker thread.
+//
 
-        const float* bias = WorkBlock->Bias;
+struct MLAS_CONV_DEPTHWISE_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* Output;
+    int32_t tids;
+};
 
-        if (bias != nullptr) {
-            bias += group * FilterCount;
+void
+MlasConvDepthwisePlane(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine convolves a single input plane with a single filter, which
+    is the operation of each output channel of a depthwise convolution.
+
+    Each output row starts from the bias and accumulates a row of the input
+    for each kernel position. The range of output columns that read inside
+    the input row is computed once per kernel column, so the inner loop has
+    no bounds checks and walks the input with a fixed stride.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input plane.
+
+    Filter - Supplies the filter of the output plane.
+
+    Bias - Supplies the bias of the output plane.
+
+    Output - Supplies the output plane.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        float* output = Output + oh * OutputWidth;
+
+        for (size_t ow = 0; ow < OutputWidth; ow++) {
+            output[ow] = Bias;
         }
 
-        MlasActivation(Parameters->Activation, output, bias, FilterCount,
-            OutputSize, OutputSize);
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            //
+            // Skip the kernel rows that read from the padding.
+            //
+
+            const size_t ih = oh * StrideHeight + kh * DilationHeight - PaddingTop;
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            const float* input_row = Input + ih * InputWidth;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const float w = Filter[kh * KernelWidth + kw];
+
+                //
+                // Compute the output columns [ow_begin, ow_end) whose input
+                // column iw = ow * StrideWidth + kw * DilationWidth - PaddingLeft
+                // is inside the input row.
+                //
+
+                const ptrdiff_t offset = ptrdiff_t(kw * DilationWidth) - ptrdiff_t(PaddingLeft);
+
+                size_t ow_begin = 0;
+
+                if (offset < 0) {
+                    ow_begin = (size_t(-offset) + StrideWidth - 1) / StrideWidth;
+                }
+
+                size_t ow_end = 0;
+
+                if (ptrdiff_t(InputWidth) > offset) {
+                    ow_end = (size_t(ptrdiff_t(InputWidth) - offset) + StrideWidth - 1) / StrideWidth;
+                }
+
+                if (ow_end > OutputWidth) {
+                    ow_end = OutputWidth;
+                }
+
+                if (ow_begin >= ow_end) {
+                    continue;
+                }
+
+                const float* input = input_row + ptrdiff_t(ow_begin * StrideWidth) + offset;
+                float* out = output + ow_begin;
+                const size_t count = ow_end - ow_begin;
+
+                if (StrideWidth == 1) {
+                    for (size_t i = 0; i < count; i++) {
+                        out[i] += w * input[i];
+                    }
+                } else {
+                    for (size_t i = 0; i < count; i++) {
+                        out[i] += w * input[i * StrideWidth];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_DEPTHWISE_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupFilterCount = Parameters->GroupCount * FilterCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    //
+    // Partition the output planes across the threads. The output planes of
+    // an image are ordered by group and then by filter, and each group reads
+    // a single input plane.
+    //
+
+    const size_t TotalWork = Parameters->BatchCount * GroupFilterCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, TotalWork, &WorkIndex, &WorkRemaining);
+
+    for (size_t plane = WorkIndex; plane < WorkIndex + WorkRemaining; plane++) {
+
+        const size_t filter = plane % GroupFilterCount;
+        const float Bias = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias[filter] : 0.0f;
+
+        float* output = WorkBlock->Output + plane * OutputSize;
+
+        MlasConvDepthwisePlane(Parameters, WorkBlock->Input + (plane / FilterCount) * InputSize,
+            WorkBlock->Filter + filter * K, Bias, output);
+
+        //
+        // The bias is already added, so only apply the activation.
+        //
+
+        MlasActivation(Parameters->Activation, output, nullptr, 1, OutputSize, OutputSize);
     }
 }
 
@@ -874,13 +1076,46 @@ Return Value:
 
     const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
     const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
-
     const size_t BatchCount = Parameters->BatchCount;
     const size_t GroupCount = Parameters->GroupCount;
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // The Winograd algorithm uses the filter from MlasConvWinogradTransformFilter,
+    // which stores a matrix per position of the transformed tile for each group.
+    //
+
+    size_t FilterGroupSize = FilterCount * K;
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+        const size_t InputTileSize = Parameters->u.Winograd.TileSize + 2;
+        FilterGroupSize = InputTileSize * InputTileSize * FilterCount * Parameters->InputChannels;
+    }
+
+    //
+    // Schedule the output planes of a depthwise convolution across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t PlaneCount = BatchCount * GroupCount * FilterCount;
+
+        MLAS_CONV_DEPTHWISE_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.Output = Output;
+        WorkBlock.tids = MlasComputeThreadCount(PlaneCount, PlaneCount * OutputSize * K, ThreadPool);
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -921,6 +1156,16 @@ Return Value:
 
         for (size_t group = 0; group < GroupCount; group++) {
 
+            //
+            // The activation with optional bias is applied to each output
+            // tile by the GEMM.
+            //
+
+            MLAS_SGEMM_EPILOGUE Epilogue;
+
+            Epilogue.RowBias = bias;
+            Epilogue.Activation = Parameters->Activation;
+
             //
             // Dispatch the convolution.
             //
@@ -935,14 +1180,7 @@ Return Value:
 
                     MlasSgemm(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
                         OutputSize, K, 1.0f, filter, K, Input, Parameters->u.GemmDirect.ldb, 0.0f,
-                        Output, OutputSize, ThreadPool);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
-
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                        Output, OutputSize, ThreadPool, &Epilogue);
 
                     break;
                 }
@@ -961,14 +1199,8 @@ Return Value:
                     }
 
                     MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f, filter,
-                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool);
-
-                    //
-                    // Apply the activation with optional bias.
-                    //
-
-                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
-                        OutputSize, OutputSize);
+                        K, WorkingBuffer, OutputSize, 0.0f, Output, OutputSize, ThreadPool,
+                        &Epilogue);
 
                     break;
                 }
@@ -988,6 +1220,28 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Transform the input tiles and multiply by the transformed
+                    // filter using threaded blocks of tiles.
+                    //
+
+                    MlasConvWinograd(Parameters, Input, filter, bias, WorkingBuffer,
+                        Output, ThreadPool);
+
+                    break;
+                }
+
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Dispatched across the threads above.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1123,6 +1377,36 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution, where each group reads a single input
+    // channel. A GEMM per group would multiply a single filter row (or a few
+    // of them) by an expanded input, so convolve each plane directly instead.
+    //
+
+    if (Dimensions == 2 && InputChannels == 1 && GroupCount > 1) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
+    //
+    // Detect a 3x3 convolution that can use the Winograd algorithm. The
+    // caller must transform the filter with MlasConvWinogradTransformFilter.
+    //
+
+    size_t WinogradTileSize = MlasConvWinogradTileSize(Dimensions, KernelShape,
+        DilationShape, StrideShape, OutputShape, InputChannels, FilterCount);
+
+    if (WinogradTileSize != 0) {
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+
+        *WorkingBufferSize = MlasConvWinogradPrepare(Parameters, WinogradTileSize, ThreadPool);
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -1191,17 +1475,8 @@ Return Value:
         int32_t TargetThreadCount;
         double Complexity = double(FilterCount) * double(OutputSize) * double(K);
 
-        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-            TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-        } else {
-            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-        }
-
-        int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
-        if (TargetThreadCount >= MaximumThreadCount) {
-            TargetThreadCount = MaximumThreadCount;
-        }
+        TargetThreadCount = MlasGetTargetThreadCount(Complexity,
+            MlasPlatform.CostModel.ConvThreadComplexity, ThreadPool);
 
         //
         // Compute the thread stride for slicing the N dimension.
@@ -1215,7 +1490,7 @@ Return Value:
 
         if (TargetThreadCount > 1) {
 
-            StrideN = (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+            StrideN = MlasAlignThreadStrideN(StrideN);
 
             if (StrideN >= OutputSize) {
                 TargetThreadCount = 1;
@@ -0,0 +1,276 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    costmodel.cpp
+
+Abstract:
+
+    This module implements the routines to query, update and calibrate the
+    cost model used to select the number of threads and the per thread tile
+    strides for an operation.
+
+    Calibration measures the single threaded throughput of the SGEMM and
+    exponential kernels and the overhead of dispatching work to the thread
+    pool. Another thread is worth using once its share of the work takes
+    MLAS_COST_MODEL_OVERHEAD_RATIO times longer than dispatching it.
+
+--*/
+
+#include "mlasi.h"
+
+#include <chrono>
+#include <memory>
+
+//
+// Define the ratio of the per thread execution time to the thread dispatch
+// overhead used when calibrating the cost model.
+//
+
+#define MLAS_COST_MODEL_OVERHEAD_RATIO              8.0
+
+//
+// Define the range of the calibrated per thread complexities.
+//
+
+#define MLAS_COST_MODEL_MINIMUM_THREAD_COMPLEXITY   (16.0 * 1024)
+#define MLAS_COST_MODEL_MAXIMUM_THREAD_COMPLEXITY   (64.0 * 1024 * 1024)
+#define MLAS_COST_MODEL_MINIMUM_THREAD_ELEMENTS     (1 * 1024)
+#define MLAS_COST_MODEL_MAXIMUM_THREAD_ELEMENTS     (1024 * 1024)
+
+//
+// Define the dimensions of the calibration workloads.
+//
+
+#define MLAS_COST_MODEL_GEMM_DIMENSION              128
+#define MLAS_COST_MODEL_COMPUTE_ELEMENTS            (16 * 1024)
+#define MLAS_COST_MODEL_ITERATIONS                  16
+
+void
+MLASCALL
+MlasGetCostModel(
+    MLAS_COST_MODEL* CostModel
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the cost model used by the library.
+
+Arguments:
+
+    CostModel - Receives the cost model.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    *CostModel = MlasPlatform.CostModel;
+}
+
+bool
+MLASCALL
+MlasSetCostModel(
+    const MLAS_COST_MODEL* CostModel
+    )
+/*++
+
+Routine Description:
+
+    This routine replaces the cost model used by the library.
+
+Arguments:
+
+    CostModel - Supplies the cost model.
+
+Return Value:
+
+    Returns true if the cost model was valid and has been applied, else false
+    if the cost model was rejected and the previous cost model remains in use.
+
+--*/
+{
+    if (!(CostModel->GemmThreadComplexity >= 1.0) ||
+        !(CostModel->ConvThreadComplexity >= 1.0)) {
+        return false;
+    }
+
+    const size_t ThreadStrideNAlign = CostModel->ThreadStrideNAlign;
+
+    if (ThreadStrideNAlign < MLAS_SGEMM_STRIDEN_THREAD_ALIGN ||
+        (ThreadStrideNAlign & (ThreadStrideNAlign - 1)) != 0) {
+        return false;
+    }
+
+    if (CostModel->ComputeThreadElements == 0) {
+        return false;
+    }
+
+    MlasPlatform.CostModel = *CostModel;
+
+    return true;
+}
+
+void
+MlasCostModelNopThreaded(
+    void* Context,
+    int32_t Index
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(Context);
+    MLAS_UNREFERENCED_PARAMETER(Index);
+}
+
+template<typename Routine>
+double
+MlasCostModelMeasure(
+    Routine Callback
+    )
+/*++
+
+Routine Description:
+
+    This routine measures the average execution time of the supplied routine.
+
+Arguments:
+
+    Callback - Supplies the routine to measure.
+
+Return Value:
+
+    Returns the average execution time in nanoseconds.
+
+--*/
+{
+    //
+    // Run the routine once to warm up the caches and the thread pool.
+    //
+
+    Callback();
+
+    auto Start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < MLAS_COST_MODEL_ITERATIONS; i++) {
+        Callback();
+    }
+
+    auto Elapsed = std::chrono::steady_clock::now() - Start;
+
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count()) /
+        double(MLAS_COST_MODEL_ITERATIONS);
+}
+
+void
+MLASCALL
+MlasCalibrateCostModel(
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine calibrates the thread complexities of the cost model for the
+    current machine and the supplied thread pool.
+
+    The calibration runs for a few milliseconds and should be invoked once
+    while the thread pool is otherwise idle.
+
+Arguments:
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (ThreadCount <= 1) {
+        return;
+    }
+
+    if (ThreadCount > MLAS_MAXIMUM_THREAD_COUNT) {
+        ThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    //
+    // Measure the overhead of dispatching an empty routine to the threads.
+    //
+
+    const double DispatchTime = MlasCostModelMeasure([&]() {
+        MlasExecuteThreaded(MlasCostModelNopThreaded, nullptr, ThreadCount, ThreadPool);
+    });
+
+    //
+    // Measure the single threaded throughput of the SGEMM kernels.
+    //
+
+    constexpr size_t Dimension = MLAS_COST_MODEL_GEMM_DIMENSION;
+    constexpr size_t MatrixElements = Dimension * Dimension;
+
+    std::unique_ptr<float[]> GemmBuffer(new float[MatrixElements * 3]);
+
+    float* A = GemmBuffer.get();
+    float* B = A + MatrixElements;
+    float* C = B + MatrixElements;
+
+    std::fill_n(A, MatrixElements * 2, 0.5f);
+
+    const double GemmTime = MlasCostModelMeasure([&]() {
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, Dimension, Dimension, Dimension,
+            1.0f, A, Dimension, B, Dimension, 0.0f, C, Dimension);
+    });
+
+    //
+    // Measure the single threaded throughput of the exponential kernel, which
+    // dominates the softmax operation.
+    //
+
+    constexpr size_t ComputeElements = MLAS_COST_MODEL_COMPUTE_ELEMENTS;
+
+    std::unique_ptr<float[]> ComputeBuffer(new float[ComputeElements]);
+
+    std::fill_n(ComputeBuffer.get(), ComputeElements, -1.0f);
+
+    const double ComputeTime = MlasCostModelMeasure([&]() {
+        MlasComputeExp(ComputeBuffer.get(), ComputeBuffer.get() + ComputeElements / 2, ComputeElements / 2);
+    });
+
+    //
+    // Derive the amount of work that takes the target multiple of the
+    // dispatch overhead to execute.
+    //
+
+    const double TargetTime = DispatchTime * MLAS_COST_MODEL_OVERHEAD_RATIO;
+
+    double ThreadComplexity = 0.0;
+
+    if (GemmTime > 0.0) {
+        ThreadComplexity = TargetTime * double(MatrixElements * Dimension) / GemmTime;
+    }
+
+    ThreadComplexity = (std::max)(ThreadComplexity, MLAS_COST_MODEL_MINIMUM_THREAD_COMPLEXITY);
+    ThreadComplexity = (std::min)(ThreadComplexity, MLAS_COST_MODEL_MAXIMUM_THREAD_COMPLEXITY);
+
+    double ThreadElements = 0.0;
+
+    if (ComputeTime > 0.0) {
+        ThreadElements = TargetTime * double(ComputeElements / 2) / ComputeTime;
+    }
+
+    ThreadElements = (std::max)(ThreadElements, double(MLAS_COST_MODEL_MINIMUM_THREAD_ELEMENTS));
+    ThreadElements = (std::min)(ThreadElements, double(MLAS_COST_MODEL_MAXIMUM_THREAD_ELEMENTS));
+
+    MlasPlatform.CostModel.GemmThreadComplexity = ThreadComplexity;
+    MlasPlatform.CostModel.ConvThreadComplexity = ThreadComplexity;
+    MlasPlatform.CostModel.ComputeThreadElements = size_t(ThreadElements);
+}
@@ -0,0 +1,996 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the reduced precision matrix/matrix multiply
+    operations for half precision (FP16) and bfloat16 (BF16) matrices.
+
+    The output matrix is split into tiles that are computed independently.
+    For each tile, blocks of matrix A and matrix B are converted to single
+    precision and multiplied by the SGEMM kernels, or for BF16 matrices, are
+    multiplied directly by a BF16 dot product kernel if the platform has one.
+    The products are accumulated in single precision and are rounded to the
+    element type once all of K has been accumulated.
+
+    This module also implements the conversions between half precision and
+    single precision buffers.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the dimensions of the output tiles and the number of columns of
+// matrix A and rows of matrix B that are converted at a time. The buffers for
+// a tile are stack allocated.
+//
+
+#define MLAS_HALF_GEMM_STRIDEM                      32
+#define MLAS_HALF_GEMM_STRIDEN                      128
+#define MLAS_HALF_GEMM_STRIDEK                      128
+
+//
+// Define the parameters to execute segments of a reduced precision GEMM
+// operation on worker threads. Each thread computes a contiguous range of the
+// output tiles.
+//
+
+struct MLAS_HALF_GEMM_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const uint16_t* A;
+    size_t lda;
+    const uint16_t* B;
+    size_t ldb;
+    float beta;
+    uint16_t* C;
+    size_t ldc;
+    size_t TileCountM;
+    size_t TileCount;
+    int32_t ThreadCount;
+};
+
+MLAS_FORCEINLINE
+float
+MlasHalfToFloat(
+    uint16_t Value
+    )
+{
+    const uint32_t Sign = uint32_t(Value & 0x8000) << 16;
+    uint32_t Exponent = (Value >> 10) & 0x1F;
+    uint32_t Mantissa = Value & 0x3FF;
+    uint32_t Bits;
+
+    if (Exponent == 0x1F) {
+        Bits = Sign | 0x7F800000 | (Mantissa << 13);
+    } else if (Exponent != 0) {
+        Bits = Sign | ((Exponent + 112) << 23) | (Mantissa << 13);
+    } else if (Mantissa != 0) {
+
+        //
+        // Normalize the denormal value.
+        //
+
+        Exponent = 113;
+
+        while ((Mantissa & 0x400) == 0) {
+            Mantissa <<= 1;
+            Exponent--;
+        }
+
+        Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FF) << 13);
+
+    } else {
+        Bits = Sign;
+    }
+
+    float FloatValue;
+    memcpy(&FloatValue, &Bits, sizeof(float));
+    return FloatValue;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToHalf(
+    float Value
+    )
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(float));
+
+    const uint32_t Sign = (Bits >> 16) & 0x8000;
+
+    Bits &= 0x7FFFFFFF;
+
+    //
+    // Values with a magnitude of at least 65536 are infinite in half
+    // precision. NaNs are returned as a quiet NaN.
+    //
+
+    if (Bits >= 0x47800000) {
+        return uint16_t(Sign | ((Bits > 0x7F800000) ? 0x7E00 : 0x7C00));
+    }
+
+    //
+    // Rebias the exponent of a normal value and round the mantissa to the
+    // nearest even value. A carry out of the mantissa increments the exponent,
+    // which correctly rounds values that overflow to infinity.
+    //
+
+    if (Bits >= 0x38800000) {
+
+        uint32_t Half = (Bits - 0x38000000) >> 13;
+        const uint32_t Remainder = Bits & 0x1FFF;
+
+        if (Remainder > 0x1000 || (Remainder == 0x1000 && (Half & 1) != 0)) {
+            Half++;
+        }
+
+        return uint16_t(Sign | Half);
+    }
+
+    //
+    // Values with a magnitude of at least 2^-25 round to a denormal value or
+    // to the smallest normal value.
+    //
+
+    if (Bits >= 0x33000000) {
+
+        const uint32_t Shift = 126 - (Bits >> 23);
+        const uint32_t Mantissa = (Bits & 0x7FFFFF) | 0x800000;
+
+        uint32_t Half = Mantissa >> Shift;
+        const uint32_t Remainder = Mantissa & ((1u << Shift) - 1);
+        const uint32_t Midpoint = 1u << (Shift - 1);
+
+        if (Remainder > Midpoint || (Remainder == Midpoint && (Half & 1) != 0)) {
+            Half++;
+        }
+
+        return uint16_t(Sign | Half);
+    }
+
+    return uint16_t(Sign);
+}
+
+MLAS_FORCEINLINE
+float
+MlasBf16ToFloat(
+    uint16_t Value
+    )
+{
+    const uint32_t Bits = uint32_t(Value) << 16;
+
+    float FloatValue;
+    memcpy(&FloatValue, &Bits, sizeof(float));
+    return FloatValue;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToBf16(
+    float Value
+    )
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(float));
+
+    //
+    // Keep NaNs quiet instead of letting the rounding turn them into an
+    // infinity, else round to the nearest even value.
+    //
+
+    if ((Bits & 0x7FFFFFFF) > 0x7F800000) {
+        return uint16_t((Bits >> 16) | 0x40);
+    }
+
+    Bits += 0x7FFF + ((Bits >> 16) & 1);
+
+    return uint16_t(Bits >> 16);
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernel(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision elements to single
+    precision.
+
+Arguments:
+
+    Source - Supplies the half precision elements.
+
+    Destination - Supplies the buffer to store the single precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasHalfToFloat(Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernel(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision elements to half
+    precision, rounding to the nearest even value.
+
+Arguments:
+
+    Source - Supplies the single precision elements.
+
+    Destination - Supplies the buffer to store the half precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < Count; n++) {
+        Destination[n] = MlasFloatToHalf(Source[n]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision elements to single
+    precision, using the F16C instructions if the platform supports them.
+
+Arguments:
+
+    Source - Supplies the half precision elements.
+
+    Destination - Supplies the buffer to store the single precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertHalfToFloatRoutine(Source, Destination, Count);
+#else
+    MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision elements to half
+    precision, rounding to the nearest even value, using the F16C
+    instructions if the platform supports them.
+
+Arguments:
+
+    Source - Supplies the single precision elements.
+
+    Destination - Supplies the buffer to store the half precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ConvertFloatToHalfRoutine(Source, Destination, Count);
+#else
+    MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+}
+
+//
+// Define the conversions for each element type.
+//
+
+struct MLAS_HALF_GEMM_ELEMENT_FP16
+{
+    static constexpr bool IsBf16 = false;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    ConvertToFloat(
+        const uint16_t* Source,
+        float* Destination,
+        size_t Count
+        )
+    {
+#if defined(MLAS_TARGET_AMD64)
+        MlasPlatform.ConvertHalfToFloatRoutine(Source, Destination, Count);
+#else
+        MlasConvertHalfToFloatKernel(Source, Destination, Count);
+#endif
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    ConvertFromFloat(
+        const float* Source,
+        uint16_t* Destination,
+        size_t Count
+        )
+    {
+#if defined(MLAS_TARGET_AMD64)
+        MlasPlatform.ConvertFloatToHalfRoutine(Source, Destination, Count);
+#else
+        MlasConvertFloatToHalfKernel(Source, Destination, Count);
+#endif
+    }
+};
+
+struct MLAS_HALF_GEMM_ELEMENT_BF16
+{
+    static constexpr bool IsBf16 = true;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    ConvertToFloat(
+        const uint16_t* Source,
+        float* Destination,
+        size_t Count
+        )
+    {
+        for (size_t n = 0; n < Count; n++) {
+            Destination[n] = MlasBf16ToFloat(Source[n]);
+        }
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    ConvertFromFloat(
+        const float* Source,
+        uint16_t* Destination,
+        size_t Count
+        )
+    {
+        for (size_t n = 0; n < Count; n++) {
+            Destination[n] = MlasFloatToBf16(Source[n]);
+        }
+    }
+};
+
+template<typename ElementType>
+void
+MlasHalfGemmConvertBlock(
+    CBLAS_TRANSPOSE Trans,
+    const uint16_t* S,
+    size_t lds,
+    size_t Rows,
+    size_t Columns,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a block of a reduced precision matrix to a single
+    precision matrix, transposing the block if needed.
+
+Arguments:
+
+    Trans - Supplies the transpose operation of the source matrix.
+
+    S - Supplies the address of the first element of the block.
+
+    lds - Supplies the first dimension of the source matrix.
+
+    Rows - Supplies the number of rows of the block after any transpose.
+
+    Columns - Supplies the number of columns of the block after any transpose.
+        This is at most MLAS_HALF_GEMM_STRIDEN.
+
+    D - Supplies the buffer to store the Rows by Columns block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Trans == CblasNoTrans) {
+
+        for (size_t r = 0; r < Rows; r++) {
+            ElementType::ConvertToFloat(S + r * lds, D + r * Columns, Columns);
+        }
+
+    } else {
+
+        //
+        // Convert each contiguous row of the source matrix and scatter it to
+        // a column of the block.
+        //
+
+        MLAS_DECLSPEC_ALIGN(float Row[MLAS_HALF_GEMM_STRIDEN], 64);
+
+        for (size_t c = 0; c < Columns; c++) {
+
+            ElementType::ConvertToFloat(S + c * lds, Row, Rows);
+
+            for (size_t r = 0; r < Rows; r++) {
+                D[r * Columns + c] = Row[r];
+            }
+        }
+    }
+}
+
+template<typename ElementType>
+void
+MlasHalfGemmStoreTile(
+    const MLAS_HALF_GEMM_WORK_BLOCK* WorkBlock,
+    float* PanelC,
+    uint16_t* C,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the accumulated products of an output tile, adds the
+    scaled existing output, and rounds the tile to the element type.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    PanelC - Supplies the CountM by CountN accumulated products.
+
+    C - Supplies the address of the output tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float alpha = WorkBlock->alpha;
+    const float beta = WorkBlock->beta;
+    const size_t ldc = WorkBlock->ldc;
+
+    MLAS_DECLSPEC_ALIGN(float Row[MLAS_HALF_GEMM_STRIDEN], 64);
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        float* c = PanelC + m * CountN;
+
+        if (beta != 0.0f) {
+
+            ElementType::ConvertToFloat(C, Row, CountN);
+
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] = alpha * c[n] + beta * Row[n];
+            }
+
+        } else if (alpha != 1.0f) {
+
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] *= alpha;
+            }
+        }
+
+        ElementType::ConvertFromFloat(c, C, CountN);
+
+        C += ldc;
+    }
+}
+
+template<typename ElementType>
+void
+MlasHalfGemmTile(
+    const MLAS_HALF_GEMM_WORK_BLOCK* WorkBlock,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an output tile by converting blocks of matrix A and
+    matrix B to single precision and multiplying the blocks with the SGEMM
+    kernels.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    StartM - Supplies the first row of the tile.
+
+    StartN - Supplies the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HALF_GEMM_STRIDEM * MLAS_HALF_GEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_HALF_GEMM_STRIDEK * MLAS_HALF_GEMM_STRIDEN], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelC[MLAS_HALF_GEMM_STRIDEM * MLAS_HALF_GEMM_STRIDEN], 64);
+
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+
+    if (K == 0) {
+        std::fill_n(PanelC, CountM * CountN, 0.0f);
+    }
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = (std::min)(K - k, size_t(MLAS_HALF_GEMM_STRIDEK));
+
+        const uint16_t* a = WorkBlock->A + ((WorkBlock->TransA == CblasNoTrans) ?
+            (StartM * lda + k) : (k * lda + StartM));
+        const uint16_t* b = WorkBlock->B + ((WorkBlock->TransB == CblasNoTrans) ?
+            (k * ldb + StartN) : (StartN * ldb + k));
+
+        MlasHalfGemmConvertBlock<ElementType>(WorkBlock->TransA, a, lda, CountM, CountK, PanelA);
+        MlasHalfGemmConvertBlock<ElementType>(WorkBlock->TransB, b, ldb, CountK, CountN, PanelB);
+
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, CountM, CountN, CountK, 1.0f,
+            PanelA, CountK, PanelB, CountN, (k == 0) ? 0.0f : 1.0f, PanelC, CountN);
+    }
+
+    MlasHalfGemmStoreTile<ElementType>(WorkBlock, PanelC,
+        WorkBlock->C + StartM * WorkBlock->ldc + StartN, CountM, CountN);
+}
+
+#if defined(MLAS_TARGET_AMD64)
+
+void
+MlasBf16GemmTileKernel(
+    const MLAS_HALF_GEMM_WORK_BLOCK* WorkBlock,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an output tile of a BF16 GEMM with the platform's
+    BF16 dot product kernel.
+
+    Each pair of adjacent elements along K is packed into a 32-bit value. The
+    rows of matrix A are packed as rows of pairs and the columns of matrix B
+    are packed as panels of 16 columns, with the pairs of the columns for one
+    step of K stored together.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    StartM - Supplies the first row of the tile.
+
+    StartN - Supplies the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelA[MLAS_HALF_GEMM_STRIDEM * MLAS_HALF_GEMM_STRIDEK / 2], 64);
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelB[MLAS_HALF_GEMM_STRIDEK / 2 * MLAS_HALF_GEMM_STRIDEN], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelC[MLAS_HALF_GEMM_STRIDEM * MLAS_HALF_GEMM_STRIDEN], 64);
+
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+    const uint16_t* A = WorkBlock->A;
+    const uint16_t* B = WorkBlock->B;
+
+    const size_t StrideAM = (WorkBlock->TransA == CblasNoTrans) ? lda : 1;
+    const size_t StrideAK = (WorkBlock->TransA == CblasNoTrans) ? 1 : lda;
+    const size_t StrideBK = (WorkBlock->TransB == CblasNoTrans) ? ldb : 1;
+    const size_t StrideBN = (WorkBlock->TransB == CblasNoTrans) ? 1 : ldb;
+
+    if (K == 0) {
+        std::fill_n(PanelC, CountM * CountN, 0.0f);
+    }
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = (std::min)(K - k, size_t(MLAS_HALF_GEMM_STRIDEK));
+
+        const size_t PairCountK = (CountK + 1) / 2;
+
+        //
+        // Pack the rows of matrix A. An odd element count is padded with zero.
+        //
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            const uint16_t* a = A + (StartM + m) * StrideAM + k * StrideAK;
+            uint32_t* d = PanelA + m * PairCountK;
+
+            for (size_t kk = 0; kk < CountK; kk += 2) {
+                uint32_t Pair = a[kk * StrideAK];
+                if (kk + 1 < CountK) {
+                    Pair |= uint32_t(a[(kk + 1) * StrideAK]) << 16;
+                }
+                *d++ = Pair;
+            }
+        }
+
+        //
+        // Pack the panels of matrix B. Columns beyond CountN are padded with
+        // zero.
+        //
+
+        uint32_t* d = PanelB;
+
+        for (size_t n = 0; n < CountN; n += 16) {
+
+            const size_t CountX = (std::min)(CountN - n, size_t(16));
+
+            for (size_t kk = 0; kk < CountK; kk += 2) {
+
+                const uint16_t* b = B + (k + kk) * StrideBK + (StartN + n) * StrideBN;
+
+                for (size_t x = 0; x < 16; x++) {
+                    uint32_t Pair = 0;
+                    if (x < CountX) {
+                        Pair = b[x * StrideBN];
+                        if (kk + 1 < CountK) {
+                            Pair |= uint32_t(b[StrideBK + x * StrideBN]) << 16;
+                        }
+                    }
+                    *d++ = Pair;
+                }
+            }
+        }
+
+        for (size_t m = 0; m < CountM;) {
+            m += MlasPlatform.GemmBf16Kernel(PanelA + m * PairCountK, PanelB,
+                PanelC + m * CountN, PairCountK, CountM - m, CountN, PairCountK,
+                CountN, k == 0);
+        }
+    }
+
+    MlasHalfGemmStoreTile<MLAS_HALF_GEMM_ELEMENT_BF16>(WorkBlock, PanelC,
+        WorkBlock->C + StartM * WorkBlock->ldc + StartN, CountM, CountN);
+}
+
+#endif
+
+template<typename ElementType>
+void
+MlasHalfGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    output tiles of a reduced precision GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_HALF_GEMM_WORK_BLOCK*)Context;
+
+    const size_t TilesPerThread = WorkBlock->TileCount / WorkBlock->ThreadCount;
+    const size_t TilesPerThreadExtra = WorkBlock->TileCount % WorkBlock->ThreadCount;
+
+    size_t TileIndex;
+    size_t TilesRemaining;
+
+    if (uint32_t(Index) < TilesPerThreadExtra) {
+        TileIndex = (TilesPerThread + 1) * Index;
+        TilesRemaining = TilesPerThread + 1;
+    } else {
+        TileIndex = TilesPerThread * Index + TilesPerThreadExtra;
+        TilesRemaining = TilesPerThread;
+    }
+
+    //
+    // Tiles are ordered by column so that consecutive tiles of a thread share
+    // the same columns of matrix B.
+    //
+
+    while (TilesRemaining-- > 0) {
+
+        const size_t StartM = (TileIndex % WorkBlock->TileCountM) * MLAS_HALF_GEMM_STRIDEM;
+        const size_t StartN = (TileIndex / WorkBlock->TileCountM) * MLAS_HALF_GEMM_STRIDEN;
+
+        const size_t CountM = (std::min)(WorkBlock->M - StartM, size_t(MLAS_HALF_GEMM_STRIDEM));
+        const size_t CountN = (std::min)(WorkBlock->N - StartN, size_t(MLAS_HALF_GEMM_STRIDEN));
+
+#if defined(MLAS_TARGET_AMD64)
+        if (ElementType::IsBf16 && MlasPlatform.GemmBf16Kernel != nullptr) {
+            MlasBf16GemmTileKernel(WorkBlock, StartM, StartN, CountM, CountN);
+        } else
+#endif
+        {
+            MlasHalfGemmTile<ElementType>(WorkBlock, StartM, StartN, CountM, CountN);
+        }
+
+        TileIndex++;
+    }
+}
+
+template<typename ElementType>
+void
+MlasHalfGemmOperation(
+    MLAS_HALF_GEMM_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine splits a reduced precision GEMM operation into output tiles
+    and executes the tiles on the target number of threads.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    WorkBlock->TileCountM = (M + MLAS_HALF_GEMM_STRIDEM - 1) / MLAS_HALF_GEMM_STRIDEM;
+    WorkBlock->TileCount = WorkBlock->TileCountM *
+        ((N + MLAS_HALF_GEMM_STRIDEN - 1) / MLAS_HALF_GEMM_STRIDEN);
+
+    //
+    // Compute the number of target threads given the complexity of the GEMM
+    // operation, limited to the number of output tiles.
+    //
+
+    const double Complexity = double(M) * double(N) * double(WorkBlock->K);
+
+    int32_t TargetThreadCount = MlasGetTargetThreadCount(Complexity,
+        MlasPlatform.CostModel.GemmThreadComplexity, ThreadPool);
+
+    if (size_t(TargetThreadCount) > WorkBlock->TileCount) {
+        TargetThreadCount = int32_t(WorkBlock->TileCount);
+    }
+
+    WorkBlock->ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasHalfGemmThreaded<ElementType>, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasHalfGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_FP16* A,
+    size_t lda,
+    const MLAS_FP16* B,
+    size_t ldb,
+    float beta,
+    MLAS_FP16* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the half precision matrix/matrix multiply
+    operation with single precision accumulation.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier (see GEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see GEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_HALF_GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_ELEMENT_FP16>(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasBf16Gemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_BF16* A,
+    size_t lda,
+    const MLAS_BF16* B,
+    size_t ldb,
+    float beta,
+    MLAS_BF16* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the bfloat16 matrix/matrix multiply operation
+    with single precision accumulation.
+
+Arguments:
+
+    See MlasHalfGemm.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_HALF_GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_ELEMENT_BF16>(&WorkBlock, ThreadPool);
+}
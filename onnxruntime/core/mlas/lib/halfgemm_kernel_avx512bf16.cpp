@@ -0,0 +1,191 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the kernel for the bfloat16 matrix/matrix multiply
+    operation (BF16 GEMM) using the AVX512_BF16 dot product instruction.
+
+--*/
+
+#include "mlasi.h"
+
+template<size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasGemmBf16KernelBlock(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes up to RowCount rows by PanelCount panels of 16
+    columns of the output matrix.
+
+Arguments:
+
+    See MlasGemmBf16KernelAvx512BF16. CountN is at most 16 * PanelCount.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    __m512 Accumulators[RowCount][PanelCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t p = 0; p < PanelCount; p++) {
+            Accumulators[r][p] = _mm512_setzero_ps();
+        }
+    }
+
+    for (size_t kp = 0; kp < PairCountK; kp++) {
+
+        __m512bh BElements[PanelCount];
+
+        for (size_t p = 0; p < PanelCount; p++) {
+            BElements[p] = (__m512bh)_mm512_loadu_si512(B + p * PairCountK * 16 + kp * 16);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m512bh AElements = (__m512bh)_mm512_set1_epi32(int32_t(A[r * lda + kp]));
+
+            for (size_t p = 0; p < PanelCount; p++) {
+                Accumulators[r][p] = _mm512_dpbf16_ps(Accumulators[r][p], AElements, BElements[p]);
+            }
+        }
+    }
+
+    for (size_t p = 0; p < PanelCount; p++) {
+
+        const size_t CountX = (std::min)(CountN - p * 16, size_t(16));
+        const __mmask16 Mask = __mmask16((1u << CountX) - 1);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            float* c = C + r * ldc + p * 16;
+            __m512 Accumulator = Accumulators[r][p];
+
+            if (!ZeroMode) {
+                Accumulator = _mm512_add_ps(Accumulator, _mm512_maskz_loadu_ps(Mask, c));
+            }
+
+            _mm512_mask_storeu_ps(c, Mask, Accumulator);
+        }
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasGemmBf16KernelRows(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+{
+    while (CountN > 16) {
+
+        const size_t CountX = (std::min)(CountN, size_t(32));
+
+        MlasGemmBf16KernelBlock<RowCount, 2>(A, B, C, PairCountK, CountX, lda, ldc, ZeroMode);
+
+        B += 2 * PairCountK * 16;
+        C += CountX;
+        CountN -= CountX;
+    }
+
+    if (CountN > 0) {
+        MlasGemmBf16KernelBlock<RowCount, 1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmBf16KernelAvx512BF16(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A. Each element holds a pair of BF16
+        values along K.
+
+    B - Supplies the address of matrix B packed as panels of 16 columns, with
+        each element holding a pair of BF16 values along K.
+
+    C - Supplies the address of matrix C.
+
+    PairCountK - Supplies the number of pairs of K to process.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A in elements.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    size_t RowsHandled;
+
+    if (CountM >= 4) {
+        MlasGemmBf16KernelRows<4>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 4;
+    } else if (CountM >= 2) {
+        MlasGemmBf16KernelRows<2>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 2;
+    } else {
+        MlasGemmBf16KernelRows<1>(A, B, C, PairCountK, CountN, lda, ldc, ZeroMode);
+        RowsHandled = 1;
+    }
+
+    return RowsHandled;
+}
@@ -0,0 +1,122 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_f16c.cpp
+
+Abstract:
+
+    This module implements the conversions between half precision and single
+    precision buffers using the F16C instructions.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertHalfToFloatKernelF16C(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision elements to single
+    precision.
+
+Arguments:
+
+    Source - Supplies the half precision elements.
+
+    Destination - Supplies the buffer to store the single precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m128i HalfVector = _mm_loadu_si128((const __m128i*)Source);
+        _mm256_storeu_ps(Destination, _mm256_cvtph_ps(HalfVector));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        MLAS_DECLSPEC_ALIGN(uint16_t HalfBuffer[8], 16) = { 0 };
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32);
+
+        memcpy(HalfBuffer, Source, Count * sizeof(uint16_t));
+
+        __m128i HalfVector = _mm_load_si128((const __m128i*)HalfBuffer);
+        _mm256_store_ps(FloatBuffer, _mm256_cvtph_ps(HalfVector));
+
+        memcpy(Destination, FloatBuffer, Count * sizeof(float));
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision elements to half
+    precision, rounding to the nearest even value.
+
+Arguments:
+
+    Source - Supplies the single precision elements.
+
+    Destination - Supplies the buffer to store the half precision elements.
+
+    Count - Supplies the number of elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 8) {
+
+        __m128i HalfVector = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)Destination, HalfVector);
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    if (Count > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float FloatBuffer[8], 32) = { 0 };
+        MLAS_DECLSPEC_ALIGN(uint16_t HalfBuffer[8], 16);
+
+        memcpy(FloatBuffer, Source, Count * sizeof(float));
+
+        __m128i HalfVector = _mm256_cvtps_ph(_mm256_load_ps(FloatBuffer), _MM_FROUND_TO_NEAREST_INT);
+        _mm_store_si128((__m128i*)HalfBuffer, HalfVector);
+
+        memcpy(Destination, HalfBuffer, Count * sizeof(uint16_t));
+    }
+}
@@ -0,0 +1,315 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    log.cpp
+
+Abstract:
+
+    This module implements routines to compute the natural logarithm and the
+    square root functions.
+
+    The logarithm uses the range reduction and polynomial coefficients found
+    in Cephes. The implementation targets the base instruction set (SSE2 or
+    NEON).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the floating point constants for use by the kernels.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float SqrtHalf;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+    float poly_7;
+    float poly_8;
+    float Log2Low;
+    float Log2High;
+    float MinimumNormal;
+    float DenormalScale;
+    float DenormalExponent;
+} MlasLogConstants = {
+    0.707106781186547524f,
+    7.0376836292e-2f,
+    -1.1514610310e-1f,
+    1.1676998740e-1f,
+    -1.2420140846e-1f,
+    1.4249322787e-1f,
+    -1.6668057665e-1f,
+    2.0000714765e-1f,
+    -2.4999993993e-1f,
+    3.3333331174e-1f,
+    -2.12194440e-4f,
+    0.693359375f,
+    1.17549435e-38f,
+    8388608.0f,
+    -23.0f,
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasSelectFloat32x4(
+    MLAS_FLOAT32X4 Mask,
+    MLAS_FLOAT32X4 TrueValue,
+    MLAS_FLOAT32X4 FalseValue
+    )
+{
+    return MlasOrFloat32x4(MlasAndFloat32x4(Mask, TrueValue), MlasAndNotFloat32x4(Mask, FalseValue));
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasEqualFloat32x4(
+    MLAS_FLOAT32X4 Vector1,
+    MLAS_FLOAT32X4 Vector2
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_u32(vceqq_f32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpeq_ps(Vector1, Vector2);
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasGreaterThanOrEqualFloat32x4(
+    MLAS_FLOAT32X4 Vector1,
+    MLAS_FLOAT32X4 Vector2
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_u32(vcgeq_f32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpge_ps(Vector1, Vector2);
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasSplitExponentFloat32x4(
+    MLAS_FLOAT32X4 Vector,
+    MLAS_FLOAT32X4& Mantissa,
+    MLAS_FLOAT32X4& Exponent
+    )
+/*++
+
+Routine Description:
+
+    This routine splits a vector of positive normal elements into mantissas in
+    the range [0.5, 1) and exponents, like frexp.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+    Mantissa - Receives the mantissa of each element.
+
+    Exponent - Receives the exponent of each element as a float.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    int32x4_t Bits = vreinterpretq_s32_f32(Vector);
+    Exponent = vcvtq_f32_s32(vsubq_s32(vshrq_n_s32(Bits, 23), vdupq_n_s32(126)));
+    Mantissa = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(Bits, vdupq_n_s32(0x007fffff)), vdupq_n_s32(0x3f000000)));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    __m128i Bits = _mm_castps_si128(Vector);
+    Exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(Bits, 23), _mm_set1_epi32(126)));
+    Mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(Bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000)));
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeLogVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+Return Value:
+
+    Returns the logarithm of each element: NaN for negative or NaN elements,
+    negative infinity for zeros and infinity for infinity.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Zero = MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 Infinity = MlasBroadcastFloat32x4(std::numeric_limits<float>::infinity());
+
+    //
+    // Scale denormal elements into the normal range and account for the scale
+    // in the exponent.
+    //
+
+    MLAS_FLOAT32X4 DenormalMask = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.MinimumNormal), Vector);
+    MLAS_FLOAT32X4 x = MlasSelectFloat32x4(DenormalMask,
+        MlasMultiplyFloat32x4(Vector, MlasBroadcastFloat32x4(MlasLogConstants.DenormalScale)), Vector);
+
+    MLAS_FLOAT32X4 m;
+    MLAS_FLOAT32X4 e;
+    MlasSplitExponentFloat32x4(x, m, e);
+    e = MlasAddFloat32x4(e, MlasAndFloat32x4(DenormalMask, MlasBroadcastFloat32x4(MlasLogConstants.DenormalExponent)));
+
+    //
+    // Shift the mantissa from [0.5, 1) to [sqrt(0.5), sqrt(2)) and subtract one
+    // so that the polynomial is evaluated around zero.
+    //
+
+    MLAS_FLOAT32X4 One = MlasBroadcastFloat32x4(1.0f);
+    MLAS_FLOAT32X4 SmallMask = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.SqrtHalf), m);
+    e = MlasSubtractFloat32x4(e, MlasAndFloat32x4(SmallMask, One));
+    m = MlasSubtractFloat32x4(MlasAddFloat32x4(m, MlasAndFloat32x4(SmallMask, m)), One);
+
+    MLAS_FLOAT32X4 z = MlasMultiplyFloat32x4(m, m);
+
+    MLAS_FLOAT32X4 p = MlasBroadcastFloat32x4(MlasLogConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_6));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_7));
+    p = MlasMultiplyAddFloat32x4(p, m, MlasBroadcastFloat32x4(MlasLogConstants.poly_8));
+    p = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(p, m), z);
+
+    //
+    // Add e * ln(2) in two steps so that the product of the high part is exact.
+    //
+
+    p = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2Low), p);
+    p = MlasMultiplyAddFloat32x4(z, MlasBroadcastFloat32x4(-0.5f), p);
+    MLAS_FLOAT32X4 Result = MlasAddFloat32x4(m, p);
+    Result = MlasMultiplyAddFloat32x4(e, MlasBroadcastFloat32x4(MlasLogConstants.Log2High), Result);
+
+    //
+    // Fix up the special values.
+    //
+
+    Result = MlasSelectFloat32x4(MlasEqualFloat32x4(Vector, Zero), MlasSubtractFloat32x4(Zero, Infinity), Result);
+    Result = MlasSelectFloat32x4(MlasEqualFloat32x4(Vector, Infinity), Infinity, Result);
+    Result = MlasSelectFloat32x4(MlasGreaterThanOrEqualFloat32x4(Vector, Zero), Result,
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::quiet_NaN()));
+
+    return Result;
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeLogVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+
+        float Buffer[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+        std::copy_n(Input, N, Buffer);
+        MlasStoreFloat32x4(Buffer, MlasComputeLogVector(MlasLoadFloat32x4(Buffer)));
+        std::copy_n(Buffer, N, Output);
+    }
+}
+
+void
+MLASCALL
+MlasComputeSqrt(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the square root function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+
+        MlasStoreFloat32x4(Output, MlasSqrtFloat32x4(Vector0));
+        MlasStoreFloat32x4(Output + 4, MlasSqrtFloat32x4(Vector1));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    while (N > 0) {
+
+        *Output++ = std::sqrt(*Input++);
+
+        N -= 1;
+    }
+}
@@ -20,6 +20,7 @@ Abstract:
 #include <mlas.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #if defined(_WIN32)
@@ -122,9 +123,9 @@ Abstract:
 // Define the alignment for segmenting a SGEMM operation across multiple
 // threads.
 //
-// All of the SGEMM kernels can efficiently handle 16 elements. AVX512F can
-// efficiently handle 32 elements, but making this value dynamic is not worth
-// the effort at this time.
+// All of the SGEMM kernels can efficiently handle 16 elements, so this is the
+// default and the minimum alignment. The cost model may select a larger
+// alignment, such as 32 elements for AVX512F.
 //
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
@@ -240,6 +241,22 @@ size_t
 
 typedef MLAS_GEMM_U8U8_KERNEL* PMLAS_GEMM_U8U8_KERNEL;
 
+//
+// Define the convolution kernel flags.
+//
+
+#define MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT     0x00000001
+#define MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION         0x00000002
+#define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION       0x00000004
+#define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION      0x00000008
+
+//
+// Define the NCHWc block size used by the ARM64 convolution and pooling
+// kernels.
+//
+
+#define MLAS_NEON_NCHWC_BLOCK_SIZE                  8
+
 typedef
 void
 (MLASCALL MLAS_CONV_FLOAT_KERNEL)(
@@ -339,6 +356,110 @@ void
 
 typedef MLAS_ELEMENTWISE_KERNEL_ROUTINE* PMLAS_ELEMENTWISE_KERNEL_ROUTINE;
 
+typedef
+float
+(MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    );
+
+typedef MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL;
+
+typedef
+float
+(MLASCALL MLAS_REDUCE_FLOAT_KERNEL)(
+    const float* Input,
+    size_t N
+    );
+
+typedef MLAS_REDUCE_FLOAT_KERNEL* PMLAS_REDUCE_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL)(
+    const float* Input,
+    float* Minimum,
+    float* Maximum,
+    size_t N
+    );
+
+typedef MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE)(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE* PMLAS_CONVERT_HALF_TO_FLOAT_ROUTINE;
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE)(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    );
+
+typedef MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE* PMLAS_CONVERT_FLOAT_TO_HALF_ROUTINE;
+
+typedef
+size_t
+(MLASCALL MLAS_GEMM_BF16_KERNEL)(
+    const uint32_t* A,
+    const uint32_t* B,
+    float* C,
+    size_t PairCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    bool ZeroMode
+    );
+
+typedef MLAS_GEMM_BF16_KERNEL* PMLAS_GEMM_BF16_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_BLOCK_QUANT_GEMV_KERNEL)(
+    const float* A,
+    const uint8_t* Panel,
+    size_t K,
+    size_t BlockSize,
+    const float* Bias,
+    float* Output
+    );
+
+typedef MLAS_BLOCK_QUANT_GEMV_KERNEL* PMLAS_BLOCK_QUANT_GEMV_KERNEL;
+
+//
+// Define the floating point constants used by the exponential function kernels.
+//
+
+struct MLAS_EXP_CONSTANTS {
+    float LowerRange;
+    float UpperRange;
+    float LowerRangeSumExp;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float MinimumExponent;
+    float MaximumExponent;
+};
+
+MLAS_INTERNAL_DATA const MLAS_EXP_CONSTANTS MlasExpConstants;
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -402,6 +523,14 @@ extern "C" {
     MLAS_POOL_FLOAT_KERNEL MlasPoolAverageIncludePadFloatKernelSse;
     MLAS_POOL_FLOAT_KERNEL MlasPoolAverageIncludePadFloatKernelAvx;
     MLAS_POOL_FLOAT_KERNEL MlasPoolAverageIncludePadFloatKernelAvx512F;
+#elif defined(MLAS_TARGET_ARM64)
+    MLAS_CONV_FLOAT_KERNEL MlasConvNchwFloatKernelNeon;
+    MLAS_CONV_FLOAT_KERNEL MlasConvNchwcFloatKernelNeon;
+    MLAS_CONV_DEPTHWISE_FLOAT_KERNEL MlasConvDepthwiseFloatKernelNeon;
+    MLAS_CONV_POINTWISE_FLOAT_KERNEL MlasConvPointwiseFloatKernelNeon;
+    MLAS_POOL_FLOAT_KERNEL MlasPoolMaximumFloatKernelNeon;
+    MLAS_POOL_FLOAT_KERNEL MlasPoolAverageExcludePadFloatKernelNeon;
+    MLAS_POOL_FLOAT_KERNEL MlasPoolAverageIncludePadFloatKernelNeon;
 #else
     MLAS_CONV_FLOAT_KERNEL MlasConvNchwFloatKernel;
     MLAS_CONV_FLOAT_KERNEL MlasConvNchwcFloatKernel;
@@ -421,6 +550,41 @@ extern "C" {
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernelFma3;
 #endif
 
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32Kernel;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceMaximumF32Kernel;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceSumF32Kernel;
+    MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32KernelFma3;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelFma3;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceMaximumF32KernelFma3;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceSumF32KernelFma3;
+    MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelFma3;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32KernelAvx512F;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx512F;
+    MLAS_REDUCE_FLOAT_KERNEL MlasReduceSumF32KernelAvx512F;
+    MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx512F;
+#endif
+
+    MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE MlasConvertHalfToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE MlasConvertFloatToHalfKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_HALF_TO_FLOAT_ROUTINE MlasConvertHalfToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_HALF_ROUTINE MlasConvertFloatToHalfKernelF16C;
+#if defined(MLAS_AVX512BF16_INTRINSICS)
+    MLAS_GEMM_BF16_KERNEL MlasGemmBf16KernelAvx512BF16;
+#endif
+#endif
+
+    MLAS_BLOCK_QUANT_GEMV_KERNEL MlasBlockQuantGemvQ8Kernel;
+    MLAS_BLOCK_QUANT_GEMV_KERNEL MlasBlockQuantGemvQ4Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_BLOCK_QUANT_GEMV_KERNEL MlasBlockQuantGemvQ8KernelFma3;
+    MLAS_BLOCK_QUANT_GEMV_KERNEL MlasBlockQuantGemvQ4KernelFma3;
+#endif
+
 }
 
 //
@@ -459,6 +623,13 @@ extern "C" {
 #endif
 #endif
 
+//
+// Define the target number of per-thread elements of an elementwise or
+// reduction operation before using another thread to perform additional work.
+//
+
+#define MLAS_COMPUTE_THREAD_ELEMENTS                (16 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -477,9 +648,79 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
+    );
+
+//
+// Post processing of a tile of the output matrix of a SGEMM operation.
+//
+
+const MLAS_SGEMM_EPILOGUE*
+MlasSgemmOffsetEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN,
+    MLAS_SGEMM_EPILOGUE* OffsetEpilogue
+    );
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    float* C,
+    size_t CountM,
+    size_t CountN,
     size_t ldc
     );
 
+//
+// Winograd convolution operation.
+//
+
+size_t
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t TileSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Tuning cache support.
+//
+
+void
+MlasLoadTuningCacheFromEnvironment(
+    void
+    );
+
+//
+// Define the instruction sets of the kernels that the tuning parameters can
+// select between, ordered by the processor features that each requires.
+//
+
+#if defined(MLAS_TARGET_AMD64)
+
+enum MLAS_KERNEL_ISA {
+    MlasKernelIsaSse,
+    MlasKernelIsaAvx,
+    MlasKernelIsaFma3,
+    MlasKernelIsaAvx512F,
+};
+
+#endif
+
 //
 // Environment information class.
 //
@@ -488,6 +729,9 @@ struct MLAS_PLATFORM {
 
     MLAS_PLATFORM(void);
 
+    MLAS_COST_MODEL CostModel;
+    int32_t MaximumThreadCount;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
     PMLAS_GEMM_FLOAT_KERNEL GemmFloatKernel;
     PMLAS_GEMM_U8U8_COPY_PACKA_ROUTINE GemmU8U8CopyPackARoutine;
@@ -499,16 +743,33 @@ struct MLAS_PLATFORM {
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1Routine;
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1TransposeBRoutine;
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
+#endif
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
     PMLAS_CONV_FLOAT_KERNEL ConvNchwFloatKernel;
     PMLAS_CONV_FLOAT_KERNEL ConvNchwcFloatKernel;
     PMLAS_CONV_DEPTHWISE_FLOAT_KERNEL ConvDepthwiseFloatKernel;
     PMLAS_CONV_POINTWISE_FLOAT_KERNEL ConvPointwiseFloatKernel;
     PMLAS_POOL_FLOAT_KERNEL PoolFloatKernel[MlasPoolingKindCount];
+    uint32_t NchwcBlockSize;
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE TanhKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE ErfKernelRoutine;
-    uint32_t NchwcBlockSize;
+    PMLAS_ELEMENTWISE_KERNEL_ROUTINE ComputeExpF32Kernel;
+    PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL ComputeSumExpF32Kernel;
+    PMLAS_REDUCE_FLOAT_KERNEL ReduceMaximumF32Kernel;
+    PMLAS_REDUCE_FLOAT_KERNEL ReduceSumF32Kernel;
+    PMLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL ReduceMinimumMaximumF32Kernel;
+    PMLAS_CONVERT_HALF_TO_FLOAT_ROUTINE ConvertHalfToFloatRoutine;
+    PMLAS_CONVERT_FLOAT_TO_HALF_ROUTINE ConvertFloatToHalfRoutine;
+    PMLAS_GEMM_BF16_KERNEL GemmBf16Kernel;
+    PMLAS_BLOCK_QUANT_GEMV_KERNEL BlockQuantGemvQ8Kernel;
+    PMLAS_BLOCK_QUANT_GEMV_KERNEL BlockQuantGemvQ4Kernel;
     uint32_t PreferredBufferAlignment;
+    MLAS_KERNEL_ISA MaximumKernelIsa;
 #endif
 };
 
@@ -541,19 +802,114 @@ MlasGetMaximumThreadCount(
     MLAS_THREADPOOL* ThreadPool
     )
 {
+#if defined(_OPENMP)
+    int32_t ThreadCount = (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
+#else
+    int32_t ThreadCount = 1;
+#endif
+
 #ifdef MLAS_NO_ONNXRUNTIME_THREADPOOL
     MLAS_UNREFERENCED_PARAMETER(ThreadPool);
 #else
     if (ThreadPool != nullptr) {
-        return ThreadPool->NumThreads() + 1;
+        ThreadCount = ThreadPool->NumThreads() + 1;
     }
 #endif
 
-#if defined(_OPENMP)
-    return (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
-#else
-    return 1;
-#endif
+    //
+    // Apply the limit from the threading policy.
+    //
+
+    if (MlasPlatform.MaximumThreadCount > 0 && ThreadCount > MlasPlatform.MaximumThreadCount) {
+        ThreadCount = MlasPlatform.MaximumThreadCount;
+    }
+
+    return ThreadCount;
+}
+
+//
+// Computes the number of threads to use for an operation with the specified
+// number of multiply/adds given the per thread complexity from the cost model.
+//
+
+inline
+int32_t
+MlasGetTargetThreadCount(
+    double Complexity,
+    double ThreadComplexity,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    int32_t TargetThreadCount;
+
+    if (Complexity < ThreadComplexity * double(MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / ThreadComplexity) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    return TargetThreadCount;
+}
+
+//
+// Aligns the N dimension stride of a GEMM operation that is segmented across
+// threads.
+//
+
+inline
+size_t
+MlasAlignThreadStrideN(
+    size_t StrideN
+    )
+{
+    const size_t Align = MlasPlatform.CostModel.ThreadStrideNAlign;
+
+    return (StrideN + Align - 1) & ~(Align - 1);
+}
+
+//
+// Computes the number of threads to use for an operation that touches the
+// specified number of elements split into independent work items.
+//
+
+int32_t
+MlasComputeThreadCount(
+    size_t WorkCount,
+    size_t ElementCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Splits the specified number of work items evenly across the threads and
+// returns the range of work items for the specified thread.
+//
+
+inline
+void
+MlasPartitionWork(
+    int32_t ThreadId,
+    int32_t ThreadCount,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    )
+{
+    const size_t WorkPerThread = TotalWork / ThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % ThreadCount;
+
+    if (uint32_t(ThreadId) < WorkPerThreadExtra) {
+        *WorkIndex = (WorkPerThread + 1) * ThreadId;
+        *WorkRemaining = WorkPerThread + 1;
+    } else {
+        *WorkIndex = WorkPerThread * ThreadId + WorkPerThreadExtra;
+        *WorkRemaining = WorkPerThread;
+    }
 }
 
 //
@@ -763,7 +1119,9 @@ inline
 MLAS_FLOAT32X4
 MlasMultiplyAddFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2, MLAS_FLOAT32X4 Vector3)
 {
-#if defined(MLAS_NEON_INTRINSICS)
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vfmaq_f32(Vector3, Vector1, Vector2);
+#elif defined(MLAS_NEON32_INTRINSICS)
     return vmlaq_f32(Vector3, Vector1, Vector2);
 #elif defined(MLAS_FMA3_INTRINSICS)
     return _mm_fmadd_ps(Vector1, Vector2, Vector3);
@@ -789,6 +1147,23 @@ MlasDivideFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+inline
+MLAS_FLOAT32X4
+MlasSqrtFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vsqrtq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 0)), Vector, 0);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 1)), Vector, 1);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 2)), Vector, 2);
+    Vector = vsetq_lane_f32(std::sqrt(vgetq_lane_f32(Vector, 3)), Vector, 3);
+    return Vector;
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_sqrt_ps(Vector);
+#endif
+}
+
 inline
 MLAS_FLOAT32X4
 MlasMaximumFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
@@ -77,6 +77,15 @@ Return Value:
 
 --*/
 {
+    //
+    // Initialize the cost model and the threading policy to the defaults.
+    //
+
+    this->CostModel.GemmThreadComplexity = double(MLAS_SGEMM_THREAD_COMPLEXITY);
+    this->CostModel.ConvThreadComplexity = double(MLAS_SGEMM_THREAD_COMPLEXITY);
+    this->CostModel.ThreadStrideNAlign = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    this->CostModel.ComputeThreadElements = MLAS_COMPUTE_THREAD_ELEMENTS;
+    this->MaximumThreadCount = 0;
 
 #if defined(MLAS_TARGET_AMD64_IX86)
 
@@ -102,8 +111,19 @@ Return Value:
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
     this->ErfKernelRoutine = MlasErfKernel;
+    this->ComputeExpF32Kernel = MlasComputeExpF32Kernel;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
+    this->ReduceSumF32Kernel = MlasReduceSumF32Kernel;
+    this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->ConvertHalfToFloatRoutine = MlasConvertHalfToFloatKernel;
+    this->ConvertFloatToHalfRoutine = MlasConvertFloatToHalfKernel;
+    this->GemmBf16Kernel = nullptr;
+    this->BlockQuantGemvQ8Kernel = MlasBlockQuantGemvQ8Kernel;
+    this->BlockQuantGemvQ4Kernel = MlasBlockQuantGemvQ4Kernel;
     this->NchwcBlockSize = 8;
     this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
+    this->MaximumKernelIsa = MlasKernelIsaSse;
 
 #endif
 
@@ -142,6 +162,16 @@ Return Value:
             this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx;
             this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
             this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
+            this->MaximumKernelIsa = MlasKernelIsaAvx;
+
+            //
+            // Check if the processor supports the F16C feature.
+            //
+
+            if ((Cpuid1[2] & 0x20000000) != 0) {
+                this->ConvertHalfToFloatRoutine = MlasConvertHalfToFloatKernelF16C;
+                this->ConvertFloatToHalfRoutine = MlasConvertFloatToHalfKernelF16C;
+            }
 
             //
             // Check if the processor supports AVX512F (and the operating
@@ -171,8 +201,14 @@ Return Value:
                     this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+                    this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
+                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx512F;
+                    this->ReduceSumF32Kernel = MlasReduceSumF32KernelAvx512F;
+                    this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32KernelAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
+                    this->MaximumKernelIsa = MlasKernelIsaAvx512F;
 
                     //
                     // Check if the processor supports AVX512BW.
@@ -191,6 +227,29 @@ Return Value:
                         }
                     }
 
+#if defined(MLAS_AVX512BF16_INTRINSICS)
+
+                    //
+                    // Check if the processor supports AVX512_BF16, which is
+                    // reported by the second subleaf of leaf 7.
+                    //
+
+                    if (Cpuid7[0] >= 1) {
+
+                        unsigned Cpuid7_1[4];
+#if defined(_WIN32)
+                        __cpuidex((int*)Cpuid7_1, 7, 1);
+#else
+                        __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
+#endif
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->GemmBf16Kernel = MlasGemmBf16KernelAvx512BF16;
+                        }
+                    }
+
+#endif
+
                 } else {
 
                     this->GemmFloatKernel = MlasGemmFloatKernelFma3;
@@ -198,11 +257,19 @@ Return Value:
                     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
                     this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
                     this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
+                    this->ComputeExpF32Kernel = MlasComputeExpF32KernelFma3;
+                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelFma3;
+                    this->ReduceSumF32Kernel = MlasReduceSumF32KernelFma3;
+                    this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32KernelFma3;
+                    this->MaximumKernelIsa = MlasKernelIsaFma3;
                 }
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
                 this->ErfKernelRoutine = MlasErfKernelFma3;
+                this->BlockQuantGemvQ8Kernel = MlasBlockQuantGemvQ8KernelFma3;
+                this->BlockQuantGemvQ4Kernel = MlasBlockQuantGemvQ4KernelFma3;
             }
 
 #endif
@@ -212,6 +279,29 @@ Return Value:
 
 #endif
 
+#if defined(MLAS_TARGET_ARM64)
+
+    //
+    // Advanced SIMD is part of the baseline ARMv8 architecture, so the NEON
+    // kernels are always available.
+    //
+
+    this->ConvNchwFloatKernel = MlasConvNchwFloatKernelNeon;
+    this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelNeon;
+    this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelNeon;
+    this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelNeon;
+    this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelNeon;
+    this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelNeon;
+    this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelNeon;
+    this->NchwcBlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+
+#endif
+
+    //
+    // Apply the tuning cache for this machine, if any.
+    //
+
+    MlasLoadTuningCacheFromEnvironment();
 }
 
 size_t
@@ -1171,6 +1171,64 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+//
+// Define the worker thread context for a pooling operation.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    int32_t tids;
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    size_t TotalChannelCount;
+    size_t OutputSize;
+    const float* Input;
+    float* Output;
+};
+
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    const size_t InputSize = ThreadedWorkBlock->WorkBlock->InputSize;
+    const size_t OutputSize = ThreadedWorkBlock->OutputSize;
+
+    //
+    // Partition the channels across the set of threads.
+    //
+
+    size_t ChannelIndex;
+    size_t ChannelCount;
+
+    MlasPartitionWork(Index, ThreadedWorkBlock->tids, ThreadedWorkBlock->TotalChannelCount,
+        &ChannelIndex, &ChannelCount);
+
+    ThreadedWorkBlock->PoolKernelRoutine(ThreadedWorkBlock->WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + ChannelIndex * InputSize,
+        ThreadedWorkBlock->Output + ChannelIndex * OutputSize);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1319,35 +1377,21 @@ Return Value:
         }
     }
 
-#ifdef MLAS_NO_ONNXRUNTIME_THREADPOOL
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-#else
-    //
-    // Use an external thread pool if one is provided.
-    // TODO: change to use MlasExecuteThreaded
-
-    // TODO: revisit the strategy of multi-threading logic
-    if (0 && !(ThreadPool == nullptr)) {
-        std::function<void(int32_t)> WorkObject = [&](int64_t c) { PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize); };
-        ThreadPool->ParallelFor((int32_t)TotalChannelCount, WorkObject);
-        return;
-    }
-#endif
-
     //
-    // Execute the pooling kernel routine.
+    // Schedule the operation across a set of worker threads. Each thread
+    // pools a contiguous range of channels.
     //
 
-#if defined(_OPENMP)
+    MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
 
-#pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
-    }
+    ThreadedWorkBlock.WorkBlock = &WorkBlock;
+    ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+    ThreadedWorkBlock.OutputSize = OutputSize;
+    ThreadedWorkBlock.Input = Input;
+    ThreadedWorkBlock.Output = Output;
 
-#else
+    ThreadedWorkBlock.tids = MlasComputeThreadCount(TotalChannelCount, TotalChannelCount * InputSize, ThreadPool);
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
-
-#endif
+    MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, ThreadedWorkBlock.tids, ThreadPool);
 }
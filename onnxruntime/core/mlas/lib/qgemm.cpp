@@ -509,28 +509,284 @@ Return Value:
     return 1;
 }
 
+//
+// Returns the number of columns of a matrix B packed by MlasGemmPackB. The
+// columns are padded to the widest column block of the copy routines.
+//
+
+inline
+size_t
+MlasGemmU8X8PackedCountN(
+    size_t N
+    )
+{
+    return (N + 15) & ~size_t(15);
+}
+
 void
-MLASCALL
-MlasQgemm(
-    size_t M,
-    size_t N,
-    size_t K,
+MlasGemmU8X8CopyPackA(
+    int16_t* D,
     const uint8_t* A,
     size_t lda,
-    uint8_t offa,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumVector,
+    int16_t offb,
+    bool AIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer using the platform copy routine.
+
+    Signed source elements are converted to unsigned elements by adding 128
+    (flipping the sign bit). The caller applies the same conversion to the
+    zero point offset of the source matrix, so the product is unchanged.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    A - Supplies the address of the source matrix.
+
+    lda - Supplies the number of elements per row of the source matrix.
+
+    CountM - Supplies the number of rows of the source matrix to copy. This is
+        at most MLAS_GEMM_U8U8_STRIDEM.
+
+    CountK - Supplies the number of columns of the source matrix to copy. This
+        is at most MLAS_GEMM_U8U8_STRIDEK.
+
+    RowSumVector - Supplies the address of the buffer to receive the sums of
+        the elements from each of the rows. Each sum has also been multiplied
+        by the zero point offset.
+
+    offb - Supplies the zero point offset for the other source matrix of the
+        matrix multiplication.
+
+    AIsSigned - Supplies true if the source matrix holds signed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint8_t ConvertedA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 16);
+
+    if (AIsSigned) {
+
+        for (size_t m = 0; m < CountM; m++) {
+            for (size_t k = 0; k < CountK; k++) {
+                ConvertedA[m * CountK + k] = uint8_t(A[m * lda + k] ^ 0x80);
+            }
+        }
+
+        A = ConvertedA;
+        lda = CountK;
+    }
+
+    MlasPlatform.GemmU8U8CopyPackARoutine(D, A, lda, CountM, CountK, RowSumVector, offb);
+}
+
+void
+MlasGemmU8X8CopyPackB(
+    uint8_t* D,
     const uint8_t* B,
     size_t ldb,
-    uint8_t offb,
+    size_t CountN,
+    size_t CountK,
+    int32_t* ColumnSumVector,
+    int16_t offa,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine copies elements from the source matrix to the destination
+    packed buffer using the platform copy routine.
+
+    Signed source elements are converted to unsigned elements by adding 128
+    (flipping the sign bit). The caller applies the same conversion to the
+    zero point offset of the source matrix, so the product is unchanged.
+
+Arguments:
+
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    CountN - Supplies the number of columns of the source matrix to copy. This
+        is at most MLAS_GEMM_U8U8_STRIDEN.
+
+    CountK - Supplies the number of rows of the source matrix to copy. This is
+        at most MLAS_GEMM_U8U8_STRIDEK.
+
+    ColumnSumVector - Supplies the address of the buffer to receive the sums of
+        the elements from each of the columns. Each sum has also been multiplied
+        by the zero point offset.
+
+    offa - Supplies the zero point offset for the other source matrix of the
+        matrix multiplication.
+
+    BIsSigned - Supplies true if the source matrix holds signed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint8_t ConvertedB[MLAS_GEMM_U8U8_STRIDEN * MLAS_GEMM_U8U8_STRIDEK], 16);
+
+    if (BIsSigned) {
+
+        for (size_t k = 0; k < CountK; k++) {
+            for (size_t n = 0; n < CountN; n++) {
+                ConvertedB[k * CountN + n] = uint8_t(B[k * ldb + n] ^ 0x80);
+            }
+        }
+
+        B = ConvertedB;
+        ldb = CountN;
+    }
+
+    MlasPlatform.GemmU8U8CopyPackBRoutine(D, B, ldb, CountN, CountK, ColumnSumVector, offa);
+}
+
+void
+MlasGemmU8X8ApplyColumnZeroPoints(
     int32_t* C,
     size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    const int32_t* RowSumVector,
+    const uint8_t* ZeroPointB,
+    uint8_t ZeroPointBFlip,
+    int32_t DepthValue
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the terms of the matrix multiplication that
+    depend on the zero point offsets of matrix B when each column of matrix B
+    has its own zero point offset. These terms can't be pre-computed to row
+    and column sums for the kernel.
+
+Arguments:
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountM - Supplies the number of rows of matrix C.
+
+    CountN - Supplies the number of columns of matrix C.
+
+    RowSumVector - Supplies the sum of each row from matrix A.
+
+    ZeroPointB - Supplies the zero point offset for each column of matrix B.
+
+    ZeroPointBFlip - Supplies the value that converts each zero point offset
+        to the unsigned domain of the packed matrix B.
+
+    DepthValue - Supplies the value CountK multiplied by the zero point offset
+        of matrix A.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+
+        const int32_t RowValue = DepthValue - RowSumVector[m];
+
+        for (size_t n = 0; n < CountN; n++) {
+            C[n] += int32_t(uint8_t(ZeroPointB[n] ^ ZeroPointBFlip)) * RowValue;
+        }
+
+        C += ldc;
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    const MLAS_GEMM_U8X8_PARAMETERS* Parameters,
     MLAS_THREADPOOL* ThreadPool
     )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM).
+
+    Signed matrices are converted to unsigned matrices by adding 128 to both
+    the elements and the zero point offsets, so the unsigned kernels compute
+    the exact result for every combination of signed and unsigned inputs.
+
+Arguments:
+
+    Parameters - Supplies the structure containing the GEMM parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
 {
     MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(uint8_t PanelB[MLAS_GEMM_U8U8_STRIDEN * MLAS_GEMM_U8U8_STRIDEK], 64);
 
     MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8U8_STRIDEM], 16);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8U8_STRIDEN], 16);
+    MLAS_DECLSPEC_ALIGN(int32_t ZeroRowSumVector[MLAS_GEMM_U8U8_STRIDEM], 16) = { 0 };
+
+    const size_t M = Parameters->M;
+    const size_t N = Parameters->N;
+    const size_t K = Parameters->K;
+    const uint8_t* A = Parameters->A;
+    const size_t lda = Parameters->lda;
+    const uint8_t* B = (const uint8_t*)Parameters->B;
+    const size_t ldb = Parameters->ldb;
+    int32_t* C = Parameters->C;
+    const size_t ldc = Parameters->ldc;
+
+    const bool AIsSigned = Parameters->AIsSigned;
+    const bool BIsSigned = Parameters->BIsSigned;
+    const bool PerColumnZeroPoints = Parameters->PerColumnZeroPoints;
+
+    //
+    // Convert the zero point offsets to the unsigned domain of the packed
+    // matrices. The per column zero point offsets of matrix B are applied
+    // after the kernel, so the kernel is invoked with a zero offset.
+    //
+
+    const uint8_t ZeroPointBFlip = BIsSigned ? 0x80 : 0;
+
+    const uint8_t offa = uint8_t(Parameters->ZeroPointA ^ (AIsSigned ? 0x80 : 0));
+    const uint8_t offb = PerColumnZeroPoints ? 0 : uint8_t(Parameters->ZeroPointB[0] ^ ZeroPointBFlip);
+
+    //
+    // The packed matrix B holds the column sums for each slice along the K
+    // dimension, followed by the packed panels of each slice.
+    //
+
+    const size_t PackedCountN = MlasGemmU8X8PackedCountN(N);
+    const int32_t* PackedColumnSums = (const int32_t*)B;
+    const uint8_t* PackedData = B + PackedCountN * ((K + MLAS_GEMM_U8U8_STRIDEK - 1) / MLAS_GEMM_U8U8_STRIDEK) * sizeof(int32_t);
 
     size_t StrideM = MLAS_GEMM_U8U8_STRIDEM;
     size_t StrideN = MLAS_GEMM_U8U8_STRIDEN;
@@ -548,6 +804,8 @@ MlasQgemm(
             CountK = K - k;
         }
 
+        size_t PairedCountK = (CountK + 1) / 2;
+
         size_t CountN;
 
         for (size_t n = 0; n < N; n += CountN) {
@@ -558,7 +816,31 @@ MlasQgemm(
                 CountN = N - n;
             }
 
-            MlasPlatform.GemmU8U8CopyPackBRoutine(PanelB, B + n + k * ldb, ldb, CountN, CountK, ColumnSumVector, -int16_t(offa));
+            const uint8_t* pb;
+
+            if (Parameters->BIsPacked) {
+
+                //
+                // Scale the column sums of the packed matrix B by the zero
+                // point offset of matrix A. The kernels read the column sums
+                // in blocks, so include the padded columns.
+                //
+
+                const int32_t* ColumnSums = PackedColumnSums + (k / StrideK) * PackedCountN + n;
+                const size_t PaddedCountN = MlasGemmU8X8PackedCountN(CountN);
+
+                for (size_t i = 0; i < PaddedCountN; i++) {
+                    ColumnSumVector[i] = ColumnSums[i] * -int32_t(offa);
+                }
+
+                pb = PackedData + k * PackedCountN + n * PairedCountK * 2;
+
+            } else {
+
+                MlasGemmU8X8CopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK, ColumnSumVector, -int16_t(offa), BIsSigned);
+
+                pb = PanelB;
+            }
 
             size_t CountM;
 
@@ -570,30 +852,194 @@ MlasQgemm(
                     CountM = M - m;
                 }
 
-                MlasPlatform.GemmU8U8CopyPackARoutine(PanelA, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(offb));
+                //
+                // With per column zero point offsets, compute the plain row
+                // sums for the fixup below instead of the scaled row sums.
+                //
+
+                MlasGemmU8X8CopyPackA(PanelA, A + k + m * lda, lda, CountM, CountK, RowSumVector, PerColumnZeroPoints ? 1 : -int16_t(offb), AIsSigned);
 
                 int16_t* pa = PanelA;
                 int32_t* c = C + n + m * ldc;
 
-                int32_t* RowSums = RowSumVector;
+                int32_t* RowSums = PerColumnZeroPoints ? ZeroRowSumVector : RowSumVector;
 
                 size_t RowsRemaining = CountM;
                 size_t RowsHandled;
 
-                size_t PairedCountK = (CountK + 1) / 2;
-
                 while (RowsRemaining > 0) {
 
-                    RowsHandled = MlasPlatform.GemmU8U8Kernel(pa, PanelB, c, PairedCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * offb, k == 0);
+                    RowsHandled = MlasPlatform.GemmU8U8Kernel(pa, pb, c, PairedCountK, RowsRemaining, CountN, ldc, RowSums, ColumnSumVector, int32_t(CountK) * offa * offb, k == 0);
 
                     RowsRemaining -= RowsHandled;
                     c += ldc * RowsHandled;
                     pa += 2 * PairedCountK * RowsHandled;
                     RowSums += RowsHandled;
                 }
+
+                if (PerColumnZeroPoints) {
+                    MlasGemmU8X8ApplyColumnZeroPoints(C + n + m * ldc, ldc, CountM, CountN, RowSumVector, Parameters->ZeroPointB + n, ZeroPointBFlip, int32_t(CountK) * offa);
+                }
             }
         }
     }
 }
 
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K,
+    bool BIsSigned
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasGemmPackB for the quantized integer matrix/matrix multiply operation.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BIsSigned - Supplies true if matrix B holds signed elements.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(BIsSigned);
+
+    //
+    // Each slice along the K dimension stores the column sums followed by the
+    // interleaved pairs of rows from matrix B.
+    //
+
+    const size_t PackedCountN = MlasGemmU8X8PackedCountN(N);
+    const size_t SliceCount = (K + MLAS_GEMM_U8U8_STRIDEK - 1) / MLAS_GEMM_U8U8_STRIDEK;
+
+    return PackedCountN * SliceCount * sizeof(int32_t) + PackedCountN * ((K + 1) & ~size_t(1));
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    size_t N,
+    size_t K,
+    const uint8_t* B,
+    size_t ldb,
+    bool BIsSigned,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B for repeated use by the quantized integer
+    matrix/matrix multiply operation, so that a constant matrix B is not
+    packed again on each multiply.
+
+    The packed format depends on the kernels selected for the platform, so
+    the packed buffer must not be persisted across processes.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BIsSigned - Supplies true if matrix B holds signed elements.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasGemmPackBSize bytes and be aligned to the value returned by
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PackedCountN = MlasGemmU8X8PackedCountN(N);
+
+    int32_t* PackedColumnSums = (int32_t*)PackedB;
+    uint8_t* PackedData = (uint8_t*)PackedB + PackedCountN * ((K + MLAS_GEMM_U8U8_STRIDEK - 1) / MLAS_GEMM_U8U8_STRIDEK) * sizeof(int32_t);
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_GEMM_U8U8_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        const size_t PairedCountK = (CountK + 1) / 2;
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = MLAS_GEMM_U8U8_STRIDEN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            //
+            // Store the plain column sums, which are scaled by the zero point
+            // offset of matrix A for each multiply.
+            //
+
+            MlasGemmU8X8CopyPackB(PackedData + k * PackedCountN + n * PairedCountK * 2,
+                B + n + k * ldb, ldb, CountN, CountK,
+                PackedColumnSums + (k / MLAS_GEMM_U8U8_STRIDEK) * PackedCountN + n, 1, BIsSigned);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MLAS_GEMM_U8X8_PARAMETERS Parameters;
+
+    Parameters.M = M;
+    Parameters.N = N;
+    Parameters.K = K;
+    Parameters.A = A;
+    Parameters.lda = lda;
+    Parameters.ZeroPointA = offa;
+    Parameters.B = B;
+    Parameters.ldb = ldb;
+    Parameters.ZeroPointB = &offb;
+    Parameters.C = C;
+    Parameters.ldc = ldc;
+
+    MlasGemm(&Parameters, ThreadPool);
+}
+
 #endif
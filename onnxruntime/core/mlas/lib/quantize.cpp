@@ -0,0 +1,600 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    quantize.cpp
+
+Abstract:
+
+    This module implements routines to requantize the int32 output of a
+    quantized matrix multiply to uint8, and to quantize and dequantize
+    buffers with a linear scale and zero point.
+
+--*/
+
+#include "mlasi.h"
+#include <cmath>
+#include <type_traits>
+
+MLAS_FORCEINLINE
+uint8_t
+MlasRequantizeValue(
+    int32_t Value,
+    float Scale,
+    int32_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes a single value.
+
+Arguments:
+
+    Value - Supplies the biased int32 value.
+
+    Scale - Supplies the scale of the value.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    The requantized value.
+
+--*/
+{
+    int32_t IntegerValue = int32_t(std::nearbyint(float(Value) * Scale)) + ZeroPoint;
+
+    IntegerValue = std::max(IntegerValue, 0);
+    IntegerValue = std::min(IntegerValue, 255);
+
+    return uint8_t(IntegerValue);
+}
+
+MLAS_FORCEINLINE
+void
+MlasRequantizeOutputRow(
+    const int32_t* Input,
+    uint8_t* Output,
+    size_t N,
+    const int32_t* ColumnBias,
+    int32_t RowBias,
+    const float* ColumnScale,
+    float RowScale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes a row of the output of a matrix multiply.
+
+Arguments:
+
+    Input - Supplies the int32 values of the row.
+
+    Output - Supplies the address of the uint8 values of the row.
+
+    N - Supplies the number of values in the row.
+
+    ColumnBias - Optionally supplies a bias for each column, else RowBias is
+        added to all the values.
+
+    RowBias - Supplies the bias of the row.
+
+    ColumnScale - Optionally supplies a scale for each column, else RowScale
+        scales all the values.
+
+    RowScale - Supplies the scale of the row.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i RowBiasVector = _mm_set1_epi32(RowBias);
+    const MLAS_FLOAT32X4 RowScaleVector = MlasBroadcastFloat32x4(RowScale);
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+
+    while (N >= 4) {
+
+        __m128i IntegerVector = _mm_loadu_si128((const __m128i*)Input);
+
+        if (ColumnBias != nullptr) {
+            IntegerVector = _mm_add_epi32(IntegerVector, _mm_loadu_si128((const __m128i*)ColumnBias));
+            ColumnBias += 4;
+        } else {
+            IntegerVector = _mm_add_epi32(IntegerVector, RowBiasVector);
+        }
+
+        MLAS_FLOAT32X4 FloatVector = _mm_cvtepi32_ps(IntegerVector);
+
+        if (ColumnScale != nullptr) {
+            FloatVector = MlasMultiplyFloat32x4(FloatVector, MlasLoadFloat32x4(ColumnScale));
+            ColumnScale += 4;
+        } else {
+            FloatVector = MlasMultiplyFloat32x4(FloatVector, RowScaleVector);
+        }
+
+        //
+        // The conversion rounds to nearest even, and the packs saturate to
+        // the range of uint8.
+        //
+
+        IntegerVector = _mm_add_epi32(_mm_cvtps_epi32(FloatVector), ZeroPointVector);
+        IntegerVector = _mm_packs_epi32(IntegerVector, IntegerVector);
+        IntegerVector = _mm_packus_epi16(IntegerVector, IntegerVector);
+
+        *((int32_t*)Output) = _mm_cvtsi128_si32(IntegerVector);
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+    const int32x4_t RowBiasVector = vdupq_n_s32(RowBias);
+    const MLAS_FLOAT32X4 RowScaleVector = MlasBroadcastFloat32x4(RowScale);
+    const int32x4_t ZeroPointVector = vdupq_n_s32(ZeroPoint);
+
+    while (N >= 4) {
+
+        int32x4_t IntegerVector = vld1q_s32(Input);
+
+        if (ColumnBias != nullptr) {
+            IntegerVector = vaddq_s32(IntegerVector, vld1q_s32(ColumnBias));
+            ColumnBias += 4;
+        } else {
+            IntegerVector = vaddq_s32(IntegerVector, RowBiasVector);
+        }
+
+        MLAS_FLOAT32X4 FloatVector = vcvtq_f32_s32(IntegerVector);
+
+        if (ColumnScale != nullptr) {
+            FloatVector = MlasMultiplyFloat32x4(FloatVector, MlasLoadFloat32x4(ColumnScale));
+            ColumnScale += 4;
+        } else {
+            FloatVector = MlasMultiplyFloat32x4(FloatVector, RowScaleVector);
+        }
+
+        IntegerVector = vaddq_s32(vcvtnq_s32_f32(FloatVector), ZeroPointVector);
+        int16x4_t ShortVector = vqmovn_s32(IntegerVector);
+        uint8x8_t ByteVector = vqmovun_s16(vcombine_s16(ShortVector, ShortVector));
+
+        vst1_lane_u32((uint32_t*)Output, vreinterpret_u32_u8(ByteVector), 0);
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+
+        int32_t Value = Input[n];
+        Value += (ColumnBias != nullptr) ? ColumnBias[n] : RowBias;
+
+        Output[n] = MlasRequantizeValue(Value, (ColumnScale != nullptr) ? ColumnScale[n] : RowScale, ZeroPoint);
+    }
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const MLAS_REQUANTIZE_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the int32 output of a quantized matrix multiply
+    to uint8, adding the bias and applying the scale and zero point of the
+    output in a single pass.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the requantization
+        parameters.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const int32_t* Input = Parameters->Input;
+    uint8_t* Output = Parameters->Output;
+    const int32_t* Bias = Parameters->Bias;
+    const float* Scale = Parameters->Scale;
+
+    for (size_t m = 0; m < Parameters->M; m++) {
+
+        if (Parameters->ChannelIsColumn) {
+
+            MlasRequantizeOutputRow(Input, Output, Parameters->N, Bias, 0,
+                Parameters->PerChannelScale ? Scale : nullptr, Scale[0],
+                Parameters->ZeroPoint);
+
+        } else {
+
+            MlasRequantizeOutputRow(Input, Output, Parameters->N, nullptr,
+                (Bias != nullptr) ? Bias[m] : 0, nullptr,
+                Parameters->PerChannelScale ? Scale[m] : Scale[0],
+                Parameters->ZeroPoint);
+        }
+
+        Input += Parameters->ldi;
+        Output += Parameters->ldo;
+    }
+}
+
+template<typename OutputType>
+void
+MlasQuantizeLinearKernel(
+    const float* Input,
+    OutputType* Output,
+    size_t N,
+    float Scale,
+    OutputType ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a buffer to uint8 or int8.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr bool IsSigned = std::is_signed<OutputType>::value;
+    constexpr int32_t MinimumValue = IsSigned ? -127 : 0;
+    constexpr int32_t MaximumValue = std::numeric_limits<OutputType>::max();
+
+    //
+    // The values are clamped before the conversion to integer, so that large
+    // values don't overflow. The limits are integers, so clamping before or
+    // after the rounding gives the same result.
+    //
+
+    const float MinimumLimit = float(MinimumValue - int32_t(ZeroPoint));
+    const float MaximumLimit = float(MaximumValue - int32_t(ZeroPoint));
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const MLAS_FLOAT32X4 MinimumVector = MlasBroadcastFloat32x4(MinimumLimit);
+    const MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(MaximumLimit);
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 FloatVector0 = _mm_div_ps(MlasLoadFloat32x4(Input), ScaleVector);
+        MLAS_FLOAT32X4 FloatVector1 = _mm_div_ps(MlasLoadFloat32x4(Input + 4), ScaleVector);
+
+        FloatVector0 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector0, MinimumVector), MaximumVector);
+        FloatVector1 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector1, MinimumVector), MaximumVector);
+
+        //
+        // The conversion rounds to nearest even.
+        //
+
+        __m128i IntegerVector0 = _mm_add_epi32(_mm_cvtps_epi32(FloatVector0), ZeroPointVector);
+        __m128i IntegerVector1 = _mm_add_epi32(_mm_cvtps_epi32(FloatVector1), ZeroPointVector);
+
+        __m128i ShortVector = _mm_packs_epi32(IntegerVector0, IntegerVector1);
+        __m128i ByteVector = IsSigned ? _mm_packs_epi16(ShortVector, ShortVector) :
+            _mm_packus_epi16(ShortVector, ShortVector);
+
+        _mm_storel_epi64((__m128i*)Output, ByteVector);
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const MLAS_FLOAT32X4 MinimumVector = MlasBroadcastFloat32x4(MinimumLimit);
+    const MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(MaximumLimit);
+    const int32x4_t ZeroPointVector = vdupq_n_s32(ZeroPoint);
+
+    while (N >= 8) {
+
+        MLAS_FLOAT32X4 FloatVector0 = vdivq_f32(MlasLoadFloat32x4(Input), ScaleVector);
+        MLAS_FLOAT32X4 FloatVector1 = vdivq_f32(MlasLoadFloat32x4(Input + 4), ScaleVector);
+
+        FloatVector0 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector0, MinimumVector), MaximumVector);
+        FloatVector1 = MlasMinimumFloat32x4(MlasMaximumFloat32x4(FloatVector1, MinimumVector), MaximumVector);
+
+        int32x4_t IntegerVector0 = vaddq_s32(vcvtnq_s32_f32(FloatVector0), ZeroPointVector);
+        int32x4_t IntegerVector1 = vaddq_s32(vcvtnq_s32_f32(FloatVector1), ZeroPointVector);
+
+        int16x8_t ShortVector = vcombine_s16(vqmovn_s32(IntegerVector0), vqmovn_s32(IntegerVector1));
+
+        if (IsSigned) {
+            vst1_s8((int8_t*)Output, vqmovn_s16(ShortVector));
+        } else {
+            vst1_u8((uint8_t*)Output, vqmovun_s16(ShortVector));
+        }
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+
+        float FloatValue = std::nearbyint(Input[n] / Scale);
+        FloatValue = (std::max)(FloatValue, MinimumLimit);
+        FloatValue = (std::min)(FloatValue, MaximumLimit);
+
+        Output[n] = OutputType(int32_t(FloatValue) + int32_t(ZeroPoint));
+    }
+}
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a buffer to uint8.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasQuantizeLinearKernel<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    int8_t* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a buffer to int8.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasQuantizeLinearKernel<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+template<typename InputType>
+void
+MlasDequantizeLinearKernel(
+    const InputType* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    InputType ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of uint8 or int8 values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr bool IsSigned = std::is_signed<InputType>::value;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const __m128i ZeroPointVector = _mm_set1_epi16(ZeroPoint);
+
+    while (N >= 8) {
+
+        //
+        // Widen the bytes to 16 bits, where the difference with the zero
+        // point fits, and then to 32 bits.
+        //
+
+        __m128i ByteVector = _mm_loadl_epi64((const __m128i*)Input);
+        __m128i ShortVector = IsSigned ? _mm_srai_epi16(_mm_unpacklo_epi8(ByteVector, ByteVector), 8) :
+            _mm_unpacklo_epi8(ByteVector, _mm_setzero_si128());
+
+        ShortVector = _mm_sub_epi16(ShortVector, ZeroPointVector);
+
+        __m128i IntegerVector0 = _mm_srai_epi32(_mm_unpacklo_epi16(ShortVector, ShortVector), 16);
+        __m128i IntegerVector1 = _mm_srai_epi32(_mm_unpackhi_epi16(ShortVector, ShortVector), 16);
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(_mm_cvtepi32_ps(IntegerVector0), ScaleVector));
+        MlasStoreFloat32x4(Output + 4, MlasMultiplyFloat32x4(_mm_cvtepi32_ps(IntegerVector1), ScaleVector));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const int16x8_t ZeroPointVector = vdupq_n_s16(ZeroPoint);
+
+    while (N >= 8) {
+
+        int16x8_t ShortVector = IsSigned ? vmovl_s8(vld1_s8((const int8_t*)Input)) :
+            vreinterpretq_s16_u16(vmovl_u8(vld1_u8((const uint8_t*)Input)));
+
+        ShortVector = vsubq_s16(ShortVector, ZeroPointVector);
+
+        int32x4_t IntegerVector0 = vmovl_s16(vget_low_s16(ShortVector));
+        int32x4_t IntegerVector1 = vmovl_s16(vget_high_s16(ShortVector));
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(vcvtq_f32_s32(IntegerVector0), ScaleVector));
+        MlasStoreFloat32x4(Output + 4, MlasMultiplyFloat32x4(vcvtq_f32_s32(IntegerVector1), ScaleVector));
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+#endif
+
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = float(int32_t(Input[n]) - int32_t(ZeroPoint)) * Scale;
+    }
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const uint8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of uint8 values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasDequantizeLinearKernel<uint8_t>(Input, Output, N, Scale, ZeroPoint);
+}
+
+void
+MLASCALL
+MlasDequantizeLinear(
+    const int8_t* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    int8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a buffer of int8 values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the quantization scale.
+
+    ZeroPoint - Supplies the quantization zero point.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasDequantizeLinearKernel<int8_t>(Input, Output, N, Scale, ZeroPoint);
+}
@@ -0,0 +1,811 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sconv_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision convolution
+    operation using the NCHWc blocking format on ARM64 processors.
+
+    The kernels are written with the cross-platform vector intrinsic wrappers,
+    so each NCHWc block of MLAS_NEON_NCHWC_BLOCK_SIZE channels is held in a
+    small array of 128-bit vectors. Interior output positions are computed in
+    pairs so that each filter vector that is loaded feeds two multiply/adds.
+
+--*/
+
+#include "mlasi.h"
+
+constexpr size_t MlasConvNeonBlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+constexpr size_t MlasConvNeonVectorCount = MlasConvNeonBlockSize / 4;
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvNeonZeroAccumulators(
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][MlasConvNeonVectorCount]
+    )
+{
+    for (size_t o = 0; o < OutputCount; o++) {
+        for (size_t f = 0; f < FilterCount; f++) {
+            for (size_t v = 0; v < MlasConvNeonVectorCount; v++) {
+                Accumulators[o][f][v] = MlasZeroFloat32x4();
+            }
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvNeonStoreOutputs(
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][MlasConvNeonVectorCount],
+    float* Output,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the post processing steps requested by the kernel
+    flags to a set of accumulators and stores the result to the output buffer.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for each output position and
+        filter set.
+
+    Output - Supplies the address of the first output position.
+
+    OutputStride - Supplies the number of elements between filter sets of the
+        output buffer.
+
+    Bias - Supplies the bias buffer.
+
+    KernelFlags - Supplies additional flags controlling the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ZeroVector = MlasZeroFloat32x4();
+
+    for (size_t o = 0; o < OutputCount; o++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            float* output = Output + f * OutputStride + o * MlasConvNeonBlockSize;
+
+            for (size_t v = 0; v < MlasConvNeonVectorCount; v++) {
+
+                MLAS_FLOAT32X4 Accumulator = Accumulators[o][f][v];
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT) != 0) {
+                    Accumulator = MlasAddFloat32x4(Accumulator, MlasLoadFloat32x4(&output[v * 4]));
+                }
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION) != 0) {
+                    Accumulator = MlasAddFloat32x4(Accumulator,
+                        MlasLoadFloat32x4(&Bias[f * MlasConvNeonBlockSize + v * 4]));
+                }
+
+                if ((KernelFlags & MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION) != 0) {
+                    Accumulator = MlasMaximumFloat32x4(Accumulator, ZeroVector);
+                }
+
+                MlasStoreFloat32x4(&output[v * 4], Accumulator);
+            }
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount, bool InputIsNchwc, bool CheckBounds>
+MLAS_FORCEINLINE
+void
+MlasConvNeonComputeOutputs(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine computes one or two adjacent output positions of a direct
+    convolution for up to four filter sets.
+
+Arguments:
+
+    Input - Supplies the address of the input for the first output position.
+
+    Filter - Supplies the address of the filter for the first filter set.
+
+    Output - Supplies the address of the first output position.
+
+    StrideWidth - Supplies the number of elements between output positions
+        in the input buffer.
+
+    DilationWidth - Supplies the number of elements between kernel columns
+        in the input buffer.
+
+    FilterStride - Supplies the number of elements between filter sets.
+
+    OutputStride - Supplies the number of elements between filter sets of the
+        output buffer.
+
+    KernelHeight - Supplies the effective height of the kernel.
+
+    KernelWidth - Supplies the width of the kernel.
+
+    InputBase - Supplies the address of the first valid element of the first
+        input row used by the kernel.
+
+    InputWidth - Supplies the number of elements in a valid input row.
+
+    DilatedInputWidth - Supplies the number of elements between kernel rows
+        in the input buffer.
+
+    Bias - Supplies the bias buffer.
+
+    KernelFlags - Supplies additional flags controlling the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // An NCHWc input supplies a block of input channels at each position that
+    // is multiplied by a square block of the filter, while an NCHW input
+    // supplies a single channel multiplied by a single row of the filter.
+    //
+
+    constexpr size_t InputChannels = InputIsNchwc ? MlasConvNeonBlockSize : 1;
+    constexpr size_t FilterTapSize = InputChannels * MlasConvNeonBlockSize;
+
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][MlasConvNeonVectorCount];
+
+    MlasConvNeonZeroAccumulators<FilterCount, OutputCount>(Accumulators);
+
+    for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+        const float* input = Input + kh * DilatedInputWidth;
+        const float* inputRowBase = InputBase + kh * DilatedInputWidth;
+        const float* filter = Filter + kh * KernelWidth * FilterTapSize;
+
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+            //
+            // Positions that read from the input padding are skipped. This is
+            // only possible for the output positions on the left or right edge.
+            //
+
+            if (CheckBounds && size_t(input - inputRowBase) >= InputWidth) {
+                input += DilationWidth;
+                filter += FilterTapSize;
+                continue;
+            }
+
+            for (size_t ic = 0; ic < InputChannels; ic++) {
+
+                MLAS_FLOAT32X4 InputVector[OutputCount];
+
+                for (size_t o = 0; o < OutputCount; o++) {
+                    InputVector[o] = MlasBroadcastFloat32x4(&input[o * StrideWidth + ic]);
+                }
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    const float* filterBlock = filter + f * FilterStride + ic * MlasConvNeonBlockSize;
+
+                    for (size_t v = 0; v < MlasConvNeonVectorCount; v++) {
+
+                        MLAS_FLOAT32X4 FilterVector = MlasLoadFloat32x4(&filterBlock[v * 4]);
+
+                        for (size_t o = 0; o < OutputCount; o++) {
+                            Accumulators[o][f][v] = MlasMultiplyAddFloat32x4(InputVector[o],
+                                FilterVector, Accumulators[o][f][v]);
+                        }
+                    }
+                }
+            }
+
+            input += DilationWidth;
+            filter += FilterTapSize;
+        }
+    }
+
+    MlasConvNeonStoreOutputs<FilterCount, OutputCount>(Accumulators, Output,
+        OutputStride, Bias, KernelFlags);
+}
+
+template<size_t FilterCount, bool InputIsNchwc>
+void
+MlasConvNeonFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the direct convolution for a single output row
+    with the strides converted from bytes to elements. See the description of
+    MlasConvNchwcFloatKernelNeon for the arguments.
+
+--*/
+{
+    const size_t OutputBlockStride = MlasConvNeonBlockSize;
+
+    size_t ow = 0;
+
+    //
+    // Process the output positions that may read from the left padding.
+    //
+
+    for (; ow < OutputCountLeftPad; ow++) {
+        MlasConvNeonComputeOutputs<FilterCount, 1, InputIsNchwc, true>(
+            Input + ow * StrideWidth, Filter, Output + ow * OutputBlockStride,
+            StrideWidth, DilationWidth, FilterStride, OutputStride, KernelHeight,
+            KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    }
+
+    //
+    // Process the interior output positions in pairs.
+    //
+
+    const size_t OutputCountInterior = OutputCountLeftPad + OutputCount;
+
+    for (; ow + 2 <= OutputCountInterior; ow += 2) {
+        MlasConvNeonComputeOutputs<FilterCount, 2, InputIsNchwc, false>(
+            Input + ow * StrideWidth, Filter, Output + ow * OutputBlockStride,
+            StrideWidth, DilationWidth, FilterStride, OutputStride, KernelHeight,
+            KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    }
+
+    if (ow < OutputCountInterior) {
+        MlasConvNeonComputeOutputs<FilterCount, 1, InputIsNchwc, false>(
+            Input + ow * StrideWidth, Filter, Output + ow * OutputBlockStride,
+            StrideWidth, DilationWidth, FilterStride, OutputStride, KernelHeight,
+            KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+        ow++;
+    }
+
+    //
+    // Process the output positions that may read from the right padding.
+    //
+
+    const size_t OutputCountTotal = OutputCountInterior + OutputCountRightPad;
+
+    for (; ow < OutputCountTotal; ow++) {
+        MlasConvNeonComputeOutputs<FilterCount, 1, InputIsNchwc, true>(
+            Input + ow * StrideWidth, Filter, Output + ow * OutputBlockStride,
+            StrideWidth, DilationWidth, FilterStride, OutputStride, KernelHeight,
+            KernelWidth, InputBase, InputWidth, DilatedInputWidth, Bias, KernelFlags);
+    }
+}
+
+template<bool InputIsNchwc>
+void
+MlasConvNeonDispatchFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    //
+    // Convert the strides from bytes to elements.
+    //
+
+    StrideWidth /= sizeof(float);
+    DilationWidth /= sizeof(float);
+    FilterStride /= sizeof(float);
+    OutputStride /= sizeof(float);
+    InputWidth /= sizeof(float);
+    DilatedInputWidth /= sizeof(float);
+
+    decltype(&MlasConvNeonFloatKernel<1, InputIsNchwc>) Kernel;
+
+    switch (FilterCount) {
+
+        case 1:
+            Kernel = MlasConvNeonFloatKernel<1, InputIsNchwc>;
+            break;
+
+        case 2:
+            Kernel = MlasConvNeonFloatKernel<2, InputIsNchwc>;
+            break;
+
+        case 3:
+            Kernel = MlasConvNeonFloatKernel<3, InputIsNchwc>;
+            break;
+
+        default:
+            Kernel = MlasConvNeonFloatKernel<4, InputIsNchwc>;
+            break;
+    }
+
+    Kernel(Input, Filter, Output, StrideWidth, DilationWidth, FilterStride,
+        OutputStride, KernelHeight, KernelWidth, InputBase, InputWidth,
+        DilatedInputWidth, OutputCountLeftPad, OutputCount, OutputCountRightPad,
+        Bias, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvNchwFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the input buffer is in
+    NCHW format.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernelNeon. The input buffer supplies a single
+    channel, so the filter for each kernel position is a single row of
+    MLAS_NEON_NCHWC_BLOCK_SIZE elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(InputStride);
+
+    MlasConvNeonDispatchFloatKernel<false>(Input, Filter, Output, StrideWidth,
+        DilationWidth, FilterCount, FilterStride, OutputStride, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad,
+        OutputCount, OutputCountRightPad, Bias, Flags);
+}
+
+void
+MLASCALL
+MlasConvNchwcFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the input buffer is in
+    NCHWc format.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer for the first output
+        position, which may point into the left padding.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation width.
+
+    FilterCount - Supplies the number of filter sets to process.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row. This kernel derives the rows from DilatedInputWidth.
+
+    FilterStride - Supplies the length in bytes between filter sets.
+
+    OutputStride - Supplies the length in bytes between output sets.
+
+    KernelHeight - Supplies the height of the kernel to apply. This height may
+        be less than the original kernel height after removing any padding
+        rows.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(InputStride);
+
+    MlasConvNeonDispatchFloatKernel<true>(Input, Filter, Output, StrideWidth,
+        DilationWidth, FilterCount, FilterStride, OutputStride, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad,
+        OutputCount, OutputCountRightPad, Bias, Flags);
+}
+
+template<bool CheckBounds>
+MLAS_FORCEINLINE
+void
+MlasConvDepthwiseNeonComputeOutput(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t DilationWidth,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    MLAS_FLOAT32X4 Accumulators[1][1][MlasConvNeonVectorCount];
+
+    MlasConvNeonZeroAccumulators<1, 1>(Accumulators);
+
+    for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+        const float* input = Input + kh * DilatedInputWidth;
+        const float* inputRowBase = InputBase + kh * DilatedInputWidth;
+        const float* filter = Filter + kh * KernelWidth * MlasConvNeonBlockSize;
+
+        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+            if (!CheckBounds || size_t(input - inputRowBase) < InputWidth) {
+
+                for (size_t v = 0; v < MlasConvNeonVectorCount; v++) {
+                    Accumulators[0][0][v] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(&input[v * 4]),
+                        MlasLoadFloat32x4(&filter[v * 4]), Accumulators[0][0][v]);
+                }
+            }
+
+            input += DilationWidth;
+            filter += MlasConvNeonBlockSize;
+        }
+    }
+
+    MlasConvNeonStoreOutputs<1, 1>(Accumulators, Output, 0, Bias, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvDepthwiseFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a depthwise separable
+    convolution for the elements of an output row for a block of channels.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernelNeon. The filter for each kernel position is a
+    single row of MLAS_NEON_NCHWC_BLOCK_SIZE elements that is multiplied by
+    the corresponding input channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(InputStride);
+
+    StrideWidth /= sizeof(float);
+    DilationWidth /= sizeof(float);
+    InputWidth /= sizeof(float);
+    DilatedInputWidth /= sizeof(float);
+
+    const size_t OutputCountInterior = OutputCountLeftPad + OutputCount;
+    const size_t OutputCountTotal = OutputCountInterior + OutputCountRightPad;
+
+    for (size_t ow = 0; ow < OutputCountTotal; ow++) {
+
+        const float* input = Input + ow * StrideWidth;
+        float* output = Output + ow * MlasConvNeonBlockSize;
+
+        if (ow >= OutputCountLeftPad && ow < OutputCountInterior) {
+            MlasConvDepthwiseNeonComputeOutput<false>(input, Filter, output,
+                DilationWidth, KernelHeight, KernelWidth, InputBase, InputWidth,
+                DilatedInputWidth, Bias, Flags);
+        } else {
+            MlasConvDepthwiseNeonComputeOutput<true>(input, Filter, output,
+                DilationWidth, KernelHeight, KernelWidth, InputBase, InputWidth,
+                DilatedInputWidth, Bias, Flags);
+        }
+    }
+}
+
+template<size_t FilterCount, size_t OutputCount>
+MLAS_FORCEINLINE
+void
+MlasConvPointwiseNeonComputeOutputs(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    MLAS_FLOAT32X4 Accumulators[OutputCount][FilterCount][MlasConvNeonVectorCount];
+
+    MlasConvNeonZeroAccumulators<FilterCount, OutputCount>(Accumulators);
+
+    for (size_t icb = 0; icb < InputChannels; icb++) {
+
+        const float* input = Input + icb * InputStride;
+        const float* filter = Filter + icb * MlasConvNeonBlockSize * MlasConvNeonBlockSize;
+
+        for (size_t ic = 0; ic < MlasConvNeonBlockSize; ic++) {
+
+            MLAS_FLOAT32X4 InputVector[OutputCount];
+
+            for (size_t o = 0; o < OutputCount; o++) {
+                InputVector[o] = MlasBroadcastFloat32x4(&input[o * StrideWidth + ic]);
+            }
+
+            for (size_t f = 0; f < FilterCount; f++) {
+
+                const float* filterBlock = filter + f * FilterStride + ic * MlasConvNeonBlockSize;
+
+                for (size_t v = 0; v < MlasConvNeonVectorCount; v++) {
+
+                    MLAS_FLOAT32X4 FilterVector = MlasLoadFloat32x4(&filterBlock[v * 4]);
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+                        Accumulators[o][f][v] = MlasMultiplyAddFloat32x4(InputVector[o],
+                            FilterVector, Accumulators[o][f][v]);
+                    }
+                }
+            }
+        }
+    }
+
+    MlasConvNeonStoreOutputs<FilterCount, OutputCount>(Accumulators, Output,
+        OutputStride, Bias, KernelFlags);
+}
+
+template<size_t FilterCount>
+void
+MlasConvPointwiseNeonFloatKernel(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned KernelFlags
+    )
+{
+    size_t ow = 0;
+
+    for (; ow + 2 <= OutputCount; ow += 2) {
+        MlasConvPointwiseNeonComputeOutputs<FilterCount, 2>(Input + ow * StrideWidth,
+            Filter, Output + ow * MlasConvNeonBlockSize, StrideWidth, InputChannels,
+            InputStride, FilterStride, OutputStride, Bias, KernelFlags);
+    }
+
+    if (ow < OutputCount) {
+        MlasConvPointwiseNeonComputeOutputs<FilterCount, 1>(Input + ow * StrideWidth,
+            Filter, Output + ow * MlasConvNeonBlockSize, StrideWidth, InputChannels,
+            InputStride, FilterStride, OutputStride, Bias, KernelFlags);
+    }
+}
+
+void
+MLASCALL
+MlasConvPointwiseFloatKernelNeon(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a pointwise convolution for the
+    elements of an output row for a set of filter rows.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    InputChannels - Supplies the number of input channel blocks to process.
+
+    FilterCount - Supplies the number of filter sets to process.
+
+    InputStride - Supplies the length in bytes between input channel blocks.
+
+    FilterStride - Supplies the length in bytes between filter sets.
+
+    OutputStride - Supplies the length in bytes between output sets.
+
+    OutputCount - Supplies the number of output elements to compute.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    StrideWidth /= sizeof(float);
+    InputStride /= sizeof(float);
+    FilterStride /= sizeof(float);
+    OutputStride /= sizeof(float);
+
+    decltype(&MlasConvPointwiseNeonFloatKernel<1>) Kernel;
+
+    switch (FilterCount) {
+
+        case 1:
+            Kernel = MlasConvPointwiseNeonFloatKernel<1>;
+            break;
+
+        case 2:
+            Kernel = MlasConvPointwiseNeonFloatKernel<2>;
+            break;
+
+        case 3:
+            Kernel = MlasConvPointwiseNeonFloatKernel<3>;
+            break;
+
+        default:
+            Kernel = MlasConvPointwiseNeonFloatKernel<4>;
+            break;
+    }
+
+    Kernel(Input, Filter, Output, StrideWidth, InputChannels, InputStride,
+        FilterStride, OutputStride, OutputCount, Bias, Flags);
+}
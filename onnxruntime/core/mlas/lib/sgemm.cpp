@@ -40,15 +40,47 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
+    size_t PackedCountN;
+    const MLAS_SGEMM_EPILOGUE* Epilogue;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t StartM;
+        size_t StartN;
         const float* A;
         const float* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads. Each operation is split into ThreadsPerGemm work items and each
+// thread executes a contiguous range of the work items.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    const MLAS_SGEMM_PARAMETERS* Parameters;
+    size_t ThreadsPerGemm;
+    size_t WorkItemCount;
+    int32_t ThreadCount;
+};
+
+//
+// Returns the number of columns of a matrix B packed by MlasGemmPackB. The
+// columns are padded to a multiple of the packed panel width.
+//
+
+inline
+size_t
+MlasSgemmPackedCountN(
+    size_t N
+    )
+{
+    return (N + 15) & ~size_t(15);
+}
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 //
@@ -121,6 +153,173 @@ Return Value:
     } while (CountM > 0);
 }
 
+const MLAS_SGEMM_EPILOGUE*
+MlasSgemmOffsetEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN,
+    MLAS_SGEMM_EPILOGUE* OffsetEpilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine adjusts the post processing parameters of a SGEMM operation
+    for a submatrix of the output matrix.
+
+Arguments:
+
+    Epilogue - Supplies the post processing parameters for the output matrix,
+        else nullptr if the operation has no post processing.
+
+    StartM - Supplies the first row of the submatrix.
+
+    StartN - Supplies the first column of the submatrix.
+
+    OffsetEpilogue - Supplies the storage for the adjusted parameters.
+
+Return Value:
+
+    Returns the post processing parameters for the submatrix, else nullptr if
+    the operation has no post processing.
+
+--*/
+{
+    if (Epilogue == nullptr) {
+        return nullptr;
+    }
+
+    *OffsetEpilogue = *Epilogue;
+
+    if (OffsetEpilogue->ColumnBias != nullptr) {
+        OffsetEpilogue->ColumnBias += StartN;
+    }
+
+    if (OffsetEpilogue->RowBias != nullptr) {
+        OffsetEpilogue->RowBias += StartM;
+    }
+
+    if (OffsetEpilogue->Residual != nullptr) {
+        OffsetEpilogue->Residual += StartM * OffsetEpilogue->ldr + StartN;
+    }
+
+    return OffsetEpilogue;
+}
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the post processing of a SGEMM operation to a tile
+    of the output matrix.
+
+Arguments:
+
+    Epilogue - Supplies the post processing parameters for the panel of the
+        output matrix that contains the tile.
+
+    StartM - Supplies the first row of the tile relative to the panel.
+
+    C - Supplies the address of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* ColumnBias = Epilogue->ColumnBias;
+    const float* Residual = Epilogue->Residual;
+
+    if (Residual != nullptr) {
+        Residual += StartM * Epilogue->ldr;
+    }
+
+    if (ColumnBias != nullptr || Residual != nullptr) {
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= CountN; n += 4) {
+
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(&c[n]);
+
+                if (ColumnBias != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&ColumnBias[n]));
+                }
+
+                if (Residual != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&Residual[n]));
+                }
+
+                MlasStoreFloat32x4(&c[n], Vector);
+            }
+
+            for (; n < CountN; n++) {
+
+                float Value = c[n];
+
+                if (ColumnBias != nullptr) {
+                    Value += ColumnBias[n];
+                }
+
+                if (Residual != nullptr) {
+                    Value += Residual[n];
+                }
+
+                c[n] = Value;
+            }
+
+            c += ldc;
+
+            if (Residual != nullptr) {
+                Residual += Epilogue->ldr;
+            }
+        }
+    }
+
+    //
+    // Apply the activation after adding the row bias vector.
+    //
+
+    MLAS_ACTIVATION IdentityActivation;
+    IdentityActivation.ActivationKind = MlasIdentityActivation;
+
+    const MLAS_ACTIVATION* Activation = Epilogue->Activation;
+
+    if (Activation == nullptr) {
+        Activation = &IdentityActivation;
+    }
+
+    const float* RowBias = Epilogue->RowBias;
+
+    if (RowBias != nullptr) {
+        RowBias += StartM;
+    } else if (Activation->ActivationKind == MlasIdentityActivation) {
+        return;
+    }
+
+    MlasActivation(Activation, C, RowBias, CountM, CountN, ldc);
+}
+
 void
 MlasSgemmTransposeA(
     float* D,
@@ -772,6 +971,162 @@ Return Value:
     }
 }
 
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A with a packed panel of matrix B
+    and accumulates the result into the output matrix.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns from the packed panel and matrix C.
+
+    CountK - Supplies the number of rows from the packed panel and the number
+        of columns from the slice of matrix A.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+    Epilogue - Supplies the post processing parameters for the panel of the
+        output matrix if this slice completes the accumulation, else nullptr.
+        The post processing is applied to each block of rows produced by the
+        kernel while the results are still cache resident.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, M - RowsRemaining, c, RowsHandled, CountN, ldc);
+            }
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                if (Epilogue != nullptr) {
+                    MlasSgemmApplyEpilogue(Epilogue, M - RowsRemaining - RowsTransposed, c, RowsHandled, CountN, ldc);
+                }
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -786,7 +1141,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -824,13 +1180,15 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the post processing parameters for matrix C, else
+        nullptr if no post processing is required.
+
 Return Value:
 
     None.
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -852,7 +1210,13 @@ Return Value:
         }
 
         if (SgemmKernelM1Routine != nullptr) {
+
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, 0, C, 1, N, ldc);
+            }
+
             return;
         }
 
@@ -909,6 +1273,10 @@ Return Value:
             MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
         }
 
+        MLAS_SGEMM_EPILOGUE PanelEpilogueStorage;
+        const MLAS_SGEMM_EPILOGUE* PanelEpilogue =
+            MlasSgemmOffsetEpilogue(Epilogue, 0, n, &PanelEpilogueStorage);
+
         //
         // Step through each slice of matrix B along the K dimension.
         //
@@ -933,91 +1301,138 @@ Return Value:
                 MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
             }
 
-            //
-            // Step through each slice of matrix A along the M dimension.
-            //
-
-            float* c = C + n;
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda, PanelB,
+                C + n, ldc, ZeroMode, (k + CountK == K) ? PanelEpilogue : nullptr);
+        }
+    }
+}
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t PackedCountN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
 
-            if (TransA == CblasNoTrans) {
+Routine Description:
 
-                const float* a = A + k;
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with matrix B supplied in the format produced by
+    MlasGemmPackB.
 
-                //
-                // Step through the rows of matrix A.
-                //
+Arguments:
 
-                do {
+    TransA - Supplies the transpose operation for matrix A.
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    M - Supplies the number of rows of matrix A and matrix C.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+    RangeStartN - Supplies the starting column from the packed matrix B. This
+        is a multiple of the packed panel width.
 
-                    RowsRemaining -= RowsHandled;
+    RangeCountN - Supplies the number of columns from the packed matrix B and
+        matrix C.
 
-                } while (RowsRemaining > 0);
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-            } else {
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-                const float* a = A + k * lda;
+    A - Supplies the address of matrix A.
 
-                do {
+    lda - Supplies the first dimension of matrix A.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    PackedB - Supplies the address of the packed matrix B.
 
-                    size_t RowsTransposed = RowsRemaining;
+    PackedCountN - Supplies the number of columns of the packed matrix B,
+        including the padding.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-                    RowsRemaining -= RowsTransposed;
+    C - Supplies the address of matrix C.
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    ldc - Supplies the first dimension of matrix C.
 
-                    a += RowsTransposed;
+    Epilogue - Supplies the post processing parameters for matrix C, else
+        nullptr if no post processing is required.
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+Return Value:
 
-                    const float* pa = PanelA;
+    None.
 
-                    do {
+--*/
+{
+    //
+    // Expand the N stride if K is small for better utilization of the B
+    // panel. The K stride is fixed by the layout of the packed buffer.
+    //
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
-#else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+    size_t StrideN = MLAS_SGEMM_STRIDEN;
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+    for (size_t StrideK = MLAS_SGEMM_STRIDEK; StrideK / 2 >= K; StrideK /= 2) {
+        StrideN *= 2;
+    }
 
-                        RowsTransposed -= RowsHandled;
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (RangeCountN - n)) {
+            CountN = RangeCountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
 
-                    } while (RowsTransposed > 0);
+        MLAS_SGEMM_EPILOGUE PanelEpilogueStorage;
+        const MLAS_SGEMM_EPILOGUE* PanelEpilogue =
+            MlasSgemmOffsetEpilogue(Epilogue, 0, n, &PanelEpilogueStorage);
 
-                } while (RowsRemaining > 0);
+        //
+        // Step through each slice of matrix B along the K dimension. Each
+        // slice of the packed buffer holds all of its columns, so the panel
+        // for this range of columns is already contiguous.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
+
+            const float* PanelB = PackedB + k * PackedCountN + (RangeStartN + n) * CountK;
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda, PanelB,
+                C + n, ldc, ZeroMode, (k + CountK == K) ? PanelEpilogue : nullptr);
         }
     }
 }
@@ -1050,10 +1465,24 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    MLAS_SGEMM_EPILOGUE SegmentEpilogueStorage;
+    const MLAS_SGEMM_EPILOGUE* SegmentEpilogue = MlasSgemmOffsetEpilogue(WorkBlock->Epilogue,
+        Segment->StartM, Segment->StartN, &SegmentEpilogueStorage);
+
+    if (WorkBlock->PackedB != nullptr) {
+
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->StartN,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->PackedCountN, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc, SegmentEpilogue);
+
+    } else {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, SegmentEpilogue);
+    }
 }
 
 inline
@@ -1069,9 +1498,12 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    const float* PackedB,
+    size_t PackedCountN,
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1104,12 +1536,21 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB, else
+        nullptr if B and ldb supply matrix B.
+
+    PackedCountN - Supplies the number of columns of the packed matrix B,
+        including the padding.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the post processing parameters for matrix C, else
+        nullptr if no post processing is required.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1130,17 +1571,8 @@ Return Value:
 
     double Complexity = double(M) * double(N) * double(K);
 
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
-        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
-    }
-
-    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+    TargetThreadCount = MlasGetTargetThreadCount(Complexity,
+        MlasPlatform.CostModel.GemmThreadComplexity, ThreadPool);
 
     if (TargetThreadCount == 1) {
         return false;
@@ -1158,6 +1590,9 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.PackedCountN = PackedCountN;
+    WorkBlock.Epilogue = Epilogue;
 
     //
     // Segment the operation across multiple threads.
@@ -1173,8 +1608,7 @@ Return Value:
             StrideN++;
         }
 
-        StrideN =
-            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+        StrideN = MlasAlignThreadStrideN(StrideN);
 
         size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
 
@@ -1188,8 +1622,10 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].StartM = 0;
+            WorkBlock.Segments[Index].StartN = n;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (PackedB == nullptr) ? B + n * pldb : nullptr;
             WorkBlock.Segments[Index].C = C + n;
 
             Index++;
@@ -1215,6 +1651,8 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].StartM = m;
+            WorkBlock.Segments[Index].StartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1244,7 +1682,8 @@ MlasSgemm(
     float beta,
     float* C,
     size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1285,6 +1724,9 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    Epilogue - Supplies the post processing parameters for matrix C, else
+        nullptr if no post processing is required.
+
 Return Value:
 
     None.
@@ -1296,7 +1738,380 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr, 0, beta, C, ldc,
+            Epilogue, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, Epilogue);
+    }
+}
+
+void
+MlasSgemmBatchOperation(
+    const MLAS_SGEMM_PARAMETERS* Parameters,
+    size_t ThreadsPerGemm,
+    size_t WorkItem
+    )
+/*++
+
+Routine Description:
+
+    This routine executes a work item of a batched SGEMM operation.
+
+Arguments:
+
+    Parameters - Supplies the parameters for the batch of SGEMM operations.
+
+    ThreadsPerGemm - Supplies the number of work items that each SGEMM
+        operation is split into.
+
+    WorkItem - Supplies the index of the work item to execute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SGEMM_PARAMETERS* Gemm = &Parameters[WorkItem / ThreadsPerGemm];
+    const size_t Part = WorkItem % ThreadsPerGemm;
+
+    const float* A = Gemm->A;
+    const float* B = Gemm->B;
+    float* C = Gemm->C;
+    size_t M = Gemm->M;
+    size_t N = Gemm->N;
+
+    //
+    // Split the operation along the larger dimension as done for a single
+    // SGEMM operation by MlasSgemmTryMultithread.
+    //
+
+    MLAS_SGEMM_EPILOGUE PartEpilogueStorage;
+    const MLAS_SGEMM_EPILOGUE* PartEpilogue = Gemm->Epilogue;
+
+    if (ThreadsPerGemm > 1) {
+
+        if (N > M) {
+
+            size_t StrideN = (N + ThreadsPerGemm - 1) / ThreadsPerGemm;
+
+            StrideN = MlasAlignThreadStrideN(StrideN);
+
+            const size_t n = Part * StrideN;
+
+            if (n >= N) {
+                return;
+            }
+
+            B += n * ((Gemm->TransB == CblasNoTrans) ? 1 : Gemm->ldb);
+            C += n;
+            N = (std::min)(StrideN, N - n);
+
+            PartEpilogue = MlasSgemmOffsetEpilogue(Gemm->Epilogue, 0, n, &PartEpilogueStorage);
+
+        } else {
+
+            const size_t StrideM = (M + ThreadsPerGemm - 1) / ThreadsPerGemm;
+
+            const size_t m = Part * StrideM;
+
+            if (m >= M) {
+                return;
+            }
+
+            A += m * ((Gemm->TransA == CblasNoTrans) ? Gemm->lda : 1);
+            C += m * Gemm->ldc;
+            M = (std::min)(StrideM, M - m);
+
+            PartEpilogue = MlasSgemmOffsetEpilogue(Gemm->Epilogue, m, 0, &PartEpilogueStorage);
+        }
+    }
+
+    MlasSgemmOperation(Gemm->TransA, Gemm->TransB, M, N, Gemm->K, Gemm->alpha,
+        A, Gemm->lda, B, Gemm->ldb, Gemm->beta, C, Gemm->ldc, PartEpilogue);
+}
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    work items of a batched SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    const size_t WorkPerThread = WorkBlock->WorkItemCount / WorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = WorkBlock->WorkItemCount % WorkBlock->ThreadCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkRemaining = WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkRemaining = WorkPerThread;
+    }
+
+    while (WorkRemaining-- > 0) {
+        MlasSgemmBatchOperation(WorkBlock->Parameters, WorkBlock->ThreadsPerGemm, WorkIndex++);
+    }
+}
+
+void
+MLASCALL
+MlasSgemmBatch(
+    const MLAS_SGEMM_PARAMETERS* Parameters,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of independent single precision
+    matrix/matrix multiply operations (SGEMM).
+
+Arguments:
+
+    Parameters - Supplies the parameters for each SGEMM operation of the
+        batch. See MlasSgemm for the definition of the fields.
+
+    BatchSize - Supplies the number of SGEMM operations.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. A batch of small requests runs using the single threaded path.
+    //
+
+    double Complexity = 0.0;
+
+    for (size_t i = 0; i < BatchSize; i++) {
+        Complexity += double(Parameters[i].M) * double(Parameters[i].N) * double(Parameters[i].K);
+    }
+
+    int32_t TargetThreadCount = MlasGetTargetThreadCount(Complexity,
+        MlasPlatform.CostModel.GemmThreadComplexity, ThreadPool);
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t i = 0; i < BatchSize; i++) {
+            MlasSgemmBatchOperation(Parameters, 1, i);
+        }
+
+        return;
+    }
+
+    //
+    // Split each operation into enough work items to keep the target threads
+    // busy if the batch is smaller than the number of threads, then hand each
+    // thread a contiguous range of the work items.
+    //
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.ThreadsPerGemm = (size_t(TargetThreadCount) + BatchSize - 1) / BatchSize;
+    WorkBlock.WorkItemCount = BatchSize * WorkBlock.ThreadsPerGemm;
+    WorkBlock.ThreadCount = int32_t((std::min)(size_t(TargetThreadCount), WorkBlock.WorkItemCount));
+
+    MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, WorkBlock.ThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack matrix B with
+    MlasGemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    //
+    // Columns are padded to a multiple of the packed panel width.
+    //
+
+    return MlasSgemmPackedCountN(N) * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B for repeated use by MlasSgemmPacked, so that
+    a constant matrix B is not packed again on each multiply.
+
+    Matrix B is packed in slices of MLAS_SGEMM_STRIDEK rows. Each slice holds
+    all columns of matrix B in the panel layout used by the SGEMM kernels.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        MlasGemmPackBSize bytes and be aligned to the value returned by
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PackedCountN = MlasSgemmPackedCountN(N);
+
+    float* D = (float*)PackedB;
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += PackedCountN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasSgemmPacked(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with matrix B packed by MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+    Epilogue - Supplies the post processing parameters for matrix C, else
+        nullptr if no post processing is required.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* PackedBuffer = (const float*)PackedB;
+    const size_t PackedCountN = MlasSgemmPackedCountN(N);
+
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, nullptr, 0,
+            PackedBuffer, PackedCountN, beta, C, ldc, Epilogue, ThreadPool)) {
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda, PackedBuffer,
+            PackedCountN, beta, C, ldc, Epilogue);
     }
 }
@@ -66,15 +66,6 @@ struct MLAS_NCHWC_POOL_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK
     MLAS_POOLING_KIND PoolingKind;
 };
 
-//
-// Define the convolution kernel flags.
-//
-
-#define MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT     0x00000001
-#define MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION         0x00000002
-#define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION       0x00000004
-#define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION      0x00000008
-
 size_t
 MLASCALL
 MlasNchwcGetBlockSize(
@@ -101,7 +92,7 @@ Return Value:
 
 --*/
 {
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
     return MlasPlatform.NchwcBlockSize;
 #else
     return 1;
@@ -699,7 +690,7 @@ struct MLAS_NCHWC_CONV_NCHWC_ALGORITHM : MLAS_NCHWC_GROUPED_CONV_ALGORITHM
 
         const size_t BlockedOutputWidth = BlockSize * OutputWidth;
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
         MLAS_CONV_FLOAT_KERNEL* Kernel = MlasPlatform.ConvNchwcFloatKernel;
 #else
         MLAS_CONV_FLOAT_KERNEL* Kernel = MlasConvNchwcFloatKernel;
@@ -809,7 +800,7 @@ struct MLAS_NCHWC_CONV_NCHW_ALGORITHM : MLAS_NCHWC_GROUPED_CONV_ALGORITHM
 
         const size_t BlockedOutputWidth = BlockSize * OutputWidth;
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
         MLAS_CONV_FLOAT_KERNEL* Kernel = MlasPlatform.ConvNchwFloatKernel;
 #else
         MLAS_CONV_FLOAT_KERNEL* Kernel = MlasConvNchwFloatKernel;
@@ -904,7 +895,7 @@ struct MLAS_NCHWC_CONV_POINTWISE_ALGORITHM : MLAS_NCHWC_GROUPED_CONV_ALGORITHM
         const size_t FilterStrideBytes = BlockSize * InputChannels * sizeof(float);
         const size_t OutputStrideBytes = BlockSize * OutputSize * sizeof(float);
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
         MLAS_CONV_POINTWISE_FLOAT_KERNEL* Kernel = MlasPlatform.ConvPointwiseFloatKernel;
 #else
         MLAS_CONV_POINTWISE_FLOAT_KERNEL* Kernel = MlasConvPointwiseFloatKernel;
@@ -1041,7 +1032,7 @@ struct MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
 
         const size_t BlockedOutputWidth = BlockSize * OutputWidth;
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
         MLAS_CONV_DEPTHWISE_FLOAT_KERNEL* Kernel = MlasPlatform.ConvDepthwiseFloatKernel;
 #else
         MLAS_CONV_DEPTHWISE_FLOAT_KERNEL* Kernel = MlasConvDepthwiseFloatKernel;
@@ -1118,7 +1109,7 @@ struct MLAS_NCHWC_CONV_DEPTHWISE_ALGORITHM : MLAS_NCHWC_CONV_ALGORITHM
 
 struct MLAS_NCHWC_POOL_ALGORITHM : MLAS_NCHWC_NN_ALGORITHM
 {
-#if !defined(MLAS_TARGET_AMD64)
+#if !defined(MLAS_TARGET_AMD64) && !defined(MLAS_TARGET_ARM64)
     static const PMLAS_POOL_FLOAT_KERNEL PoolKernels[];
 #endif
 
@@ -1156,7 +1147,7 @@ struct MLAS_NCHWC_POOL_ALGORITHM : MLAS_NCHWC_NN_ALGORITHM
         const size_t DilatedInputWidthBytes = BlockSize * DilationHeight * InputWidth * sizeof(float);
         const size_t InputStrideBytes = DilatedInputWidthBytes - KernelWidth * DilationWidthBytes;
 
-#if defined(MLAS_TARGET_AMD64)
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
         MLAS_POOL_FLOAT_KERNEL* Kernel = MlasPlatform.PoolFloatKernel[WorkBlock->PoolingKind];
 #else
         MLAS_POOL_FLOAT_KERNEL* Kernel = PoolKernels[WorkBlock->PoolingKind];
@@ -1222,7 +1213,7 @@ struct MLAS_NCHWC_POOL_ALGORITHM : MLAS_NCHWC_NN_ALGORITHM
     }
 };
 
-#if !defined(MLAS_TARGET_AMD64)
+#if !defined(MLAS_TARGET_AMD64) && !defined(MLAS_TARGET_ARM64)
 
 const PMLAS_POOL_FLOAT_KERNEL MLAS_NCHWC_POOL_ALGORITHM::PoolKernels[] =
 {
@@ -1358,6 +1349,122 @@ Return Value:
     MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, WorkBlock.tids, ThreadPool);
 }
 
+//
+// Define the worker thread context for a NCHWc global pooling operation.
+//
+
+struct MLAS_NCHWC_GLOBAL_POOL_WORK_BLOCK
+{
+    int32_t tids;
+    size_t TotalChannelBlocks;
+    size_t InputSize;
+    const float* Input;
+    float* Output;
+    MLAS_POOLING_KIND PoolingKind;
+};
+
+void
+MlasNchwcGlobalPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc global pooling operation.
+
+    Each channel block is reduced over its spatial positions with one vector
+    per four channels of the block, so the channels of the block are pooled
+    together instead of one strided channel at a time.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NCHWC_GLOBAL_POOL_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t InputSize = WorkBlock->InputSize;
+    const bool IsMaximumPooling = (WorkBlock->PoolingKind == MlasMaximumPooling);
+
+    //
+    // Partition the channel blocks across the set of threads.
+    //
+
+    size_t BlockIndex;
+    size_t BlockRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->TotalChannelBlocks, &BlockIndex, &BlockRemaining);
+
+    const float* Input = WorkBlock->Input + BlockIndex * InputSize * BlockSize;
+    float* Output = WorkBlock->Output + BlockIndex * BlockSize;
+
+    const MLAS_FLOAT32X4 InitialVector = IsMaximumPooling ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 InputSizeVector = MlasBroadcastFloat32x4(float(InputSize));
+
+    while (BlockRemaining > 0) {
+
+        //
+        // N.B. The NCHWc block size is at most 16 channels.
+        //
+
+        MLAS_FLOAT32X4 Reduction[4];
+
+        for (size_t bc = 0; bc < BlockSize / 4; bc++) {
+            Reduction[bc] = InitialVector;
+        }
+
+        //
+        // Accumulate each spatial position of the channel block.
+        //
+
+        if (IsMaximumPooling) {
+
+            for (size_t i = 0; i < InputSize; i++) {
+
+                for (size_t bc = 0; bc < BlockSize / 4; bc++) {
+                    Reduction[bc] = MlasMaximumFloat32x4(Reduction[bc], MlasLoadFloat32x4(Input + bc * 4));
+                }
+
+                Input += BlockSize;
+            }
+
+            for (size_t bc = 0; bc < BlockSize / 4; bc++) {
+                MlasStoreFloat32x4(Output + bc * 4, Reduction[bc]);
+            }
+
+        } else {
+
+            for (size_t i = 0; i < InputSize; i++) {
+
+                for (size_t bc = 0; bc < BlockSize / 4; bc++) {
+                    Reduction[bc] = MlasAddFloat32x4(Reduction[bc], MlasLoadFloat32x4(Input + bc * 4));
+                }
+
+                Input += BlockSize;
+            }
+
+            for (size_t bc = 0; bc < BlockSize / 4; bc++) {
+                MlasStoreFloat32x4(Output + bc * 4, MlasDivideFloat32x4(Reduction[bc], InputSizeVector));
+            }
+        }
+
+        Output += BlockSize;
+        BlockRemaining--;
+    }
+}
+
 void
 MLASCALL
 MlasNchwcPool(
@@ -1428,6 +1535,37 @@ Return Value:
     MlasNchwcPrepareWorkBlock(&WorkBlock, Dimensions, InputShape, KernelShape,
         DilationShape, Padding, StrideShape, OutputShape);
 
+    //
+    // Detect global pooling operations, where the kernel covers the entire
+    // input without padding, and reduce each channel block directly instead
+    // of running the sliding window kernels over a single output.
+    //
+
+    bool IsGlobalPooling = (WorkBlock.OutputSize == 1);
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        IsGlobalPooling &= (WorkBlock.KernelShape[dim] == WorkBlock.InputShape[dim]);
+        IsGlobalPooling &= (WorkBlock.Padding[dim] == 0 && WorkBlock.Padding[dim + Dimensions] == 0);
+    }
+
+    if (IsGlobalPooling) {
+
+        MLAS_NCHWC_GLOBAL_POOL_WORK_BLOCK GlobalWorkBlock;
+
+        GlobalWorkBlock.TotalChannelBlocks =
+            WorkBlock.BatchCount * WorkBlock.InputChannels / MlasNchwcGetBlockSize();
+        GlobalWorkBlock.InputSize = WorkBlock.InputSize;
+        GlobalWorkBlock.Input = Input;
+        GlobalWorkBlock.Output = Output;
+        GlobalWorkBlock.PoolingKind = PoolingKind;
+
+        GlobalWorkBlock.tids = MlasComputeThreadCount(GlobalWorkBlock.TotalChannelBlocks,
+            WorkBlock.BatchCount * WorkBlock.InputChannels * WorkBlock.InputSize, ThreadPool);
+
+        MlasExecuteThreaded(MlasNchwcGlobalPoolThreaded, &GlobalWorkBlock, GlobalWorkBlock.tids, ThreadPool);
+        return;
+    }
+
     //
     // Schedule the operation across a set of worker threads.
     //
@@ -1437,7 +1575,338 @@ Return Value:
     MlasExecuteThreaded(MlasNchwcThreaded<MLAS_NCHWC_POOL_ALGORITHM>, &WorkBlock, WorkBlock.tids, ThreadPool);
 }
 
-#if !defined(MLAS_TARGET_AMD64)
+//
+// Define the worker thread context for a NCHWc nearest neighbor upsample
+// operation.
+//
+
+struct MLAS_NCHWC_UPSAMPLE_WORK_BLOCK
+{
+    int32_t tids;
+    size_t TotalInputRows;
+    size_t InputWidth;
+    size_t ScaleHeight;
+    size_t ScaleWidth;
+    const float* Input;
+    float* Output;
+};
+
+void
+MlasNchwcUpsampleThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc nearest neighbor upsample operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NCHWC_UPSAMPLE_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t ScaleHeight = WorkBlock->ScaleHeight;
+    const size_t ScaleWidth = WorkBlock->ScaleWidth;
+    const size_t OutputRowElements = InputWidth * ScaleWidth * BlockSize;
+
+    //
+    // Partition the input rows across the set of threads. Each input row
+    // produces ScaleHeight consecutive output rows.
+    //
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->TotalInputRows, &RowIndex, &RowRemaining);
+
+    const float* Input = WorkBlock->Input + RowIndex * InputWidth * BlockSize;
+    float* Output = WorkBlock->Output + RowIndex * ScaleHeight * OutputRowElements;
+
+    while (RowRemaining > 0) {
+
+        //
+        // Replicate each block of channels across the output columns of the
+        // first output row, then replicate the first output row.
+        //
+
+        float* OutputRow = Output;
+
+        for (size_t iw = 0; iw < InputWidth; iw++) {
+
+            for (size_t sw = 0; sw < ScaleWidth; sw++) {
+                std::copy_n(Input, BlockSize, OutputRow);
+                OutputRow += BlockSize;
+            }
+
+            Input += BlockSize;
+        }
+
+        for (size_t sh = 1; sh < ScaleHeight; sh++) {
+            std::copy_n(Output, OutputRowElements, Output + sh * OutputRowElements);
+        }
+
+        Output += ScaleHeight * OutputRowElements;
+        RowRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc nearest neighbor upsample operation
+    using integer scale factors for the spatial dimensions.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor. The channel count must
+        be a multiple of the NCHWc block size.
+
+    Scales - Supplies the height and width scale factors.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    MLAS_NCHWC_UPSAMPLE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TotalInputRows = size_t(InputShape[0]) * (size_t(InputShape[1]) / BlockSize) * size_t(InputShape[2]);
+    WorkBlock.InputWidth = size_t(InputShape[3]);
+    WorkBlock.ScaleHeight = size_t(Scales[0]);
+    WorkBlock.ScaleWidth = size_t(Scales[1]);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    const size_t OutputElements = WorkBlock.TotalInputRows * WorkBlock.ScaleHeight *
+        WorkBlock.InputWidth * WorkBlock.ScaleWidth * BlockSize;
+
+    WorkBlock.tids = MlasComputeThreadCount(WorkBlock.TotalInputRows, OutputElements, ThreadPool);
+
+    MlasExecuteThreaded(MlasNchwcUpsampleThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+//
+// Define the worker thread context for a NCHWc bilinear upsample operation.
+//
+
+struct MLAS_NCHWC_UPSAMPLE_LINEAR_WORK_BLOCK
+{
+    int32_t tids;
+    size_t TotalOutputRows;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t ScaleHeight;
+    size_t ScaleWidth;
+    const float* Input;
+    float* Output;
+};
+
+void
+MlasNchwcUpsampleLinearThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc bilinear upsample operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NCHWC_UPSAMPLE_LINEAR_WORK_BLOCK*)Context;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t OutputHeight = InputHeight * WorkBlock->ScaleHeight;
+    const size_t OutputWidth = InputWidth * WorkBlock->ScaleWidth;
+    const float ScaleHeight = float(WorkBlock->ScaleHeight);
+    const float ScaleWidth = float(WorkBlock->ScaleWidth);
+
+    //
+    // Partition the output rows across the set of threads.
+    //
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->tids, WorkBlock->TotalOutputRows, &RowIndex, &RowRemaining);
+
+    float* Output = WorkBlock->Output + RowIndex * OutputWidth * BlockSize;
+
+    while (RowRemaining > 0) {
+
+        const size_t oh = RowIndex % OutputHeight;
+        const float* Input = WorkBlock->Input + (RowIndex / OutputHeight) * InputHeight * InputWidth * BlockSize;
+
+        //
+        // Compute the pair of input rows that contribute to this output row
+        // and the weight of the second row. The source coordinate is clamped
+        // to the last input row, which then contributes with a weight of one.
+        //
+
+        const float ih = std::min(float(oh) / ScaleHeight, float(InputHeight - 1));
+        const size_t ih1 = size_t(ih);
+        const size_t ih2 = std::min(ih1 + 1, InputHeight - 1);
+
+        const MLAS_FLOAT32X4 WeightH2 = MlasBroadcastFloat32x4(ih - float(ih1));
+        const MLAS_FLOAT32X4 WeightH1 = MlasBroadcastFloat32x4(1.0f - (ih - float(ih1)));
+
+        const float* InputRow1 = Input + ih1 * InputWidth * BlockSize;
+        const float* InputRow2 = Input + ih2 * InputWidth * BlockSize;
+
+        for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+            const float iw = std::min(float(ow) / ScaleWidth, float(InputWidth - 1));
+            const size_t iw1 = size_t(iw);
+            const size_t iw2 = std::min(iw1 + 1, InputWidth - 1);
+
+            const MLAS_FLOAT32X4 WeightW2 = MlasBroadcastFloat32x4(iw - float(iw1));
+            const MLAS_FLOAT32X4 WeightW1 = MlasBroadcastFloat32x4(1.0f - (iw - float(iw1)));
+
+            const float* Input11 = InputRow1 + iw1 * BlockSize;
+            const float* Input12 = InputRow1 + iw2 * BlockSize;
+            const float* Input21 = InputRow2 + iw1 * BlockSize;
+            const float* Input22 = InputRow2 + iw2 * BlockSize;
+
+            //
+            // Interpolate each input row along the width, then blend the two
+            // rows, four channels of the block at a time.
+            //
+
+            for (size_t bc = 0; bc < BlockSize; bc += 4) {
+
+                MLAS_FLOAT32X4 Row1 = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Input11 + bc), WeightW1);
+                Row1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Input12 + bc), WeightW2, Row1);
+
+                MLAS_FLOAT32X4 Row2 = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Input21 + bc), WeightW1);
+                Row2 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Input22 + bc), WeightW2, Row2);
+
+                MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(Row1, WeightH1);
+                Vector = MlasMultiplyAddFloat32x4(Row2, WeightH2, Vector);
+
+                MlasStoreFloat32x4(Output + bc, Vector);
+            }
+
+            Output += BlockSize;
+        }
+
+        RowIndex++;
+        RowRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasNchwcUpsampleLinear(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc bilinear upsample operation using
+    integer scale factors for the spatial dimensions. Output coordinates map
+    to input coordinates by dividing by the scale factor, matching the linear
+    mode of the Upsample and Resize operators.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor. The channel count must
+        be a multiple of the NCHWc block size.
+
+    Scales - Supplies the height and width scale factors.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    MLAS_NCHWC_UPSAMPLE_LINEAR_WORK_BLOCK WorkBlock;
+
+    WorkBlock.InputHeight = size_t(InputShape[2]);
+    WorkBlock.InputWidth = size_t(InputShape[3]);
+    WorkBlock.ScaleHeight = size_t(Scales[0]);
+    WorkBlock.ScaleWidth = size_t(Scales[1]);
+    WorkBlock.TotalOutputRows = size_t(InputShape[0]) * (size_t(InputShape[1]) / BlockSize) *
+        WorkBlock.InputHeight * WorkBlock.ScaleHeight;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    //
+    // Each output element blends four input elements, so weight the work by
+    // four times the output size.
+    //
+
+    const size_t OutputElements = WorkBlock.TotalOutputRows * WorkBlock.InputWidth *
+        WorkBlock.ScaleWidth * BlockSize;
+
+    WorkBlock.tids = MlasComputeThreadCount(WorkBlock.TotalOutputRows, 4 * OutputElements, ThreadPool);
+
+    MlasExecuteThreaded(MlasNchwcUpsampleLinearThreaded, &WorkBlock, WorkBlock.tids, ThreadPool);
+}
+
+#if !defined(MLAS_TARGET_AMD64) && !defined(MLAS_TARGET_ARM64)
 
 //
 // Convolution and pooling kernel stubs for architectures that do not yet have
@@ -0,0 +1,542 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    spgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a sparse matrix B.
+
+    Matrix B is packed in compressed sparse column form, which holds only the
+    nonzero elements of each column and their row indices. A panel of rows of
+    matrix A is transposed to a local buffer so that each nonzero element of
+    matrix B multiplies a contiguous vector of the panel. The dense M
+    dimension is vectorized and the work is in proportion to the number of
+    nonzero elements of matrix B instead of to N * K.
+
+--*/
+
+#include "mlasi.h"
+
+#include <memory>
+
+//
+// Define the number of rows from matrix A that are multiplied by each
+// nonzero element of matrix B.
+//
+
+#define MLAS_SPARSE_GEMM_STRIDEM            16
+
+//
+// Define the fraction of nonzero elements of matrix B above which the dense
+// SGEMM is faster than the sparse SGEMM, so matrix B isn't packed as sparse.
+//
+
+#define MLAS_SPARSE_GEMM_MAXIMUM_DENSITY    0.2
+
+//
+// Define the header of a packed sparse matrix B. The header is followed by
+// the nonzero values, their row indices, and the offset of the first nonzero
+// value of each column with a final entry that holds the nonzero count.
+//
+
+struct MLAS_SPARSE_PACKED_B {
+    size_t N;
+    size_t K;
+    size_t NonZeroCount;
+};
+
+//
+// Define the parameters to execute segments of a sparse SGEMM operation on
+// worker threads.
+//
+
+struct MLAS_SPARSE_GEMM_WORK_BLOCK {
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    CBLAS_TRANSPOSE TransA;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    const MLAS_SPARSE_PACKED_B* PackedB;
+    float beta;
+    float* C;
+    size_t ldc;
+    const MLAS_SGEMM_EPILOGUE* Epilogue;
+};
+
+size_t
+MLASCALL
+MlasSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed sparse matrix B
+    buffer.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed sparse matrix B buffer, else zero
+    if matrix B is too dense for the sparse SGEMM to be faster than the dense
+    SGEMM.
+
+--*/
+{
+    if (N == 0 || K == 0 || K > UINT32_MAX) {
+        return 0;
+    }
+
+    size_t NonZeroCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+            const float Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (Value != 0.0f) {
+                NonZeroCount++;
+            }
+        }
+    }
+
+    if (double(NonZeroCount) > MLAS_SPARSE_GEMM_MAXIMUM_DENSITY * double(N) * double(K) ||
+        NonZeroCount > UINT32_MAX) {
+        return 0;
+    }
+
+    return sizeof(MLAS_SPARSE_PACKED_B) + NonZeroCount * (sizeof(float) + sizeof(uint32_t)) +
+        (N + 1) * sizeof(uint32_t);
+}
+
+void
+MLASCALL
+MlasSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the nonzero elements of matrix B in compressed sparse
+    column form.
+
+Arguments:
+
+    TransB - Supplies the transpose operation on matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed sparse matrix B buffer, of
+        the size returned by MlasSparsePackBSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SPARSE_PACKED_B* Header = reinterpret_cast<MLAS_SPARSE_PACKED_B*>(PackedB);
+
+    size_t NonZeroCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+            const float Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (Value != 0.0f) {
+                NonZeroCount++;
+            }
+        }
+    }
+
+    Header->N = N;
+    Header->K = K;
+    Header->NonZeroCount = NonZeroCount;
+
+    float* Values = reinterpret_cast<float*>(Header + 1);
+    uint32_t* RowIndices = reinterpret_cast<uint32_t*>(Values + NonZeroCount);
+    uint32_t* ColumnOffsets = RowIndices + NonZeroCount;
+
+    //
+    // Count the nonzero elements of each column and convert the counts to
+    // the offset of the end of each column.
+    //
+
+    std::fill_n(ColumnOffsets, N + 1, 0);
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+            const float Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (Value != 0.0f) {
+                ColumnOffsets[n]++;
+            }
+        }
+    }
+
+    uint32_t Offset = 0;
+
+    for (size_t n = 0; n < N; n++) {
+        Offset += ColumnOffsets[n];
+        ColumnOffsets[n] = Offset;
+    }
+
+    //
+    // Store the elements in reverse order so that each column offset counts
+    // down to the start of its column and the row indices of each column are
+    // in ascending order.
+    //
+
+    for (size_t k = K; k > 0; k--) {
+        for (size_t n = N; n > 0; n--) {
+            const float Value = (TransB == CblasNoTrans) ? B[(k - 1) * ldb + (n - 1)] : B[(n - 1) * ldb + (k - 1)];
+            if (Value != 0.0f) {
+                const uint32_t Index = --ColumnOffsets[n - 1];
+                Values[Index] = Value;
+                RowIndices[Index] = uint32_t(k - 1);
+            }
+        }
+    }
+
+    ColumnOffsets[N] = uint32_t(NonZeroCount);
+}
+
+template<size_t VectorCount>
+void
+MlasSparseGemmKernel(
+    const float* PanelA,
+    const MLAS_SPARSE_PACKED_B* PackedB,
+    float* C,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a transposed panel of rows of matrix A by a range
+    of columns of the packed sparse matrix B.
+
+Arguments:
+
+    PanelA - Supplies the address of the transposed panel of matrix A, which
+        holds VectorCount * 4 elements for each row of matrix B.
+
+    PackedB - Supplies the address of the packed sparse matrix B.
+
+    C - Supplies the address of the first row of the panel of matrix C.
+
+    StartN - Supplies the first column of matrix B and matrix C.
+
+    CountM - Supplies the number of rows of the panel.
+
+    CountN - Supplies the number of columns to multiply.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t NonZeroCount = PackedB->NonZeroCount;
+    const float* Values = reinterpret_cast<const float*>(PackedB + 1);
+    const uint32_t* RowIndices = reinterpret_cast<const uint32_t*>(Values + NonZeroCount);
+    const uint32_t* ColumnOffsets = RowIndices + NonZeroCount;
+
+    MLAS_DECLSPEC_ALIGN(float Column[MLAS_SPARSE_GEMM_STRIDEM], 16);
+
+    for (size_t n = StartN; n < StartN + CountN; n++) {
+
+        MLAS_FLOAT32X4 Accumulators[VectorCount];
+
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[v] = MlasZeroFloat32x4();
+        }
+
+        for (uint32_t i = ColumnOffsets[n]; i < ColumnOffsets[n + 1]; i++) {
+
+            const MLAS_FLOAT32X4 ValueB = MlasBroadcastFloat32x4(Values[i]);
+            const float* a = PanelA + size_t(RowIndices[i]) * (VectorCount * 4);
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[v] = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + v * 4), ValueB, Accumulators[v]);
+            }
+        }
+
+        for (size_t v = 0; v < VectorCount; v++) {
+            MlasStoreFloat32x4(&Column[v * 4], Accumulators[v]);
+        }
+
+        float* c = C + n;
+
+        for (size_t m = 0; m < CountM; m++) {
+            const float Value = alpha * Column[m];
+            c[0] = (beta != 0.0f) ? (Value + beta * c[0]) : Value;
+            c += ldc;
+        }
+    }
+}
+
+void
+MlasSparseGemmThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    sparse SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SPARSE_GEMM_WORK_BLOCK*)Context;
+
+    const int32_t ThreadIdM = Index / WorkBlock->ThreadCountN;
+    const int32_t ThreadIdN = Index % WorkBlock->ThreadCountN;
+
+    const size_t M = WorkBlock->M;
+    const size_t K = WorkBlock->K;
+    const size_t PanelCount = (M + MLAS_SPARSE_GEMM_STRIDEM - 1) / MLAS_SPARSE_GEMM_STRIDEM;
+
+    size_t PanelStart;
+    size_t PanelCountThisThread;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, PanelCount, &PanelStart, &PanelCountThisThread);
+
+    size_t StartN;
+    size_t CountN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, WorkBlock->N, &StartN, &CountN);
+
+    if (PanelCountThisThread == 0 || CountN == 0) {
+        return;
+    }
+
+    std::unique_ptr<float[]> PanelA(new float[K * MLAS_SPARSE_GEMM_STRIDEM]);
+
+    for (size_t p = PanelStart; p < PanelStart + PanelCountThisThread; p++) {
+
+        const size_t StartM = p * MLAS_SPARSE_GEMM_STRIDEM;
+        const size_t CountM = std::min(M - StartM, size_t(MLAS_SPARSE_GEMM_STRIDEM));
+        const size_t VectorCount = (CountM + 3) / 4;
+        const size_t PanelStride = VectorCount * 4;
+
+        //
+        // Transpose the rows of matrix A to the panel buffer and clear the
+        // padding rows so that they don't produce NaNs.
+        //
+
+        const float* A = WorkBlock->A;
+        const size_t lda = WorkBlock->lda;
+        float* panel = PanelA.get();
+
+        for (size_t m = 0; m < PanelStride; m++) {
+            if (m < CountM) {
+                if (WorkBlock->TransA == CblasNoTrans) {
+                    const float* a = A + (StartM + m) * lda;
+                    for (size_t k = 0; k < K; k++) {
+                        panel[k * PanelStride + m] = a[k];
+                    }
+                } else {
+                    const float* a = A + StartM + m;
+                    for (size_t k = 0; k < K; k++) {
+                        panel[k * PanelStride + m] = a[k * lda];
+                    }
+                }
+            } else {
+                for (size_t k = 0; k < K; k++) {
+                    panel[k * PanelStride + m] = 0.0f;
+                }
+            }
+        }
+
+        float* C = WorkBlock->C + StartM * WorkBlock->ldc;
+
+        switch (VectorCount) {
+            case 1:
+                MlasSparseGemmKernel<1>(panel, WorkBlock->PackedB, C, StartN, CountM, CountN,
+                    WorkBlock->ldc, WorkBlock->alpha, WorkBlock->beta);
+                break;
+            case 2:
+                MlasSparseGemmKernel<2>(panel, WorkBlock->PackedB, C, StartN, CountM, CountN,
+                    WorkBlock->ldc, WorkBlock->alpha, WorkBlock->beta);
+                break;
+            case 3:
+                MlasSparseGemmKernel<3>(panel, WorkBlock->PackedB, C, StartN, CountM, CountN,
+                    WorkBlock->ldc, WorkBlock->alpha, WorkBlock->beta);
+                break;
+            default:
+                MlasSparseGemmKernel<4>(panel, WorkBlock->PackedB, C, StartN, CountM, CountN,
+                    WorkBlock->ldc, WorkBlock->alpha, WorkBlock->beta);
+                break;
+        }
+
+        if (WorkBlock->Epilogue != nullptr) {
+            MLAS_SGEMM_EPILOGUE TileEpilogue;
+            MlasSgemmApplyEpilogue(MlasSgemmOffsetEpilogue(WorkBlock->Epilogue, StartM, StartN, &TileEpilogue),
+                0, C + StartN, CountM, CountN, WorkBlock->ldc);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSgemmSparse(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B packed by MlasSparsePackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed sparse matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+    Epilogue - Supplies the post processing to apply to matrix C, else
+        nullptr.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const auto* Header = reinterpret_cast<const MLAS_SPARSE_PACKED_B*>(PackedB);
+
+    //
+    // Partition the panels of rows of matrix A across the threads, and the
+    // columns of matrix B as well if there are fewer panels than threads, as
+    // for a batch of a single row.
+    //
+
+    const size_t PanelCount = (M + MLAS_SPARSE_GEMM_STRIDEM - 1) / MLAS_SPARSE_GEMM_STRIDEM;
+    const size_t MultiplyCount = Header->NonZeroCount * M;
+
+    const int32_t ThreadCount = MlasComputeThreadCount(PanelCount * N, MultiplyCount, ThreadPool);
+
+    MLAS_SPARSE_GEMM_WORK_BLOCK WorkBlock;
+
+    if (size_t(ThreadCount) <= PanelCount) {
+        WorkBlock.ThreadCountM = ThreadCount;
+        WorkBlock.ThreadCountN = 1;
+    } else {
+        WorkBlock.ThreadCountM = int32_t(PanelCount);
+        WorkBlock.ThreadCountN = ThreadCount / int32_t(PanelCount);
+    }
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = Header;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.Epilogue = Epilogue;
+
+    MlasExecuteThreaded(MlasSparseGemmThreaded, &WorkBlock,
+        WorkBlock.ThreadCountM * WorkBlock.ThreadCountN, ThreadPool);
+}
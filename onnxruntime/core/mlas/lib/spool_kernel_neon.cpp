@@ -0,0 +1,243 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    spool_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision pooling
+    operation using the NCHWc blocking format on ARM64 processors.
+
+--*/
+
+#include "mlasi.h"
+
+constexpr size_t MlasPoolNeonBlockSize = MLAS_NEON_NCHWC_BLOCK_SIZE;
+constexpr size_t MlasPoolNeonVectorCount = MlasPoolNeonBlockSize / 4;
+
+template<MLAS_POOLING_KIND PoolingKind>
+void
+MlasPoolNeonFloatKernel(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute pooling for the elements of an
+    output row for a block of channels.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer for the first output
+        position, which may point into the left padding.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation width.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row. This kernel derives the rows from DilatedInputWidth.
+
+    ActualKernelSize - Supplies the size of the kernel including any padding
+        rows, which is the divisor used by average pooling that includes the
+        padding.
+
+    KernelHeight - Supplies the height of the kernel to apply. This height may
+        be less than the original kernel height after removing any padding
+        rows.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(InputStride);
+
+    StrideWidth /= sizeof(float);
+    DilationWidth /= sizeof(float);
+    InputWidth /= sizeof(float);
+    DilatedInputWidth /= sizeof(float);
+
+    const MLAS_FLOAT32X4 InitialVector = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+
+    const size_t OutputCountInterior = OutputCountLeftPad + OutputCount;
+    const size_t OutputCountTotal = OutputCountInterior + OutputCountRightPad;
+
+    for (size_t ow = 0; ow < OutputCountTotal; ow++) {
+
+        //
+        // Only the output positions on the left or right edge may read from
+        // the input padding.
+        //
+
+        const bool CheckBounds = (ow < OutputCountLeftPad || ow >= OutputCountInterior);
+
+        MLAS_FLOAT32X4 Accumulators[MlasPoolNeonVectorCount];
+
+        for (size_t v = 0; v < MlasPoolNeonVectorCount; v++) {
+            Accumulators[v] = InitialVector;
+        }
+
+        size_t ValidCount = 0;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const float* input = Input + ow * StrideWidth + kh * DilatedInputWidth;
+            const float* inputRowBase = InputBase + kh * DilatedInputWidth;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckBounds || size_t(input - inputRowBase) < InputWidth) {
+
+                    for (size_t v = 0; v < MlasPoolNeonVectorCount; v++) {
+
+                        MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&input[v * 4]);
+
+                        if (PoolingKind == MlasMaximumPooling) {
+                            Accumulators[v] = MlasMaximumFloat32x4(Accumulators[v], InputVector);
+                        } else {
+                            Accumulators[v] = MlasAddFloat32x4(Accumulators[v], InputVector);
+                        }
+                    }
+
+                    ValidCount++;
+                }
+
+                input += DilationWidth;
+            }
+        }
+
+        if (PoolingKind != MlasMaximumPooling) {
+
+            const size_t DivisorCount = (PoolingKind == MlasAveragePoolingIncludePad) ?
+                ActualKernelSize : ValidCount;
+            const MLAS_FLOAT32X4 Divisor = MlasBroadcastFloat32x4(float(DivisorCount));
+
+            for (size_t v = 0; v < MlasPoolNeonVectorCount; v++) {
+                Accumulators[v] = MlasDivideFloat32x4(Accumulators[v], Divisor);
+            }
+        }
+
+        float* output = Output + ow * MlasPoolNeonBlockSize;
+
+        for (size_t v = 0; v < MlasPoolNeonVectorCount; v++) {
+            MlasStoreFloat32x4(&output[v * 4], Accumulators[v]);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasPoolMaximumFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolNeonFloatKernel<MlasMaximumPooling>(Input, Output, StrideWidth,
+        DilationWidth, InputStride, ActualKernelSize, KernelHeight, KernelWidth,
+        InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad, OutputCount,
+        OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageExcludePadFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolNeonFloatKernel<MlasAveragePoolingExcludePad>(Input, Output, StrideWidth,
+        DilationWidth, InputStride, ActualKernelSize, KernelHeight, KernelWidth,
+        InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad, OutputCount,
+        OutputCountRightPad);
+}
+
+void
+MLASCALL
+MlasPoolAverageIncludePadFloatKernelNeon(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+{
+    MlasPoolNeonFloatKernel<MlasAveragePoolingIncludePad>(Input, Output, StrideWidth,
+        DilationWidth, InputStride, ActualKernelSize, KernelHeight, KernelWidth,
+        InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad, OutputCount,
+        OutputCountRightPad);
+}
@@ -62,3 +62,52 @@ MlasExecuteThreaded(
         ThreadedRoutine(Context, tid);
     }
 }
+
+void
+MLASCALL
+MlasGetThreadingPolicy(
+    MLAS_THREADING_POLICY* Policy
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the threading policy used by the library.
+
+Arguments:
+
+    Policy - Receives the threading policy.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Policy->MaximumThreadCount = MlasPlatform.MaximumThreadCount;
+}
+
+void
+MLASCALL
+MlasSetThreadingPolicy(
+    const MLAS_THREADING_POLICY* Policy
+    )
+/*++
+
+Routine Description:
+
+    This routine replaces the threading policy used by the library.
+
+Arguments:
+
+    Policy - Supplies the threading policy. A MaximumThreadCount of zero or
+        less removes the limit on the number of threads.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasPlatform.MaximumThreadCount = (std::max)(Policy->MaximumThreadCount, int32_t(0));
+}
@@ -0,0 +1,275 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the transpose operation.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows of the source matrix that are transposed together,
+// so that the cache lines read from these rows are reused by the following
+// columns.
+//
+
+#define MLAS_TRANSPOSE_ROW_BLOCK 32
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint32_t* Input,
+    size_t InputStride,
+    uint32_t* Output,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a 4x4 block of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the address of the source block.
+
+    InputStride - Supplies the number of elements between rows of the source
+        block.
+
+    Output - Supplies the address of the destination block.
+
+    OutputStride - Supplies the number of elements between rows of the
+        destination block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // The elements are moved as floats without any arithmetic, so any 32-bit
+    // pattern is preserved.
+    //
+
+    const float* S = reinterpret_cast<const float*>(Input);
+    float* D = reinterpret_cast<float*>(Output);
+
+#if defined(MLAS_SSE2_INTRINSICS)
+    MLAS_FLOAT32X4 v[4];
+    MLAS_FLOAT32X4 t[4];
+
+    v[0] = MlasLoadFloat32x4(&S[InputStride * 0]);
+    v[1] = MlasLoadFloat32x4(&S[InputStride * 1]);
+    v[2] = MlasLoadFloat32x4(&S[InputStride * 2]);
+    v[3] = MlasLoadFloat32x4(&S[InputStride * 3]);
+
+    t[0] = _mm_unpacklo_ps(v[0], v[1]);
+    t[2] = _mm_unpackhi_ps(v[0], v[1]);
+    t[1] = _mm_unpacklo_ps(v[2], v[3]);
+    t[3] = _mm_unpackhi_ps(v[2], v[3]);
+
+    v[0] = _mm_movelh_ps(t[0], t[1]);
+    v[1] = _mm_movehl_ps(t[1], t[0]);
+    v[2] = _mm_movelh_ps(t[2], t[3]);
+    v[3] = _mm_movehl_ps(t[3], t[2]);
+
+    MlasStoreFloat32x4(&D[OutputStride * 0], v[0]);
+    MlasStoreFloat32x4(&D[OutputStride * 1], v[1]);
+    MlasStoreFloat32x4(&D[OutputStride * 2], v[2]);
+    MlasStoreFloat32x4(&D[OutputStride * 3], v[3]);
+#elif defined(MLAS_NEON_INTRINSICS)
+    MLAS_FLOAT32X4 v0 = MlasLoadFloat32x4(&S[InputStride * 0]);
+    MLAS_FLOAT32X4 v1 = MlasLoadFloat32x4(&S[InputStride * 1]);
+    MLAS_FLOAT32X4 v2 = MlasLoadFloat32x4(&S[InputStride * 2]);
+    MLAS_FLOAT32X4 v3 = MlasLoadFloat32x4(&S[InputStride * 3]);
+
+    float32x4x2_t t01 = vtrnq_f32(v0, v1);
+    float32x4x2_t t23 = vtrnq_f32(v2, v3);
+
+    MlasStoreFloat32x4(&D[OutputStride * 0], vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+    MlasStoreFloat32x4(&D[OutputStride * 1], vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+    MlasStoreFloat32x4(&D[OutputStride * 2], vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+    MlasStoreFloat32x4(&D[OutputStride * 3], vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+#else
+    for (size_t m = 0; m < 4; m++) {
+        for (size_t n = 0; n < 4; n++) {
+            D[OutputStride * n + m] = S[InputStride * m + n];
+        }
+    }
+#endif
+}
+
+template<typename ElementType>
+MLAS_FORCEINLINE
+void
+MlasTransposeColumn(
+    const ElementType* Input,
+    size_t InputStride,
+    ElementType* Output,
+    size_t CountM
+    )
+/*++
+
+Routine Description:
+
+    This routine copies a column of the source matrix to a row of the
+    destination matrix.
+
+Arguments:
+
+    Input - Supplies the address of the first element of the column.
+
+    InputStride - Supplies the number of elements between rows of the source
+        matrix.
+
+    Output - Supplies the address of the destination row.
+
+    CountM - Supplies the number of elements to copy.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m++) {
+        Output[m] = Input[InputStride * m];
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the address of the source matrix of M rows of N elements.
+
+    Output - Supplies the address of the destination matrix of N rows of M
+        elements.
+
+    M - Supplies the number of rows of the source matrix.
+
+    N - Supplies the number of columns of the source matrix.
+
+    InputStride - Supplies the number of elements between rows of the source
+        matrix.
+
+    OutputStride - Supplies the number of elements between rows of the
+        destination matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m0 = 0; m0 < M; m0 += MLAS_TRANSPOSE_ROW_BLOCK) {
+
+        const size_t CountM = std::min<size_t>(M - m0, MLAS_TRANSPOSE_ROW_BLOCK);
+        const uint32_t* s = Input + InputStride * m0;
+        uint32_t* d = Output + m0;
+
+        size_t n = 0;
+
+        //
+        // Transpose 4x4 blocks, then the remaining rows of the 4 columns.
+        //
+
+        for (; n + 4 <= N; n += 4) {
+
+            size_t m = 0;
+
+            for (; m + 4 <= CountM; m += 4) {
+                MlasTranspose4x4Block(&s[InputStride * m + n], InputStride, &d[OutputStride * n + m], OutputStride);
+            }
+
+            if (m < CountM) {
+                for (size_t nn = n; nn < n + 4; nn++) {
+                    MlasTransposeColumn(&s[InputStride * m + nn], InputStride, &d[OutputStride * nn + m], CountM - m);
+                }
+            }
+        }
+
+        //
+        // Transpose the remaining columns.
+        //
+
+        for (; n < N; n++) {
+            MlasTransposeColumn(&s[n], InputStride, &d[OutputStride * n], CountM);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of 8-bit elements.
+
+Arguments:
+
+    Input - Supplies the address of the source matrix of M rows of N elements.
+
+    Output - Supplies the address of the destination matrix of N rows of M
+        elements.
+
+    M - Supplies the number of rows of the source matrix.
+
+    N - Supplies the number of columns of the source matrix.
+
+    InputStride - Supplies the number of elements between rows of the source
+        matrix.
+
+    OutputStride - Supplies the number of elements between rows of the
+        destination matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m0 = 0; m0 < M; m0 += MLAS_TRANSPOSE_ROW_BLOCK) {
+
+        const size_t CountM = std::min<size_t>(M - m0, MLAS_TRANSPOSE_ROW_BLOCK);
+        const uint8_t* s = Input + InputStride * m0;
+        uint8_t* d = Output + m0;
+
+        for (size_t n = 0; n < N; n++) {
+            MlasTransposeColumn(&s[n], InputStride, &d[OutputStride * n], CountM);
+        }
+    }
+}
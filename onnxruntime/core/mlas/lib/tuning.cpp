@@ -0,0 +1,423 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    tuning.cpp
+
+Abstract:
+
+    This module implements the routines to apply tuning parameters and to load
+    a tuning cache.
+
+    The tuning parameters override the cost model and the kernels that the
+    platform initialization selects from the processor features. Different
+    processors with the same features can favor different choices, so these
+    are measured on the target machine by the MLAS tuning tool and persisted
+    to a tuning cache.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+//
+// Define the name of the environment variable that supplies the tuning cache
+// to load at process start.
+//
+
+#define MLAS_TUNING_CACHE_ENVIRONMENT_VARIABLE      "MLAS_TUNING_CACHE"
+
+bool
+MlasParseTuningNumber(
+    const char* Value,
+    double* Number
+    )
+/*++
+
+Routine Description:
+
+    This routine parses the value of a numeric tuning parameter.
+
+Arguments:
+
+    Value - Supplies the text of the value.
+
+    Number - Receives the parsed value.
+
+Return Value:
+
+    Returns true if the full text is a number, else false.
+
+--*/
+{
+    char* End;
+
+    *Number = strtod(Value, &End);
+
+    return End != Value && *End == '\0';
+}
+
+bool
+MlasParseTuningCount(
+    const char* Value,
+    size_t* Count
+    )
+/*++
+
+Routine Description:
+
+    This routine parses the value of a tuning parameter that must be a
+    positive integer.
+
+Arguments:
+
+    Value - Supplies the text of the value.
+
+    Count - Receives the parsed value.
+
+Return Value:
+
+    Returns true if the full text is a positive integer, else false.
+
+--*/
+{
+    double Number;
+
+    if (!MlasParseTuningNumber(Value, &Number)) {
+        return false;
+    }
+
+    if (!(Number >= 1.0 && Number <= double(1ull << 32)) || Number != double(size_t(Number))) {
+        return false;
+    }
+
+    *Count = size_t(Number);
+
+    return true;
+}
+
+#if defined(MLAS_TARGET_AMD64)
+
+bool
+MlasSelectSgemmKernel(
+    MLAS_KERNEL_ISA KernelIsa
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the SGEMM kernel for the specified instruction set.
+
+Arguments:
+
+    KernelIsa - Supplies the instruction set of the kernel.
+
+Return Value:
+
+    Returns true if the processor supports the instruction set, else false.
+
+--*/
+{
+    if (KernelIsa > MlasPlatform.MaximumKernelIsa) {
+        return false;
+    }
+
+    switch (KernelIsa) {
+
+        case MlasKernelIsaSse:
+            MlasPlatform.GemmFloatKernel = MlasGemmFloatKernelSse;
+            break;
+
+        case MlasKernelIsaAvx:
+            MlasPlatform.GemmFloatKernel = MlasGemmFloatKernelAvx;
+            break;
+
+        case MlasKernelIsaFma3:
+            MlasPlatform.GemmFloatKernel = MlasGemmFloatKernelFma3;
+            break;
+
+        case MlasKernelIsaAvx512F:
+            MlasPlatform.GemmFloatKernel = MlasGemmFloatKernelAvx512F;
+            break;
+    }
+
+    return true;
+}
+
+bool
+MlasSelectNchwcBlockSize(
+    size_t BlockSize
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the NCHWc block size and the convolution and pooling
+    kernels that operate on that block size.
+
+Arguments:
+
+    BlockSize - Supplies the NCHWc block size.
+
+Return Value:
+
+    Returns true if the processor supports the block size, else false.
+
+--*/
+{
+    MLAS_KERNEL_ISA KernelIsa;
+
+    if (BlockSize == 16) {
+        KernelIsa = MlasKernelIsaAvx512F;
+    } else if (BlockSize == 8) {
+        KernelIsa = (std::min)(MlasPlatform.MaximumKernelIsa, MlasKernelIsaFma3);
+    } else {
+        return false;
+    }
+
+    if (KernelIsa > MlasPlatform.MaximumKernelIsa) {
+        return false;
+    }
+
+    switch (KernelIsa) {
+
+        case MlasKernelIsaSse:
+            MlasPlatform.ConvNchwFloatKernel = MlasConvNchwFloatKernelSse;
+            MlasPlatform.ConvNchwcFloatKernel = MlasConvNchwcFloatKernelSse;
+            MlasPlatform.ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelSse;
+            MlasPlatform.ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelSse;
+            MlasPlatform.PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelSse;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelSse;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelSse;
+            break;
+
+        case MlasKernelIsaAvx:
+        case MlasKernelIsaFma3:
+            if (KernelIsa == MlasKernelIsaFma3) {
+                MlasPlatform.ConvNchwFloatKernel = MlasConvNchwFloatKernelFma3;
+                MlasPlatform.ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
+                MlasPlatform.ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
+                MlasPlatform.ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
+            } else {
+                MlasPlatform.ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx;
+                MlasPlatform.ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx;
+                MlasPlatform.ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx;
+                MlasPlatform.ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx;
+            }
+            MlasPlatform.PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
+            break;
+
+        case MlasKernelIsaAvx512F:
+            MlasPlatform.ConvNchwFloatKernel = MlasConvNchwFloatKernelAvx512F;
+            MlasPlatform.ConvNchwcFloatKernel = MlasConvNchwcFloatKernelAvx512F;
+            MlasPlatform.ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelAvx512F;
+            MlasPlatform.ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelAvx512F;
+            MlasPlatform.PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
+            MlasPlatform.PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+            break;
+    }
+
+    MlasPlatform.NchwcBlockSize = uint32_t(BlockSize);
+
+    return true;
+}
+
+#endif
+
+bool
+MLASCALL
+MlasSetTuningParameter(
+    const char* Name,
+    const char* Value
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a tuning parameter.
+
+Arguments:
+
+    Name - Supplies the name of the tuning parameter.
+
+    Value - Supplies the text of the value.
+
+Return Value:
+
+    Returns true if the tuning parameter has been applied, else false if the
+    name is unknown or the value is invalid or unsupported by the processor.
+
+--*/
+{
+    MLAS_COST_MODEL CostModel = MlasPlatform.CostModel;
+
+    if (strcmp(Name, "GemmThreadComplexity") == 0) {
+        return MlasParseTuningNumber(Value, &CostModel.GemmThreadComplexity) &&
+            MlasSetCostModel(&CostModel);
+    }
+
+    if (strcmp(Name, "ConvThreadComplexity") == 0) {
+        return MlasParseTuningNumber(Value, &CostModel.ConvThreadComplexity) &&
+            MlasSetCostModel(&CostModel);
+    }
+
+    if (strcmp(Name, "ThreadStrideNAlign") == 0) {
+        return MlasParseTuningCount(Value, &CostModel.ThreadStrideNAlign) &&
+            MlasSetCostModel(&CostModel);
+    }
+
+    if (strcmp(Name, "ComputeThreadElements") == 0) {
+        return MlasParseTuningCount(Value, &CostModel.ComputeThreadElements) &&
+            MlasSetCostModel(&CostModel);
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+
+    if (strcmp(Name, "SgemmKernel") == 0) {
+
+        static const struct {
+            const char* Name;
+            MLAS_KERNEL_ISA KernelIsa;
+        } KernelIsaNames[] = {
+            { "sse", MlasKernelIsaSse },
+            { "avx", MlasKernelIsaAvx },
+            { "fma3", MlasKernelIsaFma3 },
+            { "avx512f", MlasKernelIsaAvx512F },
+        };
+
+        for (const auto& KernelIsaName : KernelIsaNames) {
+            if (strcmp(Value, KernelIsaName.Name) == 0) {
+                return MlasSelectSgemmKernel(KernelIsaName.KernelIsa);
+            }
+        }
+
+        return false;
+    }
+
+    if (strcmp(Name, "NchwcBlockSize") == 0) {
+
+        size_t BlockSize;
+
+        return MlasParseTuningCount(Value, &BlockSize) && MlasSelectNchwcBlockSize(BlockSize);
+    }
+
+#endif
+
+    return false;
+}
+
+bool
+MLASCALL
+MlasLoadTuningCache(
+    const char* FileName
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the tuning parameters from a tuning cache.
+
+Arguments:
+
+    FileName - Supplies the name of the tuning cache.
+
+Return Value:
+
+    Returns true if every tuning parameter has been applied, else false if the
+    file could not be read or any line was rejected. The valid lines of the
+    file are applied in either case.
+
+--*/
+{
+    std::ifstream File(FileName);
+
+    if (!File) {
+        return false;
+    }
+
+    static const char Whitespace[] = " \t\r";
+
+    bool Succeeded = true;
+    std::string Line;
+
+    while (std::getline(File, Line)) {
+
+        Line.erase((std::min)(Line.find('#'), Line.size()));
+        Line.erase(0, (std::min)(Line.find_first_not_of(Whitespace), Line.size()));
+        Line.erase(Line.find_last_not_of(Whitespace) + 1);
+
+        if (Line.empty()) {
+            continue;
+        }
+
+        size_t Separator = Line.find('=');
+
+        if (Separator == std::string::npos) {
+            Succeeded = false;
+            continue;
+        }
+
+        std::string Name = Line.substr(0, Separator);
+        std::string Value = Line.substr(Separator + 1);
+
+        Name.erase(Name.find_last_not_of(Whitespace) + 1);
+        Value.erase(0, (std::min)(Value.find_first_not_of(Whitespace), Value.size()));
+
+        if (!MlasSetTuningParameter(Name.c_str(), Value.c_str())) {
+            Succeeded = false;
+        }
+    }
+
+    return Succeeded;
+}
+
+void
+MlasLoadTuningCacheFromEnvironment(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine loads the tuning cache named by the MLAS_TUNING_CACHE
+    environment variable, if any. This is invoked at the end of the platform
+    initialization.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(_WIN32)
+    char* FileName = nullptr;
+    size_t FileNameLength;
+
+    if (_dupenv_s(&FileName, &FileNameLength, MLAS_TUNING_CACHE_ENVIRONMENT_VARIABLE) == 0 &&
+        FileName != nullptr) {
+        MlasLoadTuningCache(FileName);
+    }
+
+    free(FileName);
+#else
+    const char* FileName = getenv(MLAS_TUNING_CACHE_ENVIRONMENT_VARIABLE);
+
+    if (FileName != nullptr && FileName[0] != '\0') {
+        MlasLoadTuningCache(FileName);
+    }
+#endif
+}
@@ -0,0 +1,1420 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    winograd.cpp
+
+Abstract:
+
+    This module implements the single precision convolution operation using
+    the Winograd minimal filtering algorithms F(2x2,3x3) and F(4x4,3x3).
+
+    The output is split into tiles of TileSize by TileSize elements. Each tile
+    of each input channel is transformed to a matrix of (TileSize+2) by
+    (TileSize+2) elements. For each element position of the transformed
+    matrices, the transformed filter and the transformed input are multiplied
+    using a SGEMM that reduces along the input channels. The products are then
+    transformed back to the output tiles.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the target number of working buffer elements per thread. The number
+// of tiles transformed per block of SGEMM operations is derived from this
+// size, but is kept in the bounds below so that the SGEMM operations are wide
+// enough to be efficient.
+//
+
+#define MLAS_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD    (256 * 1024)
+#define MLAS_WINOGRAD_MINIMUM_BLOCK_TILE_COUNT          16
+#define MLAS_WINOGRAD_MAXIMUM_BLOCK_TILE_COUNT          64
+
+//
+// Define the minimum number of input channels and filters for the Winograd
+// algorithm. The transforms are not amortized for smaller convolutions.
+//
+
+#define MLAS_WINOGRAD_MINIMUM_CHANNEL_COUNT             8
+
+//
+// Define the parameters to execute segments of a Winograd convolution
+// operation on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    bool ZeroMode;
+};
+
+//
+// Helpers to share the transforms between the scalar elements of the NCHW
+// layout and the vectors of channels of the NCHWc layout.
+//
+
+MLAS_FORCEINLINE
+float
+MlasWinogradAdd(
+    float Value1,
+    float Value2
+    )
+{
+    return Value1 + Value2;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasWinogradAdd(
+    MLAS_FLOAT32X4 Value1,
+    MLAS_FLOAT32X4 Value2
+    )
+{
+    return MlasAddFloat32x4(Value1, Value2);
+}
+
+MLAS_FORCEINLINE
+float
+MlasWinogradSubtract(
+    float Value1,
+    float Value2
+    )
+{
+    return Value1 - Value2;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasWinogradSubtract(
+    MLAS_FLOAT32X4 Value1,
+    MLAS_FLOAT32X4 Value2
+    )
+{
+    return MlasSubtractFloat32x4(Value1, Value2);
+}
+
+MLAS_FORCEINLINE
+float
+MlasWinogradMultiply(
+    float Value,
+    float Scale
+    )
+{
+    return Value * Scale;
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasWinogradMultiply(
+    MLAS_FLOAT32X4 Value,
+    float Scale
+    )
+{
+    return MlasMultiplyFloat32x4(Value, MlasBroadcastFloat32x4(Scale));
+}
+
+//
+// One dimensional transforms for each output tile size. The two dimensional
+// transforms are computed by applying these to the columns and then to the
+// rows of a tile.
+//
+// TransformInput computes B^T * d, TransformOutput computes A^T * m and
+// TransformFilter computes G * g using the matrices from Lavin and Gray,
+// "Fast Algorithms for Convolutional Neural Networks".
+//
+
+template<size_t TileSize>
+struct MLAS_WINOGRAD_TRANSFORM;
+
+template<>
+struct MLAS_WINOGRAD_TRANSFORM<2>
+{
+    static constexpr size_t InputTileSize = 4;
+
+    template<typename T>
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformInput(
+        const T* d,
+        size_t sd,
+        T* v,
+        size_t sv
+        )
+    {
+        const T d0 = d[0];
+        const T d1 = d[sd];
+        const T d2 = d[2 * sd];
+        const T d3 = d[3 * sd];
+
+        v[0] = MlasWinogradSubtract(d0, d2);
+        v[sv] = MlasWinogradAdd(d1, d2);
+        v[2 * sv] = MlasWinogradSubtract(d2, d1);
+        v[3 * sv] = MlasWinogradSubtract(d1, d3);
+    }
+
+    template<typename T>
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformOutput(
+        const T* m,
+        size_t sm,
+        T* y,
+        size_t sy
+        )
+    {
+        const T m0 = m[0];
+        const T m1 = m[sm];
+        const T m2 = m[2 * sm];
+        const T m3 = m[3 * sm];
+
+        y[0] = MlasWinogradAdd(MlasWinogradAdd(m0, m1), m2);
+        y[sy] = MlasWinogradSubtract(MlasWinogradSubtract(m1, m2), m3);
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformFilter(
+        const float* g,
+        size_t sg,
+        float* u,
+        size_t su
+        )
+    {
+        const float g0 = g[0];
+        const float g1 = g[sg];
+        const float g2 = g[2 * sg];
+
+        u[0] = g0;
+        u[su] = 0.5f * (g0 + g1 + g2);
+        u[2 * su] = 0.5f * (g0 - g1 + g2);
+        u[3 * su] = g2;
+    }
+};
+
+template<>
+struct MLAS_WINOGRAD_TRANSFORM<4>
+{
+    static constexpr size_t InputTileSize = 6;
+
+    template<typename T>
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformInput(
+        const T* d,
+        size_t sd,
+        T* v,
+        size_t sv
+        )
+    {
+        const T d0 = d[0];
+        const T d1 = d[sd];
+        const T d2 = d[2 * sd];
+        const T d3 = d[3 * sd];
+        const T d4 = d[4 * sd];
+        const T d5 = d[5 * sd];
+
+        const T d31 = MlasWinogradSubtract(d3, d1);
+        const T d42 = MlasWinogradSubtract(d4, d2);
+
+        v[0] = MlasWinogradAdd(MlasWinogradMultiply(d0, 4.0f),
+            MlasWinogradSubtract(d4, MlasWinogradMultiply(d2, 5.0f)));
+        v[sv] = MlasWinogradSubtract(MlasWinogradAdd(d3, d4),
+            MlasWinogradMultiply(MlasWinogradAdd(d1, d2), 4.0f));
+        v[2 * sv] = MlasWinogradAdd(MlasWinogradSubtract(d4, d3),
+            MlasWinogradMultiply(MlasWinogradSubtract(d1, d2), 4.0f));
+        v[3 * sv] = MlasWinogradAdd(d42, MlasWinogradMultiply(d31, 2.0f));
+        v[4 * sv] = MlasWinogradSubtract(d42, MlasWinogradMultiply(d31, 2.0f));
+        v[5 * sv] = MlasWinogradAdd(MlasWinogradMultiply(d1, 4.0f),
+            MlasWinogradSubtract(d5, MlasWinogradMultiply(d3, 5.0f)));
+    }
+
+    template<typename T>
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformOutput(
+        const T* m,
+        size_t sm,
+        T* y,
+        size_t sy
+        )
+    {
+        const T m12Add = MlasWinogradAdd(m[sm], m[2 * sm]);
+        const T m12Sub = MlasWinogradSubtract(m[sm], m[2 * sm]);
+        const T m34Add = MlasWinogradAdd(m[3 * sm], m[4 * sm]);
+        const T m34Sub = MlasWinogradSubtract(m[3 * sm], m[4 * sm]);
+
+        y[0] = MlasWinogradAdd(MlasWinogradAdd(m[0], m12Add), m34Add);
+        y[sy] = MlasWinogradAdd(m12Sub, MlasWinogradMultiply(m34Sub, 2.0f));
+        y[2 * sy] = MlasWinogradAdd(m12Add, MlasWinogradMultiply(m34Add, 4.0f));
+        y[3 * sy] = MlasWinogradAdd(MlasWinogradAdd(m12Sub,
+            MlasWinogradMultiply(m34Sub, 8.0f)), m[5 * sm]);
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    TransformFilter(
+        const float* g,
+        size_t sg,
+        float* u,
+        size_t su
+        )
+    {
+        const float g0 = g[0];
+        const float g1 = g[sg];
+        const float g2 = g[2 * sg];
+
+        u[0] = g0 / 4.0f;
+        u[su] = -(g0 + g1 + g2) / 6.0f;
+        u[2 * su] = -(g0 - g1 + g2) / 6.0f;
+        u[3 * su] = g0 / 24.0f + g1 / 12.0f + g2 / 6.0f;
+        u[4 * su] = g0 / 24.0f - g1 / 12.0f + g2 / 6.0f;
+        u[5 * su] = g2;
+    }
+};
+
+template<size_t TileSize, typename T>
+MLAS_FORCEINLINE
+void
+MlasWinogradTransformInputTile(
+    const T* d,
+    T* v
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the two dimensional input transform B^T * d * B of
+    an input tile.
+
+Arguments:
+
+    d - Supplies the input tile of InputTileSize by InputTileSize elements.
+
+    v - Receives the transformed input tile.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_WINOGRAD_TRANSFORM<TileSize>;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+
+    T Temp[InputTileSize * InputTileSize];
+
+    for (size_t j = 0; j < InputTileSize; j++) {
+        Transform::TransformInput(&d[j], InputTileSize, &Temp[j], InputTileSize);
+    }
+
+    for (size_t i = 0; i < InputTileSize; i++) {
+        Transform::TransformInput(&Temp[i * InputTileSize], 1, &v[i * InputTileSize], 1);
+    }
+}
+
+template<size_t TileSize, typename T>
+MLAS_FORCEINLINE
+void
+MlasWinogradTransformOutputTile(
+    const T* m,
+    T* y
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the two dimensional output transform A^T * m * A of
+    a tile of products.
+
+Arguments:
+
+    m - Supplies the tile of InputTileSize by InputTileSize products.
+
+    y - Receives the output tile of TileSize by TileSize elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_WINOGRAD_TRANSFORM<TileSize>;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+
+    T Temp[TileSize * InputTileSize];
+
+    for (size_t j = 0; j < InputTileSize; j++) {
+        Transform::TransformOutput(&m[j], InputTileSize, &Temp[j], InputTileSize);
+    }
+
+    for (size_t i = 0; i < TileSize; i++) {
+        Transform::TransformOutput(&Temp[i * InputTileSize], 1, &y[i * TileSize], 1);
+    }
+}
+
+template<size_t TileSize, typename FilterAccessor>
+void
+MlasWinogradTransformFilter(
+    size_t FilterCount,
+    size_t InputChannels,
+    FilterAccessor Accessor,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the filter transform G * g * G^T for each filter and
+    input channel of a group.
+
+    The transformed filter is stored as InputTileSize*InputTileSize matrices of
+    FilterCount rows by InputChannels columns, one matrix for each position of
+    the transformed tile.
+
+Arguments:
+
+    FilterCount - Supplies the number of filters.
+
+    InputChannels - Supplies the number of input channels.
+
+    Accessor - Supplies a callable returning the address of the 3x3 kernel for
+        a filter and input channel along with the stride between kernel rows.
+
+    TransformedFilter - Receives the transformed filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_WINOGRAD_TRANSFORM<TileSize>;
+    constexpr size_t InputTileSize = Transform::InputTileSize;
+
+    const size_t TransformStride = FilterCount * InputChannels;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* g;
+            size_t RowStride;
+            size_t ColumnStride;
+
+            Accessor(f, c, &g, &RowStride, &ColumnStride);
+
+            float Temp[InputTileSize * 3];
+            float u[InputTileSize * InputTileSize];
+
+            for (size_t j = 0; j < 3; j++) {
+                Transform::TransformFilter(&g[j * ColumnStride], RowStride, &Temp[j], 3);
+            }
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                Transform::TransformFilter(&Temp[i * 3], 1, &u[i * InputTileSize], 1);
+            }
+
+            float* transformed = TransformedFilter + f * InputChannels + c;
+
+            for (size_t k = 0; k < InputTileSize * InputTileSize; k++) {
+                transformed[k * TransformStride] = u[k];
+            }
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasConvWinogradTileSize(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the output tile size of the Winograd algorithm for a
+    convolution.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the output tile size, else zero if the convolution cannot use the
+    Winograd algorithm.
+
+--*/
+{
+    if (Dimensions != 2) {
+        return 0;
+    }
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1 ||
+            OutputShape[dim] < 2) {
+            return 0;
+        }
+    }
+
+    if (InputChannels < MLAS_WINOGRAD_MINIMUM_CHANNEL_COUNT ||
+        FilterCount < MLAS_WINOGRAD_MINIMUM_CHANNEL_COUNT) {
+        return 0;
+    }
+
+    //
+    // F(4x4,3x3) needs fewer multiplies per output, but small images waste
+    // much of each tile in the padding beyond the output edges.
+    //
+
+    if (OutputShape[0] >= 6 && OutputShape[1] >= 6) {
+        return 4;
+    }
+
+    return 2;
+}
+
+size_t
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t TileSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares for a Winograd convolution operation by computing
+    the tiling and threading parameters.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    TileSize - Supplies the output tile size from MlasConvWinogradTileSize.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns the number of elements to allocate for the working buffer.
+
+--*/
+{
+    const size_t InputTileSize = TileSize + 2;
+    const size_t TransformSize = InputTileSize * InputTileSize;
+
+    const size_t TileCountH = (Parameters->OutputShape[0] + TileSize - 1) / TileSize;
+    const size_t TileCountW = (Parameters->OutputShape[1] + TileSize - 1) / TileSize;
+    const size_t TileCount = TileCountH * TileCountW;
+
+    const size_t ChannelCount = Parameters->InputChannels + Parameters->FilterCount;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // SGEMM operations. Each thread should have at least a minimum block of
+    // tiles to process.
+    //
+
+    int32_t TargetThreadCount;
+    double Complexity = double(Parameters->FilterCount) * double(Parameters->InputChannels) *
+        double(TransformSize) * double(TileCount);
+
+    TargetThreadCount = MlasGetTargetThreadCount(Complexity,
+        MlasPlatform.CostModel.ConvThreadComplexity, ThreadPool);
+
+    size_t MaximumThreadCountByTiles = TileCount / MLAS_WINOGRAD_MINIMUM_BLOCK_TILE_COUNT;
+
+    if (size_t(TargetThreadCount) > MaximumThreadCountByTiles) {
+        TargetThreadCount = int32_t((std::max)(MaximumThreadCountByTiles, size_t(1)));
+    }
+
+    size_t ThreadStrideTiles = (TileCount + TargetThreadCount - 1) / TargetThreadCount;
+
+    TargetThreadCount = int32_t((TileCount + ThreadStrideTiles - 1) / ThreadStrideTiles);
+
+    //
+    // Compute the number of tiles transformed per block of SGEMM operations.
+    //
+
+    size_t BlockTileCount = MLAS_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD / (TransformSize * ChannelCount);
+
+    if (BlockTileCount < MLAS_WINOGRAD_MINIMUM_BLOCK_TILE_COUNT) {
+        BlockTileCount = MLAS_WINOGRAD_MINIMUM_BLOCK_TILE_COUNT;
+    } else if (BlockTileCount > MLAS_WINOGRAD_MAXIMUM_BLOCK_TILE_COUNT) {
+        BlockTileCount = MLAS_WINOGRAD_MAXIMUM_BLOCK_TILE_COUNT;
+    }
+
+    if (BlockTileCount > ThreadStrideTiles) {
+        BlockTileCount = ThreadStrideTiles;
+    }
+
+    Parameters->ThreadCount = TargetThreadCount;
+
+    Parameters->u.Winograd.TileSize = TileSize;
+    Parameters->u.Winograd.TileCount = TileCount;
+    Parameters->u.Winograd.BlockTileCount = BlockTileCount;
+    Parameters->u.Winograd.ThreadStrideTiles = ThreadStrideTiles;
+
+    return size_t(TargetThreadCount) * TransformSize * ChannelCount * BlockTileCount;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradFilterSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of the filter transformed by
+    MlasConvWinogradTransformFilter or MlasNchwcConvWinogradTransformFilter.
+
+Arguments:
+
+    Parameters - Supplies the parameters prepared for the Winograd algorithm
+        by MlasConvPrepare.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter.
+
+--*/
+{
+    const size_t InputTileSize = Parameters->u.Winograd.TileSize + 2;
+
+    return Parameters->GroupCount * InputTileSize * InputTileSize *
+        Parameters->FilterCount * Parameters->InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a filter tensor in OIHW format for the Winograd
+    algorithm. The transformed filter only depends on the tile size and the
+    filter shape, so the caller may cache it across convolution operations
+    that are prepared with the same tile size.
+
+Arguments:
+
+    Parameters - Supplies the parameters prepared for the Winograd algorithm
+        by MlasConvPrepare.
+
+    Filter - Supplies the filter tensor.
+
+    TransformedFilter - Receives the transformed filter. The buffer must hold
+        the number of elements returned by MlasConvWinogradFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t KernelSize = 9;
+
+    const size_t InputTileSize = Parameters->u.Winograd.TileSize + 2;
+    const size_t GroupSize = InputTileSize * InputTileSize * FilterCount * InputChannels;
+
+    for (size_t group = 0; group < Parameters->GroupCount; group++) {
+
+        const float* filter = Filter + group * FilterCount * InputChannels * KernelSize;
+
+        auto Accessor = [filter, InputChannels, KernelSize](size_t f, size_t c,
+            const float** g, size_t* RowStride, size_t* ColumnStride) {
+            *g = filter + (f * InputChannels + c) * KernelSize;
+            *RowStride = 3;
+            *ColumnStride = 1;
+        };
+
+        if (Parameters->u.Winograd.TileSize == 2) {
+            MlasWinogradTransformFilter<2>(FilterCount, InputChannels, Accessor, TransformedFilter);
+        } else {
+            MlasWinogradTransformFilter<4>(FilterCount, InputChannels, Accessor, TransformedFilter);
+        }
+
+        TransformedFilter += GroupSize;
+    }
+}
+
+template<size_t TileSize>
+void
+MlasConvWinogradOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a segment of the Winograd convolution operation
+    for a single batch and group.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the transformed filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        for a block of tiles.
+
+    Output - Supplies the output tensor.
+
+    TileStart - Supplies the first tile of the segment.
+
+    TileCount - Supplies the number of tiles of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t InputTileSize = MLAS_WINOGRAD_TRANSFORM<TileSize>::InputTileSize;
+    constexpr size_t TransformSize = InputTileSize * InputTileSize;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountW = (OutputWidth + TileSize - 1) / TileSize;
+    const size_t BlockTileCount = Parameters->u.Winograd.BlockTileCount;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + TransformSize * InputChannels * BlockTileCount;
+
+    while (TileCount > 0) {
+
+        const size_t CountT = (std::min)(TileCount, BlockTileCount);
+
+        //
+        // Transform the input tiles to matrices of InputChannels rows by CountT
+        // columns, one for each position of the transformed tile.
+        //
+
+        const size_t InputTransformStride = InputChannels * CountT;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* input = Input + c * InputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t t = TileStart + tt;
+                const size_t ih = (t / TileCountW) * TileSize - PaddingTop;
+                const size_t iw = (t % TileCountW) * TileSize - PaddingLeft;
+
+                float d[TransformSize];
+
+                for (size_t y = 0; y < InputTileSize; y++) {
+
+                    const size_t iy = ih + y;
+
+                    for (size_t x = 0; x < InputTileSize; x++) {
+
+                        const size_t ix = iw + x;
+
+                        d[y * InputTileSize + x] = (iy < InputHeight && ix < InputWidth) ?
+                            input[iy * InputWidth + ix] : 0.0f;
+                    }
+                }
+
+                float v[TransformSize];
+
+                MlasWinogradTransformInputTile<TileSize>(d, v);
+
+                float* transformed = TransformedInput + c * CountT + tt;
+
+                for (size_t k = 0; k < TransformSize; k++) {
+                    transformed[k * InputTransformStride] = v[k];
+                }
+            }
+        }
+
+        //
+        // Multiply the transformed filter and input for each position of the
+        // transformed tile.
+        //
+
+        const size_t FilterTransformStride = FilterCount * InputChannels;
+        const size_t OutputTransformStride = FilterCount * CountT;
+
+        for (size_t k = 0; k < TransformSize; k++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountT,
+                InputChannels, 1.0f, Filter + k * FilterTransformStride, InputChannels,
+                TransformedInput + k * InputTransformStride, CountT, 0.0f,
+                TransformedOutput + k * OutputTransformStride, CountT);
+        }
+
+        //
+        // Transform the products to the output tiles, clipping the tiles at
+        // the right and bottom edges of the output.
+        //
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            float* output = Output + f * OutputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t t = TileStart + tt;
+                const size_t oh = (t / TileCountW) * TileSize;
+                const size_t ow = (t % TileCountW) * TileSize;
+
+                const float* transformed = TransformedOutput + f * CountT + tt;
+
+                float m[TransformSize];
+
+                for (size_t k = 0; k < TransformSize; k++) {
+                    m[k] = transformed[k * OutputTransformStride];
+                }
+
+                float y[TileSize * TileSize];
+
+                MlasWinogradTransformOutputTile<TileSize>(m, y);
+
+                const size_t CountY = (std::min)(TileSize, OutputHeight - oh);
+                const size_t CountX = (std::min)(TileSize, OutputWidth - ow);
+
+                for (size_t yy = 0; yy < CountY; yy++) {
+                    for (size_t xx = 0; xx < CountX; xx++) {
+                        output[(oh + yy) * OutputWidth + ow + xx] = y[yy * TileSize + xx];
+                    }
+                }
+            }
+        }
+
+        //
+        // Apply the activation with optional bias to the output rows of each
+        // run of tiles from the same row of tiles.
+        //
+
+        for (size_t t = TileStart; t < TileStart + CountT;) {
+
+            const size_t th = t / TileCountW;
+            const size_t tw = t % TileCountW;
+            const size_t CountTW = (std::min)(TileCountW - tw, TileStart + CountT - t);
+
+            const size_t oh = th * TileSize;
+            const size_t ow = tw * TileSize;
+            const size_t CountY = (std::min)(TileSize, OutputHeight - oh);
+            const size_t CountX = (std::min)(CountTW * TileSize, OutputWidth - ow);
+
+            for (size_t yy = 0; yy < CountY; yy++) {
+                MlasActivation(Parameters->Activation, Output + (oh + yy) * OutputWidth + ow,
+                    Bias, FilterCount, CountX, OutputSize);
+            }
+
+            t += CountTW;
+        }
+
+        TileStart += CountT;
+        TileCount -= CountT;
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileSize = Parameters->u.Winograd.TileSize;
+    const size_t TileCount = Parameters->u.Winograd.TileCount;
+    const size_t ThreadStrideTiles = Parameters->u.Winograd.ThreadStrideTiles;
+
+    const size_t TileStart = size_t(Index) * ThreadStrideTiles;
+
+    if (TileStart >= TileCount) {
+        return;
+    }
+
+    const size_t InputTileSize = TileSize + 2;
+    const size_t WorkingBufferSizePerThread = InputTileSize * InputTileSize *
+        (Parameters->InputChannels + Parameters->FilterCount) * Parameters->u.Winograd.BlockTileCount;
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + size_t(Index) * WorkingBufferSizePerThread;
+
+    const size_t CountT = (std::min)(ThreadStrideTiles, TileCount - TileStart);
+
+    if (TileSize == 2) {
+        MlasConvWinogradOperation<2>(Parameters, WorkBlock->Input, WorkBlock->Filter,
+            WorkBlock->Bias, WorkingBuffer, WorkBlock->Output, TileStart, CountT);
+    } else {
+        MlasConvWinogradOperation<4>(Parameters, WorkBlock->Input, WorkBlock->Filter,
+            WorkBlock->Bias, WorkingBuffer, WorkBlock->Output, TileStart, CountT);
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd convolution operation for a single
+    batch and group.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the transformed filter tensor for the group.
+
+    Bias - Optionally supplies the bias vector for the group.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.ZeroMode = true;
+
+    if (Parameters->ThreadCount > 1) {
+        MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+    } else {
+        MlasConvWinogradThreaded(&WorkBlock, 0);
+    }
+}
+
+//
+// NCHWc implementation.
+//
+// The input and output tiles are transformed using vectors of channels from
+// the NCHWc blocks. The transformed input is stored as matrices of tiles by
+// input channels, so each SGEMM produces matrices of tiles by filters that
+// can be read back as NCHWc blocks.
+//
+
+void
+MLASCALL
+MlasNchwcConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a filter tensor in OIHWBiBo format, as produced by
+    MlasReorderFilterOIHWBiBo, for the NCHWc Winograd algorithm.
+
+Arguments:
+
+    Parameters - Supplies the parameters prepared for the Winograd algorithm
+        by MlasConvPrepare using the NCHWc channel counts.
+
+    Filter - Supplies the filter tensor.
+
+    TransformedFilter - Receives the transformed filter. The buffer must hold
+        the number of elements returned by MlasConvWinogradFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t KernelSize = 9;
+
+    auto Accessor = [Filter, InputChannels, KernelSize, BlockSize](size_t f, size_t c,
+        const float** g, size_t* RowStride, size_t* ColumnStride) {
+        const size_t FilterBlock = (f / BlockSize) * (InputChannels / BlockSize) + (c / BlockSize);
+        *g = Filter + FilterBlock * KernelSize * BlockSize * BlockSize +
+            (c % BlockSize) * BlockSize + (f % BlockSize);
+        *RowStride = 3 * BlockSize * BlockSize;
+        *ColumnStride = BlockSize * BlockSize;
+    };
+
+    if (Parameters->u.Winograd.TileSize == 2) {
+        MlasWinogradTransformFilter<2>(FilterCount, InputChannels, Accessor, TransformedFilter);
+    } else {
+        MlasWinogradTransformFilter<4>(FilterCount, InputChannels, Accessor, TransformedFilter);
+    }
+}
+
+template<size_t TileSize>
+void
+MlasNchwcConvWinogradOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    bool ZeroMode,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a segment of the NCHWc Winograd convolution
+    operation for a single batch.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the transformed filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        for a block of tiles.
+
+    Output - Supplies the output tensor.
+
+    ZeroMode - Supplies true if the output tensor is overwritten, else false
+        if the output tensor is accumulated into.
+
+    TileStart - Supplies the first tile of the segment.
+
+    TileCount - Supplies the number of tiles of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t InputTileSize = MLAS_WINOGRAD_TRANSFORM<TileSize>::InputTileSize;
+    constexpr size_t TransformSize = InputTileSize * InputTileSize;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountW = (OutputWidth + TileSize - 1) / TileSize;
+    const size_t BlockTileCount = Parameters->u.Winograd.BlockTileCount;
+
+    const MLAS_ACTIVATION_KIND ActivationKind = Parameters->Activation->ActivationKind;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + TransformSize * InputChannels * BlockTileCount;
+
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    while (TileCount > 0) {
+
+        const size_t CountT = (std::min)(TileCount, BlockTileCount);
+
+        //
+        // Transform the input tiles to matrices of CountT rows by
+        // InputChannels columns, one for each position of the transformed
+        // tile.
+        //
+
+        const size_t InputTransformStride = CountT * InputChannels;
+
+        for (size_t c = 0; c < InputChannels; c += BlockSize) {
+
+            const float* input = Input + c * InputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t t = TileStart + tt;
+                const size_t ih = (t / TileCountW) * TileSize - PaddingTop;
+                const size_t iw = (t % TileCountW) * TileSize - PaddingLeft;
+
+                float* transformed = TransformedInput + tt * InputChannels + c;
+
+                for (size_t bc = 0; bc < BlockSize; bc += 4) {
+
+                    MLAS_FLOAT32X4 d[TransformSize];
+
+                    for (size_t y = 0; y < InputTileSize; y++) {
+
+                        const size_t iy = ih + y;
+
+                        for (size_t x = 0; x < InputTileSize; x++) {
+
+                            const size_t ix = iw + x;
+
+                            d[y * InputTileSize + x] = (iy < InputHeight && ix < InputWidth) ?
+                                MlasLoadFloat32x4(&input[(iy * InputWidth + ix) * BlockSize + bc]) :
+                                ZeroFloat32x4;
+                        }
+                    }
+
+                    MLAS_FLOAT32X4 v[TransformSize];
+
+                    MlasWinogradTransformInputTile<TileSize>(d, v);
+
+                    for (size_t k = 0; k < TransformSize; k++) {
+                        MlasStoreFloat32x4(&transformed[k * InputTransformStride + bc], v[k]);
+                    }
+                }
+            }
+        }
+
+        //
+        // Multiply the transformed input and filter for each position of the
+        // transformed tile.
+        //
+
+        const size_t FilterTransformStride = FilterCount * InputChannels;
+        const size_t OutputTransformStride = CountT * FilterCount;
+
+        for (size_t k = 0; k < TransformSize; k++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasTrans, CountT, FilterCount,
+                InputChannels, 1.0f, TransformedInput + k * InputTransformStride,
+                InputChannels, Filter + k * FilterTransformStride, InputChannels, 0.0f,
+                TransformedOutput + k * OutputTransformStride, FilterCount);
+        }
+
+        //
+        // Transform the products to the output tiles, clipping the tiles at
+        // the right and bottom edges of the output. The bias, the prior output
+        // values for Conv/Sum fusion and a ReLU activation are applied here.
+        //
+
+        for (size_t f = 0; f < FilterCount; f += BlockSize) {
+
+            float* output = Output + f * OutputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t t = TileStart + tt;
+                const size_t oh = (t / TileCountW) * TileSize;
+                const size_t ow = (t % TileCountW) * TileSize;
+
+                const size_t CountY = (std::min)(TileSize, OutputHeight - oh);
+                const size_t CountX = (std::min)(TileSize, OutputWidth - ow);
+
+                const float* transformed = TransformedOutput + tt * FilterCount + f;
+
+                for (size_t bf = 0; bf < BlockSize; bf += 4) {
+
+                    MLAS_FLOAT32X4 m[TransformSize];
+
+                    for (size_t k = 0; k < TransformSize; k++) {
+                        m[k] = MlasLoadFloat32x4(&transformed[k * OutputTransformStride + bf]);
+                    }
+
+                    MLAS_FLOAT32X4 y[TileSize * TileSize];
+
+                    MlasWinogradTransformOutputTile<TileSize>(m, y);
+
+                    const MLAS_FLOAT32X4 BiasVector = (Bias != nullptr) ?
+                        MlasLoadFloat32x4(&Bias[f + bf]) : ZeroFloat32x4;
+
+                    for (size_t yy = 0; yy < CountY; yy++) {
+
+                        for (size_t xx = 0; xx < CountX; xx++) {
+
+                            float* o = &output[((oh + yy) * OutputWidth + ow + xx) * BlockSize + bf];
+
+                            MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(y[yy * TileSize + xx], BiasVector);
+
+                            if (!ZeroMode) {
+                                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(o));
+                            }
+
+                            if (ActivationKind == MlasReluActivation) {
+                                Vector = MlasMaximumFloat32x4(Vector, ZeroFloat32x4);
+                            }
+
+                            MlasStoreFloat32x4(o, Vector);
+                        }
+                    }
+                }
+            }
+        }
+
+        //
+        // Apply other types of activation to the output rows of each run of
+        // tiles from the same row of tiles.
+        //
+
+        if (ActivationKind != MlasIdentityActivation && ActivationKind != MlasReluActivation) {
+
+            for (size_t t = TileStart; t < TileStart + CountT;) {
+
+                const size_t th = t / TileCountW;
+                const size_t tw = t % TileCountW;
+                const size_t CountTW = (std::min)(TileCountW - tw, TileStart + CountT - t);
+
+                const size_t oh = th * TileSize;
+                const size_t ow = tw * TileSize;
+                const size_t CountY = (std::min)(TileSize, OutputHeight - oh);
+                const size_t CountX = (std::min)(CountTW * TileSize, OutputWidth - ow);
+
+                for (size_t yy = 0; yy < CountY; yy++) {
+                    MlasActivation(Parameters->Activation,
+                        Output + ((oh + yy) * OutputWidth + ow) * BlockSize, nullptr,
+                        FilterCount / BlockSize, CountX * BlockSize, BlockSize * OutputSize);
+                }
+
+                t += CountTW;
+            }
+        }
+
+        TileStart += CountT;
+        TileCount -= CountT;
+    }
+}
+
+void
+MlasNchwcConvWinogradThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NCHWc Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t TileSize = Parameters->u.Winograd.TileSize;
+    const size_t TileCount = Parameters->u.Winograd.TileCount;
+    const size_t ThreadStrideTiles = Parameters->u.Winograd.ThreadStrideTiles;
+
+    const size_t TileStart = size_t(Index) * ThreadStrideTiles;
+
+    if (TileStart >= TileCount) {
+        return;
+    }
+
+    const size_t InputTileSize = TileSize + 2;
+    const size_t WorkingBufferSizePerThread = InputTileSize * InputTileSize *
+        (Parameters->InputChannels + Parameters->FilterCount) * Parameters->u.Winograd.BlockTileCount;
+
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + size_t(Index) * WorkingBufferSizePerThread;
+
+    const size_t CountT = (std::min)(ThreadStrideTiles, TileCount - TileStart);
+
+    if (TileSize == 2) {
+        MlasNchwcConvWinogradOperation<2>(Parameters, WorkBlock->Input, WorkBlock->Filter,
+            WorkBlock->Bias, WorkingBuffer, WorkBlock->Output, WorkBlock->ZeroMode,
+            TileStart, CountT);
+    } else {
+        MlasNchwcConvWinogradOperation<4>(Parameters, WorkBlock->Input, WorkBlock->Filter,
+            WorkBlock->Bias, WorkingBuffer, WorkBlock->Output, WorkBlock->ZeroMode,
+            TileStart, CountT);
+    }
+}
+
+void
+MLASCALL
+MlasNchwcConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    bool ZeroMode,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc convolution operation using the Winograd
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the parameters prepared by MlasConvPrepare using the
+        NCHWc channel counts with a single group. The algorithm must be
+        MlasConvAlgorithmWinograd.
+
+    Input - Supplies the input tensor in NCHWc format.
+
+    Filter - Supplies the filter tensor transformed by
+        MlasNchwcConvWinogradTransformFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor in NCHWc format.
+
+    ZeroMode - Supplies true if the output tensor is overwritten, else false
+        if the output tensor is accumulated into. This flag is used to
+        implement Conv/Sum fusion.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputBatchSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputBatchSize = Parameters->FilterCount * Parameters->OutputSize;
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.ZeroMode = ZeroMode;
+
+    for (size_t batch = 0; batch < Parameters->BatchCount; batch++) {
+
+        WorkBlock.Input = Input + batch * InputBatchSize;
+        WorkBlock.Output = Output + batch * OutputBatchSize;
+
+        if (Parameters->ThreadCount > 1) {
+            MlasExecuteThreaded(MlasNchwcConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+        } else {
+            MlasNchwcConvWinogradThreaded(&WorkBlock, 0);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsCandidate(const Node& node, const std::string& op_type,
+                 const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                 const std::string& provider) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, versions) &&
+         node.GetExecutionProviderType() == provider;
+}
+
+// MatMul operands of rank one follow different broadcasting rules, so require matrices.
+bool HasMatrixShape(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() >= 2;
+}
+
+// Checks that adding the mask to the scores does not broadcast the scores to a larger shape.
+bool IsScoresMask(const NodeArg& mask, const NodeArg& scores) {
+  const auto* mask_shape = mask.Shape();
+  const auto* scores_shape = scores.Shape();
+  if (mask_shape == nullptr || scores_shape == nullptr || mask_shape->dim_size() > scores_shape->dim_size()) {
+    return false;
+  }
+  const int offset = scores_shape->dim_size() - mask_shape->dim_size();
+  for (int i = 0; i < mask_shape->dim_size(); i++) {
+    const auto& mask_dim = mask_shape->dim(i);
+    const auto& scores_dim = scores_shape->dim(offset + i);
+    if (mask_dim.has_dim_value() && mask_dim.dim_value() == 1) {
+      continue;
+    }
+    if (mask_dim.has_dim_value() && scores_dim.has_dim_value() && mask_dim.dim_value() == scores_dim.dim_value()) {
+      continue;
+    }
+    if (mask_dim.has_dim_param() && scores_dim.has_dim_param() && mask_dim.dim_param() == scores_dim.dim_param()) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+/*
+Fuses the scaled dot product attention of transformer models into ScaledDotProductAttention:
+
+    Y = MatMul(Softmax(Add(Div(MatMul(Q, K), c), mask), axis=-1), V)
+
+The scale may also be a Mul by a constant or be absent, and the mask Add is optional. The Reshape
+and Transpose nodes that split the heads and transpose the key stay in the graph, since they only
+produce the Q, K and V inputs.
+*/
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed by an earlier fusion
+    }
+
+    auto& scores_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(scores_node, modified, graph_level));
+
+    // The CPU kernel is implemented for float.
+    const auto* type = scores_node.InputDefs().empty() ? nullptr : scores_node.InputDefs()[0]->Type();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(scores_node, "MatMul", {1, 9}) ||
+        !graph_utils::IsSupportedProvider(scores_node, GetCompatibleExecutionProviders()) ||
+        type == nullptr || *type != "tensor(float)" ||
+        !HasMatrixShape(*scores_node.InputDefs()[0]) ||
+        !HasMatrixShape(*scores_node.InputDefs()[1]) ||
+        !optimizer_utils::IsFusableIntermediate(graph, scores_node)) {
+      continue;
+    }
+
+    const std::string& provider = scores_node.GetExecutionProviderType();
+    std::vector<Node*> nodes_to_remove{&scores_node};
+    Node* current_node = &scores_node;
+    Node* next_node = graph.GetNode(scores_node.OutputNodesBegin()->Index());
+
+    // Optional scale of the scores by a constant.
+    float scale = 1.0f;
+    if (IsCandidate(*next_node, "Div", {7}, provider) || IsCandidate(*next_node, "Mul", {7}, provider)) {
+      const NodeArg* factor = optimizer_utils::GetOtherInput(*next_node, *current_node->OutputDefs()[0]);
+      if (factor == nullptr ||
+          (next_node->OpType() == "Div" && next_node->InputDefs()[0] != current_node->OutputDefs()[0]) ||
+          !optimizer_utils::GetScalarInitializerValue(graph, *factor, scale) ||
+          (next_node->OpType() == "Div" && scale == 0.0f) ||
+          !optimizer_utils::IsFusableIntermediate(graph, *next_node)) {
+        continue;
+      }
+      if (next_node->OpType() == "Div") {
+        scale = 1.0f / scale;
+      }
+      nodes_to_remove.push_back(next_node);
+      current_node = next_node;
+      next_node = graph.GetNode(next_node->OutputNodesBegin()->Index());
+    }
+
+    // Optional additive mask.
+    NodeArg* mask = nullptr;
+    if (IsCandidate(*next_node, "Add", {7}, provider)) {
+      mask = const_cast<NodeArg*>(optimizer_utils::GetOtherInput(*next_node, *current_node->OutputDefs()[0]));
+      if (mask == nullptr ||
+          !IsScoresMask(*mask, *scores_node.OutputDefs()[0]) ||
+          !optimizer_utils::IsFusableIntermediate(graph, *next_node)) {
+        continue;
+      }
+      nodes_to_remove.push_back(next_node);
+      current_node = next_node;
+      next_node = graph.GetNode(next_node->OutputNodesBegin()->Index());
+    }
+
+    // Softmax over the last axis. Softmax defaults to axis 1, which coerces the input to 2D.
+    Node& softmax_node = *next_node;
+    const auto* axis_attr = graph_utils::GetNodeAttribute(softmax_node, "axis");
+    if (!IsCandidate(softmax_node, "Softmax", {1}, provider) ||
+        !optimizer_utils::IsLastAxis(*softmax_node.InputDefs()[0], axis_attr != nullptr ? axis_attr->i() : 1) ||
+        !optimizer_utils::IsFusableIntermediate(graph, softmax_node)) {
+      continue;
+    }
+    nodes_to_remove.push_back(&softmax_node);
+
+    Node& output_node = *graph.GetNode(softmax_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(output_node, "MatMul", {1, 9}, provider) ||
+        output_node.InputDefs()[0] != softmax_node.OutputDefs()[0] ||
+        !HasMatrixShape(*output_node.InputDefs()[1])) {
+      continue;
+    }
+    nodes_to_remove.push_back(&output_node);
+
+    std::vector<NodeArg*> fused_inputs{scores_node.MutableInputDefs()[0],
+                                       scores_node.MutableInputDefs()[1],
+                                       output_node.MutableInputDefs()[1]};
+    if (mask != nullptr) {
+      fused_inputs.push_back(mask);
+    }
+
+    Node& attention_node = graph.AddNode(graph.GenerateNodeName("ScaledDotProductAttention"),
+                                         "ScaledDotProductAttention",
+                                         "fused attention subgraph",
+                                         fused_inputs,
+                                         output_node.MutableOutputDefs(),
+                                         nullptr,
+                                         kMSDomain);
+    attention_node.AddAttribute("scale", scale);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention_node.SetExecutionProviderType(provider);
+
+    optimizer_utils::RemoveFusedNodes(graph, nodes_to_remove);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool HaveSameContents(const TensorProto& lhs, const TensorProto& rhs) {
+  if (utils::HasRawData(lhs) && utils::HasRawData(rhs)) {
+    return lhs.raw_data() == rhs.raw_data();
+  }
+
+  // Compare the serialized tensors excluding the names.
+  TensorProto lhs_copy(lhs);
+  TensorProto rhs_copy(rhs);
+  lhs_copy.clear_name();
+  rhs_copy.clear_name();
+  return lhs_copy.SerializeAsString() == rhs_copy.SerializeAsString();
+}
+
+// Maps the NodeArg of each constant initializer to the NodeArg of the first
+// constant initializer with identical type, shape and contents.
+std::unordered_map<const NodeArg*, NodeArg*> FindDuplicateInitializers(Graph& graph) {
+  std::unordered_map<const NodeArg*, NodeArg*> replacements;
+
+  // Visit the initializers in name order so that the selected representative
+  // does not depend on the hash map ordering.
+  std::vector<std::string> names;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    names.push_back(entry.first);
+  }
+  std::sort(names.begin(), names.end());
+
+  // Candidates are grouped by data type and shape. Contents are only compared
+  // within a group.
+  std::unordered_map<std::string, std::vector<const TensorProto*>> candidates;
+
+  for (const auto& name : names) {
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, name, false);
+    auto* node_arg = graph.GetNodeArg(name);
+    if (tensor_proto == nullptr || node_arg == nullptr) {
+      continue;
+    }
+
+    std::string key = std::to_string(tensor_proto->data_type());
+    for (auto dim : tensor_proto->dims()) {
+      key += ',';
+      key += std::to_string(dim);
+    }
+
+    auto& group = candidates[key];
+    auto it = std::find_if(group.begin(), group.end(), [tensor_proto](const TensorProto* candidate) {
+      return HaveSameContents(*candidate, *tensor_proto);
+    });
+    if (it != group.end()) {
+      auto* representative_arg = graph.GetNodeArg((*it)->name());
+      if (representative_arg != nullptr) {
+        replacements[node_arg] = representative_arg;
+      }
+    } else {
+      group.push_back(tensor_proto);
+    }
+  }
+
+  return replacements;
+}
+
+// Computes a string that is identical for nodes that compute the same value.
+// The inputs are identified by name, which is unique within the graph.
+std::string ComputeSignature(const Node& node) {
+  std::string signature = node.Domain();
+  signature += ';';
+  signature += node.OpType();
+  signature += ';';
+  signature += std::to_string(node.Op() != nullptr ? node.Op()->SinceVersion() : -1);
+  signature += ';';
+
+  for (const auto* input_def : node.InputDefs()) {
+    signature += input_def->Name();
+    signature += ',';
+  }
+  signature += ';';
+
+  // Optional outputs that are missing in one node cannot be replaced by the
+  // other node.
+  for (const auto* output_def : node.OutputDefs()) {
+    signature += output_def->Exists() ? '1' : '0';
+  }
+  signature += ';';
+
+  // Serialize the attributes in name order.
+  std::map<std::string, const AttributeProto*> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes.emplace(attribute.first, &attribute.second);
+  }
+  for (const auto& attribute : attributes) {
+    signature += attribute.first;
+    signature += '=';
+    signature += attribute.second->SerializeAsString();
+    signature += ';';
+  }
+
+  return signature;
+}
+
+// Redirects the consumers of the duplicate node to the outputs of the
+// representative node and removes the duplicate node.
+bool MergeNodes(Graph& graph, Node& representative, Node& duplicate) {
+  // Graph outputs are referenced by name and cannot be redirected.
+  if (graph.IsNodeOutputsInGraphOutputs(duplicate)) {
+    return false;
+  }
+
+  struct OutputEdge {
+    NodeIndex dst_node;
+    int src_arg_index;
+    int dst_arg_index;
+  };
+
+  std::vector<OutputEdge> output_edges;
+  for (auto it = duplicate.OutputEdgesBegin(); it != duplicate.OutputEdgesEnd(); ++it) {
+    // Implicit inputs of nodes with subgraphs are referenced by name inside
+    // the subgraph and cannot be redirected.
+    if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+      return false;
+    }
+    output_edges.push_back({it->GetNode().Index(), it->GetSrcArgIndex(), it->GetDstArgIndex()});
+  }
+
+  for (const auto& output_edge : output_edges) {
+    graph.RemoveEdge(duplicate.Index(), output_edge.dst_node, output_edge.src_arg_index, output_edge.dst_arg_index);
+
+    auto* consumer = graph.GetNode(output_edge.dst_node);
+    consumer->MutableInputDefs()[output_edge.dst_arg_index] =
+        representative.MutableOutputDefs()[output_edge.src_arg_index];
+
+    graph.AddEdge(representative.Index(), output_edge.dst_node, output_edge.src_arg_index, output_edge.dst_arg_index);
+  }
+
+  graph.RemoveNode(duplicate.Index());
+  return true;
+}
+
+}  // namespace
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  auto initializer_replacements = FindDuplicateInitializers(graph);
+
+  // Stores the first node with each signature.
+  std::unordered_map<std::string, NodeIndex> node_signatures;
+
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // Use a single NodeArg for each set of identical initializers. The
+    // duplicate initializers are removed by Graph::Resolve() once unused.
+    for (auto& input_def : node->MutableInputDefs()) {
+      auto it = initializer_replacements.find(input_def);
+      if (it != initializer_replacements.end()) {
+        input_def = it->second;
+        modified = true;
+      }
+    }
+
+    if (excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
+        node->ContainsSubgraph() ||
+        node->OutputDefs().empty()) {
+      continue;
+    }
+
+    // Inputs produced by merged nodes have already been redirected to the
+    // representative node, so duplicates are found in a single pass.
+    auto result = node_signatures.emplace(ComputeSignature(*node), index);
+    if (result.second) {
+      continue;
+    }
+
+    auto* representative = graph.GetNode(result.first->second);
+    if (representative != nullptr && MergeNodes(graph, *representative, *node)) {
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
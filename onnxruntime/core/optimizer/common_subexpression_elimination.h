@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class CommonSubexpressionElimination
+
+Transformer that merges nodes that compute the same value, i.e., nodes with the same
+op type, domain, version, attributes and inputs. Constant initializers with identical
+contents are merged first, so that nodes that only differ by a duplicated initializer
+are also merged.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+ private:
+  /** Nodes whose op_type is included in this set are never merged.
+      All non-deterministic operators should be included in this set. */
+  const std::unordered_set<std::string> excluded_op_types_ =
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
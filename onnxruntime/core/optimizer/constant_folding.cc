@@ -4,6 +4,7 @@
 #include "core/optimizer/constant_folding.h"
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/optimizer_execution_frame.h"
+#include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
 
@@ -11,10 +12,427 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+namespace {
+
+// Stores the value of a 0-D or 1-D int64 tensor that is computed from the
+// output of a Shape node. Each element is either a known value or a symbolic
+// dimension, identified by its dim_param name if the model provides one.
+struct SymbolicValue {
+  struct Element {
+    bool known;
+    int64_t value;
+    std::string param;
+  };
+
+  std::vector<Element> elements;
+  bool is_scalar = false;
+
+  bool IsKnown() const {
+    return std::all_of(elements.begin(), elements.end(), [](const Element& element) { return element.known; });
+  }
+};
+
+using SymbolicValueMap = std::unordered_map<const NodeArg*, SymbolicValue>;
+
+bool GetConstantInt64Values(const Graph& graph, const NodeArg& arg, std::vector<int64_t>& values, bool& is_scalar) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->dims_size() > 1) {
+    return false;
+  }
+
+  is_scalar = tensor_proto->dims_size() == 0;
+  const int64_t size = is_scalar ? 1 : tensor_proto->dims(0);
+  if (size < 0) {
+    return false;
+  }
+
+  const void* raw_data = utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().data() : nullptr;
+  const size_t raw_data_len = utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().size() : 0;
+
+  values.resize(static_cast<size_t>(size));
+  if (tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    return utils::UnpackTensor<int64_t>(*tensor_proto, raw_data, raw_data_len, values.data(), size).IsOK();
+  }
+  if (tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+    std::vector<int32_t> int32_values(static_cast<size_t>(size));
+    if (!utils::UnpackTensor<int32_t>(*tensor_proto, raw_data, raw_data_len, int32_values.data(), size).IsOK()) {
+      return false;
+    }
+    std::copy(int32_values.begin(), int32_values.end(), values.begin());
+    return true;
+  }
+  return false;
+}
+
+bool GetConstantInt64Values(const Graph& graph, const NodeArg& arg, std::vector<int64_t>& values) {
+  bool is_scalar;
+  return GetConstantInt64Values(graph, arg, values, is_scalar);
+}
+
+// Returns the symbolic value of a NodeArg that is either the output of an
+// earlier shape computation or a constant initializer.
+bool GetSymbolicValue(const Graph& graph, const SymbolicValueMap& symbolic_values, const NodeArg& arg,
+                      SymbolicValue& value) {
+  auto it = symbolic_values.find(&arg);
+  if (it != symbolic_values.end()) {
+    value = it->second;
+    return true;
+  }
+
+  std::vector<int64_t> values;
+  if (!GetConstantInt64Values(graph, arg, values, value.is_scalar)) {
+    return false;
+  }
+  value.elements.clear();
+  for (auto v : values) {
+    value.elements.push_back({true, v, std::string()});
+  }
+  return true;
+}
+
+bool HasSingleAxisZero(const Node& node) {
+  auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  return axis_attr == nullptr || (utils::HasInt(*axis_attr) && axis_attr->i() == 0);
+}
+
+bool HasAxesZero(const Node& node, bool allow_missing) {
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+    return allow_missing;
+  }
+  return axes.size() == 1 && axes[0] == 0;
+}
+
+// Computes the symbolic value of the output of a node that operates on shape
+// tensors.
+bool InferSymbolicValue(const Graph& graph, const Node& node, const SymbolicValueMap& symbolic_values,
+                        SymbolicValue& value) {
+  const auto& input_defs = node.InputDefs();
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Shape", {1})) {
+    const auto* input_shape = input_defs[0]->Shape();
+    if (input_shape == nullptr) {
+      return false;
+    }
+    for (int i = 0, num_dims = input_shape->dim_size(); i < num_dims; i++) {
+      const auto& dim = input_shape->dim(i);
+      if (utils::HasDimValue(dim) && dim.dim_value() >= 0) {
+        value.elements.push_back({true, dim.dim_value(), std::string()});
+      } else {
+        value.elements.push_back({false, 0, utils::HasDimParam(dim) ? dim.dim_param() : std::string()});
+      }
+    }
+    value.is_scalar = false;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1})) {
+    SymbolicValue data;
+    std::vector<int64_t> indices;
+    bool indices_is_scalar;
+    if (!HasSingleAxisZero(node) ||
+        !GetSymbolicValue(graph, symbolic_values, *input_defs[0], data) || data.is_scalar ||
+        !GetConstantInt64Values(graph, *input_defs[1], indices, indices_is_scalar)) {
+      return false;
+    }
+    const int64_t size = static_cast<int64_t>(data.elements.size());
+    for (auto index : indices) {
+      if (index < 0) {
+        index += size;
+      }
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      value.elements.push_back(data.elements[static_cast<size_t>(index)]);
+    }
+    value.is_scalar = indices_is_scalar;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1})) {
+    if (!HasAxesZero(node, false) ||
+        !GetSymbolicValue(graph, symbolic_values, *input_defs[0], value) || !value.is_scalar) {
+      return false;
+    }
+    value.is_scalar = false;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1})) {
+    if (!HasAxesZero(node, true) ||
+        !GetSymbolicValue(graph, symbolic_values, *input_defs[0], value) ||
+        value.is_scalar || value.elements.size() != 1) {
+      return false;
+    }
+    value.is_scalar = true;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
+    if (!HasSingleAxisZero(node)) {
+      return false;
+    }
+    for (const auto* input_def : input_defs) {
+      SymbolicValue input_value;
+      if (!GetSymbolicValue(graph, symbolic_values, *input_def, input_value) || input_value.is_scalar) {
+        return false;
+      }
+      value.elements.insert(value.elements.end(), input_value.elements.begin(), input_value.elements.end());
+    }
+    value.is_scalar = false;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9})) {
+    auto* to_attr = graph_utils::GetNodeAttribute(node, "to");
+    return to_attr != nullptr && utils::HasInt(*to_attr) &&
+           to_attr->i() == ONNX_NAMESPACE::TensorProto_DataType_INT64 &&
+           GetSymbolicValue(graph, symbolic_values, *input_defs[0], value);
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {1, 10})) {
+    SymbolicValue data;
+    if (!GetSymbolicValue(graph, symbolic_values, *input_defs[0], data) || data.is_scalar) {
+      return false;
+    }
+
+    std::vector<int64_t> starts;
+    std::vector<int64_t> ends;
+    std::vector<int64_t> axes;
+    std::vector<int64_t> steps;
+    if (graph_utils::MatchesOpSinceVersion(node, {1})) {
+      if (!graph_utils::GetRepeatedNodeAttributeValues(node, "starts", starts) ||
+          !graph_utils::GetRepeatedNodeAttributeValues(node, "ends", ends)) {
+        return false;
+      }
+      graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes);
+    } else {
+      const size_t input_count = input_defs.size();
+      if (!GetConstantInt64Values(graph, *input_defs[1], starts) ||
+          !GetConstantInt64Values(graph, *input_defs[2], ends) ||
+          (input_count > 3 && input_defs[3]->Exists() && !GetConstantInt64Values(graph, *input_defs[3], axes)) ||
+          (input_count > 4 && input_defs[4]->Exists() && !GetConstantInt64Values(graph, *input_defs[4], steps))) {
+        return false;
+      }
+    }
+
+    if (starts.size() != 1 || ends.size() != 1 ||
+        (!axes.empty() && (axes.size() != 1 || (axes[0] != 0 && axes[0] != -1))) ||
+        (!steps.empty() && (steps.size() != 1 || steps[0] != 1))) {
+      return false;
+    }
+
+    const int64_t size = static_cast<int64_t>(data.elements.size());
+    auto clamp_index = [size](int64_t index) {
+      if (index < 0) {
+        index += size;
+      }
+      return std::min(std::max(index, static_cast<int64_t>(0)), size);
+    };
+    const int64_t start = clamp_index(starts[0]);
+    const int64_t end = clamp_index(ends[0]);
+    for (int64_t i = start; i < end; i++) {
+      value.elements.push_back(data.elements[static_cast<size_t>(i)]);
+    }
+    value.is_scalar = false;
+    return true;
+  }
+
+  return false;
+}
+
+void AddInt64Initializer(Graph& graph, const std::string& name, const std::vector<int64_t>& values, bool is_scalar) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  if (!is_scalar) {
+    tensor_proto.add_dims(static_cast<int64_t>(values.size()));
+  }
+
+  // Here we expect little-endian format to set raw data of the TensorProto.
+  tensor_proto.set_raw_data(values.data(), values.size() * sizeof(int64_t));
+
+  graph.AddInitializedTensor(tensor_proto);
+}
+
+// Removes the node and then any of the nodes that produced its inputs and are
+// no longer used.
+void RemoveNodeAndUnusedInputNodes(Graph& graph, Node& node) {
+  std::vector<NodeIndex> input_nodes;
+  for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+    input_nodes.push_back(it->Index());
+  }
+
+  graph.RemoveNode(node.Index());
+
+  for (auto index : input_nodes) {
+    auto* input_node = graph.GetNode(index);
+    if (input_node != nullptr && input_node->GetOutputEdgesCount() == 0 &&
+        !graph.IsNodeOutputsInGraphOutputs(*input_node)) {
+      RemoveNodeAndUnusedInputNodes(graph, *input_node);
+    }
+  }
+}
+
+// Replaces the partially known shape input of a Reshape node with a constant
+// shape. Symbolic dimensions that match the same dimension of the data input
+// are copied with 0, and a single remaining symbolic dimension is inferred
+// with -1.
+bool FoldReshapeShape(Graph& graph, Node& node, const SymbolicValueMap& symbolic_values) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = symbolic_values.find(input_defs[1]);
+  if (it == symbolic_values.end() || it->second.is_scalar) {
+    return false;
+  }
+  const auto& elements = it->second.elements;
+
+  bool has_inferred_dim = false;
+  bool has_zero_dim = false;
+  for (const auto& element : elements) {
+    if (element.known) {
+      has_inferred_dim |= (element.value == -1);
+      has_zero_dim |= (element.value == 0);
+    }
+  }
+
+  const auto* data_shape = input_defs[0]->Shape();
+
+  std::vector<int64_t> shape;
+  for (size_t i = 0; i < elements.size(); i++) {
+    const auto& element = elements[i];
+    if (element.known) {
+      shape.push_back(element.value);
+    } else if (data_shape != nullptr && !element.param.empty() &&
+               static_cast<int>(i) < data_shape->dim_size() &&
+               utils::HasDimParam(data_shape->dim(static_cast<int>(i))) &&
+               data_shape->dim(static_cast<int>(i)).dim_param() == element.param) {
+      shape.push_back(0);
+    } else if (!has_inferred_dim && !has_zero_dim) {
+      shape.push_back(-1);
+      has_inferred_dim = true;
+    } else {
+      return false;
+    }
+  }
+
+  std::string shape_name = graph.GenerateNodeArgName(input_defs[1]->Name() + "_folded");
+  AddInt64Initializer(graph, shape_name, shape, false);
+  auto& shape_arg = graph.GetOrCreateNodeArg(shape_name, input_defs[1]->TypeAsProto());
+
+  // Disconnect the original shape computation from the Reshape node and remove
+  // it if there are no other uses.
+  NodeIndex producer_index = 0;
+  int producer_arg_index = -1;
+  for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+    if (edge->GetDstArgIndex() == 1) {
+      producer_index = edge->GetNode().Index();
+      producer_arg_index = edge->GetSrcArgIndex();
+      break;
+    }
+  }
+
+  input_defs[1] = &shape_arg;
+
+  if (producer_arg_index >= 0) {
+    graph.RemoveEdge(producer_index, node.Index(), producer_arg_index, 1);
+    auto* producer = graph.GetNode(producer_index);
+    if (producer != nullptr && producer->GetOutputEdgesCount() == 0 &&
+        !graph.IsNodeOutputsInGraphOutputs(*producer)) {
+      RemoveNodeAndUnusedInputNodes(graph, *producer);
+    }
+  }
+
+  return true;
+}
+
+// Folds nodes that compute shape values from symbolic dimensions. Returns
+// true if the graph was modified.
+bool FoldSymbolicShape(Graph& graph, Node& node, SymbolicValueMap& symbolic_values) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5})) {
+    return FoldReshapeShape(graph, node, symbolic_values);
+  }
+
+  if (node.OutputDefs().size() != 1) {
+    return false;
+  }
+
+  SymbolicValue value;
+  if (!InferSymbolicValue(graph, node, symbolic_values, value)) {
+    return false;
+  }
+
+  const auto* output_def = node.OutputDefs()[0];
+  const auto* output_type = output_def->TypeAsProto();
+  if (output_type == nullptr || !utils::HasTensorType(*output_type) ||
+      output_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    return false;
+  }
+
+  if (!value.IsKnown() || graph.IsNodeOutputsInGraphOutputs(node)) {
+    symbolic_values[output_def] = std::move(value);
+    return false;
+  }
+
+  // All of the values are statically known, so replace the node with an
+  // initializer that has the same name as the node output.
+  std::vector<int64_t> values;
+  for (const auto& element : value.elements) {
+    values.push_back(element.value);
+  }
+  AddInt64Initializer(graph, output_def->Name(), values, value.is_scalar);
+
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  RemoveNodeAndUnusedInputNodes(graph, node);
+
+  return true;
+}
+
+}  // namespace
+
+bool ConstantFolding::ExceedsSizeBudget(const Node& node, size_t constant_inputs_size_in_bytes) const {
+  if (max_output_size_in_bytes_ == 0) {
+    return false;
+  }
+
+  // Use the statically inferred output shapes, if available, to avoid executing
+  // nodes that would produce large outputs.
+  for (const auto* output_def : node.OutputDefs()) {
+    const auto* output_type = output_def->TypeAsProto();
+    const auto* output_shape = output_def->Shape();
+    if (output_type == nullptr || output_shape == nullptr || !utils::HasTensorType(*output_type)) {
+      continue;
+    }
+
+    const auto* tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(output_type->tensor_type().elem_type());
+    size_t size_in_bytes = tensor_type->GetElementType()->Size();
+    bool is_static_shape = true;
+    for (int i = 0, num_dims = output_shape->dim_size(); i < num_dims; i++) {
+      const auto& dim = output_shape->dim(i);
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+        is_static_shape = false;
+        break;
+      }
+      size_in_bytes *= static_cast<size_t>(dim.dim_value());
+    }
+
+    if (is_static_shape && size_in_bytes > max_output_size_in_bytes_ &&
+        size_in_bytes > constant_inputs_size_in_bytes) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  // Stores the partially known values of shape computations.
+  SymbolicValueMap symbolic_values;
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
@@ -23,19 +441,42 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
 
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
 
-    InitializedTensorSet constant_inputs;
-
     // Check if constant folding can be applied on this node.
     if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
         excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
         // constant folding does not support executing a node that includes subgraphs (control flow operators,
         // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
         // by the Recurse call above
-        node->ContainsSubgraph() ||
-        // if the node output is in the graph output, we will get a graph with no nodes.
-        // TODO check if this is allowed in ONNX and ORT.
-        graph.IsNodeOutputsInGraphOutputs(*node) ||
-        !graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs)) {
+        node->ContainsSubgraph()) {
+      continue;
+    }
+
+    InitializedTensorSet constant_inputs;
+
+    if (!graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs)) {
+      // The node may still compute a shape from statically known or symbolic
+      // dimensions.
+      if (FoldSymbolicShape(graph, *node, symbolic_values)) {
+        modified = true;
+      }
+      continue;
+    }
+
+    // if the node output is in the graph output, we will get a graph with no nodes.
+    // TODO check if this is allowed in ONNX and ORT.
+    if (graph.IsNodeOutputsInGraphOutputs(*node)) {
+      continue;
+    }
+
+    size_t constant_inputs_size_in_bytes = 0;
+    for (const auto& constant_input : constant_inputs) {
+      size_t size_in_bytes = 0;
+      if (utils::GetSizeInBytesFromTensorProto<0>(*constant_input.second, &size_in_bytes).IsOK()) {
+        constant_inputs_size_in_bytes += size_in_bytes;
+      }
+    }
+
+    if (ExceedsSizeBudget(*node, constant_inputs_size_in_bytes)) {
       continue;
     }
 
@@ -57,9 +498,21 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
     std::vector<OrtValue> fetches;
     frame.GetOutputs(fetches);
 
+    // Check the actual output sizes against the size budget for outputs whose
+    // shapes were not statically known.
+    ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
+    if (max_output_size_in_bytes_ != 0) {
+      bool exceeds_size_budget = std::any_of(fetches.begin(), fetches.end(), [&](const OrtValue& ort_value) {
+        size_t size_in_bytes = ort_value.Get<Tensor>().SizeInBytes();
+        return size_in_bytes > max_output_size_in_bytes_ && size_in_bytes > constant_inputs_size_in_bytes;
+      });
+      if (exceeds_size_budget) {
+        continue;
+      }
+    }
+
     // Go over all output node args and substitute them with the newly computed tensors, which will be
     // added to the graph as initializers.
-    ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
     for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
       OrtValue& ort_value = fetches[fetch_idx];
 
@@ -13,11 +13,23 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+Shape subgraphs (Shape followed by Gather/Slice/Squeeze/Unsqueeze/Concat/Cast) are also
+evaluated symbolically: outputs whose value only depends on statically known dimensions
+are folded, and partially known shapes that feed a Reshape are replaced with a constant
+shape that uses 0 (copy) or -1 (infer) for the symbolic dimensions.
+
+The optional size budget prevents folding nodes that expand their constant inputs into
+large initializers (for example Tile or Expand). A node is not folded if any output is
+larger than the budget and larger than the total size of the node's constant inputs.
+A budget of 0 means no limit.
 */
 class ConstantFolding : public GraphTransformer {
  public:
-  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept :
-    GraphTransformer("ConstantFolding", compatible_execution_providers) {}
+  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                  size_t max_output_size_in_bytes = 0) noexcept :
+    GraphTransformer("ConstantFolding", compatible_execution_providers),
+    max_output_size_in_bytes_(max_output_size_in_bytes) {}
 
  private:
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
@@ -25,8 +37,15 @@ class ConstantFolding : public GraphTransformer {
   const std::unordered_set<std::string> excluded_op_types_ =
       {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
 
+  /** Maximum size of a folded output that is larger than the node's constant inputs. */
+  const size_t max_output_size_in_bytes_;
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
 
+  /** Returns true if the outputs of the node are known to exceed the size budget before
+  the node is executed. */
+  bool ExceedsSizeBudget(const Node& node, size_t constant_inputs_size_in_bytes) const;
+
   /** Create a TensorProto that has the same value as the given OrtValue
   and the same type and dimensions as the given NodeArg. */
   void BuildTensorProtoForInitializer(const OrtValue& ort_value, const NodeArg& constant_node_arg,
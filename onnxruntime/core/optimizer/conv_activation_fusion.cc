@@ -54,12 +54,18 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
     std::vector<float> activation_params;
     if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Relu", {6}) &&
         !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Sigmoid", {6}) &&
-        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6})) {
+        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Tanh", {6}) &&
+        !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Gelu", {1}, kMSDomain)) {
       if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LeakyRelu", {6})) {
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "alpha")->f());
       } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Clip", {6})) {
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "min")->f());
         activation_params.push_back(graph_utils::GetNodeAttribute(next_node, "max")->f());
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "HardSigmoid", {6})) {
+        const auto* alpha_attr = graph_utils::GetNodeAttribute(next_node, "alpha");
+        const auto* beta_attr = graph_utils::GetNodeAttribute(next_node, "beta");
+        activation_params.push_back(alpha_attr == nullptr ? 0.2f : alpha_attr->f());
+        activation_params.push_back(beta_attr == nullptr ? 0.5f : beta_attr->f());
       } else {
         continue;
       }
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeMatMulFusion
+
+Transformer that replaces float MatMul and Gemm nodes whose weights are a constant 2-D initializer with
+DynamicQuantizeMatMul nodes. The weights are quantized to uint8 with a scale and zero point per column,
+the activations are quantized at run time and the product is computed by an integer GEMM that is
+followed by a fused dequantization and bias addition.
+
+Gemm nodes are converted if they do not transpose A, alpha is 1 and C is a constant bias with a value
+per column that is added with beta 1 (or ignored with beta 0).
+*/
+class DynamicQuantizeMatMulFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeMatMulFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeMatMulFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The limits of the FusedElementwise kernel.
+constexpr size_t kMaxSteps = 16;
+constexpr size_t kMaxOperands = 8;
+
+bool IsSupportedDataType(const Node& node) {
+  const auto* type = node.InputDefs()[0]->Type();
+  return type != nullptr && (*type == "tensor(float)" || *type == "tensor(float16)" || *type == "tensor(double)");
+}
+
+bool IsUnaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9});
+}
+
+bool IsBinaryOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7});
+}
+
+// Checks that the operand broadcasts to the shape of the value, so that the result has the shape of the value.
+bool IsBroadcastOperand(const NodeArg& operand, const NodeArg& value) {
+  const auto* operand_shape = operand.Shape();
+  const auto* value_shape = value.Shape();
+  if (operand_shape == nullptr || value_shape == nullptr || operand_shape->dim_size() > value_shape->dim_size()) {
+    return false;
+  }
+  const int offset = value_shape->dim_size() - operand_shape->dim_size();
+  for (int i = 0; i < operand_shape->dim_size(); i++) {
+    const auto& operand_dim = operand_shape->dim(i);
+    const auto& value_dim = value_shape->dim(offset + i);
+    if (operand_dim.has_dim_value() && operand_dim.dim_value() == 1) {
+      continue;
+    }
+    if (operand_dim.has_dim_value() && value_dim.has_dim_value() && operand_dim.dim_value() == value_dim.dim_value()) {
+      continue;
+    }
+    if (operand_dim.has_dim_param() && value_dim.has_dim_param() && operand_dim.dim_param() == value_dim.dim_param()) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+// A step of the chain: the FusedElementwise op applied to the value and, for binary ops, its operand.
+struct Step {
+  std::string op;
+  NodeArg* operand;
+};
+
+// Returns the step that applies the node to the value, or false if the node can't be fused.
+bool GetStep(const Node& node, const NodeArg& value, const std::string& provider, Step& step) {
+  if (node.GetExecutionProviderType() != provider || !IsSupportedDataType(node)) {
+    return false;
+  }
+
+  if (IsUnaryOp(node)) {
+    step = Step{node.OpType(), nullptr};
+    return node.InputDefs()[0] == &value;
+  }
+
+  if (!IsBinaryOp(node)) {
+    return false;
+  }
+  const NodeArg* operand = optimizer_utils::GetOtherInput(node, value);
+  if (operand == nullptr || !IsBroadcastOperand(*operand, value)) {
+    return false;
+  }
+  const bool reversed = node.InputDefs()[1] == &value;
+  const auto& op_type = node.OpType();
+  step = Step{reversed && (op_type == "Sub" || op_type == "Div") ? "R" + op_type : op_type,
+              const_cast<NodeArg*>(operand)};
+  return true;
+}
+
+}  // namespace
+
+/*
+Fuses chains of elementwise ops into a FusedElementwise node, which the CUDA kernel runs in a single pass over
+the data instead of one kernel launch and one round trip to memory per op:
+
+    Y = Relu(Add(Mul(X, scale), bias))  ->  Y = FusedElementwise(X, scale, bias, ops=["Mul", "Add", "Relu"])
+
+Each intermediate value of the chain must only be used by the next op, and the operands of the binary ops must
+broadcast to the shape of the value, so that every value of the chain has the shape of X.
+*/
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed by an earlier fusion
+    }
+
+    auto& first_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(first_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(first_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // The chain starts with the input of a unary op, or with the input of a binary op that has the shape of
+    // its output.
+    const std::string& provider = first_node.GetExecutionProviderType();
+    std::vector<Step> steps(1);
+    NodeArg* input = first_node.MutableInputDefs()[0];
+    if (!GetStep(first_node, *input, provider, steps[0])) {
+      if (first_node.InputDefs().size() != 2) {
+        continue;
+      }
+      input = first_node.MutableInputDefs()[1];
+      if (!GetStep(first_node, *input, provider, steps[0])) {
+        continue;
+      }
+    }
+
+    std::vector<Node*> nodes_to_remove{&first_node};
+    size_t num_operands = steps[0].operand != nullptr ? 1 : 0;
+    Node* last_node = &first_node;
+    while (steps.size() < kMaxSteps && optimizer_utils::IsFusableIntermediate(graph, *last_node)) {
+      Node& next_node = *graph.GetNode(last_node->OutputNodesBegin()->Index());
+      Step step;
+      if (!GetStep(next_node, *last_node->OutputDefs()[0], provider, step) ||
+          (step.operand != nullptr && num_operands == kMaxOperands)) {
+        break;
+      }
+      num_operands += step.operand != nullptr ? 1 : 0;
+      steps.push_back(step);
+      nodes_to_remove.push_back(&next_node);
+      last_node = &next_node;
+    }
+
+    // a single op is already a single kernel
+    if (steps.size() < 2) {
+      continue;
+    }
+
+    std::vector<NodeArg*> inputs{input};
+    std::vector<std::string> ops;
+    for (const auto& step : steps) {
+      ops.push_back(step.op);
+      if (step.operand != nullptr) {
+        inputs.push_back(step.operand);
+      }
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused elementwise ops",
+                                     inputs,
+                                     last_node->MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(provider);
+
+    optimizer_utils::RemoveFusedNodes(graph, nodes_to_remove);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
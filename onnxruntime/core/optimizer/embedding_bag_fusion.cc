@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The CPU kernel is implemented for float and the CUDA kernel for all floating point types.
+bool IsSupportedDataType(const Node& node) {
+  const auto* type = node.InputDefs()[0]->Type();
+  if (type == nullptr) {
+    return false;
+  }
+  if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    return *type == "tensor(float)";
+  }
+  return *type == "tensor(float)" || *type == "tensor(float16)" || *type == "tensor(double)";
+}
+
+bool HasRank(const NodeArg& arg, int rank) {
+  const auto* shape = arg.Shape();
+  return shape != nullptr && shape->dim_size() == rank;
+}
+
+// Checks for a ReduceSum or ReduceMean over the bag dimension of the gathered rows [num_bags, bag_size, D]
+// that drops the reduced dimension.
+bool IsBagReduction(const Node& node, const std::string& provider) {
+  if ((!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1, 11}) &&
+       !graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11})) ||
+      node.GetExecutionProviderType() != provider) {
+    return false;
+  }
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(node, "keepdims");
+  if (keepdims_attr == nullptr || keepdims_attr->i() != 0) {
+    return false;
+  }
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes.size() != 1) {
+    return false;
+  }
+  return axes[0] == 1 || axes[0] == -2;
+}
+
+}  // namespace
+
+/*
+Fuses the pooling of the embeddings of sparse features into EmbeddingBag:
+
+    Y = ReduceSum(Gather(data, indices), axes=[1], keepdims=0)
+
+where data is a 2-D table and indices holds one bag per row, so the gathered rows are never materialized.
+ReduceMean is fused into the mean mode of EmbeddingBag.
+*/
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed by an earlier fusion
+    }
+
+    auto& gather_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(gather_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather_node, "Gather", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(gather_node, GetCompatibleExecutionProviders()) ||
+        !IsSupportedDataType(gather_node) ||
+        !optimizer_utils::IsFusableIntermediate(graph, gather_node)) {
+      continue;
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(gather_node, "axis");
+    if (axis_attr != nullptr && axis_attr->i() != 0) {
+      continue;
+    }
+
+    NodeArg* data = gather_node.MutableInputDefs()[0];
+    NodeArg* indices = gather_node.MutableInputDefs()[1];
+    if (!HasRank(*data, 2) || !HasRank(*indices, 2)) {
+      continue;
+    }
+
+    const std::string& provider = gather_node.GetExecutionProviderType();
+    Node& reduce_node = *graph.GetNode(gather_node.OutputNodesBegin()->Index());
+    if (!IsBagReduction(reduce_node, provider)) {
+      continue;
+    }
+
+    // ReduceMean of an empty bag is NaN, while EmbeddingBag produces zeros.
+    const bool mean = reduce_node.OpType() == "ReduceMean";
+    const auto& bag_dim = indices->Shape()->dim(1);
+    if (mean && (!bag_dim.has_dim_value() || bag_dim.dim_value() == 0)) {
+      continue;
+    }
+
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused Gather and reduction of bags",
+                                             {data, indices},
+                                             reduce_node.MutableOutputDefs(),
+                                             nullptr,
+                                             kMSDomain);
+    embedding_bag_node.AddAttribute("mode", std::string(mean ? "mean" : "sum"));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag_node.SetExecutionProviderType(provider);
+
+    optimizer_utils::RemoveFusedNodes(graph, {&gather_node, &reduce_node});
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
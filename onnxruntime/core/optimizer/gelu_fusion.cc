@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The CPU kernel is implemented for float and the CUDA kernel for all floating point types.
+bool IsSupportedDataType(const Node& node) {
+  const auto* type = node.InputDefs()[0]->Type();
+  if (type == nullptr) {
+    return false;
+  }
+  if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    return *type == "tensor(float)";
+  }
+  return *type == "tensor(float)" || *type == "tensor(float16)" || *type == "tensor(double)";
+}
+
+bool IsCandidate(const Node& node, const std::string& op_type, int version, const std::string& provider) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, {version}) &&
+         node.GetExecutionProviderType() == provider;
+}
+
+}  // namespace
+
+/*
+Fuses the erf based GELU of transformer models into Gelu:
+
+    Y = Mul(Mul(X, 0.5), Add(Erf(Div(X, sqrt(2))), 1))
+
+The factors of the final product may be associated in any order, and X / sqrt(2) may also
+be expressed as Mul(X, 1 / sqrt(2)).
+*/
+Status GeluFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  constexpr float sqrt_two = 1.41421356237309504880f;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed by an earlier fusion
+    }
+
+    auto& scale_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(scale_node, modified, graph_level));
+
+    if ((!graph_utils::IsSupportedOptypeVersionAndDomain(scale_node, "Div", {7}) &&
+         !graph_utils::IsSupportedOptypeVersionAndDomain(scale_node, "Mul", {7})) ||
+        !graph_utils::IsSupportedProvider(scale_node, GetCompatibleExecutionProviders()) ||
+        !IsSupportedDataType(scale_node) ||
+        !optimizer_utils::IsFusableIntermediate(graph, scale_node)) {
+      continue;
+    }
+
+    // X / sqrt(2) or X * (1 / sqrt(2)), where only the multiply is commutative.
+    NodeArg* input = scale_node.MutableInputDefs()[0];
+    const NodeArg* divisor = scale_node.InputDefs()[1];
+    if (scale_node.OpType() == "Div") {
+      if (!optimizer_utils::IsScalarInitializerWithValue(graph, *divisor, sqrt_two)) {
+        continue;
+      }
+    } else if (!optimizer_utils::IsScalarInitializerWithValue(graph, *divisor, 1.0f / sqrt_two)) {
+      input = scale_node.MutableInputDefs()[1];
+      if (!optimizer_utils::IsScalarInitializerWithValue(graph, *scale_node.InputDefs()[0], 1.0f / sqrt_two)) {
+        continue;
+      }
+    }
+
+    const std::string& provider = scale_node.GetExecutionProviderType();
+
+    Node& erf_node = *graph.GetNode(scale_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(erf_node, "Erf", 9, provider) ||
+        !optimizer_utils::IsFusableIntermediate(graph, erf_node)) {
+      continue;
+    }
+
+    Node& add_node = *graph.GetNode(erf_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(add_node, "Add", 7, provider) ||
+        !optimizer_utils::IsFusableIntermediate(graph, add_node)) {
+      continue;
+    }
+    const NodeArg* one = optimizer_utils::GetOtherInput(add_node, *erf_node.OutputDefs()[0]);
+    if (one == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *one, 1.0f)) {
+      continue;
+    }
+
+    // Walk the chain of at most two multiplies that apply the factors X and 0.5, where the
+    // factor 0.5 * X may also be computed by a separate multiply of X.
+    std::vector<Node*> nodes_to_remove{&scale_node, &erf_node, &add_node};
+    bool has_input_factor = false;
+    bool has_half_factor = false;
+    bool matched = true;
+    Node* product_node = &add_node;
+
+    while (matched && !(has_input_factor && has_half_factor)) {
+      if (nodes_to_remove.size() > 3 && !optimizer_utils::IsFusableIntermediate(graph, *product_node)) {
+        matched = false;
+        break;
+      }
+
+      Node& mul_node = *graph.GetNode(product_node->OutputNodesBegin()->Index());
+      const NodeArg* factor = IsCandidate(mul_node, "Mul", 7, provider)
+                                  ? optimizer_utils::GetOtherInput(mul_node, *product_node->OutputDefs()[0])
+                                  : nullptr;
+      if (factor == nullptr) {
+        matched = false;
+        break;
+      }
+
+      if (factor == input && !has_input_factor) {
+        has_input_factor = true;
+      } else if (!has_half_factor && optimizer_utils::IsScalarInitializerWithValue(graph, *factor, 0.5f)) {
+        has_half_factor = true;
+      } else {
+        const Node* half_node = optimizer_utils::GetInputNode(mul_node, mul_node.InputDefs()[0] == factor ? 0 : 1);
+        if (has_input_factor || has_half_factor || half_node == nullptr ||
+            !IsCandidate(*half_node, "Mul", 7, provider) ||
+            !optimizer_utils::IsFusableIntermediate(graph, *half_node)) {
+          matched = false;
+          break;
+        }
+        const NodeArg* half = optimizer_utils::GetOtherInput(*half_node, *input);
+        if (half == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *half, 0.5f)) {
+          matched = false;
+          break;
+        }
+        nodes_to_remove.push_back(graph.GetNode(half_node->Index()));
+        has_input_factor = true;
+        has_half_factor = true;
+      }
+
+      nodes_to_remove.push_back(&mul_node);
+      product_node = &mul_node;
+    }
+
+    if (!matched) {
+      continue;
+    }
+
+    Node& gelu_node = graph.AddNode(graph.GenerateNodeName("Gelu"),
+                                    "Gelu",
+                                    "fused Gelu subgraph",
+                                    {input},
+                                    product_node->MutableOutputDefs(),
+                                    nullptr,
+                                    kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    gelu_node.SetExecutionProviderType(provider);
+
+    optimizer_utils::RemoveFusedNodes(graph, nodes_to_remove);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -15,7 +15,10 @@ bool IsFusableActivation(const Node& node) {
   return graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
-         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6});
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         // only the CPU FusedGemm applies Gelu, in the MLAS epilogue
+         (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) &&
+          node.GetExecutionProviderType() == kCpuExecutionProvider);
 }
 
 void HandleActivationNodeEdges(Graph& g, const Node& act, Node& fused_gemm) {
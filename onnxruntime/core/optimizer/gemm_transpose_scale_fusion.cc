@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/gemm_transpose_scale_fusion.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatMatrix(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  return type != nullptr && type->tensor_type().elem_type() == TensorProto_DataType_FLOAT &&
+         shape != nullptr && shape->dim_size() == 2;
+}
+
+// Returns the node that produces the given input of the node if the
+// connecting edge is the only use of that output.
+Node* GetExclusiveInputNode(Graph& graph, const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() != input_index) {
+      continue;
+    }
+    const Node& input_node = it->GetNode();
+    if (input_node.GetOutputEdgesCount() != 1 ||
+        graph.IsNodeOutputsInGraphOutputs(input_node) ||
+        input_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+      return nullptr;
+    }
+    return graph.GetNode(input_node.Index());
+  }
+  return nullptr;
+}
+
+// Returns true if the node is a Transpose that swaps the two dimensions of a
+// float matrix.
+bool IsMatrixTranspose(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) ||
+      !IsFloatMatrix(*node.InputDefs()[0])) {
+    return false;
+  }
+  // The default permutation reverses the dimensions.
+  std::vector<int64_t> perm;
+  return !graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm) ||
+         (perm.size() == 2 && perm[0] == 1 && perm[1] == 0);
+}
+
+// Returns the value of the scalar float constant that scales the given output
+// of the Mul or Div node, or false if the node is not such a scaling node.
+bool GetScaleFactor(const Graph& graph, const Node& node, const NodeArg& scaled_arg, float& scale) {
+  const bool is_mul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7});
+  const bool is_div = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7});
+  if (!is_mul && !is_div) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  int scale_index;
+  if (input_defs[0] == &scaled_arg) {
+    scale_index = 1;
+  } else if (is_mul && input_defs[1] == &scaled_arg) {
+    scale_index = 0;
+  } else {
+    return false;
+  }
+
+  // The scale must not broadcast the matrix to a higher rank.
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_defs[scale_index]->Name());
+  if (tensor_proto == nullptr ||
+      tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      tensor_proto->dims_size() > 2) {
+    return false;
+  }
+
+  Initializer initializer{tensor_proto};
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  scale = initializer.data<float>()[0];
+  if (is_div) {
+    if (scale == 0.0f) {
+      return false;
+    }
+    scale = 1.0f / scale;
+  }
+  return true;
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : default_value;
+}
+
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->f() : default_value;
+}
+
+void RemoveFusedNode(Graph& graph, Node& node) {
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+}
+
+// Replaces the Transpose of a constant matrix that feeds the node with the
+// transposed initializer.
+bool FoldConstantTranspose(Graph& graph, Node& node, int input_index) {
+  Node* transpose_node = GetExclusiveInputNode(graph, node, input_index);
+  if (transpose_node == nullptr || !IsMatrixTranspose(*transpose_node)) {
+    return false;
+  }
+
+  const auto& weights_name = transpose_node->InputDefs()[0]->Name();
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, weights_name);
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  Initializer initializer{tensor_proto};
+  const auto rows = initializer.dims()[0];
+  const auto columns = initializer.dims()[1];
+  const float* input_data = initializer.data<float>();
+
+  TensorProto transposed_tensor_proto;
+  transposed_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  transposed_tensor_proto.set_name(graph.GenerateNodeArgName(weights_name + "_transposed"));
+  transposed_tensor_proto.add_dims(columns);
+  transposed_tensor_proto.add_dims(rows);
+  for (int64_t c = 0; c < columns; c++) {
+    for (int64_t r = 0; r < rows; r++) {
+      transposed_tensor_proto.add_float_data(input_data[r * columns + c]);
+    }
+  }
+  graph.AddInitializedTensor(transposed_tensor_proto);
+
+  // Reuse the type and shape of the Transpose output.
+  auto& transposed_arg = graph.GetOrCreateNodeArg(transposed_tensor_proto.name(),
+                                                  transpose_node->OutputDefs()[0]->TypeAsProto());
+  node.MutableInputDefs()[input_index] = &transposed_arg;
+
+  RemoveFusedNode(graph, *transpose_node);
+  return true;
+}
+
+}  // namespace
+
+Status GemmTransposeScaleFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // Zero bias shared by the Gemm nodes created from MatMul nodes. Gemm requires
+  // the C input before opset 11.
+  NodeArg* zero_bias_arg = nullptr;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr) {
+      continue;  // node was removed as part of an earlier fusion
+    }
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9});
+    if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto& input_defs = node.InputDefs();
+    if (!is_gemm && !IsFloatMatrix(*input_defs[0])) {
+      // The MatMul cannot be expressed as a Gemm, but a constant transposed
+      // weight can still be folded into the initializer.
+      if (IsFloatMatrix(*input_defs[1]) && FoldConstantTranspose(graph, node, 1)) {
+        modified = true;
+      }
+      continue;
+    }
+    if (!IsFloatMatrix(*input_defs[0]) || !IsFloatMatrix(*input_defs[1])) {
+      continue;
+    }
+
+    int64_t trans_a = is_gemm ? GetIntAttribute(node, "transA", 0) : 0;
+    int64_t trans_b = is_gemm ? GetIntAttribute(node, "transB", 0) : 0;
+    float alpha = is_gemm ? GetFloatAttribute(node, "alpha", 1.0f) : 1.0f;
+    float beta = is_gemm ? GetFloatAttribute(node, "beta", 1.0f) : 0.0f;
+
+    std::vector<NodeArg*> gemm_input_defs = node.MutableInputDefs();
+    std::vector<Node*> fused_nodes;
+
+    Node* transpose_a = GetExclusiveInputNode(graph, node, 0);
+    if (transpose_a != nullptr && IsMatrixTranspose(*transpose_a)) {
+      gemm_input_defs[0] = transpose_a->MutableInputDefs()[0];
+      trans_a ^= 1;
+      fused_nodes.push_back(transpose_a);
+    }
+
+    Node* transpose_b = GetExclusiveInputNode(graph, node, 1);
+    if (transpose_b != nullptr && IsMatrixTranspose(*transpose_b)) {
+      gemm_input_defs[1] = transpose_b->MutableInputDefs()[0];
+      trans_b ^= 1;
+      fused_nodes.push_back(transpose_b);
+    }
+
+    // (alpha * A * B + beta * C) * scale == (alpha * scale) * A * B + (beta * scale) * C
+    std::vector<NodeArg*> gemm_output_defs = node.MutableOutputDefs();
+    Node* scale_node = nullptr;
+    float scale = 1.0f;
+    if (node.GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(node)) {
+      const Node& next_node = *node.OutputNodesBegin();
+      if (next_node.GetExecutionProviderType() == node.GetExecutionProviderType() &&
+          GetScaleFactor(graph, next_node, *gemm_output_defs[0], scale)) {
+        alpha *= scale;
+        beta *= scale;
+        scale_node = graph.GetNode(next_node.Index());
+        gemm_output_defs = scale_node->MutableOutputDefs();
+      }
+    }
+
+    if (fused_nodes.empty() && scale_node == nullptr) {
+      continue;
+    }
+
+    if (!is_gemm) {
+      if (zero_bias_arg == nullptr) {
+        TensorProto zero_bias;
+        zero_bias.set_data_type(TensorProto_DataType_FLOAT);
+        zero_bias.set_name(graph.GenerateNodeArgName("gemm_zero_bias"));
+        zero_bias.add_dims(1);
+        zero_bias.add_float_data(0.0f);
+        graph.AddInitializedTensor(zero_bias);
+
+        TypeProto zero_bias_type;
+        zero_bias_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+        zero_bias_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+        zero_bias_arg = &graph.GetOrCreateNodeArg(zero_bias.name(), &zero_bias_type);
+      }
+      gemm_input_defs.push_back(zero_bias_arg);
+    }
+
+    Node& gemm_node = graph.AddNode(graph.GenerateNodeName("gemm"),
+                                    "Gemm",
+                                    "fused " + node.OpType() + " with Transpose and scale",
+                                    gemm_input_defs,
+                                    gemm_output_defs);
+    gemm_node.AddAttribute("transA", trans_a);
+    gemm_node.AddAttribute("transB", trans_b);
+    gemm_node.AddAttribute("alpha", alpha);
+    gemm_node.AddAttribute("beta", beta);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    gemm_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (Node* fused_node : fused_nodes) {
+      RemoveFusedNode(graph, *fused_node);
+    }
+    RemoveFusedNode(graph, node);
+    if (scale_node != nullptr) {
+      RemoveFusedNode(graph, *scale_node);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
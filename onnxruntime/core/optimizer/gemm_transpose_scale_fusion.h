@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmTransposeScaleFusion
+
+Transformer that absorbs the Transpose nodes of the 2-D inputs of MatMul and Gemm nodes into the
+transA/transB attributes of a Gemm node, and a following Mul or Div by a scalar constant into its
+alpha/beta attributes. MatMul nodes are only converted to Gemm if there is something to absorb.
+
+The Transpose of a constant weight feeding a MatMul that cannot be converted to Gemm, for example
+because the other input has more than two dimensions, is folded into a transposed initializer.
+*/
+class GemmTransposeScaleFusion : public GraphTransformer {
+ public:
+  GemmTransposeScaleFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmTransposeScaleFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
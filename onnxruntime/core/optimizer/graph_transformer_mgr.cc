@@ -14,12 +14,27 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  // A transformer that ran without modifying the graph has nothing to do until another transformer
+  // modifies the graph, so it is skipped until then. clean_at stores the number of graph
+  // modifications at the time each transformer last ran without modifying the graph.
+  const auto& level_transformers = transformers->second;
+  std::vector<int64_t> clean_at(level_transformers.size(), -1);
+  int64_t num_modifications = 0;
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < level_transformers.size(); ++i) {
+      if (clean_at[i] == num_modifications) {
+        continue;
+      }
       bool modified = false;
-      ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified));
-      graph_changed = graph_changed || modified;
+      ORT_RETURN_IF_ERROR(level_transformers[i]->Apply(graph, modified));
+      if (modified) {
+        ++num_modifications;
+        graph_changed = true;
+      } else {
+        clean_at[i] = num_modifications;
+      }
     }
     if (!graph_changed) {
       break;
@@ -8,15 +8,27 @@
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/gemm_transpose_scale_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/zipmap_elimination.h"
+#include "core/optimizer/scaler_linear_fusion.h"
 #include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
@@ -38,6 +50,7 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
       rules.push_back(std::make_unique<EliminateDropout>());
       rules.push_back(std::make_unique<FuseReluClip>());
       rules.push_back(std::make_unique<ShapeToInitializer>());
+      rules.push_back(std::make_unique<ScalerLinearFusion>());
       break;
 
     case TransformerLevel::Level2:
@@ -87,14 +100,27 @@ std::unique_ptr<RuleBasedGraphTransformer> GenerateRuleBasedGraphTransformer(Tra
 }
 
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
-                                                                    const std::vector<std::string>& transformers_and_rules_to_enable) {
+                                                                    const std::vector<std::string>& transformers_and_rules_to_enable,
+                                                                    size_t constant_folding_max_output_size_in_bytes,
+                                                                    bool enable_dynamic_quantization,
+                                                                    float nchwc_min_isolated_conv_flops_per_reorder,
+                                                                    bool enable_zipmap_elimination,
+                                                                    int weight_only_quantization_bits,
+                                                                    int weight_only_quantization_block_size) {
   std::vector<std::unique_ptr<GraphTransformer>> transformers;
   std::unique_ptr<RuleBasedGraphTransformer> rule_transformer = nullptr;
   switch (level) {
     case TransformerLevel::Level1: {
       std::unordered_set<std::string> l1_execution_providers = {};
 
-      transformers.emplace_back(std::make_unique<ConstantFolding>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<ConstantFolding>(l1_execution_providers,
+                                                                  constant_folding_max_output_size_in_bytes));
+      transformers.emplace_back(std::make_unique<CommonSubexpressionElimination>(l1_execution_providers));
+
+      // changes the type of graph outputs, so the caller has to ask for it
+      if (enable_zipmap_elimination) {
+        transformers.emplace_back(std::make_unique<ZipMapElimination>(l1_execution_providers));
+      }
 
       rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l1_execution_providers);
     } break;
@@ -107,17 +133,57 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
 
       // create standalone transformers
 #ifndef DISABLE_CONTRIB_OPS
-      transformers.emplace_back(std::make_unique<GemmActivationFusion>(l2_execution_providers));
-      transformers.emplace_back(std::make_unique<MatMulAddFusion>(l2_execution_providers));
+      // CUDA runs Gemm and FusedGemm with the bias and Relu in the epilogue of the multiplication, so MatMul + Add
+      // is fused into a Gemm before the activation following it is
+      std::unordered_set<std::string> cpu_cuda_execution_providers = {onnxruntime::kCpuExecutionProvider,
+                                                                      onnxruntime::kCudaExecutionProvider};
+      transformers.emplace_back(std::make_unique<MatMulAddFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<GemmTransposeScaleFusion>(l2_execution_providers));
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(l2_execution_providers));
+
+      // the transformer block fusions replace subgraphs with contrib ops that are also implemented by CUDA,
+      // except for the attention op which is implemented only by CPU
+      transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<AttentionFusion>(l2_execution_providers));
+
+      // pool the embeddings of sparse features without materializing the gathered rows
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(cpu_cuda_execution_providers));
+
+      // fuse the elementwise chains the fusions above leave, which only CUDA runs with a single kernel
+      std::unordered_set<std::string> cuda_execution_providers = {onnxruntime::kCudaExecutionProvider};
+      transformers.emplace_back(std::make_unique<ElementwiseFusion>(cuda_execution_providers));
+
+      // quantize the weights last so that the fusions above still see the float MatMul and Gemm nodes.
+      // the weight only quantization goes first since it keeps the activations in float.
+      if (weight_only_quantization_bits != 0) {
+        ORT_ENFORCE(weight_only_quantization_bits == 4 || weight_only_quantization_bits == 8,
+                    "weight_only_quantization_bits must be 0, 4 or 8");
+        ORT_ENFORCE(weight_only_quantization_block_size >= 16 &&
+                        (weight_only_quantization_block_size & (weight_only_quantization_block_size - 1)) == 0,
+                    "weight_only_quantization_block_size must be a power of 2 and at least 16");
+        transformers.emplace_back(std::make_unique<MatMulNBitsQuantization>(weight_only_quantization_bits,
+                                                                            weight_only_quantization_block_size,
+                                                                            l2_execution_providers));
+      }
+      if (enable_dynamic_quantization) {
+        transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(l2_execution_providers));
+      }
 #endif
     } break;
 
     case TransformerLevel::Level3: {
+      std::unordered_set<std::string> l3_execution_providers = {onnxruntime::kCpuExecutionProvider};
+
+      // Cancel the Transpose nodes around layout sensitive nodes before the
+      // NCHWc transformer converts the graph.
+      transformers.emplace_back(std::make_unique<TransposeOptimizer>(l3_execution_providers));
+
 #ifndef DISABLE_CONTRIB_OPS
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
-        transformers.emplace_back(std::make_unique<NchwcTransformer>());
+        transformers.emplace_back(std::make_unique<NchwcTransformer>(nchwc_min_isolated_conv_flops_per_reorder));
       }
 #endif
 
@@ -2,7 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/initializer.h"
 #include "core/framework/data_types.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
@@ -61,8 +66,16 @@ static bool IsInputFloat16(const onnxruntime::Node& node) {
   return false;
 }
 
+// Operators whose CPU kernels compute in float16 directly, so an isolated float16 node is cheaper
+// left as is than surrounded by casts.
+static bool HasCPUFloat16Kernel(const onnxruntime::Node& node) {
+  const auto& op_type = node.OpType();
+  return node.Domain() == kOnnxDomain && (op_type == "MatMul" || op_type == "Gemm" || op_type == "Conv");
+}
+
 static bool IsSingleInputNodeFloat16Node(const onnxruntime::Node& node) {
-  if (IsInputFloat16(node) && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+  if (IsInputFloat16(node) && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+      !HasCPUFloat16Kernel(node)) {
     for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
       if (IsInputFloat16(*it))
         return false;
@@ -91,6 +104,179 @@ Status ForceSingleNodeCPUFloat16ToFloat32(onnxruntime::Graph& graph) {
   return Status::OK();
 }
 
+static bool IsFloatTensor(const onnxruntime::NodeArg& arg) {
+  return arg.Exists() && arg.TypeAsProto() != nullptr && arg.TypeAsProto()->has_tensor_type() &&
+         arg.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// The GEMMs and convolutions, computed on the Tensor Cores with float accumulation, are worth converting wherever
+// they are. The element-wise ops and the ones that only move data are converted when they use the result of a
+// converted node, so that they don't add Casts around an otherwise float part of the graph.
+// Softmax, the reductions and the normalizations aren't listed: they accumulate over many values in the type of
+// their input.
+static bool IsCudaFloat16ComputeOp(const onnxruntime::Node& node) {
+  static const std::unordered_set<std::string> ops{"Conv", "ConvTranspose", "Gemm", "MatMul"};
+  return node.Domain() == kOnnxDomain && ops.count(node.OpType()) != 0;
+}
+
+static bool IsCudaFloat16FollowerOp(const onnxruntime::Node& node) {
+  static const std::unordered_set<std::string> ops{
+      "Relu", "LeakyRelu", "Sigmoid", "Tanh", "Add", "Sub", "Mul", "MaxPool", "AveragePool", "GlobalMaxPool",
+      "Transpose", "Concat", "Reshape", "Flatten", "Squeeze", "Unsqueeze", "Identity"};
+  if (node.Domain() == kOnnxDomain) {
+    return ops.count(node.OpType()) != 0;
+  }
+
+  // the chains fused by ElementwiseFusion, if all their steps are listed
+  static const std::unordered_set<std::string> fused_ops{"Relu", "Sigmoid", "Tanh", "Neg", "Abs", "Add", "Sub",
+                                                          "RSub", "Mul"};
+  if (node.Domain() != kMSDomain || node.OpType() != "FusedElementwise") {
+    return false;
+  }
+  const auto& attributes = node.GetAttributes();
+  const auto it = attributes.find("ops");
+  return it != attributes.end() &&
+         std::all_of(it->second.strings().begin(), it->second.strings().end(),
+                     [](const std::string& op) { return fused_ops.count(op) != 0; });
+}
+
+static onnxruntime::NodeArg& AddFloat16Initializer(onnxruntime::Graph& graph, const TensorProto& float_tensor_proto) {
+  Initializer initializer{&float_tensor_proto};
+  const float* data = initializer.data<float>();
+  std::vector<uint16_t> float16_data(static_cast<size_t>(initializer.size()));
+  for (size_t i = 0; i < float16_data.size(); ++i) {
+    float16_data[i] = math::floatToHalf(data[i]);
+  }
+
+  TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(float_tensor_proto.name() + "_fp16"));
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT16);
+  *tensor_proto.mutable_dims() = float_tensor_proto.dims();
+  tensor_proto.set_raw_data(float16_data.data(), float16_data.size() * sizeof(uint16_t));
+  graph.AddInitializedTensor(tensor_proto);
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  for (auto dim : tensor_proto.dims()) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return graph.GetOrCreateNodeArg(tensor_proto.name(), &type);
+}
+
+// Converts the float nodes of the CUDA execution provider listed above to float16. The values of converted nodes
+// that are only used by converted nodes become float16; the others are cast back to float for their other users,
+// and the float inputs of converted nodes are cast to float16 once each, or converted if they are constant.
+static Status ConvertCudaNodesToFloat16(onnxruntime::Graph& graph, IdGenerator& id_generator, bool& modified) {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::unordered_set<onnxruntime::NodeIndex> converted_nodes;
+  std::unordered_set<const onnxruntime::NodeArg*> converted_outputs;
+  for (onnxruntime::NodeIndex i : order) {
+    const auto& node = *graph.GetNode(i);
+    if (node.GetExecutionProviderType() != kCudaExecutionProvider) {
+      continue;
+    }
+
+    bool has_float_input = false;
+    bool uses_converted_output = false;
+    for (const auto* input : node.InputDefs()) {
+      has_float_input = has_float_input || IsFloatTensor(*input);
+      uses_converted_output = uses_converted_output || converted_outputs.count(input) != 0;
+    }
+    if (!has_float_input ||
+        !(IsCudaFloat16ComputeOp(node) || (IsCudaFloat16FollowerOp(node) && uses_converted_output))) {
+      continue;
+    }
+
+    converted_nodes.insert(i);
+    for (const auto* output : node.OutputDefs()) {
+      if (IsFloatTensor(*output)) {
+        converted_outputs.insert(output);
+      }
+    }
+  }
+
+  if (converted_nodes.empty()) {
+    return Status::OK();
+  }
+
+  TypeProto float_16_tensor_proto;
+  float_16_tensor_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  const auto& graph_outputs = graph.GetOutputs();
+
+  // the float16 value the converted nodes use in place of each float value
+  std::unordered_map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> float16_args;
+  for (onnxruntime::NodeIndex i : order) {
+    if (converted_nodes.count(i) == 0) {
+      continue;
+    }
+
+    auto& node = *graph.GetNode(i);
+    auto& outputs = node.MutableOutputDefs();
+    std::vector<bool> used_as_float(outputs.size(), false);
+    for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+      if (converted_nodes.count(it->GetNode().Index()) == 0) {
+        used_as_float[it->GetSrcArgIndex()] = true;
+      }
+    }
+
+    std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> replacement_defs;
+    for (size_t j = 0; j < outputs.size(); ++j) {
+      auto* output = outputs[j];
+      if (!IsFloatTensor(*output)) {
+        continue;
+      }
+
+      if (used_as_float[j] || std::find(graph_outputs.cbegin(), graph_outputs.cend(), output) != graph_outputs.cend()) {
+        auto* float16_arg = AddCastNode(graph,
+                                        id_generator,
+                                        output,
+                                        &float_16_tensor_proto,
+                                        true,
+                                        static_cast<int64_t>(TensorProto_DataType_FLOAT),
+                                        onnxruntime::kCudaExecutionProvider);
+        replacement_defs[output] = float16_arg;
+        float16_args[output] = float16_arg;
+      } else {
+        TypeProto type = *output->TypeAsProto();
+        type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+        output->SetType(type);
+        float16_args[output] = output;
+      }
+    }
+
+    for (auto* input : node.MutableInputDefs()) {
+      auto it = float16_args.find(input);
+      if (it == float16_args.end()) {
+        if (!IsFloatTensor(*input)) {
+          continue;
+        }
+
+        const auto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false);
+        auto* float16_arg = initializer != nullptr
+                                ? &AddFloat16Initializer(graph, *initializer)
+                                : AddCastNode(graph,
+                                              id_generator,
+                                              input,
+                                              &float_16_tensor_proto,
+                                              false,
+                                              static_cast<int64_t>(TensorProto_DataType_FLOAT16),
+                                              onnxruntime::kCudaExecutionProvider);
+        it = float16_args.emplace(input, float16_arg).first;
+      }
+      if (it->second != input) {
+        replacement_defs[input] = it->second;
+      }
+    }
+
+    node.ReplaceDefs(replacement_defs);
+  }
+
+  modified = true;
+  return Status::OK();
+}
+
 /** Transformer to remove duplicate Cast nodes. */
 class RemoveDuplicateCastTransformer : public GraphTransformer {
  public:
@@ -162,6 +348,10 @@ class RemoveDuplicateCastTransformer : public GraphTransformer {
 };
 
 Status InsertCastTransformer::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const {
+  IdGenerator id_generator;
+  if (cuda_float16_)
+    ORT_RETURN_IF_ERROR(ConvertCudaNodesToFloat16(graph, id_generator, modified));
+
   if (force_cpu_fp32_)
     ORT_RETURN_IF_ERROR(ForceSingleNodeCPUFloat16ToFloat32(graph));
 
@@ -171,7 +361,6 @@ Status InsertCastTransformer::ApplyImpl(onnxruntime::Graph& graph, bool& modifie
   TypeProto float_tensor_proto;
   float_16_tensor_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
   float_tensor_proto.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
-  IdGenerator id_generator;
   std::map<onnxruntime::NodeArg*, onnxruntime::NodeArg*> input_def_updates;
   for (onnxruntime::NodeIndex i : order) {
     auto node = graph.GetNode(i);
@@ -12,13 +12,16 @@ namespace onnxruntime {
 /**
 @Class InsertCastTransformer
 
-Transformer to insert cast node that casts float16 to float for cpu nodes
+Transformer to insert cast node that casts float16 to float for cpu nodes.
+With cuda_float16, it first converts the float nodes assigned to the CUDA execution provider whose ops are
+numerically safe in float16 to float16, and casts the values they share with the other nodes.
 */
 class InsertCastTransformer : public onnxruntime::GraphTransformer {
  public:
-  InsertCastTransformer(const std::string& name)
+  InsertCastTransformer(const std::string& name, bool cuda_float16 = false)
       : onnxruntime::GraphTransformer(name),
-        force_cpu_fp32_(true) {
+        force_cpu_fp32_(true),
+        cuda_float16_(cuda_float16) {
   }
 
  private:
@@ -31,5 +34,9 @@ class InsertCastTransformer : public onnxruntime::GraphTransformer {
   // A better solution is to have a cost model to evaluate does it works to place the node on float16.
   // Here for simplify, we only force the single-node-float16 sub-graph to float32
   bool force_cpu_fp32_;
+
+  // Softmax, the reductions and the normalizations accumulate over many values and stay in float, as do the ops
+  // that aren't listed in ConvertCudaNodesToFloat16.
+  bool cuda_float16_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The CPU kernel is implemented for float and the CUDA kernel for all floating point types.
+bool IsSupportedDataType(const Node& node) {
+  const auto* type = node.InputDefs()[0]->Type();
+  if (type == nullptr) {
+    return false;
+  }
+  if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    return *type == "tensor(float)";
+  }
+  return *type == "tensor(float)" || *type == "tensor(float16)" || *type == "tensor(double)";
+}
+
+// Checks for a ReduceMean over the last axis of its input that keeps the reduced dimension.
+bool IsLastAxisReduceMean(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1})) {
+    return false;
+  }
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(node, "keepdims");
+  if (keepdims_attr != nullptr && keepdims_attr->i() != 1) {
+    return false;
+  }
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes.size() != 1) {
+    return false;
+  }
+  return optimizer_utils::IsLastAxis(*node.InputDefs()[0], axes[0]);
+}
+
+// Checks whether the node is a supported elementwise op on the same provider as the fusion.
+bool IsCandidate(const Node& node, const std::string& op_type, int version, const std::string& provider) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, {version}) &&
+         node.GetExecutionProviderType() == provider;
+}
+
+// Checks whether the affine parameter is a 1-D tensor with the size of the normalized dimension.
+bool IsAffineParameter(const NodeArg& param, const NodeArg& input) {
+  const auto* param_shape = param.Shape();
+  const auto* input_shape = input.Shape();
+  if (param_shape == nullptr || input_shape == nullptr ||
+      param_shape->dim_size() != 1 || input_shape->dim_size() < 1) {
+    return false;
+  }
+  const auto& param_dim = param_shape->dim(0);
+  const auto& input_dim = input_shape->dim(input_shape->dim_size() - 1);
+  return param_dim.has_dim_value() && input_dim.has_dim_value() && param_dim.dim_value() == input_dim.dim_value();
+}
+
+}  // namespace
+
+/*
+Fuses the decomposed layer normalization of transformer models into LayerNormalization:
+
+    mean = ReduceMean(X, axes=[-1])
+    D = Sub(X, mean)
+    variance = ReduceMean(Pow(D, 2), axes=[-1])
+    Y = Add(Mul(Div(D, Sqrt(Add(variance, epsilon))), Scale), B)
+
+The final Add is optional.
+*/
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed by an earlier fusion
+    }
+
+    auto& mean_node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(mean_node, modified, graph_level));
+
+    if (!IsLastAxisReduceMean(mean_node) ||
+        !graph_utils::IsSupportedProvider(mean_node, GetCompatibleExecutionProviders()) ||
+        !IsSupportedDataType(mean_node) ||
+        !optimizer_utils::IsFusableIntermediate(graph, mean_node)) {
+      continue;
+    }
+
+    const std::string& provider = mean_node.GetExecutionProviderType();
+    NodeArg* input = mean_node.MutableInputDefs()[0];
+
+    // Sub(X, mean) feeds both the variance and the normalization.
+    Node& sub_node = *graph.GetNode(mean_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(sub_node, "Sub", 7, provider) ||
+        sub_node.InputDefs()[0] != input ||
+        sub_node.InputDefs()[1] != mean_node.OutputDefs()[0] ||
+        !optimizer_utils::IsFusableIntermediate(graph, sub_node, 2)) {
+      continue;
+    }
+
+    Node* pow_node = nullptr;
+    Node* div_node = nullptr;
+    for (auto it = sub_node.OutputNodesBegin(); it != sub_node.OutputNodesEnd(); ++it) {
+      Node* consumer = graph.GetNode(it->Index());
+      if (IsCandidate(*consumer, "Pow", 7, provider)) {
+        pow_node = consumer;
+      } else if (IsCandidate(*consumer, "Div", 7, provider)) {
+        div_node = consumer;
+      }
+    }
+    if (pow_node == nullptr || div_node == nullptr ||
+        pow_node->InputDefs()[0] != sub_node.OutputDefs()[0] ||
+        !optimizer_utils::IsScalarInitializerWithValue(graph, *pow_node->InputDefs()[1], 2.0f) ||
+        !optimizer_utils::IsFusableIntermediate(graph, *pow_node) ||
+        div_node->InputDefs()[0] != sub_node.OutputDefs()[0] ||
+        !optimizer_utils::IsFusableIntermediate(graph, *div_node)) {
+      continue;
+    }
+
+    Node& variance_node = *graph.GetNode(pow_node->OutputNodesBegin()->Index());
+    if (!IsLastAxisReduceMean(variance_node) ||
+        variance_node.GetExecutionProviderType() != provider ||
+        !optimizer_utils::IsFusableIntermediate(graph, variance_node)) {
+      continue;
+    }
+
+    float epsilon;
+    Node& epsilon_node = *graph.GetNode(variance_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(epsilon_node, "Add", 7, provider) ||
+        !optimizer_utils::IsFusableIntermediate(graph, epsilon_node)) {
+      continue;
+    }
+    const NodeArg* epsilon_arg = optimizer_utils::GetOtherInput(epsilon_node, *variance_node.OutputDefs()[0]);
+    if (epsilon_arg == nullptr || !optimizer_utils::GetScalarInitializerValue(graph, *epsilon_arg, epsilon)) {
+      continue;
+    }
+
+    Node& sqrt_node = *graph.GetNode(epsilon_node.OutputNodesBegin()->Index());
+    if (!IsCandidate(sqrt_node, "Sqrt", 6, provider) ||
+        !optimizer_utils::IsFusableIntermediate(graph, sqrt_node) ||
+        sqrt_node.OutputNodesBegin()->Index() != div_node->Index() ||
+        div_node->InputDefs()[1] != sqrt_node.OutputDefs()[0]) {
+      continue;
+    }
+
+    Node& scale_node = *graph.GetNode(div_node->OutputNodesBegin()->Index());
+    if (!IsCandidate(scale_node, "Mul", 7, provider)) {
+      continue;
+    }
+    NodeArg* scale = const_cast<NodeArg*>(optimizer_utils::GetOtherInput(scale_node, *div_node->OutputDefs()[0]));
+    if (scale == nullptr || !IsAffineParameter(*scale, *input)) {
+      continue;
+    }
+
+    std::vector<Node*> nodes_to_remove{&mean_node, &sub_node, pow_node, &variance_node, &epsilon_node,
+                                       &sqrt_node, div_node, &scale_node};
+    std::vector<NodeArg*> fused_inputs{input, scale};
+    Node* output_node = &scale_node;
+
+    // Fold the bias when the scaled output feeds only an Add of a matching 1-D tensor.
+    if (optimizer_utils::IsFusableIntermediate(graph, scale_node)) {
+      Node& bias_node = *graph.GetNode(scale_node.OutputNodesBegin()->Index());
+      if (IsCandidate(bias_node, "Add", 7, provider)) {
+        NodeArg* bias = const_cast<NodeArg*>(optimizer_utils::GetOtherInput(bias_node, *scale_node.OutputDefs()[0]));
+        if (bias != nullptr && IsAffineParameter(*bias, *input)) {
+          fused_inputs.push_back(bias);
+          nodes_to_remove.push_back(&bias_node);
+          output_node = &bias_node;
+        }
+      }
+    }
+
+    Node& layer_norm_node = graph.AddNode(graph.GenerateNodeName("LayerNormalization"),
+                                          "LayerNormalization",
+                                          "fused LayerNormalization subgraph",
+                                          fused_inputs,
+                                          output_node->MutableOutputDefs(),
+                                          nullptr,
+                                          kMSDomain);
+    layer_norm_node.AddAttribute("axis", static_cast<int64_t>(-1));
+    layer_norm_node.AddAttribute("epsilon", epsilon);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm_node.SetExecutionProviderType(provider);
+
+    optimizer_utils::RemoveFusedNodes(graph, nodes_to_remove);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
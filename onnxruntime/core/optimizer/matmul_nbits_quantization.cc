@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : default_value;
+}
+
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->f() : default_value;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// Returns the constant float 1-D bias of the Gemm node with a value for each of
+// the N columns, or nullptr if C is anything else.
+const TensorProto* GetGemmBias(const Graph& graph, const Node& node, int64_t N) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[2]->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+  const auto& dims = tensor_proto->dims();
+  if ((dims.size() == 1 && dims[0] == N) || (dims.size() == 2 && dims[0] == 1 && dims[1] == N)) {
+    return tensor_proto;
+  }
+  return nullptr;
+}
+
+NodeArg& AddInitializer(Graph& graph, TensorProto& tensor_proto, const std::string& name) {
+  tensor_proto.set_name(graph.GenerateNodeArgName(name));
+  graph.AddInitializedTensor(tensor_proto);
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(tensor_proto.data_type());
+  for (auto dim : tensor_proto.dims()) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return graph.GetOrCreateNodeArg(tensor_proto.name(), &type);
+}
+
+}  // namespace
+
+Status MatMulNBitsQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr) {
+      continue;  // node was removed as part of an earlier fusion
+    }
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9});
+    if ((!is_gemm && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto& input_defs = node.InputDefs();
+    if (!IsFloatTensor(*input_defs[0])) {
+      continue;
+    }
+
+    const auto* weights_tensor_proto = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+    if (weights_tensor_proto == nullptr ||
+        weights_tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weights_tensor_proto->dims_size() != 2) {
+      continue;
+    }
+
+    const int64_t trans_b = is_gemm ? GetIntAttribute(node, "transB", 0) : 0;
+    const int64_t K = weights_tensor_proto->dims(trans_b ? 1 : 0);
+    const int64_t N = weights_tensor_proto->dims(trans_b ? 0 : 1);
+    if (K == 0 || N == 0) {
+      continue;
+    }
+
+    const TensorProto* bias_tensor_proto = nullptr;
+    if (is_gemm) {
+      if (GetIntAttribute(node, "transA", 0) != 0 || GetFloatAttribute(node, "alpha", 1.0f) != 1.0f) {
+        continue;
+      }
+      const float beta = GetFloatAttribute(node, "beta", 1.0f);
+      if (beta != 0.0f) {
+        bias_tensor_proto = GetGemmBias(graph, node, N);
+        if (beta != 1.0f || bias_tensor_proto == nullptr) {
+          continue;
+        }
+      }
+    }
+
+    Initializer weights{weights_tensor_proto};
+    const float* weights_data = weights.data<float>();
+
+    // MLAS quantizes a K x N matrix, so a transposed B is transposed back first.
+    std::vector<float> transposed_weights;
+    if (trans_b) {
+      transposed_weights.resize(static_cast<size_t>(K * N));
+      for (int64_t n = 0; n < N; n++) {
+        for (int64_t k = 0; k < K; k++) {
+          transposed_weights[k * N + n] = weights_data[n * K + k];
+        }
+      }
+      weights_data = transposed_weights.data();
+    }
+
+    const int64_t block_count = (K + block_size_ - 1) / block_size_;
+    std::vector<uint8_t> quantized_weights(static_cast<size_t>(N * block_count * block_size_ * bits_ / 8));
+    std::vector<float> scales(static_cast<size_t>(N * block_count));
+    MlasQuantizeBlockwise(static_cast<size_t>(N), static_cast<size_t>(K), static_cast<size_t>(bits_),
+                          static_cast<size_t>(block_size_), weights_data, static_cast<size_t>(N),
+                          quantized_weights.data(), scales.data());
+
+    const auto& weights_name = weights_tensor_proto->name();
+
+    TensorProto quantized_weights_tensor_proto;
+    quantized_weights_tensor_proto.set_data_type(TensorProto_DataType_UINT8);
+    quantized_weights_tensor_proto.add_dims(static_cast<int64_t>(quantized_weights.size()));
+    quantized_weights_tensor_proto.set_raw_data(quantized_weights.data(), quantized_weights.size());
+
+    TensorProto scales_tensor_proto;
+    scales_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    scales_tensor_proto.add_dims(static_cast<int64_t>(scales.size()));
+    scales_tensor_proto.set_raw_data(scales.data(), scales.size() * sizeof(float));
+
+    std::vector<NodeArg*> quantized_input_defs{
+        node.MutableInputDefs()[0],
+        &AddInitializer(graph, quantized_weights_tensor_proto, weights_name + "_quantized"),
+        &AddInitializer(graph, scales_tensor_proto, weights_name + "_scales")};
+
+    if (bias_tensor_proto != nullptr) {
+      if (bias_tensor_proto->dims_size() == 1) {
+        quantized_input_defs.push_back(node.MutableInputDefs()[2]);
+      } else {
+        // The kernel takes the bias as a 1-D tensor.
+        Initializer bias{bias_tensor_proto};
+        TensorProto bias_1d_tensor_proto;
+        bias_1d_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+        bias_1d_tensor_proto.add_dims(N);
+        bias_1d_tensor_proto.set_raw_data(bias.data<float>(), static_cast<size_t>(N) * sizeof(float));
+        quantized_input_defs.push_back(&AddInitializer(graph, bias_1d_tensor_proto, bias_tensor_proto->name() + "_1d"));
+      }
+    }
+
+    Node& quantized_node = graph.AddNode(graph.GenerateNodeName("matmul_nbits"),
+                                         "MatMulNBits",
+                                         "weight quantized " + node.OpType(),
+                                         quantized_input_defs,
+                                         node.MutableOutputDefs(),
+                                         nullptr,
+                                         kMSDomain);
+    quantized_node.AddAttribute("K", K);
+    quantized_node.AddAttribute("N", N);
+    quantized_node.AddAttribute("bits", bits_);
+    quantized_node.AddAttribute("block_size", block_size_);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    quantized_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsQuantization
+
+Transformer that replaces float MatMul and Gemm nodes whose weights are a constant 2-D initializer with
+MatMulNBits nodes. The weights are quantized to 4 or 8 bits with a symmetric scale for each block of
+block_size rows of each column, and the activations stay in float, so the product only loses the accuracy
+of the weights while reading a quarter or an eighth of their bytes.
+
+Gemm nodes are converted if they do not transpose A, alpha is 1 and C is a constant bias with a value
+per column that is added with beta 1 (or ignored with beta 0).
+*/
+class MatMulNBitsQuantization : public GraphTransformer {
+ public:
+  MatMulNBitsQuantization(int64_t bits, int64_t block_size,
+                          const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulNBitsQuantization", compatible_execution_providers),
+        bits_(bits),
+        block_size_(block_size) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+ private:
+  const int64_t bits_;
+  const int64_t block_size_;
+};
+
+}  // namespace onnxruntime
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <deque>
+#include <limits>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
@@ -13,7 +15,8 @@ namespace onnxruntime {
 
 class NchwcTransformerImpl {
  public:
-  NchwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+  NchwcTransformerImpl(Graph& graph, float min_isolated_conv_flops_per_reorder) noexcept
+      : graph_(graph), min_isolated_conv_flops_per_reorder_(min_isolated_conv_flops_per_reorder) {}
 
   void Transform(Node& node);
   void Finalize(bool& modified);
@@ -107,6 +110,8 @@ class NchwcTransformerImpl {
   void CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels, const NchwcArgument::Shape& shape);
   void FuseNchwcArgument(Node& node, const NchwcArgument& nchwc_arg);
   void InsertReorderInput(Node& node);
+  bool HasNchwcConsumer(const Node& node) const;
+  bool IsIsolatedConvProfitable(const Node& node, int64_t group_count, bool do_reorder_input) const;
 
   void ConvPoolShapeInference(const Node& node,
                               const NchwcArgument::Shape& input_shape,
@@ -115,12 +120,19 @@ class NchwcTransformerImpl {
 
   void TransformConv(Node& node);
   void TransformPool(Node& node);
-  void TransformAdd(Node& node);
+  void TransformBinary(Node& node, bool add_node);
   void TransformConcat(Node& node);
   void TransformActivation(Node& node);
+  void TransformUpsample(Node& node);
+  void TransformBatchNormalization(Node& node);
 
   Graph& graph_;
 
+  // Stores the minimum number of floating point operations per reordered
+  // element for converting a convolution whose input and output both need to
+  // be reordered. Zero disables the estimate.
+  const float min_isolated_conv_flops_per_reorder_;
+
   // Stores a queue of nodes to be removed after walking through the graph.
   std::deque<NodeIndex> removed_nodes_;
 
@@ -204,6 +216,70 @@ void NchwcTransformerImpl::InsertReorderInput(Node& node) {
   }
 }
 
+// Returns true if an output of the node is used by a node that can consume the
+// NCHWc format. Activations are looked through as these are either fused into
+// the convolution or pass the NCHWc format along to their own uses.
+bool NchwcTransformerImpl::HasNchwcConsumer(const Node& node) const {
+  for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
+    const Node& output_node = *it;
+    if (output_node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      continue;
+    }
+    const auto& op_type = output_node.OpType();
+    if (op_type == "Relu" || op_type == "Sigmoid" || op_type == "Tanh" ||
+        op_type == "LeakyRelu" || op_type == "Clip") {
+      if (HasNchwcConsumer(output_node)) {
+        return true;
+      }
+    } else if (op_type == "Conv" || op_type == "FusedConv" ||
+               op_type == "MaxPool" || op_type == "AveragePool" ||
+               op_type == "GlobalMaxPool" || op_type == "GlobalAveragePool" ||
+               op_type == "Add" || op_type == "Sum" || op_type == "Mul" || op_type == "Concat" ||
+               op_type == "Upsample" || op_type == "Resize" || op_type == "BatchNormalization") {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Estimates whether converting a convolution that needs its output reordered
+// back to NCHW format, and possibly its input reordered to NCHWc format, does
+// enough arithmetic to hide the cost of the reorders. The estimate is done per
+// output position, so it does not depend on the spatial dimensions which may
+// not be known.
+bool NchwcTransformerImpl::IsIsolatedConvProfitable(const Node& node,
+                                                    int64_t group_count,
+                                                    bool do_reorder_input) const {
+  if (min_isolated_conv_flops_per_reorder_ <= 0.0f ||
+      (do_reorder_input && nchwc_args_.count(node.InputDefs()[0]) != 0) ||
+      HasNchwcConsumer(node)) {
+    return true;
+  }
+
+  const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+  graph_.GetInitializedTensor(node.InputDefs()[1]->Name(), conv_W_tensor_proto);
+  const int64_t output_channels = conv_W_tensor_proto->dims(0);
+  const int64_t group_input_channels = conv_W_tensor_proto->dims(1);
+  const int64_t kernel_size = conv_W_tensor_proto->dims(2) * conv_W_tensor_proto->dims(3);
+
+  const double flops = 2.0 * output_channels * group_input_channels * kernel_size;
+  double reordered_elements = static_cast<double>(output_channels);
+
+  if (do_reorder_input) {
+    // Each output position consumes stride_h * stride_w input positions.
+    int64_t input_positions = 1;
+    std::vector<int64_t> strides;
+    if (graph_utils::GetRepeatedNodeAttributeValues(node, "strides", strides)) {
+      for (auto stride : strides) {
+        input_positions *= stride;
+      }
+    }
+    reordered_elements += static_cast<double>(group_input_channels * group_count * input_positions);
+  }
+
+  return flops >= min_isolated_conv_flops_per_reorder_ * reordered_elements;
+}
+
 void NchwcTransformerImpl::ConvPoolShapeInference(const Node& node,
                                                   const NchwcArgument::Shape& input_shape,
                                                   NchwcArgument::Shape& output_shape,
@@ -338,6 +414,10 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     }
   }
 
+  if (!IsIsolatedConvProfitable(node, group_count, do_reorder_input)) {
+    return;
+  }
+
   // Also require that the optional bias tensor be static.
   const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
   if (input_defs.size() >= 3) {
@@ -506,10 +586,10 @@ void NchwcTransformerImpl::TransformPool(Node& node) {
   removed_nodes_.push_front(node.Index());
 }
 
-// The existing Add/Sum operator implementations can be used with tensors
+// The existing Add/Sum/Mul operator implementations can be used with tensors
 // in NCHWc format if the tensor shapes are exactly the same (elementwise
-// add).
-void NchwcTransformerImpl::TransformAdd(Node& node) {
+// add or multiply).
+void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
   auto& input_defs = node.MutableInputDefs();
 
   // Verify that all of the inputs to this operator are from NCHWc outputs.
@@ -558,7 +638,7 @@ void NchwcTransformerImpl::TransformAdd(Node& node) {
 
   // If one of the inputs to the Add/Sum node is a NCHWc convolution, then
   // attempt to fuse the addition into the convolution itself.
-  if (input_defs_count == 2) {
+  if (add_node && input_defs_count == 2) {
     for (size_t n = 0; n < 2; n++) {
       auto* nchwc_input_n = nchwc_inputs[n];
       auto& nchwc_node = nchwc_input_n->output_node_;
@@ -651,7 +731,22 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
     if ((nchwc_node.OpType() == "Conv") && (nchwc_node.Domain() == kMSNchwcDomain) &&
         (nchwc_input->starting_original_uses_ == 1) &&
         (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr)) {
+      // Pull out the additional parameters of the activation, using the
+      // operator defaults if the attribute is not present.
+      std::vector<float> activation_params;
+      if (node.OpType() == "LeakyRelu") {
+        auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+        activation_params.push_back(alpha_attr != nullptr ? alpha_attr->f() : 0.01f);
+      } else if (node.OpType() == "Clip") {
+        auto* min_attr = graph_utils::GetNodeAttribute(node, "min");
+        auto* max_attr = graph_utils::GetNodeAttribute(node, "max");
+        activation_params.push_back(min_attr != nullptr ? min_attr->f() : std::numeric_limits<float>::lowest());
+        activation_params.push_back(max_attr != nullptr ? max_attr->f() : std::numeric_limits<float>::max());
+      }
       nchwc_node.AddAttribute("activation", node.OpType());
+      if (!activation_params.empty()) {
+        nchwc_node.AddAttribute("activation_params", activation_params);
+      }
       FuseNchwcArgument(node, *nchwc_input);
       removed_nodes_.push_front(node.Index());
     } else {
@@ -660,6 +755,205 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
   }
 }
 
+// Nearest neighbor Upsample/Resize with integral scale factors for the spatial
+// dimensions can be computed directly on the NCHWc blocks.
+void NchwcTransformerImpl::TransformUpsample(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Only transform the node if the input is already in NCHWc format.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  // Nearest neighbor and bilinear modes are supported.
+  std::string mode = "nearest";
+  auto* mode_attr = graph_utils::GetNodeAttribute(node, "mode");
+  if (mode_attr != nullptr && utils::HasString(*mode_attr)) {
+    mode = mode_attr->s();
+    if (mode != "nearest" && mode != "linear") {
+      return;
+    }
+  }
+
+  // Older versions of Upsample specify the scales as an attribute while
+  // newer versions and Resize require the scales to be a static tensor.
+  std::vector<float> scales;
+  if (input_defs.size() == 1) {
+    auto* scales_attr = graph_utils::GetNodeAttribute(node, "scales");
+    if (scales_attr == nullptr) {
+      return;
+    }
+    scales.assign(scales_attr->floats().begin(), scales_attr->floats().end());
+  } else {
+    const ONNX_NAMESPACE::TensorProto* scales_tensor_proto = nullptr;
+    if (input_defs.size() != 2 ||
+        !graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+        !graph_.GetInitializedTensor(input_defs[1]->Name(), scales_tensor_proto) ||
+        (scales_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (scales_tensor_proto->dims_size() != 1)) {
+      return;
+    }
+    auto scales_initializer = std::make_unique<Initializer>(scales_tensor_proto);
+    const float* scales_data = scales_initializer->data<float>();
+    scales.assign(scales_data, scales_data + scales_initializer->size());
+  }
+
+  // The batch and channel dimensions cannot be scaled and the spatial
+  // dimensions must be scaled by a positive integer.
+  if (scales.size() != kNchwcDims || scales[0] != 1.0f || scales[1] != 1.0f) {
+    return;
+  }
+  std::vector<int64_t> nchwc_scales;
+  for (int i = kNchwcBatchChannelDims; i < kNchwcDims; i++) {
+    int64_t scale = static_cast<int64_t>(scales[i]);
+    if (scale < 1 || static_cast<float>(scale) != scales[i]) {
+      return;
+    }
+    nchwc_scales.push_back(scale);
+  }
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Upsample",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("scales", nchwc_scales);
+  if (mode != "nearest") {
+    nchwc_node.AddAttribute("mode", mode);
+  }
+
+  nchwc_input->remaining_original_uses_--;
+
+  // Maintain the batch and channel dimensions from the NCHWc input. The
+  // spatial dimensions are sourced from this node.
+  NchwcArgument::Shape output_shape(output_defs[0]);
+  output_shape.dims_[0] = nchwc_input->shape_.dims_[0];
+  output_shape.dims_[1] = nchwc_input->shape_.dims_[1];
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, output_shape);
+  removed_nodes_.push_front(node.Index());
+}
+
+// A standalone BatchNormalization that could not be fused into a preceding
+// convolution is converted to a NCHWc depthwise 1x1 convolution, which can
+// then be fused with a following activation.
+void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // Only transform the node if the input is already in NCHWc format.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+
+  // Depthwise convolution requires that the channel count is block aligned.
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % nchwc_block_size) != 0) {
+    return;
+  }
+
+  auto* spatial_attr = graph_utils::GetNodeAttribute(node, "spatial");
+  if (spatial_attr != nullptr && utils::HasInt(*spatial_attr) && spatial_attr->i() != 1) {
+    return;
+  }
+
+  float epsilon = 1e-5f;
+  auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr && utils::HasFloat(*epsilon_attr)) {
+    epsilon = epsilon_attr->f();
+  }
+
+  // Require that the scale, bias, mean, and variance tensors be static.
+  std::unique_ptr<Initializer> bn_params[4];
+  for (size_t i = 0; i < 4; i++) {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[i + 1]) ||
+        !graph_.GetInitializedTensor(input_defs[i + 1]->Name(), tensor_proto) ||
+        (tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (tensor_proto->dims_size() != 1) ||
+        (tensor_proto->dims(0) != channels)) {
+      return;
+    }
+    bn_params[i] = std::make_unique<Initializer>(tensor_proto);
+  }
+
+  const float* bn_scale = bn_params[0]->data<float>();
+  const float* bn_B = bn_params[1]->data<float>();
+  const float* bn_mean = bn_params[2]->data<float>();
+  const float* bn_var = bn_params[3]->data<float>();
+
+  // Compute the per channel scale and bias of the equivalent convolution.
+  std::vector<float> conv_W(channels);
+  std::vector<float> conv_B(channels);
+  for (int64_t c = 0; c < channels; c++) {
+    conv_W[c] = bn_scale[c] / std::sqrt(bn_var[c] + epsilon);
+    conv_B[c] = bn_B[c] - bn_mean[c] * conv_W[c];
+  }
+
+  const int64_t conv_W_dims[] = {channels, 1, 1, 1};
+  std::vector<float> reordered_filter(channels);
+  MlasReorderFilterOIHWBo(conv_W_dims, conv_W.data(), reordered_filter.data());
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_W_tensor_proto;
+
+  nchwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_scale"));
+  nchwc_conv_W_tensor_proto.set_raw_data(reordered_filter.data(), reordered_filter.size() * sizeof(float));
+
+  for (size_t i = 0; i < 4; i++) {
+    nchwc_conv_W_tensor_proto.add_dims(conv_W_dims[i]);
+  }
+
+  graph_.AddInitializedTensor(nchwc_conv_W_tensor_proto);
+
+  ONNX_NAMESPACE::TensorProto nchwc_conv_B_tensor_proto;
+
+  nchwc_conv_B_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nchwc_conv_B_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_B"));
+  nchwc_conv_B_tensor_proto.set_raw_data(conv_B.data(), conv_B.size() * sizeof(float));
+
+  nchwc_conv_B_tensor_proto.add_dims(channels);
+
+  graph_.AddInitializedTensor(nchwc_conv_B_tensor_proto);
+
+  auto* nchwc_conv_W_arg = &graph_.GetOrCreateNodeArg(nchwc_conv_W_tensor_proto.name(), nullptr);
+  auto* nchwc_conv_B_arg = &graph_.GetOrCreateNodeArg(nchwc_conv_B_tensor_proto.name(), nullptr);
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_bn_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Conv",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_conv_W_arg, nchwc_conv_B_arg},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("group", channels);
+
+  nchwc_input->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+}
+
 void NchwcTransformerImpl::Transform(Node& node) {
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1}) ||
       graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
@@ -677,11 +971,22 @@ void NchwcTransformerImpl::Transform(Node& node) {
     // nodes unrelated to this transformer.
     if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8})) {
-      TransformAdd(node);
+      TransformBinary(node, true);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+      TransformBinary(node, false);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
       TransformConcat(node);
-    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6})) {
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6})) {
       TransformActivation(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {7, 9}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10})) {
+      TransformUpsample(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
     }
   }
 
@@ -722,7 +1027,7 @@ void NchwcTransformerImpl::Finalize(bool& modified) {
 }
 
 Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
-  NchwcTransformerImpl impl(graph);
+  NchwcTransformerImpl impl(graph, min_isolated_conv_flops_per_reorder_);
   GraphViewer graph_viewer(graph);
 
   for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
@@ -13,13 +13,22 @@ namespace onnxruntime {
 
 Transformer that optimizes the graph by using NCHWc nodes instead of NCHW nodes
 and inserts nodes to reorder tensors as needed.
+
+A convolution that would need both its input and its output reordered, because
+no neighboring node uses the NCHWc format, is only converted if it does at
+least min_isolated_conv_flops_per_reorder floating point operations for each
+element that is reordered. A value of zero converts all supported nodes.
 */
 class NchwcTransformer : public GraphTransformer {
  public:
-  NchwcTransformer() noexcept : GraphTransformer("NchwcTransformer") {}
+  explicit NchwcTransformer(float min_isolated_conv_flops_per_reorder = 0.0f) noexcept
+      : GraphTransformer("NchwcTransformer"),
+        min_isolated_conv_flops_per_reorder_(min_isolated_conv_flops_per_reorder) {}
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  const float min_isolated_conv_flops_per_reorder_;
 };
 
 }  // namespace onnxruntime
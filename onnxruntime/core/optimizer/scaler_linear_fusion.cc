@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/scaler_linear_fusion.h"
+#include "core/graph/graph.h"
+#include "core/graph/graph_utils.h"
+
+namespace onnxruntime {
+
+Status ScalerLinearFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  const auto& linear_node = *node.OutputNodesBegin();
+
+  std::vector<float> scale;
+  std::vector<float> offset;
+  std::vector<float> coefficients;
+  std::vector<float> intercepts;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "scale", scale) ||
+      !graph_utils::GetRepeatedNodeAttributeValues(node, "offset", offset) ||
+      !graph_utils::GetRepeatedNodeAttributeValues(linear_node, "coefficients", coefficients) ||
+      scale.empty() || scale.size() != offset.size()) {
+    return Status::OK();
+  }
+  graph_utils::GetRepeatedNodeAttributeValues(linear_node, "intercepts", intercepts);
+
+  // The number of rows of the coefficients is the number of classes or targets.
+  size_t rows = intercepts.size();
+  if (linear_node.OpType() == "LinearRegressor") {
+    const auto* targets = graph_utils::GetNodeAttribute(linear_node, "targets");
+    if (targets == nullptr || targets->i() <= 0) {
+      return Status::OK();
+    }
+    rows = static_cast<size_t>(targets->i());
+  }
+
+  if (rows == 0 || coefficients.empty() || coefficients.size() % rows != 0 ||
+      (!intercepts.empty() && intercepts.size() != rows)) {
+    return Status::OK();
+  }
+
+  // Scaler applies either a single scale and offset or one per feature.
+  const size_t features = coefficients.size() / rows;
+  if (scale.size() != 1 && scale.size() != features) {
+    return Status::OK();
+  }
+
+  // w' = w * scale (per column), b' = b - sum(w * scale * offset)
+  intercepts.resize(rows, 0.f);
+  for (size_t j = 0; j < rows; ++j) {
+    float* w = coefficients.data() + j * features;
+    float bias = 0.f;
+    for (size_t k = 0; k < features; ++k) {
+      const size_t idx = scale.size() == 1 ? 0 : k;
+      w[k] *= scale[idx];
+      bias += w[k] * offset[idx];
+    }
+    intercepts[j] -= bias;
+  }
+
+  if (graph_utils::RemoveNode(graph, node)) {
+    auto* mutable_linear_node = graph.GetNode(linear_node.Index());
+    mutable_linear_node->ClearAttribute("coefficients");
+    mutable_linear_node->AddAttribute("coefficients", coefficients);
+    mutable_linear_node->ClearAttribute("intercepts");
+    mutable_linear_node->AddAttribute("intercepts", intercepts);
+
+    rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  }
+
+  return Status::OK();
+}
+
+bool ScalerLinearFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Scaler", {1}, kMLDomain) ||
+      !graph_utils::IsSingleInSingleOutNode(node) ||
+      graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+
+  const auto& next_node = *node.OutputNodesBegin();
+  const bool is_regressor = graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LinearRegressor", {1},
+                                                                           kMLDomain);
+  if ((!is_regressor &&
+       !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "LinearClassifier", {1}, kMLDomain)) ||
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // Scaler converts any input to float. LinearClassifier does the same, but LinearRegressor only
+  // accepts float, so it can only take over the Scaler input when that is already float.
+  if (is_regressor) {
+    const auto* input_type = node.InputDefs()[0]->TypeAsProto();
+    if (input_type == nullptr || !input_type->has_tensor_type() ||
+        input_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class ScalerLinearFusion
+
+Rewrite rule that folds a Scaler into the LinearClassifier or LinearRegressor consuming its output.
+Scaler computes (X - offset) * scale, so the linear model can absorb it by scaling the columns of its
+coefficients and adjusting its intercepts, and the Scaler node is removed.
+
+It is attempted to be triggered only on nodes with op type "Scaler".
+*/
+class ScalerLinearFusion : public RewriteRule {
+ public:
+  ScalerLinearFusion() noexcept : RewriteRule("ScalerLinearFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Scaler"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
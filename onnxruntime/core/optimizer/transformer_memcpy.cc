@@ -20,7 +20,7 @@ class TransformerMemcpyImpl {
  private:
   void ProcessDefs(onnxruntime::Node& node, const KernelRegistryManager& kernel_registries, InitializedTensorSet& initializers_consumed);
   void BuildDefsMapping(const onnxruntime::NodeArg* arg, const KernelRegistryManager& kernel_registries);
-  void AddCopyNode(onnxruntime::NodeArg* arg, bool is_input);
+  void AddCopyNode(const std::vector<onnxruntime::NodeArg*>& args, bool is_input);
   bool ProcessInitializers(const KernelRegistryManager& kernel_registries, const InitializedTensorSet& initializers_consumed);
 
  private:
@@ -142,25 +142,49 @@ bool TransformerMemcpyImpl::ModifyGraph(const KernelRegistryManager& kernel_regi
   for (auto arg : non_provider_output_defs_)
     BuildDefsMapping(arg, kernel_registries);
 
+  // The values crossing the device boundary at the same point, i.e. the graph inputs or the outputs of a node,
+  // are copied by a single copy node, so that the copies are done in one batch.
+  std::vector<onnxruntime::NodeArg*> input_copies;
   for (auto arg : graph_.GetInputs())
     // For inputs we need to create a copy node only when the input is connected to both provider
     // and non-provider nodes. Otherwise utils::CopyInputsAcrossDevices() will do the job.
     if (provider_input_defs_.count(arg) && non_provider_input_defs_.count(arg)) {
-      AddCopyNode(const_cast<onnxruntime::NodeArg*>(arg), true);
-      modified = true;
+      input_copies.push_back(const_cast<onnxruntime::NodeArg*>(arg));
     }
 
-  for (auto arg : non_provider_output_defs_)
-    if (provider_input_defs_.count(arg)) {
-      AddCopyNode(arg, true);
-      modified = true;
+  std::vector<std::vector<onnxruntime::NodeArg*>> output_copies_from_host;
+  std::vector<std::vector<onnxruntime::NodeArg*>> output_copies_to_host;
+  for (auto& node : graph_.Nodes()) {
+    std::vector<onnxruntime::NodeArg*> from_host;
+    std::vector<onnxruntime::NodeArg*> to_host;
+    for (auto* arg : node.MutableOutputDefs()) {
+      if (!arg->Exists())
+        continue;
+      if (non_provider_output_defs_.count(arg) && provider_input_defs_.count(arg))
+        from_host.push_back(arg);
+      if (provider_output_defs_.count(arg) && non_provider_input_defs_.count(arg))
+        to_host.push_back(arg);
     }
+    if (!from_host.empty())
+      output_copies_from_host.push_back(std::move(from_host));
+    if (!to_host.empty())
+      output_copies_to_host.push_back(std::move(to_host));
+  }
 
-  for (auto arg : provider_output_defs_)
-    if (non_provider_input_defs_.count(arg)) {
-      AddCopyNode(arg, false);
-      modified = true;
-    }
+  if (!input_copies.empty()) {
+    AddCopyNode(input_copies, true);
+    modified = true;
+  }
+
+  for (const auto& args : output_copies_from_host) {
+    AddCopyNode(args, true);
+    modified = true;
+  }
+
+  for (const auto& args : output_copies_to_host) {
+    AddCopyNode(args, false);
+    modified = true;
+  }
 
   return modified;
 }
@@ -256,32 +280,40 @@ void TransformerMemcpyImpl::BuildDefsMapping(const onnxruntime::NodeArg* arg, co
   }
 }
 
-void TransformerMemcpyImpl::AddCopyNode(onnxruntime::NodeArg* arg, bool is_input) {
-  // create unique name for new def
-  std::string new_def_name = graph_.GenerateNodeArgName(arg->Name() + "_" + provider_);
-
-  auto* new_arg = &graph_.GetOrCreateNodeArg(new_def_name, arg->TypeAsProto());
-  auto* src_arg = is_input ? arg : new_arg;
-  auto* dst_arg = is_input ? new_arg : arg;
+void TransformerMemcpyImpl::AddCopyNode(const std::vector<onnxruntime::NodeArg*>& args, bool is_input) {
+  std::vector<onnxruntime::NodeArg*> src_args;
+  std::vector<onnxruntime::NodeArg*> dst_args;
+  std::vector<onnxruntime::NodeArg*> new_args;
+  for (auto* arg : args) {
+    // create unique name for new def
+    std::string new_def_name = graph_.GenerateNodeArgName(arg->Name() + "_" + provider_);
+
+    auto* new_arg = &graph_.GetOrCreateNodeArg(new_def_name, arg->TypeAsProto());
+    src_args.push_back(is_input ? arg : new_arg);
+    dst_args.push_back(is_input ? new_arg : arg);
+    new_args.push_back(new_arg);
+  }
 
   // create unique name for copy node
   std::string new_node_name = graph_.GenerateNodeName("Memcpy");
 
   const auto op_name = is_input ? "MemcpyFromHost" : "MemcpyToHost";
-  auto& new_node = graph_.AddNode(new_node_name, op_name, "Copy from/to host memory",
-                                  std::vector<onnxruntime::NodeArg*>{src_arg},
-                                  std::vector<onnxruntime::NodeArg*>{dst_arg});
+  auto& new_node = graph_.AddNode(new_node_name, op_name, "Copy from/to host memory", src_args, dst_args);
   new_node.SetExecutionProviderType(provider_);
-  std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> map = {{arg, new_arg}};
-  auto it = provider_input_nodes_.find(arg);
-  if (it != provider_input_nodes_.end()) {
-    for (auto* node : it->second)
-      node->ReplaceDefs(map);
-  }
-  it = provider_output_nodes_.find(arg);
-  if (it != provider_output_nodes_.end()) {
-    for (auto* node : it->second)
-      node->ReplaceDefs(map);
+
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto* arg = args[i];
+    std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> map = {{arg, new_args[i]}};
+    auto it = provider_input_nodes_.find(arg);
+    if (it != provider_input_nodes_.end()) {
+      for (auto* node : it->second)
+        node->ReplaceDefs(map);
+    }
+    it = provider_output_nodes_.find(arg);
+    if (it != provider_output_nodes_.end()) {
+      for (auto* node : it->second)
+        node->ReplaceDefs(map);
+    }
   }
 }
 
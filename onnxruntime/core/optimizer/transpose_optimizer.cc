@@ -0,0 +1,681 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/transpose_optimizer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsUnaryElementwise(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Elu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Selu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {10}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softplus", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softsign", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Floor", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Ceil", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sign", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Not", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Identity", {1});
+}
+
+bool IsBroadcastElementwise(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pow", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "PRelu", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mean", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Equal", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Greater", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Less", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "And", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Or", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Xor", {7});
+}
+
+bool IsReduction(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMax", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMin", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceProd", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL1", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL2", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSum", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSumExp", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSumSquare", {1});
+}
+
+bool IsIdentityPerm(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); i++) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int64_t> InvertPerm(const std::vector<int64_t>& perm) {
+  std::vector<int64_t> inverse_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    inverse_perm[static_cast<size_t>(perm[i])] = static_cast<int64_t>(i);
+  }
+  return inverse_perm;
+}
+
+// Returns the axis of the transpose input that corresponds to the specified
+// axis of the transpose output.
+bool MapAxis(const std::vector<int64_t>& perm, int64_t& axis) {
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  if (axis < -rank || axis >= rank) {
+    return false;
+  }
+  axis = perm[static_cast<size_t>(axis < 0 ? axis + rank : axis)];
+  return true;
+}
+
+}  // namespace
+
+class TransposeOptimizerImpl {
+ public:
+  TransposeOptimizerImpl(Graph& graph, const std::unordered_set<std::string>& compatible_execution_providers) noexcept
+      : graph_(graph), compatible_execution_providers_(compatible_execution_providers) {}
+
+  // Moves every Transpose node of the graph at most one node downstream.
+  // Returns true if the graph has been modified.
+  bool Sweep();
+
+ private:
+  struct Consumer {
+    NodeIndex node_index_;
+    int input_index_;
+    bool implicit_;
+  };
+
+  void BuildArgumentMaps();
+
+  bool GetTransposePerm(const Node& node, std::vector<int64_t>& perm) const;
+  bool IsUntouchedNode(const Node* node) const;
+  Node* GetSingleConsumer(const Node& node);
+
+  void RemoveTranspose(Node& transpose_node);
+  void InsertOutputTransposes(Node& node, const std::vector<int64_t>& perm);
+  NodeArg* TransposeInitializer(const NodeArg& arg, const std::vector<int64_t>& perm);
+  bool SinkThroughInputs(Node& transpose_node, const std::vector<int64_t>& perm, Node& node, bool broadcast);
+
+  bool BypassTransposes(Node& first_node, Node& last_node);
+  bool CancelTransposes(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkThroughUnary(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkThroughElementwise(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkThroughConcat(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkThroughSplit(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkThroughReduction(Node& transpose_node, const std::vector<int64_t>& perm, Node& node);
+  bool SinkTranspose(Node& transpose_node);
+
+  Graph& graph_;
+  const std::unordered_set<std::string>& compatible_execution_providers_;
+
+  // Stores the producer and the consumers of each NodeArg at the start of a
+  // sweep. The maps are built from the node definitions instead of the graph
+  // edges, which are not updated until the graph is resolved again.
+  std::unordered_map<const NodeArg*, NodeIndex> producers_;
+  std::unordered_map<const NodeArg*, std::vector<Consumer>> consumers_;
+
+  // Stores the nodes that have been removed or rewritten in this sweep. The
+  // argument maps are stale for these nodes.
+  std::unordered_set<NodeIndex> touched_nodes_;
+
+  // Stores a mapping of constant initializers that have already been
+  // transposed, so multiple nodes can share the transposed initializer.
+  std::map<std::pair<const NodeArg*, std::vector<int64_t>>, NodeArg*> transposed_initializers_;
+};
+
+void TransposeOptimizerImpl::BuildArgumentMaps() {
+  producers_.clear();
+  consumers_.clear();
+
+  for (auto& node : graph_.Nodes()) {
+    const auto& output_defs = node.OutputDefs();
+    for (size_t i = 0; i < output_defs.size(); i++) {
+      producers_[output_defs[i]] = node.Index();
+    }
+    const auto& input_defs = node.InputDefs();
+    for (size_t i = 0; i < input_defs.size(); i++) {
+      consumers_[input_defs[i]].push_back(Consumer{node.Index(), static_cast<int>(i), false});
+    }
+    for (const auto* implicit_input_def : node.ImplicitInputDefs()) {
+      consumers_[implicit_input_def].push_back(Consumer{node.Index(), -1, true});
+    }
+  }
+}
+
+bool TransposeOptimizerImpl::GetTransposePerm(const Node& node, std::vector<int64_t>& perm) const {
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm)) {
+    // The default permutation reverses the dimensions of the input.
+    const auto* input_shape = node.InputDefs()[0]->Shape();
+    if (input_shape == nullptr) {
+      return false;
+    }
+    const int64_t rank = input_shape->dim_size();
+    perm.resize(static_cast<size_t>(rank));
+    for (int64_t i = 0; i < rank; i++) {
+      perm[static_cast<size_t>(i)] = rank - i - 1;
+    }
+  }
+
+  std::vector<bool> seen(perm.size(), false);
+  for (auto axis : perm) {
+    if (axis < 0 || axis >= static_cast<int64_t>(perm.size()) || seen[static_cast<size_t>(axis)]) {
+      return false;
+    }
+    seen[static_cast<size_t>(axis)] = true;
+  }
+  return true;
+}
+
+bool TransposeOptimizerImpl::IsUntouchedNode(const Node* node) const {
+  return node != nullptr && touched_nodes_.find(node->Index()) == touched_nodes_.end();
+}
+
+Node* TransposeOptimizerImpl::GetSingleConsumer(const Node& node) {
+  if (graph_.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+  auto it = consumers_.find(node.OutputDefs()[0]);
+  if (it == consumers_.end() || it->second.size() != 1 || it->second[0].implicit_) {
+    return nullptr;
+  }
+  Node* consumer = graph_.GetNode(it->second[0].node_index_);
+  if (!IsUntouchedNode(consumer) ||
+      consumer->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return consumer;
+}
+
+void TransposeOptimizerImpl::RemoveTranspose(Node& transpose_node) {
+  touched_nodes_.insert(transpose_node.Index());
+  graph_utils::RemoveNodeOutputEdges(graph_, transpose_node);
+  graph_.RemoveNode(transpose_node.Index());
+}
+
+void TransposeOptimizerImpl::InsertOutputTransposes(Node& node, const std::vector<int64_t>& perm) {
+  touched_nodes_.insert(node.Index());
+  graph_utils::RemoveNodeOutputEdges(graph_, node);
+
+  // Redirect each used output of the node through a new Transpose node that
+  // produces the original NodeArg.
+  const auto& graph_outputs = graph_.GetOutputs();
+  auto& output_defs = node.MutableOutputDefs();
+  for (auto& output_def : output_defs) {
+    if (!output_def->Exists() ||
+        (consumers_.find(output_def) == consumers_.end() &&
+         std::find(graph_outputs.begin(), graph_outputs.end(), output_def) == graph_outputs.end())) {
+      continue;
+    }
+    auto* output_original_arg = output_def;
+    std::string output_transposed_def_name = graph_.GenerateNodeArgName(output_original_arg->Name() + "_transposed");
+    auto* output_transposed_arg = &graph_.GetOrCreateNodeArg(output_transposed_def_name, nullptr);
+    output_def = output_transposed_arg;
+
+    Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("Transpose"),
+                                          "Transpose",
+                                          "sunk Transpose",
+                                          {output_transposed_arg},
+                                          {output_original_arg});
+    transpose_node.AddAttribute("perm", perm);
+    transpose_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  }
+}
+
+NodeArg* TransposeOptimizerImpl::TransposeInitializer(const NodeArg& arg, const std::vector<int64_t>& perm) {
+  auto key = std::make_pair(&arg, perm);
+  auto it = transposed_initializers_.find(key);
+  if (it != transposed_initializers_.end()) {
+    return it->second;
+  }
+
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, arg.Name());
+  Initializer initializer{tensor_proto};
+
+  size_t element_size;
+  switch (initializer.data_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      element_size = sizeof(uint16_t);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      element_size = sizeof(float);
+      break;
+    default:
+      element_size = sizeof(double);
+      break;
+  }
+
+  // Broadcast the initializer to the rank of the permutation by prepending
+  // dimensions of size one, then transpose by the inverse permutation so that
+  // transposing the result by the permutation restores the original layout.
+  const size_t rank = perm.size();
+  std::vector<int64_t> input_dims(rank, 1);
+  std::copy(initializer.dims().begin(), initializer.dims().end(),
+            input_dims.begin() + (rank - initializer.dims().size()));
+
+  std::vector<int64_t> input_strides(rank);
+  int64_t stride = 1;
+  for (size_t i = rank; i > 0; i--) {
+    input_strides[i - 1] = stride;
+    stride *= input_dims[i - 1];
+  }
+
+  const auto inverse_perm = InvertPerm(perm);
+  std::vector<int64_t> output_dims(rank);
+  std::vector<int64_t> output_strides(rank);
+  for (size_t i = 0; i < rank; i++) {
+    output_dims[i] = input_dims[static_cast<size_t>(inverse_perm[i])];
+    output_strides[i] = input_strides[static_cast<size_t>(inverse_perm[i])];
+  }
+
+  const char* input_data = initializer.data<char>();
+  std::string transposed_data(static_cast<size_t>(initializer.size()) * element_size, '\0');
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t n = 0; n < initializer.size(); n++) {
+    int64_t input_offset = 0;
+    for (size_t i = 0; i < rank; i++) {
+      input_offset += index[i] * output_strides[i];
+    }
+    std::copy_n(input_data + static_cast<size_t>(input_offset) * element_size,
+                element_size,
+                &transposed_data[static_cast<size_t>(n) * element_size]);
+    for (size_t i = rank; i > 0; i--) {
+      if (++index[i - 1] < output_dims[i - 1]) {
+        break;
+      }
+      index[i - 1] = 0;
+    }
+  }
+
+  ONNX_NAMESPACE::TensorProto transposed_tensor_proto;
+  transposed_tensor_proto.set_data_type(initializer.data_type());
+  transposed_tensor_proto.set_name(graph_.GenerateNodeArgName(arg.Name() + "_transposed"));
+  transposed_tensor_proto.set_raw_data(transposed_data);
+  for (auto dim : output_dims) {
+    transposed_tensor_proto.add_dims(dim);
+  }
+
+  graph_.AddInitializedTensor(transposed_tensor_proto);
+
+  auto* transposed_arg = &graph_.GetOrCreateNodeArg(transposed_tensor_proto.name(), nullptr);
+  transposed_initializers_.emplace(key, transposed_arg);
+  return transposed_arg;
+}
+
+// Rewrites the inputs of the node to the layout before the transpose. Every
+// input must either be produced by a Transpose node with the same permutation
+// and no other uses or be a constant initializer, which is transposed
+// statically. If broadcast is false, the constant initializers must have the
+// full rank of the permutation.
+bool TransposeOptimizerImpl::SinkThroughInputs(Node& transpose_node,
+                                               const std::vector<int64_t>& perm,
+                                               Node& node,
+                                               bool broadcast) {
+  const auto& input_defs = node.InputDefs();
+  std::vector<Node*> transpose_nodes(input_defs.size(), nullptr);
+  std::vector<bool> transpose_initializers(input_defs.size(), false);
+
+  for (size_t i = 0; i < input_defs.size(); i++) {
+    const auto* input_def = input_defs[i];
+    if (!input_def->Exists()) {
+      return false;
+    }
+
+    // Test for a Transpose node with the same permutation.
+    auto producer_it = producers_.find(input_def);
+    if (producer_it != producers_.end()) {
+      Node* producer = graph_.GetNode(producer_it->second);
+      if (producer == &transpose_node) {
+        transpose_nodes[i] = producer;
+        continue;
+      }
+      std::vector<int64_t> producer_perm;
+      if (IsUntouchedNode(producer) &&
+          graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Transpose", {1}) &&
+          graph_utils::IsSupportedProvider(*producer, compatible_execution_providers_) &&
+          GetSingleConsumer(*producer) == &node &&
+          GetTransposePerm(*producer, producer_perm) && producer_perm == perm) {
+        transpose_nodes[i] = producer;
+        continue;
+      }
+      return false;
+    }
+
+    // Test for a constant initializer that can be transposed statically.
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, input_def->Name());
+    if (tensor_proto == nullptr) {
+      return false;
+    }
+    const size_t initializer_rank = static_cast<size_t>(tensor_proto->dims_size());
+    if (broadcast) {
+      if (initializer_rank > perm.size()) {
+        return false;
+      }
+      const int64_t initializer_size = std::accumulate(tensor_proto->dims().begin(), tensor_proto->dims().end(),
+                                                       static_cast<int64_t>(1), std::multiplies<int64_t>{});
+      if (initializer_size == 1) {
+        // A single element broadcasts identically in either layout.
+        continue;
+      }
+    } else if (initializer_rank != perm.size()) {
+      return false;
+    }
+    if (!Initializer::IsSupportedDataType(tensor_proto)) {
+      return false;
+    }
+    transpose_initializers[i] = true;
+  }
+
+  auto& mutable_input_defs = node.MutableInputDefs();
+  for (size_t i = 0; i < mutable_input_defs.size(); i++) {
+    if (transpose_nodes[i] != nullptr) {
+      mutable_input_defs[i] = transpose_nodes[i]->MutableInputDefs()[0];
+      RemoveTranspose(*transpose_nodes[i]);
+    } else if (transpose_initializers[i]) {
+      mutable_input_defs[i] = TransposeInitializer(*mutable_input_defs[i], perm);
+    }
+  }
+
+  touched_nodes_.insert(node.Index());
+  return true;
+}
+
+// Removes the chain of Transpose nodes from first_node to last_node, which
+// must compose to the identity permutation. The consumers of the last node are
+// connected to the input of the first node. If the last node produces a graph
+// output, the producer of the input of the first node is instead changed to
+// produce the graph output.
+bool TransposeOptimizerImpl::BypassTransposes(Node& first_node, Node& last_node) {
+  auto* input_arg = first_node.MutableInputDefs()[0];
+  auto* output_arg = last_node.MutableOutputDefs()[0];
+
+  if (!graph_.IsNodeOutputsInGraphOutputs(last_node)) {
+    auto it = consumers_.find(output_arg);
+    if (it != consumers_.end()) {
+      for (const auto& consumer : it->second) {
+        if (consumer.implicit_ || !IsUntouchedNode(graph_.GetNode(consumer.node_index_))) {
+          return false;
+        }
+      }
+      for (const auto& consumer : it->second) {
+        graph_.GetNode(consumer.node_index_)->MutableInputDefs()[consumer.input_index_] = input_arg;
+        touched_nodes_.insert(consumer.node_index_);
+      }
+    }
+  } else {
+    auto producer_it = producers_.find(input_arg);
+    auto consumers_it = consumers_.find(input_arg);
+    if (producer_it == producers_.end() || consumers_it->second.size() != 1 ||
+        std::find(graph_.GetOutputs().begin(), graph_.GetOutputs().end(), input_arg) != graph_.GetOutputs().end()) {
+      return false;
+    }
+    Node* producer = graph_.GetNode(producer_it->second);
+    if (!IsUntouchedNode(producer)) {
+      return false;
+    }
+    touched_nodes_.insert(producer->Index());
+    graph_utils::RemoveNodeOutputEdges(graph_, *producer);
+    for (auto& output_def : producer->MutableOutputDefs()) {
+      if (output_def == input_arg) {
+        output_def = output_arg;
+      }
+    }
+  }
+
+  RemoveTranspose(last_node);
+  if (&first_node != &last_node) {
+    RemoveTranspose(first_node);
+  }
+  return true;
+}
+
+bool TransposeOptimizerImpl::CancelTransposes(Node& transpose_node, const std::vector<int64_t>& perm, Node& node) {
+  std::vector<int64_t> node_perm;
+  if (!GetTransposePerm(node, node_perm) || node_perm.size() != perm.size()) {
+    return false;
+  }
+
+  // Compose the permutations of the two Transpose nodes.
+  std::vector<int64_t> fused_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    fused_perm[i] = perm[static_cast<size_t>(node_perm[i])];
+  }
+
+  // The pair of Transpose nodes cancels if the composed permutation is the
+  // identity. Otherwise replace the pair with a single Transpose node.
+  if (IsIdentityPerm(fused_perm) && BypassTransposes(transpose_node, node)) {
+    return true;
+  }
+
+  auto* input_arg = transpose_node.MutableInputDefs()[0];
+  node.MutableInputDefs()[0] = input_arg;
+  node.AddAttribute("perm", fused_perm);
+  touched_nodes_.insert(node.Index());
+  RemoveTranspose(transpose_node);
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkThroughUnary(Node& transpose_node, const std::vector<int64_t>& perm, Node& node) {
+  if (!SinkThroughInputs(transpose_node, perm, node, true)) {
+    return false;
+  }
+  InsertOutputTransposes(node, perm);
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkThroughElementwise(Node& transpose_node,
+                                                    const std::vector<int64_t>& perm,
+                                                    Node& node) {
+  // The output must have the rank of the permutation, so the other inputs of
+  // the node must be broadcast to the rank of the permutation.
+  const auto* output_shape = node.OutputDefs()[0]->Shape();
+  if (output_shape == nullptr || output_shape->dim_size() != static_cast<int>(perm.size())) {
+    return false;
+  }
+  if (!SinkThroughInputs(transpose_node, perm, node, true)) {
+    return false;
+  }
+  InsertOutputTransposes(node, perm);
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkThroughConcat(Node& transpose_node, const std::vector<int64_t>& perm, Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr)) {
+    return false;
+  }
+  int64_t axis = axis_attr->i();
+  if (!MapAxis(perm, axis) || !SinkThroughInputs(transpose_node, perm, node, false)) {
+    return false;
+  }
+  node.AddAttribute("axis", axis);
+  InsertOutputTransposes(node, perm);
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkThroughSplit(Node& transpose_node, const std::vector<int64_t>& perm, Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  int64_t axis = 0;
+  if (axis_attr != nullptr && utils::HasInt(*axis_attr)) {
+    axis = axis_attr->i();
+  }
+  if (!MapAxis(perm, axis) || !SinkThroughInputs(transpose_node, perm, node, false)) {
+    return false;
+  }
+  node.AddAttribute("axis", axis);
+  InsertOutputTransposes(node, perm);
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkThroughReduction(Node& transpose_node,
+                                                  const std::vector<int64_t>& perm,
+                                                  Node& node) {
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(node, "keepdims");
+  const bool keepdims = keepdims_attr == nullptr || !utils::HasInt(*keepdims_attr) || keepdims_attr->i() != 0;
+
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+    // All dimensions are reduced, so the output is independent of the layout
+    // of the input.
+    return SinkThroughInputs(transpose_node, perm, node, false);
+  }
+
+  std::vector<bool> reduced(perm.size(), false);
+  for (auto& axis : axes) {
+    if (!MapAxis(perm, axis)) {
+      return false;
+    }
+    reduced[static_cast<size_t>(axis)] = true;
+  }
+
+  // Compute the permutation of the reduced output. If the reduced dimensions
+  // are removed, each kept dimension of the transposed output maps to the
+  // position of its source dimension amongst the kept input dimensions.
+  std::vector<int64_t> output_perm;
+  if (keepdims) {
+    output_perm = perm;
+  } else {
+    std::vector<int64_t> kept_positions(perm.size(), -1);
+    int64_t kept_count = 0;
+    for (size_t i = 0; i < perm.size(); i++) {
+      if (!reduced[i]) {
+        kept_positions[i] = kept_count++;
+      }
+    }
+    for (size_t i = 0; i < perm.size(); i++) {
+      int64_t kept_position = kept_positions[static_cast<size_t>(perm[i])];
+      if (kept_position >= 0) {
+        output_perm.push_back(kept_position);
+      }
+    }
+  }
+
+  if (!SinkThroughInputs(transpose_node, perm, node, false)) {
+    return false;
+  }
+  node.AddAttribute("axes", axes);
+  if (!IsIdentityPerm(output_perm)) {
+    InsertOutputTransposes(node, output_perm);
+  }
+  return true;
+}
+
+bool TransposeOptimizerImpl::SinkTranspose(Node& transpose_node) {
+  std::vector<int64_t> perm;
+  if (!GetTransposePerm(transpose_node, perm)) {
+    return false;
+  }
+
+  if (IsIdentityPerm(perm)) {
+    return BypassTransposes(transpose_node, transpose_node);
+  }
+
+  Node* consumer = GetSingleConsumer(transpose_node);
+  if (consumer == nullptr) {
+    return false;
+  }
+  Node& node = *consumer;
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+    return CancelTransposes(transpose_node, perm, node);
+  }
+  if (IsUnaryElementwise(node)) {
+    return SinkThroughUnary(transpose_node, perm, node);
+  }
+  if (IsBroadcastElementwise(node)) {
+    return SinkThroughElementwise(transpose_node, perm, node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
+    return SinkThroughConcat(transpose_node, perm, node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Split", {2})) {
+    return SinkThroughSplit(transpose_node, perm, node);
+  }
+  if (IsReduction(node)) {
+    return SinkThroughReduction(transpose_node, perm, node);
+  }
+  return false;
+}
+
+bool TransposeOptimizerImpl::Sweep() {
+  BuildArgumentMaps();
+  touched_nodes_.clear();
+
+  // Collect the node indices up front as new nodes are added while walking
+  // through the graph. The new nodes are visited by the next sweep.
+  std::vector<NodeIndex> node_indices;
+  for (auto& node : graph_.Nodes()) {
+    node_indices.push_back(node.Index());
+  }
+
+  bool modified = false;
+  for (auto index : node_indices) {
+    auto* node = graph_.GetNode(index);
+    if (IsUntouchedNode(node) &&
+        graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Transpose", {1}) &&
+        graph_utils::IsSupportedProvider(*node, compatible_execution_providers_) &&
+        SinkTranspose(*node)) {
+      modified = true;
+    }
+  }
+  return modified;
+}
+
+/*
+Sinks Transpose nodes towards the graph outputs. Models converted from channels
+last frameworks surround the layout sensitive nodes with Transpose nodes, which
+leaves pairs of inverse Transpose nodes separated by layout agnostic nodes.
+Sinking one Transpose node through the layout agnostic nodes lets the pair meet
+and cancel. A sunk Transpose node never copies more data than the original node,
+as the sunk node transposes either a tensor of the same size, the outputs of a
+Split node or the smaller output of a reduction.
+*/
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  for (auto& node : graph.Nodes()) {
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+  }
+
+  TransposeOptimizerImpl impl(graph, GetCompatibleExecutionProviders());
+
+  // Each sweep moves the Transpose nodes downstream, so the loop terminates.
+  while (impl.Sweep()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Transformer that sinks Transpose nodes through layout agnostic nodes (elementwise
+operators, Concat, Split and reductions) towards the graph outputs, cancels pairs
+of Transpose nodes that meet and statically transposes the constant operands of
+the nodes that a Transpose node is pushed through.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
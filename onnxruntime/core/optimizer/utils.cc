@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/graph/graph_utils.h"
+#include "core/util/math.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+
+namespace optimizer_utils {
+
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& input_arg, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || !Initializer::IsSupportedDataType(tensor_proto)) {
+    return false;
+  }
+
+  Initializer initializer{tensor_proto};
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  switch (initializer.data_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      value = *initializer.data<float>();
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      value = static_cast<float>(*initializer.data<double>());
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      value = math::halfToFloat(*initializer.data<uint16_t>());
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+bool IsScalarInitializerWithValue(const Graph& graph, const NodeArg& input_arg, float expected_value,
+                                  float tolerance) {
+  float value;
+  if (!GetScalarInitializerValue(graph, input_arg, value)) {
+    return false;
+  }
+  return std::abs(value - expected_value) <= tolerance * std::max(1.0f, std::abs(expected_value));
+}
+
+bool IsFusableIntermediate(const Graph& graph, const Node& node, size_t expected_consumers) {
+  return node.GetOutputEdgesCount() == expected_consumers && !graph.IsNodeOutputsInGraphOutputs(node);
+}
+
+const Node* GetInputNode(const Node& node, int input_index) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_index) {
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+const NodeArg* GetOtherInput(const Node& node, const NodeArg& input_arg) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() != 2 || input_defs[0] == input_defs[1]) {
+    return nullptr;
+  }
+  if (input_defs[0] == &input_arg) {
+    return input_defs[1];
+  }
+  if (input_defs[1] == &input_arg) {
+    return input_defs[0];
+  }
+  return nullptr;
+}
+
+void RemoveFusedNodes(Graph& graph, const std::vector<Node*>& nodes) {
+  for (Node* node : nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+}
+
+bool IsLastAxis(const NodeArg& input_arg, int64_t axis) {
+  if (axis == -1) {
+    return true;
+  }
+  const auto* shape = input_arg.Shape();
+  return shape != nullptr && axis == shape->dim_size() - 1;
+}
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
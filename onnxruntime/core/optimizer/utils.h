@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace optimizer_utils {
+
+/** Gets the value of a constant initializer that holds a single floating point element.
+@returns false if the input is not such an initializer. */
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& input_arg, float& value);
+
+/** Checks whether the input is a constant initializer that holds a single floating point element
+equal to expected_value within the relative tolerance. */
+bool IsScalarInitializerWithValue(const Graph& graph, const NodeArg& input_arg, float expected_value,
+                                  float tolerance = 1e-5f);
+
+/** Checks whether the node is consumed by exactly expected_consumers nodes and does not produce a
+graph output, so that the node can be removed once its consumers are fused. */
+bool IsFusableIntermediate(const Graph& graph, const Node& node, size_t expected_consumers = 1);
+
+/** Gets the node that produces the specified input of the node.
+@returns nullptr if the input is a graph input or an initializer. */
+const Node* GetInputNode(const Node& node, int input_index);
+
+/** Gets the input of a binary node other than the one named by input_arg.
+@returns nullptr if the node does not consume input_arg or consumes it twice. */
+const NodeArg* GetOtherInput(const Node& node, const NodeArg& input_arg);
+
+/** Removes the nodes that have been replaced by a fused node. The fused node takes over the input
+and output NodeArgs, so the edges are rebuilt when the graph is resolved. */
+void RemoveFusedNodes(Graph& graph, const std::vector<Node*>& nodes);
+
+/** Checks whether the axis refers to the last dimension of the input. The rank of the input must be known.
+A negative axis counts from the back. */
+bool IsLastAxis(const NodeArg& input_arg, int64_t axis);
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
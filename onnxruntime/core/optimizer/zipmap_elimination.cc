@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_elimination.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status ZipMapElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  // The outputs of a subgraph are consumed by its parent node with their current type, so only the outputs of the
+  // main graph are replaced.
+  if (graph_level > 0) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr) {
+      continue;
+    }
+
+    auto& node = *node_ptr;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "ZipMap", {1}, kMLDomain) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        node.GetOutputEdgesCount() != 0 || !graph.IsNodeOutputsInGraphOutputs(node)) {
+      continue;
+    }
+
+    NodeArg* input = node.MutableInputDefs()[0];
+    NodeArg* output = node.MutableOutputDefs()[0];
+    if (input->TypeAsProto() == nullptr) {
+      continue;
+    }
+
+    // The ZipMap becomes an Identity of the probabilities, so the graph output keeps its name.
+    const std::string name = node.Name();
+    graph.RemoveNode(node.Index());
+    output->SetType(*input->TypeAsProto());
+    graph.AddNode(graph.GenerateNodeName(name.empty() ? "ZipMap" : name), "Identity",
+                  "Probabilities of the removed ZipMap", {input}, {output});
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapElimination
+
+Transformer that removes the ZipMap nodes whose output is only a graph output, typically the last node of a
+classifier converted from scikit-learn. The graph output keeps its name but holds the probability tensor that was
+the input of the ZipMap (one row per sample, in the order of the class labels of the ZipMap), instead of a sequence
+of maps with one allocated entry per class and sample. This changes the type of the graph output, so it is enabled
+only on request.
+*/
+class ZipMapElimination : public GraphTransformer {
+ public:
+  ZipMapElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ZipMapElimination", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -63,6 +63,26 @@ class Env {
 
   virtual int GetNumCpuCores() const = 0;
 
+  /// \brief Returns the logical processors that belong to the given NUMA node.
+  ///
+  /// Returns an empty vector if the node doesn't exist or the platform doesn't
+  /// expose its NUMA topology.
+  virtual std::vector<size_t> GetNumaNodeProcessors(int numa_node) const = 0;
+
+  /// \brief Restricts the calling thread to run on the given logical processors.
+  virtual common::Status SetCurrentThreadAffinity(const std::vector<size_t>& logical_processors) const = 0;
+
+  /// \brief Allocates whole pages of memory directly from the operating system.
+  ///
+  /// With use_huge_pages, the pages are explicit huge pages if the system has them reserved and size is a
+  /// multiple of the huge page size, else the system is asked to back them with transparent huge pages where
+  /// it supports that. With a numa_node of 0 or more, the pages are preferably placed on that NUMA node.
+  /// Returns nullptr if the memory couldn't be allocated. Free the memory with FreePages.
+  virtual void* AllocatePages(size_t size, bool use_huge_pages, int numa_node) const = 0;
+
+  /// \brief Frees memory from AllocatePages. size must be the size it was allocated with.
+  virtual void FreePages(void* p, size_t size) const = 0;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const { return env_time_->NowMicros(); }
 
@@ -89,6 +109,23 @@ class Env {
                                           OrtCallback& deleter) const = 0;
 #endif
 
+  /**
+   * Maps a read-only view of a range of a file into memory, so that its pages are loaded on first access and
+   * are shared with the other processes mapping the file.
+   * \param file_path file_path must point to a regular file
+   * \param offset file offset. It doesn't need to be aligned to a page.
+   * \param len length of the range to map. Must be >0.
+   * \param[out] p address of the range in the mapped view
+   * \param[out] deleter unmaps the view
+   */
+#ifndef _WIN32
+  virtual common::Status MapFileIntoMemory(const char* file_path, off_t offset, size_t len, void*& p,
+                                           OrtCallback& deleter) const = 0;
+#else
+  virtual common::Status MapFileIntoMemory(const wchar_t* file_path, int64_t offset, size_t len, void*& p,
+                                           OrtCallback& deleter) const = 0;
+#endif
+
 #ifdef _WIN32
   //Mainly for use with protobuf library
   virtual common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const = 0;
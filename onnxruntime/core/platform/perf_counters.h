@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace onnxruntime {
+
+// Hardware performance counters of a thread, accumulated since they were opened. A counter that the hardware
+// doesn't provide is -1.
+struct PerfCounterValues {
+  int64_t cycles = -1;
+  int64_t instructions = -1;
+  int64_t llc_misses = -1;
+};
+
+// Read the hardware performance counters of the calling thread, which are opened on the first call from the thread.
+// Only threads are counted, so the work a kernel hands to the intra-op thread pool isn't included.
+// Returns false if there are no counters, e.g. on platforms other than Linux, or if perf_event_open isn't permitted
+// (see /proc/sys/kernel/perf_event_paranoid).
+bool ReadThreadPerfCounters(PerfCounterValues& values);
+
+}  // namespace onnxruntime
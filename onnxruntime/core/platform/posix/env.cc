@@ -24,9 +24,15 @@ limitations under the License.
 #include <fcntl.h>
 #include <dlfcn.h>
 #include <string.h>
+#include <fstream>
+#include <sstream>
 #include <thread>
 #include <vector>
 #include <assert.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
 #include "core/platform/env.h"
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -40,6 +46,7 @@ namespace onnxruntime {
 
 namespace {
 constexpr int OneMillion = 1000000;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
 
 static void DeleteBuffer(void* param) noexcept { ::free(param); }
 
@@ -57,7 +64,9 @@ static void UnmapFile(void* param) noexcept {
     int err = errno;
     LOGS_DEFAULT(INFO) << "munmap failed. error code:" << err;
   }
-  (void)close(p->fd);
+  if (p->fd >= 0) {
+    (void)close(p->fd);
+  }
   delete p;
 }
 
@@ -75,6 +84,98 @@ class PosixEnv : public Env {
     return std::thread::hardware_concurrency();
   }
 
+  std::vector<size_t> GetNumaNodeProcessors(int numa_node) const override {
+    std::vector<size_t> processors;
+#if defined(__linux__)
+    if (numa_node < 0) return processors;
+
+    // cpulist is a comma separated list of processor ids and ranges, e.g. "0-3,8-11"
+    std::ostringstream path;
+    path << "/sys/devices/system/node/node" << numa_node << "/cpulist";
+    std::ifstream cpulist(path.str());
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+      size_t first = 0;
+      size_t last = 0;
+      int matched = sscanf(range.c_str(), "%zu-%zu", &first, &last);
+      if (matched == 1) {
+        last = first;
+      } else if (matched != 2) {
+        continue;
+      }
+      for (size_t processor = first; processor <= last; ++processor) {
+        processors.push_back(processor);
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+    return processors;
+  }
+
+  common::Status SetCurrentThreadAffinity(const std::vector<size_t>& logical_processors) const override {
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (size_t processor : logical_processors) {
+      if (processor >= CPU_SETSIZE) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Logical processor ", processor, " is out of range");
+      }
+      CPU_SET(processor, &cpu_set);
+    }
+    // a pid of 0 applies the mask to the calling thread
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      int err = errno;
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "sched_setaffinity failed, error code = ", err);
+    }
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(logical_processors);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform");
+#endif
+  }
+
+  void* AllocatePages(size_t size, bool use_huge_pages, int numa_node) const override {
+    void* p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    // explicit huge pages only exist if the administrator reserved them, so fall back to normal pages
+    if (use_huge_pages && size % kHugePageSize == 0) {
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (p == MAP_FAILED) {
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) {
+        return nullptr;
+      }
+#if defined(MADV_HUGEPAGE)
+      if (use_huge_pages) {
+        // only a hint, transparent huge pages may be disabled
+        (void)madvise(p, size, MADV_HUGEPAGE);
+      }
+#endif
+    }
+#if defined(__linux__) && defined(SYS_mbind)
+    // the pages aren't touched yet, so the policy decides where they are first placed
+    if (numa_node >= 0) {
+      constexpr int kMpolPreferred = 1;
+      constexpr size_t bits_per_word = sizeof(unsigned long) * 8;
+      std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / bits_per_word + 1);
+      node_mask[static_cast<size_t>(numa_node) / bits_per_word] |= 1UL << (static_cast<size_t>(numa_node) % bits_per_word);
+      (void)syscall(SYS_mbind, p, size, kMpolPreferred, node_mask.data(), node_mask.size() * bits_per_word + 1, 0);
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+    return p;
+  }
+
+  void FreePages(void* p, size_t size) const override {
+    if (p != nullptr) {
+      (void)munmap(p, size);
+    }
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -175,6 +276,35 @@ class PosixEnv : public Env {
     return common::Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const char* fname, off_t offset, size_t len, void*& p,
+                                   OrtCallback& deleter) const override {
+    if (!fname) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "MapFileIntoMemory: 'fname' cannot be NULL");
+    }
+    if (offset < 0 || len == 0) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: offset must be non-negative and len must be positive");
+    }
+    deleter.f = nullptr;
+    deleter.param = nullptr;
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+      return ReportSystemError("open", fname);
+    }
+    long page_size = sysconf(_SC_PAGESIZE);
+    off_t offset_to_page = offset % static_cast<off_t>(page_size);
+    void* addr = mmap(nullptr, len + offset_to_page, PROT_READ, MAP_SHARED, fd, offset - offset_to_page);
+    // the mapping stays valid after the file is closed, so a model with many tensors doesn't hold a file per tensor
+    (void)close(fd);
+    if (addr == MAP_FAILED) {
+      return ReportSystemError("mmap", fname);
+    }
+    deleter.f = UnmapFile;
+    deleter.param = new UnmapFileParam{addr, len + offset_to_page, -1};
+    p = reinterpret_cast<char*>(addr) + offset_to_page;
+    return common::Status::OK();
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto e = errno;
     char buf[1024];
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/perf_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <initializer_list>
+#endif
+
+namespace onnxruntime {
+
+#if defined(__linux__)
+namespace {
+
+// The counters of a thread, closed when the thread exits.
+class ThreadPerfCounters {
+ public:
+  ThreadPerfCounters() {
+    cycles_fd_ = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    instructions_fd_ = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    llc_misses_fd_ = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  }
+
+  ~ThreadPerfCounters() {
+    for (int fd : {cycles_fd_, instructions_fd_, llc_misses_fd_}) {
+      if (fd >= 0) close(fd);
+    }
+  }
+
+  bool Read(PerfCounterValues& values) const {
+    if (cycles_fd_ < 0 && instructions_fd_ < 0 && llc_misses_fd_ < 0) {
+      return false;
+    }
+    values.cycles = Read(cycles_fd_);
+    values.instructions = Read(instructions_fd_);
+    values.llc_misses = Read(llc_misses_fd_);
+    return true;
+  }
+
+ private:
+  static int Open(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // the calling thread, on any cpu
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  static int64_t Read(int fd) {
+    uint64_t count;
+    if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    return static_cast<int64_t>(count);
+  }
+
+  int cycles_fd_;
+  int instructions_fd_;
+  int llc_misses_fd_;
+};
+
+}  // namespace
+
+bool ReadThreadPerfCounters(PerfCounterValues& values) {
+  static thread_local ThreadPerfCounters counters;
+  return counters.Read(values);
+}
+#else
+bool ReadThreadPerfCounters(PerfCounterValues& /*values*/) {
+  return false;
+}
+#endif
+
+}  // namespace onnxruntime
@@ -32,6 +32,13 @@ namespace {
 
 static void DeleteBuffer(void* param) noexcept { ::free(param); }
 
+static void UnmapFile(void* param) noexcept {
+  if (UnmapViewOfFile(param) != TRUE) {
+    int err = GetLastError();
+    LOGS_DEFAULT(INFO) << "UnmapViewOfFile failed. error code:" << err;
+  }
+}
+
 class WindowsEnv : public Env {
  public:
   void SleepForMicroseconds(int64_t micros) const override { Sleep(static_cast<DWORD>(micros) / 1000); }
@@ -60,6 +67,66 @@ class WindowsEnv : public Env {
     return processorCoreCount;
   }
 
+  std::vector<size_t> GetNumaNodeProcessors(int numa_node) const override {
+    std::vector<size_t> processors;
+    GROUP_AFFINITY group_affinity;
+    if (numa_node < 0 || numa_node > USHRT_MAX ||
+        !GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numa_node), &group_affinity)) {
+      return processors;
+    }
+    // processors are numbered across groups, with 64 logical processors per group
+    for (size_t bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit) {
+      if (group_affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) {
+        processors.push_back(static_cast<size_t>(group_affinity.Group) * sizeof(KAFFINITY) * 8 + bit);
+      }
+    }
+    return processors;
+  }
+
+  common::Status SetCurrentThreadAffinity(const std::vector<size_t>& logical_processors) const override {
+    if (logical_processors.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No logical processors were specified");
+    }
+    // a thread can only be affinitized to processors within a single group
+    constexpr size_t processors_per_group = sizeof(KAFFINITY) * 8;
+    GROUP_AFFINITY group_affinity = {};
+    group_affinity.Group = static_cast<WORD>(logical_processors.front() / processors_per_group);
+    for (size_t processor : logical_processors) {
+      if (processor / processors_per_group != group_affinity.Group) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "All logical processors must belong to the same processor group");
+      }
+      group_affinity.Mask |= static_cast<KAFFINITY>(1) << (processor % processors_per_group);
+    }
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, nullptr)) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "SetThreadGroupAffinity failed, error code = ", err);
+    }
+    return Status::OK();
+  }
+
+  void* AllocatePages(size_t size, bool use_huge_pages, int numa_node) const override {
+    const DWORD preferred_node = numa_node >= 0 ? static_cast<DWORD>(numa_node) : NUMA_NO_PREFERRED_NODE;
+    // large pages need the SeLockMemoryPrivilege, so fall back to normal pages without it
+    const SIZE_T large_page_size = GetLargePageMinimum();
+    if (use_huge_pages && large_page_size != 0 && size % large_page_size == 0) {
+      void* p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE, preferred_node);
+      if (p != nullptr) {
+        return p;
+      }
+    }
+    return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                              preferred_node);
+  }
+
+  void FreePages(void* p, size_t size) const override {
+    ORT_UNUSED_PARAMETER(size);
+    if (p != nullptr) {
+      VirtualFree(p, 0, MEM_RELEASE);
+    }
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
@@ -145,6 +212,49 @@ class WindowsEnv : public Env {
     return common::Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const wchar_t* fname, int64_t offset, size_t len, void*& p,
+                                   OrtCallback& deleter) const override {
+    if (!fname) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "MapFileIntoMemory: 'fname' cannot be NULL");
+    }
+    if (offset < 0 || len == 0) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: offset must be non-negative and len must be positive");
+    }
+    deleter.f = nullptr;
+    deleter.param = nullptr;
+    HANDLE hFile = CreateFileW(fname, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "open file ", ToMBString(fname), " fail, errcode =", err);
+    }
+    std::unique_ptr<void, decltype(&CloseHandle)> file_holder(hFile, CloseHandle);
+    HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CreateFileMapping ", ToMBString(fname), " fail, errcode =", err);
+    }
+    std::unique_ptr<void, decltype(&CloseHandle)> mapping_holder(hMapping, CloseHandle);
+
+    // views must start at a multiple of the allocation granularity
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    int64_t offset_to_granularity = offset % static_cast<int64_t>(sysinfo.dwAllocationGranularity);
+    int64_t view_offset = offset - offset_to_granularity;
+    void* view = MapViewOfFile(hMapping, FILE_MAP_READ, static_cast<DWORD>(view_offset >> 32),
+                               static_cast<DWORD>(view_offset & 0xFFFFFFFF),
+                               len + static_cast<size_t>(offset_to_granularity));
+    if (view == nullptr) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "MapViewOfFile ", ToMBString(fname), " fail, errcode =", err);
+    }
+    // the view keeps the mapping alive after its handles are closed
+    deleter.f = UnmapFile;
+    deleter.param = view;
+    p = reinterpret_cast<char*>(view) + offset_to_granularity;
+    return common::Status::OK();
+  }
+
   common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const override {
     _wsopen_s(&fd, path.c_str(), _O_RDONLY | _O_SEQUENTIAL | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE);
     if (0 > fd) {
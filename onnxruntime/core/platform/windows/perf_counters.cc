@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/perf_counters.h"
+
+namespace onnxruntime {
+
+bool ReadThreadPerfCounters(PerfCounterValues& /*values*/) {
+  return false;
+}
+
+}  // namespace onnxruntime
@@ -26,13 +26,20 @@ Returns true if given tensor is a scalar or 1D tensor of size 1
 **/
 inline bool IsScalarOr1ElementVector(const Tensor* input) {
   if (input->Shape().NumDimensions() == 0 ||
-      (input->Shape().NumDimensions() == 1 && input->Shape().GetDims().size() == 1)) {
+      (input->Shape().NumDimensions() == 1 && input->Shape()[0] == 1)) {
     return true;
   } else {
     return false;
   }
 }
 
+/**
+Returns true if given tensor is a 1D tensor of the given size
+**/
+inline bool IsVectorOfSize(const Tensor* input, int64_t size) {
+  return input->Shape().NumDimensions() == 1 && input->Shape()[0] == size;
+}
+
 /**
 Clamps input between provided min and max values
 **/
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/activation/activations.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
@@ -28,12 +29,65 @@ REGISTER_UNARY_ELEMENTWISE_KERNEL(Softsign, 1);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(Tanh, 6);
 REGISTER_UNARY_ELEMENTWISE_KERNEL(ThresholdedRelu, 10);
 
+template <>
+Status HardSigmoid<float>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasHardSigmoidActivation;
+  activation.Parameters.HardSigmoid.alpha = alpha_;
+  activation.Parameters.HardSigmoid.beta = beta_;
+
+  ParallelForElements(*context, x_shape.Size(), 1.0, [&activation, x_data, y_data](int64_t first, int64_t last) {
+    const size_t count = static_cast<size_t>(last - first);
+    if (y_data != x_data) {
+      std::copy_n(x_data + first, count, y_data + first);
+    }
+    MlasActivation(&activation, y_data + first, nullptr, 1, count, count);
+  });
+  return Status::OK();
+}
+
+template <>
+Status ParametricSoftplus<float>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  const float alpha = alpha_;
+  const float beta = beta_;
+
+  // alpha * log(1 + exp(beta * x)) is computed as alpha * (max(beta * x, 0) + log(1 + exp(-|beta * x|))) so that
+  // exp doesn't overflow. The output buffer holds the intermediate values, so each element of X is read first.
+  ParallelForElements(*context, x_shape.Size(), 20.0, [alpha, beta, x_data, y_data](int64_t first, int64_t last) {
+    const size_t count = static_cast<size_t>(last - first);
+    ConstEigenVectorArrayMap<float> xm(x_data + first, count);
+    EigenVectorArrayMap<float> ym(y_data + first, count);
+    Eigen::ArrayXf bx = xm * beta;
+    ym = -bx.abs();
+    MlasComputeExp(ym.data(), ym.data(), count);
+    ym += 1.0f;
+    MlasComputeLog(ym.data(), ym.data(), count);
+    ym = alpha * (bx.cwiseMax(0.0f) + ym);
+  });
+  return Status::OK();
+}
+
 template <>
 Status Sigmoid<float>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& x_shape = X->Shape();
   Tensor* Y = context->Output(0, x_shape);
-  MlasComputeLogistic(X->template Data<float>(), Y->template MutableData<float>(), x_shape.Size());
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  ParallelForElements(*context, x_shape.Size(), 8.0, [x_data, y_data](int64_t first, int64_t last) {
+    MlasComputeLogistic(x_data + first, y_data + first, static_cast<size_t>(last - first));
+  });
   return Status::OK();
 }
 
@@ -42,7 +96,26 @@ Status Tanh<float>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& x_shape = X->Shape();
   Tensor* Y = context->Output(0, x_shape);
-  MlasComputeTanh(X->template Data<float>(), Y->template MutableData<float>(), x_shape.Size());
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  ParallelForElements(*context, x_shape.Size(), 8.0, [x_data, y_data](int64_t first, int64_t last) {
+    MlasComputeTanh(x_data + first, y_data + first, static_cast<size_t>(last - first));
+  });
+  return Status::OK();
+}
+
+template <>
+Status ThresholdedRelu<float>::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& x_shape = X->Shape();
+  Tensor* Y = context->Output(0, x_shape);
+  const float* x_data = X->template Data<float>();
+  float* y_data = Y->template MutableData<float>();
+  const float alpha = alpha_;
+  ParallelForElements(*context, x_shape.Size(), 1.0, [alpha, x_data, y_data](int64_t first, int64_t last) {
+    ConstEigenVectorArrayMap<float> xm(x_data + first, last - first);
+    EigenVectorArrayMap<float>(y_data + first, last - first) = (xm > alpha).select(xm, 0.0f);
+  });
   return Status::OK();
 }
 
@@ -51,6 +51,9 @@ class HardSigmoid final : public OpKernel {
   const float beta_;
 };
 
+template <>
+Status HardSigmoid<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class LeakyRelu final : public OpKernel {
  public:
@@ -89,6 +92,9 @@ class ParametricSoftplus final : public OpKernel {
   const float beta_;
 };
 
+template <>
+Status ParametricSoftplus<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class Relu : public OpKernel {
  public:
@@ -189,4 +195,7 @@ class ThresholdedRelu final : public OpKernel {
   const float alpha_;
 };
 
+template <>
+Status ThresholdedRelu<float>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
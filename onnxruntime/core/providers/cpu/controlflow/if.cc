@@ -306,7 +306,7 @@ Status IfImpl::Execute(const FeedsFetchesManager& ffm) {
   }
 
   status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
-                                  /*sequential_execution*/ true, context_.GetTerminateFlag(),
+                                  /*sequential_execution*/ true, context_.GetTerminationCheck(),
                                   context_.Logger());
 
   ORT_RETURN_IF_ERROR(status);
@@ -136,6 +136,10 @@ struct Loop::Info {
 
   std::vector<std::string> subgraph_input_names;
   std::vector<std::string> subgraph_output_names;
+
+  // whether the subgraph allocates the output for each loop carried var on CPU, in which case LoopImpl can provide
+  // the buffer. set by SetupSubgraphExecutionInfo.
+  std::vector<bool> loop_carried_var_allocated_on_cpu;
 };
 
 class LoopImpl {
@@ -155,6 +159,10 @@ class LoopImpl {
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // custom fetch allocator for the loop carried var outputs of the subgraph. re-uses the spare buffer of the
+  // loop carried var if it has the requested shape.
+  Status AllocateLoopCarriedVar(int index, const TensorShape& shape, OrtValue& ort_value);
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
@@ -173,6 +181,25 @@ class LoopImpl {
   // collection of OrtValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
+
+  /* The loop carried vars produced by an iteration are the feeds of the next one, after which their buffers are
+     free. Buffers allocated by AllocateLoopCarriedVar are recycled as the outputs of the iteration after that, so
+     each loop carried var flips between two buffers instead of being allocated in every iteration.
+
+     Iteration   Input             Output
+     0           Loop input        a (allocated)
+     1           a                 b (allocated)
+     2           b                 a
+     3           a                 b
+     ...
+  */
+  AllocatorPtr allocator_;
+  // buffer handed out by AllocateLoopCarriedVar in the current iteration
+  std::vector<OrtValue> allocated_loop_carried_vars_;
+  // buffer allocated for the output of the previous iteration, which is the current feed
+  std::vector<OrtValue> fed_loop_carried_vars_;
+  // buffer free to be handed out for the output of the next iteration
+  std::vector<OrtValue> spare_loop_carried_vars_;
 };
 
 Loop::Loop(const OpKernelInfo& info) : OpKernel(info) {
@@ -241,6 +268,21 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
   std::vector<const OrtMemoryInfo*> fetch_locations(info_->num_subgraph_outputs, nullptr);
   utils::FinalizeFeedFetchCopyInfo(subgraph_session_state, *ffm, feed_locations, fetch_locations);
 
+  // the buffers of the loop carried vars can be provided by a custom fetch allocator if the subgraph allocates them
+  // on CPU. outputs that are pre-existing values or shared with an input are not allocated by the subgraph.
+  const auto& allocation_plan = subgraph_session_state.GetExecutionPlan()->allocation_plan;
+  const auto& ort_value_name_idx_map = subgraph_session_state.GetOrtValueNameIdxMap();
+  info_->loop_carried_var_allocated_on_cpu.resize(info_->num_loop_carried_vars);
+  for (int i = 0; i < info_->num_loop_carried_vars; ++i) {
+    // + 1 to skip the cond subgraph output
+    int ort_value_idx;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(info_->subgraph_output_names[i + 1], ort_value_idx));
+    const auto& plan = allocation_plan[ort_value_idx];
+    info_->loop_carried_var_allocated_on_cpu[i] = plan.alloc_kind == AllocKind::kAllocateOutput &&
+                                                  plan.location.device.Type() == OrtDevice::CPU &&
+                                                  plan.location.device.MemType() == OrtDevice::MemType::DEFAULT;
+  }
+
   feeds_fetches_manager_ = std::move(ffm);
 
   return Status::OK();
@@ -309,8 +351,7 @@ Status LoopImpl::Initialize() {
     }
   }
 
-  AllocatorPtr allocator;
-  status = context_.GetTempSpaceAllocator(&allocator);
+  status = context_.GetTempSpaceAllocator(&allocator_);
   ORT_RETURN_IF_ERROR(status);
 
   auto& subgraph_inputs = info_.subgraph.GetInputs();
@@ -318,11 +359,15 @@ Status LoopImpl::Initialize() {
   auto iter_num_rank = subgraph_inputs[0]->Shape()->dim_size();
   auto condition_rank = subgraph_inputs[1]->Shape()->dim_size();
 
-  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(allocator, 0, iter_num_rank);
-  condition_mlvalue_ = MakeScalarMLValue<bool>(allocator, condition_, condition_rank);
+  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(allocator_, 0, iter_num_rank);
+  condition_mlvalue_ = MakeScalarMLValue<bool>(allocator_, condition_, condition_rank);
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
 
+  allocated_loop_carried_vars_.resize(info_.num_loop_carried_vars);
+  fed_loop_carried_vars_.resize(info_.num_loop_carried_vars);
+  spare_loop_carried_vars_.resize(info_.num_loop_carried_vars);
+
   return status;
 }
 
@@ -349,6 +394,32 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
+  auto shares_buffer = [&last_outputs](const OrtValue& value, size_t skip_output) {
+    const void* buffer = value.Get<Tensor>().DataRaw();
+    for (size_t i = 0, end = last_outputs.size(); i < end; ++i) {
+      if (i != skip_output && last_outputs[i].IsTensor() && last_outputs[i].Get<Tensor>().DataRaw() == buffer) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    // the buffer of the current feed is free unless the subgraph passed it through to an output.
+    // the buffer of the new output stays owned by the Loop unless it is also used for another output.
+    OrtValue& fed = fed_loop_carried_vars_[i];
+    OrtValue& allocated = allocated_loop_carried_vars_[i];
+    const auto output_idx = static_cast<size_t>(i) + 1;  // skip cond
+
+    spare_loop_carried_vars_[i] = fed.IsAllocated() && !shares_buffer(fed, last_outputs.size()) ? fed : OrtValue();
+
+    bool owned = allocated.IsAllocated() && last_outputs[output_idx].IsTensor() &&
+                 last_outputs[output_idx].Get<Tensor>().DataRaw() == allocated.Get<Tensor>().DataRaw() &&
+                 !shares_buffer(allocated, output_idx);
+    fed = owned ? allocated : OrtValue();
+    allocated = OrtValue();
+  }
+
   // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
   for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
@@ -360,6 +431,25 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   }
 }
 
+Status LoopImpl::AllocateLoopCarriedVar(int index, const TensorShape& shape, OrtValue& ort_value) {
+  OrtValue& spare = spare_loop_carried_vars_[index];
+
+  if (spare.IsAllocated() && spare.Get<Tensor>().Shape() == shape) {
+    ort_value = spare;
+  } else {
+    // the subgraph output has the type of the loop carried var input. +2 to skip 'M' and 'cond'
+    auto* data_type = context_.Input<Tensor>(index + 2)->DataType();
+    auto tensor = std::make_unique<Tensor>(data_type, shape, allocator_);
+    ort_value = OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                         DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+  }
+
+  spare = OrtValue();
+  allocated_loop_carried_vars_[index] = ort_value;
+
+  return Status::OK();
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   size_t bytes_per_iteration = first_output.SizeInBytes();
@@ -403,9 +493,19 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
+  // the fetch index is + 1 to skip cond, and the Loop input index + 2 to skip 'M' and 'cond'
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    if (info_.loop_carried_var_allocated_on_cpu[i] && context_.Input<Tensor>(i + 2) != nullptr) {
+      fetch_allocators[i + 1] = [this, i](const TensorShape& shape, OrtValue& ort_value) {
+        return AllocateLoopCarriedVar(i, shape, ort_value);
+      };
+    }
+  }
+
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
@@ -414,8 +514,8 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
-                                    /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
+                                    /*sequential_execution*/ true, context_.GetTerminationCheck(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -12,6 +12,8 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  ArenaConfig arena_config;
+  CPUAllocatorConfig allocator_config;
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -28,8 +30,11 @@ class CPUExecutionProvider : public IExecutionProvider {
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
       : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
-                                                [](int) { return std::make_unique<CPUAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                [allocator_config = info.allocator_config](int) {
+                                                  return std::make_unique<CPUAllocator>(allocator_config);
+                                                },
+                                                std::numeric_limits<size_t>::max(),
+                                                info.arena_config};
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
@@ -49,6 +54,9 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  // the default GetCapability only looks up a kernel for each node
+  bool IsCapabilityIndependentOfPlacement() const override { return true; }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
 };
@@ -9,28 +9,33 @@
 namespace onnxruntime {
 
 struct CpuProviderFactory : IExecutionProviderFactory {
-  CpuProviderFactory(bool create_arena) : create_arena_(create_arena) {}
+  CpuProviderFactory(const CPUExecutionProviderInfo& info) : info_(info) {}
   ~CpuProviderFactory() override = default;
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  bool create_arena_;
+  CPUExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CpuProviderFactory::CreateProvider() {
-  CPUExecutionProviderInfo info;
-  info.create_arena = create_arena_;
-  return std::make_unique<CPUExecutionProvider>(info);
+  return std::make_unique<CPUExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(const CPUExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::CpuProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena) {
-  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0);
+  return CreateExecutionProviderFactory_CPU(CPUExecutionProviderInfo(use_arena != 0));
 }
 
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CPU, _In_ OrtSessionOptions* options, int use_arena) {
-  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CPU(use_arena));
+  onnxruntime::CPUExecutionProviderInfo info(use_arena != 0);
+  info.arena_config = options->value.arena_config;
+  info.allocator_config = onnxruntime::GetCPUAllocatorConfig(options->value);
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CPU(info));
   return nullptr;
 }
 
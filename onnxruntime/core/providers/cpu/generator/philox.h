@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// The functions below are shared by the CPU kernels and the CUDA kernels, so the same seed gives the same stream
+// on every provider and platform.
+#ifdef __CUDACC__
+#define ORT_PHILOX_HOST_DEVICE __host__ __device__ __inline__
+#else
+#define ORT_PHILOX_HOST_DEVICE inline
+#endif
+
+namespace onnxruntime {
+
+// Philox4x32-10 from "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et al., SC 2011).
+// Each 64-bit counter gives a block of 4 random 32-bit values, computed independently of the other blocks,
+// so a tensor can be filled in any order and in parallel, and the result only depends on the seed and the counters.
+ORT_PHILOX_HOST_DEVICE void Philox4x32(uint64_t seed, uint64_t counter, uint32_t result[4]) {
+  uint32_t key0 = static_cast<uint32_t>(seed);
+  uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+  uint32_t x0 = static_cast<uint32_t>(counter);
+  uint32_t x1 = static_cast<uint32_t>(counter >> 32);
+  uint32_t x2 = 0;
+  uint32_t x3 = 0;
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * x0;
+    const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * x2;
+    const uint32_t hi0 = static_cast<uint32_t>(product0 >> 32);
+    const uint32_t hi1 = static_cast<uint32_t>(product1 >> 32);
+    x0 = hi1 ^ x1 ^ key0;
+    x1 = static_cast<uint32_t>(product1);
+    x2 = hi0 ^ x3 ^ key1;
+    x3 = static_cast<uint32_t>(product0);
+    key0 += 0x9E3779B9u;
+    key1 += 0xBB67AE85u;
+  }
+  result[0] = x0;
+  result[1] = x1;
+  result[2] = x2;
+  result[3] = x3;
+}
+
+// A block of 4 random values gives kValuesPerBlock uniform values in [0, 1) of type T.
+template <typename T>
+struct PhiloxUniform;
+
+template <>
+struct PhiloxUniform<float> {
+  static constexpr int kValuesPerBlock = 4;
+
+  ORT_PHILOX_HOST_DEVICE static void Generate(uint64_t seed, uint64_t counter, float* values) {
+    uint32_t bits[4];
+    Philox4x32(seed, counter, bits);
+    for (int i = 0; i < 4; ++i) {
+      values[i] = static_cast<float>(bits[i] >> 8) * (1.0f / 16777216.0f);
+    }
+  }
+};
+
+template <>
+struct PhiloxUniform<double> {
+  static constexpr int kValuesPerBlock = 2;
+
+  ORT_PHILOX_HOST_DEVICE static void Generate(uint64_t seed, uint64_t counter, double* values) {
+    uint32_t bits[4];
+    Philox4x32(seed, counter, bits);
+    for (int i = 0; i < 2; ++i) {
+      const uint64_t value = (static_cast<uint64_t>(bits[2 * i]) << 32) | bits[2 * i + 1];
+      values[i] = static_cast<double>(value >> 11) * (1.0 / 9007199254740992.0);
+    }
+  }
+};
+
+// PhiloxGenerator is the state of a random generator node. Every Compute() reserves the counters it needs,
+// so consecutive runs continue the stream, and runs of the same node on several threads get disjoint parts of it.
+class PhiloxGenerator {
+ public:
+  explicit PhiloxGenerator(uint64_t seed) : seed_(seed) {}
+
+  uint64_t Seed() const { return seed_; }
+
+  // Returns the first of count consecutive counters
+  uint64_t ReserveCounters(uint64_t count) { return next_counter_.fetch_add(count); }
+
+ private:
+  const uint64_t seed_;
+  std::atomic<uint64_t> next_counter_{0};
+};
+
+}  // namespace onnxruntime
@@ -27,7 +27,8 @@ limitations under the License.
 
 #include <algorithm>
 #include <chrono>
-#include <random>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/eigen_common_wrapper.h"
 #include "gsl/span"
@@ -70,11 +71,13 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<float>()).TypeConstraint("T2", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
+template <typename T, typename TChunkFunc>
+static void GenerateData(PhiloxGenerator& generator, Tensor& tensor, concurrency::ThreadPool* tp, TChunkFunc chunk_func);
 
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, TensorProto::DataType dtype, Tensor& Y,
+                                  concurrency::ThreadPool* tp);
+static Status RandomUniformCompute(float high, float low, PhiloxGenerator& generator, TensorProto::DataType dtype, Tensor& Y,
+                                   concurrency::ThreadPool* tp);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -82,8 +85,8 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y, tp);
 
   return status;
 }
@@ -91,8 +94,8 @@ Status RandomNormal::Compute(OpKernelContext* ctx) const {
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y, tp);
 
   return status;
 }
@@ -113,8 +116,8 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y, tp);
 
   return status;
 }
@@ -134,8 +137,8 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y, tp);
 
   return status;
 }
@@ -156,56 +159,74 @@ static Status MultinomialCompute(OpKernelContext* ctx,
                                  const int64_t batch_size,
                                  const int64_t num_classes,
                                  const int64_t num_samples,
-                                 std::default_random_engine& generator,
+                                 PhiloxGenerator& generator,
                                  Tensor& Y) {
-  // implementation copied from Tensorflow with some changes such as using the std::uniform_real_distribution
-  // instead of the Philox RNG.
+  // implementation copied from Tensorflow with some changes such as drawing the samples of each batch from its own
+  // part of the Philox stream, so the batches can be sampled in parallel.
   Eigen::array<int64_t, 2> X_dims = {{batch_size, num_classes}};
   ConstMatrix<float> logits = ConstMatrix<float>(X.template Data<float>(), X_dims);
 
   Eigen::array<int64_t, 2> Y_dims = {{batch_size, num_samples}};
   Matrix<OutputType> output = Matrix<OutputType>(Y.template MutableData<OutputType>(), Y_dims);
 
-  // BEGIN create temporary tensor
+  const int64_t values_per_block = PhiloxUniform<double>::kValuesPerBlock;
+  const int64_t blocks_per_batch = (num_samples + values_per_block - 1) / values_per_block;
+  const uint64_t first_counter = generator.ReserveCounters(batch_size * blocks_per_batch);
+  const uint64_t seed = generator.Seed();
+
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-  auto cdf_data = static_cast<double*>(alloc->Alloc(sizeof(double) * num_classes));
-  BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(alloc));
-  Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
-  auto cdf = EigenVector<double>(cdf_data, cdf_dims);
-  // END create temporary tensor
-
-  std::uniform_real_distribution<double> dist(0.0, 1.0);  // TODO: should this be initialized per batch?
-
-  for (int64_t b = 0; b < batch_size; ++b) {
-    const float* logits_row = &(logits(b, 0));
-    // Takes an along-class maximum (for numerical stability).
-    float maxx = std::numeric_limits<float>::lowest();
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        maxx = std::max(maxx, logits_row[j]);
+
+  auto sample_batches = [&](int64_t first_batch, int64_t last_batch) {
+    // BEGIN create temporary tensor
+    auto cdf_data = static_cast<double*>(alloc->Alloc(sizeof(double) * num_classes));
+    BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(alloc));
+    Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
+    auto cdf = EigenVector<double>(cdf_data, cdf_dims);
+    // END create temporary tensor
+
+    for (int64_t b = first_batch; b < last_batch; ++b) {
+      const float* logits_row = &(logits(b, 0));
+      // Takes an along-class maximum (for numerical stability).
+      float maxx = std::numeric_limits<float>::lowest();
+      for (int64_t j = 0; j < num_classes; ++j) {
+        if (Eigen::numext::isfinite(logits_row[j])) {
+          maxx = std::max(maxx, logits_row[j]);
+        }
       }
-    }
-    const auto max_logit = static_cast<double>(maxx);
-
-    // Precompute cumulative probability distribution across classes.
-    // Note: This isn't normalized.
-    cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
-    double running_total = 0;
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        running_total += cdf(j);
+      const auto max_logit = static_cast<double>(maxx);
+
+      // Precompute cumulative probability distribution across classes.
+      // Note: This isn't normalized.
+      cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
+      double running_total = 0;
+      for (int64_t j = 0; j < num_classes; ++j) {
+        if (Eigen::numext::isfinite(logits_row[j])) {
+          running_total += cdf(j);
+        }
+        cdf(j) = running_total;
+      }
+      // Generate each sample.
+      const double* cdf_begin = cdf.data();
+      const double* cdf_end = cdf.data() + num_classes;
+      uint64_t counter = first_counter + b * blocks_per_batch;
+      double uniforms[PhiloxUniform<double>::kValuesPerBlock];
+      for (int64_t j = 0; j < num_samples; ++j) {
+        if (j % values_per_block == 0) {
+          PhiloxUniform<double>::Generate(seed, counter++, uniforms);
+        }
+        const double to_find = uniforms[j % values_per_block] * running_total;
+        auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
+        output(b, j) = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
       }
-      cdf(j) = running_total;
-    }
-    // Generate each sample.
-    const double* cdf_begin = cdf.data();
-    const double* cdf_end = cdf.data() + num_classes;
-    for (int64_t j = 0; j < num_samples; ++j) {
-      const double to_find = dist(generator) * running_total;
-      auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
-      output(b, j) = static_cast<OutputType>(std::distance(cdf_begin, found_iter));
     }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    sample_batches(0, batch_size);
+  } else {
+    tp->ParallelForRange(0, batch_size, static_cast<double>(num_classes + num_samples) * 10.0, sample_batches);
   }
 
   return Status::OK();
@@ -238,7 +259,6 @@ Status Multinomial::Compute(OpKernelContext* ctx) const {
   Tensor* Y = ctx->Output(0, TensorShape({batch_size, num_samples_}));
 
   Status status = Status::OK();
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
   switch (output_dtype_) {
     case TensorProto::INT32: {
       status = MultinomialCompute<int32_t>(ctx, X, batch_size, num_classes, num_samples_, generator_, *Y);
@@ -279,21 +299,80 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
   return dtype;
 }
 
+// The values are generated a chunk at a time, and every chunk starts at a fixed index, so the result doesn't depend
+// on the number of threads.
+static constexpr int64_t kRandomChunkSize = 1024;
+
+// Fills uniforms with count uniform values in [0, 1), plus the rest of the last Philox block
+template <typename T>
+static void GenerateUniformChunk(uint64_t seed, uint64_t first_counter, int64_t count, T* uniforms) {
+  const int64_t values_per_block = PhiloxUniform<T>::kValuesPerBlock;
+  uint64_t counter = first_counter;
+  for (int64_t i = 0; i < count; i += values_per_block) {
+    PhiloxUniform<T>::Generate(seed, counter++, uniforms + i);
+  }
+}
+
+template <typename T>
+static void UniformChunk(T low, T high, uint64_t seed, uint64_t first_counter, int64_t count, T* out) {
+  T uniforms[kRandomChunkSize];
+  GenerateUniformChunk(seed, first_counter, count, uniforms);
+  EigenVectorArrayMap<T>(out, count) = ConstEigenVectorArrayMap<T>(uniforms, count) * (high - low) + low;
+}
+
+// Box-Muller transform: each pair of uniform values gives a pair of independent normal values. The logarithms and
+// trigonometric functions are computed on contiguous arrays, which Eigen vectorizes.
+template <typename T>
+static void NormalChunk(T mean, T scale, uint64_t seed, uint64_t first_counter, int64_t count, T* out) {
+  T uniforms[kRandomChunkSize];
+  GenerateUniformChunk(seed, first_counter, count, uniforms);
+
+  const int64_t pairs = (count + 1) / 2;
+  T radius[kRandomChunkSize / 2];
+  T angle[kRandomChunkSize / 2];
+  for (int64_t i = 0; i < pairs; ++i) {
+    // 1 - u is in (0, 1], so its logarithm is finite
+    radius[i] = T(1) - uniforms[2 * i];
+    angle[i] = uniforms[2 * i + 1];
+  }
+  EigenVectorArrayMap<T> radius_vector(radius, pairs);
+  EigenVectorArrayMap<T> angle_vector(angle, pairs);
+  radius_vector = (radius_vector.log() * T(-2)).sqrt() * scale;
+  angle_vector *= T(2 * M_PI);
+
+  T cosines[kRandomChunkSize / 2];
+  T sines[kRandomChunkSize / 2];
+  EigenVectorArrayMap<T>(cosines, pairs) = radius_vector * angle_vector.cos() + mean;
+  EigenVectorArrayMap<T>(sines, pairs) = radius_vector * angle_vector.sin() + mean;
+  for (int64_t i = 0; i < count / 2; ++i) {
+    out[2 * i] = cosines[i];
+    out[2 * i + 1] = sines[i];
+  }
+  if (count % 2 != 0) {
+    out[count - 1] = cosines[pairs - 1];
+  }
+}
+
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
-                                  TensorProto::DataType dtype, Tensor& Y) {
+                                  PhiloxGenerator& generator,
+                                  TensorProto::DataType dtype, Tensor& Y,
+                                  concurrency::ThreadPool* tp) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::normal_distribution<float>>(
-          generator, std::normal_distribution<float>{mean, scale}, Y);
+      GenerateData<float>(generator, Y, tp,
+                          [mean, scale](uint64_t seed, uint64_t first_counter, int64_t count, float* out) {
+                            NormalChunk<float>(mean, scale, seed, first_counter, count, out);
+                          });
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::normal_distribution<double>>(
-          generator, std::normal_distribution<double>{mean, scale}, Y);
+      GenerateData<double>(generator, Y, tp,
+                           [mean, scale](uint64_t seed, uint64_t first_counter, int64_t count, double* out) {
+                             NormalChunk<double>(mean, scale, seed, first_counter, count, out);
+                           });
       break;
     }
     default:
@@ -304,21 +383,26 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxGenerator& generator,
                                    TensorProto::DataType dtype,
-                                   Tensor& Y) {
+                                   Tensor& Y,
+                                   concurrency::ThreadPool* tp) {
   switch (dtype) {
     case TensorProto::FLOAT: {
-      GenerateData<float, std::uniform_real_distribution<float>>(
-          generator, std::uniform_real_distribution<float>{low, high}, Y);
+      GenerateData<float>(generator, Y, tp,
+                          [low, high](uint64_t seed, uint64_t first_counter, int64_t count, float* out) {
+                            UniformChunk<float>(low, high, seed, first_counter, count, out);
+                          });
       break;
     }
     case TensorProto::FLOAT16: {
       ORT_NOT_IMPLEMENTED("FLOAT16 is not supported");
     }
     case TensorProto::DOUBLE: {
-      GenerateData<double, std::uniform_real_distribution<double>>(
-          generator, std::uniform_real_distribution<double>{low, high}, Y);
+      GenerateData<double>(generator, Y, tp,
+                           [low, high](uint64_t seed, uint64_t first_counter, int64_t count, double* out) {
+                             UniformChunk<double>(low, high, seed, first_counter, count, out);
+                           });
       break;
     }
     default:
@@ -328,12 +412,27 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
+template <typename T, typename TChunkFunc>
+static void GenerateData(PhiloxGenerator& generator, Tensor& tensor, concurrency::ThreadPool* tp, TChunkFunc chunk_func) {
   T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
+  const int64_t size = tensor.Shape().Size();
+  const int64_t values_per_block = PhiloxUniform<T>::kValuesPerBlock;
+  const uint64_t first_counter = generator.ReserveCounters((size + values_per_block - 1) / values_per_block);
+  const uint64_t seed = generator.Seed();
+
+  auto generate_chunks = [&](int64_t first_chunk, int64_t last_chunk) {
+    for (int64_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+      const int64_t first = chunk * kRandomChunkSize;
+      chunk_func(seed, first_counter + first / values_per_block, std::min(kRandomChunkSize, size - first),
+                 out + first);
+    }
+  };
+
+  const int64_t num_chunks = (size + kRandomChunkSize - 1) / kRandomChunkSize;
+  if (tp == nullptr) {
+    generate_chunks(0, num_chunks);
+  } else {
+    tp->ParallelForRange(0, num_chunks, kRandomChunkSize * 30.0, generate_chunks);
   }
 }
 
@@ -3,32 +3,30 @@
 
 #pragma once
 
-#include <random>
+#include <chrono>
 #include "gsl/gsl_util"
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
-#include "core/platform/ort_mutex.h"
+#include "core/providers/cpu/generator/philox.h"
 
 namespace onnxruntime {
 
+// read optional seed attribute and generate if not provided
+inline uint64_t GetRandomSeed(const OpKernelInfo& info) {
+  float seed = 0.f;
+  if (info.GetAttr<float>("seed", &seed).IsOK()) {
+    return gsl::narrow_cast<uint32_t>(seed);
+  }
+  return gsl::narrow_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
 class RandomNormal final : public OpKernel {
  public:
-  RandomNormal(const OpKernelInfo& info) : OpKernel(info) {
+  RandomNormal(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    }
-    else {
-      generator_ = std::default_random_engine{
-        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-      };
-    }
-
     int64_t dtype;
     ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
     dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
@@ -46,32 +44,19 @@ class RandomNormal final : public OpKernel {
   float mean_;
   float scale_;
   
-  // generator_ is updated with every call to Compute(). 
-  // use generator_mutex_ to ensure Compute() can be called concurrently.
-  // this is to ensure that a model with random generators is deterministic and still can be executed in parallel.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // generator_ advances with every call to Compute(), so a model with random generators is deterministic for a
+  // given seed, and Compute() can still be called concurrently.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_;
   TensorShape shape_;
 };
 
 class RandomNormalLike final : public OpKernel {
  public:
-  RandomNormalLike(const OpKernelInfo& info) : OpKernel(info) {
+  RandomNormalLike(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    }
-    else {
-      generator_ = std::default_random_engine{
-        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-      };
-    }
-
     int64_t dtype;
     if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
       dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
@@ -86,29 +71,17 @@ class RandomNormalLike final : public OpKernel {
   float mean_;
   float scale_;
   
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  //optional and may be inferred
 };
 
 class RandomUniform final : public OpKernel {
  public:
-  RandomUniform(const OpKernelInfo& info) : OpKernel(info) {
+  RandomUniform(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    }
-    else {
-      generator_ = std::default_random_engine{
-        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-      };
-    }
-
     int64_t dtype;
     ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
     dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
@@ -126,28 +99,17 @@ class RandomUniform final : public OpKernel {
   float high_;
   float low_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_;
   TensorShape shape_;
 };
 
 class RandomUniformLike final : public OpKernel {
  public:
-  RandomUniformLike(const OpKernelInfo& info) : OpKernel(info) {
+  RandomUniformLike(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    }
-    else {
-      generator_ = std::default_random_engine{
-        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-      };
-    }
 
     int64_t dtype;
     if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
@@ -163,27 +125,16 @@ class RandomUniformLike final : public OpKernel {
   float high_;
   float low_;
   
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  //optional and may be inferred
 };
 
 class Multinomial final : public OpKernel {
  public:
-  Multinomial(const OpKernelInfo& info) : OpKernel(info) {
+  Multinomial(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomSeed(info)) {
     ORT_ENFORCE(info.GetAttr<int64_t>("sample_size", &num_samples_).IsOK());
 
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    }
-    else {
-      generator_ = std::default_random_engine{
-        gsl::narrow_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-      };
-    }
-
     int64_t output_dtype_tmp;
     if (!info.GetAttr<int64_t>("dtype", &output_dtype_tmp).IsOK()) {
       output_dtype_ = ONNX_NAMESPACE::TensorProto_DataType_INT32;  // default is INT32 as per spec
@@ -199,9 +150,8 @@ class Multinomial final : public OpKernel {
  private:
   int64_t num_samples_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType output_dtype_;
 };
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include <unsupported/Eigen/SpecialFunctions>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/tile.h"
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
 
@@ -10,12 +12,14 @@
 
 namespace onnxruntime {
 
-#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      OP_TYPE,                                                                     \
-      VERSION,                                                                     \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+// The elementwise kernels compute each output element from the input elements at the same position (input 0 is
+// never broadcast onto a larger output when the planner reuses it), so the output may overwrite input 0.
+#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)                          \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      OP_TYPE,                                                                                      \
+      VERSION,                                                                                      \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -32,7 +36,7 @@ namespace onnxruntime {
       OP_TYPE,                                                                                        \
       VERSION_FROM, VERSION_TO,                                                                       \
       TYPE,                                                                                           \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                    \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),   \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
@@ -133,28 +137,28 @@ REG_ELEMENTWISE_TYPED_KERNEL(Erf, 9, float, Erf);
 ONNX_CPU_OPERATOR_KERNEL(
     Not,
     1,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Not);
 
 ONNX_CPU_OPERATOR_KERNEL(
     And,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     And);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Or,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Or);
 
 ONNX_CPU_OPERATOR_KERNEL(
     Xor,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<bool>())
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Xor);
 
@@ -218,8 +222,13 @@ template <>
 Status Reciprocal<float>::Compute(OpKernelContext* ctx) const {
   auto& X = *ctx->Input<Tensor>(0);
   auto& Y = *ctx->Output(0, X.Shape());
+  const float* x_data = X.Data<float>();
+  float* y_data = Y.MutableData<float>();
 
-  EigenMap<float>(Y) = EigenMap<float>(X).cwiseInverse();
+  ParallelForElements(*ctx, X.Shape().Size(), 2.0, [x_data, y_data](int64_t first, int64_t last) {
+    EigenVectorArrayMap<float>(y_data + first, last - first) =
+        ConstEigenVectorArrayMap<float>(x_data + first, last - first).inverse();
+  });
 
   return Status::OK();
 }
@@ -234,6 +243,20 @@ Status Sqrt<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status Sqrt<float>::Compute(OpKernelContext* ctx) const {
+  auto& X = *ctx->Input<Tensor>(0);
+  auto& Y = *ctx->Output(0, X.Shape());
+  const float* x_data = X.Data<float>();
+  float* y_data = Y.MutableData<float>();
+
+  ParallelForElements(*ctx, X.Shape().Size(), 4.0, [x_data, y_data](int64_t first, int64_t last) {
+    MlasComputeSqrt(x_data + first, y_data + first, static_cast<size_t>(last - first));
+  });
+
+  return Status::OK();
+}
+
 template <typename T>
 Status Pow<T>::Compute(OpKernelContext* context) const {
   const Tensor& Y = *context->Input<Tensor>(1);
@@ -243,6 +266,11 @@ Status Pow<T>::Compute(OpKernelContext* context) const {
     T value = *Y.Data<T>();
     if (value == 2.0) {
       input1scalar = [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T) { output = Eigen::square(input0.array()); };
+    } else if (value == 0.5 && std::is_same<T, float>::value) {
+      input1scalar = [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T) {
+        MlasComputeSqrt(reinterpret_cast<const float*>(input0.data()), reinterpret_cast<float*>(output.data()),
+                        static_cast<size_t>(input0.size()));
+      };
     } else if (value == 3.0) {
       input1scalar = [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T) { output = Eigen::cube(input0.array()); };
     }
@@ -265,12 +293,30 @@ Status Exp<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status Exp<float>::Compute(OpKernelContext* ctx) const {
+  auto& X = *ctx->Input<Tensor>(0);
+  auto& Y = *ctx->Output(0, X.Shape());
+  const float* x_data = X.Data<float>();
+  float* y_data = Y.MutableData<float>();
+
+  ParallelForElements(*ctx, X.Shape().Size(), 8.0, [x_data, y_data](int64_t first, int64_t last) {
+    MlasComputeExp(x_data + first, y_data + first, static_cast<size_t>(last - first));
+  });
+
+  return Status::OK();
+}
+
 template <>
 Status Log<float>::Compute(OpKernelContext* ctx) const {
   auto& X = *ctx->Input<Tensor>(0);
   auto& Y = *ctx->Output(0, X.Shape());
+  const float* x_data = X.Data<float>();
+  float* y_data = Y.MutableData<float>();
 
-  EigenMap<float>(Y) = EigenMap<float>(X).array().log();
+  ParallelForElements(*ctx, X.Shape().Size(), 8.0, [x_data, y_data](int64_t first, int64_t last) {
+    MlasComputeLog(x_data + first, y_data + first, static_cast<size_t>(last - first));
+  });
 
   return Status::OK();
 }
@@ -789,33 +835,6 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
-// This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
-template <typename T>
-struct TBroadcasterExpand {
-  TBroadcasterExpand(const Tensor& input, const std::vector<int64_t>& shape)
-      : input_tensor_(input),
-        broadcaster_(input.Shape().GetDims(), shape) {
-  }
-
-  TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
-  size_t GetSpanSize() const { return span_size_; }
-
-  bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
-
-  T NextScalar() { return *Next(); }
-
-  ConstEigenVectorMap<T> NextEigen() { return ConstEigenVectorMap<T>(Next(), span_size_); }
-
- private:
-  const T* Next() { return input_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
-
-  const Tensor& input_tensor_;
-  Broadcaster broadcaster_;
-  size_t span_size_{broadcaster_.GetSpanSize()};
-
-  const T* input_{input_tensor_.template Data<T>()};
-};
-
 template <typename T>
 Status Expand_8<T>::Compute(OpKernelContext* context) const {
   auto& tensor_shape = *context->Input<Tensor>(1);
@@ -825,19 +844,47 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
   const auto* p_shape = tensor_shape.template Data<int64_t>();
   std::vector<int64_t> shape{p_shape, p_shape + tensor_shape.Shape().Size()};
 
-  TBroadcasterExpand<T> bc(*context->Input<Tensor>(0), shape);
-  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
+  // Only the output shape of the broadcast is needed, as there is no second tensor
+  const auto& input = *context->Input<Tensor>(0);
+  Broadcaster broadcaster(input.Shape().GetDims(), shape);
+  TensorShape output_shape(broadcaster.output_shape_);
+
+  // The output repeats the input along the broadcast axes, so it is a view of the input with a stride of 0 on them
+  // when it's planned as one.
+  const auto& input_dims = input.Shape().GetDims();
+  const size_t output_rank = output_shape.NumDimensions();
+  const size_t leading_axes = output_rank - input_dims.size();
+  std::vector<int64_t> output_strides(output_rank, 0);
+  int64_t input_stride = 1;
+  for (size_t axis = output_rank; axis-- > leading_axes;) {
+    const int64_t input_dim = input_dims[axis - leading_axes];
+    if (input_dim == output_shape[axis]) {
+      output_strides[axis] = input_stride;
+    }
+    input_stride *= input_dim;
+  }
+  if (static_cast<OpKernelContextInternal*>(context)->OutputView(0, 0, output_shape, output_strides, 0) != nullptr)
+    return Status::OK();
+
+  auto& output = *context->Output(0, output_shape);
+  if (output_shape.Size() == 0)
+    return Status::OK();
 
-  // This doesn't use BroadcastLoop since there is no second tensor, just duplicating the first
-  if (bc.IsInput0Scalar()) {
-    // Input0 being a scalar is the only special case here, since we're duplicating a single value
-    while (output)
-      output.NextEigenOutput().array() = bc.NextScalar();
-  } else {
-    // Input1 being a scalar doesn't matter (as there's no actual input1). We're still duplicating Input0 in the same sized chunks
-    while (output)
-      output.NextEigenOutput() = bc.NextEigen();
+  // The output is the input tiled along the broadcast axes, where the input has a size of 1, so it's filled by
+  // doubling memcpy's of the input rows instead of one span at a time.
+  std::vector<int64_t> tile_input_dims(leading_axes, 1);
+  tile_input_dims.insert(tile_input_dims.end(), input_dims.begin(), input_dims.end());
+  std::vector<int64_t> repeats(output_rank);
+  for (size_t axis = 0; axis < output_rank; ++axis) {
+    repeats[axis] = output_shape[axis] / tile_input_dims[axis];
   }
+  if (output_rank == 0) {
+    tile_input_dims.push_back(1);
+    repeats.push_back(1);
+  }
+
+  TileFixedSizeData(input.DataRaw(), tile_input_dims, output.MutableDataRaw(), repeats.data(), sizeof(T),
+                    static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
   return Status::OK();
 }
 
@@ -846,7 +893,9 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
       Expand,                                                                      \
       8,                                                                           \
       TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KernelDefBuilder()                                                           \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>())                \
+          .MayStridedOutput(0, 0),                                                 \
       Expand_8<TYPE>);
 
 REG_EXPAND_KERNEL(float)
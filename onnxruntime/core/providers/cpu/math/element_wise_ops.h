@@ -5,6 +5,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -138,6 +140,12 @@ class Log final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+// The float kernels run on the vectorized MLAS routines.
+template <>
+Status Sqrt<float>::Compute(OpKernelContext* context) const;
+template <>
+Status Exp<float>::Compute(OpKernelContext* context) const;
+
 template <typename T>
 class Sum_6 : public OpKernel {
  public:
@@ -320,6 +328,28 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Moves the iterator to the given element of the output, as if AdvanceBy had been called from the start to get
+  // there, so that different parts of the output can be computed independently.
+  void MoveTo(size_t position) {
+    index_ = IndexAt(position);
+    for (size_t counterIndex = 0; counterIndex < counters_.size(); counterIndex++) {
+      counters_[counterIndex] = position % counts_[counterIndex];
+      position /= counts_[counterIndex];
+    }
+  }
+
+  // The index AdvanceBy returns at the given element of the output, without moving the iterator.
+  size_t IndexAt(size_t position) const {
+    ptrdiff_t index = 0;
+    ptrdiff_t stride = 0;  // how far the index moves each time the counter is incremented
+    for (size_t counterIndex = 0; counterIndex < counts_.size(); counterIndex++) {
+      stride = counterIndex == 0 ? deltas_[0] : stride * counts_[counterIndex - 1] + deltas_[counterIndex];
+      index += stride * static_cast<ptrdiff_t>(position % counts_[counterIndex]);
+      position /= counts_[counterIndex];
+    }
+    return static_cast<size_t>(index);
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(max_dims);
     counts_.reserve(max_dims);
@@ -460,6 +490,17 @@ struct Broadcaster {
   std::vector<int64_t> output_shape_;
 };
 
+// The broadcasting of two inputs, which kernels cache while the input shapes stay the same. Each run iterates a
+// copy of the broadcaster.
+struct BroadcastState {
+  BroadcastState(const Tensor& input0, const Tensor& input1)
+      : broadcaster(input0.Shape().GetDims(), input1.Shape().GetDims()),
+        output_shape(broadcaster.output_shape_) {}
+
+  Broadcaster broadcaster;
+  TensorShape output_shape;
+};
+
 template <typename T0, typename T1>
 struct TBroadcaster {
   TBroadcaster(const Tensor& input0, const Tensor& input1)
@@ -467,6 +508,13 @@ struct TBroadcaster {
         input_tensor1_(input1) {
   }
 
+  // Iterate the inputs with a copy of a broadcaster already set up for their shapes
+  TBroadcaster(const Tensor& input0, const Tensor& input1, const Broadcaster& broadcaster)
+      : input_tensor0_(input0),
+        input_tensor1_(input1),
+        broadcaster_(broadcaster) {
+  }
+
   TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
   size_t GetSpanSize() const { return span_size_; }
 
@@ -482,6 +530,16 @@ struct TBroadcaster {
   ConstEigenVectorMap<T0> NextEigen0() { return ConstEigenVectorMap<T0>(Next0(), span_size_); }
   ConstEigenVectorMap<T1> NextEigen1() { return ConstEigenVectorMap<T1>(Next1(), span_size_); }
 
+  // Continue from the given element of the output, which must be the start of a span
+  void MoveTo(size_t position) {
+    broadcaster_.iterator1_.MoveTo(position);
+    broadcaster_.iterator2_.MoveTo(position);
+  }
+
+  // The inputs at any element of the output, for splitting a span between threads
+  const T0* Input0At(size_t position) const { return input0_ + broadcaster_.iterator1_.IndexAt(position); }
+  const T1* Input1At(size_t position) const { return input1_ + broadcaster_.iterator2_.IndexAt(position); }
+
  private:
   const T0* Next0() { return input0_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
   const T1* Next1() { return input1_ + broadcaster_.iterator2_.AdvanceBy(span_size_); }
@@ -503,6 +561,13 @@ struct TBroadcastOutput {
     output_end_ = output_ + tensor.Shape().Size();
   }
 
+  // Output for the elements [begin, end) of the tensor, which must start and end on spans
+  TBroadcastOutput(size_t span_size, Tensor& tensor, size_t begin, size_t end)
+      : span_size_(span_size) {
+    output_ = tensor.template MutableData<T>() + begin;
+    output_end_ = tensor.template MutableData<T>() + end;
+  }
+
   operator bool() const {
     return output_ != output_end_;
   }
@@ -583,11 +648,88 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// BroadcastLoop that splits the output between the threads of the pool once it's large enough to be worth it.
+// Runs of short spans are computed with a BroadcastLoop each, and long spans (or the whole output, when nothing is
+// broadcast) are cut into pieces that are computed directly, with the same functions as BroadcastLoop.
+template <typename TOutput, typename T0, typename T1, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(concurrency::ThreadPool* tp, TBroadcaster<T0, T1>& bc, Tensor& output_tensor,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  // in elements, about the size where splitting the work beats the cost of scheduling it
+  constexpr int64_t kMinParallelSize = 16384;
+  constexpr int64_t kPieceSize = 4096;
+
+  const int64_t output_size = output_tensor.Shape().Size();
+  const int64_t span_size = static_cast<int64_t>(bc.GetSpanSize());
+  if (tp == nullptr || output_size < kMinParallelSize) {
+    TBroadcastOutput<TOutput> output(span_size, output_tensor);
+    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    return;
+  }
+
+  const double element_cost = static_cast<double>(sizeof(T0) + sizeof(T1) + sizeof(TOutput));
+  const int64_t span_count = output_size / span_size;
+
+  if (span_size < 2 * kPieceSize) {
+    tp->ParallelForRange(0, span_count, element_cost * span_size, [&](int64_t first, int64_t last) {
+      TBroadcaster<T0, T1> spans_bc(bc);
+      spans_bc.MoveTo(first * span_size);
+      TBroadcastOutput<TOutput> output(span_size, output_tensor, first * span_size, last * span_size);
+      BroadcastLoop(spans_bc, output, input0scalar, input1scalar, general);
+    });
+    return;
+  }
+
+  const int64_t pieces_per_span = (span_size + kPieceSize - 1) / kPieceSize;
+  const int64_t piece_size = (span_size + pieces_per_span - 1) / pieces_per_span;
+  const bool input0_scalar = bc.IsInput0Scalar();
+  const bool input1_scalar = bc.IsInput1Scalar();
+  TOutput* output = output_tensor.template MutableData<TOutput>();
+
+  tp->ParallelForRange(0, span_count * pieces_per_span, element_cost * piece_size, [&](int64_t first, int64_t last) {
+    for (int64_t piece = first; piece < last; piece++) {
+      const int64_t span_begin = (piece / pieces_per_span) * span_size;
+      const int64_t begin = span_begin + (piece % pieces_per_span) * piece_size;
+      const int64_t count = std::min(piece_size, span_begin + span_size - begin);
+      EigenVectorMap<TOutput> output_piece(output + begin, count);
+      if (input0_scalar) {
+        input0scalar(output_piece, *bc.Input0At(span_begin), ConstEigenVectorMap<T1>(bc.Input1At(begin), count));
+      } else if (input1_scalar) {
+        input1scalar(output_piece, ConstEigenVectorMap<T0>(bc.Input0At(begin), count), *bc.Input1At(span_begin));
+      } else {
+        general(output_piece, ConstEigenVectorMap<T0>(bc.Input0At(begin), count),
+                ConstEigenVectorMap<T1>(bc.Input1At(begin), count));
+      }
+    }
+  });
+}
+
+// Runs fn(first, last) over the count elements of a unary elementwise kernel, split across the operator thread pool
+// once the cost_per_element cycles of each element add up to enough work to be worth it.
+template <typename Fn>
+void ParallelForElements(OpKernelContext& context, int64_t count, double cost_per_element, Fn fn) {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal&>(context).GetOperatorThreadPool();
+  if (tp == nullptr) {
+    fn(0, count);
+  } else {
+    tp->ParallelForRange(0, count, cost_per_element, fn);
+  }
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
-  TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  const auto& input0 = *context.Input<Tensor>(0);
+  const auto& input1 = *context.Input<Tensor>(1);
+
+  // the broadcasting is cached while the input shapes stay the same, if the session enables its shape cache
+  auto state = context.GetShapeCachedState<BroadcastState>();
+  if (state == nullptr) {
+    state = std::make_shared<const BroadcastState>(input0, input1);
+    context.SetShapeCachedState(state);
+  }
+
+  TBroadcaster<TInput, TInput> bc(input0, input1, state->broadcaster);
+  ParallelBroadcastLoop<TOutput>(static_cast<OpKernelContextInternal&>(context).GetOperatorThreadPool(), bc,
+                                 *context.Output(0, state->output_shape), input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -624,9 +766,8 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TOutput>(static_cast<OpKernelContextInternal&>(context).GetOperatorThreadPool(), bc,
+                                   *p_output, input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
@@ -5,10 +5,84 @@
 
 namespace onnxruntime {
 
-ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     Gemm,
     7,
     9,
+    float,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    7,
+    9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gemm<MLFloat16>);
+
+Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  const auto X = context->Input<Tensor>(0);
+  const auto W = context->Input<Tensor>(1);
+  const auto B = context->Input<Tensor>(2);
+  GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans, B->Shape());
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int64_t M = helper.M();
+  int64_t N = helper.N();
+  auto Y = context->Output(0, {M, N});
+  // if input is emtpy tensor, return directly as nothing need to be calculated.
+  if (M == 0 || N == 0)
+    return Status::OK();
+  MLFloat16* y_data = Y->MutableData<MLFloat16>();
+  const int64_t K = helper.K();
+
+  if (beta_ != 0) {
+    // Broadcast the bias into the output, which MLAS then scales by beta.
+    const auto& b_shape = B->Shape();
+    const MLFloat16* b_data = B->Data<MLFloat16>();
+    if (b_shape.Size() == 1) {
+      // B is (), (1,) or (1, 1), set the scalar
+      std::fill_n(y_data, M * N, *b_data);
+    } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+      // B is (N,) or (1, N)
+      for (int64_t m = 0; m < M; m++) {
+        std::copy_n(b_data, N, y_data + m * N);
+      }
+    } else if (b_shape[1] == 1) {
+      // B is (M, 1)
+      for (int64_t m = 0; m < M; m++) {
+        std::fill_n(y_data + m * N, N, b_data[m]);
+      }
+    } else {
+      // B is (M, N), no broadcast needed.
+      std::copy_n(b_data, M * N, y_data);
+    }
+  }
+
+  // MLFloat16 holds the raw IEEE half bits that MLAS operates on.
+  MlasHalfGemm(
+      trans_A_,
+      trans_B_,
+      static_cast<size_t>(M),
+      static_cast<size_t>(N),
+      static_cast<size_t>(K),
+      alpha_,
+      reinterpret_cast<const MLAS_FP16*>(X->Data<MLFloat16>()),
+      static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+      reinterpret_cast<const MLAS_FP16*>(W->Data<MLFloat16>()),
+      static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+      beta_,
+      reinterpret_cast<MLAS_FP16*>(y_data),
+      static_cast<size_t>(N),
+      tp);
+
+  return Status::OK();
 }
+
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -25,6 +26,26 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    // Pack a constant W once so it isn't repacked on every call, keeping only its nonzeros if it is sparse.
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W) && W->Shape().NumDimensions() == 2) {
+      const size_t K = static_cast<size_t>(trans_B_ == CblasNoTrans ? W->Shape()[0] : W->Shape()[1]);
+      const size_t N = static_cast<size_t>(trans_B_ == CblasNoTrans ? W->Shape()[1] : W->Shape()[0]);
+      if (K > 0 && N > 0) {
+        auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+        const T* w_data = W->template Data<T>();
+        const size_t ldw = trans_B_ == CblasNoTrans ? N : K;
+        const size_t sparse_w_size = MlasSparsePackBSize(trans_B_, N, K, w_data, ldw);
+        if (sparse_w_size != 0) {
+          sparse_w_ = IAllocator::MakeUniquePtr<void>(alloc, sparse_w_size);
+          MlasSparsePackB(trans_B_, N, K, w_data, ldw, sparse_w_.get());
+        } else {
+          packed_w_ = IAllocator::MakeUniquePtr<void>(alloc, MlasGemmPackBSize(N, K));
+          MlasGemmPackB(trans_B_, N, K, w_data, ldw, packed_w_.get());
+        }
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -46,12 +67,37 @@ class Gemm : public OpKernel {
     if (M == 0 || N == 0)
       return Status::OK();
     T* y_data = Y->template MutableData<T>();
+    const int64_t K = helper.K();
+
+    // The bias and the activation are applied by the GEMM to each tile of the output
+    // while it is cache resident, instead of as separate passes over the output.
+    MLAS_SGEMM_EPILOGUE epilogue;
+    MLAS_ACTIVATION activation;
+    const bool fuse_activation = GetMlasActivation(activation);
+    if (fuse_activation && activation.ActivationKind != MlasIdentityActivation) {
+      epilogue.Activation = &activation;
+    }
+
+    float beta = beta_;
+    const auto& b_shape = B->Shape();
+    const T* b_data = B->template Data<T>();
 
-    // Broadcast the bias as needed.
-    if (beta_ != 0) {
+    if (beta_ == 1 && K > 0 && b_shape.Size() != 1) {
+      if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+        // B is (N,) or (1, N)
+        epilogue.ColumnBias = b_data;
+      } else if (b_shape[1] == 1) {
+        // B is (M, 1)
+        epilogue.RowBias = b_data;
+      } else {
+        // B is (M, N)
+        epilogue.Residual = b_data;
+        epilogue.ldr = static_cast<size_t>(N);
+      }
+      beta = 0;
+    } else if (beta_ != 0) {
+      // Broadcast the bias as needed.
       auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
-      const auto& b_shape = B->Shape();
-      const T* b_data = B->template Data<T>();
       if (b_shape.Size() == 1) {
         // B is (), (1,) or (1, 1), set the scalar
         output_mat.setConstant(*b_data);
@@ -68,20 +114,58 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        helper.K(),
-        alpha_,
-        X->template Data<T>(),
-        W->template Data<T>(),
-        beta_,
-        y_data,
-        tp);
-
-    FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
+    if (sparse_w_) {
+      MlasSgemmSparse(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          sparse_w_.get(),
+          beta,
+          y_data,
+          static_cast<size_t>(N),
+          tp,
+          &epilogue);
+    } else if (packed_w_) {
+      MlasSgemmPacked(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          packed_w_.get(),
+          beta,
+          y_data,
+          static_cast<size_t>(N),
+          tp,
+          &epilogue);
+    } else {
+      MlasSgemm(
+          trans_A_,
+          trans_B_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          W->template Data<T>(),
+          static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+          beta,
+          y_data,
+          static_cast<size_t>(N),
+          tp,
+          &epilogue);
+    }
+
+    if (!fuse_activation) {
+      FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
+    }
 
     return Status::OK();
   }
@@ -91,6 +175,31 @@ class Gemm : public OpKernel {
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
+  // W packed by MlasGemmPackB when it is a constant initializer. Only Gemm<float> is registered.
+  IAllocatorUniquePtr<void> packed_w_;
+  // W packed by MlasSparsePackB instead when it has few enough nonzeros that multiplying only them is faster.
+  IAllocatorUniquePtr<void> sparse_w_;
+
+  // Returns false if the activation isn't one MLAS applies in the GEMM epilogue.
+  bool GetMlasActivation(MLAS_ACTIVATION& activation) const {
+    if (activation_.empty()) {
+      activation.ActivationKind = MlasIdentityActivation;
+    } else if (activation_ == "Relu") {
+      activation.ActivationKind = MlasReluActivation;
+    } else if (activation_ == "LeakyRelu") {
+      activation.ActivationKind = MlasLeakyReluActivation;
+      activation.Parameters.LeakyRelu.alpha = leaky_relu_alpha_;
+    } else if (activation_ == "Sigmoid") {
+      activation.ActivationKind = MlasLogisticActivation;
+    } else if (activation_ == "Tanh") {
+      activation.ActivationKind = MlasTanhActivation;
+    } else if (activation_ == "Gelu") {
+      activation.ActivationKind = MlasGeluActivation;
+    } else {
+      return false;
+    }
+    return true;
+  }
 
  protected:
   // For fused gemm + activation
@@ -98,4 +207,28 @@ class Gemm : public OpKernel {
   float leaky_relu_alpha_;
 };
 
+template <>
+class Gemm<MLFloat16> final : public OpKernel {
+ public:
+  Gemm(const OpKernelInfo& info) : OpKernel(info) {
+    int64_t temp;
+    ORT_ENFORCE(info.GetAttr<int64_t>("transA", &temp).IsOK());
+    trans_A_ = temp == 0 ? CblasNoTrans : CblasTrans;
+
+    ORT_ENFORCE(info.GetAttr<int64_t>("transB", &temp).IsOK());
+    trans_B_ = temp == 0 ? CblasNoTrans : CblasTrans;
+
+    ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
+    ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  CBLAS_TRANSPOSE trans_A_;
+  CBLAS_TRANSPOSE trans_B_;
+  float alpha_;
+  float beta_;
+};
+
 }  // namespace onnxruntime
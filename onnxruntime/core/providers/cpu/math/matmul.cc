@@ -3,6 +3,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -23,6 +24,13 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     9, 9,
@@ -51,6 +59,20 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint64_t>()),
     MatMul<uint64_t>);
 
+// The helper is cached while the input shapes stay the same, if the session enables its shape cache.
+static Status GetMatMulComputeHelper(OpKernelContext* ctx, const TensorShape& left_shape,
+                                     const TensorShape& right_shape,
+                                     std::shared_ptr<const MatMulComputeHelper>& helper) {
+  helper = ctx->GetShapeCachedState<MatMulComputeHelper>();
+  if (helper == nullptr) {
+    auto new_helper = std::make_shared<MatMulComputeHelper>();
+    ORT_RETURN_IF_ERROR(new_helper->Compute(left_shape, right_shape));
+    helper = new_helper;
+    ctx->SetShapeCachedState(helper);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
@@ -59,8 +81,9 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   const auto* left_X = ctx->Input<Tensor>(0);
   const auto* right_X = ctx->Input<Tensor>(1);
 
-  MatMulComputeHelper helper;
-  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+  std::shared_ptr<const MatMulComputeHelper> cached_helper;
+  ORT_RETURN_IF_ERROR(GetMatMulComputeHelper(ctx, left_X->Shape(), right_X->Shape(), cached_helper));
+  const MatMulComputeHelper& helper = *cached_helper;
 
   Tensor* Y = ctx->Output(0, helper.OutputShape());
 
@@ -78,4 +101,120 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  std::shared_ptr<const MatMulComputeHelper> cached_helper;
+  ORT_RETURN_IF_ERROR(GetMatMulComputeHelper(ctx, left_X->Shape(), right_X->Shape(), cached_helper));
+  const MatMulComputeHelper& helper = *cached_helper;
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  // MLFloat16 holds the raw IEEE half bits that MLAS operates on.
+  const auto* A = reinterpret_cast<const MLAS_FP16*>(left_X->Data<MLFloat16>());
+  const auto* B = reinterpret_cast<const MLAS_FP16*>(right_X->Data<MLFloat16>());
+  auto* C = reinterpret_cast<MLAS_FP16*>(Y->MutableData<MLFloat16>());
+
+  const size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    MlasHalfGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f,
+                 A + helper.LeftOffsets()[i], K,
+                 B + helper.RightOffsets()[i], N, 0.0f,
+                 C + helper.OutputOffsets()[i], N, thread_pool);
+  }
+
+  return Status::OK();
+}
+
+MatMul<float>::MatMul(const OpKernelInfo& info) : OpKernel(info) {
+  const Tensor* B;
+  if (!info.TryGetConstantInput(1, &B) || B->Shape().NumDimensions() != 2) {
+    return;
+  }
+
+  const size_t K = static_cast<size_t>(B->Shape()[0]);
+  const size_t N = static_cast<size_t>(B->Shape()[1]);
+  if (K == 0 || N == 0) {
+    return;
+  }
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  const size_t sparse_b_size = MlasSparsePackBSize(CblasNoTrans, N, K, B->Data<float>(), N);
+  if (sparse_b_size != 0) {
+    sparse_b_ = IAllocator::MakeUniquePtr<void>(alloc, sparse_b_size);
+    MlasSparsePackB(CblasNoTrans, N, K, B->Data<float>(), N, sparse_b_.get());
+    return;
+  }
+
+  packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, MlasGemmPackBSize(N, K));
+  MlasGemmPackB(CblasNoTrans, N, K, B->Data<float>(), N, packed_b_.get());
+}
+
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  std::shared_ptr<const MatMulComputeHelper> cached_helper;
+  ORT_RETURN_IF_ERROR(GetMatMulComputeHelper(ctx, left_X->Shape(), right_X->Shape(), cached_helper));
+  const MatMulComputeHelper& helper = *cached_helper;
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  const size_t max_len = helper.OutputOffsets().size();
+  if (sparse_b_) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSgemmSparse(CblasNoTrans, M, N, K, 1.0f,
+                      left_X->Data<float>() + helper.LeftOffsets()[i], K,
+                      sparse_b_.get(), 0.0f,
+                      Y->MutableData<float>() + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return Status::OK();
+  }
+
+  if (packed_b_) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSgemmPacked(CblasNoTrans, M, N, K, 1.0f,
+                      left_X->Data<float>() + helper.LeftOffsets()[i], K,
+                      packed_b_.get(), 0.0f,
+                      Y->MutableData<float>() + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return Status::OK();
+  }
+
+  // the matrices of the broadcast batch dims are multiplied as one batch, so small matrices
+  // are spread across the thread pool together instead of one dispatch per matrix
+  std::vector<MLAS_SGEMM_PARAMETERS> gemm_params(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    auto& params = gemm_params[i];
+    params.M = M;
+    params.N = N;
+    params.K = K;
+    params.A = left_X->Data<float>() + helper.LeftOffsets()[i];
+    params.lda = K;
+    params.B = right_X->Data<float>() + helper.RightOffsets()[i];
+    params.ldb = N;
+    params.C = Y->MutableData<float>() + helper.OutputOffsets()[i];
+    params.ldc = N;
+  }
+  MlasSgemmBatch(gemm_params.data(), max_len, thread_pool);
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
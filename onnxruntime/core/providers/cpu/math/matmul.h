@@ -18,4 +18,22 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // B packed by MlasGemmPackB when it is a constant 2-D initializer, so it isn't repacked on every call.
+  IAllocatorUniquePtr<void> packed_b_;
+  // B packed by MlasSparsePackB instead when it is a constant 2-D initializer with few enough nonzeros
+  // that multiplying only them is faster.
+  IAllocatorUniquePtr<void> sparse_b_;
+};
+
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
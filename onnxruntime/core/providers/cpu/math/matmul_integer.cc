@@ -33,8 +33,70 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
         .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
     MatMulInteger<uint8_t, int8_t>);
 
+#ifndef USE_GEMMLOWP
+// MLAS supports a signed B, and a zero point for each column of B.
+static Status ComputeMatMulIntegerMlas(OpKernelContext* ctx, bool b_is_signed, const void* packed_b) {
+  auto a = ctx->Input<Tensor>(0);
+  auto b = ctx->Input<Tensor>(1);
+  ORT_ENFORCE(a != nullptr && b != nullptr);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // validate zero points
+  uint8_t a_offset = 0;
+  auto a_zero_point = ctx->Input<Tensor>(2);
+  if (a_zero_point != nullptr) {
+    ORT_ENFORCE(IsScalarOr1ElementVector(a_zero_point),
+                "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
+    a_offset = *static_cast<const uint8_t*>(a_zero_point->DataRaw());
+  }
+
+  uint8_t b_offset = 0;
+  const uint8_t* b_offsets = &b_offset;
+  bool per_column_zero_points = false;
+  auto b_zero_point = ctx->Input<Tensor>(3);
+  if (b_zero_point != nullptr) {
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      b_offset = *static_cast<const uint8_t*>(b_zero_point->DataRaw());
+    } else {
+      ORT_ENFORCE(b_zero_point->Shape().NumDimensions() == 1 && b_zero_point->Shape()[0] == helper.N(),
+                  "MatmulInteger : input2 zero point must be a scalar or 1D tensor with a value for each column");
+      b_offsets = static_cast<const uint8_t*>(b_zero_point->DataRaw());
+      per_column_zero_points = true;
+    }
+  }
+
+  MLAS_GEMM_U8X8_PARAMETERS gemm_params;
+  gemm_params.M = static_cast<size_t>(helper.M());
+  gemm_params.N = static_cast<size_t>(helper.N());
+  gemm_params.K = static_cast<size_t>(helper.K());
+  gemm_params.lda = gemm_params.K;
+  gemm_params.ZeroPointA = a_offset;
+  gemm_params.ldb = gemm_params.N;
+  gemm_params.ZeroPointB = b_offsets;
+  gemm_params.BIsPacked = packed_b != nullptr;
+  gemm_params.BIsSigned = b_is_signed;
+  gemm_params.PerColumnZeroPoints = per_column_zero_points;
+  gemm_params.ldc = gemm_params.N;
+
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    gemm_params.A = a->template Data<uint8_t>() + helper.LeftOffsets()[i];
+    gemm_params.B = packed_b != nullptr ? packed_b
+                                        : static_cast<const uint8_t*>(b->DataRaw()) + helper.RightOffsets()[i];
+    gemm_params.C = y->template MutableData<int32_t>() + helper.OutputOffsets()[i];
+    MlasGemm(&gemm_params, nullptr);
+  }
+  return Status::OK();
+}
+#endif
+
 template <>
 Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
+#ifndef USE_GEMMLOWP
+  return ComputeMatMulIntegerMlas(ctx, false, packed_b_.get());
+#else
   auto a = ctx->Input<Tensor>(0);
   auto b = ctx->Input<Tensor>(1);
   ORT_ENFORCE(a != nullptr && b != nullptr);
@@ -74,10 +136,14 @@ Status MatMulInteger<uint8_t, uint8_t>::Compute(OpKernelContext* ctx) const {
                   nullptr);
   }
   return Status::OK();
+#endif
 }
 
 template <>
 Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
+#ifndef USE_GEMMLOWP
+  return ComputeMatMulIntegerMlas(ctx, true, packed_b_.get());
+#else
   auto a = ctx->Input<Tensor>(0);
   auto b = ctx->Input<Tensor>(1);
   ORT_ENFORCE(a != nullptr && b != nullptr);
@@ -118,5 +184,6 @@ Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
         static_cast<int>(helper.K()));
   }
   return Status::OK();
+#endif
 }
 }  // namespace onnxruntime
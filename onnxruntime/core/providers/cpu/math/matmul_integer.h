@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 
@@ -21,6 +22,20 @@ class MatMulInteger final : public OpKernel {
     if (info.GetInputCount() > 3) {
       has_b_zero_point_ = true;
     }
+
+#ifndef USE_GEMMLOWP
+    // Pack a constant B once so it isn't repacked on every call.
+    const Tensor* b;
+    if (info.TryGetConstantInput(1, &b) && b->Shape().NumDimensions() == 2 &&
+        b->Shape()[0] > 0 && b->Shape()[1] > 0) {
+      const size_t K = static_cast<size_t>(b->Shape()[0]);
+      const size_t N = static_cast<size_t>(b->Shape()[1]);
+      const bool b_is_signed = std::is_same<T2, int8_t>::value;
+      auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+      packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, MlasGemmPackBSize(N, K, b_is_signed));
+      MlasGemmPackB(N, K, static_cast<const uint8_t*>(b->DataRaw()), N, b_is_signed, packed_b_.get());
+    }
+#endif
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,5 +43,7 @@ class MatMulInteger final : public OpKernel {
  private:
   bool has_a_zero_point_;
   bool has_b_zero_point_;
+  // B packed by MlasGemmPackB when it is a constant 2-D initializer
+  IAllocatorUniquePtr<void> packed_b_;
 };
 }  // namespace onnxruntime
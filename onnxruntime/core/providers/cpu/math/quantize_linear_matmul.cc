@@ -4,6 +4,8 @@
 #include "core/providers/cpu/math/quantize_linear_matmul.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -35,8 +37,9 @@ Status QLinearMatMul<uint8_t, uint8_t, uint8_t>::Compute(OpKernelContext* ctx) c
   auto y_offset = ctx->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_offset),
               "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset),
-              "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(b_offset) || IsVectorOfSize(b_offset, helper.N()),
+              "QLinearMatmul : weight zero point must be a scalar, 1D tensor of size 1, "
+              "or 1D tensor with a value for each column");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_offset),
               "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -46,32 +49,60 @@ Status QLinearMatMul<uint8_t, uint8_t, uint8_t>::Compute(OpKernelContext* ctx) c
   auto y_scale = ctx->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(a_scale),
               "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale),
-              "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale) || IsVectorOfSize(b_scale, helper.N()),
+              "QLinearMatmul : weight scale must be a scalar, 1D tensor of size 1, "
+              "or 1D tensor with a value for each column");
   ORT_ENFORCE(IsScalarOr1ElementVector(y_scale),
               "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
 
-  auto a_scale_data = *(a_scale->template Data<float>());
-  auto b_scale_data = *(b_scale->template Data<float>());
-  auto y_scale_data = *(y_scale->template Data<float>());
+  // the scale of each column of the int32 product in the output
+  const float a_scale_data = *(a_scale->template Data<float>());
+  const float y_scale_data = *(y_scale->template Data<float>());
+  std::vector<float> output_scales(b_scale->template Data<float>(),
+                                   b_scale->template Data<float>() + b_scale->Shape().Size());
+  for (auto& scale : output_scales) {
+    scale = a_scale_data * scale / y_scale_data;
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * static_cast<size_t>(helper.M() * helper.N()));
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
 
-  const float real_multiplier = (a_scale_data * b_scale_data) / y_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  MLAS_GEMM_U8X8_PARAMETERS gemm_params;
+  gemm_params.M = static_cast<size_t>(helper.M());
+  gemm_params.N = static_cast<size_t>(helper.N());
+  gemm_params.K = static_cast<size_t>(helper.K());
+  gemm_params.lda = gemm_params.K;
+  gemm_params.ZeroPointA = *a_offset->template Data<uint8_t>();
+  gemm_params.ldb = gemm_params.N;
+  gemm_params.ZeroPointB = b_offset->template Data<uint8_t>();
+  gemm_params.PerColumnZeroPoints = !IsScalarOr1ElementVector(b_offset);
+  gemm_params.C = gemm_output;
+  gemm_params.ldc = gemm_params.N;
+
+  // the columns of the output are the channels of the weights
+  MLAS_REQUANTIZE_PARAMETERS requantize_params;
+  requantize_params.M = gemm_params.M;
+  requantize_params.N = gemm_params.N;
+  requantize_params.Input = gemm_output;
+  requantize_params.ldi = gemm_params.N;
+  requantize_params.ldo = gemm_params.N;
+  requantize_params.Scale = output_scales.data();
+  requantize_params.PerChannelScale = output_scales.size() > 1;
+  requantize_params.ChannelIsColumn = true;
+  requantize_params.ZeroPoint = *y_offset->template Data<uint8_t>();
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
-    GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                            b->template Data<uint8_t>() + helper.RightOffsets()[i],
-                            y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                            *a_offset->template Data<uint8_t>(),
-                            *b_offset->template Data<uint8_t>(),
-                            *y_offset->template Data<uint8_t>(),
-                            static_cast<int>(helper.M()),
-                            static_cast<int>(helper.N()),
-                            static_cast<int>(helper.K()),
-                            integer_multiplier,
-                            right_shift);
+    gemm_params.A = a->template Data<uint8_t>() + helper.LeftOffsets()[i];
+    gemm_params.B = b->template Data<uint8_t>() + helper.RightOffsets()[i];
+    MlasGemm(&gemm_params, thread_pool);
+
+    requantize_params.Output = y->template MutableData<uint8_t>() + helper.OutputOffsets()[i];
+    MlasRequantizeOutput(&requantize_params);
   }
 
   return Status::OK();
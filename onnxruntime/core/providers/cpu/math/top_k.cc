@@ -19,9 +19,11 @@
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
-#include "core/util/math_cpuonly.h"
-#include <queue>
+#include "core/platform/threadpool.h"
+#include <algorithm>
+#include <numeric>
 using namespace std;
 namespace onnxruntime {
 
@@ -44,16 +46,76 @@ static int64_t SizeFromDim(size_t k, const vector<int64_t>& dims) {
   return r;
 }
 
-template <typename T>
-struct ValueCmp {
-  bool operator()(
-      const pair<T, int64_t>& lhs,
-      const pair<T, int64_t>& rhs) {
-    return (
-        lhs.first > rhs.first ||
-        (lhs.first == rhs.first && lhs.second < rhs.second));
+// The k up to which the top elements are kept in a sorted array that each new element is inserted into.
+// Larger k select the top elements with nth_element and sort only those.
+constexpr unsigned kTopKInsertionMaxK = 16;
+
+// The number of elements whose maximum is compared with the smallest of the top elements, so that a block
+// without a larger element is skipped with a single vectorizable reduction.
+constexpr int64_t kTopKInsertionBlock = 8;
+
+// Inserts the element at index into the count sorted top elements, dropping the last of them when the array
+// is full. The index is larger than the indices of the top elements, so it follows the equal values.
+static void InsertTopElement(float value, int64_t index, unsigned k, unsigned& count,
+                             float* top_values, int64_t* top_indices) {
+  unsigned position = count < k ? count++ : k - 1;
+  while (position > 0 && top_values[position - 1] < value) {
+    top_values[position] = top_values[position - 1];
+    top_indices[position] = top_indices[position - 1];
+    --position;
   }
-};
+  top_values[position] = value;
+  top_indices[position] = index;
+}
+
+// Selects the k largest of the n contiguous values in descending order, the equal values by index.
+static void SelectTopKByInsertion(const float* input, int64_t n, unsigned k,
+                                  float* top_values, int64_t* top_indices) {
+  unsigned count = 0;
+  int64_t l = 0;
+  for (; l < n && count < k; ++l) {
+    InsertTopElement(input[l], l, k, count, top_values, top_indices);
+  }
+
+  for (; l + kTopKInsertionBlock <= n; l += kTopKInsertionBlock) {
+    float block_max = input[l];
+    for (int64_t b = 1; b < kTopKInsertionBlock; ++b) {
+      block_max = std::max(block_max, input[l + b]);
+    }
+    if (block_max > top_values[k - 1]) {
+      for (int64_t b = 0; b < kTopKInsertionBlock; ++b) {
+        if (input[l + b] > top_values[k - 1]) {
+          InsertTopElement(input[l + b], l + b, k, count, top_values, top_indices);
+        }
+      }
+    }
+  }
+
+  for (; l < n; ++l) {
+    if (input[l] > top_values[k - 1]) {
+      InsertTopElement(input[l], l, k, count, top_values, top_indices);
+    }
+  }
+}
+
+// Selects the k largest of the n contiguous values in descending order, the equal values by index, by
+// partitioning the indices of the values in the scratch buffer around the k-th element.
+static void SelectTopKBySorting(const float* input, int64_t n, unsigned k, vector<int64_t>& order,
+                                float* top_values, int64_t* top_indices) {
+  order.resize(n);
+  std::iota(order.begin(), order.end(), 0);
+  auto comes_before = [input](int64_t lhs, int64_t rhs) {
+    return input[lhs] > input[rhs] || (input[lhs] == input[rhs] && lhs < rhs);
+  };
+  if (k < n) {
+    std::nth_element(order.begin(), order.begin() + (k - 1), order.end(), comes_before);
+  }
+  std::sort(order.begin(), order.begin() + k, comes_before);
+  for (unsigned l = 0; l < k; ++l) {
+    top_values[l] = input[order[l]];
+    top_indices[l] = order[l];
+  }
+}
 
 // Core TopK implementation
 Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int axis, const unsigned k) {
@@ -78,10 +140,6 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
 
   const int64_t rows = SizeToDim(axis_parsed, in_dims);
   const int64_t cols = X->Shape().Size() / rows;
-  auto input_map = ConstEigenMatrixMapRowMajor<float>(
-      static_cast<const float*>(X->template Data<float>()),
-      rows,
-      cols);
 
   // Resize output tensors to be the same shape as the input except
   // for the specified dimension ((i.e.) axis_parsed), which will be of size k. E.x. for an input tensor
@@ -91,45 +149,53 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
   auto* Values = p_op_kernel_context->Output(0, output_linear_shape);
   auto* Indices = p_op_kernel_context->Output(1, output_linear_shape);
 
-  // Use Eigen maps to allow indexing into the 2d tensors like Values_map(i,j)
-  const int64_t reduced_cols = SizeFromDim(axis_parsed, output_linear_shape);
-  auto Values_map = EigenMatrixMapRowMajor<float>(
-      Values->template MutableData<float>(), rows, reduced_cols);
-  auto Indices_map = EigenMatrixMapRowMajor<int64_t>(
-      Indices->template MutableData<int64_t>(), rows, reduced_cols);
+  const float* input_data = X->template Data<float>();
+  float* values_data = Values->template MutableData<float>();
+  int64_t* indices_data = Indices->template MutableData<int64_t>();
+  const int64_t axis_dim = in_dims[axis_parsed];
 
   // This is basically the number of elements within each of the "k" rows
+  const int64_t reduced_cols = SizeFromDim(axis_parsed, output_linear_shape);
   const int64_t block_slice = reduced_cols / k;
-  // Sort preserving Indices
-  for (int64_t i = 0; i < rows; ++i) {
-    for (int64_t j = 0; j < block_slice; ++j) {
-      // Build a min-heap, the heap element is pair of (value, idx)
-      // the top of the heap is the smallest value
-      priority_queue<
-          pair<float, int64_t>,
-          vector<pair<float, int64_t>>,
-          ValueCmp<float>>
-          min_heap;
-      // Maintain the size of heap to be less or equal to k_, so the
-      // heap will hold the k largest Values
-      for (int64_t l = 0; l < in_dims[axis_parsed]; ++l) {
-        const auto value = input_map(i, l * block_slice + j);
-        if (min_heap.size() < k || value > min_heap.top().first) {
-          min_heap.push({value, l});
-        }
-        if (min_heap.size() > k) {
-          min_heap.pop();
+
+  // Each slice of the axis is selected independently. The scratch buffers are allocated once per range of
+  // slices, and a strided slice is first copied to be contiguous.
+  auto select_slices = [&](int64_t first, int64_t last) {
+    vector<float> top_values(k);
+    vector<int64_t> top_indices(k);
+    vector<float> slice(block_slice > 1 ? axis_dim : 0);
+    vector<int64_t> order;
+    for (int64_t s = first; s < last; ++s) {
+      const int64_t i = s / block_slice;
+      const int64_t j = s % block_slice;
+      const float* slice_data = input_data + i * cols + j;
+      if (block_slice > 1) {
+        for (int64_t l = 0; l < axis_dim; ++l) {
+          slice[l] = slice_data[l * block_slice];
         }
+        slice_data = slice.data();
+      }
+      if (k <= kTopKInsertionMaxK) {
+        SelectTopKByInsertion(slice_data, axis_dim, k, top_values.data(), top_indices.data());
+      } else {
+        SelectTopKBySorting(slice_data, axis_dim, k, order, top_values.data(), top_indices.data());
       }
-      // Extract these k elements and place them in the results placeholder
-      for (int64_t l = 0; l < k; ++l) {
-        auto& pqElem = min_heap.top();
-        auto col_index = (k - l - 1) * block_slice + j;
-        Values_map(i, col_index) = pqElem.first;
-        Indices_map(i, col_index) = pqElem.second;
-        min_heap.pop();
+      // Place the k elements in the results placeholder
+      float* values_slice = values_data + i * reduced_cols + j;
+      int64_t* indices_slice = indices_data + i * reduced_cols + j;
+      for (unsigned l = 0; l < k; ++l) {
+        values_slice[l * block_slice] = top_values[l];
+        indices_slice[l * block_slice] = top_indices[l];
       }
     }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  const int64_t slices = rows * block_slice;
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, slices, static_cast<double>(axis_dim) * 2, select_slices);
+  } else {
+    select_slices(0, slices);
   }
 
   return Status::OK();
@@ -35,33 +35,26 @@ Status CategoryMapper::Compute(OpKernelContext* context) const {
 
     auto input = gsl::make_span(X.template Data<std::string>(), shape.Size());
     auto output = gsl::make_span(Y.template MutableData<int64_t>(), shape.Size());
-    auto out = output.begin();
 
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
-                    ++out;
-                  });
+    ForEachElementRange(context, shape.Size(), 64.0, [&](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) {
+        const int64_t* map_to = string_to_int_map_.Find(input[i]);
+        output[i] = map_to == nullptr ? default_int_ : *map_to;
+      }
+    });
   } else {
     if (Y.DataType() != DataTypeImpl::GetType<std::string>())
       return Status(ONNXRUNTIME, FAIL, "Input of int64 must have output of string ");
 
     auto input = gsl::make_span(X.template Data<int64_t>(), shape.Size());
     auto output = gsl::make_span(Y.template MutableData<std::string>(), shape.Size());
-    auto out = output.begin();
-
-    const auto map_end = int_to_string_map_.end();
 
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const int64_t& value) {
-                    auto map_to = int_to_string_map_.find(value);
-                    *out = map_to == map_end ? default_string_ : map_to->second;
-                    ++out;
-                  });
+    ForEachElementRange(context, shape.Size(), 64.0, [&](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) {
+        const std::string* map_to = int_to_string_map_.Find(input[i]);
+        output[i] = map_to == nullptr ? default_string_ : *map_to;
+      }
+    });
   }
 
   return Status::OK();
@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/ml/lookup_table.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -22,22 +23,22 @@ class LabelEncoder final : public OpKernel {
 
     auto num_entries = string_classes.size();
 
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
+    string_to_int_map_ = LookupTable<std::string, int64_t>(num_entries);
+    int_to_string_map_ = LookupTable<int64_t, std::string>(num_entries);
 
     for (size_t i = 0; i < num_entries; ++i) {
       const std::string& str = string_classes[i];
 
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
+      string_to_int_map_.Set(str, i);
+      int_to_string_map_.Set(i, str);
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  LookupTable<std::string, int64_t> string_to_int_map_;
+  LookupTable<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -64,8 +65,9 @@ class LabelEncoder_2 final : public OpKernel {
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
 
+    _map = LookupTable<TKey, TValue>(num_keys);
     for (size_t i = 0; i < num_keys; ++i)
-      _map[keys[i]] = values[i];
+      _map.Set(keys[i], values[i]);
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -78,13 +80,12 @@ class LabelEncoder_2 final : public OpKernel {
     auto input = X.template DataAsSpan<TKey>();
     auto output = Y.template MutableDataAsSpan<TValue>();
 
-    for (int64_t i = 0; i < shape.Size(); ++i) {
-      const auto found = _map.find(input[i]);
-      if (found == _map.end())
-        output[i] = _default_value;
-      else
-        output[i] = found->second;
-    }
+    ForEachElementRange(context, shape.Size(), 64.0, [&](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) {
+        const TValue* found = _map.Find(input[i]);
+        output[i] = found == nullptr ? _default_value : *found;
+      }
+    });
 
     return Status::OK();
   }
@@ -98,7 +99,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  std::unordered_map<TKey, TValue> _map;
+  LookupTable<TKey, TValue> _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/linearclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -52,8 +53,23 @@ LinearClassifier<T>::LinearClassifier(const OpKernelInfo& info) : OpKernel(info)
   class_count_ = static_cast<int64_t>(intercepts_.size());
 }
 
+template <typename T>
+static const float* GetFloatData(const T* data, size_t count, std::vector<float>& buffer) {
+  buffer.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    buffer[i] = static_cast<float>(data[i]);
+  }
+  return buffer.data();
+}
+
+template <>
+const float* GetFloatData(const float* data, size_t, std::vector<float>&) {
+  return data;
+}
+
 template <typename T>
 Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
   const auto* X = ctx->Input<Tensor>(0);
   const TensorShape& shape = X->Shape();
   if (shape.NumDimensions() == 0) {
@@ -63,6 +79,10 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
 
   int64_t stride = shape.NumDimensions() == 1 ? shape[0] : shape[1];
   int64_t N = shape.NumDimensions() == 1 ? 1 : shape[0];
+  if (static_cast<int64_t>(coefficients_.size()) < class_count_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "The coefficients need to have one weight per class and feature.");
+  }
   Tensor* Y = ctx->Output(0, TensorShape({N}));
 
   int64_t output_classes = class_count_;
@@ -73,32 +93,38 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
-  int64_t zindex = 0;
-  const auto* x_data = X->template Data<T>();
-
+  // The scores of all the points are computed with one matrix multiplication. They are written straight to Z
+  // when the post transform can be applied to all of them at once.
   auto class_count = static_cast<size_t>(class_count_);
+  std::vector<float> x_buffer;
+  const float* x_data = GetFloatData(X->template Data<T>(), static_cast<size_t>(N * stride), x_buffer);
+  const bool batched_post_transform = !add_second_class && class_count >= 2 &&
+                                      (post_transform_ == POST_EVAL_TRANSFORM::NONE ||
+                                       post_transform_ == POST_EVAL_TRANSFORM::LOGISTIC ||
+                                       post_transform_ == POST_EVAL_TRANSFORM::SOFTMAX);
+  std::vector<float> score_buffer;
+  float* all_scores = nullptr;
+  if (batched_post_transform) {
+    all_scores = Z->template MutableData<float>();
+  } else {
+    score_buffer.resize(static_cast<size_t>(N) * class_count);
+    all_scores = score_buffer.data();
+  }
+  ComputeLinearScores(x_data, static_cast<size_t>(N), static_cast<size_t>(stride), coefficients_, intercepts_,
+                      class_count, all_scores, tp);
+
+  int64_t zindex = 0;
   std::vector<float> scores;
   scores.reserve(class_count);
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
+    const float* point_scores = all_scores + i * class_count;
     int maxclass = -1;
     float maxweight = 0.f;
     for (int j = 0; j < class_count_; j++)  // for each class
     {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
-      if (weight > maxweight || maxclass == -1) {
-        maxweight = weight;
+      if (point_scores[j] > maxweight || maxclass == -1) {
+        maxweight = point_scores[j];
         maxclass = j;
       }
     }
@@ -135,7 +161,11 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
         Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
       }
     }
+    if (batched_post_transform) {
+      continue;
+    }
     //write float values
+    scores.assign(point_scores, point_scores + class_count);
     if (add_second_class && maxweight > 0) {
       ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
     } else if (add_second_class) {
@@ -145,6 +175,10 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
     }
     zindex += scores.size();
   }  //for each point
+
+  if (batched_post_transform) {
+    BatchedPostTransform(all_scores, static_cast<size_t>(N), class_count, post_transform_, tp);
+  }
   return Status::OK();
 }
 
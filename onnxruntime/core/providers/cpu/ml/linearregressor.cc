@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/linearregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -22,6 +23,7 @@ LinearRegressor<T>::LinearRegressor(const OpKernelInfo& info) : OpKernel(info),
 
 template <>
 Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
   const auto* X = ctx->Input<Tensor>(0);
   if (X->Shape().NumDimensions() == 0) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
@@ -30,28 +32,28 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
 
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
+  if (static_cast<int64_t>(coefficients_.size()) < targets_ * stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "The coefficients need to have one weight per target and feature.");
+  }
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
   const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
+  auto targets = static_cast<size_t>(targets_);
 
-  bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_);
+  // The scores of all the points are computed with one matrix multiplication straight into Y.
+  float* all_scores = Y->template MutableData<float>();
+  ComputeLinearScores(Xdata, static_cast<size_t>(N), static_cast<size_t>(stride), coefficients_, intercepts_,
+                      targets, all_scores, tp);
+  if (post_transform_ == POST_EVAL_TRANSFORM::NONE ||
+      BatchedPostTransform(all_scores, static_cast<size_t>(N), targets, post_transform_, tp)) {
+    return Status::OK();
+  }
+
+  int64_t yindex = 0;
+  std::vector<float> scores;
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
-    }
+    scores.assign(all_scores + i * targets, all_scores + (i + 1) * targets);
     ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
     yindex += scores.size();
   }
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Read-only map from the categories of a kernel attribute to their values, filled once in the kernel constructor.
+// The entries are stored in a single array with open addressing and linear probing instead of the nodes of a
+// std::unordered_map, and each entry keeps the hash of its key, so a lookup usually touches one cache line and
+// compares a key (e.g. a string) only when the full hashes match.
+template <typename TKey, typename TValue>
+class LookupTable {
+ public:
+  explicit LookupTable(size_t num_entries = 0) {
+    Rehash(CapacityFor(num_entries));
+  }
+
+  // Adds key, or replaces its value when key is already in the table, so the last of duplicated keys wins.
+  void Set(const TKey& key, const TValue& value) {
+    if (2 * (size_ + 1) > slots_.size()) {
+      Rehash(2 * slots_.size());
+    }
+
+    const size_t hash = Hash(key);
+    Slot& slot = slots_[Position(key, hash)];
+    if (!slot.used) {
+      slot.used = true;
+      slot.hash = hash;
+      slot.key = key;
+      ++size_;
+    }
+    slot.value = value;
+  }
+
+  // Returns the value of key, or nullptr when key is not in the table.
+  const TValue* Find(const TKey& key) const {
+    const Slot& slot = slots_[Position(key, Hash(key))];
+    return slot.used ? &slot.value : nullptr;
+  }
+
+  size_t Size() const { return size_; }
+
+ private:
+  struct Slot {
+    size_t hash{0};
+    bool used{false};
+    TKey key;
+    TValue value;
+  };
+
+  // std::hash is the identity for integers on some platforms, which puts keys with the same low bits (e.g.
+  // multiples of 1024) in a single run of slots, so the bits are mixed (the finalizer of MurmurHash3).
+  static size_t Hash(const TKey& key) {
+    uint64_t h = static_cast<uint64_t>(std::hash<TKey>{}(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }
+
+  static size_t CapacityFor(size_t num_entries) {
+    // at most half full, so that runs of used slots stay short and a probe always ends at an empty slot
+    size_t capacity = 8;
+    while (capacity < 2 * num_entries) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  // Returns the index of the slot of key, or of the empty slot where it would be added.
+  size_t Position(const TKey& key, size_t hash) const {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot& slot = slots_[i];
+      if (!slot.used || (slot.hash == hash && slot.key == key)) {
+        return i;
+      }
+    }
+  }
+
+  void Rehash(size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    slots_.swap(slots);
+    for (auto& slot : slots) {
+      if (slot.used) {
+        slots_[Position(slot.key, slot.hash)] = std::move(slot);
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_{0};
+};
+
+// Runs fn(first, last) over the num_elements elements of the input of a kernel, split across the intra-op thread
+// pool when there is one. cost_per_element is roughly the cycles it takes to look up and write one element, from
+// which the thread pool decides whether the input is large enough to be split.
+template <typename Fn>
+void ForEachElementRange(OpKernelContext* context, int64_t num_elements, double cost_per_element, Fn fn) {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, num_elements, cost_per_element, fn);
+  } else {
+    fn(0, num_elements);
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
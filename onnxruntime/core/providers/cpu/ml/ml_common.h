@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -358,5 +359,49 @@ void write_scores(std::vector<T>& scores, POST_EVAL_TRANSFORM post_transform, in
   memcpy(out_p, scores.data(), len);
 }
 
+// Computes the scores of a linear model for a batch of points with one matrix multiplication,
+// scores[N, M] = X[N, K] * coefficients[M, K]^T + intercepts. The intercepts are skipped unless there are M of them.
+static inline void ComputeLinearScores(const float* X, size_t N, size_t K, const std::vector<float>& coefficients,
+                                       const std::vector<float>& intercepts, size_t M, float* scores,
+                                       concurrency::ThreadPool* tp) {
+  const bool use_intercepts = intercepts.size() == M;
+  if (K == 0) {
+    for (size_t i = 0; i < N; i++) {
+      for (size_t j = 0; j < M; j++) {
+        scores[i * M + j] = use_intercepts ? intercepts[j] : 0.f;
+      }
+    }
+    return;
+  }
+
+  MLAS_SGEMM_EPILOGUE epilogue;
+  if (use_intercepts) {
+    epilogue.ColumnBias = intercepts.data();
+  }
+  MlasSgemm(CblasNoTrans, CblasTrans, N, M, K, 1.f, X, K, coefficients.data(), K, 0.f, scores, M, tp, &epilogue);
+}
+
+// Applies the post transform to the scores of a batch of points in place, with M >= 2 scores per point.
+// Returns false if the transform has no batched implementation, and write_scores has to be used per point.
+static inline bool BatchedPostTransform(float* scores, size_t N, size_t M, POST_EVAL_TRANSFORM post_transform,
+                                        concurrency::ThreadPool* tp) {
+  if (M < 2) {
+    return false;
+  }
+
+  switch (post_transform) {
+    case POST_EVAL_TRANSFORM::NONE:
+      return true;
+    case POST_EVAL_TRANSFORM::LOGISTIC:
+      MlasComputeLogistic(scores, scores, N * M);
+      return true;
+    case POST_EVAL_TRANSFORM::SOFTMAX:
+      MlasComputeSoftmax(scores, scores, N, M, false, tp);
+      return true;
+    default:
+      return false;
+  }
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -121,123 +122,138 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
-  const T* x_data = X->template Data<T>();
+  if (stride < feature_count_) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features, expected " + std::to_string(feature_count_));
+  }
+  const bool linear = vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR;
+  if (!linear && vector_count_ == 0)
+    return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  std::vector<float> x_buffer;
+  const float* x_data = AsFloat(X->template Data<T>(), N * stride, x_buffer);
   int64_t zindex = 0;
 
-  for (int64_t n = 0; n < N; n++)  //for each example
-  {
-    int64_t current_weight_0 = n * stride;
-    int64_t maxclass = -1;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
-
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
+  // Each pair of classes (i, j) scores the sum of the kernels of the support vectors of class i weighted by
+  // coefficient row j - 1 and of those of class j weighted by row i. sums holds, for each sample, the kernels of the
+  // support vectors of each class weighted by each coefficient row, which is one GEMM per class over the samples.
+  const int64_t num_rows = class_count_ - 1;
+  const int64_t sums_per_sample = class_count_ * num_rows;
+  const int64_t block_size = BlockRows(linear ? class_count_ : vector_count_ + sums_per_sample);
+  std::vector<float> kernels;
+  std::vector<float> sums;
+
+  for (int64_t first = 0; first < N; first += block_size) {
+    const int64_t block_rows = std::min(block_size, N - first);
+    const float* x_block = x_data + first * stride;
+
+    if (linear) {
+      kernels.resize(block_rows * class_count_);
+      batched_kernel_dot(x_block, stride, block_rows, coefficients_.data(), class_count_, feature_count_,
+                         get_kernel_type(), kernels.data(), tp);
     } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
-      int evals = 0;
-
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      votes.resize(class_count_, 0);
-      for (int64_t i = 0; i < class_count_; i++) {        // for each class
-        for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
-          double sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[evals];
-          scores.push_back((float)sum);
-          ++(votes[sum > 0 ? i : j]);
-          ++evals;  //index into rho
-        }
+      kernels.resize(block_rows * vector_count_);
+      batched_kernel_dot(x_block, stride, block_rows, support_vectors_.data(), vector_count_, feature_count_,
+                         get_kernel_type(), kernels.data(), tp);
+      sums.assign(block_rows * sums_per_sample, 0.f);
+      for (int64_t c = 0; c < class_count_ && num_rows > 0; ++c) {
+        if (vectors_per_class_[c] == 0)
+          continue;
+        math::GemmEx<float, concurrency::ThreadPool>(
+            CblasNoTrans, CblasTrans, static_cast<int>(block_rows), static_cast<int>(num_rows),
+            static_cast<int>(vectors_per_class_[c]), 1.f,
+            kernels.data() + starting_vector_[c], static_cast<int>(vector_count_),
+            coefficients_.data() + starting_vector_[c], static_cast<int>(vector_count_),
+            0.f, sums.data() + c * num_rows, static_cast<int>(sums_per_sample), tp);
       }
     }
 
-    if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
-      //compute probabilities from the scores
-      int64_t num = class_count_ * class_count_;
-      std::vector<float> probsp2(num, 0.f);
-      std::vector<float> estimates(class_count_, 0.f);
-      int64_t index = 0;
-      for (int64_t i = 0; i < class_count_; ++i) {
-        int64_t p1 = i * class_count_ + i + 1;
-        int64_t p2 = (i + 1) * class_count_ + i;
-        for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
-          float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
-          float val2 = std::max(val1, 1.0e-7f);
-          val2 = std::min(val2, 1 - 1.0e-7f);
-          probsp2[p1] = val2;
-          probsp2[p2] = 1 - val2;
-          ++p1;
-          p2 += class_count_;
+    for (int64_t b = 0; b < block_rows; b++)  //for each example
+    {
+      const int64_t n = first + b;
+      int64_t maxclass = -1;
+      std::vector<float> scores;
+      std::vector<int64_t> votes;
+
+      if (linear) {
+        const float* row = kernels.data() + b * class_count_;
+        for (int64_t j = 0; j < class_count_; j++) {  //for each class
+          scores.push_back(row[j] + rho_[0]);
+        }
+      } else {
+        const float* row = sums.data() + b * sums_per_sample;
+        int evals = 0;
+        votes.resize(class_count_, 0);
+        for (int64_t i = 0; i < class_count_; i++) {        // for each class
+          for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
+            float sum = row[i * num_rows + j - 1] + row[j * num_rows + i] + rho_[evals];
+            scores.push_back(sum);
+            ++(votes[sum > 0 ? i : j]);
+            ++evals;  //index into rho
+          }
         }
       }
-      multiclass_probability(class_count_, probsp2, estimates);
-      // copy probabilities back into scores
-      scores.resize(estimates.size());
-      std::copy(estimates.begin(), estimates.end(), scores.begin());
-    }
 
-    float max_weight = 0;
-    if (votes.size() > 0) {
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
-    } else {
-      auto it_max_weight = std::max_element(scores.begin(), scores.end());
-      maxclass = std::distance(scores.begin(), it_max_weight);
-      max_weight = *it_max_weight;
-    }
+      if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
+        //compute probabilities from the scores
+        int64_t num = class_count_ * class_count_;
+        std::vector<float> probsp2(num, 0.f);
+        std::vector<float> estimates(class_count_, 0.f);
+        int64_t index = 0;
+        for (int64_t i = 0; i < class_count_; ++i) {
+          int64_t p1 = i * class_count_ + i + 1;
+          int64_t p2 = (i + 1) * class_count_ + i;
+          for (int64_t j = i + 1; j < class_count_; ++j, ++index) {
+            float val1 = sigmoid_probability(scores[index], proba_[index], probb_[index]);
+            float val2 = std::max(val1, 1.0e-7f);
+            val2 = std::min(val2, 1 - 1.0e-7f);
+            probsp2[p1] = val2;
+            probsp2[p2] = 1 - val2;
+            ++p1;
+            p2 += class_count_;
+          }
+        }
+        multiclass_probability(class_count_, probsp2, estimates);
+        // copy probabilities back into scores
+        scores.resize(estimates.size());
+        std::copy(estimates.begin(), estimates.end(), scores.begin());
+      }
 
-    // write top class
-    // onnx specs expects one column per class.
-    int write_additional_scores = -1;
-    if (rho_.size() == 1) {
-      if (using_strings_) {
-        write_additional_scores = _set_score_svm<std::string>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_strings_, "1", "0");
+      float max_weight = 0;
+      if (votes.size() > 0) {
+        auto it_maxvotes = std::max_element(votes.begin(), votes.end());
+        maxclass = std::distance(votes.begin(), it_maxvotes);
       } else {
-        write_additional_scores = _set_score_svm<int64_t>(
-            Y, max_weight, maxclass, n, post_transform_, proba_,
-            weights_are_all_positive_, classlabels_ints_, 1, 0);
+        auto it_max_weight = std::max_element(scores.begin(), scores.end());
+        maxclass = std::distance(scores.begin(), it_max_weight);
+        max_weight = *it_max_weight;
       }
-    } else {  //multiclass
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+
+      // write top class
+      // onnx specs expects one column per class.
+      int write_additional_scores = -1;
+      if (rho_.size() == 1) {
+        if (using_strings_) {
+          write_additional_scores = _set_score_svm<std::string>(
+              Y, max_weight, maxclass, n, post_transform_, proba_,
+              weights_are_all_positive_, classlabels_strings_, "1", "0");
+        } else {
+          write_additional_scores = _set_score_svm<int64_t>(
+              Y, max_weight, maxclass, n, post_transform_, proba_,
+              weights_are_all_positive_, classlabels_ints_, 1, 0);
+        }
+      } else {  //multiclass
+        if (using_strings_) {
+          Y->template MutableData<std::string>()[n] = classlabels_strings_[maxclass];
+        } else {
+          Y->template MutableData<int64_t>()[n] = classlabels_ints_[maxclass];
+        }
       }
-    }
 
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
+      write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
+      zindex += scores.size();
+    }
   }
 
   return Status::OK();
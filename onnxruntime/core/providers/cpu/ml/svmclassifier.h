@@ -5,6 +5,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 
@@ -29,31 +31,76 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
+  // Computes the kernel of each of the num_rows rows of x, which are x_stride apart, with each of the num_vectors rows
+  // of vectors into out (num_rows x num_vectors). The dot products of all the pairs are a single GEMM, to which the
+  // kernel function is then applied, so a batch of samples is scored at the speed of the GEMM.
+  void batched_kernel_dot(const float* x, int64_t x_stride, int64_t num_rows, const float* vectors,
+                          int64_t num_vectors, int64_t len, KERNEL k, float* out,
+                          concurrency::ThreadPool* tp) const {
+    const int64_t num_values = num_rows * num_vectors;
+    if (num_values == 0) {
+      return;
+    }
+
+    if (k == KERNEL::RBF) {
+      // The squared distances are summed directly. Expanding them into dot products would make this a GEMM too,
+      // but loses the precision of the distances between close points, which are the kernel values that matter.
+      auto rbf_rows = [&](int64_t first, int64_t last) {
+        for (int64_t n = first; n < last; ++n) {
+          const float* pA = x + n * x_stride;
+          float* pOut = out + n * num_vectors;
+          for (int64_t j = 0; j < num_vectors; ++j) {
+            const float* pB = vectors + j * len;
+            double sum = 0;
+            for (int64_t i = 0; i < len; ++i) {
+              double val = pA[i] - pB[i];
+              sum += val * val;
+            }
+            pOut[j] = static_cast<float>(std::exp(-gamma_ * sum));
+          }
+        }
+      };
+      if (tp != nullptr) {
+        tp->ParallelForRange(0, num_rows, static_cast<double>(num_vectors * len * 3), rbf_rows);
+      } else {
+        rbf_rows(0, num_rows);
+      }
+      return;
+    }
+
+    if (len == 0) {
+      std::fill(out, out + num_values, 0.f);
+    } else {
+      math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans, CblasTrans,
+                                                   static_cast<int>(num_rows), static_cast<int>(num_vectors),
+                                                   static_cast<int>(len), k == KERNEL::LINEAR ? 1.f : gamma_,
+                                                   x, static_cast<int>(x_stride), vectors, static_cast<int>(len),
+                                                   0.f, out, static_cast<int>(num_vectors), tp);
+    }
+
     if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      for (int64_t i = 0; i < num_values; ++i)
+        out[i] = std::pow(out[i] + coef0_, degree_);
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
-      }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+      for (int64_t i = 0; i < num_values; ++i)
+        out[i] = std::tanh(out[i] + coef0_);
     }
-    return (float)sum;
+  }
+
+  // The kernels are evaluated in float, so the other input types are converted once for the whole batch.
+  static const float* AsFloat(const float* x, int64_t /*count*/, std::vector<float>& /*buffer*/) { return x; }
+
+  template <typename U>
+  static const float* AsFloat(const U* x, int64_t count, std::vector<float>& buffer) {
+    buffer.resize(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; ++i)
+      buffer[i] = static_cast<float>(x[i]);
+    return buffer.data();
+  }
+
+  // Number of samples scored together, so that the kernel values of a large batch stay within about 4MB.
+  static int64_t BlockRows(int64_t values_per_row) {
+    return std::max<int64_t>(1, (int64_t{1} << 20) / std::max<int64_t>(1, values_per_row));
   }
 
  private:
@@ -65,7 +112,9 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
+  using SVMCommon<T>::AsFloat;
+  using SVMCommon<T>::BlockRows;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
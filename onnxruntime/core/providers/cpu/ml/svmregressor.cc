@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -44,31 +45,47 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
-  const auto* x_data = X->template Data<T>();
+  if (stride < feature_count_) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input has " + std::to_string(stride) + " features, expected " + std::to_string(feature_count_));
+  }
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  std::vector<float> x_buffer;
+  const float* x_data = AsFloat(X->template Data<T>(), N * stride, x_buffer);
+  float* y_data = Y->template MutableData<float>();
+
+  // The kernels of a block of samples are one GEMM, and their weighted sums a second one with the coefficients.
+  const int64_t block_size = BlockRows(mode_ == SVM_TYPE::SVM_SVC ? vector_count_ : 1);
+  std::vector<float> kernels;
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
+  for (int64_t first = 0; first < N; first += block_size) {
+    const int64_t block_rows = std::min(block_size, N - first);
+    const float* x_block = x_data + first * stride;
+    float* sums = y_data + first;
 
-    float sum = 0.f;
     if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
+      kernels.resize(block_rows * vector_count_);
+      batched_kernel_dot(x_block, stride, block_rows, support_vectors_.data(), vector_count_, feature_count_,
+                         get_kernel_type(), kernels.data(), tp);
+      math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans, CblasNoTrans, static_cast<int>(block_rows), 1,
+                                                   static_cast<int>(vector_count_), 1.f, kernels.data(),
+                                                   static_cast<int>(vector_count_), coefficients_.data(), 1, 0.f,
+                                                   sums, 1, tp);
     } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
+      batched_kernel_dot(x_block, stride, block_rows, coefficients_.data(), 1, feature_count_, get_kernel_type(),
+                         sums, tp);
     }
-    if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
-    } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
-    } else {
-      Y->template MutableData<float>()[n] = sum;
+
+    for (int64_t n = 0; n < block_rows; n++) {  //for each example
+      float sum = sums[n] + rho_[0];
+      if (one_class_ && sum > 0) {
+        sums[n] = 1.f;
+      } else if (one_class_) {
+        sums[n] = -1.f;
+      } else {
+        sums[n] = sum;
+      }
     }
   }
 
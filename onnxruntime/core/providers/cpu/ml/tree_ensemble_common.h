@@ -0,0 +1,351 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// A node of the flattened trees. The nodes of a tree are stored in preorder with the true branch first,
+// so the true child of a branch is the node after it and only the false child is referenced.
+struct TreeNodeElement {
+  float value;
+  int32_t feature_id;  // for a leaf, the number of its weights
+  int32_t falsenode;   // for a leaf, the index of its first weight
+  uint8_t mode;
+  uint8_t missing_tracks_true;
+};
+
+static_assert(sizeof(TreeNodeElement) == 16, "TreeNodeElement is expected to fill 16 bytes");
+
+struct TreeNodeWeight {
+  int32_t target;
+  float value;
+};
+
+// The sum, min and max of the weights reached for a target, and whether any was reached.
+struct TreeScore {
+  float score;
+  float min;
+  float max;
+  bool has_score;
+};
+
+inline void MergeTreeScore(TreeScore& score, const TreeScore& other) {
+  if (!other.has_score) {
+    return;
+  }
+  if (score.has_score) {
+    score.score += other.score;
+    score.min = std::min(score.min, other.min);
+    score.max = std::max(score.max, other.max);
+  } else {
+    score = other;
+  }
+}
+
+// TreeEnsembleCommon holds the trees of TreeEnsembleClassifier and TreeEnsembleRegressor, flattened once when the
+// kernel is created, and computes the scores of the rows of an input with them.
+// The weights of the leaves are read from the attributes <weights_prefix>_treeids, _nodeids, _ids and _weights.
+template <typename T>
+class TreeEnsembleCommon {
+ public:
+  TreeEnsembleCommon(const OpKernelInfo& info, const std::string& weights_prefix);
+
+  size_t NumTrees() const {
+    return roots_.size();
+  }
+
+  // one more than the largest target or class id of the weights
+  int64_t NumTargets() const {
+    return n_targets_;
+  }
+
+  // Computes the scores of the N rows of x_data, starting from initial_scores, and calls finalize(row, scores)
+  // with the initial_scores.size() scores of each row. The rows run in parallel on the thread pool,
+  // or the trees when there are too few rows to keep it busy.
+  template <typename Finalize>
+  common::Status Compute(concurrency::ThreadPool* tp,
+                         const T* x_data,
+                         int64_t N,
+                         int64_t stride,
+                         const std::vector<TreeScore>& initial_scores,
+                         Finalize finalize) const;
+
+ private:
+  int32_t AddTreeNode(const std::map<std::pair<int64_t, int64_t>, size_t>& node_indices,
+                      const std::map<std::pair<int64_t, int64_t>, std::vector<TreeNodeWeight>>& leaf_weights,
+                      size_t index,
+                      int64_t depth);
+
+  const TreeNodeElement* ProcessTreeNodeLeave(const TreeNodeElement* node, const T* x_row) const;
+
+  void AddLeafWeights(const TreeNodeElement* leaf, TreeScore* scores) const;
+
+  void ProcessTrees(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                    size_t first_tree, size_t last_tree, TreeScore* scores, size_t n_scores) const;
+
+  std::vector<int64_t> nodes_treeids_;
+  std::vector<int64_t> nodes_nodeids_;
+  std::vector<int64_t> nodes_featureids_;
+  std::vector<float> nodes_values_;
+  std::vector<NODE_MODE> nodes_modes_;
+  std::vector<int64_t> nodes_truenodeids_;
+  std::vector<int64_t> nodes_falsenodeids_;
+  std::vector<int64_t> missing_tracks_true_;
+
+  std::vector<TreeNodeElement> nodes_;
+  std::vector<TreeNodeWeight> weights_;
+  std::vector<int32_t> roots_;
+  int64_t n_targets_ = 0;
+  int64_t max_feature_id_ = -1;
+
+  const int64_t kMaxTreeDepth_ = 1000;
+};
+
+template <typename T>
+TreeEnsembleCommon<T>::TreeEnsembleCommon(const OpKernelInfo& info, const std::string& weights_prefix)
+    : nodes_treeids_(info.GetAttrsOrDefault<int64_t>("nodes_treeids")),
+      nodes_nodeids_(info.GetAttrsOrDefault<int64_t>("nodes_nodeids")),
+      nodes_featureids_(info.GetAttrsOrDefault<int64_t>("nodes_featureids")),
+      nodes_values_(info.GetAttrsOrDefault<float>("nodes_values")),
+      nodes_truenodeids_(info.GetAttrsOrDefault<int64_t>("nodes_truenodeids")),
+      nodes_falsenodeids_(info.GetAttrsOrDefault<int64_t>("nodes_falsenodeids")),
+      missing_tracks_true_(info.GetAttrsOrDefault<int64_t>("nodes_missing_value_tracks_true")) {
+  std::vector<std::string> modes = info.GetAttrsOrDefault<std::string>("nodes_modes");
+  std::vector<int64_t> weights_treeids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_treeids");
+  std::vector<int64_t> weights_nodeids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_nodeids");
+  std::vector<int64_t> weights_ids = info.GetAttrsOrDefault<int64_t>(weights_prefix + "_ids");
+  std::vector<float> weights_values = info.GetAttrsOrDefault<float>(weights_prefix + "_weights");
+
+  ORT_ENFORCE(!nodes_treeids_.empty());
+  size_t nodes_id_size = nodes_nodeids_.size();
+  ORT_ENFORCE(nodes_id_size == nodes_treeids_.size());
+  ORT_ENFORCE(nodes_id_size == nodes_featureids_.size());
+  ORT_ENFORCE(nodes_id_size == nodes_values_.size());
+  ORT_ENFORCE(nodes_id_size == modes.size());
+  ORT_ENFORCE(nodes_id_size == nodes_truenodeids_.size());
+  ORT_ENFORCE(nodes_id_size == nodes_falsenodeids_.size());
+  ORT_ENFORCE(weights_nodeids.size() == weights_treeids.size());
+  ORT_ENFORCE(weights_nodeids.size() == weights_ids.size());
+  ORT_ENFORCE(weights_nodeids.size() == weights_values.size());
+
+  // in the absence of bool type supported by GetAttrs this ensure that we don't have any negative
+  // values so that we can check for the truth condition without worrying about negative values.
+  ORT_ENFORCE(std::all_of(
+      std::begin(missing_tracks_true_),
+      std::end(missing_tracks_true_), [](int64_t elem) { return elem >= 0; }));
+  if (missing_tracks_true_.size() != nodes_id_size) {
+    missing_tracks_true_.assign(nodes_id_size, 0);
+  }
+
+  nodes_modes_.reserve(modes.size());
+  for (const auto& mode : modes) {
+    nodes_modes_.push_back(MakeTreeNodeMode(mode));
+  }
+
+  // the nodes and the leaves are looked up by (tree id, node id)
+  std::map<std::pair<int64_t, int64_t>, size_t> node_indices;
+  for (size_t i = 0; i < nodes_id_size; ++i) {
+    node_indices.emplace(std::make_pair(nodes_treeids_[i], nodes_nodeids_[i]), i);
+  }
+
+  std::map<std::pair<int64_t, int64_t>, std::vector<TreeNodeWeight>> leaf_weights;
+  for (size_t i = 0, end = weights_nodeids.size(); i < end; ++i) {
+    ORT_ENFORCE(weights_ids[i] >= 0 && weights_ids[i] <= std::numeric_limits<int32_t>::max());
+    leaf_weights[std::make_pair(weights_treeids[i], weights_nodeids[i])].push_back(
+        {static_cast<int32_t>(weights_ids[i]), weights_values[i]});
+    n_targets_ = std::max(n_targets_, weights_ids[i] + 1);
+  }
+
+  // the roots are the nodes no branch points at
+  std::vector<bool> has_parent(nodes_id_size, false);
+  for (size_t i = 0; i < nodes_id_size; ++i) {
+    if (nodes_modes_[i] == NODE_MODE::LEAF) continue;
+    for (int64_t child : {nodes_truenodeids_[i], nodes_falsenodeids_[i]}) {
+      // they must be in the same tree
+      auto it = node_indices.find(std::make_pair(nodes_treeids_[i], child));
+      ORT_ENFORCE(it != node_indices.end(), "Tree ", nodes_treeids_[i], " has no node ", child);
+      has_parent[it->second] = true;
+    }
+  }
+
+  nodes_.reserve(nodes_id_size);
+  for (size_t i = 0; i < nodes_id_size; ++i) {
+    if (!has_parent[i]) {
+      roots_.push_back(AddTreeNode(node_indices, leaf_weights, i, 0));
+    }
+  }
+}
+
+// AddTreeNode appends the subtree of the node at index in the attributes and returns the index of its flattened node
+template <typename T>
+int32_t TreeEnsembleCommon<T>::AddTreeNode(
+    const std::map<std::pair<int64_t, int64_t>, size_t>& node_indices,
+    const std::map<std::pair<int64_t, int64_t>, std::vector<TreeNodeWeight>>& leaf_weights,
+    size_t index,
+    int64_t depth) {
+  ORT_ENFORCE(depth <= kMaxTreeDepth_, "Tree ", nodes_treeids_[index], " is deeper than ", kMaxTreeDepth_);
+  ORT_ENFORCE(nodes_.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+  const int32_t node_index = static_cast<int32_t>(nodes_.size());
+  nodes_.push_back({nodes_values_[index], 0, 0,
+                    static_cast<uint8_t>(nodes_modes_[index]),
+                    static_cast<uint8_t>(missing_tracks_true_[index] != 0)});
+
+  const int64_t tree_id = nodes_treeids_[index];
+  if (nodes_modes_[index] == NODE_MODE::LEAF) {
+    nodes_[node_index].falsenode = static_cast<int32_t>(weights_.size());
+    auto it = leaf_weights.find(std::make_pair(tree_id, nodes_nodeids_[index]));
+    if (it != leaf_weights.end()) {
+      weights_.insert(weights_.end(), it->second.begin(), it->second.end());
+      nodes_[node_index].feature_id = static_cast<int32_t>(it->second.size());
+    }
+    return node_index;
+  }
+
+  ORT_ENFORCE(nodes_featureids_[index] >= 0 && nodes_featureids_[index] <= std::numeric_limits<int32_t>::max());
+  nodes_[node_index].feature_id = static_cast<int32_t>(nodes_featureids_[index]);
+  max_feature_id_ = std::max(max_feature_id_, nodes_featureids_[index]);
+
+  AddTreeNode(node_indices, leaf_weights,
+              node_indices.at(std::make_pair(tree_id, nodes_truenodeids_[index])), depth + 1);
+  int32_t falsenode = AddTreeNode(node_indices, leaf_weights,
+                                  node_indices.at(std::make_pair(tree_id, nodes_falsenodeids_[index])), depth + 1);
+  nodes_[node_index].falsenode = falsenode;
+  return node_index;
+}
+
+template <typename T>
+inline const TreeNodeElement* TreeEnsembleCommon<T>::ProcessTreeNodeLeave(const TreeNodeElement* node,
+                                                                          const T* x_row) const {
+  const TreeNodeElement* nodes = nodes_.data();
+  while (node->mode != static_cast<uint8_t>(NODE_MODE::LEAF)) {
+    T val = x_row[node->feature_id];
+    float threshold = node->value;
+    bool is_true;
+    switch (static_cast<NODE_MODE>(node->mode)) {
+      case NODE_MODE::BRANCH_LEQ:
+        is_true = val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        is_true = val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        is_true = val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        is_true = val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        is_true = val == threshold;
+        break;
+      default:
+        is_true = val != threshold;
+        break;
+    }
+    if (!is_true && node->missing_tracks_true) {
+      is_true = std::isnan(static_cast<float>(val));
+    }
+    node = is_true ? node + 1 : nodes + node->falsenode;
+  }
+  return node;
+}
+
+template <typename T>
+inline void TreeEnsembleCommon<T>::AddLeafWeights(const TreeNodeElement* leaf, TreeScore* scores) const {
+  const TreeNodeWeight* weight = weights_.data() + leaf->falsenode;
+  for (int32_t i = 0; i < leaf->feature_id; ++i, ++weight) {
+    MergeTreeScore(scores[weight->target], {weight->value, weight->value, weight->value, true});
+  }
+}
+
+// ProcessTrees adds the weights of the trees [first_tree, last_tree) to the n_scores scores of each row
+// in [first_row, last_row). The rows walk each tree in turn, so its nodes stay in the cache.
+template <typename T>
+void TreeEnsembleCommon<T>::ProcessTrees(const T* x_data, int64_t stride, int64_t first_row, int64_t last_row,
+                                         size_t first_tree, size_t last_tree,
+                                         TreeScore* scores, size_t n_scores) const {
+  const TreeNodeElement* nodes = nodes_.data();
+  for (size_t j = first_tree; j < last_tree; ++j) {
+    const TreeNodeElement* root = nodes + roots_[j];
+    for (int64_t i = first_row; i < last_row; ++i) {
+      AddLeafWeights(ProcessTreeNodeLeave(root, x_data + i * stride), scores + (i - first_row) * n_scores);
+    }
+  }
+}
+
+template <typename T>
+template <typename Finalize>
+common::Status TreeEnsembleCommon<T>::Compute(concurrency::ThreadPool* tp,
+                                              const T* x_data,
+                                              int64_t N,
+                                              int64_t stride,
+                                              const std::vector<TreeScore>& initial_scores,
+                                              Finalize finalize) const {
+  if (max_feature_id_ >= stride) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  MakeString("The trees use feature ", max_feature_id_, " but X has ", stride, " features."));
+  }
+  const size_t n_scores = initial_scores.size();
+  ORT_RETURN_IF_NOT(n_scores >= static_cast<size_t>(n_targets_), "The scores can't hold the targets of the weights.");
+
+  // a row walks the trees in several tasks when there are too few rows for the threads
+  constexpr size_t kMinTreesPerTask = 64;
+  const size_t n_trees = roots_.size();
+  if (tp != nullptr && N == 1 && n_trees >= 2 * kMinTreesPerTask) {
+    const size_t n_tasks = std::min(static_cast<size_t>(tp->NumThreads()) + 1, n_trees / kMinTreesPerTask);
+    std::vector<TreeScore> task_scores(n_tasks * n_scores, TreeScore{0.f, 0.f, 0.f, false});
+    tp->ParallelFor(static_cast<int32_t>(n_tasks), [&](int32_t task) {
+      ProcessTrees(x_data, stride, 0, 1,
+                   n_trees * task / n_tasks, n_trees * (task + 1) / n_tasks,
+                   task_scores.data() + task * n_scores, n_scores);
+    });
+
+    // the tasks are merged in the order of the trees
+    std::vector<TreeScore> scores(initial_scores);
+    for (size_t task = 0; task < n_tasks; ++task) {
+      for (size_t k = 0; k < n_scores; ++k) {
+        MergeTreeScore(scores[k], task_scores[task * n_scores + k]);
+      }
+    }
+    finalize(0, scores.data());
+    return Status::OK();
+  }
+
+  // the rows are processed in blocks that walk a tree together
+  constexpr int64_t kRowBlockSize = 16;
+  auto process_rows = [&](int64_t first, int64_t last) {
+    std::vector<TreeScore> scores(kRowBlockSize * n_scores);
+    for (int64_t block = first; block < last; block += kRowBlockSize) {
+      const int64_t block_end = std::min(block + kRowBlockSize, last);
+      for (int64_t i = block; i < block_end; ++i) {
+        std::copy(initial_scores.begin(), initial_scores.end(), scores.begin() + (i - block) * n_scores);
+      }
+      ProcessTrees(x_data, stride, block, block_end, 0, n_trees, scores.data(), n_scores);
+      for (int64_t i = block; i < block_end; ++i) {
+        finalize(i, scores.data() + (i - block) * n_scores);
+      }
+    }
+  };
+
+  if (tp != nullptr) {
+    // a tree is roughly a dozen of nodes deep
+    tp->ParallelForRange(0, N, static_cast<double>(n_trees) * 12 * 4, process_rows);
+  } else {
+    process_rows(0, N);
+  }
+  return Status::OK();
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
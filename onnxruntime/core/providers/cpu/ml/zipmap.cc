@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
@@ -28,6 +30,54 @@ using namespace ::onnxruntime::common;
 using namespace std;
 namespace onnxruntime {
 namespace ml {
+
+namespace {
+
+// Fills the map of each label with zero and returns the column of each map entry in key order.
+template <typename TKey>
+std::vector<int64_t> MakeLabelMap(const std::vector<TKey>& labels, std::map<TKey, float>& label_map) {
+  std::map<TKey, int64_t> columns;
+  for (size_t j = 0; j < labels.size(); ++j) {
+    columns[labels[j]] = static_cast<int64_t>(j);
+    label_map[labels[j]] = 0.f;
+  }
+
+  std::vector<int64_t> column_of_entry;
+  column_of_entry.reserve(columns.size());
+  for (const auto& entry : columns) {
+    column_of_entry.push_back(entry.second);
+  }
+  return column_of_entry;
+}
+
+template <typename TKey>
+void ZipBatch(OpKernelContext* context, const float* x_data, int64_t batch_size, int64_t features_per_batch,
+              const std::map<TKey, float>& label_map, const std::vector<int64_t>& column_of_entry,
+              std::vector<std::map<TKey, float>>& y_data) {
+  y_data.resize(batch_size);
+  auto zip_samples = [&](int64_t first, int64_t last) {
+    for (int64_t n = first; n < last; ++n) {
+      const float* row = x_data + n * features_per_batch;
+      auto& sample_map = y_data[n];
+      sample_map = label_map;
+      auto column = column_of_entry.cbegin();
+      for (auto& entry : sample_map) {
+        entry.second = row[*column++];
+      }
+    }
+  };
+
+  // each sample allocates a node per label
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, batch_size, static_cast<double>(column_of_entry.size() * 64), zip_samples);
+  } else {
+    zip_samples(0, batch_size);
+  }
+}
+
+}  // namespace
+
 ONNX_CPU_OPERATOR_ML_KERNEL(
     ZipMap,
     1,
@@ -42,6 +92,11 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+  if (using_strings_) {
+    column_of_entry_ = MakeLabelMap(classlabels_strings_, string_map_);
+  } else {
+    column_of_entry_ = MakeLabelMap(classlabels_int64s_, int64_map_);
+  }
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -78,17 +133,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
 
-    //auto* y_data = Y->template MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
-    }
+    ZipBatch(context, x_data, batch_size, features_per_batch, string_map_, column_of_entry_, *y_data);
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
       return Status(ONNXRUNTIME,
@@ -98,17 +143,7 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     }
     auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    //auto* y_data = Y->template MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    ZipBatch(context, x_data, batch_size, features_per_batch, int64_map_, column_of_entry_, *y_data);
   }
   return common::Status::OK();
 }
@@ -4,6 +4,9 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+
+#include <map>
+
 namespace onnxruntime {
 namespace ml {
 
@@ -16,6 +19,13 @@ class ZipMapOp final : public OpKernel {
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+
+  // Maps with all the labels, copied for each sample, as copying a map is linear while inserting each key would
+  // compare it against the labels already inserted. column_of_entry_ is the input column of each map entry, in key
+  // order, which is the last column for a repeated label.
+  std::map<std::string, float> string_map_;
+  std::map<int64_t, float> int64_map_;
+  std::vector<int64_t> column_of_entry_;
 };
 
 }  // namespace ml
@@ -24,6 +24,9 @@
 #include "core/framework/tensor.h"
 #include "core/util/math_cpuonly.h"
 
+#include <cmath>
+#include <vector>
+
 namespace onnxruntime {
 
 template <typename T>
@@ -40,12 +43,50 @@ class BatchNorm : public OpKernel {
     }
 
     //TODO: momentum
+
+    // The scale, bias, mean and variance are usually initializers, in which case they are folded into a scale and a
+    // shift per channel once here instead of in every run.
+    const Tensor* scale;
+    const Tensor* B;
+    const Tensor* mean;
+    const Tensor* var;
+    if (op_kernel_info.TryGetConstantInput(1, &scale) && op_kernel_info.TryGetConstantInput(2, &B) &&
+        op_kernel_info.TryGetConstantInput(3, &mean) && op_kernel_info.TryGetConstantInput(4, &var)) {
+      const auto& num_channels = scale->Shape();
+      if (num_channels.NumDimensions() == 1 &&
+          B->Shape() == num_channels && mean->Shape() == num_channels && var->Shape() == num_channels) {
+        ComputeFusedScaleShift(scale, B, mean, var, epsilon_, fused_scale_, fused_shift_);
+        fused_scale_shift_ = true;
+      }
+    }
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
 
   protected:
+   // We can fuse the output computation as follows:
+   //   ((x - est_mean) * (inv_var) * scale + bias
+   // to
+   //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
+   static void ComputeFusedScaleShift(const Tensor* scale, const Tensor* B, const Tensor* mean, const Tensor* var,
+                                      float epsilon, std::vector<T>& fused_scale, std::vector<T>& fused_shift) {
+     const auto C = scale->Shape().Size();
+     fused_scale.resize(C);
+     fused_shift.resize(C);
+     const T* scale_data = scale->template Data<T>();
+     const T* B_data = B->template Data<T>();
+     const T* mean_data = mean->template Data<T>();
+     const T* var_data = var->template Data<T>();
+     for (int64_t c = 0; c < C; ++c) {
+       fused_scale[c] = scale_data[c] / std::sqrt(var_data[c] + epsilon);
+       fused_shift[c] = B_data[c] - mean_data[c] * fused_scale[c];
+     }
+   }
+
    float epsilon_;
    //int64_t is_test_;   ignored in this implementation since we're doing inferencing only.
+   bool fused_scale_shift_ = false;
+   std::vector<T> fused_scale_;
+   std::vector<T> fused_shift_;
 };
 }  // namespace onnxruntime
@@ -34,31 +34,17 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
   const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
-
-  std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+  std::shared_ptr<const ConvShapes> shapes;
+  ORT_RETURN_IF_ERROR(ComputeConvShapes(context, X, W, shapes));
+  const std::vector<int64_t>& kernel_shape = shapes->kernel_shape;
 
   bool Is2DKernel = kernel_shape.size() == 2;
-  std::vector<int64_t> pads(pads_);
-  if (pads.empty()) {
-    pads.resize(kernel_shape.size() * 2, 0);
-  }
-  std::vector<int64_t> dilations(dilations_);
-  if (dilations.empty()) {
-    dilations.resize(kernel_shape.size(), 1);
-  }
-  std::vector<int64_t> strides(strides_);
-  if (strides.empty()) {
-    strides.resize(kernel_shape.size(), 1);
-  }
-
-  std::vector<int64_t> Y_dims;
-  Y_dims.insert(Y_dims.begin(), {N, M});
-  TensorShape input_shape = X->Shape().Slice(2);
-  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& dilations = shapes->dilations;
+  const std::vector<int64_t>& strides = shapes->strides;
+  const TensorShape& input_shape = shapes->input_shape;
+  Tensor* Y = context->Output(0, shapes->Y_shape);
+  const TensorShape& output_shape = shapes->output_shape;
 
   const int64_t input_image_size = input_shape.Size();
   const int64_t output_image_size = output_shape.Size();
@@ -69,12 +55,8 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   const int64_t kernel_dim = C / group_ * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  auto col_data = alloc->Alloc(sizeof(T) * col_buffer_size);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  T* col_buffer_data = static_cast<T*>(col_buffer.get());
+  T* col_buffer_data = nullptr;
+  ORT_RETURN_IF_ERROR(context->GetScratchBuffer(static_cast<size_t>(col_buffer_size), &col_buffer_data));
 
   const T* Xdata = X->template Data<T>();
   T* Ydata = Y->template MutableData<T>();
@@ -146,7 +128,8 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-Status Conv<float>::Compute(OpKernelContext* context) const {
+template <>
+Status Conv<MLFloat16>::Compute(OpKernelContext* context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
   concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
@@ -157,33 +140,117 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
   const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+  std::shared_ptr<const ConvShapes> shapes;
+  ORT_RETURN_IF_ERROR(ComputeConvShapes(context, X, W, shapes));
+  const std::vector<int64_t>& kernel_shape = shapes->kernel_shape;
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& dilations = shapes->dilations;
+  const std::vector<int64_t>& strides = shapes->strides;
+  const TensorShape& input_shape = shapes->input_shape;
+  Tensor* Y = context->Output(0, shapes->Y_shape);
+  const TensorShape& output_shape = shapes->output_shape;
 
-  std::vector<int64_t> kernel_shape;
-  ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t X_offset = C / group_ * input_image_size;
+  const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
+  const int64_t W_offset = W->Shape().Size() / group_;
+  const int64_t kernel_dim = C / group_ * kernel_size;
+  const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-  std::vector<int64_t> pads(pads_);
-  if (pads.empty()) {
-    pads.resize(kernel_shape.size() * 2, 0);
+  // A pointwise convolution reads the image directly, otherwise the image is expanded by im2col.
+  bool is_pointwise = kernel_size == 1;
+  for (size_t i = 0; i < kernel_shape.size(); i++) {
+    is_pointwise &= strides[i] == 1 && pads[i] == 0 && pads[i + kernel_shape.size()] == 0;
   }
-  std::vector<int64_t> dilations(dilations_);
-  if (dilations.empty()) {
-    dilations.resize(kernel_shape.size(), 1);
+
+  MLAS_FP16* col_buffer_data = nullptr;
+  if (!is_pointwise) {
+    ORT_RETURN_IF_ERROR(context->GetScratchBuffer(static_cast<size_t>(col_buffer_size), &col_buffer_data));
   }
-  std::vector<int64_t> strides(strides_);
-  if (strides.empty()) {
-    strides.resize(kernel_shape.size(), 1);
+
+  // MLFloat16 holds the raw IEEE half bits that MLAS operates on.
+  const auto* Xdata = reinterpret_cast<const MLAS_FP16*>(X->Data<MLFloat16>());
+  const auto* Wdata = reinterpret_cast<const MLAS_FP16*>(W->Data<MLFloat16>());
+  auto* Ydata = reinterpret_cast<MLAS_FP16*>(Y->MutableData<MLFloat16>());
+  const auto* Bdata = B != nullptr ? reinterpret_cast<const MLAS_FP16*>(B->Data<MLFloat16>()) : nullptr;
+
+  TensorShape image_shape = X->Shape().Slice(1);
+  std::vector<int64_t> col_buffer_shape{kernel_dim};
+  col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
+                          output_shape.GetDims().end());
+
+  for (int image_id = 0; image_id < N; ++image_id) {
+    // The bias is broadcast into the output and accumulated into by the GEMM.
+    if (Bdata != nullptr) {
+      for (int64_t m = 0; m < M; m++) {
+        std::fill_n(Ydata + m * output_image_size, output_image_size, Bdata[m]);
+      }
+    }
+
+    for (int group_id = 0; group_id < group_; ++group_id) {
+      const MLAS_FP16* gemm_b = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<MLAS_FP16, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance());
+        gemm_b = col_buffer_data;
+      }
+      MlasHalfGemm(
+          CblasNoTrans,
+          CblasNoTrans,
+          static_cast<size_t>(M / group_),
+          static_cast<size_t>(output_image_size),
+          static_cast<size_t>(kernel_dim),
+          1.0f,
+          Wdata + group_id * W_offset,
+          static_cast<size_t>(kernel_dim),
+          gemm_b,
+          static_cast<size_t>(output_image_size),
+          Bdata != nullptr ? 1.0f : 0.0f,
+          Ydata + group_id * Y_offset,
+          static_cast<size_t>(output_image_size),
+          tp);
+    }
+
+    Xdata += X_offset * group_;
+    Ydata += Y_offset * group_;
   }
 
-  std::vector<int64_t> Y_dims;
-  Y_dims.insert(Y_dims.begin(), {N, M});
-  TensorShape input_shape = X->Shape().Slice(2);
-  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
+  return Status::OK();
+}
+
+Status Conv<float>::Compute(OpKernelContext* context) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const Tensor* B = num_inputs == 3 ? context->Input<Tensor>(2) : nullptr;
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W->Shape()[0];
+  std::shared_ptr<const ConvShapes> shapes;
+  ORT_RETURN_IF_ERROR(ComputeConvShapes(context, X, W, shapes));
+  const std::vector<int64_t>& kernel_shape = shapes->kernel_shape;
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& dilations = shapes->dilations;
+  const std::vector<int64_t>& strides = shapes->strides;
+  const TensorShape& input_shape = shapes->input_shape;
+  Tensor* Y = context->Output(0, shapes->Y_shape);
+  const TensorShape& output_shape = shapes->output_shape;
 
   const auto* Xdata = X->template Data<float>();
   const auto* Bdata = B != nullptr ? B->template Data<float>() : nullptr;
@@ -210,14 +277,40 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &WorkingBufferSize,
                     tp);
 
-    auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+    // The Winograd algorithm multiplies by the transformed filter. A constant W is transformed once
+    // per tile size, otherwise W is transformed into the scratch buffer, after the working buffer, on every call.
+    const bool transform_filter = Parameters.Algorithm == MlasConvAlgorithmWinograd && winograd_alloc_ == nullptr;
+    const size_t transformed_filter_size =
+        Parameters.Algorithm == MlasConvAlgorithmWinograd ? MlasConvWinogradFilterSize(&Parameters) : 0;
+    const size_t working_buffer_floats = (WorkingBufferSize + 15) & ~size_t{15};
+
+    float* working_buffer = nullptr;
+    ORT_RETURN_IF_ERROR(context->GetScratchBuffer(
+        working_buffer_floats + (transform_filter ? transformed_filter_size : 0), &working_buffer));
+
+    const float* Wdata = W->template Data<float>();
+
+    if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+      if (!transform_filter) {
+        std::lock_guard<OrtMutex> lock(winograd_mutex_);
+        auto& transformed_filter = winograd_filters_[Parameters.u.Winograd.TileSize == 4 ? 1 : 0];
+        if (!transformed_filter) {
+          transformed_filter = IAllocator::MakeUniquePtr<float>(winograd_alloc_, transformed_filter_size);
+          MlasConvWinogradTransformFilter(&Parameters, Wdata, transformed_filter.get());
+        }
+        Wdata = transformed_filter.get();
+      } else {
+        float* transformed_filter = working_buffer + working_buffer_floats;
+        MlasConvWinogradTransformFilter(&Parameters, Wdata, transformed_filter);
+        Wdata = transformed_filter;
+      }
+    }
 
     MlasConv(&Parameters,
              Xdata,
-             W->template Data<float>(),
+             Wdata,
              Bdata,
-             static_cast<float*>(working_buffer.get()),
+             working_buffer,
              Ydata,
              tp);
   } else {
@@ -230,9 +323,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     const int64_t kernel_dim = C / group_ * kernel_size;
     const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-    auto col_data = alloc->Alloc(sizeof(float) * col_buffer_size);
-    BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-    auto* col_buffer_data = static_cast<float*>(col_buffer.get());
+    float* col_buffer_data = nullptr;
+    ORT_RETURN_IF_ERROR(context->GetScratchBuffer(static_cast<size_t>(col_buffer_size), &col_buffer_data));
 
     TensorShape image_shape = X->Shape().Slice(1);
     std::vector<int64_t> col_buffer_shape{kernel_dim};
@@ -278,10 +370,18 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
-ONNX_CPU_OPERATOR_KERNEL(
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Conv,
     1,
+    float,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Conv<float>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Conv,
+    1,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Conv<MLFloat16>);
+
 }  // namespace onnxruntime
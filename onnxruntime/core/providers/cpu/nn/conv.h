@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/providers/cpu/nn/conv_base.h"
+#include "core/platform/ort_mutex.h"
 #include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
@@ -22,12 +23,28 @@ class Conv<float> : public OpKernel, public ConvBase {
  public:
   Conv<float>(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+
+    // A constant W is transformed once for the Winograd algorithm on first use.
+    const Tensor* W;
+    if (info.TryGetConstantInput(1, &W)) {
+      winograd_alloc_ = info.GetAllocator(0, OrtMemTypeDefault);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
+
+ private:
+  // W transformed by MlasConvWinogradTransformFilter for output tile sizes 2 and 4. The tile size
+  // depends on the output shape, so the cache is filled by Compute.
+  AllocatorPtr winograd_alloc_;
+  mutable OrtMutex winograd_mutex_;
+  mutable IAllocatorUniquePtr<float> winograd_filters_[2];
 };
 
+template <>
+Status Conv<MLFloat16>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
@@ -184,6 +186,57 @@ class ConvBase {
     return Status::OK();
   }
 
+  // The shapes a convolution derives from the shapes of X and W, which Conv kernels cache while they stay the same.
+  struct ConvShapes {
+    std::vector<int64_t> kernel_shape;
+    std::vector<int64_t> pads;
+    std::vector<int64_t> dilations;
+    std::vector<int64_t> strides;
+    TensorShape input_shape;   // the spatial dims of X
+    TensorShape Y_shape;
+    TensorShape output_shape;  // the spatial dims of Y
+  };
+
+  // Validates the shapes of X and W and computes the shapes of the convolution, or returns them from the shape cache
+  // if the session enables it and they were computed for the same input shapes before.
+  Status ComputeConvShapes(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                           std::shared_ptr<const ConvShapes>& shapes) const {
+    shapes = context->GetShapeCachedState<ConvShapes>();
+    if (shapes != nullptr) {
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+
+    auto new_shapes = std::make_shared<ConvShapes>();
+    std::vector<int64_t>& kernel_shape = new_shapes->kernel_shape;
+    ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+
+    new_shapes->pads = pads_;
+    if (new_shapes->pads.empty()) {
+      new_shapes->pads.resize(kernel_shape.size() * 2, 0);
+    }
+    new_shapes->dilations = dilations_;
+    if (new_shapes->dilations.empty()) {
+      new_shapes->dilations.resize(kernel_shape.size(), 1);
+    }
+    new_shapes->strides = strides_;
+    if (new_shapes->strides.empty()) {
+      new_shapes->strides.resize(kernel_shape.size(), 1);
+    }
+
+    std::vector<int64_t> Y_dims{X->Shape()[0], W->Shape()[0]};
+    new_shapes->input_shape = X->Shape().Slice(2);
+    ORT_RETURN_IF_ERROR(InferOutputShape(new_shapes->input_shape, kernel_shape, new_shapes->strides,
+                                         new_shapes->dilations, &new_shapes->pads, &Y_dims));
+    new_shapes->Y_shape = TensorShape(Y_dims);
+    new_shapes->output_shape = new_shapes->Y_shape.Slice(2);
+
+    shapes = new_shapes;
+    context->SetShapeCachedState(shapes);
+    return Status::OK();
+  }
+
   AutoPadType auto_pad_;
   int64_t group_;
   bool kernel_shape_specified_;
@@ -18,6 +18,8 @@
 #include "core/providers/cpu/nn/conv_transpose.h"
 #include "core/framework/op_kernel_context_internal.h"
 
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -242,22 +244,32 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   const int64_t X_offset = p.num_input_channels / group_ * input_image_size;
   const int64_t Y_offset = p.Y->Shape().Size() / p.Y->Shape()[0] / group_;
   const int64_t W_offset = p.F->Shape().Size() / group_;
-  const int64_t kernel_dim = p.num_output_channels / group_ * p.kernel_shape[0] * p.kernel_shape[1];
+  const int64_t kernel_size = p.kernel_shape[0] * p.kernel_shape[1];
+  const int64_t kernel_dim = p.num_output_channels / group_ * kernel_size;
   const int64_t output_image_size = p.Y->Shape()[2] * p.Y->Shape()[3];
-
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-  auto col_data = alloc->Alloc(sizeof(T) * kernel_dim * p.H * p.W);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  T* col_buffer_data = static_cast<T*>(col_buffer.get());
+  const int64_t group_output_channels = p.num_output_channels / group_;
+
+  // A 1x1 kernel with unit strides and no padding maps each input pixel to the same output pixel, so the GEMM
+  // writes the output directly and there is no column buffer to fold back.
+  const bool is_pointwise = kernel_size == 1 && p.strides[0] == 1 && p.strides[1] == 1 &&
+                            std::all_of(p.pads.begin(), p.pads.end(), [](int64_t pad) { return pad == 0; }) &&
+                            output_image_size == input_image_size;
+
+  T* col_buffer_data = nullptr;
+  if (!is_pointwise) {
+    ORT_RETURN_IF_ERROR(context->GetScratchBuffer(static_cast<size_t>(kernel_dim * input_image_size),
+                                                  &col_buffer_data));
+  }
 
   const T* Xdata = p.X->template Data<T>();
   const T* filter_data = p.F->template Data<T>();
+  const T* Bdata = p.B != nullptr ? p.B->template Data<T>() : nullptr;
   T* Ydata = p.Y->template MutableData<T>();
 
   for (auto image_id = 0; image_id < p.N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
+      T* group_output = Ydata + group_id * Y_offset;
+
       // Weight term
       math::Gemm<T>(
           CblasTrans,
@@ -269,33 +281,48 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
           filter_data + group_id * W_offset,
           Xdata + group_id * X_offset,
           0,
-          col_buffer_data,
+          is_pointwise ? group_output : col_buffer_data,
           tp);
 
-      // Col2im
-      math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
-          col_buffer_data,
-          p.num_output_channels / group_,
-          p.Y->Shape()[2],
-          p.Y->Shape()[3],
-          p.kernel_shape[0],
-          p.kernel_shape[1],
-          p.dilations[0],
-          p.dilations[1],
-          p.pads[0],
-          p.pads[1],
-          p.pads[2],
-          p.pads[3],
-          p.strides[0],
-          p.strides[1],
-          Ydata + group_id * Y_offset,
-          &CPUMathUtil::Instance());
-    }
-
-    if (p.B != nullptr) {
-      auto Ymatrix = EigenMatrixMap<T>(Ydata, output_image_size, p.num_output_channels);
-      auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-      Ymatrix.rowwise() += Bvec.transpose();
+      // The output channels fold back from disjoint rows of the column buffer, so they are split across the thread
+      // pool, and the bias of each channel is added while its output is still in cache.
+      auto col2im_channels = [&](int64_t first, int64_t last) {
+        for (int64_t c = first; c < last; ++c) {
+          T* channel_output = group_output + c * output_image_size;
+          if (!is_pointwise) {
+            math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
+                col_buffer_data + c * kernel_size * input_image_size,
+                1,
+                p.Y->Shape()[2],
+                p.Y->Shape()[3],
+                p.kernel_shape[0],
+                p.kernel_shape[1],
+                p.dilations[0],
+                p.dilations[1],
+                p.pads[0],
+                p.pads[1],
+                p.pads[2],
+                p.pads[3],
+                p.strides[0],
+                p.strides[1],
+                channel_output,
+                &CPUMathUtil::Instance());
+          }
+          if (Bdata != nullptr) {
+            EigenVectorMap<T>(channel_output, output_image_size).array() += Bdata[group_id * group_output_channels + c];
+          }
+        }
+      };
+
+      if (!is_pointwise || Bdata != nullptr) {
+        if (tp != nullptr) {
+          tp->ParallelForRange(0, group_output_channels,
+                               static_cast<double>(kernel_size * input_image_size + output_image_size),
+                               col2im_channels);
+        } else {
+          col2im_channels(0, group_output_channels);
+        }
+      }
     }
 
     Xdata += X_offset * group_;
@@ -3,7 +3,10 @@
 
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include <cmath>
+#include <vector>
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -28,17 +31,33 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
+  const int64_t num_planes = N * C;
+  if (num_planes == 0 || W == 0) {
+    return Status::OK();
   }
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  const float* X_data = input->template Data<float>();
+
+  // The mean and variance of each plane are computed first and then folded with the scale and bias of its channel
+  // into a single scale and shift, which are applied in one pass.
+  std::vector<float> plane_scale(num_planes);
+  std::vector<float> plane_shift(num_planes);
+  MlasReduceMeanVariance(X_data, plane_shift.data(), plane_scale.data(), num_planes, W, tp);
+
+  const float* scale_data = scale->template Data<float>();
+  const float* B_data = B->template Data<float>();
+  for (int64_t i = 0; i < num_planes; ++i) {
+    const float Xi_mean = plane_shift[i];
+    const float inv_stdev = 1.0f / std::sqrt(plane_scale[i] + epsilon_);
+    const float channel_scale = inv_stdev * scale_data[i % C];
+    plane_scale[i] = channel_scale;
+    plane_shift[i] = B_data[i % C] - Xi_mean * channel_scale;
+  }
+
+  MlasComputeScaleShift(X_data, Y->template MutableData<float>(), plane_scale.data(), plane_shift.data(),
+                        num_planes, num_planes, W, tp);
+
   return Status::OK();
 }
 }  // namespace onnxruntime
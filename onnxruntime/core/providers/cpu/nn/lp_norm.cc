@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/lp_norm.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -19,9 +20,10 @@ void DoNormalizeP2(
     const float* xData,
     float* yData,
     const int64_t m,
-    const int64_t n,
-    const int64_t sf) {
-  for (int i = 0; i < n; ++i) {
+    const int64_t sf,
+    int64_t first,
+    int64_t last) {
+  for (int64_t i = first; i < last; ++i) {
     auto base = (i / sf) * sf * m + (i % sf);
     ConstStridedVec xVec(xData + base, 1, m, InnerStride(sf));
     auto norm = xVec.template lpNorm<2>();
@@ -36,9 +38,10 @@ void DoNormalizeP1(
     const float* xData,
     float* yData,
     const int64_t m,
-    const int64_t n,
-    const int64_t sf) {
-  for (int i = 0; i < n; ++i) {
+    const int64_t sf,
+    int64_t first,
+    int64_t last) {
+  for (int64_t i = first; i < last; ++i) {
     auto base = (i / sf) * sf * m + (i % sf);
     ConstStridedVec xVec(xData + base, 1, m, InnerStride(sf));
     auto norm = xVec.template lpNorm<1>();
@@ -60,10 +63,22 @@ Status LpNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
   const int64_t n = input_shape.Size() / m;
   const int64_t sf = input_shape.SizeFromDimension(canonical_axis + 1);
 
-  if (p_ == 1) {
-    DoNormalizeP1(input->template Data<float>(), output->template MutableData<float>(), m, n, sf);
-  } else if (p_ == 2) {
-    DoNormalizeP2(input->template Data<float>(), output->template MutableData<float>(), m, n, sf);
+  // The n vectors are normalized independently, in parallel when there is a thread pool.
+  const float* x_data = input->template Data<float>();
+  float* y_data = output->template MutableData<float>();
+  auto normalize = [&](int64_t first, int64_t last) {
+    if (p_ == 1) {
+      DoNormalizeP1(x_data, y_data, m, sf, first, last);
+    } else if (p_ == 2) {
+      DoNormalizeP2(x_data, y_data, m, sf, first, last);
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  if (tp != nullptr && n > 1) {
+    tp->ParallelForRange(0, n, 2.0 * m, normalize);
+  } else {
+    normalize(0, n);
   }
 
   return Status::OK();
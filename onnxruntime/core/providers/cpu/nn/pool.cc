@@ -15,16 +15,10 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
 
   ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
 
-  std::vector<int64_t> pads = pads_;
-  std::vector<int64_t> kernel_shape = kernel_shape_;
-
-  if (global_pooling_) {
-    const auto& input_dims = x_shape.GetDims();
-    kernel_shape.assign(input_dims.begin() + 2, input_dims.end());
-    pads.assign(kernel_shape.size(), 0);
-  }
-
-  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads, dilations_, ceil_mode_);
+  auto shapes = PoolBase::ComputePoolShapes(context, x_shape);
+  const std::vector<int64_t>& kernel_shape = shapes->kernel_shape;
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& output_dims = shapes->output_dims;
   Tensor* Y = context->Output(0, output_dims);
 
   const auto* X_data = X->template Data<float>();
@@ -183,8 +177,9 @@ Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const
     ORT_RETURN_IF_NOT(pooling_dims == kernel_shape_.size(), "kernel_shape num_dims is not compatible with X num_dims.");
   }
 
-  std::vector<int64_t> pads = pads_;
-  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads, dilations_, ceil_mode_);
+  auto shapes = ComputePoolShapes(context, x_shape);
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& output_dims = shapes->output_dims;
   Tensor* Y = context->Output(0, output_dims);
 
   // Get access to the internal threadpool
@@ -235,10 +230,10 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
 
   ORT_RETURN_IF_NOT(x_shape.NumDimensions() >= 3, "Input dimension cannot be less than 3.");
 
-  std::vector<int64_t> pads = pads_;
-  std::vector<int64_t> kernel_shape = kernel_shape_;
-
-  std::vector<int64_t> output_dims = PoolBase::SetOutputSize(x_shape, x_shape[1], &pads, dilations_, ceil_mode_);
+  auto shapes = PoolBase::ComputePoolShapes(context, x_shape);
+  const std::vector<int64_t>& kernel_shape = shapes->kernel_shape;
+  const std::vector<int64_t>& pads = shapes->pads;
+  const std::vector<int64_t>& output_dims = shapes->output_dims;
   Tensor* Y = context->Output(0, output_dims);
   Tensor* I = context->Output(1, output_dims);
 
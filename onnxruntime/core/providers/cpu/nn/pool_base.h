@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cmath>
+#include <memory>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/autopad_type.h"
@@ -258,6 +259,35 @@ class PoolBase {
 
   Status Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
 
+  // The kernel shape, pads and output dims a pooling derives from the shape of X, which Pool kernels cache while it
+  // stays the same.
+  struct PoolShapes {
+    std::vector<int64_t> kernel_shape;
+    std::vector<int64_t> pads;
+    std::vector<int64_t> output_dims;
+  };
+
+  // Computes the shapes of the pooling, or returns them from the shape cache if the session enables it and they were
+  // computed for the same shape of X before.
+  std::shared_ptr<const PoolShapes> ComputePoolShapes(OpKernelContext* context, const TensorShape& x_shape) const {
+    auto shapes = context->GetShapeCachedState<PoolShapes>();
+    if (shapes == nullptr) {
+      auto new_shapes = std::make_shared<PoolShapes>();
+      new_shapes->kernel_shape = kernel_shape_;
+      new_shapes->pads = pads_;
+      if (global_pooling_) {
+        const auto& input_dims = x_shape.GetDims();
+        new_shapes->kernel_shape.assign(input_dims.begin() + 2, input_dims.end());
+        new_shapes->pads.assign(new_shapes->kernel_shape.size(), 0);
+      }
+      new_shapes->output_dims = SetOutputSize(x_shape, x_shape[1], &new_shapes->pads, dilations_, ceil_mode_);
+
+      shapes = new_shapes;
+      context->SetShapeCachedState(shapes);
+    }
+    return shapes;
+  }
+
  protected:
   const std::string op_name_;
   const bool global_pooling_;
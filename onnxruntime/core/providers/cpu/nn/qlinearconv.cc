@@ -2,9 +2,14 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 ONNX_OPERATOR_KERNEL_EX(
@@ -23,14 +28,17 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const auto* W = context->Input<Tensor>(3);
 
+  const int64_t M = W->Shape()[0];
+
   // validate offsets
   auto input_offset = context->Input<Tensor>(2);
   auto filter_offset = context->Input<Tensor>(5);
   auto result_offset = context->Input<Tensor>(7);
   ORT_ENFORCE(IsScalarOr1ElementVector(input_offset),
               "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(filter_offset),
-              "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(filter_offset) || IsVectorOfSize(filter_offset, M),
+              "QLinearConv : filter zero point must be a scalar, 1D tensor of size 1, "
+              "or 1D tensor with a value for each output channel");
   ORT_ENFORCE(IsScalarOr1ElementVector(result_offset),
               "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
 
@@ -40,19 +48,30 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_scale = context->Input<Tensor>(6);
   ORT_ENFORCE(IsScalarOr1ElementVector(input_scale),
               "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
-  ORT_ENFORCE(IsScalarOr1ElementVector(filter_scale),
-              "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(filter_scale) || IsVectorOfSize(filter_scale, M),
+              "QLinearConv : filter scale must be a scalar, 1D tensor of size 1, "
+              "or 1D tensor with a value for each output channel");
   ORT_ENFORCE(IsScalarOr1ElementVector(result_scale),
               "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
 
-  auto input_scale_data = *(input_scale->template Data<float>());
-  auto filter_scale_data = *(filter_scale->template Data<float>());
-  auto result_scale_data = *(result_scale->template Data<float>());
+  // the scale of each output channel of the int32 product in the output
+  const float input_scale_data = *(input_scale->template Data<float>());
+  const float result_scale_data = *(result_scale->template Data<float>());
+  std::vector<float> output_scales(filter_scale->template Data<float>(),
+                                   filter_scale->template Data<float>() + filter_scale->Shape().Size());
+  for (auto& scale : output_scales) {
+    scale = input_scale_data * scale / result_scale_data;
+  }
+
+  const uint8_t input_zero_point = *input_offset->template Data<uint8_t>();
+  const uint8_t* filter_zero_points = filter_offset->template Data<uint8_t>();
+  const int64_t filter_zero_point_count = filter_offset->Shape().Size();
 
-  const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+  // The GEMM takes a single zero point for the filter, so distinct zero points per output channel are subtracted
+  // afterwards, weighted by the sum of each column of the input patches.
+  const bool per_channel_zero_points =
+      std::any_of(filter_zero_points, filter_zero_points + filter_zero_point_count,
+                  [&](uint8_t zero_point) { return zero_point != filter_zero_points[0]; });
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -62,7 +81,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
   ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
 
   std::vector<int64_t> kernel_shape;
@@ -102,12 +120,44 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   const int64_t W_offset = W->Shape().Size() / group_;
   const int64_t kernel_dim = C / group_ * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
-  const int bias_offset = static_cast<int>(M / group_);
+  const int64_t group_output_channels = M / group_;
 
   auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * group_output_channels * output_image_size);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  std::vector<int32_t> column_sums;
+  if (per_channel_zero_points) {
+    column_sums.resize(output_image_size);
+  }
+
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  MLAS_GEMM_U8X8_PARAMETERS gemm_params;
+  gemm_params.M = static_cast<size_t>(group_output_channels);
+  gemm_params.N = static_cast<size_t>(output_image_size);
+  gemm_params.K = static_cast<size_t>(kernel_dim);
+  gemm_params.lda = gemm_params.K;
+  gemm_params.B = col_buffer_data;
+  gemm_params.ldb = gemm_params.N;
+  gemm_params.ZeroPointB = &input_zero_point;
+  gemm_params.C = gemm_output;
+  gemm_params.ldc = gemm_params.N;
+
+  // the rows of the output are the output channels
+  MLAS_REQUANTIZE_PARAMETERS requantize_params;
+  requantize_params.M = gemm_params.M;
+  requantize_params.N = gemm_params.N;
+  requantize_params.Input = gemm_output;
+  requantize_params.ldi = gemm_params.N;
+  requantize_params.ldo = gemm_params.N;
+  requantize_params.PerChannelScale = output_scales.size() > 1;
+  requantize_params.ZeroPoint = *result_offset->template Data<uint8_t>();
+
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
@@ -131,18 +181,33 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
           false,
           *input_offset->template Data<uint8_t>());
 
-      GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
-                              Ydata + group_id * Y_offset,
-                              *filter_offset->template Data<uint8_t>(),
-                              *input_offset->template Data<uint8_t>(),
-                              *result_offset->template Data<uint8_t>(),
-                              static_cast<int>(M / group_),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+      const int64_t first_channel = group_id * group_output_channels;
+      gemm_params.A = W->template Data<uint8_t>() + group_id * W_offset;
+      gemm_params.ZeroPointA = per_channel_zero_points ? 0 : filter_zero_points[0];
+      MlasGemm(&gemm_params, thread_pool);
+
+      if (per_channel_zero_points) {
+        // the padding is the input zero point, so it adds nothing to the sums
+        std::fill(column_sums.begin(), column_sums.end(), -static_cast<int32_t>(kernel_dim) * input_zero_point);
+        for (int64_t k = 0; k < kernel_dim; ++k) {
+          const uint8_t* col_row = col_buffer_data + k * output_image_size;
+          for (int64_t n = 0; n < output_image_size; ++n) {
+            column_sums[n] += col_row[n];
+          }
+        }
+        for (int64_t m = 0; m < group_output_channels; ++m) {
+          const int32_t zero_point = filter_zero_points[first_channel + m];
+          int32_t* gemm_output_row = gemm_output + m * output_image_size;
+          for (int64_t n = 0; n < output_image_size; ++n) {
+            gemm_output_row[n] -= zero_point * column_sums[n];
+          }
+        }
+      }
+
+      requantize_params.Output = Ydata + group_id * Y_offset;
+      requantize_params.Bias = bias == nullptr ? nullptr : bias->template Data<int32_t>() + first_channel;
+      requantize_params.Scale = output_scales.data() + (requantize_params.PerChannelScale ? first_channel : 0);
+      MlasRequantizeOutput(&requantize_params);
     }
 
     Xdata += X_offset * group_;
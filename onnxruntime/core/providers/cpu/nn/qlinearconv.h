@@ -4,7 +4,6 @@
 #pragma once
 
 #include "core/providers/cpu/nn/conv_base.h"
-#include "core/util/gemmlowp_common.h"
 
 namespace onnxruntime {
 class QLinearConv : public OpKernel, public ConvBase {
@@ -12,6 +11,6 @@ class QLinearConv : public OpKernel, public ConvBase {
   explicit QLinearConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
   }
 
-  Status Compute(OpKernelContext* context) const override;  
+  Status Compute(OpKernelContext* context) const override;
 };
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/nn/roi_pool.h"
 #include <cmath>
+#include <limits>
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
@@ -35,63 +37,97 @@ Status RoiPool<float>::Compute(OpKernelContext* context) const {
 
   auto* Ydata = Y->template MutableData<float>();
 
+  const int64_t roi_cols = R->Shape().SizeFromDimension(1);
   for (int n = 0; n < num_rois; n++) {
-    int roi_batch_id = static_cast<int>(rois[0]);
-    int roi_start_w = static_cast<int>(std::round(rois[1] * spatial_scale_));
-    int roi_start_h = static_cast<int>(std::round(rois[2] * spatial_scale_));
-    int roi_end_w = static_cast<int>(std::round(rois[3] * spatial_scale_));
-    int roi_end_h = static_cast<int>(std::round(rois[4] * spatial_scale_));
+    int roi_batch_id = static_cast<int>(rois[n * roi_cols]);
     ORT_ENFORCE(roi_batch_id >= 0);
     ORT_ENFORCE(roi_batch_id < batch_size);
+  }
 
-    // Force malformed ROIs to be 1x1
-    int roi_height = std::max(roi_end_h - roi_start_h + 1, 1);
-    int roi_width = std::max(roi_end_w - roi_start_w + 1, 1);
-
-    const float bin_size_h =
-        static_cast<float>(roi_height) / static_cast<float>(pooled_height_);
-    const float bin_size_w =
-        static_cast<float>(roi_width) / static_cast<float>(pooled_width_);
-
-    const float* batch_data = Xdata + roi_batch_id * X->Shape().SizeFromDimension(1);
-
-    for (int c = 0; c < channels; ++c) {
-      for (int ph = 0; ph < pooled_height_; ++ph) {
-        for (int pw = 0; pw < pooled_width_; ++pw) {
-          // Compute pooling region for this output unit:
-          //  start (included) = floor(ph * roi_height / pooled_height_)
-          //  end (excluded) = ceil((ph + 1) * roi_height / pooled_height_)
+  const int64_t image_size = X->Shape().SizeFromDimension(1);
+  const int64_t channel_size = X->Shape().SizeFromDimension(2);
+  const int64_t pooled_size = Y->Shape().SizeFromDimension(2);
+
+  // The work is split over (roi, channel) pairs. The pooling regions of a ROI are shared by all its channels, and
+  // are separable: the rows of a region only depend on ph and its columns on pw. A range of pairs computes them
+  // once for each of its ROIs.
+  auto work = [&](int64_t first, int64_t last) {
+    std::vector<int> hstarts(pooled_height_), hends(pooled_height_);
+    std::vector<int> wstarts(pooled_width_), wends(pooled_width_);
+    int64_t regions_roi = -1;
+    const float* batch_data = nullptr;
+
+    for (int64_t unit = first; unit < last; ++unit) {
+      const int64_t n = unit / channels;
+      const int64_t c = unit % channels;
+
+      if (n != regions_roi) {
+        const float* roi = rois + n * roi_cols;
+        int roi_batch_id = static_cast<int>(roi[0]);
+        int roi_start_w = static_cast<int>(std::round(roi[1] * spatial_scale_));
+        int roi_start_h = static_cast<int>(std::round(roi[2] * spatial_scale_));
+        int roi_end_w = static_cast<int>(std::round(roi[3] * spatial_scale_));
+        int roi_end_h = static_cast<int>(std::round(roi[4] * spatial_scale_));
+
+        // Force malformed ROIs to be 1x1
+        int roi_height = std::max(roi_end_h - roi_start_h + 1, 1);
+        int roi_width = std::max(roi_end_w - roi_start_w + 1, 1);
+
+        const float bin_size_h =
+            static_cast<float>(roi_height) / static_cast<float>(pooled_height_);
+        const float bin_size_w =
+            static_cast<float>(roi_width) / static_cast<float>(pooled_width_);
+
+        // Compute pooling region for each output unit:
+        //  start (included) = floor(ph * roi_height / pooled_height_)
+        //  end (excluded) = ceil((ph + 1) * roi_height / pooled_height_)
+        // Add roi offsets and clip to input boundaries
+        for (int ph = 0; ph < pooled_height_; ++ph) {
           int hstart = static_cast<int>(std::floor(static_cast<float>(ph) * bin_size_h));
-          int wstart = static_cast<int>(std::floor(static_cast<float>(pw) * bin_size_w));
           int hend = static_cast<int>(std::ceil(static_cast<float>(ph + 1) * bin_size_h));
+          hstarts[ph] = std::min(std::max(hstart + roi_start_h, 0), height);
+          hends[ph] = std::min(std::max(hend + roi_start_h, 0), height);
+        }
+        for (int pw = 0; pw < pooled_width_; ++pw) {
+          int wstart = static_cast<int>(std::floor(static_cast<float>(pw) * bin_size_w));
           int wend = static_cast<int>(std::ceil(static_cast<float>(pw + 1) * bin_size_w));
+          wstarts[pw] = std::min(std::max(wstart + roi_start_w, 0), width);
+          wends[pw] = std::min(std::max(wend + roi_start_w, 0), width);
+        }
 
-          // Add roi offsets and clip to input boundaries
-          hstart = std::min(std::max(hstart + roi_start_h, 0), height);
-          hend = std::min(std::max(hend + roi_start_h, 0), height);
-          wstart = std::min(std::max(wstart + roi_start_w, 0), width);
-          wend = std::min(std::max(wend + roi_start_w, 0), width);
+        batch_data = Xdata + roi_batch_id * image_size;
+        regions_roi = n;
+      }
 
-          const int pool_index = static_cast<int>(ph * pooled_width_ + pw);
+      const float* channel_data = batch_data + c * channel_size;
+      float* output = Ydata + unit * pooled_size;
 
+      for (int ph = 0; ph < pooled_height_; ++ph) {
+        for (int pw = 0; pw < pooled_width_; ++pw) {
           // Define an empty pooling region to be zero
-          bool is_empty = (hend <= hstart) || (wend <= wstart);
-          Ydata[pool_index] = is_empty ? 0 : std::numeric_limits<float>::lowest();
+          bool is_empty = (hends[ph] <= hstarts[ph]) || (wends[pw] <= wstarts[pw]);
+          float max_value = is_empty ? 0 : std::numeric_limits<float>::lowest();
 
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              const int index = h * width + w;
-              Ydata[pool_index] = std::max(batch_data[index], Ydata[pool_index]);
+          for (int h = hstarts[ph]; h < hends[ph]; ++h) {
+            const float* row = channel_data + h * width;
+            for (int w = wstarts[pw]; w < wends[pw]; ++w) {
+              max_value = std::max(row[w], max_value);
             }
           }
+
+          output[ph * pooled_width_ + pw] = max_value;
         }
       }
-      // Increment all data pointers by one channel
-      batch_data += X->Shape().SizeFromDimension(2);
-      Ydata += Y->Shape().SizeFromDimension(2);
     }
-    // Increment ROI data pointer
-    rois += R->Shape().SizeFromDimension(1);
+  };
+
+  // a (roi, channel) pair reads about the area of the ROI, which is only known per ROI, so assume the whole image
+  const double cost = static_cast<double>(channel_size + pooled_size);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, static_cast<int64_t>(num_rois) * channels, cost, work);
+  } else {
+    work(0, static_cast<int64_t>(num_rois) * channels);
   }
 
   return Status::OK();
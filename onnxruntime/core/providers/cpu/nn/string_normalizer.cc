@@ -4,12 +4,15 @@
 #include "string_normalizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <locale.h>
 #endif
 
+#include <algorithm>
 #include <codecvt>
 #include <locale>
 #include <functional>
@@ -101,53 +104,68 @@ const std::string default_locale("en_US.UTF-8");
 
 #endif
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      std::wstring_convert<std::codecvt_utf8<wchar_t>>& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
-  std::vector<int64_t> output_dims;
-  if (N == 1) {
-    output_dims.push_back(1);
-  }
+using Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
 
-  // Empty output case
-  if (C == 0) {
-    output_dims.push_back(1);
-    TensorShape output_shape(output_dims);
-    // This will create one empty string
-    ctx->Output(0, output_shape);
-    return Status::OK();
+// Whether all the chars of s are ASCII, which is checked for all of them at once so that the loop is vectorized.
+inline bool IsAscii(const std::string& s) {
+  unsigned char bits = 0;
+  for (char c : s) {
+    bits |= static_cast<unsigned char>(c);
   }
+  return bits < 0x80;
+}
 
-  output_dims.push_back(C);
+// Branch free, so that the loops that change the case of a string are vectorized.
+inline char AsciiToLower(char c) {
+  return static_cast<char>(c + (static_cast<unsigned char>(c - 'A') < 26 ? 'a' - 'A' : 0));
+}
 
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
+inline char AsciiToUpper(char c) {
+  return static_cast<char>(c - (static_cast<unsigned char>(c - 'a') < 26 ? 'a' - 'A' : 0));
+}
+
+// Whether loc changes the case of every ASCII char like AsciiToLower and AsciiToUpper, which is not the case of e.g.
+// a Turkish locale where the lower case of 'I' is a dotless i.
+bool IsAsciiCaseCompatible(const Locale& loc) {
+  for (auto caseaction : {StringNormalizer::LOWER, StringNormalizer::UPPER}) {
+    std::wstring wstr;
+    for (wchar_t ch = 0; ch < 0x80; ++ch) {
+      wstr.push_back(ch);
+    }
+    loc.ChangeCase(caseaction, wstr);
+    for (wchar_t ch = 0; ch < 0x80; ++ch) {
+      const char c = static_cast<char>(ch);
+      const char expected = (caseaction == StringNormalizer::LOWER) ? AsciiToLower(c) : AsciiToUpper(c);
+      if (wstr[ch] != static_cast<wchar_t>(expected)) {
+        return false;
       }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
+    }
+  }
+  return true;
+}
+
+// Writes s with its case changed to out. Returns false if s is not valid utf8.
+bool ChangeCase(const std::string& s, StringNormalizer::CaseAction caseaction, bool ascii_case_fast_path,
+                const Locale& loc, Converter& converter, std::string& out) {
+  assert(caseaction != StringNormalizer::NONE);
+  if (ascii_case_fast_path && IsAscii(s)) {
+    out.resize(s.size());
+    if (caseaction == StringNormalizer::LOWER) {
+      std::transform(s.cbegin(), s.cend(), out.begin(), [](char c) { return AsciiToLower(c); });
     } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+      std::transform(s.cbegin(), s.cend(), out.begin(), [](char c) { return AsciiToUpper(c); });
     }
-    ++output_idx;
-    ++first;
+    return true;
   }
-  return Status::OK();
+
+  std::wstring wstr = converter.from_bytes(s);
+  if (wstr == wconv_error) {
+    return false;
+  }
+  // In place transform
+  loc.ChangeCase(caseaction, wstr);
+  out = converter.to_bytes(wstr);
+  return true;
 }
 }  // namespace string_normalizer
 
@@ -180,9 +198,9 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+  locale_ = std::make_unique<Locale>(info.GetAttrOrDefault("locale", default_locale));
+  ascii_case_fast_path_ = IsAsciiCaseCompatible(*locale_);
+  Converter converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
   for (const auto& sw : swords) {
@@ -191,15 +209,17 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
       auto p = stopwords_.insert(sw);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
-      auto p = wstopwords_.insert(wstr);
+      std::string cased;
+      ORT_ENFORCE(ChangeCase(sw, compare_caseaction_, ascii_case_fast_path_, *locale_, converter, cased),
+                  "Stopword contains invalid utf8 chars");
+      auto p = cased_stopwords_.insert(std::move(cased));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -227,70 +247,79 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+  // The strings are normalized in ranges on the thread pool. A string that is kept is written to normalized with the
+  // output case, and with case-insensitive stopwords it is first changed to the case of the stopwords to compare them.
+  constexpr uint8_t kKeep = 0;
+  constexpr uint8_t kDrop = 1;
+  constexpr uint8_t kInvalidUtf8 = 2;
   auto const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
-  if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
+  const bool has_stopwords = is_case_sensitive_ ? !stopwords_.empty() : !cased_stopwords_.empty();
+  std::vector<std::string> normalized(C);
+  std::vector<uint8_t> states(C, kKeep);
+
+  auto normalize = [&](int64_t first, int64_t last) {
+    Converter converter(conv_error, wconv_error);
+    for (auto i = static_cast<size_t>(first); i < static_cast<size_t>(last); ++i) {
+      const std::string& s = input_data[i];
+      if (has_stopwords && is_case_sensitive_ && stopwords_.count(s) != 0) {
+        states[i] = kDrop;
+      } else if (has_stopwords && !is_case_sensitive_) {
+        std::string cased;
+        if (!ChangeCase(s, compare_caseaction_, ascii_case_fast_path_, *locale_, converter, cased)) {
+          states[i] = kInvalidUtf8;
+        } else if (cased_stopwords_.count(cased) != 0) {
+          states[i] = kDrop;
+        } else if (case_change_action_ == NONE) {
+          normalized[i] = s;
+        } else {
+          // compare_caseaction_ is the output case
+          normalized[i] = std::move(cased);
         }
-        ++first;
+      } else if (case_change_action_ == NONE) {
+        normalized[i] = s;
+      } else if (!ChangeCase(s, case_change_action_, ascii_case_fast_path_, *locale_, converter, normalized[i])) {
+        states[i] = kInvalidUtf8;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
     }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, static_cast<int64_t>(C), 256.0, normalize);
   } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
-      std::vector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars at: " + s);
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
-          if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
-          } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
-          }
-        }
-        ++first;
-      }
-      if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
-      } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
-      }
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+    normalize(0, static_cast<int64_t>(C));
+  }
+
+  auto invalid = std::find(states.cbegin(), states.cend(), kInvalidUtf8);
+  if (invalid != states.cend()) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input contains invalid utf8 chars at: " + input_data[invalid - states.cbegin()]);
+  }
+
+  std::vector<int64_t> output_dims;
+  if (N == 1) {
+    output_dims.push_back(1);
+  }
+
+  const auto output_size = static_cast<size_t>(std::count(states.cbegin(), states.cend(), kKeep));
+  // Empty output case
+  if (output_size == 0) {
+    output_dims.push_back(1);
+    TensorShape output_shape(output_dims);
+    // This will create one empty string
+    ctx->Output(0, output_shape);
+    return Status::OK();
+  }
+
+  output_dims.push_back(output_size);
+  TensorShape output_shape(output_dims);
+  auto output_tensor = ctx->Output(0, output_shape);
+  auto output_data = output_tensor->template MutableData<std::string>();
+  for (size_t i = 0; i < C; ++i) {
+    if (states[i] == kKeep) {
+      *output_data++ = std::move(normalized[i]);
     }
   }
-  return status;
+  return Status::OK();
 }
 }  // namespace onnxruntime
@@ -4,12 +4,12 @@
 #include "tfidfvectorizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
-#include <functional>
-#include <unordered_set>
-#include <ostream>
-#include <iterator>
+#include <algorithm>
+#include <unordered_map>
 
 namespace onnxruntime {
 
@@ -40,151 +40,6 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>()),
     TfIdfVectorizer);
 
-namespace ngram_details {
-
-class NgramEntryBase {
-  size_t id_;  // Id in the pool
- protected:
-  NgramEntryBase(size_t id) : id_(id) {}
-  ~NgramEntryBase() = default;
-
- public:
-  size_t Id() const { return id_; }
-};
-
-template <class T>
-class NgramEntry;
-
-template <>
-class NgramEntry<int64_t> : public NgramEntryBase {
-  std::vector<int64_t> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf{};
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
-
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(*first);
-      ++first;
-    }
-    assert(!items_.empty());
-  }
-  // For sampling
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(int64_t v) {
-    items_.push_back(v);
-    RunningHash(v);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
-  bool operator==(const NgramEntry& o) const {
-    return items_ == o.items_;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
-};
-
-template <>
-class NgramEntry<int32_t> : public NgramEntry<int64_t> {
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntry<int64_t>(id, first, last) {}
-  explicit NgramEntry() = default;
-};
-
-template <>
-class NgramEntry<std::string> : public NgramEntryBase {
- private:
-  std::vector<std::reference_wrapper<const std::string>> items_;
-  size_t hash_ = 0;
-
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf{};
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
-
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(std::cref(*first));
-      ++first;
-    }
-    assert(!items_.empty());
-  }
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(const std::string& s) {
-    items_.push_back(std::cref(s));
-    RunningHash(s);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
-
-  bool operator==(const NgramEntry& o) const {
-    if (items_.size() == o.items_.size()) {
-      return std::equal(items_.cbegin(), items_.cend(),
-                        o.items_.cbegin(), o.items_.cend(),
-                        std::equal_to<std::string>());
-    }
-    return false;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
-};
-
-using IntegerPoolSet = std::unordered_set<NgramEntry<int64_t>>;
-// Does not own strings, contains references to them. This helps
-// to search by string references that point to the current input.
-using StringPoolSet = std::unordered_set<NgramEntry<std::string>>;
-
-template <typename ForwardIter, typename Cont>
-inline void Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Cont& c) {
-  for (; ngrams > 0; --ngrams) {
-    c.emplace(ngram_id, first, first + ngram_size);
-    first += ngram_size;
-    ++ngram_id;
-  }
-}
-
-}  // namespace ngram_details
-}  // namespace onnxruntime
-
-using namespace onnxruntime::ngram_details;
-
-namespace std {
-template <typename T>
-struct hash<NgramEntry<T>> {
-  typedef NgramEntry<T> argument_type;
-  typedef size_t result_type;
-  result_type operator()(const argument_type& a) const {
-    return a.Hash();
-  }
-};
-}  // namespace std
-
-namespace onnxruntime {
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -220,11 +75,15 @@ struct TfIdfVectorizer::Impl {
   std::vector<float> weights_;
 
   std::vector<std::string> pool_strings_;
-  // This set contains references to pool_string_ entries
-  // of pool_strings attribute
-  StringPoolSet str_set_;
-  // This set contains pool_int64s entries
-  IntegerPoolSet int64_set_;
+  // The n-grams of the pool with a size in [min_gram_length, max_gram_length] as a trie over the ids of their
+  // items. Node 0 is the root, and the child of a node for an item is found in children_ by the key
+  // (node << 32 | item id), so that a row is matched by walking down the trie from each position and stops as soon as
+  // no n-gram of the pool starts with the items seen so far.
+  std::unordered_map<std::string, int32_t> str_item_ids_;
+  std::unordered_map<int64_t, int32_t> int64_item_ids_;
+  std::unordered_map<uint64_t, int32_t> children_;
+  // Id in the pool of the n-gram that ends at each node, or -1 when the node is only the prefix of longer n-grams.
+  std::vector<int64_t> node_ngram_ids_{-1};
   size_t output_size_ = 0;
 
   Impl() = default;
@@ -232,11 +91,45 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
-  template <typename T>
-  auto PoolEnd() const;
+  int32_t ItemId(const std::string& item) const {
+    auto hit = str_item_ids_.find(item);
+    return hit == str_item_ids_.cend() ? -1 : hit->second;
+  }
+
+  int32_t ItemId(int64_t item) const {
+    auto hit = int64_item_ids_.find(item);
+    return hit == int64_item_ids_.cend() ? -1 : hit->second;
+  }
+
+  int32_t ItemId(int32_t item) const {
+    return ItemId(static_cast<int64_t>(item));
+  }
+
+  int32_t AddItem(const std::string& item) {
+    return str_item_ids_.emplace(item, static_cast<int32_t>(str_item_ids_.size())).first->second;
+  }
+
+  int32_t AddItem(int64_t item) {
+    return int64_item_ids_.emplace(item, static_cast<int32_t>(int64_item_ids_.size())).first->second;
+  }
+
+  static uint64_t ChildKey(int32_t node, int32_t item_id) {
+    return (static_cast<uint64_t>(node) << 32) | static_cast<uint32_t>(item_id);
+  }
+
+  // Returns the child of node for item_id, or -1 when there is none.
+  int32_t Child(int32_t node, int32_t item_id) const {
+    if (item_id < 0) {
+      return -1;
+    }
+    auto hit = children_.find(ChildKey(node, item_id));
+    return hit == children_.cend() ? -1 : hit->second;
+  }
+
+  template <typename ForwardIter>
+  void AddNgrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id);
 
-  template <typename T>
-  auto PoolFind(const ngram_details::NgramEntry<T>&) const;
+  void CountRow(const std::vector<int32_t>& item_ids, size_t row_num, std::vector<uint32_t>& frequencies) const;
 
   void IncrementCount(size_t ngram_id, size_t row_num,
                       std::vector<uint32_t>& frequencies) const {
@@ -247,34 +140,61 @@ struct TfIdfVectorizer::Impl {
   }
 };
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int64_t>() const {
-  return int64_set_.cend();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int32_t>() const {
-  return PoolEnd<int64_t>();
-}
-
-template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<std::string>() const {
-  return str_set_.cend();
+template <typename ForwardIter>
+void TfIdfVectorizer::Impl::AddNgrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id) {
+  for (; ngrams > 0; --ngrams) {
+    int32_t node = 0;
+    for (size_t i = 0; i < ngram_size; ++i, ++first) {
+      auto child = children_.emplace(ChildKey(node, AddItem(*first)), static_cast<int32_t>(node_ngram_ids_.size()));
+      if (child.second) {
+        node_ngram_ids_.push_back(-1);
+      }
+      node = child.first->second;
+    }
+    ORT_ENFORCE(node_ngram_ids_[node] < 0, pool_strings_.empty() ? "pool_int64s" : "pool_strings",
+                " duplicate ", std::to_string(ngram_size), "-grams detected");
+    node_ngram_ids_[node] = static_cast<int64_t>(ngram_id);
+    ++ngram_id;
+  }
 }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int64_t>(const NgramEntry<int64_t>& i) const {
-  return int64_set_.find(i);
-}
+void TfIdfVectorizer::Impl::CountRow(const std::vector<int32_t>& item_ids, size_t row_num,
+                                     std::vector<uint32_t>& frequencies) const {
+  const size_t C = item_ids.size();
+  const size_t max_gram_length = static_cast<size_t>(max_gram_length_);
+  size_t start_ngram_size = static_cast<size_t>(min_gram_length_);
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int32_t>(const NgramEntry<int32_t>& i) const {
-  return int64_set_.find(i);
-}
+  // Treat 1-grams in a special way, they are counted once instead of once per skip distance
+  if (start_ngram_size == 1) {
+    for (auto item_id : item_ids) {
+      auto node = Child(0, item_id);
+      if (node >= 0 && node_ngram_ids_[node] >= 0) {
+        IncrementCount(node_ngram_ids_[node], row_num, frequencies);
+      }
+    }
+    if (++start_ngram_size > max_gram_length) {
+      return;
+    }
+  }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<std::string>(const NgramEntry<std::string>& i) const {
-  return str_set_.find(i);
+  const size_t max_skip_distance = static_cast<size_t>(max_skip_count_) + 1;  // Convert to distance
+  for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    for (size_t ngram_start = 0; ngram_start < C; ++ngram_start) {
+      int32_t node = 0;
+      for (size_t ngram_size = 1, ngram_item = ngram_start;
+           ngram_size <= max_gram_length && ngram_item < C;
+           ++ngram_size, ngram_item += skip_distance) {
+        node = Child(node, item_ids[ngram_item]);
+        if (node < 0) {
+          break;
+        }
+        // Do not count anything before start_ngram_size
+        if (ngram_size >= start_ngram_size && node_ngram_ids_[node] >= 0) {
+          IncrementCount(node_ngram_ids_[node], row_num, frequencies);
+        }
+      }
+    }
+  }
 }
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(new Impl) {
@@ -359,16 +279,12 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the trie ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (impl_->pool_strings_.empty()) {
-          auto before_insert = impl_->int64_set_.size();
-          Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->int64_set_.size(), "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
+          impl_->AddNgrams(pool_int64s.cbegin() + start_idx, ngrams, ngram_size, ngram_id);
         } else {
-          auto before_insert = impl_->str_set_.size();
-          Emplace(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->str_set_.size(), "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
+          impl_->AddNgrams(impl_->pool_strings_.cbegin() + start_idx, ngrams, ngram_size, ngram_id);
         }
       } else {
         ngram_id += ngrams;
@@ -435,7 +351,6 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
 template <typename T>
 Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   const auto& impl = *impl_;
-  auto const set_end = impl.PoolEnd<T>();
 
   auto X = ctx->Input<Tensor>(0);
   auto& input_shape = X->Shape();
@@ -482,81 +397,26 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
 
   assert((b_dim * C) == total_items);
 
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+  // The rows update disjoint parts of frequencies, so they are counted in parallel. Each item of a row is mapped to
+  // its id in the pool once, and the n-grams starting at each position are matched by walking the trie.
   auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
-
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
-        }
-        ++ngram_start;
-      }
-      ++row_num;
-      ngram_start = ngram_row_end;
+  auto count_rows = [&](int64_t first, int64_t last) {
+    std::vector<int32_t> item_ids(C);
+    for (auto row_num = static_cast<size_t>(first); row_num < static_cast<size_t>(last); ++row_num) {
+      auto const row = input_data + row_num * C;
+      std::transform(row, row + C, item_ids.begin(), [&impl](const T& item) { return impl.ItemId(item); });
+      impl.CountRow(item_ids, row_num, frequencies);
     }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
-    }
-  }
+  };
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
-          break;
-        }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
-          // Do not test anything before start_ngram_size
-          if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
-              // record frequency
-              auto ngram_id = hit->Id();
-              impl.IncrementCount(ngram_id, row_num, frequencies);
-            }
-          }
-        }
-        // Sliding window shift
-        ++ngram_start;
-      }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
-    }
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr && b_dim > 1) {
+    const double row_cost = static_cast<double>(C) * (impl.max_skip_count_ + 1) * impl.max_gram_length_ * 16;
+    tp->ParallelForRange(0, static_cast<int64_t>(b_dim), row_cost, count_rows);
+  } else {
+    count_rows(0, static_cast<int64_t>(b_dim));
   }
+
   OutputResult(ctx, B, frequencies);
   return Status::OK();
 }
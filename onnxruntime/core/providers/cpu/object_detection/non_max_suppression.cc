@@ -13,7 +13,9 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include <numeric>
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 
@@ -130,61 +132,142 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
     ScoreIndexPair() = default;
     explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
 
+    // Orders the heap of candidates by descending score, and the boxes of equal scores by ascending index.
     bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
+      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
     }
   };
 
   const auto center_point_box = GetCenterPointBox();
+  const int64_t num_boxes = pc.num_boxes_;
+  const int64_t num_tasks = pc.num_batches_ * pc.num_classes_;
+
+  // The corners and areas of all the boxes, one array per field, so that a candidate is tested against all the boxes
+  // selected before it in a single loop that the compiler can vectorize.
+  const int64_t total_boxes = pc.num_batches_ * num_boxes;
+  std::vector<float> box_fields(5 * total_boxes);
+  float* const x_min = box_fields.data();
+  float* const y_min = x_min + total_boxes;
+  float* const x_max = y_min + total_boxes;
+  float* const y_max = x_max + total_boxes;
+  float* const area = y_max + total_boxes;
+  for (int64_t i = 0; i < total_boxes; ++i) {
+    const float* box = boxes_data + 4 * i;
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], x_min[i], x_max[i]);
+      MaxMin(box[0], box[2], y_min[i], y_max[i]);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[i] = box[0] - width_half;
+      x_max[i] = box[0] + width_half;
+      y_min[i] = box[1] - height_half;
+      y_max[i] = box[1] + height_half;
+    }
+    area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+  }
+
+  // Each (batch, class) pair writes the indices of its selected boxes to its own slot of selected_boxes.
+  const int64_t max_selected = std::min(max_output_boxes_per_class, num_boxes);
+  std::vector<int64_t> selected_boxes(num_tasks * max_selected);
+  std::vector<int64_t> num_selected_boxes(num_tasks, 0);
+
+  auto select_boxes = [&](int64_t first, int64_t last) {
+    std::vector<ScoreIndexPair> candidates;
+    candidates.reserve(num_boxes);
+    std::vector<float> selected_fields(5 * max_selected);
+    float* const sel_x_min = selected_fields.data();
+    float* const sel_y_min = sel_x_min + max_selected;
+    float* const sel_x_max = sel_y_min + max_selected;
+    float* const sel_y_max = sel_x_max + max_selected;
+    float* const sel_area = sel_y_max + max_selected;
+
+    for (int64_t task = first; task < last; ++task) {
+      const int64_t batch_index = task / pc.num_classes_;
+      const auto* class_scores = scores_data + task * num_boxes;
 
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
       // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
+      candidates.clear();
       if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+        for (int64_t box_index = 0; box_index < num_boxes; ++box_index) {
+          if (class_scores[box_index] > score_threshold) {
+            candidates.emplace_back(class_scores[box_index], box_index);
           }
         }
       } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+        for (int64_t box_index = 0; box_index < num_boxes; ++box_index) {
+          candidates.emplace_back(class_scores[box_index], box_index);
         }
       }
 
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
+      // The candidates are only sorted as far as they are consumed, which is usually a small part of them once
+      // max_output_boxes_per_class boxes are selected.
+      std::make_heap(candidates.begin(), candidates.end());
+
+      int64_t* task_selected = selected_boxes.data() + task * max_selected;
+      int64_t num_selected = 0;
+      auto candidates_end = candidates.end();
       // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
-            break;
-          }
+      while (candidates_end != candidates.begin() && num_selected < max_selected) {
+        std::pop_heap(candidates.begin(), candidates_end);
+        --candidates_end;
+        const int64_t box = batch_index * num_boxes + candidates_end->index_;
+
+        const float box_x_min = x_min[box];
+        const float box_y_min = y_min[box];
+        const float box_x_max = x_max[box];
+        const float box_y_max = y_max[box];
+        const float box_area = area[box];
+
+        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+        // threshold. The same tests as SuppressByIOU, without branches.
+        int suppressed = 0;
+        for (int64_t i = 0; i < num_selected; ++i) {
+          const float intersection_area = std::max(std::min(box_x_max, sel_x_max[i]) -
+                                                       std::max(box_x_min, sel_x_min[i]),
+                                                   .0f) *
+                                          std::max(std::min(box_y_max, sel_y_max[i]) -
+                                                       std::max(box_y_min, sel_y_min[i]),
+                                                   .0f);
+          const float union_area = box_area + sel_area[i] - intersection_area;
+          suppressed |= static_cast<int>(intersection_area > .0f) &
+                        static_cast<int>(box_area > .0f) &
+                        static_cast<int>(sel_area[i] > .0f) &
+                        static_cast<int>(union_area > .0f) &
+                        static_cast<int>(intersection_area / union_area > iou_threshold);
         }
 
-        if (selected) {
-          if (max_output_boxes_per_class > 0 &&
-              static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
-            break;
-          }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+        if (!suppressed) {
+          sel_x_min[num_selected] = box_x_min;
+          sel_y_min[num_selected] = box_y_min;
+          sel_x_max[num_selected] = box_x_max;
+          sel_y_max[num_selected] = box_y_max;
+          sel_area[num_selected] = box_area;
+          task_selected[num_selected++] = candidates_end->index_;
         }
       }  //while
-    }    //for class_index
-  }      //for batch_index
+      num_selected_boxes[task] = num_selected;
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr && num_tasks > 1) {
+    tp->ParallelForRange(0, num_tasks, static_cast<double>(num_boxes) * 16.0, select_boxes);
+  } else {
+    select_boxes(0, num_tasks);
+  }
+
+  std::vector<SelectedIndex> selected_indices;
+  selected_indices.reserve(std::accumulate(num_selected_boxes.begin(), num_selected_boxes.end(), int64_t{0}));
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    const int64_t* task_selected = selected_boxes.data() + task * max_selected;
+    for (int64_t i = 0; i < num_selected_boxes[task]; ++i) {
+      selected_indices.emplace_back(task / pc.num_classes_, task % pc.num_classes_, task_selected[i]);
+    }
+  }
 
   const auto last_dim = 3;
   const auto num_selected = selected_indices.size();
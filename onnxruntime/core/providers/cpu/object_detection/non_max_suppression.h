@@ -10,6 +10,14 @@ namespace onnxruntime {
 
 struct PrepareContext;
 
+namespace nms_helpers {
+// The values of the optional inputs, or their defaults.
+Status GetThresholdsFromInputs(const PrepareContext& pc,
+                               int64_t& max_output_boxes_per_class,
+                               float& iou_threshold,
+                               float& score_threshold);
+}  // namespace nms_helpers
+
 class NonMaxSuppressionBase {
  protected:
   explicit NonMaxSuppressionBase(const OpKernelInfo& info) {
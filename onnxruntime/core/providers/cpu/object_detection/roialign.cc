@@ -170,105 +170,110 @@ void RoiAlignForward(
     T* top_data,
     const std::string& mode,
     const int64_t* batch_indices_ptr,
-    const ThreadPool* ttp) {
+    ThreadPool* ttp) {
   int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
+  const bool avg_mode = mode == "avg";
+
+  // The work is split over (roi, channel) pairs, so that a few ROIs with many channels (e.g. the second stage of
+  // Mask R-CNN) still use all the threads. A range of pairs computes the sampling taps of each of its ROIs once and
+  // applies them to all the channels of the ROI in the range.
+  auto work_object = [&](int64_t first, int64_t last) {
+    std::vector<PreCalc<T>> pre_calc;
+    int64_t pre_calc_roi = -1;
+    int64_t roi_bin_grid_h = 0;
+    int64_t roi_bin_grid_w = 0;
+    int64_t roi_batch_ind = 0;
+
+    for (int64_t unit = first; unit < last; ++unit) {
+      const int64_t n = unit / channels;
+      const int64_t c = unit % channels;
+
+      if (n != pre_calc_roi) {
+        const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
+        roi_batch_ind = batch_indices_ptr[n];
+
+        // Do not using rounding; this implementation detail is critical
+        T roi_start_w = offset_bottom_rois[0] * spatial_scale;
+        T roi_start_h = offset_bottom_rois[1] * spatial_scale;
+        T roi_end_w = offset_bottom_rois[2] * spatial_scale;
+        T roi_end_h = offset_bottom_rois[3] * spatial_scale;
+
+        // Force malformed ROIs to be 1x1
+        T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
+        T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
+        T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+        T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+        // We use roi_bin_grid to sample the grid and mimic integral
+        roi_bin_grid_h = (sampling_ratio > 0)
+                             ? sampling_ratio
+                             : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
+        roi_bin_grid_w =
+            (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
+
+        // we want to precalculate indices and weights shared by all channels,
+        // this is the key point of optimization
+        pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
+        pre_calc_for_bilinear_interpolate(
+            height,
+            width,
+            pooled_height,
+            pooled_width,
+            roi_bin_grid_h,
+            roi_bin_grid_w,
+            roi_start_h,
+            roi_start_w,
+            bin_size_h,
+            bin_size_w,
+            roi_bin_grid_h,
+            roi_bin_grid_w,
+            pre_calc);
+        pre_calc_roi = n;
+      }
+
+      // We do average (integral) pooling inside a bin
+      const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
 
-  std::function<void(int32_t)> work_object = [&](int32_t n) {
-    int64_t index_n = n * channels * pooled_width * pooled_height;
-
-    const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
-    const auto roi_batch_ind = batch_indices_ptr[n];
-
-    // Do not using rounding; this implementation detail is critical
-    T roi_start_w = offset_bottom_rois[0] * spatial_scale;
-    T roi_start_h = offset_bottom_rois[1] * spatial_scale;
-    T roi_end_w = offset_bottom_rois[2] * spatial_scale;
-    T roi_end_h = offset_bottom_rois[3] * spatial_scale;
-
-    // Force malformed ROIs to be 1x1
-    T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
-    T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
-    T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
-    T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
-
-    // We use roi_bin_grid to sample the grid and mimic integral
-    int64_t roi_bin_grid_h = (sampling_ratio > 0)
-                                 ? sampling_ratio
-                                 : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
-    int64_t roi_bin_grid_w =
-        (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
-
-    // We do average (integral) pooling inside a bin
-    const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
-
-    // we want to precalculate indices and weights shared by all channels,
-    // this is the key point of optimization
-    std::vector<PreCalc<T>> pre_calc(
-        roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
-    pre_calc_for_bilinear_interpolate(
-        height,
-        width,
-        pooled_height,
-        pooled_width,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        roi_start_h,
-        roi_start_w,
-        bin_size_h,
-        bin_size_w,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        pre_calc);
-
-    for (int64_t c = 0; c < channels; c++) {
-      int64_t index_n_c = index_n + c * pooled_width * pooled_height;
+      T* top_data_n_c = top_data + unit * pooled_width * pooled_height;
       const T* offset_bottom_data =
           bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-      int64_t pre_calc_index = 0;
-
-      for (int64_t ph = 0; ph < pooled_height; ph++) {
-        for (int64_t pw = 0; pw < pooled_width; pw++) {
-          int64_t index = index_n_c + ph * pooled_width + pw;
-
-          T output_val = 0.;
-          if (mode == "avg") {  // avg pooling
-            for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-              for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
-                output_val += pc.w1 * offset_bottom_data[pc.pos1] +
-                              pc.w2 * offset_bottom_data[pc.pos2] +
-                              pc.w3 * offset_bottom_data[pc.pos3] +
-                              pc.w4 * offset_bottom_data[pc.pos4];
-
-                pre_calc_index += 1;
-              }
-            }
-            output_val /= count;
-          } else {  // max pooling
-            bool max_flag = false;
-            for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-              for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
-                if (!max_flag) {
-                  output_val = pc.w1 * offset_bottom_data[pc.pos1];
-                  max_flag = true;
-                } else {
-                  output_val = std::max(std::max(std::max(output_val, pc.w2 * offset_bottom_data[pc.pos2]),
-                                                 pc.w3 * offset_bottom_data[pc.pos3]),
-                                        pc.w4 * offset_bottom_data[pc.pos4]);
-                }
-
-                pre_calc_index += 1;
-              }
+      const PreCalc<T>* pc = pre_calc.data();
+
+      for (int64_t index = 0; index < pooled_height * pooled_width; index++) {
+        T output_val = 0.;
+        if (avg_mode) {  // avg pooling
+          for (int64_t i = 0; i < count; i++, pc++) {
+            output_val += pc->w1 * offset_bottom_data[pc->pos1] +
+                          pc->w2 * offset_bottom_data[pc->pos2] +
+                          pc->w3 * offset_bottom_data[pc->pos3] +
+                          pc->w4 * offset_bottom_data[pc->pos4];
+          }
+          output_val /= count;
+        } else {  // max pooling
+          for (int64_t i = 0; i < count; i++, pc++) {
+            if (i == 0) {
+              output_val = pc->w1 * offset_bottom_data[pc->pos1];
+            } else {
+              output_val = std::max(std::max(std::max(output_val, pc->w2 * offset_bottom_data[pc->pos2]),
+                                             pc->w3 * offset_bottom_data[pc->pos3]),
+                                    pc->w4 * offset_bottom_data[pc->pos4]);
             }
           }
+        }
 
-          top_data[index] = output_val;
-        }  // for pw
-      }    // for ph
-    }      // for c
-  };       // for n
-  if (ttp != nullptr) const_cast<ThreadPool*>(ttp)->ParallelFor(static_cast<int32_t>(n_rois), work_object);
+        top_data_n_c[index] = output_val;
+      }
+    }
+  };
+
+  // a (roi, channel) pair reads 4 values for each sample of each output value
+  const int64_t samples_per_bin = sampling_ratio > 0 ? sampling_ratio * sampling_ratio : 4;
+  const double cost = static_cast<double>(pooled_height * pooled_width * samples_per_bin * 8);
+  if (ttp != nullptr) {
+    ttp->ParallelForRange(0, n_rois * channels, cost, work_object);
+  } else {
+    work_object(0, n_rois * channels);
+  }
 }
 }  // namespace
 
@@ -10,10 +10,9 @@ namespace onnxruntime {
 
 Status CheckROIAlignValidInput(const Tensor* X_ptr, const Tensor* rois_ptr, const Tensor* batch_indices_ptr);
 
-template <typename T>
-class RoiAlign final : public OpKernel {
- public:
-  explicit RoiAlign(const OpKernelInfo& info) : OpKernel(info) {
+class RoiAlignBase {
+ protected:
+  explicit RoiAlignBase(const OpKernelInfo& info) {
     // mode
     std::string mode_tmp;
     if (info.GetAttr<std::string>("mode", &mode_tmp).IsOK()) {
@@ -50,15 +49,23 @@ class RoiAlign final : public OpKernel {
     }
   }
 
-  Status Compute(OpKernelContext* context) const override;
-
- private:
   std::string mode_{"avg"};
   int64_t output_height_{1};
   int64_t output_width_{1};
   int64_t sampling_ratio_{0};
   float spatial_scale_{1.0f};
 
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RoiAlignBase);
+};
+
+template <typename T>
+class RoiAlign final : public OpKernel, public RoiAlignBase {
+ public:
+  explicit RoiAlign(const OpKernelInfo& info) : OpKernel(info), RoiAlignBase(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RoiAlign);
 };
 }  // namespace onnxruntime
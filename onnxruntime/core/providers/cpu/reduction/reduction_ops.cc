@@ -2,8 +2,16 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
 using namespace std;
 namespace onnxruntime {
 
@@ -218,238 +226,406 @@ bool PrepareForReduce(OpKernelContext* ctx,
   return false;
 }
 
+// Views the input as [outer, reduce, inner] and creates the output. If the reduced axes are contiguous, the
+// returned data is the input itself, which the reductions read in place with strides. Otherwise the reduced
+// axes are first transposed to the head of the input into transposedInputData, viewed as [1, reduce, inner].
 template <typename T>
-Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+static const T* PrepareForStridedReduce(OpKernelContext* ctx,
+                                        std::vector<T>& transposedInputData,
+                                        Tensor** reducedTensor,
+                                        size_t& outer_count,
+                                        size_t& reduce_count,
+                                        size_t& inner_count,
+                                        const std::vector<int64_t>& axes_,
+                                        bool keepdims_) {
+  const auto* input_tensor_ptr = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(input_tensor_ptr != nullptr);
+  const Tensor& input = *input_tensor_ptr;
+  const auto& in_dims = input.Shape().GetDims();
+  const size_t ndim = in_dims.size();
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).cwiseAbs().rowwise().sum();
+  std::vector<int64_t> axes;
+  axes.reserve(axes_.size());
+  for (int64_t axis : axes_) {
+    axes.push_back(HandleNegativeAxis(axis, static_cast<int64_t>(ndim)));
+  }
+  if (axes.empty()) {
+    for (size_t i = 0; i < ndim; i++)
+      axes.push_back(i);
+  }
+  std::sort(axes.begin(), axes.end());
+  axes.erase(std::unique(axes.begin(), axes.end()), axes.end());
+
+  outer_count = 1;
+  reduce_count = 1;
+  inner_count = 1;
+
+  const bool contiguous = axes.empty() || axes.back() - axes.front() + 1 == static_cast<int64_t>(axes.size());
+  if (!contiguous) {
+    int64_t block_size;
+    int64_t blocks;
+    PrepareForReduce<T>(ctx, transposedInputData, reducedTensor, block_size, blocks, axes_, keepdims_);
+    reduce_count = static_cast<size_t>(blocks);
+    inner_count = static_cast<size_t>(block_size);
+    return transposedInputData.data();
+  }
 
-  return Status::OK();
+  std::vector<int64_t> reduced_dims;
+  for (size_t i = 0; i < ndim; i++) {
+    const bool is_reduced = !axes.empty() && static_cast<int64_t>(i) >= axes.front() &&
+                            static_cast<int64_t>(i) <= axes.back();
+    if (is_reduced) {
+      reduce_count *= static_cast<size_t>(in_dims[i]);
+      if (keepdims_) {
+        reduced_dims.push_back(1);
+      }
+    } else {
+      reduced_dims.push_back(in_dims[i]);
+      if (axes.empty() || static_cast<int64_t>(i) < axes.front()) {
+        outer_count *= static_cast<size_t>(in_dims[i]);
+      } else {
+        inner_count *= static_cast<size_t>(in_dims[i]);
+      }
+    }
+  }
+  *reducedTensor = ctx->Output(0, reduced_dims);
+  return input.template Data<T>();
 }
 
-template <typename T>
-Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+// Reduces a float tensor with MLAS, which handles both the innermost and the strided reductions.
+static Status ReduceFloatWithMlas(OpKernelContext* ctx,
+                                  const std::vector<int64_t>& axes_,
+                                  bool keepdims_,
+                                  decltype(&MlasReduceSum) reduce_routine,
+                                  bool mean) {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().norm();
+  std::vector<float> transposedInputData;
+  Tensor* reduced;
+  size_t outer_count;
+  size_t reduce_count;
+  size_t inner_count;
+  const float* input_data = PrepareForStridedReduce<float>(ctx, transposedInputData, &reduced, outer_count,
+                                                           reduce_count, inner_count, axes_, keepdims_);
+
+  float* output_data = reduced->template MutableData<float>();
+  reduce_routine(input_data, output_data, outer_count, reduce_count, inner_count, tp);
+
+  if (mean) {
+    const size_t output_count = outer_count * inner_count;
+    EigenVectorMap<float>(output_data, output_count) *= 1.0f / static_cast<float>(reduce_count);
+  }
 
   return Status::OK();
 }
 
-template <typename T>
-Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+// The number of inner elements reduced by one task of the strided reductions.
+constexpr size_t kStridedReduceBlockSize = 256;
+
+// Runs fn(outer, inner_first, inner_last) over blocks of the [outer, inner] output of a strided reduction,
+// in parallel if there is a thread pool. The blocks split the inner dimension too, so that the work is
+// spread when there are few outer elements.
+template <typename TFunc>
+static void ForEachStridedReduceBlock(size_t outer_count, size_t reduce_count, size_t inner_count,
+                                      concurrency::ThreadPool* tp, TFunc fn) {
+  if (outer_count == 0 || inner_count == 0)
+    return;
+
+  const size_t block_size = std::min(inner_count, kStridedReduceBlockSize);
+  const size_t blocks_per_outer = (inner_count + block_size - 1) / block_size;
+  auto reduce_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t task = first; task < last; task++) {
+      const size_t outer = static_cast<size_t>(task) / blocks_per_outer;
+      const size_t inner_first = (static_cast<size_t>(task) % blocks_per_outer) * block_size;
+      fn(outer, inner_first, std::min(inner_first + block_size, inner_count));
+    }
+  };
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  for (int j = 0; j < block_size; ++j) {
-    *(output_data) = static_cast<T>(std::log(*(output_data)));
-    ++output_data;
+  const auto task_count = static_cast<int64_t>(outer_count * blocks_per_outer);
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, task_count, static_cast<double>(reduce_count * block_size), reduce_blocks);
+  } else {
+    reduce_blocks(0, task_count);
   }
+}
 
-  return Status::OK();
+// Reduces the input viewed as [outer, reduce, inner] to [outer, inner] in place. The accumulators of a block
+// of the contiguous inner dimension live in the output, so the innermost loop walks contiguous memory and
+// can be vectorized.
+template <typename T, typename TAggregator>
+static void StridedReduce(const T* input, T* output, size_t outer_count, size_t reduce_count, size_t inner_count,
+                          concurrency::ThreadPool* tp) {
+  ForEachStridedReduceBlock(outer_count, reduce_count, inner_count, tp,
+                            [=](size_t outer, size_t inner_first, size_t inner_last) {
+                              const T* in = input + outer * reduce_count * inner_count;
+                              T* out = output + outer * inner_count;
+                              if (inner_count == 1) {
+                                // the reduced axes are trailing, so each output reduces one contiguous row
+                                T acc = TAggregator::Init();
+                                for (size_t r = 0; r < reduce_count; r++) {
+                                  TAggregator::Update(acc, in[r]);
+                                }
+                                out[0] = TAggregator::Finalize(acc, reduce_count);
+                                return;
+                              }
+
+                              for (size_t i = inner_first; i < inner_last; i++) {
+                                out[i] = TAggregator::Init();
+                              }
+                              for (size_t r = 0; r < reduce_count; r++) {
+                                const T* row = in + r * inner_count;
+                                for (size_t i = inner_first; i < inner_last; i++) {
+                                  TAggregator::Update(out[i], row[i]);
+                                }
+                              }
+                              for (size_t i = inner_first; i < inner_last; i++) {
+                                out[i] = TAggregator::Finalize(out[i], reduce_count);
+                              }
+                            });
 }
 
-template <typename T>
-Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
+template <typename T, typename TAggregator>
+static Status ReduceWithAggregator(OpKernelContext* ctx, const std::vector<int64_t>& axes_, bool keepdims_) {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
   std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
-
-  for (int j = 0; j < block_size; ++j) {
-    T max_value = std::numeric_limits<T>::lowest();
-    for (int i = 0; i < blocks; ++i) {
-      max_value = std::max(max_value, transposedInputData[i * block_size + j]);
-    }
-    T scaled_exp_sum = 0;
-    for (int i = 0; i < blocks; ++i) {
-      scaled_exp_sum += static_cast<T>(std::exp(transposedInputData[i * block_size + j] - max_value));
-    }
-    *(output_data++) = static_cast<T>(std::log(scaled_exp_sum) + max_value);
-  }
+  size_t outer_count;
+  size_t reduce_count;
+  size_t inner_count;
+  const T* input_data = PrepareForStridedReduce<T>(ctx, transposedInputData, &reduced, outer_count,
+                                                   reduce_count, inner_count, axes_, keepdims_);
+
+  StridedReduce<T, TAggregator>(input_data, reduced->template MutableData<T>(),
+                                outer_count, reduce_count, inner_count, tp);
   return Status::OK();
 }
 
 template <typename T>
-Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+struct ReduceAggregatorSum {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += value; }
+  static T Finalize(T acc, size_t) { return acc; }
+};
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+struct ReduceAggregatorSumSquare {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += value * value; }
+  static T Finalize(T acc, size_t) { return acc; }
+};
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
+template <typename T>
+struct ReduceAggregatorL1 {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += std::abs(value); }
+  static T Finalize(T acc, size_t) { return acc; }
+};
 
-  return Status::OK();
-}
+template <typename T>
+struct ReduceAggregatorL2 {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += value * value; }
+  static T Finalize(T acc, size_t) { return static_cast<T>(std::sqrt(acc)); }
+};
 
 template <typename T>
-Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+struct ReduceAggregatorLogSum {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += value; }
+  static T Finalize(T acc, size_t) { return static_cast<T>(std::log(acc)); }
+};
 
-  T* output_data = reduced->template MutableData<T>();
+template <typename T>
+struct ReduceAggregatorMean {
+  static T Init() { return static_cast<T>(0); }
+  static void Update(T& acc, T value) { acc += value; }
+  static T Finalize(T acc, size_t count) { return acc / static_cast<T>(count); }
+};
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+template <typename T>
+struct ReduceAggregatorMax {
+  static T Init() { return std::numeric_limits<T>::lowest(); }
+  static void Update(T& acc, T value) { acc = std::max(acc, value); }
+  static T Finalize(T acc, size_t) { return acc; }
+};
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
-  }
+template <typename T>
+struct ReduceAggregatorMin {
+  static T Init() { return std::numeric_limits<T>::max(); }
+  static void Update(T& acc, T value) { acc = std::min(acc, value); }
+  static T Finalize(T acc, size_t) { return acc; }
+};
 
-  return Status::OK();
+template <typename T>
+struct ReduceAggregatorProd {
+  static T Init() { return static_cast<T>(1); }
+  static void Update(T& acc, T value) { acc *= value; }
+  static T Finalize(T acc, size_t) { return acc; }
+};
+
+template <typename T>
+Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorL1<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
-Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+Status ReduceL2<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorL2<T>>(ctx, axes_, keepdims_);
+}
+
+template <typename T>
+Status ReduceLogSum<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorLogSum<T>>(ctx, axes_, keepdims_);
+}
+
+template <typename T>
+Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
   std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
+  size_t outer_count;
+  size_t reduce_count;
+  size_t inner_count;
+  const T* input_data = PrepareForStridedReduce<T>(ctx, transposedInputData, &reduced, outer_count,
+                                                   reduce_count, inner_count, axes_, keepdims_);
   T* output_data = reduced->template MutableData<T>();
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
+  // one pass for the maximum, kept in the output, and one for the sum of the scaled exponentials
+  ForEachStridedReduceBlock(outer_count, reduce_count, inner_count, tp,
+                            [=](size_t outer, size_t inner_first, size_t inner_last) {
+                              const T* in = input_data + outer * reduce_count * inner_count;
+                              T* out = output_data + outer * inner_count;
+                              T scaled_exp_sums[kStridedReduceBlockSize];
+                              const size_t count = inner_last - inner_first;
+
+                              for (size_t i = 0; i < count; i++) {
+                                out[inner_first + i] = std::numeric_limits<T>::lowest();
+                                scaled_exp_sums[i] = 0;
+                              }
+                              for (size_t r = 0; r < reduce_count; r++) {
+                                const T* row = in + r * inner_count + inner_first;
+                                for (size_t i = 0; i < count; i++) {
+                                  out[inner_first + i] = std::max(out[inner_first + i], row[i]);
+                                }
+                              }
+                              for (size_t r = 0; r < reduce_count; r++) {
+                                const T* row = in + r * inner_count + inner_first;
+                                for (size_t i = 0; i < count; i++) {
+                                  scaled_exp_sums[i] += static_cast<T>(std::exp(row[i] - out[inner_first + i]));
+                                }
+                              }
+                              for (size_t i = 0; i < count; i++) {
+                                out[inner_first + i] = static_cast<T>(std::log(scaled_exp_sums[i]) +
+                                                                      out[inner_first + i]);
+                              }
+                            });
 
   return Status::OK();
 }
 
 template <typename T>
-Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
+Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorMax<T>>(ctx, axes_, keepdims_);
+}
 
-  T* output_data = reduced->template MutableData<T>();
+template <>
+Status ReduceMax<float>::Compute(OpKernelContext* ctx) const {
+  return ReduceFloatWithMlas(ctx, axes_, keepdims_, MlasReduceMaximum, false);
+}
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().prod();
+template <typename T>
+Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorMean<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <>
+Status ReduceMean<float>::Compute(OpKernelContext* ctx) const {
+  return ReduceFloatWithMlas(ctx, axes_, keepdims_, MlasReduceSum, true);
 }
 
 template <typename T>
-Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
-
-  T* output_data = reduced->template MutableData<T>();
+Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorMin<T>>(ctx, axes_, keepdims_);
+}
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+template <typename T>
+Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorProd<T>>(ctx, axes_, keepdims_);
+}
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
+template <typename T>
+Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorSum<T>>(ctx, axes_, keepdims_);
+}
 
-  return Status::OK();
+template <>
+Status ReduceSum<float>::Compute(OpKernelContext* ctx) const {
+  return ReduceFloatWithMlas(ctx, axes_, keepdims_, MlasReduceSum, false);
 }
 
 template <typename T>
 Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
+  return ReduceWithAggregator<T, ReduceAggregatorSumSquare<T>>(ctx, axes_, keepdims_);
+}
+
+// Finds the index of the first maximum (or minimum) along the reduced axis, reading the input in place as
+// [outer, reduce, inner] like the strided reductions.
+template <typename T, typename TCompare>
+static Status ArgReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes_, bool keepdims_) {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
   std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
   Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  T* output_data = reduced->template MutableData<T>();
+  size_t outer_count;
+  size_t reduce_count;
+  size_t inner_count;
+  const T* input_data = PrepareForStridedReduce<T>(ctx, transposedInputData, &reduced, outer_count,
+                                                   reduce_count, inner_count, axes_, keepdims_);
+  int64_t* output_data = reduced->template MutableData<int64_t>();
+  if (reduce_count == 0 && outer_count * inner_count > 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Cannot find the index of an element of an empty axis");
+  }
 
-  EigenVectorMap<T> out_vec(output_data, block_size);
-  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().squaredNorm();
+  ForEachStridedReduceBlock(outer_count, reduce_count, inner_count, tp,
+                            [=](size_t outer, size_t inner_first, size_t inner_last) {
+                              const T* in = input_data + outer * reduce_count * inner_count + inner_first;
+                              int64_t* out = output_data + outer * inner_count + inner_first;
+                              T best_values[kStridedReduceBlockSize];
+                              const size_t count = inner_last - inner_first;
+                              TCompare compare;
+
+                              for (size_t i = 0; i < count; i++) {
+                                best_values[i] = in[i];
+                                out[i] = 0;
+                              }
+                              for (size_t r = 1; r < reduce_count; r++) {
+                                const T* row = in + r * inner_count;
+                                for (size_t i = 0; i < count; i++) {
+                                  if (compare(row[i], best_values[i])) {
+                                    best_values[i] = row[i];
+                                    out[i] = static_cast<int64_t>(r);
+                                  }
+                                }
+                              }
+                            });
 
   return Status::OK();
 }
 
 template <typename T>
 Status ArgMax<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index maxIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).maxCoeff(&maxIndex);
-    *(output_data++) = maxIndex;
-  }
-
-  return Status::OK();
+  return ArgReduce<T, std::greater<T>>(ctx, axes_, keepdims_);
 }
 
 template <typename T>
 Status ArgMin<T>::Compute(OpKernelContext* ctx) const {
-  std::vector<T> transposedInputData;
-  int64_t block_size;
-  int64_t blocks;
-  Tensor* reduced;
-  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
-
-  auto* output_data = reduced->template MutableData<int64_t>();
-
-  Eigen::MatrixXf::Index minIndex;
-  auto matrixData = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks);
-  for (int i = 0; i < block_size; ++i) {
-    matrixData.row(i).minCoeff(&minIndex);
-    *(output_data++) = minIndex;
-  }
-
-  return Status::OK();
+  return ArgReduce<T, std::less<T>>(ctx, axes_, keepdims_);
 }
 
 }  // namespace onnxruntime
@@ -142,6 +142,15 @@ class ArgMin final : public ReduceKernel<false> {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+Status ReduceMax<float>::Compute(OpKernelContext* context) const;
+
+template <>
+Status ReduceMean<float>::Compute(OpKernelContext* context) const;
+
+template <>
+Status ReduceSum<float>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
 
 #endif  // !CORE_PROVIDERS_CPU_REDUCTION_OPS_H
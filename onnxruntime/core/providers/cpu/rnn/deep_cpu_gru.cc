@@ -172,8 +172,12 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_g, float clip,
                     onnxruntime::concurrency::ThreadPool* ttp);
 
+  // packed_input_weights, packed_recurrent_weightsZR and packed_recurrent_weightsH are the weights packed by
+  // MlasGemmPackB, or nullptr
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
                const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const void* packed_input_weights, const void* packed_recurrent_weightsZR,
+               const void* packed_recurrent_weightsH,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
@@ -266,6 +270,39 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   return status;
 }
 
+void DeepCpuGruOp::TryPackWeights(const OpKernelInfo& info, const Tensor& weights, bool pack_h_apart,
+                                  PackedWeights& packed_weights) {
+  // W is [num_directions, 3*hidden_size, input_size] and R is [num_directions, 3*hidden_size, hidden_size].
+  // Anything else is left for ValidateCommonRnnInputs to report in Compute.
+  const auto& shape = weights.Shape();
+  if (weights.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 3 ||
+      shape[0] != num_directions_ || shape[1] != 3 * hidden_size_ || shape[2] <= 0) {
+    return;
+  }
+
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+  const size_t N_zr = pack_h_apart ? N - hidden_size_ : N;
+  const size_t packed_zr_size = MlasGemmPackBSize(N_zr, K);
+  const size_t packed_weights_size = packed_zr_size + (pack_h_apart ? MlasGemmPackBSize(N - N_zr, K) : 0);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  packed_weights.buffer_ = IAllocator::MakeUniquePtr<void>(alloc, packed_weights_size * num_directions_);
+  packed_weights.weights_size_per_direction_ = packed_weights_size;
+  packed_weights.h_weights_offset_ = packed_zr_size;
+
+  const float* weights_data = weights.Data<float>();
+  auto* packed_data = static_cast<uint8_t*>(packed_weights.buffer_.get());
+  for (int i = 0; i < num_directions_; ++i) {
+    const float* direction_weights = weights_data + i * N * K;
+    uint8_t* direction_packed_data = packed_data + i * packed_weights_size;
+    MlasGemmPackB(CblasTrans, N_zr, K, direction_weights, K, direction_packed_data);
+    if (pack_h_apart) {
+      MlasGemmPackB(CblasTrans, N - N_zr, K, direction_weights + N_zr * K, K, direction_packed_data + packed_zr_size);
+    }
+  }
+}
+
 template <typename T>
 Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(&context);
@@ -322,6 +359,17 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
+  // weights packed at construction if they are constant initializers
+  auto packed_input_weights = [this](int direction) {
+    return packed_W_.buffer_ ? packed_W_.DirectionWeights(direction) : nullptr;
+  };
+  auto packed_recurrent_weightsZR = [this](int direction) {
+    return packed_R_.buffer_ ? packed_R_.DirectionWeights(direction) : nullptr;
+  };
+  auto packed_recurrent_weightsH = [this](int direction) {
+    return packed_R_.buffer_ ? packed_R_.DirectionHWeights(direction) : nullptr;
+  };
+
   gsl::span<const T> input = X.DataAsSpan<T>();
   gsl::span<const int> sequence_lens_span = sequence_lens != nullptr ? sequence_lens->DataAsSpan<int>()
                                                                      : gsl::span<const int>();
@@ -376,16 +424,33 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+
+    // the directions write to disjoint parts of the outputs, so they run concurrently. the GEMMs of each
+    // direction share the same thread pool.
+    auto compute_direction = [&](int32_t direction) {
+      if (direction == 0) {
+        fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                   packed_input_weights(0), packed_recurrent_weightsZR(0), packed_recurrent_weightsH(0),
+                   output_1, hidden_output_1);
+      } else {
+        bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
+                   packed_input_weights(1), packed_recurrent_weightsZR(1), packed_recurrent_weightsH(1),
+                   output_2, hidden_output_2);
+      }
+    };
+
+    if (thread_pool != nullptr) {
+      thread_pool->ParallelFor(2, compute_direction);
+    } else {
+      compute_direction(0);
+      compute_direction(1);
+    }
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
@@ -393,6 +458,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
     gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                  packed_input_weights(0), packed_recurrent_weightsZR(0), packed_recurrent_weightsH(0),
                   output_1, hidden_output_1);
   }
 
@@ -494,6 +560,9 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const int num_directions,
                                    const gsl::span<const T>& input_weights,
                                    const gsl::span<const T>& recurrent_weights,
+                                   const void* packed_input_weights,
+                                   const void* packed_recurrent_weightsZR,
+                                   const void* packed_recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -543,13 +612,23 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   float beta = 0.0f;  // zero out outputZRH_ when calling ComputeGemm.
 
   // apply weights to all the inputs
-  ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
-              inputs.cbegin(), inputs.cend(),
-              input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, beta,
-              outputZRH_.begin(), outputZRH_.end(),
-              hidden_size_x3, ttp_);
+  if (packed_input_weights != nullptr) {
+    ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
+                inputs.cbegin(), inputs.cend(),
+                input_size_,
+                packed_input_weights,
+                beta,
+                outputZRH_.begin(), outputZRH_.end(),
+                hidden_size_x3, ttp_);
+  } else {
+    ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
+                inputs.cbegin(), inputs.cend(),
+                input_size_,
+                input_weights.cbegin(), input_weights.cend(),
+                input_size_, beta,
+                outputZRH_.begin(), outputZRH_.end(),
+                hidden_size_x3, ttp_);
+  }
 
   DumpMatrix("inputs with weights applied", outputZRH_.data(), seq_length_ * batch_size_ * 3, hidden_size_);
 
@@ -609,13 +688,23 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
     // Ht-1 * R[zr] + Xt*(W[zr]^T)
-    ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                prev_Ht, prev_Ht_end,
-                hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, beta,
-                outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                hidden_size_x3, ttp_);
+    if (packed_recurrent_weightsZR != nullptr) {
+      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+                  prev_Ht, prev_Ht_end,
+                  hidden_size_,
+                  packed_recurrent_weightsZR,
+                  beta,
+                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                  hidden_size_x3, ttp_);
+    } else {
+      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+                  prev_Ht, prev_Ht_end,
+                  hidden_size_,
+                  recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
+                  hidden_size_, beta,
+                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                  hidden_size_x3, ttp_);
+    }
 
     DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -625,13 +714,23 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(), batched_bias_Rh_local_end - batched_bias_Rh_local), linear_output_);
 
       // compute Ht-1 * (Rh^T) + Rbh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                  prev_Ht, prev_Ht_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
-                  linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
-                  hidden_size_, ttp_);
+      if (packed_recurrent_weightsH != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    prev_Ht, prev_Ht_end,  // Ht-1
+                    hidden_size_,
+                    packed_recurrent_weightsH,  // Rh^T
+                    beta,
+                    linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
+                    hidden_size_, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    prev_Ht, prev_Ht_end,  // Ht-1
+                    hidden_size_,
+                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
+                    hidden_size_, beta,
+                    linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
+                    hidden_size_, ttp_);
+      }
 
       DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
     }
@@ -696,13 +795,23 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
 
       // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                  cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
-                  out_H, outputZRH_.end(),
-                  hidden_size_x3, ttp_);
+      if (packed_recurrent_weightsH != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    cur_h_local, cur_h_local_end,  // rt (.) Ht-1
+                    hidden_size_,
+                    packed_recurrent_weightsH,  // Rh^T
+                    beta,
+                    out_H, outputZRH_.end(),
+                    hidden_size_x3, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    cur_h_local, cur_h_local_end,  // rt (.) Ht-1
+                    hidden_size_,
+                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
+                    hidden_size_, beta,
+                    out_H, outputZRH_.end(),
+                    hidden_size_x3, ttp_);
+      }
     }
 
     DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
@@ -50,6 +50,12 @@ class DeepCpuGruOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    const Tensor* weights;
+    if (info.TryGetConstantInput(1, &weights))
+      TryPackWeights(info, *weights, false, packed_W_);
+    if (info.TryGetConstantInput(2, &weights))
+      TryPackWeights(info, *weights, true, packed_R_);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -57,6 +63,25 @@ class DeepCpuGruOp final : public OpKernel {
   ~DeepCpuGruOp() override = default;
 
  private:
+  // The weights of each direction packed by MlasGemmPackB, so constant W and R aren't repacked
+  // by every GEMM of every sequence step. R[h] is multiplied apart from R[zr], so it's packed apart.
+  struct PackedWeights {
+    IAllocatorUniquePtr<void> buffer_;
+    size_t weights_size_per_direction_ = 0;
+    size_t h_weights_offset_ = 0;
+
+    const void* DirectionWeights(int direction) const {
+      return static_cast<const uint8_t*>(buffer_.get()) + direction * weights_size_per_direction_;
+    }
+
+    const void* DirectionHWeights(int direction) const {
+      return static_cast<const uint8_t*>(DirectionWeights(direction)) + h_weights_offset_;
+    }
+  };
+
+  void TryPackWeights(const OpKernelInfo& info, const Tensor& weights, bool pack_h_apart,
+                      PackedWeights& packed_weights);
+
   rnn::detail::Direction direction_;
   int num_directions_;
 
@@ -66,6 +91,9 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  PackedWeights packed_W_;
+  PackedWeights packed_R_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
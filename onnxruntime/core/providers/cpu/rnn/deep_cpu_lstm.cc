@@ -199,8 +199,10 @@ class UniDirectionalLstm {
                      concurrency::ThreadPool& lstm_tp_,
                      concurrency::ThreadPool* mlas_tp_);
 
+  // packed_input_weights and packed_recurrent_weights are the weights packed by MlasGemmPackB, or nullptr
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
                const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const void* packed_input_weights, const void* packed_recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -312,10 +314,49 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+void DeepCpuLstmOp::TryPackWeights(const OpKernelInfo& info, const Tensor& weights, PackedWeights& packed_weights) {
+  // W is [num_directions, 4*hidden_size, input_size] and R is [num_directions, 4*hidden_size, hidden_size].
+  // Anything else is left for ValidateInputs to report in Compute.
+  const auto& shape = weights.Shape();
+  if (weights.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 3 ||
+      shape[0] != num_directions_ || shape[1] != 4 * hidden_size_ || shape[2] <= 0) {
+    return;
+  }
+
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  packed_weights.buffer_ = IAllocator::MakeUniquePtr<void>(alloc, packed_weights_size * num_directions_);
+  packed_weights.weights_size_per_direction_ = packed_weights_size;
+
+  const float* weights_data = weights.Data<float>();
+  auto* packed_data = static_cast<uint8_t*>(packed_weights.buffer_.get());
+  for (int i = 0; i < num_directions_; ++i) {
+    MlasGemmPackB(CblasTrans, N, K, weights_data + i * N * K, K, packed_data + i * packed_weights_size);
+  }
+}
+
+concurrency::ThreadPool& DeepCpuLstmOp::GetLstmThreadPool(concurrency::ThreadPool* session_thread_pool) const {
+  // ThreadPool::ParallelFor supports being called from a thread of the same pool, so the batch level
+  // parallelism can share the session thread pool with the GEMMs instead of oversubscribing the cores.
+  if (session_thread_pool != nullptr) {
+    return *session_thread_pool;
+  }
+
+  std::call_once(lstm_tp_once_, [this]() {
+    lstm_tp_ = std::make_unique<concurrency::ThreadPool>("DEEPCPU_LSTM",
+                                                         static_cast<int>(std::thread::hardware_concurrency()));
+  });
+  return *lstm_tp_;
+}
+
 template <typename T>
 Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(&context);
   concurrency::ThreadPool* mlas_thread_pool = ctx_internal->GetOperatorThreadPool();
+  concurrency::ThreadPool& lstm_thread_pool = GetLstmThreadPool(mlas_thread_pool);
 
   auto& logger = context.Logger();
 
@@ -382,6 +423,14 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
       peephole_weights.empty() ? peephole_weights
                                : peephole_weights.subspan(0, peephole_weights_size_per_direction);
 
+  // weights packed at construction if they are constant initializers
+  auto packed_input_weights = [this](int direction) {
+    return packed_W_.buffer_ ? packed_W_.DirectionWeights(direction) : nullptr;
+  };
+  auto packed_recurrent_weights = [this](int direction) {
+    return packed_R_.buffer_ ? packed_R_.DirectionWeights(direction) : nullptr;
+  };
+
   gsl::span<const T> input = X.DataAsSpan<T>();
   gsl::span<const int> sequence_lens_span = sequence_lens != nullptr ? sequence_lens->DataAsSpan<int>()
                                                                      : gsl::span<const int>();
@@ -460,7 +509,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[0],
                                      activation_funcs_.Entries()[1],
                                      activation_funcs_.Entries()[2],
-                                     clip_, lstm_tp_, mlas_thread_pool);
+                                     clip_, lstm_thread_pool, mlas_thread_pool);
 
     detail::UniDirectionalLstm<T> bw(alloc, logger, seq_length, batch_size, input_size,
                                      hidden_size_, Direction::kReverse, input_forget_,
@@ -468,12 +517,21 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[3],
                                      activation_funcs_.Entries()[4],
                                      activation_funcs_.Entries()[5],
-                                     clip_, lstm_tp_, mlas_thread_pool);
-
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
-               output_2, hidden_output_2, last_cell_2);
+                                     clip_, lstm_thread_pool, mlas_thread_pool);
+
+    // the directions write to disjoint parts of the outputs, so they run concurrently. the batches and GEMMs of
+    // each direction share the same thread pool.
+    lstm_thread_pool.ParallelFor(2, [&](int32_t direction) {
+      if (direction == 0) {
+        fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+                   packed_input_weights(0), packed_recurrent_weights(0),
+                   output_1, hidden_output_1, last_cell_1);
+      } else {
+        bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+                   packed_input_weights(1), packed_recurrent_weights(1),
+                   output_2, hidden_output_2, last_cell_2);
+      }
+    });
   } else {
     detail::UniDirectionalLstm<T> fw(alloc, logger, seq_length, batch_size, input_size,
                                      hidden_size_, direction_, input_forget_,
@@ -481,9 +539,10 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[0],
                                      activation_funcs_.Entries()[1],
                                      activation_funcs_.Entries()[2],
-                                     clip_, lstm_tp_, mlas_thread_pool);
+                                     clip_, lstm_thread_pool, mlas_thread_pool);
 
     fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+               packed_input_weights(0), packed_recurrent_weights(0),
                output_1, hidden_output_1, last_cell_1);
   }
 
@@ -722,6 +781,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const int num_directions,
                                     const gsl::span<const T>& input_weights,
                                     const gsl::span<const T>& recurrent_weights,
+                                    const void* packed_input_weights,
+                                    const void* packed_recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -778,13 +839,23 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int total_rows = max_sequence_length * batch_size_;
 
   // apply the weights to all the inputs and save to output_IOFC
-  ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
-              inputs.cbegin(), inputs.cend(),
-              input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta,
-              output_iofc_.begin(), output_iofc_.end(),
-              hidden_size_x4, mlas_tp_);
+  if (packed_input_weights != nullptr) {
+    ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
+                inputs.cbegin(), inputs.cend(),
+                input_size_,
+                packed_input_weights,  // W[iofc]
+                beta,
+                output_iofc_.begin(), output_iofc_.end(),
+                hidden_size_x4, mlas_tp_);
+  } else {
+    ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
+                inputs.cbegin(), inputs.cend(),
+                input_size_,
+                input_weights.cbegin(), input_weights.cend(),  // W[iofc]
+                input_size_, beta,
+                output_iofc_.begin(), output_iofc_.end(),
+                hidden_size_x4, mlas_tp_);
+  }
 
   DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
 
@@ -827,13 +898,23 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + row) * hidden_size_x4;
 
         // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-        ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
-                    previous_state, previous_state_end,  // Ht-1
-                    hidden_size_,
-                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta,
-                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4, mlas_tp_);
+        if (packed_recurrent_weights != nullptr) {
+          ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
+                      previous_state, previous_state_end,  // Ht-1
+                      hidden_size_,
+                      packed_recurrent_weights,  // R[iofc]
+                      beta,
+                      step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                      hidden_size_x4, mlas_tp_);
+        } else {
+          ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
+                      previous_state, previous_state_end,  // Ht-1
+                      hidden_size_,
+                      recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
+                      hidden_size_, beta,
+                      step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                      hidden_size_x4, mlas_tp_);
+        }
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str,
                    &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
@@ -905,13 +986,23 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_) * hidden_size_x4;
 
       // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-      ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
-                  previous_state, previous_state_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, beta,
-                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, mlas_tp_);
+      if (packed_recurrent_weights != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
+                    previous_state, previous_state_end,  // Ht-1
+                    hidden_size_,
+                    packed_recurrent_weights,  // R[iofc]
+                    beta,
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, mlas_tp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
+                    previous_state, previous_state_end,  // Ht-1
+                    hidden_size_,
+                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
+                    hidden_size_, beta,
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, mlas_tp_);
+      }
 
       span_T_iter batched_output;
       span_T_iter batched_output_end;
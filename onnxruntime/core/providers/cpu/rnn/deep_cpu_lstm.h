@@ -4,6 +4,8 @@
 #pragma once
 
 #include <limits>
+#include <memory>
+#include <mutex>
 
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
@@ -49,6 +51,12 @@ class DeepCpuLstmOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    const Tensor* weights;
+    if (info.TryGetConstantInput(1, &weights))
+      TryPackWeights(info, *weights, packed_W_);
+    if (info.TryGetConstantInput(2, &weights))
+      TryPackWeights(info, *weights, packed_R_);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -69,6 +77,19 @@ class DeepCpuLstmOp final : public OpKernel {
                         const Tensor* P,
                         int batch_size) const;
 
+  // The weights of each direction packed by MlasGemmPackB, so constant W and R aren't repacked
+  // by every GEMM of every sequence step.
+  struct PackedWeights {
+    IAllocatorUniquePtr<void> buffer_;
+    size_t weights_size_per_direction_ = 0;
+
+    const void* DirectionWeights(int direction) const {
+      return static_cast<const uint8_t*>(buffer_.get()) + direction * weights_size_per_direction_;
+    }
+  };
+
+  void TryPackWeights(const OpKernelInfo& info, const Tensor& weights, PackedWeights& packed_weights);
+
   rnn::detail::Direction direction_;
   int num_directions_;
 
@@ -78,12 +99,18 @@ class DeepCpuLstmOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
-  // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
-  // across them. mutable due to this.
+  PackedWeights packed_W_;
+  PackedWeights packed_R_;
+
+  // Returns the session thread pool, or a threadpool owned by the operator if the session doesn't have one.
+  concurrency::ThreadPool& GetLstmThreadPool(concurrency::ThreadPool* session_thread_pool) const;
+
+  // Threadpool for operator used when the session was created without a thread pool.
+  // If concurrent Compute calls are possible, it will be shared across them. mutable due to this.
   // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
   // cost on every call.
-  mutable onnxruntime::concurrency::ThreadPool lstm_tp_{"DEEPCPU_LSTM",
-                                                        static_cast<int>(std::thread::hardware_concurrency())};
+  mutable std::unique_ptr<onnxruntime::concurrency::ThreadPool> lstm_tp_;
+  mutable std::once_flag lstm_tp_once_;
 };
 
 }  // namespace onnxruntime
@@ -19,6 +19,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -175,6 +176,32 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// ComputeGemm for B packed by MlasGemmPackB from a transposed B, e.g. constant weights
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const void* packed_B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  // validate all the inputs
+  // need to use the lda/ldc strides which should be >= the columns for the span
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasSgemmPacked(CblasNoTrans, M, N, K, alpha,
+                  &*A, lda,
+                  packed_B, beta,
+                  &*C, ldc, tp);
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -230,17 +257,10 @@ void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, i
   ORT_UNUSED_PARAMETER(name);
   ORT_UNUSED_PARAMETER(logger);
 
-  std::atomic<int> done(0);
-  for (int i = 0; i < max; i += step) {
-    ttp.Schedule([lambda, i, &done]() {
-      lambda(i);
-      ++done;
-    });
-  }
-
+  // ParallelFor partitions the tasks across the pool with the calling thread taking
+  // part, rather than scheduling one task per step and spinning until they complete.
   int totalTasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  while (done != totalTasks)
-    ;
+  ttp.ParallelFor(totalTasks, [&lambda, step](int32_t task) { lambda(task * step); });
 #endif
 }
 
@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace detail {
+
+// Drops the axes of size 1 and merges each axis into the next inner one when both layouts are contiguous across the
+// two, so that a copy between two dense blocks becomes a single row.
+inline void CoalesceCopyDims(std::vector<int64_t>& dims, std::vector<int64_t>& dst_strides,
+                             std::vector<int64_t>& src_strides) {
+  size_t rank = 0;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (dims[i] == 1) {
+      continue;
+    }
+    if (rank > 0 &&
+        dst_strides[rank - 1] == dst_strides[i] * dims[i] &&
+        src_strides[rank - 1] == src_strides[i] * dims[i]) {
+      dims[rank - 1] *= dims[i];
+      dst_strides[rank - 1] = dst_strides[i];
+      src_strides[rank - 1] = src_strides[i];
+      continue;
+    }
+    dims[rank] = dims[i];
+    dst_strides[rank] = dst_strides[i];
+    src_strides[rank] = src_strides[i];
+    ++rank;
+  }
+
+  if (rank == 0) {
+    dims.assign(1, 1);
+    dst_strides.assign(1, 1);
+    src_strides.assign(1, 1);
+  } else {
+    dims.resize(rank);
+    dst_strides.resize(rank);
+    src_strides.resize(rank);
+  }
+}
+
+template <typename T>
+inline void CopyContiguous(T* dst, const T* src, int64_t count, std::true_type /* trivially copyable */) {
+  memcpy(dst, src, static_cast<size_t>(count) * sizeof(T));
+}
+
+template <typename T>
+inline void CopyContiguous(T* dst, const T* src, int64_t count, std::false_type /* trivially copyable */) {
+  std::copy(src, src + count, dst);
+}
+
+template <typename T>
+inline void CopyElements(T* dst, int64_t dst_stride, const T* src, int64_t src_stride, int64_t count) {
+  if (dst_stride == 1 && src_stride == 1) {
+    CopyContiguous(dst, src, count, std::is_trivially_copyable<T>{});
+    return;
+  }
+
+  for (int64_t i = 0; i < count; ++i) {
+    *dst = *src;
+    dst += dst_stride;
+    src += src_stride;
+  }
+}
+
+}  // namespace detail
+
+// Copies a block of copy_dims elements between two strided layouts: the element at index (i0, i1, ...) of the block
+// is read from src + sum(ik * src_strides[k]) and written to dst + sum(ik * dst_strides[k]). Strides are in elements
+// and may be negative. Axes that are contiguous in both layouts are merged first, and the rows of the innermost axis
+// are copied in chunks on the thread pool, so a single large block is also split across the threads.
+// Concat, Split, Slice and Pad (constant mode) share this for their data movement.
+template <typename T>
+void StridedCopy(concurrency::ThreadPool* thread_pool,
+                 T* dst, std::vector<int64_t> dst_strides,
+                 std::vector<int64_t> copy_dims,
+                 const T* src, std::vector<int64_t> src_strides) {
+  ORT_ENFORCE(dst_strides.size() == copy_dims.size() && src_strides.size() == copy_dims.size(),
+              "Strides must have the same rank as the copied block");
+
+  if (std::find_if(copy_dims.cbegin(), copy_dims.cend(), [](int64_t dim) { return dim <= 0; }) !=
+      copy_dims.cend()) {
+    return;
+  }
+
+  detail::CoalesceCopyDims(copy_dims, dst_strides, src_strides);
+
+  const size_t outer_rank = copy_dims.size() - 1;
+  const int64_t row_size = copy_dims[outer_rank];
+  const int64_t dst_row_stride = dst_strides[outer_rank];
+  const int64_t src_row_stride = src_strides[outer_rank];
+
+  int64_t num_rows = 1;
+  for (size_t axis = 0; axis < outer_rank; ++axis) {
+    num_rows *= copy_dims[axis];
+  }
+
+  // 64KB chunks amortize the scheduling of a unit of work while still splitting a large row across the threads.
+  const int64_t chunk_size = std::max<int64_t>(1, (64 * 1024) / static_cast<int64_t>(sizeof(T)));
+  const int64_t chunks_per_row = (row_size + chunk_size - 1) / chunk_size;
+
+  auto copy_chunks = [&](int64_t first, int64_t last) {
+    int64_t row = first / chunks_per_row;
+    int64_t chunk = first % chunks_per_row;
+
+    // offsets of the first row, counted back from its index along each outer axis
+    std::vector<int64_t> index(outer_rank, 0);
+    int64_t dst_offset = 0;
+    int64_t src_offset = 0;
+    for (size_t axis = outer_rank; axis-- > 0;) {
+      index[axis] = row % copy_dims[axis];
+      row /= copy_dims[axis];
+      dst_offset += index[axis] * dst_strides[axis];
+      src_offset += index[axis] * src_strides[axis];
+    }
+
+    for (int64_t unit = first; unit < last; ++unit) {
+      const int64_t begin = chunk * chunk_size;
+      const int64_t count = std::min(chunk_size, row_size - begin);
+      detail::CopyElements(dst + dst_offset + begin * dst_row_stride, dst_row_stride,
+                           src + src_offset + begin * src_row_stride, src_row_stride, count);
+
+      if (++chunk == chunks_per_row) {
+        chunk = 0;
+        for (size_t axis = outer_rank; axis-- > 0;) {
+          dst_offset += dst_strides[axis];
+          src_offset += src_strides[axis];
+          if (++index[axis] < copy_dims[axis]) {
+            break;
+          }
+          dst_offset -= copy_dims[axis] * dst_strides[axis];
+          src_offset -= copy_dims[axis] * src_strides[axis];
+          index[axis] = 0;
+        }
+      }
+    }
+  };
+
+  const int64_t num_chunks = num_rows * chunks_per_row;
+  if (thread_pool != nullptr && num_chunks > 1) {
+    const double chunk_bytes = static_cast<double>(std::min(chunk_size, row_size) * sizeof(T));
+    thread_pool->ParallelForRange(0, num_chunks, chunk_bytes, copy_chunks);
+  } else {
+    copy_chunks(0, num_chunks);
+  }
+}
+
+// StridedCopy for a tensor element type known only at runtime. Strings are assigned, and the other types are moved
+// as bytes, which doesn't change the blocks that are copied as the element bytes are always contiguous.
+inline void StridedCopy(concurrency::ThreadPool* thread_pool, MLDataType element_type,
+                        void* dst, std::vector<int64_t> dst_strides,
+                        std::vector<int64_t> copy_dims,
+                        const void* src, std::vector<int64_t> src_strides) {
+  if (element_type == DataTypeImpl::GetType<std::string>()) {
+    StridedCopy<std::string>(thread_pool, static_cast<std::string*>(dst), std::move(dst_strides),
+                             std::move(copy_dims), static_cast<const std::string*>(src), std::move(src_strides));
+    return;
+  }
+
+  const auto element_bytes = static_cast<int64_t>(element_type->Size());
+  for (auto& stride : dst_strides) stride *= element_bytes;
+  for (auto& stride : src_strides) stride *= element_bytes;
+  copy_dims.push_back(element_bytes);
+  dst_strides.push_back(1);
+  src_strides.push_back(1);
+
+  StridedCopy<uint8_t>(thread_pool, static_cast<uint8_t*>(dst), std::move(dst_strides), std::move(copy_dims),
+                       static_cast<const uint8_t*>(src), std::move(src_strides));
+}
+
+}  // namespace onnxruntime
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "dynamicquantizelinear.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/quantize_linear.h"
 #include "core/util/math_cpuonly.h"
 #include <cmath>
 #include <cfenv>
@@ -45,11 +47,33 @@ Status DynamicQuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
     qmin = -127;
   }
 
-  // find input range min and max
-  auto min = ConstEigenVectorMap<float>(x_data, x.Shape().Size()).minCoeff();
-  min = std::min(min, qmin);
-  auto max = ConstEigenVectorMap<float>(x_data, x.Shape().Size()).maxCoeff();
-  max = std::max(max, qmin);
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  const auto num_of_elements = x.Shape().Size();
+
+  // find input range min and max, from the range of each block of the input
+  constexpr int64_t kBlockSize = 16384;
+  const int64_t num_blocks = (num_of_elements + kBlockSize - 1) / kBlockSize;
+  std::vector<float> block_mins(num_blocks);
+  std::vector<float> block_maxs(num_blocks);
+  auto find_range = [&](int64_t first, int64_t last) {
+    for (int64_t block = first; block < last; block++) {
+      const int64_t begin = block * kBlockSize;
+      MlasReduceMinimumMaximum(x_data + begin, &block_mins[block], &block_maxs[block],
+                               static_cast<size_t>(std::min(kBlockSize, num_of_elements - begin)));
+    }
+  };
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelForRange(0, num_blocks, static_cast<double>(kBlockSize) / 2, find_range);
+  } else {
+    find_range(0, num_blocks);
+  }
+
+  float min = qmin;
+  float max = qmin;
+  for (int64_t block = 0; block < num_blocks; block++) {
+    min = std::min(min, block_mins[block]);
+    max = std::max(max, block_maxs[block]);
+  }
 
   // find scale and zero point
   auto scale = (max - min) / (qmax - qmin);
@@ -62,12 +86,7 @@ Status DynamicQuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   *output_zp = zero_point;
 
   // quantize the data
-  auto* output = y.template MutableData<T>();
-  const auto num_of_elements = x.Shape().Size();
-
-  for (int i = 0; i < num_of_elements; ++i) {
-    output[i] = static_cast<T>(clamp(RoundHalfToEven(static_cast<float>(x_data[i] / scale)) + zero_point, qmin, qmax));
-  }
+  ParallelQuantizeLinear(x_data, y.template MutableData<T>(), num_of_elements, scale, zero_point, thread_pool);
 
   return Status::OK();
 }
@@ -4,6 +4,8 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -30,15 +32,35 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+// Gathers blocks of a single element of type T with loads and stores rather than memcpy calls, for the indices
+// in [first, last) of the M * N indices of the output.
+template <typename T, typename Tin>
+static void GatherElements(const Tin* indices_data, const uint8_t* src_base, uint8_t* dst_base, const int64_t N,
+                           const int64_t data_batch_bytes, const int64_t first, const int64_t last) {
+  const auto* src = reinterpret_cast<const T*>(src_base);
+  auto* dst = reinterpret_cast<T*>(dst_base);
+  const int64_t data_batch_elements = data_batch_bytes / static_cast<int64_t>(sizeof(T));
+
+  int64_t batch = first / N;
+  int64_t i = first % N;
+  for (int64_t index = first; index < last; ++index) {
+    dst[index] = src[batch * data_batch_elements + indices_data[i]];
+    if (++i == N) {
+      i = 0;
+      ++batch;
+    }
+  }
+}
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
                       const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const TensorShape& input_data_shape, const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
   // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // We can't merge this code in the parallel loop below as the partitions can't return a status
   for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
     if (idx < 0 || idx >= input_data_shape[axis]) {
@@ -47,25 +69,49 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
+  if (M * N == 0) {
+    return Status::OK();
+  }
+
+  std::function<void(int64_t, int64_t)> copy_blocks;
+  if (!is_string_type && block_size == sizeof(uint32_t)) {
+    copy_blocks = [&](int64_t first, int64_t last) {
+      GatherElements<uint32_t>(indices_data, src_base, dst_base, N, data_batch_bytes, first, last);
+    };
+  } else if (!is_string_type && block_size == sizeof(uint64_t)) {
+    copy_blocks = [&](int64_t first, int64_t last) {
+      GatherElements<uint64_t>(indices_data, src_base, dst_base, N, data_batch_bytes, first, last);
+    };
+  } else {
+    copy_blocks = [&](int64_t first, int64_t last) {
+      int64_t batch = first / N;
+      int64_t i = first % N;
+      for (int64_t index = first; index < last; ++index) {
+        const int64_t src_offset_batch = batch * data_batch_bytes;
+        const int64_t dst_offset_batch = batch * gathered_batch_bytes;
+        Tin idx = indices_data[i];
+        const int64_t src_offset = src_offset_batch + idx * block_size;
+        const int64_t dst_offset = dst_offset_batch + i * block_size;
+
+        if (is_string_type) {
+          reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
+              reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+        } else {
+          memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+        }
+
+        if (++i == N) {
+          i = 0;
+          ++batch;
+        }
+      }
+    };
+  }
 
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
-    }
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, M * N, static_cast<double>(block_size), copy_blocks);
+  } else {
+    copy_blocks(0, M * N);
   }
 
   return Status::OK();
@@ -90,14 +136,18 @@ Status Gather::Compute(OpKernelContext* context) const {
   const auto* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
     return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
   if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
     return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   tp);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
@@ -11,7 +11,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<MLFloat16>(), 
                                             DataTypeImpl::GetTensorType<float>(), 
                                             DataTypeImpl::GetTensorType<double>()})
-                      .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
+                      .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>())
+                      .Alias(0, 0),
     IdentityOp<true>);
 
 ONNX_CPU_OPERATOR_KERNEL(
@@ -20,7 +21,8 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<MLFloat16>(),
                                             DataTypeImpl::GetTensorType<float>(),
                                             DataTypeImpl::GetTensorType<double>()})
-                      .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
+                      .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>())
+                      .Alias(0, 0),
     IdentityOp<true>);
 
 ONNX_CPU_OPERATOR_KERNEL(
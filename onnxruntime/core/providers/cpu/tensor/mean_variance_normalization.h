@@ -5,9 +5,11 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
-#include "gsl/gsl_util"
+#include <cmath>
+#include <vector>
 namespace onnxruntime {
 template <typename T>
 class MeanVarianceNormalization_0 : public OpKernel {
@@ -40,55 +42,45 @@ class MeanVarianceNormalization_0 : public OpKernel {
     T* Ydata = Y->template MutableData<T>();
 
     const int64_t sample_size = H * W;
-    Eigen::Array<float, Eigen::Dynamic, 1> mean(C, 1);
-    Eigen::Array<float, Eigen::Dynamic, 1> var(C, 1);
-    mean.setZero();
-    var.setZero();
-
-    ConstEigenArrayMap<T> X_arr(Xdata, sample_size, N * C);
-    for (int nc = 0; nc < N * C; ++nc) {
-      mean(nc % C) += X_arr.col(nc).sum();
+    const int64_t num_planes = N * C;
+    if (num_planes == 0 || sample_size == 0) {
+      return Status::OK();
     }
-    mean /= gsl::narrow_cast<T>(N * sample_size);
-    for (int64_t nc = 0; nc < N * C; ++nc) {
-      var(nc % C) += (X_arr.col(nc) - mean(nc % C)).matrix().squaredNorm();
+
+    concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+    // The mean and variance of each [n, c] plane are combined into those of each channel, or of the whole tensor for
+    // across channels, as the mean of the plane means and the mean of the plane variances plus the squared
+    // deviations of the plane means:
+    //   var = [(var_1 + (m_1 - m)^2) + ... + (var_n + (m_n - m)^2)] / n
+    std::vector<float> plane_mean(num_planes);
+    std::vector<float> plane_var(num_planes);
+    MlasReduceMeanVariance(Xdata, plane_mean.data(), plane_var.data(), num_planes, sample_size, tp);
+
+    const int64_t num_groups = across_channels_ ? 1 : C;
+    const float planes_per_group = static_cast<float>(num_planes / num_groups);
+    std::vector<float> mean(num_groups, 0.0f);
+    std::vector<float> var(num_groups, 0.0f);
+    for (int64_t nc = 0; nc < num_planes; ++nc) {
+      mean[nc % num_groups] += plane_mean[nc];
     }
-    var /= gsl::narrow_cast<T>(N * sample_size);
-
-    Eigen::Array<T, Eigen::Dynamic, 1> inv_std;
-    EigenArrayMap<T> Y_arr(Ydata, sample_size, N * C);
-
-    if (across_channels_) {
-      // m_c = sum(m_i) / n
-      float global_mean = mean.mean();
-
-      // var_c = [(var_1 + (m_1 - m_c)^2) + ...  + (var_n + (m_n - m_c)^2)] / n
-      //       = [sum(var_i) + squared_norm(m_i - m_c)] / n
-      float global_var = ((mean - global_mean).matrix().squaredNorm() + var.sum()) / C;
-
-      // For across channels we can directly use eigen because global_mean and global_var
-      // are just scalars.
-      if (!normalize_variance_) {
-        Y_arr = X_arr - global_mean;
-      } else {
-        float inv_std_scalar = 1 / std::sqrt(global_var);
-        Y_arr = (X_arr - global_mean) * inv_std_scalar;
-      }
-    } else {
-      if (!normalize_variance_) {
-        // inv_std = 1
-        for (int64_t nc = 0; nc < N * C; ++nc) {
-          // y = (x - mean)
-          Y_arr.col(nc) = (X_arr.col(nc) - mean(nc % C));
-        }
-      } else {
-        inv_std = var.sqrt().inverse();
-        for (int64_t nc = 0; nc < N * C; ++nc) {
-          // y = (x - mean) * (inv_std)
-          Y_arr.col(nc) = (X_arr.col(nc) - mean(nc % C)) * inv_std(nc % C);
-        }
-      }
+    for (auto& m : mean) {
+      m /= planes_per_group;
+    }
+    for (int64_t nc = 0; nc < num_planes; ++nc) {
+      const float deviation = plane_mean[nc] - mean[nc % num_groups];
+      var[nc % num_groups] += plane_var[nc] + deviation * deviation;
     }
+
+    // y = (x - mean) * inv_std, with inv_std = 1 when the variance isn't normalized
+    std::vector<float> scale(num_groups);
+    std::vector<float> shift(num_groups);
+    for (int64_t g = 0; g < num_groups; ++g) {
+      scale[g] = normalize_variance_ ? 1.0f / std::sqrt(var[g] / planes_per_group) : 1.0f;
+      shift[g] = -mean[g] * scale[g];
+    }
+
+    MlasComputeScaleShift(Xdata, Ydata, scale.data(), shift.data(), num_groups, num_planes, sample_size, tp);
     return Status::OK();
   }
 
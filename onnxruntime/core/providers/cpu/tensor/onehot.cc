@@ -15,12 +15,13 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/tensor/onehot.h"
-#include "core/util/eigen_common_wrapper.h"
-#include "core/platform/env.h"
 
-#ifndef EIGEN_USE_THREADS
-#define EIGEN_USE_THREADS
-#endif
+#include <algorithm>
+#include <sstream>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
 using namespace ::onnxruntime::common;
 using namespace std;
 
@@ -70,39 +71,27 @@ Status ValidateInputs(const Tensor* depth,
   return Status::OK();
 }
 
-// Helper to define Tensor types given that the scalar is of type T.
-template <typename T, int NDIMS = 1, typename IndexType = Eigen::DenseIndex>
-struct EigenTensorTypes {
-  using EigenTensorMap = Eigen::TensorMap<Eigen::Tensor<T, NDIMS, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstEigenTensorMap = Eigen::TensorMap<Eigen::Tensor<const T, NDIMS, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using Scalar = Eigen::TensorMap<Eigen::TensorFixedSize<T, Eigen::Sizes<>, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstScalar = Eigen::TensorMap<Eigen::TensorFixedSize<const T, Eigen::Sizes<>, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstMatrix = Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-};
-
-namespace generator {
-template <typename in_type, typename out_type>
-class OneGenerator {
- public:
-  EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE
-  OneGenerator(const typename EigenTensorTypes<in_type>::ConstMatrix& indices,
-               const typename EigenTensorTypes<out_type>::ConstScalar& on_value,
-               const typename EigenTensorTypes<out_type>::ConstScalar& off_value)
-      : indices_(indices), on_value_(on_value), off_value_(off_value) {}
-
-  EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE out_type
-  operator()(const Eigen::array<Eigen::DenseIndex, 3>& pre_depth_suff) const {
-    return (indices_(pre_depth_suff[0], pre_depth_suff[2]) == pre_depth_suff[1])
-               ? on_value_()
-               : off_value_();
+namespace {
+// Position of the on value in the depth axis for an index, or -1 when the index is outside [0, depth) or is not an
+// integer, in which case the whole depth axis has the off value.
+template <typename in_type>
+int64_t OnValuePosition(in_type index, int64_t depth) {
+  if (!(index >= 0 && index < depth)) {
+    return -1;
   }
+  const auto position = static_cast<int64_t>(index);
+  return static_cast<in_type>(position) == index ? position : -1;
+}
 
- private:
-  const typename EigenTensorTypes<in_type>::ConstMatrix indices_;
-  const typename EigenTensorTypes<out_type>::ConstScalar on_value_;
-  const typename EigenTensorTypes<out_type>::ConstScalar off_value_;
-};
-}  // namespace generator
+void ForEachElement(concurrency::ThreadPool* tp, int64_t count, double cost_per_element,
+                    const std::function<void(int64_t, int64_t)>& fn) {
+  if (tp == nullptr) {
+    fn(0, count);
+  } else {
+    tp->ParallelForRange(0, count, cost_per_element, fn);
+  }
+}
+}  // namespace
 
 template <typename in_type, typename out_type, typename depth_type>
 Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_kernel_context) const {
@@ -143,6 +132,9 @@ Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_ke
   // allocate output
   const auto* values_data = values->Data<out_type>();
   Tensor* output = p_op_kernel_context->Output(0, TensorShape(output_shape));
+  if (indices_shape.Size() == 0) {
+    return Status::OK();
+  }
 
   int64_t prefix_dim_size = 1;
   for (int64_t i = 0; i < true_axis; ++i) {
@@ -150,27 +142,30 @@ Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_ke
   }
   const int64_t suffix_dim_size = indices_shape.Size() / prefix_dim_size;
 
-  // Split indices into matrix of size prefix_dim_size x suffix_dim_size
-  Eigen::array<Eigen::DenseIndex, 2> indices_dims_e = {
-    {static_cast<Eigen::DenseIndex>(prefix_dim_size), static_cast<Eigen::DenseIndex>(suffix_dim_size)}};
+  // The output is a prefix_dim_size x depth x suffix_dim_size tensor with a single on value in the depth axis for
+  // each index, so it's filled with the off value and the on values are scattered to their positions.
   const auto* indices_data = indices->Data<in_type>();
-  typename EigenTensorTypes<in_type, 2>::ConstEigenTensorMap indices_tensor_e(indices_data, indices_dims_e);
-
-  // Split output into 3-Tensor of size:
-  //   prefix_dim_size x depth x suffix_dim_size.
-  Eigen::array<Eigen::DenseIndex, 3> output_dims_e = {
-    {static_cast<Eigen::DenseIndex>(prefix_dim_size), static_cast<Eigen::DenseIndex>(depth_val), static_cast<Eigen::DenseIndex>(suffix_dim_size)}};
   auto* output_data = output->MutableData<out_type>();
-  typename EigenTensorTypes<out_type, 3>::EigenTensorMap output_tensor_e(output_data, output_dims_e);
-
-  typename EigenTensorTypes<out_type>::ConstScalar on_value_e(values_data + 1);
-  typename EigenTensorTypes<out_type>::ConstScalar off_value_e(values_data);
-
-  generator::OneGenerator<in_type, out_type> generator(indices_tensor_e, on_value_e, off_value_e);
-
-  // TODO potential optimization opportunity
-  // TODO figure out the eigen threadpool stuff for use here
-  output_tensor_e = output_tensor_e.generate(generator);
+  const out_type& off_value = values_data[0];
+  const out_type& on_value = values_data[1];
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+
+  ForEachElement(tp, output->Shape().Size(), static_cast<double>(sizeof(out_type)),
+                 [output_data, &off_value](int64_t first, int64_t last) {
+                   std::fill(output_data + first, output_data + last, off_value);
+                 });
+
+  ForEachElement(tp, indices_shape.Size(), 4.0,
+                 [=, &on_value](int64_t first, int64_t last) {
+                   for (int64_t i = first; i < last; ++i) {
+                     const int64_t position = OnValuePosition(indices_data[i], depth_val);
+                     if (position >= 0) {
+                       const int64_t prefix = i / suffix_dim_size;
+                       const int64_t suffix = i % suffix_dim_size;
+                       output_data[(prefix * depth_val + position) * suffix_dim_size + suffix] = on_value;
+                     }
+                   }
+                 });
 
   return Status::OK();
 }
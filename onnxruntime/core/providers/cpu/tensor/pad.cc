@@ -9,6 +9,8 @@
 #endif
 #include "core/providers/cpu/tensor/pad.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cpu/tensor/copy.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 
@@ -101,6 +103,43 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
   ORT_ENFORCE(dimension_count > 0, "Input tensor has no dimensions");
   ORT_ENFORCE(dimension_count * 2 == pads.size(), "'pads' has wrong number of values");
 
+  // Constant padding fills the output with the value and copies the input, less the negative pads, into the middle.
+  if (mode == Mode::Constant) {
+    const auto& input_dims = input_tensor.Shape().GetDims();
+    std::vector<int64_t> copy_dims(dimension_count);
+    int64_t input_offset = 0;
+    int64_t output_offset = 0;
+    for (size_t i = 0; i < dimension_count; i++) {
+      output_dims[i] += pads[i] + pads[i + dimension_count] + slices[i] + slices[i + dimension_count];
+      copy_dims[i] = input_dims[i] + slices[i] + slices[i + dimension_count];
+    }
+
+    TensorPitches input_pitches(input_dims);
+    TensorPitches output_pitches(output_dims);
+    for (size_t i = 0; i < dimension_count; i++) {
+      input_offset -= slices[i] * input_pitches[i];
+      output_offset += pads[i] * output_pitches[i];
+    }
+
+    auto& output_tensor = *ctx->Output(0, TensorShape(output_dims));
+    auto* output = output_tensor.template MutableData<float>();
+    const auto output_size = output_tensor.Shape().Size();
+
+    concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+    auto fill = [output, value](int64_t first, int64_t last) {
+      std::fill(output + first, output + last, value);
+    };
+    if (tp != nullptr) {
+      tp->ParallelForRange(0, output_size, static_cast<double>(sizeof(float)), fill);
+    } else {
+      fill(0, output_size);
+    }
+
+    StridedCopy<float>(tp, output + output_offset, std::move(output_pitches), std::move(copy_dims),
+                       input_tensor.template Data<float>() + input_offset, std::move(input_pitches));
+    return Status::OK();
+  }
+
   // Reshape input dims
   std::vector<int64_t> reshaped_input_dims;
   FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
@@ -149,34 +188,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
 
   switch (mode) {
     case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          float* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          float* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
+      // handled above
       break;
 
     case Mode::Edge:
@@ -2,9 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/quantize_linear.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
 #include <cmath>
-#include <cfenv>
 
 namespace onnxruntime {
 
@@ -65,21 +65,26 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
   const T* input = x.template Data<T>();
   float* output = y.template MutableData<float>();
 
-  for (size_t n = 0; n < N; n++) {
-    const float* current_scale = scale;
-    const T* current_zero_point = zero_point;
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
 
-    for (size_t bd = 0; bd < static_cast<size_t>(broadcastDim); bd++) {
-      auto zp = static_cast<const int>(*current_zero_point);
-      auto sc = *current_scale;
-
-      for (size_t bs = 0; bs < block_size; bs++) {
-        *output++ = static_cast<float>(static_cast<const int>(*input++) - zp) * sc;
-      }
+  if (stride == 0) {
+    ParallelDequantizeLinear(input, output, x_shape.Size(), *scale, *zero_point, thread_pool);
+    return Status::OK();
+  }
 
-      current_scale += stride;
-      current_zero_point += stride;
+  // each block of block_size elements has the scale and zero point of its index along the axis
+  const int64_t num_blocks = static_cast<int64_t>(N) * broadcastDim;
+  auto dequantize_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t block = first; block < last; block++) {
+      const int64_t bd = block % broadcastDim;
+      MlasDequantizeLinear(input + block * block_size, output + block * block_size, block_size, scale[bd],
+                           zero_point[bd]);
     }
+  };
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelForRange(0, num_blocks, static_cast<double>(block_size), dequantize_blocks);
+  } else {
+    dequantize_blocks(0, num_blocks);
   }
 
   return Status::OK();
@@ -105,11 +110,6 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("y", DataTypeImpl::GetTensorType<int8_t>()),
     QuantizeLinear<int8_t>);
 
-static float RoundHalfToEven(float input) {
-  std::fesetround(FE_TONEAREST);
-  auto result = std::nearbyintf(input);
-  return result;
-}
 template <typename T>
 // formula is Y = X / Scale + ZeroPoint
 Status QuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
@@ -135,11 +135,9 @@ Status QuantizeLinear<T>::Compute(OpKernelContext* ctx) const {
 
     const T zero_point = *(y_zero_point.template Data<T>());
     const float scale = *(y_scale.template Data<float>());
-    const auto num_of_elements = x_shape.Size();
 
-    for (int i = 0; i < num_of_elements; ++i) {
-      output[i] = static_cast<T>(clamp(RoundHalfToEven(static_cast<float>(input[i] / scale)) + zero_point, qmin, qmax));
-    }
+    ParallelQuantizeLinear(input, output, x_shape.Size(), scale, zero_point,
+                           static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool());
 
   } else {
     size_t stride = 0;
@@ -5,10 +5,41 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 
+// Quantizes count elements with a single scale and zero point, rounding to nearest even. The elements are split
+// across the thread pool when there is one.
+template <typename T>
+void ParallelQuantizeLinear(const float* input, T* output, int64_t count, float scale, T zero_point,
+                            concurrency::ThreadPool* thread_pool) {
+  auto quantize = [&](int64_t first, int64_t last) {
+    MlasQuantizeLinear(input + first, output + first, static_cast<size_t>(last - first), scale, zero_point);
+  };
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelForRange(0, count, 2.0, quantize);
+  } else {
+    quantize(0, count);
+  }
+}
+
+// Dequantizes count elements with a single scale and zero point, split across the thread pool when there is one.
+template <typename T>
+void ParallelDequantizeLinear(const T* input, float* output, int64_t count, float scale, T zero_point,
+                              concurrency::ThreadPool* thread_pool) {
+  auto dequantize = [&](int64_t first, int64_t last) {
+    MlasDequantizeLinear(input + first, output + first, static_cast<size_t>(last - first), scale, zero_point);
+  };
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelForRange(0, count, 1.0, dequantize);
+  } else {
+    dequantize(0, count);
+  }
+}
+
 template <typename T>
 class DequantizeLinear final : public OpKernel {
  public:
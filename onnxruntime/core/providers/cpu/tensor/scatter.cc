@@ -4,6 +4,8 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Scatter
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 
 namespace onnxruntime {
@@ -32,7 +34,7 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 template <class Tin, class Tdata>
 Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, const Tensor* updates_input,
-                       const int64_t axis, Tensor* data_output) {
+                       const int64_t axis, Tensor* data_output, concurrency::ThreadPool* tp) {
   const TensorShape& input_data_shape = data_input->Shape();
   const Tin* indices_data = indices_input->template Data<Tin>();
   const auto num_indices = indices_input->Shape().Size();
@@ -65,12 +67,15 @@ Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, co
   }
 
   // Now poke updates
+  if (num_indices == 0) {
+    return Status::OK();
+  }
 
   const auto& upd_shape = updates_input->Shape();
   const auto num_dims = input_data_shape.NumDimensions();
   assert(num_dims > 0);
 
-  // Allocate and zero out counts. The input/output is of the same rank as
+  // dim_counters holds the counts of each dim. The input/output is of the same rank as
   // indices/updates but the actual dimensions of indices/updates must be less or equal
   // than that of input/output because we can update no more elements than
   // the input contains. As we walk through the indices/updates
@@ -80,7 +85,6 @@ Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, co
   // different cardinality according to the upd_shape dimensions.
   // As each counter reaches its max (upd_shape) it resets to zero
   // and we carry to the more significant dim (right to left)
-  std::vector<int64_t> dim_counters(num_dims);
 
   // This vector contains number of elements under the dimension.
   // For example, for the dimensions of [4, 2, 3] the vector
@@ -110,40 +114,62 @@ Status CopyScatterData(const Tensor* data_input, const Tensor* indices_input, co
   }
 
   const auto* update_data = static_cast<const Tdata*>(updates_input->DataRaw());
-  // For every update we compute the destination offset and copy it there
-  for (int64_t index = 0; index < num_indices;) {
-    const Tin axis_idx = indices_data[index];
-
-    // Compute the offset
-    // See comments above for dim_block_size
-    size_t dst_offset = 0;
-    for (size_t i = 0; i < num_dims; ++i) {
-      if (i == size_t(axis)) {
-        // replace the counter with the update index for this dim
-        dst_offset += axis_idx * dim_block_size[i];
-      } else {
-        dst_offset += dim_counters[i] * dim_block_size[i];
-      }
+  // For every update in [first, last) we compute the destination offset and copy it there
+  auto scatter_updates = [&](int64_t first, int64_t last) {
+    // Start the counters at the first update
+    std::vector<int64_t> dim_counters(num_dims);
+    int64_t remaining = first;
+    for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
+      dim_counters[i] = remaining % upd_shape[i];
+      remaining /= upd_shape[i];
     }
 
-    dst_base[dst_offset] = update_data[index];
+    for (int64_t index = first; index < last;) {
+      const Tin axis_idx = indices_data[index];
 
-    if (++index == num_indices) {
-      break;
-    }
-    // Increment counters
-    // See comments for dim_counters above
-    for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
-      auto v = ++dim_counters[i];
-      assert(v <= upd_shape[i]);
-      if (v < upd_shape[i]) {
-        // No carry, done
+      // Compute the offset
+      // See comments above for dim_block_size
+      size_t dst_offset = 0;
+      for (size_t i = 0; i < num_dims; ++i) {
+        if (i == size_t(axis)) {
+          // replace the counter with the update index for this dim
+          dst_offset += axis_idx * dim_block_size[i];
+        } else {
+          dst_offset += dim_counters[i] * dim_block_size[i];
+        }
+      }
+
+      dst_base[dst_offset] = update_data[index];
+
+      if (++index == last) {
         break;
       }
-      // No carry for the most significant dim
-      assert(i > 0);
-      dim_counters[i] = 0;
+      // Increment counters
+      // See comments for dim_counters above
+      for (auto i = int64_t(num_dims - 1); i >= 0; --i) {
+        auto v = ++dim_counters[i];
+        assert(v <= upd_shape[i]);
+        if (v < upd_shape[i]) {
+          // No carry, done
+          break;
+        }
+        // No carry for the most significant dim
+        assert(i > 0);
+        dim_counters[i] = 0;
+      }
     }
+  };
+
+  // Updates with different counters for a dim other than axis write to different elements, so if axis isn't 0
+  // the rows of dim 0 are updated in parallel. Otherwise repeated indices must be applied in order.
+  if (tp != nullptr && axis != 0) {
+    const int64_t row_size = num_indices / upd_shape[0];
+    tp->ParallelForRange(0, upd_shape[0], static_cast<double>(row_size * sizeof(Tdata)),
+                         [&](int64_t first_row, int64_t last_row) {
+                           scatter_updates(first_row * row_size, last_row * row_size);
+                         });
+  } else {
+    scatter_updates(0, num_indices);
   }
   return Status::OK();
 }
@@ -223,14 +249,15 @@ Status Scatter::Compute(OpKernelContext* context) const {
   }
 
   auto* data_output = context->Output(0, input_data_shape);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
   MLDataType Tind_type = indices_input->DataType();
   MLDataType Tdata_type = data_input->DataType();
   Status status;
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
-    DispatchOnIndexTypeAndTensorType(int32_t, Tdata_type, status, CopyScatterData, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnIndexTypeAndTensorType(int32_t, Tdata_type, status, CopyScatterData, data_input, indices_input, updates_input, axis, data_output, tp);
   } else if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
-    DispatchOnIndexTypeAndTensorType(int64_t, Tdata_type, status, CopyScatterData, data_input, indices_input, updates_input, axis, data_output);
+    DispatchOnIndexTypeAndTensorType(int64_t, Tdata_type, status, CopyScatterData, data_input, indices_input, updates_input, axis, data_output, tp);
   } else {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expecting indices to be either int32_t or int64_t");
   }
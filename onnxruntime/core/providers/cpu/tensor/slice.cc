@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/slice.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cpu/tensor/copy.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include <unordered_map>
 #include <limits>
 
@@ -15,7 +17,10 @@ namespace onnxruntime {
       Slice,                                                                            \
       1, 9,                                                                             \
       data_type,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()), \
+      KernelDefBuilder()                                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())                \
+          .MayStridedOutput(0, 0)                                                       \
+          .MayStridedInput(0),                                                          \
       Slice<data_type, false>);
 
 ADD_TYPED_SLICE_V9_OP(uint8_t);
@@ -39,7 +44,9 @@ ADD_TYPED_SLICE_V9_OP(string);
       data_type,                                                                            \
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>())      \
                         .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),    \
-                                                 DataTypeImpl::GetTensorType<int64_t>()}),  \
+                                                 DataTypeImpl::GetTensorType<int64_t>()})   \
+                        .MayStridedOutput(0, 0)                                             \
+                        .MayStridedInput(0),                                                \
       Slice<data_type, true>);
 
 ADD_TYPED_SLICE_V10_OP(uint8_t);
@@ -249,21 +256,30 @@ Status SliceImpl(OpKernelContext* ctx,
                  const std::vector<int64_t>& starts,
                  const std::vector<int64_t>& steps) {
   TensorShape output_shape(output_dims);
+
+  // the slice is a strided view of the input, moving 'step' input elements along each axis. The input may itself be
+  // a strided view.
+  std::vector<int64_t> input_strides = input_tensor.Strides();
+  int64_t input_offset = 0;
+  for (size_t i = 0; i < input_strides.size(); ++i) {
+    input_offset += input_strides[i] * starts[i];
+    input_strides[i] *= steps[i];
+  }
+
+  // share the input buffer when the output is planned as a view, and copy the elements otherwise
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  if (ctx_internal->OutputView(0, 0, output_shape, input_strides, input_offset) != nullptr)
+    return Status::OK();
+
   auto& output_tensor = *ctx->Output(0, output_shape);
 
   // output tensor's size is 0, nothing to fill - return
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  auto* output = output_tensor.template MutableData<T>();
-  const auto* output_end = output + output_tensor.Shape().Size();
-
-  SliceIterator<T> input_iterator(input_tensor, starts, output_dims, steps);
-  while (output != output_end) {
-    *output = *input_iterator;
-    ++output;
-    ++input_iterator;
-  }
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+  StridedCopy<T>(tp, output_tensor.template MutableData<T>(), TensorPitches(output_dims), output_dims,
+                 input_tensor.template Data<T>() + input_offset, std::move(input_strides));
 
   return Status::OK();
 }
@@ -12,6 +12,8 @@
 #include "gsl/gsl_algorithm"
 #include "core/providers/cpu/tensor/tile.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -38,47 +40,79 @@ ONNX_CPU_OPERATOR_KERNEL(
                       .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
-Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
-  const auto& input_shape = input_tensor.Shape().GetDims();
-  const size_t dimension_count = input_shape.size();
-
-  const auto* input = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
-  auto* output = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
-
-  // some helper variables that will be used along the way
-  size_t block_size = 0;
-  int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
-  const int64_t innermost_dim = input_shape[dimension_count - 1];
-
-  while (input_counters) {
-    // Copy the input data over
-    block_size = innermost_dim * element_size;
-    memcpy(output, input, block_size);
-    output += block_size;
-    input += block_size;
-
-    // Tile data for the innermost axis
-    copy = output - block_size;
-    num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
-    }
-
-    // Tile data for other axes
-    while (input_counters.Increment()) {
-      ptrdiff_t pitch = output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()];
-      block_size = pitch * element_size;
-      copy = output - block_size;
-      num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
-    }
+namespace {
+// Fills dst[block_size, block_size * count) with copies of dst[0, block_size). The copied range doubles with every
+// memcpy, so a block repeated many times takes log2(count) calls instead of count.
+void RepeatBlock(uint8_t* dst, size_t block_size, int64_t count) {
+  const size_t total = block_size * static_cast<size_t>(count);
+  for (size_t copied = block_size; copied < total;) {
+    const size_t size = std::min(copied, total - copied);
+    memcpy(dst + copied, dst, size);
+    copied += size;
+  }
+}
+
+// Offset in the output of the first tile of the input block with the flat index 'index' over the axes [0, axis_count)
+int64_t FirstTileOffset(int64_t index, const std::vector<int64_t>& input_dims, const TensorPitches& output_pitches,
+                        size_t axis_count) {
+  int64_t offset = 0;
+  for (size_t axis = axis_count; axis-- > 0;) {
+    offset += (index % input_dims[axis]) * output_pitches[axis];
+    index /= input_dims[axis];
+  }
+  return offset;
+}
+
+void ForEachBlock(concurrency::ThreadPool* tp, int64_t num_blocks, double bytes_per_block,
+                  const std::function<void(int64_t, int64_t)>& fn) {
+  if (tp == nullptr) {
+    fn(0, num_blocks);
+  } else {
+    tp->ParallelForRange(0, num_blocks, bytes_per_block, fn);
+  }
+}
+}  // namespace
+
+void TileFixedSizeData(const void* input_data, const std::vector<int64_t>& input_dims, void* output_data,
+                       const int64_t* repeats, size_t element_size, concurrency::ThreadPool* tp) {
+  const size_t dimension_count = input_dims.size();
+  std::vector<int64_t> output_dims(input_dims);
+  for (size_t axis = 0; axis < dimension_count; ++axis) {
+    output_dims[axis] *= repeats[axis];
+  }
+  const TensorShape input_shape(input_dims);
+  const TensorPitches output_pitches(output_dims);
+
+  const auto* input = static_cast<const uint8_t*>(input_data);
+  auto* output = static_cast<uint8_t*>(output_data);
+
+  // Copy every innermost row of the input to its first tile and tile it along the innermost axis
+  const size_t row_size = input_dims[dimension_count - 1] * element_size;
+  const int64_t row_repeats = repeats[dimension_count - 1];
+  ForEachBlock(tp, input_shape.SizeToDimension(dimension_count - 1), static_cast<double>(row_size * row_repeats),
+               [&](int64_t first, int64_t last) {
+                 for (int64_t row = first; row < last; ++row) {
+                   uint8_t* tile = output + FirstTileOffset(row, input_dims, output_pitches, dimension_count - 1) *
+                                                element_size;
+                   memcpy(tile, input + row * row_size, row_size);
+                   RepeatBlock(tile, row_size, row_repeats);
+                 }
+               });
+
+  // Tile the other axes from the inside out. The blocks repeated along an axis are complete once the axes inside
+  // it are tiled, and the blocks of one axis don't overlap, so each axis is a parallel loop over its blocks.
+  for (size_t axis = dimension_count - 1; axis-- > 0;) {
+    if (repeats[axis] == 1) continue;
+    const size_t block_size = output_pitches[axis] * input_dims[axis] * element_size;
+    const int64_t block_repeats = repeats[axis];
+    ForEachBlock(tp, input_shape.SizeToDimension(axis), static_cast<double>(block_size * (block_repeats - 1)),
+                 [&](int64_t first, int64_t last) {
+                   for (int64_t block = first; block < last; ++block) {
+                     RepeatBlock(output + FirstTileOffset(block, input_dims, output_pitches, axis) * element_size,
+                                 block_size, block_repeats);
+                   }
+                 });
   }
-  return Status::OK();
 }
 
 Status Tile::Compute(OpKernelContext* ctx) const {
@@ -114,34 +148,11 @@ Status Tile::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  const auto& dtype = input_tensor.DataType();
-  TensorAxisCounters input_counters(input_tensor);
-  TensorPitches output_pitches(output_tensor);
-
-  static_assert(sizeof(float) == sizeof(int32_t), "Float and Int32 are of different sizes");
-  static_assert(sizeof(double) == sizeof(int64_t), "Double and Int64 are of different sizes");
-
-  if (dtype == DataTypeImpl::GetType<float>() ||
-      dtype == DataTypeImpl::GetType<int32_t>() ||
-      dtype == DataTypeImpl::GetType<uint32_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(float));
-
-  if (dtype == DataTypeImpl::GetType<double>() || dtype == DataTypeImpl::GetType<int64_t>() ||
-      dtype == DataTypeImpl::GetType<uint64_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(double));
-
-  else if (dtype == DataTypeImpl::GetType<int8_t>() ||
-           dtype == DataTypeImpl::GetType<uint8_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int8_t));
-
-  if (dtype == DataTypeImpl::GetType<int16_t>() || dtype == DataTypeImpl::GetType<uint16_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int16_t));
-
-  else if (dtype == DataTypeImpl::GetType<bool>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(bool));
-
+  // The registered types are all fixed size, so they are copied as raw bytes.
   // TODO: Support 'string' and 'float16' types for completeness
-  else
-    ORT_THROW("Tile doesn't have an implementation yet for the type: ", dtype);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  TileFixedSizeData(input_tensor.DataRaw(), input_shape.GetDims(), output_tensor.MutableDataRaw(), repeats,
+                    input_tensor.DataType()->Size(), tp);
+  return Status::OK();
 }
 }  // namespace onnxruntime
@@ -1,11 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#pragma once
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 struct Tile final : OpKernel {
   Tile(const OpKernelInfo& info) : OpKernel(info) {
@@ -16,4 +21,9 @@ struct Tile final : OpKernel {
  private:
 };
 
+// Writes the input of the given dims, repeated repeats[axis] times along each axis, to the output. The elements are
+// copied as element_size raw bytes, and the copies are spread over tp when it's not null.
+void TileFixedSizeData(const void* input, const std::vector<int64_t>& input_dims, void* output,
+                       const int64_t* repeats, size_t element_size, concurrency::ThreadPool* tp);
+
 }  // namespace onnxruntime
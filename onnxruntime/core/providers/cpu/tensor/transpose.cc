@@ -3,6 +3,12 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 #include "core/framework/utils.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <numeric>
 
 namespace onnxruntime {
 
@@ -51,20 +57,34 @@ static inline void DoTransposeSingleBlock(size_t num_elts_in_block, const std::s
 // The stride vector indicates the transposition.
 static void DoTransposeImpl(int64_t num_axes, const std::vector<int64_t>& target_dims,
                             size_t num_blocks, size_t num_elts_in_block, const std::vector<size_t>& stride,
-                            const uint8_t* source, uint8_t* target, size_t element_size) {
+                            const uint8_t* source, uint8_t* target, size_t element_size,
+                            concurrency::ThreadPool* tp) {
   size_t blocksize = num_elts_in_block * element_size;
-  // index used to iterate over target iteration-space
-  std::vector<int64_t> target_index(num_axes, 0);
-  for (size_t i = 0; i < num_blocks; ++i) {
-    // convert target_index into an offset in source data
-    size_t source_offset = ComputeOffset(target_index, stride, num_axes);
+  auto copy_blocks = [&](int64_t first, int64_t last) {
+    // index used to iterate over target iteration-space, starting at the first block
+    std::vector<int64_t> target_index(num_axes, 0);
+    for (int64_t k = num_axes - 1, remaining = first; k >= 0; --k) {
+      target_index[k] = remaining % target_dims[k];
+      remaining /= target_dims[k];
+    }
+    uint8_t* block_target = target + first * blocksize;
+    for (int64_t i = first; i < last; ++i) {
+      // convert target_index into an offset in source data
+      size_t source_offset = ComputeOffset(target_index, stride, num_axes);
 
-    // copy
-    memcpy(target, source + source_offset * element_size, blocksize);
+      // copy
+      memcpy(block_target, source + source_offset * element_size, blocksize);
 
-    // increment target_index:
-    IncrementIndex(target_index, target_dims, num_axes);
-    target += blocksize;
+      // increment target_index:
+      IncrementIndex(target_index, target_dims, num_axes);
+      block_target += blocksize;
+    }
+  };
+
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, static_cast<int64_t>(num_blocks), static_cast<double>(blocksize), copy_blocks);
+  } else {
+    copy_blocks(0, static_cast<int64_t>(num_blocks));
   }
 }
 
@@ -175,7 +195,113 @@ static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& tar
   }
 }
 
-static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+// SimplifyPermutation: removes the axes of size 1 and merges the input axes that stay next to each other
+// in the output, so the transposition is described with the fewest axes.
+static void SimplifyPermutation(const std::vector<int64_t>& input_dims, const std::vector<size_t>& permutations,
+                                std::vector<int64_t>& dims, std::vector<size_t>& perm) {
+  const size_t rank = input_dims.size();
+  std::vector<int64_t> kept_index(rank, -1);
+  std::vector<int64_t> kept_dims;
+  for (size_t i = 0; i < rank; ++i) {
+    if (input_dims[i] != 1) {
+      kept_index[i] = static_cast<int64_t>(kept_dims.size());
+      kept_dims.push_back(input_dims[i]);
+    }
+  }
+
+  // the output axes are grouped while their input axes follow each other
+  std::vector<size_t> group_axes;  // the first input axis of each group, in the output order
+  std::vector<int64_t> group_dims;
+  int64_t previous_axis = -2;
+  for (size_t i = 0; i < rank; ++i) {
+    int64_t axis = kept_index[permutations[i]];
+    if (axis < 0) continue;
+    if (axis == previous_axis + 1) {
+      group_dims.back() *= kept_dims[axis];
+    } else {
+      group_axes.push_back(static_cast<size_t>(axis));
+      group_dims.push_back(kept_dims[axis]);
+    }
+    previous_axis = axis;
+  }
+
+  // the groups are the new input axes, in the input order
+  std::vector<size_t> order(group_axes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&group_axes](size_t a, size_t b) { return group_axes[a] < group_axes[b]; });
+  dims.resize(order.size());
+  perm.resize(order.size());
+  for (size_t axis = 0; axis < order.size(); ++axis) {
+    dims[axis] = group_dims[order[axis]];
+    perm[order[axis]] = axis;
+  }
+}
+
+// DoTransposeTiled: specialization of DoTranspose for when the innermost axis moves. The axis that becomes
+// innermost and the innermost input axis form 2-D matrices, one for each index of the other axes,
+// that are transposed in tiles by MLAS.
+template <typename T>
+static void DoTransposeTiled(const std::vector<int64_t>& dims, const std::vector<size_t>& perm,
+                             const T* source, T* target, concurrency::ThreadPool* tp) {
+  const size_t rank = dims.size();
+  std::vector<size_t> input_strides(rank, 1);
+  std::vector<size_t> output_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * dims[i];
+    output_strides[i - 1] = output_strides[i] * dims[perm[i]];
+  }
+
+  // rows of the matrices are along the input axis that becomes innermost, columns along the innermost input axis
+  const size_t row_axis = perm[rank - 1];
+  const size_t column_position = std::find(perm.begin(), perm.end(), rank - 1) - perm.begin();
+  const size_t M = dims[row_axis];
+  const size_t N = dims[rank - 1];
+  const size_t input_stride = input_strides[row_axis];
+  const size_t output_stride = output_strides[column_position];
+
+  std::vector<int64_t> outer_dims;
+  std::vector<size_t> outer_input_strides;
+  std::vector<size_t> outer_output_strides;
+  size_t outer_count = 1;
+  for (size_t i = 0; i < rank - 1; ++i) {
+    if (i != column_position) {
+      outer_dims.push_back(dims[perm[i]]);
+      outer_input_strides.push_back(input_strides[perm[i]]);
+      outer_output_strides.push_back(output_strides[i]);
+      outer_count *= dims[perm[i]];
+    }
+  }
+
+  // the columns are split in blocks so that a single large matrix also runs in parallel
+  constexpr size_t kColumnBlock = 256;
+  const size_t column_blocks = (N + kColumnBlock - 1) / kColumnBlock;
+  auto transpose_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t block = first; block < last; ++block) {
+      size_t outer = static_cast<size_t>(block) / column_blocks;
+      const size_t n = (static_cast<size_t>(block) % column_blocks) * kColumnBlock;
+      size_t source_offset = 0;
+      size_t target_offset = 0;
+      for (size_t k = outer_dims.size(); k-- > 0;) {
+        const size_t index = outer % outer_dims[k];
+        outer /= outer_dims[k];
+        source_offset += index * outer_input_strides[k];
+        target_offset += index * outer_output_strides[k];
+      }
+      MlasTranspose(source + source_offset + n, target + target_offset + n * output_stride,
+                    M, std::min(kColumnBlock, N - n), input_stride, output_stride);
+    }
+  };
+
+  const int64_t num_blocks = static_cast<int64_t>(outer_count * column_blocks);
+  if (tp != nullptr) {
+    tp->ParallelForRange(0, num_blocks, static_cast<double>(M * std::min(kColumnBlock, N)), transpose_blocks);
+  } else {
+    transpose_blocks(0, num_blocks);
+  }
+}
+
+static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                 concurrency::ThreadPool* tp) {
   const auto& input_shape = input.Shape();
   const auto& input_dims = input_shape.GetDims();
   auto rank = input_shape.NumDimensions();
@@ -183,6 +309,23 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
   const auto element_size = input.DataType()->Size();
   const bool is_string_type = input.DataType() == DataTypeImpl::GetType<std::string>();
 
+  // moving the innermost axis transposes matrices in tiles, rather than copying element by element
+  if (!is_string_type && (element_size == sizeof(uint32_t) || element_size == sizeof(uint8_t))) {
+    std::vector<int64_t> dims;
+    std::vector<size_t> perm;
+    SimplifyPermutation(input_dims, permutations, dims, perm);
+    if (dims.size() >= 2 && perm.back() != dims.size() - 1) {
+      if (element_size == sizeof(uint32_t)) {
+        DoTransposeTiled(dims, perm, reinterpret_cast<const uint32_t*>(input.DataRaw()),
+                         reinterpret_cast<uint32_t*>(output.MutableDataRaw()), tp);
+      } else {
+        DoTransposeTiled(dims, perm, reinterpret_cast<const uint8_t*>(input.DataRaw()),
+                         reinterpret_cast<uint8_t*>(output.MutableDataRaw()), tp);
+      }
+      return Status::OK();
+    }
+  }
+
   std::vector<size_t> stride(rank);
   for (size_t i = 0; i < rank; i++) {
     size_t inpdim = permutations[i];
@@ -232,14 +375,15 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
                          input_data, output_data, element_size);
     } else {
       DoTransposeImpl(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, suffix_blocksize, stride,
-                      input_data, output_data, element_size);
+                      input_data, output_data, element_size, tp);
     }
   }
 
   return Status::OK();
 }
 
-Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                  concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -249,7 +393,7 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
   } else {
-    status = DoUntypedTranspose(permutations, input, output);
+    status = DoUntypedTranspose(permutations, input, output, tp);
   }
 
   return status;
@@ -274,7 +418,7 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
-  DoUntypedTranspose(*p_perm, X, Y);
+  DoUntypedTranspose(*p_perm, X, Y, static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool());
 
   return Status::OK();
 }
@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/upsample.h"
+#include <algorithm>
 #include <cmath>
 #include <sstream>
+#include "core/framework/op_kernel_context_internal.h"
 
 using namespace onnxruntime::common;
 using namespace std;
@@ -30,31 +32,14 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
     Upsample<uint8_t>);
 
-template <typename T>
-void UpsampleNearest2x(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    const T* input,
-    T* output) {
-  const int64_t output_height = input_height * 2;
-  const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
-        }
-      }
-      input += input_height * input_width;
-      output += output_height * output_width;
-    }
+// Returns the input index along an axis for each output index of nearest neighbor upsampling.
+static std::vector<int64_t> NearestInputIndices(int64_t output_dim, int64_t input_dim, float scale) {
+  std::vector<int64_t> indices(output_dim);
+  for (int64_t o = 0; o < output_dim; ++o) {
+    auto i = static_cast<int64_t>(scale < 1 ? std::ceil(o / scale) : o / scale);
+    indices[o] = std::min(i, input_dim - 1);
   }
+  return indices;
 }
 
 template <typename T>
@@ -63,7 +48,8 @@ Status UpsampleNearest(const T* input,
                        const TensorShape& input_shape,
                        const TensorShape& output_shape,
                        const vector<float>& scales,
-                       bool is_resize) {
+                       bool is_resize,
+                       concurrency::ThreadPool* tp) {
   if (!input || !output)
     return Status(ONNXRUNTIME, FAIL, is_resize ? "Resize: input/output value is nullptr" : 
                                                  "Upsample: input/output value is nullptr");
@@ -78,80 +64,65 @@ Status UpsampleNearest(const T* input,
 
   int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
 
-  std::vector<int64_t> input_dim_counters(n_dim);
-  std::vector<int64_t> input_dim_factor(n_dim);
-  input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
-  for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
-    input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_shape[dim_idx + 1];
-  }
-
-  int64_t output_idx = 0;
-  int64_t input_idx = 0;
-
-#define OneDemensionProcessor(dim_inx)                                                                                                                  \
-  int64_t input_dim##dim_inx##_inx =                                                                                                                    \
-      static_cast<int64_t>(scales[dim_inx] < 1 ? std::ceil(output_dim##dim_inx##_inx / scales[dim_inx]) : output_dim##dim_inx##_inx / scales[dim_inx]); \
-  if (input_dim##dim_inx##_inx > input_shape[dim_inx] - 1) input_dim##dim_inx##_inx = input_shape[dim_inx] - 1;                                         \
-  if (input_dim##dim_inx##_inx != input_dim_counters[dim_inx]) {                                                                                        \
-    input_idx += (input_dim##dim_inx##_inx - input_dim_counters[dim_inx]) * input_dim_factor[dim_inx];                                                  \
-    input_dim_counters[dim_inx] = input_dim##dim_inx##_inx;                                                                                             \
-  }
-
-  if (n_dim == 1) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      output[output_idx++] = input[input_idx];
+  if (n_dim <= 4) {
+    // Inputs of up to 4 dimensions are treated as [N, C, H, W] with leading dimensions of size 1. The input index
+    // along each axis is looked up in a table, and the output planes are filled in parallel, copying the previous
+    // output row when two output rows read the same input row.
+    int64_t in_dims[4] = {1, 1, 1, 1};
+    int64_t out_dims[4] = {1, 1, 1, 1};
+    float axis_scales[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    for (int64_t i = 0; i < n_dim; ++i) {
+      in_dims[4 - n_dim + i] = input_shape[i];
+      out_dims[4 - n_dim + i] = output_shape[i];
+      axis_scales[4 - n_dim + i] = scales[i];
     }
-    return Status::OK();
-  }
 
-  if (n_dim == 2) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        output[output_idx++] = input[input_idx];
-      }
+    std::vector<int64_t> in_indices[4];
+    for (int i = 0; i < 4; ++i) {
+      in_indices[i] = NearestInputIndices(out_dims[i], in_dims[i], axis_scales[i]);
     }
-    return Status::OK();
-  }
 
-  if (n_dim == 3) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDemensionProcessor(2);
-          output[output_idx++] = input[input_idx];
+    const int64_t input_plane_size = in_dims[2] * in_dims[3];
+    const int64_t output_width = out_dims[3];
+    const int64_t output_plane_size = out_dims[2] * output_width;
+
+    auto upsample_planes = [&](int64_t first, int64_t last) {
+      for (int64_t plane = first; plane < last; ++plane) {
+        const int64_t in_plane = in_indices[0][plane / out_dims[1]] * in_dims[1] + in_indices[1][plane % out_dims[1]];
+        const T* in_data = input + in_plane * input_plane_size;
+        T* out_row = output + plane * output_plane_size;
+        for (int64_t y = 0; y < out_dims[2]; ++y, out_row += output_width) {
+          if (y > 0 && in_indices[2][y] == in_indices[2][y - 1]) {
+            std::copy(out_row - output_width, out_row, out_row);
+            continue;
+          }
+          const T* in_row = in_data + in_indices[2][y] * in_dims[3];
+          const int64_t* in_x = in_indices[3].data();
+          for (int64_t x = 0; x < output_width; ++x) {
+            out_row[x] = in_row[in_x[x]];
+          }
         }
       }
+    };
+
+    const int64_t num_planes = out_dims[0] * out_dims[1];
+    if (tp != nullptr && num_planes > 1) {
+      tp->ParallelForRange(0, num_planes, static_cast<double>(output_plane_size), upsample_planes);
+    } else {
+      upsample_planes(0, num_planes);
     }
     return Status::OK();
   }
 
-  if (n_dim == 4) {
-    if (scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-      UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-      return Status::OK();
-    }
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDemensionProcessor(2);
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            OneDemensionProcessor(3);
-            output[output_idx++] = input[input_idx];
-          }
-        }
-      }
-    }
-    return Status::OK();
+  std::vector<int64_t> input_dim_counters(n_dim);
+  std::vector<int64_t> input_dim_factor(n_dim);
+  input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
+  for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
+    input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_shape[dim_idx + 1];
   }
 
-#undef OneDemensionProcessor
+  int64_t output_idx = 0;
+  int64_t input_idx = 0;
 
   std::vector<int64_t> output_dim_counter(n_dim);
   output_dim_counter[n_dim - 1] = -1;  // initialize dimension counter
@@ -255,6 +226,9 @@ Status upsampleLiner(const T* input,
 // the scale values for the outermost 2 dimensions are 1.
 // This is the common use-case where the 4-D input (batched multi-channel images) 
 // is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+// The interpolation is separable: each input row that is needed is interpolated along the width once into a
+// buffer, and each output row blends the buffers of its two input rows, which are reused by the next output rows
+// that read the same input rows. The [N, C] planes are processed in parallel.
 template <typename T>
 void upsampleBilinear(
     int64_t batch_size,
@@ -265,7 +239,8 @@ void upsampleBilinear(
     float width_scale,
     const T* Xdata,
     T* Ydata,
-    AllocatorPtr& alloc) {
+    AllocatorPtr& alloc,
+    concurrency::ThreadPool* tp) {
   auto output_width = static_cast<int64_t>(input_width * width_scale);
   auto output_height = static_cast<int64_t>(input_height * height_scale);
 
@@ -274,8 +249,8 @@ void upsampleBilinear(
   auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
   BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
   auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = idx_data + output_height;
+  int64_t* in_y1 = idx_data;
+  int64_t* in_y2 = idx_data + output_height;
   int64_t* in_x1 = idx_data + 2 * output_height;
   int64_t* in_x2 = idx_data + 2 * output_height + output_width;
 
@@ -287,17 +262,14 @@ void upsampleBilinear(
 
   for (int64_t y = 0; y < output_height; ++y) {
     float in_y = std::min(y / height_scale, static_cast<float>(input_height - 1));
-    const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
-    const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
-    if (in_y1 == in_y2) {
+    in_y1[y] = std::min(static_cast<int64_t>(in_y), input_height - 1);
+    in_y2[y] = std::min(in_y1[y] + 1, input_height - 1);
+    dy1[y] = std::fabs(in_y - in_y1[y]);
+    dy2[y] = std::fabs(in_y - in_y2[y]);
+    if (in_y1[y] == in_y2[y]) {
       dy1[y] = 0.5f;
       dy2[y] = 0.5f;
     }
-
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
   }
 
   for (int64_t x = 0; x < output_width; ++x) {
@@ -313,24 +285,58 @@ void upsampleBilinear(
     }
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
+  const int64_t input_plane_size = input_height * input_width;
+  const int64_t output_plane_size = output_height * output_width;
+
+  auto upsample_planes = [&](int64_t first, int64_t last) {
+    std::vector<float> rows(2 * output_width);
+    float* row1 = rows.data();
+    float* row2 = rows.data() + output_width;
+
+    auto interpolate_row = [&](const T* input_row, float* row) {
+      for (int64_t x = 0; x < output_width; ++x) {
+        row[x] = dx2[x] * input_row[in_x1[x]] + dx1[x] * input_row[in_x2[x]];
+      }
+    };
+
+    for (int64_t plane = first; plane < last; ++plane) {
+      const T* input = Xdata + plane * input_plane_size;
+      T* output = Ydata + plane * output_plane_size;
+
+      // the input rows held by row1 and row2
+      int64_t row1_y = -1;
+      int64_t row2_y = -1;
+
       for (int64_t y = 0; y < output_height; ++y) {
+        if (row1_y != in_y1[y]) {
+          if (row2_y == in_y1[y]) {
+            std::swap(row1, row2);
+            std::swap(row1_y, row2_y);
+          } else {
+            interpolate_row(input + in_y1[y] * input_width, row1);
+            row1_y = in_y1[y];
+          }
+        }
+        if (row2_y != in_y2[y]) {
+          interpolate_row(input + in_y2[y] * input_width, row2);
+          row2_y = in_y2[y];
+        }
+
+        const float w1 = dy2[y];
+        const float w2 = dy1[y];
+        T* output_row = output + y * output_width;
         for (int64_t x = 0; x < output_width; ++x) {
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
-
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
+          output_row[x] = static_cast<T>(w1 * row1[x] + w2 * row2[x]);
         }
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
     }
+  };
+
+  const int64_t num_planes = batch_size * num_channels;
+  if (tp != nullptr && num_planes > 1) {
+    tp->ParallelForRange(0, num_planes, 4.0 * output_plane_size, upsample_planes);
+  } else {
+    upsample_planes(0, num_planes);
   }
 }
 
@@ -360,9 +366,11 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
     return Status::OK();
   }
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   switch (mode_) {
     case UpsampleMode::NN:
-      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, is_resize);
+      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, is_resize, tp);
     case UpsampleMode::LINEAR: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
       //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case 
@@ -384,7 +392,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
       ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
       upsampleBilinear(batch_size, num_channels, input_height, input_width,
                        is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], 
-                       X->template Data<T>(), Y->template MutableData<T>(), alloc);
+                       X->template Data<T>(), Y->template MutableData<T>(), alloc, tp);
       return Status::OK();
     }
     default:
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <type_traits>
 
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/element_wise_ops.h"  // for broadcast utilities
 
 namespace onnxruntime {
@@ -41,124 +43,87 @@ WHERE_TYPED_KERNEL_WITH_TYPE_NAME(std::string, string)
 #undef WHERE_TYPED_KERNEL
 
 namespace {
-template <typename T>
-constexpr bool IsEigenScalarCompatible = std::is_arithmetic<T>::value;
-
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target,
-                    TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoop(
-      *select_broadcaster, *select_broadcast_output,
-      [target](EigenVectorMap<T> output, bool condition, ConstEigenVectorMap<T> value) {
-        if (condition == target) {
-          output = value;
-        } else {
-          output = EigenVectorMap<T>::PlainObject::Constant(value.size(), T{});
-        }
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, const T& value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, ConstEigenVectorMap<T> value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      });
-}
-
-template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target, TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoopSpan(
-      *select_broadcaster, *select_broadcast_output,
-      [target](gsl::span<T> output, bool condition, gsl::span<const T> value) {
-        if (condition == target) {
-          std::copy(value.cbegin(), value.cend(), output.begin());
-        } else {
-          std::fill(output.begin(), output.end(), T{});
+// Elements of the output computed by one task of the parallel loop
+constexpr int64_t kWhereBlockSize = 4096;
+
+// The output of Where as rows of the innermost run of axes on which each input is either broadcast or not. The
+// other axes are merged the same way, so a row of the output starts at the offsets of the rows of the inputs given
+// by their strides on the outer axes, and an input that is broadcast on the innermost axes is a scalar in each row.
+struct WhereRows {
+  WhereRows(const std::vector<int64_t>& output_dims, const std::vector<const std::vector<int64_t>*>& input_dims) {
+    const size_t output_rank = output_dims.size();
+    const size_t input_count = input_dims.size();
+    std::vector<int64_t> input_sizes(input_count, 1);
+    std::vector<bool> previous_broadcast;
+    for (size_t axis = output_rank; axis-- > 0;) {
+      if (output_dims[axis] == 1) continue;
+      std::vector<bool> broadcast(input_count);
+      for (size_t input = 0; input < input_count; ++input) {
+        const auto& input_shape = *input_dims[input];
+        const size_t leading_axes = output_rank - input_shape.size();
+        broadcast[input] = axis < leading_axes || input_shape[axis - leading_axes] == 1;
+      }
+      if (!dims.empty() && broadcast == previous_broadcast) {
+        dims.back() *= output_dims[axis];
+      } else {
+        dims.push_back(output_dims[axis]);
+        strides.emplace_back(input_count);
+        for (size_t input = 0; input < input_count; ++input) {
+          strides.back()[input] = broadcast[input] ? 0 : input_sizes[input];
         }
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, const T& value) {
-        std::transform(condition.cbegin(), condition.cend(), output.begin(),
-                       [target, &value](bool condition_element) {
-                         return condition_element == target ? value : T{};
-                       });
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, gsl::span<const T> value) {
-        std::transform(condition.cbegin(), condition.cend(), value.cbegin(), output.begin(),
-                       [target](bool condition_element, const T& value_element) {
-                         return condition_element == target ? value_element : T{};
-                       });
-      });
-}
-
-template <typename T>
-std::unique_ptr<Tensor> Select(bool target, const Tensor& condition_tensor, const Tensor& value_tensor,
-                               TensorAllocator<T>& tensor_allocator) {
-  TBroadcaster<bool, T> select_broadcaster{condition_tensor, value_tensor};
-  std::unique_ptr<Tensor> select_tensor{
-      tensor_allocator.Allocate(select_broadcaster.GetOutputShape())};
-  TBroadcastOutput<T> select_broadcast_output{
-      select_broadcaster.GetSpanSize(), *select_tensor};
-
-  SelectBroadcastLoop(target, &select_broadcaster, &select_broadcast_output);
+        previous_broadcast = broadcast;
+      }
+      for (size_t input = 0; input < input_count; ++input) {
+        if (!broadcast[input]) input_sizes[input] *= output_dims[axis];
+      }
+    }
+    if (dims.empty()) {
+      dims.push_back(1);
+      strides.emplace_back(input_count, 0);
+    }
+  }
 
-  return select_tensor;
-}
+  int64_t RowSize() const { return dims.front(); }
+  bool IsScalarInRow(size_t input) const { return strides.front()[input] == 0; }
 
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](EigenVectorMap<T> output,
-                                      const T& scalar_value, ConstEigenVectorMap<T> vector_value) {
-    if (scalar_value != T{}) {
-      output = EigenVectorMap<T>::PlainObject::Constant(vector_value.size(), scalar_value);
-    } else {
-      output = vector_value;
+  int64_t InputOffset(int64_t row, size_t input) const {
+    int64_t offset = 0;
+    for (size_t group = 1; group < dims.size(); ++group) {
+      offset += (row % dims[group]) * strides[group][input];
+      row /= dims[group];
     }
-  };
-
-  BroadcastLoop(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](EigenVectorMap<T> output, const T& X_selection, ConstEigenVectorMap<T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, ConstEigenVectorMap<T> Y_selection) {
-        output = X_selection.binaryExpr(Y_selection, [](T x, T y) -> T {
-          return x != T{} ? x : y;
-        });
-      });
+    return offset;
+  }
+
+  // Sizes and per input strides of the merged axes, innermost first
+  std::vector<int64_t> dims;
+  std::vector<std::vector<int64_t>> strides;
+};
+
+// The condition, X and Y are each either a scalar or a span. Every combination is a separate loop, arithmetic values
+// are loaded before they are selected and the condition is read as bytes, so the compiler turns the loop into vector
+// blends.
+template <typename T, bool ConditionIsScalar, bool XIsScalar, bool YIsScalar>
+void WhereSpan(const uint8_t* condition, const T* x, const T* y, T* output, int64_t count) {
+  using Value = typename std::conditional<std::is_arithmetic<T>::value, const T, const T&>::type;
+  for (int64_t i = 0; i < count; ++i) {
+    Value x_value = x[XIsScalar ? 0 : i];
+    Value y_value = y[YIsScalar ? 0 : i];
+    output[i] = condition[ConditionIsScalar ? 0 : i] != 0 ? x_value : y_value;
+  }
 }
 
 template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](gsl::span<T> output, const T& scalar_value, gsl::span<const T> vector_value) {
-    if (!scalar_value.empty()) {
-      std::fill(output.begin(), output.end(), scalar_value);
-    } else {
-      std::copy(vector_value.cbegin(), vector_value.cend(), output.begin());
-    }
-  };
+using WhereSpanFn = void (*)(const uint8_t*, const T*, const T*, T*, int64_t);
 
-  BroadcastLoopSpan(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](gsl::span<T> output, const T& X_selection, gsl::span<const T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](gsl::span<T> output, gsl::span<const T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](gsl::span<T> output, gsl::span<const T> X_selection, gsl::span<const T> Y_selection) {
-        std::transform(X_selection.cbegin(), X_selection.cend(), Y_selection.cbegin(), output.begin(),
-                       [](const T& x, const T& y) { return !x.empty() ? x : y; });
-      });
+template <typename T>
+WhereSpanFn<T> GetWhereSpan(bool condition_is_scalar, bool x_is_scalar, bool y_is_scalar) {
+  static const WhereSpanFn<T> spans[] = {
+      WhereSpan<T, false, false, false>, WhereSpan<T, false, false, true>,
+      WhereSpan<T, false, true, false>, WhereSpan<T, false, true, true>,
+      WhereSpan<T, true, false, false>, WhereSpan<T, true, false, true>,
+      WhereSpan<T, true, true, false>, WhereSpan<T, true, true, true>};
+  return spans[(condition_is_scalar ? 4 : 0) + (x_is_scalar ? 2 : 0) + (y_is_scalar ? 1 : 0)];
 }
 }  // namespace
 
@@ -169,24 +134,55 @@ Status Where<T>::Compute(OpKernelContext* context) const {
   const auto* const Y = context->Input<Tensor>(2);
   ORT_ENFORCE(condition && X && Y, "condition, X, and Y inputs are required!");
 
-  // The current implementation is limited to broadcasting over two tensors at once.
-  // So, we first broadcast over condition and X to select the values from X:
-  //   X_selection = condition ? X : default value
-  // Similarly, we broadcast over condition and Y to select the values from Y:
-  //   Y_selection = !condition ? Y : default value
-  // Finally, we broadcast over and merge X_selection and Y_selection:
-  //   output = (X_selection != default value) ? X_selection : Y_selection
-  TensorAllocator<T> tensor_allocator{*context};
-  auto X_selection_tensor = Select<T>(true, *condition, *X, tensor_allocator);
-  auto Y_selection_tensor = Select<T>(false, *condition, *Y, tensor_allocator);
-
-  TBroadcaster<T, T> merge_broadcaster{*X_selection_tensor, *Y_selection_tensor};
-  Tensor* const output = context->Output(0, merge_broadcaster.GetOutputShape());
+  const auto& condition_dims = condition->Shape().GetDims();
+  const auto& X_dims = X->Shape().GetDims();
+  const auto& Y_dims = Y->Shape().GetDims();
+  const Broadcaster condition_X_broadcaster{condition_dims, X_dims};
+  const Broadcaster output_broadcaster{condition_X_broadcaster.output_shape_, Y_dims};
+  const std::vector<int64_t>& output_dims = output_broadcaster.output_shape_;
+
+  Tensor* const output = context->Output(0, TensorShape(output_dims));
   ORT_ENFORCE(output, "failed to get first output!");
-  TBroadcastOutput<T> merge_broadcast_output{
-      merge_broadcaster.GetSpanSize(), *output};
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // All three inputs are broadcast to the output in a single pass, which is split into blocks of the output rows
+  const WhereRows rows{output_dims, {&condition_dims, &X_dims, &Y_dims}};
+  const int64_t row_size = rows.RowSize();
+  const int64_t blocks_per_row = (row_size + kWhereBlockSize - 1) / kWhereBlockSize;
+  const int64_t row_count = output->Shape().Size() / row_size;
+  const WhereSpanFn<T> where_span =
+      GetWhereSpan<T>(rows.IsScalarInRow(0), rows.IsScalarInRow(1), rows.IsScalarInRow(2));
+
+  const auto* condition_data = reinterpret_cast<const uint8_t*>(condition->template Data<bool>());
+  const T* X_data = X->template Data<T>();
+  const T* Y_data = Y->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  auto where_blocks = [&](int64_t first, int64_t last) {
+    for (int64_t block = first; block < last; ++block) {
+      const int64_t row = block / blocks_per_row;
+      const int64_t begin = (block % blocks_per_row) * kWhereBlockSize;
+      const int64_t count = std::min(kWhereBlockSize, row_size - begin);
+      const int64_t condition_begin = rows.IsScalarInRow(0) ? 0 : begin;
+      const int64_t X_begin = rows.IsScalarInRow(1) ? 0 : begin;
+      const int64_t Y_begin = rows.IsScalarInRow(2) ? 0 : begin;
+      where_span(condition_data + rows.InputOffset(row, 0) + condition_begin,
+                 X_data + rows.InputOffset(row, 1) + X_begin,
+                 Y_data + rows.InputOffset(row, 2) + Y_begin,
+                 output_data + row * row_size + begin, count);
+    }
+  };
 
-  MergeBroadcastLoop(&merge_broadcaster, &merge_broadcast_output);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  const int64_t block_count = row_count * blocks_per_row;
+  if (tp == nullptr) {
+    where_blocks(0, block_count);
+  } else {
+    const double cost_per_block = static_cast<double>(std::min(kWhereBlockSize, row_size) * sizeof(T));
+    tp->ParallelForRange(0, block_count, cost_per_block, where_blocks);
+  }
 
   return Status::OK();
 }
@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <cuda_runtime.h>
 #include "core/providers/cuda/shared_inc/cuda_call.h"
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -201,7 +202,7 @@ struct GridDim {
 
   // use these for launching
   //   GridDim grid(NN);
-  //   kernel<<<grid.m_blocksPerGrid, grid.m_threadsPerBlock, ...>>>(...)
+  //   kernel<<<grid.m_blocksPerGrid, grid.m_threadsPerBlock, ..., CurrentStream()>>>(...)
   int blocks_per_grid_, threads_per_block_;  // (these may in the future be extended to multi-dimensional ones)
   CUDA_LONG N_;
 
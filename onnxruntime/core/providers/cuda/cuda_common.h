@@ -35,6 +35,8 @@ class CudaKernel : public OpKernel {
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override {
+    // the kernel's launches, copies and library calls go to the stream of its provider
+    cuda::CurrentStreamScope stream_scope(provider_->GetStream());
     auto s = ComputeInternal(p_op_kernel_context);
     // use this to precisely locate the node where CUDA failure comes from
     //  if (cudaSuccess != cudaDeviceSynchronize())
@@ -94,7 +96,8 @@ class CudaKernel : public OpKernel {
     Status CopyToGpu() {
       if (cpu_pinned_copy_) {
         gpu_copy_ = op_kernel_->GetScratchBuffer<T>(count_);
-        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice));
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(gpu_copy_.get(), cpu_pinned_copy_.get(), count_ * sizeof(T), cudaMemcpyHostToDevice,
+                                             cuda::CurrentStream()));
         op_kernel_->AddDeferredReleaseCPUPtr(cpu_pinned_copy_.release());
       }
       return Status::OK();
@@ -132,6 +135,12 @@ class CudaKernel : public OpKernel {
     return provider_->PerThreadCudnnHandle();
   }
 
+#if CUDART_VERSION >= 11000
+  inline cublasLtHandle_t CublasLtHandle() const {
+    return provider_->PerThreadCublasLtHandle();
+  }
+#endif
+
   template <typename T>
   inline const T* GetConstOnes(size_t count) const {
     return provider_->template GetConstOnes<T>(count);
@@ -143,6 +152,10 @@ class CudaKernel : public OpKernel {
 
   inline int GetDeviceId() const { return provider_->GetDeviceId(); }
 
+  inline CudnnConvAlgoSearch GetCudnnConvAlgoSearch() const { return provider_->GetCudnnConvAlgoSearch(); }
+
+  inline CudnnConvAlgoCache& GetCudnnConvAlgoCache() const { return provider_->GetCudnnConvAlgoCache(); }
+
  private:
   CUDAExecutionProvider* provider_;
 };
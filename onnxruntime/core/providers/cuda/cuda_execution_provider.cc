@@ -1,11 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
+
 #include "cuda_common.h"
 #include "cuda_execution_provider.h"
 #include "core/framework/memcpy.h"
 #include "cuda_fence.h"
 #include "cuda_allocator.h"
+#include "core/common/profiler.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
@@ -26,7 +29,7 @@ ONNX_OPERATOR_KERNEL_EX(
     1,
     kCudaExecutionProvider,
     KernelDefBuilder()
-        .InputMemoryType<OrtMemTypeCPUInput>(0)
+        .SetDefaultInputsMemoryType(OrtMemTypeCPUInput)
         .ExecQueueId(kCudaStreamCopyIn)
         .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
     Memcpy);
@@ -37,37 +40,107 @@ ONNX_OPERATOR_KERNEL_EX(
     1,
     kCudaExecutionProvider,
     KernelDefBuilder()
-        .OutputMemoryType<OrtMemTypeCPUOutput>(0)
+        .SetDefaultOutputMemoryType(OrtMemTypeCPUOutput)
         .ExecQueueId(kCudaStreamCopyOut)
         .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
     Memcpy);
 
+static thread_local cudaStream_t current_stream = nullptr;
+
+cudaStream_t CurrentStream() {
+  return current_stream;
+}
+
+CurrentStreamScope::CurrentStreamScope(cudaStream_t stream) : previous_(current_stream) {
+  current_stream = stream;
+}
+
+CurrentStreamScope::~CurrentStreamScope() {
+  current_stream = previous_;
+}
+
+bool IsCapturing(cudaStream_t stream) {
+#if CUDART_VERSION >= 10000
+  cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+  return stream != nullptr && cudaStreamIsCapturing(stream, &status) == cudaSuccess &&
+         status != cudaStreamCaptureStatusNone;
+#else
+  ORT_UNUSED_PARAMETER(stream);
+  return false;
+#endif
+}
+
+static thread_local CopyTimingEvents* current_copy_timing = nullptr;
+
+CopyTimingEvents* CurrentCopyTiming() {
+  return current_copy_timing;
+}
+
 }  // namespace cuda
 
+static void DestroyTimingEvents(std::initializer_list<cudaEvent_t> events) {
+  for (cudaEvent_t event : events) {
+    if (event != nullptr) {
+      CUDA_CALL(cudaEventDestroy(event));
+    }
+  }
+}
+
 thread_local std::unique_ptr<CUDAExecutionProvider::PerThreadContextMap> CUDAExecutionProvider::per_thread_context_map_;
+thread_local std::vector<CUDAExecutionProvider::KernelTiming> CUDAExecutionProvider::kernel_timing_stack_;
 
-CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id) {
+CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id, const ArenaConfig* arena_config,
+                                                          cudaStream_t stream) {
   CUDA_CALL_THROW(cudaSetDevice(device_id));
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
+  CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, stream));
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
+  CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, stream));
+#if CUDART_VERSION >= 11000
+  // cuBLASLt takes the stream with each call
+  CUBLAS_CALL_THROW(cublasLtCreate(&cublas_lt_handle_));
+#endif
 
-  DeviceAllocatorRegistrationInfo default_allocator_info(
-      {OrtMemTypeDefault,
-       [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
-  allocator_ = CreateAllocator(default_allocator_info, device_id);
+  if (arena_config != nullptr) {
+    DeviceAllocatorRegistrationInfo default_allocator_info(
+        {OrtMemTypeDefault,
+         [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max(), *arena_config});
+    allocator_ = CreateAllocator(default_allocator_info, device_id);
+  }
 }
 
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
   CUBLAS_CALL_THROW(cublasDestroy(cublas_handle_));
   CUDNN_CALL_THROW(cudnnDestroy(cudnn_handle_));
+#if CUDART_VERSION >= 11000
+  CUBLAS_CALL_THROW(cublasLtDestroy(cublas_lt_handle_));
+#endif
 }
 
 CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id), arena_config_(info.arena_config), arena_per_thread_(info.arena_per_thread), stream_(info.stream), enable_cuda_graph_(info.enable_cuda_graph), cudnn_conv_algo_search_(info.cudnn_conv_algo_search), cudnn_conv_algo_cache_path_(info.cudnn_conv_algo_cache_path) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
+  cudnn_conv_algo_cache_ = std::make_unique<cuda::CudnnConvAlgoCache>(device_id_);
+  if (!cudnn_conv_algo_cache_path_.empty()) {
+    // a broken cache only costs the benchmarks it would have saved
+    auto status = cudnn_conv_algo_cache_->Load(cudnn_conv_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Ignoring the cuDNN convolution algorithm cache: " << status.ErrorMessage();
+    }
+  }
+  if (enable_cuda_graph_) {
+#if CUDART_VERSION >= 10000
+    if (stream_ == nullptr) {
+      CUDA_CALL_THROW(cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking));
+      owns_stream_ = true;
+    }
+#else
+    ORT_THROW("CUDA graphs require CUDA 10.0 or later");
+#endif
+  }
 
   DeviceAllocatorRegistrationInfo default_allocator_info(
-      {OrtMemTypeDefault, [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
+      {OrtMemTypeDefault, [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max(), arena_config_});
   InsertAllocator(CreateAllocator(default_allocator_info, device_id_));
 
   DeviceAllocatorRegistrationInfo pinned_allocator_info(
@@ -81,6 +154,13 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
 }
 
 CUDAExecutionProvider::~CUDAExecutionProvider() {
+  if (!cudnn_conv_algo_cache_path_.empty()) {
+    auto status = cudnn_conv_algo_cache_->Save(cudnn_conv_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << status.ErrorMessage();
+    }
+  }
+
   auto cpu_alloc = GetAllocator(0, OrtMemTypeCPU);
   std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
   auto it = deferred_release_cpu_ptr_.begin();
@@ -95,7 +175,31 @@ CUDAExecutionProvider::~CUDAExecutionProvider() {
     CUDA_CALL_THROW(cudaEventDestroy(e));
     it = deferred_release_cpu_ptr_.erase(it);
   }
+#if CUDART_VERSION >= 10000
+  if (!graphs_.empty()) {
+    CUDA_CALL_THROW(cudaStreamSynchronize(stream_));
+    for (auto& entry : graphs_) {
+      CUDA_CALL_THROW(cudaGraphExecDestroy(entry.second.exec));
+      for (auto p : entry.second.cpu_ptrs) {
+        cpu_alloc->Free(p);
+      }
+    }
+  }
+#endif
+  for (auto& timing : kernel_timings_) {
+    DestroyTimingEvents({timing.start, timing.end, timing.copy.start, timing.copy.end});
+  }
   ReleasePerThreadStuffs();
+  if (owns_stream_) {
+    // the cuBLAS and cuDNN handles of the pooled contexts are bound to the stream
+    context_pool_.clear();
+    CUDA_CALL_THROW(cudaStreamDestroy(stream_));
+  }
+}
+
+uint64_t CUDAExecutionProvider::NextInstanceId() {
+  static std::atomic<uint64_t> next_instance_id{0};
+  return next_instance_id++;
 }
 
 CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadContext() const {
@@ -104,21 +208,21 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
   }
 
   auto* p = per_thread_context_map_.get();
-  if (p->count(this) == 0) {
+  if (p->count(instance_id_) == 0) {
     std::lock_guard<OrtMutex> lock(context_pool_mutex_);
     if (context_pool_.empty()) {
-      p->insert(std::make_pair(this, std::make_shared<PerThreadContext>(device_id_)));
+      p->insert(std::make_pair(instance_id_, std::make_shared<PerThreadContext>(device_id_, arena_per_thread_ ? &arena_config_ : nullptr, stream_)));
     } else {
-      p->insert(std::make_pair(this, context_pool_.back()));
+      p->insert(std::make_pair(instance_id_, context_pool_.back()));
       context_pool_.pop_back();
     }
   }
-  return *(p->at(this));
+  return *(p->at(instance_id_));
 }
 
 void CUDAExecutionProvider::ReleasePerThreadStuffs() const {
   if (per_thread_context_map_ != nullptr && !per_thread_context_map_->empty()) {
-    auto iter_ctx = per_thread_context_map_->find(this);
+    auto iter_ctx = per_thread_context_map_->find(instance_id_);
     if (iter_ctx != per_thread_context_map_->end()) {
       std::lock_guard<OrtMutex> lock(context_pool_mutex_);
       context_pool_.push_back(iter_ctx->second);
@@ -132,10 +236,10 @@ void CUDAExecutionProvider::ReleasePerThreadStuffs() const {
 }
 
 AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) const {
-  // Pinned memory allocator is shared between threads, but CUDA memory allocator is per-thread or it may cause result changes
-  // A hypothesis is that arena allocator is not aligned with CUDA output cache, and data from different kernel writes may
-  // cause cacheline to contain dirty data.
-  if (mem_type == OrtMemTypeDefault) {
+  // The shared device memory arena can be used by all the threads because the kernels of all of them are issued on
+  // the same stream: memory a thread frees while its kernels may still be reading it is reused by work queued on the
+  // stream after them, whichever thread queues it. The copies between the queues of a run are ordered by fences.
+  if (mem_type == OrtMemTypeDefault && arena_per_thread_) {
     return GetPerThreadContext().GetAllocator();
   } else {
     return IExecutionProvider::GetAllocator(id, mem_type);
@@ -143,21 +247,57 @@ AllocatorPtr CUDAExecutionProvider::GetAllocator(int id, OrtMemType mem_type) co
 }
 
 Status CUDAExecutionProvider::Sync() const {
-  CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
+  // with its own stream, the provider doesn't wait for the work of other CUDA users in the process
+  if (stream_ != nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream_));
+  } else {
+    CUDA_RETURN_IF_ERROR(cudaDeviceSynchronize());
+  }
+  return Status::OK();
+}
+
+Status CUDAExecutionProvider::GetGPUResource(OrtGPUResource resource, void** out) const {
+  switch (resource) {
+    case ORT_GPU_RESOURCE_COMPUTE_STREAM:
+      *out = stream_;
+      break;
+    case ORT_GPU_RESOURCE_CUBLAS_HANDLE:
+      *out = GetPerThreadContext().CublasHandle();
+      break;
+    case ORT_GPU_RESOURCE_CUDNN_HANDLE:
+      *out = GetPerThreadContext().CudnnHandle();
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unknown GPU resource ", static_cast<int>(resource));
+  }
   return Status::OK();
 }
 
 void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
-  // when not running in InferenceSession (e.g. Test)
-  // it's OK to not remember the deferred release ptr
-  // as the actual memory will be cleaned in arena allocator dtor
   auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
   if (current_deferred_release_event) {
     std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
     auto iter = deferred_release_cpu_ptr_.find(current_deferred_release_event);
     ORT_ENFORCE(iter != deferred_release_cpu_ptr_.end());
     iter->second.cpu_ptrs.push_back(p);
+    return;
   }
+
+  // A worker thread of the parallel executor, or a thread not running in InferenceSession (e.g. Test), has no event of
+  // a run, so the pointer is released after an event of its own, recorded once the kernel has queued the work using
+  // it. It's checked by the next run, or by the destructor.
+  cudaEvent_t event;
+  if (!CUDA_CALL(cudaEventCreate(&event, cudaEventDisableTiming))) {
+    return;
+  }
+  if (!CUDA_CALL(cudaEventRecord(event, stream_))) {
+    CUDA_CALL(cudaEventDestroy(event));
+    return;
+  }
+  std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+  auto& deferred_release = deferred_release_cpu_ptr_[event];
+  deferred_release.recorded = true;
+  deferred_release.cpu_ptrs.push_back(p);
 }
 
 Status CUDAExecutionProvider::OnRunStart() {
@@ -189,13 +329,203 @@ Status CUDAExecutionProvider::OnRunStart() {
 }
 
 Status CUDAExecutionProvider::OnRunEnd() {
-  // record deferred release event on default stream, and release per_thread_context
+  // record deferred release event on the stream of the provider, and release per_thread_context
   auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
-  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, nullptr));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, stream_));
   ReleasePerThreadStuffs();
-  std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
-  deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  {
+    std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+    deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  }
+
+  // record the device times of the kernels whose work has completed, the others are left for a later run
+  return ResolveKernelTimings(false);
+}
+
+bool CUDAExecutionProvider::IsGraphCaptureEnabled() const {
+  return enable_cuda_graph_;
+}
+
+bool CUDAExecutionProvider::IsGraphCaptured(const std::string& key) const {
+#if CUDART_VERSION >= 10000
+  std::lock_guard<OrtMutex> lock(graphs_mutex_);
+  return graphs_.count(key) != 0;
+#else
+  ORT_UNUSED_PARAMETER(key);
+  return false;
+#endif
+}
+
+Status CUDAExecutionProvider::BeginGraphCapture() {
+#if CUDART_VERSION >= 10000
+  ORT_RETURN_IF_NOT(enable_cuda_graph_, "CUDA graph capture isn't enabled");
+#if CUDART_VERSION >= 10010
+  // the memory arenas may allocate device memory while a run is captured, which the global mode forbids
+  CUDA_RETURN_IF_ERROR(cudaStreamBeginCapture(stream_, cudaStreamCaptureModeRelaxed));
+#else
+  CUDA_RETURN_IF_ERROR(cudaStreamBeginCapture(stream_));
+#endif
   return Status::OK();
+#else
+  return IExecutionProvider::BeginGraphCapture();
+#endif
+}
+
+Status CUDAExecutionProvider::EndGraphCapture(const std::string& key, bool keep) {
+#if CUDART_VERSION >= 10000
+  // the capture is ended even if it was invalidated, so that the stream can be used again
+  cudaGraph_t graph = nullptr;
+  cudaError_t result = cudaStreamEndCapture(stream_, &graph);
+  CapturedGraph captured;
+  if (result == cudaSuccess && keep) {
+    result = cudaGraphInstantiate(&captured.exec, graph, nullptr, nullptr, 0);
+  }
+  if (graph != nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaGraphDestroy(graph));
+  }
+  if (result != cudaSuccess) {
+    // clears the error, so that it isn't reported by the next CUDA call
+    cudaGetLastError();
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The run couldn't be captured into a CUDA graph: ",
+                           cudaGetErrorString(result));
+  }
+  if (!keep) {
+    return Status::OK();
+  }
+
+  // the pinned buffers that the run copied to the device are read again by each replay, so they are owned by the
+  // graph rather than released when the run ends
+  auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
+  if (current_deferred_release_event) {
+    std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+    auto iter = deferred_release_cpu_ptr_.find(current_deferred_release_event);
+    if (iter != deferred_release_cpu_ptr_.end()) {
+      captured.cpu_ptrs.swap(iter->second.cpu_ptrs);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(graphs_mutex_);
+  auto& entry = graphs_[key];
+  if (entry.exec != nullptr) {
+    // a replay of the previous graph may still be reading its buffers
+    captured.cpu_ptrs.insert(captured.cpu_ptrs.end(), entry.cpu_ptrs.begin(), entry.cpu_ptrs.end());
+    CUDA_RETURN_IF_ERROR(cudaGraphExecDestroy(entry.exec));
+  }
+  entry = std::move(captured);
+  return Status::OK();
+#else
+  return IExecutionProvider::EndGraphCapture(key, keep);
+#endif
+}
+
+Status CUDAExecutionProvider::ReplayGraph(const std::string& key) {
+#if CUDART_VERSION >= 10000
+  cudaGraphExec_t exec;
+  {
+    std::lock_guard<OrtMutex> lock(graphs_mutex_);
+    auto iter = graphs_.find(key);
+    ORT_RETURN_IF_NOT(iter != graphs_.end(), "No CUDA graph was captured for the run");
+    exec = iter->second.exec;
+  }
+  CUDA_RETURN_IF_ERROR(cudaGraphLaunch(exec, stream_));
+  return Status::OK();
+#else
+  return IExecutionProvider::ReplayGraph(key);
+#endif
+}
+
+void CUDAExecutionProvider::StartKernelTiming(const Node& node) const {
+  kernel_timing_stack_.emplace_back();
+  KernelTiming& timing = kernel_timing_stack_.back();
+  // events recorded while the work is captured into a graph can't be timed
+  if (cuda::IsCapturing(stream_)) {
+    return;
+  }
+
+  const bool is_memcpy = node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost";
+  if (!CUDA_CALL(cudaEventCreate(&timing.start)) || !CUDA_CALL(cudaEventCreate(&timing.end)) ||
+      (is_memcpy && (!CUDA_CALL(cudaEventCreate(&timing.copy.start)) ||
+                     !CUDA_CALL(cudaEventCreate(&timing.copy.end)))) ||
+      !CUDA_CALL(cudaEventRecord(timing.start, stream_))) {
+    DestroyTimingEvents({timing.start, timing.end, timing.copy.start, timing.copy.end});
+    timing = KernelTiming();
+    return;
+  }
+
+  if (is_memcpy) {
+    cuda::current_copy_timing = &timing.copy;
+  }
+}
+
+void CUDAExecutionProvider::EndKernelTiming(const Node& node, const TimePoint& start_time,
+                                            profiling::Profiler& profiler) const {
+  ORT_ENFORCE(!kernel_timing_stack_.empty(), "EndKernelTiming without StartKernelTiming for ", node.Name());
+  KernelTiming timing = std::move(kernel_timing_stack_.back());
+  kernel_timing_stack_.pop_back();
+  cuda::current_copy_timing = nullptr;
+  if (timing.start == nullptr) {
+    return;
+  }
+
+  if (!CUDA_CALL(cudaEventRecord(timing.end, stream_))) {
+    DestroyTimingEvents({timing.start, timing.end, timing.copy.start, timing.copy.end});
+    return;
+  }
+
+  timing.node_name = node.Name();
+  timing.op_type = node.OpType();
+  timing.start_time = start_time;
+  timing.thread_id = logging::GetThreadId();
+  timing.profiler = &profiler;
+  std::lock_guard<OrtMutex> lock(kernel_timings_mutex_);
+  kernel_timings_.push_back(std::move(timing));
+}
+
+Status CUDAExecutionProvider::FlushKernelTimings() const {
+  return ResolveKernelTimings(true);
+}
+
+Status CUDAExecutionProvider::ResolveKernelTimings(bool wait) const {
+  std::lock_guard<OrtMutex> lock(kernel_timings_mutex_);
+  Status status;
+  auto it = kernel_timings_.begin();
+  while (it != kernel_timings_.end()) {
+    KernelTiming& timing = *it;
+    if (!wait && (cudaEventQuery(timing.end) == cudaErrorNotReady ||
+                  (timing.copy.recorded && cudaEventQuery(timing.copy.end) == cudaErrorNotReady))) {
+      ++it;
+      continue;
+    }
+
+    // the timing is dropped if its work failed, with the first error returned
+    float device_ms = 0.0f;
+    float copy_ms = 0.0f;
+    bool resolved = CUDA_CALL(cudaEventSynchronize(timing.end)) &&
+                    CUDA_CALL(cudaEventElapsedTime(&device_ms, timing.start, timing.end));
+    if (resolved && timing.copy.recorded) {
+      resolved = CUDA_CALL(cudaEventSynchronize(timing.copy.end)) &&
+                 CUDA_CALL(cudaEventElapsedTime(&copy_ms, timing.copy.start, timing.copy.end));
+    }
+
+    if (!resolved) {
+      if (status.IsOK()) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to time node ", timing.node_name, " on the device");
+      }
+    } else if (timing.profiler->IsEnabled()) {
+      timing.profiler->RecordEvent(profiling::NODE_EVENT, timing.node_name + "_device_time", timing.start_time,
+                                   static_cast<long long>(device_ms * 1000), timing.thread_id,
+                                   {{"op_name", timing.op_type}, {"provider", Type()}});
+      if (timing.copy.recorded) {
+        timing.profiler->RecordEvent(profiling::NODE_EVENT, timing.node_name + "_copy_time", timing.start_time,
+                                     static_cast<long long>(copy_ms * 1000), timing.thread_id,
+                                     {{"op_name", timing.op_type}, {"provider", Type()}});
+      }
+    }
+
+    DestroyTimingEvents({timing.start, timing.end, timing.copy.start, timing.copy.end});
+    it = kernel_timings_.erase(it);
+  }
+  return status;
 }
 
 namespace cuda {
@@ -510,6 +840,10 @@ class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain,
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, Resize);
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 2, Split);
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, ConstantOfShape);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomNormal);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomUniform);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomNormalLike);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomUniformLike);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int8_t, Shrink);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int16_t, Shrink);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int32_t, Shrink);
@@ -533,6 +867,16 @@ class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain,
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, MLFloat16, Less);
 
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, Dropout);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, TopK);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, TopK);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, NonMaxSuppression);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, ConvInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearConv);
 
 static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
   static const BuildKernelCreateInfoFn function_table[] = {
@@ -847,6 +1191,10 @@ static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, Resize)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 2, Split)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, ConstantOfShape)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomNormal)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomUniform)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomNormalLike)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, RandomUniformLike)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int8_t, Shrink)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int16_t, Shrink)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, int32_t, Shrink)>,
@@ -869,6 +1217,16 @@ static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, float, Less)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, double, Less)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, MLFloat16, Less)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, TopK)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, TopK)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, NonMaxSuppression)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, ConvInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearConv)>,
   };
 
   for (auto& function_table_entry : function_table) {
@@ -993,7 +1351,7 @@ static bool CastNeedFallbackToCPU(const onnxruntime::Node& node) {
 }
 
 std::unique_ptr<onnxruntime::IDataTransfer> CUDAExecutionProvider::GetDataTransfer() const {
-  return std::make_unique<onnxruntime::GPUDataTransfer>();
+  return std::make_unique<onnxruntime::GPUDataTransfer>(stream_);
 }
 
 std::vector<std::unique_ptr<ComputeCapability>>
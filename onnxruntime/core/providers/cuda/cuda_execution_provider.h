@@ -8,6 +8,7 @@
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/cudnn_conv_algo_cache.h"
 #include "shared_inc/cuda_utils.h"
 #include <deque>
 
@@ -16,6 +17,23 @@ namespace onnxruntime {
 // Information needed to construct CUDA execution providers.
 struct CUDAExecutionProviderInfo {
   int device_id{0};
+  // Used for the device memory arenas.
+  ArenaConfig arena_config;
+  // Whether each thread running the provider's kernels gets its own device memory arena, instead of all of them
+  // sharing one. A per-thread arena only reuses the memory freed by its thread, so the memory of the provider grows
+  // with the number of threads running sessions.
+  bool arena_per_thread{false};
+  // The stream all the kernels, copies and cuBLAS and cuDNN calls of the provider are issued on, owned by the
+  // caller. nullptr for the legacy default stream, with separate streams for the copies in and out.
+  cudaStream_t stream{nullptr};
+  // Whether the runs of a session can be captured into CUDA graphs and replayed. Requires CUDA 10.0 or later. The
+  // provider creates its own stream if stream is nullptr, as the legacy default stream can't be captured.
+  bool enable_cuda_graph{false};
+  // How the convolution kernels choose their cuDNN algorithms.
+  cuda::CudnnConvAlgoSearch cudnn_conv_algo_search{cuda::CudnnConvAlgoSearch::Exhaustive};
+  // The file of benchmarked cuDNN convolution algorithms, loaded when the provider is created and saved with the
+  // algorithms it benchmarked when it's destroyed. Empty for none.
+  std::basic_string<ORTCHAR_T> cudnn_conv_algo_cache_path;
 };
 
 // Logical device representation.
@@ -32,6 +50,22 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status OnRunEnd() override;
 
+  bool IsGraphCaptureEnabled() const override;
+  bool IsGraphCaptured(const std::string& key) const override;
+  Status BeginGraphCapture() override;
+  Status EndGraphCapture(const std::string& key, bool keep) override;
+  Status ReplayGraph(const std::string& key) override;
+
+  // Times the kernels on the device with a pair of events on the stream of the provider, and the copies of the Memcpy
+  // nodes with a pair on the stream of the copy. The cuBLAS and cuDNN work of a kernel is issued on the stream of
+  // the provider, so it's included in its time. The timings are resolved at the end of the runs, once their work has
+  // completed, and recorded as "<node>_device_time" and "<node>_copy_time" events at the host time the kernel started.
+  void StartKernelTiming(const Node& node) const override;
+  void EndKernelTiming(const Node& node, const TimePoint& start_time, profiling::Profiler& profiler) const override;
+  Status FlushKernelTimings() const override;
+
+  Status GetGPUResource(OrtGPUResource resource, void** out) const override;
+
   cublasHandle_t PerThreadCublasHandle() {
     return GetPerThreadContext().CublasHandle();
   }
@@ -40,6 +74,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
     return GetPerThreadContext().CudnnHandle();
   }
 
+#if CUDART_VERSION >= 11000
+  cublasLtHandle_t PerThreadCublasLtHandle() {
+    return GetPerThreadContext().CublasLtHandle();
+  }
+#endif
+
   template <typename T>
   const T* GetConstOnes(size_t count) {
     return GetPerThreadContext().template GetConstOnes<T>(count);
@@ -64,8 +104,52 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   int GetDeviceId() const { return device_id_; }
 
+  // The stream the work of the provider is issued on, nullptr for the legacy default stream.
+  cudaStream_t GetStream() const { return stream_; }
+
+  cuda::CudnnConvAlgoSearch GetCudnnConvAlgoSearch() const { return cudnn_conv_algo_search_; }
+
+  // The cuDNN convolution algorithms benchmarked by the kernels of the provider.
+  cuda::CudnnConvAlgoCache& GetCudnnConvAlgoCache() { return *cudnn_conv_algo_cache_; }
+
  private:
   int device_id_;
+  ArenaConfig arena_config_;
+  bool arena_per_thread_;
+  cudaStream_t stream_;
+  bool owns_stream_ = false;
+  bool enable_cuda_graph_;
+  cuda::CudnnConvAlgoSearch cudnn_conv_algo_search_;
+  std::basic_string<ORTCHAR_T> cudnn_conv_algo_cache_path_;
+  std::unique_ptr<cuda::CudnnConvAlgoCache> cudnn_conv_algo_cache_;
+
+#if CUDART_VERSION >= 10000
+  struct CapturedGraph {
+    cudaGraphExec_t exec = nullptr;
+    // the pinned buffers the captured copies from the host read, which are released with the graph
+    std::vector<void*> cpu_ptrs;
+  };
+  std::unordered_map<std::string, CapturedGraph> graphs_;
+  mutable OrtMutex graphs_mutex_;
+#endif
+
+  struct KernelTiming {
+    std::string node_name;
+    std::string op_type;
+    TimePoint start_time;
+    int thread_id = 0;
+    profiling::Profiler* profiler = nullptr;
+    cudaEvent_t start = nullptr;
+    cudaEvent_t end = nullptr;
+    cuda::CopyTimingEvents copy;  // of Memcpy nodes
+  };
+  // Records the timings whose work has completed, or all of them, after waiting for their work, if wait is set.
+  Status ResolveKernelTimings(bool wait) const;
+  // the timings of the kernels whose work may not have completed yet, protected by kernel_timings_mutex_
+  mutable std::vector<KernelTiming> kernel_timings_;
+  mutable OrtMutex kernel_timings_mutex_;
+  // the timings started on this thread and not ended yet, innermost last, e.g. of the nodes of a subgraph
+  static thread_local std::vector<KernelTiming> kernel_timing_stack_;
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
@@ -76,7 +160,8 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   class PerThreadContext final {
    public:
-    PerThreadContext(int device_id);
+    // arena_config is used for the thread's device memory arena, nullptr if the thread uses the shared one.
+    PerThreadContext(int device_id, const ArenaConfig* arena_config, cudaStream_t stream);
     ~PerThreadContext();
 
     cublasHandle_t CublasHandle() const {
@@ -87,6 +172,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return cudnn_handle_;
     }
 
+#if CUDART_VERSION >= 11000
+    cublasLtHandle_t CublasLtHandle() const {
+      return cublas_lt_handle_;
+    }
+#endif
+
     cudaEvent_t& GetCurrentDeferredReleaseEvent() {
       return current_deferred_release_event_;
     }
@@ -120,6 +211,9 @@ class CUDAExecutionProvider : public IExecutionProvider {
    private:
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
+#if CUDART_VERSION >= 11000
+    cublasLtHandle_t cublas_lt_handle_ = nullptr;
+#endif
 
     // deferred release for temporary CPU pinned memory used in cudaMemcpyAsync
     // note that cudaEvent will be assigned at OnRunEnd() when PerThreadContext destory
@@ -133,9 +227,13 @@ class CUDAExecutionProvider : public IExecutionProvider {
     AllocatorPtr allocator_;
   };
 
-  // thread local context during execution
-  using PerThreadContextMap = std::unordered_map<const CUDAExecutionProvider*, std::shared_ptr<PerThreadContext>>;
+  // thread local context during execution, keyed by the instance id of the provider. The worker threads of the
+  // parallel executor keep theirs across runs, and unlike the address of the provider, its id isn't reused by a
+  // later provider, which mustn't pick up a context bound to the stream of a destroyed one.
+  using PerThreadContextMap = std::unordered_map<uint64_t, std::shared_ptr<PerThreadContext>>;
   static thread_local std::unique_ptr<PerThreadContextMap> per_thread_context_map_;
+  static uint64_t NextInstanceId();
+  const uint64_t instance_id_{NextInstanceId()};
 
   // reuse thread local context
   mutable std::deque<std::shared_ptr<PerThreadContext>> context_pool_;
@@ -8,6 +8,9 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <cublas_v2.h>
+#if CUDART_VERSION >= 11000
+#include <cublasLt.h>
+#endif
 #include <cusparse.h>
 #include <curand.h>
 #include <cudnn.h>
@@ -11,28 +11,81 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct CUDAProviderFactory : IExecutionProviderFactory {
-  CUDAProviderFactory(int device_id) : device_id_(device_id) {}
+  CUDAProviderFactory(const CUDAExecutionProviderInfo& info) : info_(info) {}
   ~CUDAProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  int device_id_;
+  CUDAExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CUDAProviderFactory::CreateProvider() {
-  CUDAExecutionProviderInfo info;
-  info.device_id = device_id_;
-  return std::make_unique<CUDAExecutionProvider>(info);
+  return std::make_unique<CUDAExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(const CUDAExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::CUDAProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id) {
-  return std::make_shared<onnxruntime::CUDAProviderFactory>(device_id);
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  return CreateExecutionProviderFactory_CUDA(info);
 }
 
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA, _In_ OrtSessionOptions* options, int device_id) {
-  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(device_id));
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.arena_config = options->value.arena_config;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithStream, _In_ OrtSessionOptions* options,
+                    int device_id, _In_ void* cuda_stream) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.arena_config = options->value.arena_config;
+  info.stream = static_cast<cudaStream_t>(cuda_stream);
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithGraphCapture, _In_ OrtSessionOptions* options,
+                    int device_id, _In_opt_ void* cuda_stream) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.arena_config = options->value.arena_config;
+  info.stream = static_cast<cudaStream_t>(cuda_stream);
+  info.enable_cuda_graph = true;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithConvAlgoCache, _In_ OrtSessionOptions* options,
+                    int device_id, _In_opt_ const ORTCHAR_T* cudnn_conv_algo_cache_path,
+                    int heuristic_conv_algo_search) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.arena_config = options->value.arena_config;
+  if (cudnn_conv_algo_cache_path != nullptr) {
+    info.cudnn_conv_algo_cache_path = cudnn_conv_algo_cache_path;
+  }
+  info.cudnn_conv_algo_search = heuristic_conv_algo_search != 0 ? cuda::CudnnConvAlgoSearch::Heuristic
+                                                                : cuda::CudnnConvAlgoSearch::Exhaustive;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CUDA_WithFloat16, _In_ OrtSessionOptions* options,
+                    int device_id) {
+  CUDAExecutionProviderInfo info;
+  info.device_id = device_id;
+  info.arena_config = options->value.arena_config;
+  options->value.enable_cuda_float16 = true;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CUDA(info));
   return nullptr;
 }
@@ -23,7 +23,7 @@ template <typename T>
 void Fill(T* output, T value, int64_t count) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
   CUDA_LONG N = static_cast<CUDA_LONG>(count);
-  _Fill<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(output, value, N);
+  _Fill<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(output, value, N);
 }
 
 template <typename T>
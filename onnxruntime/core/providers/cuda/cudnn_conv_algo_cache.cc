@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "cudnn_conv_algo_cache.h"
+#include "cuda_common.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace onnxruntime {
+namespace cuda {
+
+static const char* const kCacheFileHeader = "# onnxruntime cuDNN convolution algorithms";
+
+static void AppendDims(const char* name, const std::vector<int64_t>& dims, std::ostringstream& out) {
+  out << ' ' << name << '=';
+  for (size_t i = 0; i < dims.size(); ++i) {
+    out << (i == 0 ? "" : ",") << dims[i];
+  }
+}
+
+CudnnConvAlgoCache::CudnnConvAlgoCache(int device_id) {
+  cudaDeviceProp prop;
+  CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id));
+  std::ostringstream prefix;
+  prefix << "sm" << prop.major << prop.minor << " cudnn" << cudnnGetVersion() << ' ';
+  prefix_ = prefix.str();
+}
+
+std::string CudnnConvAlgoCache::MakeKey(const char* op, cudnnDataType_t data_type, const std::vector<int64_t>& x_dims,
+                                        const std::vector<int64_t>& w_dims, const std::vector<int64_t>& y_dims,
+                                        const std::vector<int64_t>& pads,
+                                        const std::vector<int64_t>& strides, const std::vector<int64_t>& dilations,
+                                        int64_t group) {
+  std::ostringstream key;
+  key << op << " type=" << static_cast<int>(data_type);
+  AppendDims("x", x_dims, key);
+  AppendDims("w", w_dims, key);
+  AppendDims("y", y_dims, key);
+  AppendDims("pads", pads, key);
+  AppendDims("strides", strides, key);
+  AppendDims("dilations", dilations, key);
+  key << " group=" << group;
+  return key.str();
+}
+
+bool CudnnConvAlgoCache::Lookup(const std::string& key, CudnnConvAlgoPerf& perf) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(prefix_ + key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  perf = it->second;
+  return true;
+}
+
+void CudnnConvAlgoCache::Insert(const std::string& key, const CudnnConvAlgoPerf& perf) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  entries_[prefix_ + key] = perf;
+  modified_ = true;
+}
+
+common::Status CudnnConvAlgoCache::Load(const std::basic_string<ORTCHAR_T>& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return common::Status::OK();
+  }
+
+  std::unordered_map<std::string, CudnnConvAlgoPerf> entries;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    // <key>\t<algo>\t<memory>\t<math type>
+    const auto tab = line.find('\t');
+    CudnnConvAlgoPerf perf;
+    std::istringstream values(tab == std::string::npos ? std::string() : line.substr(tab + 1));
+    if (!(values >> perf.algo >> perf.memory >> perf.math_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid cuDNN convolution algorithm cache, line ",
+                             line_number);
+    }
+    entries[line.substr(0, tab)] = perf;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  // the entries benchmarked by this process are more recent
+  for (auto& entry : entries_) {
+    entries[entry.first] = entry.second;
+  }
+  entries_.swap(entries);
+  return common::Status::OK();
+}
+
+common::Status CudnnConvAlgoCache::Save(const std::basic_string<ORTCHAR_T>& path) const {
+  std::ostringstream out;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (!modified_) {
+      return common::Status::OK();
+    }
+    out << kCacheFileHeader << '\n';
+    for (const auto& entry : entries_) {
+      out << entry.first << '\t' << entry.second.algo << '\t' << entry.second.memory << '\t'
+          << entry.second.math_type << '\n';
+    }
+  }
+
+  // written next to the file and renamed, so that a process loading it concurrently never reads part of it
+  auto temp_path = path;
+  temp_path += ORT_TSTR(".tmp");
+  {
+    std::ofstream file(temp_path, std::ios::out | std::ios::trunc);
+    file << out.str();
+    if (!file.flush()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the cuDNN convolution algorithm cache");
+    }
+  }
+#ifdef _WIN32
+  // _wrename doesn't replace an existing file
+  _wremove(path.c_str());
+  const bool renamed = _wrename(temp_path.c_str(), path.c_str()) == 0;
+#else
+  const bool renamed = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+  if (!renamed) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace the cuDNN convolution algorithm cache");
+  }
+  return common::Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "cuda_pch.h"
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace onnxruntime {
+namespace cuda {
+
+// How the convolution kernels choose the cuDNN algorithm of a shape they haven't run before.
+enum class CudnnConvAlgoSearch {
+  // benchmarks the algorithms with cudnnFind*AlgorithmEx, which finds the fastest one but takes up to seconds
+  Exhaustive,
+  // takes the algorithm ranked first by the cudnnGet*Algorithm_v7 heuristics, without running any
+  Heuristic,
+};
+
+struct CudnnConvAlgoPerf {
+  int algo;
+  size_t memory;
+  int math_type;
+};
+
+/**
+ * The cuDNN algorithms benchmarked by the convolution kernels of an execution provider, so that the kernels of
+ * other sessions, and of other processes through a file, don't benchmark the same convolutions again.
+ *
+ * The entries are keyed by the SM version of the device, the cuDNN version, and the parameters and shapes of the
+ * convolution, so a file can be shared by processes on different devices: each only uses the entries of its own.
+ */
+class CudnnConvAlgoCache {
+ public:
+  explicit CudnnConvAlgoCache(int device_id);
+  CudnnConvAlgoCache(const CudnnConvAlgoCache&) = delete;
+  CudnnConvAlgoCache& operator=(const CudnnConvAlgoCache&) = delete;
+
+  // The key of a convolution, without the device and cuDNN version. op distinguishes the forward and backward
+  // algorithms. The dims are the ones given to cuDNN. y_dims is part of the key as a transposed convolution's
+  // output shape isn't a function of the other parameters.
+  static std::string MakeKey(const char* op, cudnnDataType_t data_type, const std::vector<int64_t>& x_dims,
+                             const std::vector<int64_t>& w_dims, const std::vector<int64_t>& y_dims,
+                             const std::vector<int64_t>& pads,
+                             const std::vector<int64_t>& strides, const std::vector<int64_t>& dilations,
+                             int64_t group);
+
+  bool Lookup(const std::string& key, CudnnConvAlgoPerf& perf) const;
+  void Insert(const std::string& key, const CudnnConvAlgoPerf& perf);
+
+  // Adds the entries of a file written by Save. A missing file is an empty cache.
+  common::Status Load(const std::basic_string<ORTCHAR_T>& path);
+
+  // Writes all the entries, including the ones of other devices that were loaded, if any were added since the
+  // cache was created. The file is replaced by renaming a new one, so concurrent processes can share it.
+  common::Status Save(const std::basic_string<ORTCHAR_T>& path) const;
+
+ private:
+  std::string prefix_;  // the device and cuDNN version
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, CudnnConvAlgoPerf> entries_;  // protected by mutex_
+  bool modified_ = false;                                       // protected by mutex_
+};
+
+// The first algorithm that can run of the ones ranked by a cudnnGet*Algorithm_v7 heuristic.
+template <typename AlgoPerfType>
+common::Status FirstSupportedAlgo(const AlgoPerfType* perfs, int count, AlgoPerfType& perf) {
+  for (int i = 0; i < count; ++i) {
+    if (perfs[i].status == CUDNN_STATUS_SUCCESS) {
+      perf = perfs[i];
+      return common::Status::OK();
+    }
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "cuDNN has no algorithm for the convolution");
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "random.h"
+#include "random_impl.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace cuda {
+
+static const std::vector<MLDataType> randomOutputTypeConstraints{
+    DataTypeImpl::GetTensorType<float>(),
+    DataTypeImpl::GetTensorType<double>(),
+    DataTypeImpl::GetTensorType<MLFloat16>()};
+
+ONNX_OPERATOR_KERNEL_EX(
+    RandomNormal,
+    kOnnxDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", randomOutputTypeConstraints),
+    RandomNormal);
+
+ONNX_OPERATOR_KERNEL_EX(
+    RandomUniform,
+    kOnnxDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", randomOutputTypeConstraints),
+    RandomUniform);
+
+ONNX_OPERATOR_KERNEL_EX(
+    RandomNormalLike,
+    kOnnxDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::AllTensorTypes()).TypeConstraint("T2", randomOutputTypeConstraints),
+    RandomNormalLike);
+
+ONNX_OPERATOR_KERNEL_EX(
+    RandomUniformLike,
+    kOnnxDomain,
+    1,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::AllTensorTypes()).TypeConstraint("T2", randomOutputTypeConstraints),
+    RandomUniformLike);
+
+static TensorProto::DataType InferDataType(const Tensor& tensor) {
+  auto tensor_type = tensor.DataType();
+  if (tensor_type == DataTypeImpl::GetType<float>())
+    return TensorProto_DataType_FLOAT;
+  if (tensor_type == DataTypeImpl::GetType<double>())
+    return TensorProto_DataType_DOUBLE;
+  if (tensor_type == DataTypeImpl::GetType<MLFloat16>())
+    return TensorProto_DataType_FLOAT16;
+  return TensorProto_DataType_UNDEFINED;
+}
+
+template <typename T>
+static void RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, Tensor& Y) {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const size_t N = Y.Shape().Size();
+  const uint64_t first_counter = generator.ReserveCounters(PhiloxCounterCount<CudaT>(N));
+  RandomNormalImpl<CudaT>(generator.Seed(), first_counter, mean, scale,
+                          reinterpret_cast<CudaT*>(Y.template MutableData<T>()), N);
+}
+
+template <typename T>
+static void RandomUniformCompute(float low, float high, PhiloxGenerator& generator, Tensor& Y) {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const size_t N = Y.Shape().Size();
+  const uint64_t first_counter = generator.ReserveCounters(PhiloxCounterCount<CudaT>(N));
+  RandomUniformImpl<CudaT>(generator.Seed(), first_counter, low, high,
+                           reinterpret_cast<CudaT*>(Y.template MutableData<T>()), N);
+}
+
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                  Tensor& Y) {
+  switch (dtype) {
+    case TensorProto::FLOAT:
+      RandomNormalCompute<float>(mean, scale, generator, Y);
+      break;
+    case TensorProto::DOUBLE:
+      RandomNormalCompute<double>(mean, scale, generator, Y);
+      break;
+    case TensorProto::FLOAT16:
+      RandomNormalCompute<MLFloat16>(mean, scale, generator, Y);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid data type of ", dtype);
+  }
+  return Status::OK();
+}
+
+static Status RandomUniformCompute(float low, float high, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                   Tensor& Y) {
+  switch (dtype) {
+    case TensorProto::FLOAT:
+      RandomUniformCompute<float>(low, high, generator, Y);
+      break;
+    case TensorProto::DOUBLE:
+      RandomUniformCompute<double>(low, high, generator, Y);
+      break;
+    case TensorProto::FLOAT16:
+      RandomUniformCompute<MLFloat16>(low, high, generator, Y);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid data type of ", dtype);
+  }
+  return Status::OK();
+}
+
+Status RandomNormal::ComputeInternal(OpKernelContext* ctx) const {
+  Tensor& Y = *ctx->Output(0, shape_);
+  return RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+}
+
+Status RandomUniform::ComputeInternal(OpKernelContext* ctx) const {
+  Tensor& Y = *ctx->Output(0, shape_);
+  return RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+}
+
+Status RandomNormalLike::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor& X = *ctx->Input<Tensor>(0);
+  Tensor& Y = *ctx->Output(0, X.Shape());
+  auto dtype = dtype_ != TensorProto_DataType_UNDEFINED ? dtype_ : InferDataType(X);
+  return RandomNormalCompute(mean_, scale_, generator_, dtype, Y);
+}
+
+Status RandomUniformLike::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor& X = *ctx->Input<Tensor>(0);
+  Tensor& Y = *ctx->Output(0, X.Shape());
+  auto dtype = dtype_ != TensorProto_DataType_UNDEFINED ? dtype_ : InferDataType(X);
+  return RandomUniformCompute(low_, high_, generator_, dtype, Y);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
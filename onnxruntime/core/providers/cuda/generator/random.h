@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/generator/random.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The CUDA kernels generate the same values as the CPU kernels for float and double, and compute half values in
+// float. See the CPU kernels for the attributes.
+class RandomNormal final : public CudaKernel {
+ public:
+  RandomNormal(const OpKernelInfo& info) : CudaKernel(info), generator_(GetRandomSeed(info)) {
+    ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
+    ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
+
+    int64_t dtype;
+    ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
+    dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
+
+    std::vector<int64_t> shape;
+    ORT_ENFORCE(info.GetAttrs<int64_t>("shape", shape).IsOK());
+    shape_ = TensorShape(shape);
+  }
+
+  Status ComputeInternal(OpKernelContext* ctx) const override;
+
+ private:
+  float mean_;
+  float scale_;
+  mutable PhiloxGenerator generator_;
+  ONNX_NAMESPACE::TensorProto::DataType dtype_;
+  TensorShape shape_;
+};
+
+class RandomNormalLike final : public CudaKernel {
+ public:
+  RandomNormalLike(const OpKernelInfo& info) : CudaKernel(info), generator_(GetRandomSeed(info)) {
+    ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
+    ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
+
+    int64_t dtype;
+    if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
+      dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
+    }
+  }
+
+  Status ComputeInternal(OpKernelContext* ctx) const override;
+
+ private:
+  float mean_;
+  float scale_;
+  mutable PhiloxGenerator generator_;
+  ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  //optional and may be inferred
+};
+
+class RandomUniform final : public CudaKernel {
+ public:
+  RandomUniform(const OpKernelInfo& info) : CudaKernel(info), generator_(GetRandomSeed(info)) {
+    ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
+    ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
+
+    int64_t dtype;
+    ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
+    dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
+
+    std::vector<int64_t> shape;
+    ORT_ENFORCE(info.GetAttrs<int64_t>("shape", shape).IsOK());
+    shape_ = TensorShape(shape);
+  }
+
+  Status ComputeInternal(OpKernelContext* ctx) const override;
+
+ private:
+  float high_;
+  float low_;
+  mutable PhiloxGenerator generator_;
+  ONNX_NAMESPACE::TensorProto::DataType dtype_;
+  TensorShape shape_;
+};
+
+class RandomUniformLike final : public CudaKernel {
+ public:
+  RandomUniformLike(const OpKernelInfo& info) : CudaKernel(info), generator_(GetRandomSeed(info)) {
+    ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
+    ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
+
+    int64_t dtype;
+    if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
+      dtype_ = static_cast<ONNX_NAMESPACE::TensorProto::DataType>(dtype);
+    }
+  }
+
+  Status ComputeInternal(OpKernelContext* ctx) const override;
+
+ private:
+  float high_;
+  float low_;
+  mutable PhiloxGenerator generator_;
+  ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  //optional and may be inferred
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
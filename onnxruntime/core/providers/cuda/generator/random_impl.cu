@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cpu/generator/philox.h"
+#include "random_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The values are computed in float for half, and in T otherwise
+template <typename T>
+struct RandomComputeType {
+  typedef T type;
+};
+
+template <>
+struct RandomComputeType<half> {
+  typedef float type;
+};
+
+// Each thread computes the values of one Philox block, which are the same values as the CPU kernels compute.
+template <typename T>
+__global__ void _RandomNormalKernel(uint64_t seed,
+                                    uint64_t first_counter,
+                                    typename RandomComputeType<T>::type mean,
+                                    typename RandomComputeType<T>::type scale,
+                                    T* output_data,
+                                    const CUDA_LONG num_blocks,
+                                    const CUDA_LONG N) {
+  typedef typename RandomComputeType<T>::type U;
+  constexpr int values_per_block = PhiloxUniform<U>::kValuesPerBlock;
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, num_blocks);
+  U uniforms[values_per_block];
+  PhiloxUniform<U>::Generate(seed, first_counter + id, uniforms);
+
+  // Box-Muller transform of each pair of uniform values
+  const CUDA_LONG first = id * values_per_block;
+  for (int i = 0; i < values_per_block && first + i < N; i += 2) {
+    const U radius = _Sqrt(U(-2) * _Log(U(1) - uniforms[i])) * scale;
+    const U angle = U(2 * M_PI) * uniforms[i + 1];
+    output_data[first + i] = T(mean + radius * cos(angle));
+    if (first + i + 1 < N) {
+      output_data[first + i + 1] = T(mean + radius * sin(angle));
+    }
+  }
+}
+
+template <typename T>
+__global__ void _RandomUniformKernel(uint64_t seed,
+                                     uint64_t first_counter,
+                                     typename RandomComputeType<T>::type low,
+                                     typename RandomComputeType<T>::type range,
+                                     T* output_data,
+                                     const CUDA_LONG num_blocks,
+                                     const CUDA_LONG N) {
+  typedef typename RandomComputeType<T>::type U;
+  constexpr int values_per_block = PhiloxUniform<U>::kValuesPerBlock;
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, num_blocks);
+  U uniforms[values_per_block];
+  PhiloxUniform<U>::Generate(seed, first_counter + id, uniforms);
+
+  const CUDA_LONG first = id * values_per_block;
+  for (int i = 0; i < values_per_block && first + i < N; ++i) {
+    output_data[first + i] = T(uniforms[i] * range + low);
+  }
+}
+
+template <typename T>
+int64_t PhiloxCounterCount(size_t N) {
+  const size_t values_per_block = PhiloxUniform<typename RandomComputeType<T>::type>::kValuesPerBlock;
+  return static_cast<int64_t>((N + values_per_block - 1) / values_per_block);
+}
+
+template <typename T>
+void RandomNormalImpl(uint64_t seed, uint64_t first_counter, float mean, float scale, T* output_data, size_t N) {
+  typedef typename RandomComputeType<T>::type U;
+  const CUDA_LONG num_blocks = static_cast<CUDA_LONG>(PhiloxCounterCount<T>(N));
+  int blocksPerGrid = (int)(ceil(static_cast<float>(num_blocks) / GridDim::maxThreadsPerBlock));
+  _RandomNormalKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      seed, first_counter, static_cast<U>(mean), static_cast<U>(scale), output_data, num_blocks, (CUDA_LONG)N);
+}
+
+template <typename T>
+void RandomUniformImpl(uint64_t seed, uint64_t first_counter, float low, float high, T* output_data, size_t N) {
+  typedef typename RandomComputeType<T>::type U;
+  const CUDA_LONG num_blocks = static_cast<CUDA_LONG>(PhiloxCounterCount<T>(N));
+  int blocksPerGrid = (int)(ceil(static_cast<float>(num_blocks) / GridDim::maxThreadsPerBlock));
+  _RandomUniformKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      seed, first_counter, static_cast<U>(low), static_cast<U>(high) - static_cast<U>(low), output_data, num_blocks,
+      (CUDA_LONG)N);
+}
+
+#define SPECIALIZED_IMPL(T)                                                                                         \
+  template int64_t PhiloxCounterCount<T>(size_t N);                                                                 \
+  template void RandomNormalImpl<T>(uint64_t seed, uint64_t first_counter, float mean, float scale, T* output_data, \
+                                    size_t N);                                                                      \
+  template void RandomUniformImpl<T>(uint64_t seed, uint64_t first_counter, float low, float high, T* output_data,  \
+                                     size_t N);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Number of Philox counters used for N values of type T. half values are generated as float.
+template <typename T>
+int64_t PhiloxCounterCount(size_t N);
+
+template <typename T>
+void RandomNormalImpl(uint64_t seed, uint64_t first_counter, float mean, float scale, T* output_data, size_t N);
+
+template <typename T>
+void RandomUniformImpl(uint64_t seed, uint64_t first_counter, float low, float high, T* output_data, size_t N);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -3,9 +3,53 @@
 
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
+#include <algorithm>
+#include <set>
 
 namespace onnxruntime {
-GPUDataTransfer::GPUDataTransfer() {
+
+// Pageable memory is copied through two pinned buffers of this size.
+static constexpr size_t kStagingBufferBytes = 4 * 1024 * 1024;
+
+// Lets device access the memory of peer_device, if it can, so that copies between them don't go through the host.
+static Status EnablePeerAccess(int device, int peer_device) {
+  static OrtMutex mutex;
+  static std::set<std::pair<int, int>> checked_pairs;  // protected by mutex
+  std::lock_guard<OrtMutex> lock(mutex);
+  if (!checked_pairs.insert(std::make_pair(device, peer_device)).second) {
+    return Status::OK();
+  }
+
+  int can_access = 0;
+  CUDA_RETURN_IF_ERROR(cudaDeviceCanAccessPeer(&can_access, device, peer_device));
+  if (can_access == 0) {
+    return Status::OK();
+  }
+
+  // peer access is enabled for the current device
+  int current_device;
+  CUDA_RETURN_IF_ERROR(cudaGetDevice(&current_device));
+  CUDA_RETURN_IF_ERROR(cudaSetDevice(device));
+  const cudaError_t result = cudaDeviceEnablePeerAccess(peer_device, 0);
+  CUDA_RETURN_IF_ERROR(cudaSetDevice(current_device));
+  if (result == cudaErrorPeerAccessAlreadyEnabled) {
+    // e.g. by the application, which isn't an error
+    cudaGetLastError();
+    return Status::OK();
+  }
+  CUDA_RETURN_IF_ERROR(result);
+  return Status::OK();
+}
+
+GPUDataTransfer::GPUDataTransfer(cudaStream_t stream) : owns_copy_streams_(stream == nullptr) {
+  if (stream != nullptr) {
+    // all the copies are ordered with the kernels on the given stream
+    for (auto& s : streams_) {
+      s = stream;
+    }
+    return;
+  }
+
   // create streams, default is nullptr
   streams_[kCudaStreamDefault] = nullptr;
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyIn], cudaStreamNonBlocking));
@@ -13,8 +57,19 @@ GPUDataTransfer::GPUDataTransfer() {
 }
 
 GPUDataTransfer::~GPUDataTransfer() {
-  CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
-  CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyOut]));
+  if (owns_copy_streams_) {
+    CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyIn]));
+    CUDA_CALL(cudaStreamDestroy(streams_[kCudaStreamCopyOut]));
+  }
+  for (auto& buffer : staging_buffers_) {
+    if (buffer.copied != nullptr) {
+      CUDA_CALL(cudaEventSynchronize(buffer.copied));
+      CUDA_CALL(cudaEventDestroy(buffer.copied));
+    }
+    if (buffer.data != nullptr) {
+      CUDA_CALL(cudaFreeHost(buffer.data));
+    }
+  }
 }
 
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
@@ -23,6 +78,80 @@ bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_
 }
 
 common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const {
+  // a Memcpy node of a profiled session is timed on the stream of its copy
+  cuda::CopyTimingEvents* timing = cuda::CurrentCopyTiming();
+  if (timing != nullptr) {
+    if (!timing->recorded) {
+      CUDA_RETURN_IF_ERROR(cudaEventRecord(timing->start, streams_[exec_queue_id]));
+    }
+    ORT_RETURN_IF_ERROR(CopyTensorImpl(src, dst, exec_queue_id));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(timing->end, streams_[exec_queue_id]));
+    timing->recorded = true;
+    return Status::OK();
+  }
+  return CopyTensorImpl(src, dst, exec_queue_id);
+}
+
+// Returns whether the copy goes through the staging buffers, and in which direction.
+static bool IsStagedCopy(const Tensor& src, const Tensor& dst, bool& to_device) {
+  auto& src_device = src.Location().device;
+  auto& dst_device = dst.Location().device;
+  auto is_pageable = [](const OrtDevice& device) {
+    return device.Type() == OrtDevice::CPU && device.MemType() != OrtDevice::MemType::CUDA_PINNED;
+  };
+  to_device = dst_device.Type() == OrtDevice::GPU;
+  return to_device ? is_pageable(src_device) : src_device.Type() == OrtDevice::GPU && is_pageable(dst_device);
+}
+
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const {
+  if (src_dst_pairs.empty()) {
+    return Status::OK();
+  }
+
+  // the staged copies of each stream, in order
+  std::vector<const SrcDstPair*> to_device[kTotalCudaStreams];
+  std::vector<const SrcDstPair*> from_device[kTotalCudaStreams];
+
+  auto copy = [&]() -> Status {
+    for (const auto& pair : src_dst_pairs) {
+      const Tensor& src = pair.src;
+      Tensor& dst = pair.dst;
+      bool is_to_device = false;
+      if (src.SizeInBytes() <= kStagingBufferBytes && IsStagedCopy(src, dst, is_to_device) &&
+          !cuda::IsCapturing(streams_[pair.exec_queue_id])) {
+        (is_to_device ? to_device : from_device)[pair.exec_queue_id].push_back(&pair);
+      } else {
+        ORT_RETURN_IF_ERROR(CopyTensorImpl(src, dst, pair.exec_queue_id));
+      }
+    }
+
+    for (int queue_id = 0; queue_id < kTotalCudaStreams; ++queue_id) {
+      if (!to_device[queue_id].empty()) {
+        ORT_RETURN_IF_ERROR(StageToDevice(to_device[queue_id], streams_[queue_id]));
+      }
+      if (!from_device[queue_id].empty()) {
+        ORT_RETURN_IF_ERROR(StageFromDevice(from_device[queue_id], streams_[queue_id]));
+      }
+    }
+    return Status::OK();
+  };
+
+  // a Memcpy node of a profiled session is timed on the stream of its copies
+  cuda::CopyTimingEvents* timing = cuda::CurrentCopyTiming();
+  if (timing != nullptr) {
+    cudaStream_t stream = streams_[src_dst_pairs.front().exec_queue_id];
+    if (!timing->recorded) {
+      CUDA_RETURN_IF_ERROR(cudaEventRecord(timing->start, stream));
+    }
+    ORT_RETURN_IF_ERROR(copy());
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(timing->end, stream));
+    timing->recorded = true;
+    return Status::OK();
+  }
+  return copy();
+}
+
+common::Status GPUDataTransfer::CopyTensorImpl(const Tensor& src, Tensor& dst, int exec_queue_id) const {
   size_t bytes = src.SizeInBytes();
   const void* src_data = src.DataRaw();
   void* dst_data = dst.MutableDataRaw();
@@ -34,20 +163,35 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
     if (src_device.Type() == OrtDevice::CPU && src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copy from pinned memory to GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+    } else if (src_device.Type() == OrtDevice::GPU && src_device.Id() != dst_device.Id()) {
+      // copying between GPUs, directly if the destination can access the source, this is non-blocking
+      ORT_RETURN_IF_ERROR(EnablePeerAccess(dst_device.Id(), src_device.Id()));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyPeerAsync(dst_data, dst_device.Id(), src_data, src_device.Id(), bytes,
+                                               streams_[kCudaStreamDefault]));
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
+    } else if (cuda::IsCapturing(streams_[exec_queue_id])) {
+      // the staging buffers would be reused before the graph is replayed. Synchronizing fails the capture, and the
+      // run is executed without a graph.
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[exec_queue_id]));
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU through pinned memory, this is non-blocking once the data is staged
+      ORT_RETURN_IF_ERROR(StageToDevice(dst_data, src_data, bytes, streams_[exec_queue_id]));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copying from GPU to pinned memory, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
+    } else if (cuda::IsCapturing(streams_[exec_queue_id])) {
+      // copying from GPU to CPU memory, this is blocking, which fails the capture
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[exec_queue_id]));
     } else {
-      // copying from GPU to CPU memory, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+      // copying from GPU to CPU memory through pinned memory, this is blocking, after the kernels on the stream
+      // that wrote the source
+      ORT_RETURN_IF_ERROR(StageFromDevice(dst_data, src_data, bytes, streams_[exec_queue_id]));
     }
   } else {
     // copying between cpu memory
@@ -57,4 +201,172 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
   return Status::OK();
 }
 
+Status GPUDataTransfer::AllocateStagingBuffers() const {
+  for (auto& buffer : staging_buffers_) {
+    if (buffer.data == nullptr) {
+      // portable, as the threads copying may have another device current
+      CUDA_RETURN_IF_ERROR(cudaHostAlloc(&buffer.data, kStagingBufferBytes, cudaHostAllocPortable));
+    }
+    if (buffer.copied == nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&buffer.copied, cudaEventDisableTiming));
+    }
+  }
+  return Status::OK();
+}
+
+Status GPUDataTransfer::StageToDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(AllocateStagingBuffers());
+
+  for (size_t offset = 0; offset < bytes; offset += kStagingBufferBytes) {
+    const size_t chunk_bytes = std::min(bytes - offset, kStagingBufferBytes);
+    auto& buffer = staging_buffers_[next_staging_buffer_];
+    next_staging_buffer_ = (next_staging_buffer_ + 1) % 2;
+
+    // the chunk previously staged in the buffer was copied to the device
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copied));
+    memcpy(buffer.data, static_cast<const char*>(src) + offset, chunk_bytes);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, buffer.data, chunk_bytes,
+                                         cudaMemcpyHostToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copied, stream));
+  }
+  return Status::OK();
+}
+
+Status GPUDataTransfer::StageFromDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(AllocateStagingBuffers());
+
+  // the chunk copied to a buffer, which is copied to dst while the next one is copied from the device
+  const StagingBuffer* pending = nullptr;
+  size_t pending_offset = 0;
+  size_t pending_bytes = 0;
+  auto copy_pending = [&]() -> Status {
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(pending->copied));
+    memcpy(static_cast<char*>(dst) + pending_offset, pending->data, pending_bytes);
+    return Status::OK();
+  };
+
+  for (size_t offset = 0; offset < bytes; offset += kStagingBufferBytes) {
+    const size_t chunk_bytes = std::min(bytes - offset, kStagingBufferBytes);
+    auto& buffer = staging_buffers_[next_staging_buffer_];
+    next_staging_buffer_ = (next_staging_buffer_ + 1) % 2;
+
+    // a chunk staged in the buffer by a copy to the device on another stream may not have been copied yet
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copied));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(buffer.data, static_cast<const char*>(src) + offset, chunk_bytes,
+                                         cudaMemcpyDeviceToHost, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copied, stream));
+
+    if (pending != nullptr) {
+      ORT_RETURN_IF_ERROR(copy_pending());
+    }
+    pending = &buffer;
+    pending_offset = offset;
+    pending_bytes = chunk_bytes;
+  }
+
+  if (pending != nullptr) {
+    ORT_RETURN_IF_ERROR(copy_pending());
+  }
+  return Status::OK();
+}
+
+// Offsets of the copies in a staging buffer are aligned like the allocations of the device.
+static size_t StagingOffset(size_t offset) {
+  constexpr size_t alignment = 256;
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+Status GPUDataTransfer::StageToDevice(const std::vector<const SrcDstPair*>& copies, cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(AllocateStagingBuffers());
+
+  StagingBuffer* buffer = nullptr;
+  size_t offset = 0;
+  for (const SrcDstPair* copy : copies) {
+    const Tensor& src = copy->src;
+    Tensor& dst = copy->dst;
+    const size_t bytes = src.SizeInBytes();
+    if (buffer == nullptr || StagingOffset(offset) + bytes > kStagingBufferBytes) {
+      if (buffer != nullptr) {
+        CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer->copied, stream));
+      }
+      buffer = &staging_buffers_[next_staging_buffer_];
+      next_staging_buffer_ = (next_staging_buffer_ + 1) % 2;
+      // the copies previously staged in the buffer were copied to the device
+      CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer->copied));
+      offset = 0;
+    }
+
+    char* staged = static_cast<char*>(buffer->data) + StagingOffset(offset);
+    memcpy(staged, src.DataRaw(), bytes);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst.MutableDataRaw(), staged, bytes, cudaMemcpyHostToDevice, stream));
+    offset = StagingOffset(offset) + bytes;
+  }
+
+  if (buffer != nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer->copied, stream));
+  }
+  return Status::OK();
+}
+
+Status GPUDataTransfer::StageFromDevice(const std::vector<const SrcDstPair*>& copies, cudaStream_t stream) const {
+  std::lock_guard<OrtMutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(AllocateStagingBuffers());
+
+  // the copies to a buffer, which are copied to their destinations while the next buffer is filled
+  struct StagedCopies {
+    const StagingBuffer* buffer = nullptr;
+    std::vector<std::pair<const SrcDstPair*, size_t>> copies;  // with their offset in the buffer
+  };
+  StagedCopies pending;
+  StagedCopies current;
+  auto copy_pending = [&pending]() -> Status {
+    if (pending.buffer != nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaEventSynchronize(pending.buffer->copied));
+      for (const auto& staged : pending.copies) {
+        Tensor& dst = staged.first->dst;
+        memcpy(dst.MutableDataRaw(), static_cast<const char*>(pending.buffer->data) + staged.second,
+               dst.SizeInBytes());
+      }
+    }
+    pending = StagedCopies();
+    return Status::OK();
+  };
+
+  size_t offset = 0;
+  for (const SrcDstPair* copy : copies) {
+    const Tensor& src = copy->src;
+    const size_t bytes = src.SizeInBytes();
+    if (current.buffer == nullptr || StagingOffset(offset) + bytes > kStagingBufferBytes) {
+      if (current.buffer != nullptr) {
+        CUDA_RETURN_IF_ERROR(cudaEventRecord(current.buffer->copied, stream));
+        ORT_RETURN_IF_ERROR(copy_pending());
+        pending = std::move(current);
+        current = StagedCopies();
+      }
+      auto& buffer = staging_buffers_[next_staging_buffer_];
+      next_staging_buffer_ = (next_staging_buffer_ + 1) % 2;
+      // copies staged in the buffer by a copy to the device on another stream may not have been copied yet
+      CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copied));
+      current.buffer = &buffer;
+      offset = 0;
+    }
+
+    offset = StagingOffset(offset);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(current.buffer->data) + offset, src.DataRaw(), bytes,
+                                         cudaMemcpyDeviceToHost, stream));
+    current.copies.emplace_back(copy, offset);
+    offset += bytes;
+  }
+
+  if (current.buffer != nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(current.buffer->copied, stream));
+  }
+  ORT_RETURN_IF_ERROR(copy_pending());
+  pending = std::move(current);
+  return copy_pending();
+}
+
 }  // namespace onnxruntime
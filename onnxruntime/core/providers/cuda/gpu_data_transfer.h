@@ -5,6 +5,7 @@
 
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -17,20 +18,49 @@ enum CUDAStreamType : int {
 
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer();
+  // Copies on stream if it's not nullptr, otherwise on the legacy default stream and on streams of its own for the
+  // copies in and out.
+  explicit GPUDataTransfer(cudaStream_t stream = nullptr);
   ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
 
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const override;
 
+  // Packs the small copies between pageable host memory and the device into the staging buffers, so that they
+  // share the staging buffer fences, and a batch of copies to the host waits for the device once.
+  common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override;
+
   cudaStream_t GetStream(int queue_id) const {
     ORT_ENFORCE(queue_id >= 0 && queue_id < kTotalCudaStreams);
     return streams_[queue_id];
   }
 
  private:
+  common::Status CopyTensorImpl(const Tensor& src, Tensor& dst, int exec_queue_id) const;
+
+  // Copies between pageable host memory and the device through the staging buffers, a chunk at a time, so that
+  // the host copy of a chunk overlaps with the device copy of the previous one.
+  // A copy to the device returns once its last chunk is staged, a copy to the host once the data is in dst.
+  common::Status StageToDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+  common::Status StageFromDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+  // Same for several copies, each of which fits in a staging buffer.
+  common::Status StageToDevice(const std::vector<const SrcDstPair*>& copies, cudaStream_t stream) const;
+  common::Status StageFromDevice(const std::vector<const SrcDstPair*>& copies, cudaStream_t stream) const;
+  common::Status AllocateStagingBuffers() const;  // requires staging_mutex_
+
   cudaStream_t streams_[kTotalCudaStreams];
+  bool owns_copy_streams_;
+
+  struct StagingBuffer {
+    void* data = nullptr;          // pinned
+    cudaEvent_t copied = nullptr;  // recorded after the last device copy from or to data
+  };
+
+  // allocated on the first copy of pageable memory
+  mutable OrtMutex staging_mutex_;
+  mutable StagingBuffer staging_buffers_[2];  // protected by staging_mutex_
+  mutable size_t next_staging_buffer_ = 0;    // protected by staging_mutex_
 };
 
 }  // namespace onnxruntime
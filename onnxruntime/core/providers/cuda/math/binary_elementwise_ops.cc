@@ -235,7 +235,7 @@ Status Sum<T>::ComputeInternal(OpKernelContext* context) const {
     auto input_tensor = context->Input<Tensor>(0);
     const auto& input_shape = input_tensor->Shape();
     auto output_tensor = context->Output(0, input_shape);
-    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice, CurrentStream()));
   } else {
     // compute output shape first, using broadcast rule
     TensorShape output_shape;
@@ -262,7 +262,7 @@ Status Sum<T>::ComputeInternal(OpKernelContext* context) const {
           prepare.output_tensor->Shape().Size());
     } else {
       // for more than 2 inputs, we need to accumulate into output tensor, as the shape from input0 + input1 might be different from output shape
-      CUDA_RETURN_IF_ERROR(cudaMemset(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT)));
+      CUDA_RETURN_IF_ERROR(cudaMemsetAsync(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT), CurrentStream()));
       for (int index = 0; index < input_count; index++) {
         ORT_RETURN_IF_ERROR(BinaryElementwiseBroadcastPrepare(0, output_tensor, context->Input<Tensor>(index), output_tensor, &prepare));
         Impl_Add<CudaT>(
@@ -294,7 +294,7 @@ Status Max<T>::ComputeInternal(OpKernelContext* context) const {
     auto input_tensor = context->Input<Tensor>(0);
     const auto& input_shape = input_tensor->Shape();
     auto output_tensor = context->Output(0, input_shape);
-    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice, CurrentStream()));
   } else {
     // compute output shape first, using broadcast rule
     TensorShape output_shape;
@@ -307,7 +307,7 @@ Status Max<T>::ComputeInternal(OpKernelContext* context) const {
     BinaryElementwisePreparation prepare(this);
 
     // More than 2 inputs, set output to 0, add input0 to output, so that input0 can be broadcast with output shape correctly
-    CUDA_RETURN_IF_ERROR(cudaMemset(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT)));
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT), CurrentStream()));
     ORT_RETURN_IF_ERROR(BinaryElementwiseBroadcastPrepare(0, output_tensor, context->Input<Tensor>(0), output_tensor, &prepare));
     Impl_Add<CudaT>(
         prepare.output_rank_or_simple_broadcast,
@@ -350,7 +350,7 @@ Status Min<T>::ComputeInternal(OpKernelContext* context) const {
     auto input_tensor = context->Input<Tensor>(0);
     const auto& input_shape = input_tensor->Shape();
     auto output_tensor = context->Output(0, input_shape);
-    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor->MutableDataRaw(), input_tensor->DataRaw(), sizeof(CudaT) * input_shape.Size(), cudaMemcpyDeviceToDevice, CurrentStream()));
   } else {
     // compute output shape first, using broadcast rule
     TensorShape output_shape;
@@ -363,7 +363,7 @@ Status Min<T>::ComputeInternal(OpKernelContext* context) const {
     BinaryElementwisePreparation prepare(this);
 
     // More than 2 inputs, set output to 0, add input0 to output, so that input0 can be broadcast with output shape correctly
-    CUDA_RETURN_IF_ERROR(cudaMemset(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT)));
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(output_tensor->MutableDataRaw(), 0, output_shape.Size() * sizeof(CudaT), CurrentStream()));
     ORT_RETURN_IF_ERROR(BinaryElementwiseBroadcastPrepare(0, output_tensor, context->Input<Tensor>(0), output_tensor, &prepare));
     Impl_Add<CudaT>(
         prepare.output_rank_or_simple_broadcast,
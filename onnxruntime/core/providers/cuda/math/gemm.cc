@@ -34,10 +34,152 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
+#if CUDART_VERSION >= 11000
+namespace {
+// The workspace cuBLASLt may use for the algorithms it chooses.
+constexpr size_t kEpilogueWorkspaceBytes = 4 * 1024 * 1024;
+
+// The alignment of the pointers the algorithms are chosen for, so that they are valid for any tensor.
+constexpr uint32_t kEpilogueAlignmentBytes = 16;
+
+bool IsEpilogueAligned(const void* p) {
+  return reinterpret_cast<uintptr_t>(p) % kEpilogueAlignmentBytes == 0;
+}
+
+class CublasLtMatmulDesc final {
+ public:
+  ~CublasLtMatmulDesc() {
+    if (desc_ != nullptr) {
+      cublasLtMatmulDescDestroy(desc_);
+    }
+  }
+
+  Status Create() {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&desc_, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+    return Status::OK();
+  }
+
+  template <typename V>
+  Status Set(cublasLtMatmulDescAttributes_t attr, const V& value) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(desc_, attr, &value, sizeof(value)));
+    return Status::OK();
+  }
+
+  operator cublasLtMatmulDesc_t() const { return desc_; }
+
+ private:
+  cublasLtMatmulDesc_t desc_ = nullptr;
+};
+
+class CublasLtMatrixLayout final {
+ public:
+  ~CublasLtMatrixLayout() {
+    if (layout_ != nullptr) {
+      cublasLtMatrixLayoutDestroy(layout_);
+    }
+  }
+
+  // A column major matrix of rows x cols elements.
+  Status Create(cudaDataType_t type, int rows, int cols, int ld) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&layout_, type, rows, cols, ld));
+    return Status::OK();
+  }
+
+  operator cublasLtMatrixLayout_t() const { return layout_; }
+
+ private:
+  cublasLtMatrixLayout_t layout_ = nullptr;
+};
+}  // namespace
+
+template <typename T>
+Status Gemm<T>::ComputeWithEpilogue(const CudaT* x_data, const CudaT* w_data, const CudaT* b_data, CudaT* y_data,
+                                    int M, int N, int K, bool& computed) const {
+  computed = false;
+  // double has no bias epilogue
+  if (!std::is_same<T, float>::value && !std::is_same<T, MLFloat16>::value) {
+    return Status::OK();
+  }
+  if (M == 0 || N == 0 || K == 0 ||
+      !IsEpilogueAligned(x_data) || !IsEpilogueAligned(w_data) || !IsEpilogueAligned(b_data) ||
+      !IsEpilogueAligned(y_data)) {
+    return Status::OK();
+  }
+
+  const cudaDataType_t data_type = std::is_same<T, MLFloat16>::value ? CUDA_R_16F : CUDA_R_32F;
+  const cublasLtEpilogue_t epilogue = activation_ == "Relu" ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_BIAS;
+  const cublasOperation_t trans_w = trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  const cublasOperation_t trans_x = trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+
+  // CUDA assumes col-major, so Y(N,M) = alpha * op(W) x op(X) + B(N), B being added to each column
+  CublasLtMatmulDesc op_desc;
+  ORT_RETURN_IF_ERROR(op_desc.Create());
+  ORT_RETURN_IF_ERROR(op_desc.Set(CUBLASLT_MATMUL_DESC_TRANSA, trans_w));
+  ORT_RETURN_IF_ERROR(op_desc.Set(CUBLASLT_MATMUL_DESC_TRANSB, trans_x));
+  ORT_RETURN_IF_ERROR(op_desc.Set(CUBLASLT_MATMUL_DESC_EPILOGUE, epilogue));
+  ORT_RETURN_IF_ERROR(op_desc.Set(CUBLASLT_MATMUL_DESC_BIAS_POINTER, b_data));
+
+  CublasLtMatrixLayout w_layout, x_layout, y_layout;
+  ORT_RETURN_IF_ERROR(w_layout.Create(data_type, trans_B_ ? K : N, trans_B_ ? N : K, trans_B_ ? K : N));
+  ORT_RETURN_IF_ERROR(x_layout.Create(data_type, trans_A_ ? M : K, trans_A_ ? K : M, trans_A_ ? M : K));
+  ORT_RETURN_IF_ERROR(y_layout.Create(data_type, N, M, N));
+
+  const cublasLtMatmulAlgo_t* algo = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(epilogue_algos_mutex_);
+    auto it = epilogue_algos_.find(std::make_tuple(M, N, K));
+    if (it == epilogue_algos_.end()) {
+      cublasLtMatmulPreference_t preference;
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&preference));
+      const uint64_t workspace_bytes = kEpilogueWorkspaceBytes;
+      cublasLtMatmulPreferenceSetAttribute(preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+                                           &workspace_bytes, sizeof(workspace_bytes));
+      for (auto attr : {CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES,
+                        CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES}) {
+        cublasLtMatmulPreferenceSetAttribute(preference, attr, &kEpilogueAlignmentBytes,
+                                             sizeof(kEpilogueAlignmentBytes));
+      }
+
+      cublasLtMatmulHeuristicResult_t result;
+      int result_count = 0;
+      const auto status = cublasLtMatmulAlgoGetHeuristic(CublasLtHandle(), op_desc, w_layout, x_layout, y_layout,
+                                                         y_layout, preference, 1, &result, &result_count);
+      cublasLtMatmulPreferenceDestroy(preference);
+
+      std::unique_ptr<cublasLtMatmulAlgo_t> found;
+      if (status == CUBLAS_STATUS_SUCCESS && result_count > 0) {
+        found = std::make_unique<cublasLtMatmulAlgo_t>(result.algo);
+      }
+      it = epilogue_algos_.emplace(std::make_tuple(M, N, K), std::move(found)).first;
+    }
+    algo = it->second.get();
+  }
+
+  if (algo == nullptr) {
+    return Status::OK();
+  }
+
+  auto workspace = GetScratchBuffer<void>(kEpilogueWorkspaceBytes);
+  const float alpha = alpha_;
+  const float beta = 0.0f;
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(CublasLtHandle(), op_desc,
+                                        &alpha, w_data, w_layout, x_data, x_layout,
+                                        &beta, y_data, y_layout, y_data, y_layout,
+                                        algo, workspace.get(), kEpilogueWorkspaceBytes, CurrentStream()));
+  computed = true;
+  return Status::OK();
+}
+#endif
+
 template <typename T>
 Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
-  typedef typename ToCudaType<T>::MappedType CudaT;
+  Tensor* Y = nullptr;
+  bool activation_fused = false;
+  return ComputeGemm(ctx, Y, activation_fused);
+}
 
+template <typename T>
+Status Gemm<T>::ComputeGemm(OpKernelContext* ctx, Tensor*& Y, bool& activation_fused) const {
   const auto X = ctx->Input<Tensor>(0);
   const auto W = ctx->Input<Tensor>(1);
   const auto B = ctx->Input<Tensor>(2);
@@ -49,8 +191,26 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   int M = gsl::narrow_cast<int>(helper.M());
   int N = gsl::narrow_cast<int>(helper.N());
   int K = gsl::narrow_cast<int>(helper.K());
-  auto Y = ctx->Output(0, TensorShape(std::vector<int64_t>{M, N}));
+  Y = ctx->Output(0, TensorShape(std::vector<int64_t>{M, N}));
   CudaT* out_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  activation_fused = false;
+
+#if CUDART_VERSION >= 11000
+  // a bias of (N,) or (1, N) is added by the epilogue of the multiplication rather than copied to Y first
+  const auto& bias_shape = B->Shape();
+  if (beta_ == 1.0f && bias_shape.Size() == N && (bias_shape.NumDimensions() <= 1 || bias_shape[0] == 1) &&
+      (activation_.empty() || activation_ == "Relu")) {
+    bool computed = false;
+    ORT_RETURN_IF_ERROR(ComputeWithEpilogue(reinterpret_cast<const CudaT*>(X->template Data<T>()),
+                                            reinterpret_cast<const CudaT*>(W->template Data<T>()),
+                                            reinterpret_cast<const CudaT*>(B->template Data<T>()),
+                                            out_data, M, N, K, computed));
+    if (computed) {
+      activation_fused = true;
+      return Status::OK();
+    }
+  }
+#endif
 
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
   CudaT zero = ToCudaType<T>::FromFloat(0.0f);
@@ -95,7 +255,7 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
           out_data, N));
     } else {
       // B is (M, N), no broadcast needed.
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(out_data, b_data, M * N * sizeof(float), cudaMemcpyDeviceToDevice));
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(out_data, b_data, M * N * sizeof(CudaT), cudaMemcpyDeviceToDevice, CurrentStream()));
     }
   }
 
@@ -4,11 +4,15 @@
 #pragma once
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/platform/ort_mutex.h"
+
+#include <map>
+#include <tuple>
 
 namespace onnxruntime {
 namespace cuda {
 template <typename T>
-class Gemm final : public CudaKernel {
+class Gemm : public CudaKernel {
   using Base = CudaKernel;
 
  public:
@@ -26,7 +30,28 @@ class Gemm final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+ protected:
+  // Computes Y = alpha * op(A) x op(B) + beta * C. When the bias C is a row broadcast to Y, cuBLASLt adds it, and
+  // applies activation_ if it is Relu, in the epilogue of the multiplication; activation_fused tells whether it did.
+  Status ComputeGemm(OpKernelContext* ctx, Tensor*& Y, bool& activation_fused) const;
+
+  // The activation FusedGemm applies to Y, empty for Gemm.
+  std::string activation_;
+
  private:
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+#if CUDART_VERSION >= 11000
+  // Runs the multiplication with the bias and activation epilogue of cuBLASLt, computed is false if it doesn't
+  // support the shapes, in which case nothing was launched.
+  Status ComputeWithEpilogue(const CudaT* x_data, const CudaT* w_data, const CudaT* b_data, CudaT* y_data,
+                             int M, int N, int K, bool& computed) const;
+
+  // The algorithm the heuristics of cuBLASLt chose for each (M, N, K), nullptr if none supports the epilogue.
+  mutable std::map<std::tuple<int, int, int>, std::unique_ptr<cublasLtMatmulAlgo_t>> epilogue_algos_;
+  mutable OrtMutex epilogue_algos_mutex_;
+#endif
+
   bool trans_A_;
   bool trans_B_;
   float alpha_;
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "integer_gemm.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#if CUDART_VERSION >= 11000
+constexpr cublasComputeType_t kIntegerGemmComputeType = CUBLAS_COMPUTE_32I;
+#else
+constexpr cudaDataType_t kIntegerGemmComputeType = CUDA_R_32I;
+#endif
+
+Status IntegerGemmBase::ComputePackedGemm(int64_t M,
+                                          int64_t N,
+                                          int64_t K,
+                                          const int8_t* a,
+                                          const int8_t* b,
+                                          const IntegerGemmQuantParams& params,
+                                          int32_t* output_int32,
+                                          uint8_t* output_uint8) const {
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  const int64_t padded_n = IntegerGemmPad(N);
+  const int64_t padded_k = IntegerGemmPad(K);
+
+  auto row_sums = GetScratchBuffer<int32_t>(M + padded_n);
+  int32_t* a_row_sums = row_sums.get();
+  int32_t* b_row_sums = a_row_sums + M;
+  RowSumsInt8Impl(a, M, padded_k, a_row_sums);
+  RowSumsInt8Impl(b, padded_n, padded_k, b_row_sums);
+
+  // an int32 result without padded columns is corrected in place
+  IAllocatorUniquePtr<int32_t> product_buffer;
+  int32_t* product = output_int32;
+  if (output_int32 == nullptr || padded_n != N) {
+    product_buffer = GetScratchBuffer<int32_t>(M * padded_n);
+    product = product_buffer.get();
+  }
+
+  if (padded_k == 0) {
+    CUDA_RETURN_IF_ERROR(cudaMemsetAsync(product, 0, M * padded_n * sizeof(int32_t), CurrentStream()));
+  } else {
+    // CUDA assumes col-major, so the row major M x padded N product is product(padded N, M) = B x A^T, with B and A
+    // stored as padded K x padded N and padded K x M col-major matrices: the "TN" layout of the int8 GEMM.
+    const int32_t alpha = 1;
+    const int32_t beta = 0;
+    CUBLAS_RETURN_IF_ERROR(cublasGemmEx(
+        CublasHandle(),
+        CUBLAS_OP_T,
+        CUBLAS_OP_N,
+        static_cast<int>(padded_n),
+        static_cast<int>(M),
+        static_cast<int>(padded_k),
+        &alpha,
+        b,
+        CUDA_R_8I,
+        static_cast<int>(padded_k),
+        a,
+        CUDA_R_8I,
+        static_cast<int>(padded_k),
+        &beta,
+        product,
+        CUDA_R_32I,
+        static_cast<int>(padded_n),
+        kIntegerGemmComputeType,
+        CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+  }
+
+  if (output_int32 != nullptr) {
+    IntegerGemmOutputImpl(product, padded_n, M, N, K, a_row_sums, b_row_sums, params, output_int32);
+  } else {
+    IntegerGemmRequantizeImpl(product, padded_n, M, N, K, a_row_sums, b_row_sums, params, output_uint8);
+  }
+  return Status::OK();
+}
+
+Status IntegerGemmBase::ComputeMatMul(const Tensor& a,
+                                      const Tensor& b,
+                                      const MatMulComputeHelper& helper,
+                                      const IntegerGemmQuantParams& params,
+                                      int32_t* output_int32,
+                                      uint8_t* output_uint8) const {
+  const int64_t N = helper.N();
+  const int64_t K = helper.K();
+  const int64_t padded_n = IntegerGemmPad(N);
+  const int64_t padded_k = IntegerGemmPad(K);
+
+  // a B shared by all the matrices of A is multiplied by all their rows at once
+  const bool shared_b = b.Shape().NumDimensions() == 2;
+  const size_t batch_count = shared_b ? 1 : helper.OutputOffsets().size();
+  const int64_t M = shared_b ? helper.M() * static_cast<int64_t>(helper.OutputOffsets().size()) : helper.M();
+
+  auto packed_a = GetScratchBuffer<int8_t>(M * padded_k);
+  auto packed_b = GetScratchBuffer<int8_t>(padded_n * padded_k);
+
+  const auto* a_data = static_cast<const uint8_t*>(a.DataRaw());
+  const auto* b_data = static_cast<const uint8_t*>(b.DataRaw());
+  for (size_t i = 0; i < batch_count; i++) {
+    PackInt8RowsImpl(a_data + helper.LeftOffsets()[i], false, M, K, K, false, packed_a.get(), M, padded_k);
+    PackInt8RowsImpl(b_data + helper.RightOffsets()[i], params.b_is_signed, N, K, N, true, packed_b.get(),
+                     padded_n, padded_k);
+    ORT_RETURN_IF_ERROR(ComputePackedGemm(
+        M, N, K, packed_a.get(), packed_b.get(), params,
+        output_int32 == nullptr ? nullptr : output_int32 + helper.OutputOffsets()[i],
+        output_uint8 == nullptr ? nullptr : output_uint8 + helper.OutputOffsets()[i]));
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "integer_gemm_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Base of the kernels that multiply a uint8 matrix by a uint8 or int8 matrix with the int8 GEMM of cuBLAS, which
+// runs on the int8 tensor cores (IMMA) or with DP4A. The uint8 values are offset to int8 while they are packed, and
+// the offsets and the zero points are applied to the int32 product with the sums of the rows of the packed matrices.
+class IntegerGemmBase : public CudaKernel {
+ public:
+  explicit IntegerGemmBase(const OpKernelInfo& info) : CudaKernel(info) {}
+
+ protected:
+  // Multiplies the M x K matrix packed to a by the K x N matrix whose transpose is packed to b, and writes the M x N
+  // result with the zero points of params applied, as int32 to output_int32 or requantized to output_uint8.
+  // a holds M rows and b holds IntegerGemmPad(N) rows of IntegerGemmPad(K) values.
+  Status ComputePackedGemm(int64_t M,
+                           int64_t N,
+                           int64_t K,
+                           const int8_t* a,
+                           const int8_t* b,
+                           const IntegerGemmQuantParams& params,
+                           int32_t* output_int32,
+                           uint8_t* output_uint8) const;
+
+  // Multiplies the uint8 matrices of a by the uint8 or int8 matrices of b as MatMul broadcasts them.
+  Status ComputeMatMul(const Tensor& a,
+                       const Tensor& b,
+                       const MatMulComputeHelper& helper,
+                       const IntegerGemmQuantParams& params,
+                       int32_t* output_int32,
+                       uint8_t* output_uint8) const;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,268 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "integer_gemm_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The offset that maps uint8 values to int8.
+constexpr int32_t kUint8Offset = 128;
+
+constexpr int kWarpSize = 32;
+
+// The rows summed by a block of RowSumsInt8Impl, one per warp.
+constexpr int kRowSumsRowsPerBlock = 8;
+
+__device__ __forceinline__ int32_t _LoadInt8(const void* data, bool is_signed, CUDA_LONG index) {
+  return is_signed ? static_cast<int32_t>(static_cast<const int8_t*>(data)[index])
+                   : static_cast<int32_t>(static_cast<const uint8_t*>(data)[index]) - kUint8Offset;
+}
+
+__global__ void _PackInt8RowsKernel(
+    const void* input,
+    const bool input_is_signed,
+    const CUDA_LONG rows,
+    const CUDA_LONG cols,
+    const CUDA_LONG ld,
+    const bool transpose,
+    int8_t* output,
+    const CUDA_LONG padded_cols,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  const CUDA_LONG r = id / padded_cols;
+  const CUDA_LONG c = id % padded_cols;
+  int32_t value = 0;
+  if (r < rows && c < cols) {
+    value = _LoadInt8(input, input_is_signed, transpose ? c * ld + r : r * ld + c);
+  }
+  output[id] = static_cast<int8_t>(value);
+}
+
+void PackInt8RowsImpl(const void* input,
+                      bool input_is_signed,
+                      int64_t rows,
+                      int64_t cols,
+                      int64_t ld,
+                      bool transpose,
+                      int8_t* output,
+                      int64_t padded_rows,
+                      int64_t padded_cols) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(padded_rows * padded_cols);
+  if (N == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock));
+  _PackInt8RowsKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      input, input_is_signed, static_cast<CUDA_LONG>(rows), static_cast<CUDA_LONG>(cols), static_cast<CUDA_LONG>(ld),
+      transpose, output, static_cast<CUDA_LONG>(padded_cols), N);
+}
+
+__global__ void _Im2ColInt8Kernel(
+    const uint8_t* x,
+    const uint8_t* x_zero_point,
+    const Im2ColInt8Params params,
+    int8_t* col,
+    const CUDA_LONG padded_kernel_dim,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  const CUDA_LONG pixel = id / padded_kernel_dim;
+  const CUDA_LONG k = id % padded_kernel_dim;
+
+  const CUDA_LONG kernel_size = static_cast<CUDA_LONG>(
+      params.kernel_shape[0] * params.kernel_shape[1] * params.kernel_shape[2]);
+  const CUDA_LONG output_size = static_cast<CUDA_LONG>(
+      params.output_shape[0] * params.output_shape[1] * params.output_shape[2]);
+
+  if (pixel >= output_size || k >= static_cast<CUDA_LONG>(params.channels) * kernel_size) {
+    col[id] = 0;
+    return;
+  }
+
+  // the position in the image of the input of this element of the patch, from the innermost dimension
+  CUDA_LONG offsets[3];
+  CUDA_LONG kernel_index = k % kernel_size;
+  CUDA_LONG output_index = pixel;
+  bool is_padding = false;
+  for (int d = 2; d >= 0; d--) {
+    const CUDA_LONG kernel_dim = static_cast<CUDA_LONG>(params.kernel_shape[d]);
+    const CUDA_LONG output_dim = static_cast<CUDA_LONG>(params.output_shape[d]);
+    offsets[d] = (output_index % output_dim) * static_cast<CUDA_LONG>(params.strides[d]) -
+                 static_cast<CUDA_LONG>(params.pads[d]) +
+                 (kernel_index % kernel_dim) * static_cast<CUDA_LONG>(params.dilations[d]);
+    is_padding |= offsets[d] < 0 || offsets[d] >= static_cast<CUDA_LONG>(params.input_shape[d]);
+    kernel_index /= kernel_dim;
+    output_index /= output_dim;
+  }
+
+  CUDA_LONG input_index = k / kernel_size;
+  for (int d = 0; d < 3; d++) {
+    input_index = input_index * static_cast<CUDA_LONG>(params.input_shape[d]) + offsets[d];
+  }
+
+  const int32_t value = is_padding ? (x_zero_point != nullptr ? *x_zero_point : 0) : x[input_index];
+  col[id] = static_cast<int8_t>(value - kUint8Offset);
+}
+
+void Im2ColInt8Impl(const uint8_t* x,
+                    const uint8_t* x_zero_point,
+                    const Im2ColInt8Params& params,
+                    int8_t* col,
+                    int64_t padded_pixels,
+                    int64_t padded_kernel_dim) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(padded_pixels * padded_kernel_dim);
+  if (N == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock));
+  _Im2ColInt8Kernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      x, x_zero_point, params, col, static_cast<CUDA_LONG>(padded_kernel_dim), N);
+}
+
+// Each warp sums a row, four values at a time.
+__global__ void _RowSumsInt8Kernel(
+    const int8_t* input,
+    const CUDA_LONG rows,
+    const CUDA_LONG padded_cols,
+    int32_t* sums) {
+  const CUDA_LONG row = blockIdx.x * kRowSumsRowsPerBlock + threadIdx.x / kWarpSize;
+  const int lane = threadIdx.x % kWarpSize;
+  if (row >= rows) {
+    return;
+  }
+
+  const char4* values = reinterpret_cast<const char4*>(input + row * padded_cols);
+  int32_t sum = 0;
+  for (CUDA_LONG i = lane; i < padded_cols / 4; i += kWarpSize) {
+    const char4 v = values[i];
+    sum += v.x + v.y + v.z + v.w;
+  }
+  for (int offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    sum += __shfl_down_sync(0xffffffff, sum, offset);
+  }
+  if (lane == 0) {
+    sums[row] = sum;
+  }
+}
+
+void RowSumsInt8Impl(const int8_t* input,
+                     int64_t rows,
+                     int64_t padded_cols,
+                     int32_t* sums) {
+  if (rows == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>(CeilDiv(rows, kRowSumsRowsPerBlock));
+  _RowSumsInt8Kernel<<<blocksPerGrid, kRowSumsRowsPerBlock * kWarpSize, 0, CurrentStream()>>>(
+      input, static_cast<CUDA_LONG>(rows), static_cast<CUDA_LONG>(padded_cols), sums);
+}
+
+// sum((a - za) * (b - zb)) over K, where the packed values are a' = a - oa and b' = b - ob, is
+// sum(a' * b') + ca * sum(b') + cb * sum(a') + K * ca * cb with ca = oa - za and cb = ob - zb.
+__device__ __forceinline__ int32_t _IntegerGemmValue(
+    const int32_t* product,
+    const CUDA_LONG ldp,
+    const CUDA_LONG m,
+    const CUDA_LONG n,
+    const CUDA_LONG K,
+    const int32_t* a_row_sums,
+    const int32_t* b_row_sums,
+    const IntegerGemmQuantParams& params) {
+  int32_t ca = kUint8Offset;
+  if (params.a_zero_point != nullptr) {
+    ca -= params.a_zero_point[params.a_zero_point_per_row ? m : 0];
+  }
+  int32_t cb = params.b_is_signed ? 0 : kUint8Offset;
+  if (params.b_zero_point != nullptr) {
+    const CUDA_LONG index = params.b_zero_point_per_column ? n : 0;
+    cb -= params.b_is_signed ? static_cast<int32_t>(static_cast<const int8_t*>(params.b_zero_point)[index])
+                             : static_cast<int32_t>(static_cast<const uint8_t*>(params.b_zero_point)[index]);
+  }
+  return product[m * ldp + n] + ca * b_row_sums[n] + cb * a_row_sums[m] + K * ca * cb;
+}
+
+__global__ void _IntegerGemmOutputKernel(
+    const int32_t* product,
+    const CUDA_LONG ldp,
+    const CUDA_LONG N,
+    const CUDA_LONG K,
+    const int32_t* a_row_sums,
+    const int32_t* b_row_sums,
+    const IntegerGemmQuantParams params,
+    int32_t* output,
+    const CUDA_LONG count) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, count);
+
+  const CUDA_LONG m = id / N;
+  const CUDA_LONG n = id % N;
+  output[id] = _IntegerGemmValue(product, ldp, m, n, K, a_row_sums, b_row_sums, params);
+}
+
+void IntegerGemmOutputImpl(const int32_t* product,
+                           int64_t ldp,
+                           int64_t M,
+                           int64_t N,
+                           int64_t K,
+                           const int32_t* a_row_sums,
+                           const int32_t* b_row_sums,
+                           const IntegerGemmQuantParams& params,
+                           int32_t* output) {
+  const CUDA_LONG count = static_cast<CUDA_LONG>(M * N);
+  if (count == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  _IntegerGemmOutputKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      product, static_cast<CUDA_LONG>(ldp), static_cast<CUDA_LONG>(N), static_cast<CUDA_LONG>(K),
+      a_row_sums, b_row_sums, params, output, count);
+}
+
+__global__ void _IntegerGemmRequantizeKernel(
+    const int32_t* product,
+    const CUDA_LONG ldp,
+    const CUDA_LONG N,
+    const CUDA_LONG K,
+    const int32_t* a_row_sums,
+    const int32_t* b_row_sums,
+    const IntegerGemmQuantParams params,
+    uint8_t* output,
+    const CUDA_LONG count) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, count);
+
+  const CUDA_LONG m = id / N;
+  const CUDA_LONG n = id % N;
+  int32_t value = _IntegerGemmValue(product, ldp, m, n, K, a_row_sums, b_row_sums, params);
+  if (params.bias != nullptr) {
+    value += params.bias[m];
+  }
+
+  const float scale = params.a_scale[params.a_scale_per_row ? m : 0] *
+                      params.b_scale[params.b_scale_per_column ? n : 0] / params.y_scale[0];
+  int32_t result = __float2int_rn(static_cast<float>(value) * scale) + params.y_zero_point[0];
+  output[id] = static_cast<uint8_t>(min(max(result, 0), 255));
+}
+
+void IntegerGemmRequantizeImpl(const int32_t* product,
+                               int64_t ldp,
+                               int64_t M,
+                               int64_t N,
+                               int64_t K,
+                               const int32_t* a_row_sums,
+                               const int32_t* b_row_sums,
+                               const IntegerGemmQuantParams& params,
+                               uint8_t* output) {
+  const CUDA_LONG count = static_cast<CUDA_LONG>(M * N);
+  if (count == 0) {
+    return;
+  }
+  const int blocksPerGrid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  _IntegerGemmRequantizeKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      product, static_cast<CUDA_LONG>(ldp), static_cast<CUDA_LONG>(N), static_cast<CUDA_LONG>(K),
+      a_row_sums, b_row_sums, params, output, count);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The int8 GEMM of cuBLAS takes a K that is a multiple of 4, and computes rows of the result that are a multiple of 4
+// long, so the packed matrices are padded with zero rows and columns to these multiples.
+constexpr int64_t kIntegerGemmAlignment = 4;
+
+inline int64_t IntegerGemmPad(int64_t dim) {
+  return (dim + kIntegerGemmAlignment - 1) / kIntegerGemmAlignment * kIntegerGemmAlignment;
+}
+
+// The zero points, scales and bias of the product of an M x K uint8 matrix A by a K x N uint8 or int8 matrix B, all
+// in device memory. A value of A applies to a row of the product, a value of B to a column, and a per tensor value
+// is read from its first element. A nullptr zero point is 0, and a nullptr bias adds nothing.
+// The scales, the output zero point and the bias are only used by the products requantized to uint8.
+struct IntegerGemmQuantParams {
+  const uint8_t* a_zero_point = nullptr;
+  bool a_zero_point_per_row = false;
+  const void* b_zero_point = nullptr;
+  bool b_zero_point_per_column = false;
+  bool b_is_signed = false;
+
+  const int32_t* bias = nullptr;
+  const float* a_scale = nullptr;
+  bool a_scale_per_row = false;
+  const float* b_scale = nullptr;
+  bool b_scale_per_column = false;
+  const float* y_scale = nullptr;
+  const uint8_t* y_zero_point = nullptr;
+};
+
+// Packs the rows x cols matrix input[r * ld + c], or its transpose input[c * ld + r], to a padded_rows x padded_cols
+// int8 matrix, with the uint8 values offset by -128 and the padding zero.
+void PackInt8RowsImpl(const void* input,
+                      bool input_is_signed,
+                      int64_t rows,
+                      int64_t cols,
+                      int64_t ld,
+                      bool transpose,
+                      int8_t* output,
+                      int64_t padded_rows,
+                      int64_t padded_cols);
+
+// The geometry of a convolution of up to 3 spatial dimensions. The missing dimensions are 1, with no padding.
+struct Im2ColInt8Params {
+  int64_t channels;
+  int64_t input_shape[3];
+  int64_t output_shape[3];
+  int64_t kernel_shape[3];
+  int64_t strides[3];
+  int64_t pads[3];
+  int64_t dilations[3];
+};
+
+// Writes a row of the channels * kernel size values of the patch of each output pixel of the uint8 image x, offset
+// by -128, so the packed patches are the transposed B of the product of the filters by the patches. The padding of
+// the image is the input zero point, and the padding of the rows and columns is zero.
+void Im2ColInt8Impl(const uint8_t* x,
+                    const uint8_t* x_zero_point,
+                    const Im2ColInt8Params& params,
+                    int8_t* col,
+                    int64_t padded_pixels,
+                    int64_t padded_kernel_dim);
+
+// Sums each row of a matrix packed by PackInt8RowsImpl or Im2ColInt8Impl.
+void RowSumsInt8Impl(const int8_t* input,
+                     int64_t rows,
+                     int64_t padded_cols,
+                     int32_t* sums);
+
+// Turns the product of the packed A and B, product[m * ldp + n], into the product of the original matrices with
+// their zero points subtracted, using the sums of the rows of the packed A and B, and writes it to output[m * N + n].
+// K is the number of columns of A before padding.
+void IntegerGemmOutputImpl(const int32_t* product,
+                           int64_t ldp,
+                           int64_t M,
+                           int64_t N,
+                           int64_t K,
+                           const int32_t* a_row_sums,
+                           const int32_t* b_row_sums,
+                           const IntegerGemmQuantParams& params,
+                           int32_t* output);
+
+// Like IntegerGemmOutputImpl, then adds the bias and requantizes the result to uint8 with the scales and the output
+// zero point.
+void IntegerGemmRequantizeImpl(const int32_t* product,
+                               int64_t ldp,
+                               int64_t M,
+                               int64_t N,
+                               int64_t K,
+                               const int32_t* a_row_sums,
+                               const int32_t* b_row_sums,
+                               const IntegerGemmQuantParams& params,
+                               uint8_t* output);
+
+}  // namespace cuda
+}  // namespace onnxruntime
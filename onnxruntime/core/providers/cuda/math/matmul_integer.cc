@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "matmul_integer.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                         \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                         \
+      MatMulInteger,                                                     \
+      kOnnxDomain,                                                       \
+      10,                                                                \
+      T,                                                                 \
+      kCudaExecutionProvider,                                            \
+      KernelDefBuilder()                                                 \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())  \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T>())        \
+          .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()), \
+      MatMulInteger<T>);
+
+REGISTER_KERNEL_TYPED(uint8_t)
+REGISTER_KERNEL_TYPED(int8_t)
+
+template <typename T2>
+Status MatMulInteger<T2>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // the zero points stay in device memory, and are read by the kernel that corrects the product
+  IntegerGemmQuantParams params;
+  params.b_is_signed = std::is_same<T2, int8_t>::value;
+
+  const Tensor* a_zero_point = ctx->Input<Tensor>(2);
+  if (a_zero_point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_zero_point),
+                      "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
+    params.a_zero_point = a_zero_point->template Data<uint8_t>();
+  }
+
+  const Tensor* b_zero_point = ctx->Input<Tensor>(3);
+  if (b_zero_point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_zero_point) || IsVectorOfSize(b_zero_point, helper.N()),
+                      "MatmulInteger : input2 zero point must be a scalar or 1D tensor with a value for each column");
+    params.b_zero_point = b_zero_point->template Data<T2>();
+    params.b_zero_point_per_column = !IsScalarOr1ElementVector(b_zero_point);
+  }
+
+  return ComputeMatMul(*a, *b, helper, params, y->template MutableData<int32_t>(), nullptr);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "integer_gemm.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// T2 is the type of B, uint8_t or int8_t.
+template <typename T2>
+class MatMulInteger final : public IntegerGemmBase {
+ public:
+  MatMulInteger(const OpKernelInfo& info) : IntegerGemmBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "quantize_linear_matmul.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearMatMul,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMatMul);
+
+Status QLinearMatMul::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(3);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // validate offsets
+  const Tensor* a_offset = ctx->Input<Tensor>(2);
+  const Tensor* b_offset = ctx->Input<Tensor>(5);
+  const Tensor* y_offset = ctx->Input<Tensor>(7);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_offset),
+                    "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_offset) || IsVectorOfSize(b_offset, helper.N()),
+                    "QLinearMatmul : weight zero point must be a scalar, 1D tensor of size 1, "
+                    "or 1D tensor with a value for each column");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_offset),
+                    "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
+
+  // validate scale
+  const Tensor* a_scale = ctx->Input<Tensor>(1);
+  const Tensor* b_scale = ctx->Input<Tensor>(4);
+  const Tensor* y_scale = ctx->Input<Tensor>(6);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_scale),
+                    "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_scale) || IsVectorOfSize(b_scale, helper.N()),
+                    "QLinearMatmul : weight scale must be a scalar, 1D tensor of size 1, "
+                    "or 1D tensor with a value for each column");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_scale),
+                    "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
+
+  // the zero points and scales stay in device memory, and are read by the kernel that requantizes the product
+  IntegerGemmQuantParams params;
+  params.a_zero_point = a_offset->template Data<uint8_t>();
+  params.b_zero_point = b_offset->template Data<uint8_t>();
+  params.b_zero_point_per_column = !IsScalarOr1ElementVector(b_offset);
+  params.a_scale = a_scale->template Data<float>();
+  params.b_scale = b_scale->template Data<float>();
+  params.b_scale_per_column = !IsScalarOr1ElementVector(b_scale);
+  params.y_scale = y_scale->template Data<float>();
+  params.y_zero_point = y_offset->template Data<uint8_t>();
+
+  return ComputeMatMul(*a, *b, helper, params, nullptr, y->template MutableData<uint8_t>());
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "integer_gemm.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+class QLinearMatMul final : public IntegerGemmBase {
+ public:
+  QLinearMatMul(const OpKernelInfo& info) : IntegerGemmBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "topk.h"
+#include "topk_impl.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    TopK,
+    kOnnxDomain,
+    1, 9,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),
+    TopK<9>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    TopK,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),
+    TopK<10>);
+
+template <int OpSet>
+TopK<OpSet>::TopK(const OpKernelInfo& info) : CudaKernel(info) {
+  axis_ = info.GetAttrOrDefault<int64_t>("axis", -1);
+  if (OpSet < 10) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("k", &k_).IsOK());
+    ORT_ENFORCE(k_ > 0);
+  }
+}
+
+template <int OpSet>
+Status TopK<OpSet>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* X = ctx->Input<Tensor>(0);
+  const auto& x_dims = X->Shape().GetDims();
+
+  int64_t k = k_;
+  if (OpSet >= 10) {
+    const Tensor* K = ctx->Input<Tensor>(1);
+    if (K->Shape().NumDimensions() != 1 || K->Shape()[0] != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k tensor should be a 1D tensor of size 1");
+    }
+    k = K->Data<int64_t>()[0];
+    if (k < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "value of k must not be negative");
+    }
+  }
+
+  const auto axis = HandleNegativeAxis(axis_, x_dims.size());
+  if (x_dims[axis] < k) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k argment [", k, "] should not be greater than specified axis dim value [",
+                           x_dims[axis], "]");
+  }
+
+  std::vector<int64_t> y_dims = x_dims;
+  y_dims[axis] = k;
+  Tensor* values = ctx->Output(0, y_dims);
+  Tensor* indices = ctx->Output(1, y_dims);
+  if (k == 0 || values->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t rows = X->Shape().SizeToDimension(axis);
+  const int64_t stride = X->Shape().SizeFromDimension(axis + 1);
+  IAllocatorUniquePtr<float> scratch_values;
+  IAllocatorUniquePtr<int32_t> scratch_indices;
+  IAllocatorUniquePtr<int32_t> scratch_slices;
+  if (k > kTopKMaxBlockSortedK) {
+    const size_t scratch_size = static_cast<size_t>(rows * stride * k);
+    scratch_values = GetScratchBuffer<float>(scratch_size);
+    scratch_indices = GetScratchBuffer<int32_t>(scratch_size);
+    scratch_slices = GetScratchBuffer<int32_t>(scratch_size);
+  }
+
+  return TopKImpl(X->Data<float>(), values->MutableData<float>(), indices->MutableData<int64_t>(),
+                  rows, x_dims[axis], stride, k, scratch_values.get(), scratch_indices.get(), scratch_slices.get());
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
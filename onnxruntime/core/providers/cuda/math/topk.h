@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Before opset 10, k is an attribute, from opset 10 it's the second input.
+template <int OpSet>
+class TopK final : public CudaKernel {
+ public:
+  TopK(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  int64_t k_ = -1;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
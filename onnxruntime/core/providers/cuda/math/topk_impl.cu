@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cuda_common.h"
+#include "topk_impl.h"
+
+#include <climits>
+#include <thrust/execution_policy.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/zip_iterator.h>
+#include <thrust/sort.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kTopKBlockSize = 256;
+
+// A key whose unsigned order is the order of the values, with -0 equal to 0.
+__device__ __forceinline__ uint32_t TopKKey(float value) {
+  const uint32_t bits = __float_as_uint(value == 0.f ? 0.f : value);
+  return (bits & 0x80000000u) != 0 ? ~bits : (bits | 0x80000000u);
+}
+
+// Whether the element with key_a and index_a comes before the one with key_b and index_b in the output.
+__device__ __forceinline__ bool TopKBefore(uint32_t key_a, int32_t index_a, uint32_t key_b, int32_t index_b) {
+  return key_a > key_b || (key_a == key_b && index_a < index_b);
+}
+
+// The exclusive prefix sum of value over the threads of the block, and the sum of all of them in total.
+__device__ int BlockExclusiveSum(int value, int* scratch, int& total) {
+  scratch[threadIdx.x] = value;
+  __syncthreads();
+  for (int offset = 1; offset < kTopKBlockSize; offset <<= 1) {
+    const int add = threadIdx.x >= offset ? scratch[threadIdx.x - offset] : 0;
+    __syncthreads();
+    scratch[threadIdx.x] += add;
+    __syncthreads();
+  }
+  const int inclusive = scratch[threadIdx.x];
+  total = scratch[kTopKBlockSize - 1];
+  __syncthreads();
+  return inclusive - value;
+}
+
+// One block per slice.
+__global__ void _TopKKernel(const float* input,
+                            float* values,
+                            int64_t* indices,
+                            const int dim,
+                            const int stride,
+                            const int k,
+                            float* scratch_values,
+                            int32_t* scratch_indices,
+                            int32_t* scratch_slices) {
+  __shared__ int histogram[256];
+  __shared__ int scan_scratch[kTopKBlockSize];
+  __shared__ uint32_t digit_prefix;
+  __shared__ int digit_remaining;
+  __shared__ uint32_t sorted_keys[kTopKMaxBlockSortedK];
+  __shared__ int32_t sorted_indices[kTopKMaxBlockSortedK];
+
+  const int slice = blockIdx.x;
+  const int row = slice / stride;
+  const int col = slice % stride;
+  const float* x = input + static_cast<int64_t>(row) * dim * stride + col;
+
+  // radix select of the key of the k-th largest element, 8 bits at a time from the highest ones. remaining is the
+  // number of elements with this key among the k largest, the others being larger.
+  uint32_t prefix = 0;
+  uint32_t prefix_mask = 0;
+  int remaining = k;
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    for (int i = threadIdx.x; i < 256; i += kTopKBlockSize) {
+      histogram[i] = 0;
+    }
+    __syncthreads();
+    for (int i = threadIdx.x; i < dim; i += kTopKBlockSize) {
+      const uint32_t key = TopKKey(x[static_cast<int64_t>(i) * stride]);
+      if ((key & prefix_mask) == prefix) {
+        atomicAdd(&histogram[(key >> shift) & 0xff], 1);
+      }
+    }
+    __syncthreads();
+    if (threadIdx.x == 0) {
+      int digit = 255;
+      for (; digit > 0 && histogram[digit] < remaining; --digit) {
+        remaining -= histogram[digit];
+      }
+      digit_prefix = prefix | (static_cast<uint32_t>(digit) << shift);
+      digit_remaining = remaining;
+    }
+    __syncthreads();
+    prefix = digit_prefix;
+    remaining = digit_remaining;
+    prefix_mask |= 0xffu << shift;
+  }
+
+  // the larger elements, and the first remaining ones equal to the k-th, in the order of the slice
+  const uint32_t kth_key = prefix;
+  const bool sorted_in_block = k <= kTopKMaxBlockSortedK;
+  int selected = 0;
+  int equal_seen = 0;
+  for (int base = 0; base < dim && selected < k; base += kTopKBlockSize) {
+    const int i = base + threadIdx.x;
+    const uint32_t key = i < dim ? TopKKey(x[static_cast<int64_t>(i) * stride]) : 0;
+    const int is_equal = i < dim && key == kth_key;
+    int equal_total;
+    const int equal_rank = equal_seen + BlockExclusiveSum(is_equal, scan_scratch, equal_total);
+    const int is_selected = i < dim && (key > kth_key || (is_equal && equal_rank < remaining));
+    int selected_total;
+    const int position = selected + BlockExclusiveSum(is_selected, scan_scratch, selected_total);
+    if (is_selected) {
+      if (sorted_in_block) {
+        sorted_keys[position] = key;
+        sorted_indices[position] = i;
+      } else {
+        const int64_t offset = static_cast<int64_t>(slice) * k + position;
+        scratch_values[offset] = x[static_cast<int64_t>(i) * stride];
+        scratch_indices[offset] = i;
+        scratch_slices[offset] = slice;
+      }
+    }
+    selected += selected_total;
+    equal_seen += equal_total;
+  }
+
+  if (!sorted_in_block) {
+    return;
+  }
+
+  // bitonic sort, with the padding up to a power of 2 after all the elements
+  int size = 1;
+  while (size < k) {
+    size <<= 1;
+  }
+  for (int i = k + threadIdx.x; i < size; i += kTopKBlockSize) {
+    sorted_keys[i] = 0;
+    sorted_indices[i] = INT_MAX;
+  }
+  __syncthreads();
+  for (int block = 2; block <= size; block <<= 1) {
+    for (int distance = block >> 1; distance > 0; distance >>= 1) {
+      for (int i = threadIdx.x; i < size; i += kTopKBlockSize) {
+        const int j = i ^ distance;
+        if (j > i) {
+          const bool i_first = (i & block) == 0;
+          const bool swap = i_first ? TopKBefore(sorted_keys[j], sorted_indices[j], sorted_keys[i], sorted_indices[i])
+                                    : TopKBefore(sorted_keys[i], sorted_indices[i], sorted_keys[j], sorted_indices[j]);
+          if (swap) {
+            const uint32_t key = sorted_keys[i];
+            sorted_keys[i] = sorted_keys[j];
+            sorted_keys[j] = key;
+            const int32_t index = sorted_indices[i];
+            sorted_indices[i] = sorted_indices[j];
+            sorted_indices[j] = index;
+          }
+        }
+      }
+      __syncthreads();
+    }
+  }
+
+  for (int i = threadIdx.x; i < k; i += kTopKBlockSize) {
+    const int64_t offset = (static_cast<int64_t>(row) * k + i) * stride + col;
+    values[offset] = x[static_cast<int64_t>(sorted_indices[i]) * stride];
+    indices[offset] = sorted_indices[i];
+  }
+}
+
+// Writes the scratch buffers, sorted by slice, to the outputs.
+__global__ void _TopKScatterKernel(const float* scratch_values,
+                                   const int32_t* scratch_indices,
+                                   float* values,
+                                   int64_t* indices,
+                                   const fast_divmod k_div,
+                                   const fast_divmod stride_div,
+                                   const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int slice, position;
+  k_div.divmod(id, slice, position);
+  int row, col;
+  stride_div.divmod(slice, row, col);
+  const int64_t offset = (static_cast<int64_t>(row) * k_div.d_ + position) * stride_div.d_ + col;
+  values[offset] = scratch_values[id];
+  indices[offset] = scratch_indices[id];
+}
+
+Status TopKImpl(const float* input,
+                float* values,
+                int64_t* indices,
+                int64_t rows,
+                int64_t dim,
+                int64_t stride,
+                int64_t k,
+                float* scratch_values,
+                int32_t* scratch_indices,
+                int32_t* scratch_slices) {
+  const int slices = static_cast<int>(rows * stride);
+  if (slices == 0 || k == 0) {
+    return Status::OK();
+  }
+
+  _TopKKernel<<<slices, kTopKBlockSize, 0, CurrentStream()>>>(
+      input, values, indices, static_cast<int>(dim), static_cast<int>(stride), static_cast<int>(k),
+      scratch_values, scratch_indices, scratch_slices);
+
+  if (k > kTopKMaxBlockSortedK) {
+    // the elements of each slice are in the order of the slice, so sorting them stably by value, then by slice,
+    // orders the equal ones by index
+    const CUDA_LONG N = static_cast<CUDA_LONG>(slices * k);
+    auto policy = thrust::cuda::par.on(CurrentStream());
+    thrust::stable_sort_by_key(policy, scratch_values, scratch_values + N,
+                               thrust::make_zip_iterator(thrust::make_tuple(scratch_indices, scratch_slices)),
+                               thrust::greater<float>());
+    thrust::stable_sort_by_key(policy, scratch_slices, scratch_slices + N,
+                               thrust::make_zip_iterator(thrust::make_tuple(scratch_values, scratch_indices)));
+
+    int blocksPerGrid = static_cast<int>(CeilDiv(N, GridDim::maxThreadsPerBlock));
+    _TopKScatterKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+        scratch_values, scratch_indices, values, indices, fast_divmod(static_cast<int>(k)),
+        fast_divmod(static_cast<int>(stride)), N);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
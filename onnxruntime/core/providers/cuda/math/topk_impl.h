@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The largest k whose elements are sorted by the block that selects them. The elements of a larger k are sorted in
+// scratch buffers of slices * k elements.
+constexpr int64_t kTopKMaxBlockSortedK = 1024;
+
+// Writes the k largest elements of each slice of input, and their indices in the slice, in descending order, the
+// equal elements by index. The slices are the elements input[(row * dim + i) * stride + col] for i in [0, dim), and
+// the outputs have the same layout with k elements per slice.
+// Each slice is selected by a block with a radix select, so selecting a few elements of a large dim is linear in dim.
+// The scratch buffers are only used when k > kTopKMaxBlockSortedK, and can be nullptr otherwise.
+Status TopKImpl(const float* input,
+                float* values,
+                int64_t* indices,
+                int64_t rows,
+                int64_t dim,
+                int64_t stride,
+                int64_t k,
+                float* scratch_values,
+                int32_t* scratch_indices,
+                int32_t* scratch_slices);
+
+}  // namespace cuda
+}  // namespace onnxruntime
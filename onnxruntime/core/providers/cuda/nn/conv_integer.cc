@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "conv_integer.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    ConvInteger,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    ConvInteger);
+
+Status IntegerConvBase::ComputeConv(OpKernelContext* context,
+                                    const Tensor& X,
+                                    const Tensor& W,
+                                    const uint8_t* x_zero_point,
+                                    IntegerGemmQuantParams params,
+                                    bool requantize) const {
+  const int64_t N = X.Shape()[0];
+  const int64_t C = X.Shape()[1];
+  const int64_t M = W.Shape()[0];
+  ORT_RETURN_IF_ERROR(ValidateInputShape(&X, &W));
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W.Shape(), kernel_shape));
+  const size_t rank = kernel_shape.size();
+  if (rank > 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "Integer convolutions of more than 3 spatial dimensions are not supported");
+  }
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(rank * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(rank, 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(rank, 1);
+  }
+
+  std::vector<int64_t> Y_dims{N, M};
+  TensorShape input_shape = X.Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(2);
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t group_channels = C / group_;
+  const int64_t group_output_channels = M / group_;
+  const int64_t kernel_dim = group_channels * TensorShape(kernel_shape).Size();
+  const int64_t padded_pixels = IntegerGemmPad(output_image_size);
+  const int64_t padded_kernel_dim = IntegerGemmPad(kernel_dim);
+
+  // the geometry of a group, the missing leading dimensions being 1
+  Im2ColInt8Params im2col_params;
+  im2col_params.channels = group_channels;
+  for (size_t d = 0; d < 3; d++) {
+    const bool is_missing = d + rank < 3;
+    const size_t i = is_missing ? 0 : d + rank - 3;
+    im2col_params.input_shape[d] = is_missing ? 1 : input_shape[i];
+    im2col_params.output_shape[d] = is_missing ? 1 : output_shape[i];
+    im2col_params.kernel_shape[d] = is_missing ? 1 : kernel_shape[i];
+    im2col_params.strides[d] = is_missing ? 1 : strides[i];
+    im2col_params.pads[d] = is_missing ? 0 : pads[i];
+    im2col_params.dilations[d] = is_missing ? 1 : dilations[i];
+  }
+
+  auto packed_w = GetScratchBuffer<int8_t>(M * padded_kernel_dim);
+  PackInt8RowsImpl(W.DataRaw(), false, M, kernel_dim, kernel_dim, false, packed_w.get(), M, padded_kernel_dim);
+  auto col = GetScratchBuffer<int8_t>(padded_pixels * padded_kernel_dim);
+
+  // the patches are the B of the product
+  params.b_zero_point = x_zero_point;
+  params.b_zero_point_per_column = false;
+  params.b_is_signed = false;
+
+  const auto* x_data = X.template Data<uint8_t>();
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    for (int64_t group_id = 0; group_id < group_; ++group_id) {
+      Im2ColInt8Impl(x_data + (image_id * C + group_id * group_channels) * input_image_size, x_zero_point,
+                     im2col_params, col.get(), padded_pixels, padded_kernel_dim);
+
+      // the values of the output channels of the group
+      const int64_t first_channel = group_id * group_output_channels;
+      IntegerGemmQuantParams group_params = params;
+      if (params.a_zero_point_per_row) {
+        group_params.a_zero_point += first_channel;
+      }
+      if (params.a_scale_per_row) {
+        group_params.a_scale += first_channel;
+      }
+      if (params.bias != nullptr) {
+        group_params.bias += first_channel;
+      }
+
+      const int64_t output_offset = (image_id * M + first_channel) * output_image_size;
+      ORT_RETURN_IF_ERROR(ComputePackedGemm(
+          group_output_channels, output_image_size, kernel_dim,
+          packed_w.get() + first_channel * padded_kernel_dim, col.get(), group_params,
+          requantize ? nullptr : Y->template MutableData<int32_t>() + output_offset,
+          requantize ? Y->template MutableData<uint8_t>() + output_offset : nullptr));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status ConvInteger::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+  const int64_t M = W->Shape()[0];
+
+  const uint8_t* x_zero_point = nullptr;
+  const Tensor* X_Zero_Point = context->Input<Tensor>(2);
+  if (X_Zero_Point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(X_Zero_Point), "Must be a scalar or 1D tensor or size 1.");
+    x_zero_point = X_Zero_Point->template Data<uint8_t>();
+  }
+
+  IntegerGemmQuantParams params;
+  const Tensor* W_Zero_Point = context->Input<Tensor>(3);
+  if (W_Zero_Point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(W_Zero_Point) || IsVectorOfSize(W_Zero_Point, M),
+                      "Must be a scalar, 1D tensor of size 1, or 1D tensor with a value for each output channel.");
+    params.a_zero_point = W_Zero_Point->template Data<uint8_t>();
+    params.a_zero_point_per_row = !IsScalarOr1ElementVector(W_Zero_Point);
+  }
+
+  return ComputeConv(context, *X, *W, x_zero_point, params, false);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
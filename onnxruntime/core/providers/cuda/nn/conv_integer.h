@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/math/integer_gemm.h"
+#include "core/providers/cpu/nn/conv_base.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Base of the integer convolutions, which multiply the filters by the patches of the image packed by
+// Im2ColInt8Impl with the int8 GEMM. Up to 3 spatial dimensions are supported.
+class IntegerConvBase : public IntegerGemmBase, public ConvBase {
+ public:
+  IntegerConvBase(const OpKernelInfo& info) : IntegerGemmBase(info), ConvBase(info) {}
+
+ protected:
+  // Convolves the uint8 image X with the uint8 filters W, whose zero points, scales and bias are in params as the
+  // values of the rows of the product, the output channels. The image has the zero point x_zero_point, which is also
+  // its padding. The output is int32, or requantized to uint8 with params if requantize is set.
+  Status ComputeConv(OpKernelContext* context,
+                     const Tensor& X,
+                     const Tensor& W,
+                     const uint8_t* x_zero_point,
+                     IntegerGemmQuantParams params,
+                     bool requantize) const;
+};
+
+class ConvInteger final : public IntegerConvBase {
+ public:
+  ConvInteger(const OpKernelInfo& info) : IntegerConvBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
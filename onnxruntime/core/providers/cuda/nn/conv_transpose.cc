@@ -89,29 +89,56 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
       y_data = reinterpret_cast<CudaT*>(p.Y->template MutableData<T>());
 
       if (!s_.cached_benchmark_results.contains(x_dims)) {
-        IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
-
-        // set math type to tensor core before algorithm search
-        if (std::is_same<T, MLFloat16>::value)
-          CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
-
-        cudnnConvolutionBwdDataAlgoPerf_t perf;
-        int algo_count = 1;
-        CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
-            CudnnHandle(),
-            s_.filter_desc,
-            w_data,
-            s_.x_tensor,
-            x_data,
-            s_.conv_desc,
-            s_.y_tensor,
-            y_data,
-            1,
-            &algo_count,
-            &perf,
-            algo_search_workspace.get(),
-            AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
+        // the algorithms benchmarked by other kernels, sessions or processes are used over the heuristics
+        auto& algo_cache = GetCudnnConvAlgoCache();
+        const std::string algo_key = CudnnConvAlgoCache::MakeKey("ConvTranspose", CudnnTensor::GetDataType<CudaT>(),
+                                                                 x_dims, w_dims, y_dims, p.pads, p.strides,
+                                                                 p.dilations, group_);
+        CudnnConvAlgoPerf cached;
+        if (algo_cache.Lookup(algo_key, cached)) {
+          s_.cached_benchmark_results.insert(x_dims, {static_cast<cudnnConvolutionBwdDataAlgo_t>(cached.algo),
+                                                      cached.memory,
+                                                      static_cast<cudnnMathType_t>(cached.math_type)});
+        } else {
+          // set math type to tensor core before algorithm search
+          if (std::is_same<T, MLFloat16>::value)
+            CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
+
+          cudnnConvolutionBwdDataAlgoPerf_t perf;
+          if (GetCudnnConvAlgoSearch() == CudnnConvAlgoSearch::Heuristic) {
+            cudnnConvolutionBwdDataAlgoPerf_t perfs[CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT];
+            int algo_count = 0;
+            CUDNN_RETURN_IF_ERROR(cudnnGetConvolutionBackwardDataAlgorithm_v7(
+                CudnnHandle(),
+                s_.filter_desc,
+                s_.x_tensor,
+                s_.conv_desc,
+                s_.y_tensor,
+                CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT,
+                &algo_count,
+                perfs));
+            ORT_RETURN_IF_ERROR(FirstSupportedAlgo(perfs, algo_count, perf));
+          } else {
+            IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
+            int algo_count = 1;
+            CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
+                CudnnHandle(),
+                s_.filter_desc,
+                w_data,
+                s_.x_tensor,
+                x_data,
+                s_.conv_desc,
+                s_.y_tensor,
+                y_data,
+                1,
+                &algo_count,
+                &perf,
+                algo_search_workspace.get(),
+                AlgoSearchWorkspaceSize));
+            algo_cache.Insert(algo_key, {perf.algo, perf.memory, perf.mathType});
+          }
+          s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
+        }
       }
 
       const auto& perf = s_.cached_benchmark_results.at(x_dims);
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "qlinearconv.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearConv,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
+    QLinearConv);
+
+Status QLinearConv::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(3);
+  const int64_t M = W->Shape()[0];
+
+  // validate offsets
+  const Tensor* input_offset = context->Input<Tensor>(2);
+  const Tensor* filter_offset = context->Input<Tensor>(5);
+  const Tensor* result_offset = context->Input<Tensor>(7);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(input_offset),
+                    "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(filter_offset) || IsVectorOfSize(filter_offset, M),
+                    "QLinearConv : filter zero point must be a scalar, 1D tensor of size 1, "
+                    "or 1D tensor with a value for each output channel");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(result_offset),
+                    "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
+
+  // validate scale
+  const Tensor* input_scale = context->Input<Tensor>(1);
+  const Tensor* filter_scale = context->Input<Tensor>(4);
+  const Tensor* result_scale = context->Input<Tensor>(6);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(input_scale),
+                    "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(filter_scale) || IsVectorOfSize(filter_scale, M),
+                    "QLinearConv : filter scale must be a scalar, 1D tensor of size 1, "
+                    "or 1D tensor with a value for each output channel");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(result_scale),
+                    "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
+
+  const Tensor* bias = context->Input<Tensor>(8);
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(IsVectorOfSize(bias, M),
+                      "QLinearConv : bias must be a 1D tensor with a value for each output channel");
+  }
+
+  // the filters are the A of the product, and the zero points and scales stay in device memory
+  IntegerGemmQuantParams params;
+  params.a_zero_point = filter_offset->template Data<uint8_t>();
+  params.a_zero_point_per_row = !IsScalarOr1ElementVector(filter_offset);
+  params.a_scale = filter_scale->template Data<float>();
+  params.a_scale_per_row = !IsScalarOr1ElementVector(filter_scale);
+  params.b_scale = input_scale->template Data<float>();
+  params.y_scale = result_scale->template Data<float>();
+  params.y_zero_point = result_offset->template Data<uint8_t>();
+  params.bias = bias == nullptr ? nullptr : bias->template Data<int32_t>();
+
+  return ComputeConv(context, *X, *W, input_offset->template Data<uint8_t>(), params, true);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -57,7 +57,7 @@ void ShrinkImpl(
     T* output_data,
     size_t N) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
-  _ShrinkKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  _ShrinkKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
       input_data, bias, lambda, output_data, (CUDA_LONG)N);
 }
 
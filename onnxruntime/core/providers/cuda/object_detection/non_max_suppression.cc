@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "non_max_suppression.h"
+#include "non_max_suppression_impl.h"
+#include "core/providers/cpu/object_detection/non_max_suppression_helper.h"
+#include "core/providers/cuda/math/topk_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    NonMaxSuppression,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .InputMemoryType<OrtMemTypeCPUInput>(4),
+    NonMaxSuppression);
+
+Status NonMaxSuppression::ComputeInternal(OpKernelContext* ctx) const {
+  PrepareContext pc;
+  ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
+
+  int64_t max_output_boxes_per_class = 0;
+  float iou_threshold = .0f;
+  float score_threshold = .0f;
+  ORT_RETURN_IF_ERROR(nms_helpers::GetThresholdsFromInputs(pc, max_output_boxes_per_class, iou_threshold,
+                                                           score_threshold));
+
+  // a segment is the boxes of a batch with the scores of a class
+  const int64_t num_segments = pc.num_batches_ * pc.num_classes_;
+  const int64_t num_boxes = pc.num_boxes_;
+  if (0 == max_output_boxes_per_class || 0 == num_segments || 0 == num_boxes) {
+    ctx->Output(0, {0, 3});
+    return Status::OK();
+  }
+
+  // the boxes of each segment in the order of their scores
+  const size_t sorted_size = static_cast<size_t>(num_segments * num_boxes);
+  auto sorted_scores = GetScratchBuffer<float>(sorted_size);
+  auto sorted_indices = GetScratchBuffer<int64_t>(sorted_size);
+  IAllocatorUniquePtr<float> scratch_values;
+  IAllocatorUniquePtr<int32_t> scratch_indices;
+  IAllocatorUniquePtr<int32_t> scratch_slices;
+  if (num_boxes > kTopKMaxBlockSortedK) {
+    scratch_values = GetScratchBuffer<float>(sorted_size);
+    scratch_indices = GetScratchBuffer<int32_t>(sorted_size);
+    scratch_slices = GetScratchBuffer<int32_t>(sorted_size);
+  }
+  ORT_RETURN_IF_ERROR(TopKImpl(pc.scores_data_, sorted_scores.get(), sorted_indices.get(), num_segments, num_boxes, 1,
+                               num_boxes, scratch_values.get(), scratch_indices.get(), scratch_slices.get()));
+
+  auto candidate_counts = GetScratchBuffer<int32_t>(num_segments);
+  NmsCountCandidatesImpl(sorted_scores.get(), num_boxes, pc.score_threshold_ != nullptr, score_threshold,
+                         candidate_counts.get(), num_segments);
+
+  // the segments are processed in the order of the stream, so they reuse the mask
+  const int64_t max_selected = std::min(max_output_boxes_per_class, num_boxes);
+  const int64_t mask_words = (num_boxes + kNmsBoxesPerMask - 1) / kNmsBoxesPerMask;
+  auto mask = GetScratchBuffer<uint64_t>(static_cast<size_t>(num_boxes * mask_words));
+  auto selected = GetScratchBuffer<int64_t>(static_cast<size_t>(num_segments * max_selected));
+  auto selected_counts = GetScratchBuffer<int32_t>(num_segments);
+  for (int64_t segment = 0; segment < num_segments; ++segment) {
+    const int64_t batch_index = segment / pc.num_classes_;
+    ORT_RETURN_IF_ERROR(NmsSelectImpl(pc.boxes_data_ + batch_index * num_boxes * 4,
+                                      sorted_indices.get() + segment * num_boxes,
+                                      candidate_counts.get() + segment,
+                                      num_boxes,
+                                      GetCenterPointBox(),
+                                      iou_threshold,
+                                      max_selected,
+                                      mask.get(),
+                                      selected.get() + segment * max_selected,
+                                      selected_counts.get() + segment));
+  }
+
+  // the number of boxes selected sizes the output
+  auto selected_counts_cpu = AllocateBufferOnCPUPinned<int32_t>(GetDeviceId(), num_segments);
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(selected_counts_cpu.get(), selected_counts.get(), num_segments * sizeof(int32_t),
+                                       cudaMemcpyDeviceToHost, CurrentStream()));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(CurrentStream()));
+
+  CudaAsyncBuffer<int32_t> output_offsets(this, GetDeviceId(), num_segments);
+  auto output_offsets_span = output_offsets.CpuSpan();
+  int64_t num_selected = 0;
+  for (int64_t segment = 0; segment < num_segments; ++segment) {
+    output_offsets_span[segment] = gsl::narrow<int32_t>(num_selected);
+    num_selected += selected_counts_cpu.get()[segment];
+  }
+
+  Tensor* output = ctx->Output(0, {num_selected, 3});
+  if (num_selected == 0) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(output_offsets.CopyToGpu());
+  NmsOutputImpl(selected.get(), selected_counts.get(), output_offsets.GpuPtr(), max_selected, pc.num_classes_,
+                output->MutableData<int64_t>(), num_segments);
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/object_detection/non_max_suppression_helper.h"
+#include "non_max_suppression_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The words of the boxes removed by the selected ones are in shared memory.
+constexpr int kNmsMaxMaskWords = 48 * 1024 / sizeof(uint64_t);
+constexpr int kNmsSelectBlockSize = 256;
+
+__global__ void _NmsCountCandidatesKernel(const float* sorted_scores,
+                                          const int num_boxes,
+                                          const bool has_score_threshold,
+                                          const float score_threshold,
+                                          int32_t* candidate_counts,
+                                          const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int count = num_boxes;
+  if (has_score_threshold) {
+    // the first score that doesn't pass
+    const float* scores = sorted_scores + static_cast<int64_t>(id) * num_boxes;
+    int low = 0;
+    int high = num_boxes;
+    while (low < high) {
+      const int mid = (low + high) / 2;
+      if (scores[mid] > score_threshold) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    count = low;
+  }
+  candidate_counts[id] = count;
+}
+
+// Block (x, y) sets bit c of the word (i, x) of the mask if the candidate x * 64 + c overlaps the candidate
+// i = y * 64 + threadIdx.x, which comes first, more than the threshold.
+__global__ void _NmsMaskKernel(const float* boxes,
+                               const int64_t* sorted_indices,
+                               const int32_t* candidate_count,
+                               const int mask_words,
+                               const int64_t center_point_box,
+                               const float iou_threshold,
+                               uint64_t* mask) {
+  const int n = *candidate_count;
+  const int row_block = blockIdx.y;
+  const int col_block = blockIdx.x;
+  if (row_block > col_block || row_block * kNmsBoxesPerMask >= n || col_block * kNmsBoxesPerMask >= n) {
+    return;
+  }
+
+  const int row_size = min(n - row_block * kNmsBoxesPerMask, kNmsBoxesPerMask);
+  const int col_size = min(n - col_block * kNmsBoxesPerMask, kNmsBoxesPerMask);
+  __shared__ int64_t col_boxes[kNmsBoxesPerMask];
+  if (threadIdx.x < col_size) {
+    col_boxes[threadIdx.x] = sorted_indices[col_block * kNmsBoxesPerMask + threadIdx.x];
+  }
+  __syncthreads();
+
+  if (threadIdx.x < row_size) {
+    const int i = row_block * kNmsBoxesPerMask + threadIdx.x;
+    const int64_t row_box = sorted_indices[i];
+    uint64_t bits = 0;
+    for (int c = row_block == col_block ? threadIdx.x + 1 : 0; c < col_size; ++c) {
+      if (nms_helpers::SuppressByIOU(boxes, row_box, col_boxes[c], center_point_box, iou_threshold)) {
+        bits |= 1ull << c;
+      }
+    }
+    mask[static_cast<int64_t>(i) * mask_words + col_block] = bits;
+  }
+}
+
+// Walks the candidates in the order of their scores, keeping those that no kept candidate overlaps.
+__global__ void _NmsSelectKernel(const uint64_t* mask,
+                                 const int64_t* sorted_indices,
+                                 const int32_t* candidate_count,
+                                 const int mask_words,
+                                 const int64_t max_selected,
+                                 int64_t* selected,
+                                 int32_t* selected_count) {
+  __shared__ uint64_t removed[kNmsMaxMaskWords];
+  const int n = *candidate_count;
+  const int words = (n + kNmsBoxesPerMask - 1) / kNmsBoxesPerMask;
+  for (int w = threadIdx.x; w < words; w += blockDim.x) {
+    removed[w] = 0;
+  }
+  __syncthreads();
+
+  int64_t count = 0;
+  for (int i = 0; i < n && count < max_selected; ++i) {
+    const int word = i / kNmsBoxesPerMask;
+    const bool keep = ((removed[word] >> (i % kNmsBoxesPerMask)) & 1) == 0;
+    __syncthreads();
+    if (keep) {
+      if (threadIdx.x == 0) {
+        selected[count] = sorted_indices[i];
+      }
+      ++count;
+      const uint64_t* row = mask + static_cast<int64_t>(i) * mask_words;
+      for (int w = word + threadIdx.x; w < words; w += blockDim.x) {
+        removed[w] |= row[w];
+      }
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.x == 0) {
+    *selected_count = static_cast<int32_t>(count);
+  }
+}
+
+__global__ void _NmsOutputKernel(const int64_t* selected,
+                                 const int32_t* selected_counts,
+                                 const int32_t* output_offsets,
+                                 const fast_divmod max_selected_div,
+                                 const fast_divmod num_classes_div,
+                                 int64_t* output,
+                                 const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int segment, position;
+  max_selected_div.divmod(id, segment, position);
+  if (position >= selected_counts[segment]) {
+    return;
+  }
+
+  int batch_index, class_index;
+  num_classes_div.divmod(segment, batch_index, class_index);
+  int64_t* row = output + (static_cast<int64_t>(output_offsets[segment]) + position) * 3;
+  row[0] = batch_index;
+  row[1] = class_index;
+  row[2] = selected[id];
+}
+
+void NmsCountCandidatesImpl(const float* sorted_scores,
+                            int64_t num_boxes,
+                            bool has_score_threshold,
+                            float score_threshold,
+                            int32_t* candidate_counts,
+                            int64_t num_segments) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(num_segments) / GridDim::maxThreadsPerBlock));
+  _NmsCountCandidatesKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      sorted_scores, static_cast<int>(num_boxes), has_score_threshold, score_threshold, candidate_counts,
+      static_cast<CUDA_LONG>(num_segments));
+}
+
+Status NmsSelectImpl(const float* boxes,
+                     const int64_t* sorted_indices,
+                     const int32_t* candidate_count,
+                     int64_t num_boxes,
+                     int64_t center_point_box,
+                     float iou_threshold,
+                     int64_t max_selected,
+                     uint64_t* mask,
+                     int64_t* selected,
+                     int32_t* selected_count) {
+  // the number of candidates is only known on the device, the blocks past it return
+  const int mask_words = static_cast<int>((num_boxes + kNmsBoxesPerMask - 1) / kNmsBoxesPerMask);
+  ORT_RETURN_IF_NOT(mask_words <= kNmsMaxMaskWords, "NonMaxSuppression supports up to ",
+                    kNmsMaxMaskWords * kNmsBoxesPerMask, " boxes on CUDA, got ", num_boxes);
+
+  const dim3 mask_blocks(mask_words, mask_words);
+  _NmsMaskKernel<<<mask_blocks, kNmsBoxesPerMask, 0, CurrentStream()>>>(
+      boxes, sorted_indices, candidate_count, mask_words, center_point_box, iou_threshold, mask);
+  _NmsSelectKernel<<<1, kNmsSelectBlockSize, 0, CurrentStream()>>>(
+      mask, sorted_indices, candidate_count, mask_words, max_selected, selected, selected_count);
+  return Status::OK();
+}
+
+void NmsOutputImpl(const int64_t* selected,
+                   const int32_t* selected_counts,
+                   const int32_t* output_offsets,
+                   int64_t max_selected,
+                   int64_t num_classes,
+                   int64_t* output,
+                   int64_t num_segments) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(num_segments * max_selected);
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _NmsOutputKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      selected, selected_counts, output_offsets, fast_divmod(static_cast<int>(max_selected)),
+      fast_divmod(static_cast<int>(num_classes)), output, N);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
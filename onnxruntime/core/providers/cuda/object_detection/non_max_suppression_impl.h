@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The boxes of a segment, i.e. a batch and class, are compared 64 at a time.
+constexpr int kNmsBoxesPerMask = 64;
+
+// The number of boxes of each segment whose score passes the threshold. The scores of each segment are sorted in
+// descending order.
+void NmsCountCandidatesImpl(const float* sorted_scores,
+                            int64_t num_boxes,
+                            bool has_score_threshold,
+                            float score_threshold,
+                            int32_t* candidate_counts,
+                            int64_t num_segments);
+
+// Selects the boxes of one segment with a bitmask of the pairs of candidates that overlap more than iou_threshold:
+// mask holds num_boxes * ceil(num_boxes / kNmsBoxesPerMask) words, and selected max_selected indices.
+Status NmsSelectImpl(const float* boxes,
+                     const int64_t* sorted_indices,
+                     const int32_t* candidate_count,
+                     int64_t num_boxes,
+                     int64_t center_point_box,
+                     float iou_threshold,
+                     int64_t max_selected,
+                     uint64_t* mask,
+                     int64_t* selected,
+                     int32_t* selected_count);
+
+// Writes the (batch, class, box) triples of the boxes selected in each segment, starting at the row of
+// output_offsets of the segment.
+void NmsOutputImpl(const int64_t* selected,
+                   const int32_t* selected_counts,
+                   const int32_t* output_offsets,
+                   int64_t max_selected,
+                   int64_t num_classes,
+                   int64_t* output,
+                   int64_t num_segments);
+
+}  // namespace cuda
+}  // namespace onnxruntime
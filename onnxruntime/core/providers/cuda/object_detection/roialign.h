@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/object_detection/roialign.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+class RoiAlign final : public CudaKernel, public RoiAlignBase {
+ public:
+  explicit RoiAlign(const OpKernelInfo& info) : CudaKernel(info), RoiAlignBase(info) {}
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RoiAlign);
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
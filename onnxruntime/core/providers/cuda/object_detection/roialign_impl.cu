@@ -0,0 +1,225 @@
+/**
+* Copyright (c) 2016-present, Facebook, Inc.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+/* Modifications Copyright (c) Microsoft. */
+
+#include "roialign_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+__device__ T bilinear_interpolate(
+    const T* bottom_data,
+    const int64_t height,
+    const int64_t width,
+    T y,
+    T x,
+    const bool is_mode_avg,
+    const bool is_first_sample) {
+  // deal with: inverse elements are out of feature map boundary
+  if (y < -1.0 || y > height || x < -1.0 || x > width) {
+    return 0;
+  }
+
+  if (y <= 0) {
+    y = 0;
+  }
+  if (x <= 0) {
+    x = 0;
+  }
+
+  int64_t y_low = static_cast<int64_t>(y);
+  int64_t x_low = static_cast<int64_t>(x);
+  int64_t y_high;
+  int64_t x_high;
+
+  if (y_low >= height - 1) {
+    y_high = y_low = height - 1;
+    y = (T)y_low;
+  } else {
+    y_high = y_low + 1;
+  }
+
+  if (x_low >= width - 1) {
+    x_high = x_low = width - 1;
+    x = (T)x_low;
+  } else {
+    x_high = x_low + 1;
+  }
+
+  T ly = y - y_low;
+  T lx = x - x_low;
+  T hy = static_cast<T>(1.) - ly;
+  T hx = static_cast<T>(1.) - lx;
+  T w1 = hy * hx;
+  T w2 = hy * lx;
+  T w3 = ly * hx;
+  T w4 = ly * lx;
+
+  T v1 = bottom_data[y_low * width + x_low];
+  T v2 = bottom_data[y_low * width + x_high];
+  T v3 = bottom_data[y_high * width + x_low];
+  T v4 = bottom_data[y_high * width + x_high];
+
+  if (is_mode_avg) {
+    return w1 * v1 + w2 * v2 + w3 * v3 + w4 * v4;
+  }
+  // the max mode of the CPU kernel takes the first corner of the first sample, and the other corners of the
+  // following ones
+  if (is_first_sample) {
+    return w1 * v1;
+  }
+  return _Max(_Max(w2 * v2, w3 * v3), w4 * v4);
+}
+
+template <typename T>
+__global__ void _RoiAlignKernel(
+    const int64_t nthreads,
+    const T* bottom_data,
+    const T spatial_scale,
+    const int64_t channels,
+    const int64_t height,
+    const int64_t width,
+    const int64_t pooled_height,
+    const int64_t pooled_width,
+    const int64_t sampling_ratio,
+    const T* bottom_rois,
+    int64_t roi_cols,
+    T* top_data,
+    const bool is_mode_avg,
+    const int64_t* batch_indices_ptr) {
+  for (size_t index = blockIdx.x * blockDim.x + threadIdx.x; index < nthreads; index += blockDim.x * gridDim.x) {
+    // (n, c, ph, pw) is an element in the pooled output
+    int64_t pw = index % pooled_width;
+    int64_t ph = (index / pooled_width) % pooled_height;
+    int64_t c = (index / pooled_width / pooled_height) % channels;
+    int64_t n = index / pooled_width / pooled_height / channels;
+
+    const T* offset_bottom_rois = bottom_rois + n * roi_cols;
+    const auto roi_batch_ind = batch_indices_ptr[n];
+
+    // Do not using rounding; this implementation detail is critical
+    T roi_start_w = offset_bottom_rois[0] * spatial_scale;
+    T roi_start_h = offset_bottom_rois[1] * spatial_scale;
+    T roi_end_w = offset_bottom_rois[2] * spatial_scale;
+    T roi_end_h = offset_bottom_rois[3] * spatial_scale;
+
+    // Force malformed ROIs to be 1x1
+    T roi_width = _Max(roi_end_w - roi_start_w, (T)1.);
+    T roi_height = _Max(roi_end_h - roi_start_h, (T)1.);
+    T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+    T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+    const T* offset_bottom_data =
+        bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
+
+    // We use roi_bin_grid to sample the grid and mimic integral
+    int64_t roi_bin_grid_h = (sampling_ratio > 0)
+                                 ? sampling_ratio
+                                 : static_cast<int64_t>(_Ceil(roi_height / pooled_height));  // e.g., = 2
+    int64_t roi_bin_grid_w =
+        (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(_Ceil(roi_width / pooled_width));
+
+    // We do average (integral) pooling inside a bin
+    const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
+
+    T output_val = 0.;
+    bool is_first_sample = true;
+    for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
+      const T y = roi_start_h + ph * bin_size_h +
+                  static_cast<T>(iy + .5f) * bin_size_h /
+                      static_cast<T>(roi_bin_grid_h);  // e.g., 0.5, 1.5
+      for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
+        const T x = roi_start_w + pw * bin_size_w +
+                    static_cast<T>(ix + .5f) * bin_size_w /
+                        static_cast<T>(roi_bin_grid_w);
+
+        T val = bilinear_interpolate(
+            offset_bottom_data, height, width, y, x, is_mode_avg, is_first_sample);
+
+        if (is_mode_avg) {
+          output_val += val;
+        } else if (is_first_sample) {
+          output_val = val;
+        } else {
+          output_val = _Max(output_val, val);
+        }
+        is_first_sample = false;
+      }
+    }
+    if (is_mode_avg) {
+      output_val /= count;
+    }
+
+    top_data[index] = output_val;
+  }
+}
+
+template <typename T>
+void RoiAlignImpl(const int64_t nthreads,
+                  const T* bottom_data,
+                  const T spatial_scale,
+                  const int64_t channels,
+                  const int64_t height,
+                  const int64_t width,
+                  const int64_t pooled_height,
+                  const int64_t pooled_width,
+                  const int64_t sampling_ratio,
+                  const T* bottom_rois,
+                  int64_t roi_cols,
+                  T* top_data,
+                  const bool is_mode_avg,
+                  const int64_t* batch_indices_ptr) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(nthreads) / GridDim::maxThreadsPerBlock));
+  _RoiAlignKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
+      nthreads,
+      bottom_data,
+      spatial_scale,
+      channels,
+      height,
+      width,
+      pooled_height,
+      pooled_width,
+      sampling_ratio,
+      bottom_rois,
+      roi_cols,
+      top_data,
+      is_mode_avg,
+      batch_indices_ptr);
+}
+
+#define SPECIALIZED_IMPL(T)                                            \
+  template void RoiAlignImpl<T>(const int64_t nthreads,                \
+                                const T* bottom_data,                  \
+                                const T spatial_scale,                 \
+                                const int64_t channels,                \
+                                const int64_t height,                  \
+                                const int64_t width,                   \
+                                const int64_t pooled_height,           \
+                                const int64_t pooled_width,            \
+                                const int64_t sampling_ratio,          \
+                                const T* bottom_rois,                  \
+                                int64_t roi_cols,                      \
+                                T* top_data,                           \
+                                const bool is_mode_avg,                \
+                                const int64_t* batch_indices_ptr);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+
+}  // namespace cuda
+}  // namespace onnxruntime
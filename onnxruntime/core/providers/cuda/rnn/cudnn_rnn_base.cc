@@ -34,7 +34,7 @@ void CudnnRnnBase<T>::SetWeightBias(const cudnnHandle_t handle,
 
   cudnnGetFilterNdDescriptor(filter_desc, 3, &dt, &tf, &numDims, matDims.data());
   int count = matDims[0] * matDims[1] * matDims[2];
-  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice);
+  cudaMemcpyAsync(mem_offset, pos + offset, count * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream());
   offset += count;
 }
 template <typename T>
@@ -107,8 +107,73 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
 }
 
 template <typename T>
-Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
+Status CudnnRnnBase<T>::SetRnnDescriptors() const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  if (rnn_desc_set_) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                    cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
+  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
+  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+
+  // The persistent kernels have no double precision. Whether they run the RNN on this device is only known from the
+  // workspace size of a shape, or from the first run.
+  if (!std::is_same<T, double>::value) {
+    persistent_supported_ = persistent_rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                                     cudnn_direction_mode_, rnn_mode_,
+                                                     CudnnTensor::GetDataType<CudaT>(),
+                                                     CUDNN_RNN_ALGO_PERSIST_STATIC)
+                                .IsOK();
+  }
+
+  rnn_desc_set_ = true;
+  return Status::OK();
+}
+
+template <typename T>
+Status CudnnRnnBase<T>::GetShapeState(int64_t seq_length, int64_t batch_size, int64_t input_size,
+                                      CudnnRnnShapeState*& state) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  const auto key = std::make_tuple(seq_length, batch_size, input_size);
+  auto it = shape_states_.find(key);
+  if (it != shape_states_.end()) {
+    state = it->second.get();
+    return Status::OK();
+  }
+
+  if (shape_states_.size() >= kCudnnRnnMaxCachedShapes) {
+    shape_states_.clear();
+  }
+
+  auto new_state = std::make_unique<CudnnRnnShapeState>();
+  std::vector<int64_t> dims_x({batch_size, input_size, 1});
+  std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
+  std::vector<int64_t> dims_hxy({RNN_NUM_LAYERS * num_directions_, batch_size, hidden_size_});
+  ORT_RETURN_IF_ERROR(new_state->x_step_desc.Set(dims_x, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_ERROR(new_state->y_step_desc.Set(dims_y, CudnnTensor::GetDataType<CudaT>()));
+  ORT_RETURN_IF_ERROR(new_state->h_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
+  new_state->x_desc.assign(seq_length, new_state->x_step_desc);
+  new_state->y_desc.assign(seq_length, new_state->y_step_desc);
+
+  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc_, gsl::narrow_cast<int>(seq_length),
+                                                 new_state->x_desc.data(), &new_state->workspace_bytes));
+
+  // the shapes the persistent algorithm doesn't support are run by the standard one
+  if (persistent_supported_ && batch_size <= kCudnnRnnPersistMaxBatchSize) {
+    new_state->persistent = cudnnGetRNNWorkspaceSize(CudnnHandle(), persistent_rnn_desc_,
+                                                     gsl::narrow_cast<int>(seq_length), new_state->x_desc.data(),
+                                                     &new_state->persistent_workspace_bytes) == CUDNN_STATUS_SUCCESS;
+  }
+
+  state = new_state.get();
+  shape_states_.emplace(key, std::move(new_state));
+  return Status::OK();
+}
+
+template <typename T>
+Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   // Cache the weight
   const Tensor* W;
   const Tensor* R;
@@ -117,14 +182,14 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   bool get_R = info.TryGetConstantInput(RNN_Input_Index::R, &R);
   bool get_B = info.TryGetConstantInput(RNN_Input_Index::B, &B);
 
+  std::lock_guard<OrtMutex> lock(rnn_state_mutex_);
+  ORT_RETURN_IF_ERROR(SetRnnDescriptors());
+
   if (get_W && get_R) {
-    CudnnRNN tmp_rnn_desc;
-    ORT_RETURN_IF_ERROR(tmp_rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                         cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
     if (get_B) {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, rnn_desc_));
     } else {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, rnn_desc_));
     }
     weight_cached_ = true;
   }
@@ -160,24 +225,11 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
   Tensor* Y_h = ctx->Output(Output_Index::Y_h, dims_hxy);
   Tensor* Y_c = ctx->Output(Output_Index::Y_c, dims_yc);
 
-  std::vector<int64_t> dims_x({batch_size, input_size, 1});
-  std::vector<int64_t> dims_y({batch_size, hidden_size_ * num_directions_, 1});
-
-  CudnnTensor x_desc_temp;
-  x_desc_temp.Set(dims_x, CudnnTensor::GetDataType<CudaT>());
-  CudnnTensor y_desc_temp;
-  y_desc_temp.Set(dims_y, CudnnTensor::GetDataType<CudaT>());
-  std::vector<cudnnTensorDescriptor_t> x_desc(seq_length, x_desc_temp);
-  std::vector<cudnnTensorDescriptor_t> y_desc(seq_length, y_desc_temp);
-
-  CudnnTensor hx_desc;
-  CudnnTensor cx_desc;
-  CudnnTensor y_h_desc;
-  CudnnTensor y_c_desc;
-  ORT_RETURN_IF_ERROR(hx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(cx_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_h_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
-  ORT_RETURN_IF_ERROR(y_c_desc.Set(dims_hxy, CudnnTensor::GetDataType<CudaT>()));
+  // the descriptors are set on the first run of a shape, and shared by the runs, which take the mutex
+  std::lock_guard<OrtMutex> lock(rnn_state_mutex_);
+  ORT_RETURN_IF_ERROR(SetRnnDescriptors());
+  CudnnRnnShapeState* state = nullptr;
+  ORT_RETURN_IF_ERROR(GetShapeState(seq_length, batch_size, input_size, state));
 
   IAllocatorUniquePtr<T> x_reversed_data;
   const T* x_data = X->template Data<T>();
@@ -210,10 +262,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
 
-  CudnnRNN rnn_desc;
-  ORT_RETURN_IF_ERROR(rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                   cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
-
   // Prepare the weight data
   IAllocatorUniquePtr<void> w_data;
   CudnnFilterDescriptor w_desc;
@@ -221,39 +269,50 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(RNN_Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(RNN_Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(RNN_Input_Index::B);
-    ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc);
+    ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc_);
   }
 
-  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
-  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc, CUDNN_RNN_PADDED_IO_ENABLED));
-
-  size_t workspace_bytes;
-  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
-  auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
   int32_t zero_seq_count = 0;
   std::vector<int32_t> zero_seq_index_cache(batch_size, 0);
   int64_t zero_seq_index_cache_size = 0;
 
   if (CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data) {
-    CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
-                                                   rnn_desc,
-                                                   gsl::narrow_cast<int>(seq_length),
-                                                   x_desc.data(),
-                                                   x_data_input,
-                                                   hx_desc,
-                                                   hx_data,
-                                                   cx_desc,
-                                                   cx_data,
-                                                   weight_cached_ ? w_desc_cache_ : w_desc,
-                                                   weight_cached_ ? w_data_cache_.get() : w_data.get(),
-                                                   y_desc.data(),
-                                                   y_data,
-                                                   y_h_desc,
-                                                   y_h_data,
-                                                   y_c_desc,
-                                                   y_c_data,
-                                                   workspace_cuda.get(),
-                                                   workspace_bytes));
+    auto forward = [&](const CudnnRNN& rnn_desc, size_t workspace_bytes) {
+      auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+      return cudnnRNNForwardInference(CudnnHandle(),
+                                      rnn_desc,
+                                      gsl::narrow_cast<int>(seq_length),
+                                      state->x_desc.data(),
+                                      x_data_input,
+                                      state->h_desc,
+                                      hx_data,
+                                      state->h_desc,
+                                      cx_data,
+                                      weight_cached_ ? w_desc_cache_ : w_desc,
+                                      weight_cached_ ? w_data_cache_.get() : w_data.get(),
+                                      state->y_desc.data(),
+                                      y_data,
+                                      state->h_desc,
+                                      y_h_data,
+                                      state->h_desc,
+                                      y_c_data,
+                                      workspace_cuda.get(),
+                                      workspace_bytes);
+    };
+
+    if (state->persistent) {
+      const cudnnStatus_t status = forward(persistent_rnn_desc_, state->persistent_workspace_bytes);
+      if (status != CUDNN_STATUS_NOT_SUPPORTED) {
+        CUDNN_RETURN_IF_ERROR(status);
+      } else {
+        // cuDNN can't run the RNN persistently on this device after all
+        persistent_supported_ = false;
+        state->persistent = false;
+      }
+    }
+    if (!state->persistent) {
+      CUDNN_RETURN_IF_ERROR(forward(rnn_desc_, state->workspace_bytes));
+    }
   } else {
     // cudnn doesn't support 0 sequence inside the batch, find the 0 sequence and set it to 1
     // there's a ZeroMask kernel to reset the result to 0 for the 0 sequence
@@ -282,26 +341,27 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     CudnnDataTensor y_desc;
     y_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, hidden_size_ * num_directions_, seq_len_array.data());
 
+    auto workspace_cuda = GetScratchBuffer<void>(state->workspace_bytes);
     CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInferenceEx(CudnnHandle(),
-                                                     rnn_desc,
+                                                     rnn_desc_,
                                                      x_desc,
                                                      x_data_input,
-                                                     hx_desc,
+                                                     state->h_desc,
                                                      hx_data,
-                                                     cx_desc,
+                                                     state->h_desc,
                                                      cx_data,
                                                      weight_cached_ ? w_desc_cache_ : w_desc,
                                                      weight_cached_ ? w_data_cache_.get() : w_data.get(),
                                                      y_desc,
                                                      y_data,
-                                                     y_h_desc,
+                                                     state->h_desc,
                                                      y_h_data,
-                                                     y_c_desc,
+                                                     state->h_desc,
                                                      y_c_data,
                                                      nullptr, nullptr, nullptr, nullptr,
                                                      nullptr, nullptr, nullptr, nullptr,
                                                      workspace_cuda.get(),
-                                                     workspace_bytes));
+                                                     state->workspace_bytes));
 
     // Early terminate for this case since Y data is not required, and Y_h is obtained correctly, no need the following code to retrive Y_h from Y data.
     if (nullptr == Y) {
@@ -336,7 +396,7 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
     if (Y != nullptr) {
       // User specified this optional output, so need to copy the reversed data to orignial place
-      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice);
+      cudaMemcpyAsync(y_data, y_reorganized_data.get(), output_size * sizeof(T), cudaMemcpyDeviceToDevice, CurrentStream());
     } else {
       y_data = y_reorganized_data.get();
     }
@@ -4,9 +4,12 @@
 #pragma once
 
 #include "gsl/gsl_util"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/cuda_common.h"
 #include <cudnn.h>
+#include <map>
+#include <tuple>
 
 namespace onnxruntime {
 namespace cuda {
@@ -24,6 +27,29 @@ enum RNN_Input_Index {
 // Onnx RNN/GRU/LSTM only support 1 layer
 const int RNN_NUM_LAYERS = 1;
 
+// Batches of up to this many sequences of the same length run with the persistent kernels of cuDNN when they support
+// the RNN, which keep the recurrent weights on chip across the steps, so short sequences of small batches aren't
+// dominated by reloading the weights at each step.
+constexpr int64_t kCudnnRnnPersistMaxBatchSize = 32;
+
+// The shapes whose descriptors are cached; the cache restarts when it's full.
+constexpr size_t kCudnnRnnMaxCachedShapes = 64;
+
+// The descriptors of the inputs and outputs of a shape of X, and the workspace the RNN needs for it.
+struct CudnnRnnShapeState {
+  CudnnTensor x_step_desc;
+  CudnnTensor y_step_desc;
+  // the descriptors of each step of the sequence
+  std::vector<cudnnTensorDescriptor_t> x_desc;
+  std::vector<cudnnTensorDescriptor_t> y_desc;
+  // the descriptor of the initial and final hidden and cell states
+  CudnnTensor h_desc;
+  size_t workspace_bytes = 0;
+  // whether the persistent algorithm runs the sequences of this shape, and its workspace
+  bool persistent = false;
+  size_t persistent_workspace_bytes = 0;
+};
+
 class CudnnRNN {
  public:
   CudnnRNN() : cudnn_rnn_desc_(nullptr) {
@@ -38,7 +64,8 @@ class CudnnRNN {
 
   Status Set(const cudnnHandle_t& cudnnHandle, int64_t hidden_size, int num_layers,
              cudnnDropoutDescriptor_t cudnn_dropout_desc, cudnnDirectionMode_t cudnn_direction_model,
-             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType) {
+             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType,
+             cudnnRNNAlgo_t algo = CUDNN_RNN_ALGO_STANDARD) {
     if (!cudnn_rnn_desc_)
       CUDNN_RETURN_IF_ERROR(cudnnCreateRNNDescriptor(&cudnn_rnn_desc_));
 
@@ -50,7 +77,7 @@ class CudnnRNN {
                                                 CUDNN_LINEAR_INPUT,  // We can also skip the input matrix transformation
                                                 cudnn_direction_model,
                                                 rnn_mode,
-                                                CUDNN_RNN_ALGO_STANDARD,  //CUDNN_RNN_ALGO_PERSIST_STATIC, CUDNN_RNN_ALGO_PERSIST_DYNAMIC
+                                                algo,
                                                 dataType));
 
     return Status::OK();
@@ -120,6 +147,13 @@ class CudnnRnnBase : public CudaKernel {
                            CudnnFilterDescriptor& target_w_desc,
                            CudnnRNN& rnn_desc) const;
 
+  // Sets the RNN descriptors once the mode of the RNN is known. Called with rnn_state_mutex_ held.
+  Status SetRnnDescriptors() const;
+
+  // Gets the descriptors of a shape of X, set on the first run of the shape. Called with rnn_state_mutex_ held.
+  Status GetShapeState(int64_t seq_length, int64_t batch_size, int64_t input_size,
+                       CudnnRnnShapeState*& state) const;
+
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
                      const int pseudo_layer,
@@ -159,6 +193,17 @@ class CudnnRnnBase : public CudaKernel {
   IAllocatorUniquePtr<void> state_buffer_;
   CudnnDropout cudnn_dropout_desc_;
 
+  // The RNN descriptors and the descriptors of the shapes of X, which are set once instead of on every run.
+  // rnn_desc_ runs the standard algorithm, with padded inputs and outputs for variable sequence lengths, and
+  // persistent_rnn_desc_ the persistent static algorithm if cuDNN supports it for the RNN and the device.
+  // Like the state of Conv, they are shared by the runs of the kernel, which take the mutex.
+  mutable OrtMutex rnn_state_mutex_;
+  mutable bool rnn_desc_set_ = false;
+  mutable CudnnRNN rnn_desc_;
+  mutable bool persistent_supported_ = false;
+  mutable CudnnRNN persistent_rnn_desc_;
+  mutable std::map<std::tuple<int64_t, int64_t, int64_t>, std::unique_ptr<CudnnRnnShapeState>> shape_states_;
+
   enum Output_Index {
     Y = 0,
     Y_h = 1,
@@ -20,6 +20,36 @@ enum class SimpleBroadcast : size_t {
   RightPerChannelBatchN = (size_t)-5,
 };
 
+// The stream the CUDA work of the kernel running on this thread is issued on: the stream of its execution provider,
+// or the legacy default stream (nullptr) if the provider wasn't given one.
+cudaStream_t CurrentStream();
+
+// Makes stream the current stream of this thread while it's alive.
+class CurrentStreamScope {
+ public:
+  explicit CurrentStreamScope(cudaStream_t stream);
+  ~CurrentStreamScope();
+  CurrentStreamScope(const CurrentStreamScope&) = delete;
+  CurrentStreamScope& operator=(const CurrentStreamScope&) = delete;
+
+ private:
+  cudaStream_t previous_;
+};
+
+// Whether the work issued on stream is captured into a CUDA graph instead of being run.
+bool IsCapturing(cudaStream_t stream);
+
+// The events a Memcpy node of a profiled session records around its copy, on the stream the copy is issued on, which
+// is one of the copy streams if the provider wasn't given a stream.
+struct CopyTimingEvents {
+  cudaEvent_t start = nullptr;
+  cudaEvent_t end = nullptr;
+  bool recorded = false;
+};
+
+// The copy timing events of the Memcpy node running on this thread, nullptr if there are none.
+CopyTimingEvents* CurrentCopyTiming();
+
 template <typename T>
 class IConstantBuffer {
  public:
@@ -31,7 +31,7 @@ inline cublasStatus_t cublasGemmHelper(cublasHandle_t handle, cublasOperation_t
   float h_a = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(alpha));
   float h_b = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(beta));
   cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH);
-  return cublasGemmEx(handle, transa, transb, m, n, k, &h_a, A, CUDA_R_16F, lda, B, CUDA_R_16F, ldb, &h_b, C, CUDA_R_16F, ldc, CUDA_R_32F, CUBLAS_GEMM_DFALT);
+  return cublasGemmEx(handle, transa, transb, m, n, k, &h_a, A, CUDA_R_16F, lda, B, CUDA_R_16F, ldb, &h_b, C, CUDA_R_16F, ldc, CUDA_R_32F, CUBLAS_GEMM_DEFAULT_TENSOR_OP);
 }
 
 // batched gemm
@@ -43,7 +43,10 @@ inline cublasStatus_t cublasGemmBatchedHelper(cublasHandle_t handle, cublasOpera
 }
 inline cublasStatus_t cublasGemmBatchedHelper(cublasHandle_t handle, cublasOperation_t transa, cublasOperation_t transb, int m, int n, int k, const half* alpha, const half* Aarray[], int lda, const half* Barray[], int ldb, const half* beta, half* Carray[], int ldc, int batchCount) {
   cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH);
-  return cublasHgemmBatched(handle, transa, transb, m, n, k, alpha, (const __half**)Aarray, lda, (const __half**)Barray, ldb, beta, (__half**)Carray, ldc, batchCount);
+  // accumulate in float like the non-batched GEMM, rather than in half with cublasHgemmBatched
+  float h_a = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(alpha));
+  float h_b = onnxruntime::math::halfToFloat(*reinterpret_cast<const uint16_t*>(beta));
+  return cublasGemmBatchedEx(handle, transa, transb, m, n, k, &h_a, (const void**)Aarray, CUDA_R_16F, lda, (const void**)Barray, CUDA_R_16F, ldb, &h_b, (void**)Carray, CUDA_R_16F, ldc, batchCount, CUDA_R_32F, CUBLAS_GEMM_DEFAULT_TENSOR_OP);
 }
 
 // axpy
@@ -81,6 +84,7 @@ inline cublasStatus_t cublasAsumHelper(cublasHandle_t, int n, const half* x, int
   cudnnReduceTensorDescriptor_t reduceTensorDesc;
 
   cudnnCreate(&cudnnHandle);
+  cudnnSetStream(cudnnHandle, onnxruntime::cuda::CurrentStream());
   cudnnCreateTensorDescriptor(&srcTensorDesc);
   cudnnCreateTensorDescriptor(&dstTensorDesc);
   cudnnCreateReduceTensorDescriptor(&reduceTensorDesc);
@@ -118,7 +122,8 @@ inline cublasStatus_t cublasAsumHelper(cublasHandle_t, int n, const half* x, int
                     dstTensorDesc,
                     d_res);
 
-  cudaMemcpy((void*)result, d_res, sizeof(half), cudaMemcpyDeviceToHost);
+  cudaMemcpyAsync((void*)result, d_res, sizeof(half), cudaMemcpyDeviceToHost, onnxruntime::cuda::CurrentStream());
+  cudaStreamSynchronize(onnxruntime::cuda::CurrentStream());
 
   cudnnDestroyReduceTensorDescriptor(reduceTensorDesc);
   cudnnDestroyTensorDescriptor(srcTensorDesc);
@@ -145,6 +150,7 @@ inline cublasStatus_t cublasAmaxHelper(cublasHandle_t, int n, const half* x, int
   cudnnReduceTensorDescriptor_t reduceTensorDesc;
 
   cudnnCreate(&cudnnHandle);
+  cudnnSetStream(cudnnHandle, onnxruntime::cuda::CurrentStream());
   cudnnCreateTensorDescriptor(&srcTensorDesc);
   cudnnCreateTensorDescriptor(&dstTensorDesc);
   cudnnCreateReduceTensorDescriptor(&reduceTensorDesc);
@@ -183,7 +189,9 @@ inline cublasStatus_t cublasAmaxHelper(cublasHandle_t, int n, const half* x, int
                     dstTensorDesc,
                     d_max);
 
-  cudaMemcpy(&h_result_uint, d_result_uint, sizeof(unsigned int), cudaMemcpyDeviceToHost);
+  cudaMemcpyAsync(&h_result_uint, d_result_uint, sizeof(unsigned int), cudaMemcpyDeviceToHost,
+                  onnxruntime::cuda::CurrentStream());
+  cudaStreamSynchronize(onnxruntime::cuda::CurrentStream());
 
   cudnnDestroyReduceTensorDescriptor(reduceTensorDesc);
   cudnnDestroyTensorDescriptor(srcTensorDesc);
@@ -40,7 +40,8 @@ Status Compress::ComputeInternal(OpKernelContext* ctx) const {
   PrefixSumImpl(reinterpret_cast<const int8_t*>(condition_data), condition_cumulative_sum, valid_condition_length);
   
   int32_t positive_condition_count = 0;
-  CUDA_RETURN_IF_ERROR(cudaMemcpy(&positive_condition_count, condition_cumulative_sum + valid_condition_length - 1, sizeof(int32_t), cudaMemcpyDeviceToHost));
+  CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(&positive_condition_count, condition_cumulative_sum + valid_condition_length - 1, sizeof(int32_t), cudaMemcpyDeviceToHost, CurrentStream()));
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(CurrentStream()));
 
   std::vector<int64_t> output_dims(input_dimensions);
   if (has_axis_) {
@@ -59,28 +59,28 @@ Status ExpandImpl(
 
   switch (element_size) {
     case sizeof(uint8_t):
-      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           rank, N, N_input,
           reinterpret_cast<const ToCudaType<uint8_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<uint8_t>::MappedType*>(output_data),
           fdm_input_dims, fdm_output_dims, fdm_output_subdim_size);
       break;
     case sizeof(uint16_t):
-      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           rank, N, N_input,
           reinterpret_cast<const ToCudaType<uint16_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<uint16_t>::MappedType*>(output_data),
           fdm_input_dims, fdm_output_dims, fdm_output_subdim_size);
       break;
     case sizeof(uint32_t):
-      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           rank, N, N_input,
           reinterpret_cast<const ToCudaType<uint32_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<uint32_t>::MappedType*>(output_data),
           fdm_input_dims, fdm_output_dims, fdm_output_subdim_size);
       break;
     case sizeof(uint64_t):
-      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      ExpandKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           rank, N, N_input,
           reinterpret_cast<const ToCudaType<uint64_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<uint64_t>::MappedType*>(output_data),
@@ -36,7 +36,7 @@ Status Flatten::ComputeInternal(OpKernelContext* ctx) const {
   const void* source = X->DataRaw();
   void* target = Y->MutableDataRaw();
   if (target != source) {
-    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X_shape.Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(target, source, X_shape.Size() * X->DataType()->Size(), cudaMemcpyDeviceToDevice, CurrentStream()));
   }
 
   return Status::OK();
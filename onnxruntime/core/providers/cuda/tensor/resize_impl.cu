@@ -163,15 +163,15 @@ void ResizeImpl(const onnxruntime::UpsampleMode upsample_mode,
                 const size_t N) {
   int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
   if (onnxruntime::UpsampleMode::NN == upsample_mode) {
-    _ResizeNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    _ResizeNearestKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         rank, input_pitches, output_div_pitches, scales_vals,
         input_data, output_data, N);
   } else if (onnxruntime::UpsampleMode::LINEAR == upsample_mode && rank == 4) {
-    _ResizeBilinear4DInputKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    _ResizeBilinear4DInputKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         input_dim2, input_pitches, output_div_pitches, scales_vals,
         input_data, output_data, N);
   } else if (onnxruntime::UpsampleMode::LINEAR == upsample_mode && rank == 2) {
-    _ResizeBilinear2DInputKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    _ResizeBilinear2DInputKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
         input_dim2, input_pitches, output_div_pitches, scales_vals,
         input_data, output_data, N);
   }
@@ -45,28 +45,28 @@ Status SliceImpl(const size_t element_size,
 
   switch (element_size) {
     case sizeof(int8_t):
-      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           dimension_count, starts, steps, input_strides, output_div_strides,
           reinterpret_cast<const ToCudaType<int8_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<int8_t>::MappedType*>(output_data),
           (CUDA_LONG)N);
       break;
     case sizeof(int16_t):
-      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           dimension_count, starts, steps, input_strides, output_div_strides,
           reinterpret_cast<const ToCudaType<int16_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<int16_t>::MappedType*>(output_data),
           (CUDA_LONG)N);
       break;
     case sizeof(int32_t):
-      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           dimension_count, starts, steps, input_strides, output_div_strides,
           reinterpret_cast<const ToCudaType<int32_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<int32_t>::MappedType*>(output_data),
           (CUDA_LONG)N);
       break;
     case sizeof(int64_t):
-      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SliceKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           dimension_count, starts, steps, input_strides, output_div_strides,
           reinterpret_cast<const ToCudaType<int64_t>::MappedType*>(input_data),
           reinterpret_cast<ToCudaType<int64_t>::MappedType*>(output_data),
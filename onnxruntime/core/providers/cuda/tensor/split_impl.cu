@@ -56,7 +56,7 @@ Status SplitImpl(const size_t element_size,
 
   switch (element_size) {
     case sizeof(int8_t):
-      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           block_size_including_axis_dim_div, block_size_inside_axis_dim_div,
           split_sizes, split_sizes_range, axis_dimension_input_output_mapping, num_outputs,
           reinterpret_cast<const ToCudaType<int8_t>::MappedType*>(input_data),
@@ -64,7 +64,7 @@ Status SplitImpl(const size_t element_size,
           (CUDA_LONG)N);
       break;
     case sizeof(int16_t):
-      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           block_size_including_axis_dim_div, block_size_inside_axis_dim_div,
           split_sizes, split_sizes_range, axis_dimension_input_output_mapping, num_outputs,
           reinterpret_cast<const ToCudaType<int16_t>::MappedType*>(input_data),
@@ -72,7 +72,7 @@ Status SplitImpl(const size_t element_size,
           (CUDA_LONG)N);
       break;
     case sizeof(int32_t):
-      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           block_size_including_axis_dim_div, block_size_inside_axis_dim_div,
           split_sizes, split_sizes_range, axis_dimension_input_output_mapping, num_outputs,
           reinterpret_cast<const ToCudaType<int32_t>::MappedType*>(input_data),
@@ -80,7 +80,7 @@ Status SplitImpl(const size_t element_size,
           (CUDA_LONG)N);
       break;
     case sizeof(int64_t):
-      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      _SplitKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, CurrentStream()>>>(
           block_size_including_axis_dim_div, block_size_inside_axis_dim_div,
           split_sizes, split_sizes_range, axis_dimension_input_output_mapping, num_outputs,
           reinterpret_cast<const ToCudaType<int64_t>::MappedType*>(input_data),
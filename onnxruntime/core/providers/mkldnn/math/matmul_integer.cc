@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "matmul_integer.h"
+#include <algorithm>
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "mkldnn.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulInteger,
+    kOnnxDomain,
+    10,
+    int8_t,
+    kMklDnnExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    MatMulInteger<uint8_t, int8_t>);
+
+template <>
+Status MatMulInteger<uint8_t, int8_t>::Compute(OpKernelContext* ctx) const {
+  const auto A = ctx->Input<Tensor>(0);
+  const auto B = ctx->Input<Tensor>(1);
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(A->Shape(), B->Shape()));
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  int M = gsl::narrow_cast<int>(helper.M());
+  int N = gsl::narrow_cast<int>(helper.N());
+  int K = gsl::narrow_cast<int>(helper.K());
+
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+  if (K == 0) {
+    std::fill_n(Y->template MutableData<int32_t>(), Y->Shape().Size(), 0);
+    return Status::OK();
+  }
+
+  int32_t a_offset = 0;
+  const auto a_zero_point = ctx->Input<Tensor>(2);
+  if (a_zero_point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_zero_point),
+                      "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
+    a_offset = *a_zero_point->template Data<uint8_t>();
+  }
+
+  std::vector<int32_t> b_offsets(N, 0);
+  bool has_b_offset = false;
+  const auto b_zero_point = ctx->Input<Tensor>(3);
+  if (b_zero_point != nullptr) {
+    const int8_t* b_zero_point_data = b_zero_point->template Data<int8_t>();
+    if (IsScalarOr1ElementVector(b_zero_point)) {
+      std::fill(b_offsets.begin(), b_offsets.end(), static_cast<int32_t>(*b_zero_point_data));
+    } else {
+      ORT_RETURN_IF_NOT(b_zero_point->Shape().NumDimensions() == 1 && b_zero_point->Shape()[0] == N,
+                        "MatmulInteger : input2 zero point must be a scalar or 1D tensor with a value for each column");
+      std::copy(b_zero_point_data, b_zero_point_data + N, b_offsets.begin());
+    }
+    has_b_offset = std::any_of(b_offsets.begin(), b_offsets.end(), [](int32_t offset) { return offset != 0; });
+  }
+
+  // mkldnn_gemm_s8u8s32 takes an int8 offset for each operand, which can't hold every uint8 zero point of A, so
+  // the zero points are applied to the product with the sums of the rows of A and the columns of B:
+  // (A - a) x (B - b) = A x B - a * colsum(B) - rowsum(A) * b + K * a * b
+  std::vector<int32_t> a_row_sums(has_b_offset ? M : 0);
+  std::vector<int32_t> b_col_sums(a_offset != 0 ? N : 0);
+  const float alpha = 1.f;
+  const float beta = 0.f;
+  const int8_t zero_offset = 0;
+  const int32_t zero_c_offset = 0;
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    const uint8_t* a_data = A->template Data<uint8_t>() + helper.LeftOffsets()[i];
+    const int8_t* b_data = B->template Data<int8_t>() + helper.RightOffsets()[i];
+    int32_t* y_data = Y->template MutableData<int32_t>() + helper.OutputOffsets()[i];
+
+    // mkldnn_gemm_s8u8s32 expects col major matrices, so we need to swap the operands A and B.
+    // Like the other int8 paths without VNNI, the pairs of products of the operands may saturate in int16 when both
+    // use their whole ranges.
+    auto status = mkldnn_gemm_s8u8s32("N", "N", "F",
+                                      &N, &M, &K,
+                                      &alpha, b_data, &N, &zero_offset,
+                                      a_data, &K, &zero_offset,
+                                      &beta, y_data, &N, &zero_c_offset);
+    if (status != mkldnn_success) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mkldnn_gemm_s8u8s32 failed with status: ", status);
+    }
+
+    if (a_offset == 0 && !has_b_offset) {
+      continue;
+    }
+    std::fill(a_row_sums.begin(), a_row_sums.end(), 0);
+    std::fill(b_col_sums.begin(), b_col_sums.end(), 0);
+    for (int m = 0; m < static_cast<int>(a_row_sums.size()); m++) {
+      for (int k = 0; k < K; k++) {
+        a_row_sums[m] += a_data[m * K + k];
+      }
+    }
+    for (int k = 0; k < K && !b_col_sums.empty(); k++) {
+      for (int n = 0; n < N; n++) {
+        b_col_sums[n] += b_data[k * N + n];
+      }
+    }
+    for (int m = 0; m < M; m++) {
+      int32_t* y_row = y_data + m * N;
+      for (int n = 0; n < N; n++) {
+        int32_t correction = K * a_offset * b_offsets[n];
+        if (a_offset != 0) {
+          correction -= a_offset * b_col_sums[n];
+        }
+        if (has_b_offset) {
+          correction -= a_row_sums[m] * b_offsets[n];
+        }
+        y_row[n] += correction;
+      }
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
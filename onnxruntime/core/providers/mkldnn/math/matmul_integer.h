@@ -0,0 +1,17 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+template <typename T1, typename T2>
+class MatMulInteger final : public OpKernel {
+ public:
+  MatMulInteger(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
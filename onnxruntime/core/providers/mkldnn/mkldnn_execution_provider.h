@@ -150,8 +150,10 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
   mutable int subgraph_index_ = 0;
 
   // supported MklDnn Operators
-  std::set<std::string> mkldnn_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum",
+  std::set<std::string> mkldnn_ops_ = {"Conv", "BatchNormalization", "Relu", "LeakyRelu", "Sum",
                                        "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN"};
+  // ops with kernels registered outside of the sub-graphs
+  std::set<std::string> mkldnn_int8_ops_ = {"MatMulInteger"};
 
   mutable std::unordered_map<std::string, std::shared_ptr<mkl_dnn::Subgraph>> mkl_subgraphs_;
 };
@@ -410,7 +410,9 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
     {
       // lock to make sure reordering is done only once
       std::lock_guard<OrtMutex> lock(provider_->GetMutex());
-      auto weight_name = OpKernel::Node().InputDefs()[1]->Name();
+      // the blocked format depends on the shapes, so the weights are kept per format
+      auto weight_name = OpKernel::Node().InputDefs()[1]->Name() + "-" +
+                         std::to_string(static_cast<int>(conv_primitive->GetFilterMemoryFormat()));
       std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(weight_name);
 
       if (filter_dst_mem == nullptr) {
@@ -19,8 +19,10 @@ class MklDnnRelu : public MklDnnKernel {
              MKLDNNExecutionProvider* provider,
              const NodeAttributes& attributes,
              const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
-    ORT_UNUSED_PARAMETER(attributes);
-    ORT_UNUSED_PARAMETER(attributes_prefix);
+    if (mklnode_ptr_->name == "LeakyRelu") {
+      alpha_ = 0.01f;
+      ReadAttributes(attributes, attributes_prefix);
+    }
   }
 
   Status CreatePrimitives(const OrtCustomOpApi* api,
@@ -70,7 +72,7 @@ class MklDnnRelu : public MklDnnKernel {
     mkldnn::memory::dims dst_dims_mkl(primitive_dst_shape_.GetDims().begin(), primitive_dst_shape_.GetDims().end());
     mkldnn::algorithm algo = mkldnn::algorithm::eltwise_relu;
     fwd_desc_.reset(new mkldnn::eltwise_forward::desc(
-        mkldnn::prop_kind::forward_inference, algo, *src_md_, 0));
+        mkldnn::prop_kind::forward_inference, algo, *src_md_, alpha_));
 
     relu_fwd_pd_.reset(new mkldnn::eltwise_forward::primitive_desc(
         *fwd_desc_, cpu_engine));
@@ -140,6 +142,19 @@ class MklDnnRelu : public MklDnnKernel {
   }
 
  private:
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    auto attr = attributes.find(attributes_prefix + "alpha");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      GetFloatAttr(proto, alpha_);
+    }
+  }
+
+ private:
+  // negative slope, 0 for Relu
+  float alpha_ = 0.f;
+
   std::shared_ptr<mkldnn::memory> src_mem_;
 
   std::unique_ptr<mkldnn::eltwise_forward::desc> fwd_desc_;
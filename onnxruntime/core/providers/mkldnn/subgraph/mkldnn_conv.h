@@ -273,6 +273,8 @@ class MklDnnConv : public MklDnnKernel {
 
     mkldnn_filter_format_ = static_cast<mkldnn::memory::format>(
         conv_fwd_pd_.get()->weights_primitive_desc().desc().data.format);
+    // the blocked format of the weights depends on the shapes, so the reordered weights are kept per format
+    weights_key_ = mklnode_ptr_->weight_name + "-" + std::to_string(static_cast<int>(mkldnn_filter_format_));
 
     primitive_dst_format_ = static_cast<mkldnn::memory::format>(
         conv_fwd_pd_.get()->dst_primitive_desc().desc().data.format);
@@ -364,7 +366,7 @@ class MklDnnConv : public MklDnnKernel {
     {
       // lock to make sure reordering is done only once
       std::lock_guard<OrtMutex> lock(provider_->GetMutex());
-      std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(weights_key_);
 
       if (filter_dst_mem == nullptr) {
         auto pd = mkldnn::memory::primitive_desc(
@@ -379,7 +381,7 @@ class MklDnnConv : public MklDnnKernel {
         DoReorder<T>(params);
         provider_->SaveAllocatedMemory(std::move(filter_reorder_buffer));
         filter_data = static_cast<T*>(filter_dst_mem->get_data_handle());
-        provider_->SetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_dst_mem);
+        provider_->SetWeightsMemoryBuffer(weights_key_, filter_dst_mem);
       }
     }
   }
@@ -405,10 +407,15 @@ class MklDnnConv : public MklDnnKernel {
       const OrtValue* binput_tensor = ort.KernelContext_GetInput(context, input_index + 2);
       bias_data = const_cast<T*>(ort.GetTensorData<T>(binput_tensor));
     }
-    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    std::shared_ptr<mkldnn::memory> filter_dst_mem;
+    {
+      std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+      filter_dst_mem = provider_->GetWeightsMemoryBuffer(weights_key_);
+    }
     if (filter_dst_mem == nullptr) {
       ReorderWeights(api, context, GetEngine());
-      filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+      std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+      filter_dst_mem = provider_->GetWeightsMemoryBuffer(weights_key_);
     }
     filter_data = static_cast<T*>(filter_dst_mem->get_data_handle());
 
@@ -516,6 +523,7 @@ class MklDnnConv : public MklDnnKernel {
  private:
   mkldnn::memory::format mkldnn_filter_format_;
   mkldnn::memory::format filter_format_;
+  std::string weights_key_;
 
   std::shared_ptr<mkldnn::memory> src_mem_from_;
   std::unique_ptr<mkldnn::memory> src_mem_to_;
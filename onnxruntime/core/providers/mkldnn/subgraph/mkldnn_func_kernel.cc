@@ -79,9 +79,9 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
-      } else if (mkldnn_node.name == "Relu") {
+      } else if (mkldnn_node.name == "Relu" || mkldnn_node.name == "LeakyRelu") {
         std::ostringstream os;
-        os << "Relu-" << mkldnn_node.node_index << "-";
+        os << mkldnn_node.name << "-" << mkldnn_node.node_index << "-";
         std::shared_ptr<MklDnnRelu<T>> kernel;
         kernel.reset(new MklDnnRelu<T>(mkldnn_node, params.provider, params.attributes, os.str()));
         for (auto index : mkldnn_node.parent_nodes) {
@@ -201,8 +201,10 @@ class SubgraphPrimitivePool : public PrimitivePool<T> {
                                    OrtKernelContext* context,
                                    const SubgraphParams& params) {
     Ort::CustomOpApi ort{*api};
+    // the primitives are created for the shapes of all the inputs of the subgraph, not only of its first node
     std::string dims_str;
-    for (auto i = 0; i < params.subgraph->mkldnn_nodes[0].num_inputs; i++) {
+    const size_t num_inputs = ort.KernelContext_GetInputCount(context);
+    for (size_t i = 0; i < num_inputs; i++) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
       auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
       auto tensor_shape = ort.GetTensorShape(tensor_info);
@@ -37,10 +37,28 @@ static bool check_ngraph_dump_ops() {
 #endif
 }
 
+static size_t get_ngraph_lru_cache_size() {
+  std::string tempSize;
+#ifdef _WIN32
+  char* buf{nullptr};
+  size_t bufSize = 0;
+  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
+    tempSize = buf;
+    free(buf);
+  }
+#else
+  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
+    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
+  }
+#endif
+  const int cacheSize = tempSize.empty() ? 0 : std::atoi(tempSize.c_str());
+  return cacheSize > 0 ? static_cast<size_t>(cacheSize) : NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE;
+}
+
 NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
                                const ONNX_NAMESPACE::ModelProto& model_proto,
                                const std::shared_ptr<ngraph::runtime::Backend>& ng_backend) :
-  ng_backend_{ng_backend}, model_proto_{model_proto}
+  ng_backend_{ng_backend}, cache_size_{get_ngraph_lru_cache_size()}, model_proto_{model_proto}
 {
   allocate_func_ = context->allocate_func;
   release_func_ = context->release_func;
@@ -51,143 +69,169 @@ NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
     std::fstream dump(name_ + ".onnx", std::ios::out | std::ios::trunc | std::ios::binary);
     model_proto_.SerializeToOstream(&dump);
   }
+
+  // When all the input shapes are declared, compile for them now rather than in the first run.
+  std::vector<std::vector<int64_t>> input_shapes;
+  for (const auto& input : model_proto_.graph().input()) {
+    if (!input.type().tensor_type().has_shape()) {
+      return;
+    }
+    std::vector<int64_t> shape;
+    for (const auto& dim : input.type().tensor_type().shape().dim()) {
+      if (!dim.has_dim_value()) {
+        return;
+      }
+      shape.push_back(dim.dim_value());
+    }
+    input_shapes.push_back(std::move(shape));
+  }
+  const std::string key = GetShapeKey(input_shapes);
+  ReleaseExecutable(key, CompileExecutable(input_shapes));
 }
 
 NGRAPHCustomOp::~NGRAPHCustomOp() {
-  for (const auto& compiled_exe : ng_exe_map_) {
-    ng_backend_->remove_compiled_function(compiled_exe.second);
+  for (const auto& compiled_exes : ng_exe_map_) {
+    for (const auto& compiled_exe : compiled_exes.second.free) {
+      ng_backend_->remove_compiled_function(compiled_exe);
+    }
   }
 }
 
-//This method gets called in critical path of execution: Optimize
-void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const {
-  Ort::CustomOpApi ort{*api};
-
-  size_t num_inputs = ort.KernelContext_GetInputCount(context);
-
-  //Key for ng_exe_map
+std::string NGRAPHCustomOp::GetShapeKey(const std::vector<std::vector<int64_t>>& input_shapes) {
   std::string uniq_input_shape;
 
   //Optimizing for general case of 4D tensors
-  uniq_input_shape.reserve(4 * sizeof(int64_t) * num_inputs + num_inputs);
-
-  for (size_t i = 0; i < num_inputs; i++) {
-    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
-    auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-    auto tensor_shape = ort.GetTensorShape(tensor_info);
-    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+  uniq_input_shape.reserve(4 * sizeof(int64_t) * input_shapes.size() + input_shapes.size());
 
+  for (const auto& tensor_shape : input_shapes) {
     const auto ndim = tensor_shape.size();
     uniq_input_shape.append(reinterpret_cast<const char*>(&ndim), sizeof(ndim));
     uniq_input_shape.append(reinterpret_cast<const char*>(tensor_shape.data()), ndim * sizeof(int64_t));
   }
+  return uniq_input_shape;
+}
 
-  // Get cache size from environment
-  std::string tempSize;
-  #ifdef _WIN32
-  char *buf{nullptr};
-  size_t bufSize = 0;
-  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
-    tempSize = buf;
-    free(buf);
-  }
-  #else
-  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
-    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
+std::shared_ptr<ngraph::runtime::Executable>
+NGRAPHCustomOp::CompileExecutable(const std::vector<std::vector<int64_t>>& input_shapes) const {
+  LOGS_DEFAULT(INFO) << "[NGRAPHCustomOp] Compiling customOp: " << name_;
+
+  // Clear previous shapes if any and set new input shapes
+  ONNX_NAMESPACE::ModelProto model_proto = model_proto_;
+  auto graph_proto = model_proto.mutable_graph();
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    auto g_in_shape = graph_proto->mutable_input((int)i)->mutable_type()->mutable_tensor_type()->mutable_shape();
+    g_in_shape->clear_dim();
+
+    for (size_t dim = 0; dim < input_shapes[i].size(); dim++) {
+      g_in_shape->add_dim()->set_dim_value(input_shapes[i][dim]);
+    }
   }
-  #endif
-  size_t cacheSize = tempSize.empty() ? NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE : std::stoi(tempSize);
-
-  // Not in cache
-  if (ng_exe_map_.find(uniq_input_shape) == ng_exe_map_.end()) {
-    // Check if full
-    if (keyCache.size() == cacheSize) {
-      // Delete least recently used element
-      std::string last = keyCache.back();
-  
-      // Pop the last elmeent
-      keyCache.pop_back();
-  
-      // Erase the last element from cache
-      ng_exe_map_.erase(ng_exe_map_.find(last)); 
-    } 
-  } 
-  
-  // Found in cache 
-  else {
-    keyCache.remove(uniq_input_shape);
-  }
-  
-  // update reference
-  keyCache.push_front(uniq_input_shape);
-  auto it = ng_exe_map_.insert({uniq_input_shape, nullptr});
-
-  //ng_exe with current shape already exists
-  if (!it.second) {
-    ng_curr_exe_ = it.first->second;
-    return;
-  } else {
-    auto graph_proto = model_proto_.mutable_graph();
 
-    LOGS_DEFAULT(INFO) << "[NGRAPHCustomOp] Compiling customOp: " << name_;
+  std::istringstream model_stream{model_proto.SerializeAsString()};
+  std::shared_ptr<ngraph::Function> ng_function;
+  try {
+    ng_function = ngraph::onnx_import::import_onnx_model(model_stream);
+  } catch (const std::exception& exp) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
+                        << "Exception while importing model to nGraph: " << std::string(exp.what());
+    throw;
+  } catch (...) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
+                        << "Unknown exception while importing model to nGraph";
+    throw;
+  }
 
-    // Clear previous shapes if any and set new input shapes
-    for (size_t i = 0; i < num_inputs; i++) {
-      auto g_in_shape = graph_proto->mutable_input((int)i)->mutable_type()->mutable_tensor_type()->mutable_shape();
-      g_in_shape->clear_dim();
+  for (auto& result : ng_function->get_results()) {
+    result->set_needs_default_layout(true);
+  }
 
-      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
-      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-      auto tensor_shape = ort.GetTensorShape(tensor_info);
-      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+  // Finally compile nGraph with backend.
+  std::shared_ptr<ngraph::runtime::Executable> ng_exe;
+  try {
+    ng_exe = ng_backend_->compile(ng_function);
+  } catch (const std::exception& exp) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
+                        << "Exception while compiling ngraph::Function: " << std::string(exp.what());
+  } catch (...) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - " << "Unknown exception while compiling ngraph::Function";
+  }
+  return ng_exe;
+}
 
-      for (size_t dim = 0; dim < tensor_shape.size(); dim++) {
-        g_in_shape->add_dim()->set_dim_value(tensor_shape[dim]);
+//This method gets called in critical path of execution: Optimize
+std::shared_ptr<ngraph::runtime::Executable>
+NGRAPHCustomOp::AcquireExecutable(const std::string& key, const std::vector<std::vector<int64_t>>& input_shapes) const {
+  {
+    std::lock_guard<std::mutex> lock(compute_lock_);
+    auto it = ng_exe_map_.find(key);
+    if (it != ng_exe_map_.end()) {
+      // update reference
+      keyCache.splice(keyCache.begin(), keyCache, it->second.key_it);
+      if (!it->second.free.empty()) {
+        auto ng_exe = std::move(it->second.free.back());
+        it->second.free.pop_back();
+        return ng_exe;
       }
     }
+  }
 
-    std::istringstream model_stream{model_proto_.SerializeAsString()};
-    std::shared_ptr<ngraph::Function> ng_function;
-    try {
-      ng_function = ngraph::onnx_import::import_onnx_model(model_stream);
-    } catch (const std::exception& exp) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Exception while importing model to nGraph: " << std::string(exp.what());
-      throw;
-    } catch (...) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Unknown exception while importing model to nGraph";
-      throw;
-    }
+  // Not in cache, or all its executables are being called by other runs.
+  return CompileExecutable(input_shapes);
+}
 
-    for (auto& result : ng_function->get_results()) {
-      result->set_needs_default_layout(true);
-    }
+void NGRAPHCustomOp::ReleaseExecutable(const std::string& key, std::shared_ptr<ngraph::runtime::Executable> ng_exe) const {
+  if (ng_exe == nullptr) {
+    return;
+  }
 
-    // Finally compile nGraph with backend.
-    try {
-      ng_curr_exe_ = ng_backend_->compile(ng_function);
-    } catch (const std::exception& exp) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Exception while compiling ngraph::Function: " << std::string(exp.what());
-    } catch (...) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - " << "Unknown exception while compiling ngraph::Function";
+  std::vector<std::shared_ptr<ngraph::runtime::Executable>> evicted;
+  {
+    std::lock_guard<std::mutex> lock(compute_lock_);
+    auto it = ng_exe_map_.find(key);
+    if (it == ng_exe_map_.end()) {
+      // Check if full
+      if (keyCache.size() >= cache_size_) {
+        // Delete least recently used element
+        auto last = ng_exe_map_.find(keyCache.back());
+        evicted = std::move(last->second.free);
+        ng_exe_map_.erase(last);
+        keyCache.pop_back();
+      }
+      keyCache.push_front(key);
+      it = ng_exe_map_.emplace(key, CachedExecutables{{}, keyCache.begin()}).first;
     }
-    it.first->second = ng_curr_exe_;
+    it->second.free.push_back(std::move(ng_exe));
   }
-}  // namespace ngraph_ep
+
+  for (const auto& evicted_exe : evicted) {
+    ng_backend_->remove_compiled_function(evicted_exe);
+  }
+}
 
 //This method gets called in critical path of execution: Optimize
 Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const {
   Ort::CustomOpApi ort{*api};
 
-  // Initialize nGraph function if it is not already initialized.
-  {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    Initialize(api, context);
+  size_t num_inputs = ort.KernelContext_GetInputCount(context);
+  std::vector<std::vector<int64_t>> input_shapes(num_inputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
+    auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+    input_shapes[i] = ort.GetTensorShape(tensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
   }
 
-  ORT_ENFORCE(ng_curr_exe_ != nullptr);
+  const std::string key = GetShapeKey(input_shapes);
+  auto ng_exe = AcquireExecutable(key, input_shapes);
+  ORT_ENFORCE(ng_exe != nullptr);
+
+  Status status = Run(*ng_exe, api, context);
+  ReleaseExecutable(key, std::move(ng_exe));
+  return status;
+}
+
+Status NGRAPHCustomOp::Run(ngraph::runtime::Executable& ng_exe, const OrtCustomOpApi* api, OrtKernelContext* context) const {
+  Ort::CustomOpApi ort{*api};
 
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_inputs;
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_outputs;
@@ -195,10 +239,9 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   // Write ONNXR input data to nGraph input tensors.
   try {
     unsigned input_index = 0;
-    for (const auto& ng_param : ng_curr_exe_->get_parameters()) {
+    for (const auto& ng_param : ng_exe.get_parameters()) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index++);
       void* input_data = const_cast<void*>(ort.GetTensorData<void>(input_tensor));
-      std::lock_guard<std::mutex> lock(compute_lock_);
       ng_inputs.emplace_back(ng_backend_->create_tensor(ng_param->get_output_element_type(0), ng_param->get_output_shape(0), input_data));
     }
   } catch (const std::exception& exp) {
@@ -211,14 +254,13 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   try {
     //TODO: Optimize
     unsigned output_index = 0;
-    for (auto& ng_result : ng_curr_exe_->get_results()) {
+    for (auto& ng_result : ng_exe.get_results()) {
       const auto& dtype = ng_result->get_element_type();
       const auto& shape = ng_result->get_shape();
 
       std::vector<int64_t> ort_shape{shape.begin(), shape.end()};
       OrtValue* output_tensor = ort.KernelContext_GetOutput(context, output_index++, ort_shape.data(), ort_shape.size());
       void* output_data = ort.GetTensorMutableData<void>(output_tensor);
-      std::lock_guard<std::mutex> lock(compute_lock_);
       ng_outputs.emplace_back(ng_backend_->create_tensor(dtype, shape, output_data));
     }
   } catch (const std::exception& exp) {
@@ -229,8 +271,7 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
 
   // Run the graph through nGraph.
   try {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    if (!ng_curr_exe_->call(ng_outputs, ng_inputs))
+    if (!ng_exe.call(ng_outputs, ng_inputs))
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Error while executing nGraph computation");
   } catch (const std::exception& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Exception while executing nGraph computation: " + std::string(exp.what()));
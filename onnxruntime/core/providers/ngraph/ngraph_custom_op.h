@@ -34,11 +34,24 @@ class NGRAPHCustomOp {
   ~NGRAPHCustomOp();
 
  private:
-  void Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const;
+  /*
+  Logically, key = [i0.rank,[i0.dims],i1.rank,[i1.dims] ... iN.rank,[iN.dims]] raw bytes enclosed inside a string.
+  Example: input0.shape(1,2,3) input1.shape(4,5)
+  key = [3,1,2,3,2,4,5]
+  */
+  static std::string GetShapeKey(const std::vector<std::vector<int64_t>>& input_shapes);
 
-  std::shared_ptr<ngraph::runtime::Backend> ng_backend_;
+  std::shared_ptr<ngraph::runtime::Executable> CompileExecutable(const std::vector<std::vector<int64_t>>& input_shapes) const;
+
+  // An executable of the input shapes no other run is calling, compiled if there is none.
+  std::shared_ptr<ngraph::runtime::Executable> AcquireExecutable(const std::string& key,
+                                                                 const std::vector<std::vector<int64_t>>& input_shapes) const;
+
+  void ReleaseExecutable(const std::string& key, std::shared_ptr<ngraph::runtime::Executable> ng_exe) const;
 
-  mutable std::shared_ptr<ngraph::runtime::Executable> ng_curr_exe_ = nullptr;
+  Status Run(ngraph::runtime::Executable& ng_exe, const OrtCustomOpApi* api, OrtKernelContext* context) const;
+
+  std::shared_ptr<ngraph::runtime::Backend> ng_backend_;
 
   AllocateFunc allocate_func_ = nullptr;
 
@@ -49,18 +62,22 @@ class NGRAPHCustomOp {
   std::string name_;
 
   /*
-  nGraph::Executable objects are specific to input shapes.
-  Here we keep of a cache of nGraph::Executable objects with key as input shapes. TODO: Configure size of this cache.
-  Logically, key = [i0.rank,[i0.dims],i1.rank,[i1.dims] ... iN.rank,[iN.dims]] raw bytes enclosed inside a string.
-  Example: input0.shape(1,2,3) input1.shape(4,5)
-  key = [3,1,2,3,2,4,5]
-*/
-  mutable std::unordered_map<std::string, std::shared_ptr<ngraph::runtime::Executable>> ng_exe_map_;
+  nGraph::Executable objects are specific to input shapes, and a call of one doesn't run concurrently with another.
+  Here we keep a cache of the nGraph::Executable objects not being called, with key as input shapes, for the
+  cache_size_ most recently used shapes. Concurrent runs of the same shapes call executables of their own.
+  */
+  struct CachedExecutables {
+    std::vector<std::shared_ptr<ngraph::runtime::Executable>> free;
+    std::list<std::string>::iterator key_it;
+  };
+  mutable std::unordered_map<std::string, CachedExecutables> ng_exe_map_;
   mutable std::list<std::string> keyCache;
-  
+  size_t cache_size_;
+
+  // Guards the cache only, the executables are compiled and called without it.
   mutable std::mutex compute_lock_;
 
-  mutable ONNX_NAMESPACE::ModelProto model_proto_;
+  const ONNX_NAMESPACE::ModelProto model_proto_;
 };
 }  // namespace ngraph_ep
 }  // namespace onnxruntime
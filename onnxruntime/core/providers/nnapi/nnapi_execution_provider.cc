@@ -14,8 +14,8 @@ namespace onnxruntime {
 
 constexpr const char* NNAPI = "Nnapi";
 
-NnapiExecutionProvider::NnapiExecutionProvider()
-    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider} {
+NnapiExecutionProvider::NnapiExecutionProvider(const NnapiExecutionProviderInfo& info)
+    : IExecutionProvider{onnxruntime::kNnapiExecutionProvider}, info_(info) {
   DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                               [](int) { return std::make_unique<CPUAllocator>(
                                                             std::make_unique<OrtMemoryInfo>(NNAPI,
@@ -32,6 +32,18 @@ NnapiExecutionProvider::NnapiExecutionProvider()
 
 NnapiExecutionProvider::~NnapiExecutionProvider() {}
 
+static uint32_t GetDnnPreference(OrtNnapiExecutionPreference preference) {
+  switch (preference) {
+    case ORT_NNAPI_PREFER_LOW_POWER:
+      return dnn::ModelBuilder::PREFERENCE_LOW_POWER;
+    case ORT_NNAPI_PREFER_FAST_SINGLE_ANSWER:
+      return dnn::ModelBuilder::PREFERENCE_FAST_SINGLE_ANSWER;
+    case ORT_NNAPI_PREFER_SUSTAINED_SPEED:
+    default:
+      return dnn::ModelBuilder::PREFERENCE_SUSTAINED_SPEED;
+  }
+}
+
 std::vector<std::vector<int>> NnapiExecutionProvider::GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const {
   dnn::OnnxConverter converter;
   return converter.GetSupportedNodes(model_proto);
@@ -210,8 +222,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     dnn::OnnxReader onnx_reader;
     dnn::ModelBuilder model_builder;
     onnx_reader.ReadOnnx(model_proto, model_builder);
-    model_builder.AllowFp16(true);
-    auto dnn_model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
+    model_builder.AllowFp16(info_.relax_fp32_to_fp16);
+    auto dnn_model = model_builder.Compile(GetDnnPreference(info_.execution_preference));
     dnn_models_.emplace(fused_node->Name(), std::move(dnn_model));
 
     NodeComputeInfo compute_info;
@@ -4,12 +4,21 @@
 
 #include "core/framework/execution_provider.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/providers/nnapi/nnapi_provider_factory.h"
 #include "dnnlibrary/Model.h"
 
 namespace onnxruntime {
+
+// Information needed to construct NNAPI execution providers.
+struct NnapiExecutionProviderInfo {
+  // Let NNAPI compute float32 tensors with the range and precision of float16.
+  bool relax_fp32_to_fp16{true};
+  OrtNnapiExecutionPreference execution_preference{ORT_NNAPI_PREFER_SUSTAINED_SPEED};
+};
+
 class NnapiExecutionProvider : public IExecutionProvider {
  public:
-  NnapiExecutionProvider();
+  explicit NnapiExecutionProvider(const NnapiExecutionProviderInfo& info = NnapiExecutionProviderInfo());
   virtual ~NnapiExecutionProvider();
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -19,6 +28,7 @@ class NnapiExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
  private:
+  NnapiExecutionProviderInfo info_;
   std::unordered_map<std::string, std::unique_ptr<dnn::Model>> dnn_models_;
   std::vector<std::vector<int>> GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const;
 };
@@ -9,18 +9,25 @@ using namespace onnxruntime;
 namespace onnxruntime {
 
 struct NnapiProviderFactory : IExecutionProviderFactory {
-  NnapiProviderFactory() {}
+  NnapiProviderFactory(const NnapiExecutionProviderInfo& info) : info_(info) {}
   ~NnapiProviderFactory() override {}
 
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
+
+ private:
+  NnapiExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> NnapiProviderFactory::CreateProvider() {
-  return std::make_unique<NnapiExecutionProvider>();
+  return std::make_unique<NnapiExecutionProvider>(info_);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi(const NnapiExecutionProviderInfo& info) {
+  return std::make_shared<onnxruntime::NnapiProviderFactory>(info);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Nnapi() {
-  return std::make_shared<onnxruntime::NnapiProviderFactory>();
+  return CreateExecutionProviderFactory_Nnapi(NnapiExecutionProviderInfo());
 }
 }  // namespace onnxruntime
 
@@ -29,4 +36,18 @@ ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nnapi, _In_ OrtSess
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_Nnapi_WithOptions, _In_ OrtSessionOptions* options,
+                    int relax_fp32_to_fp16, OrtNnapiExecutionPreference execution_preference) {
+  if (execution_preference != ORT_NNAPI_PREFER_LOW_POWER &&
+      execution_preference != ORT_NNAPI_PREFER_FAST_SINGLE_ANSWER &&
+      execution_preference != ORT_NNAPI_PREFER_SUSTAINED_SPEED) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "Invalid NNAPI execution preference");
+  }
+  onnxruntime::NnapiExecutionProviderInfo info;
+  info.relax_fp32_to_fp16 = relax_fp32_to_fp16 != 0;
+  info.execution_preference = execution_preference;
+  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_Nnapi(info));
+  return nullptr;
+}
+
 
@@ -32,7 +32,12 @@ static const std::unordered_set<std::string> valid_keys = {
     kNupharCacheSoName,
     kNupharCacheModelChecksum,
     kNupharCacheForceNoJIT,
-    kNupharCodeGenTarget};
+    kNupharCodeGenTarget,
+    kNupharCompileThreads,
+    kNupharSpecializedDims,
+    kNupharTuning,
+    kNupharTuningLog,
+    kNupharTuningRepeat};
 
 void SetDefaultOptions(std::map<std::string, std::string>& options) {
   // create two temporary strings to get rid of the odr-use issue introduced
@@ -33,6 +33,24 @@ constexpr static const char* kNupharActivations_DeepCpu = "deep_cpu_activation";
 // Option to control nuphar code generation target (avx2 or avx512)
 constexpr static const char* kNupharCodeGenTarget = "nuphar_codegen_target";
 
+// Number of threads compiling the subgraphs of a fused node, 0 for the number of cores. Compiles on 1 thread if not set
+constexpr static const char* kNupharCompileThreads = "nuphar_compile_threads";
+
+// Values of symbolic dims to generate extra code for, like "seq=1;batch=1&seq=16" for two versions, one with seq 1,
+// another one with batch 1 and seq 16. The generic code runs when the realized dims match no version
+constexpr static const char* kNupharSpecializedDims = "nuphar_specialized_dims";
+
+// Set to "on" to tune the schedules of subgraphs with constant shapes while compiling. Candidate tile sizes, vector
+// widths and loop orders are timed on the current CPU and the fastest one is appended to the tuning log
+constexpr static const char* kNupharTuning = "nuphar_tuning";
+// Path of the tuning log. Defaults to tuning.log in the versioned cache directory when nuphar_cache_path is set.
+// Schedules found in the log are used whenever a subgraph is JIT compiled, whether tuning is on or not
+constexpr static const char* kNupharTuningLog = "nuphar_tuning_log";
+// Number of timed runs of each candidate schedule, 10 if not set
+constexpr static const char* kNupharTuningRepeat = "nuphar_tuning_repeat";
+
+constexpr static const char* kNupharTuningLog_Default = "tuning.log";
+
 // cache version number (MAJOR.MINOR.PATCH) following https://semver.org/
 // 1. MAJOR version when you make incompatible changes that old cache files no longer work,
 // 2. MINOR version when you add functionality in a backwards - compatible manner, and
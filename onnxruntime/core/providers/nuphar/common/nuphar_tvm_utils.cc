@@ -7,6 +7,7 @@
 #include "core/providers/nuphar/common/nuphar_settings.h"
 #include "core/codegen/common/common.h"
 #include "core/codegen/common/target_info.h"
+#include "core/codegen/common/utils.h"
 
 #include "core/common/logging/logging.h"
 #include "core/platform/env.h"
@@ -16,6 +17,7 @@
 #include <tvm/ir_pass.h>
 #include <experimental/filesystem>
 #include <fstream>
+#include <sstream>
 namespace fs = std::experimental::filesystem;
 
 namespace onnxruntime {
@@ -70,6 +72,170 @@ static bool GetCacheSoFilePath(std::string& so_path) {
   return false;
 }
 
+bool GetTuningLogFilePath(std::string& log_path, bool create) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(kNupharTuningLog)) {
+    log_path = settings.GetOptionValue(kNupharTuningLog);
+    return true;
+  }
+
+  fs::path path;
+  if (!GetOrCreateTVMModuleCacheDirectory(path, create))
+    return false;
+
+  path.append(kNupharTuningLog_Default);
+  log_path = path.string();
+  return true;
+}
+
+// The file of a marshalled weight starts with a header holding the element size and the shape,
+// padded so that the data is aligned for the generated code when the file is memory mapped
+static constexpr char kWeightLayoutFileMagic[8] = {'N', 'U', 'P', 'H', 'W', 'L', '0', '1'};
+static constexpr size_t kWeightLayoutFileAlignment = 64;
+
+static size_t WeightLayoutFileDataOffset(size_t rank) {
+  size_t header_size = sizeof(kWeightLayoutFileMagic) + sizeof(uint64_t) * (2 + rank);
+  return (header_size + kWeightLayoutFileAlignment - 1) / kWeightLayoutFileAlignment * kWeightLayoutFileAlignment;
+}
+
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+  // FNV-1a, which is stable across platforms and runs
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string GetWeightLayoutCacheKey(const std::string& initializer_name,
+                                    const std::string& layout_name,
+                                    const void* original_data,
+                                    size_t original_size) {
+  // different names may normalize to the same string, so the name is hashed along with the data
+  uint64_t hash = HashBytes(initializer_name.data(), initializer_name.size());
+  hash = HashBytes(original_data, original_size, hash);
+  std::ostringstream key;
+  key << NormalizeCppName(initializer_name) << "_" << NormalizeCppName(layout_name) << "_" << std::hex << hash;
+  return key.str();
+}
+
+static bool GetWeightLayoutFilePath(const std::string& key, bool create, fs::path& path) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+
+  // without a model checksum, a cached weight could silently come from another version of the model
+  if (!settings.HasOption(kNupharCacheModelChecksum))
+    return false;
+
+  if (!GetOrCreateTVMModuleCacheDirectory(path, create))
+    return false;
+
+  path.append("weight_layouts_" + NormalizeCppName(settings.GetOptionValue(kNupharCacheModelChecksum)));
+  if (!fs::is_directory(path)) {
+    if (!create)
+      return false;
+    fs::create_directory(path);
+  }
+
+  path.append(key + ".bin");
+  return true;
+}
+
+const void* LoadWeightLayoutFromCache(const std::string& key,
+                                      size_t element_size,
+                                      const std::vector<int64_t>& shape) {
+  fs::path path;
+  if (!GetWeightLayoutFilePath(key, /*create*/ false, path) || !fs::is_regular_file(path))
+    return nullptr;
+
+  // the mapped views stay alive for the lifetime of the process, so that sessions created later share them.
+  // They are clean file backed pages, which cost address space rather than memory.
+  struct MappedWeightLayout {
+    void* data;
+    size_t size;
+    OrtCallback deleter;
+  };
+  static std::mutex mapped_mutex;
+  static std::unordered_map<std::string, MappedWeightLayout> mapped_files;
+
+  const size_t data_offset = WeightLayoutFileDataOffset(shape.size());
+  const size_t data_size = element_size * gsl::narrow<size_t>(TotalSize(shape));
+
+  std::lock_guard<std::mutex> lock(mapped_mutex);
+  auto it = mapped_files.find(path.string());
+  if (it != mapped_files.end())
+    return it->second.size == data_size ? it->second.data : nullptr;
+
+  std::ifstream file(path.string(), std::ios::binary);
+  char magic[sizeof(kWeightLayoutFileMagic)];
+  uint64_t file_element_size = 0;
+  uint64_t file_rank = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&file_element_size), sizeof(file_element_size));
+  file.read(reinterpret_cast<char*>(&file_rank), sizeof(file_rank));
+  std::vector<int64_t> file_shape(file && file_rank == shape.size() ? shape.size() : 0);
+  file.read(reinterpret_cast<char*>(file_shape.data()), file_shape.size() * sizeof(int64_t));
+  if (!file ||
+      memcmp(magic, kWeightLayoutFileMagic, sizeof(magic)) != 0 ||
+      file_element_size != element_size ||
+      file_shape != shape ||
+      fs::file_size(path) != data_offset + data_size) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cached weight layout " << path << " does not match, recomputing...";
+    return nullptr;
+  }
+  file.close();
+
+  void* data = nullptr;
+  OrtCallback deleter{nullptr, nullptr};
+  Status status = Env::Default().MapFileIntoMemory(path.c_str(), gsl::narrow<off_t>(data_offset), data_size, data, deleter);
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Failed to map cached weight layout " << path << ": "
+                                             << status.ErrorMessage();
+    return nullptr;
+  }
+
+  mapped_files.emplace(path.string(), MappedWeightLayout{data, data_size, deleter});
+  return data;
+}
+
+void SaveWeightLayoutToCache(const std::string& key,
+                             size_t element_size,
+                             const std::vector<int64_t>& shape,
+                             const void* data) {
+  fs::path path;
+  if (!GetWeightLayoutFilePath(key, /*create*/ true, path) || fs::exists(path))
+    return;
+
+  // write to a temporary file first, so that other processes never map a partial file
+  fs::path tmp_path = path;
+  tmp_path += "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream file(tmp_path.string(), std::ios::binary);
+    const uint64_t file_element_size = element_size;
+    const uint64_t file_rank = shape.size();
+    file.write(kWeightLayoutFileMagic, sizeof(kWeightLayoutFileMagic));
+    file.write(reinterpret_cast<const char*>(&file_element_size), sizeof(file_element_size));
+    file.write(reinterpret_cast<const char*>(&file_rank), sizeof(file_rank));
+    file.write(reinterpret_cast<const char*>(shape.data()), shape.size() * sizeof(int64_t));
+
+    const size_t header_size = sizeof(kWeightLayoutFileMagic) + sizeof(uint64_t) * (2 + shape.size());
+    const std::vector<char> padding(WeightLayoutFileDataOffset(shape.size()) - header_size, 0);
+    file.write(padding.data(), padding.size());
+    file.write(static_cast<const char*>(data), element_size * gsl::narrow<size_t>(TotalSize(shape)));
+    if (!file) {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Failed to save weight layout to " << tmp_path;
+      file.close();
+      fs::remove(tmp_path);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+  }
+}
+
 static void* GetFuncFromLibrary(const std::string& so_path, const std::string& func_name, bool throw_if_not_found = true) {
   void* so_handle;
   ORT_ENFORCE(Env::Default().LoadDynamicLibrary(so_path, &so_handle).IsOK());
@@ -86,41 +252,40 @@ static bool VerifyTVMModuleChecksum(const std::string& so_path) {
   static std::string last_so_path;
   static bool last_checksum_validated = false;
   static std::mutex checksum_mutex;
+  // the subgraphs may be compiled on several threads
+  std::lock_guard<std::mutex> lock(checksum_mutex);
   if (last_so_path != so_path) {
-    std::lock_guard<std::mutex> lock(checksum_mutex);
-    if (last_so_path != so_path) {
-      disable_caching_due_to_checksum_failure = false;  // reset disabled caching for a new file
-      last_so_path = so_path;
-      void* f = GetFuncFromLibrary(so_path, "_ORTInternal_GetCheckSum", /*throw_if_not_found*/ false);
-      if (f) {
-        typedef void (*GetChecksumFunc)(const char*&, size_t&);
-        GetChecksumFunc func = reinterpret_cast<GetChecksumFunc>(f);
-        const char* model_checksum;
-        size_t model_checksum_len;
-        func(model_checksum,
-             model_checksum_len);
-
-        codegen::CodeGenSettings& setting = codegen::CodeGenSettings::Instance();
-        // When checksum is expected by dll/so, user must set environment variable
-        // NUPHAR_CACHE_MODEL_CHECKSUM from md5 digest of running model.
-        // User may choose to run with base model or simplified mode and any match
-        // would be regarded as validated.
-        // Note that checksum validation here is not designed as a security measurement,
-        // so checksum compute is not done inside ORT.
-        last_checksum_validated =
-            setting.OptionMatches(
-                kNupharCacheModelChecksum,
-                std::string(model_checksum, model_checksum_len));
-
-        if (!last_checksum_validated) {
-          LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cache checksum validation failed, using JIT...";
-          disable_caching_due_to_checksum_failure = true;
-        }
-      } else {
-        // do not validate checksum if dll didn't require it (usually during debugging)
-        // TODO: force checksum validation in final release
-        last_checksum_validated = true;
+    disable_caching_due_to_checksum_failure = false;  // reset disabled caching for a new file
+    last_so_path = so_path;
+    void* f = GetFuncFromLibrary(so_path, "_ORTInternal_GetCheckSum", /*throw_if_not_found*/ false);
+    if (f) {
+      typedef void (*GetChecksumFunc)(const char*&, size_t&);
+      GetChecksumFunc func = reinterpret_cast<GetChecksumFunc>(f);
+      const char* model_checksum;
+      size_t model_checksum_len;
+      func(model_checksum,
+           model_checksum_len);
+
+      codegen::CodeGenSettings& setting = codegen::CodeGenSettings::Instance();
+      // When checksum is expected by dll/so, user must set environment variable
+      // NUPHAR_CACHE_MODEL_CHECKSUM from md5 digest of running model.
+      // User may choose to run with base model or simplified mode and any match
+      // would be regarded as validated.
+      // Note that checksum validation here is not designed as a security measurement,
+      // so checksum compute is not done inside ORT.
+      last_checksum_validated =
+          setting.OptionMatches(
+              kNupharCacheModelChecksum,
+              std::string(model_checksum, model_checksum_len));
+
+      if (!last_checksum_validated) {
+        LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cache checksum validation failed, using JIT...";
+        disable_caching_due_to_checksum_failure = true;
       }
+    } else {
+      // do not validate checksum if dll didn't require it (usually during debugging)
+      // TODO: force checksum validation in final release
+      last_checksum_validated = true;
     }
   }
   return last_checksum_validated;
@@ -142,7 +307,8 @@ tvm::runtime::PackedFunc LoadTVMPackedFuncFromCache(const std::string& func_name
   return func;
 }
 
-thread_local int saved_tvm_model_cnt = 0;
+// guarded by the mutex of SaveTVMModuleToCache, so the files saved from different threads get different names
+static int saved_tvm_model_cnt = 0;
 
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module) {
   fs::path path;
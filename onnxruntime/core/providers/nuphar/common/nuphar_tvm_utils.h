@@ -4,6 +4,7 @@
 #pragma once
 #include <tvm/tvm.h>
 #include <string>
+#include <vector>
 
 #include "core/graph/graph.h"
 
@@ -20,6 +21,27 @@ tvm::runtime::PackedFunc
 LoadTVMPackedFuncFromCache(const std::string& func_name);
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module);
 
+// Helper functions to persist the marshalled weights of WeightLayouts in the cache directory, keyed by the model
+// checksum in nuphar_cache_model_checksum, so that they are neither transformed nor copied again by later sessions.
+// A loaded weight is a read-only memory mapped view of its file, shared by all the sessions in the process.
+// The key of a weight hashes its original data too, since initializers of subgraphs may share names
+std::string GetWeightLayoutCacheKey(const std::string& initializer_name,
+                                    const std::string& layout_name,
+                                    const void* original_data,
+                                    size_t original_size);
+// Returns nullptr if the weight is not cached or the file does not match element_size and shape
+const void* LoadWeightLayoutFromCache(const std::string& key,
+                                      size_t element_size,
+                                      const std::vector<int64_t>& shape);
+void SaveWeightLayoutToCache(const std::string& key,
+                             size_t element_size,
+                             const std::vector<int64_t>& shape,
+                             const void* data);
+
+// Gets the path of the schedule tuning log, either from the settings or in the cache directory
+// The cache directory is created if create is true
+bool GetTuningLogFilePath(std::string& log_path, bool create);
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target);
 
 }  // namespace nuphar
@@ -62,6 +62,15 @@ struct NupharFuncInfo {
   // PackedFunc
   tvm::runtime::PackedFunc packed_func;
 
+  // PackedFuncs generated for the given values of some symbolic dims,
+  // called instead of packed_func when the realized dims match
+  struct SpecializedFunc {
+    std::vector<std::pair<std::string, int64_t>> dims;
+    tvm::runtime::PackedFunc packed_func;
+  };
+
+  std::vector<SpecializedFunc> specialized_funcs;
+
   // TVM DLDevice
   DLDeviceType device_type;
 
@@ -78,9 +78,27 @@ static const Tensor* Marshalling(
     const tvm_codegen::WeightLayout* layout_ptr,
     WeightLayoutCtx& ctx_layout,
     AllocatorPtr allocator) {
-  tvm::runtime::PackedFunc packed_func;
-
   const std::string& layout_key = layout_ptr->Name();
+  std::vector<int64_t> marshalled_shape = layout_ptr->ToActualShape(original_initializer);
+  auto marshalled_size = TotalSize(marshalled_shape);
+  auto byte_size = original_initializer->DataType()->Size();
+
+  // a weight marshalled by an earlier session is mapped from the cache, skipping both the transform and the copy
+  const std::string cache_key = nuphar::GetWeightLayoutCacheKey(initializer_name, layout_key,
+                                                                original_initializer->DataRaw(),
+                                                                original_initializer->SizeInBytes());
+  const void* cached_data = nuphar::LoadWeightLayoutFromCache(cache_key, byte_size, marshalled_shape);
+  if (nullptr != cached_data) {
+    global_generated_initializers.emplace(
+        initializer_name,
+        std::make_unique<Tensor>(original_initializer->DataType(),
+                                 TensorShape(marshalled_shape),
+                                 const_cast<void*>(cached_data),
+                                 allocator->Info()));
+    return global_generated_initializers.at(initializer_name).get();
+  }
+
+  tvm::runtime::PackedFunc packed_func;
   if (ctx_layout.weight_layout_to_packed_func.count(layout_key) == 0) {
     packed_func = LowerLayoutFunc(layout_ptr);
     ctx_layout.weight_layout_to_packed_func.insert(std::make_pair(layout_key, packed_func));
@@ -88,19 +106,7 @@ static const Tensor* Marshalling(
     packed_func = ctx_layout.weight_layout_to_packed_func[layout_key];
   }
 
-  std::vector<int64_t> marshalled_shape = layout_ptr->ToActualShape(original_initializer);
-  auto marshalled_size = TotalSize(marshalled_shape);
-  auto byte_size = original_initializer->DataType()->Size();
-
-  std::unique_ptr<Tensor> out_ptr;
   void* p_data = allocator->Alloc(marshalled_size * byte_size);
-  out_ptr = std::make_unique<Tensor>(
-      original_initializer->DataType(),
-      TensorShape(marshalled_shape),
-      p_data,
-      allocator->Info());
-
-  global_generated_initializers.emplace(initializer_name, std::move(out_ptr));
 
   int num_args = 2;
   DLContext tvm_ctx{kDLCPU, 0};
@@ -130,6 +136,21 @@ static const Tensor* Marshalling(
   tvm::TVMArgs tvm_args(lvalues.data(), types_code.data(), num_args);
   tvm::TVMRetValue rvalue;
   packed_func.CallPacked(tvm_args, &rvalue);
+
+  // when the weight could be saved to the cache, use the mapped file so that all sessions share one copy
+  nuphar::SaveWeightLayoutToCache(cache_key, byte_size, marshalled_shape, p_data);
+  cached_data = nuphar::LoadWeightLayoutFromCache(cache_key, byte_size, marshalled_shape);
+  if (nullptr != cached_data) {
+    allocator->Free(p_data);
+    p_data = const_cast<void*>(cached_data);
+  }
+
+  global_generated_initializers.emplace(
+      initializer_name,
+      std::make_unique<Tensor>(original_initializer->DataType(),
+                               TensorShape(marshalled_shape),
+                               p_data,
+                               allocator->Info()));
   return global_generated_initializers.at(initializer_name).get();
 }
 
@@ -15,6 +15,10 @@
 #include "core/providers/nuphar/compiler/nuphar_op_ir_builder.h"
 #include "core/providers/nuphar/compiler/nuphar_schedule_builder.h"
 
+#include <chrono>
+#include <limits>
+#include <mutex>
+
 namespace onnxruntime {
 namespace nuphar {
 
@@ -161,7 +165,12 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
       }
     }
 
-    tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_);
+    NupharScheduleConfig schedule_config;
+    if (!ScheduleTuningLog::Instance().Lookup(func_name, schedule_config) && IsScheduleTuningEnabled()) {
+      TuneSchedule(func_name, tvm_target, tvm_host_target, config, schedule_config);
+    }
+
+    tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_, schedule_config);
     std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
     tvm::Array<tvm::LoweredFunc> lowered = tvm::lower(tvm_schedule, tvm_args_, func_name, binds, config);
 
@@ -187,6 +196,94 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
   return cached_func;
 }
 
+bool NupharCompiler::TuneSchedule(const std::string& func_name,
+                                  tvm::Target tvm_target,
+                                  tvm::Target tvm_host_target,
+                                  const tvm::BuildConfig& config,
+                                  NupharScheduleConfig& best_config) {
+  // the candidates run on zero filled buffers, so all the shapes need to be known
+  std::vector<std::vector<int64_t>> shapes;
+  for (const auto& arg : tvm_args_) {
+    std::vector<int64_t> shape;
+    for (const auto& dim : arg->shape) {
+      const int64_t* value = tvm::as_const_int(dim);
+      if (nullptr == value) {
+        LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Skip tuning " << func_name << " with symbolic dims";
+        return false;
+      }
+      shape.push_back(*value);
+    }
+    shapes.push_back(std::move(shape));
+  }
+
+  const AllocatorPtr& allocator = context_.GetCodeGenHandle()->allocator;
+  const size_t num_args = tvm_args_.size();
+  std::vector<IAllocatorUniquePtr<void>> buffers;
+  std::vector<DLTensor> tvm_tensors(num_args);
+  std::vector<TVMValue> lvalues(num_args);
+  for (size_t i = 0; i < num_args; ++i) {
+    const tvm::Type& type = tvm_args_[i]->dtype;
+    DLDataType tvm_dtype{static_cast<uint8_t>(type.code()), static_cast<uint8_t>(type.bits()),
+                         static_cast<uint16_t>(type.lanes())};
+    int64_t num_elements = 1;
+    for (int64_t dim : shapes[i])
+      num_elements *= dim;
+    size_t num_bytes = std::max<size_t>(gsl::narrow<size_t>(num_elements) * ((type.bits() * type.lanes() + 7) / 8), 1);
+
+    buffers.push_back(IAllocator::MakeUniquePtr<void>(allocator, num_bytes));
+    memset(buffers.back().get(), 0, num_bytes);
+    tvm_tensors[i] = {buffers.back().get(), DLContext{kDLCPU, 0},
+                      gsl::narrow_cast<int>(shapes[i].size()), tvm_dtype,
+                      shapes[i].data(), nullptr, 0};
+    lvalues[i].v_handle = &(tvm_tensors[i]);
+  }
+  std::vector<int> types_code(num_args, kNDArrayContainer);
+  tvm::TVMArgs tvm_args(lvalues.data(), types_code.data(), gsl::narrow_cast<int>(num_args));
+
+  // subgraphs may be compiled on several threads, so time one candidate at a time to keep the numbers comparable
+  static std::mutex tuning_mutex;
+  std::lock_guard<std::mutex> lock(tuning_mutex);
+
+  const int repeat = GetScheduleTuningRepeat();
+  double best_us = std::numeric_limits<double>::max();
+  for (const auto& candidate : GetScheduleCandidates()) {
+    tvm::runtime::PackedFunc func;
+    try {
+      tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_, candidate);
+      std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
+      tvm::Array<tvm::LoweredFunc> lowered = tvm::lower(tvm_schedule, tvm_args_, func_name, binds, config);
+      tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
+      func = module.GetFunction(func_name);
+    } catch (const std::exception& ex) {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Tuning " << func_name << " skipped schedule "
+                                               << candidate.ToString() << ": " << ex.what();
+      continue;
+    }
+    if (func == nullptr)
+      continue;
+
+    tvm::TVMRetValue rvalue;
+    func.CallPacked(tvm_args, &rvalue);  // warm up
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeat; ++r)
+      func.CallPacked(tvm_args, &rvalue);
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    double avg_us = elapsed.count() / repeat;
+    if (avg_us < best_us) {
+      best_us = avg_us;
+      best_config = candidate;
+    }
+  }
+
+  if (best_us == std::numeric_limits<double>::max())
+    return false;
+
+  ScheduleTuningLog::Instance().Record(func_name, best_config, best_us);
+  return true;
+}
+
 static tvm::BuildConfig CreateConfig(const Node& node,
                                      bool allow_unaligned_buffers) {
   tvm::BuildConfig config = tvm::build_config();
@@ -202,25 +299,44 @@ static tvm::BuildConfig CreateConfig(const Node& node,
   return config;
 }
 
-// Lower compiles the tvm::Tensor to a function
-Status NupharCompiler::Lower(const nuphar::NupharSubgraphUnit& subgraph,
-                             tvm::Target tvm_target,
-                             tvm::Target tvm_host_target,
-                             NupharFuncInfo* func_info,
-                             nuphar::OrtSubgraphAllocationInfo* partition_info) {
+void NupharCompiler::SpecializeDims(const std::vector<std::pair<std::string, int64_t>>& dims) {
+  for (const auto& dim : dims) {
+    context_.SpecializeDynamicDim(dim.first, dim.second);
+    func_name_suffix_ += "_" + NormalizeCppName(dim.first) + "_" + std::to_string(dim.second);
+  }
+}
+
+// Generate compiles the tvm::Tensor to a function
+Status NupharCompiler::Generate(const nuphar::NupharSubgraphUnit& subgraph,
+                                tvm::Target tvm_target,
+                                tvm::Target tvm_host_target) {
   const auto& target_codegen = *context_.GetCodeGenHandle()->codegen_target;
-  std::string func_name = nuphar::GetPackedFuncName(subgraph, target_codegen);
+  func_name_ = nuphar::GetPackedFuncName(subgraph, target_codegen) + func_name_suffix_;
   tvm::BuildConfig config = CreateConfig(*subgraph.nodes.front(),
                                          context_.GetCodeGenHandle()->allow_unaligned_buffers);
 
   // using "subgraph" for type and name for now
   // TODO: change name
-  tvm::runtime::PackedFunc cached_func =
+  generated_func_ =
       GetLoweredPackedFunc(
-          func_name, tvm_target, tvm_host_target,
+          func_name_, tvm_target, tvm_host_target,
           config, "subgraph", "subgraph");
 
-  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, cached_func, func_name);
+  return Status::OK();
+}
+
+// Lower fills the NupharFuncInfo of the compiled function
+Status NupharCompiler::Lower(const nuphar::NupharSubgraphUnit& subgraph,
+                             tvm::Target tvm_target,
+                             tvm::Target tvm_host_target,
+                             NupharFuncInfo* func_info,
+                             nuphar::OrtSubgraphAllocationInfo* partition_info) {
+  if (generated_func_ == nullptr) {
+    ORT_RETURN_IF_ERROR(Generate(subgraph, tvm_target, tvm_host_target));
+  }
+
+  // the offsets of the allocations are given in the order of the subgraphs, so this part stays sequential
+  FillNupharFuncInfo(func_info, partition_info, subgraph, context_, tvm_target, generated_func_, func_name_);
 
   return Status::OK();
 }
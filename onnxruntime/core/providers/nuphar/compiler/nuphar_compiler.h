@@ -9,6 +9,7 @@
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/compiler/nuphar_codegen_ctx.h"
 #include "core/providers/nuphar/compiler/nuphar_handle.h"
+#include "core/providers/nuphar/compiler/nuphar_schedule_tuning.h"
 #include "core/providers/nuphar/compiler/traverse_shape_infer.h"
 #include "core/framework/op_kernel.h"
 #include "core/graph/graph.h"
@@ -31,10 +32,19 @@ class NupharCompiler {
                  std::unordered_map<std::string, std::unique_ptr<Tensor>>& generated_initializers,
                  const NupharCodeGenHandle* handle);
 
+  // SpecializeDims generates code for the given values of some symbolic dims, and is called before Build
+  void SpecializeDims(const std::vector<std::pair<std::string, int64_t>>& dims);
+
   // Build builds tvm IR and apply passes
   Status Build(const nuphar::NupharSubgraphUnit& subgraph);
 
-  // Lower lowers the built tvm IR to llvm ir and compiles it
+  // Generate lowers the built tvm IR to llvm ir and compiles it.
+  // The compilers of different subgraphs can generate concurrently.
+  Status Generate(const nuphar::NupharSubgraphUnit& subgraph,
+                  tvm::Target tvm_target,
+                  tvm::Target tvm_host_target);
+
+  // Lower fills ctx_func with the compiled function, generating it first if Generate was not called
   Status Lower(const nuphar::NupharSubgraphUnit& subgraph,
                tvm::Target tvm_target,
                tvm::Target tvm_host_target,
@@ -49,16 +59,35 @@ class NupharCompiler {
       const std::string& subgraph_type,
       const std::string& subgraph_name);
 
+  const tvm::runtime::PackedFunc& GetGeneratedFunc() const {
+    return generated_func_;
+  }
+
  private:
   size_t num_initializers_in_graph_inputs_;
 
   // BuildSubgraph builds tvm IR and apply passes for a subgraph
   Status BuildSubgraph(const Node& node);
 
+  // TuneSchedule times the built subgraph with each candidate schedule and records the fastest one in the
+  // tuning log. It returns false if the subgraph has symbolic dims or no candidate could be built
+  bool TuneSchedule(const std::string& func_name,
+                    tvm::Target tvm_target,
+                    tvm::Target tvm_host_target,
+                    const tvm::BuildConfig& config,
+                    NupharScheduleConfig& best_config);
+
   NupharCodeGenCtx context_;
 
   tvm::Array<tvm::Tensor> tvm_args_;
   tvm::Array<tvm::Tensor> tvm_outputs_;
+
+  // the function compiled by Generate
+  std::string func_name_;
+  tvm::runtime::PackedFunc generated_func_;
+
+  // keeps the functions of the specialized dims apart from the generic one in the cache
+  std::string func_name_suffix_;
 };
 
 }  // namespace nuphar
@@ -9,16 +9,96 @@
 
 #include "core/providers/nuphar/common/analysis/subgraph_codegen_stats.h"
 
+#include <algorithm>
+
 // TODO change name space
 namespace onnxruntime {
 namespace nuphar {
 
+// TryTunedOutputSchedule applies the tunable part of the schedule to a real output.
+// Like TryVectorization, the innermost axis is split by the vector width and vectorized.
+// In addition, the second innermost axis may be tiled so that a block of rows is computed
+// for each vectorized chunk of the innermost axis, and the two outermost axes may be interchanged.
+static bool TryTunedOutputSchedule(const tvm::Tensor& tensor,
+                                   const NupharScheduleConfig& schedule_config,
+                                   tvm_codegen::ScheduleContext& ctx_schedule) {
+  if (schedule_config.IsDefault()) {
+    return TryVectorization(tensor, schedule_config.vector_width, ctx_schedule);
+  }
+
+  auto it = ctx_schedule.scheduled_tensors.find(tensor->op.get());
+  if (it != ctx_schedule.scheduled_tensors.end() && it->second > tvm_codegen::ScheduleType::ScheduleInline) {
+    return false;
+  }
+
+  auto compute_op = tensor->op.as<tvm::ComputeOpNode>();
+  if (nullptr == compute_op || compute_op->axis.size() < 1) {
+    return false;
+  }
+
+  const size_t rank = compute_op->axis.size();
+  const int64_t* tail_dim = as_const_int(tensor->shape[rank - 1]);
+  if (nullptr == tail_dim) {
+    return false;
+  }
+
+  auto& stage = ctx_schedule.schedule[tensor->op];
+  std::vector<tvm::IterVar> outer_axes(compute_op->axis.begin(), compute_op->axis.end() - 1);
+  if (schedule_config.interchange && outer_axes.size() >= 2) {
+    std::swap(outer_axes[0], outer_axes[1]);
+  }
+
+  // tile the second innermost axis only when its extent is a known multiple of tile_rows
+  tvm::IterVar yi;
+  bool tiled = false;
+  if (rank >= 2 && schedule_config.tile_rows > 1) {
+    const int64_t* row_dim = as_const_int(tensor->shape[rank - 2]);
+    if (nullptr != row_dim && *row_dim > schedule_config.tile_rows && *row_dim % schedule_config.tile_rows == 0) {
+      tvm::IterVar y = compute_op->axis[rank - 2];
+      tvm::IterVar yo;
+      stage.split(y, schedule_config.tile_rows, &yo, &yi);
+      std::replace_if(
+          outer_axes.begin(), outer_axes.end(), [&y](const tvm::IterVar& v) { return v.same_as(y); }, yo);
+      tiled = true;
+    }
+  }
+
+  tvm::IterVar x = compute_op->axis[rank - 1];
+  tvm::IterVar xo;
+  tvm::IterVar xi = x;
+  bool vectorized = false;
+  if (*tail_dim > schedule_config.vector_width) {
+    if (*tail_dim % schedule_config.vector_width == 0) {
+      stage.split(x, schedule_config.vector_width, &xo, &xi);
+      vectorized = true;
+    }
+  } else if (*tail_dim > 0) {
+    // don't vectorize if dim is 0
+    vectorized = true;
+  }
+
+  tvm::Array<tvm::IterVar> order(outer_axes.begin(), outer_axes.end());
+  if (xo.defined())
+    order.push_back(xo);
+  if (tiled)
+    order.push_back(yi);
+  order.push_back(xi);
+  if (order.size() > 1)
+    stage.reorder(order);
+
+  if (vectorized)
+    stage.vectorize(xi);
+
+  return vectorized || tiled || (schedule_config.interchange && outer_axes.size() >= 2);
+}
+
 // Traverse iterates a tvm::Tensor and itself dependencies
 // and builds schedule (in ScheduleContext)
 // based on corresponding ORT ir and TVM ir
 static void Traverse(const tvm::Tensor& tensor,
                      const Node* node,
                      NupharCodeGenCtx& ctx_codegen,
+                     const NupharScheduleConfig& schedule_config,
                      tvm_codegen::ScheduleContext& ctx_schedule) {
   // no need to traverse on nodes already marked as closured
   if (ctx_schedule.scheduled_tensors.count(tensor->op.get()) > 0) {
@@ -34,10 +114,8 @@ static void Traverse(const tvm::Tensor& tensor,
                         Promote<CodeGenUnitStats>(ctx_codegen.GetGraphStats())->IsOutputNode(node);
 
   if (is_real_output) {
-    // TODO change it to the value from Target
-    int64_t natural_vector_size = 16;
-
-    TryVectorization(tensor, natural_vector_size, ctx_schedule);  // to x86
+    // TODO change the default vector width to the value from Target
+    TryTunedOutputSchedule(tensor, schedule_config, ctx_schedule);  // to x86
     InsertRootScheduleAndClosure(tensor, ctx_schedule);
   }
 
@@ -46,13 +124,14 @@ static void Traverse(const tvm::Tensor& tensor,
     // check whether it is a tensor having inputs
     if (t->op->InputTensors().size() > 0) {
       auto current_node = ctx_codegen.FindNode(t);
-      Traverse(t, current_node, ctx_codegen, ctx_schedule);
+      Traverse(t, current_node, ctx_codegen, schedule_config, ctx_schedule);
     }
   }
 }
 
 tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
-                             NupharCodeGenCtx& ctx_codegen) {
+                             NupharCodeGenCtx& ctx_codegen,
+                             const NupharScheduleConfig& schedule_config) {
   // Create scheudule object
   tvm::Array<tvm::Operation> out_ops;
   for (auto& t : outs) {
@@ -67,7 +146,7 @@ tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
   // Schedule all outputs
   for (const auto& t : outs) {
     const Node* node = ctx_codegen.FindNode(t);
-    Traverse(t, node, ctx_codegen, ctx_schedule);
+    Traverse(t, node, ctx_codegen, schedule_config, ctx_schedule);
   }
 
   return ctx_schedule.schedule;
@@ -6,6 +6,7 @@
 #include <tvm/tvm.h>
 #include "core/common/common.h"
 #include "core/providers/nuphar/compiler/nuphar_codegen_ctx.h"
+#include "core/providers/nuphar/compiler/nuphar_schedule_tuning.h"
 
 // TODO change name space
 namespace onnxruntime {
@@ -13,8 +14,10 @@ namespace nuphar {
 
 // Traverse iterates tvm::Array<tvm::Tensor> a single node
 // and builds the whole schedule (in CodeGenContext)
+// The real outputs are scheduled with schedule_config
 tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
-                             NupharCodeGenCtx& ctx_codegen);
+                             NupharCodeGenCtx& ctx_codegen,
+                             const NupharScheduleConfig& schedule_config = NupharScheduleConfig());
 
 }  // namespace nuphar
 }  // namespace onnxruntime
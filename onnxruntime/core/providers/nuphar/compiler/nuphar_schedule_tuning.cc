@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/nuphar/compiler/nuphar_schedule_tuning.h"
+
+#include "core/codegen/common/settings.h"
+#include "core/common/logging/logging.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
+#include "core/providers/nuphar/common/nuphar_tvm_utils.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace onnxruntime {
+namespace nuphar {
+
+bool NupharScheduleConfig::IsDefault() const {
+  const NupharScheduleConfig default_config;
+  return vector_width == default_config.vector_width &&
+         tile_rows == default_config.tile_rows &&
+         interchange == default_config.interchange;
+}
+
+std::string NupharScheduleConfig::ToString() const {
+  return "v" + std::to_string(vector_width) +
+         "_t" + std::to_string(tile_rows) +
+         "_i" + (interchange ? "1" : "0");
+}
+
+bool NupharScheduleConfig::FromString(const std::string& str, NupharScheduleConfig& config) {
+  int vector_width = 0;
+  int tile_rows = 0;
+  int interchange = 0;
+  char tail = 0;
+  if (sscanf(str.c_str(), "v%d_t%d_i%d%c", &vector_width, &tile_rows, &interchange, &tail) != 3 ||
+      vector_width < 1 || tile_rows < 1 || (interchange != 0 && interchange != 1))
+    return false;
+
+  config.vector_width = vector_width;
+  config.tile_rows = tile_rows;
+  config.interchange = interchange != 0;
+  return true;
+}
+
+const std::vector<NupharScheduleConfig>& GetScheduleCandidates() {
+  static const std::vector<NupharScheduleConfig> candidates = []() {
+    std::vector<NupharScheduleConfig> result(1);
+    for (int vector_width : {4, 8, 16, 32, 64}) {
+      for (int tile_rows : {1, 2, 4, 8}) {
+        for (bool interchange : {false, true}) {
+          NupharScheduleConfig config;
+          config.vector_width = vector_width;
+          config.tile_rows = tile_rows;
+          config.interchange = interchange;
+          if (!config.IsDefault())
+            result.push_back(config);
+        }
+      }
+    }
+    return result;
+  }();
+  return candidates;
+}
+
+bool IsScheduleTuningEnabled() {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  return settings.HasOption(kNupharTuning) && settings.OptionMatches(kNupharTuning, "on");
+}
+
+int GetScheduleTuningRepeat() {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(kNupharTuningRepeat)) {
+    int repeat = std::stoi(settings.GetOptionValue(kNupharTuningRepeat));
+    if (repeat > 0)
+      return repeat;
+  }
+  return 10;
+}
+
+ScheduleTuningLog& ScheduleTuningLog::Instance() {
+  static ScheduleTuningLog log;
+  return log;
+}
+
+void ScheduleTuningLog::LoadIfNeeded() {
+  std::string path;
+  if (!GetTuningLogFilePath(path, /*create*/ false))
+    path.clear();
+
+  // the settings are recreated with each Nuphar execution provider, so the path may change
+  if (loaded_ && path == loaded_path_)
+    return;
+
+  loaded_ = true;
+  loaded_path_ = path;
+  configs_.clear();
+  if (path.empty())
+    return;
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream fields(line);
+    std::string func_name;
+    std::string config_str;
+    NupharScheduleConfig config;
+    if (fields >> func_name >> config_str && NupharScheduleConfig::FromString(config_str, config)) {
+      configs_[func_name] = config;
+    } else {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Ignoring invalid line in tuning log " << path << ": " << line;
+    }
+  }
+}
+
+bool ScheduleTuningLog::Lookup(const std::string& func_name, NupharScheduleConfig& config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  auto it = configs_.find(func_name);
+  if (it == configs_.end())
+    return false;
+
+  config = it->second;
+  return true;
+}
+
+void ScheduleTuningLog::Record(const std::string& func_name, const NupharScheduleConfig& config, double avg_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  configs_[func_name] = config;
+
+  std::string path;
+  if (!GetTuningLogFilePath(path, /*create*/ true)) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Tuned " << func_name << " to " << config.ToString()
+                                             << ", set nuphar_cache_path or nuphar_tuning_log to save it";
+    return;
+  }
+
+  std::ofstream file(path, std::ios::app);
+  file << func_name << " " << config.ToString() << " " << avg_us << std::endl;
+  if (!file) {
+    LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Failed to write tuning log " << path;
+  }
+  loaded_path_ = path;
+}
+
+}  // namespace nuphar
+}  // namespace onnxruntime
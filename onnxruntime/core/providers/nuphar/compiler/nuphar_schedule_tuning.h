@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace onnxruntime {
+namespace nuphar {
+
+// NupharScheduleConfig holds the tunable part of the schedule of the real outputs of a subgraph.
+// The default values reproduce the fixed rules of the schedule builder.
+struct NupharScheduleConfig {
+  int vector_width = 16;     // split factor of the innermost axis, which gets vectorized
+  int tile_rows = 1;         // split factor of the second innermost axis, 1 for no tiling
+  bool interchange = false;  // swap the two outermost axes
+
+  bool IsDefault() const;
+
+  // Serializes to and from the format in the tuning log, like "v16_t1_i0"
+  std::string ToString() const;
+  static bool FromString(const std::string& str, NupharScheduleConfig& config);
+};
+
+// Candidates explored in tuning mode, with the default config first
+const std::vector<NupharScheduleConfig>& GetScheduleCandidates();
+
+bool IsScheduleTuningEnabled();
+
+int GetScheduleTuningRepeat();
+
+// ScheduleTuningLog keeps the best schedule of each tuned function, keyed by the packed func name.
+// The log file is read on first use after the settings change, and new records are appended to it,
+// so a later line of the same function overrides an earlier one.
+class ScheduleTuningLog {
+ public:
+  static ScheduleTuningLog& Instance();
+
+  bool Lookup(const std::string& func_name, NupharScheduleConfig& config);
+
+  void Record(const std::string& func_name, const NupharScheduleConfig& config, double avg_us);
+
+ private:
+  ScheduleTuningLog() = default;
+
+  // mutex_ must be held
+  void LoadIfNeeded();
+
+  std::mutex mutex_;
+  bool loaded_ = false;
+  std::string loaded_path_;
+  std::unordered_map<std::string, NupharScheduleConfig> configs_;
+};
+
+}  // namespace nuphar
+}  // namespace onnxruntime
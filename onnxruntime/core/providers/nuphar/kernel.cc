@@ -6,12 +6,19 @@
 #include "core/codegen/passes/utils/codegen_context.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/nuphar/common/analysis/subgraph_codegen_stats.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/nuphar_execution_provider.h"
 #include "core/providers/nuphar/partition/subgraph_partitioner.h"
 #include "core/providers/nuphar/runtime/sequential/basic.h"
 #include "core/providers/nuphar/runtime/sequential/loop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
 namespace onnxruntime {
 namespace nuphar {
 
@@ -34,11 +41,9 @@ NupharKernelState::NupharKernelState(
       subgraphs,
       [&](const std::string& name) { return provider_.GetConstantInitializer(name); });
 
-  for (auto& subgraph : subgraphs) {
-    Compile(subgraph);
-    if (!codegen_status_.IsOK()) {
-      return;  // early return
-    }
+  Compile(subgraphs);
+  if (!codegen_status_.IsOK()) {
+    return;  // early return
   }
 
   // Currently BuildExecBlocksAndCalls is inserted here
@@ -46,23 +51,172 @@ NupharKernelState::NupharKernelState(
   BuildExecBlocksAndCalls(subgraphs);
 }
 
-void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
+static size_t GetCompileThreads() {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (!settings.HasOption(kNupharCompileThreads)) {
+    return 1;
+  }
+  const int threads = std::stoi(settings.GetOptionValue(kNupharCompileThreads));
+  if (threads <= 0) {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  return static_cast<size_t>(threads);
+}
+
+using SpecializedDims = std::vector<std::pair<std::string, int64_t>>;
+
+// the versions in the settings, each one with the "name=value" of its dims joined by '&'
+static std::vector<SpecializedDims> GetSpecializedDims() {
+  std::vector<SpecializedDims> versions;
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (!settings.HasOption(kNupharSpecializedDims)) {
+    return versions;
+  }
+
+  std::stringstream versions_stream(settings.GetOptionValue(kNupharSpecializedDims));
+  std::string version;
+  while (std::getline(versions_stream, version, ';')) {
+    SpecializedDims dims;
+    std::stringstream dims_stream(version);
+    std::string dim;
+    while (std::getline(dims_stream, dim, '&')) {
+      auto pos = dim.find('=');
+      ORT_ENFORCE(pos != std::string::npos, "Invalid specialized dim: ", dim);
+      dims.emplace_back(dim.substr(0, pos), std::stoll(dim.substr(pos + 1)));
+    }
+    if (!dims.empty()) {
+      versions.push_back(std::move(dims));
+    }
+  }
+  return versions;
+}
+
+// a version applies to the subgraphs run by BasicExecBlock with all of its dims in their inputs,
+// so the dims are realized before the function is selected
+static bool CanSpecialize(const NupharSubgraphUnit& subgraph, const SpecializedDims& dims) {
+  if (subgraph.IsSingleNode() && subgraph.nodes.front()->OpType() == "Scan") {
+    return false;
+  }
+
+  std::unordered_set<std::string> dim_params;
+  for (const NodeArg* input : subgraph.inputs) {
+    const auto* shape = input->Shape();
+    if (nullptr == shape) {
+      continue;
+    }
+    for (const auto& dim : shape->dim()) {
+      if (utils::HasDimParam(dim)) {
+        dim_params.insert(dim.dim_param());
+      }
+    }
+  }
+
+  return std::all_of(dims.begin(), dims.end(),
+                     [&dim_params](const std::pair<std::string, int64_t>& dim) {
+                       return dim_params.count(dim.first) > 0;
+                     });
+}
+
+void NupharKernelState::Compile(const std::vector<NupharSubgraphUnit>& subgraphs) {
   // TODO: rename tvm_target to a proper name
   auto tvm_target = provider_.GetTVMTarget();
+  auto tvm_host_target = provider_.GetTVMHostTarget();
+
+  // the generic code of each subgraph comes first, followed by the specialized versions
+  struct CompileUnit {
+    size_t subgraph_idx;
+    const SpecializedDims* dims;  // nullptr for the generic code
+    std::unique_ptr<NupharCompiler> compiler;
+    Status status;
+  };
+
+  const std::vector<SpecializedDims> specialized_dims = GetSpecializedDims();
+
+  // tvm IR is built sequentially as the subgraphs share the generated initializers
+  std::vector<CompileUnit> units;
+  auto build = [&](size_t subgraph_idx, const SpecializedDims* dims) {
+    const auto& subgraph = subgraphs[subgraph_idx];
+    auto compiler = std::make_unique<NupharCompiler>(subgraph,
+                                                     generated_initailizers_,
+                                                     provider_.GetNupharCodeGenHandle());
+    if (nullptr != dims) {
+      compiler->SpecializeDims(*dims);
+    }
+    Status status = compiler->Build(subgraph);
+    if (status.IsOK()) {
+      units.push_back({subgraph_idx, dims, std::move(compiler), Status::OK()});
+    }
+    return status;
+  };
 
-  NupharCompiler tvm_compiler(subgraph,
-                              generated_initailizers_,
-                              provider_.GetNupharCodeGenHandle());
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    codegen_status_ = build(idx, nullptr);
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
+  }
+
+  // a specialized version that fails to build is skipped, leaving its dims to the generic code
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    for (const auto& dims : specialized_dims) {
+      if (CanSpecialize(subgraphs[idx], dims)) {
+        Status status = build(idx, &dims);
+        if (!status.IsOK()) {
+          LOGS_DEFAULT(WARNING) << "Nuphar skips a specialized version of " << subgraphs[idx].Name()
+                                << ": " << status.ErrorMessage();
+        }
+      }
+    }
+  }
 
-  codegen_status_ = tvm_compiler.Build(subgraph);
+  // llvm compilation takes most of the time, so it runs on several threads when the settings allow it
+  std::atomic<size_t> next_unit{0};
+  auto generate = [&]() {
+    for (size_t idx = next_unit++; idx < units.size(); idx = next_unit++) {
+      auto& unit = units[idx];
+      try {
+        unit.status = unit.compiler->Generate(subgraphs[unit.subgraph_idx], tvm_target, tvm_host_target);
+      } catch (const std::exception& ex) {
+        unit.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      }
+    }
+  };
+
+  const size_t num_threads = std::min(GetCompileThreads(), units.size());
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(generate);
+  }
+  generate();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t idx = 0; idx < subgraphs.size(); ++idx) {
+    codegen_status_ = units[idx].status;
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
 
-  if (codegen_status_.IsOK()) {
     func_infos_.emplace_back(std::make_unique<NupharFuncInfo>());
-    codegen_status_ = tvm_compiler.Lower(subgraph,
-                                         tvm_target,
-                                         provider_.GetTVMHostTarget(),
-                                         func_infos_.back().get(),
-                                         partition_info_.get());
+    codegen_status_ = units[idx].compiler->Lower(subgraphs[idx],
+                                                 tvm_target,
+                                                 tvm_host_target,
+                                                 func_infos_.back().get(),
+                                                 partition_info_.get());
+    if (!codegen_status_.IsOK()) {
+      return;
+    }
+  }
+
+  for (size_t idx = subgraphs.size(); idx < units.size(); ++idx) {
+    const auto& unit = units[idx];
+    if (!unit.status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Nuphar skips a specialized version of " << subgraphs[unit.subgraph_idx].Name()
+                            << ": " << unit.status.ErrorMessage();
+      continue;
+    }
+    func_infos_[unit.subgraph_idx]->specialized_funcs.push_back({*unit.dims, unit.compiler->GetGeneratedFunc()});
   }
 }
 
@@ -193,6 +347,14 @@ ONNX_OPERATOR_KERNEL_EX(
                                                         DataTypeImpl::GetTensorType<int64_t>()}),
     nuphar::NupharKernel);
 
+ONNX_OPERATOR_KERNEL_EX(
+    LayerNormalization,
+    kMSDomain,
+    1,
+    kNupharExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    nuphar::NupharKernel);
+
 ONNX_OPERATOR_KERNEL_EX(
     MatMulInteger,
     kOnnxDomain,
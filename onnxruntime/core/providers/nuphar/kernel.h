@@ -38,7 +38,7 @@ class NupharKernelState {
 
   Status Compute(OpKernelContext* op_kernel_context) const;
 
-  void Compile(const NupharSubgraphUnit& subgraph);
+  void Compile(const std::vector<NupharSubgraphUnit>& subgraphs);
 
   void BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs);
 
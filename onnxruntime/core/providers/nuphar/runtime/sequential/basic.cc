@@ -7,6 +7,7 @@
 #include "core/codegen/common/profile.h"
 #include "core/codegen/passes/utils/ort_tvm_utils.h"
 #include "gsl/gsl_util"
+#include <algorithm>
 #include <tvm/tvm.h>
 
 // from onnxruntime_typeinf.cc, in global namespace
@@ -15,6 +16,21 @@ const onnxruntime::DataTypeImpl* ElementTypeFromProto(int type);
 namespace onnxruntime {
 namespace nuphar {
 
+// the first function specialized for the realized dims, or the generic one
+static const tvm::runtime::PackedFunc& SelectPackedFunc(const NupharFuncInfo* func_info,
+                                                        const std::unordered_map<std::string, int64_t>& realized_dims) {
+  for (const auto& specialized : func_info->specialized_funcs) {
+    bool matched = std::all_of(specialized.dims.begin(), specialized.dims.end(),
+                               [&realized_dims](const std::pair<std::string, int64_t>& dim) {
+                                 auto iter = realized_dims.find(dim.first);
+                                 return iter != realized_dims.end() && iter->second == dim.second;
+                               });
+    if (matched)
+      return specialized.packed_func;
+  }
+  return func_info->packed_func;
+}
+
 void BasicExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
   CODEGEN_PROFILER_EVENT(func_info_->name);
   if (!kernel_compute_ctx->IsInitialized(func_info_)) {
@@ -34,7 +50,7 @@ void BasicExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
                         tvm_num_args);
 
   tvm::TVMRetValue rvalue;
-  const tvm::runtime::PackedFunc& func = func_info_->packed_func;
+  const tvm::runtime::PackedFunc& func = SelectPackedFunc(func_info_, kernel_compute_ctx->GetRealizedDims());
 
   func.CallPacked(tvm_args, &rvalue);
 
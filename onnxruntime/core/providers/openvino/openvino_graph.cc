@@ -1,6 +1,7 @@
 // Copyright(C) 2019 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <map>
@@ -25,6 +26,9 @@ namespace openvino_ep {
 
 const std::string OpenVINOGraph::log_tag = "[OpenVINO-EP] ";
 
+// The networks of input shapes other than those of the IR are kept for the shapes most recently used.
+constexpr size_t kMaxLoadedNetworks = 4;
+
 OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   device_id_ = "CPU";
   precision_ = InferenceEngine::Precision::FP32;
@@ -65,10 +69,17 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   // operations associated with the Infer Requests may be scheduled in parallel.
   // Infer Requests hold resources representing the entire network on their target hardware. So,
   // having more Infer Requests than needed would waste system resources.
-  // In VAD-M (HDDL) accelerator, there are 8 parallel execution units. So, creating 8 instances
-  // of Infer Requests only if the VAD-M accelerator is being used.
+  // In VAD-M (HDDL) accelerator, there are 8 parallel execution units, and a MYRIAD device pipelines
+  // 4 Infer Requests. On CPU and GPU, a second Infer Request overlaps copying the data of one batch
+  // slice or run with the inference of another.
   // sets number of maximum parallel inferences
-  num_inf_reqs_ = (device_id_ == "HDDL") ? 8 : 1;
+  if (device_id_ == "HDDL") {
+    num_inf_reqs_ = 8;
+  } else if (device_id_ == "MYRIAD") {
+    num_inf_reqs_ = 4;
+  } else {
+    num_inf_reqs_ = 2;
+  }
 
   fused_node_ = fused_node;
 
@@ -105,18 +116,117 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
                 plugin_path)
                 .getPluginByDevice(device_id_);
 
+  std::vector<InferenceEngine::SizeVector> input_dims;
+  for (const auto& input_info : openvino_network_->getInputsInfo()) {
+    input_dims.push_back(input_info.second->getTensorDesc().getDims());
+  }
+  loaded_networks_.emplace_front(std::move(input_dims), LoadNetwork(openvino_network_));
+}
+
+std::shared_ptr<OpenVINOGraph::LoadedNetwork> OpenVINOGraph::LoadNetwork(
+    std::shared_ptr<InferenceEngine::CNNNetwork> network) {
+  auto loaded_network = std::make_shared<LoadedNetwork>();
+  loaded_network->network = network;
+
   //Loading model to the plugin
-  InferenceEngine::ExecutableNetwork exeNetwork = plugin_.LoadNetwork(*openvino_network_, {});
+  loaded_network->executable_network = plugin_.LoadNetwork(*network, {});
 
   LOGS_DEFAULT(INFO) << log_tag << "Network loaded into accelerator plug-in succesfully";
 
   //Create infer request
   for (size_t i = 0; i < num_inf_reqs_; i++) {
-    auto infRequest = exeNetwork.CreateInferRequestPtr();
-
-    infer_requests_.push_back(infRequest);
+    loaded_network->free_infer_requests.push_back(loaded_network->executable_network.CreateInferRequestPtr());
   }
   LOGS_DEFAULT(INFO) << log_tag << "Infer requests created: " << num_inf_reqs_;
+
+  return loaded_network;
+}
+
+std::shared_ptr<OpenVINOGraph::LoadedNetwork> OpenVINOGraph::GetLoadedNetwork(Ort::CustomOpApi ort,
+                                                                              const OrtValue* input_tensors[],
+                                                                              size_t batch_size) {
+  // The dims of a batch slice of each input
+  std::vector<InferenceEngine::SizeVector> input_dims;
+  size_t i = 0;
+  for (const auto& input_info : openvino_network_->getInputsInfo()) {
+    const auto& graph_dims = input_info.second->getTensorDesc().getDims();
+    auto tensor_info = ort.GetTensorTypeAndShape(input_tensors[i++]);
+    const auto& input_shape = ort.GetTensorShape(tensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+
+    InferenceEngine::SizeVector dims(input_shape.begin(), input_shape.end());
+    if (dims.size() == graph_dims.size() + 1) {
+      dims.erase(dims.begin());
+    } else if (batch_size > 1 && !dims.empty()) {
+      dims[0] = 1;
+    }
+    input_dims.push_back(std::move(dims));
+  }
+
+  auto find_network = [&]() -> std::shared_ptr<LoadedNetwork> {
+    std::lock_guard<std::mutex> lock(loaded_networks_lock_);
+    for (auto it = loaded_networks_.begin(); it != loaded_networks_.end(); ++it) {
+      if (it->first == input_dims) {
+        loaded_networks_.splice(loaded_networks_.begin(), loaded_networks_, it);
+        return it->second;
+      }
+    }
+    return nullptr;
+  };
+  auto loaded_network = find_network();
+  if (loaded_network) {
+    return loaded_network;
+  }
+
+  // Another run may have loaded it while this one waited
+  std::lock_guard<std::mutex> load_lock(load_lock_);
+  loaded_network = find_network();
+  if (loaded_network) {
+    return loaded_network;
+  }
+
+  LOGS_DEFAULT(INFO) << log_tag << "Loading the network for new input shapes";
+  auto network = BuildOpenVINONetworkWithMO();
+  InferenceEngine::ICNNNetwork::InputShapes input_shapes;
+  i = 0;
+  for (const auto& input_info : network->getInputsInfo()) {
+    input_shapes[input_info.first] = input_dims[i++];
+  }
+  network->reshape(input_shapes);
+  GetExecutableHandle(network);
+  loaded_network = LoadNetwork(network);
+
+  std::lock_guard<std::mutex> lock(loaded_networks_lock_);
+  loaded_networks_.emplace_front(std::move(input_dims), loaded_network);
+  if (loaded_networks_.size() > kMaxLoadedNetworks) {
+    // The runs still using the network keep it until they are done
+    loaded_networks_.pop_back();
+  }
+  return loaded_network;
+}
+
+std::vector<InferenceEngine::InferRequest::Ptr> OpenVINOGraph::AcquireInferRequests(LoadedNetwork& loaded_network,
+                                                                                   size_t max_count) {
+  // Waiting only while holding no Infer Request, concurrent runs can't wait for each other.
+  std::unique_lock<std::mutex> lock(loaded_network.lock);
+  loaded_network.released.wait(lock, [&loaded_network]() { return !loaded_network.free_infer_requests.empty(); });
+
+  auto& free_infer_requests = loaded_network.free_infer_requests;
+  const size_t count = std::min(std::max<size_t>(max_count, 1), free_infer_requests.size());
+  std::vector<InferenceEngine::InferRequest::Ptr> infer_requests(free_infer_requests.end() - count,
+                                                                 free_infer_requests.end());
+  free_infer_requests.resize(free_infer_requests.size() - count);
+  return infer_requests;
+}
+
+void OpenVINOGraph::ReleaseInferRequests(LoadedNetwork& loaded_network,
+                                         const std::vector<InferenceEngine::InferRequest::Ptr>& infer_requests) {
+  {
+    std::lock_guard<std::mutex> lock(loaded_network.lock);
+    loaded_network.free_infer_requests.insert(loaded_network.free_infer_requests.end(),
+                                              infer_requests.begin(), infer_requests.end());
+  }
+  loaded_network.released.notify_all();
 }
 
 std::vector<std::string> OpenVINOGraph::GetEnvLdLibraryPath() const {
@@ -325,18 +435,18 @@ size_t OpenVINOGraph::DeduceBatchSize(Ort::CustomOpApi ort, const OrtValue* inpu
 }
 
 // Starts an asynchronous inference request for data in slice indexed by batch_slice_idx on
-// an Infer Request indexed by infer_req_idx
+// an Infer Request of the loaded network
 void OpenVINOGraph::StartAsyncInference(Ort::CustomOpApi ort, const OrtValue* input_tensors[],
                                         size_t batch_slice_idx,
-                                        size_t infer_req_idx) {
-  auto infer_request = infer_requests_[infer_req_idx];
-  auto graph_input_info = openvino_network_->getInputsInfo();
+                                        const LoadedNetwork& loaded_network,
+                                        InferenceEngine::InferRequest& infer_request) {
+  auto graph_input_info = loaded_network.network->getInputsInfo();
 
   size_t i = 0;
   for (auto input_info_iter = graph_input_info.begin();
        input_info_iter != graph_input_info.end(); ++input_info_iter, ++i) {
     // Get OpenVINO's input buffer
-    auto graph_input_blob = infer_request->GetBlob(input_info_iter->first);
+    auto graph_input_blob = infer_request.GetBlob(input_info_iter->first);
     auto graph_input_buffer =
         graph_input_blob->buffer().as<InferenceEngine::PrecisionTrait<InferenceEngine::Precision::FP32>::value_type*>();
 
@@ -349,25 +459,24 @@ void OpenVINOGraph::StartAsyncInference(Ort::CustomOpApi ort, const OrtValue* in
   }
 
   // Start Async inference
-  infer_request->StartAsync();
+  infer_request.StartAsync();
 }
 
-// Wait for asynchronous inference completion on an Infer Request object indexed by infer_req_idx
+// Wait for asynchronous inference completion on an Infer Request of the loaded network
 // and copy the results into a slice location within the batched output buffer indexed by batch_slice_idx
 void OpenVINOGraph::CompleteAsyncInference(Ort::CustomOpApi ort, OrtValue* output_tensors[],
                                            size_t batch_slice_idx,
-                                           size_t infer_req_idx) {
-  auto infer_request = infer_requests_[infer_req_idx];
-
+                                           const LoadedNetwork& loaded_network,
+                                           InferenceEngine::InferRequest& infer_request) {
   // Wait for Async inference completion
-  infer_request->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
-  auto graph_output_info = openvino_network_->getOutputsInfo();
+  infer_request.Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+  auto graph_output_info = loaded_network.network->getOutputsInfo();
 
   size_t i = 0;
   for (auto output_info_iter = graph_output_info.begin();
        output_info_iter != graph_output_info.end(); ++output_info_iter, ++i) {
     // Get OpenVINO's output blob
-    auto graph_output_blob = infer_request->GetBlob(output_info_iter->first);
+    auto graph_output_blob = infer_request.GetBlob(output_info_iter->first);
     auto graph_output_buffer =
         graph_output_blob->buffer().as<InferenceEngine::PrecisionTrait<InferenceEngine::Precision::FP32>::value_type*>();
 
@@ -388,17 +497,17 @@ void OpenVINOGraph::GetInputTensors(Ort::CustomOpApi ort, OrtKernelContext* cont
   }
 }
 
-void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size) {
-  auto graph_output_info = openvino_network_->getOutputsInfo();
+void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size,
+                                     const LoadedNetwork& loaded_network, InferenceEngine::InferRequest& infer_request) {
+  auto graph_output_info = loaded_network.network->getOutputsInfo();
 
   // All infer_requests process identical tensor slices from the batch.
-  // So using info from first infer_request to allocate all output tensors.
-  auto infer_request = infer_requests_[0];
+  // So using info from one infer_request to allocate all output tensors.
 
   size_t i = 0;
   for (auto output_info_iter = graph_output_info.begin();
        output_info_iter != graph_output_info.end(); ++output_info_iter, ++i) {
-    auto graph_output_blob = infer_request->GetBlob(output_info_iter->first);
+    auto graph_output_blob = infer_request.GetBlob(output_info_iter->first);
     auto graph_output_dims = graph_output_blob->getTensorDesc().getDims();
 
     if (batch_size > 1) {
@@ -417,10 +526,6 @@ void OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* con
 }
 
 void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
-  std::lock_guard<std::mutex> lock(compute_lock_);
-
   LOGS_DEFAULT(INFO) << log_tag << "Starting inference";
 
   // Get Input and Output tensors
@@ -435,35 +540,31 @@ void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   auto batch_size = DeduceBatchSize(ort, input_tensors[0],
                                     openvino_network_->getInputsInfo().begin()->second->getTensorDesc().getDims());
 
-  size_t full_parallel_runs = batch_size / num_inf_reqs_;
-  size_t remainder_parallel_runs = batch_size % num_inf_reqs_;
-
-  GetOutputTensors(ort, context, output_tensors, batch_size);
-
-  // Distribute the batched inputs among available Infer Requests
-  // for parallel inference.
-
-  // Run parallel inferences as sets of num_inf_reqs_
-  for (size_t set = 0; set < full_parallel_runs; set++) {
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
+  auto loaded_network = GetLoadedNetwork(ort, input_tensors, batch_size);
+
+  // Concurrent runs share the Infer Requests of the network, so this one may get fewer than the batch slices.
+  auto infer_requests = AcquireInferRequests(*loaded_network, batch_size);
+  const size_t num_parallel_runs = infer_requests.size();
+
+  try {
+    GetOutputTensors(ort, context, output_tensors, batch_size, *loaded_network, *infer_requests[0]);
+
+    // Distribute the batched inputs among the acquired Infer Requests
+    // for parallel inference, as sets of num_parallel_runs
+    for (size_t set_begin = 0; set_begin < batch_size; set_begin += num_parallel_runs) {
+      const size_t set_size = std::min(num_parallel_runs, batch_size - set_begin);
+      for (size_t inf_req_idx = 0; inf_req_idx < set_size; inf_req_idx++) {
+        StartAsyncInference(ort, input_tensors, set_begin + inf_req_idx, *loaded_network, *infer_requests[inf_req_idx]);
+      }
+      for (size_t inf_req_idx = 0; inf_req_idx < set_size; inf_req_idx++) {
+        CompleteAsyncInference(ort, output_tensors, set_begin + inf_req_idx, *loaded_network, *infer_requests[inf_req_idx]);
+      }
     }
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
-    }
-  }
-
-  // Run parallel inferences for remaining batch slices
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
-  }
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
+  } catch (...) {
+    ReleaseInferRequests(*loaded_network, infer_requests);
+    throw;
   }
+  ReleaseInferRequests(*loaded_network, infer_requests);
 
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
 }
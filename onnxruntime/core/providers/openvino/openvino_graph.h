@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include <inference_engine.hpp>
 #include <ie_utils.hpp>
@@ -30,8 +33,28 @@ class OpenVINOGraph {
   static const std::string log_tag;
 
  private:
+  // A network loaded into the plugin for the shapes of a batch slice of the inputs, with its Infer Requests.
+  struct LoadedNetwork {
+    std::shared_ptr<InferenceEngine::CNNNetwork> network;
+    InferenceEngine::ExecutableNetwork executable_network;
+    std::mutex lock;
+    std::condition_variable released;
+    std::vector<InferenceEngine::InferRequest::Ptr> free_infer_requests;
+  };
+
   std::shared_ptr<InferenceEngine::CNNNetwork> BuildOpenVINONetworkWithMO();
 
+  std::shared_ptr<LoadedNetwork> LoadNetwork(std::shared_ptr<InferenceEngine::CNNNetwork> network);
+
+  // The network loaded for the shapes of a batch slice of the inputs, loading it if it isn't one of the most recently
+  // used ones.
+  std::shared_ptr<LoadedNetwork> GetLoadedNetwork(Ort::CustomOpApi ort, const OrtValue* input_tensors[], size_t batch_size);
+
+  // Infer Requests of the network for up to max_count batch slices, waiting for one if all are used by other runs.
+  std::vector<InferenceEngine::InferRequest::Ptr> AcquireInferRequests(LoadedNetwork& loaded_network, size_t max_count);
+
+  void ReleaseInferRequests(LoadedNetwork& loaded_network, const std::vector<InferenceEngine::InferRequest::Ptr>& infer_requests);
+
   InferenceEngine::Precision ConvertPrecisionONNXToOpenVINO(ONNX_NAMESPACE::DataType onnx_type);
 
   void GetExecutableHandle(
@@ -42,11 +65,14 @@ class OpenVINOGraph {
 
   void GetInputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, const OrtValue* input_tensors[]);
 
-  void GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size);
+  void GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, OrtValue* output_tensors[], size_t batch_size,
+                        const LoadedNetwork& loaded_network, InferenceEngine::InferRequest& infer_request);
 
-  void StartAsyncInference(Ort::CustomOpApi ort, const OrtValue* input_tensors[], size_t batch_slice_idx, size_t infer_req_idx);
+  void StartAsyncInference(Ort::CustomOpApi ort, const OrtValue* input_tensors[], size_t batch_slice_idx,
+                           const LoadedNetwork& loaded_network, InferenceEngine::InferRequest& infer_request);
 
-  void CompleteAsyncInference(Ort::CustomOpApi ort, OrtValue* output_tensors[], size_t batch_slice_idx, size_t infer_req_idx);
+  void CompleteAsyncInference(Ort::CustomOpApi ort, OrtValue* output_tensors[], size_t batch_slice_idx,
+                              const LoadedNetwork& loaded_network, InferenceEngine::InferRequest& infer_request);
 
   std::vector<std::string> GetEnvLdLibraryPath() const;
 
@@ -54,9 +80,12 @@ class OpenVINOGraph {
   std::shared_ptr<InferenceEngine::CNNNetwork> openvino_network_;
   size_t num_inf_reqs_;
   InferenceEngine::InferencePlugin plugin_;
-  std::vector<InferenceEngine::InferRequest::Ptr> infer_requests_;
   std::string device_id_;
-  mutable std::mutex compute_lock_;
+  // the networks by the dims of a batch slice of the inputs, the most recently used first
+  std::list<std::pair<std::vector<InferenceEngine::SizeVector>, std::shared_ptr<LoadedNetwork>>> loaded_networks_;
+  std::mutex loaded_networks_lock_;
+  // the networks are loaded one at a time
+  std::mutex load_lock_;
   std::vector<int> input_indexes_;
   InferenceEngine::Precision precision_;
   const onnxruntime::Graph* onnx_graph_;
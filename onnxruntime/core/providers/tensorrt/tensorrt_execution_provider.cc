@@ -19,6 +19,9 @@
 #include "core/graph/model.h"
 #include "cuda_runtime_api.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 using namespace ONNX_NAMESPACE;
@@ -40,10 +43,154 @@ TensorrtLogger& GetTensorrtLogger() {
     }                                                           \
   } while (0)
 
+namespace {
+// FNV-1a, which unlike std::hash is the same in every build, so that the engines cached by one can be loaded by another.
+uint64_t HashEngineKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Fixes the dims of the graph inputs other than the batch to input_dims, and the other dims that aren't fixed to 1,
+// since the parser only takes fixed dims. The shapes inferred from the dims that weren't fixed are dropped.
+void FixInputDims(ONNX_NAMESPACE::GraphProto& graph,
+                  const std::unordered_map<std::string, std::vector<int64_t>>& input_dims) {
+  bool fixed = false;
+  for (auto& input : *graph.mutable_input()) {
+    if (!input.type().tensor_type().has_shape()) {
+      continue;
+    }
+    auto* shape = input.mutable_type()->mutable_tensor_type()->mutable_shape();
+    const auto dims = input_dims.find(input.name());
+    for (int j = 1, end = shape->dim_size(); j < end; ++j) {
+      auto* dim = shape->mutable_dim(j);
+      if (dims != input_dims.end() && j < static_cast<int>(dims->second.size())) {
+        fixed = fixed || !dim->has_dim_value() || dim->dim_value() != dims->second[j];
+        dim->set_dim_value(dims->second[j]);
+      } else if (!dim->has_dim_value()) {
+        fixed = true;
+        dim->set_dim_value(1);
+      }
+    }
+  }
+  if (fixed) {
+    graph.clear_value_info();
+  }
+}
+
+// Whether graph inputs have dims other than the batch that aren't fixed.
+bool HasDynamicInputDims(const ONNX_NAMESPACE::GraphProto& graph) {
+  for (const auto& input : graph.input()) {
+    const auto& shape = input.type().tensor_type().shape();
+    for (int j = 1, end = shape.dim_size(); j < end; ++j) {
+      if (!shape.dim(j).has_dim_value()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+}  // namespace
+
+TensorrtContextPool::TensorrtContextPool(nvinfer1::ICudaEngine& engine, nvinfer1::IExecutionContext* context,
+                                         int device_id)
+    : engine_(engine), device_id_(device_id) {
+  Entry* entry = CreateEntry(context);
+  ORT_ENFORCE(entry != nullptr, "Failed to create the stream of a TensorRT execution context");
+  free_entries_.push_back(entry);
+}
+
+TensorrtContextPool::~TensorrtContextPool() {
+  for (auto& entry : entries_) {
+    entry->context->destroy();
+    cudaStreamDestroy(entry->stream);
+    cudaEventDestroy(entry->inputs_ready);
+  }
+}
+
+TensorrtContextPool::Entry* TensorrtContextPool::CreateEntry(nvinfer1::IExecutionContext* context) {
+  if (context == nullptr) {
+    return nullptr;
+  }
+  auto entry = std::make_unique<Entry>();
+  entry->context = context;
+  // the runs wait for their inputs with inputs_ready, so their streams don't need to synchronize with the legacy
+  // default stream, which would make them wait for each other
+  if (cudaStreamCreateWithFlags(&entry->stream, cudaStreamNonBlocking) != cudaSuccess ||
+      cudaEventCreateWithFlags(&entry->inputs_ready, cudaEventDisableTiming) != cudaSuccess) {
+    if (entry->stream != nullptr) {
+      cudaStreamDestroy(entry->stream);
+    }
+    context->destroy();
+    return nullptr;
+  }
+  entries_.push_back(std::move(entry));
+  return entries_.back().get();
+}
+
+TensorrtContextPool::Entry* TensorrtContextPool::Acquire() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!free_entries_.empty()) {
+    Entry* entry = free_entries_.back();
+    free_entries_.pop_back();
+    return entry;
+  }
+  // the contexts share the weights of the engine, each only adds its activations
+  cudaSetDevice(device_id_);
+  return CreateEntry(engine_.createExecutionContext());
+}
+
+void TensorrtContextPool::Release(Entry* entry) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  free_entries_.push_back(entry);
+}
+
 TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id),
+      engine_cache_path_(info.engine_cache_path), fp16_enable_(info.fp16_enable), int8_enable_(info.int8_enable) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
+  if (engine_cache_path_.empty()) {
+    const char* cache_path_env = getenv("ORT_TENSORRT_ENGINE_CACHE_PATH");
+    if (cache_path_env) {
+      engine_cache_path_ = ToWideString(std::string(cache_path_env));
+    }
+  }
+
+  const char* fp16_env = getenv("ORT_TENSORRT_FP16_ENABLE");
+  if (fp16_env) {
+    fp16_enable_ = atoi(fp16_env) != 0;
+  }
+
+  const char* max_engines_env = getenv("ORT_TENSORRT_MAX_ENGINES_PER_SUBGRAPH");
+  if (max_engines_env && atoi(max_engines_env) > 0) {
+    max_engines_per_subgraph_ = static_cast<size_t>(atoi(max_engines_env));
+  }
+
+  const char* int8_env = getenv("ORT_TENSORRT_INT8_ENABLE");
+  if (int8_env) {
+    int8_enable_ = atoi(int8_env) != 0;
+  }
+
+  if (int8_enable_) {
+    auto table_path = info.int8_calibration_table_path;
+    const char* table_path_env = getenv("ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH");
+    if (table_path.empty() && table_path_env) {
+      table_path = ToWideString(std::string(table_path_env));
+    }
+    if (table_path.empty()) {
+      ORT_THROW("The int8 mode of TensorRT requires a calibration table");
+    }
+    std::ifstream file(table_path, std::ios::in | std::ios::binary);
+    if (!file) {
+      ORT_THROW("Failed to read the TensorRT calibration table");
+    }
+    int8_calibration_table_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
   DeviceAllocatorRegistrationInfo default_allocator_info(
       {OrtMemTypeDefault, [](int id) { return std::make_unique<CUDAAllocator>(id, TRT); }, std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(default_allocator_info, device_id_));
@@ -203,6 +350,7 @@ SubGraphCollection_t TensorrtExecutionProvider::GetSupportedList(SubGraphCollect
 
         // Serialize modelproto to string
         ONNX_NAMESPACE::ModelProto model_proto = model_build.ToProto();
+        FixInputDims(*model_proto.mutable_graph(), {});
         string string_buf;
         model_proto.SerializeToString(&string_buf);
 
@@ -259,6 +407,7 @@ TensorrtExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   ORT_ENFORCE(status.IsOK(), status);
   ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
   model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  FixInputDims(*model_proto.mutable_graph(), {});
 
   // Serialize modelproto to string
   string string_buf;
@@ -294,30 +443,244 @@ TensorrtExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+TensorrtExecutionProvider::unique_pointer<nvinfer1::ICudaEngine>
+TensorrtExecutionProvider::BuildOrLoadEngine(nvinfer1::IBuilder& builder, nvinfer1::INetworkDefinition& network,
+                                             const std::string& model_buf) {
+  if (engine_cache_path_.empty()) {
+    return unique_pointer<nvinfer1::ICudaEngine>(builder.buildCudaEngine(network));
+  }
+
+  // an engine only runs with the TensorRT version and the GPU model it was built for
+  cudaDeviceProp prop;
+  CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id_));
+  std::ostringstream key;
+  key << model_buf << '\n'
+      << "tensorrt " << getInferLibVersion() << '\n'
+      << "gpu " << prop.name << ' ' << prop.major << '.' << prop.minor << '\n'
+      << "batch " << max_batch_size_ << " workspace " << max_workspace_size_ << '\n'
+      << "precision" << (fp16_enable_ ? " fp16" : "") << (int8_enable_ ? " int8 " : "")
+      << (int8_enable_ ? int8_calibration_table_ : "");
+  std::ostringstream file_name;
+  file_name << std::hex << HashEngineKey(key.str()) << ".engine";
+  auto path = engine_cache_path_;
+  path += ORT_TSTR("/");
+  path += ToWideString(file_name.str());
+
+  {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (file) {
+      std::string plan((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      if (!runtime_) {
+        runtime_ = unique_pointer<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTensorrtLogger()));
+      }
+      auto engine = unique_pointer<nvinfer1::ICudaEngine>(
+          runtime_->deserializeCudaEngine(plan.data(), plan.size(), nullptr));
+      if (engine != nullptr) {
+        return engine;
+      }
+      // a plan that doesn't deserialize, e.g. written by a process that crashed, is rebuilt and replaced
+      LOGS_DEFAULT(WARNING) << "Rebuilding the TensorRT engine " << file_name.str() << " that failed to deserialize";
+    }
+  }
+
+  auto engine = unique_pointer<nvinfer1::ICudaEngine>(builder.buildCudaEngine(network));
+  if (engine == nullptr) {
+    return engine;
+  }
+
+  // written next to the file and renamed, so that a process loading it concurrently never reads part of it
+  auto plan = unique_pointer<nvinfer1::IHostMemory>(engine->serialize());
+  auto temp_path = path;
+  temp_path += ORT_TSTR(".tmp");
+  bool written = false;
+  {
+    std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(plan->data()), plan->size());
+    written = static_cast<bool>(file.flush());
+  }
+#ifdef _WIN32
+  // _wrename doesn't replace an existing file
+  _wremove(path.c_str());
+  const bool renamed = written && _wrename(temp_path.c_str(), path.c_str()) == 0;
+#else
+  const bool renamed = written && std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+  if (!renamed) {
+    LOGS_DEFAULT(WARNING) << "Failed to add the TensorRT engine " << file_name.str() << " to the engine cache";
+  }
+  return engine;
+}
+
+common::Status TensorrtExecutionProvider::BuildEngine(
+    const TensorrtSubgraph& subgraph, const std::unordered_map<std::string, std::vector<int64_t>>& input_dims,
+    std::shared_ptr<TensorrtEngine>& engine) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  if (!model_proto.ParseFromString(subgraph.model_buf)) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to parse the model of the TensorRT subgraph");
+  }
+  string string_buf = subgraph.model_buf;
+  if (!input_dims.empty()) {
+    FixInputDims(*model_proto.mutable_graph(), input_dims);
+    model_proto.SerializeToString(&string_buf);
+  }
+
+  // Build map from input name to its index in input definitions
+  std::unordered_map<std::string, int> input_map;
+  input_map.reserve(subgraph.input_names.size());
+  for (int i = 0, end = subgraph.input_names.size(); i < end; ++i) {
+    input_map[subgraph.input_names[i]] = i;
+  }
+
+  // Build map from output name to its index in output definitions
+  std::unordered_map<std::string, int> output_map;
+  output_map.reserve(subgraph.output_names.size());
+  for (int i = 0, end = subgraph.output_names.size(); i < end; ++i) {
+    output_map[subgraph.output_names[i]] = i;
+  }
+
+  // Create TensorRT engine
+  CHECK_CUDA(cudaSetDevice(device_id_));
+  TensorrtLogger& trt_logger = GetTensorrtLogger();
+  auto trt_builder = unique_pointer<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(trt_logger));
+  auto trt_network = unique_pointer<nvinfer1::INetworkDefinition>(trt_builder->createNetwork());
+  auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
+  trt_parser->parse(string_buf.data(), string_buf.size());
+
+  trt_builder->setMaxBatchSize(max_batch_size_);
+  trt_builder->setMaxWorkspaceSize(max_workspace_size_);
+
+  // the layers without a faster implementation in the lower precisions stay in float
+  if (fp16_enable_) {
+    if (!trt_builder->platformHasFastFp16()) {
+      LOGS_DEFAULT(WARNING) << "The GPU has no fast float16, TensorRT may not run any layer in float16";
+    }
+    trt_builder->setFp16Mode(true);
+  }
+  std::unique_ptr<TensorrtCalibrationTable> trt_calibrator;
+  if (int8_enable_) {
+    if (!trt_builder->platformHasFastInt8()) {
+      LOGS_DEFAULT(WARNING) << "The GPU has no fast int8, TensorRT may not run any layer in int8";
+    }
+    trt_calibrator = std::make_unique<TensorrtCalibrationTable>(int8_calibration_table_);
+    trt_builder->setInt8Mode(true);
+    trt_builder->setInt8Calibrator(trt_calibrator.get());
+  }
+  auto trt_engine = BuildOrLoadEngine(*trt_builder, *trt_network, string_buf);
+  if (trt_engine == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to build the TensorRT engine");
+  }
+
+  // Build TensorRT context
+  auto trt_context = unique_pointer<nvinfer1::IExecutionContext>(trt_engine->createExecutionContext());
+  if (trt_context == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to create a TensorRT execution context");
+  }
+
+  auto result = std::make_shared<TensorrtEngine>();
+
+  // Get input binding index
+  int num_inputs = trt_network->getNbInputs();
+  result->input_indexes.resize(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    const std::string& name = trt_network->getInput(i)->getName();
+    size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
+    auto iter = input_map.find(name);
+    if (iter != input_map.end()) {
+      result->input_indexes[bindingIndex] = iter->second;
+    }
+  }
+
+  // Get output shape and binding index
+  int num_outputs = trt_network->getNbOutputs();
+  result->output_indexes.resize(num_outputs);
+  result->output_shapes.resize(num_outputs);
+  result->output_types.resize(num_outputs);
+  for (int i = 0; i < num_outputs; ++i) {
+    const std::string& name = trt_network->getOutput(i)->getName();
+    size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
+    nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
+    bindingIndex -= num_inputs;
+    auto iter = output_map.find(name);
+    if (iter != output_map.end()) {
+      result->output_indexes[bindingIndex] = iter->second;
+    }
+    for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
+      result->output_shapes[bindingIndex].push_back(dimensions.d[j]);
+    }
+
+    const auto& graph_output = model_proto.graph().output();
+    const auto& tensor_type = graph_output[i].type().tensor_type();
+    result->output_types[bindingIndex] = tensor_type.elem_type();
+
+    const auto& tensor_shape = tensor_type.shape();
+    if (tensor_shape.dim_size() == 1 && result->output_shapes[bindingIndex].back() == 1) {
+      result->output_shapes[bindingIndex].pop_back();
+    }
+  }
+
+  ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs));
+
+  result->engine = std::move(trt_engine);
+  result->context_pool = std::make_unique<TensorrtContextPool>(*result->engine, trt_context.release(), device_id_);
+  engine = std::move(result);
+  return Status::OK();
+}
+
+common::Status TensorrtExecutionProvider::GetEngine(TensorrtSubgraph& subgraph,
+                                                    const std::vector<std::vector<int64_t>>& input_shapes,
+                                                    std::shared_ptr<TensorrtEngine>& engine) {
+  // the batch is given to the engine when it is enqueued
+  std::vector<std::vector<int64_t>> key;
+  key.reserve(input_shapes.size());
+  for (const auto& shape : input_shapes) {
+    key.emplace_back(shape.empty() ? shape.begin() : shape.begin() + 1, shape.end());
+  }
+
+  auto find_engine = [&]() {
+    std::lock_guard<OrtMutex> lock(subgraph.mutex);
+    for (auto it = subgraph.engines.begin(), end = subgraph.engines.end(); it != end; ++it) {
+      if (it->first == key) {
+        subgraph.engines.splice(subgraph.engines.begin(), subgraph.engines, it);
+        engine = it->second;
+        return true;
+      }
+    }
+    return false;
+  };
+  if (find_engine()) {
+    return Status::OK();
+  }
+
+  // another run may have built it while this one waited
+  std::lock_guard<OrtMutex> build_lock(build_mutex_);
+  if (find_engine()) {
+    return Status::OK();
+  }
+
+  std::unordered_map<std::string, std::vector<int64_t>> input_dims;
+  for (size_t i = 0, end = subgraph.input_names.size(); i < end; ++i) {
+    input_dims[subgraph.input_names[i]] = input_shapes[i];
+  }
+  ORT_RETURN_IF_ERROR(BuildEngine(subgraph, input_dims, engine));
+
+  std::lock_guard<OrtMutex> lock(subgraph.mutex);
+  subgraph.engines.emplace_front(std::move(key), engine);
+  if (subgraph.engines.size() > max_engines_per_subgraph_) {
+    // the runs still using the engine keep it until they are done
+    subgraph.engines.pop_back();
+  }
+  return Status::OK();
+}
+
 common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                                   std::vector<NodeComputeInfo>& node_compute_funcs) {
   for (const auto* fused_node : fused_nodes) {
-    std::vector<int> input_indexes;
-    std::vector<int> input_dim_sizes;
-    std::vector<int> output_indexes;
-    std::vector<int> output_dim_sizes;
-    std::vector<std::vector<int64_t>> output_shapes;
-    std::vector<int> output_types;
-
-    // Build map from input name to its index in input definitions
-    std::unordered_map<std::string, int> input_map;
-    const auto& input_defs = fused_node->InputDefs();
-    input_map.reserve(input_defs.size());
-    for (int i = 0, end = input_defs.size(); i < end; ++i) {
-      input_map[input_defs[i]->Name()] = i;
+    auto subgraph = std::make_unique<TensorrtSubgraph>();
+    for (const auto* input : fused_node->InputDefs()) {
+      subgraph->input_names.push_back(input->Name());
     }
-
-    // Build map from output name to its index in output definitions
-    std::unordered_map<std::string, int> output_map;
-    const auto& output_defs = fused_node->OutputDefs();
-    output_map.reserve(output_defs.size());
-    for (int i = 0, end = output_defs.size(); i < end; ++i) {
-      output_map[output_defs[i]->Name()] = i;
+    for (const auto* output : fused_node->OutputDefs()) {
+      subgraph->output_names.push_back(output->Name());
     }
 
     // Reconstruct graph proto from fused node's function body
@@ -330,15 +693,8 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
     *(model_proto.mutable_graph()) = graph_body.ToGraphProto();
     model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
-    string string_buf;
-    model_proto.SerializeToString(&string_buf);
-
-    // Create TensorRT engine
-    TensorrtLogger& trt_logger = GetTensorrtLogger();
-    auto trt_builder = unique_pointer<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(trt_logger));
-    auto trt_network = unique_pointer<nvinfer1::INetworkDefinition>(trt_builder->createNetwork());
-    auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
-    trt_parser->parse(string_buf.data(), string_buf.size());
+    model_proto.SerializeToString(&subgraph->model_buf);
+    subgraph->dynamic = HasDynamicInputDims(model_proto.graph());
 
     const char* batch_env = getenv("ORT_TENSORRT_MAX_BATCH_SIZE");
     if (batch_env) {
@@ -352,86 +708,21 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       SetMaxWorkspaceSize(max_workspace_size);
     }
 
-    trt_builder->setMaxBatchSize(max_batch_size_);
-    trt_builder->setMaxWorkspaceSize(max_workspace_size_);
-    auto trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildCudaEngine(*trt_network.get()));
-    ORT_ENFORCE(trt_engine != nullptr);
-
-    // Build TensorRT context
-    auto trt_context = unique_pointer<nvinfer1::IExecutionContext>(trt_engine->createExecutionContext());
-    ORT_ENFORCE(trt_context != nullptr);
-
-    // Get input shape and binding index
-    int num_inputs = trt_network->getNbInputs();
-    input_indexes.resize(num_inputs);
-    input_dim_sizes.resize(num_inputs);
-    for (int i = 0; i < num_inputs; ++i) {
-      const std::string& name = trt_network->getInput(i)->getName();
-      size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
-      nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
-      auto iter = input_map.find(name);
-      if (iter != input_map.end()) {
-        input_indexes[bindingIndex] = iter->second;
-      }
-      size_t dim_size = 1;
-      for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
-        dim_size *= dimensions.d[j];
-      }
-      input_dim_sizes[bindingIndex] = dim_size;
+    // the engines of dynamic dims are built by the runs
+    if (!subgraph->dynamic) {
+      std::shared_ptr<TensorrtEngine> trt_engine;
+      ORT_RETURN_IF_ERROR(BuildEngine(*subgraph, {}, trt_engine));
+      subgraph->engines.emplace_front(std::vector<std::vector<int64_t>>(), std::move(trt_engine));
     }
-
-    // Get output shape and binding index
-    int num_outputs = trt_network->getNbOutputs();
-    output_indexes.resize(num_outputs);
-    output_dim_sizes.resize(num_outputs);
-    output_shapes.resize(num_outputs);
-    output_types.resize(num_outputs);
-    for (int i = 0; i < num_outputs; ++i) {
-      const std::string& name = trt_network->getOutput(i)->getName();
-      size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
-      nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
-      bindingIndex -= num_inputs;
-      auto iter = output_map.find(name);
-      if (iter != output_map.end()) {
-        output_indexes[bindingIndex] = iter->second;
-      }
-      size_t dim_size = 1;
-      for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
-        output_shapes[bindingIndex].push_back(dimensions.d[j]);
-        dim_size *= dimensions.d[j];
-      }
-      output_dim_sizes[bindingIndex] = dim_size;
-
-      const auto& graph_output = model_proto.graph().output();
-      const auto& tensor_type = graph_output[i].type().tensor_type();
-      output_types[bindingIndex] = tensor_type.elem_type();
-
-      const auto& tensor_shape = tensor_type.shape();
-      if (tensor_shape.dim_size() == 1 && output_shapes[bindingIndex].back() == 1) {
-        output_shapes[bindingIndex].pop_back();
-      }
-    }
-
-    ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs));
-
-    // Save engine, context and input/output info to map
-    parsers_.emplace(fused_node->Name(), std::move(trt_parser));
-    engines_.emplace(fused_node->Name(), std::move(trt_engine));
-    contexts_.emplace(fused_node->Name(), std::move(trt_context));
-    input_info_[fused_node->Name()].push_back(input_indexes);
-    input_info_[fused_node->Name()].push_back(input_dim_sizes);
-    output_info_[fused_node->Name()].push_back(output_indexes);
-    output_info_[fused_node->Name()].push_back(output_dim_sizes);
-    output_info_[fused_node->Name()].push_back(output_types);
-    output_shapes_[fused_node->Name()] = output_shapes;
+    subgraphs_.emplace(fused_node->Name(), std::move(subgraph));
 
     // Create function state
     // TODO: remove default capture
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [=](ComputeContext* context, FunctionState* state) {
       std::unique_ptr<TensorrtFuncState> p = std::make_unique<TensorrtFuncState>();
-      *p = {context->allocate_func, context->release_func, context->allocator_handle, parsers_[context->node_name].get(), engines_[context->node_name].get(), contexts_[context->node_name].get(),
-            input_info_[context->node_name], output_info_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_};
+      *p = {context->allocate_func, context->release_func, context->allocator_handle, this,
+            subgraphs_[context->node_name].get()};
       *state = p.release();
       return 0;
     };
@@ -446,10 +737,27 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
       TensorrtFuncState* trt_state = reinterpret_cast<TensorrtFuncState*>(state);
-      const std::vector<int>& input_indexes = (trt_state->input_info)[0];
-      const std::vector<int>& output_indexes = (trt_state->output_info)[0];
-      const std::vector<int>& output_types = (trt_state->output_info)[2];
-      std::vector<std::vector<int64_t>> output_shapes = trt_state->output_shapes;
+      TensorrtSubgraph& subgraph = *trt_state->subgraph;
+
+      // the engine of the dims of the inputs
+      std::shared_ptr<TensorrtEngine> trt_engine;
+      if (subgraph.dynamic) {
+        std::vector<std::vector<int64_t>> input_shapes(subgraph.input_names.size());
+        for (size_t i = 0, end = input_shapes.size(); i < end; ++i) {
+          const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
+          auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+          input_shapes[i] = ort.GetTensorShape(tensor_info);
+          ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        }
+        ORT_RETURN_IF_ERROR(trt_state->provider->GetEngine(subgraph, input_shapes, trt_engine));
+      } else {
+        trt_engine = subgraph.engines.front().second;
+      }
+
+      const std::vector<int>& input_indexes = trt_engine->input_indexes;
+      const std::vector<int>& output_indexes = trt_engine->output_indexes;
+      const std::vector<int>& output_types = trt_engine->output_types;
+      std::vector<std::vector<int64_t>> output_shapes = trt_engine->output_shapes;
 
       int num_binding_inputs = input_indexes.size();
       int num_binding_outputs = output_indexes.size();
@@ -499,11 +807,25 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         }
       }
 
-      // Run TRT inference
-      std::lock_guard<OrtMutex> lock(*(trt_state->tensorrt_mu_ptr));
-      bool ret = trt_state->context->enqueue(batch_size, &buffers[0], nullptr, nullptr);
+      // Run TRT inference on a context no other run is using
+      TensorrtContextPool* context_pool = trt_engine->context_pool.get();
+      TensorrtContextPool::Entry* entry = context_pool->Acquire();
+      if (entry == nullptr) {
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to create a TensorRT execution context.");
+      }
+      // the inputs are produced by the legacy default stream or by blocking streams, which an event recorded on the
+      // legacy default stream waits for
+      bool ret = cudaEventRecord(entry->inputs_ready, cudaStreamLegacy) == cudaSuccess &&
+                 cudaStreamWaitEvent(entry->stream, entry->inputs_ready, 0) == cudaSuccess &&
+                 entry->context->enqueue(batch_size, &buffers[0], entry->stream, nullptr);
+      // the outputs are read by the next nodes, which don't know about the stream
+      const bool synchronized = cudaStreamSynchronize(entry->stream) == cudaSuccess;
+      context_pool->Release(entry);
+      if (ret && !synchronized) {
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "TensorRT execution failed.");
+      }
       if (!ret) {
-        if (trt_state->context->getEngine().getMaxBatchSize() < batch_size) {
+        if (trt_engine->engine->getMaxBatchSize() < batch_size) {
           return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                                 "TRT enqueue failed: Set ORT_TENSORRT_MAX_BATCH_SIZE environment variable to at least " + to_string(batch_size));
         }
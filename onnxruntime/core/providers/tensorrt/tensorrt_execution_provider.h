@@ -3,6 +3,7 @@
 
 #pragma once
 #include <ctime>
+#include <list>
 #include "core/common/logging/logging.h"
 #include "core/framework/op_kernel.h"
 #include "NvInfer.h"
@@ -33,20 +34,113 @@ class TensorrtLogger : public nvinfer1::ILogger {
 // Information needed to construct trt execution providers.
 struct TensorrtExecutionProviderInfo {
   int device_id{0};
+  // The directory the engines are serialized to and loaded from, empty for none.
+  std::basic_string<ORTCHAR_T> engine_cache_path;
+  // Let TensorRT run the layers in float16 where it is faster.
+  bool fp16_enable{false};
+  // Let TensorRT run the layers in int8 where it is faster, with the dynamic ranges of the calibration table.
+  bool int8_enable{false};
+  // The calibration table TensorRT wrote for the model, required for int8.
+  std::basic_string<ORTCHAR_T> int8_calibration_table_path;
 };
 
+struct TensorrtInferDeleter {
+  template <typename T>
+  void operator()(T* obj) const {
+    if (obj) {
+      obj->destroy();
+    }
+  }
+};
+
+// Gives TensorRT the dynamic ranges of a calibration table rather than calibrating with batches of data.
+class TensorrtCalibrationTable : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  explicit TensorrtCalibrationTable(const std::string& table) : table_(table) {}
+
+  int getBatchSize() const override { return 1; }
+
+  bool getBatch(void* /*bindings*/[], const char* /*names*/[], int /*nbBindings*/) override { return false; }
+
+  const void* readCalibrationCache(size_t& length) override {
+    length = table_.size();
+    return table_.data();
+  }
+
+  void writeCalibrationCache(const void* /*ptr*/, size_t /*length*/) override {}
+
+ private:
+  const std::string& table_;
+};
+
+// The execution contexts of an engine, each with its own stream, so that concurrent runs enqueue the engine at the
+// same time instead of waiting for each other. A context is added when all of them are in use.
+class TensorrtContextPool {
+ public:
+  struct Entry {
+    nvinfer1::IExecutionContext* context = nullptr;
+    cudaStream_t stream = nullptr;
+    // recorded on the legacy default stream for the stream to wait for the inputs
+    cudaEvent_t inputs_ready = nullptr;
+  };
+
+  // context is the first context of the engine, which the pool takes ownership of.
+  TensorrtContextPool(nvinfer1::ICudaEngine& engine, nvinfer1::IExecutionContext* context, int device_id);
+  ~TensorrtContextPool();
+
+  // A context no other run is using, nullptr if a new one couldn't be created.
+  Entry* Acquire();
+
+  void Release(Entry* entry);
+
+ private:
+  Entry* CreateEntry(nvinfer1::IExecutionContext* context);
+
+  nvinfer1::ICudaEngine& engine_;
+  int device_id_;
+  OrtMutex mutex_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+  std::vector<Entry*> free_entries_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(TensorrtContextPool);
+};
+
+// An engine of a subgraph built for the dims of its inputs, with the bindings of the inputs and outputs.
+struct TensorrtEngine {
+  std::unique_ptr<nvinfer1::ICudaEngine, TensorrtInferDeleter> engine;
+  // declared after the engine to be destroyed before it
+  std::unique_ptr<TensorrtContextPool> context_pool;
+  // the index in the fused node of the input or output of each binding
+  std::vector<int> input_indexes;
+  std::vector<int> output_indexes;
+  std::vector<int> output_types;
+  // the dims of the outputs without the batch
+  std::vector<std::vector<int64_t>> output_shapes;
+};
+
+// A fused node run by TensorRT. The parser only takes fixed dims, so when inputs have dims other than the batch that
+// aren't fixed, an engine is built for their dims on the first run with them.
+struct TensorrtSubgraph {
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  // the serialized model of the subgraph
+  std::string model_buf;
+  bool dynamic = false;
+  OrtMutex mutex;
+  // the engines by the dims of the inputs without the batch, the most recently used first. The engine of a subgraph
+  // without dynamic dims is built by Compile and is the only one.
+  std::list<std::pair<std::vector<std::vector<int64_t>>, std::shared_ptr<TensorrtEngine>>> engines;
+};
+
+class TensorrtExecutionProvider;
+
 // Information to construct kernel function state.
 struct TensorrtFuncState {
   AllocateFunc test_allocate_func = nullptr;
   DestroyFunc test_release_func = nullptr;
   AllocatorHandle allocator = nullptr;
-  nvonnxparser::IParser* parser = nullptr;
-  nvinfer1::ICudaEngine* engine = nullptr;
-  nvinfer1::IExecutionContext* context = nullptr;
-  std::vector<std::vector<int>> input_info;
-  std::vector<std::vector<int>> output_info;
-  std::vector<std::vector<int64_t>> output_shapes;
-  OrtMutex* tensorrt_mu_ptr = nullptr;
+  TensorrtExecutionProvider* provider = nullptr;
+  TensorrtSubgraph* subgraph = nullptr;
 };
 
 // Logical device representation.
@@ -74,36 +168,52 @@ class TensorrtExecutionProvider : public IExecutionProvider {
     max_workspace_size_ = workspace_size;
   }
 
+  /**
+  Get the engine of a subgraph with dynamic dims for the shapes of its inputs, building it if it isn't one of the
+  max_engines_per_subgraph_ most recently used ones.
+  */
+  common::Status GetEngine(TensorrtSubgraph& subgraph, const std::vector<std::vector<int64_t>>& input_shapes,
+                           std::shared_ptr<TensorrtEngine>& engine);
+
  private:
   int max_batch_size_ = 1;
   size_t max_workspace_size_ = 1 << 30;  // 1GB
   int max_parser_iterations_ = 6;
-
-  struct InferDeleter {
-    template <typename T>
-    void operator()(T* obj) const {
-      if (obj) {
-        obj->destroy();
-      }
-    }
-  };
+  size_t max_engines_per_subgraph_ = 8;
+  std::basic_string<ORTCHAR_T> engine_cache_path_;
+  bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  std::string int8_calibration_table_;
 
   template <typename T>
-  using unique_pointer = std::unique_ptr<T, InferDeleter>;
+  using unique_pointer = std::unique_ptr<T, TensorrtInferDeleter>;
 
-  OrtMutex tensorrt_mu_;
   int device_id_;
-  std::unordered_map<std::string, unique_pointer<nvonnxparser::IParser>> parsers_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::ICudaEngine>> engines_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::IExecutionContext>> contexts_;
-  std::unordered_map<std::string, std::vector<std::vector<int>>> input_info_;
-  std::unordered_map<std::string, std::vector<std::vector<int>>> output_info_;
-  std::unordered_map<std::string, std::vector<std::vector<int64_t>>> output_shapes_;
+  // deserializes the cached engines, which it must outlive
+  unique_pointer<nvinfer1::IRuntime> runtime_;
+  std::unordered_map<std::string, std::unique_ptr<TensorrtSubgraph>> subgraphs_;
+  // the engines are built one at a time
+  OrtMutex build_mutex_;
 
   /**Get IndexedSubGraph based on node list of the subgraph*/
   std::unique_ptr<IndexedSubGraph> GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index,
                                                const onnxruntime::GraphViewer& graph) const;
 
+  /**
+  Build the engine of a network, or load it from the engine cache if the subgraph serialized to model_buf was built
+  with the same configuration before. Built engines are added to the cache.
+  */
+  unique_pointer<nvinfer1::ICudaEngine> BuildOrLoadEngine(nvinfer1::IBuilder& builder,
+                                                          nvinfer1::INetworkDefinition& network,
+                                                          const std::string& model_buf);
+
+  /**
+  Build the engine of a subgraph, with the dims of its inputs other than the batch fixed to input_dims if not empty.
+  */
+  common::Status BuildEngine(const TensorrtSubgraph& subgraph,
+                             const std::unordered_map<std::string, std::vector<int64_t>>& input_dims,
+                             std::shared_ptr<TensorrtEngine>& engine);
+
   /**
   Get TensorRT supported node lists by calling Onnx-TensorRT parser recursively. Since each time the parser
   can only detect first unsupported node failure, it needs to wait for Onnxruntime to partition the graph
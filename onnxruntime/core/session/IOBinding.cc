@@ -69,20 +69,93 @@ common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml
   auto rc = Contains(output_names_, name);
   if (rc.first) {
     outputs_[rc.second] = ml_value;
+    output_locations_[rc.second] = nullptr;
     return Status::OK();
   }
 
   output_names_.push_back(name);
   outputs_.push_back(ml_value);
+  output_locations_.push_back(nullptr);
   return Status::OK();
 }
 
+common::Status IOBinding::BindOutput(const std::string& name, const OrtMemoryInfo& location) {
+  // Keep the OrtMemoryInfo owned by the allocator, as it lives as long as the session.
+  const auto& execution_providers = session_state_.GetExecutionProviders();
+  auto allocator = execution_providers.GetAllocator(location);
+  if (allocator == nullptr) {
+    // the caller can't tell whether the provider wraps its device allocator in an arena, so accept either
+    OrtAllocatorType other_type = location.type == OrtArenaAllocator ? OrtDeviceAllocator : OrtArenaAllocator;
+    allocator = execution_providers.GetAllocator(
+        OrtMemoryInfo(location.name, other_type, location.device, location.id, location.mem_type));
+  }
+  if (allocator == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "No execution provider of the session has an allocator for ", location.ToString());
+  }
+
+  auto rc = Contains(output_names_, name);
+  if (rc.first) {
+    outputs_[rc.second] = OrtValue();
+    output_locations_[rc.second] = &allocator->Info();
+    return Status::OK();
+  }
+
+  output_names_.push_back(name);
+  outputs_.push_back(OrtValue());
+  output_locations_.push_back(&allocator->Info());
+  return Status::OK();
+}
+
+void IOBinding::ClearInputs() {
+  feed_names_.clear();
+  feeds_.clear();
+}
+
+void IOBinding::ClearOutputs() {
+  output_names_.clear();
+  outputs_.clear();
+  output_locations_.clear();
+}
+
 const std::vector<std::string>& IOBinding::GetOutputNames() const {
   return output_names_;
 }
 
 std::vector<OrtValue>& IOBinding::GetOutputs() { return outputs_; }
 
+const std::vector<const OrtMemoryInfo*>& IOBinding::GetOutputLocations() const {
+  return output_locations_;
+}
+
+common::Status IOBinding::CopyOutputsToCpu(std::vector<OrtValue>& cpu_outputs) const {
+  cpu_outputs.clear();
+  cpu_outputs.reserve(outputs_.size());
+
+  AllocatorPtr cpu_allocator;
+  for (const auto& output : outputs_) {
+    if (!output.IsAllocated() || !output.IsTensor() ||
+        output.Get<Tensor>().Location().device.Type() == OrtDevice::CPU) {
+      cpu_outputs.push_back(output);
+      continue;
+    }
+
+    if (cpu_allocator == nullptr) {
+      cpu_allocator = session_state_.GetExecutionProviders()
+                          .Get(onnxruntime::kCpuExecutionProvider)
+                          ->GetAllocator(0, OrtMemTypeDefault);
+    }
+
+    const auto& src = output.Get<Tensor>();
+    auto dst = std::make_unique<Tensor>(src.DataType(), src.Shape(), cpu_allocator);
+    ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensor(src, *dst));
+    cpu_outputs.emplace_back(dst.release(), DataTypeImpl::GetType<Tensor>(),
+                             DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  }
+
+  return Status::OK();
+}
+
 const std::vector<std::string>& IOBinding::GetInputNames() const {
   return feed_names_;
 }
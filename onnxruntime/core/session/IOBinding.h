@@ -31,6 +31,7 @@ class SessionState;
  *
  * io_binding->BindOutput(...);
  * io_binding->BindOutput(...);
+ * io_binding->BindOutput(name, device_memory_info);  // leave the output on the device
  *
  * session.Run(io_binding);
  *
@@ -62,12 +63,36 @@ class IOBinding {
     */
   common::Status BindOutput(const std::string& name, const OrtValue& ml_value);
 
+  /**
+    * Binds the output to the device described by location. The output is allocated on that device by
+    * each Run(), so an output produced on the device is not copied to CPU. The location must match an
+    * allocator of one of the session's execution providers.
+    */
+  common::Status BindOutput(const std::string& name, const OrtMemoryInfo& location);
+
+  /**
+    * Removes all bound inputs or outputs so the binding can be reused with different names.
+    */
+  void ClearInputs();
+  void ClearOutputs();
+
   /**
     * This simply collects the outputs obtained after calling Run() inside the @param outputs.
     */
   const std::vector<std::string>& GetOutputNames() const;
   std::vector<OrtValue>& GetOutputs();
 
+  /**
+    * The device location of each output bound with BindOutput(name, location), nullptr for the others.
+    */
+  const std::vector<const OrtMemoryInfo*>& GetOutputLocations() const;
+
+  /**
+    * Returns the outputs with any tensor that is not in CPU memory copied to CPU, e.g. for a language
+    * binding that can only read CPU memory. Outputs already in CPU memory are returned without a copy.
+    */
+  common::Status CopyOutputsToCpu(std::vector<OrtValue>& cpu_outputs) const;
+
   const std::vector<std::string>& GetInputNames() const;
   const std::vector<OrtValue>& GetInputs() const;
 
@@ -87,6 +112,7 @@ class IOBinding {
   std::vector<OrtValue> feeds_;
   std::vector<std::string> output_names_;
   std::vector<OrtValue> outputs_;
+  std::vector<const OrtMemoryInfo*> output_locations_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 };
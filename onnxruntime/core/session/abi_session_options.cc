@@ -44,6 +44,15 @@ ORT_API_STATUS_IMPL(OrtDisableSequentialExecution, _In_ OrtSessionOptions* optio
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtEnableCriticalPathScheduling, _In_ OrtSessionOptions* options) {
+  options->value.enable_critical_path_scheduling = true;
+  return nullptr;
+}
+ORT_API_STATUS_IMPL(OrtDisableCriticalPathScheduling, _In_ OrtSessionOptions* options) {
+  options->value.enable_critical_path_scheduling = false;
+  return nullptr;
+}
+
 // set filepath to save optimized onnx model.
 ORT_API_STATUS_IMPL(OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options, _In_ const ORTCHAR_T* optimized_model_filepath) {
   options->value.optimized_model_filepath = optimized_model_filepath;
@@ -62,6 +71,67 @@ ORT_API_STATUS_IMPL(OrtDisableProfiling, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtEnableProfilingHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_profiling_hardware_counters = true;
+  return nullptr;
+}
+ORT_API_STATUS_IMPL(OrtDisableProfilingHardwareCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_profiling_hardware_counters = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableNodeCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_node_counters = true;
+  return nullptr;
+}
+ORT_API_STATUS_IMPL(OrtDisableNodeCounters, _In_ OrtSessionOptions* options) {
+  options->value.enable_node_counters = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableShapeCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_shape_cache = true;
+  return nullptr;
+}
+ORT_API_STATUS_IMPL(OrtDisableShapeCache, _In_ OrtSessionOptions* options) {
+  options->value.enable_shape_cache = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtAddIncrementalExecutionInput, _In_ OrtSessionOptions* options, _In_ const char* input_name) {
+  options->value.incremental_execution_inputs.emplace_back(input_name);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableMemoryProfiling, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_profiling = true;
+  return nullptr;
+}
+ORT_API_STATUS_IMPL(OrtDisableMemoryProfiling, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_profiling = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetRunTraceSampling, _In_ OrtSessionOptions* options, int64_t sample_rate,
+                    size_t buffer_size) {
+  if (sample_rate < 0)
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "sample_rate must not be negative.");
+  options->value.trace_sample_rate = sample_rate;
+  options->value.trace_buffer_size = buffer_size;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetRunTraceCallbacks, _In_ OrtSessionOptions* options, _In_opt_ OrtRunTraceCallback begin_span,
+                    _In_opt_ OrtRunTraceCallback end_span, _In_opt_ void* user_data) {
+  if (begin_span == nullptr && end_span == nullptr) {
+    options->value.run_trace_hook = nullptr;
+  } else {
+    options->value.run_trace_hook = std::make_shared<onnxruntime::CallbackRunTraceHook>(begin_span, end_span,
+                                                                                         user_data);
+  }
+  return nullptr;
+}
+
 // enable the memory pattern optimization.
 // The idea is if the input shapes are the same, we could trace the internal memory allocation
 // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -75,6 +145,16 @@ ORT_API_STATUS_IMPL(OrtDisableMemPattern, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtSetSessionMemPatternCacheOptions, _In_ OrtSessionOptions* options, int64_t shape_bucket_size,
+                    size_t max_patterns) {
+  if (shape_bucket_size <= 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "shape_bucket_size must be positive.");
+  }
+  options->value.mem_pattern_shape_bucket_size = shape_bucket_size;
+  options->value.mem_pattern_cache_size = max_patterns;
+  return nullptr;
+}
+
 // enable the memory arena on CPU
 // Arena may pre-allocate memory for future usage.
 // set this option to false if you don't want it.
@@ -88,6 +168,43 @@ ORT_API_STATUS_IMPL(OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtEnableCpuMemHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_huge_pages = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableCpuMemHugePages, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_mem_huge_pages = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetCpuMemNumaNode, _In_ OrtSessionOptions* options, int numa_node) {
+  if (numa_node < -1) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "numa_node must be -1 or a NUMA node.");
+  }
+  options->value.cpu_mem_numa_node = numa_node;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionArenaConfig, _In_ OrtSessionOptions* options, size_t max_mem,
+                    OrtArenaExtendStrategy arena_extend_strategy, size_t initial_chunk_size_bytes,
+                    int64_t idle_shrink_timeout_ms) {
+  if (arena_extend_strategy != ORT_ARENA_EXTEND_NEXT_POWER_OF_TWO &&
+      arena_extend_strategy != ORT_ARENA_EXTEND_SAME_AS_REQUESTED) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "Unknown arena extend strategy.");
+  }
+  if (idle_shrink_timeout_ms < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "idle_shrink_timeout_ms must not be negative.");
+  }
+  onnxruntime::ArenaConfig& config = options->value.arena_config;
+  config.max_mem = max_mem;
+  config.arena_extend_strategy = static_cast<onnxruntime::ArenaExtendStrategy>(arena_extend_strategy);
+  config.initial_chunk_size_bytes = initial_chunk_size_bytes == 0 ? onnxruntime::ArenaConfig().initial_chunk_size_bytes
+                                                                   : initial_chunk_size_bytes;
+  config.idle_shrink_timeout_ms = idle_shrink_timeout_ms;
+  return nullptr;
+}
+
 ///< logger id to use for session output
 ORT_API_STATUS_IMPL(OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -137,3 +254,137 @@ ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options
   options->value.session_thread_pool_size = session_thread_pool_size;
   return nullptr;
 }
+
+///How many threads in the thread pool used by the parallel executor.
+ORT_API_STATUS_IMPL(OrtSetSessionInterOpThreadPoolSize, _In_ OrtSessionOptions* options, int inter_op_thread_pool_size) {
+  options->value.inter_op_thread_pool_size = inter_op_thread_pool_size;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolAffinity, _In_ OrtSessionOptions* options,
+                    _In_ const size_t* logical_processors, size_t count) {
+  if (count > 0 && logical_processors == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "logical_processors is null");
+  }
+  options->value.session_thread_pool_options.affinity.assign(logical_processors, logical_processors + count);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionInterOpThreadPoolAffinity, _In_ OrtSessionOptions* options,
+                    _In_ const size_t* logical_processors, size_t count) {
+  if (count > 0 && logical_processors == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "logical_processors is null");
+  }
+  options->value.inter_op_thread_pool_options.affinity.assign(logical_processors, logical_processors + count);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolNumaNode, _In_ OrtSessionOptions* options, int numa_node) {
+  options->value.session_thread_pool_options.numa_node = numa_node;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionInterOpThreadPoolNumaNode, _In_ OrtSessionOptions* options, int numa_node) {
+  options->value.inter_op_thread_pool_options.numa_node = numa_node;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionThreadPoolSpinDuration, _In_ OrtSessionOptions* options, int spin_duration_us) {
+  if (spin_duration_us < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "spin_duration_us must be 0 or more.");
+  }
+  options->value.session_thread_pool_options.spin_duration_us = spin_duration_us;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionInterOpThreadPoolSpinDuration, _In_ OrtSessionOptions* options,
+                    int spin_duration_us) {
+  if (spin_duration_us < 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "spin_duration_us must be 0 or more.");
+  }
+  options->value.inter_op_thread_pool_options.spin_duration_us = spin_duration_us;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableLowLatencyRuns, _In_ OrtSessionOptions* options) {
+  options->value.enable_low_latency_runs = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableLowLatencyRuns, _In_ OrtSessionOptions* options) {
+  options->value.enable_low_latency_runs = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableGlobalThreadPools, _In_ OrtSessionOptions* options) {
+  options->value.use_global_thread_pools = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableGlobalThreadPools, _In_ OrtSessionOptions* options) {
+  options->value.use_global_thread_pools = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_initializers = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->value.use_shared_initializers = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableEnvAllocators, _In_ OrtSessionOptions* options) {
+  options->value.use_env_allocators = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableEnvAllocators, _In_ OrtSessionOptions* options) {
+  options->value.use_env_allocators = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableZipMapElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_elimination = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableZipMapElimination, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_elimination = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtSetSessionWeightOnlyQuantization, _In_ OrtSessionOptions* options, int bits, int block_size) {
+  if (bits != 0 && bits != 4 && bits != 8) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "bits must be 0, 4 or 8.");
+  }
+  if (block_size < 16 || (block_size & (block_size - 1)) != 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "block_size must be a power of 2 and at least 16.");
+  }
+  options->value.weight_only_quantization_bits = bits;
+  options->value.weight_only_quantization_block_size = block_size;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtEnableMemoryEfficientExecutionOrder, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_efficient_execution_order = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtDisableMemoryEfficientExecutionOrder, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_efficient_execution_order = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtAddSessionWarmupInputShapes, _Inout_ OrtSessionOptions* options,
+                    _In_ const char* const* input_names, _In_ const int64_t* const* input_shapes,
+                    _In_ const size_t* input_shape_lens, size_t input_len) {
+  onnxruntime::NameShapeMap input_shape_set;
+  for (size_t i = 0; i != input_len; ++i) {
+    input_shape_set[input_names[i]].assign(input_shapes[i], input_shapes[i] + input_shape_lens[i]);
+  }
+  options->value.warmup_input_shapes.push_back(std::move(input_shape_set));
+  return nullptr;
+}
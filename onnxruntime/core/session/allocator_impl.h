@@ -6,7 +6,7 @@
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
-class AllocatorWrapper : public IAllocator {
+class AllocatorWrapper : public IDeviceAllocator {
  public:
   AllocatorWrapper(OrtAllocator* impl) : impl_(impl) {}
   void* Alloc(size_t size) override {
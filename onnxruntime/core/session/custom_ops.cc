@@ -50,6 +50,48 @@ ORT_API_STATUS_IMPL(OrtKernelContext_GetOutput, _Inout_ OrtKernelContext* contex
   return nullptr;
 };
 
+ORT_API_STATUS_IMPL(OrtKernelContext_ParallelFor, _Inout_ OrtKernelContext* context, _In_ OrtKernelParallelForFunc fn,
+                    _In_opt_ void* param, size_t total, double cost_per_unit) {
+  auto* tp = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    fn(param, 0, total);
+    return nullptr;
+  }
+  tp->ParallelForRange(0, static_cast<int64_t>(total), cost_per_unit, [fn, param](int64_t first, int64_t last) {
+    fn(param, static_cast<size_t>(first), static_cast<size_t>(last));
+  });
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_AllocateScratch, _Inout_ OrtKernelContext* context, size_t size, _Outptr_ void** out) {
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetTempSpaceAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  try {
+    *out = allocator->Alloc(size);
+  } catch (const std::exception& ex) {
+    return OrtCreateStatus(ORT_FAIL, ex.what());
+  }
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_FreeScratch, _Inout_ OrtKernelContext* context, _In_opt_ void* p) {
+  onnxruntime::AllocatorPtr allocator;
+  auto status = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetTempSpaceAllocator(&allocator);
+  if (!status.IsOK())
+    return onnxruntime::ToOrtStatus(status);
+  allocator->Free(p);
+  return nullptr;
+};
+
+ORT_API_STATUS_IMPL(OrtKernelContext_GetGPUResource, _In_ const OrtKernelContext* context, OrtGPUResource resource,
+                    _Out_ void** out) {
+  const auto* provider = reinterpret_cast<const onnxruntime::OpKernelContextInternal*>(context)->GetExecutionProvider();
+  *out = nullptr;
+  return onnxruntime::ToOrtStatus(provider->GetGPUResource(resource, out));
+};
+
 ORT_API_STATUS_IMPL(OrtKernelInfoGetAttribute_string, _In_ const OrtKernelInfo* info, _In_ const char* name, _Out_ char* out, _Inout_ size_t* size) {
   std::string value;
   auto status = reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->GetAttr<std::string>(name, &value);
@@ -88,6 +130,12 @@ constexpr OrtCustomOpApi g_custom_op_api = {
     &OrtKernelContext_GetInput,
     &OrtKernelContext_GetOutputCount,
     &OrtKernelContext_GetOutput,
+
+    &OrtKernelContext_ParallelFor,
+    &OrtKernelContext_AllocateScratch,
+    &OrtKernelContext_FreeScratch,
+
+    &OrtKernelContext_GetGPUResource,
 };
 
 const OrtCustomOpApi& GetCustomOpApi() { return g_custom_op_api; }
@@ -96,7 +144,7 @@ namespace onnxruntime {
 
 struct CustomOpKernel : OpKernel {
   CustomOpKernel(const OpKernelInfo& info, OrtCustomOp& op) : OpKernel(info), op_(op) {
-    if (op_.version != 1)
+    if (op_.version < 1 || op_.version > ORT_API_VERSION)
       throw std::invalid_argument("Unsupported version '" + std::to_string(op_.version) + "' in custom op '" + op.GetName(&op));
     op_kernel_ = op_.CreateKernel(&op_, &g_custom_op_api, reinterpret_cast<OrtKernelInfo*>(const_cast<OpKernelInfo*>(&info)));
   }
@@ -158,6 +206,17 @@ common::Status CreateCustomRegistry(const std::vector<OrtCustomOpDomain*>& op_do
       else
         def_builder.Provider(onnxruntime::kCpuExecutionProvider);
 
+      if (op->version >= 2) {
+        for (size_t i = 0; i < output_count; i++) {
+          int input_index = op->GetMayInplaceInput ? op->GetMayInplaceInput(op, i) : -1;
+          if (input_index >= 0)
+            def_builder.MayInplace(input_index, static_cast<int>(i));
+          input_index = op->GetAliasInput ? op->GetAliasInput(op, i) : -1;
+          if (input_index >= 0)
+            def_builder.Alias(input_index, static_cast<int>(i));
+        }
+      }
+
       KernelCreateFn kernel_create_fn = [&op](const OpKernelInfo& info) -> OpKernel* { return new CustomOpKernel(info, *op); };
       KernelCreateInfo create_info(def_builder.Build(), kernel_create_fn);
 
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/session/environment.h"
+
+#include <thread>
+
 #include "core/framework/allocatormgr.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 #include "onnx/defs/operator_sets.h"
@@ -24,10 +28,57 @@ std::atomic<bool> Environment::is_initialized_{false};
 
 Status Environment::Create(std::unique_ptr<Environment>& environment) {
   environment = std::unique_ptr<Environment>(new Environment());
+  environment->shared_initializer_cache_ = std::make_unique<SharedInitializerCache>();
   auto status = environment->Initialize();
   return status;
 }
 
+namespace {
+std::unique_ptr<concurrency::ThreadPool> CreateGlobalThreadPool(const char* name, int size,
+                                                                const concurrency::ThreadOptions& thread_options) {
+  if (size < 0) size = std::thread::hardware_concurrency() / 2;
+  return size > 0 ? std::make_unique<concurrency::ThreadPool>(name, size, thread_options) : nullptr;
+}
+}  // namespace
+
+Status Environment::Create(std::unique_ptr<Environment>& environment,
+                           const GlobalThreadPoolOptions& thread_pool_options) {
+  ORT_RETURN_IF_ERROR(Create(environment));
+
+  environment->intra_op_thread_pool_ = CreateGlobalThreadPool("GLOBAL_INTRA_OP",
+                                                              thread_pool_options.intra_op_thread_pool_size,
+                                                              thread_pool_options.intra_op_thread_options);
+  environment->inter_op_thread_pool_ = CreateGlobalThreadPool("GLOBAL_INTER_OP",
+                                                              thread_pool_options.inter_op_thread_pool_size,
+                                                              thread_pool_options.inter_op_thread_options);
+  environment->has_global_thread_pools_ = true;
+  return Status::OK();
+}
+
+Status Environment::RegisterAllocator(AllocatorPtr allocator) {
+  ORT_RETURN_IF_NOT(allocator != nullptr, "allocator is null.");
+  const OrtMemoryInfo& info = allocator->Info();
+  for (const auto& registered : registered_allocators_) {
+    const OrtMemoryInfo& registered_info = registered->Info();
+    if (registered_info.id == info.id && registered_info.mem_type == info.mem_type &&
+        strcmp(registered_info.name, info.name) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "An allocator for ", info, " is already registered.");
+    }
+  }
+  registered_allocators_.push_back(std::move(allocator));
+  return Status::OK();
+}
+
+// each output of a copy node is a copy of the input at the same index
+static void PropagateShapesAndTypesOfCopies(InferenceContext& ctx) {
+  for (size_t i = 0, end = ctx.getNumInputs(); i < end; ++i) {
+    propagateElemTypeFromInputToOutput(ctx, i, i);
+    if (hasInputShape(ctx, i)) {
+      propagateShapeFromInputToOutput(ctx, i, i);
+    }
+  }
+}
+
 Status Environment::Initialize() {
   auto status = Status::OK();
 
@@ -53,27 +104,27 @@ Status Environment::Initialize() {
 
     // These ops are internal-only, so register outside of onnx
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyFromHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "inputs", "T", OpSchema::Variadic, /*is_homogeneous*/ false)
+        .Output(0, "Y", "outputs, one per input", "T", OpSchema::Variadic, /*is_homogeneous*/ false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(PropagateShapesAndTypesOfCopies)
         .SetDoc(R"DOC(
-Internal copy node
+Internal copy node, copying the tensors that cross the device boundary at the same point in one batch
 )DOC");
 
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyToHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "inputs", "T", OpSchema::Variadic, /*is_homogeneous*/ false)
+        .Output(0, "Y", "outputs, one per input", "T", OpSchema::Variadic, /*is_homogeneous*/ false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(PropagateShapesAndTypesOfCopies)
         .SetDoc(R"DOC(
-Internal copy node
+Internal copy node, copying the tensors that cross the device boundary at the same point in one batch
 )DOC");
 
     is_initialized_ = true;
@@ -7,7 +7,10 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <unordered_set>
 #include <list>
@@ -17,11 +20,14 @@
 #include "core/common/logging/logging.h"
 #include "core/platform/notification.h"
 #include "core/platform/ort_mutex.h"
+#include "core/platform/perf_counters.h"
 #include "core/platform/threadpool.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/customregistry.h"
 #include "core/session/environment.h"
 #include "core/framework/error_code_helper.h"
@@ -39,6 +45,7 @@
 #include "core/framework/session_state_initializer.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
+#include "core/framework/termination_check.h"
 #include "core/framework/utils.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
@@ -47,6 +54,7 @@
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "core/session/custom_ops.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
@@ -89,37 +97,112 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
-concurrency::ThreadPool* CreateThreadPool(int size) {
+concurrency::ThreadPool* CreateThreadPool(const char* name, int size,
+                                         const concurrency::ThreadOptions& thread_options) {
   if (size < 0) size = std::thread::hardware_concurrency() / 2;
-  return size > 0 ? new concurrency::ThreadPool("SESSION", size) : nullptr;
+  return size > 0 ? new concurrency::ThreadPool(name, size, thread_options) : nullptr;
+}
+
+// Returns the thread pool a session should use: the environment's pool when the session opted in to
+// global thread pools, and the session's own pool otherwise.
+concurrency::ThreadPool* SelectThreadPool(const SessionOptions& session_options, const Environment* environment,
+                                          concurrency::ThreadPool* session_thread_pool, bool inter_op) {
+  if (!session_options.use_global_thread_pools) {
+    return session_thread_pool;
+  }
+
+  ORT_ENFORCE(environment != nullptr && environment->HasGlobalThreadPools(),
+              "use_global_thread_pools requires an Environment that was created with global thread pools.");
+  if (inter_op) {
+    return session_options.enable_sequential_execution ? nullptr : environment->GetInterOpThreadPool();
+  }
+  return environment->GetIntraOpThreadPool();
+}
+
+SharedInitializerCache* SelectSharedInitializerCache(const SessionOptions& session_options,
+                                                     const Environment* environment) {
+  if (!session_options.use_shared_initializers) {
+    return nullptr;
+  }
+  ORT_ENFORCE(environment != nullptr, "use_shared_initializers requires an Environment.");
+  return environment->GetSharedInitializerCache();
+}
+
+std::vector<AllocatorPtr> SelectEnvAllocators(const SessionOptions& session_options, const Environment* environment) {
+  if (!session_options.use_env_allocators) {
+    return {};
+  }
+  ORT_ENFORCE(environment != nullptr, "use_env_allocators requires an Environment.");
+  return environment->GetRegisteredAllocators();
 }
 
 }  // namespace
 
+CPUAllocatorConfig GetCPUAllocatorConfig(const SessionOptions& session_options) {
+  CPUAllocatorConfig config;
+  config.use_huge_pages = session_options.enable_cpu_mem_huge_pages;
+  config.numa_node = session_options.cpu_mem_numa_node;
+  // follow the intra-op threads, unless an affinity overrides their NUMA node or they aren't the session's own
+  const auto& thread_options = session_options.session_thread_pool_options;
+  if (config.numa_node < 0 && !session_options.use_global_thread_pools && thread_options.affinity.empty()) {
+    config.numa_node = thread_options.numa_node;
+  }
+  return config;
+}
+
 InferenceSession::InferenceSession(const SessionOptions& session_options,
-                                   logging::LoggingManager* logging_manager)
+                                   logging::LoggingManager* logging_manager,
+                                   const Environment* environment)
     : session_options_{session_options},
       graph_transformation_mgr_{session_options.max_num_graph_transformation_steps},
       logging_manager_{logging_manager},
-      thread_pool_(CreateThreadPool(session_options.session_thread_pool_size)),
+      run_trace_buffer_{session_options.trace_buffer_size, session_options.trace_sample_rate,
+                        session_options.run_trace_hook},
+      thread_pool_(session_options.use_global_thread_pools
+                       ? nullptr
+                       : CreateThreadPool("SESSION", session_options.session_thread_pool_size,
+                                          session_options.session_thread_pool_options)),
+      inter_op_thread_pool_(session_options.use_global_thread_pools || session_options.enable_sequential_execution
+                                ? nullptr
+                                : CreateThreadPool("SESSION_INTER_OP", session_options.inter_op_thread_pool_size,
+                                                   session_options.inter_op_thread_pool_options)),
+      shared_initializer_cache_(SelectSharedInitializerCache(session_options, environment)),
+      env_allocators_(SelectEnvAllocators(session_options, environment)),
       session_state_(execution_providers_,
                      session_options.enable_mem_pattern && session_options.enable_sequential_execution,
-                     thread_pool_.get()),
-      insert_cast_transformer_{"CastFloat16Transformer"} {
+                     SelectThreadPool(session_options, environment, thread_pool_.get(), /*inter_op*/ false),
+                     SelectThreadPool(session_options, environment, inter_op_thread_pool_.get(), /*inter_op*/ true)),
+      insert_cast_transformer_{"CastFloat16Transformer", session_options.enable_cuda_float16} {
   ORT_ENFORCE(Environment::IsInitialized(),
               "Environment must be initialized before creating an InferenceSession.");
 
   InitLogger(logging_manager);
 
   session_state_.SetDataTransferMgr(&data_transfer_mgr_);
+  session_state_.SetMemoryPatternCacheOptions(session_options.mem_pattern_shape_bucket_size,
+                                              session_options.mem_pattern_cache_size);
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
+  if (session_options.enable_profiling_hardware_counters) {
+    PerfCounterValues counters;
+    if (ReadThreadPerfCounters(counters)) {
+      session_state_.SetProfileHardwareCounters(true);
+    } else {
+      LOGS(*session_logger_, WARNING) << "Hardware counters are not available, so they won't be profiled.";
+    }
+  }
   if (session_options.enable_profiling) {
     StartProfiling(session_options.profile_file_prefix);
   }
 }
 
 InferenceSession::~InferenceSession() {
+  // the runs enqueued by RunAsync use the session
+  {
+    std::unique_lock<onnxruntime::OrtMutex> lock(async_run_mutex_);
+    async_run_cv_.wait(lock, [this]() { return num_pending_async_runs_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -150,6 +233,13 @@ common::Status InferenceSession::RegisterExecutionProvider(std::unique_ptr<IExec
       return st;
     }
   }
+  for (const auto& allocator : env_allocators_) {
+    if (p_exec_provider->ReplaceAllocator(allocator)) {
+      VLOGS(*session_logger_, 1) << "Using the allocator of the environment for " << allocator->Info() << " of "
+                                 << provider_type;
+    }
+  }
+
   execution_providers_.Add(provider_type, std::move(p_exec_provider));
 
   return Status::OK();
@@ -214,6 +304,7 @@ common::Status InferenceSession::Load(std::function<common::Status(std::shared_p
 
     // all steps complete, mark the model as loaded.
     is_model_loaded_ = true;
+    initialization_times_.load_us = TimeDiffMicroSeconds(tp);
   } catch (const std::exception& ex) {
     status = Status(common::ONNXRUNTIME, common::FAIL, "Exception during loading: " + std::string(ex.what()));
   } catch (...) {
@@ -291,21 +382,23 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
 
 common::Status InferenceSession::Load(std::istream& model_istream) {
   auto loader = [this, &model_istream](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    auto model_proto = std::make_unique<ModelProto>();
 
     google::protobuf::io::IstreamInputStream zero_copy_input(&model_istream);
-    const bool result = model_proto.ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+    const bool result = model_proto->ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    // hand the parsed proto over to the model rather than have it take a copy of every initializer
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr);
   };
 
   return Load(loader, "model_loading_istream");
@@ -313,26 +406,51 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
 
 common::Status InferenceSession::Load(const void* model_data, int model_data_len) {
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    auto model_proto = std::make_unique<ModelProto>();
 
-    const bool result = model_proto.ParseFromArray(model_data, model_data_len);
+    const bool result = model_proto->ParseFromArray(model_data, model_data_len);
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
 
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return onnxruntime::Model::Load(std::move(model_proto), model,
+                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr);
   };
 
   return Load(loader, "model_loading_array");
 }
 
+namespace {
+
+// Metadata properties of an optimized model serialized by a session.
+constexpr const char* kOptimizationLevelMetadataKey = "onnxruntime.graph_optimization_level";
+constexpr const char* kNchwcBlockSizeMetadataKey = "onnxruntime.nchwc_block_size";
+
+bool ContainsNchwcNodes(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.Domain() == kMSNchwcDomain) {
+      return true;
+    }
+    if (node.ContainsSubgraph()) {
+      for (const auto* subgraph : node.GetSubgraphs()) {
+        if (ContainsNchwcNodes(*subgraph)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
                                                 const onnxruntime::GraphTransformerManager& graph_transformer_mgr,
                                                 const ExecutionProviders& providers,
@@ -350,8 +468,13 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  auto tp = session_profiler_.StartTime();
+  GraphPartitioner partitioner(kernel_registry_manager, providers, GetInitializationThreadPool());
   ORT_RETURN_IF_ERROR(partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr()));
+  initialization_times_.graph_partitioning_us = TimeDiffMicroSeconds(tp);
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_partitioning", tp);
+  }
 
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
@@ -400,9 +523,12 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
 
       auto subgraph_session_state = std::make_unique<SessionState>(execution_providers_,
                                                                    session_state.GetEnableMemoryPattern(),
-                                                                   session_state.GetThreadPool());
+                                                                   session_state.GetThreadPool(),
+                                                                   session_state.GetInterOpThreadPool());
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
+      subgraph_session_state->SetMemoryPatternCacheOptions(session_options_.mem_pattern_shape_bucket_size,
+                                                           session_options_.mem_pattern_cache_size);
       // Pass data transfer manager to subgraph.
       subgraph_session_state->SetDataTransferMgr(&session_state.GetDataTransferMgr());
       // Pass fused function manager to subgraph
@@ -425,6 +551,14 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
 /// @param session_state The SessionState instance for 'graph'.
 /// @remarks We pass in graph and session_state so we can handled nested subgraphs in the future
 common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, SessionState& session_state) {
+  struct SubgraphInfo {
+    Node* node;
+    const std::string* attribute_name;
+    Graph* subgraph;
+    SessionState* session_state;
+  };
+  std::vector<SubgraphInfo> subgraphs;
+
   for (auto& node : graph.Nodes()) {
     // We only need subgraph session state for control flow nodes being handled by the CPU execution provider.
     // Remove it if it's not needed.
@@ -434,37 +568,63 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
     }
 
     for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
-      auto& name = entry.first;
-      Graph& subgraph = *entry.second;
-
-      SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), name);
+      SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), entry.first);
       ORT_ENFORCE(subgraph_session_state, "CreateSubgraphSessionState should have created an entry earlier.");
+      subgraphs.push_back({&node, &entry.first, entry.second, subgraph_session_state});
+    }
+  }
 
-      // setup everything required to execute the subgraph and save it in subgraph_session_state
-      SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
-                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_);
+  // setup everything required to execute the subgraph and save it in its session state, then recurse.
+  // the subgraphs are independent of each other, so with parallel initialization they're set up concurrently.
+  auto initialize_subgraph = [this](const SubgraphInfo& info) -> Status {
+    SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, *info.subgraph,
+                                        *info.session_state, execution_providers_, kernel_registry_manager_,
+                                        shared_initializer_cache_, GetInitializationThreadPool());
 
-      const auto implicit_inputs = node.ImplicitInputDefs();
-      ORT_RETURN_IF_ERROR(initializer.CreatePlan(&node, &implicit_inputs,
-                                                 session_options_.enable_sequential_execution));
+    const auto implicit_inputs = info.node->ImplicitInputDefs();
+    ORT_RETURN_IF_ERROR(initializer.CreatePlan(info.node, &implicit_inputs,
+                                               session_options_.enable_sequential_execution,
+                                               session_options_.enable_memory_efficient_execution_order));
 
-      // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
-      //                                                   &*subgraph_info.session_state);
+    // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
+    //                                                   &*subgraph_info.session_state);
 
-      // setup all the info for handling the feeds and fetches used in subraph execution
-      auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
-      auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(session_state, name, *subgraph_session_state));
+    return InitializeSubgraphSessions(*info.subgraph, *info.session_state);
+  };
 
-      // recurse
-      ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(subgraph, *subgraph_session_state));
+  concurrency::ThreadPool* thread_pool = GetInitializationThreadPool();
+  if (thread_pool != nullptr && subgraphs.size() > 1) {
+    std::vector<Status> statuses(subgraphs.size());
+    thread_pool->ParallelFor(static_cast<int32_t>(subgraphs.size()),
+                             [&subgraphs, &statuses, &initialize_subgraph](int32_t i) {
+                               statuses[i] = initialize_subgraph(subgraphs[i]);
+                             });
+    for (const auto& status : statuses) {
+      ORT_RETURN_IF_ERROR(status);
+    }
+  } else {
+    for (const auto& info : subgraphs) {
+      ORT_RETURN_IF_ERROR(initialize_subgraph(info));
     }
   }
 
+  // setup all the info for handling the feeds and fetches used in subraph execution.
+  // a kernel may have several subgraphs, so this is done serially.
+  for (const auto& info : subgraphs) {
+    auto* p_op_kernel = session_state.GetMutableKernel(info.node->Index());
+    ORT_ENFORCE(p_op_kernel);
+    auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+    ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(session_state, *info.attribute_name,
+                                                                       *info.session_state));
+  }
+
   return Status::OK();
 }
 
+concurrency::ThreadPool* InferenceSession::GetInitializationThreadPool() const {
+  return session_options_.enable_parallel_initialization ? session_state_.GetThreadPool() : nullptr;
+}
+
 common::Status InferenceSession::Initialize() {
   Status status = Status::OK();
   auto tp = session_profiler_.StartTime();
@@ -486,21 +646,19 @@ common::Status InferenceSession::Initialize() {
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.arena_config = session_options_.arena_config;
+      epi.allocator_config = GetCPUAllocatorConfig(session_options_);
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
 
-    if (!session_options_.enable_sequential_execution &&
-        execution_providers_.Get(onnxruntime::kCudaExecutionProvider)) {
-      LOGS(*session_logger_, ERROR) << "Parallel execution is currently not supported "
-                                       "for the registered CUDA Execution Provider.";
-      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Parallel execution is currently not supported "
-                            "for the registered CUDA Execution Provider.");
-    }
+    // skip the transformers already applied to an optimized model serialized by a previous session
+    TransformerLevel applied_optimization_level;
+    ORT_RETURN_IF_ERROR(GetAppliedOptimizationLevel(applied_optimization_level));
 
     // add predefined transformers
-    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
+    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
+                              applied_optimization_level, transformers_to_enable_);
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
@@ -515,12 +673,14 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
-                                                session_state_, execution_providers_, kernel_registry_manager_);
+                                                session_state_, execution_providers_, kernel_registry_manager_,
+                                                shared_initializer_cache_, GetInitializationThreadPool());
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
 
     // apply any transformations to the main graph and any subgraphs
+    auto transform_tp = session_profiler_.StartTime();
     ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
                                        execution_providers_, kernel_registry_manager_,
                                        insert_cast_transformer_,
@@ -528,23 +688,85 @@ common::Status InferenceSession::Initialize() {
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR(graph.Resolve());
+    initialization_times_.graph_transformation_us =
+        TimeDiffMicroSeconds(transform_tp) - initialization_times_.graph_partitioning_us;
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transformation", transform_tp);
+    }
 
     if (!session_options_.optimized_model_filepath.empty()) {
-      if (session_options_.graph_optimization_level < TransformerLevel::Level3) {
-        // Serialize optimized ONNX model.
-        ORT_RETURN_IF_ERROR(Model::Save(*model_, session_options_.optimized_model_filepath));
+      // Record the applied optimization level so that sessions loading the optimized model skip
+      // the graph transformations. The NCHWc nodes and their reordered filters depend on the
+      // block size of the platform, which is recorded and validated when the model is loaded.
+      const auto saved_optimization_level = std::max(session_options_.graph_optimization_level,
+                                                     applied_optimization_level);
+      if (saved_optimization_level > TransformerLevel::Default) {
+        model_->SetMetaData(kOptimizationLevelMetadataKey,
+                            std::to_string(static_cast<int>(saved_optimization_level)));
+      }
+      if (ContainsNchwcNodes(graph)) {
+        model_->SetMetaData(kNchwcBlockSizeMetadataKey, std::to_string(MlasNchwcGetBlockSize()));
+      }
+
+      // Serialize optimized ONNX model.
+      ORT_RETURN_IF_ERROR(Model::Save(*model_, session_options_.optimized_model_filepath));
+    }
+
+    ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.enable_sequential_execution,
+                                                       session_options_.enable_memory_efficient_execution_order));
+    initialization_times_.initializer_loading_us = session_initializer.InitializerLoadingMicroSeconds();
+    initialization_times_.kernel_creation_us = session_initializer.KernelCreationMicroSeconds();
+
+    if (!session_options_.enable_sequential_execution && session_options_.enable_critical_path_scheduling) {
+      session_state_.EnableNodePriorities();
+    }
+
+    if (session_options_.enable_node_counters) {
+      session_state_.EnableNodeCounters();
+    }
+
+    if (session_options_.enable_shape_cache) {
+      session_state_.EnableNodeShapeCache();
+    }
+
+    if (!session_options_.incremental_execution_inputs.empty()) {
+      if (session_options_.enable_sequential_execution) {
+        ORT_RETURN_IF_ERROR(session_state_.EnableIncrementalExecution(session_options_.incremental_execution_inputs));
+        LOGS(*session_logger_, INFO) << "Incremental execution memoizes "
+                                     << session_state_.GetIncrementalExecutionCache()->NumMemoizedNodes()
+                                     << " nodes, with "
+                                     << session_state_.GetIncrementalExecutionCache()->FrontierValues().size()
+                                     << " values read by the other nodes.";
       } else {
-        LOGS(*session_logger_, WARNING) << "Serializing Optimized ONNX model with Graph Optimization"
-                                           " level greater than 2 is not supported.";
+        LOGS(*session_logger_, WARNING) << "Incremental execution is ignored, as it only applies to sequential "
+                                           "execution.";
       }
     }
 
-    ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.enable_sequential_execution));
+    if (session_options_.enable_memory_profiling) {
+      std::vector<std::shared_ptr<BFCArena>> arenas;
+      for (const auto& provider : execution_providers_) {
+        for (const auto& allocator : provider->GetAllocators()) {
+          const OrtMemoryInfo& info = allocator->Info();
+          auto arena = std::dynamic_pointer_cast<BFCArena>(provider->GetAllocator(info.id, info.mem_type));
+          if (arena != nullptr) {
+            arenas.push_back(std::move(arena));
+          }
+        }
+      }
+      session_state_.EnableMemoryProfiler(std::move(arenas));
+    }
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
+    SelectGraphCaptureProvider(graph);
     is_inited_ = true;
 
+    // Initialize only returns, and the session is only ready, once it's warmed up
+    if (!session_options_.warmup_input_shapes.empty()) {
+      ORT_RETURN_IF_ERROR(Warmup(session_options_.warmup_input_shapes));
+    }
+
     LOGS(*session_logger_, INFO) << "Session successfully initialized.";
   } catch (const NotImplementedException& ex) {
     status = ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Exception during initialization: ", ex.what());
@@ -557,6 +779,9 @@ common::Status InferenceSession::Initialize() {
     LOGS(*session_logger_, ERROR) << status.ErrorMessage();
   }
 
+  if (status.IsOK()) {
+    initialization_times_.initialize_us = TimeDiffMicroSeconds(tp);
+  }
   if (session_profiler_.IsEnabled()) {
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_initialization", tp);
   }
@@ -614,6 +839,34 @@ static common::Status CheckTypes(MLDataType actual, MLDataType expected) {
                 "Unexpected input data type. Actual: (" + actual_name + ") , expected: (" + expected_name + ")");
 }
 
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                                               const OrtValue& feed) const {
+  auto expected_type = input_def.ml_data_type;
+  if (feed.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
+                             feed_name, " is not expected to be of type tensor.");
+    }
+
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = feed.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    const auto& expected_shape = input_def.tensor_shape;
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = feed.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
+    }
+  } else {
+    auto input_type = feed.Type();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::ValidateInputs(const std::vector<std::string>& feed_names,
                                                 const std::vector<OrtValue>& feeds) const {
   if (feed_names.size() != feeds.size()) {
@@ -632,29 +885,7 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
                              "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
-                               feed_name, " is not expected to be of type tensor.");
-      }
-
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
-
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
-    }
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_name, iter->second, feeds.at(i)));
   }
 
   return Status::OK();
@@ -692,30 +923,33 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
   return common::Status::OK();
 }
 
-Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
-                             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
-                             std::vector<OrtValue>* p_fetches) {
+template <typename TExecute>
+Status InferenceSession::ExecuteRun(const RunOptions& run_options, TExecute&& execute) {
   auto tp = session_profiler_.StartTime();
   Status retval = Status::OK();
+  const TerminationCheck termination_check = TerminationCheck::ForRun(run_options);
+  std::unique_ptr<RunTrace> run_trace = run_trace_buffer_.StartRun(run_options);
+  RunTraceSpan run_span;
+  run_span.Begin(run_trace.get(), ORT_RUN_TRACE_SPAN_RUN, run_options.run_tag);
 
-  try {
-    if (!is_inited_) {
-      LOGS(*session_logger_, ERROR) << "Session was not initialized";
-      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
-    }
+  if (!run_options.run_tag.empty()) {
+    LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
+  }
 
-    ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+  ++current_num_runs_;
 
-    FeedsFetchesInfo info(feed_names, output_names, session_state_.GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
-
-    if (!run_options.run_tag.empty()) {
-      LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
-    }
+  concurrency::ThreadPool* low_latency_thread_pool =
+      session_options_.enable_low_latency_runs ? session_state_.GetThreadPool() : nullptr;
+  if (low_latency_thread_pool != nullptr) {
+    low_latency_thread_pool->StartLowLatency();
+  }
 
-    ++current_num_runs_;
+  std::unique_lock<OrtMutex> graph_capture_lock;
+  if (graph_capture_provider_ != nullptr) {
+    graph_capture_lock = std::unique_lock<OrtMutex>(graph_capture_mutex_);
+  }
 
+  try {
     // TODO should we add this exec to the list of executors? i guess its not needed now?
 
     // scope of owned_run_logger is just the call to Execute.
@@ -730,9 +964,7 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     }
 
     // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(
-        utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                            session_options_.enable_sequential_execution, run_options.terminate, run_logger));
+    ORT_CHECK_AND_SET_RETVAL(execute(run_logger, termination_check, run_trace.get()));
 
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
@@ -745,7 +977,15 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
     ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
   }
 
+  if (low_latency_thread_pool != nullptr) {
+    low_latency_thread_pool->EndLowLatency();
+  }
+
   --current_num_runs_;
+  run_span.End(retval);
+  if (run_trace != nullptr) {
+    run_trace_buffer_.Add(std::move(run_trace));
+  }
   if (session_profiler_.IsEnabled()) {
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
   }
@@ -753,6 +993,241 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   return retval;
 }
 
+Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                             std::vector<OrtValue>* p_fetches) {
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                 const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                                 std::vector<OrtValue>* p_fetches,
+                                 const std::vector<const OrtMemoryInfo*>* fetch_locations) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+  ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+
+  return ExecuteRun(run_options, [&](const logging::Logger& run_logger, const TerminationCheck& termination_check,
+                                         RunTrace* run_trace) {
+    FeedsFetchesInfo info(feed_names, output_names, session_state_.GetOrtValueNameIdxMap());
+    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+
+    auto execute_graph = [&]() {
+      return utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                 session_options_.enable_sequential_execution, termination_check, run_trace,
+                                 run_logger, fetch_locations);
+    };
+
+    // fetches that aren't preallocated are allocated by the run, at addresses a replay wouldn't write to
+    std::string graph_key;
+    if (graph_capture_provider_ == nullptr ||
+        (fetch_locations != nullptr &&
+         std::any_of(fetch_locations->cbegin(), fetch_locations->cend(),
+                     [](const OrtMemoryInfo* location) { return location != nullptr; })) ||
+        !GetGraphCaptureKey(feed_names, feeds, output_names, *p_fetches, graph_key)) {
+      return execute_graph();
+    }
+
+    return RunWithGraphCapture(graph_key, execute_graph);
+  });
+}
+
+void InferenceSession::SelectGraphCaptureProvider(const onnxruntime::Graph& graph) {
+  for (const auto& xp : execution_providers_) {
+    if (!xp->IsGraphCaptureEnabled()) {
+      continue;
+    }
+
+    if (!session_options_.enable_sequential_execution) {
+      LOGS(*session_logger_, WARNING) << "Graph capture by " << xp->Type()
+                                      << " is disabled, as it requires sequential execution.";
+      return;
+    }
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.GetExecutionProviderType() != xp->Type()) {
+        LOGS(*session_logger_, WARNING) << "Graph capture by " << xp->Type() << " is disabled, as node "
+                                        << node.Name() << " is assigned to " << node.GetExecutionProviderType();
+        return;
+      }
+    }
+
+    graph_capture_provider_ = xp.get();
+    graph_capture_device_ = xp->GetAllocator(0, OrtMemTypeDefault)->Info().device;
+    LOGS(*session_logger_, INFO) << "Runs are captured into graphs by " << xp->Type();
+    return;
+  }
+}
+
+bool InferenceSession::GetGraphCaptureKey(const std::vector<std::string>& feed_names,
+                                          const std::vector<OrtValue>& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          const std::vector<OrtValue>& fetches, std::string& key) const {
+  std::ostringstream out;
+  auto append = [&](const std::string& name, const OrtValue& value) {
+    if (!value.IsAllocated() || !value.IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = value.Get<Tensor>();
+    if (!(tensor.Location().device == graph_capture_device_)) {
+      return false;
+    }
+
+    out << name << ':' << tensor.Shape() << '@' << tensor.DataRaw() << ';';
+    return true;
+  };
+
+  if (fetches.size() != output_names.size()) {
+    return false;
+  }
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (!append(feed_names[i], feeds[i])) {
+      return false;
+    }
+  }
+  out << '|';
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    if (!append(output_names[i], fetches[i])) {
+      return false;
+    }
+  }
+
+  key = out.str();
+  return true;
+}
+
+Status InferenceSession::RunWithGraphCapture(const std::string& key, const std::function<Status()>& execute) {
+  if (graph_capture_provider_->IsGraphCaptured(key)) {
+    return graph_capture_provider_->ReplayGraph(key);
+  }
+  if (uncapturable_graph_keys_.count(key) != 0) {
+    return execute();
+  }
+
+  ORT_RETURN_IF_ERROR(graph_capture_provider_->BeginGraphCapture());
+  Status status;
+  try {
+    status = execute();
+  } catch (...) {
+    graph_capture_provider_->EndGraphCapture(key, false);
+    throw;
+  }
+
+  Status capture_status = graph_capture_provider_->EndGraphCapture(key, status.IsOK());
+  if (status.IsOK() && capture_status.IsOK()) {
+    // the captured work didn't run
+    return graph_capture_provider_->ReplayGraph(key);
+  }
+
+  // e.g. a kernel synchronized with the device, or copied data to the host to read it
+  LOGS(*session_logger_, WARNING) << "The run couldn't be captured into a graph and is executed without one: "
+                                  << (status.IsOK() ? capture_status : status).ErrorMessage();
+  uncapturable_graph_keys_.insert(key);
+  return execute();
+}
+
+common::Status InferenceSession::PrepareRun(const std::vector<std::string>& feed_names,
+                                            const std::vector<std::string>& output_names,
+                                            std::unique_ptr<PreparedRun>* prepared_run) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &fetches));
+
+  std::vector<const InputDefMetaData*> feed_defs;
+  feed_defs.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+    feed_defs.push_back(&iter->second);
+  }
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                                  feeds_fetches_manager));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state_, *feeds_fetches_manager));
+
+  // private constructor, can't use make_unique
+  prepared_run->reset(new PreparedRun(*this, std::move(feeds_fetches_manager), std::move(feed_defs)));
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run) {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The prepared run was created by another session.");
+  }
+
+  const auto& feed_names = prepared_run.GetFeedNames();
+  const auto& feeds = prepared_run.feeds_;
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_names[i], *prepared_run.feed_defs_[i], feeds[i]));
+  }
+
+  ORT_RETURN_IF_ERROR(prepared_run.FinalizeCopyInfo(session_state_));
+
+  return ExecuteRun(run_options, [&](const logging::Logger& run_logger, const TerminationCheck& termination_check,
+                                         RunTrace* run_trace) {
+    return utils::ExecuteFinalizedGraph(session_state_, *prepared_run.feeds_fetches_manager_,
+                                        feeds, prepared_run.fetches_,
+                                        session_options_.enable_sequential_execution, termination_check,
+                                        run_trace, run_logger);
+  });
+}
+
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                          const std::vector<OrtValue>& feeds,
+                                          const std::vector<std::string>& output_names,
+                                          std::vector<OrtValue>&& fetches, RunAsyncCallback callback) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  // report invalid names and values to the caller rather than through the callback
+  ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+  ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &fetches));
+
+  concurrency::ThreadPool* thread_pool;
+  {
+    std::lock_guard<onnxruntime::OrtMutex> lock(async_run_mutex_);
+    if (async_run_thread_pool_ == nullptr) {
+      int size = session_options_.inter_op_thread_pool_size;
+      if (size <= 0) size = std::max(1, static_cast<int>(std::thread::hardware_concurrency() / 2));
+      async_run_thread_pool_ = std::make_unique<concurrency::ThreadPool>(
+          "SESSION_ASYNC_RUN", size, session_options_.inter_op_thread_pool_options);
+    }
+    thread_pool = async_run_thread_pool_.get();
+    ++num_pending_async_runs_;
+  }
+
+  thread_pool->Schedule([this, &run_options, feed_names, feeds, output_names, fetches = std::move(fetches),
+                         callback = std::move(callback)]() mutable {
+    Status status = Run(run_options, feed_names, feeds, output_names, &fetches);
+    callback(status, fetches);
+
+    // the values may be freed by allocators of the session, so release them before the session can be destroyed
+    feeds.clear();
+    fetches.clear();
+    callback = nullptr;
+
+    std::lock_guard<onnxruntime::OrtMutex> lock(async_run_mutex_);
+    --num_pending_async_runs_;
+    async_run_cv_.notify_all();
+  });
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -832,7 +1307,16 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.feed_names_, io_binding.feeds_, io_binding.output_names_, &io_binding.outputs_);
+
+  // Outputs bound to a device are allocated by every run, as their shape may change.
+  for (size_t i = 0, end = io_binding.outputs_.size(); i < end; ++i) {
+    if (io_binding.output_locations_[i] != nullptr) {
+      io_binding.outputs_[i] = OrtValue();
+    }
+  }
+
+  return RunImpl(run_options, io_binding.feed_names_, io_binding.feeds_, io_binding.output_names_,
+                 &io_binding.outputs_, &io_binding.output_locations_);
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -840,6 +1324,308 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::Warmup(const std::vector<NameShapeMap>& input_shape_sets) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+
+  std::vector<std::string> output_names;
+  output_names.reserve(output_def_list_.size());
+  for (const auto* output : output_def_list_) {
+    output_names.push_back(output->Name());
+  }
+
+  RunOptions run_options;
+  run_options.run_tag = "warmup";
+
+  for (const auto& input_shapes : input_shape_sets) {
+    for (const auto& name_shape : input_shapes) {
+      if (input_def_map_.find(name_shape.first) == input_def_map_.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid warm-up input name: ", name_shape.first);
+      }
+    }
+
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    for (const auto& name_def : input_def_map_) {
+      const auto& name = name_def.first;
+      const auto& input_def = name_def.second;
+      auto shape_entry = input_shapes.find(name);
+      // initializers that can be overridden are only fed if they are listed
+      if (shape_entry == input_shapes.end() && required_inputs_.find(name) == required_inputs_.end()) {
+        continue;
+      }
+
+      if (input_def.ml_data_type == nullptr || !input_def.ml_data_type->IsTensorType()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Warm-up only supports tensor inputs. Input ", name,
+                               " is not a tensor.");
+      }
+
+      std::vector<int64_t> dims;
+      if (shape_entry != input_shapes.end()) {
+        dims = shape_entry->second;
+      } else {
+        dims = input_def.tensor_shape.GetDims();
+        for (auto& dim : dims) {
+          if (dim < 0) dim = 1;
+        }
+      }
+
+      const auto* element_type = static_cast<const TensorTypeBase*>(input_def.ml_data_type)->GetElementType();
+      auto tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), allocator);
+      if (element_type != DataTypeImpl::GetType<std::string>() && tensor->SizeInBytes() > 0) {
+        memset(tensor->MutableDataRaw(), 0, tensor->SizeInBytes());
+      }
+
+      feed_names.push_back(name);
+      feeds.emplace_back(tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                         DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    }
+
+    std::vector<OrtValue> fetches;
+    auto status = Run(run_options, feed_names, feeds, output_names, &fetches);
+    if (!status.IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Warm-up run failed: ", status.ErrorMessage());
+    }
+  }
+
+  return Status::OK();
+}
+
+namespace {
+
+// Whether dimension 0 of a graph input or output is symbolic, so that a batch of any number of rows fits it.
+bool HasSymbolicBatchDim(const TensorShapeProto* shape) {
+  return shape != nullptr && shape->dim_size() > 0 && !shape->dim(0).has_dim_value();
+}
+
+// Concatenates CPU tensors along dimension 0 into a new tensor. Returns false if their element types or their
+// other dimensions don't match.
+bool ConcatRows(const std::vector<const Tensor*>& parts, const AllocatorPtr& allocator, OrtValue& batch) {
+  const Tensor& first = *parts.front();
+  const auto& first_dims = first.Shape().GetDims();
+  int64_t rows = 0;
+  for (const Tensor* part : parts) {
+    const auto& dims = part->Shape().GetDims();
+    if (part->DataType() != first.DataType() || part->Location().device.Type() != OrtDevice::CPU ||
+        dims.empty() || dims.size() != first_dims.size() ||
+        !std::equal(dims.cbegin() + 1, dims.cend(), first_dims.cbegin() + 1)) {
+      return false;
+    }
+    rows += dims[0];
+  }
+
+  std::vector<int64_t> batch_dims(first_dims);
+  batch_dims[0] = rows;
+  auto tensor = std::make_unique<Tensor>(first.DataType(), TensorShape(batch_dims), allocator);
+  if (first.DataType() == DataTypeImpl::GetType<std::string>()) {
+    std::string* dst = tensor->MutableData<std::string>();
+    for (const Tensor* part : parts) {
+      const std::string* src = part->Data<std::string>();
+      dst = std::copy(src, src + part->Shape().Size(), dst);
+    }
+  } else {
+    auto* dst = static_cast<char*>(tensor->MutableDataRaw());
+    for (const Tensor* part : parts) {
+      memcpy(dst, part->DataRaw(), part->SizeInBytes());
+      dst += part->SizeInBytes();
+    }
+  }
+
+  batch.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return true;
+}
+
+// Returns rows [first_row, first_row + rows) of a CPU tensor as a tensor over its buffer, which keeps the batch
+// alive, so that the outputs of a batch aren't copied into the sets.
+OrtValue SliceRows(const OrtValue& batch, int64_t first_row, int64_t rows) {
+  const Tensor& tensor = batch.Get<Tensor>();
+  std::vector<int64_t> dims(tensor.Shape().GetDims());
+  const size_t row_size = dims[0] == 0 ? 0 : tensor.SizeInBytes() / static_cast<size_t>(dims[0]);
+  dims[0] = rows;
+
+  auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw())) + first_row * row_size;
+  auto slice = std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location());
+
+  OrtValue value;
+  value.Init(slice.release(), DataTypeImpl::GetType<Tensor>(),
+             [batch](void* p) { delete static_cast<Tensor*>(p); });
+  return value;
+}
+
+}  // namespace
+
+common::Status InferenceSession::RunMany(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                         const std::vector<std::vector<OrtValue>>& feeds,
+                                         const std::vector<std::string>& output_names,
+                                         std::vector<std::vector<OrtValue>>* p_fetches) {
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+  for (const auto& set_feeds : feeds) {
+    if (set_feeds.size() != feed_names.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Each set of feeds must have a value per feed name. Got ",
+                             set_feeds.size(), " values for ", feed_names.size(), " names.");
+    }
+  }
+
+  auto& fetches = *p_fetches;
+  fetches.clear();
+  fetches.resize(feeds.size());
+
+  if (feeds.size() > 1) {
+    bool batched = false;
+    ORT_RETURN_IF_ERROR(RunBatched(run_options, feed_names, feeds, output_names, fetches, batched));
+    if (batched) {
+      return Status::OK();
+    }
+  }
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds[i], output_names, &fetches[i]));
+  }
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunBatched(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                                            const std::vector<std::vector<OrtValue>>& feeds,
+                                            const std::vector<std::string>& output_names,
+                                            std::vector<std::vector<OrtValue>>& fetches, bool& batched) {
+  batched = false;
+  if (feed_names.empty()) {
+    return Status::OK();
+  }
+
+  for (const auto& name : feed_names) {
+    auto entry = input_def_map_.find(name);
+    if (entry == input_def_map_.end() || !HasSymbolicBatchDim(entry->second.node_arg->Shape())) {
+      return Status::OK();
+    }
+  }
+  for (const auto& name : output_names) {
+    auto output = std::find_if(output_def_list_.cbegin(), output_def_list_.cend(),
+                               [&name](const NodeArg* def) { return def->Name() == name; });
+    if (output == output_def_list_.cend() || !HasSymbolicBatchDim((*output)->Shape())) {
+      return Status::OK();
+    }
+  }
+
+  // the rows of each set, which all of its feeds must agree on
+  const size_t num_sets = feeds.size();
+  std::vector<int64_t> set_rows(num_sets);
+  std::vector<const Tensor*> parts(num_sets);
+  std::vector<OrtValue> batch_feeds(feed_names.size());
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+  for (size_t f = 0, num_feeds = feed_names.size(); f < num_feeds; ++f) {
+    for (size_t s = 0; s < num_sets; ++s) {
+      const OrtValue& value = feeds[s][f];
+      if (!value.IsTensor() || value.Get<Tensor>().Shape().NumDimensions() == 0) {
+        return Status::OK();
+      }
+      parts[s] = &value.Get<Tensor>();
+      const int64_t rows = parts[s]->Shape()[0];
+      if (f == 0) {
+        set_rows[s] = rows;
+      } else if (rows != set_rows[s]) {
+        return Status::OK();
+      }
+    }
+    if (!ConcatRows(parts, allocator, batch_feeds[f])) {
+      return Status::OK();
+    }
+  }
+
+  std::vector<OrtValue> batch_fetches;
+  ORT_RETURN_IF_ERROR(Run(run_options, feed_names, batch_feeds, output_names, &batch_fetches));
+
+  // an output that doesn't have a row per input row can't be split into the sets, which are then run one by one
+  const int64_t total_rows = std::accumulate(set_rows.cbegin(), set_rows.cend(), int64_t{0});
+  for (const auto& fetch : batch_fetches) {
+    if (!fetch.IsTensor()) {
+      return Status::OK();
+    }
+    const Tensor& tensor = fetch.Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || tensor.Shape().NumDimensions() == 0 ||
+        tensor.Shape()[0] != total_rows) {
+      return Status::OK();
+    }
+  }
+
+  for (const auto& fetch : batch_fetches) {
+    int64_t first_row = 0;
+    for (size_t s = 0; s < num_sets; ++s) {
+      fetches[s].push_back(SliceRows(fetch, first_row, set_rows[s]));
+      first_row += set_rows[s];
+    }
+  }
+
+  batched = true;
+  return Status::OK();
+}
+
+NodeCounters* InferenceSession::GetNodeCounters() const {
+  return is_inited_ ? session_state_.GetNodeCounters() : nullptr;
+}
+
+MemoryProfiler* InferenceSession::GetMemoryProfiler() const {
+  return is_inited_ ? session_state_.GetMemoryProfiler() : nullptr;
+}
+
+std::string InferenceSession::DumpRunTraces(bool clear) {
+  return run_trace_buffer_.Dump(clear);
+}
+
+common::Status InferenceSession::ShrinkMemoryArenas() {
+  for (const auto& provider : execution_providers_) {
+    for (const auto& allocator : provider->GetAllocators()) {
+      const OrtMemoryInfo& info = allocator->Info();
+      auto arena = std::dynamic_pointer_cast<IArenaAllocator>(provider->GetAllocator(info.id, info.mem_type));
+      if (arena != nullptr) {
+        ORT_RETURN_IF_ERROR(arena->Shrink());
+      }
+    }
+  }
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetMemoryArenaBytesInUse(size_t& bytes_in_use) const {
+  size_t bytes_reserved;
+  return GetMemoryArenaStats(nullptr, bytes_reserved, bytes_in_use);
+}
+
+common::Status InferenceSession::GetMemoryArenaStats(const char* allocator_name, size_t& bytes_reserved,
+                                                     size_t& bytes_in_use) const {
+  bytes_reserved = 0;
+  bytes_in_use = 0;
+  for (const auto& provider : execution_providers_) {
+    for (const auto& allocator : provider->GetAllocators()) {
+      const OrtMemoryInfo& info = allocator->Info();
+      if (allocator_name != nullptr && strcmp(info.name, allocator_name) != 0) {
+        continue;
+      }
+      auto arena = std::dynamic_pointer_cast<IArenaAllocator>(provider->GetAllocator(info.id, info.mem_type));
+      if (arena == nullptr) {
+        continue;
+      }
+      // the BFC arena counts the chunks parked in its thread caches in Used(), its stats leave them out
+      auto bfc_arena = std::dynamic_pointer_cast<BFCArena>(arena);
+      if (bfc_arena != nullptr) {
+        AllocatorStats stats;
+        bfc_arena->GetStats(&stats);
+        bytes_reserved += static_cast<size_t>(stats.total_allocated_bytes);
+        bytes_in_use += static_cast<size_t>(stats.bytes_in_use);
+      } else {
+        bytes_reserved += arena->Used();
+        bytes_in_use += arena->Used();
+      }
+    }
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -864,6 +1650,28 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      // add the device times of the kernels still running asynchronously
+      for (const auto& provider : execution_providers_) {
+        auto status = provider->FlushKernelTimings();
+        if (!status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Could not add the kernel timings of " << provider->Type()
+                                          << " to the profile: " << status.ErrorMessage();
+        }
+      }
+
+      const MemoryProfiler* memory_profiler = session_state_.GetMemoryProfiler();
+      if (memory_profiler != nullptr) {
+        // summarize the tensors in use at the peak of the runs
+        auto summary = memory_profiler->GetPeakSummary();
+        for (const auto& tensor : summary.tensors) {
+          TimePoint tp = session_profiler_.StartTime();
+          session_profiler_.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, tensor.tensor_name, tp,
+                                                  {{"kind", "peak_tensor"},
+                                                   {"bytes", std::to_string(tensor.bytes)},
+                                                   {"node", tensor.node_name},
+                                                   {"peak_bytes", std::to_string(summary.peak_bytes)}});
+        }
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -943,14 +1751,6 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
 
   // create a per-run logger if we can
   if (logging_manager_ != nullptr) {
-    std::string run_log_id{session_options_.session_logid};
-
-    if (!session_options_.session_logid.empty() && !run_options.run_tag.empty()) {
-      run_log_id += ":";
-    }
-
-    run_log_id += run_options.run_tag;
-
     logging::Severity severity = logging::Severity::kWARNING;
     if (run_options.run_log_severity_level == -1) {
       severity = session_logger_->GetSeverity();
@@ -962,13 +1762,14 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
       severity = static_cast<logging::Severity>(run_options.run_log_severity_level);
     }
 
-    new_run_logger = logging_manager_->CreateLogger(run_log_id,
-                                                    severity,
-                                                    false,
-                                                    run_options.run_log_verbosity_level);
+    // the log id of the run is only built when it logs a message, so a run whose messages are filtered doesn't pay
+    // for it
+    new_run_logger = std::make_unique<logging::Logger>(*logging_manager_, session_options_.session_logid,
+                                                       run_options.run_tag, severity, false,
+                                                       run_options.run_log_verbosity_level);
 
     run_logger = new_run_logger.get();
-    VLOGS(*run_logger, 1) << "Created logger for run with id of " << run_log_id;
+    VLOGS(*run_logger, 1) << "Created logger for run with tag " << run_options.run_tag;
   } else {
     // fallback to using default logger. this does NOT have any session or run specific id/tag in it
     run_logger = session_logger_;
@@ -1007,10 +1808,23 @@ void InferenceSession::InitLogger(logging::LoggingManager* logging_manager) {
 // Registers all the predefined transformers with transformer manager
 void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                                  TransformerLevel graph_optimization_level,
+                                                 TransformerLevel applied_optimization_level,
                                                  const std::vector<std::string>& custom_list) {
   auto add_transformers = [&](TransformerLevel level) {
+    if (level <= applied_optimization_level) {
+      LOGS(*session_logger_, INFO) << "Skipping level " << static_cast<int>(level)
+                                   << " transformers already applied to the optimized model.";
+      return;
+    }
+
     // Generate and register transformers for level
-    auto transformers_to_register = transformer_utils::GenerateTransformers(level, custom_list);
+    auto transformers_to_register = transformer_utils::GenerateTransformers(
+        level, custom_list, session_options_.constant_folding_max_output_size_in_bytes,
+        session_options_.enable_dynamic_quantization,
+        session_options_.nchwc_min_isolated_conv_flops_per_reorder,
+        session_options_.enable_zipmap_elimination,
+        session_options_.weight_only_quantization_bits,
+        session_options_.weight_only_quantization_block_size);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
@@ -1033,6 +1847,40 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
   }
 }
 
+common::Status InferenceSession::GetAppliedOptimizationLevel(TransformerLevel& applied_optimization_level) const {
+  applied_optimization_level = TransformerLevel::Default;
+
+  const auto& metadata = model_->MetaData();
+  auto level_it = metadata.find(kOptimizationLevelMetadataKey);
+  if (level_it == metadata.end()) {
+    return Status::OK();
+  }
+
+  int level = 0;
+  try {
+    level = std::stoi(level_it->second);
+  } catch (const std::exception&) {
+    level = -1;
+  }
+  if (level < static_cast<int>(TransformerLevel::Default) ||
+      level >= static_cast<int>(TransformerLevel::MaxTransformerLevel)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Invalid ", kOptimizationLevelMetadataKey,
+                           " metadata value: ", level_it->second);
+  }
+
+  auto block_size_it = metadata.find(kNchwcBlockSizeMetadataKey);
+  if (block_size_it != metadata.end() &&
+      block_size_it->second != std::to_string(MlasNchwcGetBlockSize())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                           "The optimized model uses NCHWc block size ", block_size_it->second,
+                           " but this platform uses block size ", MlasNchwcGetBlockSize(),
+                           ". Serialize the optimized model on the target platform or load the original model.");
+  }
+
+  applied_optimization_level = static_cast<TransformerLevel>(level);
+  return Status::OK();
+}
+
 common::Status InferenceSession::WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) {
   if (timeout_in_ms > 0) {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, "timeout_in_ms >0 is not supported");  // TODO
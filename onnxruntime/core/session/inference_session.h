@@ -3,22 +3,27 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/run_trace.h"
 #include "core/framework/session_state.h"
 #include "core/graph/basic_types.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/ort_mutex.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -37,8 +42,13 @@ struct OrtCustomOpDomain {
 };
 
 namespace onnxruntime {
+class Environment;
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class MemoryProfiler;
+class NodeCounters;
+class PreparedRun;
+class SharedInitializerCache;
 class CustomRegistry;
 class Notification;
 
@@ -49,6 +59,11 @@ class LoggingManager;
 /**
   * Configuration information for a session.
   */
+/**
+  * Input shapes of a warm-up run by input name.
+  */
+using NameShapeMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
 struct SessionOptions {
   //int num_threads; // not used now until we re-introduce threadpools for async execution
   bool enable_sequential_execution = true;  // TODO: should we default to sequential execution?
@@ -56,7 +71,44 @@ struct SessionOptions {
   // enable profiling for this session.
   bool enable_profiling = false;
 
+  // Add the hardware counters of each kernel computation to its profiler event, with its achieved GFLOP/s and GB/s
+  // according to a static estimate of its work. Requires Linux perf_event access; ignored otherwise.
+  bool enable_profiling_hardware_counters = false;
+
+  // Count the kernel runs of each node of the main graph, with their compute time and output bytes. Unlike
+  // profiling, this is cheap enough to leave enabled in production. See InferenceSession::GetNodeCounters.
+  bool enable_node_counters = false;
+
+  // Let the kernels of the main graph cache what they derive from their input shapes, such as their output shapes,
+  // and reuse it while the shapes of their inputs stay the same. This mostly helps small models run with fixed shapes,
+  // where the shape logic is a noticeable part of the run time.
+  bool enable_shape_cache = false;
+
+  // Names of graph inputs that often hold the same values in consecutive runs, such as the encoder outputs fed to
+  // each step of a decoder. The nodes of the main graph that only depend on these inputs and on the initializers are
+  // memoized: a run whose values of these inputs equal those of the previous run reuses their outputs instead of
+  // running them. The inputs are compared by value, after copying them to CPU if needed. Only applies to sequential
+  // execution. See IncrementalExecutionCache.
+  std::vector<std::string> incremental_execution_inputs;
+
+  // Record a per node trace of one in every trace_sample_rate runs into a ring buffer of the trace_buffer_size most
+  // recent traces, which InferenceSession::DumpRunTraces returns on demand. 0 samples no runs, but the runs whose
+  // RunOptions set trace_run are still traced. A trace_buffer_size of 0 disables tracing.
+  int64_t trace_sample_rate = 0;
+  size_t trace_buffer_size = 16;
+
+  // Receives the spans of the phases of every run, e.g. to export them to a distributed tracing system.
+  // See OrtSetRunTraceCallbacks.
+  std::shared_ptr<RunTraceHook> run_trace_hook;
+
+  // Record the allocations, reuses and releases of the tensors of each run and the extensions of the arenas, to
+  // find the tensors driving the peak memory. With profiling enabled, they're also recorded as "Memory" events, and
+  // the tensors in use at the peak are written by EndProfiling. See InferenceSession::GetMemoryProfiler.
+  bool enable_memory_profiling = false;
+
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
+  // The serialized model records the applied optimization level, so a session that loads it skips
+  // the transformers of that level and below.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
   // enable the memory pattern optimization.
@@ -66,11 +118,33 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // Input dims are rounded up to a multiple of this value to find a memory pattern, so that
+  // e.g. variable sequence lengths share the pattern of their bucket. 1 requires exact shapes.
+  int64_t mem_pattern_shape_bucket_size = 1;
+
+  // Maximum number of memory patterns kept per session, least recently used evicted first.
+  // 0 means no limit.
+  size_t mem_pattern_cache_size = 0;
+
+  // Run the nodes in an order that lowers the peak memory use of the intermediate values, estimated from their
+  // inferred shapes, instead of the topological order of the graph. Only applies to sequential execution.
+  bool enable_memory_efficient_execution_order = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // Growth, limit and idle shrinking of the arena of the default CPU execution provider.
+  ArenaConfig arena_config;
+
+  // Back the large CPU allocations, such as the arena regions and the initializers, with huge pages.
+  bool enable_cpu_mem_huge_pages = false;
+
+  // Place the large CPU allocations on this NUMA node. -1 uses the NUMA node of the session thread pool, if it
+  // has one, so that the intra-op threads read local memory.
+  int cpu_mem_numa_node = -1;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -87,10 +161,89 @@ struct SessionOptions {
   // set graph optimization level
   TransformerLevel graph_optimization_level = TransformerLevel::Level1;
 
+  // Constant folding skips nodes that would expand their constant inputs into an output
+  // larger than this many bytes, so that folding does not blow up the model size.
+  // 0 means no limit.
+  size_t constant_folding_max_output_size_in_bytes = 16 * 1024 * 1024;
+
+  // Quantize the constant weights of float MatMul and Gemm nodes and compute them with an integer GEMM
+  // that quantizes the activations at run time. This trades accuracy for speed, so it is opt-in.
+  bool enable_dynamic_quantization = false;
+
+  // Quantize the constant weights of float MatMul and Gemm nodes to this many bits (4 or 8), with a scale for each
+  // block of weight_only_quantization_block_size rows (a power of 2, at least 16), and compute them with a kernel that
+  // dequantizes the weights on the fly. The activations stay in float. This speeds up the matrix-vector products of
+  // decoders, which are bound by the bandwidth to read the weights, and trades accuracy for it, so it is opt-in.
+  // 0 disables it.
+  int weight_only_quantization_bits = 0;
+  int weight_only_quantization_block_size = 32;
+
+  // Compute the float GEMMs and convolutions assigned to the CUDA execution provider in float16 on the Tensor Cores,
+  // with the element-wise and data movement ops around them, and cast the values they share with the rest of the
+  // graph. Softmax, the reductions and the normalizations stay in float. This trades accuracy for speed, so it is
+  // opt-in.
+  bool enable_cuda_float16 = false;
+
+  // Replace the ZipMap nodes that produce graph outputs, such as the probabilities of classifiers converted from
+  // scikit-learn, by their input tensor (one row of probabilities per sample, in the order of the class labels).
+  // The outputs keep their names but are tensors instead of sequences of maps, so this is opt-in.
+  bool enable_zipmap_elimination = false;
+
+  // The NCHWc transformer leaves a convolution in NCHW format if both its input and output would
+  // need to be reordered and it does fewer floating point operations than this per reordered element.
+  // 0 converts all supported convolutions.
+  float nchwc_min_isolated_conv_flops_per_reorder = 0.0f;
+
   // How many threads in the session thread pool.
+  // Kernels use this pool to parallelize work within a single node (intra-op parallelism).
   int session_thread_pool_size = -1;
+
+  // Where the threads of the session thread pool run.
+  concurrency::ThreadOptions session_thread_pool_options;
+
+  // How many threads in the pool the parallel executor uses to run independent nodes
+  // concurrently (inter-op parallelism). Only used if sequential execution is disabled.
+  int inter_op_thread_pool_size = -1;
+
+  // Where the threads of the inter-op thread pool run.
+  concurrency::ThreadOptions inter_op_thread_pool_options;
+
+  // Keep the threads of the session thread pool spinning for work while a Run is in progress, and let them
+  // block between runs. This removes the wake-up latency of the parallel loops of small models, at the cost of
+  // CPU time during the runs.
+  bool enable_low_latency_runs = false;
+
+  // When parallel execution is enabled, dispatch ready nodes in order of the longest remaining path to the
+  // end of the graph, weighted by the kernel times observed in previous runs.
+  bool enable_critical_path_scheduling = false;
+
+  // Use the thread pools owned by the Environment instead of creating per session thread pools.
+  // The thread pool sizes and options above are ignored if this is set.
+  bool use_global_thread_pools = false;
+
+  // Share the CPU initializers with the other sessions of the same model that set this, through the cache
+  // owned by the Environment, instead of each session holding its own copy of the weights.
+  bool use_shared_initializers = false;
+
+  // Use the allocators registered with the Environment in place of the allocators of the execution providers with
+  // the same name, device id and memory type, e.g. to share one arena among all the sessions on a device.
+  bool use_env_allocators = false;
+
+  // Deserialize the initializers, create the kernels and initialize the subgraphs concurrently on the session
+  // thread pool in Initialize. When partitioning, the first execution provider and those whose capability doesn't
+  // depend on the nodes placed before them (e.g. CPU) are asked for their capabilities concurrently. Kernels of the
+  // CPU execution provider, including those of custom ops, are then created concurrently, so their constructors must
+  // be thread-safe.
+  bool enable_parallel_initialization = false;
+
+  // Input shapes to warm the session up for, by running it once per entry in Initialize.
+  // See InferenceSession::Warmup.
+  std::vector<NameShapeMap> warmup_input_shapes;
 };
 
+// The allocator configuration of the CPU execution providers created for the session options.
+CPUAllocatorConfig GetCPUAllocatorConfig(const SessionOptions& session_options);
+
 /**
   * Pre-defined and custom metadata about the model.
   */
@@ -103,6 +256,18 @@ struct ModelMetadata {
   std::unordered_map<std::string, std::string> custom_metadata_map;
 };
 
+/**
+  * The time the phases of creating a session took, in microseconds.
+  */
+struct SessionInitializationTimes {
+  int64_t load_us = 0;                  // Load, including parsing the model
+  int64_t initialize_us = 0;            // Initialize, including the phases below and any warm-up runs
+  int64_t graph_transformation_us = 0;  // applying the graph transformers, excluding the partitioning
+  int64_t graph_partitioning_us = 0;    // assigning the nodes to the execution providers
+  int64_t initializer_loading_us = 0;   // saving the initializers of the main graph into the session state
+  int64_t kernel_creation_us = 0;       // creating the kernels of the main graph
+};
+
 /**
  * @brief This is the main class used to Run a model.
  * Sample simple usage:
@@ -135,9 +300,14 @@ class InferenceSession {
     If nullptr, the default LoggingManager MUST have been created previously as it will be used
     for logging. This will use the default logger id in messages.
     See core/common/logging/logging.h for details, and how LoggingManager::DefaultLogger works.
+    @param environment
+    Optional environment whose thread pools are used if session_options.use_global_thread_pools is set,
+    and whose initializer cache is used if session_options.use_shared_initializers is set.
+    The environment must outlive the session.
     */
   explicit InferenceSession(const SessionOptions& session_options,
-                            logging::LoggingManager* logging_manager = nullptr);
+                            logging::LoggingManager* logging_manager = nullptr,
+                            const Environment* environment = nullptr);
 
   virtual ~InferenceSession();
 
@@ -253,6 +423,107 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+    * Prepares runs of the model for the given input and output names. The names are resolved and validated once,
+    * so that each run of the prepared run only validates the types and shapes of the inputs.
+    * See PreparedRun class for more info.
+    */
+  common::Status PrepareRun(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                            std::unique_ptr<PreparedRun>* prepared_run);
+
+  /**
+    * Run the model with the feeds of a prepared run, which receives the outputs in its fetches.
+    * @param run_options use this to tune the Run call to your needs.
+    */
+  common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run);
+
+  /**
+    * Receives the status of a run enqueued by RunAsync and, if it succeeded, its outputs in the order of
+    * the output names. It is called on a thread of the session and must not throw or destroy the session.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Enqueues a run of the model and returns without waiting for it to complete. The run executes on the
+    * session's async run thread pool and calls callback when it completes.
+    * The names and values are copied, but run_options must stay alive until the callback is called.
+    * The session waits for its pending runs when it's destroyed.
+    * @param fetches pre-allocated outputs, or empty to have the run allocate them.
+    * @return OK if the run was enqueued, in which case the callback is always called; the error otherwise.
+    */
+  common::Status RunAsync(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                          const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                          std::vector<OrtValue>&& fetches, RunAsyncCallback callback);
+
+  /**
+    * Run the model for each of several sets of feeds in one call.
+    * If dimension 0 of the model inputs that are fed and of the requested outputs is symbolic, and the feeds are
+    * CPU tensors whose other dimensions match between the sets, the sets are concatenated along dimension 0 and
+    * run as one batch whose outputs are split back into the sets. This assumes the rows of a batch are computed
+    * independently of each other. Otherwise the sets are run one after the other.
+    * This API is thread-safe.
+    * @param feeds one vector of values per set, in the order of feed_names.
+    * @param p_fetches receives one vector of outputs per set, in the order of output_names.
+    * @return OK if success.
+    */
+  common::Status RunMany(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                         const std::vector<std::vector<OrtValue>>& feeds, const std::vector<std::string>& output_names,
+                         std::vector<std::vector<OrtValue>>* p_fetches);
+
+  /**
+    * Run the model once for each set of input shapes with zero-filled inputs, so that the costs of a first run
+    * for those shapes, such as growing the arenas, tracing the memory patterns and the searches or compilation
+    * of execution providers that cache per shape, aren't paid by later runs.
+    * An input that isn't listed in a set gets the shape of the model input, with 1 for symbolic dimensions.
+    * This API is thread-safe.
+    * @return OK if all the runs succeeded.
+    */
+  common::Status Warmup(const std::vector<NameShapeMap>& input_shape_sets);
+
+  /**
+    * Get the counters of the kernel runs of each node of the main graph.
+    * Safe to read while Run is in progress.
+    * @return NULL unless SessionOptions::enable_node_counters is set and the session is initialized.
+    */
+  NodeCounters* GetNodeCounters() const;
+
+  /**
+    * Get the traces of the most recent runs that were sampled by SessionOptions::trace_sample_rate or that set
+    * RunOptions::trace_run, in chromium format. Safe to call while Run is in progress.
+    * @param clear  whether to drop the returned traces from the buffer.
+    */
+  std::string DumpRunTraces(bool clear = false);
+
+  /**
+    * Get the memory profile of the runs, with the tensors in use at the peak.
+    * @return NULL unless SessionOptions::enable_memory_profiling is set and the session is initialized.
+    */
+  MemoryProfiler* GetMemoryProfiler() const;
+
+  /**
+    * Return the memory of all arenas of the registered execution providers that is not in use
+    * to the devices. Safe to call while Run is in progress.
+    */
+  common::Status ShrinkMemoryArenas();
+
+  /**
+    * Get the bytes allocated from all arenas of the registered execution providers that are in use by the session.
+    * Safe to call while Run is in progress.
+    */
+  common::Status GetMemoryArenaBytesInUse(size_t& bytes_in_use) const;
+
+  /**
+    * Get the bytes the arenas of the registered execution providers reserved from their devices and the bytes of
+    * those in use by the session. Safe to call while Run is in progress.
+    * @param allocator_name  the name of the allocators of the arenas to count, e.g. CPU or CUDA, or NULL for all.
+    */
+  common::Status GetMemoryArenaStats(const char* allocator_name, size_t& bytes_reserved, size_t& bytes_in_use) const;
+
+  /**
+    * Get the time the phases of Load and Initialize took. The phases that haven't run are 0.
+    */
+  const SessionInitializationTimes& GetInitializationTimes() const { return initialization_times_; }
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -337,6 +608,8 @@ class InferenceSession {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
 
+  friend PreparedRun;
+
   bool HasLocalSchema() const {
     return !custom_schema_registries_.empty();
   }
@@ -364,20 +637,68 @@ class InferenceSession {
 
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state);
 
+  // The thread pool Initialize runs its independent work on. nullptr if parallel initialization is disabled.
+  concurrency::ThreadPool* GetInitializationThreadPool() const;
+
   void AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                  TransformerLevel graph_optimization_level,
+                                 TransformerLevel applied_optimization_level,
                                  const std::vector<std::string>& custom_list);
 
+  // Returns the graph optimization level that was already applied to an optimized model
+  // serialized by a previous session, or an error if that model can't run on this platform.
+  common::Status GetAppliedOptimizationLevel(TransformerLevel& applied_optimization_level) const;
+
   void InitLogger(logging::LoggingManager* logging_manager);
 
   common::Status CheckShapes(const std::string& input_name,
                              const TensorShape& input_shape,
                              const TensorShape& expected_shape) const;
 
+  struct InputDefMetaData;
+
+  common::Status ValidateInput(const std::string& feed_name, const InputDefMetaData& input_def,
+                               const OrtValue& feed) const;
+
+  // Runs the sets of feeds of RunMany as one batch. batched is false if the sets can't be batched, in which case
+  // nothing was run.
+  common::Status RunBatched(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                            const std::vector<std::vector<OrtValue>>& feeds,
+                            const std::vector<std::string>& output_names,
+                            std::vector<std::vector<OrtValue>>& fetches, bool& batched);
+
   common::Status ValidateInputs(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds) const;
 
   common::Status ValidateOutputs(const std::vector<std::string>& output_names, const std::vector<OrtValue>* p_fetches) const;
 
+  // Implements Run. fetch_locations optionally provides the device location for each fetch that is not
+  // pre-allocated, so that it is left on that device instead of being returned on CPU.
+  common::Status RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                         const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                         std::vector<OrtValue>* p_fetches,
+                         const std::vector<const OrtMemoryInfo*>* fetch_locations);
+
+  // Executes a run that was validated by the caller. execute is called with the logger, the TerminationCheck and the
+  // RunTrace (null unless the run is traced) for the run and does the actual execution, between notifying the
+  // execution providers of the start and the end of the run. The run's timeout, if any, starts here.
+  template <typename TExecute>
+  common::Status ExecuteRun(const RunOptions& run_options, TExecute&& execute);
+
+  // Selects the execution provider whose runs are captured into graphs, if one has graph capture enabled and runs all
+  // the nodes of the main graph.
+  void SelectGraphCaptureProvider(const onnxruntime::Graph& graph);
+
+  // The key of the captured graph of a run, if it can be captured: all its feeds and fetches are tensors in the memory
+  // of the graph capture provider, with the fetches preallocated. It holds their names, shapes and addresses, so a
+  // replay of the graph reads and writes the same buffers as the captured run.
+  bool GetGraphCaptureKey(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                          const std::vector<std::string>& output_names, const std::vector<OrtValue>& fetches,
+                          std::string& key) const;
+
+  // Replays the graph of key, or captures it from execute and replays it if it wasn't captured yet. Runs execute
+  // without a graph if the run can't be captured. Called with graph_capture_mutex_ held.
+  common::Status RunWithGraphCapture(const std::string& key, const std::function<common::Status()>& execute);
+
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
   template <typename T>
@@ -404,6 +725,11 @@ class InferenceSession {
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // Traces of the sampled runs of this session.
+  RunTraceBuffer run_trace_buffer_;
+
+  SessionInitializationTimes initialization_times_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
@@ -411,6 +737,15 @@ class InferenceSession {
   // Threadpool for this session
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
 
+  // Threadpool used by the parallel executor. nullptr if sequential execution is enabled.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
+
+  // Cache of the environment the initializers are shared through. nullptr if they aren't shared.
+  SharedInitializerCache* shared_initializer_cache_;
+
+  // Allocators of the environment that replace those of the execution providers. Empty if they aren't used.
+  std::vector<AllocatorPtr> env_allocators_;
+
  protected:
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
@@ -443,10 +778,24 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Runs enqueued by RunAsync. These get their own pool, created by the first RunAsync, as a run that blocks a
+  // thread of the inter-op pool can deadlock the parallel executor, which waits on nodes scheduled to that pool.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;  // GUARDED_BY(async_run_mutex_)
+  int num_pending_async_runs_ = 0;                                                // GUARDED_BY(async_run_mutex_)
+  onnxruntime::OrtMutex async_run_mutex_;
+  onnxruntime::OrtCondVar async_run_cv_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
 
+  // The provider whose runs are captured into graphs, if any. Its runs are serialized by graph_capture_mutex_, as
+  // the work of concurrent runs would be captured with the run being captured.
+  IExecutionProvider* graph_capture_provider_ = nullptr;
+  OrtDevice graph_capture_device_;
+  onnxruntime::OrtMutex graph_capture_mutex_;
+  std::unordered_set<std::string> uncapturable_graph_keys_;  // GUARDED_BY(graph_capture_mutex_)
+
   InsertCastTransformer insert_cast_transformer_;
 
   //CustomRegistry objects own the corresponding KernelRegistry and OnnxRuntimeOpSchemaRegistry objects.
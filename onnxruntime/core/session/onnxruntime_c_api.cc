@@ -7,6 +7,7 @@
 #include "core/framework/execution_provider.h"
 #include <cassert>
 #include <cstring>
+#include <limits>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
@@ -14,6 +15,7 @@
 #include "core/common/status.h"
 #include "core/graph/graph.h"
 #include "core/framework/allocator.h"
+#include "core/framework/allocatormgr.h"
 #include "core/framework/tensor.h"
 #include "core/framework/ml_value.h"
 #include "core/session/environment.h"
@@ -21,7 +23,10 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "core/framework/data_types.h"
+#include "core/framework/node_counters.h"
 #include "abi_session_options_impl.h"
 
 using namespace onnxruntime::logging;
@@ -131,6 +136,80 @@ ORT_API_STATUS_IMPL(OrtCreateEnv, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtCreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level, _In_ const char* logid,
+                    int intra_op_thread_pool_size, int inter_op_thread_pool_size, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  auto default_logging_manager = std::make_unique<LoggingManager>(std::unique_ptr<ISink>{new CLogSink{}},
+                                                                  static_cast<Severity>(default_warning_level), false,
+                                                                  LoggingManager::InstanceType::Default,
+                                                                  &name);
+  GlobalThreadPoolOptions thread_pool_options;
+  thread_pool_options.intra_op_thread_pool_size = intra_op_thread_pool_size;
+  thread_pool_options.inter_op_thread_pool_size = inter_op_thread_pool_size;
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env, thread_pool_options);
+  if (status.IsOK()) {
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+    return nullptr;
+  }
+  *out = nullptr;
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreateEnvWithCustomLoggerAndGlobalThreadPools, OrtLoggingFunction logging_function,
+                    _In_opt_ void* logger_param, OrtLoggingLevel default_warning_level, _In_ const char* logid,
+                    int intra_op_thread_pool_size, int inter_op_thread_pool_size, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  std::unique_ptr<ISink> logger = std::make_unique<LoggingWrapper>(logging_function, logger_param);
+  auto default_logging_manager = std::make_unique<LoggingManager>(std::move(logger),
+                                                                  static_cast<Severity>(default_warning_level), false,
+                                                                  LoggingManager::InstanceType::Default,
+                                                                  &name);
+  GlobalThreadPoolOptions thread_pool_options;
+  thread_pool_options.intra_op_thread_pool_size = intra_op_thread_pool_size;
+  thread_pool_options.inter_op_thread_pool_size = inter_op_thread_pool_size;
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env, thread_pool_options);
+  if (status.IsOK()) {
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+    return nullptr;
+  }
+  *out = nullptr;
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRegisterAllocator, _Inout_ OrtEnv* env, _In_ OrtAllocator* allocator, int use_arena) {
+  API_IMPL_BEGIN
+  if (allocator == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "allocator is null");
+  }
+  AllocatorPtr allocator_ptr;
+  if (use_arena != 0) {
+    DeviceAllocatorRegistrationInfo info{OrtMemTypeDefault,
+                                         [allocator](int) { return std::make_unique<AllocatorWrapper>(allocator); },
+                                         std::numeric_limits<size_t>::max()};
+    allocator_ptr = CreateAllocator(info);
+  } else {
+    allocator_ptr = std::make_shared<AllocatorWrapper>(allocator);
+  }
+  return ToOrtStatus(env->value->RegisterAllocator(std::move(allocator_ptr)));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtEnableAsyncLogging, _Inout_ OrtEnv* env, size_t max_queued_messages) {
+  API_IMPL_BEGIN
+  if (max_queued_messages == 0) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "max_queued_messages must be positive");
+  }
+  env->loggingManager->EnableAsyncSink(max_queued_messages);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ size_t* out) {
   TENSOR_READ_API_BEGIN
   const auto* src = tensor.Data<std::string>();
@@ -368,7 +447,7 @@ template <typename Loader>
 OrtStatus* CreateSessionImpl(_In_ const OrtEnv* env, _In_ const OrtSessionOptions* options,
                              Loader loader, _Outptr_ OrtSession** out) {
   auto sess = std::make_unique<::onnxruntime::InferenceSession>(
-      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager);
+      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager, env->value);
   Status status;
   if (options != nullptr) {
     if (!options->custom_op_domains_.empty()) {
@@ -477,6 +556,341 @@ ORT_API_STATUS_IMPL(OrtRun, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtCreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtIoBinding*>(binding.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingBindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* value) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  auto status = binding->BindInput(name, *value);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingBindOutput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* value) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  auto status = binding->BindOutput(name, *value);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingBindOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* info) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  auto status = binding->BindOutput(name, *info);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingSynchronizeInputs, _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  return ToOrtStatus(binding->SynchronizeInputs());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingSynchronizeOutputs, _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  return ToOrtStatus(binding->SynchronizeOutputs());
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingClearInputs, _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr)->ClearInputs();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingClearOutputs, _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr)->ClearOutputs();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingGetOutputCount, _In_ const OrtIoBinding* binding_ptr, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding_ptr);
+  *out = binding->GetOutputNames().size();
+  return nullptr;
+  API_IMPL_END
+}
+
+static char* StrDup(const std::string& str, OrtAllocator* allocator) {
+  char* output_string = reinterpret_cast<char*>(allocator->Alloc(allocator, str.size() + 1));
+  memcpy(output_string, str.c_str(), str.size());
+  output_string[str.size()] = '\0';
+  return output_string;
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingGetOutputName, _In_ const OrtIoBinding* binding_ptr, size_t index,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** name) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding_ptr);
+  const auto& output_names = binding->GetOutputNames();
+  if (index >= output_names.size())
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "index out of range");
+  *name = StrDup(output_names[index], allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtIoBindingGetOutputValue, _In_ const OrtIoBinding* binding_ptr, size_t index,
+                    _Outptr_ OrtValue** value) {
+  API_IMPL_BEGIN
+  // GetOutputs is not const as the outputs are written by the run.
+  auto binding = const_cast<::onnxruntime::IOBinding*>(reinterpret_cast<const ::onnxruntime::IOBinding*>(binding_ptr));
+  const auto& outputs = binding->GetOutputs();
+  if (index >= outputs.size())
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "index out of range");
+  *value = new OrtValue(outputs[index]);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, *binding);
+  } else {
+    status = session->Run(*run_options, *binding);
+  }
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtCreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, &prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run_ptr, _In_ const OrtValue* const* input,
+                    _Inout_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& prepared_run = *reinterpret_cast<::onnxruntime::PreparedRun*>(prepared_run_ptr);
+  const int queue_id = 0;
+
+  auto& feeds = prepared_run.GetMutableFeeds();
+  for (size_t i = 0, end = feeds.size(); i != end; ++i) {
+    auto& ort_value = feeds[i] = *input[i];
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  auto& fetches = prepared_run.GetMutableFetches();
+  for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    } else {
+      fetches[i] = OrtValue();
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared_run);
+  } else {
+    status = session->Run(*run_options, prepared_run);
+  }
+
+  if (status.IsOK()) {
+    for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+      ::OrtValue& value = fetches[i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+      if (output[i] == nullptr) {
+        output[i] = new OrtValue(value);
+      }
+    }
+  }
+
+  // don't hold on to the inputs and outputs between runs
+  for (auto& feed : feeds) {
+    feed = OrtValue();
+  }
+  for (auto& fetch : fetches) {
+    fetch = OrtValue();
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _In_ OrtRunAsyncCallback callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  if (callback == nullptr) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    feed_names[i] = input_names[i];
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  // the run options have to outlive the run, so use a default instance that does
+  static const OrtRunOptions default_run_options;
+  const OrtRunOptions& options = run_options == nullptr ? default_run_options : *run_options;
+
+  auto status = session->RunAsync(
+      options, feed_names, feeds, output_names, {},
+      [callback, user_data](const Status& run_status, std::vector<OrtValue>& fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, nullptr, 0, ToOrtStatus(run_status));
+          return;
+        }
+
+        std::vector<OrtValue*> outputs(fetches.size());
+        for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+          ::OrtValue& value = fetches[i];
+          if (value.Fence())
+            value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+          outputs[i] = new OrtValue(value);
+        }
+        callback(user_data, outputs.data(), outputs.size(), nullptr);
+      });
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunMany, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    size_t run_count, _In_ const char* const* output_names1, size_t output_names_len,
+                    _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::vector<OrtValue>> feeds(run_count, std::vector<OrtValue>(input_len));
+  for (size_t r = 0; r != run_count; ++r) {
+    for (size_t i = 0; i != input_len; ++i) {
+      auto& ort_value = feeds[r][i] = *reinterpret_cast<const ::OrtValue*>(input[r * input_len + i]);
+      if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    }
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::vector<std::vector<OrtValue>> fetches;
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->RunMany(op, feed_names, feeds, output_names, &fetches);
+  } else {
+    status = session->RunMany(*run_options, feed_names, feeds, output_names, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t r = 0; r != run_count; ++r) {
+    for (size_t i = 0; i != output_names_len; ++i) {
+      ::OrtValue& value = fetches[r][i];
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+      output[r * output_names_len + i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _Inout_ OrtValue* value, _Outptr_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -504,7 +918,7 @@ ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
   }
   size_t f = 0;
   char* p = static_cast<char*>(s);
-  for (size_t i = 0; i != offsets_len; ++i, ++offsets) {
+  for (size_t i = 0; i != len; ++i, ++offsets) {
     memcpy(p, input[i].data(), input[i].size());
     p += input[i].size();
     *offsets = f;
@@ -514,6 +928,42 @@ ORT_API_STATUS_IMPL(OrtGetStringTensorContent, _In_ const OrtValue* value,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtFillStringTensorFromBuffer, _Inout_ OrtValue* value, _In_ const void* s, size_t s_len,
+                    _In_ const size_t* offsets, size_t offsets_len) {
+  TENSOR_READWRITE_API_BEGIN
+  auto* dst = tensor->MutableData<std::string>();
+  auto len = static_cast<size_t>(tensor->Shape().Size());
+  if (offsets_len < len) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "offsets array is too short");
+  }
+  const char* p = static_cast<const char*>(s);
+  for (size_t i = 0; i != len; ++i) {
+    const size_t end = i + 1 < len ? offsets[i + 1] : s_len;
+    if (offsets[i] > end || end > s_len) {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "offsets are not increasing or exceed the data length");
+    }
+    dst[i].assign(p + offsets[i], end - offsets[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtGetStringTensorViews, _In_ const OrtValue* value, _Out_ const char** data,
+                    _Out_ size_t* lengths, size_t len) {
+  TENSOR_READ_API_BEGIN
+  const auto* input = tensor.Data<std::string>();
+  auto count = static_cast<size_t>(tensor.Shape().Size());
+  if (len < count) {
+    return OrtCreateStatus(ORT_FAIL, "space is not enough");
+  }
+  for (size_t i = 0; i != count; ++i) {
+    data[i] = input[i].c_str();
+    lengths[i] = input[i].size();
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 #define ORT_C_API_RETURN_IF_ERROR(expr)                 \
   do {                                                  \
     auto _status = (expr);                              \
@@ -547,6 +997,129 @@ ORT_API_STATUS_IMPL(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto status = session->ShrinkMemoryArenas();
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetMemoryArenaBytesInUse, _In_ const OrtSession* sess, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  auto status = session->GetMemoryArenaBytesInUse(*out);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetMemoryArenaStats, _In_ const OrtSession* sess, _In_opt_ const char* allocator_name,
+                    _Out_ size_t* bytes_reserved, _Out_ size_t* bytes_in_use) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  auto status = session->GetMemoryArenaStats(allocator_name, *bytes_reserved, *bytes_in_use);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetInitializationTimes, _In_ const OrtSession* sess,
+                    _Out_ OrtSessionInitializationTimes* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto& times = session->GetInitializationTimes();
+  out->load_us = times.load_us;
+  out->initialize_us = times.initialize_us;
+  out->graph_transformation_us = times.graph_transformation_us;
+  out->graph_partitioning_us = times.graph_partitioning_us;
+  out->initializer_loading_us = times.initializer_loading_us;
+  out->kernel_creation_us = times.kernel_creation_us;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetNodeCounterCount, _In_ const OrtSession* sess, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto* node_counters = session->GetNodeCounters();
+  *out = node_counters == nullptr ? 0 : node_counters->Nodes().size();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetNodeCounterName, _In_ const OrtSession* sess, size_t index,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** value) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto* node_counters = session->GetNodeCounters();
+  if (node_counters == nullptr || index >= node_counters->NodeNames().size()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "node counter index is out of range");
+  }
+  *value = StrDup(node_counters->NodeNames()[index], allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetNodeCounters, _In_ const OrtSession* sess,
+                    _Out_ OrtNodeCounters* counters, size_t count) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto* node_counters = session->GetNodeCounters();
+  if (node_counters == nullptr || count > node_counters->Nodes().size()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "count is larger than the number of node counters");
+  }
+  for (size_t i = 0; i != count; ++i) {
+    auto values = node_counters->Get(node_counters->Nodes()[i]);
+    counters[i].count = values.count;
+    counters[i].total_ns = values.total_ns;
+    counters[i].max_ns = values.max_ns;
+    counters[i].bytes_allocated = values.bytes_allocated;
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionResetNodeCounters, _Inout_ OrtSession* sess) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto* node_counters = session->GetNodeCounters();
+  if (node_counters != nullptr) {
+    node_counters->Reset();
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionDumpRunTraces, _Inout_ OrtSession* sess, int clear, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->DumpRunTraces(clear != 0), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionWarmup, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, _In_ const int64_t* const* input_shapes,
+                    _In_ const size_t* input_shape_lens, size_t input_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::NameShapeMap input_shape_set;
+  for (size_t i = 0; i != input_len; ++i) {
+    input_shape_set[input_names[i]].assign(input_shapes[i], input_shapes[i] + input_shape_lens[i]);
+  }
+  auto status = session->Warmup({input_shape_set});
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtSessionGetInputTypeInfo, _In_ const OrtSession* sess, size_t index, _Outptr_ struct OrtTypeInfo** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -572,13 +1145,6 @@ ORT_API_STATUS_IMPL(OrtSessionGetOutputTypeInfo, _In_ const OrtSession* sess, si
   API_IMPL_END
 }
 
-static char* StrDup(const std::string& str, OrtAllocator* allocator) {
-  char* output_string = reinterpret_cast<char*>(allocator->Alloc(allocator, str.size() + 1));
-  memcpy(output_string, str.c_str(), str.size());
-  output_string[str.size()] = '\0';
-  return output_string;
-}
-
 static OrtStatus* GetInputOutputNameImpl(_In_ const OrtSession* sess, size_t index,
                                          _Inout_ OrtAllocator* allocator, bool is_input,
                                          _Outptr_ char** output) {
@@ -1078,3 +1644,5 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(IoBinding, ::onnxruntime::IOBinding)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
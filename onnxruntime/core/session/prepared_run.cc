@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/prepared_run.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+PreparedRun::PreparedRun(const InferenceSession& session,
+                         std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager,
+                         std::vector<const InferenceSession::InputDefMetaData*>&& feed_defs)
+    : session_(session),
+      feeds_fetches_manager_(std::move(feeds_fetches_manager)),
+      feed_defs_(std::move(feed_defs)),
+      copy_info_is_dynamic_(feeds_fetches_manager_->GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+  const auto& info = feeds_fetches_manager_->GetFeedsFetchesInfo();
+  feed_devices_.resize(info.feed_names.size());
+  fetch_devices_.resize(info.output_names.size());
+  feeds_.resize(info.feed_names.size());
+  fetches_.resize(info.output_names.size());
+}
+
+const std::vector<std::string>& PreparedRun::GetFeedNames() const {
+  return feeds_fetches_manager_->GetFeedsFetchesInfo().feed_names;
+}
+
+const std::vector<std::string>& PreparedRun::GetOutputNames() const {
+  return feeds_fetches_manager_->GetFeedsFetchesInfo().output_names;
+}
+
+static OrtDevice GetFeedDevice(const OrtValue& feed) {
+  return feed.IsTensor() ? feed.Get<Tensor>().Location().device : OrtDevice();
+}
+
+// an output that isn't pre-allocated is returned on CPU
+static OrtDevice GetFetchDevice(const OrtValue& fetch) {
+  return fetch.IsAllocated() && fetch.IsTensor() ? fetch.Get<Tensor>().Location().device : OrtDevice();
+}
+
+common::Status PreparedRun::FinalizeCopyInfo(const SessionState& session_state) {
+  // with only CPU providers InitializeFeedFetchCopyInfo has already determined that nothing is copied
+  if (!copy_info_is_dynamic_) {
+    return Status::OK();
+  }
+
+  if (copy_info_finalized_) {
+    bool devices_changed = false;
+    for (size_t i = 0, end = feeds_.size(); i < end && !devices_changed; ++i) {
+      devices_changed = GetFeedDevice(feeds_[i]) != feed_devices_[i];
+    }
+    for (size_t i = 0, end = fetches_.size(); i < end && !devices_changed; ++i) {
+      devices_changed = GetFetchDevice(fetches_[i]) != fetch_devices_[i];
+    }
+    if (!devices_changed) {
+      return Status::OK();
+    }
+
+    // a finalized FeedsFetchesManager can't be finalized again, so start over from its names and indexes
+    FeedsFetchesInfo info = feeds_fetches_manager_->GetFeedsFetchesInfo();
+    feeds_fetches_manager_ = std::make_unique<FeedsFetchesManager>(std::move(info));
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, *feeds_fetches_manager_));
+  }
+
+  std::vector<const OrtMemoryInfo*> fetch_alloc_info(fetches_.size(), nullptr);
+  for (size_t i = 0, end = feeds_.size(); i < end; ++i) {
+    feed_devices_[i] = GetFeedDevice(feeds_[i]);
+  }
+  for (size_t i = 0, end = fetches_.size(); i < end; ++i) {
+    fetch_devices_[i] = GetFetchDevice(fetches_[i]);
+    if (fetches_[i].IsAllocated() && fetches_[i].IsTensor()) {
+      fetch_alloc_info[i] = &fetches_[i].Get<Tensor>().Location();
+    }
+  }
+
+  utils::FinalizeFeedFetchCopyInfo(session_state, *feeds_fetches_manager_, feed_devices_, fetch_alloc_info);
+  copy_info_finalized_ = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
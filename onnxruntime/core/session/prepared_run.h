@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/ml_value.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+class SessionState;
+
+/**
+ * A run of a session for a fixed list of input and output names, prepared once so that repeated runs don't
+ * resolve the names, validate them or set up the FeedsFetchesManager again.
+ * Usage is as follows:
+ *
+ * std::unique_ptr<PreparedRun> prepared_run;
+ * session.PrepareRun(input_names, output_names, &prepared_run);
+ * ...
+ * prepared_run->GetMutableFeeds()[0] = input;  // one value per input name
+ * session.Run(run_options, *prepared_run);
+ * OrtValue& output = prepared_run->GetMutableFetches()[0];
+ *
+ * The feeds and fetches are owned by the prepared run and are reused by every run, so it must not be run
+ * by more than one thread at a time. Create one prepared run per thread instead.
+ */
+class PreparedRun {
+ public:
+  const std::vector<std::string>& GetFeedNames() const;
+  const std::vector<std::string>& GetOutputNames() const;
+
+  /**
+    * The inputs of the next run, in the order of the input names.
+    */
+  std::vector<OrtValue>& GetMutableFeeds() { return feeds_; }
+
+  /**
+    * The outputs of the last run, in the order of the output names. An output that is allocated before a run
+    * is written into instead of being allocated by the run.
+    */
+  std::vector<OrtValue>& GetMutableFetches() { return fetches_; }
+
+ private:
+  friend InferenceSession;
+
+  PreparedRun(const InferenceSession& session, std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager,
+              std::vector<const InferenceSession::InputDefMetaData*>&& feed_defs);
+
+  // Finalizes the copy info of the FeedsFetchesManager for the devices of the current feeds and fetches.
+  // This is only done again when the devices differ from those of the previous run.
+  common::Status FinalizeCopyInfo(const SessionState& session_state);
+
+  const InferenceSession& session_;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  std::vector<const InferenceSession::InputDefMetaData*> feed_defs_;
+
+  // true if the copy info depends on the devices of the feeds and fetches, i.e. there are non-CPU providers
+  bool copy_info_is_dynamic_;
+  bool copy_info_finalized_ = false;
+  std::vector<OrtDevice> feed_devices_;
+  std::vector<OrtDevice> fetch_devices_;
+
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+};
+}  // namespace onnxruntime
@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "onnxruntime_pybind_dlpack.h"
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace python {
+
+namespace {
+
+// The structures of the DLPack ABI (https://github.com/dmlc/dlpack), version 0.x, which the Python frameworks
+// exchange in "dltensor" capsules.
+enum DLDeviceType {
+  kDLCPU = 1,
+  kDLGPU = 2,
+  kDLCPUPinned = 3,
+};
+
+struct DLContext {
+  DLDeviceType device_type;
+  int device_id;
+};
+
+enum DLDataTypeCode {
+  kDLInt = 0U,
+  kDLUInt = 1U,
+  kDLFloat = 2U,
+  kDLBfloat = 4U,
+  kDLBool = 6U,
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void* data;
+  DLContext ctx;
+  int ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+const char* const kDltensorName = "dltensor";
+const char* const kUsedDltensorName = "used_dltensor";
+
+MLDataType DlpackToOnnxRuntimeType(DLDataType dtype) {
+  if (dtype.lanes == 1) {
+    switch (dtype.code) {
+      case kDLFloat:
+        if (dtype.bits == 16) return DataTypeImpl::GetType<MLFloat16>();
+        if (dtype.bits == 32) return DataTypeImpl::GetType<float>();
+        if (dtype.bits == 64) return DataTypeImpl::GetType<double>();
+        break;
+      case kDLBfloat:
+        if (dtype.bits == 16) return DataTypeImpl::GetType<BFloat16>();
+        break;
+      case kDLInt:
+        if (dtype.bits == 8) return DataTypeImpl::GetType<int8_t>();
+        if (dtype.bits == 16) return DataTypeImpl::GetType<int16_t>();
+        if (dtype.bits == 32) return DataTypeImpl::GetType<int32_t>();
+        if (dtype.bits == 64) return DataTypeImpl::GetType<int64_t>();
+        break;
+      case kDLUInt:
+        if (dtype.bits == 8) return DataTypeImpl::GetType<uint8_t>();
+        if (dtype.bits == 16) return DataTypeImpl::GetType<uint16_t>();
+        if (dtype.bits == 32) return DataTypeImpl::GetType<uint32_t>();
+        if (dtype.bits == 64) return DataTypeImpl::GetType<uint64_t>();
+        break;
+      case kDLBool:
+        if (dtype.bits == 8) return DataTypeImpl::GetType<bool>();
+        break;
+    }
+  }
+  throw std::runtime_error("Unsupported DLPack data type (code " + std::to_string(dtype.code) + ", bits " +
+                           std::to_string(dtype.bits) + ", lanes " + std::to_string(dtype.lanes) + ")");
+}
+
+DLDataType OnnxRuntimeToDlpackType(MLDataType type) {
+  DLDataType dtype;
+  dtype.lanes = 1;
+  dtype.bits = static_cast<uint8_t>(type->Size() * 8);
+  if (type == DataTypeImpl::GetType<MLFloat16>() || type == DataTypeImpl::GetType<float>() ||
+      type == DataTypeImpl::GetType<double>()) {
+    dtype.code = kDLFloat;
+  } else if (type == DataTypeImpl::GetType<BFloat16>()) {
+    dtype.code = kDLBfloat;
+  } else if (type == DataTypeImpl::GetType<int8_t>() || type == DataTypeImpl::GetType<int16_t>() ||
+             type == DataTypeImpl::GetType<int32_t>() || type == DataTypeImpl::GetType<int64_t>()) {
+    dtype.code = kDLInt;
+  } else if (type == DataTypeImpl::GetType<uint8_t>() || type == DataTypeImpl::GetType<uint16_t>() ||
+             type == DataTypeImpl::GetType<uint32_t>() || type == DataTypeImpl::GetType<uint64_t>()) {
+    dtype.code = kDLUInt;
+  } else if (type == DataTypeImpl::GetType<bool>()) {
+    dtype.code = kDLBool;
+  } else {
+    throw std::runtime_error(std::string("Tensors of ") + DataTypeImpl::ToString(type) +
+                             " can't be exchanged with DLPack or the CUDA array interface");
+  }
+  return dtype;
+}
+
+// The typestr of the array interfaces, e.g. "<f4". The supported devices are all little-endian.
+std::string TypeStr(DLDataType dtype) {
+  if (dtype.code == kDLBfloat) {
+    throw std::runtime_error("bfloat16 has no typestr in the CUDA array interface");
+  }
+  const char kind = dtype.code == kDLFloat ? 'f' : dtype.code == kDLInt ? 'i' : dtype.code == kDLUInt ? 'u' : 'b';
+  return std::string(dtype.bits == 8 ? "|" : "<") + kind + std::to_string(dtype.bits / 8);
+}
+
+DLDataType FromTypeStr(const std::string& typestr) {
+  if (typestr.size() < 3 || (typestr[0] != '<' && typestr[0] != '|' && typestr[0] != '=')) {
+    throw std::runtime_error("Unsupported typestr '" + typestr + "' in the CUDA array interface");
+  }
+  DLDataType dtype;
+  dtype.lanes = 1;
+  dtype.bits = static_cast<uint8_t>(std::stoi(typestr.substr(2)) * 8);
+  switch (typestr[1]) {
+    case 'f':
+      dtype.code = kDLFloat;
+      break;
+    case 'i':
+      dtype.code = kDLInt;
+      break;
+    case 'u':
+      dtype.code = kDLUInt;
+      break;
+    case 'b':
+      dtype.code = kDLBool;
+      break;
+    default:
+      throw std::runtime_error("Unsupported typestr '" + typestr + "' in the CUDA array interface");
+  }
+  return dtype;
+}
+
+// Tensors are dense, so strides (in elements or bytes, per element_size) must be those of a C-contiguous layout.
+void CheckContiguous(const std::vector<int64_t>& dims, const int64_t* strides, int64_t element_size) {
+  if (strides == nullptr) {
+    return;
+  }
+  int64_t expected = element_size;
+  for (size_t i = dims.size(); i-- > 0;) {
+    if (dims[i] != 1 && strides[i] != expected) {
+      throw std::runtime_error("Only C-contiguous tensors can be exchanged without a copy");
+    }
+    expected *= dims[i];
+  }
+}
+
+OrtValue OrtValueOverBuffer(MLDataType element_type, const std::vector<int64_t>& dims, void* data,
+                            const OrtMemoryInfo& info, const std::function<void()>& release) {
+  auto p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), data, info);
+  OrtValue ml_value;
+  ml_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), [release](void* p) {
+    delete static_cast<Tensor*>(p);
+    release();
+  });
+  return ml_value;
+}
+
+// The DLManagedTensor of an OrtValue, which keeps a copy of the OrtValue for the consumer.
+struct OrtValueDlpackContext {
+  OrtValue ml_value;
+  std::vector<int64_t> shape;
+  DLManagedTensor tensor;
+};
+
+}  // namespace
+
+OrtValue OrtValueFromDlpack(py::object dlpack) {
+  PyObject* capsule = dlpack.ptr();
+  if (!PyCapsule_IsValid(capsule, kDltensorName)) {
+    throw std::runtime_error("Expected a DLPack capsule that wasn't consumed yet");
+  }
+
+  auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, kDltensorName));
+  const DLTensor& dl_tensor = managed->dl_tensor;
+
+  OrtMemoryInfo info = GetMemoryInfoForDevice("cpu", 0);
+  if (dl_tensor.ctx.device_type == kDLGPU) {
+    info = GetMemoryInfoForDevice("cuda", dl_tensor.ctx.device_id);
+  } else if (dl_tensor.ctx.device_type != kDLCPU && dl_tensor.ctx.device_type != kDLCPUPinned) {
+    throw std::runtime_error("Unsupported DLPack device type " + std::to_string(dl_tensor.ctx.device_type));
+  }
+
+  MLDataType element_type = DlpackToOnnxRuntimeType(dl_tensor.dtype);
+  std::vector<int64_t> dims(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  CheckContiguous(dims, dl_tensor.strides, 1);
+
+  void* data = static_cast<char*>(dl_tensor.data) + dl_tensor.byte_offset;
+  OrtValue ml_value = OrtValueOverBuffer(element_type, dims, data, info, [managed]() {
+    if (managed->deleter != nullptr) {
+      managed->deleter(managed);
+    }
+  });
+
+  // the OrtValue owns the tensor now, so the capsule must not call the deleter
+  PyCapsule_SetName(capsule, kUsedDltensorName);
+  return ml_value;
+}
+
+py::object OrtValueToDlpack(const OrtValue& ml_value) {
+  const Tensor& tensor = ml_value.Get<Tensor>();
+  if (!tensor.IsContiguous()) {
+    throw std::runtime_error("Only C-contiguous tensors can be exchanged without a copy");
+  }
+
+  auto context = std::make_unique<OrtValueDlpackContext>();
+  context->ml_value = ml_value;
+  context->shape = tensor.Shape().GetDims();
+
+  DLTensor& dl_tensor = context->tensor.dl_tensor;
+  dl_tensor.data = const_cast<void*>(tensor.DataRaw());
+  const OrtDevice& device = tensor.Location().device;
+  dl_tensor.ctx.device_type = device.Type() == OrtDevice::GPU ? kDLGPU : kDLCPU;
+  dl_tensor.ctx.device_id = device.Id();
+  dl_tensor.ndim = static_cast<int>(context->shape.size());
+  dl_tensor.dtype = OnnxRuntimeToDlpackType(tensor.DataType());
+  dl_tensor.shape = context->shape.data();
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+
+  context->tensor.manager_ctx = context.get();
+  context->tensor.deleter = [](DLManagedTensor* self) {
+    delete static_cast<OrtValueDlpackContext*>(self->manager_ctx);
+  };
+
+  PyObject* capsule = PyCapsule_New(&context->tensor, kDltensorName, [](PyObject* self) {
+    // a consumer renames the capsule, so only a capsule that was never consumed still owns the tensor
+    if (PyCapsule_IsValid(self, kDltensorName)) {
+      auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(self, kDltensorName));
+      managed->deleter(managed);
+    }
+  });
+  if (capsule == nullptr) {
+    throw py::error_already_set();
+  }
+  context.release();
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+OrtValue OrtValueFromCudaArrayInterface(py::object obj, int device_id) {
+  py::dict interface = obj.attr("__cuda_array_interface__");
+
+  const auto dims = interface["shape"].cast<std::vector<int64_t>>();
+  MLDataType element_type = DlpackToOnnxRuntimeType(FromTypeStr(interface["typestr"].cast<std::string>()));
+  py::object interface_strides = interface.attr("get")("strides");
+  if (!interface_strides.is_none()) {
+    const auto strides = interface_strides.cast<std::vector<int64_t>>();
+    CheckContiguous(dims, strides.data(), static_cast<int64_t>(element_type->Size()));
+  }
+  void* data = reinterpret_cast<void*>(interface["data"].cast<py::tuple>()[0].cast<uintptr_t>());
+
+  // The OrtValue keeps obj alive. The last copy of the OrtValue may go away on another thread.
+  PyObject* owner = obj.ptr();
+  Py_INCREF(owner);
+  return OrtValueOverBuffer(element_type, dims, data, GetMemoryInfoForDevice("cuda", device_id), [owner]() {
+    py::gil_scoped_acquire acquire;
+    Py_DECREF(owner);
+  });
+}
+
+py::dict CudaArrayInterface(const OrtValue& ml_value) {
+  const Tensor& tensor = ml_value.Get<Tensor>();
+  if (tensor.Location().device.Type() != OrtDevice::GPU) {
+    // an AttributeError, so that hasattr() tells the consumers there is no interface
+    PyErr_SetString(PyExc_AttributeError, "__cuda_array_interface__ is only defined for tensors in CUDA memory");
+    throw py::error_already_set();
+  }
+  if (!tensor.IsContiguous()) {
+    throw std::runtime_error("Only C-contiguous tensors can be exchanged without a copy");
+  }
+
+  py::dict interface;
+  interface["shape"] = py::tuple(py::cast(tensor.Shape().GetDims()));
+  interface["typestr"] = TypeStr(OnnxRuntimeToDlpackType(tensor.DataType()));
+  interface["data"] = py::make_tuple(reinterpret_cast<uintptr_t>(tensor.DataRaw()), false);
+  interface["strides"] = py::none();
+  interface["version"] = 2;
+  return interface;
+}
+
+py::tuple DlpackDevice(const OrtValue& ml_value) {
+  const OrtDevice& device = ml_value.Get<Tensor>().Location().device;
+  return py::make_tuple(static_cast<int>(device.Type() == OrtDevice::GPU ? kDLGPU : kDLCPU),
+                        static_cast<int>(device.Id()));
+}
+
+}  // namespace python
+}  // namespace onnxruntime
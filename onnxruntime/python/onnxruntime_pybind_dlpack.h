@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "onnxruntime_pybind_mlvalue.h"
+
+namespace onnxruntime {
+namespace python {
+
+// Wraps the tensor of a DLPack capsule ("dltensor") in an OrtValue without copying it. The capsule is consumed, and
+// the OrtValue calls the DLPack deleter of the tensor once its last copy is released.
+OrtValue OrtValueFromDlpack(py::object dlpack);
+
+// Returns a DLPack capsule over the tensor of the OrtValue, which keeps a copy of the OrtValue until the consumer
+// calls the deleter (or until the capsule is released without being consumed).
+py::object OrtValueToDlpack(const OrtValue& ml_value);
+
+// Wraps the CUDA memory described by the __cuda_array_interface__ of obj (e.g. a CuPy array or a Numba device array)
+// in an OrtValue without copying it. The OrtValue keeps a reference to obj.
+OrtValue OrtValueFromCudaArrayInterface(py::object obj, int device_id);
+
+// Returns the __cuda_array_interface__ of an OrtValue holding a tensor in CUDA memory.
+py::dict CudaArrayInterface(const OrtValue& ml_value);
+
+// The DLPack (device_type, device_id) of the tensor of the OrtValue.
+py::tuple DlpackDevice(const OrtValue& ml_value);
+
+}  // namespace python
+}  // namespace onnxruntime
@@ -95,8 +95,43 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+// Numeric arrays whose buffer is laid out as a tensor of their type: C-contiguous, aligned and in native byte order.
+static bool IsTensorCompatibleArray(PyArrayObject* darray) {
+  const int npy_type = PyArray_TYPE(darray);
+  return npy_type != NPY_UNICODE && npy_type != NPY_STRING && npy_type != NPY_VOID && npy_type != NPY_OBJECT &&
+         PyArray_ISCARRAY_RO(darray) && PyArray_ISNOTSWAPPED(darray);
+}
+
+// Wraps the buffer of the array in a tensor without copying it, like OrtCreateTensorWithDataAsOrtValue. The OrtValue
+// holds a reference to the array, released with the GIL as the last copy of the OrtValue may go away on another thread.
+static void CreateTensorMLValueOverArray(const OrtMemoryInfo& info, PyArrayObject* darray, OrtValue* p_mlvalue) {
+  int ndim = PyArray_NDIM(darray);
+  npy_intp* npy_dims = PyArray_DIMS(darray);
+  std::vector<int64_t> dims(ndim);
+  for (int i = 0; i < ndim; ++i) {
+    dims[i] = npy_dims[i];
+  }
+
+  auto element_type = NumpyToOnnxRuntimeTensorType(PyArray_TYPE(darray));
+  auto p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), PyArray_DATA(darray), info);
+
+  Py_INCREF(darray);
+  p_mlvalue->Init(p_tensor.release(),
+                  DataTypeImpl::GetType<Tensor>(),
+                  [darray](void* p) {
+                    delete static_cast<Tensor*>(p);
+                    py::gil_scoped_acquire acquire;
+                    Py_DECREF(darray);
+                  });
+}
+
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject,
-                         OrtValue* p_mlvalue) {
+                         OrtValue* p_mlvalue, bool use_array_buffer) {
+  if (use_array_buffer && alloc->Info().device.Type() == OrtDevice::CPU && IsTensorCompatibleArray(pyObject)) {
+    CreateTensorMLValueOverArray(alloc->Info(), pyObject, p_mlvalue);
+    return;
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -399,11 +434,12 @@ void CreateGenericIterableMLValue(PyObject* iterator, AllocatorPtr alloc, const
   }
 }
 
-void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue) {
+void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue,
+                          bool use_array_buffer) {
   if (PyObjectCheck_Array(value.ptr())) {
     // The most frequent case: input comes as an array.
     PyArrayObject* arr = reinterpret_cast<PyArrayObject*>(value.ptr());
-    CreateTensorMLValue(alloc, name_input, arr, p_mlvalue);
+    CreateTensorMLValue(alloc, name_input, arr, p_mlvalue, use_array_buffer);
   } else if (PyDict_Check(value.ptr())) {
     CreateMapMLValue_AgnosticVectorMap((PyObject*)NULL, value.ptr(), alloc, name_input, p_mlvalue);
   } else {
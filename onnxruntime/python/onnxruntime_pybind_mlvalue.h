@@ -24,7 +24,14 @@ namespace py = pybind11;
 
 int OnnxRuntimeTensorToNumpyType(const DataTypeImpl* tensor_type);
 
-void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue);
+// The location of a tensor on a device named as in the Python API ("cpu" or "cuda").
+OrtMemoryInfo GetMemoryInfoForDevice(const std::string& device_type, int device_id);
+
+// Converts a Python object to an OrtValue, copying its data. With use_array_buffer, a numeric numpy array laid out as a
+// tensor is wrapped without copying instead, and the OrtValue keeps the array alive. The array must then not be
+// modified while the OrtValue is in use.
+void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue,
+                          bool use_array_buffer = false);
 
 }  // namespace python
 }  // namespace onnxruntime
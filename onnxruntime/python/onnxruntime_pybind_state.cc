@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "onnxruntime_pybind_mlvalue.h"
+#include "onnxruntime_pybind_dlpack.h"
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #define PY_ARRAY_UNIQUE_SYMBOL onnxruntime_python_ARRAY_API
@@ -64,6 +65,7 @@
 
 #define BACKEND_DEVICE BACKEND_PROC BACKEND_MKLDNN BACKEND_MKLML BACKEND_NGRAPH BACKEND_OPENVINO BACKEND_NUPHAR BACKEND_OPENBLAS
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/IOBinding.h"
 #include "core/providers/providers.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/cpu_provider_factory.h"
@@ -169,7 +171,9 @@ void AddNonTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
   }
 }
 
-void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
+// Adds the tensor as a numpy array. With share_buffer, a numeric tensor in CPU memory isn't copied: the array is
+// created over the tensor buffer and owns a copy of the OrtValue, which keeps the buffer alive.
+void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs, bool share_buffer = false) {
   const Tensor& rtensor = val.Get<Tensor>();
   std::vector<npy_intp> npy_dims;
   const TensorShape& shape = rtensor.Shape();
@@ -180,6 +184,23 @@ void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+
+  if (share_buffer && numpy_type != NPY_OBJECT && rtensor.IsContiguous() &&
+      rtensor.Location().device.Type() == OrtDevice::CPU) {
+    py::capsule owner(new OrtValue(val), [](void* p) { delete static_cast<OrtValue*>(p); });
+    py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+        shape.NumDimensions(), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw(dtype))));
+    if (!obj) {
+      throw py::error_already_set();
+    }
+    // PyArray_SetBaseObject steals the reference to the owner
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), owner.release().ptr()) != 0) {
+      throw py::error_already_set();
+    }
+    pyobjs.push_back(obj);
+    return;
+  }
+
   py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -199,6 +220,40 @@ void AddTensorAsPyObj(OrtValue& val, vector<py::object>& pyobjs) {
   pyobjs.push_back(obj);
 }
 
+// Holds the IOBinding of a session. The session is kept alive by the binding object on the Python side.
+struct SessionIOBinding {
+  std::unique_ptr<IOBinding> io_binding;
+};
+
+// Holds the Python objects used by a run enqueued by run_async. The run completes on a thread of the session,
+// so they are released with the GIL held.
+struct PyRunAsyncState {
+  py::function callback;
+  py::object run_options;  // keeps the RunOptions the run uses alive
+
+  ~PyRunAsyncState() {
+    py::gil_scoped_acquire acquire;
+    callback = py::function();
+    run_options = py::object();
+  }
+};
+
+OrtMemoryInfo GetMemoryInfoForDevice(const std::string& device_type, int device_id) {
+  if (device_type == "cpu") {
+    return OrtMemoryInfo(CPU, OrtDeviceAllocator);
+  }
+#ifdef USE_CUDA
+  if (device_type == "cuda") {
+    return OrtMemoryInfo(CUDA, OrtDeviceAllocator,
+                         OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(device_id)),
+                         device_id);
+  }
+#else
+  ORT_UNUSED_PARAMETER(device_id);
+#endif
+  throw std::runtime_error("Unsupported device type: " + device_type);
+}
+
 class SessionObjectInitializer {
  public:
   typedef const SessionOptions& Arg1;
@@ -472,18 +527,33 @@ void addObjectMethods(py::module& m) {
       .value("ORT_ENABLE_EXTENDED", GraphOptimizationLevel::ORT_ENABLE_EXTENDED)
       .value("ORT_ENABLE_ALL", GraphOptimizationLevel::ORT_ENABLE_ALL);
 
+  py::enum_<onnxruntime::ArenaExtendStrategy>(m, "ArenaExtendStrategy")
+      .value("kNextPowerOfTwo", onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo)
+      .value("kSameAsRequested", onnxruntime::ArenaExtendStrategy::kSameAsRequested);
+
   py::class_<SessionOptions> sess(m, "SessionOptions", R"pbdoc(Configuration information for a session.)pbdoc");
   sess
       .def(py::init())
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_cpu_mem_huge_pages", &SessionOptions::enable_cpu_mem_huge_pages,
+                     R"pbdoc(Backs the large CPU allocations, such as the arena regions and the initializers, with
+huge pages to reduce TLB misses. Default is False.)pbdoc")
+      .def_readwrite("cpu_mem_numa_node", &SessionOptions::cpu_mem_numa_node,
+                     R"pbdoc(The NUMA node to place the large CPU allocations on. Default is -1, which uses the
+NUMA node of the session thread pool, if it has one.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
+      .def_readwrite("mem_pattern_shape_bucket_size", &SessionOptions::mem_pattern_shape_bucket_size,
+                     R"pbdoc(Round input dims up to a multiple of this value to look up a memory pattern, so that
+inputs of similar size share one. Default is 1 (exact shapes).)pbdoc")
+      .def_readwrite("mem_pattern_cache_size", &SessionOptions::mem_pattern_cache_size,
+                     R"pbdoc(Maximum number of memory patterns to keep. Default is 0 (no limit).)pbdoc")
       .def_readwrite("enable_sequential_execution", &SessionOptions::enable_sequential_execution,
                      R"pbdoc(Enables sequential execution, disables parallel execution. Default is true.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
@@ -497,6 +567,102 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("thread_pool_size", &SessionOptions::session_thread_pool_size,
                      R"pbdoc(How many threads in the session thread pool. Default is 0 to let onnxruntime choose.
 This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("enable_critical_path_scheduling", &SessionOptions::enable_critical_path_scheduling,
+                     R"pbdoc(Dispatch ready nodes on the longest remaining path first. Default is false.
+This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("enable_parallel_initialization", &SessionOptions::enable_parallel_initialization,
+                     R"pbdoc(Deserialize initializers, create kernels and initialize subgraphs concurrently
+when the session is created. Default is false.)pbdoc")
+      .def_readwrite("enable_shape_cache", &SessionOptions::enable_shape_cache,
+                     R"pbdoc(Let kernels cache what they derive from their input shapes, such as their output shapes,
+and reuse it while the input shapes stay the same. Default is false.)pbdoc")
+      .def_readwrite("incremental_execution_inputs", &SessionOptions::incremental_execution_inputs,
+                     R"pbdoc(Names of graph inputs that often hold the same values in consecutive runs. The nodes that
+only depend on them and on the initializers are skipped in the runs where these inputs hold the same values as in the
+previous run, which reuse their outputs instead. Only applies to sequential execution. Default is empty.)pbdoc")
+      .def_readwrite("enable_zipmap_elimination", &SessionOptions::enable_zipmap_elimination,
+                     R"pbdoc(Return the probabilities of the ZipMap nodes that produce graph outputs as a float tensor
+with one row per sample, in the order of the class labels, instead of a list of dictionaries. The outputs keep their
+names. Default is false.)pbdoc")
+      .def_readwrite("weight_only_quantization_bits", &SessionOptions::weight_only_quantization_bits,
+                     R"pbdoc(Quantize the constant weights of float MatMul and Gemm nodes to this many bits (4 or 8)
+and compute them with a kernel that dequantizes the weights on the fly, while the activations stay in float. Speeds
+up decoders that run a few rows at a time, at some cost in accuracy. Default is 0, which disables it.)pbdoc")
+      .def_readwrite("weight_only_quantization_block_size", &SessionOptions::weight_only_quantization_block_size,
+                     R"pbdoc(Number of rows of the weights that share a scale when *weight_only_quantization_bits*
+is set. Must be a power of 2 and at least 16. Default is 32.)pbdoc")
+      .def_readwrite("enable_memory_efficient_execution_order",
+                     &SessionOptions::enable_memory_efficient_execution_order,
+                     R"pbdoc(Run the nodes in an order that lowers the peak memory use of the intermediate tensors
+instead of the topological order of the graph. Only applies to sequential execution. Default is false.)pbdoc")
+      .def_readwrite("warmup_input_shapes", &SessionOptions::warmup_input_shapes,
+                     R"pbdoc(A list of ``{ input_name: shape }`` dictionaries. The session runs once for each of them
+with zero-filled inputs when it's created. Inputs that aren't listed get the shape of the model input.)pbdoc")
+      .def_readwrite("inter_op_thread_pool_size", &SessionOptions::inter_op_thread_pool_size,
+                     R"pbdoc(How many threads the parallel executor uses to run nodes concurrently. Default is -1 to let
+onnxruntime choose. This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_property(
+          "arena_max_mem",
+          [](const SessionOptions* options) { return options->arena_config.max_mem; },
+          [](SessionOptions* options, size_t max_mem) { options->arena_config.max_mem = max_mem; },
+          R"pbdoc(Upper bound on the memory the CPU arena holds. Default is 0 (no limit).)pbdoc")
+      .def_property(
+          "arena_initial_chunk_size_bytes",
+          [](const SessionOptions* options) { return options->arena_config.initial_chunk_size_bytes; },
+          [](SessionOptions* options, size_t size) { options->arena_config.initial_chunk_size_bytes = size; },
+          R"pbdoc(Size of the first region the CPU arena allocates. Default is 1MB.)pbdoc")
+      .def_property(
+          "arena_extend_strategy",
+          [](const SessionOptions* options) { return options->arena_config.arena_extend_strategy; },
+          [](SessionOptions* options, onnxruntime::ArenaExtendStrategy strategy) {
+            options->arena_config.arena_extend_strategy = strategy;
+          },
+          R"pbdoc(How the CPU arena sizes new regions. Default is kNextPowerOfTwo.)pbdoc")
+      .def_property(
+          "arena_idle_shrink_timeout_ms",
+          [](const SessionOptions* options) { return options->arena_config.idle_shrink_timeout_ms; },
+          [](SessionOptions* options, int64_t timeout) { options->arena_config.idle_shrink_timeout_ms = timeout; },
+          R"pbdoc(Free arena regions that have been unused for this many milliseconds. Default is 0 (never).)pbdoc")
+      .def_property(
+          "thread_pool_affinity",
+          [](const SessionOptions* options) { return options->session_thread_pool_options.affinity; },
+          [](SessionOptions* options, const std::vector<size_t>& affinity) {
+            options->session_thread_pool_options.affinity = affinity;
+          },
+          R"pbdoc(Logical processors to pin the session thread pool threads to. Default is empty.)pbdoc")
+      .def_property(
+          "inter_op_thread_pool_affinity",
+          [](const SessionOptions* options) { return options->inter_op_thread_pool_options.affinity; },
+          [](SessionOptions* options, const std::vector<size_t>& affinity) {
+            options->inter_op_thread_pool_options.affinity = affinity;
+          },
+          R"pbdoc(Logical processors to pin the inter-op thread pool threads to. Default is empty.)pbdoc")
+      .def_property(
+          "thread_pool_numa_node",
+          [](const SessionOptions* options) { return options->session_thread_pool_options.numa_node; },
+          [](SessionOptions* options, int numa_node) { options->session_thread_pool_options.numa_node = numa_node; },
+          R"pbdoc(NUMA node the session thread pool threads run on. Default is -1 (no restriction).)pbdoc")
+      .def_property(
+          "inter_op_thread_pool_numa_node",
+          [](const SessionOptions* options) { return options->inter_op_thread_pool_options.numa_node; },
+          [](SessionOptions* options, int numa_node) { options->inter_op_thread_pool_options.numa_node = numa_node; },
+          R"pbdoc(NUMA node the inter-op thread pool threads run on. Default is -1 (no restriction).)pbdoc")
+      .def_property(
+          "thread_pool_spin_duration_us",
+          [](const SessionOptions* options) { return options->session_thread_pool_options.spin_duration_us; },
+          [](SessionOptions* options, int spin_duration_us) {
+            options->session_thread_pool_options.spin_duration_us = spin_duration_us;
+          },
+          R"pbdoc(Microseconds the session thread pool threads spin for more work before blocking. Default is 0.)pbdoc")
+      .def_property(
+          "inter_op_thread_pool_spin_duration_us",
+          [](const SessionOptions* options) { return options->inter_op_thread_pool_options.spin_duration_us; },
+          [](SessionOptions* options, int spin_duration_us) {
+            options->inter_op_thread_pool_options.spin_duration_us = spin_duration_us;
+          },
+          R"pbdoc(Microseconds the inter-op thread pool threads spin for more work before blocking. Default is 0.)pbdoc")
+      .def_readwrite("enable_low_latency_runs", &SessionOptions::enable_low_latency_runs,
+                     R"pbdoc(Keep the session thread pool threads spinning during each run, and let them block between runs. Default is false.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
@@ -552,7 +718,10 @@ Applies to a particular Run() invocation. Default is 0.)pbdoc")
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("run_timeout_ms", &RunOptions::run_timeout_ms,
+                     R"pbdoc(If greater than 0, calls using this RunOptions instance fail once they have been
+executing for longer than this many milliseconds. Default is 0.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -622,6 +791,122 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       },
                              "node shape (assuming the node holds a tensor)");
 
+  py::class_<OrtValue>(m, "OrtValue", R"pbdoc(A value held by ONNX Runtime, which runs and IOBinding consume and produce without numpy arrays.)pbdoc")
+      .def_static("ortvalue_from_numpy", [](py::object value) {
+        auto ml_value = std::make_unique<OrtValue>();
+        CreateGenericMLValue(GetAllocator(), "ortvalue_from_numpy", value, ml_value.get());
+        if (PyErr_Occurred()) {
+          throw py::error_already_set();
+        }
+        if (!ml_value->IsTensor())
+          throw std::runtime_error("ortvalue_from_numpy expects a numpy array");
+        return ml_value;
+      },
+                  R"pbdoc(Copy a numpy array into a new OrtValue in CPU memory.)pbdoc")
+      .def("is_tensor", &OrtValue::IsTensor)
+      .def("shape", [](const OrtValue* ml_value) -> std::vector<int64_t> {
+        return ml_value->Get<Tensor>().Shape().GetDims();
+      })
+      .def("element_type", [](const OrtValue* ml_value) -> py::object {
+        const int numpy_type = OnnxRuntimeTensorToNumpyType(ml_value->Get<Tensor>().DataType());
+        return py::reinterpret_steal<py::object>(reinterpret_cast<PyObject*>(PyArray_DescrFromType(numpy_type)));
+      },
+           R"pbdoc(The numpy dtype of the elements of the tensor.)pbdoc")
+      .def("device_name", [](const OrtValue* ml_value) -> std::string {
+        return ml_value->Get<Tensor>().Location().device.Type() == OrtDevice::GPU ? "cuda" : "cpu";
+      })
+      .def_static("from_dlpack", &OrtValueFromDlpack,
+                  R"pbdoc(Wrap the tensor of a DLPack capsule (e.g. from torch.utils.dlpack.to_dlpack) without copying it.)pbdoc")
+      .def("to_dlpack", &OrtValueToDlpack,
+           R"pbdoc(Return a DLPack capsule over the tensor (e.g. for torch.utils.dlpack.from_dlpack) without copying it.)pbdoc")
+      .def("__dlpack__", [](const OrtValue& ml_value, py::object /*stream*/) {
+        return OrtValueToDlpack(ml_value);
+      },
+           py::arg("stream") = py::none())
+      .def("__dlpack_device__", &DlpackDevice)
+      .def_static("from_cuda_array_interface", &OrtValueFromCudaArrayInterface, py::arg("obj"), py::arg("device_id") = 0,
+                  R"pbdoc(Wrap the CUDA memory of an object with __cuda_array_interface__ (e.g. a CuPy array) without copying it.)pbdoc")
+      .def_property_readonly("__cuda_array_interface__", &CudaArrayInterface)
+      .def("numpy", [](OrtValue* ml_value) -> py::object {
+        if (ml_value->Get<Tensor>().Location().device.Type() != OrtDevice::CPU)
+          throw std::runtime_error("numpy() requires a tensor in CPU memory. "
+                                   "Use copy_outputs_to_cpu for the outputs of an IOBinding left on a device.");
+        std::vector<py::object> rfetch;
+        AddTensorAsPyObj(*ml_value, rfetch);
+        return rfetch[0];
+      },
+           R"pbdoc(Copy the tensor into a new numpy array.)pbdoc");
+
+  py::class_<SessionIOBinding>(m, "SessionIOBinding", R"pbdoc(Inputs and outputs bound to a session for repeated runs.)pbdoc")
+      .def(py::init([](InferenceSession* sess) {
+        std::unique_ptr<IOBinding> io_binding;
+        auto status = sess->NewIOBinding(&io_binding);
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+        return SessionIOBinding{std::move(io_binding)};
+      }),
+           py::keep_alive<1, 2>())
+      .def("bind_input", [](SessionIOBinding* binding, const std::string& name, py::object value) {
+        OrtValue ml_value;
+        CreateGenericMLValue(GetAllocator(), name, value, &ml_value);
+        auto status = binding->io_binding->BindInput(name, ml_value);
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      },
+           R"pbdoc(Bind a numpy array to an input. The array is copied to the device the input is consumed on.)pbdoc")
+      .def("bind_ortvalue_input", [](SessionIOBinding* binding, const std::string& name, const OrtValue& ml_value) {
+        auto status = binding->io_binding->BindInput(name, ml_value);
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      },
+           R"pbdoc(Bind an OrtValue to an input. It is copied to the device the input is consumed on if it isn't there.)pbdoc")
+      .def("bind_output", [](SessionIOBinding* binding, const std::string& name, const std::string& device_type, int device_id) {
+        OrtMemoryInfo location = GetMemoryInfoForDevice(device_type, device_id);
+        auto status = binding->io_binding->BindOutput(name, location);
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      },
+           py::arg("name"), py::arg("device_type") = "cpu", py::arg("device_id") = 0,
+           R"pbdoc(Bind an output to a device. The output is allocated on the device by each run and is not copied to CPU.)pbdoc")
+      .def("synchronize_inputs", [](SessionIOBinding* binding) {
+        auto status = binding->io_binding->SynchronizeInputs();
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      })
+      .def("synchronize_outputs", [](SessionIOBinding* binding) {
+        auto status = binding->io_binding->SynchronizeOutputs();
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      })
+      .def("clear_binding_inputs", [](SessionIOBinding* binding) {
+        binding->io_binding->ClearInputs();
+      })
+      .def("clear_binding_outputs", [](SessionIOBinding* binding) {
+        binding->io_binding->ClearOutputs();
+      })
+      .def("copy_outputs_to_cpu", [](SessionIOBinding* binding) -> std::vector<py::object> {
+        std::vector<OrtValue> outputs;
+        auto status = binding->io_binding->CopyOutputsToCpu(outputs);
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+
+        std::vector<py::object> rfetch;
+        rfetch.reserve(outputs.size());
+        for (auto _ : outputs) {
+          if (_.IsTensor()) {
+            AddTensorAsPyObj(_, rfetch);
+          } else {
+            AddNonTensorAsPyObj(_, rfetch);
+          }
+        }
+        return rfetch;
+      },
+           R"pbdoc(Return the outputs of the last run as numpy arrays, copying the outputs left on a device.)pbdoc")
+      .def("get_outputs", [](SessionIOBinding* binding) -> std::vector<OrtValue> {
+        return binding->io_binding->GetOutputs();
+      },
+           R"pbdoc(Return the outputs of the last run as OrtValues, left on the device they were bound to.)pbdoc");
+
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
   py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       .def(py::init<SessionObjectInitializer, SessionObjectInitializer>())
@@ -645,10 +930,11 @@ including arg name, arg type (contains both type and shape).)pbdoc")
       },
            R"pbdoc(Load a model serialized in ONNX format.)pbdoc")
       .def("run", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
+        // The numpy inputs are wrapped without copying them. pyfeeds holds the arrays during the run.
         NameMLValMap feeds;
         for (auto _ : pyfeeds) {
           OrtValue ml_value;
-          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
+          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value, true);
           if (PyErr_Occurred()) {
             PyObject *ptype, *pvalue, *ptraceback;
             PyErr_Fetch(&ptype, &pvalue, &ptraceback);
@@ -687,16 +973,175 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         rfetch.reserve(fetches.size());
         for (auto _ : fetches) {
           if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
+            // An output that is a graph input too is the numpy input itself, which the returned array mustn't share.
+            const void* data = _.Get<Tensor>().DataRaw();
+            const bool is_feed = std::any_of(feeds.cbegin(), feeds.cend(), [data](const NameMLValMap::value_type& feed) {
+              return feed.second.IsTensor() && feed.second.Get<Tensor>().DataRaw() == data;
+            });
+            AddTensorAsPyObj(_, rfetch, !is_feed);
           } else {
             AddNonTensorAsPyObj(_, rfetch);
           }
         }
         return rfetch;
       })
+      .def("run_many", [](InferenceSession* sess, std::vector<std::string> output_names, std::vector<std::map<std::string, py::object>> pyfeed_sets, RunOptions* run_options = nullptr) -> std::vector<std::vector<py::object>> {
+        // The numpy inputs are wrapped without copying them. pyfeed_sets holds the arrays during the runs.
+        if (pyfeed_sets.empty()) {
+          return {};
+        }
+        std::vector<std::string> feed_names;
+        for (const auto& _ : pyfeed_sets.front()) {
+          feed_names.push_back(_.first);
+        }
+
+        std::vector<std::vector<OrtValue>> feeds(pyfeed_sets.size());
+        for (size_t i = 0; i < pyfeed_sets.size(); ++i) {
+          auto& pyfeeds = pyfeed_sets[i];
+          // the maps are ordered by name, so the values of every set line up with feed_names
+          if (pyfeeds.size() != feed_names.size() ||
+              !std::equal(feed_names.cbegin(), feed_names.cend(), pyfeeds.cbegin(),
+                          [](const std::string& name, const std::pair<const std::string, py::object>& feed) {
+                            return name == feed.first;
+                          })) {
+            throw std::runtime_error("Input feed " + std::to_string(i) + " doesn't have the inputs of the first feed.");
+          }
+          for (auto& _ : pyfeeds) {
+            OrtValue ml_value;
+            CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value, true);
+            if (PyErr_Occurred()) {
+              throw py::error_already_set();
+            }
+            feeds[i].push_back(ml_value);
+          }
+        }
+
+        static const RunOptions default_run_options;
+        std::vector<std::vector<OrtValue>> fetches;
+        common::Status status;
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          status = sess->RunMany(run_options != nullptr ? *run_options : default_run_options, feed_names, feeds,
+                                 output_names, &fetches);
+        }
+        if (!status.IsOK())
+          throw std::runtime_error(std::string("Method run_many failed due to: ") + status.ToString());
+
+        std::vector<std::vector<py::object>> rfetch_sets;
+        rfetch_sets.reserve(fetches.size());
+        for (auto& set_fetches : fetches) {
+          std::vector<py::object> rfetch;
+          rfetch.reserve(set_fetches.size());
+          for (auto _ : set_fetches) {
+            if (_.IsTensor()) {
+              AddTensorAsPyObj(_, rfetch);
+            } else {
+              AddNonTensorAsPyObj(_, rfetch);
+            }
+          }
+          rfetch_sets.push_back(std::move(rfetch));
+        }
+        return rfetch_sets;
+      })
+      .def("run_async", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, py::function callback, py::object run_options) {
+        std::vector<std::string> feed_names;
+        std::vector<OrtValue> feeds;
+        feed_names.reserve(pyfeeds.size());
+        feeds.reserve(pyfeeds.size());
+        for (auto _ : pyfeeds) {
+          OrtValue ml_value;
+          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
+          if (PyErr_Occurred()) {
+            throw py::error_already_set();
+          }
+          feed_names.push_back(_.first);
+          feeds.push_back(ml_value);
+        }
+
+        static const RunOptions default_run_options;
+        const RunOptions& options = run_options.is_none() ? default_run_options : run_options.cast<const RunOptions&>();
+
+        auto state = std::make_shared<PyRunAsyncState>();
+        state->callback = std::move(callback);
+        state->run_options = std::move(run_options);
+
+        auto status = sess->RunAsync(options, feed_names, feeds, output_names, {},
+                                     [state](const common::Status& run_status, std::vector<OrtValue>& fetches) {
+                                       py::gil_scoped_acquire acquire;
+                                       try {
+                                         if (!run_status.IsOK()) {
+                                           state->callback(py::none(), std::string("Method run_async failed due to: ") + run_status.ToString());
+                                           return;
+                                         }
+
+                                         std::vector<py::object> rfetch;
+                                         rfetch.reserve(fetches.size());
+                                         for (auto _ : fetches) {
+                                           if (_.IsTensor()) {
+                                             AddTensorAsPyObj(_, rfetch);
+                                           } else {
+                                             AddNonTensorAsPyObj(_, rfetch);
+                                           }
+                                         }
+                                         state->callback(rfetch, py::none());
+                                       } catch (py::error_already_set& e) {
+                                         // there's no caller to raise to on this thread
+                                         e.restore();
+                                         PyErr_Print();
+                                       }
+                                     });
+        if (!status.IsOK())
+          throw std::runtime_error(std::string("Method run_async failed due to: ") + status.ToString());
+      })
+      .def("run_with_iobinding", [](InferenceSession* sess, SessionIOBinding& binding, RunOptions* run_options = nullptr) {
+        common::Status status;
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            status = sess->Run(*run_options, *binding.io_binding);
+          } else {
+            status = sess->Run(*binding.io_binding);
+          }
+        }
+        if (!status.IsOK())
+          throw std::runtime_error(std::string("Method run_with_iobinding failed due to: ") + status.ToString());
+      })
+      .def("run_with_ortvalues", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, OrtValue> ortvalue_feeds, RunOptions* run_options = nullptr) -> std::vector<OrtValue> {
+        NameMLValMap feeds(ortvalue_feeds.cbegin(), ortvalue_feeds.cend());
+        std::vector<OrtValue> fetches;
+        common::Status status;
+        {
+          // release GIL to allow multiple python threads to invoke Run() in parallel.
+          py::gil_scoped_release release;
+          if (run_options != nullptr) {
+            status = sess->Run(*run_options, feeds, output_names, &fetches);
+          } else {
+            status = sess->Run(feeds, output_names, &fetches);
+          }
+        }
+        if (!status.IsOK())
+          throw std::runtime_error(std::string("Method run_with_ortvalues failed due to: ") + status.ToString());
+        return fetches;
+      })
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
+      .def("warmup", [](InferenceSession* sess, const std::vector<NameShapeMap>& input_shape_sets) {
+        common::Status status;
+        {
+          py::gil_scoped_release release;
+          status = sess->Warmup(input_shape_sets);
+        }
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      })
+      .def("shrink_memory_arenas", [](InferenceSession* sess) {
+        auto status = sess->ShrinkMemoryArenas();
+        if (!status.IsOK())
+          throw std::runtime_error(status.ToString().c_str());
+      })
       .def_property_readonly("inputs_meta", [](const InferenceSession* sess) -> const std::vector<const onnxruntime::NodeArg*>& {
         auto res = sess->GetModelInputs();
         if (!res.first.IsOK()) {
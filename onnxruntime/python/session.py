@@ -3,6 +3,7 @@
 # Licensed under the MIT License.
 #--------------------------------------------------------------------------
 
+import asyncio
 import sys
 import os
 
@@ -71,6 +72,100 @@ class InferenceSession:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run(output_names, input_feed, run_options)
 
+    def run_with_ortvalues(self, output_names, input_feed, run_options=None):
+        """
+        Compute the predictions for inputs given as :class:`onnxruntime.OrtValue`, without converting the inputs
+        and outputs from and to numpy arrays.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: ortvalue }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list of :class:`onnxruntime.OrtValue`
+
+        ::
+
+            x = onnxruntime.OrtValue.ortvalue_from_numpy(x_array)
+            y = sess.run_with_ortvalues([output_name], {input_name: x})[0].numpy()
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_with_ortvalues(output_names, input_feed, run_options)
+
+    def run_many(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions for several input feeds in one call. If the first dimension of the inputs and
+        outputs is symbolic, the feeds are run as one batch, concatenated along the first dimension, whose outputs
+        are split back into the feeds. This assumes the rows of a batch are computed independently of each other.
+        Otherwise the feeds are run one after the other, without returning to Python in between.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``, which all have the same names
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list of the outputs of each feed
+
+        ::
+
+            results = sess.run_many([output_name], [{input_name: x1}, {input_name: x2}])
+        """
+        if not input_feeds:
+            return []
+        num_required_inputs = len(self._inputs_meta)
+        for input_feed in input_feeds:
+            num_inputs = len(input_feed)
+            if num_inputs < num_required_inputs:
+                raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_many(output_names, input_feeds, run_options)
+
+    async def run_async(self, output_names, input_feed, run_options=None):
+        """
+        Compute the predictions without blocking the event loop.
+        The run executes on a thread of the session and is awaited on the current event loop.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+            It must not be modified until the run completes, except to terminate it.
+
+        ::
+
+            outputs = await sess.run_async([output_name], {input_name: x})
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        # the graph may have optional inputs used to override initializers. allow for that.
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+
+        loop = asyncio.get_event_loop()
+        future = loop.create_future()
+
+        def complete(outputs, error):
+            if future.cancelled():
+                return
+            if error is not None:
+                future.set_exception(RuntimeError(error))
+            else:
+                future.set_result(outputs)
+
+        # called on a thread of the session, so hand the result over to the event loop
+        def callback(outputs, error):
+            try:
+                loop.call_soon_threadsafe(complete, outputs, error)
+            except RuntimeError:
+                # the event loop was closed, so nothing is waiting for the result
+                pass
+
+        self._sess.run_async(output_names, input_feed, callback, run_options)
+        return await future
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -79,3 +174,91 @@ class InferenceSession:
         :meth:`onnxruntime.SessionOptions.enable_profiling`.
         """
         return self._sess.end_profiling()
+
+    def warmup(self, input_shape_sets):
+        """
+        Run the session once for each set of input shapes with zero-filled inputs, so that later runs
+        with those shapes don't pay for the first run.
+
+        :param input_shape_sets: list of dictionaries ``{ input_name: shape }``. Inputs that aren't listed
+            get the shape of the model input, with 1 for symbolic dimensions.
+        """
+        self._sess.warmup(input_shape_sets)
+
+    def shrink_memory_arenas(self):
+        """
+        Return the memory of the session's arenas that is not in use.
+        """
+        self._sess.shrink_memory_arenas()
+
+    def io_binding(self):
+        "Return an :class:`onnxruntime.IOBinding` object for this session."
+        return IOBinding(self)
+
+    def run_with_iobinding(self, iobinding, run_options=None):
+        """
+        Compute the predictions for the inputs and outputs bound to ``iobinding``.
+
+        :param iobinding: the :class:`onnxruntime.IOBinding` object created by :meth:`io_binding`
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        self._sess.run_with_iobinding(iobinding._iobinding, run_options)
+
+
+class IOBinding:
+    """
+    This class binds inputs and outputs to a session so that repeated runs do not copy them again.
+    Outputs can be left on the device the model runs on.
+
+    ::
+
+        io_binding = sess.io_binding()
+        io_binding.bind_input(input_name, x)
+        io_binding.bind_output(output_name, 'cuda', 0)
+        sess.run_with_iobinding(io_binding)
+        y = io_binding.copy_outputs_to_cpu()[0]
+    """
+    def __init__(self, session):
+        self._iobinding = C.SessionIOBinding(session._sess)
+
+    def bind_input(self, name, value):
+        """
+        :param name: input name
+        :param value: numpy array, copied to the device the input is consumed on
+        """
+        self._iobinding.bind_input(name, value)
+
+    def bind_ortvalue_input(self, name, ortvalue):
+        """
+        :param name: input name
+        :param ortvalue: :class:`onnxruntime.OrtValue`, copied to the device the input is consumed on if needed
+        """
+        self._iobinding.bind_ortvalue_input(name, ortvalue)
+
+    def bind_output(self, name, device_type='cpu', device_id=0):
+        """
+        :param name: output name
+        :param device_type: device the output is allocated on, 'cpu' or 'cuda'
+        :param device_id: device id, e.g. the CUDA device ordinal
+        """
+        self._iobinding.bind_output(name, device_type, device_id)
+
+    def synchronize_inputs(self):
+        self._iobinding.synchronize_inputs()
+
+    def synchronize_outputs(self):
+        self._iobinding.synchronize_outputs()
+
+    def clear_binding_inputs(self):
+        self._iobinding.clear_binding_inputs()
+
+    def clear_binding_outputs(self):
+        self._iobinding.clear_binding_outputs()
+
+    def copy_outputs_to_cpu(self):
+        "Return the outputs of the last run as numpy arrays, copying any output left on a device."
+        return self._iobinding.copy_outputs_to_cpu()
+
+    def get_outputs(self):
+        "Return the outputs of the last run as :class:`onnxruntime.OrtValue`, left on the device they were bound to."
+        return self._iobinding.get_outputs()
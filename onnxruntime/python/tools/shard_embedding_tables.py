@@ -0,0 +1,99 @@
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+"""
+Moves embedding tables out of a model for ONNX Runtime Server.
+
+Each table is a float initializer of shape [rows, row size] read by Gather nodes on axis 0. The tool splits it into
+shard files of consecutive rows, to be served with --embedding_shard by the servers holding them, and replaces its
+Gather nodes with RemoteGather nodes of the com.microsoft.server domain, which the servers running the model look up
+in the shards given with --remote_embedding_shard.
+"""
+import argparse
+import os
+
+import numpy as np
+import onnx
+from onnx import helper, numpy_helper
+
+remote_embedding_domain = "com.microsoft.server"
+
+
+def shard_table(model, table, shard_count, output_dir):
+    initializer = next((i for i in model.graph.initializer if i.name == table), None)
+    if initializer is None:
+        raise ValueError("{} isn't an initializer of the model".format(table))
+
+    values = numpy_helper.to_array(initializer)
+    if values.dtype != np.float32 or values.ndim != 2:
+        raise ValueError("{} isn't a 2-D float tensor".format(table))
+
+    nodes = [n for n in model.graph.node if table in n.input]
+    for node in nodes:
+        axis = next((a.i for a in node.attribute if a.name == "axis"), 0)
+        if node.op_type != "Gather" or node.input[1] == table or axis != 0:
+            raise ValueError("{} is read by node {}, which isn't a Gather on axis 0".format(table, node.name))
+
+    shards = []
+    rows_per_shard = (values.shape[0] + shard_count - 1) // shard_count
+    for first_row in range(0, values.shape[0], rows_per_shard):
+        path = os.path.join(output_dir, "{}.{}.bin".format(table, len(shards)))
+        rows = np.ascontiguousarray(values[first_row:first_row + rows_per_shard])
+        rows.astype("<f4").tofile(path)
+        shards.append((first_row, rows.shape[0], path))
+
+    graph_nodes = []
+    casts = set()
+    for node in model.graph.node:
+        if node not in nodes:
+            graph_nodes.append(node)
+            continue
+
+        # RemoteGather takes int64 indices
+        indices = node.input[1]
+        indices_type = next((i.type.tensor_type.elem_type
+                             for i in list(model.graph.input) + list(model.graph.value_info)
+                             if i.name == indices), onnx.TensorProto.INT64)
+        if indices_type != onnx.TensorProto.INT64:
+            cast_output = indices + "_int64"
+            if cast_output not in casts:
+                graph_nodes.append(helper.make_node("Cast", [indices], [cast_output], to=onnx.TensorProto.INT64))
+                casts.add(cast_output)
+            indices = cast_output
+        graph_nodes.append(helper.make_node("RemoteGather", [indices], list(node.output), name=node.name,
+                                            domain=remote_embedding_domain, table=table))
+    del model.graph.node[:]
+    model.graph.node.extend(graph_nodes)
+
+    model.graph.initializer.remove(initializer)
+    return values.shape[1], shards
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Moves embedding tables out of a model for ONNX Runtime Server.')
+    parser.add_argument('model', help='the model')
+    parser.add_argument('output_model', help='the model with RemoteGather nodes in place of the Gather nodes')
+    parser.add_argument('--table', action='append', required=True, help='initializer of a table, can be repeated')
+    parser.add_argument('--shards', type=int, default=2, help='number of shards of each table')
+    parser.add_argument('--output_dir', default='.', help='directory of the shard files')
+    args = parser.parse_args()
+
+    model = onnx.load(args.model)
+    flags = []
+    for table in args.table:
+        row_size, shards = shard_table(model, table, args.shards, args.output_dir)
+        for i, (first_row, row_count, path) in enumerate(shards):
+            flags.append("shard {}: --embedding_shard {}:{}:{}:{}".format(i, table, first_row, row_size, path))
+            flags.append("model: --remote_embedding_shard {}:{}:{}:{}:<host of shard {}>:<grpc port>".format(
+                table, row_size, first_row, row_count, i))
+
+    if not any(o.domain == remote_embedding_domain for o in model.opset_import):
+        model.opset_import.extend([helper.make_opsetid(remote_embedding_domain, 1)])
+    onnx.save(model, args.output_model)
+    print("\n".join(flags))
+
+
+if __name__ == "__main__":
+    main()
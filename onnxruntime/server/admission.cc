@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "admission.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+bool ParseRequestPriority(const std::string& value, RequestPriority& priority) {
+  if (value == "low") {
+    priority = RequestPriority::Low;
+  } else if (value == "normal") {
+    priority = RequestPriority::Normal;
+  } else if (value == "high") {
+    priority = RequestPriority::High;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+AdmissionController::Slot::~Slot() {
+  if (controller_ != nullptr) {
+    controller_->Release();
+  }
+}
+
+AdmissionController::AdmissionController(const AdmissionOptions& options) : options_(options) {}
+
+protobufutil::Status AdmissionController::Admit(RequestPriority priority,
+                                                std::chrono::steady_clock::time_point deadline, Slot& slot) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (options_.max_concurrent_runs == 0 || (running_ < options_.max_concurrent_runs && queued_ == 0)) {
+    ++running_;
+    slot.controller_ = this;
+    return protobufutil::Status::OK;
+  }
+
+  const auto index = static_cast<size_t>(priority);
+  if (queued_ >= options_.max_queued_requests) {
+    // the newest of the queued requests of the lowest priority makes room for a request of a higher priority
+    size_t lowest = 0;
+    while (lowest < index && queues_[lowest].empty()) {
+      ++lowest;
+    }
+    if (lowest == index) {
+      return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED,
+                                  "The server is overloaded, too many requests are waiting to run");
+    }
+
+    auto* displaced = queues_[lowest].back();
+    queues_[lowest].pop_back();
+    --queued_;
+    displaced->rejected = true;
+    displaced->cv.notify_one();
+  }
+
+  Waiter waiter;
+  queues_[index].push_back(&waiter);
+  ++queued_;
+
+  auto done = [&waiter]() { return waiter.admitted || waiter.rejected; };
+  if (deadline == std::chrono::steady_clock::time_point::max()) {
+    waiter.cv.wait(lock, done);
+  } else if (!waiter.cv.wait_until(lock, deadline, done)) {
+    auto& queue = queues_[index];
+    queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+    --queued_;
+    return protobufutil::Status(protobufutil::error::Code::DEADLINE_EXCEEDED,
+                                "The deadline of the request passed while it was waiting to run");
+  }
+
+  if (waiter.rejected) {
+    return protobufutil::Status(protobufutil::error::Code::RESOURCE_EXHAUSTED,
+                                "The server is overloaded, the request made room for requests of a higher priority");
+  }
+
+  // Release counted the request as running when it admitted it
+  slot.controller_ = this;
+  return protobufutil::Status::OK;
+}
+
+size_t AdmissionController::QueueDepth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queued_;
+}
+
+void AdmissionController::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --running_;
+  for (size_t i = kNumPriorities; i-- > 0;) {
+    auto& queue = queues_[i];
+    if (!queue.empty()) {
+      auto* next = queue.front();
+      queue.pop_front();
+      --queued_;
+      ++running_;
+      next->admitted = true;
+      next->cv.notify_one();
+      return;
+    }
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <google/protobuf/stubs/status.h>
+
+namespace onnxruntime {
+namespace server {
+
+// Priority of a request, from its x-ms-priority header or gRPC metadata. Queued requests of a higher priority are
+// admitted first.
+enum class RequestPriority {
+  Low = 0,
+  Normal = 1,
+  High = 2,
+};
+
+// Parses "low", "normal" or "high". Returns false for any other value.
+bool ParseRequestPriority(const std::string& value, /* out */ RequestPriority& priority);
+
+struct AdmissionOptions {
+  // Largest number of requests of a model that run at the same time. 0 admits every request right away.
+  size_t max_concurrent_runs = 0;
+  // Largest number of requests of a model waiting to run. A request that arrives when the queue is full is
+  // rejected, unless a queued request has a lower priority, which is rejected in its place.
+  size_t max_queued_requests = 64;
+};
+
+/**
+ * Bounds the requests of a model that run at the same time, so that an overloaded server keeps serving the requests
+ * it admits at a steady latency instead of slowing all of them down. The requests that can't run yet wait in a
+ * bounded queue, by priority then in arrival order, and are rejected early when it's full or their deadline passes.
+ */
+class AdmissionController {
+ public:
+  // The right of an admitted request to run. It's given to the next queued request when destroyed.
+  class Slot {
+   public:
+    Slot() = default;
+    ~Slot();
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+   private:
+    friend class AdmissionController;
+    AdmissionController* controller_ = nullptr;
+  };
+
+  explicit AdmissionController(const AdmissionOptions& options);
+  AdmissionController(const AdmissionController&) = delete;
+  AdmissionController& operator=(const AdmissionController&) = delete;
+
+  // Waits until the request may run and sets slot. Returns RESOURCE_EXHAUSTED if the request is rejected because
+  // the queue is full, or DEADLINE_EXCEEDED if deadline passes while it's queued.
+  google::protobuf::util::Status Admit(RequestPriority priority, std::chrono::steady_clock::time_point deadline,
+                                       /* out */ Slot& slot);
+
+  // Number of requests waiting to run.
+  size_t QueueDepth() const;
+
+ private:
+  struct Waiter {
+    std::condition_variable cv;
+    bool admitted = false;
+    bool rejected = false;
+  };
+  static constexpr size_t kNumPriorities = 3;
+
+  void Release();
+
+  const AdmissionOptions options_;
+
+  mutable std::mutex mutex_;
+  size_t running_ = 0;                          // protected by mutex_
+  size_t queued_ = 0;                           // protected by mutex_
+  std::deque<Waiter*> queues_[kNumPriorities];  // protected by mutex_, indexed by priority
+};
+
+}  // namespace server
+}  // namespace onnxruntime
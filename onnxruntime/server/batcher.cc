@@ -0,0 +1,318 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "batcher.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+static size_t NumElements(const int64_t* dims, size_t rank) {
+  return std::accumulate(dims, dims + rank, size_t{1},
+                         [](size_t count, int64_t dim) { return count * static_cast<size_t>(dim); });
+}
+
+// Copies the rows of src into dst, whose dims after dim 0 are at least those of src. The padding isn't written.
+static void CopyPadded(const uint8_t* src, const int64_t* src_dims, uint8_t* dst, const int64_t* dst_dims,
+                       size_t rank, size_t element_size) {
+  if (rank == 1) {
+    memcpy(dst, src, static_cast<size_t>(src_dims[0]) * element_size);
+    return;
+  }
+
+  const size_t src_stride = NumElements(src_dims + 1, rank - 1) * element_size;
+  const size_t dst_stride = NumElements(dst_dims + 1, rank - 1) * element_size;
+  for (int64_t i = 0; i < src_dims[0]; ++i) {
+    CopyPadded(src + i * src_stride, src_dims + 1, dst + i * dst_stride, dst_dims + 1, rank - 1, element_size);
+  }
+}
+
+// Number of rows of a tensor that can be batched along dim 0, or 0 if it can't be batched.
+static int64_t BatchRows(const Ort::Value& value, ONNXTensorElementDataType& type, std::vector<int64_t>& shape) {
+  if (!value.IsTensor()) {
+    return 0;
+  }
+
+  auto info = value.GetTensorTypeAndShapeInfo();
+  type = info.GetElementType();
+  shape = info.GetShape();
+  return TensorElementSize(type) != 0 && !shape.empty() ? shape[0] : 0;
+}
+
+static std::vector<Ort::Value> RunSession(const Ort::Session& session, const Ort::RunOptions& run_options,
+                                          const std::vector<std::string>& input_names,
+                                          std::vector<Ort::Value>& input_values,
+                                          const std::vector<std::string>& output_names) {
+  std::vector<const char*> input_ptrs;
+  input_ptrs.reserve(input_names.size());
+  for (const auto& name : input_names) {
+    input_ptrs.push_back(name.c_str());
+  }
+  std::vector<const char*> output_ptrs;
+  output_ptrs.reserve(output_names.size());
+  for (const auto& name : output_names) {
+    output_ptrs.push_back(name.c_str());
+  }
+
+  return const_cast<Ort::Session&>(session).Run(run_options, input_ptrs.data(), input_values.data(),
+                                               input_values.size(), output_ptrs.data(), output_ptrs.size());
+}
+
+RequestBatcher::RequestBatcher(const Ort::Session& session, const BatchingOptions& options)
+    : session_(session), options_(options) {
+  worker_ = std::thread([this]() { ProcessRequests(); });
+}
+
+RequestBatcher::~RequestBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+std::vector<Ort::Value> RequestBatcher::Run(const Ort::RunOptions& run_options,
+                                            std::vector<std::string> input_names,
+                                            std::vector<Ort::Value> input_values,
+                                            const std::vector<std::string>& output_names,
+                                            BatchedRunStats* stats) {
+  PendingRequest request;
+  request.run_options = &run_options;
+  request.output_names = &output_names;
+
+  std::vector<size_t> order(input_names.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(),
+            [&input_names](size_t a, size_t b) { return input_names[a] < input_names[b]; });
+
+  // all the inputs must have the same number of rows for the request to be batched
+  request.rows = order.empty() ? 0 : -1;
+  for (size_t i : order) {
+    ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;
+    const int64_t rows = BatchRows(input_values[i], type, shape);
+    request.rows = (request.rows == -1 || request.rows == rows) ? rows : 0;
+
+    request.input_names.push_back(std::move(input_names[i]));
+    request.input_values.push_back(std::move(input_values[i]));
+    request.input_types.push_back(type);
+    request.input_shapes.push_back(std::move(shape));
+  }
+
+  // a request that fills a batch by itself gains nothing from waiting for others
+  if (request.rows <= 0 || static_cast<size_t>(request.rows) >= options_.max_batch_size) {
+    if (stats != nullptr) {
+      stats->queue_time = std::chrono::steady_clock::duration::zero();
+      stats->batch_size = static_cast<size_t>(std::max<int64_t>(request.rows, 1));
+    }
+    return RunSingle(request);
+  }
+
+  auto outputs = request.outputs.get_future();
+  request.enqueue_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(&request);
+    queued_rows_ += static_cast<size_t>(request.rows);
+  }
+  cv_.notify_one();
+
+  // the stats are set before the outputs, so the future synchronizes them
+  auto result = outputs.get();
+  if (stats != nullptr) {
+    stats->queue_time = request.dequeue_time - request.enqueue_time;
+    stats->batch_size = request.batch_size;
+  }
+  return result;
+}
+
+size_t RequestBatcher::NumBatchedRuns() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_batched_runs_;
+}
+
+size_t RequestBatcher::QueueDepth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+void RequestBatcher::ProcessRequests() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // wait for a full batch, but not longer than the oldest request may be delayed
+    const auto deadline = queue_.front()->enqueue_time + options_.max_queue_delay;
+    cv_.wait_until(lock, deadline, [this]() { return stopping_ || queued_rows_ >= options_.max_batch_size; });
+
+    auto batch = TakeBatch();
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+std::vector<RequestBatcher::PendingRequest*> RequestBatcher::TakeBatch() {
+  std::vector<PendingRequest*> batch{queue_.front()};
+  queue_.pop_front();
+  size_t rows = static_cast<size_t>(batch[0]->rows);
+
+  // requests that don't fit or aren't compatible with the first one wait for a later batch
+  for (auto it = queue_.begin(); it != queue_.end() && rows < options_.max_batch_size;) {
+    const size_t request_rows = static_cast<size_t>((*it)->rows);
+    if (rows + request_rows <= options_.max_batch_size && CanBatch(*batch[0], **it)) {
+      rows += request_rows;
+      batch.push_back(*it);
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  queued_rows_ -= rows;
+  const auto now = std::chrono::steady_clock::now();
+  for (auto* request : batch) {
+    request->dequeue_time = now;
+    request->batch_size = rows;
+  }
+  return batch;
+}
+
+bool RequestBatcher::CanBatch(const PendingRequest& first, const PendingRequest& request) const {
+  if (request.input_names != first.input_names || *request.output_names != *first.output_names) {
+    return false;
+  }
+
+  for (size_t i = 0, end = first.input_shapes.size(); i < end; ++i) {
+    const auto& first_shape = first.input_shapes[i];
+    const auto& shape = request.input_shapes[i];
+    if (request.input_types[i] != first.input_types[i] || shape.size() != first_shape.size()) {
+      return false;
+    }
+    if (!options_.pad_variable_length_inputs && !std::equal(shape.begin() + 1, shape.end(), first_shape.begin() + 1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void RequestBatcher::RunBatch(const std::vector<PendingRequest*>& batch) {
+  auto run_single = [this](PendingRequest& request) {
+    try {
+      request.outputs.set_value(RunSingle(request));
+    } catch (...) {
+      request.outputs.set_exception(std::current_exception());
+    }
+  };
+
+  if (batch.size() == 1) {
+    run_single(*batch[0]);
+    return;
+  }
+
+  const PendingRequest& first = *batch[0];
+  int64_t total_rows = 0;
+  for (const auto* request : batch) {
+    total_rows += request->rows;
+  }
+
+  std::vector<Ort::Value> outputs;
+  bool batched = false;
+  try {
+    std::vector<Ort::Value> inputs;
+    for (size_t i = 0, end = first.input_values.size(); i < end; ++i) {
+      const size_t element_size = TensorElementSize(first.input_types[i]);
+      std::vector<int64_t> shape = first.input_shapes[i];
+      shape[0] = total_rows;
+      for (const auto* request : batch) {
+        const auto& request_shape = request->input_shapes[i];
+        std::transform(shape.begin() + 1, shape.end(), request_shape.begin() + 1, shape.begin() + 1,
+                       [](int64_t a, int64_t b) { return std::max(a, b); });
+      }
+
+      auto input = Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), first.input_types[i]);
+      auto* data = input.GetTensorMutableData<uint8_t>();
+      const size_t row_size = NumElements(shape.data() + 1, shape.size() - 1) * element_size;
+      for (auto* request : batch) {
+        const auto& request_shape = request->input_shapes[i];
+        const auto* request_data = request->input_values[i].GetTensorMutableData<uint8_t>();
+        if (std::equal(request_shape.begin() + 1, request_shape.end(), shape.begin() + 1)) {
+          memcpy(data, request_data, static_cast<size_t>(request->rows) * row_size);
+        } else {
+          memset(data, 0, static_cast<size_t>(request->rows) * row_size);
+          CopyPadded(request_data, request_shape.data(), data, shape.data(), shape.size(), element_size);
+        }
+        data += static_cast<size_t>(request->rows) * row_size;
+      }
+
+      inputs.push_back(std::move(input));
+    }
+
+    outputs = RunSession(session_, *first.run_options, first.input_names, inputs, *first.output_names);
+
+    batched = std::all_of(outputs.begin(), outputs.end(), [total_rows](const Ort::Value& output) {
+      ONNXTensorElementDataType type;
+      std::vector<int64_t> shape;
+      return BatchRows(output, type, shape) == total_rows;
+    });
+  } catch (const Ort::Exception&) {
+    // the model may not accept a batch, or one of the requests may be invalid. either way each request
+    // is run on its own below so that it gets its own outputs or error.
+  }
+
+  if (!batched) {
+    for (auto* request : batch) {
+      run_single(*request);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_batched_runs_;
+  }
+
+  size_t row_offset = 0;
+  for (auto* request : batch) {
+    try {
+      std::vector<Ort::Value> request_outputs;
+      request_outputs.reserve(outputs.size());
+      for (auto& output : outputs) {
+        auto info = output.GetTensorTypeAndShapeInfo();
+        const auto type = info.GetElementType();
+        std::vector<int64_t> shape = info.GetShape();
+        const size_t row_size = NumElements(shape.data() + 1, shape.size() - 1) * TensorElementSize(type);
+        shape[0] = request->rows;
+
+        auto request_output = Ort::Value::CreateTensor(allocator_, shape.data(), shape.size(), type);
+        memcpy(request_output.GetTensorMutableData<uint8_t>(),
+               output.GetTensorMutableData<uint8_t>() + row_offset * row_size,
+               static_cast<size_t>(request->rows) * row_size);
+        request_outputs.push_back(std::move(request_output));
+      }
+
+      request->outputs.set_value(std::move(request_outputs));
+    } catch (...) {
+      request->outputs.set_exception(std::current_exception());
+    }
+
+    row_offset += static_cast<size_t>(request->rows);
+  }
+}
+
+std::vector<Ort::Value> RequestBatcher::RunSingle(PendingRequest& request) {
+  return RunSession(session_, *request.run_options, request.input_names, request.input_values,
+                    *request.output_names);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Largest number of rows, i.e. the sum of dim 0 of the inputs of the requests, run in one batch.
+  size_t max_batch_size = 1;
+  // How long the oldest queued request waits for more requests before a partial batch is run.
+  std::chrono::microseconds max_queue_delay{1000};
+  // Batch requests whose inputs differ in the dims after dim 0 by padding them with zeros to the largest of them.
+  // The outputs of a padded batch are split along dim 0 only, so they keep the padded dims.
+  bool pad_variable_length_inputs = false;
+};
+
+// How a request was run by RequestBatcher::Run.
+struct BatchedRunStats {
+  // Time the request waited in the queue for its batch to run.
+  std::chrono::steady_clock::duration queue_time{};
+  // Number of rows of the batch the request was taken from the queue in, its own rows if it wasn't queued.
+  size_t batch_size = 0;
+};
+
+/**
+ * Coalesces concurrent requests into a single Run of the session, so that a model serving requests of one row
+ * at a time still runs with larger batches. Requests are batched along dim 0 of their inputs when they have the
+ * same input and output names, and inputs of the same element types and dims after dim 0 (unless padding is
+ * enabled). The outputs of a batch are split back along dim 0.
+ *
+ * A request that can't be batched, or whose batch doesn't produce outputs batched along dim 0, is run on its own.
+ */
+class RequestBatcher {
+ public:
+  RequestBatcher(const Ort::Session& session, const BatchingOptions& options);
+  ~RequestBatcher();
+  RequestBatcher(const RequestBatcher&) = delete;
+  RequestBatcher& operator=(const RequestBatcher&) = delete;
+
+  // Runs a request, possibly in a batch with concurrent ones, and waits for its outputs.
+  // A batch is run with the run_options of its first request. Throws Ort::Exception like Ort::Session::Run.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& run_options,
+                              std::vector<std::string> input_names,
+                              std::vector<Ort::Value> input_values,
+                              const std::vector<std::string>& output_names,
+                              /* out */ BatchedRunStats* stats = nullptr);
+
+  // Number of Run calls of the session made for more than one request.
+  size_t NumBatchedRuns() const;
+
+  // Number of requests waiting for their batch to run.
+  size_t QueueDepth() const;
+
+ private:
+  struct PendingRequest {
+    const Ort::RunOptions* run_options;
+    std::vector<std::string> input_names;  // sorted, so that the inputs of two requests can be compared
+    std::vector<Ort::Value> input_values;
+    std::vector<ONNXTensorElementDataType> input_types;
+    std::vector<std::vector<int64_t>> input_shapes;
+    const std::vector<std::string>* output_names;
+    int64_t rows;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::chrono::steady_clock::time_point dequeue_time;  // set with batch_size when the batch is taken
+    size_t batch_size;
+    std::promise<std::vector<Ort::Value>> outputs;
+  };
+
+  void ProcessRequests();
+  std::vector<PendingRequest*> TakeBatch();
+  bool CanBatch(const PendingRequest& first, const PendingRequest& request) const;
+  void RunBatch(const std::vector<PendingRequest*>& batch);
+  std::vector<Ort::Value> RunSingle(PendingRequest& request);
+
+  const Ort::Session& session_;
+  const BatchingOptions options_;
+  Ort::AllocatorWithDefaultOptions allocator_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<PendingRequest*> queue_;  // protected by mutex_
+  size_t queued_rows_ = 0;             // protected by mutex_
+  size_t num_batched_runs_ = 0;        // protected by mutex_
+  bool stopping_ = false;              // protected by mutex_
+  std::thread worker_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -15,6 +15,10 @@ std::string InternalRequestId() {
 }
 const std::string MS_REQUEST_ID_HEADER = "x-ms-request-id";
 const std::string MS_CLIENT_REQUEST_ID_HEADER = "x-ms-client-request-id";
+const std::string MS_PRIORITY_HEADER = "x-ms-priority";
+const std::string MS_REQUEST_TIMEOUT_HEADER = "x-ms-request-timeout-ms";
+// W3C trace context of the caller
+const std::string TRACEPARENT_HEADER = "traceparent";
 }  // namespace util
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
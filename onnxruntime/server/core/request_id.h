@@ -8,6 +8,11 @@ namespace util {
 std::string InternalRequestId();
 extern const std::string MS_REQUEST_ID_HEADER;
 extern const std::string MS_CLIENT_REQUEST_ID_HEADER;
+// Priority of a request when it waits to run: low, normal or high
+extern const std::string MS_PRIORITY_HEADER;
+// Milliseconds the client waits for the response of a request over HTTP. GRPC requests use the deadline of the call.
+extern const std::string MS_REQUEST_TIMEOUT_HEADER;
+extern const std::string TRACEPARENT_HEADER;
 }  // namespace util
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
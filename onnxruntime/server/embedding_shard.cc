@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "embedding_shard.h"
+
+#include <fstream>
+
+namespace onnxruntime {
+namespace server {
+
+EmbeddingShard::EmbeddingShard(const EmbeddingShardOptions& options)
+    : table_(options.table), first_row_(options.first_row), row_size_(options.row_size) {
+  Validate();
+
+  std::ifstream file(options.path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw Ort::Exception("Can't open the shard of table " + table_ + " at " + options.path, ORT_NO_SUCHFILE);
+  }
+
+  const auto bytes = static_cast<uint64_t>(file.tellg());
+  const uint64_t row_bytes = static_cast<uint64_t>(row_size_) * sizeof(float);
+  if (bytes % row_bytes != 0) {
+    throw Ort::Exception("The shard of table " + table_ + " at " + options.path + " has " + std::to_string(bytes) +
+                             " bytes, which isn't a whole number of rows of " + std::to_string(row_size_) + " floats",
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  row_count_ = static_cast<int64_t>(bytes / row_bytes);
+  values_.resize(static_cast<size_t>(bytes / sizeof(float)));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(values_.data()), static_cast<std::streamsize>(bytes))) {
+    throw Ort::Exception("Reading the shard of table " + table_ + " at " + options.path + " failed", ORT_FAIL);
+  }
+}
+
+EmbeddingShard::EmbeddingShard(const std::string& table, int64_t first_row, int64_t row_size,
+                               std::vector<float>&& values)
+    : table_(table), first_row_(first_row), row_size_(row_size), values_(std::move(values)) {
+  Validate();
+  if (values_.size() % static_cast<size_t>(row_size_) != 0) {
+    throw Ort::Exception("The shard of table " + table_ + " doesn't hold whole rows", ORT_INVALID_ARGUMENT);
+  }
+  row_count_ = static_cast<int64_t>(values_.size()) / row_size_;
+}
+
+void EmbeddingShard::Validate() const {
+  if (table_.empty() || first_row_ < 0 || row_size_ <= 0) {
+    throw Ort::Exception("An embedding shard needs a table name, a first row that isn't negative and a positive row size",
+                         ORT_INVALID_ARGUMENT);
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
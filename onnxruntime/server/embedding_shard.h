@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct EmbeddingShardOptions {
+  // Name of the table the models look it up by, the table attribute of their RemoteGather nodes.
+  std::string table;
+  // Index in the whole table of the first row of the shard.
+  int64_t first_row = 0;
+  // Number of values of a row.
+  int64_t row_size = 0;
+  // File of the rows: row_size float values per row, in row-major order and little endian.
+  std::string path;
+};
+
+/**
+ * A range of rows of an embedding table too large to be held by one server. The server holding it serves its rows
+ * to the models of other servers through the EmbeddingService, which look them up with RemoteGather nodes in place
+ * of the Gather nodes of the table (see RemoteEmbeddingTable).
+ */
+class EmbeddingShard {
+ public:
+  // Reads the rows of options.path. Throws Ort::Exception if it can't be read or doesn't hold whole rows.
+  explicit EmbeddingShard(const EmbeddingShardOptions& options);
+  EmbeddingShard(const std::string& table, int64_t first_row, int64_t row_size, std::vector<float>&& values);
+  EmbeddingShard(const EmbeddingShard&) = delete;
+  EmbeddingShard& operator=(const EmbeddingShard&) = delete;
+
+  const std::string& Table() const { return table_; }
+  int64_t FirstRow() const { return first_row_; }
+  int64_t RowCount() const { return row_count_; }
+  int64_t RowSize() const { return row_size_; }
+
+  // The values of row, an index in the whole table, or nullptr if it isn't in the shard.
+  const float* Row(int64_t row) const {
+    return row < first_row_ || row - first_row_ >= row_count_ ? nullptr
+                                                              : values_.data() + (row - first_row_) * row_size_;
+  }
+
+ private:
+  void Validate() const;
+
+  std::string table_;
+  int64_t first_row_;
+  int64_t row_size_;
+  int64_t row_count_ = 0;
+  std::vector<float> values_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -32,32 +32,96 @@ void ORT_API_CALL Log(void* param, OrtLoggingLevel severity, const char* categor
   return;
 }
 
-ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink) : severity_(severity),
-                                                                                               logger_id_("ServerApp"),
-                                                                                               sink_(sink),
-                                                                                               default_logger_(std::make_shared<spdlog::logger>(logger_id_, sink)),
-                                                                                               runtime_environment_(severity, logger_id_.c_str(), Log, default_logger_.get()),
-                                                                                               session(nullptr) {
+ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink, size_t log_queue_size)
+    : severity_(severity),
+      logger_id_("ServerApp"),
+      sink_(sink),
+      log_thread_pool_(log_queue_size == 0 ? nullptr : std::make_shared<spdlog::details::thread_pool>(log_queue_size, 1)),
+      default_logger_(std::make_shared<spdlog::logger>(logger_id_, sink)),
+      runtime_environment_(severity, logger_id_.c_str(), Log, default_logger_.get(), -1, 0),
+      model_repository_(runtime_environment_, default_logger_) {
   spdlog::set_automatic_registration(false);
   spdlog::set_level(Convert(severity_));
   spdlog::initialize_logger(default_logger_);
+  if (log_queue_size != 0) {
+    runtime_environment_.EnableAsyncLogging(log_queue_size);
+  }
+}
+
+void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name,
+                                        const std::string& model_version) {
+  model_repository_.LoadModel(model_name, model_version, model_path);
+  default_model_name_ = model_name;
+  default_model_version_ = model_version;
+}
+
+void ServerEnvironment::EnableBatching(const BatchingOptions& options) {
+  model_repository_.EnableBatching(options);
+}
+
+void ServerEnvironment::EnableAdmissionControl(const AdmissionOptions& options) {
+  model_repository_.EnableAdmissionControl(options);
+}
+
+void ServerEnvironment::SetReplicaDevices(const std::vector<ReplicaDevice>& devices) {
+  model_repository_.SetReplicaDevices(devices);
+}
+
+void ServerEnvironment::EnableResponseCache(const ResponseCacheOptions& options) {
+  model_repository_.EnableResponseCache(options);
+}
+
+void ServerEnvironment::EnableRemoteEmbeddings(const std::shared_ptr<RemoteEmbeddingTables>& tables) {
+  model_repository_.EnableRemoteEmbeddings(tables);
+}
+
+void ServerEnvironment::AddEmbeddingShard(std::unique_ptr<EmbeddingShard> shard) {
+  const auto table = shard->Table();
+  if (!embedding_shards_.emplace(table, std::move(shard)).second) {
+    throw Ort::Exception("The server already has a shard of table " + table, ORT_INVALID_ARGUMENT);
+  }
+}
+
+const EmbeddingShard* ServerEnvironment::GetEmbeddingShard(const std::string& table) const {
+  auto match = embedding_shards_.find(table);
+  return match == embedding_shards_.end() ? nullptr : match->second.get();
+}
+
+void ServerEnvironment::EnableSharedMemory() {
+  shared_memory_enabled_ = true;
 }
 
-void ServerEnvironment::InitializeModel(const std::string& model_path) {
-  session = Ort::Session(runtime_environment_, model_path.c_str(), Ort::SessionOptions());
+bool ServerEnvironment::IsSharedMemoryEnabled() const {
+  return shared_memory_enabled_;
+}
 
-  auto output_count = session.GetOutputCount();
+SharedMemoryRegistry& ServerEnvironment::GetSharedMemory() {
+  return shared_memory_;
+}
 
-  Ort::AllocatorWithDefaultOptions allocator;
-  for (size_t i = 0; i < output_count; i++) {
-    auto name = session.GetOutputName(i, allocator);
-    model_output_names_.push_back(name);
-    allocator.Free(name);
+void ServerEnvironment::EnableTracing(std::unique_ptr<SpanExporter> exporter) {
+  tracer_ = std::make_unique<RequestTracer>(std::move(exporter));
+  model_repository_.EnableTracing(tracer_.get());
+}
+
+RequestTracer* ServerEnvironment::GetTracer() const {
+  return tracer_.get();
+}
+
+ModelRepository& ServerEnvironment::GetModelRepository() {
+  return model_repository_;
+}
+
+std::shared_ptr<ServedModel> ServerEnvironment::GetModel(const std::string& name, const std::string& version) const {
+  auto model = model_repository_.GetModel(name.empty() ? default_model_name_ : name, version);
+  if (model == nullptr) {
+    model = model_repository_.GetSingleModel();
   }
+  return model;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames() const {
-  return model_output_names_;
+ServerMetrics& ServerEnvironment::GetMetrics() {
+  return metrics_;
 }
 
 OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
@@ -65,11 +129,21 @@ OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
 }
 
 const Ort::Session& ServerEnvironment::GetSession() const {
-  return session;
+  auto model = model_repository_.GetModel(default_model_name_, default_model_version_);
+  if (model == nullptr) {
+    throw Ort::Exception("The default model isn't loaded", ORT_FAIL);
+  }
+  return model->replicas.front()->session;
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
-  auto logger = std::make_shared<spdlog::logger>(request_id, sink_.begin(), sink_.end());
+  std::shared_ptr<spdlog::logger> logger;
+  if (log_thread_pool_ != nullptr) {
+    logger = std::make_shared<spdlog::async_logger>(request_id, sink_.begin(), sink_.end(), log_thread_pool_,
+                                                    spdlog::async_overflow_policy::overrun_oldest);
+  } else {
+    logger = std::make_shared<spdlog::logger>(request_id, sink_.begin(), sink_.end());
+  }
   spdlog::initialize_logger(logger);
   return logger;
 }
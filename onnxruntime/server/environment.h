@@ -3,26 +3,79 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "core/session/onnxruntime_cxx_api.h"
+#include <spdlog/async.h>
 #include <spdlog/spdlog.h>
 
+#include "embedding_shard.h"
+#include "metrics.h"
+#include "model_repository.h"
+#include "shared_memory.h"
+#include "tracing.h"
+
 namespace onnxruntime {
 namespace server {
 
 class ServerEnvironment {
  public:
-  explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
+  // With a log_queue_size, the messages of the requests and of the runtime wait in queues of that many messages for
+  // background threads to format and write them, so the requests don't wait for the sinks. The oldest messages of
+  // the requests are overwritten when their queue is full, and newer messages of the runtime are dropped.
+  explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink, size_t log_queue_size = 0);
   ~ServerEnvironment() = default;
   ServerEnvironment(const ServerEnvironment&) = delete;
 
   OrtLoggingLevel GetLogSeverity() const;
 
+  // The session of the first replica of the default model. It's only valid until the default model is reloaded or unloaded.
   const Ort::Session& GetSession() const;
-  void InitializeModel(const std::string& model_path);
-  const std::vector<std::string>& GetModelOutputNames() const;
+  // Loads the default model, the one requests that don't name a model are run with.
+  void InitializeModel(const std::string& model_path, const std::string& model_name = "default",
+                       const std::string& model_version = "1");
+
+  // Batches the concurrent requests for the models loaded after this call.
+  void EnableBatching(const BatchingOptions& options);
+  // Bounds the concurrent requests for the models loaded after this call.
+  void EnableAdmissionControl(const AdmissionOptions& options);
+  // Runs the models loaded after this call with a replica on each of devices.
+  void SetReplicaDevices(const std::vector<ReplicaDevice>& devices);
+  // Caches the outputs of the requests for the models loaded after this call. Only for deterministic models.
+  void EnableResponseCache(const ResponseCacheOptions& options);
+
+  // Looks up the RemoteGather nodes of the models loaded after this call in tables.
+  void EnableRemoteEmbeddings(const std::shared_ptr<RemoteEmbeddingTables>& tables);
+
+  // Serves the rows of shard to the RemoteGather nodes of other servers. Must be called before the server starts.
+  // Throws Ort::Exception if the server already has a shard of the table.
+  void AddEmbeddingShard(std::unique_ptr<EmbeddingShard> shard);
+  // The shard of table held by the server, or nullptr if there's none.
+  const EmbeddingShard* GetEmbeddingShard(const std::string& table) const;
+
+  // Lets local clients register shared memory regions that requests read their inputs from and write their
+  // outputs to. Must be called before the server starts.
+  void EnableSharedMemory();
+  bool IsSharedMemoryEnabled() const;
+  SharedMemoryRegistry& GetSharedMemory();
+
+  // Traces the requests and the runs of the models loaded after this call, and exports their spans to exporter.
+  // Must be called before the server starts.
+  void EnableTracing(std::unique_ptr<SpanExporter> exporter);
+  // nullptr if the requests aren't traced.
+  RequestTracer* GetTracer() const;
+
+  ModelRepository& GetModelRepository();
+  // The model a request is run with: the given version, or the latest one if version is empty, of the named model,
+  // or of the default model if name is empty. When a single model is served, it serves the requests for any name.
+  // nullptr if there's no such model.
+  std::shared_ptr<ServedModel> GetModel(const std::string& name, const std::string& version) const;
+
+  ServerMetrics& GetMetrics();
+
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
 
@@ -30,12 +83,20 @@ class ServerEnvironment {
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
   const std::vector<spdlog::sink_ptr> sink_;
+  // writes the messages of the loggers of the requests if they are asynchronous, nullptr otherwise
+  const std::shared_ptr<spdlog::details::thread_pool> log_thread_pool_;
   const std::shared_ptr<spdlog::logger> default_logger_;
 
   Ort::Env runtime_environment_;
-  Ort::SessionOptions options_;
-  Ort::Session session;
-  std::vector<std::string> model_output_names_;
+  // declared before the models, whose sessions report the spans of their runs to it
+  std::unique_ptr<RequestTracer> tracer_;
+  ModelRepository model_repository_;
+  std::string default_model_name_;
+  std::string default_model_version_;
+  ServerMetrics metrics_;
+  std::map<std::string, std::unique_ptr<EmbeddingShard>> embedding_shards_;
+  bool shared_memory_enabled_ = false;
+  SharedMemoryRegistry shared_memory_;
 };
 
 }  // namespace server
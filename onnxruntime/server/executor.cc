@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <stdio.h>
+#include <algorithm>
 #include "core/common/logging/logging.h"
 #include "core/framework/data_types.h"
 #include "core/session/environment.h"
@@ -23,11 +24,105 @@ namespace server {
 
 namespace protobufutil = google::protobuf::util;
 
+Executor::Executor(ServerEnvironment* server_env, std::string request_id)
+    : env_(server_env),
+      request_id_(std::move(request_id)),
+      using_raw_data_(true),
+      tracer_(server_env->GetTracer()) {
+  if (tracer_ != nullptr) {
+    trace_context_.trace_id = TraceIdFromRequestId(request_id_);
+    span_id_ = NewSpanId();
+    start_time_ = std::chrono::steady_clock::now();
+  }
+}
+
+Executor::~Executor() {
+  if (tracer_ != nullptr) {
+    ExportSpans();
+  }
+
+  if (metrics_ == nullptr || !succeeded_) {
+    return;
+  }
+
+  metrics_->ObservePhase(RequestPhase::Decode, decode_time_);
+  if (!cached_) {
+    metrics_->ObservePhase(RequestPhase::Queue, queue_time_);
+    metrics_->ObservePhase(RequestPhase::Run, run_time_);
+  }
+  metrics_->ObservePhase(RequestPhase::Encode, encode_time_);
+}
+
+void Executor::SetTraceParent(const std::string& traceparent) {
+  if (tracer_ != nullptr && !traceparent.empty() && !ParseTraceParent(traceparent, trace_context_)) {
+    Logger()->warn("Ignoring the malformed traceparent {}", traceparent);
+  }
+}
+
+const std::shared_ptr<spdlog::logger>& Executor::Logger() {
+  if (logger_ == nullptr) {
+    logger_ = env_->GetLogger(request_id_);
+  }
+  return logger_;
+}
+
+void Executor::AddPhaseSpan(const char* name, std::chrono::steady_clock::time_point start,
+                            std::chrono::steady_clock::time_point end, std::string span_id) {
+  if (tracer_ == nullptr) {
+    return;
+  }
+  TraceSpan span;
+  span.span_id = span_id.empty() ? NewSpanId() : std::move(span_id);
+  span.name = name;
+  span.start_time_ns = ToUnixNanoseconds(start);
+  span.end_time_ns = ToUnixNanoseconds(end);
+  phase_spans_.push_back(std::move(span));
+}
+
+void Executor::ExportSpans() {
+  TraceSpan request_span;
+  request_span.trace_id = trace_context_.trace_id;
+  request_span.span_id = span_id_;
+  request_span.parent_span_id = trace_context_.parent_span_id;
+  request_span.name = "onnxruntime_server.predict";
+  request_span.start_time_ns = ToUnixNanoseconds(start_time_);
+  request_span.end_time_ns = ToUnixNanoseconds(std::chrono::steady_clock::now());
+  request_span.attributes.emplace_back("onnxruntime_server.request_id", request_id_);
+  if (!model_name_.empty()) {
+    request_span.attributes.emplace_back("onnxruntime_server.model_name", model_name_);
+    request_span.attributes.emplace_back("onnxruntime_server.model_version", model_version_);
+  }
+  if (cached_) {
+    request_span.attributes.emplace_back("onnxruntime_server.cached", "true");
+  }
+  if (!succeeded_) {
+    request_span.error = true;
+    request_span.status_message = "The request failed";
+  }
+
+  for (auto& span : phase_spans_) {
+    span.trace_id = trace_context_.trace_id;
+    span.parent_span_id = span_id_;
+    tracer_->Export(std::move(span));
+  }
+  tracer_->Export(std::move(request_span));
+}
+
 protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           MemBufferArray& buffers,
                                           OrtMemoryInfo* cpu_allocator_info,
                                           /* out */ Ort::Value& ml_value) {
-  auto logger = env_->GetLogger(request_id_);
+  const auto& logger = Logger();
+
+  // raw_data that can be used as is is borrowed from the request, which outlives the run
+  try {
+    if (onnxruntime::server::TryWrapRawData(input_tensor, *cpu_allocator_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TryWrapRawData() failed. Error Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
 
   size_t cpu_tensor_length = 0;
   try {
@@ -51,11 +146,69 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
   return protobufutil::Status::OK;
 }
 
+protobufutil::Status Executor::WrapSharedMemoryTensor(const std::string& name,
+                                                      const onnxruntime::server::SharedMemoryTensor& tensor,
+                                                      /* out */ Ort::Value& ml_value) {
+  auto region = env_->GetSharedMemory().Get(tensor.region());
+  if (region == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Shared memory region " + tensor.region() + " of " + name + " isn't registered");
+  }
+  if (tensor.data_type() == onnx::TensorProto_DataType_UNDEFINED ||
+      tensor.data_type() == onnx::TensorProto_DataType_STRING) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Shared memory tensor " + name + " must have a numeric or bool data type");
+  }
+
+  std::vector<int64_t> shape{tensor.dims().begin(), tensor.dims().end()};
+  size_t element_count = 1;
+  for (auto dim : shape) {
+    if (dim < 0) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Shared memory tensor " + name + " has a negative dimension");
+    }
+    element_count *= static_cast<size_t>(dim);
+  }
+
+  // the size is computed like that of a tensor proto of the same type and shape
+  onnx::TensorProto shape_proto;
+  shape_proto.set_data_type(tensor.data_type());
+  *shape_proto.mutable_dims() = tensor.dims();
+  size_t byte_size = 0;
+  try {
+    onnxruntime::server::GetSizeInBytesFromTensorProto<0>(shape_proto, &byte_size);
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
+  void* data = region->Data(tensor.offset(), byte_size);
+  if (data == nullptr) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Shared memory tensor " + name + " of " + std::to_string(byte_size) +
+                                    " bytes at offset " + std::to_string(tensor.offset()) +
+                                    " isn't in region " + tensor.region());
+  }
+  if (element_count != 0 && reinterpret_cast<uintptr_t>(data) % (byte_size / element_count) != 0) {
+    return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                "Shared memory tensor " + name + " isn't aligned to the size of its elements");
+  }
+
+  try {
+    auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    ml_value = Ort::Value::CreateTensor(memory_info, data, byte_size, shape.data(), shape.size(),
+                                        static_cast<ONNXTensorElementDataType>(tensor.data_type()));
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+  shared_memory_regions_.push_back(std::move(region));
+  return protobufutil::Status::OK;
+}
+
 protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input_names,
                                                  std::vector<Ort::Value>& input_values,
                                                  const onnxruntime::server::PredictRequest& request,
                                                  MemBufferArray& buffers) {
-  auto logger = env_->GetLogger(request_id_);
+  const auto& logger = Logger();
 
   OrtMemoryInfo* allocator_info = nullptr;
   auto ort_status = OrtCreateCpuAllocatorInfo(OrtArenaAllocator, OrtMemTypeDefault, &allocator_info);
@@ -82,10 +235,31 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   }
 
   OrtReleaseMemoryInfo(allocator_info);
+
+  // the inputs in shared memory are run with values over their regions, so they aren't copied
+  for (const auto& input : request.shared_memory_inputs()) {
+    if (request.inputs().count(input.first) != 0) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Input " + input.first + " is both in inputs and in shared_memory_inputs");
+    }
+
+    Ort::Value ml_value{nullptr};
+    auto status = WrapSharedMemoryTensor(input.first, input.second, ml_value);
+    if (status != protobufutil::Status::OK) {
+      logger->error("WrapSharedMemoryTensor() failed! Input name: {}", input.first);
+      return status;
+    }
+
+    input_names.push_back(input.first);
+    input_values.push_back(std::move(ml_value));
+  }
+
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+// outputs has an entry per output name. The null ones are set to the outputs allocated by the run, the others are
+// pre-allocated values the run writes into.
+void Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names, /* in, out */ std::vector<Ort::Value>& outputs) {
   size_t input_count = input_names.size();
   size_t output_count = output_names.size();
 
@@ -100,66 +274,203 @@ std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions&
     output_ptrs.push_back(output.data());
   }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), outputs.data(), output_count);
 }
 
 protobufutil::Status Executor::Predict(const std::string& model_name,
                                        const std::string& model_version,
                                        const onnxruntime::server::PredictRequest& request,
                                        /* out */ onnxruntime::server::PredictResponse& response) {
-  auto logger = env_->GetLogger(request_id_);
-
   // Convert PredictRequest to NameMLValMap
   MemBufferArray buffer_array;
   std::vector<std::string> input_names;
   std::vector<Ort::Value> input_values;
+  const auto decode_start = std::chrono::steady_clock::now();
   auto conversion_status = SetNameMLValueMap(input_names, input_values, request, buffer_array);
+  const auto decode_end = std::chrono::steady_clock::now();
+  decode_time_ += decode_end - decode_start;
+  AddPhaseSpan("decode", decode_start, decode_end);
   if (conversion_status != protobufutil::Status::OK) {
     return conversion_status;
   }
 
+  // Prepare the output names
+  std::vector<std::string> output_names;
+  output_names.reserve(request.output_filter_size());
+  for (const auto& name : request.output_filter()) {
+    output_names.push_back(name);
+  }
+
+  for (const auto& output : request.shared_memory_outputs()) {
+    Ort::Value ml_value{nullptr};
+    auto status = WrapSharedMemoryTensor(output.first, output.second, ml_value);
+    if (status != protobufutil::Status::OK) {
+      return status;
+    }
+    shared_memory_outputs_.emplace(output.first, std::move(ml_value));
+  }
+
+  std::vector<Ort::Value> outputs;
+  auto run_status = Run(model_name, model_version, std::move(input_names), std::move(input_values), output_names,
+                        outputs);
+  if (run_status != protobufutil::Status::OK) {
+    return run_status;
+  }
+
+  return BuildResponse(output_names, outputs, response);
+}
+
+protobufutil::Status Executor::Run(const std::string& model_name,
+                                   const std::string& model_version,
+                                   std::vector<std::string> input_names,
+                                   std::vector<Ort::Value> input_values,
+                                   /* in, out */ std::vector<std::string>& output_names,
+                                   /* out */ std::vector<Ort::Value>& outputs) {
+  const auto& logger = Logger();
+
+  // The model is held until the request is done, so it isn't destroyed if it's reloaded or unloaded meanwhile
+  auto model = env_->GetModel(model_name, model_version);
+  if (model == nullptr) {
+    auto message = "Model " + model_name + (model_version.empty() ? "" : " version " + model_version) + " isn't loaded";
+    logger->error(message);
+    return protobufutil::Status(protobufutil::error::Code::NOT_FOUND, message);
+  }
+
   Ort::RunOptions run_options{};
   run_options.SetRunLogVerbosityLevel(static_cast<int>(env_->GetLogSeverity()));
   run_options.SetRunTag(request_id_.c_str());
 
-  // Prepare the output names
-  std::vector<std::string> output_names;
+  if (output_names.empty()) {
+    output_names = model->output_names;
+  }
+  for (const auto& output : shared_memory_outputs_) {
+    if (std::find(output_names.begin(), output_names.end(), output.first) == output_names.end()) {
+      output_names.push_back(output.first);
+    }
+  }
+
+  metrics_ = &env_->GetMetrics().GetModelMetrics(model->name, model->version);
+  model_name_ = model->name;
+  model_version_ = model->version;
+  ++metrics_->requests;
 
-  if (!request.output_filter().empty()) {
-    output_names.reserve(request.output_filter_size());
-    for (const auto& name : request.output_filter()) {
-      output_names.push_back(name);
+  // A cache hit skips the queue and the run
+  std::string cache_key;
+  // the outputs written to shared memory aren't cached, since a hit wouldn't write them
+  if (model->cache != nullptr && shared_memory_outputs_.empty()) {
+    try {
+      cached_ = ResponseCache::MakeKey(input_names, input_values, output_names, cache_key) &&
+                model->cache->Lookup(cache_key, outputs);
+    } catch (const Ort::Exception& e) {
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
+    if (cached_) {
+      ++metrics_->cache_hits;
+      succeeded_ = true;
+      return protobufutil::Status::OK;
     }
-  } else {
-    output_names = env_->GetModelOutputNames();
   }
 
-  std::vector<Ort::Value> outputs;
+  // Held until the run is done, when the next queued request is admitted
+  AdmissionController::Slot slot;
+  if (model->admission != nullptr) {
+    const auto admission_start = std::chrono::steady_clock::now();
+    auto status = model->admission->Admit(priority_, deadline_, slot);
+    if (!status.ok()) {
+      ++metrics_->rejections;
+      logger->warn("Request rejected: {}", status.error_message());
+      return status;
+    }
+    const auto admission_end = std::chrono::steady_clock::now();
+    queue_time_ = admission_end - admission_start;
+    AddPhaseSpan("queue", admission_start, admission_end);
+  }
+
+  if (deadline_ != std::chrono::steady_clock::time_point::max()) {
+    const auto remaining = deadline_ - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+      ++metrics_->rejections;
+      return protobufutil::Status(protobufutil::error::Code::DEADLINE_EXCEEDED,
+                                  "The deadline of the request passed before it was run");
+    }
+    // rounded up, a timeout of 0 would disable it
+    run_options.SetRunTimeout(std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count() + 1);
+  }
+
+  ++metrics_->in_flight;
+  ReplicaLease lease(model->LeastLoadedReplica());
+  auto& replica = lease.replica();
+  const auto run_start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration batch_queue_time{};
+  // the spans the session reports for the run are children of its span. A batched run is tagged with the first
+  // request of the batch, so its spans are only part of the trace of that request.
+  const auto run_span_id = tracer_ != nullptr ? NewSpanId() : std::string{};
+  TracedRunScope traced_run(tracer_, request_id_, trace_context_.trace_id, run_span_id);
   try {
-    outputs = Run(env_->GetSession(), run_options, input_names, input_values, output_names);
+    if (replica.batcher != nullptr && shared_memory_outputs_.empty()) {
+      BatchedRunStats stats;
+      outputs = replica.batcher->Run(run_options, std::move(input_names), std::move(input_values), output_names,
+                                     &stats);
+      batch_queue_time = stats.queue_time;
+      metrics_->batch_size.Observe(static_cast<double>(stats.batch_size));
+    } else {
+      // the outputs written to shared memory are pre-allocated over their regions, the run allocates the others
+      std::vector<Ort::Value> run_outputs;
+      for (const auto& name : output_names) {
+        auto match = shared_memory_outputs_.find(name);
+        run_outputs.push_back(match == shared_memory_outputs_.end() ? Ort::Value{nullptr} : std::move(match->second));
+      }
+      server::Run(replica.session, run_options, input_names, input_values, output_names, run_outputs);
+      outputs = std::move(run_outputs);
+    }
+    if (!cache_key.empty()) {
+      model->cache->Insert(cache_key, outputs);
+    }
   } catch (const Ort::Exception& e) {
+    --metrics_->in_flight;
+    ++metrics_->failures;
+    AddPhaseSpan("run", run_start, std::chrono::steady_clock::now(), run_span_id);
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
+  --metrics_->in_flight;
+  AddPhaseSpan("run", run_start, std::chrono::steady_clock::now(), run_span_id);
+  queue_time_ += batch_queue_time;
+  run_time_ = std::chrono::steady_clock::now() - run_start - batch_queue_time;
+  succeeded_ = true;
 
-  // Build the response
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status Executor::BuildResponse(const std::vector<std::string>& output_names,
+                                             std::vector<Ort::Value>& outputs,
+                                             /* out */ onnxruntime::server::PredictResponse& response) {
+  const auto& logger = Logger();
+  const auto encode_start = std::chrono::steady_clock::now();
+
+  // The output tensors are written in place in the response, so they aren't copied again.
+  auto& response_outputs = *response.mutable_outputs();
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
-    try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
-    } catch (const Ort::Exception& e) {
-      logger = env_->GetLogger(request_id_);
-      logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
-      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    // already written to its region
+    if (shared_memory_outputs_.count(output_names[i]) != 0) {
+      continue;
     }
 
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
+    if (response_outputs.count(output_names[i]) != 0) {
       logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
       return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
     }
+
+    try {
+      MLValueToTensorProto(outputs[i], using_raw_data_, logger, response_outputs[output_names[i]]);
+    } catch (const Ort::Exception& e) {
+      logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
+      return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    }
   }
 
+  const auto encode_end = std::chrono::steady_clock::now();
+  encode_time_ += encode_end - encode_start;
+  AddPhaseSpan("encode", encode_start, encode_end);
   return protobufutil::Status::OK;
 }
 
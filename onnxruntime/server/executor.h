@@ -3,10 +3,16 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
+#include <memory>
+
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
 #include "predict.pb.h"
+#include "shared_memory.h"
+#include "tracing.h"
 #include "util.h"
 #include "core/session/onnxruntime_cxx_api.h"
 
@@ -15,9 +21,12 @@ namespace server {
 
 class Executor {
  public:
-  Executor(ServerEnvironment* server_env, std::string request_id) : env_(server_env),
-                                                                    request_id_(std::move(request_id)),
-                                                                    using_raw_data_(true) {}
+  Executor(ServerEnvironment* server_env, std::string request_id);
+  // Records the latencies of the phases of the request with the metrics of the model it was run with, if its run
+  // succeeded, and exports the spans of the request if it's traced.
+  ~Executor();
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
 
   // Prediction method
   google::protobuf::util::Status Predict(const std::string& model_name,
@@ -25,16 +34,83 @@ class Executor {
                                          const onnxruntime::server::PredictRequest& request,
                                          /* out */ onnxruntime::server::PredictResponse& response);
 
+  // Runs the model with inputs that are already values, e.g. decoded in place from a binary payload.
+  // All the outputs of the model are returned if output_names is empty, in which case it's set to their names.
+  google::protobuf::util::Status Run(const std::string& model_name,
+                                     const std::string& model_version,
+                                     std::vector<std::string> input_names,
+                                     std::vector<Ort::Value> input_values,
+                                     /* in, out */ std::vector<std::string>& output_names,
+                                     /* out */ std::vector<Ort::Value>& outputs);
+
+  // Writes the outputs of Run into response.
+  google::protobuf::util::Status BuildResponse(const std::vector<std::string>& output_names,
+                                               std::vector<Ort::Value>& outputs,
+                                               /* out */ onnxruntime::server::PredictResponse& response);
+
+  // Time the caller spent decoding the request before it was run, or encoding the response after it was built,
+  // e.g. parsing or serializing the payload. It's added to the phases the executor measures itself.
+  void AddDecodeTime(std::chrono::steady_clock::duration time) { decode_time_ += time; }
+  void AddEncodeTime(std::chrono::steady_clock::duration time) { encode_time_ += time; }
+
+  // The priority of the request when it waits to be admitted, Normal by default.
+  void SetPriority(RequestPriority priority) { priority_ = priority; }
+  // The time by which the request must be done. It bounds the wait to be admitted and the run, which fail with
+  // DEADLINE_EXCEEDED and a run timeout when it passes. No deadline by default.
+  void SetDeadline(std::chrono::steady_clock::time_point deadline) { deadline_ = deadline; }
+  // The W3C traceparent header of the caller, whose trace the spans of the request are part of when the server
+  // traces the requests. Without one, or if it's malformed, the request starts a trace whose id is its request id.
+  void SetTraceParent(const std::string& traceparent);
+
  private:
   ServerEnvironment* env_;
   const std::string request_id_;
   bool using_raw_data_;
+  RequestPriority priority_ = RequestPriority::Normal;
+  std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+
+  // The regions of the shared memory tensors of the request, held until it's done.
+  std::vector<std::shared_ptr<SharedMemoryRegion>> shared_memory_regions_;
+  // The outputs of the request written to shared memory, pre-allocated over their regions. The values are moved
+  // to the outputs of the run.
+  std::map<std::string, Ort::Value> shared_memory_outputs_;
+
+  ModelMetrics* metrics_ = nullptr;  // of the model the request was run with, once Run found it
+  bool succeeded_ = false;
+  bool cached_ = false;  // the outputs came from the response cache, so there was no queue or run
+  std::chrono::steady_clock::duration decode_time_{};
+  std::chrono::steady_clock::duration queue_time_{};
+  std::chrono::steady_clock::duration run_time_{};
+  std::chrono::steady_clock::duration encode_time_{};
+
+  // The tracing of the request, if the server traces the requests.
+  RequestTracer* tracer_;
+  TraceContext trace_context_;
+  std::string span_id_;  // of the span of the request
+  std::chrono::steady_clock::time_point start_time_;
+  std::string model_name_;  // the model and version the request was run with
+  std::string model_version_;
+  std::vector<TraceSpan> phase_spans_;
+
+  // A span of a phase of the request, child of its span, exported with it.
+  void AddPhaseSpan(const char* name, std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end, std::string span_id = {});
+  void ExportSpans();
+
+  // The logger of the request, created the first time it's needed rather than by every step that may log.
+  const std::shared_ptr<spdlog::logger>& Logger();
+  std::shared_ptr<spdlog::logger> logger_;
 
   google::protobuf::util::Status SetMLValue(const onnx::TensorProto& input_tensor,
                                             MemBufferArray& buffers,
                                             OrtMemoryInfo* cpu_allocator_info,
                                             /* out */ Ort::Value& ml_value);
 
+  // Wraps a tensor of a shared memory region in a value without copying it.
+  google::protobuf::util::Status WrapSharedMemoryTensor(const std::string& name,
+                                                        const onnxruntime::server::SharedMemoryTensor& tensor,
+                                                        /* out */ Ort::Value& ml_value);
+
   google::protobuf::util::Status SetNameMLValueMap(/* out */ std::vector<std::string>& input_names,
                                                    /* out */ std::vector<Ort::Value>& input_values,
                                                    const onnxruntime::server::PredictRequest& request,
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "embedding_client.h"
+#include "embedding_service.grpc.pb.h"
+#include <grpcpp/grpcpp.h>
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+EmbeddingRowFetcher CreateEmbeddingRowFetcher(const RemoteEmbeddingShard& shard) {
+  // a stub is thread safe, and the concurrent calls of a channel are multiplexed on its connection
+  std::shared_ptr<EmbeddingService::Stub> stub =
+      EmbeddingService::NewStub(::grpc::CreateChannel(shard.address, ::grpc::InsecureChannelCredentials()));
+  const std::string address = shard.address;
+
+  return [stub, address](const std::string& table, const std::vector<int64_t>& rows, std::vector<float>& values) {
+    LookupRowsRequest request;
+    request.set_table(table);
+    request.mutable_rows()->Reserve(static_cast<int>(rows.size()));
+    for (auto row : rows) {
+      request.add_rows(row);
+    }
+
+    LookupRowsResponse response;
+    ::grpc::ClientContext context;
+    auto status = stub->LookupRows(&context, request, &response);
+    if (!status.ok()) {
+      throw Ort::Exception("Looking up rows of table " + table + " at " + address + " failed: " +
+                               status.error_message(),
+                           ORT_FAIL);
+    }
+
+    const auto& data = response.values().raw_data();
+    if (response.values().data_type() != onnx::TensorProto_DataType_FLOAT || data.size() % sizeof(float) != 0) {
+      throw Ort::Exception("The rows of table " + table + " from " + address + " aren't floats in raw data",
+                           ORT_FAIL);
+    }
+    values.resize(data.size() / sizeof(float));
+    std::memcpy(values.data(), data.data(), data.size());
+  };
+}
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
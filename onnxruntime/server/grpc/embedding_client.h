@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "remote_embedding.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+// Fetches rows from the EmbeddingService of the server holding shard. The fetches from a shard share a channel.
+EmbeddingRowFetcher CreateEmbeddingRowFetcher(const RemoteEmbeddingShard& shard);
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
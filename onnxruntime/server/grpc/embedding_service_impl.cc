@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "embedding_service_impl.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+
+EmbeddingServiceImpl::EmbeddingServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
+
+::grpc::Status EmbeddingServiceImpl::LookupRows(::grpc::ServerContext* /*context*/, const ::onnxruntime::server::LookupRowsRequest* request, ::onnxruntime::server::LookupRowsResponse* response) {
+  const auto* shard = environment_->GetEmbeddingShard(request->table());
+  if (shard == nullptr) {
+    return ::grpc::Status(::grpc::StatusCode::NOT_FOUND, "The server has no shard of table " + request->table());
+  }
+
+  const size_t row_bytes = static_cast<size_t>(shard->RowSize()) * sizeof(float);
+  auto& values = *response->mutable_values();
+  values.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  values.add_dims(request->rows_size());
+  values.add_dims(shard->RowSize());
+  auto& data = *values.mutable_raw_data();
+  data.resize(request->rows_size() * row_bytes);
+  for (int i = 0; i < request->rows_size(); ++i) {
+    const float* row = shard->Row(request->rows(i));
+    if (row == nullptr) {
+      return ::grpc::Status(::grpc::StatusCode::OUT_OF_RANGE,
+                            "Row " + std::to_string(request->rows(i)) + " isn't in the shard of table " +
+                                request->table() + ", which holds the rows from " +
+                                std::to_string(shard->FirstRow()) + " to " +
+                                std::to_string(shard->FirstRow() + shard->RowCount() - 1));
+    }
+    std::memcpy(&data[i * row_bytes], row, row_bytes);
+  }
+  return ::grpc::Status::OK;
+}
+
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "embedding_service.grpc.pb.h"
+#include "environment.h"
+#include <grpcpp/grpcpp.h>
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+// Serves the rows of the embedding shards of the environment.
+class EmbeddingServiceImpl final : public onnxruntime::server::EmbeddingService::Service {
+ public:
+  EmbeddingServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
+  ::grpc::Status LookupRows(::grpc::ServerContext* context, const ::onnxruntime::server::LookupRowsRequest* request, ::onnxruntime::server::LookupRowsResponse* response);
+
+ private:
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
+};
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
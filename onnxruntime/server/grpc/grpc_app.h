@@ -1,6 +1,7 @@
 #pragma once
 #include <grpcpp/grpcpp.h>
 #include "prediction_service_impl.h"
+#include "embedding_service_impl.h"
 #include "environment.h"
 
 namespace onnxruntime {
@@ -19,6 +20,7 @@ class GRPCApp {
 
  private:
   grpc::PredictionServiceImpl prediction_service_implementation_;
+  grpc::EmbeddingServiceImpl embedding_service_implementation_;
   std::unique_ptr<::grpc::Server> server_;
 };
 }  // namespace server
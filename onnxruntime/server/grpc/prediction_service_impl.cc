@@ -1,23 +1,221 @@
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
 #include "prediction_service_impl.h"
 #include "request_id.h"
+#include "util.h"
 
 namespace onnxruntime {
 namespace server {
 namespace grpc {
 
+// Largest number of requests of a stream that run at the same time. Reading the stream waits while there are as
+// many requests whose responses haven't been written.
+static constexpr size_t kMaxStreamInFlightRequests = 32;
+
 PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env) : environment_(env) {}
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
+  RequestPriority priority;
+  std::chrono::steady_clock::time_point deadline;
+  auto admission_status = GetAdmission(context, priority, deadline);
+  if (!admission_status.ok()) {
+    return admission_status;
+  }
+  if (!request->shared_memory_inputs().empty() || !request->shared_memory_outputs().empty()) {
+    auto access_status = CheckSharedMemoryAccess(context);
+    if (!access_status.ok()) {
+      return access_status;
+    }
+  }
+
   onnxruntime::server::Executor executor(environment_.get(), request_id);
+  executor.SetPriority(priority);
+  executor.SetDeadline(deadline);
+  executor.SetTraceParent(GetTraceParent(context));
   //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  auto status = executor.Predict("", "", *request, *response);  // No model spec yet, so run the default model.
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
   return ::grpc::Status::OK;
 }
 
+::grpc::Status PredictionServiceImpl::PredictStream(::grpc::ServerContext* context, ::grpc::ServerReaderWriter<::onnxruntime::server::PredictResponse, ::onnxruntime::server::PredictRequest>* stream) {
+  return ProcessPredictStream(context, stream);
+}
+
+::grpc::Status PredictionServiceImpl::ProcessPredictStream(
+    ::grpc::ServerContext* context,
+    ::grpc::ServerReaderWriterInterface<::onnxruntime::server::PredictResponse,
+                                        ::onnxruntime::server::PredictRequest>* stream) {
+  auto stream_id = SetRequestContext(context);
+  auto logger = environment_->GetLogger(stream_id);
+  // all the requests of the stream share its priority, deadline and trace context
+  const auto traceparent = GetTraceParent(context);
+  RequestPriority priority;
+  std::chrono::steady_clock::time_point deadline;
+  auto admission_status = GetAdmission(context, priority, deadline);
+  if (!admission_status.ok()) {
+    return admission_status;
+  }
+
+  struct Prediction {
+    ::grpc::Status status;
+    ::onnxruntime::server::PredictResponse response;
+  };
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::future<Prediction>> in_flight;  // protected by mutex, in the order of the requests
+  bool reading_done = false;                      // protected by mutex
+  ::grpc::Status stream_status;                   // protected by mutex
+
+  // Writes the responses in order as their requests complete, while the next requests are read.
+  std::thread writer([&]() {
+    for (;;) {
+      std::future<Prediction> next;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return !in_flight.empty() || reading_done; });
+        if (in_flight.empty()) {
+          return;
+        }
+        next = std::move(in_flight.front());
+      }
+
+      auto prediction = next.get();
+      bool failed;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        in_flight.pop_front();
+        if (stream_status.ok() && !prediction.status.ok()) {
+          stream_status = prediction.status;
+        }
+        failed = !stream_status.ok();
+      }
+      cv.notify_all();
+
+      if (!failed && !stream->Write(prediction.response)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stream_status = ::grpc::Status(::grpc::StatusCode::CANCELLED, "The stream was closed by the client");
+        failed = true;
+      }
+      if (failed) {
+        // unblocks the Read of the next request, the requests already running are drained
+        context->TryCancel();
+      }
+    }
+  });
+
+  ::onnxruntime::server::PredictRequest request;
+  while (stream->Read(&request)) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return in_flight.size() < kMaxStreamInFlightRequests || !stream_status.ok(); });
+    if (!stream_status.ok()) {
+      break;
+    }
+
+    auto request_id = util::InternalRequestId();
+    logger->debug("Stream request: [{}]", request_id);
+    ::grpc::Status access_status;
+    if (!request.shared_memory_inputs().empty() || !request.shared_memory_outputs().empty()) {
+      access_status = CheckSharedMemoryAccess(context);
+    }
+    in_flight.push_back(std::async(std::launch::async,
+                                   [this, request_id, priority, deadline, traceparent, access_status,
+                                    request = std::move(request)]() {
+                                     Prediction prediction;
+                                     if (!access_status.ok()) {
+                                       prediction.status = access_status;
+                                       return prediction;
+                                     }
+                                     onnxruntime::server::Executor executor(environment_.get(), request_id);
+                                     executor.SetPriority(priority);
+                                     executor.SetDeadline(deadline);
+                                     executor.SetTraceParent(traceparent);
+                                     auto status = executor.Predict("", "", request, prediction.response);
+                                     if (!status.ok()) {
+                                       prediction.status = ::grpc::Status(::grpc::StatusCode(status.error_code()),
+                                                                          status.error_message());
+                                     }
+                                     return prediction;
+                                   }));
+    lock.unlock();
+    cv.notify_all();
+    request.Clear();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    reading_done = true;
+  }
+  cv.notify_all();
+  writer.join();
+
+  return stream_status;
+}
+
+::grpc::Status PredictionServiceImpl::RegisterSharedMemory(::grpc::ServerContext* context,
+                                                           const ::onnxruntime::server::RegisterSharedMemoryRequest* request,
+                                                           ::onnxruntime::server::RegisterSharedMemoryResponse* /*response*/) {
+  auto request_id = SetRequestContext(context);
+  auto access_status = CheckSharedMemoryAccess(context);
+  if (!access_status.ok()) {
+    return access_status;
+  }
+
+  try {
+    environment_->GetSharedMemory().Register(request->name(), request->key(), request->offset(),
+                                             request->byte_size());
+  } catch (const Ort::Exception& e) {
+    auto status = GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+    return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
+  }
+  environment_->GetLogger(request_id)->info("Registered shared memory region {}: {} bytes at offset {} of {}",
+                                            request->name(), request->byte_size(), request->offset(),
+                                            request->key());
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::UnregisterSharedMemory(::grpc::ServerContext* context,
+                                                             const ::onnxruntime::server::UnregisterSharedMemoryRequest* request,
+                                                             ::onnxruntime::server::UnregisterSharedMemoryResponse* /*response*/) {
+  SetRequestContext(context);
+  auto access_status = CheckSharedMemoryAccess(context);
+  if (!access_status.ok()) {
+    return access_status;
+  }
+
+  if (!environment_->GetSharedMemory().Unregister(request->name())) {
+    return ::grpc::Status(::grpc::StatusCode::NOT_FOUND,
+                          "There's no shared memory region named " + request->name());
+  }
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status PredictionServiceImpl::CheckSharedMemoryAccess(::grpc::ServerContext* context) const {
+  if (!environment_->IsSharedMemoryEnabled()) {
+    return ::grpc::Status(::grpc::StatusCode::FAILED_PRECONDITION,
+                          "Shared memory isn't enabled, run the server with --enable_shared_memory");
+  }
+
+  // only the clients on the host of the server can map its shared memory
+  const auto peer = context->peer();
+  for (const auto* prefix : {"unix:", "ipv4:127.", "ipv6:[::1]", "ipv6:%5B::1%5D"}) {
+    if (peer.compare(0, std::strlen(prefix), prefix) == 0) {
+      return ::grpc::Status::OK;
+    }
+  }
+  return ::grpc::Status(::grpc::StatusCode::PERMISSION_DENIED,
+                        "Shared memory is only available to clients on the host of the server, not to " + peer);
+}
+
 std::string PredictionServiceImpl::SetRequestContext(::grpc::ServerContext* context) {
   auto metadata = context->client_metadata();
   auto request_id = util::InternalRequestId();
@@ -33,6 +231,34 @@ std::string PredictionServiceImpl::SetRequestContext(::grpc::ServerContext* cont
   return request_id;
 }
 
+std::string PredictionServiceImpl::GetTraceParent(::grpc::ServerContext* context) {
+  const auto& metadata = context->client_metadata();
+  auto search = metadata.find(util::TRACEPARENT_HEADER);
+  return search == metadata.end() ? std::string{} : std::string(search->second.data(), search->second.length());
+}
+
+::grpc::Status PredictionServiceImpl::GetAdmission(::grpc::ServerContext* context, RequestPriority& priority,
+                                                   std::chrono::steady_clock::time_point& deadline) {
+  priority = RequestPriority::Normal;
+  auto metadata = context->client_metadata();
+  auto search = metadata.find(util::MS_PRIORITY_HEADER);
+  if (search != metadata.end() &&
+      !ParseRequestPriority(std::string(search->second.data(), search->second.length()), priority)) {
+    return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                          util::MS_PRIORITY_HEADER + " metadata must be low, normal or high");
+  }
+
+  // the deadline of the call is on the system clock, it's max() if the client didn't set one
+  deadline = std::chrono::steady_clock::time_point::max();
+  const auto call_deadline = context->deadline();
+  if (call_deadline != std::chrono::system_clock::time_point::max()) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(call_deadline -
+                                                                              std::chrono::system_clock::now());
+  }
+  return ::grpc::Status::OK;
+}
+
 }  // namespace grpc
 }  // namespace server
 
@@ -11,12 +11,39 @@ class PredictionServiceImpl final : public onnxruntime::server::PredictionServic
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
   ::grpc::Status Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response);
+  ::grpc::Status PredictStream(::grpc::ServerContext* context, ::grpc::ServerReaderWriter<::onnxruntime::server::PredictResponse, ::onnxruntime::server::PredictRequest>* stream);
+
+  // Registers a shared memory region of a client on the same host. FAILED_PRECONDITION if the server isn't run with
+  // --enable_shared_memory, PERMISSION_DENIED if the client isn't local.
+  ::grpc::Status RegisterSharedMemory(::grpc::ServerContext* context,
+                                      const ::onnxruntime::server::RegisterSharedMemoryRequest* request,
+                                      ::onnxruntime::server::RegisterSharedMemoryResponse* response);
+  ::grpc::Status UnregisterSharedMemory(::grpc::ServerContext* context,
+                                        const ::onnxruntime::server::UnregisterSharedMemoryRequest* request,
+                                        ::onnxruntime::server::UnregisterSharedMemoryResponse* response);
+
+  // PredictStream on the interface of the stream, so that it can be run without a channel.
+  ::grpc::Status ProcessPredictStream(::grpc::ServerContext* context,
+                                      ::grpc::ServerReaderWriterInterface<::onnxruntime::server::PredictResponse,
+                                                                          ::onnxruntime::server::PredictRequest>* stream);
 
  private:
   std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
 
   //Extract customer request ID and set request ID for response.
   std::string SetRequestContext(::grpc::ServerContext* context);
+
+  // Reads the priority of the requests of a call from its metadata and their deadline from the deadline of the call.
+  // Returns INVALID_ARGUMENT if the priority isn't low, normal or high.
+  ::grpc::Status GetAdmission(::grpc::ServerContext* context, /* out */ RequestPriority& priority,
+                              /* out */ std::chrono::steady_clock::time_point& deadline);
+
+  // The traceparent metadata of a call, empty if there's none.
+  static std::string GetTraceParent(::grpc::ServerContext* context);
+
+  // Returns FAILED_PRECONDITION if shared memory isn't enabled and PERMISSION_DENIED if the peer of the call isn't on
+  // the host of the server.
+  ::grpc::Status CheckSharedMemoryAccess(::grpc::ServerContext* context) const;
 };
 }  // namespace grpc
 }  // namespace server
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
 #include "re2/re2.h"
 
@@ -60,9 +61,15 @@ http::status Routes::ParseUrl(http::verb method,
     return http::status::method_not_allowed;
   }
 
+  // routes capture up to the model name, version and action, in that order, e.g. /metrics captures none of them
+  const re2::RE2::Arg name_arg(&model_name), version_arg(&model_version), action_arg(&action);
+  const re2::RE2::Arg* const args[] = {&name_arg, &version_arg, &action_arg};
+
   bool found_match = false;
   for (const auto& pattern : func_table) {
-    if (re2::RE2::FullMatch(url, pattern.first, &model_name, &model_version, &action)) {
+    const re2::RE2 re(pattern.first);
+    const int n = std::min(re.NumberOfCapturingGroups(), 3);
+    if (n >= 0 && re2::RE2::FullMatchN(url, re, args, n)) {
       func = pattern.second;
 
       found_match = true;
@@ -15,6 +15,11 @@ HttpSession::HttpSession(const Routes& routes, tcp::socket socket)
 }
 
 void HttpSession::DoRead() {
+  if (reading_ || read_closed_ || next_request_ - next_response_ >= kMaxPipelinedRequests) {
+    return;
+  }
+
+  reading_ = true;
   req_.emplace();
 
   // TODO: make the max request size configable.
@@ -32,39 +37,81 @@ void HttpSession::DoRead() {
 
 void HttpSession::OnRead(beast::error_code ec, std::size_t bytes_transferred) {
   boost::ignore_unused(bytes_transferred);
+  reading_ = false;
 
   // This means they closed the connection
+  // The responses of the requests in flight are still written
   if (ec == http::error::end_of_stream) {
-    return DoClose();
+    read_closed_ = true;
+    if (next_response_ == next_request_) {
+      DoClose();
+    }
+    return;
   }
 
   if (ec) {
     ErrorHandling(ec, "read");
+    read_closed_ = true;
+    return;
+  }
+
+  // No request is read after one with the "Connection: close" semantic
+  auto request = req_->release();
+  if (!request.keep_alive()) {
+    read_closed_ = true;
+  }
+
+  // Handle the request, and read the next one while it runs
+  HandleRequest(std::move(request));
+  DoRead();
+}
+
+void HttpSession::OnResponse(size_t sequence_number, std::shared_ptr<Response> response) {
+  responses_.emplace(sequence_number, std::move(response));
+  DoWrite();
+}
+
+void HttpSession::DoWrite() {
+  if (writing_) {
     return;
   }
 
-  // Send the response
-  HandleRequest(req_->release());
+  auto next = responses_.find(next_response_);
+  if (next == responses_.end()) {
+    return;
+  }
+
+  writing_ = true;
+  auto response = std::move(next->second);
+  responses_.erase(next);
+
+  auto self = shared_from_this();
+  auto close = response->need_eof();
+  http::async_write(socket_, *response,
+                    net::bind_executor(strand_,
+                                       [self, response, close](beast::error_code ec, std::size_t bytes) {
+                                         self->OnWrite(ec, bytes, close);
+                                       }));
 }
 
 void HttpSession::OnWrite(beast::error_code ec, std::size_t bytes_transferred, bool close) {
   boost::ignore_unused(bytes_transferred);
+  writing_ = false;
 
   if (ec) {
     ErrorHandling(ec, "write");
     return;
   }
 
-  if (close) {
+  ++next_response_;
+  if (close || (read_closed_ && next_response_ == next_request_)) {
     // This means we should close the connection, usually because
     // the response indicated the "Connection: close" semantic.
     return DoClose();
   }
 
-  // We're done with the response so delete it
-  res_ = nullptr;
-
-  // Read another request
+  // Write the next response, and read another request now that there's room for it
+  DoWrite();
   DoRead();
 }
 
@@ -76,43 +123,38 @@ void HttpSession::DoClose() {
   // At this point the connection is closed gracefully
 }
 
-template <class Msg>
-void HttpSession::Send(Msg&& msg) {
-  using item_type = std::remove_reference_t<decltype(msg)>;
-
-  auto ptr = std::make_shared<item_type>(std::move(msg));
-  auto self_ = shared_from_this();
-  self_->res_ = ptr;
-
-  http::async_write(self_->socket_, *ptr,
-                    net::bind_executor(strand_,
-                                       [self_, close = ptr->need_eof()](beast::error_code ec, std::size_t bytes) {
-                                         self_->OnWrite(ec, bytes, close);
-                                       }));
-}
-
 template <typename Body, typename Allocator>
 void HttpSession::HandleRequest(http::request<Body, http::basic_fields<Allocator> >&& req) {
-  HttpContext context{};
-  context.request = std::move(req);
-
-  // Special handle the liveness probe endpoint for orchestration systems like Kubernetes.
-  if (context.request.method() == http::verb::get && context.request.target().to_string() == "/") {
-    context.response.body() = "Healthy";
-  } else {
-    auto status = ExecuteUserFunction(context);
-
-    if (status != http::status::ok) {
-      routes_.on_error(context);
+  auto sequence_number = next_request_++;
+  auto self = shared_from_this();
+  auto request = std::make_shared<http::request<Body, http::basic_fields<Allocator> > >(std::move(req));
+
+  // Run the request on any thread of the io_context, so the requests in flight on the connection run concurrently
+  net::post(socket_.get_executor(), [self, sequence_number, request]() {
+    HttpContext context{};
+    context.request = std::move(*request);
+
+    // Special handle the liveness probe endpoint for orchestration systems like Kubernetes.
+    if (context.request.method() == http::verb::get && context.request.target().to_string() == "/") {
+      context.response.body() = "Healthy";
+    } else {
+      auto status = self->ExecuteUserFunction(context);
+
+      if (status != http::status::ok) {
+        self->routes_.on_error(context);
+      }
     }
-  }
 
-  context.response.keep_alive(context.request.keep_alive());
-  context.response.prepare_payload();
-  return Send(std::move(context.response));
+    context.response.keep_alive(context.request.keep_alive());
+    context.response.prepare_payload();
+    auto response = std::make_shared<Response>(std::move(context.response));
+    net::post(self->strand_, [self, sequence_number, response]() {
+      self->OnResponse(sequence_number, response);
+    });
+  });
 }
 
-http::status HttpSession::ExecuteUserFunction(HttpContext& context) {
+http::status HttpSession::ExecuteUserFunction(HttpContext& context) const {
   std::string path = context.request.target().to_string();
   std::string model_name, model_version, action;
   HandlerFn func;
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <boost/beast/version.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -24,6 +25,10 @@ namespace http = beast::http;
 
 // An implementation of a single HTTP session
 // Used by a listener to hand off the work and async write back to a socket
+//
+// Requests are pipelined: the session keeps reading requests while the previous ones are handled, up to
+// kMaxPipelinedRequests of them. They are handled concurrently on the threads of the io_context and the
+// responses are written back in the order of the requests, as HTTP/1.1 requires.
 class HttpSession : public std::enable_shared_from_this<HttpSession> {
  public:
   HttpSession(const Routes& routes, tcp::socket socket);
@@ -35,39 +40,48 @@ class HttpSession : public std::enable_shared_from_this<HttpSession> {
   }
 
  private:
+  using Response = http::response<http::string_body>;
+
+  static constexpr size_t kMaxPipelinedRequests = 16;
+
   const Routes routes_;
   tcp::socket socket_;
   net::strand<net::io_context::executor_type> strand_;
   beast::flat_buffer buffer_;
   boost::optional<http::request_parser<http::string_body>> req_;
-  std::shared_ptr<void> res_{nullptr};
 
-  // Writes the message asynchronously back to the socket
-  // Stores the pointer to the message and the class itself so that
-  // They do not get destructed before the async process is finished
-  // If you pass shared_from_this() are guaranteed that the life time
-  // of your object will be extended to as long as the function needs it
-  // Most examples in boost::asio are based on this logic
-  template <class Msg>
-  void Send(Msg&& msg);
+  // The members below are only used on the strand
+  size_t next_request_ = 0;                                // sequence number of the next request read
+  size_t next_response_ = 0;                               // sequence number of the next response to write
+  std::map<size_t, std::shared_ptr<Response>> responses_;  // handled requests waiting for their turn to be written
+  bool reading_ = false;
+  bool writing_ = false;
+  bool read_closed_ = false;  // no more requests are read from the connection
 
   // Called after the session is finished reading the message
-  // Should set the response before calling Send
+  // Handles the request off the strand, then posts its response back to the strand
   template <typename Body, typename Allocator>
   void HandleRequest(http::request<Body, http::basic_fields<Allocator>>&& req);
 
   // Handle the request and hand it off to the user's function
   // Execute user function, handle errors
-  // HttpContext parameter can be updated here or in HandleRequest
-  http::status ExecuteUserFunction(HttpContext& context);
+  // Called concurrently for the requests in flight, so it must not change the session
+  http::status ExecuteUserFunction(HttpContext& context) const;
 
-  // Asynchronously reads the request from the socket
+  // Asynchronously reads the request from the socket, if there's room for another request in flight
   void DoRead();
 
   // Perform error checking before handing off to HandleRequest
   void OnRead(beast::error_code ec, std::size_t bytes_transferred);
 
-  // After writing, make the session read another request
+  // Queues the response of request sequence_number and writes the next responses that are ready
+  void OnResponse(size_t sequence_number, std::shared_ptr<Response> response);
+
+  // Writes the next response asynchronously back to the socket, if it's ready and no write is in progress
+  // The response and the session are kept alive by the completion handler until the write is finished
+  void DoWrite();
+
+  // After writing, write the next response and make the session read another request
   void OnWrite(beast::error_code ec, std::size_t bytes_transferred, bool close);
 
   // Close the connection
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "environment.h"
+#include "http_server.h"
+#include "json_handling.h"
+#include "metrics_handler.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace http = boost::beast::http;
+
+void GetMetrics(const std::string& /* name */,
+                const std::string& /* version */,
+                const std::string& /* action */,
+                /* in, out */ HttpContext& context,
+                const std::shared_ptr<ServerEnvironment>& env) {
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+
+  try {
+    context.response.body() = env->GetMetrics().Render(env->GetModelRepository().GetModels());
+  } catch (const Ort::Exception& e) {
+    auto logger = env->GetLogger(context.request_id);
+    logger->error("Rendering the metrics failed: {}", e.what());
+    context.response.result(http::status::internal_server_error);
+    context.response.body() = CreateJsonError(http::status::internal_server_error, e.what());
+    context.response.set(http::field::content_type, "application/json");
+    return;
+  }
+
+  context.response.result(http::status::ok);
+  context.response.set(http::field::content_type, kMetricsContentType);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+
+namespace onnxruntime {
+namespace server {
+
+class ServerEnvironment;
+
+// Writes the metrics of the server in the Prometheus text format, for a Prometheus server to scrape.
+void GetMetrics(const std::string& name,
+                const std::string& version,
+                const std::string& action,
+                /* in, out */ HttpContext& context,
+                const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
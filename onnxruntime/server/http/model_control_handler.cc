@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "environment.h"
+#include "http_server.h"
+#include "json_handling.h"
+#include "model_control_handler.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace http = boost::beast::http;
+
+static void GenerateResponse(http::status status_code, const std::string& message, HttpContext& context) {
+  context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
+  if (!context.client_request_id.empty()) {
+    context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
+  }
+  context.response.result(status_code);
+  if (status_code != http::status::ok) {
+    context.response.body() = CreateJsonError(status_code, message);
+    context.response.set(http::field::content_type, "application/json");
+  }
+}
+
+void ControlModel(const std::string& name,
+                  const std::string& version,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env) {
+  auto logger = env->GetLogger(context.request_id);
+  logger->info("Model Name: {}, Version: {}, Action: {}", name, version, action);
+
+  auto& repository = env->GetModelRepository();
+  if (action == "unload") {
+    if (!repository.UnloadModel(name, version)) {
+      GenerateResponse(http::status::not_found, "Model " + name + " version " + version + " isn't loaded", context);
+      return;
+    }
+    GenerateResponse(http::status::ok, "", context);
+    return;
+  }
+
+  const auto& body = context.request.body();
+  auto begin = body.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    GenerateResponse(http::status::bad_request, "The body must be the path of the model to load", context);
+    return;
+  }
+  auto model_path = body.substr(begin, body.find_last_not_of(" \t\r\n") + 1 - begin);
+
+  try {
+    repository.LoadModel(name, version, model_path);
+  } catch (const Ort::Exception& e) {
+    logger->error("Loading model {} version {} from {} failed: {}", name, version, model_path, e.what());
+    GenerateResponse(http::status::bad_request, e.what(), context);
+    return;
+  }
+  GenerateResponse(http::status::ok, "", context);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "http_server.h"
+
+namespace onnxruntime {
+namespace server {
+
+class ServerEnvironment;
+
+// Loads or unloads a version of a model while the server is running. action is "load" or "unload".
+// The body of a load request is the path of the model file. Loading a version that is already served replaces it
+// once the new session is ready, the requests in flight finish on the previous one.
+void ControlModel(const std::string& name,
+                  const std::string& version,
+                  const std::string& action,
+                  /* in, out */ HttpContext& context,
+                  const std::shared_ptr<ServerEnvironment>& env);
+
+}  // namespace server
+}  // namespace onnxruntime
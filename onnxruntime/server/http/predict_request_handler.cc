@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/stubs/status.h>
 
 #include "environment.h"
@@ -8,6 +9,7 @@
 #include "json_handling.h"
 #include "executor.h"
 #include "util.h"
+#include "serializing/raw_tensors.h"
 
 namespace onnxruntime {
 namespace server {
@@ -31,6 +33,11 @@ namespace protobufutil = google::protobuf::util;
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type,
                                 /* out */ PredictRequest& predictRequest, /* out */ http::status& error_code, /* out */ std::string& error_message);
 
+// Runs a request of raw tensors, which are decoded in place from the body instead of through a PredictRequest.
+static protobufutil::Status PredictRawTensors(const std::string& name, const std::string& version,
+                                             SupportedContentType response_type, HttpContext& context,
+                                             Executor& executor, /* out */ PredictResponse& predict_response);
+
 void Predict(const std::string& name,
              const std::string& version,
              const std::string& action,
@@ -49,56 +56,137 @@ void Predict(const std::string& name,
   if (response_type == SupportedContentType::Unknown) {
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
-
-  // Deserialize the payload
-  auto body = context.request.body();
-  PredictRequest predict_request{};
-  http::status error_code;
-  std::string error_message;
-  bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
-  if (!parse_succeeded) {
-    GenerateErrorResponse(logger, error_code, error_message, context);
+  if (request_type == SupportedContentType::RawTensors && context.request.find("Accept") == context.request.end()) {
+    response_type = SupportedContentType::RawTensors;
+  } else if (response_type == SupportedContentType::RawTensors && request_type != SupportedContentType::RawTensors) {
+    GenerateErrorResponse(logger, http::status::not_acceptable,
+                          std::string(kRawTensorsContentType) + " responses are only returned for requests of that type",
+                          context);
     return;
   }
 
-  // Run Prediction
+  // The request and response messages, and their tensors, are allocated on an arena that is released at once
+  // when the request is done.
+  google::protobuf::Arena arena;
+  auto& predict_response = *google::protobuf::Arena::CreateMessage<PredictResponse>(&arena);
+
+  // Records the latencies of the request when it's done, once the response is serialized
   Executor executor(env.get(), context.request_id);
-  PredictResponse predict_response{};
-  auto status = executor.Predict(name, version, predict_request, predict_response);
-  if (!status.ok()) {
-    GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
+  RequestPriority priority;
+  std::chrono::steady_clock::time_point deadline;
+  if (!GetRequestPriority(context, priority)) {
+    GenerateErrorResponse(logger, http::status::bad_request,
+                          "'" + util::MS_PRIORITY_HEADER + "' header field must be low, normal or high", context);
     return;
   }
+  if (!GetRequestDeadline(context, deadline)) {
+    GenerateErrorResponse(logger, http::status::bad_request,
+                          "'" + util::MS_REQUEST_TIMEOUT_HEADER + "' header field must be a positive number of milliseconds",
+                          context);
+    return;
+  }
+  executor.SetPriority(priority);
+  executor.SetDeadline(deadline);
+  auto traceparent = context.request.find(util::TRACEPARENT_HEADER);
+  if (traceparent != context.request.end()) {
+    executor.SetTraceParent(traceparent->value().to_string());
+  }
+  if (request_type == SupportedContentType::RawTensors) {
+    auto status = PredictRawTensors(name, version, response_type, context, executor, predict_response);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
+      return;
+    }
+  } else {
+    // Deserialize the payload
+    auto& predict_request = *google::protobuf::Arena::CreateMessage<PredictRequest>(&arena);
+    http::status error_code;
+    std::string error_message;
+    const auto parse_start = std::chrono::steady_clock::now();
+    bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
+    if (!parse_succeeded) {
+      GenerateErrorResponse(logger, error_code, error_message, context);
+      return;
+    }
+    executor.AddDecodeTime(std::chrono::steady_clock::now() - parse_start);
 
-  // Serialize to proper output format
-  std::string response_body{};
-  if (response_type == SupportedContentType::Json) {
-    status = GenerateResponseInJson(predict_response, response_body);
+    // Run Prediction
+    auto status = executor.Predict(name, version, predict_request, predict_response);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
+      return;
+    }
+  }
+
+  // Serialize to proper output format, straight into the body of the HTTP response
+  std::string& response_body = context.response.body();
+  const auto serialize_start = std::chrono::steady_clock::now();
+  if (response_type == SupportedContentType::RawTensors) {
+    // the outputs were already written to the body
+    context.response.set(http::field::content_type, kRawTensorsContentType);
+  } else if (response_type == SupportedContentType::Json) {
+    auto status = GenerateResponseInJson(predict_response, response_body);
     if (!status.ok()) {
       GenerateErrorResponse(logger, http::status::internal_server_error, status.error_message(), context);
       return;
     }
     context.response.set(http::field::content_type, "application/json");
   } else {
-    response_body = predict_response.SerializeAsString();
+    predict_response.SerializeToString(&response_body);
     if (context.request.find("Accept") != context.request.end() && context.request["Accept"] != "*/*") {
       context.response.set(http::field::content_type, context.request["Accept"].to_string());
     } else {
       context.response.set(http::field::content_type, "application/octet-stream");
     }
   }
+  executor.AddEncodeTime(std::chrono::steady_clock::now() - serialize_start);
 
   // Build HTTP response
   context.response.insert(util::MS_REQUEST_ID_HEADER, context.request_id);
   if (!context.client_request_id.empty()) {
     context.response.insert(util::MS_CLIENT_REQUEST_ID_HEADER, context.client_request_id);
   }
-  context.response.body() = response_body;
   context.response.result(http::status::ok);
 };
 
+static protobufutil::Status PredictRawTensors(const std::string& name, const std::string& version,
+                                             SupportedContentType response_type, HttpContext& context,
+                                             Executor& executor, PredictResponse& predict_response) {
+  std::vector<std::string> input_names;
+  std::vector<Ort::Value> input_values;
+  MemBufferArray buffers;
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  protobufutil::Status status;
+  const auto decode_start = std::chrono::steady_clock::now();
+  try {
+    // the inputs borrow the body of the request, which outlives the run
+    status = ParseRawTensors(context.request.body(), *memory_info, buffers, input_names, input_values);
+  } catch (const Ort::Exception& e) {
+    status = GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+  if (!status.ok()) {
+    return status;
+  }
+  executor.AddDecodeTime(std::chrono::steady_clock::now() - decode_start);
+
+  std::vector<std::string> output_names;
+  std::vector<Ort::Value> outputs;
+  status = executor.Run(name, version, std::move(input_names), std::move(input_values), output_names, outputs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (response_type == SupportedContentType::RawTensors) {
+    const auto encode_start = std::chrono::steady_clock::now();
+    status = WriteRawTensors(output_names, outputs, context.response.body());
+    executor.AddEncodeTime(std::chrono::steady_clock::now() - encode_start);
+    return status;
+  }
+  return executor.BuildResponse(output_names, outputs, predict_response);
+}
+
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
-  auto body = context.request.body();
+  const auto& body = context.request.body();
   protobufutil::Status status;
   switch (request_type) {
     case SupportedContentType::Json: {
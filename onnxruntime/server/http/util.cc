@@ -8,6 +8,7 @@
 
 #include "context.h"
 #include "util.h"
+#include "serializing/raw_tensors.h"
 
 namespace protobufutil = google::protobuf::util;
 namespace onnxruntime {
@@ -24,8 +25,6 @@ boost::beast::http::status GetHttpStatusCode(const protobufutil::Status& status)
       return boost::beast::http::status::ok;
 
     case protobufutil::error::Code::UNKNOWN:
-    case protobufutil::error::Code::DEADLINE_EXCEEDED:
-    case protobufutil::error::Code::RESOURCE_EXHAUSTED:
     case protobufutil::error::Code::ABORTED:
     case protobufutil::error::Code::UNIMPLEMENTED:
     case protobufutil::error::Code::INTERNAL:
@@ -43,6 +42,12 @@ boost::beast::http::status GetHttpStatusCode(const protobufutil::Status& status)
     case protobufutil::error::Code::NOT_FOUND:
       return boost::beast::http::status::not_found;
 
+    case protobufutil::error::Code::RESOURCE_EXHAUSTED:
+      return boost::beast::http::status::too_many_requests;
+
+    case protobufutil::error::Code::DEADLINE_EXCEEDED:
+      return boost::beast::http::status::gateway_timeout;
+
     case protobufutil::error::Code::PERMISSION_DENIED:
       return boost::beast::http::status::forbidden;
 
@@ -60,6 +65,8 @@ SupportedContentType GetRequestContentType(const HttpContext& context) {
       return SupportedContentType::Json;
     } else if (protobuf_mime_types.find(context.request["Content-Type"].to_string()) != protobuf_mime_types.end()) {
       return SupportedContentType::PbByteArray;
+    } else if (context.request["Content-Type"] == kRawTensorsContentType) {
+      return SupportedContentType::RawTensors;
     }
   }
 
@@ -72,6 +79,8 @@ SupportedContentType GetResponseContentType(const HttpContext& context) {
       return SupportedContentType::Json;
     } else if (context.request["Accept"] == "*/*" || protobuf_mime_types.find(context.request["Accept"].to_string()) != protobuf_mime_types.end()) {
       return SupportedContentType::PbByteArray;
+    } else if (context.request["Accept"] == kRawTensorsContentType) {
+      return SupportedContentType::RawTensors;
     }
   } else {
     return SupportedContentType::PbByteArray;
@@ -80,5 +89,30 @@ SupportedContentType GetResponseContentType(const HttpContext& context) {
   return SupportedContentType::Unknown;
 }
 
+bool GetRequestPriority(const HttpContext& context, RequestPriority& priority) {
+  priority = RequestPriority::Normal;
+  auto field = context.request.find(util::MS_PRIORITY_HEADER);
+  return field == context.request.end() || ParseRequestPriority(field->value().to_string(), priority);
+}
+
+bool GetRequestDeadline(const HttpContext& context, std::chrono::steady_clock::time_point& deadline) {
+  deadline = std::chrono::steady_clock::time_point::max();
+  auto field = context.request.find(util::MS_REQUEST_TIMEOUT_HEADER);
+  if (field == context.request.end()) {
+    return true;
+  }
+
+  const auto value = field->value().to_string();
+  if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  const auto timeout_ms = std::stoll(value);
+  if (timeout_ms == 0) {
+    return false;
+  }
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  return true;
+}
+
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
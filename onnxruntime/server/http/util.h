@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include <chrono>
+
 #include <boost/beast/core.hpp>
 #include <boost/beast/http/status.hpp>
 #include <google/protobuf/stubs/status.h>
 
+#include "admission.h"
 #include "http/core/context.h"
 
 namespace onnxruntime {
@@ -17,19 +20,30 @@ namespace beast = boost::beast;  // from <boost/beast.hpp>
 enum class SupportedContentType : int {
   Unknown,
   Json,
-  PbByteArray
+  PbByteArray,
+  RawTensors  // see serializing/raw_tensors.h
 };
 
 // Mapping protobuf status to http status
 boost::beast::http::status GetHttpStatusCode(const google::protobuf::util::Status& status);
 
 // "Content-Type" header field in request is MUST-HAVE.
-// Currently we only support two types of input content type: application/json and application/octet-stream
+// Currently we support three types of input content type: application/json, application/octet-stream and
+// application/vnd.onnxruntime.tensors
 SupportedContentType GetRequestContentType(const HttpContext& context);
 
 // "Accept" header field in request is OPTIONAL.
-// Currently we only support three types of response content type: */*, application/json and application/octet-stream
+// Currently we support four types of response content type: */*, application/json, application/octet-stream and
+// application/vnd.onnxruntime.tensors
 SupportedContentType GetResponseContentType(const HttpContext& context);
 
+// "x-ms-priority" header field in request is OPTIONAL, Normal if it's missing.
+// Returns false if its value isn't low, normal or high.
+bool GetRequestPriority(const HttpContext& context, /* out */ RequestPriority& priority);
+
+// "x-ms-request-timeout-ms" header field in request is OPTIONAL, the deadline is time_point::max() if it's missing.
+// Returns false if its value isn't a positive number of milliseconds.
+bool GetRequestDeadline(const HttpContext& context, /* out */ std::chrono::steady_clock::time_point& deadline);
+
 }  // namespace server
 }  // namespace onnxruntime
@@ -3,8 +3,11 @@
 
 #include "environment.h"
 #include "http_server.h"
+#include "metrics_handler.h"
+#include "model_control_handler.h"
 #include "predict_request_handler.h"
 #include "server_configuration.h"
+#include "grpc/embedding_client.h"
 #include "grpc/grpc_app.h"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/sink.h>
@@ -58,12 +61,66 @@ int main(int argc, char* argv[]) {
     exit(EXIT_FAILURE);
   }
 
-  const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
+  const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()},
+                                                               static_cast<size_t>(config.log_queue_size));
   auto logger = env->GetAppLogger();
   logger->info("Model path: {}", config.model_path);
 
   try {
-    env->InitializeModel(config.model_path);
+    if (config.max_batch_size > 1) {
+      server::BatchingOptions batching_options;
+      batching_options.max_batch_size = static_cast<size_t>(config.max_batch_size);
+      batching_options.max_queue_delay = std::chrono::microseconds(config.max_queue_delay_us);
+      batching_options.pad_variable_length_inputs = config.pad_batch_inputs;
+      env->EnableBatching(batching_options);
+      logger->info("Batching requests up to {} rows", config.max_batch_size);
+    }
+    if (config.max_concurrent_runs > 0) {
+      server::AdmissionOptions admission_options;
+      admission_options.max_concurrent_runs = static_cast<size_t>(config.max_concurrent_runs);
+      admission_options.max_queued_requests = static_cast<size_t>(config.max_queued_requests);
+      env->EnableAdmissionControl(admission_options);
+      logger->info("Running up to {} requests per model, with up to {} waiting", config.max_concurrent_runs,
+                   config.max_queued_requests);
+    }
+    if (config.response_cache_mb > 0) {
+      server::ResponseCacheOptions cache_options;
+      cache_options.max_bytes = static_cast<size_t>(config.response_cache_mb) << 20;
+      cache_options.ttl = std::chrono::milliseconds(config.response_cache_ttl_ms);
+      env->EnableResponseCache(cache_options);
+      logger->info("Caching up to {} MB of outputs per model", config.response_cache_mb);
+    }
+    if (!config.replica_devices.empty()) {
+      env->SetReplicaDevices(config.replica_devices);
+      logger->info("Running {} replica(s) of each model", config.replica_devices.size());
+    }
+    for (const auto& shard : config.embedding_shards) {
+      env->AddEmbeddingShard(std::make_unique<server::EmbeddingShard>(shard));
+      logger->info("Serving the rows of table {} from row {}", shard.table, shard.first_row);
+    }
+    if (!config.remote_embedding_tables.empty()) {
+      auto tables = std::make_shared<server::RemoteEmbeddingTables>(server::grpc::CreateEmbeddingRowFetcher);
+      for (const auto& table : config.remote_embedding_tables) {
+        tables->AddTable(table);
+        logger->info("Looking up table {} in {} remote shard(s)", table.name, table.shards.size());
+      }
+      env->EnableRemoteEmbeddings(tables);
+    }
+    if (config.enable_shared_memory) {
+      env->EnableSharedMemory();
+      logger->info("Local gRPC clients can register shared memory regions");
+    }
+    if (!config.otlp_traces_endpoint.empty()) {
+      server::OtlpExporterOptions exporter_options;
+      exporter_options.endpoint = config.otlp_traces_endpoint;
+      exporter_options.service_name = config.trace_service_name;
+      env->EnableTracing(std::make_unique<server::OtlpHttpExporter>(exporter_options, env->GetAppLogger()));
+      logger->info("Exporting the spans of the requests to {}", config.otlp_traces_endpoint);
+    }
+    env->InitializeModel(config.model_path, config.model_name, config.model_version);
+    for (const auto& model : config.additional_models) {
+      env->GetModelRepository().LoadModel(model.name, model.version, model.path);
+    }
     logger->debug("Initialize Model Successfully!");
   } catch (const Ort::Exception& ex) {
     logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
@@ -109,6 +166,20 @@ int main(int argc, char* argv[]) {
         server::Predict(name, version, action, context, env);
       });
 
+  app.RegisterGet(
+      R"(/metrics)",
+      [&env](const auto& name, const auto& version, const auto& action, auto& context) -> void {
+        server::GetMetrics(name, version, action, context, env);
+      });
+
+  if (config.enable_model_control) {
+    app.RegisterPost(
+        R"(/v1/models/([^/:]+)/versions/(\d+):(load|unload))",
+        [&env](const auto& name, const auto& version, const auto& action, auto& context) -> void {
+          server::ControlModel(name, version, action, context, env);
+        });
+  }
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "metrics.h"
+#include "model_repository.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Latencies of the phases of a request, from 100us to 10s.
+static std::vector<double> LatencyBounds() {
+  return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+}
+
+static std::vector<double> BatchSizeBounds() {
+  return {1, 2, 4, 8, 16, 32, 64, 128, 256, 512};
+}
+
+static std::string FormatValue(double value) {
+  std::ostringstream out;
+  out << std::setprecision(10) << value;
+  return out.str();
+}
+
+// A label value, with the characters the text format requires to be escaped escaped.
+static std::string Quote(const std::string& value) {
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c == '\n') {
+      quoted += "\\n";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+static std::string ModelLabels(const std::string& name, const std::string& version) {
+  return "model=" + Quote(name) + ",version=" + Quote(version);
+}
+
+static void RenderHeader(const char* name, const char* type, const char* help, std::string& out) {
+  out += "# HELP ";
+  out += name;
+  out += ' ';
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out += ' ';
+  out += type;
+  out += '\n';
+}
+
+static void RenderSample(const std::string& name, const std::string& labels, const std::string& value,
+                         std::string& out) {
+  out += name;
+  out += '{';
+  out += labels;
+  out += "} ";
+  out += value;
+  out += '\n';
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)), counts_(bounds_.size() + 1) {}
+
+void Histogram::Observe(double value) {
+  const size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++counts_[bucket];
+  sum_ += value;
+  ++count_;
+}
+
+void Histogram::Render(const std::string& name, const std::string& labels, std::string& out) const {
+  std::vector<uint64_t> counts;
+  double sum;
+  uint64_t count;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counts = counts_;
+    sum = sum_;
+    count = count_;
+  }
+
+  const std::string bucket_name = name + "_bucket";
+  const std::string bucket_labels = labels.empty() ? labels : labels + ",";
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < bounds_.size(); ++i) {
+    cumulative += counts[i];
+    RenderSample(bucket_name, bucket_labels + "le=" + Quote(FormatValue(bounds_[i])), std::to_string(cumulative),
+                 out);
+  }
+  RenderSample(bucket_name, bucket_labels + "le=\"+Inf\"", std::to_string(count), out);
+  RenderSample(name + "_sum", labels, FormatValue(sum), out);
+  RenderSample(name + "_count", labels, std::to_string(count), out);
+}
+
+ModelMetrics::ModelMetrics()
+    : decode_seconds(LatencyBounds()),
+      queue_seconds(LatencyBounds()),
+      run_seconds(LatencyBounds()),
+      encode_seconds(LatencyBounds()),
+      batch_size(BatchSizeBounds()) {}
+
+void ModelMetrics::ObservePhase(RequestPhase phase, std::chrono::steady_clock::duration time) {
+  const double seconds = std::chrono::duration<double>(time).count();
+  switch (phase) {
+    case RequestPhase::Decode:
+      decode_seconds.Observe(seconds);
+      break;
+    case RequestPhase::Queue:
+      queue_seconds.Observe(seconds);
+      break;
+    case RequestPhase::Run:
+      run_seconds.Observe(seconds);
+      break;
+    case RequestPhase::Encode:
+      encode_seconds.Observe(seconds);
+      break;
+  }
+}
+
+ModelMetrics& ServerMetrics::GetModelMetrics(const std::string& name, const std::string& version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& metrics = models_[std::make_pair(name, version)];
+  if (metrics == nullptr) {
+    metrics = std::make_unique<ModelMetrics>();
+  }
+  return *metrics;
+}
+
+std::string ServerMetrics::Render(const std::vector<std::shared_ptr<ServedModel>>& models) const {
+  // the metrics are never removed, so they can be rendered without holding the lock
+  std::vector<std::pair<std::string, const ModelMetrics*>> model_metrics;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : models_) {
+      model_metrics.emplace_back(ModelLabels(entry.first.first, entry.first.second), entry.second.get());
+    }
+  }
+
+  std::string out;
+  RenderHeader("onnxruntime_server_requests_total", "counter", "Requests for the model.", out);
+  for (const auto& entry : model_metrics) {
+    RenderSample("onnxruntime_server_requests_total", entry.first, std::to_string(entry.second->requests.load()), out);
+  }
+
+  RenderHeader("onnxruntime_server_request_failures_total", "counter", "Requests whose run failed.", out);
+  for (const auto& entry : model_metrics) {
+    RenderSample("onnxruntime_server_request_failures_total", entry.first,
+                 std::to_string(entry.second->failures.load()), out);
+  }
+
+  RenderHeader("onnxruntime_server_request_rejections_total", "counter",
+               "Requests rejected by admission control, because the queue was full or their deadline passed.", out);
+  for (const auto& entry : model_metrics) {
+    RenderSample("onnxruntime_server_request_rejections_total", entry.first,
+                 std::to_string(entry.second->rejections.load()), out);
+  }
+
+  RenderHeader("onnxruntime_server_response_cache_hits_total", "counter",
+               "Requests answered from the response cache without running the model.", out);
+  for (const auto& entry : model_metrics) {
+    RenderSample("onnxruntime_server_response_cache_hits_total", entry.first,
+                 std::to_string(entry.second->cache_hits.load()), out);
+  }
+
+  RenderHeader("onnxruntime_server_requests_in_flight", "gauge", "Requests being run with the model.", out);
+  for (const auto& entry : model_metrics) {
+    RenderSample("onnxruntime_server_requests_in_flight", entry.first, std::to_string(entry.second->in_flight.load()),
+                 out);
+  }
+
+  const std::pair<const char*, const Histogram ModelMetrics::*> phases[] = {
+      {"decode", &ModelMetrics::decode_seconds},
+      {"queue", &ModelMetrics::queue_seconds},
+      {"run", &ModelMetrics::run_seconds},
+      {"encode", &ModelMetrics::encode_seconds},
+  };
+  RenderHeader("onnxruntime_server_request_phase_seconds", "histogram",
+               "Latency of the phases of the requests that succeeded.", out);
+  for (const auto& entry : model_metrics) {
+    for (const auto& phase : phases) {
+      (entry.second->*phase.second)
+          .Render("onnxruntime_server_request_phase_seconds", entry.first + ",phase=" + Quote(phase.first), out);
+    }
+  }
+
+  RenderHeader("onnxruntime_server_batch_size", "histogram",
+               "Rows of the batches the requests were run in, for models with batching enabled.", out);
+  for (const auto& entry : model_metrics) {
+    entry.second->batch_size.Render("onnxruntime_server_batch_size", entry.first, out);
+  }
+
+  RenderHeader("onnxruntime_server_queued_requests", "gauge",
+               "Requests waiting to be admitted or for their batch to run.", out);
+  for (const auto& model : models) {
+    size_t queued = model->admission != nullptr ? model->admission->QueueDepth() : 0;
+    for (const auto& replica : model->replicas) {
+      queued += replica->batcher != nullptr ? replica->batcher->QueueDepth() : 0;
+    }
+    RenderSample("onnxruntime_server_queued_requests", ModelLabels(model->name, model->version),
+                 std::to_string(queued), out);
+  }
+
+  RenderHeader("onnxruntime_server_replica_requests_in_flight", "gauge",
+               "Requests dispatched to a replica of the model that aren't done.", out);
+  for (const auto& model : models) {
+    for (size_t i = 0; i < model->replicas.size(); ++i) {
+      const auto& replica = *model->replicas[i];
+      RenderSample("onnxruntime_server_replica_requests_in_flight",
+                   ModelLabels(model->name, model->version) + ",replica=" + Quote(std::to_string(i)) +
+                       ",device=" + Quote(replica.device.ToString()),
+                   std::to_string(replica.in_flight.load()), out);
+    }
+  }
+
+  RenderHeader("onnxruntime_server_response_cache_bytes", "gauge", "Bytes of the response cache of the model.", out);
+  for (const auto& model : models) {
+    const size_t bytes = model->cache != nullptr ? model->cache->SizeInBytes() : 0;
+    RenderSample("onnxruntime_server_response_cache_bytes", ModelLabels(model->name, model->version),
+                 std::to_string(bytes), out);
+  }
+
+  RenderHeader("onnxruntime_server_arena_bytes_in_use", "gauge",
+               "Bytes of the memory arenas of the sessions of the model's replicas in use.", out);
+  for (const auto& model : models) {
+    size_t bytes = 0;
+    for (const auto& replica : model->replicas) {
+      bytes += replica->session.GetMemoryArenaBytesInUse();
+    }
+    RenderSample("onnxruntime_server_arena_bytes_in_use", ModelLabels(model->name, model->version),
+                 std::to_string(bytes), out);
+  }
+
+  return out;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
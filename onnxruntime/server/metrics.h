@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+namespace server {
+
+struct ServedModel;
+
+// A distribution of observed values in cumulative buckets, as exported by Prometheus.
+class Histogram {
+ public:
+  // bounds are the increasing upper bounds of the buckets. Values above the last bound are only counted in the
+  // implicit +Inf bucket.
+  explicit Histogram(std::vector<double> bounds);
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void Observe(double value);
+
+  // Writes the _bucket, _sum and _count samples of the histogram. labels are the labels of the samples without
+  // braces, e.g. model="mnist",version="1".
+  void Render(const std::string& name, const std::string& labels, std::string& out) const;
+
+ private:
+  const std::vector<double> bounds_;
+
+  mutable std::mutex mutex_;
+  std::vector<uint64_t> counts_;  // protected by mutex_, per bucket, not cumulative
+  double sum_ = 0;                // protected by mutex_
+  uint64_t count_ = 0;            // protected by mutex_
+};
+
+// The phases of a request whose latency is recorded.
+enum class RequestPhase {
+  Decode,  // the request payload is parsed into input values
+  Queue,   // the request waits for its batch to run
+  Run,     // the session runs
+  Encode,  // the outputs are written to the response
+};
+
+// The metrics of a version of a model. They outlive the sessions of the version, so reloading it keeps its counts.
+struct ModelMetrics {
+  ModelMetrics();
+  ModelMetrics(const ModelMetrics&) = delete;
+
+  void ObservePhase(RequestPhase phase, std::chrono::steady_clock::duration time);
+
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> failures{0};
+  std::atomic<uint64_t> rejections{0};
+  std::atomic<uint64_t> cache_hits{0};
+  std::atomic<int64_t> in_flight{0};
+  Histogram decode_seconds;
+  Histogram queue_seconds;
+  Histogram run_seconds;
+  Histogram encode_seconds;
+  Histogram batch_size;
+};
+
+/**
+ * The metrics of the server, rendered in the Prometheus text format for the /metrics endpoint. Counters and
+ * histograms are recorded per model version as requests run. The gauges of the loaded models (requests in
+ * flight per replica, queued requests, arena bytes in use) are sampled when the metrics are rendered.
+ */
+class ServerMetrics {
+ public:
+  ServerMetrics() = default;
+  ServerMetrics(const ServerMetrics&) = delete;
+  ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+  // The metrics of a version of a model, created on first use. The reference stays valid for the lifetime of this.
+  ModelMetrics& GetModelMetrics(const std::string& name, const std::string& version);
+
+  // Renders the metrics of all the versions that served requests, and the gauges of the loaded models.
+  std::string Render(const std::vector<std::shared_ptr<ServedModel>>& models) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<ModelMetrics>> models_;  // protected by mutex_
+};
+
+// The content type of the Prometheus text format.
+constexpr const char* kMetricsContentType = "text/plain; version=0.0.4";
+
+}  // namespace server
+}  // namespace onnxruntime
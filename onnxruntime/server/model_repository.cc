@@ -0,0 +1,277 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_repository.h"
+
+#ifdef USE_CUDA
+#include "core/providers/cuda/cuda_provider_factory.h"
+#endif
+
+namespace onnxruntime {
+namespace server {
+
+std::string ReplicaDevice::ToString() const {
+  if (kind == Kind::Cuda) {
+    return "cuda:" + std::to_string(device_id);
+  }
+  return numa_node < 0 ? "cpu" : "cpu:" + std::to_string(numa_node);
+}
+
+// Parses the number of up to 4 digits after prefix in value. Returns -1 if value isn't prefix and such a number.
+static int ParseDeviceNumber(const std::string& value, const std::string& prefix) {
+  if (value.compare(0, prefix.size(), prefix) != 0 || value.size() == prefix.size() ||
+      value.size() > prefix.size() + 4 || value.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+    return -1;
+  }
+  return std::stoi(value.substr(prefix.size()));
+}
+
+bool ParseReplicaDevice(const std::string& value, ReplicaDevice& device) {
+  if (value == "cpu") {
+    device = ReplicaDevice{};
+    return true;
+  }
+
+  const int numa_node = ParseDeviceNumber(value, "cpu:");
+  if (numa_node >= 0) {
+    device = ReplicaDevice{};
+    device.numa_node = numa_node;
+    return true;
+  }
+
+  const int device_id = ParseDeviceNumber(value, "cuda:");
+  if (device_id < 0) {
+    return false;
+  }
+  device = ReplicaDevice{};
+  device.kind = ReplicaDevice::Kind::Cuda;
+  device.device_id = device_id;
+  return true;
+}
+
+ModelReplica::ModelReplica(Ort::Session&& session, const ReplicaDevice& device)
+    : session(std::move(session)), device(device) {}
+
+ServedModel::ServedModel(const std::string& name, const std::string& version,
+                         std::vector<std::unique_ptr<ModelReplica>>&& replicas)
+    : name(name), version(version), replicas(std::move(replicas)) {
+  // the replicas are sessions of the same model, so they have the same outputs
+  const auto& session = this->replicas.front()->session;
+  auto output_count = session.GetOutputCount();
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0; i < output_count; i++) {
+    auto output_name = session.GetOutputName(i, allocator);
+    output_names.push_back(output_name);
+    allocator.Free(output_name);
+  }
+}
+
+ModelReplica& ServedModel::LeastLoadedReplica() {
+  const size_t count = replicas.size();
+  const size_t first = count == 1 ? 0 : next_replica_++ % count;
+  auto* least_loaded = replicas[first].get();
+  for (size_t i = 1; i < count; ++i) {
+    auto* replica = replicas[(first + i) % count].get();
+    if (replica->in_flight < least_loaded->in_flight) {
+      least_loaded = replica;
+    }
+  }
+  return *least_loaded;
+}
+
+bool ModelRepository::VersionLess::operator()(const std::string& a, const std::string& b) const {
+  // versions are decimal numbers, possibly with leading zeros
+  auto a_begin = a.find_first_not_of('0');
+  auto b_begin = b.find_first_not_of('0');
+  auto a_digits = a_begin == std::string::npos ? 0 : a.size() - a_begin;
+  auto b_digits = b_begin == std::string::npos ? 0 : b.size() - b_begin;
+  if (a_digits != b_digits) {
+    return a_digits < b_digits;
+  }
+  auto a_number = a.compare(a.size() - a_digits, a_digits, b, b.size() - b_digits, b_digits);
+  return a_number != 0 ? a_number < 0 : a < b;
+}
+
+ModelRepository::ModelRepository(Ort::Env& env, std::shared_ptr<spdlog::logger> logger)
+    : env_(env), logger_(std::move(logger)) {
+  session_options_.EnableGlobalThreadPools();
+  session_options_.EnableSharedInitializers();
+  devices_.emplace_back();
+}
+
+void ModelRepository::EnableBatching(const BatchingOptions& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  batching_options_ = options;
+}
+
+void ModelRepository::EnableAdmissionControl(const AdmissionOptions& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  admission_options_ = options;
+}
+
+void ModelRepository::SetReplicaDevices(const std::vector<ReplicaDevice>& devices) {
+  if (devices.empty()) {
+    throw Ort::Exception("A model needs at least one replica", ORT_INVALID_ARGUMENT);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  devices_ = devices;
+}
+
+void ModelRepository::EnableResponseCache(const ResponseCacheOptions& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_options_ = options;
+}
+
+void ModelRepository::EnableRemoteEmbeddings(const std::shared_ptr<RemoteEmbeddingTables>& tables) {
+  if (remote_embeddings_ != nullptr) {
+    throw Ort::Exception("Remote embedding tables are already enabled", ORT_INVALID_ARGUMENT);
+  }
+  session_options_.Add(tables->GetCustomOpDomain());
+  remote_embeddings_ = tables;
+}
+
+void ModelRepository::EnableTracing(RequestTracer* tracer) {
+  session_options_.SetRunTraceCallbacks(nullptr, &RequestTracer::EndSessionSpan, tracer);
+}
+
+void ModelRepository::LoadModel(const std::string& name, const std::string& version, const std::string& model_path) {
+  BatchingOptions batching_options;
+  AdmissionOptions admission_options;
+  ResponseCacheOptions cache_options;
+  std::vector<ReplicaDevice> devices;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batching_options = batching_options_;
+    admission_options = admission_options_;
+    cache_options = cache_options_;
+    devices = devices_;
+  }
+
+  // The new sessions are ready to serve before they're published, the lock is only held to swap them in.
+  std::vector<std::unique_ptr<ModelReplica>> replicas;
+  for (const auto& device : devices) {
+    auto replica = std::make_unique<ModelReplica>(CreateSession(model_path, device), device);
+    try {
+      replica->session.Warmup(nullptr, nullptr, nullptr, 0);
+    } catch (const Ort::Exception& e) {
+      // a model whose inputs can't be made up from its input shapes is served cold
+      logger_->warn("Warming up model {} version {} on {} failed: {}", name, version, device.ToString(), e.what());
+    }
+    if (batching_options.max_batch_size > 1) {
+      replica->batcher = std::make_unique<RequestBatcher>(replica->session, batching_options);
+    }
+    replicas.push_back(std::move(replica));
+  }
+
+  auto model = std::make_shared<ServedModel>(name, version, std::move(replicas));
+  if (admission_options.max_concurrent_runs > 0) {
+    model->admission = std::make_unique<AdmissionController>(admission_options);
+  }
+  if (cache_options.max_bytes > 0) {
+    model->cache = std::make_unique<ResponseCache>(cache_options);
+  }
+
+  std::shared_ptr<ServedModel> previous;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = models_[name][version];
+    previous = std::move(slot);
+    slot = std::move(model);
+  }
+
+  // the requests still running on the previous version keep it alive until they are done
+  logger_->info("{} model {} version {} from {} with {} replica(s)", previous ? "Reloaded" : "Loaded", name, version,
+                model_path, devices.size());
+}
+
+Ort::Session ModelRepository::CreateSession(const std::string& model_path, const ReplicaDevice& device) {
+  if (device.kind == ReplicaDevice::Kind::Cpu) {
+    if (device.numa_node < 0) {
+      return Ort::Session(env_, model_path.c_str(), session_options_);
+    }
+
+    // A replica pinned to a NUMA node runs on its own thread pools restricted to the processors of the node, and
+    // holds its own copy of the weights in the memory of the node rather than sharing those of the other replicas.
+    auto options = session_options_.Clone();
+    options.DisableGlobalThreadPools();
+    options.DisableSharedInitializers();
+    options.SetThreadPoolNumaNode(device.numa_node);
+    options.SetInterOpThreadPoolNumaNode(device.numa_node);
+    options.SetCpuMemNumaNode(device.numa_node);
+    return Ort::Session(env_, model_path.c_str(), options);
+  }
+
+#ifdef USE_CUDA
+  auto options = session_options_.Clone();
+  ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_CUDA(options, device.device_id));
+  return Ort::Session(env_, model_path.c_str(), options);
+#else
+  throw Ort::Exception("Replica device " + device.ToString() + " requires a build with CUDA", ORT_NOT_IMPLEMENTED);
+#endif
+}
+
+bool ModelRepository::UnloadModel(const std::string& name, const std::string& version) {
+  std::shared_ptr<ServedModel> unloaded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto model = models_.find(name);
+    if (model == models_.end()) {
+      return false;
+    }
+
+    auto& versions = model->second;
+    auto match = versions.find(version);
+    if (match == versions.end()) {
+      return false;
+    }
+
+    unloaded = std::move(match->second);
+    versions.erase(match);
+    if (versions.empty()) {
+      models_.erase(model);
+    }
+  }
+
+  logger_->info("Unloaded model {} version {}", name, version);
+  return true;
+}
+
+std::shared_ptr<ServedModel> ModelRepository::GetModel(const std::string& name, const std::string& version) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto model = models_.find(name);
+  if (model == models_.end()) {
+    return nullptr;
+  }
+
+  const auto& versions = model->second;
+  if (version.empty()) {
+    return versions.rbegin()->second;
+  }
+
+  auto match = versions.find(version);
+  return match == versions.end() ? nullptr : match->second;
+}
+
+std::shared_ptr<ServedModel> ModelRepository::GetSingleModel() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (models_.size() != 1 || models_.begin()->second.size() != 1) {
+    return nullptr;
+  }
+
+  return models_.begin()->second.begin()->second;
+}
+
+std::vector<std::shared_ptr<ServedModel>> ModelRepository::GetModels() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<ServedModel>> models;
+  for (const auto& model : models_) {
+    for (const auto& version : model.second) {
+      models.push_back(version.second);
+    }
+  }
+  return models;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
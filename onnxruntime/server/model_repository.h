@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+#include <spdlog/spdlog.h>
+
+#include "admission.h"
+#include "batcher.h"
+#include "remote_embedding.h"
+#include "response_cache.h"
+#include "tracing.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Where a replica of a model runs.
+struct ReplicaDevice {
+  enum class Kind {
+    Cpu,
+    Cuda,
+  };
+
+  Kind kind = Kind::Cpu;
+  int device_id = 0;   // of the CUDA device
+  int numa_node = -1;  // of a CPU replica pinned to a NUMA node, -1 if it runs on the shared thread pools
+
+  std::string ToString() const;
+};
+
+// Parses "cpu", "cpu:<numa node>" or "cuda:<device id>". Returns false if value is none of them.
+bool ParseReplicaDevice(const std::string& value, /* out */ ReplicaDevice& device);
+
+// A session of a model bound to a device. The replicas of a model serve its requests concurrently.
+struct ModelReplica {
+  ModelReplica(Ort::Session&& session, const ReplicaDevice& device);
+  ModelReplica(const ModelReplica&) = delete;
+
+  Ort::Session session;
+  const ReplicaDevice device;
+  // The batcher requests are run through, or nullptr if batching isn't enabled. Declared after the session, which
+  // it uses until it is destroyed.
+  std::unique_ptr<RequestBatcher> batcher;
+  // Requests dispatched to the replica that aren't done, including those waiting for their batch.
+  std::atomic<size_t> in_flight{0};
+};
+
+// Counts a request as in flight on a replica while it's alive.
+class ReplicaLease {
+ public:
+  explicit ReplicaLease(ModelReplica& replica) : replica_(replica) { ++replica_.in_flight; }
+  ~ReplicaLease() { --replica_.in_flight; }
+  ReplicaLease(const ReplicaLease&) = delete;
+  ReplicaLease& operator=(const ReplicaLease&) = delete;
+
+  ModelReplica& replica() const { return replica_; }
+
+ private:
+  ModelReplica& replica_;
+};
+
+// A loaded version of a model. Requests hold a shared_ptr to it while they run, so a version that is replaced or
+// unloaded is only destroyed once its in-flight requests are done.
+struct ServedModel {
+  ServedModel(const std::string& name, const std::string& version,
+              std::vector<std::unique_ptr<ModelReplica>>&& replicas);
+  ServedModel(const ServedModel&) = delete;
+
+  // The replica with the fewest requests in flight. Ties go to the replicas in turn, so that idle replicas share
+  // the requests too.
+  ModelReplica& LeastLoadedReplica();
+
+  const std::string name;
+  const std::string version;
+  const std::vector<std::unique_ptr<ModelReplica>> replicas;  // at least one
+  std::vector<std::string> output_names;
+  // Bounds the requests run at the same time, or nullptr if admission control isn't enabled.
+  std::unique_ptr<AdmissionController> admission;
+  // The outputs of recent requests, or nullptr if response caching isn't enabled.
+  std::unique_ptr<ResponseCache> cache;
+
+ private:
+  std::atomic<size_t> next_replica_{0};
+};
+
+/**
+ * The models served by the process, keyed by name and version. All the sessions share the thread pools of the
+ * environment, and the sessions loaded from the same file share the weights that didn't change, so reloading a
+ * model while its previous session still serves requests doesn't hold two copies of them.
+ *
+ * LoadModel creates and warms up the new session before publishing it, so replacing a version (hot reload) neither
+ * drops the requests in flight on the old session nor makes the next requests pay for a cold start.
+ */
+class ModelRepository {
+ public:
+  ModelRepository(Ort::Env& env, std::shared_ptr<spdlog::logger> logger);
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Batches the concurrent requests of the versions loaded after this call, if options.max_batch_size > 1.
+  void EnableBatching(const BatchingOptions& options);
+
+  // Bounds the concurrent requests of the versions loaded after this call, if options.max_concurrent_runs > 0.
+  // A reloaded version starts with an empty queue, the requests running on the previous one aren't counted.
+  void EnableAdmissionControl(const AdmissionOptions& options);
+
+  // Runs the versions loaded after this call with a replica on each of devices, and dispatches each request to
+  // the least loaded one. One CPU replica by default. Replicas on the CPU share the weights and the thread pools.
+  void SetReplicaDevices(const std::vector<ReplicaDevice>& devices);
+
+  // Caches the outputs of the requests of the versions loaded after this call, if options.max_bytes > 0. Each
+  // version has its own cache, so a reloaded version doesn't serve the outputs of the previous one.
+  void EnableResponseCache(const ResponseCacheOptions& options);
+
+  // Registers the RemoteGather op looking up tables in the sessions of the versions loaded after this call. Must be
+  // called before the models using it are loaded, and only once.
+  void EnableRemoteEmbeddings(const std::shared_ptr<RemoteEmbeddingTables>& tables);
+
+  // Reports the spans of the runs of the sessions of the versions loaded after this call to tracer, which must
+  // outlive them.
+  void EnableTracing(RequestTracer* tracer);
+
+  // Loads (or replaces) a version of a model. Throws Ort::Exception if the model can't be loaded on all of the
+  // replica devices, in which case the version being served, if any, is left in place.
+  void LoadModel(const std::string& name, const std::string& version, const std::string& model_path);
+
+  // Stops serving a version of a model. Returns false if it isn't loaded.
+  bool UnloadModel(const std::string& name, const std::string& version);
+
+  // The requested version of a model, or its latest version if version is empty. nullptr if there's no match.
+  std::shared_ptr<ServedModel> GetModel(const std::string& name, const std::string& version) const;
+
+  // The only model served, or nullptr if there is none or more than one.
+  std::shared_ptr<ServedModel> GetSingleModel() const;
+
+  // All the versions of all the models served.
+  std::vector<std::shared_ptr<ServedModel>> GetModels() const;
+
+ private:
+  // Orders the versions numerically, so the last one is the latest.
+  struct VersionLess {
+    bool operator()(const std::string& a, const std::string& b) const;
+  };
+  using Versions = std::map<std::string, std::shared_ptr<ServedModel>, VersionLess>;
+
+  // A session of the model of model_path, with the execution provider of device.
+  Ort::Session CreateSession(const std::string& model_path, const ReplicaDevice& device);
+
+  Ort::Env& env_;
+  const std::shared_ptr<spdlog::logger> logger_;
+  Ort::SessionOptions session_options_;
+  // declared before the models, whose sessions must be released before the tables they look up
+  std::shared_ptr<RemoteEmbeddingTables> remote_embeddings_;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Versions> models_;  // protected by mutex_
+  BatchingOptions batching_options_;        // protected by mutex_
+  AdmissionOptions admission_options_;      // protected by mutex_
+  ResponseCacheOptions cache_options_;      // protected by mutex_
+  std::vector<ReplicaDevice> devices_;      // protected by mutex_
+};
+
+}  // namespace server
+}  // namespace onnxruntime
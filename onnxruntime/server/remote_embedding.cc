@@ -0,0 +1,294 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "remote_embedding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace onnxruntime {
+namespace server {
+
+EmbeddingRowCache::EmbeddingRowCache(size_t capacity, int64_t row_size)
+    : capacity_(capacity), row_size_(static_cast<size_t>(row_size)) {}
+
+bool EmbeddingRowCache::Lookup(int64_t row, float* values) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto match = index_.find(row);
+  if (match == index_.end()) {
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, match->second);
+  std::memcpy(values, match->second->second.data(), row_size_ * sizeof(float));
+  return true;
+}
+
+void EmbeddingRowCache::Insert(int64_t row, const float* values) {
+  if (capacity_ == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto match = index_.find(row);
+  if (match != index_.end()) {
+    // inserted by a concurrent lookup of the same row
+    entries_.splice(entries_.begin(), entries_, match->second);
+    return;
+  }
+
+  if (entries_.size() < capacity_) {
+    entries_.emplace_front(row, std::vector<float>(row_size_));
+  } else {
+    // the evicted entry is reused for the row, so that a full cache doesn't allocate
+    index_.erase(entries_.back().first);
+    entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+    entries_.front().first = row;
+  }
+  std::memcpy(entries_.front().second.data(), values, row_size_ * sizeof(float));
+  index_[row] = entries_.begin();
+}
+
+size_t EmbeddingRowCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+RemoteEmbeddingTable::RemoteEmbeddingTable(const RemoteEmbeddingTableOptions& options,
+                                           const EmbeddingRowFetcherFactory& fetcher_factory)
+    : name_(options.name),
+      row_size_(options.row_size),
+      max_batch_rows_(std::max<size_t>(options.max_batch_rows, 1)) {
+  if (row_size_ <= 0 || options.shards.empty()) {
+    throw Ort::Exception("Remote table " + name_ + " needs a positive row size and at least one shard",
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  auto ranges = options.shards;
+  std::sort(ranges.begin(), ranges.end(), [](const RemoteEmbeddingShard& a, const RemoteEmbeddingShard& b) {
+    return a.first_row < b.first_row;
+  });
+  for (const auto& range : ranges) {
+    if (range.first_row != row_count_ || range.row_count <= 0) {
+      throw Ort::Exception("The shards of remote table " + name_ + " don't hold its rows from 0 without gaps or " +
+                               "overlaps: the shard at " + range.address + " starts at row " +
+                               std::to_string(range.first_row) + " instead of " + std::to_string(row_count_),
+                           ORT_INVALID_ARGUMENT);
+    }
+    row_count_ += range.row_count;
+  }
+
+  if (options.cache_rows > 0) {
+    cache_ = std::make_unique<EmbeddingRowCache>(options.cache_rows, row_size_);
+  }
+
+  const size_t fetcher_count = std::max<size_t>(options.max_fetches_per_shard, 1);
+  for (const auto& range : ranges) {
+    auto shard = std::make_unique<Shard>();
+    shard->range = range;
+    shard->fetch = fetcher_factory(range);
+    shards_.push_back(std::move(shard));
+  }
+  for (auto& shard : shards_) {
+    for (size_t i = 0; i < fetcher_count; ++i) {
+      shard->fetchers.emplace_back(&RemoteEmbeddingTable::RunFetcher, this, std::ref(*shard));
+    }
+  }
+}
+
+RemoteEmbeddingTable::~RemoteEmbeddingTable() {
+  for (auto& shard : shards_) {
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->stopping = true;
+    }
+    shard->queued.notify_all();
+  }
+  for (auto& shard : shards_) {
+    for (auto& fetcher : shard->fetchers) {
+      fetcher.join();
+    }
+  }
+}
+
+size_t RemoteEmbeddingTable::FindShard(int64_t row) const {
+  auto next = std::upper_bound(shards_.begin(), shards_.end(), row,
+                               [](int64_t r, const std::unique_ptr<Shard>& shard) {
+                                 return r < shard->range.first_row;
+                               });
+  return static_cast<size_t>(next - shards_.begin()) - 1;
+}
+
+void RemoteEmbeddingTable::Lookup(const int64_t* indices, size_t count, float* values) {
+  const size_t row_size = static_cast<size_t>(row_size_);
+
+  // the positions of each row missing from the cache, which is fetched once for all of them
+  std::unordered_map<int64_t, std::vector<size_t>> missing;
+  std::vector<std::shared_ptr<PendingFetch>> fetches(shards_.size());
+  for (size_t i = 0; i < count; ++i) {
+    int64_t row = indices[i] < 0 ? indices[i] + row_count_ : indices[i];
+    if (row < 0 || row >= row_count_) {
+      throw Ort::Exception("Index " + std::to_string(indices[i]) + " is out of the " + std::to_string(row_count_) +
+                               " rows of remote table " + name_,
+                           ORT_INVALID_ARGUMENT);
+    }
+
+    auto match = missing.find(row);
+    if (match != missing.end()) {
+      match->second.push_back(i);
+    } else if (cache_ == nullptr || !cache_->Lookup(row, values + i * row_size)) {
+      missing[row].push_back(i);
+      auto& fetch = fetches[FindShard(row)];
+      if (fetch == nullptr) {
+        fetch = std::make_shared<PendingFetch>();
+      }
+      fetch->rows.push_back(row);
+    }
+  }
+
+  // all the fetches are queued before waiting for any, so that the shards look up their rows at the same time
+  std::vector<std::future<void>> done(shards_.size());
+  for (size_t s = 0; s < shards_.size(); ++s) {
+    if (fetches[s] != nullptr) {
+      done[s] = fetches[s]->done.get_future();
+      auto& shard = *shards_[s];
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.queue.push_back(fetches[s]);
+      }
+      shard.queued.notify_one();
+    }
+  }
+
+  for (size_t s = 0; s < shards_.size(); ++s) {
+    if (fetches[s] == nullptr) {
+      continue;
+    }
+
+    done[s].get();
+    const auto& fetch = *fetches[s];
+    for (size_t r = 0; r < fetch.rows.size(); ++r) {
+      const float* row_values = fetch.values.data() + r * row_size;
+      for (auto i : missing[fetch.rows[r]]) {
+        std::memcpy(values + i * row_size, row_values, row_size * sizeof(float));
+      }
+      if (cache_ != nullptr) {
+        cache_->Insert(fetch.rows[r], row_values);
+      }
+    }
+  }
+}
+
+void RemoteEmbeddingTable::RunFetcher(Shard& shard) {
+  const size_t row_size = static_cast<size_t>(row_size_);
+  for (;;) {
+    // takes the lookups queued while the previous fetches were in flight, up to max_batch_rows_ rows
+    std::vector<std::shared_ptr<PendingFetch>> batch;
+    size_t batch_rows = 0;
+    {
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.queued.wait(lock, [&shard]() { return shard.stopping || !shard.queue.empty(); });
+      if (shard.queue.empty()) {
+        return;
+      }
+
+      do {
+        batch_rows += shard.queue.front()->rows.size();
+        batch.push_back(std::move(shard.queue.front()));
+        shard.queue.pop_front();
+      } while (!shard.queue.empty() && batch_rows + shard.queue.front()->rows.size() <= max_batch_rows_);
+    }
+
+    try {
+      if (batch.size() == 1) {
+        auto& fetch = *batch.front();
+        shard.fetch(name_, fetch.rows, fetch.values);
+        if (fetch.values.size() != fetch.rows.size() * row_size) {
+          throw Ort::Exception("The shard of remote table " + name_ + " at " + shard.range.address +
+                                   " returned a wrong number of values",
+                               ORT_FAIL);
+        }
+      } else {
+        // the rows needed by several lookups are fetched once
+        std::vector<int64_t> rows;
+        std::unordered_map<int64_t, size_t> positions;
+        for (const auto& fetch : batch) {
+          for (auto row : fetch->rows) {
+            if (positions.emplace(row, rows.size()).second) {
+              rows.push_back(row);
+            }
+          }
+        }
+
+        std::vector<float> values;
+        shard.fetch(name_, rows, values);
+        if (values.size() != rows.size() * row_size) {
+          throw Ort::Exception("The shard of remote table " + name_ + " at " + shard.range.address +
+                                   " returned a wrong number of values",
+                               ORT_FAIL);
+        }
+
+        for (auto& fetch : batch) {
+          fetch->values.resize(fetch->rows.size() * row_size);
+          for (size_t r = 0; r < fetch->rows.size(); ++r) {
+            std::memcpy(fetch->values.data() + r * row_size, values.data() + positions[fetch->rows[r]] * row_size,
+                        row_size * sizeof(float));
+          }
+        }
+      }
+    } catch (...) {
+      auto error = std::current_exception();
+      for (auto& fetch : batch) {
+        fetch->done.set_exception(error);
+      }
+      continue;
+    }
+
+    for (auto& fetch : batch) {
+      fetch->done.set_value();
+    }
+  }
+}
+
+void RemoteGatherKernel::Compute(OrtKernelContext* context) {
+  const OrtValue* indices = api_.KernelContext_GetInput(context, 0);
+  OrtTensorTypeAndShapeInfo* indices_info = api_.GetTensorTypeAndShape(indices);
+  auto output_shape = api_.GetTensorShape(indices_info);
+  const size_t count = api_.GetTensorShapeElementCount(indices_info);
+  api_.ReleaseTensorTypeAndShapeInfo(indices_info);
+
+  output_shape.push_back(table_.RowSize());
+  OrtValue* output = api_.KernelContext_GetOutput(context, 0, output_shape.data(), output_shape.size());
+  table_.Lookup(api_.GetTensorData<int64_t>(indices), count, api_.GetTensorMutableData<float>(output));
+}
+
+void* RemoteGatherOp::CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) {
+  const auto name = api.KernelInfoGetAttribute<std::string>(info, "table");
+  auto* table = tables_.GetTable(name);
+  if (table == nullptr) {
+    throw Ort::Exception("RemoteGather looks up table " + name + ", which isn't a remote table of the server",
+                         ORT_INVALID_ARGUMENT);
+  }
+  return new RemoteGatherKernel(api, *table);
+}
+
+RemoteEmbeddingTables::RemoteEmbeddingTables(const EmbeddingRowFetcherFactory& fetcher_factory)
+    : fetcher_factory_(fetcher_factory), op_(*this), domain_(kRemoteEmbeddingDomain) {
+  domain_.Add(&op_);
+}
+
+void RemoteEmbeddingTables::AddTable(const RemoteEmbeddingTableOptions& options) {
+  if (tables_.count(options.name) != 0) {
+    throw Ort::Exception("Remote table " + options.name + " is added twice", ORT_INVALID_ARGUMENT);
+  }
+  tables_.emplace(options.name, std::make_unique<RemoteEmbeddingTable>(options, fetcher_factory_));
+}
+
+RemoteEmbeddingTable* RemoteEmbeddingTables::GetTable(const std::string& name) const {
+  auto match = tables_.find(name);
+  return match == tables_.end() ? nullptr : match->second.get();
+}
+
+}  // namespace server
+}  // namespace onnxruntime
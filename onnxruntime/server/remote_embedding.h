@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The domain of the RemoteGather op.
+constexpr const char* kRemoteEmbeddingDomain = "com.microsoft.server";
+
+// A range of rows of a table held by another server.
+struct RemoteEmbeddingShard {
+  // host:port of the gRPC endpoint of the server.
+  std::string address;
+  int64_t first_row = 0;
+  int64_t row_count = 0;
+};
+
+struct RemoteEmbeddingTableOptions {
+  std::string name;
+  // Number of values of a row.
+  int64_t row_size = 0;
+  // The shards of the table, which together hold its rows from 0 without gaps or overlaps.
+  std::vector<RemoteEmbeddingShard> shards;
+  // Number of recently used rows kept locally. 0 disables the cache.
+  size_t cache_rows = 0;
+  // Largest number of rows fetched from a shard at once, unless a single lookup needs more.
+  size_t max_batch_rows = 4096;
+  // Largest number of fetches from a shard at the same time.
+  size_t max_fetches_per_shard = 2;
+};
+
+// Fetches rows of a table, given by their index in the whole table, from a shard. Sets values to the rows in the
+// order of rows. Throws Ort::Exception if they can't be fetched.
+using EmbeddingRowFetcher =
+    std::function<void(const std::string& table, const std::vector<int64_t>& rows, std::vector<float>& values)>;
+using EmbeddingRowFetcherFactory = std::function<EmbeddingRowFetcher(const RemoteEmbeddingShard& shard)>;
+
+/**
+ * The least recently used rows of a table. Thread safe.
+ */
+class EmbeddingRowCache {
+ public:
+  EmbeddingRowCache(size_t capacity, int64_t row_size);
+  EmbeddingRowCache(const EmbeddingRowCache&) = delete;
+  EmbeddingRowCache& operator=(const EmbeddingRowCache&) = delete;
+
+  // Copies the row to values. Returns false if it isn't cached.
+  bool Lookup(int64_t row, float* values);
+
+  // Caches a copy of the row, evicting the least recently used one if the cache is full.
+  void Insert(int64_t row, const float* values);
+
+  size_t Size() const;
+
+ private:
+  using Entry = std::pair<int64_t, std::vector<float>>;
+  using EntryList = std::list<Entry>;
+
+  const size_t capacity_;
+  const size_t row_size_;
+
+  mutable std::mutex mutex_;
+  EntryList entries_;                                       // protected by mutex_, most recently used first
+  std::unordered_map<int64_t, EntryList::iterator> index_;  // protected by mutex_
+};
+
+/**
+ * An embedding table whose rows are held by the shards of other servers, looked up by the RemoteGather nodes of
+ * the models of this one.
+ *
+ * A lookup fetches each of its rows missing from the cache once, from all the shards at the same time. The fetches
+ * from a shard are batched across the concurrent lookups: each shard has a few fetchers, which fetch all the rows
+ * queued while their previous fetch was in flight at once, so that the lookups of concurrent requests share round
+ * trips and the round trips to a shard overlap.
+ */
+class RemoteEmbeddingTable {
+ public:
+  // Throws Ort::Exception if the shards don't hold the rows from 0 without gaps or overlaps.
+  RemoteEmbeddingTable(const RemoteEmbeddingTableOptions& options, const EmbeddingRowFetcherFactory& fetcher_factory);
+  // Waits for the fetches in flight.
+  ~RemoteEmbeddingTable();
+  RemoteEmbeddingTable(const RemoteEmbeddingTable&) = delete;
+  RemoteEmbeddingTable& operator=(const RemoteEmbeddingTable&) = delete;
+
+  // Writes the rows of indices to values, RowSize() values per index. Negative indices count from the end of the
+  // table, like those of Gather. Throws Ort::Exception if an index is out of range or a fetch fails.
+  void Lookup(const int64_t* indices, size_t count, float* values);
+
+  const std::string& Name() const { return name_; }
+  int64_t RowSize() const { return row_size_; }
+  int64_t RowCount() const { return row_count_; }
+
+ private:
+  // The rows a lookup needs from a shard.
+  struct PendingFetch {
+    std::vector<int64_t> rows;
+    std::vector<float> values;
+    std::promise<void> done;
+  };
+
+  struct Shard {
+    RemoteEmbeddingShard range;
+    EmbeddingRowFetcher fetch;
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::deque<std::shared_ptr<PendingFetch>> queue;  // protected by mutex
+    bool stopping = false;                            // protected by mutex
+    std::vector<std::thread> fetchers;
+  };
+
+  // The index in shards_ of the shard of row.
+  size_t FindShard(int64_t row) const;
+
+  // Fetches the rows queued for the shard until the table is destroyed.
+  void RunFetcher(Shard& shard);
+
+  const std::string name_;
+  const int64_t row_size_;
+  const size_t max_batch_rows_;
+  int64_t row_count_ = 0;
+  std::vector<std::unique_ptr<Shard>> shards_;  // ordered by first row
+  std::unique_ptr<EmbeddingRowCache> cache_;
+};
+
+// Looks up the rows of indices in a remote table: the output is Gather(table, indices) on axis 0.
+struct RemoteGatherKernel {
+  RemoteGatherKernel(Ort::CustomOpApi api, RemoteEmbeddingTable& table) : api_(api), table_(table) {}
+
+  void Compute(OrtKernelContext* context);
+
+ private:
+  Ort::CustomOpApi api_;
+  RemoteEmbeddingTable& table_;
+};
+
+class RemoteEmbeddingTables;
+
+// RemoteGather(indices) with a string attribute table, the name of the remote table.
+struct RemoteGatherOp : Ort::CustomOpBase<RemoteGatherOp, RemoteGatherKernel> {
+  explicit RemoteGatherOp(const RemoteEmbeddingTables& tables) : tables_(tables) {}
+
+  // Throws Ort::Exception if the table isn't one of tables_.
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info);
+  const char* GetName() const { return "RemoteGather"; }
+
+  size_t GetInputTypeCount() const { return 1; }
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64; }
+
+  size_t GetOutputTypeCount() const { return 1; }
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; }
+
+ private:
+  const RemoteEmbeddingTables& tables_;
+};
+
+/**
+ * The remote tables of a server, and the custom op domain of the RemoteGather op that looks them up. The sessions
+ * using the domain must be released before the tables.
+ */
+class RemoteEmbeddingTables {
+ public:
+  explicit RemoteEmbeddingTables(const EmbeddingRowFetcherFactory& fetcher_factory);
+  RemoteEmbeddingTables(const RemoteEmbeddingTables&) = delete;
+  RemoteEmbeddingTables& operator=(const RemoteEmbeddingTables&) = delete;
+
+  // Adds a table. Must be called before the sessions using the domain are created. Throws Ort::Exception if there
+  // is already a table with the name or if its shards are invalid.
+  void AddTable(const RemoteEmbeddingTableOptions& options);
+
+  // The table named name, or nullptr if there's none.
+  RemoteEmbeddingTable* GetTable(const std::string& name) const;
+
+  OrtCustomOpDomain* GetCustomOpDomain() { return domain_; }
+
+ private:
+  const EmbeddingRowFetcherFactory fetcher_factory_;
+  std::map<std::string, std::unique_ptr<RemoteEmbeddingTable>> tables_;
+  RemoteGatherOp op_;
+  Ort::CustomOpDomain domain_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
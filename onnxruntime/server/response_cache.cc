@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "response_cache.h"
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+template <typename T>
+static void Append(const T& value, std::string& key) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AppendString(const std::string& value, std::string& key) {
+  Append(value.size(), key);
+  key.append(value);
+}
+
+// Gets the type, shape and size of the data of a tensor. Returns false if it isn't a tensor that can be copied as
+// memory.
+static bool TensorBytes(const Ort::Value& value, ONNXTensorElementDataType& type, std::vector<int64_t>& shape,
+                        size_t& bytes) {
+  if (!value.IsTensor()) {
+    return false;
+  }
+
+  auto info = value.GetTensorTypeAndShapeInfo();
+  type = info.GetElementType();
+  shape = info.GetShape();
+  bytes = info.GetElementCount() * TensorElementSize(type);
+  return TensorElementSize(type) != 0;
+}
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options) : options_(options) {}
+
+bool ResponseCache::MakeKey(const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values,
+                            const std::vector<std::string>& output_names, std::string& key) {
+  // the inputs are ordered by name, so that the same inputs make the same key whatever the order of the request
+  std::vector<size_t> order(input_names.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(),
+            [&input_names](size_t a, size_t b) { return input_names[a] < input_names[b]; });
+
+  key.clear();
+  Append(order.size(), key);
+  for (size_t i : order) {
+    ONNXTensorElementDataType type;
+    std::vector<int64_t> shape;
+    size_t bytes;
+    if (!TensorBytes(input_values[i], type, shape, bytes)) {
+      key.clear();
+      return false;
+    }
+
+    AppendString(input_names[i], key);
+    Append(type, key);
+    Append(shape.size(), key);
+    key.append(reinterpret_cast<const char*>(shape.data()), shape.size() * sizeof(int64_t));
+    key.append(const_cast<Ort::Value&>(input_values[i]).GetTensorMutableData<char>(), bytes);
+  }
+
+  Append(output_names.size(), key);
+  for (const auto& name : output_names) {
+    AppendString(name, key);
+  }
+  return true;
+}
+
+bool ResponseCache::Lookup(const std::string& key, std::vector<Ort::Value>& outputs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto match = index_.find(key);
+  if (match == index_.end()) {
+    return false;
+  }
+
+  auto entry = match->second;
+  if (options_.ttl.count() != 0 && entry->expiry <= std::chrono::steady_clock::now()) {
+    Erase(entry);
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, entry);
+
+  outputs.clear();
+  outputs.reserve(entry->outputs.size());
+  for (const auto& tensor : entry->outputs) {
+    auto value = Ort::Value::CreateTensor(allocator_, tensor.shape.data(), tensor.shape.size(), tensor.type);
+    memcpy(value.GetTensorMutableData<char>(), tensor.data.data(), tensor.data.size());
+    outputs.push_back(std::move(value));
+  }
+  return true;
+}
+
+void ResponseCache::Insert(const std::string& key, std::vector<Ort::Value>& outputs) {
+  Entry entry;
+  entry.bytes = key.size();
+  for (auto& output : outputs) {
+    CachedTensor tensor;
+    size_t bytes;
+    if (!TensorBytes(output, tensor.type, tensor.shape, bytes)) {
+      return;
+    }
+
+    tensor.data.assign(output.GetTensorMutableData<char>(), bytes);
+    entry.bytes += bytes + tensor.shape.size() * sizeof(int64_t);
+    entry.outputs.push_back(std::move(tensor));
+  }
+  if (entry.bytes > options_.max_bytes) {
+    return;
+  }
+  entry.expiry = std::chrono::steady_clock::now() + options_.ttl;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto match = index_.find(key);
+  if (match != index_.end()) {
+    // a concurrent request with the same inputs cached them first
+    return;
+  }
+
+  while (bytes_ + entry.bytes > options_.max_bytes) {
+    Erase(std::prev(entries_.end()));
+  }
+
+  auto slot = index_.emplace(key, entries_.end()).first;
+  entry.key = &slot->first;
+  bytes_ += entry.bytes;
+  entries_.push_front(std::move(entry));
+  slot->second = entries_.begin();
+}
+
+size_t ResponseCache::SizeInBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+void ResponseCache::Erase(EntryList::iterator entry) {
+  bytes_ -= entry->bytes;
+  index_.erase(*entry->key);
+  entries_.erase(entry);
+}
+
+}  // namespace server
+}  // namespace onnxruntime
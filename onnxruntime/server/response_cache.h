@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct ResponseCacheOptions {
+  // Largest number of bytes of the cached requests and outputs. 0 disables the cache.
+  size_t max_bytes = 0;
+  // How long the outputs of a request are served from the cache. 0 keeps them until they are evicted.
+  std::chrono::milliseconds ttl{0};
+};
+
+/**
+ * Caches the outputs of the requests of a deterministic model, so that a request with the same inputs as a recent
+ * one is answered without running the model. The least recently used entries are evicted to stay within the size
+ * limit.
+ *
+ * An entry is keyed by the bytes of the request: its input names, types, shapes and data, and the output names.
+ * Lookups hash the whole key and compare it on a match, so a hash collision can't return the outputs of another
+ * request. Only requests and outputs of tensors of numeric and bool types are cached.
+ */
+class ResponseCache {
+ public:
+  explicit ResponseCache(const ResponseCacheOptions& options);
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Builds the key of a request. Returns false if it can't be cached.
+  static bool MakeKey(const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values,
+                      const std::vector<std::string>& output_names, /* out */ std::string& key);
+
+  // Sets outputs to copies of the cached outputs of key. Returns false if they aren't cached or have expired.
+  bool Lookup(const std::string& key, /* out */ std::vector<Ort::Value>& outputs);
+
+  // Caches the outputs of key, unless they can't be cached or don't fit.
+  void Insert(const std::string& key, std::vector<Ort::Value>& outputs);
+
+  // Number of bytes of the cached entries.
+  size_t SizeInBytes() const;
+
+ private:
+  struct CachedTensor {
+    ONNXTensorElementDataType type;
+    std::vector<int64_t> shape;
+    std::string data;
+  };
+
+  struct Entry {
+    const std::string* key;  // the key of the entry in index_
+    std::vector<CachedTensor> outputs;
+    size_t bytes;
+    std::chrono::steady_clock::time_point expiry;
+  };
+  using EntryList = std::list<Entry>;
+
+  void Erase(EntryList::iterator entry);
+
+  const ResponseCacheOptions options_;
+  Ort::AllocatorWithDefaultOptions allocator_;
+
+  mutable std::mutex mutex_;
+  EntryList entries_;                                           // protected by mutex_, most recently used first
+  std::unordered_map<std::string, EntryList::iterator> index_;  // protected by mutex_
+  size_t bytes_ = 0;                                            // protected by mutex_
+};
+
+}  // namespace server
+}  // namespace onnxruntime
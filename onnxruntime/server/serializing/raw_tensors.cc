@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "raw_tensors.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace protobufutil = google::protobuf::util;
+
+static constexpr char kMagic[4] = {'O', 'R', 'T', 'T'};
+static constexpr size_t kDataAlignment = 8;
+
+static bool IsLittleEndianHost() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+// Size of an element of type, or 0 if the type has no fixed size.
+static size_t ElementSize(int32_t type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static size_t PaddingTo(size_t offset, size_t alignment) {
+  return (alignment - offset % alignment) % alignment;
+}
+
+static protobufutil::Status InvalidPayload(const std::string& message) {
+  return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "Invalid tensors payload: " + message);
+}
+
+namespace {
+// Reads the fields of a payload in order.
+class PayloadReader {
+ public:
+  explicit PayloadReader(const std::string& payload) : payload_(payload) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    return Read(&value, sizeof(T));
+  }
+
+  bool Read(void* dst, size_t length) {
+    if (length > payload_.size() - offset_) {
+      return false;
+    }
+    memcpy(dst, payload_.data() + offset_, length);
+    offset_ += length;
+    return true;
+  }
+
+  // Skips length bytes and returns where they start, or nullptr if the payload is too short.
+  const char* Skip(size_t length) {
+    if (length > payload_.size() - offset_) {
+      return nullptr;
+    }
+    const char* start = payload_.data() + offset_;
+    offset_ += length;
+    return start;
+  }
+
+  size_t Offset() const { return offset_; }
+
+ private:
+  const std::string& payload_;
+  size_t offset_ = 0;
+};
+}  // namespace
+
+protobufutil::Status ParseRawTensors(const std::string& payload, const OrtMemoryInfo& memory_info,
+                                     MemBufferArray& buffers,
+                                     std::vector<std::string>& names,
+                                     std::vector<Ort::Value>& values) {
+  if (!IsLittleEndianHost()) {
+    return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED,
+                                "Tensors payloads are only supported on little endian hosts");
+  }
+
+  PayloadReader reader(payload);
+  char magic[sizeof(kMagic)];
+  uint32_t count;
+  if (!reader.Read(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !reader.Read(count)) {
+    return InvalidPayload("missing header");
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t name_length;
+    const char* name;
+    int32_t type;
+    uint32_t rank;
+    if (!reader.Read(name_length) || (name = reader.Skip(name_length)) == nullptr || !reader.Read(type) ||
+        !reader.Read(rank) || rank > (payload.size() - reader.Offset()) / sizeof(int64_t)) {
+      return InvalidPayload("truncated tensor header");
+    }
+
+    std::vector<int64_t> shape(rank);
+    uint64_t data_length;
+    if (!reader.Read(shape.data(), rank * sizeof(int64_t)) || !reader.Read(data_length)) {
+      return InvalidPayload("truncated tensor header");
+    }
+
+    std::string tensor_name(name, name_length);
+    auto element_size = ElementSize(type);
+    if (element_size == 0) {
+      return InvalidPayload("unsupported element type " + std::to_string(type) + " of tensor " + tensor_name);
+    }
+
+    uint64_t element_count = 1;
+    for (auto dim : shape) {
+      if (dim < 0 || (dim != 0 && element_count > UINT64_MAX / static_cast<uint64_t>(dim))) {
+        return InvalidPayload("invalid dims of tensor " + tensor_name);
+      }
+      element_count *= static_cast<uint64_t>(dim);
+    }
+    if (element_count > UINT64_MAX / element_size || element_count * element_size != data_length) {
+      return InvalidPayload("the data length of tensor " + tensor_name + " doesn't match its dims");
+    }
+
+    const char* data;
+    if (reader.Skip(PaddingTo(reader.Offset(), kDataAlignment)) == nullptr ||
+        (data = reader.Skip(static_cast<size_t>(data_length))) == nullptr) {
+      return InvalidPayload("truncated data of tensor " + tensor_name);
+    }
+
+    // the data is aligned in the payload, so it's only copied if the payload itself isn't
+    void* tensor_data = const_cast<char*>(data);
+    if (reinterpret_cast<uintptr_t>(data) % element_size != 0) {
+      tensor_data = buffers.AllocNewBuffer(static_cast<size_t>(data_length));
+      memcpy(tensor_data, data, static_cast<size_t>(data_length));
+    }
+
+    // the tensor is only read by the session, so the payload isn't modified despite the const_cast
+    values.push_back(Ort::Value::CreateTensor(&memory_info, tensor_data, static_cast<size_t>(data_length),
+                                              shape.data(), shape.size(),
+                                              static_cast<ONNXTensorElementDataType>(type)));
+    names.push_back(std::move(tensor_name));
+  }
+
+  if (reader.Offset() != payload.size()) {
+    return InvalidPayload("unexpected data after the last tensor");
+  }
+
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status WriteRawTensors(const std::vector<std::string>& names,
+                                     std::vector<Ort::Value>& values,
+                                     std::string& payload) {
+  if (!IsLittleEndianHost()) {
+    return protobufutil::Status(protobufutil::error::Code::UNIMPLEMENTED,
+                                "Tensors payloads are only supported on little endian hosts");
+  }
+
+  auto append = [&payload](const void* data, size_t length) {
+    payload.append(static_cast<const char*>(data), length);
+  };
+
+  payload.clear();
+  append(kMagic, sizeof(kMagic));
+  auto count = static_cast<uint32_t>(values.size());
+  append(&count, sizeof(count));
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto info = values[i].GetTensorTypeAndShapeInfo();
+    auto type = static_cast<int32_t>(info.GetElementType());
+    auto element_size = ElementSize(type);
+    if (element_size == 0) {
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT,
+                                  "Output " + names[i] + " has an element type that tensors payloads don't support");
+    }
+
+    auto shape = info.GetShape();
+    auto data_length = static_cast<uint64_t>(info.GetElementCount() * element_size);
+    auto name_length = static_cast<uint32_t>(names[i].size());
+    auto rank = static_cast<uint32_t>(shape.size());
+
+    append(&name_length, sizeof(name_length));
+    append(names[i].data(), names[i].size());
+    append(&type, sizeof(type));
+    append(&rank, sizeof(rank));
+    append(shape.data(), shape.size() * sizeof(int64_t));
+    append(&data_length, sizeof(data_length));
+    payload.append(PaddingTo(payload.size(), kDataAlignment), '\0');
+    append(values[i].GetTensorMutableData<char>(), static_cast<size_t>(data_length));
+  }
+
+  return protobufutil::Status::OK;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
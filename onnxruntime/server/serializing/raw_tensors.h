@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+#include "util.h"
+
+namespace onnxruntime {
+namespace server {
+
+/**
+ * A binary payload of named tensors, which is decoded without parsing numbers or copying the tensor data.
+ * All the fields are little endian:
+ *
+ *   char     magic[4] = "ORTT"
+ *   uint32   tensor count
+ *   for each tensor:
+ *     uint32 name length, followed by the name
+ *     int32  element type, an onnx::TensorProto_DataType of a fixed size type (not STRING)
+ *     uint32 rank, followed by the int64 dims
+ *     uint64 data length
+ *     zero padding up to the next offset in the payload that is a multiple of 8
+ *     the data, in row-major order
+ */
+constexpr const char* kRawTensorsContentType = "application/vnd.onnxruntime.tensors";
+
+// Decodes the tensors of payload. The values borrow the data from payload when it's aligned for their element type,
+// so payload must outlive them, and copy it into buffers otherwise.
+google::protobuf::util::Status ParseRawTensors(const std::string& payload, const OrtMemoryInfo& memory_info,
+                                               MemBufferArray& buffers,
+                                               /* out */ std::vector<std::string>& names,
+                                               /* out */ std::vector<Ort::Value>& values);
+
+// Encodes tensors into payload, which is overwritten.
+google::protobuf::util::Status WriteRawTensors(const std::vector<std::string>& names,
+                                               std::vector<Ort::Value>& values,
+                                               /* out */ std::string& payload);
+
+}  // namespace server
+}  // namespace onnxruntime
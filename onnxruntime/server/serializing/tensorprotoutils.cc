@@ -424,6 +424,33 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+bool TryWrapRawData(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info, Ort::Value& value) {
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_type() == onnx::TensorProto_DataType::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  size_t size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes);
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  size_t element_count = 1;
+  for (auto dim : tensor_shape_vec) {
+    element_count *= static_cast<size_t>(dim);
+  }
+
+  const std::string& raw_data = tensor_proto.raw_data();
+  if (element_count == 0 || raw_data.size() != size_in_bytes ||
+      reinterpret_cast<uintptr_t>(raw_data.data()) % (size_in_bytes / element_count) != 0) {
+    return false;
+  }
+
+  // the tensor is only read by the session, so the storage isn't modified despite the const_cast
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   (ONNXTensorElementDataType)tensor_proto.data_type());
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
@@ -27,6 +27,13 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Wraps the raw_data of a TensorProto in value without copying it, if it can be used as is: the platform is little
+ * endian, and raw_data has the size of the tensor and is aligned for its element type. Returns false otherwise.
+ * value borrows the storage of input, which must outlive it and must not be modified while it's in use.
+ */
+bool TryWrapRawData(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info, /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
@@ -3,12 +3,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <thread>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
 
 #include "boost/program_options.hpp"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "embedding_shard.h"
+#include "model_repository.h"
 
 namespace onnxruntime {
 namespace server {
@@ -33,26 +37,72 @@ static std::unordered_map<std::string, OrtLoggingLevel> supported_log_levels{
     {"error", ORT_LOGGING_LEVEL_ERROR},
     {"fatal", ORT_LOGGING_LEVEL_FATAL}};
 
+// A model served in addition to the one of model_path
+struct AdditionalModel {
+  std::string name;
+  std::string version;
+  std::string path;
+};
+
 // Wrapper around Boost program_options and should provide all the functionality for options parsing
 // Provides sane default values
 class ServerConfiguration {
  public:
   const std::string full_desc = "ONNX Server: host an ONNX model with ONNX Runtime";
   std::string model_path;
+  std::string model_name = "default";
+  std::string model_version = "1";
+  std::vector<AdditionalModel> additional_models;
+  bool enable_model_control = false;
   std::string address = "0.0.0.0";
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int max_batch_size = 1;
+  int max_queue_delay_us = 1000;
+  bool pad_batch_inputs = false;
+  int max_concurrent_runs = 0;
+  int max_queued_requests = 64;
+  int response_cache_mb = 0;
+  int response_cache_ttl_ms = 0;
+  std::vector<ReplicaDevice> replica_devices;  // one replica on the CPU if empty
+  std::vector<EmbeddingShardOptions> embedding_shards;
+  std::vector<RemoteEmbeddingTableOptions> remote_embedding_tables;
+  int remote_embedding_cache_rows = 0;
+  bool enable_shared_memory = false;
+  std::string otlp_traces_endpoint;  // tracing is disabled if empty
+  std::string trace_service_name = "onnxruntime_server";
+  int log_queue_size = 8192;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
+    desc.add_options()("log_queue_size", po::value(&log_queue_size)->default_value(log_queue_size), "Number of log messages waiting to be written by a background thread, so that the requests don't wait for them. The oldest ones are dropped when it's full. 0 writes them synchronously");
     desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    // not named model_name and model_version, so that --model still abbreviates --model_path
+    desc.add_options()("default_model_name", po::value(&model_name)->default_value(model_name), "Name of the model of model_path, which serves the requests that don't name a model");
+    desc.add_options()("default_model_version", po::value(&model_version)->default_value(model_version), "Version of the model of model_path");
+    desc.add_options()("additional_model", po::value(&additional_model_strs_)->composing(), "Another model to serve, as name:version:path. Can be repeated");
+    desc.add_options()("enable_model_control", po::bool_switch(&enable_model_control), "Accept requests to load and unload model versions at /v1/models/<name>/versions/<version>:(load|unload)");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Largest number of rows of concurrent requests batched into one run. 1 disables batching");
+    desc.add_options()("max_queue_delay_us", po::value(&max_queue_delay_us)->default_value(max_queue_delay_us), "Microseconds a request waits for others to batch with");
+    desc.add_options()("pad_batch_inputs", po::bool_switch(&pad_batch_inputs), "Batch requests with inputs of different lengths by padding them with zeros");
+    desc.add_options()("max_concurrent_runs", po::value(&max_concurrent_runs)->default_value(max_concurrent_runs), "Largest number of requests of a model run at the same time, the others wait in a queue. 0 for no limit");
+    desc.add_options()("max_queued_requests", po::value(&max_queued_requests)->default_value(max_queued_requests), "Largest number of requests of a model waiting to run with max_concurrent_runs. More are rejected with 429 or RESOURCE_EXHAUSTED");
+    desc.add_options()("response_cache_mb", po::value(&response_cache_mb)->default_value(response_cache_mb), "Megabytes of the cache of the outputs of recent requests of each model, for deterministic models. 0 disables it");
+    desc.add_options()("response_cache_ttl_ms", po::value(&response_cache_ttl_ms)->default_value(response_cache_ttl_ms), "Milliseconds the outputs of a request are served from the cache. 0 keeps them until they are evicted");
+    desc.add_options()("replica_device", po::value(&replica_device_strs_)->composing(), "Device of a replica of each model, cpu, cpu:<NUMA node> or cuda:<device id>. A cpu:<NUMA node> replica runs on its own threads and memory of that node. Can be repeated, requests go to the least loaded replica. One cpu replica by default");
+    desc.add_options()("embedding_shard", po::value(&embedding_shard_strs_)->composing(), "Shard of an embedding table whose rows are served to the RemoteGather nodes of other servers, as table:first_row:row_size:path of a file of float rows. Can be repeated");
+    desc.add_options()("remote_embedding_shard", po::value(&remote_embedding_shard_strs_)->composing(), "Shard of an embedding table looked up by the RemoteGather nodes of the models and held by another server, as table:row_size:first_row:row_count:host:port. Can be repeated");
+    desc.add_options()("remote_embedding_cache_rows", po::value(&remote_embedding_cache_rows)->default_value(remote_embedding_cache_rows), "Number of recently used rows of each remote embedding table kept locally. 0 disables the cache");
+    desc.add_options()("enable_shared_memory", po::bool_switch(&enable_shared_memory), "Let gRPC clients on the same host register POSIX shared memory regions that requests read their inputs from and write their outputs to");
+    desc.add_options()("otlp_traces_endpoint", po::value(&otlp_traces_endpoint), "host:port of the OTLP/HTTP endpoint of an OpenTelemetry collector the spans of the requests and their runs are exported to. Tracing is disabled by default");
+    desc.add_options()("trace_service_name", po::value(&trace_service_name)->default_value(trace_service_name), "The service.name of the exported spans");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -89,6 +139,10 @@ class ServerConfiguration {
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
   std::string log_level_str = "info";
+  std::vector<std::string> additional_model_strs_;
+  std::vector<std::string> replica_device_strs_;
+  std::vector<std::string> embedding_shard_strs_;
+  std::vector<std::string> remote_embedding_shard_strs_;
 
   // Print help and return if there is a bad value
   Result ValidateOptions() {
@@ -99,14 +153,125 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
+    } else if (max_batch_size <= 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_queue_delay_us < 0) {
+      PrintHelp(std::cerr, "max_queue_delay_us must not be negative");
+      return Result::ExitFailure;
+    } else if (max_concurrent_runs < 0 || max_queued_requests < 0) {
+      PrintHelp(std::cerr, "max_concurrent_runs and max_queued_requests must not be negative");
+      return Result::ExitFailure;
+    } else if (response_cache_mb < 0 || response_cache_ttl_ms < 0) {
+      PrintHelp(std::cerr, "response_cache_mb and response_cache_ttl_ms must not be negative");
+      return Result::ExitFailure;
     } else if (!file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
+    } else if (!is_valid_model_name(model_name) || !is_valid_model_version(model_version)) {
+      PrintHelp(std::cerr, "default_model_name must not contain '/' or ':' and default_model_version must be a number");
+      return Result::ExitFailure;
+    } else if (log_queue_size < 0) {
+      PrintHelp(std::cerr, "log_queue_size must not be negative");
+      return Result::ExitFailure;
+    } else if (remote_embedding_cache_rows < 0) {
+      PrintHelp(std::cerr, "remote_embedding_cache_rows must not be negative");
+      return Result::ExitFailure;
+    } else if (!otlp_traces_endpoint.empty() && otlp_traces_endpoint.find(':') == std::string::npos) {
+      PrintHelp(std::cerr, "otlp_traces_endpoint must be host:port");
+      return Result::ExitFailure;
+    } else if (ParseReplicaDevices() != Result::ContinueSuccess) {
+      return Result::ExitFailure;
+    } else if (ParseEmbeddingShards() != Result::ContinueSuccess) {
+      return Result::ExitFailure;
     } else {
-      return Result::ContinueSuccess;
+      return ParseAdditionalModels();
     }
   }
 
+  Result ParseReplicaDevices() {
+    for (const auto& str : replica_device_strs_) {
+      ReplicaDevice device;
+      if (!ParseReplicaDevice(str, device)) {
+        PrintHelp(std::cerr, "replica_device must be cpu, cpu:<NUMA node> or cuda:<device id>, got " + str);
+        return Result::ExitFailure;
+      }
+      replica_devices.push_back(device);
+    }
+
+    return Result::ContinueSuccess;
+  }
+
+  Result ParseEmbeddingShards() {
+    for (const auto& str : embedding_shard_strs_) {
+      std::vector<std::string> fields;
+      EmbeddingShardOptions shard;
+      if (!split_fields(str, 4, fields) || fields[0].empty() || !parse_int64(fields[1], shard.first_row) ||
+          !parse_int64(fields[2], shard.row_size) || shard.row_size == 0 || !file_exists(fields[3])) {
+        PrintHelp(std::cerr, "embedding_shard must be table:first_row:row_size:path of a valid file, got " + str);
+        return Result::ExitFailure;
+      }
+      shard.table = fields[0];
+      shard.path = fields[3];
+      embedding_shards.push_back(std::move(shard));
+    }
+
+    // the shards of a table are grouped into its options, which check that they hold all its rows
+    for (const auto& str : remote_embedding_shard_strs_) {
+      std::vector<std::string> fields;
+      int64_t row_size = 0;
+      RemoteEmbeddingShard shard;
+      if (!split_fields(str, 5, fields) || fields[0].empty() || !parse_int64(fields[1], row_size) || row_size == 0 ||
+          !parse_int64(fields[2], shard.first_row) || !parse_int64(fields[3], shard.row_count) ||
+          shard.row_count == 0 || fields[4].empty()) {
+        PrintHelp(std::cerr, "remote_embedding_shard must be table:row_size:first_row:row_count:host:port, got " + str);
+        return Result::ExitFailure;
+      }
+      shard.address = fields[4];
+
+      auto table = std::find_if(remote_embedding_tables.begin(), remote_embedding_tables.end(),
+                                [&fields](const RemoteEmbeddingTableOptions& t) { return t.name == fields[0]; });
+      if (table == remote_embedding_tables.end()) {
+        RemoteEmbeddingTableOptions options;
+        options.name = fields[0];
+        options.row_size = row_size;
+        options.cache_rows = static_cast<size_t>(remote_embedding_cache_rows);
+        table = remote_embedding_tables.insert(table, std::move(options));
+      } else if (table->row_size != row_size) {
+        PrintHelp(std::cerr, "remote_embedding_shard must have the same row_size for all the shards of a table, got " + str);
+        return Result::ExitFailure;
+      }
+      table->shards.push_back(std::move(shard));
+    }
+
+    return Result::ContinueSuccess;
+  }
+
+  // Splits each additional_model into its name, version and path. The path is the rest after the second ':'.
+  Result ParseAdditionalModels() {
+    for (const auto& str : additional_model_strs_) {
+      auto name_end = str.find(':');
+      auto version_end = name_end == std::string::npos ? name_end : str.find(':', name_end + 1);
+      if (version_end == std::string::npos) {
+        PrintHelp(std::cerr, "additional_model must be name:version:path, got " + str);
+        return Result::ExitFailure;
+      }
+
+      AdditionalModel model{str.substr(0, name_end), str.substr(name_end + 1, version_end - name_end - 1),
+                            str.substr(version_end + 1)};
+      if (!is_valid_model_name(model.name) || !is_valid_model_version(model.version)) {
+        PrintHelp(std::cerr, "additional_model must have a name without '/' and a number as version, got " + str);
+        return Result::ExitFailure;
+      } else if (!file_exists(model.path)) {
+        PrintHelp(std::cerr, "additional_model must have the location of a valid file, got " + str);
+        return Result::ExitFailure;
+      }
+      additional_models.push_back(std::move(model));
+    }
+
+    return Result::ContinueSuccess;
+  }
+
   // Checks if program options contains help
   bool ContainsHelp() const {
     return vm.count("help") || vm.count("h");
@@ -120,6 +285,38 @@ class ServerConfiguration {
         << desc << std::endl;
   }
 
+  static bool is_valid_model_name(const std::string& name) {
+    return !name.empty() && name.find_first_of("/:") == std::string::npos;
+  }
+
+  static bool is_valid_model_version(const std::string& version) {
+    return !version.empty() && version.find_first_not_of("0123456789") == std::string::npos;
+  }
+
+  // Splits str into count fields separated by ':'. The last field is the rest of str, so it may contain ':'.
+  static bool split_fields(const std::string& str, size_t count, std::vector<std::string>& fields) {
+    size_t begin = 0;
+    for (size_t i = 0; i + 1 < count; ++i) {
+      auto end = str.find(':', begin);
+      if (end == std::string::npos) {
+        return false;
+      }
+      fields.push_back(str.substr(begin, end - begin));
+      begin = end + 1;
+    }
+    fields.push_back(str.substr(begin));
+    return true;
+  }
+
+  // Parses a number that isn't negative.
+  static bool parse_int64(const std::string& str, int64_t& value) {
+    if (str.empty() || str.size() > 18 || str.find_first_not_of("0123456789") != std::string::npos) {
+      return false;
+    }
+    value = std::stoll(str);
+    return true;
+  }
+
   inline bool file_exists(const std::string& fileName) {
     std::ifstream infile(fileName.c_str());
     return infile.good();
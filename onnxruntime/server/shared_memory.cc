@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "shared_memory.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+namespace server {
+
+SharedMemoryRegion::SharedMemoryRegion(const std::string& key, uint64_t offset, uint64_t byte_size)
+    : key_(key), byte_size_(byte_size) {
+#ifdef _WIN32
+  (void)offset;
+  throw Ort::Exception("Shared memory regions require POSIX shared memory", ORT_NOT_IMPLEMENTED);
+#else
+  if (byte_size == 0) {
+    throw Ort::Exception("Shared memory region " + key + " is empty", ORT_INVALID_ARGUMENT);
+  }
+
+  const int fd = shm_open(key.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    throw Ort::Exception("Can't open shared memory object " + key + ": " + std::strerror(errno), ORT_NO_SUCHFILE);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < offset ||
+      static_cast<uint64_t>(info.st_size) - offset < byte_size) {
+    close(fd);
+    throw Ort::Exception("Shared memory object " + key + " has no " + std::to_string(byte_size) +
+                             " bytes at offset " + std::to_string(offset),
+                         ORT_INVALID_ARGUMENT);
+  }
+
+  // mappings start at a page boundary
+  const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t mapping_offset = offset - offset % page_size;
+  mapping_size_ = static_cast<size_t>(byte_size + offset - mapping_offset);
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(mapping_offset));
+  const int mmap_errno = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw Ort::Exception("Can't map shared memory object " + key + ": " + std::strerror(mmap_errno), ORT_FAIL);
+  }
+  data_ = static_cast<char*>(mapping_) + (offset - mapping_offset);
+#endif
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+#ifndef _WIN32
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+#endif
+}
+
+void SharedMemoryRegistry::Register(const std::string& name, const std::string& key, uint64_t offset,
+                                    uint64_t byte_size) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (regions_.count(name) != 0) {
+      throw Ort::Exception("Shared memory region " + name + " is already registered", ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  // mapped without the lock, the name is checked again before it's published
+  auto region = std::make_shared<SharedMemoryRegion>(key, offset, byte_size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!regions_.emplace(name, std::move(region)).second) {
+    throw Ort::Exception("Shared memory region " + name + " is already registered", ORT_INVALID_ARGUMENT);
+  }
+}
+
+bool SharedMemoryRegistry::Unregister(const std::string& name) {
+  // unmapped once the lock is released, unless a request still holds it
+  std::shared_ptr<SharedMemoryRegion> region;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto match = regions_.find(name);
+    if (match == regions_.end()) {
+      return false;
+    }
+    region = std::move(match->second);
+    regions_.erase(match);
+  }
+  return true;
+}
+
+std::shared_ptr<SharedMemoryRegion> SharedMemoryRegistry::Get(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto match = regions_.find(name);
+  return match == regions_.end() ? nullptr : match->second;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
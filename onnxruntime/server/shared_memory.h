@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+/**
+ * A range of a POSIX shared memory object mapped by the server. Clients on the same host put the inputs of their
+ * requests in it and have their outputs written to it, so that the tensors are neither serialized nor copied: the
+ * server runs the model with values over the region.
+ */
+class SharedMemoryRegion {
+ public:
+  // Maps the byte_size bytes at offset of the shared memory object key, e.g. "/my_region". Throws Ort::Exception
+  // if it can't be mapped, or on platforms without POSIX shared memory.
+  SharedMemoryRegion(const std::string& key, uint64_t offset, uint64_t byte_size);
+  // Unmaps the region.
+  ~SharedMemoryRegion();
+  SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+  SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+  const std::string& Key() const { return key_; }
+  uint64_t ByteSize() const { return byte_size_; }
+
+  // The byte_size bytes at offset in the region, or nullptr if they aren't all in it.
+  void* Data(uint64_t offset, uint64_t byte_size) const {
+    return offset > byte_size_ || byte_size > byte_size_ - offset ? nullptr : data_ + offset;
+  }
+
+ private:
+  const std::string key_;
+  const uint64_t byte_size_;
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  char* data_ = nullptr;
+};
+
+/**
+ * The shared memory regions registered by the clients, by name. Requests hold the regions they use, so a region
+ * unregistered during a request stays mapped until it is done.
+ */
+class SharedMemoryRegistry {
+ public:
+  SharedMemoryRegistry() = default;
+  SharedMemoryRegistry(const SharedMemoryRegistry&) = delete;
+  SharedMemoryRegistry& operator=(const SharedMemoryRegistry&) = delete;
+
+  // Maps a region under name. Throws Ort::Exception if the name is taken or the region can't be mapped.
+  void Register(const std::string& name, const std::string& key, uint64_t offset, uint64_t byte_size);
+
+  // Returns false if there's no region named name.
+  bool Unregister(const std::string& name);
+
+  // The region named name, or nullptr if there's none.
+  std::shared_ptr<SharedMemoryRegion> Get(const std::string& name) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<SharedMemoryRegion>> regions_;  // protected by mutex_
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,348 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "core/session/onnxruntime_cxx_api.h"
+#include "tracing.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = boost::asio::ip::tcp;
+
+static bool IsLowerHex(const std::string& text, size_t offset, size_t length) {
+  bool all_zeros = true;
+  for (size_t i = offset; i < offset + length; ++i) {
+    const char c = text[i];
+    if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+      return false;
+    }
+    all_zeros = all_zeros && c == '0';
+  }
+  return !all_zeros;
+}
+
+bool ParseTraceParent(const std::string& traceparent, TraceContext& context) {
+  // version 00 is exactly 55 characters, later versions may append fields after the flags
+  if (traceparent.size() < 55 || traceparent[2] != '-' || traceparent[35] != '-' || traceparent[52] != '-' ||
+      traceparent.compare(0, 2, "ff") == 0 || (traceparent.compare(0, 2, "00") == 0 && traceparent.size() != 55) ||
+      (traceparent.size() > 55 && traceparent[55] != '-')) {
+    return false;
+  }
+  for (size_t i : {0, 53}) {
+    if (!std::isxdigit(static_cast<unsigned char>(traceparent[i])) ||
+        !std::isxdigit(static_cast<unsigned char>(traceparent[i + 1]))) {
+      return false;
+    }
+  }
+  if (!IsLowerHex(traceparent, 3, 32) || !IsLowerHex(traceparent, 36, 16)) {
+    return false;
+  }
+
+  context.trace_id = traceparent.substr(3, 32);
+  context.parent_span_id = traceparent.substr(36, 16);
+  return true;
+}
+
+static std::string RandomHex(size_t length) {
+  static thread_local std::mt19937_64 generator{std::random_device{}()};
+  static const char digits[] = "0123456789abcdef";
+
+  std::string hex(length, '0');
+  while (hex.find_first_not_of('0') == std::string::npos) {
+    for (size_t i = 0; i < length; i += 16) {
+      auto bits = generator();
+      for (size_t j = i; j < std::min(length, i + 16); ++j, bits >>= 4) {
+        hex[j] = digits[bits & 0xf];
+      }
+    }
+  }
+  return hex;
+}
+
+std::string NewTraceId() {
+  return RandomHex(32);
+}
+
+std::string NewSpanId() {
+  return RandomHex(16);
+}
+
+std::string TraceIdFromRequestId(const std::string& request_id) {
+  std::string trace_id;
+  trace_id.reserve(32);
+  for (char c : request_id) {
+    if (c != '-') {
+      trace_id.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+  }
+  if (trace_id.size() != 32 || !IsLowerHex(trace_id, 0, 32)) {
+    return NewTraceId();
+  }
+  return trace_id;
+}
+
+int64_t ToUnixNanoseconds(std::chrono::steady_clock::time_point time) {
+  const auto offset = std::chrono::system_clock::now().time_since_epoch() -
+                      std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch() + offset).count();
+}
+
+static void AppendJsonString(std::ostringstream& json, const std::string& text) {
+  json << '"';
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        json << "\\\"";
+        break;
+      case '\\':
+        json << "\\\\";
+        break;
+      case '\n':
+        json << "\\n";
+        break;
+      case '\r':
+        json << "\\r";
+        break;
+      case '\t':
+        json << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          json << escaped;
+        } else {
+          json << c;
+        }
+    }
+  }
+  json << '"';
+}
+
+static void AppendJsonAttribute(std::ostringstream& json, const std::string& key, const std::string& value) {
+  json << "{\"key\":";
+  AppendJsonString(json, key);
+  json << ",\"value\":{\"stringValue\":";
+  AppendJsonString(json, value);
+  json << "}}";
+}
+
+std::string OtlpHttpExporter::ToJson(const std::vector<TraceSpan>& spans, const std::string& service_name) {
+  std::ostringstream json;
+  json << "{\"resourceSpans\":[{\"resource\":{\"attributes\":[";
+  AppendJsonAttribute(json, "service.name", service_name);
+  json << "]},\"scopeSpans\":[{\"scope\":{\"name\":\"onnxruntime_server\"},\"spans\":[";
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const auto& span = spans[i];
+    json << (i == 0 ? "" : ",") << "{\"traceId\":\"" << span.trace_id << "\",\"spanId\":\"" << span.span_id << '"';
+    if (!span.parent_span_id.empty()) {
+      json << ",\"parentSpanId\":\"" << span.parent_span_id << '"';
+    }
+    json << ",\"name\":";
+    AppendJsonString(json, span.name);
+    // 64 bit integers are strings in the JSON encoding of protobuf
+    json << ",\"startTimeUnixNano\":\"" << span.start_time_ns << "\",\"endTimeUnixNano\":\"" << span.end_time_ns
+         << "\",\"attributes\":[";
+    for (size_t j = 0; j < span.attributes.size(); ++j) {
+      json << (j == 0 ? "" : ",");
+      AppendJsonAttribute(json, span.attributes[j].first, span.attributes[j].second);
+    }
+    json << "]";
+    if (span.error) {
+      // STATUS_CODE_ERROR
+      json << ",\"status\":{\"code\":2,\"message\":";
+      AppendJsonString(json, span.status_message);
+      json << "}";
+    }
+    json << "}";
+  }
+  json << "]}]}]}";
+  return json.str();
+}
+
+OtlpHttpExporter::OtlpHttpExporter(const OtlpExporterOptions& options, std::shared_ptr<spdlog::logger> logger)
+    : options_(options), logger_(std::move(logger)) {
+  const auto colon = options_.endpoint.rfind(':');
+  if (colon == std::string::npos || colon == 0 || colon + 1 == options_.endpoint.size()) {
+    throw Ort::Exception("The OTLP endpoint " + options_.endpoint + " isn't host:port", ORT_INVALID_ARGUMENT);
+  }
+  host_ = options_.endpoint.substr(0, colon);
+  port_ = options_.endpoint.substr(colon + 1);
+
+  sender_ = std::thread([this]() { SendBatches(); });
+}
+
+OtlpHttpExporter::~OtlpHttpExporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_one();
+  sender_.join();
+}
+
+void OtlpHttpExporter::Export(TraceSpan span) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= options_.max_queued_spans) {
+      ++dropped_spans_;
+      return;
+    }
+    queue_.push_back(std::move(span));
+    if (queue_.size() < options_.max_batch_spans) {
+      return;
+    }
+  }
+  queued_.notify_one();
+}
+
+void OtlpHttpExporter::SendBatches() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // a batch is sent when it's full, and the queued spans every flush_interval
+    queued_.wait_for(lock, options_.flush_interval,
+                     [this]() { return stopping_ || queue_.size() >= options_.max_batch_spans; });
+    if (queue_.empty()) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+
+    const size_t count = std::min(queue_.size(), options_.max_batch_spans);
+    std::vector<TraceSpan> batch;
+    batch.reserve(count);
+    std::move(queue_.begin(), queue_.begin() + count, std::back_inserter(batch));
+    queue_.erase(queue_.begin(), queue_.begin() + count);
+
+    lock.unlock();
+    if (!Post(ToJson(batch, options_.service_name))) {
+      dropped_spans_ += batch.size();
+    }
+    lock.lock();
+  }
+}
+
+bool OtlpHttpExporter::Post(const std::string& body) {
+  try {
+    boost::asio::io_context context;
+    tcp::resolver resolver(context);
+    tcp::socket socket(context);
+    boost::asio::connect(socket, resolver.resolve(host_, port_));
+
+    http::request<http::string_body> request{http::verb::post, "/v1/traces", 11};
+    request.set(http::field::host, host_);
+    request.set(http::field::content_type, "application/json");
+    request.body() = body;
+    request.prepare_payload();
+    http::write(socket, request);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    http::read(socket, buffer, response);
+
+    beast::error_code ec;
+    socket.shutdown(tcp::socket::shutdown_both, ec);
+
+    if (response.result_int() / 100 != 2) {
+      logger_->warn("The OTLP collector at {} rejected the spans: {} {}", options_.endpoint, response.result_int(),
+                    response.body());
+      return false;
+    }
+  } catch (const std::exception& e) {
+    logger_->warn("Failed to export spans to the OTLP collector at {}: {}", options_.endpoint, e.what());
+    return false;
+  }
+  return true;
+}
+
+RequestTracer::RequestTracer(std::unique_ptr<SpanExporter> exporter) : exporter_(std::move(exporter)) {}
+
+void RequestTracer::BeginRun(const std::string& run_tag, const std::string& trace_id,
+                             const std::string& parent_span_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  runs_[run_tag] = TracedRun{trace_id, parent_span_id, NewSpanId()};
+}
+
+void RequestTracer::EndRun(const std::string& run_tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  runs_.erase(run_tag);
+}
+
+static const char* SessionSpanName(OrtRunTraceSpanKind kind) {
+  switch (kind) {
+    case ORT_RUN_TRACE_SPAN_RUN:
+      return "onnxruntime.run";
+    case ORT_RUN_TRACE_SPAN_FEED_COPY:
+      return "onnxruntime.feed_copy";
+    case ORT_RUN_TRACE_SPAN_PARTITION:
+      return "onnxruntime.partition";
+    case ORT_RUN_TRACE_SPAN_MEMCPY:
+      return "onnxruntime.memcpy";
+    case ORT_RUN_TRACE_SPAN_FETCH_COPY:
+      return "onnxruntime.fetch_copy";
+    default:
+      return "onnxruntime.span";
+  }
+}
+
+void ORT_API_CALL RequestTracer::EndSessionSpan(void* user_data, const OrtRunTraceSpan* span) {
+  auto* tracer = static_cast<RequestTracer*>(user_data);
+
+  TraceSpan trace_span;
+  {
+    std::lock_guard<std::mutex> lock(tracer->mutex_);
+    auto run = tracer->runs_.find(span->run_tag);
+    if (run == tracer->runs_.end()) {
+      return;
+    }
+    trace_span.trace_id = run->second.trace_id;
+    if (span->kind == ORT_RUN_TRACE_SPAN_RUN) {
+      trace_span.span_id = run->second.run_span_id;
+      trace_span.parent_span_id = run->second.parent_span_id;
+    } else {
+      trace_span.span_id = NewSpanId();
+      trace_span.parent_span_id = run->second.run_span_id;
+    }
+  }
+
+  trace_span.name = SessionSpanName(span->kind);
+  trace_span.start_time_ns = span->start_time_ns;
+  trace_span.end_time_ns = span->end_time_ns;
+  trace_span.attributes.emplace_back("onnxruntime.run_id", std::to_string(span->run_id));
+  switch (span->kind) {
+    case ORT_RUN_TRACE_SPAN_PARTITION:
+      trace_span.attributes.emplace_back("onnxruntime.provider", span->provider);
+      trace_span.attributes.emplace_back("onnxruntime.node_count", std::to_string(span->node_count));
+      break;
+    case ORT_RUN_TRACE_SPAN_MEMCPY:
+      trace_span.attributes.emplace_back("onnxruntime.provider", span->provider);
+      trace_span.attributes.emplace_back("onnxruntime.node", span->name);
+      break;
+    default:
+      break;
+  }
+  if (span->status != ORT_OK) {
+    trace_span.error = true;
+    trace_span.status_message = "Failed with error code " + std::to_string(static_cast<int>(span->status));
+  }
+
+  tracer->Export(std::move(trace_span));
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+// The W3C trace context a request is part of, from the traceparent header of its caller.
+struct TraceContext {
+  std::string trace_id;        // 32 lowercase hex digits
+  std::string parent_span_id;  // 16 lowercase hex digits, empty if the request starts the trace
+};
+
+// Parses a traceparent header, "00-<trace id>-<parent span id>-<flags>". Returns false if it's malformed or one of
+// its ids is all zeros, in which case context is left unchanged.
+bool ParseTraceParent(const std::string& traceparent, TraceContext& context);
+
+// Random ids of 32 and 16 lowercase hex digits.
+std::string NewTraceId();
+std::string NewSpanId();
+
+// The trace id of a request without a trace context: its request id, a UUID, without the dashes. A random one if the
+// request id isn't a UUID.
+std::string TraceIdFromRequestId(const std::string& request_id);
+
+// Nanoseconds since the Unix epoch of a time of the steady clock, which the phases of the requests are timed with.
+int64_t ToUnixNanoseconds(std::chrono::steady_clock::time_point time);
+
+// A finished span, in the terms of OpenTelemetry.
+struct TraceSpan {
+  std::string trace_id;
+  std::string span_id;
+  std::string parent_span_id;  // empty for a root span
+  std::string name;
+  int64_t start_time_ns = 0;  // since the Unix epoch
+  int64_t end_time_ns = 0;
+  bool error = false;
+  std::string status_message;
+  std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+// Where the finished spans go. Thread safe.
+class SpanExporter {
+ public:
+  virtual ~SpanExporter() = default;
+  virtual void Export(TraceSpan span) = 0;
+};
+
+struct OtlpExporterOptions {
+  // host:port of the OTLP/HTTP endpoint of the collector.
+  std::string endpoint;
+  // The service.name resource attribute of the spans.
+  std::string service_name = "onnxruntime_server";
+  // Largest number of spans sent at once.
+  size_t max_batch_spans = 512;
+  // Largest number of spans waiting to be sent. Newer ones are dropped, so that a slow or missing collector doesn't
+  // hold up the requests.
+  size_t max_queued_spans = 8192;
+  // Longest time a span waits to be sent.
+  std::chrono::milliseconds flush_interval{1000};
+};
+
+/**
+ * Exports spans to an OpenTelemetry collector with OTLP/HTTP in its JSON encoding, POSTed to /v1/traces of the
+ * endpoint. The spans are queued and sent in batches by a background thread.
+ */
+class OtlpHttpExporter : public SpanExporter {
+ public:
+  // Throws Ort::Exception if the endpoint isn't host:port.
+  OtlpHttpExporter(const OtlpExporterOptions& options, std::shared_ptr<spdlog::logger> logger);
+  // Sends the queued spans.
+  ~OtlpHttpExporter() override;
+  OtlpHttpExporter(const OtlpHttpExporter&) = delete;
+  OtlpHttpExporter& operator=(const OtlpHttpExporter&) = delete;
+
+  void Export(TraceSpan span) override;
+
+  // Spans dropped because the queue was full or they couldn't be sent.
+  uint64_t DroppedSpans() const { return dropped_spans_; }
+
+  // The ExportTraceServiceRequest of spans, in the JSON encoding of OTLP.
+  static std::string ToJson(const std::vector<TraceSpan>& spans, const std::string& service_name);
+
+ private:
+  void SendBatches();
+  // Returns false if the collector couldn't be reached or didn't accept the request.
+  bool Post(const std::string& body);
+
+  const OtlpExporterOptions options_;
+  const std::shared_ptr<spdlog::logger> logger_;
+  std::string host_;
+  std::string port_;
+  std::atomic<uint64_t> dropped_spans_{0};
+
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::deque<TraceSpan> queue_;  // protected by mutex_
+  bool stopping_ = false;        // protected by mutex_
+  std::thread sender_;
+};
+
+/**
+ * Traces the requests of the server. The executor of a request exports a span for it and its phases, and the
+ * sessions report the spans of their runs to EndSessionSpan, which parents them to the request they were run for by
+ * their run tag, the request id.
+ */
+class RequestTracer {
+ public:
+  explicit RequestTracer(std::unique_ptr<SpanExporter> exporter);
+  RequestTracer(const RequestTracer&) = delete;
+  RequestTracer& operator=(const RequestTracer&) = delete;
+
+  // The end_span callback of the sessions, with the tracer as user data.
+  static void ORT_API_CALL EndSessionSpan(void* user_data, const OrtRunTraceSpan* span);
+
+  // The spans of the runs tagged run_tag are children of parent_span_id in trace_id until EndRun. The spans of runs
+  // with tags that aren't begun are dropped.
+  void BeginRun(const std::string& run_tag, const std::string& trace_id, const std::string& parent_span_id);
+  void EndRun(const std::string& run_tag);
+
+  void Export(TraceSpan span) { exporter_->Export(std::move(span)); }
+
+ private:
+  struct TracedRun {
+    std::string trace_id;
+    std::string parent_span_id;
+    // of the span of the run in the session, which the other spans of the session are children of
+    std::string run_span_id;
+  };
+
+  const std::unique_ptr<SpanExporter> exporter_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, TracedRun> runs_;  // protected by mutex_, by run tag
+};
+
+// Begins a run with the tracer, if there's one, and ends it when it goes out of scope.
+class TracedRunScope {
+ public:
+  TracedRunScope(RequestTracer* tracer, const std::string& run_tag, const std::string& trace_id,
+                 const std::string& parent_span_id)
+      : tracer_(tracer), run_tag_(run_tag) {
+    if (tracer_ != nullptr) {
+      tracer_->BeginRun(run_tag_, trace_id, parent_span_id);
+    }
+  }
+  ~TracedRunScope() {
+    if (tracer_ != nullptr) {
+      tracer_->EndRun(run_tag_);
+    }
+  }
+  TracedRunScope(const TracedRunScope&) = delete;
+  TracedRunScope& operator=(const TracedRunScope&) = delete;
+
+ private:
+  RequestTracer* const tracer_;
+  const std::string run_tag_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
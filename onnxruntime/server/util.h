@@ -6,6 +6,7 @@
 #include <google/protobuf/stubs/status.h>
 
 #include "core/common/status.h"
+#include "core/session/onnxruntime_c_api.h"
 
 namespace onnxruntime {
 namespace server {
@@ -38,6 +39,9 @@ class MemBufferArray {
   }
 };
 
+// Size of an element of a tensor, or 0 for the types whose tensors can't be copied as memory (i.e. strings).
+size_t TensorElementSize(ONNXTensorElementDataType type);
+
 google::protobuf::util::Status GenerateProtobufStatus(const int& onnx_status, const std::string& message);
 // Generate protobuf status from ONNX Runtime status
 google::protobuf::util::Status GenerateProtobufStatus(const onnxruntime::common::Status& onnx_status, const std::string& message);
@@ -92,6 +92,80 @@ TEST(DateTimeTransformer, Future_2025_June_30) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+namespace {
+
+void AddBatchOutputs(OpTester& test, const std::vector<int64_t>& dims, const std::vector<time_t>& dates) {
+  std::vector<int32_t> year;
+  std::vector<uint8_t> month, day, hour, minute, second, day_of_week, quarter_of_year, week_of_month;
+  std::vector<uint16_t> day_of_year;
+  for (time_t date : dates) {
+    dft::TimePoint tp(SysClock::from_time_t(date));
+    year.push_back(tp.year);
+    month.push_back(tp.month);
+    day.push_back(tp.day);
+    hour.push_back(tp.hour);
+    minute.push_back(tp.minute);
+    second.push_back(tp.second);
+    day_of_week.push_back(tp.dayOfWeek);
+    day_of_year.push_back(tp.dayOfYear);
+    quarter_of_year.push_back(tp.quarterOfYear);
+    week_of_month.push_back(tp.weekOfMonth);
+  }
+  test.AddOutput<int32_t>("year", dims, year);
+  test.AddOutput<uint8_t>("month", dims, month);
+  test.AddOutput<uint8_t>("day", dims, day);
+  test.AddOutput<uint8_t>("hour", dims, hour);
+  test.AddOutput<uint8_t>("minute", dims, minute);
+  test.AddOutput<uint8_t>("second", dims, second);
+  test.AddOutput<uint8_t>("dayOfWeek", dims, day_of_week);
+  test.AddOutput<uint16_t>("dayOfYear", dims, day_of_year);
+  test.AddOutput<uint8_t>("quarterOfYear", dims, quarter_of_year);
+  test.AddOutput<uint8_t>("weekOfMonth", dims, week_of_month);
+}
+
+}  // namespace
+
+TEST(DateTimeTransformerBatch, MultipleDates) {
+  // 1970-01-01, 1976-11-17 12:27:04, 2000-02-29 23:59:59 and 2025-06-30
+  const std::vector<time_t> dates = {0, 217081624, 951868799, 1751241600};
+
+  OpTester test("DateTimeTransformerBatch", 1, onnxruntime::kMSAutoMLDomain);
+  test.AddInput<int64_t>("X", {2, 2}, std::vector<int64_t>(dates.begin(), dates.end()));
+  AddBatchOutputs(test, {2, 2}, dates);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(DateTimeTransformerBatch, PreEpoch) {
+  OpTester test("DateTimeTransformerBatch", 1, onnxruntime::kMSAutoMLDomain);
+  // 1776-07-04 00:00:00 and 1969-12-31 23:59:59
+  test.AddInput<int64_t>("X", {2}, {-6106060800, -1});
+  test.AddOutput<int32_t>("year", {2}, {1776, 1969});
+  test.AddOutput<uint8_t>("month", {2}, {7, 12});
+  test.AddOutput<uint8_t>("day", {2}, {4, 31});
+  test.AddOutput<uint8_t>("hour", {2}, {0, 23});
+  test.AddOutput<uint8_t>("minute", {2}, {0, 59});
+  test.AddOutput<uint8_t>("second", {2}, {0, 59});
+  test.AddOutput<uint8_t>("dayOfWeek", {2}, {dft::TimePoint::THURSDAY, dft::TimePoint::WEDNESDAY});
+  test.AddOutput<uint16_t>("dayOfYear", {2}, {185, 364});
+  test.AddOutput<uint8_t>("quarterOfYear", {2}, {3, 4});
+  test.AddOutput<uint8_t>("weekOfMonth", {2}, {0, 4});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(DateTimeTransformerBatch, LargeBatch) {
+  // Enough elements to be split across the thread pool. Steps of a little over a day walk
+  // through every time of day, day of week and leap year boundary between 1970 and 2070.
+  const int64_t count = 20000;
+  std::vector<time_t> dates;
+  for (int64_t i = 0; i < count; ++i) {
+    dates.push_back(static_cast<time_t>(i * 157787));
+  }
+
+  OpTester test("DateTimeTransformerBatch", 1, onnxruntime::kMSAutoMLDomain);
+  test.AddInput<int64_t>("X", {count}, std::vector<int64_t>(dates.begin(), dates.end()));
+  AddBatchOutputs(test, {count}, dates);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
 
 }  // namespace test
 }  // namespace onnxruntime
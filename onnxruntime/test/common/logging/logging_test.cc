@@ -142,6 +142,28 @@ TEST_F(LoggingTestsFixture, TestLoggerFiltering) {
   VLOGS(*logger, 2) << "VLOG enabled up to " << max_vlog_level;
 }
 
+/// <summary>
+/// Tests that the identifier of the logger of a run joins the session identifier and the run tag.
+/// </summary>
+TEST_F(LoggingTestsFixture, TestRunLoggerId) {
+  const std::string session_id{"Session"};
+  const std::string no_session_id;
+  const std::string run_tag{"Run"};
+
+  MockSink* sink_ptr = new MockSink();
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, Eq("Session:Run"), testing::_)).Times(1);
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, Eq("Run"), testing::_)).Times(1);
+
+  LoggingManager manager{std::unique_ptr<ISink>(sink_ptr), Severity::kWARNING, false, InstanceType::Temporal};
+
+  Logger logger{manager, session_id, run_tag, Severity::kWARNING, false, -1};
+  Logger logger_without_session_id{manager, no_session_id, run_tag, Severity::kWARNING, false, -1};
+
+  LOGS(logger, WARNING) << "Warning";
+  LOGS(logger, INFO) << "filtered";
+  LOGS(logger_without_session_id, WARNING) << "Warning";
+}
+
 /// <summary>
 /// Tests that the logging manager constructor validates its usage correctly.
 /// </summary>
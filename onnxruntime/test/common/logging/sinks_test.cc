@@ -1,8 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <future>
+#include <thread>
+#include <vector>
+
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -144,3 +149,111 @@ TEST(LoggingTests, TestCompositeSink) {
 
   LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning";
 }
+
+/// <summary>
+/// Tests that the AsyncSink sends the messages to its sink.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kWARNING;
+
+  MockSink* sink_ptr = new MockSink();
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, logid, testing::_)).Times(2);
+
+  LoggingManager manager{std::unique_ptr<ISink>(sink_ptr), min_log_level, false, InstanceType::Temporal};
+  manager.EnableAsyncSink(16);
+
+  auto logger = manager.CreateLogger(logid);
+
+  LOGS(*logger, WARNING) << "Warning";
+  LOGS(*logger, ERROR) << "Error";
+  // the queued messages are sent when the manager is destroyed
+}
+
+/// <summary>
+/// Tests that the AsyncSink drops the messages logged while its queue is full, and reports how many.
+/// </summary>
+TEST(LoggingTests, TestAsyncSinkDropsMessagesWhenFull) {
+  // holds the background thread in the first message until released
+  class BlockingSink : public ISink {
+   public:
+    BlockingSink(std::promise<void>& started, std::shared_future<void> released, std::vector<std::string>& messages)
+        : started_{started}, released_{released}, messages_{messages} {}
+
+    void SendImpl(const Timestamp&, const std::string&, const Capture& message) override {
+      if (messages_.empty()) {
+        started_.set_value();
+        released_.wait();
+      }
+      messages_.push_back(message.Message());
+    }
+
+   private:
+    std::promise<void>& started_;
+    std::shared_future<void> released_;
+    std::vector<std::string>& messages_;
+  };
+
+  std::promise<void> started;
+  std::promise<void> released;
+  std::vector<std::string> messages;
+  auto* sink = new AsyncSink(std::make_unique<BlockingSink>(started, released.get_future().share(), messages), 2);
+  LoggingManager manager{std::unique_ptr<ISink>(sink), Severity::kWARNING, false, InstanceType::Temporal};
+  auto logger = manager.CreateLogger("TestAsyncSinkDropsMessagesWhenFull");
+
+  LOGS(*logger, WARNING) << "0";
+  started.get_future().wait();
+  for (int i = 1; i <= 4; ++i) {
+    LOGS(*logger, WARNING) << i;
+  }
+  EXPECT_EQ(sink->DroppedMessages(), 2u);
+
+  released.set_value();
+  sink->Flush();
+  // the drops are reported after the message that was being sent
+  ASSERT_EQ(messages.size(), 4u);
+  EXPECT_EQ(messages[0], "0");
+  EXPECT_NE(messages[1].find("2 log messages were dropped"), std::string::npos);
+  EXPECT_EQ(messages[2], "1");
+  EXPECT_EQ(messages[3], "2");
+}
+
+/// <summary>
+/// Tests that the AsyncSink sends the profile events to its sink from the background thread.
+/// </summary>
+TEST(LoggingTests, TestAsyncSinkProfileEvents) {
+  class ProfileSink : public ISink {
+   public:
+    ProfileSink(std::vector<std::string>& names, std::vector<std::thread::id>& thread_ids)
+        : names_{names}, thread_ids_{thread_ids} {}
+
+    void SendProfileEvent(onnxruntime::profiling::EventRecord& eventRecord) const override {
+      names_.push_back(eventRecord.name);
+      thread_ids_.push_back(std::this_thread::get_id());
+    }
+
+   private:
+    void SendImpl(const Timestamp&, const std::string&, const Capture&) override {}
+
+    std::vector<std::string>& names_;
+    std::vector<std::thread::id>& thread_ids_;
+  };
+
+  std::vector<std::string> names;
+  std::vector<std::thread::id> thread_ids;
+  AsyncSink sink{std::make_unique<ProfileSink>(names, thread_ids), 2};
+
+  // profile events aren't dropped when the queue is full
+  for (int i = 0; i < 4; ++i) {
+    onnxruntime::profiling::EventRecord event{onnxruntime::profiling::NODE_EVENT, 0, 0, "event" + std::to_string(i),
+                                              0, 0, {}};
+    sink.SendProfileEvent(event);
+  }
+  sink.Flush();
+
+  EXPECT_EQ(names, (std::vector<std::string>{"event0", "event1", "event2", "event3"}));
+  for (const auto& thread_id : thread_ids) {
+    EXPECT_NE(thread_id, std::this_thread::get_id());
+  }
+  EXPECT_EQ(sink.DroppedMessages(), 0u);
+}
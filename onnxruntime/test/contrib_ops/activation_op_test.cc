@@ -14,8 +14,9 @@ void TestActivationContribOp(const char* szOp, std::vector<float>& input_vals,
                              std::function<float(float)> expected_func,
                              const std::unordered_map<std::string, float> attribs = {},
                              bool is_tensorrt_supported = true,
-                             int opset_version = 7) {
-  OpTester test(szOp, opset_version);
+                             int opset_version = 7,
+                             const char* domain = kOnnxDomain) {
+  OpTester test(szOp, opset_version, domain);
 
   for (auto attr : attribs)
     test.AddAttribute(attr.first, attr.second);
@@ -77,5 +78,14 @@ TEST(ActivationContribOpTest, ParametricSoftplus) {
                           {{"alpha", alpha}, {"beta", beta}});
 }
 
+TEST(ActivationContribOpTest, Gelu) {
+  std::vector<float> gelu_input_values = {-100.0f, -3.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 3.0f, 100.0f};
+
+  TestActivationContribOp("Gelu",
+                          gelu_input_values,
+                          [](float x) { return 0.5f * x * (1.0f + std::erf(x * 0.70710678f)); },
+                          {}, false, 1, kMSDomain);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Computes Softmax(scale * Q * K + mask) * V for Q [B, S, D], K [B, D, L], V [B, L, Dv] and a
+// mask that is either empty or holds one row of L elements per batch.
+static std::vector<float> ReferenceAttention(const std::vector<float>& Q, const std::vector<float>& K,
+                                             const std::vector<float>& V, const std::vector<float>& mask,
+                                             int64_t B, int64_t S, int64_t D, int64_t L, int64_t Dv,
+                                             float scale) {
+  std::vector<float> Y(B * S * Dv, 0.0f);
+  std::vector<double> scores(L);
+  for (int64_t b = 0; b < B; b++) {
+    for (int64_t s = 0; s < S; s++) {
+      double max_score = -std::numeric_limits<double>::infinity();
+      for (int64_t l = 0; l < L; l++) {
+        double sum = 0.0;
+        for (int64_t d = 0; d < D; d++) {
+          sum += Q[(b * S + s) * D + d] * K[(b * D + d) * L + l];
+        }
+        scores[l] = scale * sum + (mask.empty() ? 0.0 : mask[b * L + l]);
+        max_score = std::max(max_score, scores[l]);
+      }
+      double total = 0.0;
+      for (int64_t l = 0; l < L; l++) {
+        scores[l] = std::exp(scores[l] - max_score);
+        total += scores[l];
+      }
+      for (int64_t v = 0; v < Dv; v++) {
+        double sum = 0.0;
+        for (int64_t l = 0; l < L; l++) {
+          sum += scores[l] / total * V[(b * L + l) * Dv + v];
+        }
+        Y[(b * S + s) * Dv + v] = static_cast<float>(sum);
+      }
+    }
+  }
+  return Y;
+}
+
+static std::vector<float> FillValues(size_t count, int seed) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<float>(static_cast<int>((i * 7 + seed) % 13) - 6) * 0.125f;
+  }
+  return values;
+}
+
+TEST(AttentionTest, MultiHeadWithMask) {
+  // Two batches of two heads, where the mask is shared by the heads of a batch.
+  constexpr int64_t batch = 2, heads = 2, S = 3, D = 4, L = 5, Dv = 4;
+  const float scale = 0.5f;
+
+  auto Q = FillValues(batch * heads * S * D, 1);
+  auto K = FillValues(batch * heads * D * L, 2);
+  auto V = FillValues(batch * heads * L * Dv, 3);
+  std::vector<float> mask = {0.0f, 0.0f, 0.0f, -10000.0f, -10000.0f,
+                             0.0f, 0.0f, 0.0f, 0.0f, -10000.0f};
+
+  std::vector<float> head_mask;
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t h = 0; h < heads; h++) {
+      head_mask.insert(head_mask.end(), mask.begin() + b * L, mask.begin() + (b + 1) * L);
+    }
+  }
+
+  OpTester test("ScaledDotProductAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("scale", scale);
+  test.AddInput<float>("Q", {batch, heads, S, D}, Q);
+  test.AddInput<float>("K", {batch, heads, D, L}, K);
+  test.AddInput<float>("V", {batch, heads, L, Dv}, V);
+  test.AddInput<float>("mask", {batch, 1, 1, L}, mask);
+  test.AddOutput<float>("Y", {batch, heads, S, Dv},
+                        ReferenceAttention(Q, K, V, head_mask, batch * heads, S, D, L, Dv, scale));
+  test.Run();
+}
+
+TEST(AttentionTest, NoMask) {
+  constexpr int64_t batch = 3, S = 2, D = 8, L = 6, Dv = 3;
+  const float scale = 0.35355339f;
+
+  auto Q = FillValues(batch * S * D, 4);
+  auto K = FillValues(batch * D * L, 5);
+  auto V = FillValues(batch * L * Dv, 6);
+
+  OpTester test("ScaledDotProductAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("scale", scale);
+  test.AddInput<float>("Q", {batch, S, D}, Q);
+  test.AddInput<float>("K", {batch, D, L}, K);
+  test.AddInput<float>("V", {batch, L, Dv}, V);
+  test.AddMissingOptionalInput<float>();
+  test.AddOutput<float>("Y", {batch, S, Dv}, ReferenceAttention(Q, K, V, {}, batch, S, D, L, Dv, scale));
+  test.Run();
+}
+
+TEST(AttentionTest, InvalidMask) {
+  OpTester test("ScaledDotProductAttention", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("Q", {1, 2, 2}, std::vector<float>(4, 1.0f));
+  test.AddInput<float>("K", {1, 2, 3}, std::vector<float>(6, 1.0f));
+  test.AddInput<float>("V", {1, 3, 2}, std::vector<float>(6, 1.0f));
+  test.AddInput<float>("mask", {2}, std::vector<float>(2, 0.0f));
+  test.AddOutput<float>("Y", {1, 2, 2}, std::vector<float>(4, 1.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "does not broadcast to the attention scores");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
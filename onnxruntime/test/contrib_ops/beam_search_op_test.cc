@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "test/providers/provider_test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Decoder with a vocabulary of 4 tokens, of which token 0 ends a sequence, and a single layer with one head of size
+// 4. The logits are the log probabilities of a bigram table for the input token, minus 100 for each token in the
+// past key cache. The present key and value are the one-hot encoding of the input token, so the caches hold the
+// tokens before the input token of each beam and a token is only repeated right after itself.
+static GraphProto CreateDecoder() {
+  Model model("BeamSearch decoder");
+  auto& graph = model.MainGraph();
+
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& input_ids = graph.GetOrCreateNodeArg("input_ids", &int64_tensor);
+  auto& position = graph.GetOrCreateNodeArg("position", &int64_scalar);
+  auto& past_key = graph.GetOrCreateNodeArg("past_key", &float_tensor);
+  auto& past_value = graph.GetOrCreateNodeArg("past_value", &float_tensor);
+
+  auto& bigram_table = graph.GetOrCreateNodeArg("bigram_table", &float_tensor);
+  auto& one_hot_table = graph.GetOrCreateNodeArg("one_hot_table", &float_tensor);
+  auto& penalty = graph.GetOrCreateNodeArg("penalty", &float_tensor);
+
+  auto& bigram_rows = graph.GetOrCreateNodeArg("bigram_rows", &float_tensor);
+  auto& bigram_logits = graph.GetOrCreateNodeArg("bigram_logits", &float_tensor);
+  auto& seen = graph.GetOrCreateNodeArg("seen", &float_tensor);
+  auto& seen_penalty = graph.GetOrCreateNodeArg("seen_penalty", &float_tensor);
+  auto& logits = graph.GetOrCreateNodeArg("logits", &float_tensor);
+  auto& one_hot = graph.GetOrCreateNodeArg("one_hot", &float_tensor);
+  auto& present_key = graph.GetOrCreateNodeArg("present_key", &float_tensor);
+  auto& present_value = graph.GetOrCreateNodeArg("present_value", &float_tensor);
+
+  graph.AddNode("gather_bigrams", "Gather", "Bigram log probabilities", {&bigram_table, &input_ids}, {&bigram_rows});
+  auto& squeeze = graph.AddNode("squeeze_bigrams", "Squeeze", "", {&bigram_rows}, {&bigram_logits});
+  squeeze.AddAttribute("axes", std::vector<int64_t>{1});
+  auto& count_seen = graph.AddNode("count_seen", "ReduceSum", "Count the tokens in the cache", {&past_key}, {&seen});
+  count_seen.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  count_seen.AddAttribute("keepdims", int64_t{0});
+  graph.AddNode("scale_seen", "Mul", "", {&seen, &penalty}, {&seen_penalty});
+  graph.AddNode("add_penalty", "Add", "", {&bigram_logits, &seen_penalty}, {&logits});
+  graph.AddNode("gather_one_hot", "Gather", "Encode the input token", {&one_hot_table, &input_ids}, {&one_hot});
+  auto& unsqueeze = graph.AddNode("unsqueeze_one_hot", "Unsqueeze", "", {&one_hot}, {&present_key});
+  unsqueeze.AddAttribute("axes", std::vector<int64_t>{1});
+  graph.AddNode("copy_one_hot", "Identity", "", {&present_key}, {&present_value});
+
+  const float probabilities[4][4] = {{0.25f, 0.25f, 0.25f, 0.25f},
+                                     {0.01f, 0.04f, 0.5f, 0.45f},
+                                     {0.01f, 0.6f, 0.09f, 0.3f},
+                                     {0.01f, 0.3f, 0.09f, 0.6f}};
+  TensorProto bigram_tensor;
+  bigram_tensor.set_name("bigram_table");
+  bigram_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  bigram_tensor.add_dims(4);
+  bigram_tensor.add_dims(4);
+  TensorProto one_hot_tensor{bigram_tensor};
+  one_hot_tensor.set_name("one_hot_table");
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      bigram_tensor.add_float_data(std::log(probabilities[i][j]));
+      one_hot_tensor.add_float_data(i == j ? 1.0f : 0.0f);
+    }
+  }
+  graph.AddInitializedTensor(bigram_tensor);
+  graph.AddInitializedTensor(one_hot_tensor);
+
+  TensorProto penalty_tensor;
+  penalty_tensor.set_name("penalty");
+  penalty_tensor.set_data_type(TensorProto_DataType_FLOAT);
+  penalty_tensor.add_float_data(-100.0f);
+  graph.AddInitializedTensor(penalty_tensor);
+
+  graph.SetInputs({&input_ids, &position, &past_key, &past_value});
+  graph.SetOutputs({&logits, &present_key, &present_value});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+static void AddDecoderAttributes(OpTester& test, int64_t num_beams) {
+  test.AddAttribute("decoder", CreateDecoder());
+  test.AddAttribute<int64_t>("num_beams", num_beams);
+  test.AddAttribute<int64_t>("eos_token_id", 0);
+  test.AddAttribute<int64_t>("num_layers", 1);
+  test.AddAttribute<int64_t>("num_heads", 1);
+  test.AddAttribute<int64_t>("head_size", 4);
+}
+
+TEST(BeamSearchTest, BeamsFollowTheirCaches) {
+  // After [1] the beams are [1, 2] and [1, 3], and the best continuations are [1, 3, 3] and [1, 2, 3]. The first
+  // beam continues the second one and the second beam the first one, so their caches are swapped. With the caches
+  // left in place, 3 would be penalized after [1, 2] instead of 2, and [1, 3, 3, 3] would win.
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  AddDecoderAttributes(test, 2);
+  test.AddInput<int64_t>("input_ids", {2, 1}, {1, 3});
+  test.AddInput<int64_t>("max_length", {}, {4});
+  test.AddOutput<int64_t>("sequences", {2, 4}, {1, 2, 3, 3, 3, 3, 1, 2});
+  test.AddOutput<float>("sequences_scores", {2},
+                        {std::log(0.375f * 0.6f / 0.61f) / 4.0f, std::log(0.6f * 0.75f * (0.5f / 0.55f)) / 4.0f});
+  test.Run();
+}
+
+TEST(BeamSearchTest, GreedyEndsWithEos) {
+  // The prompt is fed before the first token is selected. Once 1, 2 and 3 are in the cache the only
+  // continuation is the end of sequence, and the rest of the sequence is padding.
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  AddDecoderAttributes(test, 1);
+  test.AddAttribute<int64_t>("pad_token_id", 3);
+  test.AddInput<int64_t>("input_ids", {1, 2}, {1, 2});
+  test.AddInput<int64_t>("max_length", {1}, {6});
+  test.AddOutput<int64_t>("sequences", {1, 6}, {1, 2, 3, 3, 0, 3});
+  test.AddOutput<float>("sequences_scores", {1}, {(std::log(0.75f) + std::log(0.6f / 0.61f)) / 4.0f});
+  test.Run();
+}
+
+TEST(BeamSearchTest, MaxLengthShorterThanPrompt) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  AddDecoderAttributes(test, 2);
+  test.AddInput<int64_t>("input_ids", {1, 3}, {1, 2, 3});
+  test.AddInput<int64_t>("max_length", {}, {2});
+  test.AddOutput<int64_t>("sequences", {1, 2}, {0, 0});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is shorter than the prompt length");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A covers [0, 255] so that it is quantized exactly with a scale of 1 and a zero point of 0.
+TEST(DynamicQuantizeMatMulOpTest, ExactQuantization) {
+  const std::vector<float> a{0.f, 255.f, 3.f, 7.f,
+                             10.f, 1.f, 128.f, 2.f};
+  const std::vector<uint8_t> b{1, 2, 3,
+                               4, 5, 6,
+                               7, 8, 9,
+                               10, 11, 12};
+  const std::vector<float> b_scale{0.5f, 1.0f, 2.0f};
+  const std::vector<uint8_t> b_zero_point{2, 0, 8};
+  const std::vector<float> bias{1.0f, -1.0f, 0.5f};
+
+  std::vector<float> y(6);
+  for (int m = 0; m < 2; m++) {
+    for (int n = 0; n < 3; n++) {
+      float sum = 0.0f;
+      for (int k = 0; k < 4; k++) {
+        sum += a[m * 4 + k] * (static_cast<int>(b[k * 3 + n]) - b_zero_point[n]);
+      }
+      y[m * 3 + n] = sum * b_scale[n] + bias[n];
+    }
+  }
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 4}, a);
+  test.AddInput<uint8_t>("B", {4, 3}, b);
+  test.AddInput<float>("b_scale", {3}, b_scale);
+  test.AddInput<uint8_t>("b_zero_point", {3}, b_zero_point);
+  test.AddInput<float>("bias", {3}, bias);
+  test.AddOutput<float>("Y", {2, 3}, y);
+  test.Run();
+}
+
+// Compares a batched product with a signed B against the float product of the dequantized B.
+TEST(DynamicQuantizeMatMulOpTest, SignedWeightsBatched) {
+  const std::vector<float> a{-1.0f, 0.5f, 0.25f, 0.75f,
+                             0.1f, -0.3f, 0.9f, -0.6f,
+                             0.0f, 0.2f, -0.8f, 0.4f,
+                             1.0f, -0.5f, 0.3f, 0.6f};
+  const std::vector<int8_t> b{-128, 5, 64,
+                              17, -3, 127,
+                              0, -77, 31,
+                              99, 12, -50};
+  const float b_scale = 0.01f;
+
+  std::vector<float> y(12);
+  for (int m = 0; m < 4; m++) {
+    for (int n = 0; n < 3; n++) {
+      float sum = 0.0f;
+      for (int k = 0; k < 4; k++) {
+        sum += a[m * 4 + k] * b[k * 3 + n] * b_scale;
+      }
+      y[m * 3 + n] = sum;
+    }
+  }
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 2, 4}, a);
+  test.AddInput<int8_t>("B", {4, 3}, b);
+  test.AddInput<float>("b_scale", {}, {b_scale});
+  test.AddOutput<float>("Y", {2, 2, 3}, y);
+  // A is quantized with a step of 2/255, so each product can be off by about K * step / 2 * max|B|.
+  test.SetOutputAbsErr("Y", 0.03f);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -47,5 +47,18 @@ TEST(MathOpTest, Scale_Default) {
   test.Run();
 }
 
+#ifdef USE_CUDA
+// FusedElementwise is only implemented by CUDA.
+TEST(MathOpTest, FusedElementwise) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "RSub", "Relu"});
+  test.AddInput<float>("X", {2, 3}, {-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f});
+  test.AddInput<float>("scale", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddInput<float>("bias", {1}, {0.5f});
+  test.AddOutput<float>("Y", {2, 3}, {2.5f, 2.5f, 0.5f, 0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
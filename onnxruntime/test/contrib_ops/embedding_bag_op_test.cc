@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<float> ReferenceEmbeddingBag(const std::vector<float>& data, int64_t D,
+                                                const std::vector<int64_t>& indices,
+                                                const std::vector<int64_t>& offsets,
+                                                const std::vector<float>& weights, bool mean) {
+  std::vector<float> Y(offsets.size() * D, 0.0f);
+  for (size_t b = 0; b < offsets.size(); b++) {
+    const int64_t begin = offsets[b];
+    const int64_t end = b + 1 < offsets.size() ? offsets[b + 1] : static_cast<int64_t>(indices.size());
+    for (int64_t i = begin; i < end; i++) {
+      for (int64_t j = 0; j < D; j++) {
+        const float value = data[indices[i] * D + j];
+        Y[b * D + j] += weights.empty() ? value : weights[i] * value;
+      }
+    }
+    if (mean && end > begin) {
+      for (int64_t j = 0; j < D; j++) {
+        Y[b * D + j] /= static_cast<float>(end - begin);
+      }
+    }
+  }
+  return Y;
+}
+
+static std::vector<float> MakeTable(int64_t num_embeddings, int64_t D) {
+  std::vector<float> data(num_embeddings * D);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<float>((i * 7) % 13) * 0.25f - 1.5f;
+  }
+  return data;
+}
+
+TEST(EmbeddingBagTest, SumWithOffsets) {
+  // The second bag is empty and the last bag extends to the end of the indices.
+  std::vector<float> data = MakeTable(6, 3);
+  std::vector<int64_t> indices = {0, 2, 2, 5, 1, 4};
+  std::vector<int64_t> offsets = {0, 2, 2, 4};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {6, 3}, data);
+  test.AddInput<int64_t>("indices", {6}, indices);
+  test.AddInput<int64_t>("offsets", {4}, offsets);
+  test.AddOutput<float>("Y", {4, 3}, ReferenceEmbeddingBag(data, 3, indices, offsets, {}, false));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanWithPerSampleWeights) {
+  std::vector<float> data = MakeTable(5, 4);
+  std::vector<int32_t> indices = {4, 0, 3, 3, 1};
+  std::vector<int32_t> offsets = {0, 3};
+  std::vector<float> weights = {0.5f, 2.0f, -1.0f, 1.5f, 0.25f};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("data", {5, 4}, data);
+  test.AddInput<int32_t>("indices", {5}, indices);
+  test.AddInput<int32_t>("offsets", {2}, offsets);
+  test.AddInput<float>("per_sample_weights", {5}, weights);
+  test.AddOutput<float>("Y", {2, 4},
+                        ReferenceEmbeddingBag(data, 4, {4, 0, 3, 3, 1}, {0, 3}, weights, true));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, FixedSizeBags) {
+  // Without offsets, each row of the 2-D indices is a bag.
+  std::vector<float> data = MakeTable(8, 16);
+  std::vector<int64_t> indices = {7, 1, 0, 3, 3, 3, 6, 2, 5, 4, 0, 7};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "sum");
+  test.AddInput<float>("data", {8, 16}, data);
+  test.AddInput<int64_t>("indices", {4, 3}, indices);
+  test.AddOutput<float>("Y", {4, 16}, ReferenceEmbeddingBag(data, 16, indices, {0, 3, 6, 9}, {}, false));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, InvalidIndices) {
+  // The CUDA kernel skips the rows outside of the table instead of failing.
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<int64_t>("indices", {3}, {0, 2, 1});
+  test.AddInput<int64_t>("offsets", {1}, {0});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds", {kCudaExecutionProvider});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
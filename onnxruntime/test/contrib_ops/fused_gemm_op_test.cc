@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace test {
+
+// A (2, 4) x B (4, 3) + C, with C either a row of 3 or a (2, 3) matrix.
+static void RunFusedGemmTest(const std::string& activation, const std::vector<int64_t>& c_dims,
+                             const std::vector<float>& c, bool trans_b) {
+  const std::vector<float> a = {1.0f, -2.0f, 3.0f, -4.0f,
+                                -0.5f, 1.5f, -2.5f, 3.5f};
+  const std::vector<float> b = {0.5f, -1.0f, 2.0f,
+                                1.0f, 0.25f, -0.5f,
+                                -1.5f, 2.0f, 0.75f,
+                                2.0f, -0.5f, 1.0f};
+  const float leaky_relu_alpha = 0.1f;
+
+  std::vector<float> y(6);
+  for (int m = 0; m < 2; m++) {
+    for (int n = 0; n < 3; n++) {
+      float value = c.size() == 3 ? c[n] : c[m * 3 + n];
+      for (int k = 0; k < 4; k++) {
+        value += a[m * 4 + k] * b[k * 3 + n];
+      }
+      if (activation == "Relu") {
+        value = std::max(value, 0.0f);
+      } else if (activation == "LeakyRelu") {
+        value = value >= 0.0f ? value : leaky_relu_alpha * value;
+      }
+      y[m * 3 + n] = value;
+    }
+  }
+
+  std::vector<float> b_input = b;
+  std::vector<int64_t> b_dims = {4, 3};
+  if (trans_b) {
+    for (int k = 0; k < 4; k++) {
+      for (int n = 0; n < 3; n++) {
+        b_input[n * 4 + k] = b[k * 3 + n];
+      }
+    }
+    b_dims = {3, 4};
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(trans_b ? 1 : 0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", activation);
+  if (activation == "LeakyRelu") {
+    test.AddAttribute("leaky_relu_alpha", leaky_relu_alpha);
+  }
+  test.AddInput<float>("A", {2, 4}, a);
+  test.AddInput<float>("B", b_dims, b_input);
+  test.AddInput<float>("C", c_dims, c);
+  test.AddOutput<float>("Y", {2, 3}, y);
+  test.Run();
+}
+
+TEST(FusedGemmTest, ReluWithRowBias) {
+  RunFusedGemmTest("Relu", {3}, {0.5f, -1.0f, 0.25f}, false);
+}
+
+TEST(FusedGemmTest, ReluWithRowBiasTransB) {
+  RunFusedGemmTest("Relu", {1, 3}, {0.5f, -1.0f, 0.25f}, true);
+}
+
+TEST(FusedGemmTest, LeakyReluWithRowBias) {
+  RunFusedGemmTest("LeakyRelu", {3}, {0.5f, -1.0f, 0.25f}, false);
+}
+
+TEST(FusedGemmTest, ReluWithMatrixBias) {
+  RunFusedGemmTest("Relu", {2, 3}, {0.5f, -1.0f, 0.25f, -0.5f, 1.0f, -0.25f}, false);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<float> ReferenceLayerNorm(const std::vector<float>& X, const std::vector<float>& scale,
+                                             const std::vector<float>& bias, float epsilon) {
+  const size_t D = scale.size();
+  std::vector<float> Y(X.size());
+  for (size_t row = 0; row < X.size() / D; row++) {
+    double mean = 0.0;
+    for (size_t i = 0; i < D; i++) {
+      mean += X[row * D + i];
+    }
+    mean /= D;
+    double variance = 0.0;
+    for (size_t i = 0; i < D; i++) {
+      variance += (X[row * D + i] - mean) * (X[row * D + i] - mean);
+    }
+    variance /= D;
+    for (size_t i = 0; i < D; i++) {
+      double value = (X[row * D + i] - mean) / std::sqrt(variance + epsilon) * scale[i];
+      Y[row * D + i] = static_cast<float>(bias.empty() ? value : value + bias[i]);
+    }
+  }
+  return Y;
+}
+
+TEST(LayerNormTest, LastAxis) {
+  std::vector<float> X = {0.8f, -0.5f, 0.0f, 1.0f,
+                          0.5f, 0.2f, 0.3f, -0.6f,
+                          10.0f, 20.0f, 30.0f, 40.0f};
+  std::vector<float> scale = {1.0f, 0.5f, 2.0f, -1.0f};
+  std::vector<float> bias = {0.0f, 0.1f, -0.2f, 0.3f};
+
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-5f);
+  test.AddInput<float>("X", {3, 4}, X);
+  test.AddInput<float>("Scale", {4}, scale);
+  test.AddInput<float>("B", {4}, bias);
+  test.AddOutput<float>("Y", {3, 4}, ReferenceLayerNorm(X, scale, bias, 1e-5f));
+  test.Run();
+}
+
+TEST(LayerNormTest, NoBias) {
+  std::vector<float> X = {0.8f, -0.5f, 0.0f, 1.0f,
+                          0.5f, 0.2f, 0.3f, -0.6f};
+  std::vector<float> scale = {1.0f, 0.5f, 2.0f, -1.0f};
+
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-3f);
+  test.AddInput<float>("X", {1, 2, 4}, X);
+  test.AddInput<float>("Scale", {4}, scale);
+  test.AddMissingOptionalInput<float>();
+  test.AddOutput<float>("Y", {1, 2, 4}, ReferenceLayerNorm(X, scale, {}, 1e-3f));
+  test.Run();
+}
+
+TEST(LayerNormTest, InnerAxes) {
+  // Normalize over the last two dimensions.
+  std::vector<float> X(2 * 3 * 5);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>((i * 7) % 11) - 5.0f;
+  }
+  std::vector<float> scale(15, 1.5f);
+  std::vector<float> bias(15, -0.25f);
+
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddAttribute<float>("epsilon", 1e-5f);
+  test.AddInput<float>("X", {2, 3, 5}, X);
+  test.AddInput<float>("Scale", {3, 5}, scale);
+  test.AddInput<float>("B", {3, 5}, bias);
+  test.AddOutput<float>("Y", {2, 3, 5}, ReferenceLayerNorm(X, scale, bias, 1e-5f));
+  test.Run();
+}
+
+TEST(LayerNormTest, InvalidScale) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-5f);
+  test.AddInput<float>("X", {2, 4}, std::vector<float>(8, 1.0f));
+  test.AddInput<float>("Scale", {3}, std::vector<float>(3, 1.0f));
+  test.AddInput<float>("B", {3}, std::vector<float>(3, 0.0f));
+  test.AddOutput<float>("Y", {2, 4}, std::vector<float>(8, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Scale and B must have the shape of the normalized dimensions");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+#include <functional>
+#include <numeric>
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Runs MatMulNBits with weights q[k * N + n] in [-(2^(bits-1)-1), 2^(bits-1)-1] and a scale for each block of each
+// column, and compares against the float product of the dequantized weights. The values are small multiples of
+// powers of 2, so the sums are exact in any order.
+void RunMatMulNBitsTest(const std::vector<int64_t>& a_dims, int64_t K, int64_t N, int64_t bits, int64_t block_size,
+                        bool constant_b, bool has_bias) {
+  const int64_t M = std::accumulate(a_dims.begin(), a_dims.end() - 1, int64_t{1}, std::multiplies<int64_t>());
+  const int64_t block_count = (K + block_size - 1) / block_size;
+  const int64_t maximum = (int64_t{1} << (bits - 1)) - 1;
+
+  std::vector<float> a(M * K);
+  for (int64_t i = 0; i < M * K; i++) {
+    a[i] = static_cast<float>((i * 7) % 11 - 5) * 0.125f;
+  }
+
+  std::vector<int> q(K * N);
+  for (int64_t i = 0; i < K * N; i++) {
+    q[i] = static_cast<int>((i * 13) % (2 * maximum + 1) - maximum);
+  }
+
+  std::vector<float> scales(N * block_count);
+  for (int64_t i = 0; i < N * block_count; i++) {
+    scales[i] = 0.25f + static_cast<float>(i % 5) * 0.0625f;
+  }
+
+  std::vector<float> bias(N);
+  for (int64_t n = 0; n < N; n++) {
+    bias[n] = static_cast<float>(n % 3) - 1.0f;
+  }
+
+  // The weights of each column then of each block, offset to unsigned values, with two 4-bit weights of
+  // consecutive rows in a byte. The padding rows of the last block are zero weights.
+  const int64_t block_bytes = block_size * bits / 8;
+  std::vector<uint8_t> b(N * block_count * block_bytes, 0);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t k = 0; k < block_count * block_size; k++) {
+      const int value = (k < K) ? q[k * N + n] : 0;
+      const uint8_t stored = static_cast<uint8_t>(value + maximum + 1);
+      const int64_t block = k / block_size;
+      const int64_t index = k % block_size;
+      uint8_t* block_data = b.data() + (n * block_count + block) * block_bytes;
+      if (bits == 8) {
+        block_data[index] = stored;
+      } else {
+        block_data[index / 2] |= static_cast<uint8_t>(stored << ((index % 2) * 4));
+      }
+    }
+  }
+
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = has_bias ? bias[n] : 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * static_cast<float>(q[k * N + n]) * scales[n * block_count + k / block_size];
+      }
+      y[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> y_dims(a_dims);
+  y_dims.back() = N;
+
+  OpTester test("MatMulNBits", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<uint8_t>("B", {static_cast<int64_t>(b.size())}, b, constant_b);
+  test.AddInput<float>("scales", {N * block_count}, scales, constant_b);
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, bias);
+  }
+  test.AddOutput<float>("Y", y_dims, y);
+  test.Run();
+}
+}  // namespace
+
+TEST(MatMulNBitsOpTest, Int8Weights) {
+  RunMatMulNBitsTest({1, 20}, 20, 3, 8, 16, false, true);
+  RunMatMulNBitsTest({2, 64}, 64, 33, 8, 32, true, false);
+}
+
+TEST(MatMulNBitsOpTest, Int4Weights) {
+  RunMatMulNBitsTest({1, 40}, 40, 17, 4, 16, true, true);
+  RunMatMulNBitsTest({3, 128}, 128, 16, 4, 64, false, false);
+}
+
+// Batched A with enough rows that the weights are dequantized to a buffer for the float GEMM.
+TEST(MatMulNBitsOpTest, BatchedRows) {
+  RunMatMulNBitsTest({2, 5, 50}, 50, 20, 4, 16, true, true);
+  RunMatMulNBitsTest({3, 4, 33}, 33, 40, 8, 32, true, true);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -124,15 +124,19 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool memory_efficient_order = false)
+      : shape_map_(shape_map), memory_efficient_order_(memory_efficient_order) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool IsMemoryEfficientOrderEnabled() const override { return memory_efficient_order_; }
+
  private:
   ShapeMap* shape_map_;
+  bool memory_efficient_order_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -149,6 +153,8 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> alias_kernel_;     // a unary kernel aliasing its output to its input
+  std::unique_ptr<::onnxruntime::KernelDef> strided_kernel_;   // a unary kernel whose output may be a strided view
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -166,6 +172,14 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    alias_kernel_ =
+        KernelDefBuilder().SetName("Flatten").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Alias(0, 0).Build();
+    strided_kernel_ = KernelDefBuilder()
+                          .SetName("Squeeze")
+                          .Provider(kCpuExecutionProvider)
+                          .SinceVersion(1, 10)
+                          .MayStridedOutput(0, 0)
+                          .Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = std::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -188,6 +202,15 @@ class PlannerTest : public ::testing::Test {
     return p_node;
   }
 
+  onnxruntime::Node* AddBinaryNode(::onnxruntime::KernelDef& kernel_def, std::string& input1, std::string& input2,
+                                   std::string& output) {
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), kernel_def.OpName(), "test op",
+                                   {Arg(input1), Arg(input2)}, {Arg(output)});
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    kernel_bindings_.emplace_back(p_node, kernel_def);
+    return p_node;
+  }
+
   onnxruntime::Node* AddNormalNode(std::string& input, std::string& output) {
     return AddNode(*std_kernel_, input, output);
   }
@@ -196,6 +219,14 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddAliasNode(std::string& input, std::string& output) {
+    return AddNode(*alias_kernel_, input, output);
+  }
+
+  onnxruntime::Node* AddStridedNode(std::string& input, std::string& output) {
+    return AddNode(*strided_kernel_, input, output);
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg) {
     auto info = std::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node),
                                                state_.GetInitializedTensors(), state_.GetOrtValueNameIdxMap(),
@@ -217,7 +248,7 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}, bool memory_efficient_order = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
     state_.SetGraph(graph_);
@@ -237,7 +268,7 @@ class PlannerTest : public ::testing::Test {
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
     status = state_.CreateKernels(kernel_registry_manager);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, memory_efficient_order);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, state_.GetOrtValueNameIdxMap(), test_context, plan_);
 
@@ -378,6 +409,126 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(2, {X2});
 }
 
+// InPlaceOutputTest: Check that a temporary whose only use is an in-place computation of an output
+// is planned to be written into the output's buffer, and that other temporaries aren't.
+TEST_F(PlannerTest, InPlaceOutputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddInplaceNode(X2, X3);  // may-in-place operator; X3: output
+  AddNormalNode(X1, X4);   // no in-place operator; X4: temporary
+  AddInplaceNode(X4, X5);  // may-in-place operator; X5: output
+  AddNormalNode(X4, X6);   // no in-place operator; X6: output, so X4 has another use
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan();
+
+  int x2, x3, x4;
+  index(X2, x2);
+  index(X3, x3);
+  index(X4, x4);
+  EXPECT_EQ(GetPlan().allocation_plan[x2].inplace_output, x3);
+  EXPECT_EQ(GetPlan().allocation_plan[x4].inplace_output, -1);
+  EXPECT_EQ(GetPlan().planner_stats.num_inplace_output_candidates, 1u);
+}
+
+// OutputViewTest: Check that a graph output produced by an aliasing kernel is planned as a view of its input
+// when nothing else uses or reuses that input, and that the input then gets a buffer of its own.
+TEST_F(PlannerTest, OutputViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // no in-place operator; X1: input; X2: temporary
+  AddAliasNode(X2, X3);   // aliasing operator; X3: output
+  AddNormalNode(X1, X4);  // no in-place operator; X4: temporary
+  AddAliasNode(X4, X5);   // aliasing operator; X5: output
+  AddNormalNode(X4, X6);  // no in-place operator; X6: output, so X4 has another use
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan();
+
+  int x2, x3, x5;
+  index(X2, x2);
+  index(X3, x3);
+  index(X5, x5);
+  CheckAllocKind(X2, AllocKind::kAllocateOutput);
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  EXPECT_EQ(GetPlan().allocation_plan[x3].view_of, x2);
+  EXPECT_EQ(GetPlan().allocation_plan[x5].view_of, -1);
+  EXPECT_EQ(GetPlan().planner_stats.num_output_views, 1u);
+}
+
+// StridedViewTest: Check that the output of a kernel that may produce a strided view of its input shares the
+// input buffer, and that the view is released along with that buffer.
+TEST_F(PlannerTest, StridedViewTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddStridedNode(X2, X3);  // may-strided-output operator; X3: temporary
+  AddNormalNode(X3, X4);   // no in-place operator; X4: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}});
+
+  CreatePlan();
+
+  int x2, x3;
+  index(X2, x2);
+  index(X3, x3);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  EXPECT_EQ(GetPlan().allocation_plan[x3].reused_buffer, x2);
+  EXPECT_EQ(GetPlan().allocation_plan[x3].view_of, x2);
+  EXPECT_EQ(GetPlan().planner_stats.num_strided_views, 1u);
+
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X2, X3});
+}
+
+// StridedViewAliasTest: Check that the output of a kernel aliasing its input doesn't share the buffer of a strided
+// view, as the kernel gets a contiguous copy of the view and copies it into its output.
+TEST_F(PlannerTest, StridedViewAliasTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // no in-place operator; X1: input; X2: temporary
+  AddStridedNode(X2, X3);  // may-strided-output operator; X3: temporary
+  AddAliasNode(X3, X4);    // aliasing operator; X4: temporary
+  AddNormalNode(X4, X5);   // no in-place operator; X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan();
+
+  int x4;
+  index(X4, x4);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  EXPECT_EQ(GetPlan().allocation_plan[x4].view_of, -1);
+  EXPECT_EQ(GetPlan().planner_stats.num_strided_views, 1u);
+}
+
 // InPlaceSizeMismatchTest: Check that Inplace reuse is not allowed when sizes don't match.
 // Also tests reuse of disjoint lifetime tensors.
 TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
@@ -413,6 +564,129 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// InPlaceBroadcastTest: Check that a broadcasting elementwise op reuses the input its other input is broadcast onto,
+// even when the shape of its output is unknown.
+TEST_F(PlannerTest, InPlaceBroadcastTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), B("B"), X3("X3"), X4("X4"), X5("X5");
+
+  auto add_kernel =
+      KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(7, 10).MayInplace(0, 0).Build();
+
+  // graph structure:
+  AddNormalNode(X1, X2);                  // no in-place operator; X1: input; X2: temporary
+  AddBinaryNode(*add_kernel, X2, B, X3);  // B: input broadcast along the rows of X2; X3: temporary
+  AddNormalNode(X3, X4);                  // no in-place operator; X4: temporary
+  AddBinaryNode(*add_kernel, B, X4, X5);  // B + X4 would grow B; X5: output
+
+  // simulate shape-inference results, with the shapes of X3 and X5 unknown:
+  Shape shape1w{"M", 8};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{8};
+  auto shape2 = &shape2w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {B, shape2}, {X4, shape1}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+
+  int x2, x3;
+  index(X2, x2);
+  index(X3, x3);
+  EXPECT_EQ(GetPlan().allocation_plan[x3].reused_buffer, x2);
+}
+
+// BestFitReuseTest: Check that a dead buffer is reused for a smaller tensor, picking the smallest one that fits.
+TEST_F(PlannerTest, BestFitReuseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddNormalNode(X2, X3);  // X3: temporary, bigger than X2
+  AddNormalNode(X3, X4);  // X4: temporary, bigger than X2 and X3
+  AddNormalNode(X4, X5);  // X5: temporary, smaller than X2 and X3 and with a different shape
+  AddNormalNode(X5, X6);  // X6: output
+
+  // simulate shape-inference results:
+  Shape shape2{50, 100};
+  Shape shape3{60, 100};
+  Shape shape4{70, 100};
+  Shape shape5{100, 40};
+  Shape shape6{40, 100};
+  SetShape({{X1, &shape2.value}, {X2, &shape2.value}, {X3, &shape3.value}, {X4, &shape4.value},
+            {X5, &shape5.value}, {X6, &shape6.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckAllocKind(X5, AllocKind::kReuse);
+  CheckAllocKind(X6, AllocKind::kAllocateOutput);
+
+  // X2 and X3 are dead when X5 is allocated. X3 was freed more recently but X2 fits better.
+  int x2, x5;
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X2, x2).IsOK());
+  ASSERT_TRUE(GetState().GetOrtValueNameIdxMap().GetIdx(X5, x5).IsOK());
+  EXPECT_EQ(GetPlan().allocation_plan[x5].reused_buffer, x2);
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X3});
+  CheckFreed(3, {X4});
+  CheckFreed(4, {X2});
+
+  const auto& stats = GetPlan().planner_stats;
+  EXPECT_EQ(stats.num_inplace_reuses, 0u);
+  EXPECT_EQ(stats.num_same_size_reuses, 0u);
+  EXPECT_EQ(stats.num_best_fit_reuses, 1u);
+  EXPECT_EQ(stats.num_unknown_size_tensors, 0u);
+  EXPECT_EQ(stats.allocated_bytes, (5000u + 6000u + 7000u + 4000u) * sizeof(float));
+  EXPECT_EQ(stats.allocated_bytes_without_reuse, (5000u + 6000u + 7000u + 4000u + 4000u) * sizeof(float));
+  // X2 is kept for X5, so it is live together with X3 and X4
+  EXPECT_EQ(stats.peak_bytes, (5000u + 6000u + 7000u) * sizeof(float));
+}
+
+// MemoryEfficientOrderTest: Check that a branch is finished before another one is started if that frees its large
+// temporary first.
+TEST_F(PlannerTest, MemoryEfficientOrderTest) {
+  // tensor variables:
+  std::string X("X"), A1("A1"), A2("A2"), B1("B1"), B2("B2"), Y("Y");
+
+  auto add_kernel = KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(7, 10).Build();
+
+  // graph structure: two branches that each expand X into a large temporary and reduce it again
+  auto* a1 = AddNormalNode(X, A1);
+  auto* b1 = AddNormalNode(X, B1);
+  auto* a2 = AddNormalNode(A1, A2);
+  auto* b2 = AddNormalNode(B1, B2);
+  auto* y = AddBinaryNode(*add_kernel, A2, B2, Y);
+
+  // simulate shape-inference results:
+  Shape small_shape{10};
+  Shape large_shape{1000, 10};
+  SetShape({{X, &small_shape.value}, {A1, &large_shape.value}, {A2, &small_shape.value},
+            {B1, &large_shape.value}, {B2, &small_shape.value}, {Y, &small_shape.value}});
+
+  CreatePlan({}, /*memory_efficient_order*/ true);
+
+  std::vector<NodeIndex> order;
+  for (const auto& step : GetPlan().execution_plan) {
+    order.push_back(step.node_index);
+  }
+  ASSERT_EQ(order.size(), 5u);
+  // the first branch is reduced before the second is expanded, so A1 and B1 are never live together
+  EXPECT_EQ(order, (std::vector<NodeIndex>{a1->Index(), a2->Index(), b1->Index(), b2->Index(), y->Index()}));
+  EXPECT_LT(GetPlan().planner_stats.peak_bytes, 2 * 10000u * sizeof(float));
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
@@ -3,6 +3,7 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
 #include "test_utils.h"
 #include "gtest/gtest.h"
 
@@ -26,6 +27,24 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   //todo: test the used / max api.
 }
 
+// large allocations come from pages of the system, small ones from the heap, and both are usable and freed
+TEST(AllocatorTest, CPUAllocatorHugePagesAndNumaNodeTest) {
+  CPUAllocatorConfig config;
+  config.use_huge_pages = true;
+  config.numa_node = 0;
+  CPUAllocator allocator(config);
+
+  for (size_t size : {size_t{64}, size_t{1024 * 1024}, size_t{3 * 1024 * 1024 + 5}}) {
+    auto* bytes = static_cast<unsigned char*>(allocator.Alloc(size));
+    ASSERT_NE(bytes, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(bytes) % MlasGetPreferredBufferAlignment(), 0u);
+    memset(bytes, 0x5a, size);
+    EXPECT_EQ(bytes[0], 0x5a);
+    EXPECT_EQ(bytes[size - 1], 0x5a);
+    allocator.Free(bytes);
+  }
+}
+
 // helper class to validate values in Alloc and Free calls made via IAllocator::MakeUniquePtr
 class TestAllocator : public IAllocator {
  public:
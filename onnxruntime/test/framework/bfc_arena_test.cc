@@ -3,7 +3,9 @@
 
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
+#include <chrono>
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +236,167 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, FreedSmallChunkIsReused) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  void* t1 = a.Alloc(1000);
+  a.Free(t1);
+  CheckStats(&a, 1, 0, 1024, 1024);
+
+  // Served from the thread cache, but bookkeeping stays exact.
+  void* t2 = a.Alloc(900);
+  EXPECT_EQ(t1, t2);
+  EXPECT_EQ(900, a.RequestedSize(t2));
+  EXPECT_EQ(1024, a.AllocatedSize(t2));
+  CheckStats(&a, 2, 1024, 1024, 1024);
+  a.Free(t2);
+  CheckStats(&a, 2, 0, 1024, 1024);
+}
+
+TEST(BFCArenaTest, FreeOnAnotherThread) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a.Alloc(2048));
+  }
+  std::thread t([&a, &ptrs]() {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  });
+  t.join();
+  CheckStats(&a, 100, 0, 100 * 2048, 2048);
+
+  // Everything went back to one of the caches or the bins, and can be handed
+  // out again without growing the arena.
+  AllocatorStats before;
+  a.GetStats(&before);
+  for (int i = 0; i < 100; ++i) {
+    ptrs[i] = a.Alloc(2048);
+    EXPECT_NE(nullptr, ptrs[i]);
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  AllocatorStats after;
+  a.GetStats(&after);
+  EXPECT_EQ(before.total_allocated_bytes, after.total_allocated_bytes);
+  EXPECT_EQ(0, after.bytes_in_use);
+}
+
+TEST(BFCArenaTest, ConcurrentAllocationsAndDeallocations) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  const int num_threads = 8;
+  const int num_iterations = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<void*> live;
+      for (int i = 0; i < num_iterations; ++i) {
+        size_t size = 64 + ((i * 7 + t * 13) % 64) * 256;
+        void* p = a.Alloc(size);
+        ASSERT_NE(nullptr, p);
+        // Tag the buffer with its owner so chunks handed out twice show up.
+        *static_cast<int*>(p) = t;
+        live.push_back(p);
+        if (live.size() > 16) {
+          ASSERT_EQ(t, *static_cast<int*>(live.front()));
+          a.Free(live.front());
+          live.erase(live.begin());
+        }
+      }
+      for (void* p : live) {
+        a.Free(p);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(num_threads * num_iterations, stats.num_allocs);
+  EXPECT_EQ(0, stats.bytes_in_use);
+}
+
+TEST(BFCArenaTest, ExtendSameAsRequested) {
+  ArenaConfig config;
+  config.arena_extend_strategy = ArenaExtendStrategy::kSameAsRequested;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, config);
+
+  void* t1 = a.Alloc(3 << 20);
+  void* t2 = a.Alloc(3 << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  // Two regions of exactly the requested size, rather than 4MB and 8MB.
+  EXPECT_EQ(6 << 20, stats.total_allocated_bytes);
+  a.Free(t1);
+  a.Free(t2);
+}
+
+TEST(BFCArenaTest, InitialChunkSize) {
+  ArenaConfig config;
+  config.initial_chunk_size_bytes = 64 << 10;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, config);
+
+  void* t1 = a.Alloc(1024);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(64 << 10, stats.total_allocated_bytes);
+  a.Free(t1);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* small = a.Alloc(1024);
+  void* large = a.Alloc(16 << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  const int64_t allocated = stats.total_allocated_bytes;
+  const int64_t small_region = 1 << 20;
+
+  a.Free(large);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  // The region holding 'small' stays.
+  EXPECT_EQ(small_region, stats.total_allocated_bytes);
+  EXPECT_LT(stats.total_allocated_bytes, allocated);
+  EXPECT_EQ(1024, a.RequestedSize(small));
+
+  a.Free(small);
+  ASSERT_TRUE(a.Shrink().IsOK());
+  a.GetStats(&stats);
+  EXPECT_EQ(0, stats.total_allocated_bytes);
+
+  // The arena grows again from the initial chunk size.
+  void* again = a.Alloc(1024);
+  EXPECT_NE(nullptr, again);
+  a.GetStats(&stats);
+  EXPECT_EQ(small_region, stats.total_allocated_bytes);
+  a.Free(again);
+}
+
+TEST(BFCArenaTest, IdleShrink) {
+  ArenaConfig config;
+  config.idle_shrink_timeout_ms = 10;
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, config);
+
+  void* keep = a.Alloc(1024);
+  void* large = a.Alloc(16 << 20);
+  a.Free(large);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // The check runs as the arena is used.
+  a.Free(a.Alloc(1 << 21));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  a.Free(a.Reserve(1024));
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(1 << 20, stats.total_allocated_bytes);
+  a.Free(keep);
+}
 }  // namespace test
 }  // namespace onnxruntime
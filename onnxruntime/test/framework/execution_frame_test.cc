@@ -159,6 +159,54 @@ TEST_F(ExecutionFrameTest, FeedInDataTest) {
   EXPECT_EQ(p_tensor_arg_0->MutableData<float>(), value.GetMutable<Tensor>()->MutableData<float>());
 }
 
+TEST_F(ExecutionFrameTest, ValuesArePooledBetweenRuns) {
+  onnxruntime::Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                           std::unordered_map<std::string, int>{{"", 10}});
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Clip", "Clip operator", ArgMap{&input_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  graph.Resolve();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  EXPECT_TRUE(kernel_registry_manager.RegisterKernels(execution_providers).IsOK());
+  SessionState state{execution_providers, true, &tp_};
+  auto status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map = state.GetOrtValueNameIdxMap();
+  int x_idx, y_idx;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("Y", y_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_typ)->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue value;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{3, 2}, std::vector<float>(6, 1.0f), &value);
+
+  const OrtValue* first_run_value = nullptr;
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({x_idx}, {value}, {y_idx}, outputs, {}, state);
+    first_run_value = frame.GetMutableNodeInputOrOutputMLValue(0);
+    ASSERT_TRUE(first_run_value != nullptr && first_run_value->IsAllocated());
+  }
+
+  // the next run takes the same table back from the session, without the values of the previous run
+  vector<OrtValue> outputs;
+  ExecutionFrame frame({}, {}, {y_idx}, outputs, {}, state);
+  const OrtValue* p_ml_value = frame.GetMutableNodeInputOrOutputMLValue(0);
+  EXPECT_EQ(p_ml_value, first_run_value);
+  EXPECT_FALSE(p_ml_value->IsAllocated());
+}
+
 TEST_F(ExecutionFrameTest, MemPatternTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
   auto xp_type = cpu_xp->Type();
@@ -265,6 +313,90 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   EXPECT_EQ(p->GetBlock(4)->offset_, 64);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternWithScratchBufferTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      gemm_out_def("T1", &tensor_float),
+      clip_out_def("T2", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm_out_def})
+      .SetExecutionProviderType(xp_type);
+  auto& clip_node = graph.AddNode("node2", "Clip", "clip1", ArgMap{&gemm_out_def}, ArgMap{&clip_out_def});
+  clip_node.SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+  kernel_registry_manager.RegisterKernels(execution_providers);
+  SessionState state{execution_providers, true, &tp_};
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map{state.GetOrtValueNameIdxMap()};
+  int x1_idx, x2_idx, t1_idx, t2_idx;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue v1, v2;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{1, 2}, std::vector<float>{1.0f, 1.0f}, &v1);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan = std::make_unique<SequentialExecutionPlan>();
+  SequentialPlannerContext context(false);
+  status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         mlvalue_name_idx_map, context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  vector<OrtValue> outputs;
+  ExecutionFrame frame({x1_idx, x2_idx}, {v1, v2}, {t2_idx}, outputs, {}, state);
+
+  // T1 is live while the Clip node uses a scratch buffer, which is freed before the next allocation
+  OrtValue t1_value;
+  status = frame.AllocateMLValueTensorSelfOwnBuffer(t1_value, t1_idx, DataTypeImpl::GetType<float>(),
+                                                    cpu_allocator->Info(), TensorShape(std::vector<int64_t>{1, 2}));
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  void* scratch = frame.AllocateScratchBuffer(clip_node.Index(), cpu_allocator, 128);
+  ASSERT_NE(scratch, nullptr);
+  frame.ReleaseScratchBuffer(clip_node.Index(), cpu_allocator, scratch);
+
+  MemoryPatternGroup pattern;
+  status = frame.GeneratePatterns(&pattern);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto p = pattern.GetPatterns(cpu_allocator->Info());
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(p->PeakSize(), 64 + 128);
+  EXPECT_EQ(p->GetBlock(t1_idx)->offset_, 0);
+
+  // the scratch buffer is the only block not keyed by an OrtValue index
+  size_t scratch_blocks = 0;
+  for (int idx = -1; idx >= -16; --idx) {
+    const auto* block = p->GetBlock(idx);
+    if (block != nullptr) {
+      EXPECT_EQ(block->offset_, 64);
+      EXPECT_EQ(block->size_, 128);
+      ++scratch_blocks;
+    }
+  }
+  EXPECT_EQ(scratch_blocks, 1);
+}
+
 TEST(ExecutionFrameTestWithoutSessionState, BadModelInvalidDimParamUsage) {
   // load model with 2 Scan ops that both incorrectly use shapes of { 'None', 'None' } for their outputs.
   // as 'None' is not a special value it's treated as a variable name, leading to a runtime error when we
@@ -4,9 +4,11 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <thread>
 #include <fstream>
 
@@ -24,12 +26,14 @@
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "core/platform/env.h"
+#include "core/platform/perf_counters.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -130,6 +134,24 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
   }
 };
 
+// InferenceSession wrapper to expose the shape cache state of the first node.
+class InferenceSessionShapeCacheWrapper : public InferenceSession {
+ public:
+  explicit InferenceSessionShapeCacheWrapper(const SessionOptions& session_options,
+                                             logging::LoggingManager* logging_manager)
+      : InferenceSession(session_options, logging_manager) {
+  }
+
+  // Returns the state cached for the node whatever its input shapes, and the signature it was cached with
+  std::shared_ptr<const void> GetCachedState(std::vector<int64_t>& signature) const {
+    NodeIndex node_index = model_->MainGraph().Nodes().begin()->Index();
+    return session_state_.GetNodeShapeCache()->Lookup(node_index, [&signature](const std::vector<int64_t>& s) {
+      signature = s;
+      return true;
+    });
+  }
+};
+
 namespace test {
 static void VerifyOutputs(const std::vector<OrtValue>& fetches, const std::vector<int64_t>& expected_dims,
                           const std::vector<float>& expected_values);
@@ -342,6 +364,25 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, ParallelExecutionWithCriticalPathScheduling) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ParallelExecutionWithCriticalPathScheduling";
+  so.enable_sequential_execution = false;
+  so.enable_critical_path_scheduling = true;
+  so.inter_op_thread_pool_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // later runs use the priorities computed from the costs observed in earlier runs
+  RunOptions run_options;
+  run_options.run_tag = "one session/one tag";
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+}
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -403,14 +444,48 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Load(test_model).IsOK());
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 
-  // Assert that level 3 optimization doesn't result in serialized model.
-  so_opt.optimized_model_filepath = ToWideString("ShouldNotSerialize");
+  // Assert that the serialized model records the applied optimization level.
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(so.optimized_model_filepath, p_model).IsOK());
+  auto metadata = p_model->MetaData();
+  ASSERT_EQ(metadata["onnxruntime.graph_optimization_level"], "1");
+
+  // Assert that level 3 optimization results in a serialized model that can be loaded again.
+  so_opt.optimized_model_filepath = ToWideString(test_model + "-TransformLevel-3");
   so_opt.graph_optimization_level = TransformerLevel::Level3;
   InferenceSession session_object_Level3Test{so_opt, &DefaultLoggingManager()};
   ASSERT_TRUE(session_object_Level3Test.Load(test_model).IsOK());
   ASSERT_TRUE(session_object_Level3Test.Initialize().IsOK());
-  std::ifstream model_fs_Level3(so_opt.optimized_model_filepath, ios::in | ios::binary);
-  ASSERT_TRUE(model_fs_Level3.fail());
+  ASSERT_TRUE(Model::Load(so_opt.optimized_model_filepath, p_model).IsOK());
+  metadata = p_model->MetaData();
+  ASSERT_EQ(metadata["onnxruntime.graph_optimization_level"], "3");
+
+  SessionOptions so_reload;
+  so_reload.session_logid = "InferenceSessionTests.TestModelSerialization";
+  so_reload.graph_optimization_level = TransformerLevel::Level3;
+  InferenceSession session_object_Level3Reload{so_reload, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object_Level3Reload.Load(so_opt.optimized_model_filepath).IsOK());
+  ASSERT_TRUE(session_object_Level3Reload.Initialize().IsOK());
+}
+
+TEST(InferenceSessionTests, TestOptimizedModelNchwcBlockSizeMismatch) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(test_model, p_model).IsOK());
+
+  // An optimized model serialized on a platform with a different NCHWc block size can't be loaded.
+  p_model->SetMetaData("onnxruntime.graph_optimization_level", "3");
+  p_model->SetMetaData("onnxruntime.nchwc_block_size", "3");
+  const string model_path = "abs-id-max-nchwc-mismatch.onnx";
+  ASSERT_TRUE(Model::Save(*p_model, model_path).IsOK());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestOptimizedModelNchwcBlockSizeMismatch";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_path).IsOK());
+  auto status = session_object.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("NCHWc block size"));
 }
 
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
@@ -743,11 +818,13 @@ static void TestBindHelper(const std::string& log_str,
                            ProviderType bind_provider_type,
                            ProviderType run_provider_type,
                            bool preallocate_output,
-                           ProviderType allocation_provider = kCpuExecutionProvider) {
+                           ProviderType allocation_provider = kCpuExecutionProvider,
+                           bool enable_sequential_execution = true) {
   SessionOptions so;
 
   so.session_logid = "InferenceSessionTests." + log_str;
   so.session_log_verbosity_level = 1;  // change to 1 for detailed logging
+  so.enable_sequential_execution = enable_sequential_execution;
 
   InferenceSession session_object{so, &DefaultLoggingManager()};
 
@@ -823,6 +900,699 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestPreparedRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestPreparedRun";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::unique_ptr<PreparedRun> prepared_run;
+  ASSERT_FALSE(session_object.PrepareRun({"X"}, {"Z"}, &prepared_run).IsOK());
+  ASSERT_FALSE(session_object.PrepareRun({"W"}, {"Y"}, &prepared_run).IsOK());
+  ASSERT_TRUE(session_object.PrepareRun({"X"}, {"Y"}, &prepared_run).IsOK());
+  ASSERT_EQ(prepared_run->GetMutableFeeds().size(), 1u);
+  ASSERT_EQ(prepared_run->GetMutableFetches().size(), 1u);
+
+  RunOptions run_options;
+  std::vector<int64_t> dims_mul_x = {3, 2};
+
+  // run repeatedly with different inputs
+  for (float scale : {1.0f, 2.0f}) {
+    std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<float> expected_values_mul_y(values_mul_x.size());
+    for (size_t i = 0; i < values_mul_x.size(); ++i) {
+      values_mul_x[i] *= scale;
+      expected_values_mul_y[i] = values_mul_x[i] * values_mul_x[i];
+    }
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &prepared_run->GetMutableFeeds()[0]);
+    prepared_run->GetMutableFetches()[0] = OrtValue();
+
+    ASSERT_TRUE(session_object.Run(run_options, *prepared_run).IsOK());
+    VerifyOutputs(prepared_run->GetMutableFetches(), dims_mul_x, expected_values_mul_y);
+  }
+
+  // the inputs are still validated by each run
+  std::vector<int64_t> values_int = {1, 2, 3, 4, 5, 6};
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_int,
+                         &prepared_run->GetMutableFeeds()[0]);
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run).IsOK());
+}
+
+TEST(InferenceSessionTests, TestRunAsync) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestRunAsync";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  // enqueue several runs and wait for all of their callbacks
+  constexpr int num_runs = 4;
+  std::vector<Status> statuses(num_runs);
+  std::vector<std::vector<OrtValue>> outputs(num_runs);
+  int num_completed = 0;
+  OrtMutex mutex;
+  OrtCondVar cv;
+  for (int i = 0; i < num_runs; ++i) {
+    ASSERT_TRUE(session_object.RunAsync(run_options, {"X"}, {ml_value}, {"Y"}, {},
+                                        [&, i](const Status& status, std::vector<OrtValue>& fetches) {
+                                          std::lock_guard<OrtMutex> lock(mutex);
+                                          statuses[i] = status;
+                                          outputs[i] = fetches;
+                                          ++num_completed;
+                                          cv.notify_all();
+                                        })
+                    .IsOK());
+  }
+  {
+    std::unique_lock<OrtMutex> lock(mutex);
+    cv.wait(lock, [&]() { return num_completed == num_runs; });
+  }
+
+  for (int i = 0; i < num_runs; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    VerifyOutputs(outputs[i], dims_mul_x, expected_values_mul_y);
+  }
+
+  // invalid names are reported by RunAsync rather than by the callback
+  ASSERT_FALSE(session_object.RunAsync(run_options, {"X"}, {ml_value}, {"Z"}, {},
+                                       [](const Status&, std::vector<OrtValue>&) { FAIL(); })
+                   .IsOK());
+}
+
+TEST(InferenceSessionTests, TestWarmup) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestWarmup";
+  so.warmup_input_shapes = {{{"X", {3, 2}}}};
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // an input that isn't listed gets the shape of the model input
+  ASSERT_TRUE(session_object.Warmup({NameShapeMap{}}).IsOK());
+  ASSERT_FALSE(session_object.Warmup({{{"W", {3, 2}}}}).IsOK());
+  ASSERT_FALSE(session_object.Warmup({{{"X", {4, 2}}}}).IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, TestShapeCache) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestShapeCache";
+  so.enable_shape_cache = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the second and third runs reuse the MatMul helper computed in the first one
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModelWithBindingMatMul(session_object, run_options, kCpuExecutionProvider);
+  }
+}
+
+static void RunMatMulWithShapes(InferenceSession& session_object, int64_t rows_a,
+                                const std::vector<float>& expected_values) {
+  std::vector<float> values_a(static_cast<size_t>(rows_a * 4));
+  std::iota(values_a.begin(), values_a.end(), 0.0f);
+  std::vector<float> values_b(12);
+  std::iota(values_b.begin(), values_b.end(), 0.0f);
+
+  OrtValue input_a;
+  OrtValue input_b;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {rows_a, 4}, values_a,
+                       &input_a);
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {4, 3}, values_b, &input_b);
+  NameMLValMap feeds{{"A", input_a}, {"B", input_b}};
+
+  std::vector<OrtValue> fetches;
+  Status st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {rows_a, 3}, expected_values);
+}
+
+TEST(InferenceSessionTests, TestShapeCacheInputShapeChanges) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestShapeCacheInputShapeChanges";
+  so.enable_shape_cache = true;
+
+  InferenceSessionShapeCacheWrapper session_object{so, &DefaultLoggingManager()};
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCpuExecutionProvider);
+
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  const std::vector<float> expected_3x3 = {42.0f, 48.0f, 54.0f, 114.0f, 136.0f, 158.0f, 186.0f, 224.0f, 262.0f};
+  const std::vector<float> expected_2x3 = {42.0f, 48.0f, 54.0f, 114.0f, 136.0f, 158.0f};
+  std::vector<int64_t> signature;
+
+  // the first run caches the helper, which the second run reuses rather than replaces
+  RunMatMulWithShapes(session_object, 3, expected_3x3);
+  auto state = session_object.GetCachedState(signature);
+  ASSERT_NE(state, nullptr);
+  ASSERT_EQ(signature, (std::vector<int64_t>{2, 3, 4, 2, 4, 3}));
+  RunMatMulWithShapes(session_object, 3, expected_3x3);
+  ASSERT_EQ(session_object.GetCachedState(signature), state);
+
+  // other input shapes don't use the cached helper, and replace it with their own
+  RunMatMulWithShapes(session_object, 2, expected_2x3);
+  auto other_state = session_object.GetCachedState(signature);
+  ASSERT_NE(other_state, state);
+  ASSERT_EQ(signature, (std::vector<int64_t>{2, 2, 4, 2, 4, 3}));
+
+  // and going back to the first shapes doesn't reuse the helper of the second ones
+  RunMatMulWithShapes(session_object, 3, expected_3x3);
+  ASSERT_NE(session_object.GetCachedState(signature), other_state);
+  ASSERT_EQ(signature, (std::vector<int64_t>{2, 3, 4, 2, 4, 3}));
+}
+
+TEST(InferenceSessionTests, TestLowLatencyRuns) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestLowLatencyRuns";
+  so.session_thread_pool_size = 2;
+  so.session_thread_pool_options.spin_duration_us = 100;
+  so.enable_low_latency_runs = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  Status st;
+  ASSERT_TRUE((st = session_object.Load(MODEL_URI)).IsOK()) << st.ErrorMessage();
+  ASSERT_TRUE((st = session_object.Initialize()).IsOK()) << st.ErrorMessage();
+
+  // the pool threads spin during each run and block again between runs
+  RunOptions run_options;
+  for (int i = 0; i < 3; ++i) {
+    RunModel(session_object, run_options);
+  }
+}
+
+TEST(InferenceSessionTests, TestNodeCounters) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestNodeCounters";
+  so.enable_node_counters = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_EQ(session_object.GetNodeCounters(), nullptr);
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  NodeCounters* node_counters = session_object.GetNodeCounters();
+  ASSERT_NE(node_counters, nullptr);
+  ASSERT_EQ(node_counters->Nodes().size(), 1u);
+  ASSERT_EQ(node_counters->NodeNames().size(), 1u);
+  const NodeIndex node_index = node_counters->Nodes()[0];
+  EXPECT_EQ(node_counters->Get(node_index).count, 0);
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  // the node multiplies two 3x2 float tensors
+  auto values = node_counters->Get(node_index);
+  EXPECT_EQ(values.count, 2);
+  EXPECT_GE(values.total_ns, values.max_ns);
+  EXPECT_EQ(values.bytes_allocated, 2 * 6 * static_cast<int64_t>(sizeof(float)));
+
+  node_counters->Reset();
+  values = node_counters->Get(node_index);
+  EXPECT_EQ(values.count, 0);
+  EXPECT_EQ(values.total_ns, 0);
+  EXPECT_EQ(values.max_ns, 0);
+  EXPECT_EQ(values.bytes_allocated, 0);
+}
+
+TEST(InferenceSessionTests, TestStridedViewsAliasedByReshape) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 9;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  // Y = Abs(Reshape(Slice(X)[:, 0:2], S)) and Z = Abs(Reshape(Expand(X2, E), S)), where the Slice and Expand
+  // outputs are strided views, of a feed and of an intermediate smaller than the view
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto tensor_int64;
+  tensor_int64.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  auto& input_x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& input_x2 = graph.GetOrCreateNodeArg("X2", &tensor_float);
+  auto& input_s = graph.GetOrCreateNodeArg("S", &tensor_int64);
+  auto& input_e = graph.GetOrCreateNodeArg("E", &tensor_int64);
+  auto& sliced = graph.GetOrCreateNodeArg("sliced", &tensor_float);
+  auto& sliced_reshaped = graph.GetOrCreateNodeArg("sliced_reshaped", &tensor_float);
+  auto& neg_x2 = graph.GetOrCreateNodeArg("neg_X2", &tensor_float);
+  auto& expanded = graph.GetOrCreateNodeArg("expanded", &tensor_float);
+  auto& expanded_reshaped = graph.GetOrCreateNodeArg("expanded_reshaped", &tensor_float);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  auto& output_z = graph.GetOrCreateNodeArg("Z", &tensor_float);
+  auto& slice = graph.AddNode("slice", "Slice", "Slice", {&input_x}, {&sliced});
+  slice.AddAttribute("axes", std::vector<int64_t>{1});
+  slice.AddAttribute("starts", std::vector<int64_t>{0});
+  slice.AddAttribute("ends", std::vector<int64_t>{2});
+  graph.AddNode("reshape_sliced", "Reshape", "Reshape", {&sliced, &input_s}, {&sliced_reshaped});
+  graph.AddNode("abs_sliced", "Abs", "Abs", {&sliced_reshaped}, {&output_y});
+  graph.AddNode("neg", "Neg", "Neg", {&input_x2}, {&neg_x2});
+  graph.AddNode("expand", "Expand", "Expand", {&neg_x2, &input_e}, {&expanded});
+  graph.AddNode("reshape_expanded", "Reshape", "Reshape", {&expanded, &input_s}, {&expanded_reshaped});
+  graph.AddNode("abs_expanded", "Abs", "Abs", {&expanded_reshaped}, {&output_z});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestStridedViewsAliasedByReshape";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(model_str);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  const std::vector<float> values_x = {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};
+  std::vector<OrtValue> feeds(4);
+  CreateMLValue<float>(allocator, {2, 3}, values_x, &feeds[0]);
+  CreateMLValue<float>(allocator, {1, 2}, {1.0f, -2.0f}, &feeds[1]);
+  CreateMLValue<int64_t>(allocator, {1}, {-1}, &feeds[2]);
+  CreateMLValue<int64_t>(allocator, {2}, {3, 2}, &feeds[3]);
+
+  std::vector<OrtValue> fetches;
+  RunOptions run_options;
+  st = session_object.Run(run_options, {"X", "X2", "S", "E"}, feeds, {"Y", "Z"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  ASSERT_EQ(fetches.size(), 2u);
+  VerifyOutputs({fetches[0]}, {4}, {1.0f, 2.0f, 4.0f, 5.0f});
+  VerifyOutputs({fetches[1]}, {6}, {1.0f, 2.0f, 1.0f, 2.0f, 1.0f, 2.0f});
+
+  // the Reshape of the slice didn't write into the feed it's a view of
+  const auto& x = feeds[0].Get<Tensor>();
+  EXPECT_EQ(std::vector<float>(x.Data<float>(), x.Data<float>() + x.Shape().Size()), values_x);
+}
+
+TEST(InferenceSessionTests, TestIncrementalExecution) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  // Y = Abs(A) + B, where only Abs is memoized
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& input_b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& abs_a = graph.GetOrCreateNodeArg("abs_A", &tensor_float);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("abs", "Abs", "Abs", {&input_a}, {&abs_a});
+  graph.AddNode("add", "Add", "Add", {&abs_a, &input_b}, {&output_y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIncrementalExecution";
+  so.enable_node_counters = true;
+
+  // only graph inputs can be watched
+  so.incremental_execution_inputs = {"abs_A"};
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream sstr(model_str);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    ASSERT_FALSE(session_object.Initialize().IsOK());
+  }
+
+  so.incremental_execution_inputs = {"A"};
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(model_str);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  NodeCounters* node_counters = session_object.GetNodeCounters();
+  ASSERT_NE(node_counters, nullptr);
+  const auto& names = node_counters->NodeNames();
+  const NodeIndex abs_index = node_counters->Nodes()[std::find(names.cbegin(), names.cend(), "abs") - names.cbegin()];
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto run = [&](const std::vector<float>& a, const std::vector<float>& b, const std::vector<float>& expected_y) {
+    std::vector<OrtValue> feeds(2);
+    CreateMLValue<float>(allocator, {2}, a, &feeds[0]);
+    CreateMLValue<float>(allocator, {2}, b, &feeds[1]);
+    std::vector<OrtValue> fetches;
+    RunOptions run_options;
+    Status status = session_object.Run(run_options, {"A", "B"}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {2}, expected_y);
+  };
+
+  run({1.0f, -2.0f}, {1.0f, 1.0f}, {2.0f, 3.0f});
+  EXPECT_EQ(node_counters->Get(abs_index).count, 1);
+
+  // A is unchanged, so Abs is skipped
+  run({1.0f, -2.0f}, {2.0f, 2.0f}, {3.0f, 4.0f});
+  run({1.0f, -2.0f}, {3.0f, 3.0f}, {4.0f, 5.0f});
+  EXPECT_EQ(node_counters->Get(abs_index).count, 1);
+
+  run({-3.0f, 4.0f}, {3.0f, 3.0f}, {6.0f, 7.0f});
+  EXPECT_EQ(node_counters->Get(abs_index).count, 2);
+}
+
+TEST(InferenceSessionTests, TestIncrementalExecutionStridedFrontier) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  // Y = Slice(Abs(A))[:, 0:2] + B, where Abs and Slice are memoized, and the slice is a strided view of Abs(A)
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& input_b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& abs_a = graph.GetOrCreateNodeArg("abs_A", &tensor_float);
+  auto& sliced = graph.GetOrCreateNodeArg("sliced", &tensor_float);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("abs", "Abs", "Abs", {&input_a}, {&abs_a});
+  auto& slice = graph.AddNode("slice", "Slice", "Slice", {&abs_a}, {&sliced});
+  slice.AddAttribute("axes", std::vector<int64_t>{1});
+  slice.AddAttribute("starts", std::vector<int64_t>{0});
+  slice.AddAttribute("ends", std::vector<int64_t>{2});
+  graph.AddNode("add", "Add", "Add", {&sliced, &input_b}, {&output_y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIncrementalExecutionStridedFrontier";
+  so.enable_node_counters = true;
+  so.incremental_execution_inputs = {"A"};
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(model_str);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  NodeCounters* node_counters = session_object.GetNodeCounters();
+  ASSERT_NE(node_counters, nullptr);
+  const auto& names = node_counters->NodeNames();
+  const NodeIndex slice_index =
+      node_counters->Nodes()[std::find(names.cbegin(), names.cend(), "slice") - names.cbegin()];
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto run = [&](const std::vector<float>& b, const std::vector<float>& expected_y) {
+    std::vector<OrtValue> feeds(2);
+    CreateMLValue<float>(allocator, {2, 3}, {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f}, &feeds[0]);
+    CreateMLValue<float>(allocator, {2, 2}, b, &feeds[1]);
+    std::vector<OrtValue> fetches;
+    RunOptions run_options;
+    Status status = session_object.Run(run_options, {"A", "B"}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {2, 2}, expected_y);
+  };
+
+  run({1.0f, 1.0f, 1.0f, 1.0f}, {2.0f, 3.0f, 5.0f, 6.0f});
+
+  // the runs that skip Slice get the elements of the view, not the start of the buffer it shares
+  run({2.0f, 2.0f, 2.0f, 2.0f}, {3.0f, 4.0f, 6.0f, 7.0f});
+  run({3.0f, 3.0f, 3.0f, 3.0f}, {4.0f, 5.0f, 7.0f, 8.0f});
+  EXPECT_EQ(node_counters->Get(slice_index).count, 1);
+}
+
+TEST(InferenceSessionTests, TestRunTraces) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestRunTraces";
+  so.trace_sample_rate = 2;
+  so.trace_buffer_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  EXPECT_EQ(session_object.DumpRunTraces(), "[]\n");
+
+  // runs 0, 2 and 4 are sampled, and only the last two fit in the buffer
+  RunOptions run_options;
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+  std::string traces = session_object.DumpRunTraces();
+  EXPECT_EQ(traces.find(R"("run_id" : "0")"), std::string::npos);
+  EXPECT_EQ(traces.find(R"("run_id" : "1")"), std::string::npos);
+  EXPECT_NE(traces.find(R"("run_id" : "2")"), std::string::npos);
+  EXPECT_NE(traces.find(R"("run_id" : "4")"), std::string::npos);
+  EXPECT_NE(traces.find(R"("op_name" : "Mul", "provider" : "CPUExecutionProvider")"), std::string::npos);
+
+  // run 5 isn't sampled, but asks to be traced
+  run_options.trace_run = true;
+  RunModel(session_object, run_options);
+  traces = session_object.DumpRunTraces(/*clear*/ true);
+  EXPECT_EQ(traces.find(R"("run_id" : "2")"), std::string::npos);
+  EXPECT_NE(traces.find(R"("run_id" : "5")"), std::string::npos);
+  EXPECT_EQ(session_object.DumpRunTraces(), "[]\n");
+}
+
+// Records the spans of the runs it gets as "begin|end <kind> <name> <provider> <run tag> <run id> <node count>".
+class RecordingRunTraceHook : public RunTraceHook {
+ public:
+  void BeginSpan(const OrtRunTraceSpan& span) override { Record("begin", span); }
+  void EndSpan(const OrtRunTraceSpan& span) override {
+    EXPECT_GE(span.end_time_ns, span.start_time_ns);
+    EXPECT_EQ(span.status, ORT_OK);
+    Record("end", span);
+  }
+
+  std::vector<std::string> spans;
+
+ private:
+  void Record(const char* event, const OrtRunTraceSpan& span) {
+    std::ostringstream out;
+    out << event << " " << span.kind << " " << span.name << " " << span.provider << " " << span.run_tag << " "
+        << span.run_id << " " << span.node_count;
+    std::lock_guard<OrtMutex> lock(mutex_);
+    spans.push_back(out.str());
+  }
+
+  OrtMutex mutex_;
+};
+
+TEST(InferenceSessionTests, TestRunTraceHook) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestRunTraceHook";
+  auto hook = std::make_shared<RecordingRunTraceHook>();
+  so.run_trace_hook = hook;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "tag";
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  // every run is traced with its partitions, but as none is sampled, no node is recorded
+  const std::vector<std::string> expected{
+      "begin 0 tag  tag 0 0",
+      "begin 2 CPUExecutionProvider CPUExecutionProvider tag 0 0",
+      "end 2 CPUExecutionProvider CPUExecutionProvider tag 0 1",
+      "end 0 tag  tag 0 0",
+      "begin 0 tag  tag 1 0",
+      "begin 2 CPUExecutionProvider CPUExecutionProvider tag 1 0",
+      "end 2 CPUExecutionProvider CPUExecutionProvider tag 1 1",
+      "end 0 tag  tag 1 0"};
+  EXPECT_EQ(hook->spans, expected);
+  EXPECT_EQ(session_object.DumpRunTraces(), "[]\n");
+}
+
+TEST(InferenceSessionTests, TestMemoryProfiling) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestMemoryProfiling";
+  so.enable_memory_profiling = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_EQ(session_object.GetMemoryProfiler(), nullptr);
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  MemoryProfiler* memory_profiler = session_object.GetMemoryProfiler();
+  ASSERT_NE(memory_profiler, nullptr);
+  EXPECT_EQ(memory_profiler->GetPeakSummary().peak_bytes, 0);
+
+  session_object.StartProfiling("onnxruntime_memory_profile");
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the only tensor the run allocates is the output of the node, a 3x2 float tensor in a 64 byte aligned buffer
+  auto summary = memory_profiler->GetPeakSummary();
+  EXPECT_EQ(summary.peak_bytes, 64);
+  ASSERT_EQ(summary.tensors.size(), 1u);
+  EXPECT_EQ(summary.tensors[0].tensor_name, "Y");
+  EXPECT_FALSE(summary.tensors[0].node_name.empty());
+  EXPECT_EQ(summary.tensors[0].bytes, 64);
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string contents{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  EXPECT_NE(contents.find(R"("cat" : "Memory")"), std::string::npos);
+  EXPECT_NE(contents.find("peak_tensor"), std::string::npos);
+
+  memory_profiler->Reset();
+  EXPECT_EQ(memory_profiler->GetPeakSummary().peak_bytes, 0);
+}
+
+TEST(InferenceSessionTests, TestProfilingHardwareCounters) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestProfilingHardwareCounters";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_hardware_counters_profile");
+  so.enable_profiling_hardware_counters = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string contents{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  EXPECT_NE(contents.find("_kernel_time"), std::string::npos);
+
+  // the counters are only added where perf_event_open is permitted, the profile is written either way
+  PerfCounterValues counters;
+  if (ReadThreadPerfCounters(counters)) {
+    EXPECT_NE(contents.find("\"cycles\""), std::string::npos);
+    // the 3x2 * 3x2 Mul does one multiplication per output element
+    EXPECT_NE(contents.find(R"("flops" : "6")"), std::string::npos);
+  }
+}
+
+TEST(InferenceSessionTests, TestProfilingRecordsInputShapes) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestProfilingRecordsInputShapes";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxruntime_input_shapes_profile");
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string contents{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  // X and the initializer W of the Mul are both 3x2
+  EXPECT_NE(contents.find(R"("input_types" : "tensor(float);tensor(float)")"), std::string::npos);
+  EXPECT_NE(contents.find(R"("input_shapes" : "[3,2];[3,2]")"), std::string::npos);
+}
+
+TEST(InferenceSessionTests, TestInitializationTimesAndArenaStats) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestInitializationTimesAndArenaStats";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  EXPECT_EQ(session_object.GetInitializationTimes().load_us, 0);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the phases are disjoint parts of Initialize
+  const auto& times = session_object.GetInitializationTimes();
+  EXPECT_GE(times.load_us, 0);
+  EXPECT_LE(times.graph_transformation_us + times.graph_partitioning_us + times.initializer_loading_us +
+                times.kernel_creation_us,
+            times.initialize_us);
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  size_t bytes_reserved = 0;
+  size_t bytes_in_use = 0;
+  ASSERT_TRUE(session_object.GetMemoryArenaStats(CPU, bytes_reserved, bytes_in_use).IsOK());
+  EXPECT_GT(bytes_reserved, 0u);
+  EXPECT_GE(bytes_reserved, bytes_in_use);
+
+  // only the CPU execution provider is registered
+  ASSERT_TRUE(session_object.GetMemoryArenaStats(CUDA, bytes_reserved, bytes_in_use).IsOK());
+  EXPECT_EQ(bytes_reserved, 0u);
+  EXPECT_EQ(bytes_in_use, 0u);
+}
+
+TEST(InferenceSessionTests, TestRunMany) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestRunMany";
+  RunOptions run_options;
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  // dimension 0 of X is fixed, so the sets are run one by one
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    std::vector<int64_t> dims_mul_x = {3, 2};
+    std::vector<std::vector<OrtValue>> feeds(2, std::vector<OrtValue>(1));
+    CreateMLValue<float>(allocator, dims_mul_x, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &feeds[0][0]);
+    CreateMLValue<float>(allocator, dims_mul_x, {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f}, &feeds[1][0]);
+
+    std::vector<std::vector<OrtValue>> fetches;
+    auto status = session_object.RunMany(run_options, {"X"}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 2u);
+    VerifyOutputs(fetches[0], dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+    VerifyOutputs(fetches[1], dims_mul_x, {4.0f, 4.0f, 4.0f, 4.0f, 4.0f, 4.0f});
+
+    ASSERT_FALSE(session_object.RunMany(run_options, {"X"}, {{}}, {"Y"}, &fetches).IsOK());
+  }
+
+  // dimension 0 of X and Y is symbolic, so the sets are run as one batch
+  {
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load("testdata/matmul_2.onnx").IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    std::vector<std::vector<OrtValue>> feeds(2, std::vector<OrtValue>(1));
+    CreateMLValue<float>(allocator, {1, 2}, {1.0f, 2.0f}, &feeds[0][0]);
+    CreateMLValue<float>(allocator, {2, 2}, {3.0f, 4.0f, 5.0f, 6.0f}, &feeds[1][0]);
+
+    std::vector<std::vector<OrtValue>> fetches;
+    auto status = session_object.RunMany(run_options, {"X"}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 2u);
+    VerifyOutputs(fetches[0], {1, 1}, {5.0f});
+    VerifyOutputs(fetches[1], {2, 1}, {11.0f, 17.0f});
+
+    // the outputs of the sets are rows of the output of the batch
+    EXPECT_EQ(fetches[0][0].Get<Tensor>().Data<float>() + 1, fetches[1][0].Get<Tensor>().Data<float>());
+  }
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -894,6 +1664,38 @@ TEST(InferenceSessionTests, TestBindCudaPreallocateOutputOnCpu2) {
                  kCpuExecutionProvider);
 }
 
+TEST(InferenceSessionTests, TestBindCudaParallelExecution) {
+  TestBindHelper("TestBindCudaParallelExecution",
+                 kCudaExecutionProvider,
+                 kCudaExecutionProvider,
+                 false /* don't preallocate output */,
+                 kCpuExecutionProvider,
+                 false /* parallel execution */);
+}
+
+TEST(InferenceSessionTests, TestCudaKernelDeviceTiming) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaKernelDeviceTiming";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  session_object.StartProfiling("onnxruntime_cuda_device_timing_profile");
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string contents{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  // the Mul runs on the device, and its input and output are copied by the Memcpy nodes added for them
+  EXPECT_NE(contents.find("_device_time"), std::string::npos);
+  EXPECT_NE(contents.find("_copy_time"), std::string::npos);
+}
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -1105,6 +1907,93 @@ TEST(ExecutionProviderTest, FunctionTest) {
   VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
 }
 
+TEST(ExecutionProviderTest, ParallelPartitioningTest) {
+  // counts the calls of GetCapability
+  class CountingFuseExecutionProvider : public FuseExecutionProvider {
+   public:
+    explicit CountingFuseExecutionProvider(std::atomic<int>& calls) : calls_(calls) {}
+
+    std::vector<std::unique_ptr<ComputeCapability>>
+    GetCapability(const onnxruntime::GraphViewer& graph,
+                  const std::vector<const KernelRegistry*>& kernel_registries) const override {
+      ++calls_;
+      return FuseExecutionProvider::GetCapability(graph, kernel_registries);
+    }
+
+   private:
+    std::atomic<int>& calls_;
+  };
+
+  class CountingCPUExecutionProvider : public CPUExecutionProvider {
+   public:
+    explicit CountingCPUExecutionProvider(std::atomic<int>& calls)
+        : CPUExecutionProvider(CPUExecutionProviderInfo()), calls_(calls) {}
+
+    std::vector<std::unique_ptr<ComputeCapability>>
+    GetCapability(const onnxruntime::GraphViewer& graph,
+                  const std::vector<const KernelRegistry*>& kernel_registries) const override {
+      ++calls_;
+      return CPUExecutionProvider::GetCapability(graph, kernel_registries);
+    }
+
+   private:
+    std::atomic<int>& calls_;
+  };
+
+  // M = X + Y + Z, whose two Add nodes the first provider fuses
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input_x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& input_z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  auto& sum_xy = graph.GetOrCreateNodeArg("node_1_out_1", &float_tensor);
+  auto& output_m = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_x, &input_y}, {&sum_xy});
+  graph.AddNode("node_2", "Add", "node 2.", {&sum_xy, &input_z}, {&output_m});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string model_str;
+  model.ToProto().SerializeToString(&model_str);
+
+  SessionOptions so;
+  so.session_logid = "ExecutionProviderTest.ParallelPartitioningTest";
+  so.enable_parallel_initialization = true;
+  so.session_thread_pool_size = 2;
+  std::atomic<int> fuse_calls{0};
+  std::atomic<int> cpu_calls{0};
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CountingFuseExecutionProvider>(fuse_calls))
+                  .IsOK());
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CountingCPUExecutionProvider>(cpu_calls))
+                  .IsOK());
+  std::stringstream sstr(model_str);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  Status status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // each provider is asked once, and the early answer of CPU doesn't claim the nodes fused before it
+  EXPECT_EQ(fuse_calls.load(), 1);
+  EXPECT_EQ(cpu_calls.load(), 1);
+  const Graph& partitioned = session_object.GetGraph();
+  ASSERT_EQ(partitioned.NumberOfNodes(), 1);
+  EXPECT_EQ(partitioned.Nodes().begin()->GetExecutionProviderType(), kFuseExecutionProvider);
+
+  std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<OrtValue> feeds(3);
+  for (auto& feed : feeds) {
+    CreateMLValue<float>(allocator, {3, 2}, values, &feed);
+  }
+  std::vector<OrtValue> fetches;
+  status = session_object.Run(RunOptions(), {"X", "Y", "Z"}, feeds, {"M"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {3, 2}, {3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f});
+}
+
 TEST(ExecutionProviderTest, FunctionInlineTest) {
   onnxruntime::Model model("graph_1");
 
@@ -1355,6 +2244,54 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
   }
 }
 
+TEST(InferenceSessionTests, TestParallelInitialization) {
+  // the Scan subgraphs, their initializers and their kernels are set up concurrently
+  static const std::string LSTM_MODEL_URI = "testdata/scan_1.onnx";
+
+  std::vector<int64_t> X_dims = {5, 1, 3};
+  std::vector<float> X = {0.5488135f, 0.71518934f, 0.60276335f,
+                          0.5448832f, 0.4236548f, 0.6458941f,
+                          0.4375872f, 0.891773f, 0.96366274f,
+                          0.3834415f, 0.79172504f, 0.5288949f,
+                          0.56804454f, 0.92559665f, 0.07103606f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), X_dims, X, &ml_value);
+  NameMLValMap feeds = {{"Input13165", ml_value}};
+
+  auto run = [&feeds](bool enable_parallel_initialization, std::vector<OrtValue>& fetches) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.TestParallelInitialization";
+    so.enable_parallel_initialization = enable_parallel_initialization;
+    so.session_thread_pool_size = 4;
+    InferenceSession session_object(so, &DefaultLoggingManager());
+    ASSERT_TRUE(session_object.Load(LSTM_MODEL_URI).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::vector<std::string> output_names;
+    for (const auto* output : session_object.GetModelOutputs().second) {
+      output_names.push_back(output->Name());
+    }
+    status = session_object.Run(RunOptions(), feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  };
+
+  std::vector<OrtValue> expected_fetches;
+  std::vector<OrtValue> fetches;
+  run(false, expected_fetches);
+  run(true, fetches);
+
+  ASSERT_EQ(expected_fetches.size(), fetches.size());
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const auto& expected = expected_fetches[i].Get<Tensor>();
+    const auto& actual = fetches[i].Get<Tensor>();
+    ASSERT_EQ(expected.Shape(), actual.Shape());
+    for (int64_t j = 0; j < expected.Shape().Size(); ++j) {
+      EXPECT_EQ(expected.Data<float>()[j], actual.Data<float>()[j]);
+    }
+  }
+}
+
 // create the feeds and fetches using the dummy allocator so that we have to copy to CPU to execute, and from
 // CPU to return in utils::ExecuteGraph. Call InferenceSession::Run twice to test the caching of the copy logic.
 TEST(InferenceSessionTests, TestCopyToFromDevices) {
@@ -1479,6 +2416,170 @@ TEST(InferenceSessionTests, TestParallelExecutionWithCudaProvider) {
   ASSERT_TRUE(!status.IsOK());
 }
 
+TEST(InferenceSessionTests, TestCudaProviderWithExternalStream) {
+  // a non-blocking stream isn't ordered with the legacy default stream, so the run is only correct if all of its
+  // work goes to this stream
+  cudaStream_t stream;
+  ASSERT_EQ(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking), cudaSuccess);
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.TestCudaProviderWithExternalStream";
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+
+    CUDAExecutionProviderInfo epi;
+    epi.device_id = 0;
+    epi.stream = stream;
+    EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    RunOptions run_options;
+    run_options.run_tag = so.session_logid;
+    RunModel(session_object, run_options);
+    RunModel(session_object, run_options);
+  }
+  ASSERT_EQ(cudaStreamDestroy(stream), cudaSuccess);
+}
+
+TEST(InferenceSessionTests, TestCudaProviderSharesArenaAcrossThreads) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaProviderSharesArenaAcrossThreads";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  auto provider = std::make_unique<CUDAExecutionProvider>(epi);
+  auto* cuda_provider = provider.get();
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(provider)).IsOK());
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  std::vector<AllocatorPtr> allocators(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < allocators.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      for (int run = 0; run < 10; ++run) {
+        RunModel(session_object, run_options);
+      }
+      allocators[i] = cuda_provider->GetAllocator(0, OrtMemTypeDefault);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& allocator : allocators) {
+    EXPECT_EQ(allocators[0], allocator);
+  }
+}
+
+TEST(InferenceSessionTests, TestCudaProviderWithGraphCapture) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestCudaProviderWithGraphCapture";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.enable_cuda_graph = true;
+  auto provider = std::make_unique<CUDAExecutionProvider>(epi);
+  auto* cuda_provider = provider.get();
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(provider)).IsOK());
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the input and output stay at the same addresses, so the first run is captured and the second one is replayed
+  std::vector<int64_t> dims = {3, 2};
+  OrtValue input;
+  AllocateMLValue<float>(TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, &input);
+  OrtValue output;
+  AllocateMLValue<float>(TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, &output);
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_TRUE(session_object.NewIOBinding(&io_binding).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("X", input).IsOK());
+  ASSERT_TRUE(io_binding->BindOutput("Y", output).IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  const std::vector<std::vector<float>> values = {{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f},
+                                                  {-1.0f, 0.5f, 2.0f, 3.0f, -4.0f, 10.0f}};
+  for (const auto& x : values) {
+    ASSERT_EQ(cudaMemcpy(input.GetMutable<Tensor>()->MutableDataRaw(), x.data(), x.size() * sizeof(float),
+                         cudaMemcpyHostToDevice),
+              cudaSuccess);
+    ASSERT_TRUE(session_object.Run(run_options, *io_binding).IsOK());
+    ASSERT_TRUE(cuda_provider->Sync().IsOK());
+
+    std::vector<float> y(x.size());
+    ASSERT_EQ(cudaMemcpy(y.data(), output.Get<Tensor>().DataRaw(), y.size() * sizeof(float), cudaMemcpyDeviceToHost),
+              cudaSuccess);
+    std::vector<float> expected_y;
+    for (float v : x) {
+      expected_y.push_back(v * v);
+    }
+    EXPECT_EQ(expected_y, y);
+  }
+}
+
+TEST(InferenceSessionTests, TestCudaCopyOfPageableMemory) {
+  // larger than the two staging buffers, and not a multiple of their size
+  std::vector<int64_t> dims = {3 * 1024 * 1024 + 5};
+  std::vector<float> values(static_cast<size_t>(dims[0]));
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i % 1000);
+  }
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto gpu_allocator = TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  Tensor cpu_src(DataTypeImpl::GetType<float>(), TensorShape(dims), cpu_allocator);
+  std::copy(values.begin(), values.end(), cpu_src.MutableData<float>());
+  Tensor gpu(DataTypeImpl::GetType<float>(), TensorShape(dims), gpu_allocator);
+  Tensor cpu_dst(DataTypeImpl::GetType<float>(), TensorShape(dims), cpu_allocator);
+
+  GPUDataTransfer data_transfer;
+  ASSERT_TRUE(data_transfer.CopyTensor(cpu_src, gpu, 0).IsOK());
+  // the source can be reused once the copy to the device returns
+  std::fill(cpu_src.MutableData<float>(), cpu_src.MutableData<float>() + values.size(), -1.0f);
+  ASSERT_TRUE(data_transfer.CopyTensor(gpu, cpu_dst, 0).IsOK());
+
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), cpu_dst.Data<float>()));
+}
+
+TEST(InferenceSessionTests, TestCudaCopyBetweenDevices) {
+  int device_count = 0;
+  ASSERT_EQ(cudaGetDeviceCount(&device_count), cudaSuccess);
+  if (device_count < 2) {
+    return;
+  }
+
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 1;
+  CUDAExecutionProvider provider_1(epi);
+  ASSERT_EQ(cudaSetDevice(0), cudaSuccess);
+
+  std::vector<int64_t> dims = {1000};
+  std::vector<float> values(static_cast<size_t>(dims[0]));
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i);
+  }
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  Tensor cpu_src(DataTypeImpl::GetType<float>(), TensorShape(dims), cpu_allocator);
+  std::copy(values.begin(), values.end(), cpu_src.MutableData<float>());
+  Tensor gpu_0(DataTypeImpl::GetType<float>(), TensorShape(dims),
+               TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault));
+  Tensor gpu_1(DataTypeImpl::GetType<float>(), TensorShape(dims), provider_1.GetAllocator(1, OrtMemTypeDefault));
+  Tensor cpu_dst(DataTypeImpl::GetType<float>(), TensorShape(dims), cpu_allocator);
+
+  GPUDataTransfer data_transfer;
+  ASSERT_TRUE(data_transfer.CopyTensor(cpu_src, gpu_0, 0).IsOK());
+  ASSERT_TRUE(data_transfer.CopyTensor(gpu_0, gpu_1, 0).IsOK());
+  ASSERT_TRUE(data_transfer.CopyTensor(gpu_1, cpu_dst, 0).IsOK());
+
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), cpu_dst.Data<float>()));
+}
+
 #endif
 
 }  // namespace test
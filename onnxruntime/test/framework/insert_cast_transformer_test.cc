@@ -4,6 +4,7 @@
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
 #include "gtest/gtest.h"
 #include "test_utils.h"
@@ -107,6 +108,63 @@ TEST(TransformerTest, InsertCastAllCPUTest) {
   }
 }
 
+TEST(TransformerTest, InsertCastCudaFloat16Test) {
+  auto model = std::make_shared<onnxruntime::Model>("test");
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg x_def("X", &tensor_float),
+      w_def("W", &tensor_float),
+      o1_def("O1", &tensor_float),
+      o2_def("O2", &tensor_float),
+      o3_def("O3", &tensor_float);
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  weights.add_dims(2);
+  weights.add_dims(2);
+  for (float value : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    weights.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weights);
+
+  auto& node1 = graph.AddNode("node1", "MatMul", "gpu operator1", ArgMap{&x_def, &w_def}, ArgMap{&o1_def});
+  auto& node2 = graph.AddNode("node2", "Relu", "gpu operator2", ArgMap{&o1_def}, ArgMap{&o2_def});
+  auto& node3 = graph.AddNode("node3", "Softmax", "gpu operator3", ArgMap{&o2_def}, ArgMap{&o3_def});
+  for (auto* node : {&node1, &node2, &node3}) {
+    node->SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  }
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  InsertCastTransformer transformer("Test", /*cuda_float16*/ true);
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+  status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // X is cast to float16 and the weights are converted, the MatMul output feeds the Relu in float16,
+  // and the Relu output is cast back to float for the Softmax.
+  EXPECT_EQ(graph.NumberOfNodes(), 5);
+  for (const auto* input : node1.InputDefs()) {
+    EXPECT_EQ(input->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT16);
+  }
+  EXPECT_EQ(node1.InputNodesBegin()->OpType(), "Cast");
+  EXPECT_TRUE(graph_utils::IsConstantInitializer(graph, node1.InputDefs()[1]->Name()));
+  EXPECT_EQ(node2.InputDefs()[0], node1.OutputDefs()[0]);
+  EXPECT_EQ(node2.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(node2.OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT16);
+  EXPECT_EQ(node3.InputNodesBegin()->OpType(), "Cast");
+  EXPECT_EQ(node3.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT);
+  EXPECT_EQ(node3.OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT);
+}
+
 // test that when there are 3 Cast ops in a row we remove the correct ones
 TEST(TransformerTest, ThreeInARowRemoval) {
   std::string model_uri = MODEL_FOLDER + "triple-cast.onnx";
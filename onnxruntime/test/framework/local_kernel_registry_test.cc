@@ -325,5 +325,54 @@ TEST(CustomKernelTests, CustomKernelWithOptionalOutput) {
   // Now run
   RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
 }
+
+TEST(CustomKernelTests, TryFindKernelMatchesVersionTypeAndProvider) {
+  KernelRegistry registry;
+  auto register_add = [&registry](int start_version, int end_version, MLDataType type) {
+    KernelDefBuilder def;
+    def.SetName("Add")
+        .SetDomain(onnxruntime::kOnnxDomain)
+        .SinceVersion(start_version, end_version)
+        .Provider(onnxruntime::kCpuExecutionProvider)
+        .TypeConstraint("T", type);
+    EXPECT_TRUE(registry.Register(def, CreateFooKernel).IsOK());
+  };
+  register_add(1, 6, DataTypeImpl::GetTensorType<float>());
+  register_add(7, 7, DataTypeImpl::GetTensorType<float>());
+  register_add(7, 7, DataTypeImpl::GetTensorType<int32_t>());
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float, tensor_int32, tensor_double;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_int32.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  tensor_double.mutable_tensor_type()->set_elem_type(TensorProto_DataType_DOUBLE);
+  onnxruntime::NodeArg float_x("FX", &tensor_float), float_y("FY", &tensor_float);
+  onnxruntime::NodeArg int32_x("IX", &tensor_int32), int32_y("IY", &tensor_int32);
+  onnxruntime::NodeArg double_x("DX", &tensor_double), double_y("DY", &tensor_double);
+  using ArgList = std::vector<onnxruntime::NodeArg*>;
+  auto& float_node = graph.AddNode("float_add", "Add", "", ArgList{&float_x, &float_x}, ArgList{&float_y});
+  auto& int32_node = graph.AddNode("int32_add", "Add", "", ArgList{&int32_x, &int32_x}, ArgList{&int32_y});
+  auto& double_node = graph.AddNode("double_add", "Add", "", ArgList{&double_x, &double_x}, ArgList{&double_y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // look up twice so the second lookup uses the type constraints resolved by the first
+  for (int i = 0; i < 2; ++i) {
+    const KernelCreateInfo* float_kernel = registry.TryFindKernel(float_node, onnxruntime::kCpuExecutionProvider);
+    ASSERT_NE(float_kernel, nullptr);
+    EXPECT_EQ(float_kernel->kernel_def->SinceVersion(), std::make_pair(7, 7));
+    EXPECT_EQ(float_kernel->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<float>());
+
+    const KernelCreateInfo* int32_kernel = registry.TryFindKernel(int32_node, onnxruntime::kCpuExecutionProvider);
+    ASSERT_NE(int32_kernel, nullptr);
+    EXPECT_EQ(int32_kernel->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<int32_t>());
+
+    EXPECT_EQ(registry.TryFindKernel(double_node, onnxruntime::kCpuExecutionProvider), nullptr);
+    EXPECT_EQ(registry.TryFindKernel(float_node, onnxruntime::kCudaExecutionProvider), nullptr);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -177,6 +177,60 @@ TEST(TransformerTest, MemcpyTransformerTestCudaFirst) {
   ExpectSame(node2, node4, 0);
   ExpectSame(node2, node4, 1);
 }
+TEST(TransformerTest, MemcpyTransformerTestBatchedCopies) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg i1_def("I1", &tensor_float_type),
+      o1_def("O1", &tensor_float_type),
+      o2_def("O2", &tensor_float_type),
+      o3_def("O3", &tensor_float_type);
+
+  // both outputs of the cpu node are consumed by the gpu node
+  auto& node1 = graph.AddNode("node1", "Split", "cpu operator1", ArgMap{&i1_def}, ArgMap{&o1_def, &o2_def});
+  node1.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  auto& node2 = graph.AddNode("node2", "Add", "gpu operator1", ArgMap{&o1_def, &o2_def}, ArgMap{&o3_def});
+  node2.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                          std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernels(execution_providers);
+
+  MemcpyTransformer transformer({onnxruntime::kCudaExecutionProvider}, test_registry_manager);
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // Expect: a single node copying O1 and O2 from cpu to gpu
+  int copy_nodes = 0;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() != "MemcpyFromHost")
+      continue;
+    ++copy_nodes;
+    ASSERT_EQ(node.InputDefs().size(), 2u);
+    ASSERT_EQ(node.OutputDefs().size(), 2u);
+    EXPECT_EQ(node.InputDefs()[0]->Name(), "O1");
+    EXPECT_EQ(node.InputDefs()[1]->Name(), "O2");
+    EXPECT_EQ(node.OutputDefs()[0], node2.InputDefs()[0]);
+    EXPECT_EQ(node.OutputDefs()[1], node2.InputDefs()[1]);
+  }
+  EXPECT_EQ(copy_nodes, 1);
+}
+
 TEST(TransformerTest, TestCopyNodeInsertionInitializerInSubgraph) {
   // In this test, we are going to create a subgraph consuming an implicit input
   // which is an initializer in the outer scope, and this implicit input to the subgraph
@@ -5,9 +5,11 @@
 
 #include "core/framework/execution_providers.h"
 #include "core/framework/graph_partitioner.h"
+#include "core/framework/mem_pattern_planner.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -149,6 +151,175 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
   }
 }
 
+static std::unique_ptr<MemoryPatternGroup> CreateMemoryPatternGroup(size_t size) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, size);
+  auto group = std::make_unique<MemoryPatternGroup>();
+  group->locations.push_back(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator));
+  group->patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+TEST(SessionStateTest, MemoryPatternCacheBucketsShapes) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, nullptr};
+  s.SetMemoryPatternCacheOptions(32, 0);
+
+  TensorShape shape_40({1, 40});
+  TensorShape shape_64({1, 64});
+  TensorShape shape_65({1, 65});
+  TensorShape shape_transposed({40, 1});
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache({std::cref(shape_40)}, CreateMemoryPatternGroup(160)).IsOK());
+
+  // same bucket
+  auto patterns = s.GetMemoryPatternGroup({std::cref(shape_64)});
+  ASSERT_NE(nullptr, patterns);
+  EXPECT_EQ(160u, patterns->patterns[0].PeakSize());
+  // next bucket, and a different shape with the same dims
+  EXPECT_EQ(nullptr, s.GetMemoryPatternGroup({std::cref(shape_65)}));
+  EXPECT_EQ(nullptr, s.GetMemoryPatternGroup({std::cref(shape_transposed)}));
+
+  // a run with bigger tensors than the pattern asks for a retrace; the bigger pattern replaces it
+  s.RequestMemoryPatternRetrace({std::cref(shape_64)});
+  EXPECT_EQ(nullptr, s.GetMemoryPatternGroup({std::cref(shape_40)}));
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache({std::cref(shape_64)}, CreateMemoryPatternGroup(256)).IsOK());
+  patterns = s.GetMemoryPatternGroup({std::cref(shape_40)});
+  ASSERT_NE(nullptr, patterns);
+  EXPECT_EQ(256u, patterns->patterns[0].PeakSize());
+}
+
+TEST(SessionStateTest, MemoryPatternCacheEvictsLeastRecentlyUsed) {
+  ExecutionProviders execution_providers;
+  SessionState s{execution_providers, true, nullptr};
+  s.SetMemoryPatternCacheOptions(1, 2);
+
+  TensorShape shape_1({1});
+  TensorShape shape_2({2});
+  TensorShape shape_3({3});
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache({std::cref(shape_1)}, CreateMemoryPatternGroup(64)).IsOK());
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache({std::cref(shape_2)}, CreateMemoryPatternGroup(64)).IsOK());
+
+  // keep the evicted pattern alive the way a running ExecutionFrame does
+  auto in_use = s.GetMemoryPatternGroup({std::cref(shape_1)});
+  ASSERT_NE(nullptr, in_use);
+  ASSERT_TRUE(s.UpdateMemoryPatternGroupCache({std::cref(shape_3)}, CreateMemoryPatternGroup(64)).IsOK());
+
+  EXPECT_NE(nullptr, s.GetMemoryPatternGroup({std::cref(shape_1)}));
+  EXPECT_EQ(nullptr, s.GetMemoryPatternGroup({std::cref(shape_2)}));
+  EXPECT_NE(nullptr, s.GetMemoryPatternGroup({std::cref(shape_3)}));
+  EXPECT_EQ(64u, in_use->patterns[0].PeakSize());
+}
+
+TEST(SessionStateTest, SymbolicMemoryPatternPlannedWithoutTracing) {
+  concurrency::ThreadPool tp{"test", 1};
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(4);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &float_tensor);
+  graph.AddNode("relu_1", "Relu", "", {&x}, {&y});
+  graph.AddNode("relu_2", "Relu", "", {&y}, {&z});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  status = execution_providers.Add(onnxruntime::kCpuExecutionProvider, std::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SessionState session_state(execution_providers, true, &tp);
+  SessionStateInitializer session_initializer(true, ORT_TSTR(""), graph, session_state, execution_providers, krm);
+  GraphPartitioner partitioner(krm, execution_providers);
+  status = partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr());
+  ASSERT_TRUE(status.IsOK()) << status;
+  status = session_initializer.CreatePlan(nullptr, nullptr, true);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  int x_idx, y_idx;
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("Y", y_idx).IsOK());
+  const auto& location = session_state.GetExecutionPlan()->GetLocation(y_idx);
+
+  // a pattern is available for each new batch size before any run traced it
+  TensorShape batch_3({3, 4});
+  auto patterns = session_state.GetMemoryPatternGroup({std::cref(batch_3)}, {x_idx});
+  ASSERT_NE(nullptr, patterns);
+  ASSERT_NE(nullptr, patterns->GetPatterns(location));
+  ASSERT_NE(nullptr, patterns->GetPatterns(location)->GetBlock(y_idx));
+  EXPECT_EQ(64u, patterns->GetPatterns(location)->GetBlock(y_idx)->size_);
+  EXPECT_EQ(patterns, session_state.GetMemoryPatternGroup({std::cref(batch_3)}, {x_idx}));
+
+  TensorShape batch_5({5, 4});
+  patterns = session_state.GetMemoryPatternGroup({std::cref(batch_5)}, {x_idx});
+  ASSERT_NE(nullptr, patterns);
+  EXPECT_EQ(128u, patterns->GetPatterns(location)->GetBlock(y_idx)->size_);
+
+  // the symbols must be bound by the feeds
+  TensorShape batch_7({7, 4});
+  EXPECT_EQ(nullptr, session_state.GetMemoryPatternGroup({std::cref(batch_7)}, {}));
+}
+
+// Test that sessions of the same model share the initializers through a SharedInitializerCache
+TEST(SessionStateTest, SharedInitializers) {
+  concurrency::ThreadPool tp{"test", 1};
+  std::string model_path = "testdata/optional_inputs_ir3.onnx";
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  auto status = execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                                        std::make_unique<CPUExecutionProvider>(epi));
+  ASSERT_TRUE(status.IsOK()) << status;
+  KernelRegistryManager krm;
+  status = krm.RegisterKernels(execution_providers);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  SharedInitializerCache cache;
+  std::vector<std::shared_ptr<Model>> models(2);
+  std::vector<std::unique_ptr<SessionState>> session_states(2);
+  size_t num_initializers = 0;
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_TRUE((status = Model::Load(model_path, models[i])).IsOK()) << status;
+    Graph& graph = models[i]->MainGraph();
+    num_initializers = graph.GetAllInitializedTensors().size();
+
+    session_states[i] = std::make_unique<SessionState>(execution_providers, true, &tp);
+    SessionStateInitializer session_initializer(true, ToWideString(model_path), graph, *session_states[i],
+                                                execution_providers, krm, &cache);
+    GraphPartitioner partitioner(krm, execution_providers);
+    status = partitioner.Partition(graph, session_states[i]->ExportDll(), session_states[i]->GetMutableFuncMgr());
+    ASSERT_TRUE(status.IsOK()) << status;
+    status = session_initializer.CreatePlan(nullptr, nullptr, true);
+    ASSERT_TRUE(status.IsOK()) << status;
+  }
+
+  ASSERT_GT(num_initializers, 0u);
+  EXPECT_EQ(num_initializers, cache.NumEntries());
+  const auto& initialized_tensors_0 = session_states[0]->GetInitializedTensors();
+  const auto& initialized_tensors_1 = session_states[1]->GetInitializedTensors();
+  for (const auto& entry : session_states[0]->GetOrtValueNameIdxMap()) {
+    auto it = initialized_tensors_0.find(entry.second);
+    if (it == initialized_tensors_0.cend()) continue;
+    int idx;
+    ASSERT_TRUE(session_states[1]->GetOrtValueNameIdxMap().GetIdx(entry.first, idx).IsOK());
+    EXPECT_EQ(it->second.Get<Tensor>().DataRaw(), initialized_tensors_1.at(idx).Get<Tensor>().DataRaw())
+        << entry.first << " is not shared";
+  }
+
+  // the entries are kept alive by the sessions using them
+  session_states[0].reset();
+  EXPECT_EQ(num_initializers, cache.NumEntries());
+  session_states[1].reset();
+  EXPECT_EQ(0u, cache.NumEntries());
+}
+
 INSTANTIATE_TEST_CASE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
 }  // namespace test
 }  // namespace onnxruntime
@@ -137,6 +137,31 @@ TEST(TensorTest, EmptyTensorTest) {
   EXPECT_EQ(location.type, OrtAllocatorType::OrtArenaAllocator);
 }
 
+TEST(TensorTest, StridesTest) {
+  std::vector<float> data(24);
+  auto location = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault)->Info();
+  Tensor t(DataTypeImpl::GetType<float>(), TensorShape({2, 3, 4}), data.data(), location);
+  EXPECT_TRUE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(12, 4, 1));
+
+  // every other column of the first two rows of each matrix
+  t.SetShapeAndStrides(TensorShape({2, 2, 2}), {12, 4, 2});
+  EXPECT_FALSE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(12, 4, 2));
+
+  // the strides of axes of size 1 don't matter
+  t.SetShapeAndStrides(TensorShape({2, 1, 4}), {12, 0, 1});
+  EXPECT_FALSE(t.IsContiguous());
+  t.SetShapeAndStrides(TensorShape({2, 1, 4}), {4, 0, 1});
+  EXPECT_TRUE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(4, 4, 1));
+
+  // a broadcast along the first axis
+  t.SetShapeAndStrides(TensorShape({5, 4}), {0, 1});
+  EXPECT_FALSE(t.IsContiguous());
+  EXPECT_THAT(t.Strides(), testing::ElementsAre(0, 1));
+}
+
 TEST(TensorTest, StringTensorTest) {
 //add scope to explicitly delete tensor
 #ifdef _MSC_VER
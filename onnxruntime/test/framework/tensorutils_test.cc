@@ -2,7 +2,15 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensorprotoutils.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "core/framework/callback.h"
+#include "core/framework/mem_buffer.h"
+#include "core/framework/ml_value.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
 #include "gtest/gtest.h"
 
 using namespace ::onnxruntime::utils;
@@ -71,5 +79,55 @@ TEST(TensorParseTest, TensorUtilsTest) {
   status = UnpackTensorWrapper(bool_tensor_proto, string_data, 2);
   EXPECT_FALSE(status.IsOK());
 }
+
+static void SetExternalData(TensorProto& tensor_proto, const std::string& location, const std::string& offset,
+                            const std::string& length) {
+  tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+  tensor_proto.clear_external_data();
+  const std::pair<std::string, std::string> entries[] = {{"location", location}, {"offset", offset}, {"length", length}};
+  for (const auto& entry : entries) {
+    auto* external_data = tensor_proto.add_external_data();
+    external_data->set_key(entry.first);
+    external_data->set_value(entry.second);
+  }
+}
+
+TEST(TensorParseTest, MappedExternalData) {
+  const std::string file_name = "tensorutils_test_mapped_external_data.bin";
+  const float data[4] = {1.f, 2.f, 3.f, 4.f};
+  {
+    std::ofstream file(file_name, std::ios::binary);
+    const char padding[4] = {};
+    file.write(padding, sizeof(padding));
+    file.write(reinterpret_cast<const char*>(data), sizeof(data));
+  }
+
+  TensorProto tensor_proto;
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  tensor_proto.add_dims(4);
+
+  // the data must be aligned for the element type to be used in place
+  SetExternalData(tensor_proto, file_name, "2", "16");
+  EXPECT_FALSE(CanUseMappedExternalData(tensor_proto));
+  SetExternalData(tensor_proto, file_name, "4", "16");
+  ASSERT_TRUE(CanUseMappedExternalData(tensor_proto));
+
+  OrtValue value;
+  OrtCallback deleter;
+  OrtMemoryInfo cpu_info(CPU, OrtAllocatorType::OrtDeviceAllocator);
+  auto status = TensorProtoToMLValue(Env::Default(), nullptr, tensor_proto, MemBuffer(nullptr, 0, cpu_info), value,
+                                     deleter);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(nullptr, deleter.f);
+  const auto& tensor = value.Get<Tensor>();
+  ASSERT_EQ(4, tensor.Shape().Size());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(data[i], tensor.Data<float>()[i]);
+  }
+
+  value = OrtValue();
+  deleter.f(deleter.param);
+  std::remove(file_name.c_str());
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -591,6 +591,48 @@ TEST(ResolvingGraphTest, UnusedInitializerIsIgnored) {
   ASSERT_TRUE(graph.GetAllInitializedTensors().empty());
 }
 
+TEST(ResolvingGraphTest, IncrementalTypeInference) {
+  Model model("IncrementalTypeInference");
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // X -> relu_1 -> A -> relu_2 -> Y
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& a_arg = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& y_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  auto& relu_1 = graph.AddNode("relu_1", "Relu", "relu 1", {&x_arg}, {&a_arg});
+  auto& relu_2 = graph.AddNode("relu_2", "Relu", "relu 2", {&a_arg}, {&y_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_NE(y_arg.Shape(), nullptr);
+  EXPECT_EQ(y_arg.Shape()->dim_size(), 2);
+
+  // Redirect relu_1 to a new untyped NodeArg and consume it with a new node. The nodes
+  // that changed are inferred again, and the types of the unchanged nodes are kept.
+  auto& b_arg = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& z_arg = graph.GetOrCreateNodeArg("Z", nullptr);
+  relu_1.MutableOutputDefs()[0] = &b_arg;
+  relu_2.MutableInputDefs()[0] = &b_arg;
+  graph.AddNode("relu_3", "Relu", "relu 3", {&b_arg}, {&z_arg});
+  graph.SetGraphResolveNeeded();
+
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  for (const auto* arg : {&b_arg, &y_arg, &z_arg}) {
+    ASSERT_NE(arg->Type(), nullptr) << arg->Name();
+    EXPECT_EQ(*arg->Type(), "tensor(float)") << arg->Name();
+    ASSERT_NE(arg->Shape(), nullptr) << arg->Name();
+    ASSERT_EQ(arg->Shape()->dim_size(), 2) << arg->Name();
+    EXPECT_EQ(arg->Shape()->dim(0).dim_value(), 2) << arg->Name();
+    EXPECT_EQ(arg->Shape()->dim(1).dim_value(), 3) << arg->Name();
+  }
+}
+
 TEST(ResolvingGraphTest, GraphConstruction_CheckIsNotAcyclic) {
   // A cyclic graph
   //                 SouceNode
@@ -647,6 +689,29 @@ TEST(ResolvingGraphTest, GraphConstruction_OnlyInitializer) {
   EXPECT_TRUE(iii.size() == 0);
 }
 
+TEST(ResolvingGraphTest, ReleaseInitializedTensorData) {
+  onnxruntime::Model model("graph");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TensorProto weight;
+  weight.add_dims(2);
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_float_data(1.f);
+  weight.add_float_data(2.f);
+  weight.set_name("weight");
+  graph.AddInitializedTensor(weight);
+
+  graph.ReleaseInitializedTensorData("weight");
+
+  const ONNX_NAMESPACE::TensorProto* released = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("weight", released));
+  EXPECT_EQ("weight", released->name());
+  EXPECT_EQ(TensorProto_DataType_FLOAT, released->data_type());
+  ASSERT_EQ(1, released->dims_size());
+  EXPECT_EQ(2, released->dims(0));
+  EXPECT_EQ(0, released->float_data_size());
+}
+
 TEST(ResolvingGraphTest, GraphConstruction_TypeInference) {
   ASSERT_TRUE(kSchemasRegistered);
 
@@ -0,0 +1,576 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    tuning.cpp
+
+Abstract:
+
+    This module implements a tool that tunes the MLAS library on the current
+    machine for a set of operation shapes and writes a tuning cache.
+
+    The tool sweeps the SGEMM kernel, the NCHWc block size, the thread stride
+    alignment and the per thread complexities of the cost model, keeping the
+    fastest choice for the supplied shapes at each step. Processes load the
+    tuning cache at start when the MLAS_TUNING_CACHE environment variable
+    names the file.
+
+--*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mlas.h>
+
+#if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
+#include "core/platform/threadpool.h"
+#endif
+
+//
+// Define the number of times each candidate is measured. The fastest run is
+// used to reduce the noise from other activity on the machine.
+//
+
+#define MLAS_TUNING_RUNS                            5
+
+struct MLAS_TUNING_GEMM_SHAPE {
+    size_t M;
+    size_t N;
+    size_t K;
+    std::vector<float> A;
+    std::vector<float> B;
+    std::vector<float> C;
+};
+
+struct MLAS_TUNING_CONV_SHAPE {
+    size_t InputChannels;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t FilterCount;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t Stride;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    std::vector<float> Input;
+    std::vector<float> Filter;
+    std::vector<float> Output;
+    std::vector<float> NchwcFilter;
+    std::vector<float> WorkingBuffer;
+};
+
+struct MLAS_TUNING_POOL_SHAPE {
+    size_t Channels;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t Kernel;
+    size_t Stride;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    std::vector<float> Input;
+    std::vector<float> Output;
+};
+
+struct MLAS_TUNING_SOFTMAX_SHAPE {
+    size_t N;
+    size_t D;
+    std::vector<float> Input;
+    std::vector<float> Output;
+};
+
+class MlasTuning
+{
+public:
+    MlasTuning(
+        MLAS_THREADPOOL* ThreadPool
+        ) : ThreadPool(ThreadPool)
+    {
+    }
+
+    bool
+    AddShape(
+        const char* Shape
+        )
+    {
+        size_t v[7];
+
+        if (sscanf(Shape, "gemm:%zu,%zu,%zu", &v[0], &v[1], &v[2]) == 3) {
+
+            MLAS_TUNING_GEMM_SHAPE Gemm;
+
+            Gemm.M = v[0];
+            Gemm.N = v[1];
+            Gemm.K = v[2];
+            Gemm.A.assign(Gemm.M * Gemm.K, 0.25f);
+            Gemm.B.assign(Gemm.K * Gemm.N, 0.5f);
+            Gemm.C.resize(Gemm.M * Gemm.N);
+
+            GemmShapes.push_back(std::move(Gemm));
+            return true;
+        }
+
+        if (sscanf(Shape, "conv:%zu,%zu,%zu,%zu,%zu,%zu,%zu", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6]) == 7) {
+
+            MLAS_TUNING_CONV_SHAPE Conv;
+
+            Conv.InputChannels = v[0];
+            Conv.InputHeight = v[1];
+            Conv.InputWidth = v[2];
+            Conv.FilterCount = v[3];
+            Conv.KernelHeight = v[4];
+            Conv.KernelWidth = v[5];
+            Conv.Stride = (std::max)(v[6], size_t(1));
+
+            if (Conv.KernelHeight == 0 || Conv.KernelWidth == 0 ||
+                Conv.KernelHeight > Conv.InputHeight || Conv.KernelWidth > Conv.InputWidth) {
+                return false;
+            }
+
+            Conv.OutputHeight = (Conv.InputHeight + 2 * (Conv.KernelHeight / 2) - Conv.KernelHeight) / Conv.Stride + 1;
+            Conv.OutputWidth = (Conv.InputWidth + 2 * (Conv.KernelWidth / 2) - Conv.KernelWidth) / Conv.Stride + 1;
+            Conv.Input.assign(AlignChannels(Conv.InputChannels) * Conv.InputHeight * Conv.InputWidth, 0.5f);
+            Conv.Filter.assign(Conv.FilterCount * Conv.InputChannels * Conv.KernelHeight * Conv.KernelWidth, 0.25f);
+            Conv.Output.resize(AlignChannels(Conv.FilterCount) * Conv.OutputHeight * Conv.OutputWidth);
+
+            ConvShapes.push_back(std::move(Conv));
+            return true;
+        }
+
+        if (sscanf(Shape, "pool:%zu,%zu,%zu,%zu,%zu", &v[0], &v[1], &v[2], &v[3], &v[4]) == 5) {
+
+            MLAS_TUNING_POOL_SHAPE Pool;
+
+            Pool.Channels = v[0];
+            Pool.InputHeight = v[1];
+            Pool.InputWidth = v[2];
+            Pool.Kernel = v[3];
+            Pool.Stride = (std::max)(v[4], size_t(1));
+
+            if (Pool.Kernel > Pool.InputHeight || Pool.Kernel > Pool.InputWidth) {
+                return false;
+            }
+
+            Pool.OutputHeight = (Pool.InputHeight - Pool.Kernel) / Pool.Stride + 1;
+            Pool.OutputWidth = (Pool.InputWidth - Pool.Kernel) / Pool.Stride + 1;
+            Pool.Input.assign(AlignChannels(Pool.Channels) * Pool.InputHeight * Pool.InputWidth, 0.5f);
+            Pool.Output.resize(AlignChannels(Pool.Channels) * Pool.OutputHeight * Pool.OutputWidth);
+
+            PoolShapes.push_back(std::move(Pool));
+            return true;
+        }
+
+        if (sscanf(Shape, "softmax:%zu,%zu", &v[0], &v[1]) == 2) {
+
+            MLAS_TUNING_SOFTMAX_SHAPE Softmax;
+
+            Softmax.N = v[0];
+            Softmax.D = v[1];
+            Softmax.Input.assign(Softmax.N * Softmax.D, 0.5f);
+            Softmax.Output.resize(Softmax.N * Softmax.D);
+
+            SoftmaxShapes.push_back(std::move(Softmax));
+            return true;
+        }
+
+        return false;
+    }
+
+    void
+    Tune(
+        void
+        )
+    {
+        MlasGetCostModel(&DefaultCostModel);
+
+        //
+        // Select the SGEMM kernel from the GEMM and NCHW convolution shapes.
+        //
+
+        if (!GemmShapes.empty() || !ConvShapes.empty()) {
+            Sweep("SgemmKernel", { "sse", "avx", "fma3", "avx512f" }, [this]() {
+                RunGemm();
+                RunConv();
+            });
+        }
+
+        //
+        // Select the NCHWc block size from the NCHWc convolution and pooling
+        // shapes. The filters are reordered for each block size.
+        //
+
+        if (MlasNchwcGetBlockSize() > 1 && (!ConvShapes.empty() || !PoolShapes.empty())) {
+            Sweep("NchwcBlockSize", { "8", "16" }, [this]() {
+                RunNchwcConv();
+                RunNchwcPool();
+            });
+        }
+
+        //
+        // Select the thread stride alignment and the per thread complexities
+        // if there are threads to balance.
+        //
+
+        if (ThreadPool == nullptr) {
+            return;
+        }
+
+        if (!GemmShapes.empty()) {
+            Sweep("ThreadStrideNAlign", { "16", "32", "64", "128" }, [this]() {
+                RunGemm();
+            });
+            Sweep("GemmThreadComplexity", ScaledValues(DefaultCostModel.GemmThreadComplexity), [this]() {
+                RunGemm();
+            });
+        }
+
+        if (!ConvShapes.empty()) {
+            Sweep("ConvThreadComplexity", ScaledValues(DefaultCostModel.ConvThreadComplexity), [this]() {
+                RunConv();
+            });
+        }
+
+        if (!SoftmaxShapes.empty()) {
+            Sweep("ComputeThreadElements", ScaledValues(double(DefaultCostModel.ComputeThreadElements)), [this]() {
+                RunSoftmax();
+            });
+        }
+    }
+
+    bool
+    WriteCache(
+        const char* FileName
+        )
+    {
+        std::ofstream File(FileName);
+
+        File << "# MLAS tuning cache\n";
+
+        for (const auto& Selection : Selections) {
+            File << Selection.first << "=" << Selection.second << "\n";
+        }
+
+        File.close();
+
+        return !File.fail();
+    }
+
+private:
+    MLAS_THREADPOOL* ThreadPool;
+    MLAS_COST_MODEL DefaultCostModel;
+    std::vector<MLAS_TUNING_GEMM_SHAPE> GemmShapes;
+    std::vector<MLAS_TUNING_CONV_SHAPE> ConvShapes;
+    std::vector<MLAS_TUNING_POOL_SHAPE> PoolShapes;
+    std::vector<MLAS_TUNING_SOFTMAX_SHAPE> SoftmaxShapes;
+    std::vector<std::pair<std::string, std::string>> Selections;
+
+    static
+    size_t
+    AlignChannels(
+        size_t Channels
+        )
+    {
+        //
+        // Align to the largest NCHWc block size so that the buffers can be
+        // used with any block size.
+        //
+
+        return (Channels + 15) & ~size_t(15);
+    }
+
+    static
+    std::vector<std::string>
+    ScaledValues(
+        double Value
+        )
+    {
+        std::vector<std::string> Values;
+
+        for (double Scale : { 0.125, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0 }) {
+            Values.push_back(std::to_string(size_t((std::max)(Value * Scale, 1.0))));
+        }
+
+        return Values;
+    }
+
+    void
+    Sweep(
+        const char* Name,
+        const std::vector<std::string>& Values,
+        const std::function<void()>& Workload
+        )
+    {
+        const std::string* BestValue = nullptr;
+        double BestTime = 0.0;
+
+        for (const auto& Value : Values) {
+
+            if (!MlasSetTuningParameter(Name, Value.c_str())) {
+                continue;
+            }
+
+            double Time = Measure(Workload);
+
+            printf("%s=%s: %.3f ms\n", Name, Value.c_str(), Time * 1e-6);
+
+            if (BestValue == nullptr || Time < BestTime) {
+                BestValue = &Value;
+                BestTime = Time;
+            }
+        }
+
+        if (BestValue != nullptr) {
+            MlasSetTuningParameter(Name, BestValue->c_str());
+            Selections.emplace_back(Name, *BestValue);
+        }
+    }
+
+    static
+    double
+    Measure(
+        const std::function<void()>& Workload
+        )
+    {
+        //
+        // Run the workload once to warm up the caches and the thread pool.
+        //
+
+        Workload();
+
+        double BestTime = 0.0;
+
+        for (size_t run = 0; run < MLAS_TUNING_RUNS; run++) {
+
+            auto Start = std::chrono::steady_clock::now();
+
+            Workload();
+
+            auto Elapsed = std::chrono::steady_clock::now() - Start;
+            double Time = double(std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count());
+
+            if (run == 0 || Time < BestTime) {
+                BestTime = Time;
+            }
+        }
+
+        return BestTime;
+    }
+
+    void
+    RunGemm(
+        void
+        )
+    {
+        for (auto& Gemm : GemmShapes) {
+            MlasSgemm(CblasNoTrans, CblasNoTrans, Gemm.M, Gemm.N, Gemm.K, 1.0f,
+                Gemm.A.data(), Gemm.K, Gemm.B.data(), Gemm.N, 0.0f, Gemm.C.data(), Gemm.N, ThreadPool);
+        }
+    }
+
+    void
+    RunConv(
+        void
+        )
+    {
+        for (auto& Conv : ConvShapes) {
+
+            int64_t InputShape[] = { int64_t(Conv.InputHeight), int64_t(Conv.InputWidth) };
+            int64_t KernelShape[] = { int64_t(Conv.KernelHeight), int64_t(Conv.KernelWidth) };
+            int64_t DilationShape[] = { 1, 1 };
+            int64_t Padding[] = { int64_t(Conv.KernelHeight / 2), int64_t(Conv.KernelWidth / 2),
+                int64_t(Conv.KernelHeight / 2), int64_t(Conv.KernelWidth / 2) };
+            int64_t StrideShape[] = { int64_t(Conv.Stride), int64_t(Conv.Stride) };
+            int64_t OutputShape[] = { int64_t(Conv.OutputHeight), int64_t(Conv.OutputWidth) };
+
+            MLAS_ACTIVATION Activation;
+            Activation.ActivationKind = MlasIdentityActivation;
+
+            MLAS_CONV_PARAMETERS Parameters;
+            size_t WorkingBufferSize;
+
+            MlasConvPrepare(&Parameters, 2, 1, 1, Conv.InputChannels, InputShape, KernelShape,
+                DilationShape, Padding, StrideShape, OutputShape, Conv.FilterCount, &Activation,
+                &WorkingBufferSize, ThreadPool);
+
+            if (Conv.WorkingBuffer.size() < WorkingBufferSize) {
+                Conv.WorkingBuffer.resize(WorkingBufferSize);
+            }
+
+            const float* Filter = Conv.Filter.data();
+            std::vector<float> TransformedFilter;
+
+            if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+                TransformedFilter.resize(MlasConvWinogradFilterSize(&Parameters));
+                MlasConvWinogradTransformFilter(&Parameters, Filter, TransformedFilter.data());
+                Filter = TransformedFilter.data();
+            }
+
+            MlasConv(&Parameters, Conv.Input.data(), Filter, nullptr, Conv.WorkingBuffer.data(),
+                Conv.Output.data(), ThreadPool);
+        }
+    }
+
+    void
+    RunNchwcConv(
+        void
+        )
+    {
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+
+        for (auto& Conv : ConvShapes) {
+
+            if (Conv.InputChannels < BlockSize) {
+                continue;
+            }
+
+            const size_t NchwcInputChannels = (Conv.InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+            const size_t NchwcOutputChannels = (Conv.FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+            int64_t FilterShape[] = { int64_t(Conv.FilterCount), int64_t(Conv.InputChannels),
+                int64_t(Conv.KernelHeight), int64_t(Conv.KernelWidth) };
+
+            Conv.NchwcFilter.resize(NchwcOutputChannels * NchwcInputChannels * Conv.KernelHeight * Conv.KernelWidth);
+            MlasReorderFilterOIHWBiBo(FilterShape, Conv.Filter.data(), Conv.NchwcFilter.data());
+
+            int64_t InputShape[] = { 1, int64_t(NchwcInputChannels), int64_t(Conv.InputHeight), int64_t(Conv.InputWidth) };
+            int64_t KernelShape[] = { int64_t(Conv.KernelHeight), int64_t(Conv.KernelWidth) };
+            int64_t DilationShape[] = { 1, 1 };
+            int64_t Padding[] = { int64_t(Conv.KernelHeight / 2), int64_t(Conv.KernelWidth / 2),
+                int64_t(Conv.KernelHeight / 2), int64_t(Conv.KernelWidth / 2) };
+            int64_t StrideShape[] = { int64_t(Conv.Stride), int64_t(Conv.Stride) };
+            int64_t OutputShape[] = { 1, int64_t(NchwcOutputChannels), int64_t(Conv.OutputHeight), int64_t(Conv.OutputWidth) };
+
+            MLAS_ACTIVATION Activation;
+            Activation.ActivationKind = MlasIdentityActivation;
+
+            MlasNchwcConv(2, InputShape, KernelShape, DilationShape, Padding, StrideShape, OutputShape, 1,
+                Conv.Input.data(), Conv.NchwcFilter.data(), nullptr, Conv.Output.data(), &Activation,
+                true, ThreadPool);
+        }
+    }
+
+    void
+    RunNchwcPool(
+        void
+        )
+    {
+        const size_t BlockSize = MlasNchwcGetBlockSize();
+
+        for (auto& Pool : PoolShapes) {
+
+            const int64_t NchwcChannels = int64_t((Pool.Channels + BlockSize - 1) & ~(BlockSize - 1));
+
+            int64_t InputShape[] = { 1, NchwcChannels, int64_t(Pool.InputHeight), int64_t(Pool.InputWidth) };
+            int64_t KernelShape[] = { int64_t(Pool.Kernel), int64_t(Pool.Kernel) };
+            int64_t Padding[] = { 0, 0, 0, 0 };
+            int64_t StrideShape[] = { int64_t(Pool.Stride), int64_t(Pool.Stride) };
+            int64_t OutputShape[] = { 1, NchwcChannels, int64_t(Pool.OutputHeight), int64_t(Pool.OutputWidth) };
+
+            MlasNchwcPool(MlasMaximumPooling, 2, InputShape, KernelShape, nullptr, Padding, StrideShape,
+                OutputShape, Pool.Input.data(), Pool.Output.data(), ThreadPool);
+        }
+    }
+
+    void
+    RunSoftmax(
+        void
+        )
+    {
+        for (auto& Softmax : SoftmaxShapes) {
+            MlasComputeSoftmax(Softmax.Input.data(), Softmax.Output.data(), Softmax.N, Softmax.D, false, ThreadPool);
+        }
+    }
+};
+
+static
+void
+Usage(
+    void
+    )
+{
+    printf("Usage: onnxruntime_mlas_tuning [-t threads] [-o file] shape...\n"
+           "\n"
+           "Shapes:\n"
+           "    gemm:M,N,K                 SGEMM of an MxK matrix and a KxN matrix\n"
+           "    conv:C,H,W,F,KH,KW,S       2D convolution with same padding and stride S\n"
+           "    pool:C,H,W,K,S             2D maximum pooling with a KxK kernel and stride S\n"
+           "    softmax:N,D                softmax of N rows of D elements\n"
+           "\n"
+           "The tuning cache is written to mlas_tuning_cache.txt unless -o is specified.\n"
+           "Set the MLAS_TUNING_CACHE environment variable to the file name to apply it.\n");
+}
+
+int
+#if defined(_WIN32)
+__cdecl
+#endif
+main(
+    int argc,
+    char* argv[]
+    )
+{
+    const char* FileName = "mlas_tuning_cache.txt";
+    int ThreadCount = 0;
+    std::vector<const char*> Shapes;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            FileName = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            ThreadCount = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            Usage();
+            return 1;
+        } else {
+            Shapes.push_back(argv[i]);
+        }
+    }
+
+    if (Shapes.empty()) {
+        Usage();
+        return 1;
+    }
+
+    MLAS_THREADPOOL* ThreadPool = nullptr;
+
+#if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
+    std::unique_ptr<onnxruntime::concurrency::ThreadPool> ThreadPoolObject;
+
+    if (ThreadCount > 1) {
+        ThreadPoolObject = std::make_unique<onnxruntime::concurrency::ThreadPool>("MlasTuning", ThreadCount - 1);
+        ThreadPool = ThreadPoolObject.get();
+    }
+#else
+    (void)ThreadCount;
+#endif
+
+    MlasTuning Tuning(ThreadPool);
+
+    for (const char* Shape : Shapes) {
+        if (!Tuning.AddShape(Shape)) {
+            printf("invalid shape: %s\n", Shape);
+            return 1;
+        }
+    }
+
+    Tuning.Tune();
+
+    if (!Tuning.WriteCache(FileName)) {
+        printf("failed to write %s\n", FileName);
+        return 1;
+    }
+
+    printf("Wrote %s.\n", FileName);
+
+    return 0;
+}
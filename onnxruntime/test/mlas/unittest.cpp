@@ -17,8 +17,11 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -244,6 +247,113 @@ private:
                 printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
             }
         }
+
+        //
+        // Repeat the operation with matrix B packed in advance. The packed
+        // buffer size is a multiple of the preferred alignment, so the guard
+        // buffer returns an aligned address.
+        //
+
+        void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K) / sizeof(float));
+
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasSgemmPacked(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+            }
+        }
+
+        //
+        // Repeat the operation as a batch of multiplies that write to separate
+        // output matrices.
+        //
+
+        constexpr size_t BatchSize = 3;
+
+        float* CBatch = BufferCBatch.GetBuffer(M * N * BatchSize);
+
+        std::fill_n(CBatch, M * N * BatchSize, -0.5f);
+
+        MLAS_SGEMM_PARAMETERS Parameters[BatchSize];
+
+        for (size_t b = 0; b < BatchSize; b++) {
+            Parameters[b].TransA = TransA;
+            Parameters[b].TransB = TransB;
+            Parameters[b].M = M;
+            Parameters[b].N = N;
+            Parameters[b].K = K;
+            Parameters[b].alpha = alpha;
+            Parameters[b].A = A;
+            Parameters[b].lda = lda;
+            Parameters[b].B = B;
+            Parameters[b].ldb = ldb;
+            Parameters[b].beta = beta;
+            Parameters[b].C = CBatch + M * N * b;
+            Parameters[b].ldc = ldc;
+        }
+
+        MlasSgemmBatch(Parameters, BatchSize, threadpool);
+
+        for (size_t f = 0; f < M * N * BatchSize; f++) {
+            if (CBatch[f] != CReference[f % (M * N)]) {
+                printf("mismatch batch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                break;
+            }
+        }
+
+        //
+        // Repeat the operation with the bias vectors, the residual matrix and
+        // the activation applied by the epilogue. The reference applies the
+        // post processing in the same order, so the results match exactly.
+        //
+
+        const float* ColumnBias = BufferColumnBias.GetBuffer(N);
+        const float* RowBias = BufferRowBias.GetBuffer(M);
+        const float* Residual = BufferResidual.GetBuffer(M * N);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
+
+        MLAS_SGEMM_EPILOGUE Epilogue;
+        Epilogue.ColumnBias = ColumnBias;
+        Epilogue.RowBias = RowBias;
+        Epilogue.Residual = Residual;
+        Epilogue.ldr = N;
+        Epilogue.Activation = &Activation;
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float Value = CReference[m * ldc + n] + ColumnBias[n] + Residual[m * N + n];
+                CReference[m * ldc + n] = (std::max)(Value + RowBias[m], 0.0f);
+            }
+        }
+
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, threadpool, &Epilogue);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch epilogue TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                break;
+            }
+        }
+
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasSgemmPacked(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool, &Epilogue);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed epilogue TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                break;
+            }
+        }
     }
 
     void
@@ -357,8 +467,13 @@ private:
 
     MatrixGuardBuffer<float> BufferA;
     MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBPacked;
+    MatrixGuardBuffer<float> BufferCBatch;
     MatrixGuardBuffer<float> BufferC;
     MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<float> BufferColumnBias;
+    MatrixGuardBuffer<float> BufferRowBias;
+    MatrixGuardBuffer<float> BufferResidual;
 
 public:
     void
@@ -452,26 +567,54 @@ public:
     }
 };
 
-#ifdef MLAS_HAS_QGEMM_U8U8
-
-class MlasQgemmU8U8Test : public MlasTestBase
+template<bool Bf16>
+class MlasHalfGemmTest : public MlasTestBase
 {
 private:
-    void
-    Test(
-        size_t M,
-        size_t N,
-        size_t K,
-        uint8_t offa,
-        uint8_t offb
+    //
+    // The test values are small multiples of 1/4, so they convert exactly
+    // without rounding.
+    //
+
+    static
+    uint16_t
+    FloatToElement(
+        float Value
         )
     {
-        const uint8_t* A = BufferA.GetBuffer(K * M);
-        const uint8_t* B = BufferB.GetBuffer(N * K);
-        int32_t* C = BufferC.GetBuffer(N * M);
-        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(float));
 
-        Test(M, N, K, A, K, offa, B, N, offb, C, CReference, N);
+        if (Bf16) {
+            return uint16_t(Bits >> 16);
+        }
+
+        if ((Bits & 0x7FFFFFFF) == 0) {
+            return uint16_t(Bits >> 16);
+        }
+
+        return uint16_t(((Bits >> 16) & 0x8000) | (((Bits & 0x7FFFFFFF) - 0x38000000) >> 13));
+    }
+
+    static
+    float
+    ElementToFloat(
+        uint16_t Value
+        )
+    {
+        uint32_t Bits;
+
+        if (Bf16) {
+            Bits = uint32_t(Value) << 16;
+        } else if ((Value & 0x7FFF) == 0) {
+            Bits = uint32_t(Value) << 16;
+        } else {
+            Bits = (uint32_t(Value & 0x8000) << 16) | ((uint32_t(Value & 0x7FFF) << 13) + 0x38000000);
+        }
+
+        float FloatValue;
+        memcpy(&FloatValue, &Bits, sizeof(float));
+        return FloatValue;
     }
 
     void
@@ -479,69 +622,88 @@ private:
         size_t M,
         size_t N,
         size_t K,
-        const uint8_t* A,
-        size_t lda,
-        uint8_t offa,
-        const uint8_t* B,
-        size_t ldb,
-        uint8_t offb,
-        int32_t* C,
-        int32_t* CReference,
-        size_t ldc
+        float alpha,
+        float beta
         )
     {
-        std::fill_n(C, M * N, -1);
-        std::fill_n(CReference, M * N, -1);
-
-        MlasQgemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, threadpool);
-        ReferenceQgemm(M, N, K, A, lda, offa, B, ldb, offb, CReference, ldc);
-
-        for (size_t f = 0; f < M * N; f++) {
-            if (C[f] != CReference[f]) {
-                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
-            }
-        }
+        Test(CblasNoTrans, CblasNoTrans, M, N, K, alpha, beta);
+        Test(CblasNoTrans, CblasTrans, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasNoTrans, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasTrans, M, N, K, alpha, beta);
     }
 
     void
-    ReferenceQgemm(
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
         size_t M,
         size_t N,
         size_t K,
-        const uint8_t* A,
-        size_t lda,
-        uint8_t offa,
-        const uint8_t* B,
-        size_t ldb,
-        uint8_t offb,
-        int32_t* C,
-        size_t ldc
+        float alpha,
+        float beta
         )
     {
-        for (size_t m = 0; m < M; m++) {
+        uint16_t* A = BufferA.GetBuffer(M * K);
+        uint16_t* B = BufferB.GetBuffer(K * N);
+        uint16_t* C = BufferC.GetBuffer(M * N);
+        float* CReference = BufferCReference.GetBuffer(M * N);
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = FloatToElement(float(int(i % 7) - 3) * 0.25f);
+        }
+
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = FloatToElement(float(int(i % 11) - 5) * 0.25f);
+        }
+
+        for (size_t i = 0; i < M * N; i++) {
+            C[i] = FloatToElement(-0.5f);
+        }
+
+        const size_t lda = (TransA == CblasNoTrans) ? K : M;
+        const size_t ldb = (TransB == CblasNoTrans) ? N : K;
 
+        for (size_t m = 0; m < M; m++) {
             for (size_t n = 0; n < N; n++) {
 
-                const uint8_t* a = A + (m * lda);
-                const uint8_t* b = B + n;
-                int32_t* c = C + (m * ldc) + n;
-                int32_t sum = 0;
+                float sum = 0.0f;
 
                 for (size_t k = 0; k < K; k++) {
-                    sum += ((int32_t(*b) - offb) * (int32_t(*a) - offa));
-                    b += ldb;
-                    a += 1;
+                    float a = ElementToFloat(A[(TransA == CblasNoTrans) ? (m * lda + k) : (k * lda + m)]);
+                    float b = ElementToFloat(B[(TransB == CblasNoTrans) ? (k * ldb + n) : (n * ldb + k)]);
+                    sum += a * b;
                 }
 
-                *c = sum;
+                CReference[m * N + n] = (beta != 0.0f) ? (alpha * sum + beta * -0.5f) : (alpha * sum);
+            }
+        }
+
+        if (Bf16) {
+            MlasBf16Gemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N, threadpool);
+        } else {
+            MlasHalfGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N, threadpool);
+        }
+
+        //
+        // The output is rounded to the element type, so compare relative to
+        // the precision of the element type.
+        //
+
+        const float Epsilon = Bf16 ? (1.0f / 128.0f) : (1.0f / 1024.0f);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (!(std::fabs(ElementToFloat(C[f]) - CReference[f]) <= Epsilon * (std::fabs(CReference[f]) + 1.0f))) {
+                printf("mismatch %s TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n",
+                    Bf16 ? "BF16" : "FP16", TransA, TransB, M, N, K, alpha, beta);
+                break;
             }
         }
     }
 
-    MatrixGuardBuffer<uint8_t> BufferA;
-    MatrixGuardBuffer<uint8_t> BufferB;
-    MatrixGuardBuffer<int32_t> BufferC;
-    MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<uint16_t> BufferA;
+    MatrixGuardBuffer<uint16_t> BufferB;
+    MatrixGuardBuffer<uint16_t> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
 
 public:
     void
@@ -550,14 +712,15 @@ public:
         ) override
     {
         for (size_t b = 1; b < 16; b++) {
-            Test(b, b, b, 14, 211);
+            Test(b, b, b, 1.0f, 0.0f);
         }
         for (size_t b = 16; b <= 256; b <<= 1) {
-            Test(b, b, b, 34, 1);
-        }
-        for (size_t b = 256; b < 320; b += 32) {
-            Test(b, b, b, 85, 173);
+            Test(b, b, b, 1.0f, 0.0f);
         }
+        Test(1, 300, 257, 1.0f, 0.0f);
+        Test(67, 33, 129, 0.5f, 1.0f);
+        Test(130, 131, 17, -1.0f, 0.25f);
+        Test(33, 145, 0, 1.0f, 1.0f);
     }
 
     void
@@ -565,320 +728,247 @@ public:
         void
         ) override
     {
-        static const uint8_t zero_points[] = { 0, 18, 128, 157, 231, 255 };
-
-        for (size_t a = 0; a < _countof(zero_points); a++) {
-            uint8_t offa = zero_points[a];
-
-            for (size_t b = 0; b < _countof(zero_points); b++) {
-                uint8_t offb = zero_points[b];
-
-                for (size_t M = 16; M < 160; M += 32) {
-                    for (size_t N = 16; N < 160; N += 32) {
-
-                        static const size_t ks[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 20, 32, 48, 64, 118, 119, 120, 121, 122, 160, 240, 320 };
-                        for (size_t k = 0; k < _countof(ks); k++) {
-                            size_t K = ks[k];
+        static const float multipliers[] = { 0.0f, -0.0f, 0.25f, -0.5f, 1.0f, -1.0f };
 
-                            Test(M, N, K, offa, offb);
-                            Test(M + 1, N, K, offa, offb);
-                            Test(M, N + 1, K, offa, offb);
-                            Test(M + 1, N + 1, K, offa, offb);
-                            Test(M + 3, N + 2, K, offa, offb);
-                            Test(M + 4, N, K, offa, offb);
-                            Test(M, N + 4, K, offa, offb);
-                            Test(M + 4, N + 4, K, offa, offb);
-                            Test(M + 3, N + 7, K, offa, offb);
-                            Test(M + 8, N, K, offa, offb);
-                            Test(M, N + 8, K, offa, offb);
-                            Test(M + 12, N + 12, K, offa, offb);
-                            Test(M + 13, N, K, offa, offb);
-                            Test(M, N + 15, K, offa, offb);
-                            Test(M + 15, N + 15, K, offa, offb);
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 80; M += 7) {
+                    for (size_t N = 1; N < 300; N += 37) {
+                        for (size_t K = 1; K < 300; K += 43) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
                         }
                     }
-                    printf("a %zd/%zd b %zd/%zd M %zd\n", a, _countof(zero_points), b, _countof(zero_points), M);
-                }
-            }
-        }
-
-        for (size_t M = 1; M < 160; M++) {
-            for (size_t N = 1; N < 160; N++) {
-                for (size_t K = 1; K < 160; K++) {
-                    Test(M, N, K, 18, 24);
-                }
-            }
-            printf("M %zd\n", M);
-        }
-
-        for (size_t M = 160; M < 320; M += 24) {
-            for (size_t N = 112; N < 320; N += 24) {
-                for (size_t K = 1; K < 16; K++) {
-                    Test(M, N, K, 1, 3);
-                }
-                for (size_t K = 16; K < 160; K += 32) {
-                    Test(M, N, K, 5, 7);
                 }
             }
-            printf("M %zd\n", M);
         }
     }
 };
 
-#endif
-
-class MlasConv2DTest : public MlasTestBase
+class MlasHalfConversionTest : public MlasTestBase
 {
-protected:
+private:
+    MatrixGuardBuffer<uint16_t> BufferHalf;
+    MatrixGuardBuffer<float> BufferFloat;
+    MatrixGuardBuffer<uint16_t> BufferHalfOutput;
+
     void
     Test(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth
+        size_t Count
         )
     {
-        int64_t OutputHeight64 =
-            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
-            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
-        int64_t OutputWidth64 =
-            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
-            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+        //
+        // Every half precision value converts exactly to single precision and
+        // back, except NaNs, which stay NaNs.
+        //
 
-        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
-            return;
+        uint16_t* Half = BufferHalf.GetBuffer(Count);
+        float* Float = BufferFloat.GetBuffer(Count);
+        uint16_t* HalfOutput = BufferHalfOutput.GetBuffer(Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            Half[i] = uint16_t(i * 40503);
         }
 
-        size_t OutputHeight = size_t(OutputHeight64);
-        size_t OutputWidth = size_t(OutputWidth64);
+        MlasConvertHalfToFloatBuffer(Half, Float, Count);
+        MlasConvertFloatToHalfBuffer(Float, HalfOutput, Count);
 
-        size_t InputSize = InputHeight * InputWidth;
-        size_t KernelSize = KernelHeight * KernelWidth;
-        size_t OutputSize = OutputHeight * OutputWidth;
+        for (size_t i = 0; i < Count; i++) {
+            const bool IsNan = (Half[i] & 0x7C00) == 0x7C00 && (Half[i] & 0x3FF) != 0;
+            if (IsNan ? !std::isnan(Float[i]) || (HalfOutput[i] & 0x7FFF) <= 0x7C00 : HalfOutput[i] != Half[i]) {
+                printf("mismatch HalfConversion: Count=%zd, value=%04x!\n", Count, unsigned(Half[i]));
+                return;
+            }
+        }
+    }
 
-        size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
-        size_t FilterElements = GroupCount * FilterCount * InputChannels * KernelSize;
-        size_t BiasElements = GroupCount * FilterCount;
-        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
-
-        const float* Input = BufferInput.GetBuffer(InputElements);
-        const float* Filter = BufferFilter.GetBuffer(FilterElements);
-        const float* Bias = BufferBias.GetBuffer(BiasElements);
-        float* Output = BufferOutput.GetBuffer(OutputElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+    void
+    TestRounding(
+        void
+        )
+    {
+        //
+        // The single precision values are halfway between, or just above
+        // halfway between, two half precision values, or overflow.
+        //
 
-        MlasConv2D(BatchCount,
-                   GroupCount,
-                   InputChannels,
-                   InputHeight, InputWidth,
-                   FilterCount,
-                   KernelHeight, KernelWidth,
-                   PaddingLeftHeight, PaddingLeftWidth,
-                   PaddingRightHeight, PaddingRightWidth,
-                   DilationHeight, DilationWidth,
-                   StrideHeight, StrideWidth,
-                   OutputHeight, OutputWidth,
-                   Input,
-                   Filter,
-                   Bias,
-                   Output);
+        static const float Values[] = { 1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 1.0f + 1.0f / 2048.0f + 1.0f / 65536.0f,
+            -2049.0f, 65504.0f, 65520.0f, 1.0e10f, 5.9604645e-8f, 2.9802322e-8f };
+        static const uint16_t Expected[] = { 0x3C00, 0x3C02, 0x3C01, 0xE800, 0x7BFF, 0x7C00, 0x7C00, 0x0001, 0x0000 };
 
-        ReferenceConv2D(BatchCount,
-                        GroupCount,
-                        InputChannels,
-                        InputHeight, InputWidth,
-                        FilterCount,
-                        KernelHeight, KernelWidth,
-                        PaddingLeftHeight, PaddingLeftWidth,
-                        DilationHeight, DilationWidth,
-                        StrideHeight, StrideWidth,
-                        OutputHeight, OutputWidth,
-                        Input,
-                        Filter,
-                        Bias,
-                        OutputReference);
+        uint16_t HalfOutput[_countof(Values)];
+        MlasConvertFloatToHalfBuffer(Values, HalfOutput, _countof(Values));
 
-        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
-            printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
-                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
-                KernelHeight, KernelWidth);
+        for (size_t i = 0; i < _countof(Values); i++) {
+            if (HalfOutput[i] != Expected[i]) {
+                printf("mismatch HalfConversion rounding: value=%g, expected=%04x, actual=%04x!\n",
+                    Values[i], unsigned(Expected[i]), unsigned(HalfOutput[i]));
+            }
         }
     }
 
-    virtual
+public:
     void
-    MlasConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
-        )
+    ExecuteShort(
+        void
+        ) override
     {
-        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
-
-        MLAS_ACTIVATION Activation;
-        Activation.ActivationKind = MlasIdentityActivation;
+        for (size_t Count = 1; Count < 40; Count++) {
+            Test(Count);
+        }
+        Test(65536);
+        TestRounding();
+    }
 
-        MLAS_CONV_PARAMETERS Parameters;
-        size_t WorkingBufferSize;
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-        MlasConvPrepare(&Parameters,
-                        2,
-                        BatchCount,
-                        GroupCount,
-                        InputChannels,
-                        InputShape,
-                        KernelShape,
-                        DilationShape,
-                        Padding,
-                        StrideShape,
-                        OutputShape,
-                        FilterCount,
-                        &Activation,
-                        &WorkingBufferSize,
-                        nullptr);
+class MlasSparseGemmTest : public MlasTestBase
+{
+private:
+    //
+    // The test values are small multiples of 1/4, so the sums are exact in
+    // any order and the results are compared exactly.
+    //
 
-        MlasConv(&Parameters,
-                 Input,
-                 Filter,
-                 Bias,
-                 BufferWorking.GetBuffer(WorkingBufferSize),
-                 Output,
-                 nullptr);
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        Test(CblasNoTrans, CblasNoTrans, M, N, K, alpha, beta);
+        Test(CblasNoTrans, CblasTrans, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasNoTrans, M, N, K, alpha, beta);
+        Test(CblasTrans, CblasTrans, M, N, K, alpha, beta);
     }
 
     void
-    ReferenceConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
         )
     {
-        size_t InputSize = InputHeight * InputWidth;
-        size_t OutputSize = OutputHeight * OutputWidth;
-        size_t KernelSize = KernelHeight * KernelWidth;
+        float* A = BufferA.GetBuffer(M * K);
+        float* B = BufferB.GetBuffer(K * N);
+        float* C = BufferC.GetBuffer(M * N);
+        float* CReference = BufferCReference.GetBuffer(M * N);
+        float* ColumnBias = BufferColumnBias.GetBuffer(N);
+        float* RowBias = BufferRowBias.GetBuffer(M);
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float(int(i % 7) - 3) * 0.25f;
+        }
 
-        size_t K = InputChannels * KernelSize;
-        size_t Im2ColElements = OutputSize * K;
+        //
+        // About one element in eight of matrix B is nonzero.
+        //
 
-        for (size_t b = 0; b < BatchCount; b++) {
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = (i % 8 == 3) ? float(int(i % 5) - 2) * 0.5f : 0.0f;
+        }
 
-            const float* filter = Filter;
-            const float* bias = Bias;
+        for (size_t n = 0; n < N; n++) {
+            ColumnBias[n] = float(int(n % 3) - 1) * 0.5f;
+        }
 
-            for (size_t g = 0; g < GroupCount; g++) {
+        for (size_t m = 0; m < M; m++) {
+            RowBias[m] = float(int(m % 5) - 2) * 0.25f;
+        }
 
-                //
-                // Transform the image using IM2COL and invoke the GEMM.
-                //
+        const size_t lda = (TransA == CblasNoTrans) ? K : M;
+        const size_t ldb = (TransB == CblasNoTrans) ? N : K;
 
-                float* Im2Col = BufferIm2Col.GetBuffer(Im2ColElements);
-                float* Im2ColOut = Im2Col;
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
 
-                for (size_t c = 0; c < InputChannels; c++) {
+                float sum = 0.0f;
 
-                    for (size_t ky = 0; ky < KernelHeight; ky++) {
+                for (size_t k = 0; k < K; k++) {
+                    float a = A[(TransA == CblasNoTrans) ? (m * lda + k) : (k * lda + m)];
+                    float b = B[(TransB == CblasNoTrans) ? (k * ldb + n) : (n * ldb + k)];
+                    sum += a * b;
+                }
 
-                        for (size_t kx = 0; kx < KernelWidth; kx++) {
+                CReference[m * N + n] = (beta != 0.0f) ? (alpha * sum + beta * -0.5f) : (alpha * sum);
+            }
+        }
 
-                            for (size_t oh = 0; oh < OutputHeight; oh++) {
+        const size_t PackedBSize = MlasSparsePackBSize(TransB, N, K, B, ldb);
 
-                                size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingLeftHeight;
+        if (PackedBSize == 0) {
+            printf("sparse pack failed TransB=%d, N=%zd, K=%zd!\n", TransB, N, K);
+            return;
+        }
 
-                                for (size_t ow = 0; ow < OutputWidth; ow++) {
+        void* PackedB = BufferBPacked.GetBuffer((PackedBSize + sizeof(float) - 1) / sizeof(float));
 
-                                    size_t iw = ow * StrideWidth + kx * DilationWidth - PaddingLeftWidth;
+        MlasSparsePackB(TransB, N, K, B, ldb, PackedB);
 
-                                    *Im2ColOut++ = (ih < InputHeight && iw < InputWidth) ?
-                                        Input[ih * InputWidth + iw] : 0;
-                                }
-                            }
-                        }
-                    }
+        std::fill_n(C, M * N, -0.5f);
 
-                    Input += InputSize;
-                }
+        MlasSgemmSparse(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool);
 
-                MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
-                    filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, threadpool);
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch sparse TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n",
+                    TransA, TransB, M, N, K, alpha, beta);
+                break;
+            }
+        }
 
-                //
-                // Apply the bias.
-                //
+        //
+        // Repeat the operation with the bias vectors and the activation
+        // applied by the epilogue.
+        //
 
-                for (size_t f = 0; f < FilterCount; f++) {
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
 
-                    float biasValue = *bias++;
+        MLAS_SGEMM_EPILOGUE Epilogue;
+        Epilogue.ColumnBias = ColumnBias;
+        Epilogue.RowBias = RowBias;
+        Epilogue.Activation = &Activation;
 
-                    for (size_t o = 0; o < OutputSize; o++) {
-                        *Output++ += biasValue;
-                    }
-                }
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float Value = CReference[m * N + n] + ColumnBias[n];
+                CReference[m * N + n] = (std::max)(Value + RowBias[m], 0.0f);
+            }
+        }
 
-                filter += FilterCount * InputChannels * KernelSize;
+        std::fill_n(C, M * N, -0.5f);
+
+        MlasSgemmSparse(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool, &Epilogue);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch sparse epilogue TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n",
+                    TransA, TransB, M, N, K, alpha, beta);
+                break;
             }
         }
     }
 
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferFilter;
-    MatrixGuardBuffer<float> BufferBias;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
-    MatrixGuardBuffer<float> BufferWorking;
-    MatrixGuardBuffer<float> BufferIm2Col;
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBPacked;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+    MatrixGuardBuffer<float> BufferColumnBias;
+    MatrixGuardBuffer<float> BufferRowBias;
 
 public:
     void
@@ -886,62 +976,38 @@ public:
         void
         ) override
     {
-        for (unsigned i = 1; i < 256; i <<= 1) {
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
-            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
-            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
-    }
-
+        //
+        // A dense matrix B isn't packed.
+        //
+
+        const float Dense[] = { 1.0f, 2.0f, 0.0f, 4.0f, 5.0f, 6.0f };
+
+        if (MlasSparsePackBSize(CblasNoTrans, 3, 2, Dense, 3) != 0) {
+            printf("sparse pack of a dense matrix!\n");
+        }
+
+        for (size_t b = 8; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        Test(1, 300, 257, 1.0f, 0.0f);
+        Test(5, 64, 128, 0.5f, 1.0f);
+        Test(67, 33, 129, 0.5f, 1.0f);
+        Test(130, 131, 17, -1.0f, 0.25f);
+    }
+
     void
     ExecuteLong(
         void
         ) override
     {
-        static const unsigned cs[] = { 32, 14, 1 };
-        static const unsigned is[] = { 53, 11, 5, 1 };
-
-        for (unsigned i = 1; i <= 32; i++) {
-            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
-
-        for (unsigned b = 1; b < 64; b++) {
-            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
+        static const float multipliers[] = { 0.0f, 0.25f, -0.5f, 1.0f, -1.0f };
 
-        for (unsigned ic = 0; ic < _countof(cs); ic++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", cs[ic], is[ih], is[iw]);
-                    for (unsigned fc = 0; fc < _countof(cs); fc++) {
-                        for (unsigned kh = 1; kh <= 5; kh++) {
-                            if (kh == 4) continue;
-                            for (unsigned kw = 1; kw <= 5; kw++) {
-                                if (kw == 4) continue;
-                                for (unsigned p0 = 0; p0 < 2; p0++) {
-                                    for (unsigned p1 = 0; p1 < 2; p1++) {
-                                        for (unsigned p2 = 0; p2 < 2; p2++) {
-                                            for (unsigned p3 = 0; p3 < 2; p3++) {
-                                                for (unsigned dh = 1; dh <= 2; dh++) {
-                                                    for (unsigned dw = 1; dw <= 2; dw++) {
-                                                        for (unsigned sh = 1; sh <= 2; sh++) {
-                                                            for (unsigned sw = 1; sw <= 2; sw++) {
-                                                                Test(1, 1, cs[ic], is[ih], is[iw], cs[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 80; M += 7) {
+                    for (size_t N = 8; N < 300; N += 37) {
+                        for (size_t K = 8; K < 300; K += 43) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
                         }
                     }
                 }
@@ -950,251 +1016,428 @@ public:
     }
 };
 
-class MlasNchwcConv2DTest : public MlasConv2DTest
+class MlasBlockQuantGemmTest : public MlasTestBase
 {
-protected:
+private:
+    //
+    // The first row of each block of matrix B is the largest quantized value
+    // times 1/4, so the scales are exactly 1/4 and the quantization is exact.
+    // The values of matrix A are small multiples of 1/4, so the sums are
+    // exact in any order and the results are compared exactly.
+    //
+
     void
-    MlasConv2D(
-        size_t BatchCount,
-        size_t GroupCount,
-        size_t InputChannels,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t FilterCount,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t DilationHeight,
-        size_t DilationWidth,
-        size_t StrideHeight,
-        size_t StrideWidth,
-        size_t OutputHeight,
-        size_t OutputWidth,
-        const float* Input,
-        const float* Filter,
-        const float* Bias,
-        float* Output
-        ) override
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        size_t Bits,
+        size_t BlockSize,
+        bool UseBias
+        )
     {
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(GroupCount * InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t FilterShape[] = { int64_t(GroupCount * FilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(GroupCount * FilterCount), int64_t(OutputHeight), int64_t(OutputWidth) };
-
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-
-        //
-        // Select the type of convolution that will be performed.
-        //
-
-        bool DoReorderInput;
-        bool ReorderFilterOIHWBo;
-
-        if (GroupCount > 1 && InputChannels == 1 && FilterCount == 1) {
-            // Depthwise convolution.
-            DoReorderInput = true;
-            ReorderFilterOIHWBo = true;
-        } else if (InputChannels >= BlockSize) {
-            // NCHWc or pointwise convolution;
-            DoReorderInput = true;
-            ReorderFilterOIHWBo = false;
-        } else {
-            // NCHW convolution.
-            DoReorderInput = false;
-            ReorderFilterOIHWBo = true;
+        const size_t BlockCount = (K + BlockSize - 1) / BlockSize;
+        const int32_t MaximumValue = (int32_t(1) << (Bits - 1)) - 1;
+
+        float* A = BufferA.GetBuffer(M * K);
+        float* B = BufferB.GetBuffer(K * N);
+        uint8_t* QuantB = BufferQuantB.GetBuffer(N * BlockCount * BlockSize * Bits / 8);
+        float* Scales = BufferScales.GetBuffer(N * BlockCount);
+        float* Bias = BufferBias.GetBuffer(N);
+        float* C = BufferC.GetBuffer(M * N);
+        float* CReference = BufferCReference.GetBuffer(M * N);
+
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float(int(i % 7) - 3) * 0.25f;
         }
 
-        size_t NchwcInputChannels = (GroupCount * InputChannels + BlockSize - 1) & ~(BlockSize - 1);
-        size_t NchwcOutputChannels = (GroupCount * FilterCount + BlockSize - 1) & ~(BlockSize - 1);
-
-        //
-        // Reorder the filter buffer as needed.
-        //
-
-        float* ReorderedFilter;
-
-        if (ReorderFilterOIHWBo) {
-            size_t NchwcFilterElements = NchwcOutputChannels * InputChannels * KernelHeight * KernelWidth;
-            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
-            MlasReorderFilterOIHWBo(FilterShape, Filter, ReorderedFilter);
-        } else {
-            size_t NchwcFilterElements = NchwcOutputChannels * NchwcInputChannels * KernelHeight * KernelWidth;
-            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
-            MlasReorderFilterOIHWBiBo(FilterShape, Filter, ReorderedFilter);
+        for (size_t k = 0; k < K; k++) {
+            for (size_t n = 0; n < N; n++) {
+                const int32_t Value = (k % BlockSize == 0) ? ((n % 2 == 0) ? MaximumValue : -MaximumValue) :
+                    int32_t((k * 31 + n * 17) % (2 * MaximumValue + 1)) - MaximumValue;
+                B[k * N + n] = float(Value) * 0.25f;
+            }
         }
 
-        //
-        // Align the bias buffer to the filter count if needed.
-        //
-
-        if (Bias != nullptr && GroupCount * FilterCount < NchwcOutputChannels) {
+        for (size_t n = 0; n < N; n++) {
+            Bias[n] = float(int(n % 5) - 2) * 0.5f;
+        }
 
-            float* AlignedBias = BufferNchwcBias.GetBuffer(NchwcOutputChannels);
+        MlasQuantizeBlockwise(N, K, Bits, BlockSize, B, N, QuantB, Scales);
 
-            size_t i;
-            for (i = 0; i < GroupCount * FilterCount; i++) {
-                AlignedBias[i] = Bias[i];
-            }
-            for (; i < NchwcOutputChannels; i++) {
-                AlignedBias[i] = 0.0f;
+        for (size_t i = 0; i < N * BlockCount; i++) {
+            if (Scales[i] != 0.25f) {
+                printf("mismatch block quantize scale: N=%zd, K=%zd, Bits=%zd, BlockSize=%zd!\n", N, K, Bits, BlockSize);
+                return;
             }
-
-            Bias = AlignedBias;
         }
 
-        //
-        // Reorder the input buffer if needed.
-        //
-
-        if (DoReorderInput) {
-            size_t NchwcInputElements = BatchCount * NchwcInputChannels * InputHeight * InputWidth;
-            float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
-            MlasReorderInput(InputShape, Input, NchwcInput);
-            Input = NchwcInput;
-            InputShape[1] = NchwcInputChannels;
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float sum = UseBias ? Bias[n] : 0.0f;
+                for (size_t k = 0; k < K; k++) {
+                    sum += A[m * K + k] * B[k * N + n];
+                }
+                CReference[m * N + n] = sum;
+            }
         }
 
-        int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcOutputChannels), int64_t(OutputHeight), int64_t(OutputWidth) };
+        const size_t PackedBSize = MlasBlockQuantGemmPackBSize(N, K, Bits, BlockSize);
 
-        size_t NchwcOutputElements = BatchCount * NchwcOutputChannels * OutputHeight * OutputWidth;
-        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+        void* PackedB = BufferBPacked.GetBuffer((PackedBSize + sizeof(float) - 1) / sizeof(float));
 
-        MLAS_ACTIVATION Activation;
-        Activation.ActivationKind = MlasIdentityActivation;
+        MlasBlockQuantGemmPackB(N, K, Bits, BlockSize, QuantB, Scales, PackedB);
 
-        MlasNchwcConv(2,
-                      InputShape,
-                      KernelShape,
-                      DilationShape,
-                      Padding,
-                      StrideShape,
-                      NchwcOutputShape,
-                      GroupCount,
-                      Input,
-                      ReorderedFilter,
-                      Bias,
-                      NchwcOutput,
-                      &Activation,
-                      true,
-                      nullptr);
+        std::fill_n(C, M * N, -0.5f);
 
-        //
-        // Reorder the output buffer.
-        //
+        MlasBlockQuantGemm(M, N, K, A, K, PackedB, UseBias ? Bias : nullptr, C, N, threadpool);
 
-        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch block quant gemm: M=%zd, N=%zd, K=%zd, Bits=%zd, BlockSize=%zd, Bias=%d!\n",
+                    M, N, K, Bits, BlockSize, int(UseBias));
+                break;
+            }
+        }
     }
 
-    const size_t BlockSize = MlasNchwcGetBlockSize();
-
-    MatrixGuardBuffer<float> BufferNchwcInput;
-    MatrixGuardBuffer<float> BufferNchwcFilter;
-    MatrixGuardBuffer<float> BufferNchwcBias;
-    MatrixGuardBuffer<float> BufferNchwcOutput;
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferQuantB;
+    MatrixGuardBuffer<float> BufferScales;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferBPacked;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
 
 public:
     void
-    ExecuteLong(
+    ExecuteShort(
         void
         ) override
     {
-        // N.B. InputChannels must be a multiple of 4 if the count is greater
-        // than the block size.
-        static const unsigned cis[] = { 32, 20, 5, 1 };
-        static const unsigned cos[] = { 64, 15, 1 };
-        static const unsigned is[] = { 27, 11, 5, 1 };
-
-        // Depthwise convolutions.
-        for (unsigned i = 16; i < 256; i <<= 1) {
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, i, 1, 28, 28, 1, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(12, i, 1, 11, 11, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+        if (MlasBlockQuantGemmPackBSize(16, 16, 3, 16) != 0 || MlasBlockQuantGemmPackBSize(16, 16, 4, 15) != 0) {
+            printf("block quant gemm pack of unsupported parameters!\n");
         }
 
-        // Test varying FilterCounts.
-        for (unsigned i = 1; i < 128; i++) {
-            Test(1, 1, 3, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(1, 1, 16, 34, 34, i, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        for (size_t Bits = 4; Bits <= 8; Bits += 4) {
+            Test(1, 16, 16, Bits, 16, false);
+            Test(1, 300, 257, Bits, 32, true);
+            Test(3, 33, 129, Bits, 64, true);
+            Test(4, 64, 128, Bits, 128, false);
+            Test(5, 64, 100, Bits, 32, true);
+            Test(67, 131, 65, Bits, 16, true);
         }
+    }
 
-        for (unsigned i = 1; i <= 32; i++) {
-            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
-            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t Bits = 4; Bits <= 8; Bits += 4) {
+            for (size_t BlockSize = 16; BlockSize <= 128; BlockSize <<= 1) {
+                for (size_t M = 1; M < 20; M += 3) {
+                    for (size_t N = 1; N < 300; N += 37) {
+                        for (size_t K = 1; K < 300; K += 43) {
+                            Test(M, N, K, Bits, BlockSize, (N % 2) != 0);
+                        }
+                    }
+                }
+            }
         }
+    }
+};
 
-        for (unsigned b = 1; b < 64; b++) {
-            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
-        }
+#ifdef MLAS_HAS_QGEMM_U8U8
 
-        for (unsigned ic = 0; ic < _countof(cis); ic++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", cis[ic], is[ih], is[iw]);
-                    for (unsigned fc = 0; fc < _countof(cos); fc++) {
-                        for (unsigned kh = 1; kh <= 5; kh++) {
-                            if (kh == 4) continue;
-                            for (unsigned kw = 1; kw <= 5; kw++) {
-                                if (kw == 4) continue;
-                                for (unsigned p0 = 0; p0 <= 3; p0++) {
-                                    for (unsigned p1 = 0; p1 <= 3; p1++) {
-                                        for (unsigned p2 = 0; p2 <= 3; p2++) {
-                                            for (unsigned p3 = 0; p3 <= 3; p3++) {
-                                                for (unsigned dh = 1; dh <= 2; dh++) {
-                                                    for (unsigned dw = 1; dw <= 2; dw++) {
-                                                        for (unsigned sh = 1; sh <= 2; sh++) {
-                                                            for (unsigned sw = 1; sw <= 2; sw++) {
-                                                                Test(1, 1, cis[ic], is[ih], is[iw], cos[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+class MlasQgemmU8U8Test : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        uint8_t offb
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M);
+        const uint8_t* B = BufferB.GetBuffer(N * K);
+        int32_t* C = BufferC.GetBuffer(N * M);
+        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+
+        Test(M, N, K, A, K, offa, B, N, offb, C, CReference, N);
+    }
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        const uint8_t* A,
+        size_t lda,
+        uint8_t offa,
+        const uint8_t* B,
+        size_t ldb,
+        uint8_t offb,
+        int32_t* C,
+        int32_t* CReference,
+        size_t ldc
+        )
+    {
+        std::fill_n(C, M * N, -1);
+        std::fill_n(CReference, M * N, -1);
+
+        MlasQgemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, threadpool);
+        ReferenceQgemm(M, N, K, A, lda, offa, B, ldb, offb, CReference, ldc);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+            }
+        }
+
+        //
+        // Repeat the operation through MlasGemm for signed inputs, per column
+        // zero point offsets, and matrix B packed in advance.
+        //
+
+        for (int i = 0; i < 16; i++) {
+
+            MLAS_GEMM_U8X8_PARAMETERS Parameters;
+
+            Parameters.M = M;
+            Parameters.N = N;
+            Parameters.K = K;
+            Parameters.A = A;
+            Parameters.lda = lda;
+            Parameters.ZeroPointA = offa;
+            Parameters.AIsSigned = (i & 1) != 0;
+            Parameters.B = B;
+            Parameters.ldb = ldb;
+            Parameters.BIsSigned = (i & 2) != 0;
+            Parameters.PerColumnZeroPoints = (i & 4) != 0;
+            Parameters.C = C;
+            Parameters.ldc = ldc;
+
+            uint8_t* ZeroPointB = BufferZeroPointB.GetBuffer(N);
+
+            for (size_t n = 0; n < N; n++) {
+                ZeroPointB[n] = Parameters.PerColumnZeroPoints ? uint8_t(offb + n * 7) : offb;
+            }
+
+            Parameters.ZeroPointB = ZeroPointB;
+
+            if ((i & 8) != 0) {
+
+                uint8_t* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K, Parameters.BIsSigned));
+
+                MlasGemmPackB(N, K, B, ldb, Parameters.BIsSigned, PackedB);
+
+                Parameters.B = PackedB;
+                Parameters.BIsPacked = true;
+            }
+
+            std::fill_n(C, M * N, -1);
+            std::fill_n(CReference, M * N, -1);
+
+            MlasGemm(&Parameters, threadpool);
+            ReferenceGemm(Parameters, B, CReference);
+
+            for (size_t f = 0; f < M * N; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d, AIsSigned=%d, BIsSigned=%d, BIsPacked=%d, PerColumnZeroPoints=%d!\n",
+                        M, N, K, offa, offb, Parameters.AIsSigned, Parameters.BIsSigned, Parameters.BIsPacked, Parameters.PerColumnZeroPoints);
+                    break;
+                }
+            }
+        }
+    }
+
+    void
+    ReferenceGemm(
+        const MLAS_GEMM_U8X8_PARAMETERS& Parameters,
+        const uint8_t* B,
+        int32_t* C
+        )
+    {
+        auto ValueA = [&](uint8_t v) { return Parameters.AIsSigned ? int32_t(int8_t(v)) : int32_t(v); };
+        auto ValueB = [&](uint8_t v) { return Parameters.BIsSigned ? int32_t(int8_t(v)) : int32_t(v); };
+
+        const int32_t offa = ValueA(Parameters.ZeroPointA);
+
+        for (size_t m = 0; m < Parameters.M; m++) {
+
+            for (size_t n = 0; n < Parameters.N; n++) {
+
+                const uint8_t* a = Parameters.A + (m * Parameters.lda);
+                const uint8_t* b = B + n;
+                int32_t* c = C + (m * Parameters.ldc) + n;
+                int32_t offb = ValueB(Parameters.ZeroPointB[Parameters.PerColumnZeroPoints ? n : 0]);
+                int32_t sum = 0;
+
+                for (size_t k = 0; k < Parameters.K; k++) {
+                    sum += ((ValueB(*b) - offb) * (ValueA(*a) - offa));
+                    b += Parameters.ldb;
+                    a += 1;
+                }
+
+                *c = sum;
+            }
+        }
+    }
+
+    void
+    ReferenceQgemm(
+        size_t M,
+        size_t N,
+        size_t K,
+        const uint8_t* A,
+        size_t lda,
+        uint8_t offa,
+        const uint8_t* B,
+        size_t ldb,
+        uint8_t offb,
+        int32_t* C,
+        size_t ldc
+        )
+    {
+        for (size_t m = 0; m < M; m++) {
+
+            for (size_t n = 0; n < N; n++) {
+
+                const uint8_t* a = A + (m * lda);
+                const uint8_t* b = B + n;
+                int32_t* c = C + (m * ldc) + n;
+                int32_t sum = 0;
+
+                for (size_t k = 0; k < K; k++) {
+                    sum += ((int32_t(*b) - offb) * (int32_t(*a) - offa));
+                    b += ldb;
+                    a += 1;
+                }
+
+                *c = sum;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<uint8_t> BufferA;
+    MatrixGuardBuffer<uint8_t> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferBPacked;
+    MatrixGuardBuffer<uint8_t> BufferZeroPointB;
+    MatrixGuardBuffer<int32_t> BufferC;
+    MatrixGuardBuffer<int32_t> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 14, 211);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 34, 1);
+        }
+        for (size_t b = 256; b < 320; b += 32) {
+            Test(b, b, b, 85, 173);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const uint8_t zero_points[] = { 0, 18, 128, 157, 231, 255 };
+
+        for (size_t a = 0; a < _countof(zero_points); a++) {
+            uint8_t offa = zero_points[a];
+
+            for (size_t b = 0; b < _countof(zero_points); b++) {
+                uint8_t offb = zero_points[b];
+
+                for (size_t M = 16; M < 160; M += 32) {
+                    for (size_t N = 16; N < 160; N += 32) {
+
+                        static const size_t ks[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 20, 32, 48, 64, 118, 119, 120, 121, 122, 160, 240, 320 };
+                        for (size_t k = 0; k < _countof(ks); k++) {
+                            size_t K = ks[k];
+
+                            Test(M, N, K, offa, offb);
+                            Test(M + 1, N, K, offa, offb);
+                            Test(M, N + 1, K, offa, offb);
+                            Test(M + 1, N + 1, K, offa, offb);
+                            Test(M + 3, N + 2, K, offa, offb);
+                            Test(M + 4, N, K, offa, offb);
+                            Test(M, N + 4, K, offa, offb);
+                            Test(M + 4, N + 4, K, offa, offb);
+                            Test(M + 3, N + 7, K, offa, offb);
+                            Test(M + 8, N, K, offa, offb);
+                            Test(M, N + 8, K, offa, offb);
+                            Test(M + 12, N + 12, K, offa, offb);
+                            Test(M + 13, N, K, offa, offb);
+                            Test(M, N + 15, K, offa, offb);
+                            Test(M + 15, N + 15, K, offa, offb);
                         }
                     }
+                    printf("a %zd/%zd b %zd/%zd M %zd\n", a, _countof(zero_points), b, _countof(zero_points), M);
                 }
             }
         }
-    }
 
+        for (size_t M = 1; M < 160; M++) {
+            for (size_t N = 1; N < 160; N++) {
+                for (size_t K = 1; K < 160; K++) {
+                    Test(M, N, K, 18, 24);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+
+        for (size_t M = 160; M < 320; M += 24) {
+            for (size_t N = 112; N < 320; N += 24) {
+                for (size_t K = 1; K < 16; K++) {
+                    Test(M, N, K, 1, 3);
+                }
+                for (size_t K = 16; K < 160; K += 32) {
+                    Test(M, N, K, 5, 7);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+    }
 };
 
-class MlasPool2DTest : public MlasTestBase
+#endif
+
+class MlasConv2DTest : public MlasTestBase
 {
 protected:
     void
     Test(
         size_t BatchCount,
+        size_t GroupCount,
         size_t InputChannels,
         size_t InputHeight,
         size_t InputWidth,
+        size_t FilterCount,
         size_t KernelHeight,
         size_t KernelWidth,
         size_t PaddingLeftHeight,
         size_t PaddingLeftWidth,
         size_t PaddingRightHeight,
         size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
         size_t StrideHeight,
         size_t StrideWidth
         )
     {
-        const size_t DilationHeight = 1;
-        const size_t DilationWidth = 1;
-
         int64_t OutputHeight64 =
             ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
             (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
@@ -1206,615 +1449,2247 @@ protected:
             return;
         }
 
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputHeight64, OutputWidth64 };
+        size_t OutputHeight = size_t(OutputHeight64);
+        size_t OutputWidth = size_t(OutputWidth64);
+
+        size_t InputSize = InputHeight * InputWidth;
+        size_t KernelSize = KernelHeight * KernelWidth;
+        size_t OutputSize = OutputHeight * OutputWidth;
+
+        size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+        size_t FilterElements = GroupCount * FilterCount * InputChannels * KernelSize;
+        size_t BiasElements = GroupCount * FilterCount;
+        size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+        const float* Input = BufferInput.GetBuffer(InputElements);
+        const float* Filter = BufferFilter.GetBuffer(FilterElements);
+        const float* Bias = BufferBias.GetBuffer(BiasElements);
+        float* Output = BufferOutput.GetBuffer(OutputElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        MlasConv2D(BatchCount,
+                   GroupCount,
+                   InputChannels,
+                   InputHeight, InputWidth,
+                   FilterCount,
+                   KernelHeight, KernelWidth,
+                   PaddingLeftHeight, PaddingLeftWidth,
+                   PaddingRightHeight, PaddingRightWidth,
+                   DilationHeight, DilationWidth,
+                   StrideHeight, StrideWidth,
+                   OutputHeight, OutputWidth,
+                   Input,
+                   Filter,
+                   Bias,
+                   Output);
+
+        ReferenceConv2D(BatchCount,
+                        GroupCount,
+                        InputChannels,
+                        InputHeight, InputWidth,
+                        FilterCount,
+                        KernelHeight, KernelWidth,
+                        PaddingLeftHeight, PaddingLeftWidth,
+                        DilationHeight, DilationWidth,
+                        StrideHeight, StrideWidth,
+                        OutputHeight, OutputWidth,
+                        Input,
+                        Filter,
+                        Bias,
+                        OutputReference);
+
+        bool Mismatch;
+
+        if (OutputIsApproximate) {
+
+            //
+            // The Winograd algorithm reassociates the products, so compare
+            // relative to the magnitude of the reference output.
+            //
+
+            float MaximumValue = 1.0f;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                MaximumValue = (std::max)(MaximumValue, std::fabs(OutputReference[i]));
+            }
+
+            Mismatch = false;
+
+            for (size_t i = 0; i < OutputElements; i++) {
+                if (!(std::fabs(Output[i] - OutputReference[i]) <= MaximumValue * 1e-4f)) {
+                    Mismatch = true;
+                    break;
+                }
+            }
+
+        } else {
+            Mismatch = (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0);
+        }
+
+        if (Mismatch) {
+            printf("mismatch: batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+                BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+                KernelHeight, KernelWidth);
+        }
+    }
+
+    virtual
+    void
+    MlasConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        )
+    {
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MLAS_CONV_PARAMETERS Parameters;
+        size_t WorkingBufferSize;
+
+        MlasConvPrepare(&Parameters,
+                        2,
+                        BatchCount,
+                        GroupCount,
+                        InputChannels,
+                        InputShape,
+                        KernelShape,
+                        DilationShape,
+                        Padding,
+                        StrideShape,
+                        OutputShape,
+                        FilterCount,
+                        &Activation,
+                        &WorkingBufferSize,
+                        nullptr);
+
+        //
+        // The Winograd algorithm requires the transformed filter.
+        //
+
+        OutputIsApproximate = (Parameters.Algorithm == MlasConvAlgorithmWinograd);
+
+        if (OutputIsApproximate) {
+            float* TransformedFilter = BufferFilterTransformed.GetBuffer(MlasConvWinogradFilterSize(&Parameters));
+            MlasConvWinogradTransformFilter(&Parameters, Filter, TransformedFilter);
+            Filter = TransformedFilter;
+        }
+
+        MlasConv(&Parameters,
+                 Input,
+                 Filter,
+                 Bias,
+                 BufferWorking.GetBuffer(WorkingBufferSize),
+                 Output,
+                 nullptr);
+    }
+
+    void
+    ReferenceConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        )
+    {
+        size_t InputSize = InputHeight * InputWidth;
+        size_t OutputSize = OutputHeight * OutputWidth;
+        size_t KernelSize = KernelHeight * KernelWidth;
+
+        size_t K = InputChannels * KernelSize;
+        size_t Im2ColElements = OutputSize * K;
+
+        for (size_t b = 0; b < BatchCount; b++) {
+
+            const float* filter = Filter;
+            const float* bias = Bias;
+
+            for (size_t g = 0; g < GroupCount; g++) {
+
+                //
+                // Transform the image using IM2COL and invoke the GEMM.
+                //
+
+                float* Im2Col = BufferIm2Col.GetBuffer(Im2ColElements);
+                float* Im2ColOut = Im2Col;
+
+                for (size_t c = 0; c < InputChannels; c++) {
+
+                    for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+                        for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                            for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+                                size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingLeftHeight;
+
+                                for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+                                    size_t iw = ow * StrideWidth + kx * DilationWidth - PaddingLeftWidth;
+
+                                    *Im2ColOut++ = (ih < InputHeight && iw < InputWidth) ?
+                                        Input[ih * InputWidth + iw] : 0;
+                                }
+                            }
+                        }
+                    }
+
+                    Input += InputSize;
+                }
+
+                MlasSgemm(CblasNoTrans, CblasNoTrans, FilterCount, OutputSize, K, 1.0f,
+                    filter, K, Im2Col, OutputSize, 0.0f, Output, OutputSize, threadpool);
+
+                //
+                // Apply the bias.
+                //
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    float biasValue = *bias++;
+
+                    for (size_t o = 0; o < OutputSize; o++) {
+                        *Output++ += biasValue;
+                    }
+                }
+
+                filter += FilterCount * InputChannels * KernelSize;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferFilter;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferWorking;
+    MatrixGuardBuffer<float> BufferIm2Col;
+    MatrixGuardBuffer<float> BufferFilterTransformed;
+
+    bool OutputIsApproximate = false;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 256; i <<= 1) {
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
+            Test(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
+            Test(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 32, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 32, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+            Test(2, 16, 1, i, i, 2, 5, 5, 2, 2, 2, 2, 2, 2, 1, 1);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned cs[] = { 32, 14, 1 };
+        static const unsigned is[] = { 53, 11, 5, 1 };
+
+        for (unsigned i = 1; i <= 32; i++) {
+            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned b = 1; b < 64; b++) {
+            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned ic = 0; ic < _countof(cs); ic++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", cs[ic], is[ih], is[iw]);
+                    for (unsigned fc = 0; fc < _countof(cs); fc++) {
+                        for (unsigned kh = 1; kh <= 5; kh++) {
+                            if (kh == 4) continue;
+                            for (unsigned kw = 1; kw <= 5; kw++) {
+                                if (kw == 4) continue;
+                                for (unsigned p0 = 0; p0 < 2; p0++) {
+                                    for (unsigned p1 = 0; p1 < 2; p1++) {
+                                        for (unsigned p2 = 0; p2 < 2; p2++) {
+                                            for (unsigned p3 = 0; p3 < 2; p3++) {
+                                                for (unsigned dh = 1; dh <= 2; dh++) {
+                                                    for (unsigned dw = 1; dw <= 2; dw++) {
+                                                        for (unsigned sh = 1; sh <= 2; sh++) {
+                                                            for (unsigned sw = 1; sw <= 2; sw++) {
+                                                                Test(1, 1, cs[ic], is[ih], is[iw], cs[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasNchwcConv2DTest : public MlasConv2DTest
+{
+protected:
+    void
+    MlasConv2D(
+        size_t BatchCount,
+        size_t GroupCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t FilterCount,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        size_t OutputHeight,
+        size_t OutputWidth,
+        const float* Input,
+        const float* Filter,
+        const float* Bias,
+        float* Output
+        ) override
+    {
+        //
+        // The NCHWc layout has no grouped convolution with more than one
+        // filter for each single channel group, so use the NCHW convolution.
+        //
+
+        if (GroupCount > 1 && InputChannels == 1 && FilterCount > 1) {
+            MlasConv2DTest::MlasConv2D(BatchCount, GroupCount, InputChannels, InputHeight, InputWidth,
+                FilterCount, KernelHeight, KernelWidth, PaddingLeftHeight, PaddingLeftWidth,
+                PaddingRightHeight, PaddingRightWidth, DilationHeight, DilationWidth, StrideHeight,
+                StrideWidth, OutputHeight, OutputWidth, Input, Filter, Bias, Output);
+            return;
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(GroupCount * InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t FilterShape[] = { int64_t(GroupCount * FilterCount), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(GroupCount * FilterCount), int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+
+        //
+        // Select the type of convolution that will be performed.
+        //
+
+        bool DoReorderInput;
+        bool ReorderFilterOIHWBo;
+
+        if (GroupCount > 1 && InputChannels == 1 && FilterCount == 1) {
+            // Depthwise convolution.
+            DoReorderInput = true;
+            ReorderFilterOIHWBo = true;
+        } else if (InputChannels >= BlockSize) {
+            // NCHWc or pointwise convolution;
+            DoReorderInput = true;
+            ReorderFilterOIHWBo = false;
+        } else {
+            // NCHW convolution.
+            DoReorderInput = false;
+            ReorderFilterOIHWBo = true;
+        }
+
+        size_t NchwcInputChannels = (GroupCount * InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+        size_t NchwcOutputChannels = (GroupCount * FilterCount + BlockSize - 1) & ~(BlockSize - 1);
+
+        //
+        // Reorder the filter buffer as needed.
+        //
+
+        float* ReorderedFilter;
+
+        if (ReorderFilterOIHWBo) {
+            size_t NchwcFilterElements = NchwcOutputChannels * InputChannels * KernelHeight * KernelWidth;
+            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
+            MlasReorderFilterOIHWBo(FilterShape, Filter, ReorderedFilter);
+        } else {
+            size_t NchwcFilterElements = NchwcOutputChannels * NchwcInputChannels * KernelHeight * KernelWidth;
+            ReorderedFilter = BufferNchwcFilter.GetBuffer(NchwcFilterElements);
+            MlasReorderFilterOIHWBiBo(FilterShape, Filter, ReorderedFilter);
+        }
+
+        //
+        // Align the bias buffer to the filter count if needed.
+        //
+
+        if (Bias != nullptr && GroupCount * FilterCount < NchwcOutputChannels) {
+
+            float* AlignedBias = BufferNchwcBias.GetBuffer(NchwcOutputChannels);
+
+            size_t i;
+            for (i = 0; i < GroupCount * FilterCount; i++) {
+                AlignedBias[i] = Bias[i];
+            }
+            for (; i < NchwcOutputChannels; i++) {
+                AlignedBias[i] = 0.0f;
+            }
+
+            Bias = AlignedBias;
+        }
+
+        //
+        // Reorder the input buffer if needed.
+        //
+
+        if (DoReorderInput) {
+            size_t NchwcInputElements = BatchCount * NchwcInputChannels * InputHeight * InputWidth;
+            float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+            MlasReorderInput(InputShape, Input, NchwcInput);
+            Input = NchwcInput;
+            InputShape[1] = NchwcInputChannels;
+        }
+
+        int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(NchwcOutputChannels), int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        size_t NchwcOutputElements = BatchCount * NchwcOutputChannels * OutputHeight * OutputWidth;
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        //
+        // Use the Winograd algorithm if selected for the NCHWc channel counts.
+        //
+
+        OutputIsApproximate = false;
+
+        if (DoReorderInput && !ReorderFilterOIHWBo && GroupCount == 1) {
+
+            MLAS_CONV_PARAMETERS Parameters;
+            size_t WorkingBufferSize;
+
+            MlasConvPrepare(&Parameters,
+                            2,
+                            BatchCount,
+                            1,
+                            NchwcInputChannels,
+                            &InputShape[2],
+                            KernelShape,
+                            DilationShape,
+                            Padding,
+                            StrideShape,
+                            &NchwcOutputShape[2],
+                            NchwcOutputChannels,
+                            &Activation,
+                            &WorkingBufferSize,
+                            nullptr);
+
+            if (Parameters.Algorithm == MlasConvAlgorithmWinograd) {
+
+                float* TransformedFilter = BufferFilterTransformed.GetBuffer(MlasConvWinogradFilterSize(&Parameters));
+                MlasNchwcConvWinogradTransformFilter(&Parameters, ReorderedFilter, TransformedFilter);
+
+                MlasNchwcConvWinograd(&Parameters,
+                                      Input,
+                                      TransformedFilter,
+                                      Bias,
+                                      BufferWorking.GetBuffer(WorkingBufferSize),
+                                      NchwcOutput,
+                                      true,
+                                      nullptr);
+
+                MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+                OutputIsApproximate = true;
+
+                return;
+            }
+        }
+
+        MlasNchwcConv(2,
+                      InputShape,
+                      KernelShape,
+                      DilationShape,
+                      Padding,
+                      StrideShape,
+                      NchwcOutputShape,
+                      GroupCount,
+                      Input,
+                      ReorderedFilter,
+                      Bias,
+                      NchwcOutput,
+                      &Activation,
+                      true,
+                      nullptr);
+
+        //
+        // Reorder the output buffer.
+        //
+
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    }
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcFilter;
+    MatrixGuardBuffer<float> BufferNchwcBias;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+public:
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        // N.B. InputChannels must be a multiple of 4 if the count is greater
+        // than the block size.
+        static const unsigned cis[] = { 32, 20, 5, 1 };
+        static const unsigned cos[] = { 64, 15, 1 };
+        static const unsigned is[] = { 27, 11, 5, 1 };
+
+        // Depthwise convolutions.
+        for (unsigned i = 16; i < 256; i <<= 1) {
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 1, 1, 2, 2);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 0, 0, 0, 0, 2, 2, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, i, 1, 28, 28, 1, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(12, i, 1, 11, 11, 1, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        // Test varying FilterCounts.
+        for (unsigned i = 1; i < 128; i++) {
+            Test(1, 1, 3, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, 34, 34, i, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(1, 1, 16, 34, 34, i, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned i = 1; i <= 32; i++) {
+            Test(4, 18, 1, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+            Test(4, 18, 1, 32, 89, 48, i, 89, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(4, 18, 2, 32, 89, 48, i, 89, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned b = 1; b < 64; b++) {
+            Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        }
+
+        for (unsigned ic = 0; ic < _countof(cis); ic++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", cis[ic], is[ih], is[iw]);
+                    for (unsigned fc = 0; fc < _countof(cos); fc++) {
+                        for (unsigned kh = 1; kh <= 5; kh++) {
+                            if (kh == 4) continue;
+                            for (unsigned kw = 1; kw <= 5; kw++) {
+                                if (kw == 4) continue;
+                                for (unsigned p0 = 0; p0 <= 3; p0++) {
+                                    for (unsigned p1 = 0; p1 <= 3; p1++) {
+                                        for (unsigned p2 = 0; p2 <= 3; p2++) {
+                                            for (unsigned p3 = 0; p3 <= 3; p3++) {
+                                                for (unsigned dh = 1; dh <= 2; dh++) {
+                                                    for (unsigned dw = 1; dw <= 2; dw++) {
+                                                        for (unsigned sh = 1; sh <= 2; sh++) {
+                                                            for (unsigned sw = 1; sw <= 2; sw++) {
+                                                                Test(1, 1, cis[ic], is[ih], is[iw], cos[fc], kh, kw, p0, p1, p2, p3, dh, dw, sh, sw);
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+};
+
+class MlasPool2DTest : public MlasTestBase
+{
+protected:
+    void
+    Test(
+        size_t BatchCount,
+        size_t InputChannels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        const size_t DilationHeight = 1;
+        const size_t DilationWidth = 1;
+
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputHeight64, OutputWidth64 };
+
+        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
+        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+
+        const float* Input = BufferInput.GetBuffer(InputBufferElements);
+        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+        MlasPool2D(MlasMaximumPooling, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool2D(MlasAveragePoolingExcludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool2D(MlasAveragePoolingIncludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
+        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        }
+    }
+
+    virtual
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+    }
+
+    void
+    ReferenceMaximumPool2D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputHeight = InputShape[2];
+        int64_t InputWidth = InputShape[3];
+
+        int64_t KernelHeight = KernelShape[0];
+        int64_t KernelWidth = KernelShape[1];
+
+        int64_t PaddingLeftY = Padding[0];
+        int64_t PaddingLeftX = Padding[1];
+        int64_t PaddingRightY = Padding[2];
+        int64_t PaddingRightX = Padding[3];
+
+        int64_t StrideHeight = StrideShape[0];
+        int64_t StrideWidth = StrideShape[1];
+
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                int64_t ihEnd = ihStart + KernelHeight;
+
+                ihStart = (std::max)(ihStart, int64_t(0));
+                ihEnd = (std::min)(ihEnd, InputHeight);
+
+                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                    int64_t iwEnd = iwStart + KernelWidth;
+
+                    iwStart = (std::max)(iwStart, int64_t(0));
+                    iwEnd = (std::min)(iwEnd, InputWidth);
+
+                    float m = std::numeric_limits<float>::lowest();
+
+                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                            m = (std::max)(m, Input[ih * InputWidth + iw]);
+                        }
+                    }
+
+                    Output[ph * OutputWidth + pw] = m;
+                }
+            }
+
+            Input += InputHeight * InputWidth;
+            Output += OutputHeight * OutputWidth;
+        }
+    }
+
+    void
+    ReferenceAveragePool2D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output,
+        bool CountIncludePad
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputHeight = InputShape[2];
+        int64_t InputWidth = InputShape[3];
+
+        int64_t KernelHeight = KernelShape[0];
+        int64_t KernelWidth = KernelShape[1];
+
+        int64_t PaddingLeftY = Padding[0];
+        int64_t PaddingLeftX = Padding[1];
+        int64_t PaddingRightY = Padding[2];
+        int64_t PaddingRightX = Padding[3];
+
+        int64_t StrideHeight = StrideShape[0];
+        int64_t StrideWidth = StrideShape[1];
+
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                int64_t ihEnd = ihStart + KernelHeight;
+
+                ihStart = (std::max)(ihStart, int64_t(0));
+                ihEnd = (std::min)(ihEnd, InputHeight);
+
+                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                    int64_t iwEnd = iwStart + KernelWidth;
+
+                    iwStart = (std::max)(iwStart, int64_t(0));
+                    iwEnd = (std::min)(iwEnd, InputWidth);
+
+                    float m = 0.0f;
+
+                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                            m += Input[ih * InputWidth + iw];
+                        }
+                    }
+
+                    if (CountIncludePad) {
+                        m /= (KernelHeight * KernelWidth);
+                    } else {
+                        m /= (ihEnd - ihStart) * (iwEnd - iwStart);
+                    }
+
+                    Output[ph * OutputWidth + pw] = m;
+                }
+            }
+
+            Input += InputHeight * InputWidth;
+            Output += OutputHeight * OutputWidth;
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 256; i <<= 1) {
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 2, 2);
+            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 3, 3, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, i, i, 1, 1, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, i, 1, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, 1, i, 0, 0, 0, 0, 1, 1);
+            Test(1, 16, i, i, i, i, 0, 0, 0, 0, 1, 1);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 53, 17, 11, 5, 4, 3, 2, 1 };
+
+        for (unsigned i = 1; i < 2058; i++) {
+            Test(1, 1, 4, i, 2, 4, 0, 2, 0, 1, 1, 1);
+        }
+
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
+                Test(1, 1, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
+                Test(1, 1, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
+                Test(1, 1, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
+                for (unsigned kh = 1; kh <= 5; kh++) {
+                    if (kh > is[ih]) break;
+                    for (unsigned kw = 1; kw <= 5; kw++) {
+                        if (kw > is[iw]) break;
+                        for (unsigned sh = 1; sh <= 3; sh++) {
+                            for (unsigned sw = 1; sw <= 3; sw++) {
+                                for (unsigned p0 = 0; p0 < kh; p0++) {
+                                    for (unsigned p1 = 0; p1 < kw; p1++) {
+                                        for (unsigned p2 = 0; p2 < kh; p2++) {
+                                            for (unsigned p3 = 0; p3 < kw; p3++) {
+                                                Test(5, 3, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasNchwcPool2DTest : public MlasPool2DTest
+{
+protected:
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        ) override
+    {
+        size_t NchwcChannels = (size_t(InputShape[1]) + BlockSize - 1) & ~(BlockSize - 1);
+
+        int64_t NchwcInputShape[] = { InputShape[0], int64_t(NchwcChannels), InputShape[2], InputShape[3] };
+        size_t NchwcInputElements = size_t(NchwcInputShape[0]) * size_t(NchwcInputShape[1]) * size_t(NchwcInputShape[2]) * size_t(NchwcInputShape[3]);
+        float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+
+        int64_t NchwcOutputShape[] = { OutputShape[0], int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
+        size_t NchwcOutputElements = size_t(NchwcOutputShape[0]) * size_t(NchwcOutputShape[1]) * size_t(NchwcOutputShape[2]) * size_t(NchwcOutputShape[3]);
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+
+        MlasReorderInput(InputShape, Input, NchwcInput);
+
+        MlasNchwcPool(PoolingKind,
+                      2,
+                      NchwcInputShape,
+                      KernelShape,
+                      nullptr,
+                      Padding,
+                      StrideShape,
+                      NchwcOutputShape,
+                      NchwcInput,
+                      NchwcOutput,
+                      nullptr);
+
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    }
+
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+public:
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 53, 11, 1 };
+
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
+                Test(1, 12, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
+                Test(1, 32, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
+                Test(1, 68, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
+                for (unsigned kh = 1; kh <= 5; kh++) {
+                    if (kh > is[ih]) break;
+                    for (unsigned kw = 1; kw <= 5; kw++) {
+                        if (kw > is[iw]) break;
+                        for (unsigned sh = 1; sh <= 3; sh++) {
+                            for (unsigned sw = 1; sw <= 3; sw++) {
+                                for (unsigned p0 = 0; p0 < kh; p0++) {
+                                    for (unsigned p1 = 0; p1 < kw; p1++) {
+                                        for (unsigned p2 = 0; p2 < kh; p2++) {
+                                            for (unsigned p3 = 0; p3 < kw; p3++) {
+                                                Test(1, 32, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+};
+
+class MlasNchwcUpsampleTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t BatchCount,
+        size_t Channels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t ScaleHeight,
+        size_t ScaleWidth,
+        bool Linear
+        )
+    {
+        const size_t NchwcChannels = (Channels + BlockSize - 1) & ~(BlockSize - 1);
+        const size_t OutputHeight = InputHeight * ScaleHeight;
+        const size_t OutputWidth = InputWidth * ScaleWidth;
+
+        const size_t InputElements = BatchCount * Channels * InputHeight * InputWidth;
+        const size_t OutputElements = BatchCount * Channels * OutputHeight * OutputWidth;
+
+        float* Input = BufferInput.GetBuffer(InputElements);
+        float* Output = BufferOutput.GetBuffer(OutputElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+        float* NchwcInput = BufferNchwcInput.GetBuffer(BatchCount * NchwcChannels * InputHeight * InputWidth);
+        float* NchwcOutput = BufferNchwcOutput.GetBuffer(BatchCount * NchwcChannels * OutputHeight * OutputWidth);
+
+        for (size_t i = 0; i < InputElements; i++) {
+            Input[i] = float(int(i % 97) - 48);
+        }
+
+        //
+        // Compute the reference nearest neighbor or bilinear upsample in NCHW
+        // format.
+        //
+
+        for (size_t nc = 0; nc < BatchCount * Channels; nc++) {
+            for (size_t oh = 0; oh < OutputHeight; oh++) {
+                for (size_t ow = 0; ow < OutputWidth; ow++) {
+                    float& OutputValue = OutputReference[(nc * OutputHeight + oh) * OutputWidth + ow];
+                    if (!Linear) {
+                        OutputValue = Input[(nc * InputHeight + oh / ScaleHeight) * InputWidth + ow / ScaleWidth];
+                        continue;
+                    }
+                    const float ih = std::min(float(oh) / float(ScaleHeight), float(InputHeight - 1));
+                    const float iw = std::min(float(ow) / float(ScaleWidth), float(InputWidth - 1));
+                    const size_t ih1 = size_t(ih);
+                    const size_t iw1 = size_t(iw);
+                    const size_t ih2 = std::min(ih1 + 1, InputHeight - 1);
+                    const size_t iw2 = std::min(iw1 + 1, InputWidth - 1);
+                    const float dh = ih - float(ih1);
+                    const float dw = iw - float(iw1);
+                    const float* InputPlane = Input + nc * InputHeight * InputWidth;
+                    OutputValue =
+                        (1.0f - dh) * ((1.0f - dw) * InputPlane[ih1 * InputWidth + iw1] + dw * InputPlane[ih1 * InputWidth + iw2]) +
+                        dh * ((1.0f - dw) * InputPlane[ih2 * InputWidth + iw1] + dw * InputPlane[ih2 * InputWidth + iw2]);
+                }
+            }
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(Channels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(NchwcChannels), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(Channels), int64_t(OutputHeight), int64_t(OutputWidth) };
+        int64_t Scales[] = { int64_t(ScaleHeight), int64_t(ScaleWidth) };
+
+        MlasReorderInput(InputShape, Input, NchwcInput);
+        if (Linear) {
+            MlasNchwcUpsampleLinear(NchwcInputShape, Scales, NchwcInput, NchwcOutput, threadpool);
+        } else {
+            MlasNchwcUpsample(NchwcInputShape, Scales, NchwcInput, NchwcOutput, threadpool);
+        }
+        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+        for (size_t i = 0; i < OutputElements; i++) {
+            if (std::fabs(Output[i] - OutputReference[i]) > 1e-4f) {
+                printf("mismatch: %zd,%zd,%zd,%zd,%zd,%zd,%d\n", BatchCount, Channels, InputHeight, InputWidth,
+                    ScaleHeight, ScaleWidth, int(Linear));
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+    MatrixGuardBuffer<float> BufferNchwcInput;
+    MatrixGuardBuffer<float> BufferNchwcOutput;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (bool Linear : { false, true }) {
+            for (size_t sh = 1; sh <= 3; sh++) {
+                for (size_t sw = 1; sw <= 3; sw++) {
+                    Test(1, 16, 7, 9, sh, sw, Linear);
+                    Test(1, 40, 5, 3, sh, sw, Linear);
+                    Test(2, 32, 5, 3, sh, sw, Linear);
+                    Test(1, 4, 1, 1, sh, sw, Linear);
+                }
+            }
+            Test(1, 64, 38, 50, 2, 2, Linear);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+class MlasPool3DTest : public MlasTestBase
+{
+protected:
+    void
+    Test(
+        size_t BatchCount,
+        size_t InputChannels,
+        size_t InputDepth,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelDepth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingLeftDepth,
+        size_t PaddingLeftHeight,
+        size_t PaddingLeftWidth,
+        size_t PaddingRightDepth,
+        size_t PaddingRightHeight,
+        size_t PaddingRightWidth,
+        size_t StrideDepth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        const size_t DilationDepth = 1;
+        const size_t DilationHeight = 1;
+        const size_t DilationWidth = 1;
+
+        int64_t OutputDepth64 =
+            ((int64_t(InputDepth) + int64_t(PaddingLeftDepth) + int64_t(PaddingRightDepth)) -
+            (int64_t(DilationDepth) * (int64_t(KernelDepth) - 1) + 1)) / int64_t(StrideDepth) + 1;
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputDepth64 <= 0 || OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputDepth), int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelDepth), int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t Padding[] = { int64_t(PaddingLeftDepth), int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightDepth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+        int64_t StrideShape[] = { int64_t(StrideDepth), int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputDepth64, OutputHeight64, OutputWidth64 };
+
+        OutputShape[2] = (InputShape[2] + Padding[0] + Padding[3] - KernelShape[0]) / StrideShape[0] + 1;
+        OutputShape[3] = (InputShape[3] + Padding[1] + Padding[4] - KernelShape[1]) / StrideShape[1] + 1;
+        OutputShape[4] = (InputShape[4] + Padding[2] + Padding[5] - KernelShape[2]) / StrideShape[2] + 1;
+
+        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3] * InputShape[4]);
+        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3] * OutputShape[4]);
+
+        const float* Input = BufferInput.GetBuffer(InputBufferElements);
+        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+        MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: maximum input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageexcpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+
+        MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+            printf("mismatch: averageincpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
+                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        }
+    }
+
+    void
+    ReferenceMaximumPool3D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputDepth = InputShape[2];
+        int64_t InputHeight = InputShape[3];
+        int64_t InputWidth = InputShape[4];
+
+        int64_t KernelDepth = KernelShape[0];
+        int64_t KernelHeight = KernelShape[1];
+        int64_t KernelWidth = KernelShape[2];
+
+        int64_t PaddingLeftZ = Padding[0];
+        int64_t PaddingLeftY = Padding[1];
+        int64_t PaddingLeftX = Padding[2];
+        int64_t PaddingRightZ = Padding[3];
+        int64_t PaddingRightY = Padding[4];
+        int64_t PaddingRightX = Padding[5];
+
+        int64_t StrideDepth = StrideShape[0];
+        int64_t StrideHeight = StrideShape[1];
+        int64_t StrideWidth = StrideShape[2];
+
+        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+
+                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
+                int64_t idEnd = idStart + KernelDepth;
+
+                idStart = (std::max)(idStart, int64_t(0));
+                idEnd = (std::min)(idEnd, InputDepth);
+
+                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                    int64_t ihEnd = ihStart + KernelHeight;
+
+                    ihStart = (std::max)(ihStart, int64_t(0));
+                    ihEnd = (std::min)(ihEnd, InputHeight);
+
+                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                        int64_t iwEnd = iwStart + KernelWidth;
+
+                        iwStart = (std::max)(iwStart, int64_t(0));
+                        iwEnd = (std::min)(iwEnd, InputWidth);
+
+                        float m = std::numeric_limits<float>::lowest();
+
+                        for (int64_t id = idStart; id < idEnd; id++) {
+                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                                    m = (std::max)(m, Input[id * InputHeight * InputWidth + ih * InputWidth + iw]);
+                                }
+                            }
+                        }
+
+                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
+                    }
+                }
+            }
+
+            Input += InputDepth * InputHeight * InputWidth;
+            Output += OutputDepth * OutputHeight * OutputWidth;
+        }
+    }
+
+    void
+    ReferenceAveragePool3D(
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const float* Input,
+        float* Output,
+        bool CountIncludePad
+        )
+    {
+        int64_t ChannelCount = InputShape[0] * InputShape[1];
+
+        int64_t InputDepth = InputShape[2];
+        int64_t InputHeight = InputShape[3];
+        int64_t InputWidth = InputShape[4];
+
+        int64_t KernelDepth = KernelShape[0];
+        int64_t KernelHeight = KernelShape[1];
+        int64_t KernelWidth = KernelShape[2];
+
+        int64_t PaddingLeftZ = Padding[0];
+        int64_t PaddingLeftY = Padding[1];
+        int64_t PaddingLeftX = Padding[2];
+        int64_t PaddingRightZ = Padding[3];
+        int64_t PaddingRightY = Padding[4];
+        int64_t PaddingRightX = Padding[5];
+
+        int64_t StrideDepth = StrideShape[0];
+        int64_t StrideHeight = StrideShape[1];
+        int64_t StrideWidth = StrideShape[2];
+
+        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
+        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
+        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+
+        for (int64_t c = 0; c < ChannelCount; c++) {
+
+            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+
+                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
+                int64_t idEnd = idStart + KernelDepth;
+
+                idStart = (std::max)(idStart, int64_t(0));
+                idEnd = (std::min)(idEnd, InputDepth);
+
+                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+
+                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
+                    int64_t ihEnd = ihStart + KernelHeight;
+
+                    ihStart = (std::max)(ihStart, int64_t(0));
+                    ihEnd = (std::min)(ihEnd, InputHeight);
+
+                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+
+                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
+                        int64_t iwEnd = iwStart + KernelWidth;
+
+                        iwStart = (std::max)(iwStart, int64_t(0));
+                        iwEnd = (std::min)(iwEnd, InputWidth);
+
+                        float m = 0.0f;
+
+                        for (int64_t id = idStart; id < idEnd; id++) {
+                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
+                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
+                                    m += Input[id * InputHeight * InputWidth + ih * InputWidth + iw];
+                                }
+                            }
+                        }
+
+                        if (CountIncludePad) {
+                            m /= (KernelDepth * KernelHeight * KernelWidth);
+                        } else {
+                            m /= (idEnd - idStart) * (ihEnd - ihStart) * (iwEnd - iwStart);
+                        }
+
+                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
+                    }
+                }
+            }
+
+            Input += InputDepth * InputHeight * InputWidth;
+            Output += OutputDepth * OutputHeight * OutputWidth;
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (unsigned i = 1; i < 64; i <<= 1) {
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 2, 2, 2);
+            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, i, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+            Test(1, 16, i, i, i, 1, 1, i, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const unsigned is[] = { 11, 5, 4, 3, 2, 1 };
+
+        for (unsigned id = 0; id < _countof(is); id++) {
+            for (unsigned ih = 0; ih < _countof(is); ih++) {
+                for (unsigned iw = 0; iw < _countof(is); iw++) {
+                    fprintf(stderr, "Handling %ux%ux%u\n", is[id], is[ih], is[iw]);
+                    Test(1, 1, is[id], is[ih], is[iw], is[id], is[ih], is[iw], 0, 0, 0, 0, 0, 0, 1, 1, 1);
+                    for (unsigned kd = 1; kd <= 4; kd++) {
+                        if (kd > is[id]) break;
+                        for (unsigned kh = 1; kh <= 4; kh++) {
+                            if (kh > is[ih]) break;
+                            for (unsigned kw = 1; kw <= 4; kw++) {
+                                if (kw > is[iw]) break;
+                                for (unsigned sd = 1; sd <= 3; sd++) {
+                                    for (unsigned sh = 1; sh <= 3; sh++) {
+                                        for (unsigned sw = 1; sw <= 3; sw++) {
+                                            for (unsigned p0 = 0; p0 < kd; p0++) {
+                                                for (unsigned p1 = 0; p1 < kh; p1++) {
+                                                    for (unsigned p2 = 0; p2 < kw; p2++) {
+                                                        for (unsigned p3 = 0; p3 < kd; p3++) {
+                                                            for (unsigned p4 = 0; p4 < kh; p4++) {
+                                                                for (unsigned p5 = 0; p5 < kw; p5++) {
+                                                                    Test(1, 1, is[id], is[ih], is[iw], kd, kh, kw, p0, p1, p2, p3, p4, p5, sd, sh, sw);
+                                                                }
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class MlasActivationTest : public MlasTestBase
+{
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        union AliasedValue {
+            unsigned u;
+            float f;
+        };
+
+        // N.B. The test data includes values at the edge of Tanh/Logistic boundaries.
+        //    Identity,     Relu,         LeakyRelu,    Tanh,         Logistic,     Clip,
+        static const AliasedValue TestData[20][6] = {
+            { {0x00000001}, {0x00000001}, {0x00000001}, {0x00000000}, {0x3f000000}, {0x00000001}, }, // positive denormal
+            { {0x80000001}, {0x00000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x00000000}, }, // negative denormal
+            { {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, }, // positive NaN
+            { {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, }, // negative NaN
+            { {0x00000000}, {0x00000000}, {0x00000000}, {0x00000000}, {0x3f000000}, {0x00000000}, }, // 0.0f
+            { {0x80000000}, {0x80000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x80000000}, }, // -0.0f
+            { {0x3e800000}, {0x3e800000}, {0x3e800000}, {0x3e7acbf5}, {0x3f0feacc}, {0x3e800000}, }, // 0.25f
+            { {0xbe800000}, {0x00000000}, {0xbd4ccccd}, {0xbe7acbf5}, {0x3ee02a67}, {0x00000000}, }, // -0.25f
+            { {0x40800000}, {0x40800000}, {0x40800000}, {0x3f7fd40a}, {0x3f7b6541}, {0x40800000}, }, // 4.0f
+            { {0xc0800000}, {0x00000000}, {0xbf4ccccd}, {0xbf7fd40a}, {0x3c9357e0}, {0x00000000}, }, // -4.0f
+            { {0x41200000}, {0x41200000}, {0x41200000}, {0x3f800000}, {0x3f7ffd06}, {0x40c00000}, }, // 10.0f
+            { {0xc1200000}, {0x00000000}, {0xc0000000}, {0xbf800000}, {0x383e6000}, {0x00000000}, }, // -10.0f
+            { {0xc18866eb}, {0x00000000}, {0xc05a3e45}, {0xbf800000}, {0x33000000}, {0x00000000}, }, // -17.0502529144f
+            { {0xc18869bb}, {0x00000000}, {0xc05a42c5}, {0xbf800000}, {0x33c00000}, {0x00000000}, }, // -17.0516262054f
+            { {0xc18852a8}, {0x00000000}, {0xc05a1dda}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0403594971f
+            { {0xc18844aa}, {0x00000000}, {0xc05a0777}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0335273743f
+            { {0x418866eb}, {0x418866eb}, {0x418866eb}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0502529144f
+            { {0x418869bb}, {0x418869bb}, {0x418869bb}, {0x3f800000}, {0x3f7ffffe}, {0x40c00000}, }, // +17.0516262054f
+            { {0x418852a8}, {0x418852a8}, {0x418852a8}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0403594971f
+            { {0x418844aa}, {0x418844aa}, {0x418844aa}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0335273743f
+        };
+
+        MLAS_ACTIVATION Activation;
+        AliasedValue Buffer[_countof(TestData)];
+
+        for (unsigned kind = 0; kind < unsigned(MlasClipActivation); kind++) {
+
+            Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
+
+            if (Activation.ActivationKind == MlasLeakyReluActivation) {
+                Activation.Parameters.LeakyRelu.alpha = 0.2f;
+            } else if (Activation.ActivationKind == MlasClipActivation) {
+                Activation.Parameters.Clip.minimum = 0.0f;
+                Activation.Parameters.Clip.maximum = 6.0f;
+            }
+
+            //
+            // Test the vectorized activations.
+            //
+
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                Buffer[i].u = TestData[i][0].u;
+            }
+
+            MlasActivation(&Activation, &Buffer[0].f, nullptr, _countof(Buffer), 1, 1);
+
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                // Sensitive to comparing positive/negative zero and NaNs.
+                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
+                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
+                }
+            }
+
+            //
+            // Test the scalar activations.
+            //
+
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                Buffer[i].u = TestData[i][0].u;
+                MlasActivation(&Activation, &Buffer[i].f, nullptr, 1, 1, 1);
+            }
+
+            for (unsigned i = 0; i < _countof(TestData); i++) {
+                // Sensitive to comparing positive/negative zero and NaNs.
+                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
+                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
+                }
+            }
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+class MlasActivationReferenceTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferOutput;
+
+    static
+    float
+    Reference(
+        const MLAS_ACTIVATION& Activation,
+        float Value
+        )
+    {
+        switch (Activation.ActivationKind) {
+            case MlasGeluActivation:
+                return 0.5f * Value * (1.0f + std::erf(Value * 0.70710678118654752440f));
+            case MlasSwishActivation:
+                return Value / (1.0f + std::exp(-Value));
+            default:
+                return (std::max)(0.0f, (std::min)(1.0f,
+                    Activation.Parameters.HardSigmoid.alpha * Value + Activation.Parameters.HardSigmoid.beta));
+        }
+    }
+
+    void
+    Test(
+        MLAS_ACTIVATION_KIND Kind,
+        size_t M,
+        size_t N,
+        size_t ldc,
+        bool AddBias
+        )
+    {
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = Kind;
+        Activation.Parameters.HardSigmoid.alpha = 0.2f;
+        Activation.Parameters.HardSigmoid.beta = 0.5f;
+
+        float* Output = BufferOutput.GetBuffer(M * ldc);
+        std::vector<float> Input(M * ldc);
+        std::vector<float> Bias(M);
+
+        for (size_t i = 0; i < M * ldc; i++) {
+            Input[i] = float(int((i * 7919) % 257) - 128) * 0.0625f;
+        }
+        for (size_t m = 0; m < M; m++) {
+            Bias[m] = float(int(m % 5) - 2) * 0.5f;
+        }
+        std::copy(Input.begin(), Input.end(), Output);
+
+        MlasActivation(&Activation, Output, AddBias ? Bias.data() : nullptr, M, N, ldc);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < ldc; n++) {
+                const size_t i = m * ldc + n;
+                // The columns past N are left untouched.
+                const float Expected = (n < N) ? Reference(Activation, Input[i] + (AddBias ? Bias[m] : 0.0f)) : Input[i];
+                if (std::fabs(Output[i] - Expected) > 1e-5f * (1.0f + std::fabs(Expected))) {
+                    printf("mismatch activation kind=%d M=%zd N=%zd ldc=%zd m=%zd n=%zd output=%.9g expected=%.9g\n",
+                        int(Kind), M, N, ldc, m, n, Output[i], Expected);
+                    return;
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (MLAS_ACTIVATION_KIND Kind : { MlasGeluActivation, MlasSwishActivation, MlasHardSigmoidActivation }) {
+            for (size_t N : { 1, 3, 4, 7, 16, 255, 256, 257, 1000 }) {
+                Test(Kind, 1, N, N, false);
+                Test(Kind, 5, N, N, true);
+                Test(Kind, 3, N, N + 5, false);
+                Test(Kind, 3, N, N + 5, true);
+            }
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
-        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+class MlasComputeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
 
-        const float* Input = BufferInput.GetBuffer(InputBufferElements);
-        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+    static
+    bool
+    CloseEnough(
+        float Value,
+        float Reference,
+        float Tolerance
+        )
+    {
+        return std::fabs(Value - Reference) <= Tolerance * (std::fabs(Reference) + std::numeric_limits<float>::min());
+    }
 
-        MlasPool2D(MlasMaximumPooling, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+    void
+    TestExp(
+        size_t N,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = MinimumValue + (MaximumValue - MinimumValue) * float(n) / float(N);
         }
 
-        MlasPool2D(MlasAveragePoolingExcludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+        MlasComputeExp(Input, Output, N);
+
+        for (size_t n = 0; n < N; n++) {
+            float Reference = std::exp(Input[n]);
+            // Denormal results lose relative precision.
+            float Tolerance = (Reference < std::numeric_limits<float>::min()) ? 1e-2f : 2e-6f;
+            if (!CloseEnough(Output[n], Reference, Tolerance) &&
+                std::fabs(Output[n] - Reference) > 1e-44f) {
+                printf("mismatch exp N=%zd, n=%zd, input=%.9g, output=%.9g, expected=%.9g!\n",
+                    N, n, Input[n], Output[n], Reference);
+                break;
+            }
+        }
+    }
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    void
+    TestLog(
+        size_t N,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = MinimumValue * std::pow(MaximumValue / MinimumValue, float(n) / float(N));
         }
 
-        MlasPool2D(MlasAveragePoolingIncludePad, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output);
-        ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+        MlasComputeLog(Input, Output, N);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
-                InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+        for (size_t n = 0; n < N; n++) {
+            float Reference = std::log(Input[n]);
+            if (!CloseEnough(Output[n], Reference, 2e-6f) && std::fabs(Output[n] - Reference) > 2e-7f) {
+                printf("mismatch log N=%zd, n=%zd, input=%.9g, output=%.9g, expected=%.9g!\n",
+                    N, n, Input[n], Output[n], Reference);
+                break;
+            }
         }
     }
 
-    virtual
     void
-    MlasPool2D(
-        MLAS_POOLING_KIND PoolingKind,
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const int64_t* OutputShape,
-        const float* Input,
-        float* Output
+    TestLogSpecialValues(
+        void
         )
     {
-        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
+        const float Infinity = std::numeric_limits<float>::infinity();
+        const float Input[] = { 0.0f, -0.0f, -1.0f, Infinity, -Infinity, std::numeric_limits<float>::quiet_NaN(),
+            1.0f, std::numeric_limits<float>::denorm_min(), 1e-40f };
+        float Output[_countof(Input)];
+
+        MlasComputeLog(Input, Output, _countof(Input));
+
+        for (size_t n = 0; n < _countof(Input); n++) {
+            float Reference = std::log(Input[n]);
+            bool Match = std::isnan(Reference) ? std::isnan(Output[n]) :
+                (Output[n] == Reference || CloseEnough(Output[n], Reference, 2e-6f));
+            if (!Match) {
+                printf("mismatch log n=%zd, input=%.9g, output=%.9g, expected=%.9g!\n",
+                    n, Input[n], Output[n], Reference);
+            }
+        }
     }
 
     void
-    ReferenceMaximumPool2D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output
+    TestSqrt(
+        size_t N
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
-
-        int64_t InputHeight = InputShape[2];
-        int64_t InputWidth = InputShape[3];
-
-        int64_t KernelHeight = KernelShape[0];
-        int64_t KernelWidth = KernelShape[1];
-
-        int64_t PaddingLeftY = Padding[0];
-        int64_t PaddingLeftX = Padding[1];
-        int64_t PaddingRightY = Padding[2];
-        int64_t PaddingRightX = Padding[3];
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
 
-        int64_t StrideHeight = StrideShape[0];
-        int64_t StrideWidth = StrideShape[1];
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = float(n * 7919 % 1009) * 0.37f;
+        }
 
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        MlasComputeSqrt(Input, Output, N);
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        for (size_t n = 0; n < N; n++) {
+            if (Output[n] != std::sqrt(Input[n])) {
+                printf("mismatch sqrt N=%zd, n=%zd, input=%.9g, output=%.9g, expected=%.9g!\n",
+                    N, n, Input[n], Output[n], std::sqrt(Input[n]));
+                break;
+            }
+        }
+    }
 
-            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+    void
+    TestSoftmax(
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
 
-                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                int64_t ihEnd = ihStart + KernelHeight;
+        for (size_t i = 0; i < N * D; i++) {
+            Input[i] = float(int(i % 41) - 20) * 0.75f + float(i % 7) * 0.01f;
+        }
 
-                ihStart = (std::max)(ihStart, int64_t(0));
-                ihEnd = (std::min)(ihEnd, InputHeight);
+        for (size_t n = 0; n < N; n++) {
+            const float* x = Input + n * D;
+            double Maximum = *std::max_element(x, x + D);
+            double Sum = 0.0;
+            for (size_t d = 0; d < D; d++) {
+                Sum += std::exp(double(x[d]) - Maximum);
+            }
+            for (size_t d = 0; d < D; d++) {
+                OutputReference[n * D + d] = LogSoftmax ? float(double(x[d]) - Maximum - std::log(Sum)) :
+                    float(std::exp(double(x[d]) - Maximum) / Sum);
+            }
+        }
 
-                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
 
-                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                    int64_t iwEnd = iwStart + KernelWidth;
+        for (size_t i = 0; i < N * D; i++) {
+            if (!CloseEnough(Output[i], OutputReference[i], 1e-5f) &&
+                std::fabs(Output[i] - OutputReference[i]) > 1e-6f) {
+                printf("mismatch %s N=%zd, D=%zd, i=%zd, output=%.9g, expected=%.9g!\n",
+                    LogSoftmax ? "logsoftmax" : "softmax", N, D, i, Output[i], OutputReference[i]);
+                break;
+            }
+        }
+    }
 
-                    iwStart = (std::max)(iwStart, int64_t(0));
-                    iwEnd = (std::min)(iwEnd, InputWidth);
+    void
+    TestReduce(
+        size_t OuterCount,
+        size_t ReduceCount,
+        size_t InnerCount,
+        bool IsMaximum
+        )
+    {
+        const size_t InputCount = OuterCount * ReduceCount * InnerCount;
+        const size_t OutputCount = OuterCount * InnerCount;
 
-                    float m = std::numeric_limits<float>::lowest();
+        float* Input = BufferInput.GetBuffer(InputCount);
+        float* Output = BufferOutput.GetBuffer(OutputCount);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputCount);
 
-                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                            m = (std::max)(m, Input[ih * InputWidth + iw]);
-                        }
-                    }
+        // Small integers keep the sums exact regardless of the order of accumulation.
+        for (size_t i = 0; i < InputCount; i++) {
+            Input[i] = float(int((i * 7919) % 23) - 11);
+        }
 
-                    Output[ph * OutputWidth + pw] = m;
+        for (size_t o = 0; o < OuterCount; o++) {
+            for (size_t i = 0; i < InnerCount; i++) {
+                float Value = IsMaximum ? std::numeric_limits<float>::lowest() : 0.0f;
+                for (size_t r = 0; r < ReduceCount; r++) {
+                    float x = Input[(o * ReduceCount + r) * InnerCount + i];
+                    Value = IsMaximum ? std::max(Value, x) : Value + x;
                 }
+                OutputReference[o * InnerCount + i] = Value;
             }
+        }
 
-            Input += InputHeight * InputWidth;
-            Output += OutputHeight * OutputWidth;
+        if (IsMaximum) {
+            MlasReduceMaximum(Input, Output, OuterCount, ReduceCount, InnerCount, threadpool);
+        } else {
+            MlasReduceSum(Input, Output, OuterCount, ReduceCount, InnerCount, threadpool);
+        }
+
+        for (size_t i = 0; i < OutputCount; i++) {
+            if (Output[i] != OutputReference[i]) {
+                printf("mismatch %s outer=%zd, reduce=%zd, inner=%zd, i=%zd, output=%f, expected=%f!\n",
+                    IsMaximum ? "maximum" : "sum", OuterCount, ReduceCount, InnerCount, i, Output[i], OutputReference[i]);
+                break;
+            }
         }
     }
 
     void
-    ReferenceAveragePool2D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output,
-        bool CountIncludePad
+    TestReduceMinimumMaximum(
+        size_t N
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
-
-        int64_t InputHeight = InputShape[2];
-        int64_t InputWidth = InputShape[3];
-
-        int64_t KernelHeight = KernelShape[0];
-        int64_t KernelWidth = KernelShape[1];
-
-        int64_t PaddingLeftY = Padding[0];
-        int64_t PaddingLeftX = Padding[1];
-        int64_t PaddingRightY = Padding[2];
-        int64_t PaddingRightX = Padding[3];
+        float* Input = BufferInput.GetBuffer(N);
 
-        int64_t StrideHeight = StrideShape[0];
-        int64_t StrideWidth = StrideShape[1];
-
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = float(int((n * 7919) % 1009) - 504) * 0.25f;
+        }
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        float Minimum;
+        float Maximum;
 
-            for (int64_t ph = 0; ph < OutputHeight; ph++) {
+        MlasReduceMinimumMaximum(Input, &Minimum, &Maximum, N);
 
-                int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                int64_t ihEnd = ihStart + KernelHeight;
+        float MinimumReference = *std::min_element(Input, Input + N);
+        float MaximumReference = *std::max_element(Input, Input + N);
 
-                ihStart = (std::max)(ihStart, int64_t(0));
-                ihEnd = (std::min)(ihEnd, InputHeight);
+        if (Minimum != MinimumReference || Maximum != MaximumReference) {
+            printf("mismatch minimum/maximum N=%zd, output=%f/%f, expected=%f/%f!\n",
+                N, Minimum, Maximum, MinimumReference, MaximumReference);
+        }
+    }
 
-                for (int64_t pw = 0; pw < OutputWidth; pw++) {
+    void
+    TestNormalize(
+        size_t RowCount,
+        size_t RowSize,
+        size_t ScaleCount
+        )
+    {
+        const size_t Elements = RowCount * RowSize;
 
-                    int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                    int64_t iwEnd = iwStart + KernelWidth;
+        float* Input = BufferInput.GetBuffer(Elements);
+        float* Output = BufferOutput.GetBuffer(Elements);
 
-                    iwStart = (std::max)(iwStart, int64_t(0));
-                    iwEnd = (std::min)(iwEnd, InputWidth);
+        for (size_t n = 0; n < Elements; n++) {
+            Input[n] = float(int((n * 7919) % 1009) - 504) * 0.25f + 100.0f;
+        }
 
-                    float m = 0.0f;
+        std::vector<float> Mean(RowCount);
+        std::vector<float> Variance(RowCount);
 
-                    for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                        for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                            m += Input[ih * InputWidth + iw];
-                        }
-                    }
+        MlasReduceMeanVariance(Input, Mean.data(), Variance.data(), RowCount, RowSize, threadpool);
 
-                    if (CountIncludePad) {
-                        m /= (KernelHeight * KernelWidth);
-                    } else {
-                        m /= (ihEnd - ihStart) * (iwEnd - iwStart);
-                    }
+        for (size_t row = 0; row < RowCount; row++) {
 
-                    Output[ph * OutputWidth + pw] = m;
-                }
+            double Sum = 0.0;
+            for (size_t i = 0; i < RowSize; i++) {
+                Sum += Input[row * RowSize + i];
             }
+            const double MeanReference = Sum / RowSize;
 
-            Input += InputHeight * InputWidth;
-            Output += OutputHeight * OutputWidth;
-        }
-    }
-
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
+            double SquaredDeviations = 0.0;
+            for (size_t i = 0; i < RowSize; i++) {
+                const double Deviation = Input[row * RowSize + i] - MeanReference;
+                SquaredDeviations += Deviation * Deviation;
+            }
+            const double VarianceReference = SquaredDeviations / RowSize;
 
-public:
-    void
-    ExecuteShort(
-        void
-        ) override
-    {
-        for (unsigned i = 1; i < 256; i <<= 1) {
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 2, 2);
-            Test(1, 16, i, i, 3, 3, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 3, 3, 1, 1, 1, 1, 1, 1);
-            Test(1, 16, i, i, 1, 1, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, i, 1, 0, 0, 0, 0, 1, 1);
-            Test(1, 16, i, i, 1, i, 0, 0, 0, 0, 1, 1);
+            if (std::fabs(Mean[row] - MeanReference) > 1e-3 * (1.0 + std::fabs(MeanReference)) ||
+                std::fabs(Variance[row] - VarianceReference) > 1e-3 * (1.0 + VarianceReference)) {
+                printf("mismatch mean/variance RowCount=%zd, RowSize=%zd, row=%zd, output=%f/%f, expected=%f/%f!\n",
+                    RowCount, RowSize, row, Mean[row], Variance[row], MeanReference, VarianceReference);
+                break;
+            }
         }
-    }
-
-    void
-    ExecuteLong(
-        void
-        ) override
-    {
-        static const unsigned is[] = { 53, 17, 11, 5, 4, 3, 2, 1 };
 
-        for (unsigned i = 1; i < 2058; i++) {
-            Test(1, 1, 4, i, 2, 4, 0, 2, 0, 1, 1, 1);
-        }
+        std::vector<float> Scale(ScaleCount);
+        std::vector<float> Shift(ScaleCount);
 
-        for (unsigned ih = 0; ih < _countof(is); ih++) {
-            for (unsigned iw = 0; iw < _countof(is); iw++) {
-                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
-                Test(1, 1, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
-                Test(1, 1, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
-                Test(1, 1, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
-                for (unsigned kh = 1; kh <= 5; kh++) {
-                    if (kh > is[ih]) break;
-                    for (unsigned kw = 1; kw <= 5; kw++) {
-                        if (kw > is[iw]) break;
-                        for (unsigned sh = 1; sh <= 3; sh++) {
-                            for (unsigned sw = 1; sw <= 3; sw++) {
-                                for (unsigned p0 = 0; p0 < kh; p0++) {
-                                    for (unsigned p1 = 0; p1 < kw; p1++) {
-                                        for (unsigned p2 = 0; p2 < kh; p2++) {
-                                            for (unsigned p3 = 0; p3 < kw; p3++) {
-                                                Test(5, 3, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+        for (size_t s = 0; s < ScaleCount; s++) {
+            Scale[s] = 0.5f + float(s % 7) * 0.25f;
+            Shift[s] = float(int(s % 5) - 2);
+        }
+
+        MlasComputeScaleShift(Input, Output, Scale.data(), Shift.data(), ScaleCount, RowCount, RowSize, threadpool);
+
+        for (size_t n = 0; n < Elements; n++) {
+            const size_t s = (n / RowSize) % ScaleCount;
+            const float OutputReference = Input[n] * Scale[s] + Shift[s];
+            if (std::fabs(Output[n] - OutputReference) > 1e-4f * (1.0f + std::fabs(OutputReference))) {
+                printf("mismatch scale/shift RowCount=%zd, RowSize=%zd, ScaleCount=%zd, n=%zd, output=%f, expected=%f!\n",
+                    RowCount, RowSize, ScaleCount, n, Output[n], OutputReference);
+                break;
             }
         }
     }
-};
 
-class MlasNchwcPool2DTest : public MlasPool2DTest
-{
-protected:
+public:
     void
-    MlasPool2D(
-        MLAS_POOLING_KIND PoolingKind,
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const int64_t* OutputShape,
-        const float* Input,
-        float* Output
+    ExecuteShort(
+        void
         ) override
     {
-        size_t NchwcChannels = (size_t(InputShape[1]) + BlockSize - 1) & ~(BlockSize - 1);
+        for (size_t N = 1; N < 40; N++) {
+            TestExp(N, -5.0f, 5.0f);
+        }
+        TestExp(4000, -110.0f, 88.7f);
 
-        int64_t NchwcInputShape[] = { InputShape[0], int64_t(NchwcChannels), InputShape[2], InputShape[3] };
-        size_t NchwcInputElements = size_t(NchwcInputShape[0]) * size_t(NchwcInputShape[1]) * size_t(NchwcInputShape[2]) * size_t(NchwcInputShape[3]);
-        float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputElements);
+        for (size_t N = 1; N < 40; N++) {
+            TestLog(N, 0.01f, 100.0f);
+            TestSqrt(N);
+        }
+        TestLog(4000, 1e-37f, 3e38f);
+        TestLogSpecialValues();
 
-        int64_t NchwcOutputShape[] = { OutputShape[0], int64_t(NchwcChannels), OutputShape[2], OutputShape[3] };
-        size_t NchwcOutputElements = size_t(NchwcOutputShape[0]) * size_t(NchwcOutputShape[1]) * size_t(NchwcOutputShape[2]) * size_t(NchwcOutputShape[3]);
-        float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputElements);
+        static const size_t Dimensions[] = { 1, 3, 8, 15, 16, 17, 31, 33, 64, 100, 1000, 32003 };
 
-        MlasReorderInput(InputShape, Input, NchwcInput);
+        for (size_t d = 0; d < _countof(Dimensions); d++) {
+            for (size_t N : { 1, 3, 16 }) {
+                TestSoftmax(N, Dimensions[d], false);
+                TestSoftmax(N, Dimensions[d], true);
+            }
+            for (size_t InnerCount : { 1, 5, 300 }) {
+                TestReduce(3, Dimensions[d] % 1000, InnerCount, false);
+                TestReduce(3, Dimensions[d] % 1000, InnerCount, true);
+            }
+        }
+        TestReduce(1, 1024, 1024, false);
+        TestReduce(64, 2048, 1, true);
 
-        MlasNchwcPool(PoolingKind,
-                      2,
-                      NchwcInputShape,
-                      KernelShape,
-                      nullptr,
-                      Padding,
-                      StrideShape,
-                      NchwcOutputShape,
-                      NchwcInput,
-                      NchwcOutput,
-                      nullptr);
+        for (size_t N = 1; N < 80; N++) {
+            TestReduceMinimumMaximum(N);
+        }
+        TestReduceMinimumMaximum(32003);
 
-        MlasReorderOutput(OutputShape, NchwcOutput, Output);
+        for (size_t RowSize : { 1, 3, 8, 15, 16, 17, 100, 1000, 32003 }) {
+            TestNormalize(1, RowSize, 1);
+            TestNormalize(6, RowSize, 3);
+            TestNormalize(24, RowSize, 24);
+        }
     }
 
-    MatrixGuardBuffer<float> BufferNchwcInput;
-    MatrixGuardBuffer<float> BufferNchwcOutput;
-
-    const size_t BlockSize = MlasNchwcGetBlockSize();
-
-public:
     void
     ExecuteLong(
         void
         ) override
     {
-        static const unsigned is[] = { 53, 11, 1 };
-
-        for (unsigned ih = 0; ih < _countof(is); ih++) {
-            for (unsigned iw = 0; iw < _countof(is); iw++) {
-                fprintf(stderr, "Handling %ux%u\n", is[ih], is[iw]);
-                Test(1, 12, is[ih], is[iw], is[ih], is[iw], 0, 0, 0, 0, 1, 1);
-                Test(1, 32, is[ih], is[iw], is[ih], 1, 0, 0, 0, 0, 1, 1);
-                Test(1, 68, is[ih], is[iw], 1, is[iw], 0, 0, 0, 0, 1, 1);
-                for (unsigned kh = 1; kh <= 5; kh++) {
-                    if (kh > is[ih]) break;
-                    for (unsigned kw = 1; kw <= 5; kw++) {
-                        if (kw > is[iw]) break;
-                        for (unsigned sh = 1; sh <= 3; sh++) {
-                            for (unsigned sw = 1; sw <= 3; sw++) {
-                                for (unsigned p0 = 0; p0 < kh; p0++) {
-                                    for (unsigned p1 = 0; p1 < kw; p1++) {
-                                        for (unsigned p2 = 0; p2 < kh; p2++) {
-                                            for (unsigned p3 = 0; p3 < kw; p3++) {
-                                                Test(1, 32, is[ih], is[iw], kh, kw, p0, p1, p2, p3, sh, sw);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
     }
-
 };
 
-class MlasPool3DTest : public MlasTestBase
+template<typename ElementType>
+class MlasTransposeTest : public MlasTestBase
 {
-protected:
+private:
+    MatrixGuardBuffer<ElementType> BufferInput;
+    MatrixGuardBuffer<ElementType> BufferOutput;
+
     void
     Test(
-        size_t BatchCount,
-        size_t InputChannels,
-        size_t InputDepth,
-        size_t InputHeight,
-        size_t InputWidth,
-        size_t KernelDepth,
-        size_t KernelHeight,
-        size_t KernelWidth,
-        size_t PaddingLeftDepth,
-        size_t PaddingLeftHeight,
-        size_t PaddingLeftWidth,
-        size_t PaddingRightDepth,
-        size_t PaddingRightHeight,
-        size_t PaddingRightWidth,
-        size_t StrideDepth,
-        size_t StrideHeight,
-        size_t StrideWidth
+        size_t M,
+        size_t N
         )
     {
-        const size_t DilationDepth = 1;
-        const size_t DilationHeight = 1;
-        const size_t DilationWidth = 1;
-
-        int64_t OutputDepth64 =
-            ((int64_t(InputDepth) + int64_t(PaddingLeftDepth) + int64_t(PaddingRightDepth)) -
-            (int64_t(DilationDepth) * (int64_t(KernelDepth) - 1) + 1)) / int64_t(StrideDepth) + 1;
-        int64_t OutputHeight64 =
-            ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
-            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
-        int64_t OutputWidth64 =
-            ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
-            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
-
-        if (OutputDepth64 <= 0 || OutputHeight64 <= 0 || OutputWidth64 <= 0) {
-            return;
-        }
-
-        int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputDepth), int64_t(InputHeight), int64_t(InputWidth) };
-        int64_t KernelShape[] = { int64_t(KernelDepth), int64_t(KernelHeight), int64_t(KernelWidth) };
-        int64_t Padding[] = { int64_t(PaddingLeftDepth), int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightDepth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
-        int64_t StrideShape[] = { int64_t(StrideDepth), int64_t(StrideHeight), int64_t(StrideWidth) };
-        int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), OutputDepth64, OutputHeight64, OutputWidth64 };
-
-        OutputShape[2] = (InputShape[2] + Padding[0] + Padding[3] - KernelShape[0]) / StrideShape[0] + 1;
-        OutputShape[3] = (InputShape[3] + Padding[1] + Padding[4] - KernelShape[1]) / StrideShape[1] + 1;
-        OutputShape[4] = (InputShape[4] + Padding[2] + Padding[5] - KernelShape[2]) / StrideShape[2] + 1;
-
-        size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3] * InputShape[4]);
-        size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3] * OutputShape[4]);
+        //
+        // The rows of both matrices are padded to test the strides.
+        //
 
-        const float* Input = BufferInput.GetBuffer(InputBufferElements);
-        float* Output = BufferOutput.GetBuffer(OutputBufferElements);
-        float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+        const size_t InputStride = N + 3;
+        const size_t OutputStride = M + 5;
 
-        MlasPool(MlasMaximumPooling, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceMaximumPool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+        ElementType* Input = BufferInput.GetBuffer(M * InputStride);
+        ElementType* Output = BufferOutput.GetBuffer(N * OutputStride);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: maximum input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                Input[m * InputStride + n] = ElementType(m * 251 + n * 17 + 3);
+            }
         }
 
-        MlasPool(MlasAveragePoolingExcludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+        MlasTranspose(Input, Output, M, N, InputStride, OutputStride);
 
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageexcpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                if (Output[n * OutputStride + m] != Input[m * InputStride + n]) {
+                    printf("mismatch Transpose: M=%zd, N=%zd, m=%zd, n=%zd\n", M, N, m, n);
+                    return;
+                }
+            }
         }
+    }
 
-        MlasPool(MlasAveragePoolingIncludePad, 3, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input, Output, threadpool);
-        ReferenceAveragePool3D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
-
-        if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
-            printf("mismatch: averageincpad input(%zd,%zd,%zd,%zd),kernel(%zd,%zd,%zd)!!!\n",
-                InputChannels, InputDepth, InputHeight, InputWidth, KernelDepth, KernelHeight, KernelWidth);
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 40; M++) {
+            for (size_t N = 1; N < 40; N++) {
+                Test(M, N);
+            }
         }
+        Test(197, 768);
+        Test(768, 197);
     }
 
     void
-    ReferenceMaximumPool3D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+template<typename QuantizedType>
+class MlasQuantizeLinearTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<QuantizedType> BufferQuantized;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    void
+    Test(
+        size_t N,
+        float Scale,
+        QuantizedType ZeroPoint
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
+        float* Input = BufferInput.GetBuffer(N);
+        QuantizedType* Quantized = BufferQuantized.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
 
-        int64_t InputDepth = InputShape[2];
-        int64_t InputHeight = InputShape[3];
-        int64_t InputWidth = InputShape[4];
+        //
+        // The values include exact halves of the scale to test the rounding
+        // to nearest even, and values outside of the range to test the
+        // saturation.
+        //
 
-        int64_t KernelDepth = KernelShape[0];
-        int64_t KernelHeight = KernelShape[1];
-        int64_t KernelWidth = KernelShape[2];
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = float(int((n * 7919) % 1201) - 600) * 0.5f * Scale;
+        }
 
-        int64_t PaddingLeftZ = Padding[0];
-        int64_t PaddingLeftY = Padding[1];
-        int64_t PaddingLeftX = Padding[2];
-        int64_t PaddingRightZ = Padding[3];
-        int64_t PaddingRightY = Padding[4];
-        int64_t PaddingRightX = Padding[5];
+        const int32_t MinimumValue = std::is_signed<QuantizedType>::value ? -127 : 0;
+        const int32_t MaximumValue = std::numeric_limits<QuantizedType>::max();
 
-        int64_t StrideDepth = StrideShape[0];
-        int64_t StrideHeight = StrideShape[1];
-        int64_t StrideWidth = StrideShape[2];
+        MlasQuantizeLinear(Input, Quantized, N, Scale, ZeroPoint);
 
-        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        for (size_t n = 0; n < N; n++) {
+            int32_t Reference = int32_t(std::nearbyint(Input[n] / Scale)) + ZeroPoint;
+            Reference = std::min(std::max(Reference, MinimumValue), MaximumValue);
+            if (Quantized[n] != QuantizedType(Reference)) {
+                printf("mismatch QuantizeLinear: N=%zd, n=%zd, input=%f, output=%d, expected=%d\n",
+                    N, n, Input[n], int(Quantized[n]), int(Reference));
+                return;
+            }
+        }
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        MlasDequantizeLinear(Quantized, Output, N, Scale, ZeroPoint);
 
-            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+        for (size_t n = 0; n < N; n++) {
+            float Reference = float(int32_t(Quantized[n]) - int32_t(ZeroPoint)) * Scale;
+            if (Output[n] != Reference) {
+                printf("mismatch DequantizeLinear: N=%zd, n=%zd, output=%f, expected=%f\n",
+                    N, n, Output[n], Reference);
+                return;
+            }
+        }
+    }
 
-                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
-                int64_t idEnd = idStart + KernelDepth;
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t N = 1; N < 40; N++) {
+            Test(N, 0.5f, QuantizedType(std::is_signed<QuantizedType>::value ? -3 : 128));
+        }
+        Test(4000, 0.03125f, QuantizedType(5));
+        Test(4000, 1.7f, QuantizedType(0));
+    }
 
-                idStart = (std::max)(idStart, int64_t(0));
-                idEnd = (std::min)(idEnd, InputDepth);
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
 
-                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+class MlasThreadingPolicyTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
 
-                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                    int64_t ihEnd = ihStart + KernelHeight;
+    void
+    TestSgemm(
+        const char* Description,
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        float* A = BufferA.GetBuffer(M * K);
+        float* B = BufferB.GetBuffer(K * N);
+        float* C = BufferC.GetBuffer(M * N);
 
-                    ihStart = (std::max)(ihStart, int64_t(0));
-                    ihEnd = (std::min)(ihEnd, InputHeight);
+        for (size_t i = 0; i < M * K; i++) {
+            A[i] = float((i % 7) - 3);
+        }
 
-                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+        for (size_t i = 0; i < K * N; i++) {
+            B[i] = float((i % 5) - 2);
+        }
 
-                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                        int64_t iwEnd = iwStart + KernelWidth;
+        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, threadpool);
 
-                        iwStart = (std::max)(iwStart, int64_t(0));
-                        iwEnd = (std::min)(iwEnd, InputWidth);
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
 
-                        float m = std::numeric_limits<float>::lowest();
+                float Reference = 0.0f;
 
-                        for (int64_t id = idStart; id < idEnd; id++) {
-                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                                    m = (std::max)(m, Input[id * InputHeight * InputWidth + ih * InputWidth + iw]);
-                                }
-                            }
-                        }
+                for (size_t k = 0; k < K; k++) {
+                    Reference += A[m * K + k] * B[k * N + n];
+                }
 
-                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
-                    }
+                if (C[m * N + n] != Reference) {
+                    printf("mismatch %s M=%zd, N=%zd, K=%zd, m=%zd, n=%zd!\n", Description, M, N, K, m, n);
+                    return;
                 }
             }
-
-            Input += InputDepth * InputHeight * InputWidth;
-            Output += OutputDepth * OutputHeight * OutputWidth;
         }
     }
 
     void
-    ReferenceAveragePool3D(
-        const int64_t* InputShape,
-        const int64_t* KernelShape,
-        const int64_t* Padding,
-        const int64_t* StrideShape,
-        const float* Input,
-        float* Output,
-        bool CountIncludePad
+    TestAllSgemm(
+        const char* Description
         )
     {
-        int64_t ChannelCount = InputShape[0] * InputShape[1];
+        TestSgemm(Description, 1, 1000, 32);
+        TestSgemm(Description, 37, 300, 64);
+        TestSgemm(Description, 300, 37, 64);
+        TestSgemm(Description, 128, 513, 17);
+    }
 
-        int64_t InputDepth = InputShape[2];
-        int64_t InputHeight = InputShape[3];
-        int64_t InputWidth = InputShape[4];
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        MLAS_COST_MODEL DefaultCostModel;
+        MLAS_THREADING_POLICY DefaultPolicy;
 
-        int64_t KernelDepth = KernelShape[0];
-        int64_t KernelHeight = KernelShape[1];
-        int64_t KernelWidth = KernelShape[2];
+        MlasGetCostModel(&DefaultCostModel);
+        MlasGetThreadingPolicy(&DefaultPolicy);
 
-        int64_t PaddingLeftZ = Padding[0];
-        int64_t PaddingLeftY = Padding[1];
-        int64_t PaddingLeftX = Padding[2];
-        int64_t PaddingRightZ = Padding[3];
-        int64_t PaddingRightY = Padding[4];
-        int64_t PaddingRightX = Padding[5];
+        //
+        // Verify that invalid cost models are rejected.
+        //
 
-        int64_t StrideDepth = StrideShape[0];
-        int64_t StrideHeight = StrideShape[1];
-        int64_t StrideWidth = StrideShape[2];
+        MLAS_COST_MODEL CostModel = DefaultCostModel;
 
-        int64_t OutputDepth = (InputDepth + PaddingLeftZ + PaddingRightZ - KernelDepth) / StrideDepth + 1;
-        int64_t OutputHeight = (InputHeight + PaddingLeftY + PaddingRightY - KernelHeight) / StrideHeight + 1;
-        int64_t OutputWidth = (InputWidth + PaddingLeftX + PaddingRightX - KernelWidth) / StrideWidth + 1;
+        CostModel.ThreadStrideNAlign = 24;
+        if (MlasSetCostModel(&CostModel)) {
+            printf("cost model with unaligned stride accepted!\n");
+        }
 
-        for (int64_t c = 0; c < ChannelCount; c++) {
+        CostModel.ThreadStrideNAlign = 8;
+        if (MlasSetCostModel(&CostModel)) {
+            printf("cost model with small stride accepted!\n");
+        }
 
-            for (int64_t pd = 0; pd < OutputDepth; pd++) {
+        CostModel = DefaultCostModel;
+        CostModel.GemmThreadComplexity = 0.0;
+        if (MlasSetCostModel(&CostModel)) {
+            printf("cost model with zero complexity accepted!\n");
+        }
 
-                int64_t idStart = pd * StrideDepth - PaddingLeftZ;
-                int64_t idEnd = idStart + KernelDepth;
+        TestAllSgemm("default");
 
-                idStart = (std::max)(idStart, int64_t(0));
-                idEnd = (std::min)(idEnd, InputDepth);
+        //
+        // Use as many threads as possible with a wide stride alignment.
+        //
 
-                for (int64_t ph = 0; ph < OutputHeight; ph++) {
+        CostModel = DefaultCostModel;
+        CostModel.GemmThreadComplexity = 1.0;
+        CostModel.ConvThreadComplexity = 1.0;
+        CostModel.ThreadStrideNAlign = 64;
+        CostModel.ComputeThreadElements = 1;
 
-                    int64_t ihStart = ph * StrideHeight - PaddingLeftY;
-                    int64_t ihEnd = ihStart + KernelHeight;
+        if (!MlasSetCostModel(&CostModel)) {
+            printf("cost model rejected!\n");
+        }
 
-                    ihStart = (std::max)(ihStart, int64_t(0));
-                    ihEnd = (std::min)(ihEnd, InputHeight);
+        TestAllSgemm("eager");
 
-                    for (int64_t pw = 0; pw < OutputWidth; pw++) {
+        //
+        // Force single threaded execution.
+        //
 
-                        int64_t iwStart = pw * StrideWidth - PaddingLeftX;
-                        int64_t iwEnd = iwStart + KernelWidth;
+        MLAS_THREADING_POLICY Policy;
+        Policy.MaximumThreadCount = 1;
+        MlasSetThreadingPolicy(&Policy);
 
-                        iwStart = (std::max)(iwStart, int64_t(0));
-                        iwEnd = (std::min)(iwEnd, InputWidth);
+        MlasGetThreadingPolicy(&Policy);
+        if (Policy.MaximumThreadCount != 1) {
+            printf("threading policy not applied!\n");
+        }
 
-                        float m = 0.0f;
+        TestAllSgemm("single threaded");
 
-                        for (int64_t id = idStart; id < idEnd; id++) {
-                            for (int64_t ih = ihStart; ih < ihEnd; ih++) {
-                                for (int64_t iw = iwStart; iw < iwEnd; iw++) {
-                                    m += Input[id * InputHeight * InputWidth + ih * InputWidth + iw];
-                                }
-                            }
-                        }
+        MlasSetThreadingPolicy(&DefaultPolicy);
 
-                        if (CountIncludePad) {
-                            m /= (KernelDepth * KernelHeight * KernelWidth);
-                        } else {
-                            m /= (idEnd - idStart) * (ihEnd - ihStart) * (iwEnd - iwStart);
-                        }
+        //
+        // Verify that the calibrated cost model is valid.
+        //
 
-                        Output[pd * OutputHeight * OutputWidth + ph * OutputWidth + pw] = m;
-                    }
-                }
-            }
+        MlasCalibrateCostModel(threadpool);
+        MlasGetCostModel(&CostModel);
 
-            Input += InputDepth * InputHeight * InputWidth;
-            Output += OutputDepth * OutputHeight * OutputWidth;
+        if (!MlasSetCostModel(&CostModel)) {
+            printf("calibrated cost model rejected!\n");
         }
-    }
 
-    MatrixGuardBuffer<float> BufferInput;
-    MatrixGuardBuffer<float> BufferOutput;
-    MatrixGuardBuffer<float> BufferOutputReference;
+        TestAllSgemm("calibrated");
 
-public:
-    void
-    ExecuteShort(
-        void
-        ) override
-    {
-        for (unsigned i = 1; i < 64; i <<= 1) {
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 2, 2, 2);
-            Test(1, 16, i, i, i, 3, 3, 3, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, i, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-            Test(1, 16, i, i, i, 1, 1, i, 0, 0, 0, 0, 0, 0, 1, 1, 1);
-        }
+        MlasSetCostModel(&DefaultCostModel);
     }
 
     void
@@ -1822,48 +3697,10 @@ public:
         void
         ) override
     {
-        static const unsigned is[] = { 11, 5, 4, 3, 2, 1 };
-
-        for (unsigned id = 0; id < _countof(is); id++) {
-            for (unsigned ih = 0; ih < _countof(is); ih++) {
-                for (unsigned iw = 0; iw < _countof(is); iw++) {
-                    fprintf(stderr, "Handling %ux%ux%u\n", is[id], is[ih], is[iw]);
-                    Test(1, 1, is[id], is[ih], is[iw], is[id], is[ih], is[iw], 0, 0, 0, 0, 0, 0, 1, 1, 1);
-                    for (unsigned kd = 1; kd <= 4; kd++) {
-                        if (kd > is[id]) break;
-                        for (unsigned kh = 1; kh <= 4; kh++) {
-                            if (kh > is[ih]) break;
-                            for (unsigned kw = 1; kw <= 4; kw++) {
-                                if (kw > is[iw]) break;
-                                for (unsigned sd = 1; sd <= 3; sd++) {
-                                    for (unsigned sh = 1; sh <= 3; sh++) {
-                                        for (unsigned sw = 1; sw <= 3; sw++) {
-                                            for (unsigned p0 = 0; p0 < kd; p0++) {
-                                                for (unsigned p1 = 0; p1 < kh; p1++) {
-                                                    for (unsigned p2 = 0; p2 < kw; p2++) {
-                                                        for (unsigned p3 = 0; p3 < kd; p3++) {
-                                                            for (unsigned p4 = 0; p4 < kh; p4++) {
-                                                                for (unsigned p5 = 0; p5 < kw; p5++) {
-                                                                    Test(1, 1, is[id], is[ih], is[iw], kd, kh, kw, p0, p1, p2, p3, p4, p5, sd, sh, sw);
-                                                                }
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
     }
 };
 
-class MlasActivationTest : public MlasTestBase
+class MlasTuningTest : public MlasTestBase
 {
 public:
     void
@@ -1871,83 +3708,77 @@ public:
         void
         ) override
     {
-        union AliasedValue {
-            unsigned u;
-            float f;
-        };
+        MLAS_COST_MODEL DefaultCostModel;
 
-        // N.B. The test data includes values at the edge of Tanh/Logistic boundaries.
-        //    Identity,     Relu,         LeakyRelu,    Tanh,         Logistic,     Clip,
-        static const AliasedValue TestData[20][6] = {
-            { {0x00000001}, {0x00000001}, {0x00000001}, {0x00000000}, {0x3f000000}, {0x00000001}, }, // positive denormal
-            { {0x80000001}, {0x00000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x00000000}, }, // negative denormal
-            { {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, {0x7ff00002}, }, // positive NaN
-            { {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, {0xfff00002}, }, // negative NaN
-            { {0x00000000}, {0x00000000}, {0x00000000}, {0x00000000}, {0x3f000000}, {0x00000000}, }, // 0.0f
-            { {0x80000000}, {0x80000000}, {0x80000000}, {0x80000000}, {0x3f000000}, {0x80000000}, }, // -0.0f
-            { {0x3e800000}, {0x3e800000}, {0x3e800000}, {0x3e7acbf5}, {0x3f0feacc}, {0x3e800000}, }, // 0.25f
-            { {0xbe800000}, {0x00000000}, {0xbd4ccccd}, {0xbe7acbf5}, {0x3ee02a67}, {0x00000000}, }, // -0.25f
-            { {0x40800000}, {0x40800000}, {0x40800000}, {0x3f7fd40a}, {0x3f7b6541}, {0x40800000}, }, // 4.0f
-            { {0xc0800000}, {0x00000000}, {0xbf4ccccd}, {0xbf7fd40a}, {0x3c9357e0}, {0x00000000}, }, // -4.0f
-            { {0x41200000}, {0x41200000}, {0x41200000}, {0x3f800000}, {0x3f7ffd06}, {0x40c00000}, }, // 10.0f
-            { {0xc1200000}, {0x00000000}, {0xc0000000}, {0xbf800000}, {0x383e6000}, {0x00000000}, }, // -10.0f
-            { {0xc18866eb}, {0x00000000}, {0xc05a3e45}, {0xbf800000}, {0x33000000}, {0x00000000}, }, // -17.0502529144f
-            { {0xc18869bb}, {0x00000000}, {0xc05a42c5}, {0xbf800000}, {0x33c00000}, {0x00000000}, }, // -17.0516262054f
-            { {0xc18852a8}, {0x00000000}, {0xc05a1dda}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0403594971f
-            { {0xc18844aa}, {0x00000000}, {0xc05a0777}, {0xbf800000}, {0x00000000}, {0x00000000}, }, // -17.0335273743f
-            { {0x418866eb}, {0x418866eb}, {0x418866eb}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0502529144f
-            { {0x418869bb}, {0x418869bb}, {0x418869bb}, {0x3f800000}, {0x3f7ffffe}, {0x40c00000}, }, // +17.0516262054f
-            { {0x418852a8}, {0x418852a8}, {0x418852a8}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0403594971f
-            { {0x418844aa}, {0x418844aa}, {0x418844aa}, {0x3f800000}, {0x3f800000}, {0x40c00000}, }, // +17.0335273743f
+        MlasGetCostModel(&DefaultCostModel);
+
+        //
+        // Verify that invalid tuning parameters are rejected.
+        //
+
+        static const char* InvalidParameters[][2] = {
+            { "UnknownParameter", "1" },
+            { "GemmThreadComplexity", "abc" },
+            { "GemmThreadComplexity", "12x" },
+            { "ThreadStrideNAlign", "24" },
+            { "ComputeThreadElements", "0" },
+            { "SgemmKernel", "unknown" },
+            { "NchwcBlockSize", "4" },
         };
 
-        MLAS_ACTIVATION Activation;
-        AliasedValue Buffer[_countof(TestData)];
+        for (size_t i = 0; i < _countof(InvalidParameters); i++) {
+            if (MlasSetTuningParameter(InvalidParameters[i][0], InvalidParameters[i][1])) {
+                printf("invalid tuning parameter %s=%s accepted!\n", InvalidParameters[i][0], InvalidParameters[i][1]);
+            }
+        }
 
-        for (unsigned kind = 0; kind < unsigned(MlasClipActivation); kind++) {
+        MLAS_COST_MODEL CostModel;
 
-            Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
+        if (!MlasSetTuningParameter("ThreadStrideNAlign", "32") ||
+            !MlasSetTuningParameter("GemmThreadComplexity", "65536")) {
+            printf("tuning parameter rejected!\n");
+        }
 
-            if (Activation.ActivationKind == MlasLeakyReluActivation) {
-                Activation.Parameters.LeakyRelu.alpha = 0.2f;
-            } else if (Activation.ActivationKind == MlasClipActivation) {
-                Activation.Parameters.Clip.minimum = 0.0f;
-                Activation.Parameters.Clip.maximum = 6.0f;
-            }
+        MlasGetCostModel(&CostModel);
 
-            //
-            // Test the vectorized activations.
-            //
+        if (CostModel.ThreadStrideNAlign != 32 || CostModel.GemmThreadComplexity != 65536.0) {
+            printf("tuning parameter not applied!\n");
+        }
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                Buffer[i].u = TestData[i][0].u;
-            }
+        MlasSetCostModel(&DefaultCostModel);
 
-            MlasActivation(&Activation, &Buffer[0].f, nullptr, _countof(Buffer), 1, 1);
+#if defined(_M_AMD64) || defined(__x86_64__)
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                // Sensitive to comparing positive/negative zero and NaNs.
-                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
-                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
-                }
+        //
+        // Run the SGEMM tests with each supported kernel. The kernels are in
+        // order of the required processor features, so the default kernel is
+        // selected again by the last iteration.
+        //
+
+        for (const char* KernelIsa : { "sse", "avx", "fma3", "avx512f" }) {
+            if (MlasSetTuningParameter("SgemmKernel", KernelIsa)) {
+                std::make_unique<MlasSgemmTest>()->ExecuteShort();
             }
+        }
 
-            //
-            // Test the scalar activations.
-            //
+        //
+        // Run the NCHWc tests with the smaller block size if the larger block
+        // size is the default.
+        //
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                Buffer[i].u = TestData[i][0].u;
-                MlasActivation(&Activation, &Buffer[i].f, nullptr, 1, 1, 1);
-            }
+        if (MlasNchwcGetBlockSize() == 16) {
 
-            for (unsigned i = 0; i < _countof(TestData); i++) {
-                // Sensitive to comparing positive/negative zero and NaNs.
-                if (Buffer[i].u != TestData[i][kind].u && Buffer[i].f != TestData[i][kind].f) {
-                    printf("mismatch activation kind=%d i=%d value=%08x expected=%08x\n", kind, i, Buffer[i].u, TestData[i][kind].u);
-                }
+            if (!MlasSetTuningParameter("NchwcBlockSize", "8") || MlasNchwcGetBlockSize() != 8) {
+                printf("NCHWc block size not applied!\n");
             }
+
+            std::make_unique<MlasNchwcConv2DTest>()->ExecuteShort();
+            std::make_unique<MlasNchwcPool2DTest>()->ExecuteShort();
+
+            MlasSetTuningParameter("NchwcBlockSize", "16");
         }
+
+#endif
     }
 
     void
@@ -1970,6 +3801,19 @@ main(
         printf("SGEMM tests.\n");
         std::make_unique<MlasSgemmTest>()->ExecuteShort();
 
+        printf("Half precision GEMM tests.\n");
+        std::make_unique<MlasHalfGemmTest<false>>()->ExecuteShort();
+        std::make_unique<MlasHalfGemmTest<true>>()->ExecuteShort();
+
+        printf("Half precision conversion tests.\n");
+        std::make_unique<MlasHalfConversionTest>()->ExecuteShort();
+
+        printf("Sparse GEMM tests.\n");
+        std::make_unique<MlasSparseGemmTest>()->ExecuteShort();
+
+        printf("Block quantized GEMM tests.\n");
+        std::make_unique<MlasBlockQuantGemmTest>()->ExecuteShort();
+
 #ifdef MLAS_HAS_QGEMM_U8U8
         printf("QGEMM tests.\n");
         std::make_unique<MlasQgemmU8U8Test>()->ExecuteShort();
@@ -1987,11 +3831,34 @@ main(
             std::make_unique<MlasNchwcPool2DTest>()->ExecuteShort();
         }
 
+        if (MlasNchwcGetBlockSize() > 1) {
+            printf("NCHWc upsample tests.\n");
+            std::make_unique<MlasNchwcUpsampleTest>()->ExecuteShort();
+        }
+
         printf("Pool3D tests.\n");
         std::make_unique<MlasPool3DTest>()->ExecuteShort();
 
         printf("Activation tests.\n");
         std::make_unique<MlasActivationTest>()->ExecuteShort();
+        std::make_unique<MlasActivationReferenceTest>()->ExecuteShort();
+
+        printf("Softmax and reduction tests.\n");
+        std::make_unique<MlasComputeTest>()->ExecuteShort();
+
+        printf("Transpose tests.\n");
+        std::make_unique<MlasTransposeTest<uint32_t>>()->ExecuteShort();
+        std::make_unique<MlasTransposeTest<uint8_t>>()->ExecuteShort();
+
+        printf("QuantizeLinear tests.\n");
+        std::make_unique<MlasQuantizeLinearTest<uint8_t>>()->ExecuteShort();
+        std::make_unique<MlasQuantizeLinearTest<int8_t>>()->ExecuteShort();
+
+        printf("Threading policy and cost model tests.\n");
+        std::make_unique<MlasThreadingPolicyTest>()->ExecuteShort();
+
+        printf("Tuning tests.\n");
+        std::make_unique<MlasTuningTest>()->ExecuteShort();
 
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
@@ -0,0 +1,388 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/onnxruntime_c_api.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmarks of single CPU kernels: each builds a model of one node, and times OrtRun of the session over it, so
+// the time includes the per run overhead of the session, which is small next to the sizes used here. The last
+// argument of each is the size of the session thread pool, 0 to run the kernel on the calling thread.
+
+extern OrtEnv* env;
+
+static bool SkipOnError(benchmark::State& state, OrtStatus* status) {
+  if (status == nullptr) {
+    return false;
+  }
+  state.SkipWithError(OrtGetErrorMessage(status));
+  OrtReleaseStatus(status);
+  return true;
+}
+
+static std::vector<float> RandomFloats(size_t count) {
+  std::mt19937 rand_engine(1234);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(count);
+  for (auto& value : values) {
+    value = dist(rand_engine);
+  }
+  return values;
+}
+
+static int64_t ElementCount(const std::vector<int64_t>& shape) {
+  int64_t count = 1;
+  for (int64_t dim : shape) {
+    count *= dim;
+  }
+  return count;
+}
+
+// A model of a single node, whose inputs and outputs are the inputs and outputs of the graph.
+class NodeModel {
+ public:
+  explicit NodeModel(const char* op_type, const char* domain = "") {
+    model_.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+    auto* opset = model_.add_opset_import();
+    opset->set_domain("");
+    opset->set_version(10);
+    if (*domain != '\0') {
+      opset = model_.add_opset_import();
+      opset->set_domain(domain);
+      opset->set_version(1);
+    }
+
+    auto* graph = model_.mutable_graph();
+    graph->set_name(op_type);
+    node_ = graph->add_node();
+    node_->set_op_type(op_type);
+    node_->set_domain(domain);
+  }
+
+  void AddInput(const char* name, const std::vector<int64_t>& shape,
+                ONNX_NAMESPACE::TensorProto_DataType elem_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    node_->add_input(name);
+    SetValueInfo(model_.mutable_graph()->add_input(), name, elem_type, &shape);
+  }
+
+  // An input of the node that's a constant of the graph.
+  void AddInitializer(const char* name, const std::vector<int64_t>& shape, const std::vector<float>& values) {
+    node_->add_input(name);
+    auto* initializer = model_.mutable_graph()->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (int64_t dim : shape) {
+      initializer->add_dims(dim);
+    }
+    initializer->set_raw_data(values.data(), values.size() * sizeof(float));
+  }
+
+  void AddOutput(const char* name) {
+    node_->add_output(name);
+    SetValueInfo(model_.mutable_graph()->add_output(), name, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, nullptr);
+  }
+
+  ONNX_NAMESPACE::AttributeProto* AddAttribute(const char* name, ONNX_NAMESPACE::AttributeProto_AttributeType type) {
+    auto* attribute = node_->add_attribute();
+    attribute->set_name(name);
+    attribute->set_type(type);
+    return attribute;
+  }
+
+  void AddAttribute(const char* name, int64_t value) {
+    AddAttribute(name, ONNX_NAMESPACE::AttributeProto_AttributeType_INT)->set_i(value);
+  }
+
+  void AddAttribute(const char* name, const std::vector<int64_t>& values) {
+    auto* attribute = AddAttribute(name, ONNX_NAMESPACE::AttributeProto_AttributeType_INTS);
+    for (int64_t value : values) {
+      attribute->add_ints(value);
+    }
+  }
+
+  void AddAttribute(const char* name, const std::vector<float>& values) {
+    auto* attribute = AddAttribute(name, ONNX_NAMESPACE::AttributeProto_AttributeType_FLOATS);
+    for (float value : values) {
+      attribute->add_floats(value);
+    }
+  }
+
+  void AddAttribute(const char* name, const std::vector<std::string>& values) {
+    auto* attribute = AddAttribute(name, ONNX_NAMESPACE::AttributeProto_AttributeType_STRINGS);
+    for (const auto& value : values) {
+      attribute->add_strings(value);
+    }
+  }
+
+  std::string Serialize() const { return model_.SerializeAsString(); }
+
+ private:
+  static void SetValueInfo(ONNX_NAMESPACE::ValueInfoProto* value_info, const char* name,
+                           ONNX_NAMESPACE::TensorProto_DataType elem_type, const std::vector<int64_t>* shape) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(elem_type);
+    if (shape != nullptr) {
+      for (int64_t dim : *shape) {
+        tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+      }
+    }
+  }
+
+  ONNX_NAMESPACE::ModelProto model_;
+  ONNX_NAMESPACE::NodeProto* node_;
+};
+
+// A session over a NodeModel, with the values of the inputs it's run with.
+class NodeSession {
+ public:
+  NodeSession(benchmark::State& state, const NodeModel& model, int64_t thread_count) : state_(state) {
+    OrtSessionOptions* session_options;
+    if (SkipOnError(state_, OrtCreateSessionOptions(&session_options))) {
+      return;
+    }
+    const std::string model_data = model.Serialize();
+    if (!SkipOnError(state_, OrtSetSessionThreadPoolSize(session_options, static_cast<int>(thread_count)))) {
+      SkipOnError(state_, OrtCreateSessionFromArray(env, model_data.data(), model_data.size(), session_options,
+                                                    &session_));
+    }
+    OrtReleaseSessionOptions(session_options);
+    SkipOnError(state_, OrtCreateCpuAllocatorInfo(OrtDeviceAllocator, OrtMemTypeDefault, &memory_info_));
+  }
+
+  ~NodeSession() {
+    for (OrtValue* input : inputs_) {
+      OrtReleaseValue(input);
+    }
+    if (memory_info_ != nullptr) {
+      OrtReleaseMemoryInfo(memory_info_);
+    }
+    if (session_ != nullptr) {
+      OrtReleaseSession(session_);
+    }
+  }
+
+  void AddInput(const char* name, const std::vector<int64_t>& shape, std::vector<float> values) {
+    float_buffers_.push_back(std::move(values));
+    AddInput(name, shape, float_buffers_.back().data(), float_buffers_.back().size() * sizeof(float),
+             ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  }
+
+  void AddInput(const char* name, const std::vector<int64_t>& shape, std::vector<int64_t> values) {
+    int64_buffers_.push_back(std::move(values));
+    AddInput(name, shape, int64_buffers_.back().data(), int64_buffers_.back().size() * sizeof(int64_t),
+             ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+  }
+
+  // Runs the session for every iteration of the benchmark.
+  void Run(const char* output_name) {
+    if (session_ == nullptr || memory_info_ == nullptr || inputs_.size() != input_names_.size()) {
+      return;
+    }
+    for (auto _ : state_) {
+      OrtValue* output = nullptr;
+      if (SkipOnError(state_, OrtRun(session_, nullptr, input_names_.data(), inputs_.data(), inputs_.size(),
+                                     &output_name, 1, &output))) {
+        break;
+      }
+      OrtReleaseValue(output);
+    }
+  }
+
+ private:
+  void AddInput(const char* name, const std::vector<int64_t>& shape, void* data, size_t data_length,
+                ONNXTensorElementDataType type) {
+    input_names_.push_back(name);
+    if (memory_info_ == nullptr) {
+      return;
+    }
+    OrtValue* input = nullptr;
+    if (!SkipOnError(state_, OrtCreateTensorWithDataAsOrtValue(memory_info_, data, data_length, shape.data(),
+                                                               shape.size(), type, &input))) {
+      inputs_.push_back(input);
+    }
+  }
+
+  benchmark::State& state_;
+  OrtSession* session_ = nullptr;
+  OrtMemoryInfo* memory_info_ = nullptr;
+  std::vector<const char*> input_names_;
+  std::vector<OrtValue*> inputs_;
+  // the buffers of the inputs, which mustn't move while the session runs
+  std::vector<std::vector<float>> float_buffers_;
+  std::vector<std::vector<int64_t>> int64_buffers_;
+};
+
+// The bytes the kernel reads and writes in each iteration, reported as a rate.
+static void SetBytesProcessed(benchmark::State& state, int64_t bytes_per_iteration) {
+  state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+}
+
+// N, C, H, W, threads: transposes NCHW to NHWC.
+static void BM_Transpose(benchmark::State& state) {
+  const std::vector<int64_t> shape{state.range(0), state.range(1), state.range(2), state.range(3)};
+  NodeModel model("Transpose");
+  model.AddInput("X", shape);
+  model.AddOutput("Y");
+  model.AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+
+  NodeSession session(state, model, state.range(4));
+  session.AddInput("X", shape, RandomFloats(ElementCount(shape)));
+  session.Run("Y");
+  SetBytesProcessed(state, 2 * ElementCount(shape) * sizeof(float));
+}
+BENCHMARK(BM_Transpose)
+    ->ArgNames({"N", "C", "H", "W", "threads"})
+    ->Args({1, 64, 56, 56, 0})
+    ->Args({1, 256, 14, 14, 0})
+    ->Args({8, 64, 56, 56, 0})
+    ->Args({8, 64, 56, 56, 4})
+    ->UseRealTime();
+
+// Rows of the data, columns, indices, threads: gathers rows of an embedding table.
+static void BM_Gather(benchmark::State& state) {
+  const std::vector<int64_t> data_shape{state.range(0), state.range(1)};
+  const int64_t index_count = state.range(2);
+  NodeModel model("Gather");
+  model.AddInput("X", data_shape);
+  model.AddInput("I", {index_count}, ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  model.AddOutput("Y");
+  model.AddAttribute("axis", int64_t{0});
+
+  std::mt19937 rand_engine(1234);
+  std::uniform_int_distribution<int64_t> dist(0, data_shape[0] - 1);
+  std::vector<int64_t> indices(index_count);
+  for (auto& index : indices) {
+    index = dist(rand_engine);
+  }
+
+  NodeSession session(state, model, state.range(3));
+  session.AddInput("X", data_shape, RandomFloats(ElementCount(data_shape)));
+  session.AddInput("I", {index_count}, std::move(indices));
+  session.Run("Y");
+  SetBytesProcessed(state, 2 * index_count * data_shape[1] * sizeof(float));
+}
+BENCHMARK(BM_Gather)
+    ->ArgNames({"rows", "cols", "indices", "threads"})
+    ->Args({30522, 768, 128, 0})
+    ->Args({30522, 768, 4096, 0})
+    ->Args({30522, 768, 4096, 4})
+    ->UseRealTime();
+
+// Rows, columns, threads: the softmax of each row.
+static void BM_Softmax(benchmark::State& state) {
+  const std::vector<int64_t> shape{state.range(0), state.range(1)};
+  NodeModel model("Softmax");
+  model.AddInput("X", shape);
+  model.AddOutput("Y");
+  model.AddAttribute("axis", int64_t{1});
+
+  NodeSession session(state, model, state.range(2));
+  session.AddInput("X", shape, RandomFloats(ElementCount(shape)));
+  session.Run("Y");
+  state.SetItemsProcessed(state.iterations() * ElementCount(shape));
+}
+BENCHMARK(BM_Softmax)
+    ->ArgNames({"rows", "cols", "threads"})
+    ->Args({1, 1000, 0})
+    ->Args({1536, 128, 0})
+    ->Args({128, 30522, 0})
+    ->Args({128, 30522, 4})
+    ->UseRealTime();
+
+// Sequence length, batch, input size, hidden size, threads: a forward LSTM.
+static void BM_LSTM(benchmark::State& state) {
+  const int64_t seq_length = state.range(0);
+  const int64_t batch_size = state.range(1);
+  const int64_t input_size = state.range(2);
+  const int64_t hidden_size = state.range(3);
+  const std::vector<int64_t> shape{seq_length, batch_size, input_size};
+  NodeModel model("LSTM");
+  model.AddInput("X", shape);
+  model.AddInitializer("W", {1, 4 * hidden_size, input_size}, RandomFloats(4 * hidden_size * input_size));
+  model.AddInitializer("R", {1, 4 * hidden_size, hidden_size}, RandomFloats(4 * hidden_size * hidden_size));
+  model.AddInitializer("B", {1, 8 * hidden_size}, RandomFloats(8 * hidden_size));
+  model.AddOutput("Y");
+  model.AddAttribute("hidden_size", hidden_size);
+
+  NodeSession session(state, model, state.range(4));
+  session.AddInput("X", shape, RandomFloats(ElementCount(shape)));
+  session.Run("Y");
+  const double flops = 2.0 * seq_length * batch_size * 4 * hidden_size * (input_size + hidden_size);
+  state.counters["FLOPS"] = benchmark::Counter(flops * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_LSTM)
+    ->ArgNames({"seq", "batch", "input", "hidden", "threads"})
+    ->Args({32, 1, 128, 128, 0})
+    ->Args({32, 16, 256, 256, 0})
+    ->Args({32, 16, 256, 256, 4})
+    ->UseRealTime();
+
+// Rows, features, trees, tree depth, threads: a regressor of complete binary trees.
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  const int64_t row_count = state.range(0);
+  const int64_t feature_count = state.range(1);
+  const int64_t tree_count = state.range(2);
+  const int64_t depth = state.range(3);
+  const int64_t node_count = (int64_t{1} << (depth + 1)) - 1;
+
+  std::mt19937 rand_engine(1234);
+  std::uniform_int_distribution<int64_t> feature_dist(0, feature_count - 1);
+  std::uniform_real_distribution<float> value_dist(-1.0f, 1.0f);
+  std::vector<int64_t> true_node_ids, false_node_ids, tree_ids, node_ids, feature_ids;
+  std::vector<int64_t> target_tree_ids, target_node_ids, target_ids;
+  std::vector<float> values, target_weights;
+  std::vector<std::string> modes;
+  for (int64_t tree_id = 0; tree_id < tree_count; ++tree_id) {
+    for (int64_t node_id = 0; node_id < node_count; ++node_id) {
+      // the children of node i are 2i + 1 and 2i + 2, and the nodes of the last level are leaves
+      const bool is_leaf = 2 * node_id + 1 >= node_count;
+      tree_ids.push_back(tree_id);
+      node_ids.push_back(node_id);
+      true_node_ids.push_back(is_leaf ? 0 : 2 * node_id + 1);
+      false_node_ids.push_back(is_leaf ? 0 : 2 * node_id + 2);
+      feature_ids.push_back(is_leaf ? 0 : feature_dist(rand_engine));
+      values.push_back(is_leaf ? 0.0f : value_dist(rand_engine));
+      modes.push_back(is_leaf ? "LEAF" : "BRANCH_LEQ");
+      if (is_leaf) {
+        target_tree_ids.push_back(tree_id);
+        target_node_ids.push_back(node_id);
+        target_ids.push_back(0);
+        target_weights.push_back(value_dist(rand_engine));
+      }
+    }
+  }
+
+  const std::vector<int64_t> shape{row_count, feature_count};
+  NodeModel model("TreeEnsembleRegressor", "ai.onnx.ml");
+  model.AddInput("X", shape);
+  model.AddOutput("Y");
+  model.AddAttribute("nodes_truenodeids", true_node_ids);
+  model.AddAttribute("nodes_falsenodeids", false_node_ids);
+  model.AddAttribute("nodes_treeids", tree_ids);
+  model.AddAttribute("nodes_nodeids", node_ids);
+  model.AddAttribute("nodes_featureids", feature_ids);
+  model.AddAttribute("nodes_values", values);
+  model.AddAttribute("nodes_modes", modes);
+  model.AddAttribute("target_treeids", target_tree_ids);
+  model.AddAttribute("target_nodeids", target_node_ids);
+  model.AddAttribute("target_ids", target_ids);
+  model.AddAttribute("target_weights", target_weights);
+  model.AddAttribute("n_targets", int64_t{1});
+
+  NodeSession session(state, model, state.range(4));
+  session.AddInput("X", shape, RandomFloats(ElementCount(shape)));
+  session.Run("Y");
+  state.SetItemsProcessed(state.iterations() * row_count);
+}
+BENCHMARK(BM_TreeEnsembleRegressor)
+    ->ArgNames({"rows", "features", "trees", "depth", "threads"})
+    ->Args({1, 100, 100, 6, 0})
+    ->Args({1000, 100, 100, 6, 0})
+    ->Args({1000, 100, 100, 6, 4})
+    ->Args({1000, 100, 500, 10, 4})
+    ->UseRealTime();
@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/mlas/inc/mlas.h>
+#include <core/platform/threadpool.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Benchmarks of the MLAS routines behind the CPU kernels. The last argument of each is the number of threads of the
+// thread pool passed to MLAS, 0 for none, which runs the routine on the calling thread.
+
+static MLAS_THREADPOOL* GetThreadPool(int64_t thread_count) {
+  static std::map<int64_t, std::unique_ptr<onnxruntime::concurrency::ThreadPool>> thread_pools;
+  if (thread_count == 0) {
+    return nullptr;
+  }
+  auto& thread_pool = thread_pools[thread_count];
+  if (thread_pool == nullptr) {
+    thread_pool = std::make_unique<onnxruntime::concurrency::ThreadPool>("mlas_benchmark",
+                                                                        static_cast<int>(thread_count));
+  }
+  return thread_pool.get();
+}
+
+template <typename T>
+static std::vector<T> RandomBuffer(size_t count) {
+  std::mt19937 rand_engine(1234);
+  std::uniform_int_distribution<int> dist(-64, 63);
+  std::vector<T> buffer(count);
+  for (auto& value : buffer) {
+    value = static_cast<T>(dist(rand_engine) + (std::is_signed<T>::value || std::is_floating_point<T>::value ? 0 : 64));
+  }
+  return buffer;
+}
+
+// The operations the routine does in each iteration, reported as a rate.
+static void SetFlops(benchmark::State& state, double flops_per_iteration) {
+  state.counters["FLOPS"] = benchmark::Counter(flops_per_iteration * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+static void ThreadCounts(benchmark::internal::Benchmark* b, const std::vector<std::vector<int64_t>>& shapes) {
+  for (const auto& shape : shapes) {
+    for (int64_t thread_count : {0, 4}) {
+      std::vector<int64_t> args = shape;
+      args.push_back(thread_count);
+      b->Args(args);
+    }
+  }
+}
+
+// M, N, K, threads: the shapes of square matrices, of the fully connected layers of a BERT base encoder over 128
+// tokens, and of a batch 1 classifier.
+static void GemmShapes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "threads"});
+  ThreadCounts(b, {{64, 64, 64}, {256, 256, 256}, {1024, 1024, 1024},
+                   {128, 768, 768}, {128, 3072, 768}, {128, 768, 3072},
+                   {1, 1000, 2048}});
+}
+
+static void BM_MlasSgemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(3));
+  auto A = RandomBuffer<float>(M * K);
+  auto B = RandomBuffer<float>(K * N);
+  std::vector<float> C(M * N);
+  for (auto _ : state) {
+    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A.data(), K, B.data(), N, 0.0f, C.data(), N, thread_pool);
+  }
+  SetFlops(state, 2.0 * M * N * K);
+}
+BENCHMARK(BM_MlasSgemm)->Apply(GemmShapes)->UseRealTime();
+
+static void BM_MlasSgemmPacked(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(3));
+  auto A = RandomBuffer<float>(M * K);
+  auto B = RandomBuffer<float>(K * N);
+  std::vector<uint8_t> packed_B(MlasGemmPackBSize(N, K));
+  MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, packed_B.data());
+  std::vector<float> C(M * N);
+  for (auto _ : state) {
+    MlasSgemmPacked(CblasNoTrans, M, N, K, 1.0f, A.data(), K, packed_B.data(), 0.0f, C.data(), N, thread_pool);
+  }
+  SetFlops(state, 2.0 * M * N * K);
+}
+BENCHMARK(BM_MlasSgemmPacked)->Apply(GemmShapes)->UseRealTime();
+
+// M, N, K, threads, with B signed if the fifth argument is 1.
+static void BM_MlasQgemm(benchmark::State& state) {
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(3));
+  auto A = RandomBuffer<uint8_t>(M * K);
+  auto B = RandomBuffer<uint8_t>(K * N);
+  std::vector<int32_t> C(M * N);
+  const uint8_t zero_point_b = 0;
+
+  MLAS_GEMM_U8X8_PARAMETERS parameters;
+  parameters.M = M;
+  parameters.N = N;
+  parameters.K = K;
+  parameters.A = A.data();
+  parameters.lda = K;
+  parameters.ZeroPointA = 128;
+  parameters.B = B.data();
+  parameters.ldb = N;
+  parameters.ZeroPointB = &zero_point_b;
+  parameters.BIsSigned = state.range(4) != 0;
+  parameters.C = C.data();
+  parameters.ldc = N;
+  for (auto _ : state) {
+    MlasGemm(&parameters, thread_pool);
+  }
+  SetFlops(state, 2.0 * M * N * K);
+}
+BENCHMARK(BM_MlasQgemm)
+    ->ArgNames({"M", "N", "K", "threads", "signed_b"})
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      const std::vector<std::vector<int64_t>> shapes{{256, 256, 256}, {128, 768, 768}, {128, 3072, 768},
+                                                     {1, 1000, 2048}};
+      for (int64_t signed_b : {0, 1}) {
+        for (const auto& shape : shapes) {
+          for (int64_t thread_count : {0, 4}) {
+            b->Args({shape[0], shape[1], shape[2], thread_count, signed_b});
+          }
+        }
+      }
+    })
+    ->UseRealTime();
+
+// The 2D convolutions of ResNet-50: batch, input channels, input size, filters, kernel size, stride, threads.
+static void ConvShapes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "HW", "F", "K", "S", "threads"});
+  ThreadCounts(b, {{1, 3, 224, 64, 7, 2}, {1, 64, 56, 64, 3, 1}, {1, 64, 56, 256, 1, 1}, {1, 256, 56, 64, 1, 1},
+                   {1, 128, 28, 128, 3, 1}, {1, 256, 14, 256, 3, 1}, {1, 512, 7, 512, 3, 1}});
+}
+
+struct ConvShape {
+  explicit ConvShape(benchmark::State& state)
+      : batch(state.range(0)), channels(state.range(1)), input_size(state.range(2)), filters(state.range(3)),
+        kernel_size(state.range(4)), stride(state.range(5)), padding(kernel_size / 2),
+        output_size((input_size + 2 * padding - kernel_size) / stride + 1) {}
+
+  double Flops() const {
+    return 2.0 * batch * filters * output_size * output_size * channels * kernel_size * kernel_size;
+  }
+
+  int64_t batch, channels, input_size, filters, kernel_size, stride, padding, output_size;
+};
+
+static void BM_MlasConv(benchmark::State& state) {
+  const ConvShape shape(state);
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(6));
+  const int64_t input_shape[] = {shape.input_size, shape.input_size};
+  const int64_t kernel_shape[] = {shape.kernel_size, shape.kernel_size};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {shape.padding, shape.padding, shape.padding, shape.padding};
+  const int64_t stride_shape[] = {shape.stride, shape.stride};
+  const int64_t output_shape[] = {shape.output_size, shape.output_size};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  MLAS_CONV_PARAMETERS parameters;
+  size_t working_buffer_size;
+  MlasConvPrepare(&parameters, 2, static_cast<size_t>(shape.batch), 1, static_cast<size_t>(shape.channels),
+                  input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(shape.filters), &activation, &working_buffer_size, thread_pool);
+
+  auto input = RandomBuffer<float>(shape.batch * shape.channels * shape.input_size * shape.input_size);
+  auto filter = RandomBuffer<float>(shape.filters * shape.channels * shape.kernel_size * shape.kernel_size);
+  std::vector<float> bias(shape.filters);
+  std::vector<float> working_buffer(working_buffer_size);
+  std::vector<float> output(shape.batch * shape.filters * shape.output_size * shape.output_size);
+  if (parameters.Algorithm == MlasConvAlgorithmWinograd) {
+    // the filter of a Winograd convolution is transformed once, as the kernel does for a constant filter
+    std::vector<float> transformed_filter(MlasConvWinogradFilterSize(&parameters));
+    MlasConvWinogradTransformFilter(&parameters, filter.data(), transformed_filter.data());
+    filter = std::move(transformed_filter);
+  }
+  for (auto _ : state) {
+    MlasConv(&parameters, input.data(), filter.data(), bias.data(), working_buffer.data(), output.data(),
+             thread_pool);
+  }
+  SetFlops(state, shape.Flops());
+  state.SetLabel(parameters.Algorithm == MlasConvAlgorithmWinograd ? "winograd" : "");
+}
+BENCHMARK(BM_MlasConv)->Apply(ConvShapes)->UseRealTime();
+
+static void BM_MlasNchwcConv(benchmark::State& state) {
+  const size_t block_size = MlasNchwcGetBlockSize();
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc isn't supported on this platform");
+    return;
+  }
+
+  const ConvShape shape(state);
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(6));
+  auto align = [block_size](int64_t channels) {
+    return static_cast<int64_t>((static_cast<size_t>(channels) + block_size - 1) & ~(block_size - 1));
+  };
+  const int64_t nchwc_channels = align(shape.channels);
+  const int64_t nchwc_filters = align(shape.filters);
+  const int64_t input_shape[] = {shape.batch, nchwc_channels, shape.input_size, shape.input_size};
+  const int64_t kernel_shape[] = {shape.kernel_size, shape.kernel_size};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {shape.padding, shape.padding, shape.padding, shape.padding};
+  const int64_t stride_shape[] = {shape.stride, shape.stride};
+  const int64_t output_shape[] = {shape.batch, nchwc_filters, shape.output_size, shape.output_size};
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+  auto input = RandomBuffer<float>(shape.batch * nchwc_channels * shape.input_size * shape.input_size);
+  auto filter = RandomBuffer<float>(nchwc_filters * nchwc_channels * shape.kernel_size * shape.kernel_size);
+  std::vector<float> bias(nchwc_filters);
+  std::vector<float> output(shape.batch * nchwc_filters * shape.output_size * shape.output_size);
+  for (auto _ : state) {
+    MlasNchwcConv(2, input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape, 1,
+                  input.data(), filter.data(), bias.data(), output.data(), &activation, true, thread_pool);
+  }
+  SetFlops(state, shape.Flops());
+}
+BENCHMARK(BM_MlasNchwcConv)->Apply(ConvShapes)->UseRealTime();
+
+// Pooling kind (MLAS_POOLING_KIND), batch, channels, input size, kernel size, stride, threads.
+static void BM_MlasPool(benchmark::State& state) {
+  const auto kind = static_cast<MLAS_POOLING_KIND>(state.range(0));
+  const int64_t batch = state.range(1);
+  const int64_t channels = state.range(2);
+  const int64_t input_size = state.range(3);
+  const int64_t kernel_size = state.range(4);
+  const int64_t stride = state.range(5);
+  MLAS_THREADPOOL* thread_pool = GetThreadPool(state.range(6));
+  const int64_t output_size = (input_size - kernel_size) / stride + 1;
+
+  const int64_t input_shape[] = {batch, channels, input_size, input_size};
+  const int64_t kernel_shape[] = {kernel_size, kernel_size};
+  const int64_t padding[] = {0, 0, 0, 0};
+  const int64_t stride_shape[] = {stride, stride};
+  const int64_t output_shape[] = {batch, channels, output_size, output_size};
+  auto input = RandomBuffer<float>(batch * channels * input_size * input_size);
+  std::vector<float> output(batch * channels * output_size * output_size);
+  for (auto _ : state) {
+    MlasPool(kind, 2, input_shape, kernel_shape, padding, stride_shape, output_shape, input.data(), output.data(),
+             thread_pool);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_MlasPool)
+    ->ArgNames({"kind", "N", "C", "HW", "K", "S", "threads"})
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (int64_t kind : {MlasMaximumPooling, MlasAveragePoolingExcludePad}) {
+        for (int64_t thread_count : {0, 4}) {
+          b->Args({kind, 1, 64, 112, 3, 2, thread_count});
+          b->Args({kind, 1, 2048, 7, 7, 1, thread_count});
+        }
+      }
+    })
+    ->UseRealTime();
+
+// Activation kind (MLAS_ACTIVATION_KIND), elements.
+static void BM_MlasActivation(benchmark::State& state) {
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = static_cast<MLAS_ACTIVATION_KIND>(state.range(0));
+  activation.Parameters.LeakyRelu.alpha = 0.01f;
+  const size_t count = static_cast<size_t>(state.range(1));
+  auto buffer = RandomBuffer<float>(count);
+  for (auto _ : state) {
+    MlasActivation(&activation, buffer.data(), nullptr, 1, count, count);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MlasActivation)
+    ->ArgNames({"kind", "elements"})
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (int64_t kind : {MlasReluActivation, MlasLeakyReluActivation, MlasTanhActivation, MlasLogisticActivation}) {
+        b->Args({kind, 1 << 10});
+        b->Args({kind, 1 << 20});
+      }
+    });
+
+template <void (*Compute)(const float*, float*, size_t)>
+static void BM_MlasCompute(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  auto input = RandomBuffer<float>(count);
+  std::vector<float> output(count);
+  for (auto _ : state) {
+    Compute(input.data(), output.data(), count);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK_TEMPLATE(BM_MlasCompute, MlasComputeLogistic)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_MlasCompute, MlasComputeTanh)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_MlasCompute, MlasComputeErf)->Arg(1 << 10)->Arg(1 << 20);
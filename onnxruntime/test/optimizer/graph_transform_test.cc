@@ -16,6 +16,10 @@
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/gemm_transpose_scale_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/framework/data_types.h"
@@ -28,7 +32,10 @@
 #include "gtest/gtest.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/shape_to_initializer.h"
+#include "core/optimizer/zipmap_elimination.h"
+#include "core/optimizer/scaler_linear_fusion.h"
 
 using namespace std;
 using namespace ONNX_NAMESPACE;
@@ -38,6 +45,46 @@ namespace test {
 
 static const std::string MODEL_FOLDER = "testdata/transform/";
 
+// Transformer that reports a modification for the given number of calls and counts its calls.
+class CountingGraphTransformer : public GraphTransformer {
+ public:
+  CountingGraphTransformer(const std::string& name, int num_modifying_calls) noexcept
+      : GraphTransformer(name), num_modifying_calls_(num_modifying_calls) {}
+
+  int NumCalls() const { return num_calls_; }
+
+ private:
+  const int num_modifying_calls_;
+  mutable int num_calls_ = 0;
+
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/) const override {
+    modified = num_calls_++ < num_modifying_calls_;
+    return Status::OK();
+  }
+};
+
+TEST(GraphTransformationTests, SkipTransformersUntilGraphModified) {
+  string model_uri = MODEL_FOLDER + "abs-id-max.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  auto modifying_transformer = std::make_unique<CountingGraphTransformer>("Modifying", 2);
+  auto idle_transformer = std::make_unique<CountingGraphTransformer>("Idle", 0);
+  const auto* modifying = modifying_transformer.get();
+  const auto* idle = idle_transformer.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(modifying_transformer), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(std::move(idle_transformer), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  // The modifying transformer runs until it no longer modifies the graph. The idle transformer
+  // is not run again in the last step as the graph was not modified since its previous run.
+  EXPECT_EQ(modifying->NumCalls(), 3);
+  EXPECT_EQ(idle->NumCalls(), 2);
+}
+
 TEST(GraphTransformationTests, IdentityElimination) {
   string model_uri = MODEL_FOLDER + "abs-id-max.onnx";
   std::shared_ptr<Model> model;
@@ -189,6 +236,230 @@ TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+static NodeArg& MakeInt64Initializer(Graph& graph, const std::string& name, const std::vector<int64_t>& values,
+                                     bool is_scalar = false) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  if (!is_scalar) {
+    tensor_proto.add_dims(static_cast<int64_t>(values.size()));
+  }
+  for (auto value : values) {
+    tensor_proto.add_int64_data(value);
+  }
+  graph.AddInitializedTensor(tensor_proto);
+  return graph.GetOrCreateNodeArg(name, nullptr);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingSymbolicShape) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  Model model("ConstantFoldingSymbolicShape", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  auto& graph = model.MainGraph();
+
+  // X has the shape [batch, 4, 8].
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(8);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &input_type);
+
+  auto& index0_arg = MakeInt64Initializer(graph, "index0", {0}, true);
+  auto& index1_arg = MakeInt64Initializer(graph, "index1", {1}, true);
+  auto& dim32_arg = MakeInt64Initializer(graph, "dim32", {32});
+  auto& dim8_arg = MakeInt64Initializer(graph, "dim8", {8});
+
+  auto& shape_arg = graph.GetOrCreateNodeArg("shape", nullptr);
+  graph.AddNode("shape", "Shape", "", {&input_arg}, {&shape_arg});
+
+  auto add_gather_unsqueeze = [&](const std::string& name, NodeArg& index_arg) -> NodeArg& {
+    auto& gather_arg = graph.GetOrCreateNodeArg(name + "_gather", nullptr);
+    graph.AddNode(name + "_gather", "Gather", "", {&shape_arg, &index_arg}, {&gather_arg});
+    auto& unsqueeze_arg = graph.GetOrCreateNodeArg(name + "_unsqueeze", nullptr);
+    auto& unsqueeze_node = graph.AddNode(name + "_unsqueeze", "Unsqueeze", "", {&gather_arg}, {&unsqueeze_arg});
+    unsqueeze_node.AddAttribute("axes", std::vector<int64_t>{0});
+    return unsqueeze_arg;
+  };
+
+  // Reshape to [batch, 32]: the batch dimension is copied from the input.
+  auto& batch1_arg = add_gather_unsqueeze("batch1", index0_arg);
+  auto& concat1_arg = graph.GetOrCreateNodeArg("concat1", nullptr);
+  auto& concat1_node = graph.AddNode("concat1", "Concat", "", {&batch1_arg, &dim32_arg}, {&concat1_arg});
+  concat1_node.AddAttribute("axis", static_cast<int64_t>(0));
+  auto& output1_arg = graph.GetOrCreateNodeArg("Y1", nullptr);
+  graph.AddNode("reshape1", "Reshape", "", {&input_arg, &concat1_arg}, {&output1_arg});
+
+  // Reshape to [4, batch, 8]: the batch dimension is inferred.
+  auto& channels_arg = add_gather_unsqueeze("channels", index1_arg);
+  auto& batch2_arg = add_gather_unsqueeze("batch2", index0_arg);
+  auto& concat2_arg = graph.GetOrCreateNodeArg("concat2", nullptr);
+  auto& concat2_node = graph.AddNode("concat2", "Concat", "", {&channels_arg, &batch2_arg, &dim8_arg}, {&concat2_arg});
+  concat2_node.AddAttribute("axis", static_cast<int64_t>(0));
+  auto& output2_arg = graph.GetOrCreateNodeArg("Y2", nullptr);
+  graph.AddNode("reshape2", "Reshape", "", {&input_arg, &concat2_arg}, {&output2_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Shape"], 0);
+  ASSERT_EQ(op_to_count["Gather"], 0);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 0);
+  ASSERT_EQ(op_to_count["Concat"], 0);
+  ASSERT_EQ(op_to_count["Reshape"], 2);
+
+  for (auto& node : graph.Nodes()) {
+    const auto* shape_tensor = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+    ASSERT_TRUE(shape_tensor != nullptr);
+    std::vector<int64_t> shape(static_cast<size_t>(shape_tensor->dims(0)));
+    memcpy(shape.data(), shape_tensor->raw_data().data(), shape.size() * sizeof(int64_t));
+    if (node.OutputDefs()[0]->Name() == "Y1") {
+      EXPECT_EQ(shape, (std::vector<int64_t>{0, 32}));
+    } else {
+      EXPECT_EQ(shape, (std::vector<int64_t>{4, -1, 8}));
+    }
+  }
+}
+
+TEST(GraphTransformationTests, ConstantFoldingSizeBudget) {
+  auto test_case = [&](int64_t repeats, size_t max_output_size_in_bytes, int expected_tile_count) {
+    Model model("ConstantFoldingSizeBudget");
+    auto& graph = model.MainGraph();
+
+    TensorProto value_tensor;
+    value_tensor.set_name("value");
+    value_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    value_tensor.add_dims(256);
+    for (int i = 0; i < 256; i++) {
+      value_tensor.add_float_data(static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(value_tensor);
+    auto& value_arg = graph.GetOrCreateNodeArg("value", nullptr);
+
+    auto& repeats_arg = MakeInt64Initializer(graph, "repeats", {repeats});
+
+    TypeProto input_type;
+    input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(256 * repeats);
+    auto& input_arg = graph.GetOrCreateNodeArg("X", &input_type);
+
+    auto& tile_arg = graph.GetOrCreateNodeArg("tile", nullptr);
+    graph.AddNode("tile", "Tile", "", {&value_arg, &repeats_arg}, {&tile_arg});
+    auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+    graph.AddNode("add", "Add", "", {&input_arg, &tile_arg}, {&output_arg});
+
+    auto status = graph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::make_unique<ConstantFolding>(std::unordered_set<std::string>{},
+                                                                        max_output_size_in_bytes),
+                                      TransformerLevel::Level1);
+
+    status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+    ASSERT_TRUE(status.IsOK()) << status;
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_EQ(op_to_count["Tile"], expected_tile_count);
+  };
+
+  // A Tile that expands its input beyond the budget is not folded.
+  test_case(1024, 64 * 1024, 1);
+
+  // A Tile within the budget or without a budget is folded.
+  test_case(16, 64 * 1024, 0);
+  test_case(1024, 0, 0);
+}
+
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  Model model("CommonSubexpressionElimination");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &input_type);
+
+  // Two initializers with identical contents and one that differs.
+  auto add_weights = [&](const std::string& name, float scale) -> NodeArg& {
+    TensorProto weights_tensor;
+    weights_tensor.set_name(name);
+    weights_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    weights_tensor.add_dims(3);
+    weights_tensor.add_dims(3);
+    for (int i = 0; i < 9; i++) {
+      weights_tensor.add_float_data(scale * static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(weights_tensor);
+    return graph.GetOrCreateNodeArg(name, nullptr);
+  };
+  auto& weights1_arg = add_weights("W1", 1.0f);
+  auto& weights2_arg = add_weights("W2", 1.0f);
+  auto& weights3_arg = add_weights("W3", 2.0f);
+
+  // Each branch transposes its weights, multiplies the input and adds a
+  // Relu of the input.
+  std::vector<NodeArg*> branch_outputs;
+  auto add_branch = [&](const std::string& name, NodeArg& weights_arg, bool do_random) {
+    auto& transpose_arg = graph.GetOrCreateNodeArg(name + "_transpose", nullptr);
+    auto& transpose_node = graph.AddNode(name + "_transpose", "Transpose", "", {&weights_arg}, {&transpose_arg});
+    transpose_node.AddAttribute("perm", std::vector<int64_t>{1, 0});
+    auto& matmul_arg = graph.GetOrCreateNodeArg(name + "_matmul", nullptr);
+    graph.AddNode(name + "_matmul", "MatMul", "", {&input_arg, &transpose_arg}, {&matmul_arg});
+    auto& relu_arg = graph.GetOrCreateNodeArg(name + "_relu", nullptr);
+    graph.AddNode(name + "_relu", "Relu", "", {&input_arg}, {&relu_arg});
+    auto* addend_arg = &relu_arg;
+    if (do_random) {
+      addend_arg = &graph.GetOrCreateNodeArg(name + "_random", nullptr);
+      graph.AddNode(name + "_random", "RandomUniformLike", "", {&input_arg}, {addend_arg});
+    }
+    auto& output_arg = graph.GetOrCreateNodeArg(name + "_output", nullptr);
+    graph.AddNode(name + "_add", "Add", "", {&matmul_arg, addend_arg}, {&output_arg});
+    branch_outputs.push_back(&output_arg);
+  };
+  add_branch("branch1", weights1_arg, true);
+  add_branch("branch2", weights2_arg, true);
+  add_branch("branch3", weights3_arg, false);
+
+  auto& sum_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("sum", "Sum", "", branch_outputs, {&sum_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<CommonSubexpressionElimination>(), TransformerLevel::Level1);
+
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  // The first two branches share the Transpose and MatMul nodes. The Relu is
+  // shared by all branches. The non-deterministic RandomUniformLike nodes and
+  // therefore the Add nodes are not merged.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 2);
+  ASSERT_EQ(op_to_count["MatMul"], 2);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["RandomUniformLike"], 2);
+  ASSERT_EQ(op_to_count["Add"], 3);
+  ASSERT_EQ(op_to_count["Sum"], 1);
+
+  // The duplicate initializer is no longer used.
+  const TensorProto* tensor_proto = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("W1", tensor_proto));
+  ASSERT_FALSE(graph.GetInitializedTensor("W2", tensor_proto));
+  ASSERT_TRUE(graph.GetInitializedTensor("W3", tensor_proto));
+}
+
 TEST(GraphTransformationTests, ShapeToInitializer) {
   string model_uri = MODEL_FOLDER + "shape-add.onnx";
   std::shared_ptr<Model> model;
@@ -463,6 +734,104 @@ TEST(GraphTransformationTests, MatMulAddFusion_three_input) {
   ASSERT_TRUE(op_to_count["Gemm"] == 1);
 }
 
+TEST(GraphTransformationTests, GemmTransposeScaleFusion) {
+  Model model("GemmTransposeScaleFusion");
+  auto& graph = model.MainGraph();
+
+  auto make_float_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  auto add_initializer = [&](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; i++) {
+      tensor.add_float_data(static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(tensor);
+    auto type = make_float_type(dims);
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  // Y1 = Transpose(A) * Transpose(W1) / 4
+  auto a_type = make_float_type({3, 4});
+  auto& a_arg = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& a_transposed_arg = graph.GetOrCreateNodeArg("A_transposed", nullptr);
+  graph.AddNode("transpose_a", "Transpose", "", {&a_arg}, {&a_transposed_arg});
+
+  auto& w1_arg = add_initializer("W1", {5, 3});
+  auto& w1_transposed_arg = graph.GetOrCreateNodeArg("W1_transposed", nullptr);
+  auto& transpose_w1 = graph.AddNode("transpose_w1", "Transpose", "", {&w1_arg}, {&w1_transposed_arg});
+  transpose_w1.AddAttribute("perm", std::vector<int64_t>{1, 0});
+
+  auto& matmul1_arg = graph.GetOrCreateNodeArg("matmul1", nullptr);
+  graph.AddNode("matmul1", "MatMul", "", {&a_transposed_arg, &w1_transposed_arg}, {&matmul1_arg});
+  TensorProto divisor;
+  divisor.set_name("divisor");
+  divisor.set_data_type(TensorProto_DataType_FLOAT);
+  divisor.add_float_data(4.0f);
+  graph.AddInitializedTensor(divisor);
+  auto divisor_type = make_float_type({});
+  auto& divisor_arg = graph.GetOrCreateNodeArg("divisor", &divisor_type);
+  auto& y1_arg = graph.GetOrCreateNodeArg("Y1", nullptr);
+  graph.AddNode("div", "Div", "", {&matmul1_arg, &divisor_arg}, {&y1_arg});
+
+  // Y2 = X * Transpose(W2) where X is not a matrix.
+  auto x_type = make_float_type({2, 4, 3});
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w2_arg = add_initializer("W2", {5, 3});
+  auto& w2_transposed_arg = graph.GetOrCreateNodeArg("W2_transposed", nullptr);
+  graph.AddNode("transpose_w2", "Transpose", "", {&w2_arg}, {&w2_transposed_arg});
+  auto& y2_arg = graph.GetOrCreateNodeArg("Y2", nullptr);
+  graph.AddNode("matmul2", "MatMul", "", {&x_arg, &w2_transposed_arg}, {&y2_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<GemmTransposeScaleFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Div"], 0);
+  ASSERT_EQ(op_to_count["Gemm"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Gemm") {
+      const auto& attrs = node.GetAttributes();
+      EXPECT_EQ(attrs.at("transA").i(), 1);
+      EXPECT_EQ(attrs.at("transB").i(), 1);
+      EXPECT_EQ(attrs.at("alpha").f(), 0.25f);
+      EXPECT_EQ(attrs.at("beta").f(), 0.0f);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "A");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "W1");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y1");
+    } else if (node.OpType() == "MatMul") {
+      // The transposed weights are folded into a new initializer.
+      const TensorProto* tensor_proto = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), tensor_proto));
+      ASSERT_EQ(tensor_proto->dims(0), 3);
+      ASSERT_EQ(tensor_proto->dims(1), 5);
+      EXPECT_EQ(tensor_proto->float_data(1), 3.0f);
+      EXPECT_EQ(tensor_proto->float_data(5), 1.0f);
+    }
+  }
+}
+
 #ifndef DISABLE_CONTRIB_OPS
 TEST(GraphTransformationTests, Gemm_Relu_three_input) {
   string model_uri = MODEL_FOLDER + "matmul_add_fusion/3Input/gemm_relu.onnx";
@@ -478,6 +847,314 @@ TEST(GraphTransformationTests, Gemm_Relu_three_input) {
   std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
   ASSERT_TRUE(op_to_count["Relu"] == 0);
 }
+
+TEST(GraphTransformationTests, Gemm_Relu_three_input_cuda) {
+  string model_uri = MODEL_FOLDER + "matmul_add_fusion/3Input/gemm_relu.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<GemmActivationFusion>(
+                                        std::unordered_set<std::string>{kCudaExecutionProvider}),
+                                    TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Relu"] == 0);
+  ASSERT_TRUE(op_to_count["FusedGemm"] == 1);
+  for (auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kCudaExecutionProvider);
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, ElementwiseFusion) {
+  Model model("ElementwiseFusion");
+  auto& graph = model.MainGraph();
+
+  auto make_float_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  auto add_initializer = [&](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; i++) {
+      tensor.add_float_data(static_cast<float>(i));
+    }
+    graph.AddInitializedTensor(tensor);
+    auto type = make_float_type(dims);
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  auto add_node = [&](const std::string& op_type, const std::vector<NodeArg*>& inputs, const std::string& output,
+                      const std::string& provider) {
+    auto& output_arg = graph.GetOrCreateNodeArg(output, nullptr);
+    auto& node = graph.AddNode(output, op_type, "", inputs, {&output_arg});
+    node.SetExecutionProviderType(provider);
+    return &output_arg;
+  };
+
+  // Y1 = Relu(1 - (bias + X * scale)) on CUDA is fused.
+  auto x_type = make_float_type({2, 3, 4});
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& scale_arg = add_initializer("scale", {4});
+  auto& bias_arg = add_initializer("bias", {3, 4});
+  auto& one_arg = add_initializer("one", {1});
+  auto* t1_arg = add_node("Mul", {&x_arg, &scale_arg}, "T1", kCudaExecutionProvider);
+  auto* t2_arg = add_node("Add", {&bias_arg, t1_arg}, "T2", kCudaExecutionProvider);
+  auto* t3_arg = add_node("Sub", {&one_arg, t2_arg}, "T3", kCudaExecutionProvider);
+  add_node("Relu", {t3_arg}, "Y1", kCudaExecutionProvider);
+
+  // Y2 = Tanh(Exp(X)) isn't, as Exp runs on the CPU.
+  auto* t4_arg = add_node("Exp", {&x_arg}, "T4", kCpuExecutionProvider);
+  add_node("Tanh", {t4_arg}, "Y2", kCudaExecutionProvider);
+
+  // Y3 = Sigmoid(X + B) isn't, as X and B broadcast each other to a larger shape.
+  auto b_type = make_float_type({3, 1, 1, 4});
+  auto& b_arg = graph.GetOrCreateNodeArg("B", &b_type);
+  auto* t5_arg = add_node("Add", {&x_arg, &b_arg}, "T5", kCudaExecutionProvider);
+  add_node("Sigmoid", {t5_arg}, "Y3", kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      std::make_unique<ElementwiseFusion>(std::unordered_set<std::string>{kCudaExecutionProvider}),
+      TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedElementwise"], 1);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 0);
+  ASSERT_EQ(op_to_count["Relu"], 0);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Exp"], 1);
+  ASSERT_EQ(op_to_count["Tanh"], 1);
+  ASSERT_EQ(op_to_count["Sigmoid"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() != "FusedElementwise") {
+      continue;
+    }
+    EXPECT_EQ(node.GetExecutionProviderType(), kCudaExecutionProvider);
+    EXPECT_EQ(node.OutputDefs()[0]->Name(), "Y1");
+    const auto& input_defs = node.InputDefs();
+    ASSERT_EQ(input_defs.size(), 4u);
+    EXPECT_EQ(input_defs[0]->Name(), "X");
+    EXPECT_EQ(input_defs[1]->Name(), "scale");
+    EXPECT_EQ(input_defs[2]->Name(), "bias");
+    EXPECT_EQ(input_defs[3]->Name(), "one");
+    const auto& ops = node.GetAttributes().at("ops").strings();
+    ASSERT_EQ(ops.size(), 4);
+    EXPECT_EQ(ops[0], "Mul");
+    EXPECT_EQ(ops[1], "Add");
+    EXPECT_EQ(ops[2], "RSub");
+    EXPECT_EQ(ops[3], "Relu");
+  }
+}
+#endif
+
+#ifndef DISABLE_CONTRIB_OPS
+TEST(GraphTransformationTests, DynamicQuantizeMatMulFusion) {
+  Model model("DynamicQuantizeMatMulFusion");
+  auto& graph = model.MainGraph();
+
+  auto make_float_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  auto add_initializer = [&](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; i++) {
+      tensor.add_float_data(static_cast<float>(i) - 4.0f);
+    }
+    graph.AddInitializedTensor(tensor);
+    auto type = make_float_type(dims);
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  // Y1 = X * W1 where X is not a matrix.
+  auto x_type = make_float_type({2, 3, 4});
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w1_arg = add_initializer("W1", {4, 5});
+  auto& y1_arg = graph.GetOrCreateNodeArg("Y1", nullptr);
+  graph.AddNode("matmul1", "MatMul", "", {&x_arg, &w1_arg}, {&y1_arg});
+
+  // Y2 = A * Transpose(W2) + bias
+  auto a_type = make_float_type({3, 4});
+  auto& a_arg = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& w2_arg = add_initializer("W2", {5, 4});
+  auto& bias_arg = add_initializer("bias", {5});
+  auto& y2_arg = graph.GetOrCreateNodeArg("Y2", nullptr);
+  auto& gemm = graph.AddNode("gemm", "Gemm", "", {&a_arg, &w2_arg, &bias_arg}, {&y2_arg});
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+
+  // Y3 = A * B where B is not a constant.
+  auto b_type = make_float_type({4, 5});
+  auto& b_arg = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& y3_arg = graph.GetOrCreateNodeArg("Y3", nullptr);
+  graph.AddNode("matmul3", "MatMul", "", {&a_arg, &b_arg}, {&y3_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<DynamicQuantizeMatMulFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["DynamicQuantizeMatMul"], 2);
+  ASSERT_EQ(op_to_count["Gemm"], 0);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() != "DynamicQuantizeMatMul") {
+      continue;
+    }
+    const auto& input_defs = node.InputDefs();
+    const TensorProto* tensor_proto = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(input_defs[1]->Name(), tensor_proto));
+    ASSERT_EQ(tensor_proto->data_type(), TensorProto_DataType_UINT8);
+    ASSERT_EQ(tensor_proto->dims(0), 4);
+    ASSERT_EQ(tensor_proto->dims(1), 5);
+    ASSERT_TRUE(graph.GetInitializedTensor(input_defs[2]->Name(), tensor_proto));
+    ASSERT_EQ(tensor_proto->dims(0), 5);
+    ASSERT_TRUE(graph.GetInitializedTensor(input_defs[3]->Name(), tensor_proto));
+    ASSERT_EQ(tensor_proto->dims(0), 5);
+    if (node.OutputDefs()[0]->Name() == "Y2") {
+      ASSERT_EQ(input_defs.size(), 5u);
+      EXPECT_EQ(input_defs[4]->Name(), "bias");
+    } else {
+      EXPECT_EQ(input_defs.size(), 4u);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, MatMulNBitsQuantization) {
+  Model model("MatMulNBitsQuantization");
+  auto& graph = model.MainGraph();
+
+  auto make_float_type = [](const std::vector<int64_t>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  auto add_initializer = [&](const std::string& name, const std::vector<int64_t>& dims) -> NodeArg& {
+    TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    int64_t size = 1;
+    for (auto dim : dims) {
+      tensor.add_dims(dim);
+      size *= dim;
+    }
+    for (int64_t i = 0; i < size; i++) {
+      tensor.add_float_data(static_cast<float>(i % 9) - 4.0f);
+    }
+    graph.AddInitializedTensor(tensor);
+    auto type = make_float_type(dims);
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  // Y1 = X * W1 where X is not a matrix, with K = 40 which isn't a multiple of the block size.
+  auto x_type = make_float_type({2, 3, 40});
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w1_arg = add_initializer("W1", {40, 5});
+  auto& y1_arg = graph.GetOrCreateNodeArg("Y1", nullptr);
+  graph.AddNode("matmul1", "MatMul", "", {&x_arg, &w1_arg}, {&y1_arg});
+
+  // Y2 = A * Transpose(W2) + bias
+  auto a_type = make_float_type({1, 40});
+  auto& a_arg = graph.GetOrCreateNodeArg("A", &a_type);
+  auto& w2_arg = add_initializer("W2", {5, 40});
+  auto& bias_arg = add_initializer("bias", {5});
+  auto& y2_arg = graph.GetOrCreateNodeArg("Y2", nullptr);
+  auto& gemm = graph.AddNode("gemm", "Gemm", "", {&a_arg, &w2_arg, &bias_arg}, {&y2_arg});
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+
+  // Y3 = A * B where B is not a constant.
+  auto b_type = make_float_type({40, 5});
+  auto& b_arg = graph.GetOrCreateNodeArg("B", &b_type);
+  auto& y3_arg = graph.GetOrCreateNodeArg("Y3", nullptr);
+  graph.AddNode("matmul3", "MatMul", "", {&a_arg, &b_arg}, {&y3_arg});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<MatMulNBitsQuantization>(4, 16), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MatMulNBits"], 2);
+  ASSERT_EQ(op_to_count["Gemm"], 0);
+  ASSERT_EQ(op_to_count["MatMul"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() != "MatMulNBits") {
+      continue;
+    }
+    const auto& attributes = node.GetAttributes();
+    EXPECT_EQ(attributes.at("K").i(), 40);
+    EXPECT_EQ(attributes.at("N").i(), 5);
+    EXPECT_EQ(attributes.at("bits").i(), 4);
+    EXPECT_EQ(attributes.at("block_size").i(), 16);
+
+    // 3 blocks of 16 rows for each of the 5 columns, with two weights in a byte
+    const auto& input_defs = node.InputDefs();
+    const TensorProto* tensor_proto = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(input_defs[1]->Name(), tensor_proto));
+    ASSERT_EQ(tensor_proto->data_type(), TensorProto_DataType_UINT8);
+    ASSERT_EQ(tensor_proto->dims(0), 5 * 3 * 8);
+    ASSERT_TRUE(graph.GetInitializedTensor(input_defs[2]->Name(), tensor_proto));
+    ASSERT_EQ(tensor_proto->dims(0), 5 * 3);
+    if (node.OutputDefs()[0]->Name() == "Y2") {
+      ASSERT_EQ(input_defs.size(), 4u);
+      EXPECT_EQ(input_defs[3]->Name(), "bias");
+    } else {
+      EXPECT_EQ(input_defs.size(), 3u);
+    }
+  }
+}
 #endif
 
 TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
@@ -606,5 +1283,92 @@ TEST(GraphTransformationTests, ReluClipFusion) {
   }
 }
 
+TEST(GraphTransformationTests, ZipMapElimination) {
+  Model model("ZipMapElimination");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &input_type);
+
+  auto& softmax_arg = graph.GetOrCreateNodeArg("probabilities", nullptr);
+  graph.AddNode("softmax", "Softmax", "", {&input_arg}, {&softmax_arg});
+  auto& output_arg = graph.GetOrCreateNodeArg("output_probability", nullptr);
+  auto& zipmap = graph.AddNode("zipmap", "ZipMap", "", {&softmax_arg}, {&output_arg}, nullptr, kMLDomain);
+  zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{0, 1, 2});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ZipMapElimination>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["ZipMap"], 0);
+  ASSERT_EQ(op_to_count["Identity"], 1);
+
+  // the graph output keeps its name and is now the float tensor of probabilities
+  const auto& outputs = graph.GetOutputs();
+  auto output = std::find_if(outputs.cbegin(), outputs.cend(),
+                             [](const NodeArg* arg) { return arg->Name() == "output_probability"; });
+  ASSERT_NE(output, outputs.cend());
+  ASSERT_TRUE((*output)->TypeAsProto()->has_tensor_type());
+  ASSERT_EQ((*output)->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT);
+}
+
+TEST(GraphTransformationTests, ScalerLinearFusion) {
+  Model model("ScalerLinearFusion");
+  auto& graph = model.MainGraph();
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &input_type);
+
+  auto& scaled_arg = graph.GetOrCreateNodeArg("scaled", nullptr);
+  auto& scaler = graph.AddNode("scaler", "Scaler", "", {&input_arg}, {&scaled_arg}, nullptr, kMLDomain);
+  scaler.AddAttribute("scale", std::vector<float>{2.f, 0.5f});
+  scaler.AddAttribute("offset", std::vector<float>{1.f, -4.f});
+
+  auto& output_arg = graph.GetOrCreateNodeArg("variable", nullptr);
+  auto& regressor = graph.AddNode("regressor", "LinearRegressor", "", {&scaled_arg}, {&output_arg}, nullptr,
+                                  kMLDomain);
+  regressor.AddAttribute("coefficients", std::vector<float>{3.f, 4.f, -1.f, 2.f});
+  regressor.AddAttribute("intercepts", std::vector<float>{10.f, 20.f});
+  regressor.AddAttribute("targets", static_cast<int64_t>(2));
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  auto rule_transformer_L1 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  rule_transformer_L1->Register(std::make_unique<ScalerLinearFusion>());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Scaler"], 0);
+  ASSERT_EQ(op_to_count["LinearRegressor"], 1);
+
+  // (x - offset) * scale is folded into the coefficients and intercepts
+  for (auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.OpType(), "LinearRegressor");
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+
+    std::vector<float> coefficients;
+    std::vector<float> intercepts;
+    ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "coefficients", coefficients));
+    ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "intercepts", intercepts));
+    ASSERT_EQ(coefficients, (std::vector<float>{6.f, 2.f, -2.f, 1.f}));
+    ASSERT_EQ(intercepts, (std::vector<float>{12.f, 26.f}));
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
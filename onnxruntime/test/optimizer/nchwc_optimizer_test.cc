@@ -79,27 +79,33 @@ struct NchwcTestHelper {
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
-  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape, const std::vector<float>& data) {
     std::string name = graph_.GenerateNodeArgName("constant");
     ONNX_NAMESPACE::TensorProto tensor_proto;
     tensor_proto.set_name(name);
     tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
 
-    int64_t num_elements = 1;
     for (auto& dim : shape) {
       tensor_proto.add_dims(dim);
-      num_elements *= dim;
     }
 
-    auto random_data = FillRandomData(static_cast<size_t>(num_elements));
-    tensor_proto.mutable_float_data()->Resize(static_cast<int>(num_elements), 0.0f);
-    memcpy(tensor_proto.mutable_float_data()->mutable_data(), random_data.data(), random_data.size() * sizeof(float));
+    tensor_proto.mutable_float_data()->Resize(static_cast<int>(data.size()), 0.0f);
+    memcpy(tensor_proto.mutable_float_data()->mutable_data(), data.data(), data.size() * sizeof(float));
 
     graph_.AddInitializedTensor(tensor_proto);
 
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      num_elements *= dim;
+    }
+
+    return MakeInitializer(shape, FillRandomData(static_cast<size_t>(num_elements)));
+  }
+
   Node& AddNode(const std::string& op_type,
                 const std::vector<NodeArg*>& input_args,
                 const std::vector<NodeArg*>& output_args) {
@@ -140,7 +146,8 @@ struct NchwcTestHelper {
 
 void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& build_test_case,
                           const std::function<void(NchwcInferenceSession& session)>& check_nchwc_graph,
-                          int opset_version = 10) {
+                          int opset_version = 10,
+                          float min_isolated_conv_flops_per_reorder = 0.0f) {
   // Ignore the test if NCHWc is not supported by the platform.
   if (MlasNchwcGetBlockSize() <= 1) {
     return;
@@ -161,6 +168,7 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
   auto run_model = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
     SessionOptions session_options;
     session_options.graph_optimization_level = level;
+    session_options.nchwc_min_isolated_conv_flops_per_reorder = min_isolated_conv_flops_per_reorder;
     session_options.session_logid = "NchwcOptimizerTests";
     NchwcInferenceSession session{session_options, &DefaultLoggingManager()};
     ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
@@ -622,6 +630,175 @@ TEST(NchwcOptimizerTests, ConvConcat) {
   test_case(0, 64, 3);
 }
 
+TEST(NchwcOptimizerTests, ConvMul) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* mul_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+    helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+    helper.AddNode("Mul", {conv1_output_arg, conv2_output_arg}, {mul_output_arg});
+    helper.AddConvNode(mul_output_arg, output_arg, {16, 32, 1, 1});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 3);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 1);
+  };
+
+  // Verify that Mul operates directly on NCHWc tensors, but is not fused into
+  // the preceding Conv node.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
+TEST(NchwcOptimizerTests, ConvActivationFusion) {
+  auto test_case = [&](const std::string& activation_op_type) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* add_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+      helper.AddNode("Add", {conv1_output_arg, conv2_output_arg}, {add_output_arg});
+
+      auto& activation_node = helper.AddNode(activation_op_type, {add_output_arg}, {output_arg});
+      if (activation_op_type == "LeakyRelu") {
+        activation_node.AddAttribute("alpha", 0.25f);
+      } else if (activation_op_type == "Clip") {
+        activation_node.AddAttribute("min", -64.0f);
+        activation_node.AddAttribute("max", 256.0f);
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Add"], 0);
+      EXPECT_EQ(op_to_count[activation_op_type], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Verify that activations with and without parameters can be fused into a
+  // NCHWc Conv node after a Conv/Add fusion.
+  std::vector<std::string> activation_op_types = {"Relu", "Sigmoid", "Tanh", "LeakyRelu", "Clip"};
+  for (auto& activation_op_type : activation_op_types) {
+    test_case(activation_op_type);
+  }
+}
+
+TEST(NchwcOptimizerTests, ConvUpsample) {
+  auto test_case = [&](const std::string& op_type, int opset_version, const std::vector<float>& scales,
+                       const std::string& mode, bool expect_nchwc) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 32, 11, 13});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* upsample_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+
+      Node* upsample_node;
+      if (opset_version == 7) {
+        upsample_node = &helper.AddNode(op_type, {conv1_output_arg}, {upsample_output_arg});
+        upsample_node->AddAttribute("scales", scales);
+      } else {
+        auto* scales_arg = helper.MakeInitializer({4}, scales);
+        upsample_node = &helper.AddNode(op_type, {conv1_output_arg, scales_arg}, {upsample_output_arg});
+      }
+      upsample_node->AddAttribute("mode", mode);
+
+      helper.AddConvNode(upsample_output_arg, output_arg, {16, 32, 3, 3});
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["nchwc.Upsample"], expect_nchwc ? 1 : 0);
+      EXPECT_EQ(op_to_count[op_type], expect_nchwc ? 0 : 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], expect_nchwc ? 1 : 2);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], expect_nchwc ? 1 : 2);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, opset_version);
+  };
+
+  // Nearest neighbor or bilinear upsampling with integral spatial scales stays in NCHWc format.
+  test_case("Upsample", 7, {1.0f, 1.0f, 2.0f, 2.0f}, "nearest", true);
+  test_case("Upsample", 9, {1.0f, 1.0f, 2.0f, 3.0f}, "nearest", true);
+  test_case("Resize", 10, {1.0f, 1.0f, 3.0f, 1.0f}, "nearest", true);
+  test_case("Upsample", 9, {1.0f, 1.0f, 2.0f, 2.0f}, "linear", true);
+  test_case("Resize", 10, {1.0f, 1.0f, 3.0f, 2.0f}, "linear", true);
+
+  // Fractional scales reorder back to NCHW.
+  test_case("Resize", 10, {1.0f, 1.0f, 1.5f, 2.0f}, "nearest", false);
+  test_case("Resize", 10, {1.0f, 1.0f, 2.0f, 0.5f}, "linear", false);
+}
+
+TEST(NchwcOptimizerTests, BatchNormalization) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto* pool_output_arg = helper.MakeIntermediate();
+    auto* bn_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv_output_arg, {32, 32, 3, 3});
+
+    auto& pool_node = helper.AddNode("MaxPool", {conv_output_arg}, {pool_output_arg});
+    pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+
+    // Use power of two scales and variances so that the folded depthwise
+    // convolution produces the exact same results as the original node.
+    std::vector<float> scale_data(32);
+    std::vector<float> bias_data(32);
+    std::vector<float> mean_data(32);
+    std::vector<float> var_data(32);
+    for (size_t i = 0; i < 32; i++) {
+      scale_data[i] = static_cast<float>(1 << (i % 3));
+      bias_data[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+      mean_data[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+      var_data[i] = static_cast<float>(1 << (2 * (i % 2)));
+    }
+
+    auto* scale_arg = helper.MakeInitializer({32}, scale_data);
+    auto* bias_arg = helper.MakeInitializer({32}, bias_data);
+    auto* mean_arg = helper.MakeInitializer({32}, mean_data);
+    auto* var_arg = helper.MakeInitializer({32}, var_data);
+
+    auto& bn_node = helper.AddNode("BatchNormalization", {pool_output_arg, scale_arg, bias_arg, mean_arg, var_arg}, {bn_output_arg});
+    bn_node.AddAttribute("epsilon", 0.0f);
+
+    helper.AddNode("Relu", {bn_output_arg}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["nchwc.MaxPool"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  // Verify that a standalone BatchNormalization is converted to a NCHWc
+  // depthwise convolution and fused with the following activation.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
 TEST(NchwcOptimizerTests, ConvReuseWeightsOIHWBiBo) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput({1, 64, 7, 7});
@@ -885,6 +1062,43 @@ TEST(NchwcOptimizerTests, TensorAlignment) {
   NchwcOptimizerTester(build_test_case, check_nchwc_graph);
 }
 
+TEST(NchwcOptimizerTests, IsolatedConvCost) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    // Depthwise convolution that does little work per reordered element.
+    auto* input1_arg = helper.MakeInput({1, 96, 28, 28});
+    auto* output1_arg = helper.MakeOutput();
+    auto& conv1_node = helper.AddConvNode(input1_arg, output1_arg, {96, 1, 3, 3});
+    conv1_node.AddAttribute("group", static_cast<int64_t>(96));
+
+    // Convolution that does enough work to pay for its reorders.
+    auto* input2_arg = helper.MakeInput({1, 64, 28, 28});
+    auto* output2_arg = helper.MakeOutput();
+    helper.AddConvNode(input2_arg, output2_arg, {128, 64, 3, 3});
+
+    // Chain of depthwise convolutions that share the NCHWc format.
+    auto* input3_arg = helper.MakeInput({1, 64, 28, 28});
+    auto* conv3_output_arg = helper.MakeIntermediate();
+    auto* output3_arg = helper.MakeOutput();
+    auto& conv3_node = helper.AddConvNode(input3_arg, conv3_output_arg, {64, 1, 3, 3});
+    conv3_node.AddAttribute("group", static_cast<int64_t>(64));
+    auto* relu_output_arg = helper.MakeIntermediate();
+    helper.AddNode("Relu", {conv3_output_arg}, {relu_output_arg});
+    auto& conv4_node = helper.AddConvNode(relu_output_arg, output3_arg, {64, 1, 3, 3});
+    conv4_node.AddAttribute("group", static_cast<int64_t>(64));
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Conv"], 1);
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 3);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 2);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 2);
+  };
+
+  // Verify that the isolated depthwise convolution is left in NCHW format.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph, 10, 32.0f);
+}
+
 #endif
 
 }  // namespace test
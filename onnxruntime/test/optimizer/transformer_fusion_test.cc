@@ -0,0 +1,417 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/inference_session.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/framework/test_utils.h"
+#include "test/compare_ortvalue.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// InferenceSession wrapper in order to gain access to the loaded graph.
+class TransformerFusionInferenceSession : public InferenceSession {
+ public:
+  explicit TransformerFusionInferenceSession(const SessionOptions& session_options,
+                                            logging::LoggingManager* logging_manager)
+      : InferenceSession(session_options, logging_manager) {
+  }
+
+  std::unordered_map<std::string, int> CountOpsInGraph() {
+    std::unordered_map<std::string, int> op_to_count;
+    if (model_.get() != nullptr) {
+      for (auto& node : model_->MainGraph().Nodes()) {
+        op_to_count[node.OpType()] = op_to_count[node.OpType()] + 1;
+      }
+    }
+    return op_to_count;
+  }
+};
+
+struct TransformerFusionTestHelper {
+  TransformerFusionTestHelper(Graph& graph) : graph_(graph), fill_value_(0) {
+  }
+
+  NodeArg* MakeInput(const std::vector<int64_t>& shape) {
+    ONNX_NAMESPACE::TypeProto type_proto;
+    type_proto.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto& dim : shape) {
+      type_proto.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+
+    OrtValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), shape,
+                         FillData(static_cast<size_t>(TensorShape(shape).Size())), &input_value);
+    std::string name = graph_.GenerateNodeArgName("input");
+    feeds_.insert(std::make_pair(name, input_value));
+
+    return &graph_.GetOrCreateNodeArg(name, &type_proto);
+  }
+
+  NodeArg* MakeOutput() {
+    std::string name = graph_.GenerateNodeArgName("output");
+    output_names_.push_back(name);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeIntermediate() {
+    std::string name = graph_.GenerateNodeArgName("node");
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape, const std::vector<float>& data) {
+    std::string name = graph_.GenerateNodeArgName("constant");
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto& dim : shape) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_float_data(value);
+    }
+    graph_.AddInitializedTensor(tensor_proto);
+
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    return MakeInitializer(shape, FillData(static_cast<size_t>(TensorShape(shape).Size())));
+  }
+
+  NodeArg* MakeScalarInitializer(float value) {
+    return MakeInitializer({}, {value});
+  }
+
+  NodeArg* MakeInt64Initializer(const std::vector<int64_t>& shape, const std::vector<int64_t>& data) {
+    std::string name = graph_.GenerateNodeArgName("constant");
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    for (auto& dim : shape) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : data) {
+      tensor_proto.add_int64_data(value);
+    }
+    graph_.AddInitializedTensor(tensor_proto);
+
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  Node& AddNode(const std::string& op_type,
+                const std::vector<NodeArg*>& input_args,
+                const std::vector<NodeArg*>& output_args) {
+    return graph_.AddNode(graph_.GenerateNodeName("node"),
+                          op_type,
+                          "description",
+                          input_args,
+                          output_args);
+  }
+
+  NodeArg* AddBinaryNode(const std::string& op_type, NodeArg* input_a, NodeArg* input_b) {
+    auto* output_arg = MakeIntermediate();
+    AddNode(op_type, {input_a, input_b}, {output_arg});
+    return output_arg;
+  }
+
+  // Keeps the values small so that the softmax of the attention scores does not saturate.
+  std::vector<float> FillData(size_t count) {
+    std::vector<float> data(count);
+    for (size_t n = 0; n < count; n++) {
+      data[n] = static_cast<float>(fill_value_ - 8) * 0.125f;
+      fill_value_ = (fill_value_ + 5) % 17;
+    }
+    return data;
+  }
+
+  Graph& graph_;
+  NameMLValMap feeds_;
+  std::vector<std::string> output_names_;
+  int fill_value_;
+};
+
+void TransformerFusionTester(const std::function<void(TransformerFusionTestHelper& helper)>& build_test_case,
+                             const std::function<void(TransformerFusionInferenceSession& session)>& check_graph) {
+  // Build the model for this test.
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  Model model("transformer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  TransformerFusionTestHelper helper(model.MainGraph());
+  build_test_case(helper);
+  ASSERT_TRUE(model.MainGraph().Resolve().IsOK());
+
+  // Serialize the model to a string.
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  auto run_model = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    session_options.session_logid = "TransformerFusionTests";
+    TransformerFusionInferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    RunOptions run_options;
+    auto status = session.Run(run_options, helper.feeds_, helper.output_names_, &fetches);
+    if (!status.IsOK()) {
+      std::cout << "Run failed with status message: " << status.ErrorMessage() << std::endl;
+    }
+    ASSERT_TRUE(status.IsOK());
+
+    if (level == TransformerLevel::Level2) {
+      check_graph(session);
+    }
+  };
+
+  std::vector<OrtValue> level1_fetches;
+  run_model(TransformerLevel::Level1, level1_fetches);
+
+  std::vector<OrtValue> level2_fetches;
+  run_model(TransformerLevel::Level2, level2_fetches);
+
+  size_t num_outputs = level1_fetches.size();
+  ASSERT_TRUE(num_outputs == level2_fetches.size());
+
+  for (size_t i = 0; i < num_outputs; i++) {
+    double per_sample_tolerance = 1e-4;
+    double relative_per_sample_tolerance = 1e-4;
+    std::pair<COMPARE_RESULT, std::string> ret =
+        CompareOrtValue(level2_fetches[i],
+                        level1_fetches[i],
+                        per_sample_tolerance,
+                        relative_per_sample_tolerance,
+                        false);
+    EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS);
+  }
+}
+
+TEST(TransformerFusionTests, LayerNormalization) {
+  auto test_case = [&](bool has_bias) {
+    auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({2, 8, 32});
+      auto* output_arg = helper.MakeOutput();
+
+      auto* mean_arg = helper.MakeIntermediate();
+      helper.AddNode("ReduceMean", {input_arg}, {mean_arg}).AddAttribute("axes", std::vector<int64_t>{-1});
+      auto* centered_arg = helper.AddBinaryNode("Sub", input_arg, mean_arg);
+      auto* squared_arg = helper.AddBinaryNode("Pow", centered_arg, helper.MakeScalarInitializer(2.0f));
+      auto* variance_arg = helper.MakeIntermediate();
+      helper.AddNode("ReduceMean", {squared_arg}, {variance_arg}).AddAttribute("axes", std::vector<int64_t>{2});
+      auto* biased_variance_arg = helper.AddBinaryNode("Add", variance_arg, helper.MakeScalarInitializer(1e-5f));
+      auto* std_dev_arg = helper.MakeIntermediate();
+      helper.AddNode("Sqrt", {biased_variance_arg}, {std_dev_arg});
+      auto* normalized_arg = helper.AddBinaryNode("Div", centered_arg, std_dev_arg);
+      if (has_bias) {
+        auto* scaled_arg = helper.AddBinaryNode("Mul", helper.MakeInitializer({32}), normalized_arg);
+        helper.AddNode("Add", {scaled_arg, helper.MakeInitializer({32})}, {output_arg});
+      } else {
+        helper.AddNode("Mul", {normalized_arg, helper.MakeInitializer({32})}, {output_arg});
+      }
+    };
+
+    auto check_graph = [&](TransformerFusionInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["LayerNormalization"], 1);
+      EXPECT_EQ(op_to_count["ReduceMean"], 0);
+      EXPECT_EQ(op_to_count["Sqrt"], 0);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+      EXPECT_EQ(op_to_count["Add"], 0);
+    };
+
+    TransformerFusionTester(build_test_case, check_graph);
+  };
+
+  test_case(true);
+  test_case(false);
+}
+
+TEST(TransformerFusionTests, LayerNormalizationSharedIntermediate) {
+  // The centered input is also a graph output, so the subgraph must not be fused.
+  auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({4, 16});
+    auto* output_arg = helper.MakeOutput();
+    auto* centered_arg = helper.MakeOutput();
+
+    auto* mean_arg = helper.MakeIntermediate();
+    helper.AddNode("ReduceMean", {input_arg}, {mean_arg}).AddAttribute("axes", std::vector<int64_t>{-1});
+    helper.AddNode("Sub", {input_arg, mean_arg}, {centered_arg});
+    auto* squared_arg = helper.AddBinaryNode("Pow", centered_arg, helper.MakeScalarInitializer(2.0f));
+    auto* variance_arg = helper.MakeIntermediate();
+    helper.AddNode("ReduceMean", {squared_arg}, {variance_arg}).AddAttribute("axes", std::vector<int64_t>{-1});
+    auto* biased_variance_arg = helper.AddBinaryNode("Add", variance_arg, helper.MakeScalarInitializer(1e-5f));
+    auto* std_dev_arg = helper.MakeIntermediate();
+    helper.AddNode("Sqrt", {biased_variance_arg}, {std_dev_arg});
+    auto* normalized_arg = helper.AddBinaryNode("Div", centered_arg, std_dev_arg);
+    helper.AddNode("Mul", {normalized_arg, helper.MakeInitializer({16})}, {output_arg});
+  };
+
+  auto check_graph = [&](TransformerFusionInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["LayerNormalization"], 0);
+    EXPECT_EQ(op_to_count["ReduceMean"], 2);
+  };
+
+  TransformerFusionTester(build_test_case, check_graph);
+}
+
+TEST(TransformerFusionTests, Gelu) {
+  // The factors of the final product are associated in each of the orders emitted by exporters.
+  auto test_case = [&](int variant) {
+    auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({4, 64});
+      auto* output_arg = helper.MakeOutput();
+
+      NodeArg* scaled_arg;
+      if (variant == 0) {
+        scaled_arg = helper.AddBinaryNode("Div", input_arg, helper.MakeScalarInitializer(1.41421356f));
+      } else {
+        scaled_arg = helper.AddBinaryNode("Mul", helper.MakeScalarInitializer(0.70710678f), input_arg);
+      }
+      auto* erf_arg = helper.MakeIntermediate();
+      helper.AddNode("Erf", {scaled_arg}, {erf_arg});
+      auto* sum_arg = helper.AddBinaryNode("Add", erf_arg, helper.MakeScalarInitializer(1.0f));
+      if (variant == 0) {
+        auto* product_arg = helper.AddBinaryNode("Mul", input_arg, sum_arg);
+        helper.AddNode("Mul", {product_arg, helper.MakeScalarInitializer(0.5f)}, {output_arg});
+      } else if (variant == 1) {
+        auto* half_arg = helper.AddBinaryNode("Mul", input_arg, helper.MakeScalarInitializer(0.5f));
+        helper.AddNode("Mul", {half_arg, sum_arg}, {output_arg});
+      } else {
+        auto* product_arg = helper.AddBinaryNode("Mul", sum_arg, helper.MakeScalarInitializer(0.5f));
+        helper.AddNode("Mul", {product_arg, input_arg}, {output_arg});
+      }
+    };
+
+    auto check_graph = [&](TransformerFusionInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["Gelu"], 1);
+      EXPECT_EQ(op_to_count["Erf"], 0);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+    };
+
+    TransformerFusionTester(build_test_case, check_graph);
+  };
+
+  test_case(0);
+  test_case(1);
+  test_case(2);
+}
+
+TEST(TransformerFusionTests, EmbeddingBag) {
+  auto test_case = [&](const std::string& reduce_op, int64_t axis) {
+    auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+      auto* data_arg = helper.MakeInput({10, 8});
+      auto* indices_arg = helper.MakeInt64Initializer({4, 3}, {9, 0, 4, 1, 1, 7, 3, 8, 2, 5, 6, 0});
+      auto* output_arg = helper.MakeOutput();
+
+      auto* gathered_arg = helper.AddBinaryNode("Gather", data_arg, indices_arg);
+      auto& reduce_node = helper.AddNode(reduce_op, {gathered_arg}, {output_arg});
+      reduce_node.AddAttribute("axes", std::vector<int64_t>{axis});
+      reduce_node.AddAttribute("keepdims", static_cast<int64_t>(0));
+    };
+
+    auto check_graph = [&](TransformerFusionInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["EmbeddingBag"], 1);
+      EXPECT_EQ(op_to_count["Gather"], 0);
+      EXPECT_EQ(op_to_count[reduce_op], 0);
+    };
+
+    TransformerFusionTester(build_test_case, check_graph);
+  };
+
+  test_case("ReduceSum", 1);
+  test_case("ReduceMean", -2);
+}
+
+TEST(TransformerFusionTests, EmbeddingBagKeepDims) {
+  // The reduced dimension is kept, so the output does not have the shape of the pooled bags.
+  auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+    auto* data_arg = helper.MakeInput({10, 8});
+    auto* indices_arg = helper.MakeInt64Initializer({2, 3}, {9, 0, 4, 1, 1, 7});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* gathered_arg = helper.AddBinaryNode("Gather", data_arg, indices_arg);
+    helper.AddNode("ReduceSum", {gathered_arg}, {output_arg}).AddAttribute("axes", std::vector<int64_t>{1});
+  };
+
+  auto check_graph = [&](TransformerFusionInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["EmbeddingBag"], 0);
+    EXPECT_EQ(op_to_count["ReduceSum"], 1);
+  };
+
+  TransformerFusionTester(build_test_case, check_graph);
+}
+
+TEST(TransformerFusionTests, Attention) {
+  auto test_case = [&](bool has_mask) {
+    auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+      // Batch of 2 with 4 heads, sequence length 8 and head size 16.
+      auto* query_arg = helper.MakeInput({2, 4, 8, 16});
+      auto* key_arg = helper.MakeInput({2, 4, 8, 16});
+      auto* value_arg = helper.MakeInput({2, 4, 8, 16});
+      auto* output_arg = helper.MakeOutput();
+
+      auto* key_transposed_arg = helper.MakeIntermediate();
+      helper.AddNode("Transpose", {key_arg}, {key_transposed_arg})
+          .AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+      auto* scores_arg = helper.AddBinaryNode("MatMul", query_arg, key_transposed_arg);
+      scores_arg = helper.AddBinaryNode("Div", scores_arg, helper.MakeScalarInitializer(4.0f));
+      if (has_mask) {
+        auto* mask_arg = helper.MakeInput({2, 1, 1, 8});
+        scores_arg = helper.AddBinaryNode("Add", scores_arg, mask_arg);
+      }
+      auto* probs_arg = helper.MakeIntermediate();
+      helper.AddNode("Softmax", {scores_arg}, {probs_arg}).AddAttribute("axis", static_cast<int64_t>(3));
+      helper.AddNode("MatMul", {probs_arg, value_arg}, {output_arg});
+    };
+
+    auto check_graph = [&](TransformerFusionInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["ScaledDotProductAttention"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 1);
+      EXPECT_EQ(op_to_count["MatMul"], 0);
+      EXPECT_EQ(op_to_count["Softmax"], 0);
+    };
+
+    TransformerFusionTester(build_test_case, check_graph);
+  };
+
+  test_case(true);
+  test_case(false);
+}
+
+TEST(TransformerFusionTests, AttentionSoftmaxNotLastAxis) {
+  // Softmax defaults to axis 1, which normalizes over more than the last axis of the scores.
+  auto build_test_case = [&](TransformerFusionTestHelper& helper) {
+    auto* query_arg = helper.MakeInput({2, 4, 8});
+    auto* key_arg = helper.MakeInput({2, 8, 4});
+    auto* value_arg = helper.MakeInput({2, 4, 8});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* scores_arg = helper.AddBinaryNode("MatMul", query_arg, key_arg);
+    auto* probs_arg = helper.MakeIntermediate();
+    helper.AddNode("Softmax", {scores_arg}, {probs_arg});
+    helper.AddNode("MatMul", {probs_arg, value_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](TransformerFusionInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["ScaledDotProductAttention"], 0);
+    EXPECT_EQ(op_to_count["Softmax"], 1);
+  };
+
+  TransformerFusionTester(build_test_case, check_graph);
+}
+
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,338 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/inference_session.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/framework/test_utils.h"
+#include "test/compare_ortvalue.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// InferenceSession wrapper in order to gain access to the loaded graph.
+class TransposeOptimizerInferenceSession : public InferenceSession {
+ public:
+  explicit TransposeOptimizerInferenceSession(const SessionOptions& session_options,
+                                              logging::LoggingManager* logging_manager)
+      : InferenceSession(session_options, logging_manager) {
+  }
+
+  std::unordered_map<std::string, int> CountOpsInGraph() {
+    std::unordered_map<std::string, int> op_to_count;
+    if (model_.get() != nullptr) {
+      for (auto& node : model_->MainGraph().Nodes()) {
+        op_to_count[node.OpType()] = op_to_count[node.OpType()] + 1;
+      }
+    }
+    return op_to_count;
+  }
+};
+
+struct TransposeOptimizerTestHelper {
+  TransposeOptimizerTestHelper(Graph& graph) : graph_(graph), fill_value_(0) {
+  }
+
+  NodeArg* MakeInput(const std::vector<int64_t>& shape) {
+    ONNX_NAMESPACE::TypeProto type_proto;
+    type_proto.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto& dim : shape) {
+      type_proto.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+
+    OrtValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), shape,
+                         FillData(static_cast<size_t>(TensorShape(shape).Size())), &input_value);
+    std::string name = graph_.GenerateNodeArgName("input");
+    feeds_.insert(std::make_pair(name, input_value));
+
+    return &graph_.GetOrCreateNodeArg(name, &type_proto);
+  }
+
+  NodeArg* MakeOutput() {
+    std::string name = graph_.GenerateNodeArgName("output");
+    output_names_.push_back(name);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeIntermediate() {
+    std::string name = graph_.GenerateNodeArgName("node");
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    std::string name = graph_.GenerateNodeArgName("constant");
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto& dim : shape) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : FillData(static_cast<size_t>(TensorShape(shape).Size()))) {
+      tensor_proto.add_float_data(value);
+    }
+    graph_.AddInitializedTensor(tensor_proto);
+
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  Node& AddNode(const std::string& op_type,
+                const std::vector<NodeArg*>& input_args,
+                const std::vector<NodeArg*>& output_args) {
+    return graph_.AddNode(graph_.GenerateNodeName("node"),
+                          op_type,
+                          "description",
+                          input_args,
+                          output_args);
+  }
+
+  NodeArg* AddTransposeNode(NodeArg* input_arg, const std::vector<int64_t>& perm) {
+    auto* output_arg = MakeIntermediate();
+    AddNode("Transpose", {input_arg}, {output_arg}).AddAttribute("perm", perm);
+    return output_arg;
+  }
+
+  std::vector<float> FillData(size_t count) {
+    std::vector<float> data(count);
+    for (size_t n = 0; n < count; n++) {
+      data[n] = static_cast<float>(fill_value_ - 8) * 0.125f;
+      fill_value_ = (fill_value_ + 5) % 17;
+    }
+    return data;
+  }
+
+  Graph& graph_;
+  NameMLValMap feeds_;
+  std::vector<std::string> output_names_;
+  int fill_value_;
+};
+
+void TransposeOptimizerTester(const std::function<void(TransposeOptimizerTestHelper& helper)>& build_test_case,
+                              const std::function<void(TransposeOptimizerInferenceSession& session)>& check_graph) {
+  // Build the model for this test.
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  Model model("transpose", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  TransposeOptimizerTestHelper helper(model.MainGraph());
+  build_test_case(helper);
+  ASSERT_TRUE(model.MainGraph().Resolve().IsOK());
+
+  // Serialize the model to a string.
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  auto run_model = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    session_options.session_logid = "TransposeOptimizerTests";
+    TransposeOptimizerInferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    RunOptions run_options;
+    auto status = session.Run(run_options, helper.feeds_, helper.output_names_, &fetches);
+    if (!status.IsOK()) {
+      std::cout << "Run failed with status message: " << status.ErrorMessage() << std::endl;
+    }
+    ASSERT_TRUE(status.IsOK());
+
+    if (level == TransformerLevel::Level3) {
+      check_graph(session);
+    }
+  };
+
+  std::vector<OrtValue> level1_fetches;
+  run_model(TransformerLevel::Level1, level1_fetches);
+
+  std::vector<OrtValue> level3_fetches;
+  run_model(TransformerLevel::Level3, level3_fetches);
+
+  size_t num_outputs = level1_fetches.size();
+  ASSERT_TRUE(num_outputs == level3_fetches.size());
+
+  for (size_t i = 0; i < num_outputs; i++) {
+    double per_sample_tolerance = 1e-4;
+    double relative_per_sample_tolerance = 1e-4;
+    std::pair<COMPARE_RESULT, std::string> ret =
+        CompareOrtValue(level3_fetches[i],
+                        level1_fetches[i],
+                        per_sample_tolerance,
+                        relative_per_sample_tolerance,
+                        false);
+    EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS);
+  }
+}
+
+static const std::vector<int64_t> nhwc_to_nchw{0, 3, 1, 2};
+static const std::vector<int64_t> nchw_to_nhwc{0, 2, 3, 1};
+
+TEST(TransposeOptimizerTests, ChannelsLastConvChain) {
+  // Models converted from channels last frameworks wrap each Conv node with a
+  // pair of Transpose nodes, with the activation and bias applied in between.
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 12, 12, 16});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* conv1_input_arg = helper.AddTransposeNode(input_arg, nhwc_to_nchw);
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    helper.AddNode("Conv", {conv1_input_arg, helper.MakeInitializer({16, 16, 3, 3})}, {conv1_output_arg})
+        .AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    auto* nhwc_arg = helper.AddTransposeNode(conv1_output_arg, nchw_to_nhwc);
+    auto* bias_arg = helper.MakeIntermediate();
+    helper.AddNode("Add", {nhwc_arg, helper.MakeInitializer({16})}, {bias_arg});
+    auto* relu_arg = helper.MakeIntermediate();
+    helper.AddNode("Relu", {bias_arg}, {relu_arg});
+    auto* conv2_input_arg = helper.AddTransposeNode(relu_arg, nhwc_to_nchw);
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    helper.AddNode("Conv", {conv2_input_arg, helper.MakeInitializer({8, 16, 1, 1})}, {conv2_output_arg});
+    helper.AddNode("Transpose", {conv2_output_arg}, {output_arg}).AddAttribute("perm", nchw_to_nhwc);
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+TEST(TransposeOptimizerTests, CancelToGraphOutput) {
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({2, 3, 4, 5});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* sigmoid_arg = helper.MakeIntermediate();
+    helper.AddNode("Sigmoid", {input_arg}, {sigmoid_arg});
+    auto* transpose_arg = helper.AddTransposeNode(sigmoid_arg, {1, 0, 3, 2});
+    auto* tanh_arg = helper.MakeIntermediate();
+    helper.AddNode("Tanh", {transpose_arg}, {tanh_arg});
+    helper.AddNode("Transpose", {tanh_arg}, {output_arg}).AddAttribute("perm", std::vector<int64_t>{1, 0, 3, 2});
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+TEST(TransposeOptimizerTests, ComposeTransposes) {
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({2, 3, 4, 5});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* transpose_arg = helper.AddTransposeNode(input_arg, {0, 2, 1, 3});
+    helper.AddNode("Transpose", {transpose_arg}, {output_arg}).AddAttribute("perm", std::vector<int64_t>{3, 0, 1, 2});
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 1);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+TEST(TransposeOptimizerTests, Elementwise) {
+  // Both operands are transposed by the same permutation, so the Transpose
+  // nodes merge into one that cancels with the trailing Transpose node.
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input1_arg = helper.MakeInput({2, 6, 4, 3});
+    auto* input2_arg = helper.MakeInput({2, 6, 4, 3});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* transpose1_arg = helper.AddTransposeNode(input1_arg, nhwc_to_nchw);
+    auto* transpose2_arg = helper.AddTransposeNode(input2_arg, nhwc_to_nchw);
+    auto* mul_arg = helper.MakeIntermediate();
+    helper.AddNode("Mul", {transpose1_arg, transpose2_arg}, {mul_arg});
+    auto* sub_arg = helper.MakeIntermediate();
+    helper.AddNode("Sub", {helper.MakeInitializer({3, 1, 1}), mul_arg}, {sub_arg});
+    auto* max_arg = helper.MakeIntermediate();
+    helper.AddNode("Max", {sub_arg, helper.MakeInitializer({2, 3, 6, 4})}, {max_arg});
+    helper.AddNode("Transpose", {max_arg}, {output_arg}).AddAttribute("perm", nchw_to_nhwc);
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+TEST(TransposeOptimizerTests, ConcatSplit) {
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input1_arg = helper.MakeInput({1, 5, 5, 8});
+    auto* input2_arg = helper.MakeInput({1, 5, 5, 4});
+    auto* output1_arg = helper.MakeOutput();
+    auto* output2_arg = helper.MakeOutput();
+
+    auto* transpose1_arg = helper.AddTransposeNode(input1_arg, nhwc_to_nchw);
+    auto* transpose2_arg = helper.AddTransposeNode(input2_arg, nhwc_to_nchw);
+    auto* concat_arg = helper.MakeIntermediate();
+    helper.AddNode("Concat", {transpose1_arg, transpose2_arg, helper.MakeInitializer({1, 4, 5, 5})}, {concat_arg})
+        .AddAttribute("axis", static_cast<int64_t>(1));
+    auto* split1_arg = helper.MakeIntermediate();
+    auto* split2_arg = helper.MakeIntermediate();
+    helper.AddNode("Split", {concat_arg}, {split1_arg, split2_arg})
+        .AddAttribute("axis", static_cast<int64_t>(-3));
+    helper.AddNode("Transpose", {split1_arg}, {output1_arg}).AddAttribute("perm", nchw_to_nhwc);
+    helper.AddNode("Transpose", {split2_arg}, {output2_arg}).AddAttribute("perm", nchw_to_nhwc);
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+TEST(TransposeOptimizerTests, Reduction) {
+  auto test_case = [&](int64_t keepdims) {
+    auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({2, 8, 6, 6});
+      auto* output_arg = helper.MakeOutput();
+
+      auto* transpose_arg = helper.AddTransposeNode(input_arg, nchw_to_nhwc);
+      auto& reduce_node = helper.AddNode("ReduceMean", {transpose_arg}, {output_arg});
+      reduce_node.AddAttribute("axes", std::vector<int64_t>{1, -2});
+      reduce_node.AddAttribute("keepdims", keepdims);
+    };
+
+    auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["Transpose"], keepdims != 0 ? 1 : 0);
+    };
+
+    TransposeOptimizerTester(build_test_case, check_graph);
+  };
+
+  test_case(1);
+  test_case(0);
+}
+
+TEST(TransposeOptimizerTests, SharedTranspose) {
+  // The Transpose node has multiple consumers, so it is not sunk.
+  auto build_test_case = [&](TransposeOptimizerTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({3, 4, 5});
+    auto* output1_arg = helper.MakeOutput();
+    auto* output2_arg = helper.MakeOutput();
+
+    auto* transpose_arg = helper.AddTransposeNode(input_arg, {2, 0, 1});
+    helper.AddNode("Relu", {transpose_arg}, {output1_arg});
+    helper.AddNode("Neg", {transpose_arg}, {output2_arg});
+  };
+
+  auto check_graph = [&](TransposeOptimizerInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 1);
+  };
+
+  TransposeOptimizerTester(build_test_case, check_graph);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -23,12 +23,57 @@
 namespace onnxruntime {
 namespace perftest {
 
+// Values above ORT_ENABLE_ALL enable all optimizations too.
+static bool ParseOptimizationLevel(long value, GraphOptimizationLevel& level) {
+  switch (value) {
+    case ORT_DISABLE_ALL:
+      level = ORT_DISABLE_ALL;
+      return true;
+    case ORT_ENABLE_BASIC:
+      level = ORT_ENABLE_BASIC;
+      return true;
+    case ORT_ENABLE_EXTENDED:
+      level = ORT_ENABLE_EXTENDED;
+      return true;
+    case ORT_ENABLE_ALL:
+      level = ORT_ENABLE_ALL;
+      return true;
+    default:
+      if (value > ORT_ENABLE_ALL) {  // relax constraint
+        level = ORT_ENABLE_ALL;
+        return true;
+      }
+      return false;
+  }
+}
+
+static bool ParseLoadMethod(const std::basic_string<ORTCHAR_T>& value, ModelLoadMethod& method) {
+  if (!CompareCString(value.c_str(), ORT_TSTR("file"))) {
+    method = ModelLoadMethod::kFile;
+  } else if (!CompareCString(value.c_str(), ORT_TSTR("array"))) {
+    method = ModelLoadMethod::kArray;
+  } else if (!CompareCString(value.c_str(), ORT_TSTR("mmap"))) {
+    method = ModelLoadMethod::kMmap;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 /*static*/ void CommandLineParser::ShowUsage() {
   printf(
-      "perf_test [options...] model_path result_file\n"
+      "perf_test [options...] model_path [mixed_model_path...] result_file\n"
+      "The sessions of the mixed models, if any, are run along with those of model_path, one run of each model after "
+      "the other.\n"
       "Options:\n"
       "\t-m [test_mode]: Specifies the test mode. Value could be 'duration' or 'times'.\n"
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. "
+      "\t-q [qps]: Runs an open loop test instead for the duration given by -t: requests arrive at qps per second on "
+      "average as a Poisson process, whether or not the earlier ones completed, and are served by the number of "
+      "concurrent runs given by -c. Reports the percentiles of the latencies from arrival to completion and the "
+      "queueing delays.\n"
+      "\t-L [concurrency levels]: Comma separated numbers of concurrent runs to test one after the other in open loop "
+      "mode, e.g. 1,2,4,8, for a curve of latency against throughput.\n"
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
@@ -39,18 +84,31 @@ namespace perftest {
       "\t-r [repeated_times]: Specifies the repeated times if running in 'times' test mode.Default:1000.\n"
       "\t-t [seconds_to_run]: Specifies the seconds to run for 'duration' mode. Default:600.\n"
       "\t-p [profile_file]: Specifies the profile name to enable profiling and dump the profile data to the file.\n"
+      "\t-R [profile_file]: Replays each node of the model recorded in the profile on its own, at the input shapes it "
+      "ran with, on every provider given by -e (which may be repeated, e.g. -e cpu -e cuda), and writes the mean time "
+      "of each node on each provider to result_file. Each node is run the number of times given by -r.\n"
       "\t-s: Show statistics result, like P75, P90.\n"
       "\t-v: Show verbose information.\n"
       "\t-x [thread_size]: Session thread pool size, must >=0.\n"
+      "\t-G: The sessions share the thread pools of the environment, whose size -x sets, instead of creating their own.\n"
+      "\t-n [sessions]: Creates that many sessions of each model, which the runs are spread over. Default:1.\n"
+      "\t-I: Binds the inputs on the device of the provider once and the outputs to it with IOBinding, so the runs "
+      "don't copy them from and to the CPU.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
       "\t-o [optimization level]: Default is 1. Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels. \n"
+      "\t-O [optimization levels]: Comma separated optimization levels to test one after the other, e.g. 0,1,99, to "
+      "compare their session creation time, first run, memory and run time.\n"
+      "\t-l [load methods]: Comma separated ways to load the model to test one after the other: 'file' from its path, "
+      "'array' from a copy of the file in memory, 'mmap' from a mapping of the file. Default:'file'.\n"
+      "\t-w [optimized_model_path]: Writes the model optimized at the level given by -o to the path, then also tests "
+      "the sessions loading it, which skip the optimizations already applied.\n"
       "\t-h: help\n");
 }
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:c:o:AMPvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:R:t:p:x:c:n:o:O:l:w:q:L:AGIMPvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -95,6 +153,10 @@ namespace perftest {
         } else {
           return false;
         }
+        test_config.machine_config.provider_type_names.push_back(test_config.machine_config.provider_type_name);
+        break;
+      case 'R':
+        test_config.run_config.replay_profile_file = optarg;
         break;
       case 'r':
         test_config.run_config.repeated_times = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
@@ -125,6 +187,20 @@ namespace perftest {
       case 'P':
         test_config.run_config.enable_sequential_execution = false;
         break;
+      case 'G':
+        test_config.run_config.use_global_thread_pools = true;
+        break;
+      case 'I':
+        test_config.run_config.bind_io = true;
+        break;
+      case 'n': {
+        const long sessions = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (sessions <= 0) {
+          return false;
+        }
+        test_config.run_config.sessions_per_model = static_cast<size_t>(sessions);
+        break;
+      }
       case 'c':
         test_config.run_config.concurrent_session_runs =
             static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
@@ -132,31 +208,82 @@ namespace perftest {
           return false;
         }
         break;
-      case 'o': {
-        int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        switch (tmp) {
-          case ORT_DISABLE_ALL:
-            test_config.run_config.optimization_level = ORT_DISABLE_ALL;
-            break;
-          case ORT_ENABLE_BASIC:
-            test_config.run_config.optimization_level = ORT_ENABLE_BASIC;
+      case 'q': {
+        const long qps = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (qps <= 0) {
+          return false;
+        }
+        test_config.run_config.target_qps = static_cast<size_t>(qps);
+        test_config.run_config.test_mode = TestMode::kOpenLoopMode;
+        break;
+      }
+      case 'L': {
+        test_config.run_config.concurrency_levels.clear();
+        ORTCHAR_T* level_str = optarg;
+        for (;;) {
+          ORTCHAR_T* end = nullptr;
+          const long level = OrtStrtol<PATH_CHAR_TYPE>(level_str, &end);
+          if (end == level_str || level <= 0) {
+            return false;
+          }
+          test_config.run_config.concurrency_levels.push_back(static_cast<size_t>(level));
+          if (*end == 0) {
             break;
-          case ORT_ENABLE_EXTENDED:
-            test_config.run_config.optimization_level = ORT_ENABLE_EXTENDED;
+          }
+          if (*end != ORT_TSTR(',')) {
+            return false;
+          }
+          level_str = end + 1;
+        }
+        break;
+      }
+      case 'o':
+        if (!ParseOptimizationLevel(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr),
+                                    test_config.run_config.optimization_level)) {
+          return false;
+        }
+        break;
+      case 'O': {
+        test_config.run_config.compared_optimization_levels.clear();
+        ORTCHAR_T* level_str = optarg;
+        for (;;) {
+          ORTCHAR_T* end = nullptr;
+          GraphOptimizationLevel level;
+          if (!ParseOptimizationLevel(OrtStrtol<PATH_CHAR_TYPE>(level_str, &end), level) || end == level_str) {
+            return false;
+          }
+          test_config.run_config.compared_optimization_levels.push_back(level);
+          if (*end == 0) {
             break;
-          case ORT_ENABLE_ALL:
-            test_config.run_config.optimization_level = ORT_ENABLE_ALL;
+          }
+          if (*end != ORT_TSTR(',')) {
+            return false;
+          }
+          level_str = end + 1;
+        }
+        break;
+      }
+      case 'l': {
+        test_config.run_config.load_methods.clear();
+        std::basic_string<ORTCHAR_T> methods = optarg;
+        size_t start = 0;
+        for (;;) {
+          const size_t end = methods.find(ORT_TSTR(','), start);
+          ModelLoadMethod method;
+          if (!ParseLoadMethod(methods.substr(start, end - start), method)) {
+            return false;
+          }
+          test_config.run_config.load_methods.push_back(method);
+          if (end == std::basic_string<ORTCHAR_T>::npos) {
             break;
-          default: {
-            if (tmp > ORT_ENABLE_ALL) {  // relax constraint
-              test_config.run_config.optimization_level = ORT_ENABLE_ALL;
-            } else {
-              return false;
-            }
           }
+          start = end + 1;
         }
         break;
       }
+      case 'w':
+        test_config.run_config.optimized_model_file_path = optarg;
+        break;
       case '?':
       case 'h':
       default:
@@ -164,13 +291,14 @@ namespace perftest {
     }
   }
 
-  // parse model_path and result_file_path
+  // parse model_path, the mixed model paths and result_file_path
   argc -= optind;
   argv += optind;
-  if (argc != 2) return false;
+  if (argc < 2) return false;
 
   test_config.model_info.model_file_path = argv[0];
-  test_config.model_info.result_file_path = argv[1];
+  test_config.model_info.mixed_model_file_paths.assign(argv + 1, argv + argc - 1);
+  test_config.model_info.result_file_path = argv[argc - 1];
 
   return true;
 }
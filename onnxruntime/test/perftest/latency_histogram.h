@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// A histogram of latencies in microseconds in the manner of an HDR histogram: values below 2^kSubBucketBits are
+// counted exactly, and every larger power of two range is split into 2^kSubBucketBits buckets, so a percentile is
+// within 0.1% of the recorded value whatever its magnitude, without keeping the values.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() : counts_(kSubBucketCount) {}
+
+  void Record(int64_t value) {
+    value = std::max<int64_t>(value, 0);
+    const size_t index = Index(static_cast<uint64_t>(value));
+    if (index >= counts_.size()) {
+      counts_.resize(index + 1);
+    }
+    ++counts_[index];
+    ++total_count_;
+    sum_ += value;
+    max_ = std::max(max_, value);
+  }
+
+  int64_t TotalCount() const { return total_count_; }
+  int64_t Max() const { return max_; }
+  double Mean() const { return total_count_ == 0 ? 0.0 : static_cast<double>(sum_) / total_count_; }
+
+  // The value that percentile (0 to 100) percent of the recorded values are less than or equal to, as the highest
+  // value of its bucket. 0 if nothing was recorded.
+  int64_t ValueAtPercentile(double percentile) const {
+    if (total_count_ == 0) {
+      return 0;
+    }
+    const double rank = std::min(percentile, 100.0) / 100.0 * total_count_;
+    const int64_t target = std::max<int64_t>(1, static_cast<int64_t>(rank + 0.5));
+    int64_t count = 0;
+    for (size_t index = 0; index < counts_.size(); ++index) {
+      count += counts_[index];
+      if (count >= target) {
+        return std::min(HighestValue(index), max_);
+      }
+    }
+    return max_;
+  }
+
+ private:
+  static constexpr int kSubBucketBits = 10;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+    int shift = 0;
+    while ((value >> shift) >= 2 * kSubBucketCount) {
+      ++shift;
+    }
+    // value >> shift is in [kSubBucketCount, 2 * kSubBucketCount)
+    return static_cast<size_t>(kSubBucketCount * (shift + 1) + ((value >> shift) - kSubBucketCount));
+  }
+
+  static int64_t HighestValue(size_t index) {
+    if (index < kSubBucketCount) {
+      return static_cast<int64_t>(index);
+    }
+    const int shift = static_cast<int>(index / kSubBucketCount) - 1;
+    const uint64_t sub_bucket = kSubBucketCount + index % kSubBucketCount;
+    return static_cast<int64_t>(((sub_bucket + 1) << shift) - 1);
+  }
+
+  std::vector<int64_t> counts_;
+  int64_t total_count_{0};
+  int64_t sum_{0};
+  int64_t max_{0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
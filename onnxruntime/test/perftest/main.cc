@@ -3,12 +3,48 @@
 
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
+#include <iostream>
 #include <random>
+#include <vector>
 #include "command_args_parser.h"
+#include "op_replay.h"
+#include "ort_test_session.h"
 #include "performance_runner.h"
 
 using namespace onnxruntime;
 
+// The tests to compare: the model at each optimization level given by -O, or at the one given by -o, loaded by each
+// of the methods given by -l, and then the optimized model written by -w loaded by each of the methods.
+static std::vector<perftest::PerformanceTestConfig> GetComparedConfigs(
+    const perftest::PerformanceTestConfig& test_config) {
+  const perftest::RunConfig& run_config = test_config.run_config;
+  std::vector<GraphOptimizationLevel> levels = run_config.compared_optimization_levels;
+  if (levels.empty()) {
+    levels.push_back(run_config.optimization_level);
+  }
+  std::vector<perftest::ModelLoadMethod> load_methods = run_config.load_methods;
+  if (load_methods.empty()) {
+    load_methods.push_back(run_config.load_method);
+  }
+
+  std::vector<perftest::PerformanceTestConfig> configs;
+  for (GraphOptimizationLevel level : levels) {
+    for (perftest::ModelLoadMethod load_method : load_methods) {
+      configs.push_back(test_config);
+      configs.back().run_config.optimization_level = level;
+      configs.back().run_config.load_method = load_method;
+    }
+  }
+  if (!run_config.optimized_model_file_path.empty()) {
+    for (perftest::ModelLoadMethod load_method : load_methods) {
+      configs.push_back(test_config);
+      configs.back().run_config.load_method = load_method;
+      configs.back().run_config.load_optimized_model = true;
+    }
+  }
+  return configs;
+}
+
 #ifdef _WIN32
 int real_main(int argc, wchar_t* argv[]) {
 #else
@@ -23,20 +59,54 @@ int real_main(int argc, char* argv[]) {
   try {
     OrtLoggingLevel logging_level = test_config.run_config.f_verbose 
       ? ORT_LOGGING_LEVEL_VERBOSE : ORT_LOGGING_LEVEL_WARNING;
-    env = Ort::Env(logging_level, "Default");
+    if (test_config.run_config.use_global_thread_pools) {
+      // the inter op thread pool is only used by the parallel executor
+      env = Ort::Env(logging_level, "Default", test_config.run_config.session_thread_pool_size,
+                     test_config.run_config.enable_sequential_execution ? 0 : -1);
+    } else {
+      env = Ort::Env(logging_level, "Default");
+    }
   } catch (const Ort::Exception& e) {
     fprintf(stderr, "Error creating environment: %s \n", e.what());
     return -1;
   }
+  if (!test_config.run_config.replay_profile_file.empty()) {
+    perftest::OpReplayRunner replay_runner(env, test_config);
+    auto status = replay_runner.Run();
+    if (!status.IsOK()) {
+      printf("Replay failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+    replay_runner.SerializeResult();
+    return 0;
+  }
+
+  if (!test_config.run_config.optimized_model_file_path.empty()) {
+    perftest::SaveOptimizedModel(env, test_config);
+  }
+
   std::random_device rd;
-  perftest::PerformanceRunner perf_runner(env, test_config, rd);
-  auto status = perf_runner.Run();
-  if (!status.IsOK()) {
-    printf("Run failed:%s\n", status.ErrorMessage().c_str());
-    return -1;
+  const std::vector<perftest::PerformanceTestConfig> configs = GetComparedConfigs(test_config);
+  std::vector<perftest::PerformanceResult> results;
+  for (const auto& config : configs) {
+    perftest::PerformanceRunner perf_runner(env, config, rd);
+    auto status = perf_runner.Run();
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    perf_runner.SerializeResult();
+    results.push_back(perf_runner.GetResult());
   }
 
-  perf_runner.SerializeResult();
+  if (results.size() > 1) {
+    std::cout << std::endl;
+    perftest::PerformanceResult::WriteStartupHeader(std::cout);
+    for (const auto& result : results) {
+      result.WriteStartupRow(std::cout);
+    }
+  }
 
   return 0;
 }
@@ -0,0 +1,403 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "op_replay.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include <core/graph/onnx_protobuf.h>
+#include "ort_test_session.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+// The value of the field key of an event written by the profiler, which writes each event on a line of its own, or
+// an empty string if the event has no such field.
+static std::string GetEventField(const std::string& event, const std::string& key) {
+  const std::string quoted_key = "\"" + key + "\"";
+  size_t pos = event.find(quoted_key);
+  if (pos == std::string::npos || (pos = event.find(':', pos + quoted_key.size())) == std::string::npos ||
+      (pos = event.find_first_not_of(' ', pos + 1)) == std::string::npos) {
+    return std::string();
+  }
+  if (event[pos] == '"') {
+    const size_t end = event.find('"', pos + 1);
+    return end == std::string::npos ? std::string() : event.substr(pos + 1, end - pos - 1);
+  }
+  const size_t end = event.find_first_of(",}", pos);
+  return event.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+static std::vector<std::string> Split(const std::string& value, char separator) {
+  std::vector<std::string> items;
+  std::istringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, separator)) {
+    items.push_back(item);
+  }
+  return items;
+}
+
+// "[1,3,224,224]" to its dimensions.
+static bool ParseShape(const std::string& shape_str, std::vector<int64_t>& shape) {
+  if (shape_str.size() < 2 || shape_str.front() != '[' || shape_str.back() != ']') {
+    return false;
+  }
+  shape.clear();
+  for (const auto& dim : Split(shape_str.substr(1, shape_str.size() - 2), ',')) {
+    shape.push_back(std::stoll(dim));
+  }
+  return true;
+}
+
+// "tensor(float)" to the type of its elements, the values of which are the same for ONNX and the C API.
+static bool ParseTensorType(const std::string& type_str, ONNXTensorElementDataType& type) {
+  const std::string prefix = "tensor(";
+  if (type_str.compare(0, prefix.size(), prefix) != 0 || type_str.back() != ')') {
+    return false;
+  }
+  std::string name = type_str.substr(prefix.size(), type_str.size() - prefix.size() - 1);
+  std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::toupper(c)); });
+  ONNX_NAMESPACE::TensorProto_DataType data_type;
+  if (!ONNX_NAMESPACE::TensorProto_DataType_Parse(name, &data_type)) {
+    return false;
+  }
+  type = static_cast<ONNXTensorElementDataType>(data_type);
+  return true;
+}
+
+static size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// A tensor to feed the node. The values of the inputs aren't in the profile: floating point inputs are random, and
+// the others are zeros, which are valid indices.
+static Ort::Value CreateInput(const std::vector<int64_t>& shape, ONNXTensorElementDataType type,
+                              std::mt19937& rand_engine) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+  size_t count = 1;
+  for (int64_t dim : shape) {
+    count *= static_cast<size_t>(dim);
+  }
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+    float* data = value.GetTensorMutableData<float>();
+    std::generate(data, data + count, [&]() { return dist(rand_engine); });
+  } else if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE) {
+    double* data = value.GetTensorMutableData<double>();
+    std::generate(data, data + count, [&]() { return dist(rand_engine); });
+  } else {
+    memset(value.GetTensorMutableData<uint8_t>(), 0, count * ElementSize(type));
+  }
+  return value;
+}
+
+// The single node model of node, with its inputs that are initializers of model as initializers, and the values of
+// its other inputs, which are the inputs of the single node model.
+static Status CreateNodeModel(const ONNX_NAMESPACE::ModelProto& model, const ONNX_NAMESPACE::NodeProto& node,
+                              const ReplayedNode& replayed_node, std::string& node_model_data,
+                              std::vector<std::string>& input_names, std::vector<Ort::Value>& input_values) {
+  for (const auto& attribute : node.attribute()) {
+    if (attribute.has_g() || attribute.graphs_size() > 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "nodes with subgraphs aren't replayed");
+    }
+  }
+
+  ONNX_NAMESPACE::ModelProto node_model;
+  node_model.set_ir_version(model.ir_version());
+  *node_model.mutable_opset_import() = model.opset_import();
+  auto* graph = node_model.mutable_graph();
+  graph->set_name(node.name());
+  *graph->add_node() = node;
+
+  const auto types = Split(replayed_node.input_types, ';');
+  const auto shapes = Split(replayed_node.input_shapes, ';');
+  std::mt19937 rand_engine(1234);
+  std::set<std::string> added_inputs;
+  for (int i = 0; i < node.input_size(); ++i) {
+    const std::string& name = node.input(i);
+    if (name.empty() || !added_inputs.insert(name).second) {
+      continue;
+    }
+
+    const auto& initializers = model.graph().initializer();
+    auto initializer = std::find_if(initializers.begin(), initializers.end(),
+                                    [&name](const ONNX_NAMESPACE::TensorProto& tensor) { return tensor.name() == name; });
+    if (initializer != initializers.end()) {
+      *graph->add_initializer() = *initializer;
+      continue;
+    }
+
+    ONNXTensorElementDataType type;
+    std::vector<int64_t> shape;
+    if (static_cast<size_t>(i) >= types.size() || static_cast<size_t>(i) >= shapes.size() ||
+        !ParseTensorType(types[i], type) || !ParseShape(shapes[i], shape)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "the profile has no tensor type and shape for input ",
+                             name);
+    }
+    if (ElementSize(type) == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "inputs of type ", types[i], " aren't replayed");
+    }
+
+    auto* input = graph->add_input();
+    input->set_name(name);
+    auto* tensor_type = input->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(static_cast<ONNX_NAMESPACE::TensorProto_DataType>(type));
+    for (int64_t dim : shape) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    input_names.push_back(name);
+    input_values.push_back(CreateInput(shape, type, rand_engine));
+  }
+
+  // the types of the outputs are inferred
+  for (const auto& name : node.output()) {
+    if (!name.empty()) {
+      graph->add_output()->set_name(name);
+    }
+  }
+
+  node_model_data = node_model.SerializeAsString();
+  return Status::OK();
+}
+
+// The providers of the nodes in the run traces of a session.
+static std::string GetTracedProviders(Ort::Session& session) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  char* traces = session.DumpRunTraces(true, allocator);
+  std::set<std::string> providers;
+  std::istringstream stream(traces);
+  std::string event;
+  while (std::getline(stream, event)) {
+    if (GetEventField(event, "cat") == "Node") {
+      providers.insert(GetEventField(event, "provider"));
+    }
+  }
+  allocator.Free(traces);
+
+  std::string ran_on;
+  for (const auto& provider : providers) {
+    ran_on += (ran_on.empty() ? "" : "+") + provider;
+  }
+  return ran_on;
+}
+
+// Runs the single node model on provider_name repeated_times, with the inputs copied to the provider's device once
+// and the outputs left there.
+static ReplayTiming TimeNodeModel(Ort::Env& env, const RunConfig& run_config, const std::string& provider_name,
+                                  const std::string& node_model_data, const std::vector<std::string>& input_names,
+                                  const std::vector<Ort::Value>& input_values,
+                                  const ONNX_NAMESPACE::NodeProto& node) {
+  ReplayTiming timing;
+  try {
+    Ort::SessionOptions session_options;
+    AppendExecutionProvider(session_options, provider_name, run_config);
+    if (run_config.enable_cpu_mem_arena)
+      session_options.EnableCpuMemArena();
+    else
+      session_options.DisableCpuMemArena();
+    session_options.SetThreadPoolSize(run_config.session_thread_pool_size);
+    session_options.SetGraphOptimizationLevel(run_config.optimization_level);
+    session_options.SetRunTraceSampling(0, 1);
+    Ort::Session session(env, node_model_data.data(), node_model_data.size(), session_options);
+
+    auto output_location = CreateOutputAllocatorInfo(provider_name);
+    Ort::IoBinding binding(session);
+    for (size_t i = 0; i < input_names.size(); ++i) {
+      binding.BindInput(input_names[i].c_str(), input_values[i]);
+    }
+    for (const auto& name : node.output()) {
+      if (!name.empty()) {
+        binding.BindOutput(name.c_str(), output_location);
+      }
+    }
+    binding.SynchronizeInputs();
+
+    // the warm up run is traced to find out which providers computed the node
+    Ort::RunOptions warm_up_options;
+    warm_up_options.SetTraceRun(true);
+    session.Run(warm_up_options, binding);
+    binding.SynchronizeOutputs();
+    timing.ran_on = GetTracedProviders(session);
+
+    Ort::RunOptions run_options;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < run_config.repeated_times; ++i) {
+      session.Run(run_options, binding);
+      binding.SynchronizeOutputs();
+    }
+    const std::chrono::duration<double, std::micro> duration = std::chrono::high_resolution_clock::now() - start;
+    timing.mean_us = duration.count() / std::max<size_t>(run_config.repeated_times, 1);
+  } catch (const std::exception& ex) {
+    timing.error = ex.what();
+  }
+  return timing;
+}
+
+OpReplayRunner::OpReplayRunner(Ort::Env& env, const PerformanceTestConfig& test_config)
+    : env_(env), test_config_(test_config), provider_names_(test_config.machine_config.provider_type_names) {
+  if (provider_names_.empty()) {
+    provider_names_.push_back(kCpuExecutionProvider);
+  }
+}
+
+Status OpReplayRunner::ReadProfile() {
+  std::ifstream profile(test_config_.run_config.replay_profile_file);
+  if (!profile.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "failed to open the profile to replay");
+  }
+
+  // a node is replayed once for every set of input shapes it ran with
+  std::unordered_map<std::string, size_t> node_indices;
+  std::string event;
+  while (std::getline(profile, event)) {
+    const std::string name = GetEventField(event, "name");
+    const std::string suffix = "_kernel_time";
+    const std::string input_shapes = GetEventField(event, "input_shapes");
+    if (GetEventField(event, "cat") != "Node" || input_shapes.empty() || name.size() < suffix.size() ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+      continue;
+    }
+
+    const std::string node_name = name.substr(0, name.size() - suffix.size());
+    auto inserted = node_indices.emplace(node_name + "|" + input_shapes, nodes_.size());
+    if (inserted.second) {
+      ReplayedNode node;
+      node.node_name = node_name;
+      node.op_type = GetEventField(event, "op_name");
+      node.input_types = GetEventField(event, "input_types");
+      node.input_shapes = input_shapes;
+      node.recorded_provider = GetEventField(event, "provider");
+      nodes_.push_back(std::move(node));
+    }
+    auto& node = nodes_[inserted.first->second];
+    const double dur = std::stod(GetEventField(event, "dur"));
+    node.recorded_mean_us += (dur - node.recorded_mean_us) / static_cast<double>(++node.recorded_count);
+  }
+
+  if (nodes_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "the profile has no kernel events with the input types and shapes of the nodes");
+  }
+  return Status::OK();
+}
+
+Status OpReplayRunner::Run() {
+  ORT_RETURN_IF_ERROR(ReadProfile());
+
+  ONNX_NAMESPACE::ModelProto model;
+  std::ifstream model_stream(test_config_.model_info.model_file_path, std::ios::binary);
+  if (!model.ParseFromIstream(&model_stream)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "failed to load the model");
+  }
+  std::unordered_map<std::string, const ONNX_NAMESPACE::NodeProto*> model_nodes;
+  for (const auto& node : model.graph().node()) {
+    model_nodes.emplace(node.name(), &node);
+  }
+
+  for (auto& replayed_node : nodes_) {
+    std::cout << replayed_node.node_name << " (" << replayed_node.op_type << ") " << replayed_node.input_shapes
+              << ":";
+    std::string error;
+    auto model_node = model_nodes.find(replayed_node.node_name);
+    std::string node_model_data;
+    std::vector<std::string> input_names;
+    std::vector<Ort::Value> input_values;
+    if (replayed_node.node_name.empty() || model_node == model_nodes.end()) {
+      error = "not a node of the model, e.g. created by a graph optimization";
+    } else {
+      auto status = CreateNodeModel(model, *model_node->second, replayed_node, node_model_data, input_names,
+                                    input_values);
+      if (!status.IsOK()) {
+        error = status.ErrorMessage();
+      }
+    }
+
+    for (const auto& provider_name : provider_names_) {
+      ReplayTiming timing;
+      if (error.empty()) {
+        timing = TimeNodeModel(env_, test_config_.run_config, provider_name, node_model_data, input_names,
+                               input_values, *model_node->second);
+      } else {
+        timing.error = error;
+      }
+      if (timing.error.empty()) {
+        std::cout << " " << provider_name << " " << timing.mean_us << "us";
+        if (timing.ran_on != provider_name) {
+          std::cout << " (ran on " << timing.ran_on << ")";
+        }
+      } else {
+        std::cout << " " << provider_name << " failed: " << timing.error;
+      }
+      replayed_node.timings.push_back(std::move(timing));
+    }
+    std::cout << std::endl;
+  }
+  return Status::OK();
+}
+
+void OpReplayRunner::SerializeResult() const {
+  std::ofstream outfile(test_config_.model_info.result_file_path, std::ofstream::out | std::ofstream::trunc);
+  if (!outfile.good()) {
+    printf("failed to open result file");
+    return;
+  }
+
+  outfile << "node_name,op_type,input_shapes,recorded_provider,recorded_count,recorded_mean_us";
+  for (const auto& provider_name : provider_names_) {
+    outfile << "," << provider_name << "_mean_us," << provider_name << "_ran_on";
+  }
+  outfile << ",fastest_provider" << std::endl;
+
+  for (const auto& node : nodes_) {
+    // the shapes are separated by ';' and their dimensions by ',', so they're quoted
+    outfile << node.node_name << "," << node.op_type << ",\"" << node.input_shapes << "\","
+            << node.recorded_provider << "," << node.recorded_count << "," << node.recorded_mean_us;
+    // only a provider that computed the node itself can be the fastest
+    const std::string* fastest_provider = nullptr;
+    double fastest_us = 0;
+    for (size_t i = 0; i < provider_names_.size(); ++i) {
+      const auto& timing = node.timings[i];
+      outfile << "," << timing.mean_us << "," << (timing.error.empty() ? timing.ran_on : "error");
+      if (timing.error.empty() && timing.ran_on == provider_names_[i] &&
+          (fastest_provider == nullptr || timing.mean_us < fastest_us)) {
+        fastest_provider = &provider_names_[i];
+        fastest_us = timing.mean_us;
+      }
+    }
+    outfile << "," << (fastest_provider == nullptr ? "" : *fastest_provider) << std::endl;
+  }
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+// onnxruntime dependencies
+#include <core/common/common.h>
+#include <core/common/status.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include "test_configuration.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+// The runs of a node on its own on one execution provider.
+struct ReplayTiming {
+  // the mean time of a run in microseconds, or -1 if the node couldn't be run
+  double mean_us{-1};
+  // the providers that computed the node, which differ from the requested one if it has no kernel for the node
+  // and the node fell back to another provider
+  std::string ran_on;
+  std::string error;
+};
+
+// A node of the model at one set of input shapes recorded for it in the profile.
+struct ReplayedNode {
+  std::string node_name;
+  std::string op_type;
+  std::string input_types;
+  std::string input_shapes;
+  // the provider of the node and its mean kernel time in the profile
+  std::string recorded_provider;
+  size_t recorded_count{0};
+  double recorded_mean_us{0};
+  // one per replay provider, in the order of MachineConfig::provider_type_names
+  std::vector<ReplayTiming> timings;
+};
+
+// Replays the nodes of a model recorded in a profile one at a time: each node becomes a model of its own, whose
+// inputs are random tensors of the types and shapes the node ran with and whose constant inputs are the
+// initializers of the model, and is run on each of the providers to compare, so the fastest provider of each op
+// is known before choosing a partitioning of the model.
+//
+// The profile must have been written with the input types and shapes of the kernels, and the nodes that graph
+// optimizations created, e.g. fused nodes, aren't in the model, so record it with optimizations disabled (-o 0)
+// to replay every node.
+class OpReplayRunner {
+ public:
+  OpReplayRunner(Ort::Env& env, const PerformanceTestConfig& test_config);
+
+  Status Run();
+
+  // Writes a CSV table of the nodes with the time of each provider to the result file.
+  void SerializeResult() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OpReplayRunner);
+
+ private:
+  Status ReadProfile();
+
+  Ort::Env& env_;
+  const PerformanceTestConfig test_config_;
+  std::vector<std::string> provider_names_;
+  std::vector<ReplayedNode> nodes_;
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
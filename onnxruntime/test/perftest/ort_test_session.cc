@@ -1,6 +1,11 @@
 #include "ort_test_session.h"
 #include <core/session/onnxruntime_cxx_api.h>
 #include <assert.h>
+#include <fstream>
+#include <iterator>
+#include "core/framework/allocator.h"
+#include "core/platform/env.h"
+#include "gsl/gsl_util"
 #include "providers.h"
 #include "TestCase.h"
 
@@ -11,28 +16,14 @@
 namespace onnxruntime {
 namespace perftest {
 
-std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
-  //Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
-  const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
-  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
-  auto& input = test_inputs_.at(id);
-  auto start = std::chrono::high_resolution_clock::now();
-  auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
-                                    output_names_raw_ptr.data(), output_names_raw_ptr.size());
-  auto end = std::chrono::high_resolution_clock::now();
-  std::chrono::duration<double> duration_seconds = end - start;
-  return duration_seconds;
-}
-
-OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd,
-                                               const PerformanceTestConfig& performance_test_config,
-                                               const TestModelInfo* m)
-    : rand_engine_(rd()), input_names_(m->GetInputCount()), input_length_(m->GetInputCount()) {
-  Ort::SessionOptions session_options;
-  const std::string& provider_name = performance_test_config.machine_config.provider_type_name;
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& provider_name,
+                             const RunConfig& run_config) {
+  // only used by the providers included in the build
+  ORT_UNUSED_PARAMETER(session_options);
+  ORT_UNUSED_PARAMETER(run_config);
   if (provider_name == onnxruntime::kMklDnnExecutionProvider) {
 #ifdef USE_MKLDNN
-    ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_Mkldnn(session_options, performance_test_config.run_config.enable_cpu_mem_arena ? 1 : 0));
+    ORT_THROW_ON_ERROR(OrtSessionOptionsAppendExecutionProvider_Mkldnn(session_options, run_config.enable_cpu_mem_arena ? 1 : 0));
 #else
     ORT_THROW("MKL-DNN is not supported in this build\n");
 #endif
@@ -76,6 +67,100 @@ OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device
   } else if (!provider_name.empty() && provider_name != onnxruntime::kCpuExecutionProvider) {
     ORT_THROW("This backend is not included in perf test runner.\n");
   }
+}
+
+Ort::AllocatorInfo CreateOutputAllocatorInfo(const std::string& provider_name) {
+  if (provider_name == kCudaExecutionProvider || provider_name == kTensorrtExecutionProvider) {
+    return Ort::AllocatorInfo(CUDA, OrtArenaAllocator, 0, OrtMemTypeDefault);
+  }
+  return Ort::AllocatorInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+}
+
+Ort::IoBinding OnnxRuntimeTestSession::AcquireBinding(size_t test_data_id) {
+  {
+    std::lock_guard<std::mutex> lock(bindings_mutex_);
+    if (free_bindings_.size() < test_inputs_.size()) {
+      free_bindings_.resize(test_inputs_.size());
+    }
+    auto& free_bindings = free_bindings_[test_data_id];
+    if (!free_bindings.empty()) {
+      Ort::IoBinding binding = std::move(free_bindings.back());
+      free_bindings.pop_back();
+      return binding;
+    }
+  }
+
+  Ort::IoBinding binding(session_);
+  const auto& input = test_inputs_.at(test_data_id);
+  for (size_t i = 0; i != input_names_.size(); ++i) {
+    binding.BindInput(input_names_[i], input[i]);
+  }
+  for (const char* output_name : output_names_raw_ptr) {
+    binding.BindOutput(output_name, output_allocator_info_);
+  }
+  binding.SynchronizeInputs();
+  return binding;
+}
+
+void OnnxRuntimeTestSession::ReleaseBinding(size_t test_data_id, Ort::IoBinding binding) {
+  std::lock_guard<std::mutex> lock(bindings_mutex_);
+  free_bindings_[test_data_id].push_back(std::move(binding));
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
+  //Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
+  const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
+  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+  if (bind_io_) {
+    // the inputs are already on the device and the outputs stay there, so only the run and waiting for the device
+    // to complete it are timed
+    Ort::IoBinding binding = AcquireBinding(id);
+    auto start = std::chrono::high_resolution_clock::now();
+    session_.Run(Ort::RunOptions{nullptr}, binding);
+    binding.SynchronizeOutputs();
+    auto end = std::chrono::high_resolution_clock::now();
+    ReleaseBinding(id, std::move(binding));
+    return end - start;
+  }
+  auto& input = test_inputs_.at(id);
+  auto start = std::chrono::high_resolution_clock::now();
+  auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
+                                    output_names_raw_ptr.data(), output_names_raw_ptr.size());
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> duration_seconds = end - start;
+  return duration_seconds;
+}
+
+SessionStats OnnxRuntimeTestSession::GetStats() const {
+  SessionStats stats = stats_;
+  session_.GetMemoryArenaStats(nullptr, stats.arena_reserved_bytes, stats.arena_in_use_bytes);
+  session_.GetMemoryArenaStats(onnxruntime::CUDA, stats.gpu_arena_reserved_bytes, stats.gpu_arena_in_use_bytes);
+  return stats;
+}
+
+void OnnxRuntimeTestSession::ThreadSafeRun() {
+  size_t id;
+  {
+    std::lock_guard<std::mutex> lock(rand_mutex_);
+    const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
+    id = static_cast<size_t>(dist_(rand_engine_, p));
+  }
+  if (bind_io_) {
+    Ort::IoBinding binding = AcquireBinding(id);
+    session_.Run(Ort::RunOptions{nullptr}, binding);
+    binding.SynchronizeOutputs();
+    ReleaseBinding(id, std::move(binding));
+    return;
+  }
+  auto& input = test_inputs_.at(id);
+  session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
+               output_names_raw_ptr.data(), output_names_raw_ptr.size());
+}
+
+static Ort::SessionOptions CreateSessionOptions(const PerformanceTestConfig& performance_test_config) {
+  Ort::SessionOptions session_options;
+  AppendExecutionProvider(session_options, performance_test_config.machine_config.provider_type_name,
+                          performance_test_config.run_config);
 
   if (performance_test_config.run_config.enable_cpu_mem_arena)
     session_options.EnableCpuMemArena();
@@ -90,13 +175,86 @@ OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device
     session_options.EnableSequentialExecution();
   else
     session_options.DisableSequentialExecution();
-  fprintf(stdout, "Setting thread pool size to %d\n", performance_test_config.run_config.session_thread_pool_size);
-  session_options.SetThreadPoolSize(performance_test_config.run_config.session_thread_pool_size);
+  if (performance_test_config.run_config.use_global_thread_pools) {
+    session_options.EnableGlobalThreadPools();
+  } else {
+    fprintf(stdout, "Setting thread pool size to %d\n", performance_test_config.run_config.session_thread_pool_size);
+    session_options.SetThreadPoolSize(performance_test_config.run_config.session_thread_pool_size);
+  }
   // Set optimization level.
   session_options.SetGraphOptimizationLevel(performance_test_config.run_config.optimization_level);
   if (!performance_test_config.run_config.profile_file.empty())
     session_options.EnableProfiling(performance_test_config.run_config.profile_file.c_str());
-  session_ = Ort::Session(env, performance_test_config.model_info.model_file_path.c_str(), session_options);
+  return session_options;
+}
+
+void SaveOptimizedModel(Ort::Env& env, const PerformanceTestConfig& performance_test_config) {
+  Ort::SessionOptions session_options = CreateSessionOptions(performance_test_config);
+  ORT_THROW_ON_ERROR(OrtSetOptimizedModelFilePath(
+      session_options, performance_test_config.run_config.optimized_model_file_path.c_str()));
+  Ort::Session session(env, performance_test_config.model_info.model_file_path.c_str(), session_options);
+}
+
+static double ToMilliseconds(int64_t us) {
+  return us / 1000.0;
+}
+
+OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd,
+                                               const PerformanceTestConfig& performance_test_config,
+                                               const TestModelInfo* m)
+    : rand_engine_(rd()),
+      input_names_(m->GetInputCount()),
+      input_length_(m->GetInputCount()),
+      bind_io_(performance_test_config.run_config.bind_io) {
+  Ort::SessionOptions session_options = CreateSessionOptions(performance_test_config);
+  if (bind_io_) {
+    output_allocator_info_ = CreateOutputAllocatorInfo(performance_test_config.machine_config.provider_type_name);
+  }
+  const RunConfig& run_config = performance_test_config.run_config;
+  const std::basic_string<ORTCHAR_T>& model_path = run_config.load_optimized_model
+                                                       ? run_config.optimized_model_file_path
+                                                       : performance_test_config.model_info.model_file_path;
+
+  // the creation time includes reading or mapping the file for the methods that load the model from memory
+  auto start = std::chrono::high_resolution_clock::now();
+  switch (run_config.load_method) {
+    case ModelLoadMethod::kFile:
+      session_ = Ort::Session(env, model_path.c_str(), session_options);
+      break;
+    case ModelLoadMethod::kArray: {
+      std::ifstream model_file(model_path, std::ios::binary);
+      if (!model_file) {
+        ORT_THROW("failed to read the model file");
+      }
+      std::vector<char> model_data{std::istreambuf_iterator<char>(model_file), std::istreambuf_iterator<char>()};
+      session_ = Ort::Session(env, model_data.data(), model_data.size(), session_options);
+      break;
+    }
+    case ModelLoadMethod::kMmap: {
+      std::ifstream model_file(model_path, std::ios::binary | std::ios::ate);
+      if (!model_file) {
+        ORT_THROW("failed to read the model file");
+      }
+      const auto model_length = static_cast<size_t>(model_file.tellg());
+      void* model_data = nullptr;
+      OrtCallback unmap;
+      ORT_THROW_IF_ERROR(Env::Default().MapFileIntoMemory(model_path.c_str(), 0, model_length, model_data, unmap));
+      // the session copies what it needs of the model, so it's unmapped once the session is created
+      auto unmap_guard = gsl::finally([&unmap]() { unmap.f(unmap.param); });
+      session_ = Ort::Session(env, model_data, model_length, session_options);
+      break;
+    }
+  }
+  std::chrono::duration<double, std::milli> creation_ms = std::chrono::high_resolution_clock::now() - start;
+  stats_.creation_ms = creation_ms.count();
+
+  const OrtSessionInitializationTimes times = session_.GetInitializationTimes();
+  stats_.load_ms = ToMilliseconds(times.load_us);
+  stats_.initialize_ms = ToMilliseconds(times.initialize_us);
+  stats_.graph_transformation_ms = ToMilliseconds(times.graph_transformation_us);
+  stats_.graph_partitioning_ms = ToMilliseconds(times.graph_partitioning_us);
+  stats_.initializer_loading_ms = ToMilliseconds(times.initializer_loading_us);
+  stats_.kernel_creation_ms = ToMilliseconds(times.kernel_creation_us);
 
   size_t output_count = session_.GetOutputCount();
   output_names_.resize(output_count);
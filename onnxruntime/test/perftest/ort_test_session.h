@@ -3,12 +3,26 @@
 
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
+#include <mutex>
 #include <random>
 #include "test_configuration.h"
 #include "test_session.h"
 class TestModelInfo;
 namespace onnxruntime {
 namespace perftest {
+// Append the execution provider named provider_name, one of the onnxruntime::k*ExecutionProvider names, to
+// session_options. Throws if it isn't included in this build.
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& provider_name,
+                             const RunConfig& run_config);
+
+// Where the outputs of the runs on the provider named provider_name are allocated when they're bound to its device:
+// on the GPU for CUDA and TensorRT, on the CPU otherwise.
+Ort::AllocatorInfo CreateOutputAllocatorInfo(const std::string& provider_name);
+
+// Create a session of the model under test with the options of performance_test_config, to write the model
+// optimized at its optimization level to RunConfig::optimized_model_file_path.
+void SaveOptimizedModel(Ort::Env& env, const PerformanceTestConfig& performance_test_config);
+
 class OnnxRuntimeTestSession : public TestSession {
  public:
   OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd, const PerformanceTestConfig& performance_test_config,
@@ -31,13 +45,23 @@ class OnnxRuntimeTestSession : public TestSession {
     }
   }
   std::chrono::duration<double> Run() override;
+  void ThreadSafeRun() override;
+  SessionStats GetStats() const override;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
+  // A binding of the inputs of test data set test_data_id, bound on the devices of the session once, and of the
+  // outputs to the device of the provider. Each concurrent run takes a binding of its own.
+  Ort::IoBinding AcquireBinding(size_t test_data_id);
+  void ReleaseBinding(size_t test_data_id, Ort::IoBinding binding);
+
   Ort::Session session_{nullptr};
+  SessionStats stats_;
   std::mt19937 rand_engine_;
   std::uniform_int_distribution<int> dist_;
+  // serializes the picks of the inputs of ThreadSafeRun
+  std::mutex rand_mutex_;
   std::vector<std::vector<Ort::Value>> test_inputs_;
   std::vector<std::string> output_names_;
   // The same size with output_names_.
@@ -45,6 +69,12 @@ class OnnxRuntimeTestSession : public TestSession {
   std::vector<const char*> output_names_raw_ptr;
   std::vector<char*> input_names_;
   const int input_length_;
+  // whether the runs go through IoBindings rather than taking the inputs from and returning the outputs to the CPU
+  const bool bind_io_;
+  Ort::AllocatorInfo output_allocator_info_{nullptr};
+  // the bindings not in use by a run, per test data set
+  std::mutex bindings_mutex_;
+  std::vector<std::vector<Ort::IoBinding>> free_bindings_;
 };
 
 }  // namespace perftest
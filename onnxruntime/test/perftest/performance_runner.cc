@@ -7,7 +7,11 @@
 #endif
 
 #include "performance_runner.h"
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -46,8 +50,13 @@ Status PerformanceRunner::Run() {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
-  // warm up
-  RunOneIteration<true>();
+  // warm up every session, timing the first run of the first one on its own
+  for (size_t i = 0; i != sessions_.size(); ++i) {
+    std::chrono::duration<double> first_run_seconds = sessions_[i].second->Run();
+    if (i == 0) {
+      performance_result_.first_run_time_cost = first_run_seconds.count();
+    }
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
@@ -60,12 +69,18 @@ Status PerformanceRunner::Run() {
     case TestMode::KFixRepeatedTimesMode:
       ORT_RETURN_IF_ERROR(RepeatedTimesTest());
       break;
+    case TestMode::kOpenLoopMode:
+      ORT_RETURN_IF_ERROR(OpenLoopTest());
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
   }
 
   performance_result_.average_CPU_usage = p_ICPUUsage->GetUsage();
   performance_result_.peak_workingset_size = utils::GetPeakWorkingSetSize();
+  for (const auto& session : sessions_) {
+    performance_result_.session_stats.Add(session.second->GetStats());
+  }
 
   // TODO: end profiling
   // if (!performance_test_config_.run_config.profile_file.empty()) session_object->EndProfiling();
@@ -73,6 +88,22 @@ Status PerformanceRunner::Run() {
   std::cout << "Total time cost:" << performance_result_.total_time_cost << std::endl
             << "Total iterations:" << performance_result_.time_costs.size() << std::endl
             << "Average time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl;
+  const SessionStats& stats = performance_result_.session_stats;
+  std::cout << "Session creation time cost:" << stats.creation_ms << " ms" << std::endl
+            << "  Load:" << stats.load_ms << " ms" << std::endl
+            << "  Initialize:" << stats.initialize_ms << " ms (graph transformation:" << stats.graph_transformation_ms
+            << " ms, graph partitioning:" << stats.graph_partitioning_ms << " ms, initializer loading:"
+            << stats.initializer_loading_ms << " ms, kernel creation:" << stats.kernel_creation_ms << " ms)"
+            << std::endl
+            << "First run time cost:" << performance_result_.first_run_time_cost * 1000 << " ms" << std::endl
+            << "Working set after session creation:" << performance_result_.workingset_size_after_creation
+            << " bytes, peak:" << performance_result_.peak_workingset_size << " bytes" << std::endl
+            << "Arena reserved:" << stats.arena_reserved_bytes << " bytes, in use:" << stats.arena_in_use_bytes
+            << " bytes" << std::endl;
+  if (stats.gpu_arena_reserved_bytes != 0) {
+    std::cout << "GPU arena reserved:" << stats.gpu_arena_reserved_bytes
+              << " bytes, in use:" << stats.gpu_arena_in_use_bytes << " bytes" << std::endl;
+  }
   return Status::OK();
 }
 
@@ -110,7 +141,7 @@ Status PerformanceRunner::RunParallelDuration() {
       count++;
       counter++;
       tpool->Schedule([this, &counter, &m, &cv]() {
-        session_->ThreadSafeRun();
+        NextSession().second->ThreadSafeRun();
         // Simplified version of Eigen::Barrier
         std::lock_guard<std::mutex> lg(m);
         counter--;
@@ -143,7 +174,7 @@ Status PerformanceRunner::ForkJoinRepeat() {
     for (size_t i = 0; i != performance_test_config_.run_config.concurrent_session_runs; ++i) {
       counter++;
       tpool->Schedule([this, &counter, &m, &cv]() {
-        session_->ThreadSafeRun();
+        NextSession().second->ThreadSafeRun();
         // Simplified version of Eigen::Barrier
         std::lock_guard<std::mutex> lg(m);
         counter--;
@@ -158,6 +189,126 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::OpenLoopTest() {
+  const RunConfig& run_config = performance_test_config_.run_config;
+  if (run_config.target_qps == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "open loop mode requires a target QPS.");
+  }
+
+  std::vector<size_t> concurrency_levels = run_config.concurrency_levels;
+  if (concurrency_levels.empty()) {
+    concurrency_levels.push_back(run_config.concurrent_session_runs);
+  }
+
+  OpenLoopResult::WriteHeader(std::cout);
+  for (size_t concurrency : concurrency_levels) {
+    OpenLoopResult result;
+    ORT_RETURN_IF_ERROR(RunOpenLoop(concurrency, result));
+    result.WriteRow(std::cout);
+    performance_result_.open_loop_results.push_back(std::move(result));
+  }
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunOpenLoop(size_t concurrency, OpenLoopResult& result) {
+  using Clock = std::chrono::steady_clock;
+  const RunConfig& run_config = performance_test_config_.run_config;
+  result.concurrency = concurrency;
+  result.target_qps = run_config.target_qps;
+
+  // the arrivals of a Poisson process are exponentially distributed apart
+  std::random_device rd;
+  std::mt19937 rand_engine(rd());
+  std::exponential_distribution<double> interarrival_seconds(static_cast<double>(run_config.target_qps));
+
+  std::deque<Clock::time_point> arrivals;
+  bool arrivals_done = false;
+  std::mutex arrivals_mutex;
+  std::condition_variable arrivals_cv;
+  std::string error_message;
+
+  auto microseconds = [](Clock::duration duration) {
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  };
+  auto serve = [&]() {
+    for (;;) {
+      Clock::time_point arrival;
+      {
+        std::unique_lock<std::mutex> lock(arrivals_mutex);
+        arrivals_cv.wait(lock, [&]() { return arrivals_done || !arrivals.empty(); });
+        if (arrivals.empty()) {
+          return;
+        }
+        arrival = arrivals.front();
+        arrivals.pop_front();
+      }
+
+      const auto& session = NextSession();
+      const Clock::time_point start = Clock::now();
+      try {
+        session.second->ThreadSafeRun();
+      } catch (const std::exception& ex) {
+        std::lock_guard<std::mutex> guard(results_mutex_);
+        if (error_message.empty()) {
+          error_message = ex.what();
+        }
+        continue;
+      }
+      const Clock::time_point end = Clock::now();
+
+      std::chrono::duration<double> run_seconds = end - start;
+      std::lock_guard<std::mutex> guard(results_mutex_);
+      result.queueing_delay_us.Record(microseconds(start - arrival));
+      result.latency_us.Record(microseconds(end - arrival));
+      performance_result_.model_latencies_us[session.first].second.Record(microseconds(end - start));
+      performance_result_.time_costs.emplace_back(run_seconds.count());
+      performance_result_.total_time_cost += run_seconds.count();
+    }
+  };
+
+  std::vector<std::thread> runs;
+  for (size_t i = 0; i < concurrency; ++i) {
+    runs.emplace_back(serve);
+  }
+
+  // Each arrival is scheduled from the previous one rather than from when it was queued, and a request's latency
+  // counts from its scheduled arrival, so that a slow model delays the requests instead of the arrivals.
+  const Clock::time_point begin = Clock::now();
+  const Clock::time_point stop = begin + std::chrono::seconds(run_config.duration_in_seconds);
+  Clock::time_point next_arrival = begin;
+  for (;;) {
+    next_arrival += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(interarrival_seconds(rand_engine)));
+    if (next_arrival >= stop) {
+      break;
+    }
+    std::this_thread::sleep_until(next_arrival);
+    {
+      std::lock_guard<std::mutex> lock(arrivals_mutex);
+      arrivals.push_back(next_arrival);
+    }
+    arrivals_cv.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(arrivals_mutex);
+    arrivals_done = true;
+  }
+  arrivals_cv.notify_all();
+  for (auto& run : runs) {
+    run.join();
+  }
+
+  if (!error_message.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "run failed in open loop mode: ", error_message);
+  }
+
+  // the queued requests are served after the arrivals stop, so the rate is over the time to serve them all
+  std::chrono::duration<double> elapsed_seconds = Clock::now() - begin;
+  result.achieved_qps = result.latency_us.TotalCount() / elapsed_seconds.count();
+  return Status::OK();
+}
+
 static TestModelInfo* CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     return TestModelInfo::LoadOnnxModel(performance_test_config_.model_info.model_file_path.c_str());
@@ -181,53 +332,113 @@ static TestSession* CreateSession(Ort::Env& env, std::random_device& rd,
 #endif
   ORT_NOT_IMPLEMENTED(ToMBString(performance_test_config_.backend), " is not supported");
 }
+// e.g. "optimization_level=99 load=mmap optimized_model"
+static std::string DescribeConfiguration(const RunConfig& run_config) {
+  std::ostringstream configuration;
+  configuration << "optimization_level=" << static_cast<int>(run_config.optimization_level) << " load=";
+  switch (run_config.load_method) {
+    case ModelLoadMethod::kFile:
+      configuration << "file";
+      break;
+    case ModelLoadMethod::kArray:
+      configuration << "array";
+      break;
+    case ModelLoadMethod::kMmap:
+      configuration << "mmap";
+      break;
+  }
+  if (run_config.load_optimized_model) {
+    configuration << " optimized_model";
+  }
+  if (run_config.sessions_per_model > 1) {
+    configuration << " sessions_per_model=" << run_config.sessions_per_model;
+  }
+  if (run_config.use_global_thread_pools) {
+    configuration << " global_thread_pools";
+  }
+  if (run_config.bind_io) {
+    configuration << " bind_io";
+  }
+  return configuration.str();
+}
+
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
-    : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)),
-      session_(CreateSession(env, rd, test_config, test_model_info_)) {}
+    : performance_test_config_(test_config) {
+  std::vector<std::basic_string<ORTCHAR_T>> model_paths{test_config.model_info.model_file_path};
+  model_paths.insert(model_paths.end(), test_config.model_info.mixed_model_file_paths.begin(),
+                     test_config.model_info.mixed_model_file_paths.end());
+  for (const auto& model_path : model_paths) {
+    TestModel model;
+    model.config = test_config;
+    model.config.model_info.model_file_path = model_path;
+    model.model_info = CreateModelInfo(model.config);
+    for (size_t i = 0; i != test_config.run_config.sessions_per_model; ++i) {
+      model.sessions.emplace_back(CreateSession(env, rd, model.config, model.model_info));
+    }
+    models_.push_back(std::move(model));
+  }
+
+  // interleave the models, so that the runs of the models are mixed
+  for (size_t i = 0; i != test_config.run_config.sessions_per_model; ++i) {
+    for (size_t model_index = 0; model_index != models_.size(); ++model_index) {
+      sessions_.emplace_back(model_index, models_[model_index].sessions[i].get());
+    }
+  }
+
+  performance_result_.configuration = DescribeConfiguration(test_config.run_config);
+  performance_result_.workingset_size_after_creation = utils::GetWorkingSetSize();
+}
 
 PerformanceRunner::~PerformanceRunner() = default;
 
 bool PerformanceRunner::Initialize() {
-  std::basic_string<PATH_CHAR_TYPE> test_case_dir;
-  auto st = GetDirNameFromFilePath(performance_test_config_.model_info.model_file_path, test_case_dir);
-  if (!st.IsOK()) {
-    printf("input path is not a valid model\n");
-    return false;
-  }
-  std::basic_string<PATH_CHAR_TYPE> model_name = GetLastComponent(test_case_dir);
-  // TODO: remove the input and model name's dependency on directory tree
-  if (CompareCString(model_name.c_str(), ORT_TSTR("test_")) == 0) {
-    model_name = model_name.substr(5);
-  }
-  std::string narrow_model_name = ToMBString(model_name);
-  performance_result_.model_name = narrow_model_name;
-
-  test_case_.reset(CreateOnnxTestCase(narrow_model_name, test_model_info_, 0.0, 0.0));
-
-  // TODO: Place input tensor on cpu memory if mkldnn provider type to avoid CopyTensor logic in CopyInputAcrossDevices
-  size_t test_data_count = test_case_->GetDataCount();
-  if (test_data_count == 0) {
-    std::cout << "there is no test data for model " << test_case_->GetTestCaseName() << std::endl;
-    return false;
-  }
-  for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
-    std::unordered_map<std::string, OrtValue*> feeds;
-    test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
-    // Discard the names in feeds
-    int input_count = test_model_info_->GetInputCount();
-    for (int i = 0; i != input_count; ++i) {
-      auto iter = feeds.find(test_model_info_->GetInputName(i));
-      if (iter == feeds.end()) {
-        std::cout << "there is no test input data for input " << test_model_info_->GetInputName(i) << " and model "
-                  << test_case_->GetTestCaseName() << std::endl;
-        return false;
+  std::string result_model_name;
+  for (auto& model : models_) {
+    std::basic_string<PATH_CHAR_TYPE> test_case_dir;
+    auto st = GetDirNameFromFilePath(model.config.model_info.model_file_path, test_case_dir);
+    if (!st.IsOK()) {
+      printf("input path is not a valid model\n");
+      return false;
+    }
+    std::basic_string<PATH_CHAR_TYPE> model_name = GetLastComponent(test_case_dir);
+    // TODO: remove the input and model name's dependency on directory tree
+    if (CompareCString(model_name.c_str(), ORT_TSTR("test_")) == 0) {
+      model_name = model_name.substr(5);
+    }
+    std::string narrow_model_name = ToMBString(model_name);
+    result_model_name += (result_model_name.empty() ? "" : "+") + narrow_model_name;
+    performance_result_.model_latencies_us.emplace_back(narrow_model_name, LatencyHistogram{});
+
+    TestModelInfo* test_model_info = model.model_info;
+    std::unique_ptr<ITestCase> test_case(CreateOnnxTestCase(narrow_model_name, test_model_info, 0.0, 0.0));
+    model.model_info = nullptr;
+
+    // TODO: Place input tensor on cpu memory if mkldnn provider type to avoid CopyTensor logic in CopyInputAcrossDevices
+    size_t test_data_count = test_case->GetDataCount();
+    if (test_data_count == 0) {
+      std::cout << "there is no test data for model " << test_case->GetTestCaseName() << std::endl;
+      return false;
+    }
+    // every session owns the test data loaded for it
+    for (auto& session : model.sessions) {
+      for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
+        std::unordered_map<std::string, OrtValue*> feeds;
+        test_case->LoadTestData(test_data_id /* id */, b_, feeds, true);
+        // Discard the names in feeds
+        int input_count = test_model_info->GetInputCount();
+        for (int i = 0; i != input_count; ++i) {
+          auto iter = feeds.find(test_model_info->GetInputName(i));
+          if (iter == feeds.end()) {
+            std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
+                      << test_case->GetTestCaseName() << std::endl;
+            return false;
+          }
+          session->PreLoadTestData(test_data_id, static_cast<size_t>(i), iter->second);
+        }
       }
-      session_->PreLoadTestData(test_data_id, static_cast<size_t>(i), iter->second);
     }
   }
-  test_case_.reset(nullptr);
-  test_model_info_ = nullptr;
+  performance_result_.model_name = result_model_name;
   return true;
 }
 
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <iostream>
 #include <random>
@@ -16,6 +17,7 @@
 #include <core/platform/env.h>
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
+#include "latency_histogram.h"
 #include "heap_buffer.h"
 #include "test_session.h"
 #include "OrtValueList.h"
@@ -26,12 +28,64 @@ class TestModelInfo;
 namespace onnxruntime {
 namespace perftest {
 
+// The result of an open loop test at one concurrency level. The latency of a request is from its arrival to its
+// completion, so it includes the time it waited for a run to serve it, which is its queueing delay.
+struct OpenLoopResult {
+  size_t concurrency{0};
+  size_t target_qps{0};
+  double achieved_qps{0};
+  LatencyHistogram latency_us;
+  LatencyHistogram queueing_delay_us;
+
+  static void WriteHeader(std::ostream& out) {
+    out << "concurrency,target_qps,achieved_qps,requests,p50_ms,p90_ms,p99_ms,p999_ms,max_ms,"
+        << "mean_queueing_ms,p99_queueing_ms" << std::endl;
+  }
+
+  void WriteRow(std::ostream& out) const {
+    auto ms = [](int64_t us) { return us / 1000.0; };
+    out << concurrency << "," << target_qps << "," << achieved_qps << "," << latency_us.TotalCount() << ","
+        << ms(latency_us.ValueAtPercentile(50)) << "," << ms(latency_us.ValueAtPercentile(90)) << ","
+        << ms(latency_us.ValueAtPercentile(99)) << "," << ms(latency_us.ValueAtPercentile(99.9)) << ","
+        << ms(latency_us.Max()) << "," << queueing_delay_us.Mean() / 1000.0 << ","
+        << ms(queueing_delay_us.ValueAtPercentile(99)) << std::endl;
+  }
+};
+
 struct PerformanceResult {
   size_t peak_workingset_size{0};
   short average_CPU_usage{0};
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
+  // one per concurrency level in open loop mode, the latency against throughput curve of the model
+  std::vector<OpenLoopResult> open_loop_results;
+  // what tells the test apart from the others it's compared to, e.g. its optimization level
+  std::string configuration;
+  // the cost of creating the session, with the memory of its arenas after the test
+  SessionStats session_stats;
+  size_t workingset_size_after_creation{0};
+  // the first run, which pays for what the session does lazily, in seconds
+  double first_run_time_cost{0};
+  // the latencies of the runs of each model, when the sessions of several models are mixed
+  std::vector<std::pair<std::string, LatencyHistogram>> model_latencies_us;
+
+  static void WriteStartupHeader(std::ostream& out) {
+    out << "configuration,creation_ms,load_ms,initialize_ms,graph_transformation_ms,graph_partitioning_ms,"
+        << "initializer_loading_ms,kernel_creation_ms,first_run_ms,average_run_ms,workingset_after_creation,"
+        << "peak_workingset,arena_reserved,arena_in_use,gpu_arena_reserved,gpu_arena_in_use" << std::endl;
+  }
+
+  void WriteStartupRow(std::ostream& out) const {
+    const double average_run_ms = time_costs.empty() ? 0.0 : total_time_cost / time_costs.size() * 1000;
+    out << configuration << "," << session_stats.creation_ms << "," << session_stats.load_ms << ","
+        << session_stats.initialize_ms << "," << session_stats.graph_transformation_ms << ","
+        << session_stats.graph_partitioning_ms << "," << session_stats.initializer_loading_ms << ","
+        << session_stats.kernel_creation_ms << "," << first_run_time_cost * 1000 << "," << average_run_ms << ","
+        << workingset_size_after_creation << "," << peak_workingset_size << "," << session_stats.arena_reserved_bytes
+        << "," << session_stats.arena_in_use_bytes << "," << session_stats.gpu_arena_reserved_bytes << ","
+        << session_stats.gpu_arena_in_use_bytes << std::endl;
+  }
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const {
     std::ofstream outfile;
@@ -67,6 +121,29 @@ struct PerformanceResult {
       outfile << "P999 Latency is " << sorted_time[n999] << "sec" << std::endl;
     }
 
+    outfile << std::endl;
+    WriteStartupHeader(outfile);
+    WriteStartupRow(outfile);
+
+    if (model_latencies_us.size() > 1) {
+      outfile << std::endl;
+      outfile << "model,runs,mean_ms,p50_ms,p99_ms" << std::endl;
+      for (const auto& model_latency : model_latencies_us) {
+        const LatencyHistogram& latency_us = model_latency.second;
+        outfile << model_latency.first << "," << latency_us.TotalCount() << "," << latency_us.Mean() / 1000.0 << ","
+                << latency_us.ValueAtPercentile(50) / 1000.0 << "," << latency_us.ValueAtPercentile(99) / 1000.0
+                << std::endl;
+      }
+    }
+
+    if (!open_loop_results.empty()) {
+      outfile << std::endl;
+      OpenLoopResult::WriteHeader(outfile);
+      for (const auto& result : open_loop_results) {
+        result.WriteRow(outfile);
+      }
+    }
+
     outfile.close();
   }
 };
@@ -89,13 +166,21 @@ class PerformanceRunner {
  private:
   bool Initialize();
 
+  // The session to run next, with the index of its model. Thread-safe.
+  const std::pair<size_t, TestSession*>& NextSession() {
+    return sessions_[next_session_++ % sessions_.size()];
+  }
+
   template <bool isWarmup>
   Status RunOneIteration() {
-    std::chrono::duration<double> duration_seconds = session_->Run();
+    const auto& session = NextSession();
+    std::chrono::duration<double> duration_seconds = session.second->Run();
     if (!isWarmup) {
       std::lock_guard<std::mutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
       performance_result_.total_time_cost += duration_seconds.count();
+      performance_result_.model_latencies_us[session.first].second.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(duration_seconds).count());
       if (performance_test_config_.run_config.f_verbose) {
         std::cout << "iteration:" << performance_result_.time_costs.size() << ","
                   << "time_cost:" << performance_result_.time_costs.back() << std::endl;
@@ -108,6 +193,8 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status OpenLoopTest();
+  Status RunOpenLoop(size_t concurrency, OpenLoopResult& result);
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -124,12 +211,20 @@ class PerformanceRunner {
   }
 
  private:
+  // A model under test with its sessions. The model info is owned by the test case loading the test data.
+  struct TestModel {
+    PerformanceTestConfig config;
+    TestModelInfo* model_info;
+    std::vector<std::unique_ptr<TestSession>> sessions;
+  };
+
   PerformanceResult performance_result_;
   PerformanceTestConfig performance_test_config_;
-  TestModelInfo* test_model_info_;
-  std::unique_ptr<TestSession> session_;
+  std::vector<TestModel> models_;
+  // the sessions of all the models with the index of their model, which the runs are spread over round robin
+  std::vector<std::pair<size_t, TestSession*>> sessions_;
+  std::atomic<size_t> next_session_{0};
   onnxruntime::test::HeapBuffer b_;
-  std::unique_ptr<ITestCase> test_case_;
 
   // TODO: Convert to OrtMutex
   std::mutex results_mutex_;
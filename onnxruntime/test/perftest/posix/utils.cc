@@ -4,9 +4,11 @@
 #include "test/perftest/utils.h"
 
 #include <cstddef>
+#include <fstream>
 
 #include <sys/times.h>
 #include <sys/resource.h>
+#include <unistd.h>
 
 #include "core/platform/env.h"
 
@@ -20,6 +22,17 @@ std::size_t GetPeakWorkingSetSize() {
   return static_cast<size_t>(rusage.ru_maxrss * 1024L);
 }
 
+std::size_t GetWorkingSetSize() {
+  // the resident pages are the second field of /proc/self/statm, which only Linux has
+  std::ifstream statm("/proc/self/statm");
+  std::size_t total_pages = 0;
+  std::size_t resident_pages = 0;
+  if (!(statm >> total_pages >> resident_pages)) {
+    return 0;
+  }
+  return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
 class CPUUsage : public ICPUUsage {
  public:
   CPUUsage() {
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "core/graph/constants.h"
 
@@ -13,7 +14,19 @@ namespace perftest {
 
 enum class TestMode : std::uint8_t {
   kFixDurationMode = 0,
-  KFixRepeatedTimesMode
+  KFixRepeatedTimesMode,
+  // requests arrive at a target rate, whether or not the earlier ones completed, for a fixed duration
+  kOpenLoopMode
+};
+
+// How the session reads the model file.
+enum class ModelLoadMethod : std::uint8_t {
+  // from its path
+  kFile = 0,
+  // from a copy of the file read into memory
+  kArray,
+  // from a read-only mapping of the file
+  kMmap
 };
 
 enum class Platform : std::uint8_t {
@@ -24,6 +37,8 @@ enum class Platform : std::uint8_t {
 struct ModelInfo {
   std::string model_name;
   std::basic_string<ORTCHAR_T> model_file_path;
+  // the other models whose sessions are run along with those of model_file_path, mixed round robin
+  std::vector<std::basic_string<ORTCHAR_T>> mixed_model_file_paths;
   std::basic_string<ORTCHAR_T> input_file_path;
   std::basic_string<ORTCHAR_T> result_file_path;
 };
@@ -31,21 +46,45 @@ struct ModelInfo {
 struct MachineConfig {
   Platform platform{Platform::kWindows};
   std::string provider_type_name{onnxruntime::kCpuExecutionProvider};
+  // every provider given with -e, in order, which the nodes are replayed on in replay mode
+  std::vector<std::string> provider_type_names;
 };
 
 struct RunConfig {
   std::basic_string<ORTCHAR_T> profile_file;
+  // a profile of the model to replay the nodes of, one at a time at the input shapes they ran with
+  std::basic_string<ORTCHAR_T> replay_profile_file;
   TestMode test_mode{TestMode::kFixDurationMode};
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // the mean rate of the Poisson arrivals of the requests in open loop mode
+  size_t target_qps{0};
+  // the numbers of runs serving the requests in open loop mode, one test each, concurrent_session_runs if empty
+  std::vector<size_t> concurrency_levels;
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
   bool enable_cpu_mem_arena{true};
   bool enable_sequential_execution{true};
   int session_thread_pool_size{-1};
+  // the sessions use the thread pools of the Env, sized by session_thread_pool_size, instead of their own
+  bool use_global_thread_pools{false};
+  // the number of sessions of each model, which the runs are spread over round robin
+  size_t sessions_per_model{1};
+  // bind the inputs on the devices of the session once and the outputs to the device of the provider, and run
+  // through the bindings, instead of copying the inputs from and the outputs to the CPU on every run
+  bool bind_io{false};
   GraphOptimizationLevel optimization_level{ORT_ENABLE_EXTENDED};
+  // the optimization levels to compare the startup, memory and run time of, one test each after the other
+  std::vector<GraphOptimizationLevel> compared_optimization_levels;
+  // the ways to load the model to compare, one test each; a single test loading it from its path if empty
+  std::vector<ModelLoadMethod> load_methods;
+  ModelLoadMethod load_method{ModelLoadMethod::kFile};
+  // where the model optimized at optimization_level is written, to also test the sessions loading it
+  std::basic_string<ORTCHAR_T> optimized_model_file_path;
+  // whether the session loads the model at optimized_model_file_path instead of the model under test
+  bool load_optimized_model{false};
 };
 
 struct PerformanceTestConfig {
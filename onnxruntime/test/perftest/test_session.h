@@ -8,14 +8,48 @@
 
 namespace onnxruntime {
 namespace perftest {
+// The cost of creating a session and the memory its arenas hold, as far as the backend reports them.
+struct SessionStats {
+  // the time from creating the session until it's ready to run, in milliseconds
+  double creation_ms{0};
+  // the phases of creating it, in milliseconds
+  double load_ms{0};
+  double initialize_ms{0};
+  double graph_transformation_ms{0};
+  double graph_partitioning_ms{0};
+  double initializer_loading_ms{0};
+  double kernel_creation_ms{0};
+  // the memory of all arenas, and of the arenas on the GPU, reserved from the devices and in use
+  size_t arena_reserved_bytes{0};
+  size_t arena_in_use_bytes{0};
+  size_t gpu_arena_reserved_bytes{0};
+  size_t gpu_arena_in_use_bytes{0};
+
+  // Sums the stats of several sessions.
+  void Add(const SessionStats& other) {
+    creation_ms += other.creation_ms;
+    load_ms += other.load_ms;
+    initialize_ms += other.initialize_ms;
+    graph_transformation_ms += other.graph_transformation_ms;
+    graph_partitioning_ms += other.graph_partitioning_ms;
+    initializer_loading_ms += other.initializer_loading_ms;
+    kernel_creation_ms += other.kernel_creation_ms;
+    arena_reserved_bytes += other.arena_reserved_bytes;
+    arena_in_use_bytes += other.arena_in_use_bytes;
+    gpu_arena_reserved_bytes += other.gpu_arena_reserved_bytes;
+    gpu_arena_in_use_bytes += other.gpu_arena_in_use_bytes;
+  }
+};
+
 class TestSession {
  public:
   virtual std::chrono::duration<double> Run() = 0;
-  // TODO: implement it
   // This function won't return duration, because it may vary largely.
   // Please measure the perf at a higher level.
-  void ThreadSafeRun() { abort(); }
+  virtual void ThreadSafeRun() { abort(); }
   virtual void PreLoadTestData(size_t test_data_id, size_t input_id, OrtValue* value) = 0;
+  // The creation stats of the session with the current memory of its arenas. Zeros by default.
+  virtual SessionStats GetStats() const { return SessionStats{}; }
 
   virtual ~TestSession() = default;
 };
@@ -11,6 +11,9 @@ namespace utils {
 
 size_t GetPeakWorkingSetSize();
 
+// The current working set of the process, 0 where it's unknown.
+size_t GetWorkingSetSize();
+
 class ICPUUsage {
  public:
   virtual ~ICPUUsage() = default;
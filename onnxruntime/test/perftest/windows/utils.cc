@@ -21,6 +21,15 @@ size_t GetPeakWorkingSetSize() {
   return 0;
 }
 
+size_t GetWorkingSetSize() {
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+    return pmc.WorkingSetSize;
+  }
+
+  return 0;
+}
+
 static std::uint64_t SubtractFILETIME(const FILETIME& ft_a, const FILETIME& ft_b) {
   LARGE_INTEGER a, b;
   a.LowPart = ft_a.dwLowDateTime;
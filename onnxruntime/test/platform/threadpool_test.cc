@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/threadpool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace concurrency {
+namespace test {
+
+namespace {
+void ValidateEachIndexVisitedOnce(const std::vector<std::atomic<int>>& visits) {
+  for (size_t i = 0; i < visits.size(); ++i) {
+    ASSERT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+}
+}  // namespace
+
+TEST(ThreadPoolTest, ParallelForVisitsEachIteration) {
+  ThreadPool tp("test", 4);
+  for (int32_t total : {0, 1, 2, 3, 7, 64, 1000}) {
+    std::vector<std::atomic<int>> visits(total);
+    for (auto& v : visits) v = 0;
+    tp.ParallelFor(total, [&visits](int32_t i) { ++visits[i]; });
+    ValidateEachIndexVisitedOnce(visits);
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForRangeCoversHalfOpenInterval) {
+  ThreadPool tp("test", 3);
+  const int64_t first = 5;
+  const int64_t last = 10005;
+  std::vector<std::atomic<int>> visits(last);
+  for (auto& v : visits) v = 0;
+  tp.ParallelForRange(first, last, [&visits, first, last](int64_t block_first, int64_t block_last) {
+    ASSERT_LE(first, block_first);
+    ASSERT_LT(block_first, block_last);
+    ASSERT_LE(block_last, last);
+    for (int64_t i = block_first; i < block_last; ++i) ++visits[i];
+  });
+  for (int64_t i = 0; i < first; ++i) ASSERT_EQ(visits[i].load(), 0);
+  for (int64_t i = first; i < last; ++i) ASSERT_EQ(visits[i].load(), 1);
+}
+
+TEST(ThreadPoolTest, ParallelForRangeCheapWorkRunsInline) {
+  ThreadPool tp("test", 4);
+  int calls = 0;
+  // cost is low enough that a single block on the calling thread is expected
+  tp.ParallelForRange(0, 16, 1.0, [&calls](int64_t block_first, int64_t block_last) {
+    ++calls;
+    EXPECT_EQ(block_first, 0);
+    EXPECT_EQ(block_last, 16);
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(ThreadPoolTest, ParallelForRangeWithCost) {
+  ThreadPool tp("test", 4);
+  std::vector<std::atomic<int>> visits(100000);
+  for (auto& v : visits) v = 0;
+  tp.ParallelForRange(0, static_cast<int64_t>(visits.size()), 100.0, [&visits](int64_t block_first, int64_t block_last) {
+    for (int64_t i = block_first; i < block_last; ++i) ++visits[i];
+  });
+  ValidateEachIndexVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+  // every pool thread may be blocked in an outer iteration; the inner loops must
+  // still complete because the calling thread drains its own blocks.
+  ThreadPool tp("test", 2);
+  std::vector<std::atomic<int>> visits(16 * 16);
+  for (auto& v : visits) v = 0;
+  tp.ParallelFor(16, [&tp, &visits](int32_t outer) {
+    tp.ParallelFor(16, [&visits, outer](int32_t inner) { ++visits[outer * 16 + inner]; });
+  });
+  ValidateEachIndexVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, PinnedThreads) {
+  // placement is best effort so this validates that a pinned pool still executes work
+  ThreadOptions thread_options;
+  thread_options.affinity = {0};
+  ThreadPool tp("test", 2, thread_options);
+  std::vector<std::atomic<int>> visits(100);
+  for (auto& v : visits) v = 0;
+  tp.ParallelFor(static_cast<int32_t>(visits.size()), [&visits](int32_t i) { ++visits[i]; });
+  ValidateEachIndexVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, NumaNodeThreads) {
+  ThreadOptions thread_options;
+  thread_options.numa_node = 0;
+  ThreadPool tp("test", 2, thread_options);
+  EXPECT_EQ(tp.NumThreads(), 2);
+  std::vector<std::atomic<int>> visits(100);
+  for (auto& v : visits) v = 0;
+  tp.ParallelFor(static_cast<int32_t>(visits.size()), [&visits](int32_t i) { ++visits[i]; });
+  ValidateEachIndexVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, SpinningThreads) {
+  ThreadOptions thread_options;
+  thread_options.spin_duration_us = 1000;
+  ThreadPool tp("test", 3, thread_options);
+  for (int run = 0; run < 100; ++run) {
+    std::vector<std::atomic<int>> visits(64);
+    for (auto& v : visits) v = 0;
+    tp.ParallelFor(static_cast<int32_t>(visits.size()), [&visits](int32_t i) { ++visits[i]; });
+    ValidateEachIndexVisitedOnce(visits);
+  }
+}
+
+TEST(ThreadPoolTest, LowLatency) {
+  ThreadPool tp("test", 3);
+  tp.StartLowLatency();
+  // nested sections, and scheduled work that takes the place of a spinning thread
+  tp.StartLowLatency();
+  std::atomic<bool> scheduled_ran{false};
+  tp.Schedule([&scheduled_ran]() { scheduled_ran = true; });
+  for (int run = 0; run < 100; ++run) {
+    std::vector<std::atomic<int>> visits(64);
+    for (auto& v : visits) v = 0;
+    tp.ParallelFor(static_cast<int32_t>(visits.size()), [&visits](int32_t i) { ++visits[i]; });
+    ValidateEachIndexVisitedOnce(visits);
+  }
+  tp.EndLowLatency();
+  while (!scheduled_ran) {
+    std::this_thread::yield();
+  }
+  tp.EndLowLatency();
+
+  // the threads block again, and scheduled work still runs
+  std::atomic<bool> parked_ran{false};
+  tp.Schedule([&parked_ran]() { parked_ran = true; });
+  while (!parked_ran) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace test
+}  // namespace concurrency
+}  // namespace onnxruntime
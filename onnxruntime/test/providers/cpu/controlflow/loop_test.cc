@@ -472,77 +472,146 @@ TEST(Loop, ZeroIterations) {
           {});
 }
 
-TEST(Loop, InfiniteLoopTermination) {
-  auto create_subgraph = [](const RunOptions&) {
-    Model model("Infinite Loop subgraph");
-    auto& graph = model.MainGraph();
+// Subgraph of a Loop computing the Fibonacci sequence in a and b. b_out is a pass through of a_in, so the buffer
+// of a_in is still in use after the iteration and cannot be recycled for the next a_out.
+static const ONNX_NAMESPACE::GraphProto CreateFibonacciSubgraph() {
+  Model model("Fibonacci Loop subgraph");
+  auto& graph = model.MainGraph();
 
-    std::vector<NodeArg*> inputs;
-    std::vector<NodeArg*> outputs;
+  /*
+       iter_num_in    cond_in          a_in      b_in
+         (unused)        |            /    \      |
+                     [Identity]  [Identity] [Add]-/
+                         |           |        |   \
+                      cond_out     b_out    a_out [Identity]
+                                                      |
+                                                  a_scan_out
+  */
 
-    /* Never change cond_in so loop is infinite
-            Inputs: iter_num, cond_in, loop carried state variables.
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
 
-         iter_num_in    cond_in     [outer_scope_0]
-           (unused)        |                |
-                       [Identity]      [Identity]
-                           |               |
-                        cond_out     loop_var_0_out
-    */
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
 
-    // graph inputs types.
-    TypeProto int64_scalar;
-    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
-    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
 
-    TypeProto bool_scalar;
-    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
-    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+  auto& a_in = graph.GetOrCreateNodeArg("a_in", &float_tensor);
+  auto& b_in = graph.GetOrCreateNodeArg("b_in", &float_tensor);
 
-    TypeProto float_tensor;
-    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
-    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+  auto& a_out = graph.GetOrCreateNodeArg("a_out", &float_tensor);
+  auto& b_out = graph.GetOrCreateNodeArg("b_out", &float_tensor);
+  auto& a_scan_out = graph.GetOrCreateNodeArg("a_scan_out", &float_tensor);
 
-    // graph inputs
-    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
-    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+  graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+  graph.AddNode("add", "Add", "Next Fibonacci number", {&a_in, &b_in}, {&a_out});
+  graph.AddNode("a_in_identity", "Identity", "Forward a_in to b_out", {&a_in}, {&b_out});
+  graph.AddNode("a_out_identity", "Identity", "Copy a_out to the scan output", {&a_out}, {&a_scan_out});
 
-    // outer scope value. need type but not shape.
-    auto& outer_scope_0 = graph.GetOrCreateNodeArg("outer_scope_0", &float_tensor);
+  graph.SetInputs({&iter_num_in, &cond_in, &a_in, &b_in});
+  graph.SetOutputs({&cond_out, &a_out, &b_out, &a_scan_out});
 
-    // add so that we don't end up with it being considered a graph input
-    graph.AddOuterScopeNodeArg("outer_scope_0");
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
 
-    // graph outputs
-    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
-    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+  return graph.ToGraphProto();
+}
 
-    // cond_in -> cond_out
-    {
-      inputs = {&cond_in};
-      outputs = {&cond_out};
+TEST(Loop, LoopCarriedVarBuffersSwap) {
+  OpTester test("Loop", 1);
+  test.AddAttribute("body", CreateFibonacciSubgraph());
 
-      graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
-    }
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("a", {2}, {1.f, 2.f});
+  test.AddInput<float>("b", {2}, {0.f, 0.f});
 
-    // outer_scope_0 -> loop_var_0_out
-    {
-      inputs = {&outer_scope_0};
-      outputs = {&loop_var_0_out};
+  test.AddOutput<float>("a_final", {2}, {8.f, 16.f});
+  test.AddOutput<float>("b_final", {2}, {5.f, 10.f});
+  test.AddOutput<float>("a_scan", {5, 2}, {1.f, 2.f, 2.f, 4.f, 3.f, 6.f, 5.f, 10.f, 8.f, 16.f});
 
-      graph.AddNode("loop_var_out", "Identity", "Forward outer_scope_0 to loop_var_0_out", inputs, outputs);
-    }
+  test.Run();
+}
 
-    graph.SetInputs({&iter_num_in, &cond_in, &outer_scope_0});
-    graph.SetOutputs({&cond_out, &loop_var_0_out});
+// Subgraph of a Loop that never changes cond, so the loop only ends when its run is stopped.
+static const ONNX_NAMESPACE::GraphProto CreateInfiniteLoopSubgraph(const RunOptions&) {
+  Model model("Infinite Loop subgraph");
+  auto& graph = model.MainGraph();
 
-    auto status = graph.Resolve();
-    EXPECT_EQ(status, Status::OK());
+  std::vector<NodeArg*> inputs;
+  std::vector<NodeArg*> outputs;
 
-    return graph.ToGraphProto();
-  };
+  /* Never change cond_in so loop is infinite
+          Inputs: iter_num, cond_in, loop carried state variables.
+
+       iter_num_in    cond_in     [outer_scope_0]
+         (unused)        |                |
+                     [Identity]      [Identity]
+                         |               |
+                      cond_out     loop_var_0_out
+  */
+
+  // graph inputs types.
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
 
-  LoopOpTester test{{}, create_subgraph};
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+
+  // graph inputs
+  auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+
+  // outer scope value. need type but not shape.
+  auto& outer_scope_0 = graph.GetOrCreateNodeArg("outer_scope_0", &float_tensor);
+
+  // add so that we don't end up with it being considered a graph input
+  graph.AddOuterScopeNodeArg("outer_scope_0");
+
+  // graph outputs
+  auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+  auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+
+  // cond_in -> cond_out
+  {
+    inputs = {&cond_in};
+    outputs = {&cond_out};
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+  }
+
+  // outer_scope_0 -> loop_var_0_out
+  {
+    inputs = {&outer_scope_0};
+    outputs = {&loop_var_0_out};
+
+    graph.AddNode("loop_var_out", "Identity", "Forward outer_scope_0 to loop_var_0_out", inputs, outputs);
+  }
+
+  graph.SetInputs({&iter_num_in, &cond_in, &outer_scope_0});
+  graph.SetOutputs({&cond_out, &loop_var_0_out});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+TEST(Loop, InfiniteLoopTermination) {
+  LoopOpTester test{{}, CreateInfiniteLoopSubgraph};
 
   test.AddInput<int64_t>("M", {1}, {INT64_MAX});
   test.AddInput<bool>("cond", {1}, {true});
@@ -574,6 +643,23 @@ TEST(Loop, InfiniteLoopTermination) {
   terminator_thread.join();
 }
 
+TEST(Loop, InfiniteLoopTimeout) {
+  LoopOpTester test{{}, CreateInfiniteLoopSubgraph};
+
+  test.AddInput<int64_t>("M", {1}, {INT64_MAX});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("fake", {1}, {0.f});
+
+  test.AddOutput<float>("loop_var_0_final", {1}, {0.f});
+
+  OrtRunOptions session_run_options;
+  session_run_options.run_tag = "Loop.InfiniteLoopTimeout";
+  session_run_options.run_timeout_ms = 100;
+
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Exiting as the run timeout has been exceeded",
+           {kTensorrtExecutionProvider}, &session_run_options);  // Disable TensorRT on unsupported data type BOOL
+}
+
 // Regression test that a subgraph input overrides an outer scope value of the same name.
 // Replicate issue from https://github.com/onnx/onnx/issues/2082
 TEST(Loop, SubgraphInputShadowsOuterScopeValue) {
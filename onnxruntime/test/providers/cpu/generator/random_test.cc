@@ -5,11 +5,43 @@
 #include "test/providers/provider_test_utils.h"
 
 #include <algorithm>
-#include <random>
+#include <cmath>
+#include "core/providers/cpu/generator/philox.h"
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+// Reference values of the first run of a generator: value i comes from Philox block i / kValuesPerBlock.
+template <typename T>
+static std::vector<T> PhiloxUniformValues(float seed, int64_t size, float low, float high) {
+  const int values_per_block = PhiloxUniform<T>::kValuesPerBlock;
+  std::vector<T> values(size);
+  for (int64_t i = 0; i < size; i += values_per_block) {
+    T uniforms[4];
+    PhiloxUniform<T>::Generate(gsl::narrow_cast<uint32_t>(seed), i / values_per_block, uniforms);
+    for (int j = 0; j < values_per_block && i + j < size; ++j) {
+      values[i + j] = low + uniforms[j] * (high - low);
+    }
+  }
+  return values;
+}
+
+// Box-Muller transform of consecutive pairs of uniform values
+template <typename T>
+static std::vector<T> PhiloxNormalValues(float seed, int64_t size, float mean, float scale) {
+  std::vector<T> uniforms = PhiloxUniformValues<T>(seed, size + 1, 0.f, 1.f);
+  std::vector<T> values(size);
+  for (int64_t i = 0; i < size; i += 2) {
+    const T radius = std::sqrt(T(-2) * std::log(T(1) - uniforms[i])) * scale;
+    const T angle = T(2 * M_PI) * uniforms[i + 1];
+    values[i] = mean + radius * std::cos(angle);
+    if (i + 1 < size) {
+      values[i + 1] = mean + radius * std::sin(angle);
+    }
+  }
+  return values;
+}
+
 TEST(Random, RandomNormal2DDouble) {
   OpTester test("RandomNormal");
 
@@ -25,12 +57,7 @@ TEST(Random, RandomNormal2DDouble) {
   test.AddAttribute<int64_t>("dtype", TensorProto::DOUBLE);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<double> distribution{mean, scale};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = PhiloxNormalValues<double>(seed, TensorShape(dims).Size(), mean, scale);
 
   test.AddOutput<double>("Y", dims, expected_output);
   test.Run();
@@ -59,12 +86,7 @@ void RunRandomNormalLike3DFloat(bool infer_dtype = false) {
                         0.f, 0.f, 0.f,
                         0.f, 0.f, 0.f});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<float> distribution{mean, scale};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = PhiloxNormalValues<float>(seed, TensorShape(dims).Size(), mean, scale);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -95,12 +117,7 @@ TEST(Random, RandomUniform1DFloat) {
   test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<float> distribution{low, high};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = PhiloxUniformValues<float>(seed, TensorShape(dims).Size(), low, high);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -127,12 +144,7 @@ void RunRandomUniformLikeTest(bool infer_dtype = false) {
                         {0., 0., 0., 0., 0., 0.,
                          0., 0., 0., 0., 0., 0.});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<double> distribution{low, high};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = PhiloxUniformValues<double>(seed, TensorShape(dims).Size(), low, high);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
@@ -148,6 +160,28 @@ TEST(Random, RandomUniformLikeInferDType) {
   RunRandomUniformLikeTest(infer_dtype);
 }
 
+// spans several chunks, which may be generated on different threads
+TEST(Random, RandomNormalLargeFloat) {
+  OpTester test("RandomNormal");
+
+  std::vector<int64_t> dims{5, 1001};
+
+  float scale = 2.f;
+  float mean = 1.f;
+  float seed = 42.f;
+
+  test.AddAttribute("scale", scale);
+  test.AddAttribute("mean", mean);
+  test.AddAttribute("seed", seed);
+  test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
+  test.AddAttribute("shape", dims);
+
+  std::vector<float> expected_output = PhiloxNormalValues<float>(seed, TensorShape(dims).Size(), mean, scale);
+
+  test.AddOutput<float>("Y", dims, expected_output);
+  test.Run();
+}
+
 TEST(Random, InvalidDType) {
   float seed = 123.f;
 
@@ -221,10 +255,10 @@ TEST(Random, InvalidDType) {
 }
 
 /*
-Note: There are no reference tests that can be reused in this case. I tried to use the tensorflow
-test cases but they use a different RNG (Philox) and hence the test results differ. Since the implementation
-of the op is same as tensorflow, for now I've just relied on the output generated by this code as ground truth
-for verification.
+Note: There are no reference tests that can be reused in this case. The tensorflow test cases also use Philox,
+but they draw the samples from the stream in a different order and hence the test results differ. Since the
+implementation of the op is same as tensorflow, for now I've just relied on the output generated by this code as
+ground truth for verification.
 */
 TEST(Random, MultinomialGoodCase) {
   OpTester test("Multinomial");
@@ -244,13 +278,7 @@ TEST(Random, MultinomialGoodCase) {
   test.AddAttribute<int64_t>("dtype", TensorProto::INT64);
 
   const std::vector<int64_t> output_dims{batch_size, num_samples};
-#ifdef _WIN32
-  const std::vector<int64_t> expected_output{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-#elif defined(__MACH__) || defined(__ANDROID__)
-  const std::vector<int64_t> expected_output{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-#else
-  const std::vector<int64_t> expected_output{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-#endif
+  const std::vector<int64_t> expected_output{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
   test.AddOutput<int64_t>("Y", output_dims, expected_output);
 
   test.Run();
@@ -281,16 +309,9 @@ TEST(Random, MultinomialDefaultDType) {
     test.Run();
   };
 
-#ifdef _WIN32
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-  const std::vector<int32_t> expected_output_2{0, 0, 1, 0, 2, 2, 2, 0, 2, 1, 2, 1, 0, 2, 0, 2, 2, 1, 2, 1};
-#elif defined(__MACH__) || defined(__ANDROID__)
-  const std::vector<int32_t> expected_output_1{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-  const std::vector<int32_t> expected_output_2{1, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 2, 0, 1, 1, 0, 2, 2, 2, 1};
-#else
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-  const std::vector<int32_t> expected_output_2{2, 2, 1, 1, 0, 2, 2, 1, 1, 2, 0, 0, 0, 2, 0, 1, 1, 1, 0, 0};
-#endif
+  // Philox gives the same stream on every platform
+  const std::vector<int32_t> expected_output_1{1, 2, 0, 2, 0, 0, 2, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
+  const std::vector<int32_t> expected_output_2{2, 0, 0, 2, 0, 1, 2, 1, 1, 0, 0, 2, 0, 2, 2, 0, 2, 2, 1, 2};
 
   // Test output from a single call to Multinomial::Compute
   run_test(1, expected_output_1);
@@ -194,6 +194,35 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+TEST(MathOpTest, Add_Broadcast_Large) {
+  // large enough for the output to be split between threads: the channel bias is broadcast over spans of 64x64
+  // elements, and the scalar over the whole output in pieces
+  const int64_t N = 2, C = 3, HW = 64 * 64;
+  std::vector<float> X(N * C * HW);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(i % 1000);
+  }
+  std::vector<float> bias{1000.0f, 2000.0f, 3000.0f};
+  std::vector<float> expected_bias(X.size());
+  std::vector<float> expected_scalar(X.size());
+  for (size_t i = 0; i < X.size(); i++) {
+    expected_bias[i] = X[i] + bias[(i / HW) % C];
+    expected_scalar[i] = X[i] + 0.5f;
+  }
+
+  OpTester test_bias("Add");
+  test_bias.AddInput<float>("A", {N, C, 64, 64}, X);
+  test_bias.AddInput<float>("B", {C, 1, 1}, bias);
+  test_bias.AddOutput<float>("C", {N, C, 64, 64}, expected_bias);
+  test_bias.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  OpTester test_scalar("Add");
+  test_scalar.AddInput<float>("A", {N * C * HW}, X);
+  test_scalar.AddInput<float>("B", {}, {0.5f});
+  test_scalar.AddOutput<float>("C", {N * C * HW}, expected_scalar);
+  test_scalar.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, Sub_int32) {
   OpTester test("Sub");
   test.AddInput<int32_t>("A", {3}, {1, 4, 3});
@@ -477,6 +506,16 @@ TEST(MathOpTest, Pow_Broadcast_Scalar1) {
   test.Run();
 }
 
+TEST(MathOpTest, Pow_Broadcast_Scalar1_Sqrt) {
+  OpTester test("Pow");
+
+  std::vector<int64_t> dims{5};
+  test.AddInput<float>("X", dims, {0.0f, 1.0f, 2.0f, 9.0f, 1e6f});
+  test.AddInput<float>("Y", {}, {0.5f});
+  test.AddOutput<float>("Z", dims, {0.0f, 1.0f, std::sqrt(2.0f), 3.0f, 1e3f});
+  test.Run();
+}
+
 TEST(MathOpTest, Exp_float) {
   OpTester test("Exp");
   std::vector<int64_t> dims{2, 2};
@@ -517,6 +556,20 @@ TEST(MathOpTest, Log) {
   test.Run();
 }
 
+TEST(MathOpTest, Log_Range) {
+  OpTester test("Log");
+  std::vector<float> x;
+  std::vector<float> y;
+  for (int i = -30; i <= 30; i++) {
+    x.push_back(std::pow(3.0f, static_cast<float>(i)) * 1.1f);
+    y.push_back(std::log(x.back()));
+  }
+  std::vector<int64_t> dims{static_cast<int64_t>(x.size())};
+  test.AddInput<float>("X", dims, x);
+  test.AddOutput<float>("Y", dims, y);
+  test.Run();
+}
+
 TEST(MathOpTest, Sum_6) {
   OpTester test("Sum", 6);
   std::vector<int64_t> dims{3, 3};
@@ -1172,6 +1225,23 @@ TEST(MathOpTest, Expand_8_1x3_float16) {
   test.Run();
 }
 
+TEST(MathOpTest, Expand_8_Large) {
+  // broadcast on the outer and inner axes of a rank 3 output, large enough to be split over threads
+  std::vector<float> input(300);
+  for (size_t i = 0; i < input.size(); ++i) input[i] = static_cast<float>(i);
+  std::vector<float> output;
+  output.reserve(16 * 300 * 20);
+  for (int outer = 0; outer < 16; ++outer)
+    for (size_t i = 0; i < input.size(); ++i)
+      output.insert(output.end(), 20, input[i]);
+
+  OpTester test("Expand", 8);
+  test.AddInput<float>("data_0", {300, 1}, input);
+  test.AddInput<int64_t>("data_1", {3}, {16, 1, 20});
+  test.AddOutput<float>("result", {16, 300, 20}, output);
+  test.Run();
+}
+
 TEST(MathOpTest, Erf) {
   OpTester test("Erf", 9);
   std::vector<int64_t> dims{2, 2};
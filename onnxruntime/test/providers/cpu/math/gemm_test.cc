@@ -26,8 +26,6 @@ TEST(GemmOpTest, GemmNoTrans) {
   test.Run();
 }
 
-// Only CUDA kernel has float 16 support
-#ifdef USE_CUDA
 TEST(GemmOpTest, GemmNoTrans_f16) {
   OpTester test("Gemm");
 
@@ -58,7 +56,6 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
   test.AddOutput<MLFloat16>("Y", {2, 3}, f_Y);
   test.Run();
 }
-#endif
 
 TEST(GemmOpTest, GemmBroadcast) {
   OpTester test("Gemm");
@@ -100,6 +97,82 @@ TEST(GemmOpTest, GemmTrans) {
   test.Run();
 }
 
+// B is an initializer, so the kernel packs it once when it is created
+TEST(GemmOpTest, GemmNoTransBIsInitializer) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3},
+                       {1.0f, 2.0f, 3.0f,
+                        4.0f, 5.0f, 6.0f,
+                        7.0f, 8.0f, 9.0f,
+                        10.0f, 11.0f, 12.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {71.0f, 82.0f, 93.0f,
+                         -69.0f, -78.0f, -87.0f});
+  test.Run();
+}
+
+TEST(GemmOpTest, GemmTransBIsInitializer) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 4.0f, 7.0f, 10.0f,
+                        2.0f, 5.0f, 8.0f, 11.0f,
+                        3.0f, 6.0f, 9.0f, 12.0f},
+                       true);
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {71.0f, 82.0f, 93.0f,
+                         -69.0f, -78.0f, -87.0f});
+  test.Run();
+}
+
+// B is a sparse initializer, so the kernel packs only its nonzeros
+TEST(GemmOpTest, GemmTransBIsSparseInitializer) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+
+  test.AddInput<float>("A", {4, 2},
+                       {1.0f, -1.0f,
+                        2.0f, -2.0f,
+                        3.0f, -3.0f,
+                        4.0f, -4.0f});
+  test.AddInput<float>("B", {5, 4},
+                       {0.0f, 2.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 4.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f},
+                       true);
+  test.AddInput<float>("C", {5}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f});
+  test.AddOutput<float>("Y", {2, 5},
+                        {4.0f, 4.0f, 14.0f, 8.0f, 10.0f,
+                         0.0f, 4.0f, -2.0f, 8.0f, 10.0f});
+  test.Run();
+}
+
 TEST(GemmOpTest, GemmAlphaBeta) {
   OpTester test("Gemm");
 
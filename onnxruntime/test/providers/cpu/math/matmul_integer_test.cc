@@ -7,6 +7,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 #include <random>
 
@@ -42,6 +43,50 @@ TEST(MatmulIntegerOpTest, MatMulInteger_WithZero_ZeroPoint) {
   test.Run();
 }
 
+#ifndef USE_GEMMLOWP
+TEST(MatmulIntegerOpTest, MatMulInteger_2D_B_Is_Initializer) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6}, /*is_initializer*/ true);
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {}, {0});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-38, -83, -44, -98, -50, -113, -56, -128});
+  test.Run();
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_PerColumn_ZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 2}, {1, 4, 2, 5, 3, 6}, /*is_initializer*/ true);
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<uint8_t>("b_zero_point", {2}, {1, 2});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-23, -53, -26, -62, -29, -71, -32, -80});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});
+}
+
+// a batch of A by a shared B, whose sizes aren't multiples of the alignment of the int8 GEMM of the CUDA EP
+TEST(MatmulIntegerOpTest, MatMulInteger_3D_PerColumn_ZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {2, 2, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<uint8_t>("T2", {3, 5}, {1, 4, 2, 5, 3, 2, 8, 3, 0, 4, 3, 6, 9, 7, 9});
+  test.AddInput<uint8_t>("a_zero_point", {}, {7});
+  test.AddInput<uint8_t>("b_zero_point", {5}, {1, 2, 0, 3, 1});
+  test.AddOutput<int32_t>("T3", {2, 2, 5}, {-8, -8, -28, -8, -24, -11, -20, -42, -11, -37,
+                                            -14, -32, -56, -14, -50, -17, -44, -70, -17, -63});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});
+}
+
+TEST(MatmulIntegerOpTest, MatMulInteger_Uint8_Int8_ZeroPoint) {
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {4, 3}, {11, 7, 3, 10, 6, 2, 9, 5, 1, 8, 4, 0});
+  test.AddInput<int8_t>("T2", {3, 2}, {-1, 4, 2, -5, 3, 6});
+  test.AddInput<uint8_t>("a_zero_point", {}, {12});
+  test.AddInput<int8_t>("b_zero_point", {}, {-2});
+  test.AddOutput<int32_t>("T3", {4, 2}, {-66, -63, -76, -74, -86, -85, -96, -96});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider});
+}
+#endif
+
 template <typename T>
 std::vector<T> ToVector(const int* value, int size) {
   std::vector<T> data(size);
@@ -81,7 +81,7 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
@@ -93,7 +93,7 @@ void RunMatMulTest(int32_t opset_version = 7)
 
     int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
 
@@ -105,10 +105,71 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+TEST(MathOpTest, MatMulFloatTypeInitializer) {
+  // a constant 2-D B is packed once when the kernel is created
+  RunMatMulTest<float>(7, true);
+}
+
+TEST(MathOpTest, MatMulFloatTypeSparseInitializer) {
+  // a constant B with few nonzeros is packed as sparse and only the nonzeros are multiplied
+  const int64_t K = 8;
+  const int64_t N = 5;
+  std::vector<float> b_vals(K * N, 0.0f);
+  b_vals[0 * N + 1] = 2.0f;
+  b_vals[2 * N + 4] = -1.0f;
+  b_vals[3 * N + 0] = 0.5f;
+  b_vals[5 * N + 1] = 3.0f;
+  b_vals[7 * N + 3] = -2.0f;
+
+  std::vector<float> a_vals(2 * 3 * K);
+  for (size_t i = 0; i < a_vals.size(); i++) {
+    a_vals[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+
+  std::vector<float> y_vals(2 * 3 * N, 0.0f);
+  for (int64_t m = 0; m < 2 * 3; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      for (int64_t k = 0; k < K; k++) {
+        y_vals[m * N + n] += a_vals[m * K + k] * b_vals[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {2, 3, K}, a_vals);
+  test.AddInput<float>("B", {K, N}, b_vals, true);
+  test.AddOutput<float>("Y", {2, 3, N}, y_vals);
+  test.Run();
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
 
+TEST(MathOpTest, MatMulFloat16Type) {
+  OpTester test("MatMul", 7);
+
+  std::vector<float> A{1.0f, 2.0f, 3.0f,
+                       -1.0f, 0.5f, 4.0f};
+  std::vector<float> B{1.0f, -2.0f,
+                       0.25f, 3.0f,
+                       2.0f, 1.0f};
+  std::vector<float> Y{7.5f, 7.0f,
+                       7.125f, 7.5f};
+
+  std::vector<MLFloat16> f_A(6);
+  std::vector<MLFloat16> f_B(6);
+  std::vector<MLFloat16> f_Y(4);
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), 6);
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), 6);
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), 4);
+
+  test.AddInput<MLFloat16>("A", {2, 3}, f_A);
+  test.AddInput<MLFloat16>("B", {3, 2}, f_B);
+  test.AddOutput<MLFloat16>("Y", {2, 2}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, MatMulInt32Type) {
   RunMatMulTest<int32_t>(9);
 }
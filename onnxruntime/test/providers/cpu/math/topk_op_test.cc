@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -264,5 +265,68 @@ TEST(TopKOperator, Top1ExplicitAxisMultiDInputOpset10) {
   RunTest(10, 1, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, axis);
 }
 
+// Many equal values along a long axis, with a k the GPU sorts in a block and one it sorts in scratch buffers.
+TEST(TopKOperator, TopKWithTiesLongAxisOpset10) {
+  const int64_t rows = 2;
+  const int64_t dim = 3000;
+  std::vector<float> input_vals;
+  for (int64_t i = 0; i < rows * dim; ++i) {
+    input_vals.push_back(static_cast<float>((i * 7919) % 50) - 25.0f);
+  }
+
+  for (int64_t k : {7, 2000}) {
+    std::vector<float> expected_vals;
+    std::vector<int64_t> expected_indices;
+    for (int64_t row = 0; row < rows; ++row) {
+      std::vector<int64_t> order(dim);
+      for (int64_t i = 0; i < dim; ++i) {
+        order[i] = i;
+      }
+      const float* row_vals = input_vals.data() + row * dim;
+      std::stable_sort(order.begin(), order.end(), [row_vals](int64_t a, int64_t b) {
+        return row_vals[a] > row_vals[b];
+      });
+      for (int64_t i = 0; i < k; ++i) {
+        expected_vals.push_back(row_vals[order[i]]);
+        expected_indices.push_back(order[i]);
+      }
+    }
+    RunTest(10, k, input_vals, {rows, dim}, expected_vals, expected_indices, {rows, k}, false);
+  }
+}
+
+// An inner axis with many slices, so the strided slices are selected in parallel with both a small and a large k.
+TEST(TopKOperator, TopKInnerAxisManySlicesOpset10) {
+  const int64_t outer = 4;
+  const int64_t dim = 100;
+  const int64_t inner = 33;
+  std::vector<float> input_vals;
+  for (int64_t i = 0; i < outer * dim * inner; ++i) {
+    input_vals.push_back(static_cast<float>((i * 7919) % 61) * 0.5f);
+  }
+
+  for (int64_t k : {5, 40}) {
+    std::vector<float> expected_vals(outer * k * inner);
+    std::vector<int64_t> expected_indices(outer * k * inner);
+    for (int64_t o = 0; o < outer; ++o) {
+      for (int64_t j = 0; j < inner; ++j) {
+        std::vector<int64_t> order(dim);
+        for (int64_t i = 0; i < dim; ++i) {
+          order[i] = i;
+        }
+        const float* slice_vals = input_vals.data() + o * dim * inner + j;
+        std::stable_sort(order.begin(), order.end(), [slice_vals, inner](int64_t a, int64_t b) {
+          return slice_vals[a * inner] > slice_vals[b * inner];
+        });
+        for (int64_t i = 0; i < k; ++i) {
+          expected_vals[(o * k + i) * inner + j] = slice_vals[order[i] * inner];
+          expected_indices[(o * k + i) * inner + j] = order[i];
+        }
+      }
+    }
+    RunTest(10, k, input_vals, {outer, dim, inner}, expected_vals, expected_indices, {outer, k, inner}, false, 1);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -168,5 +168,34 @@ TEST(LabelEncoder, Int64ToFloatOpset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, StringToInt64Opset2ManyKeys) {
+  // enough keys and elements for the lookups to be split across the threads
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    values.push_back(3 * i);
+  }
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (int i = 0; i < 20000; ++i) {
+    const int key = (i * 7) % 1200;
+    input.push_back("key" + std::to_string(key));
+    output.push_back(key < 1000 ? 3 * key : -1);
+  }
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  test.AddInput<std::string>("X", {100, 200}, input);
+  test.AddOutput<std::int64_t>("Y", {100, 200}, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -121,5 +121,68 @@ TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   test.Run();
 }
 
+// stumps on the 3 features in turn, with 1 on the true branch and 2 on the false one, so the rows walk the trees
+// in blocks, or a single row walks them in parallel
+static void RunManyTreesTest(int64_t N) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  const int64_t n_trees = 300;
+  std::vector<int64_t> lefts, rights, treeids, nodeids, featureids;
+  std::vector<float> thresholds;
+  std::vector<std::string> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_classids;
+  std::vector<float> target_weights;
+  for (int64_t t = 0; t < n_trees; ++t) {
+    lefts.insert(lefts.end(), {1, 0, 0});
+    rights.insert(rights.end(), {2, 0, 0});
+    treeids.insert(treeids.end(), {t, t, t});
+    nodeids.insert(nodeids.end(), {0, 1, 2});
+    featureids.insert(featureids.end(), {t % 3, 0, 0});
+    thresholds.insert(thresholds.end(), {0.5f, 0.f, 0.f});
+    modes.insert(modes.end(), {"BRANCH_LEQ", "LEAF", "LEAF"});
+    target_treeids.insert(target_treeids.end(), {t, t});
+    target_nodeids.insert(target_nodeids.end(), {1, 2});
+    target_classids.insert(target_classids.end(), {0, 0});
+    target_weights.insert(target_weights.end(), {1.f, 2.f});
+  }
+
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int64_t i = 0; i < N; ++i) {
+    float result = 0.f;
+    for (int64_t f = 0; f < 3; ++f) {
+      float x = static_cast<float>((i >> f) & 1);
+      X.push_back(x);
+      result += (n_trees / 3) * (x <= 0.5f ? 1.f : 2.f);
+    }
+    results.push_back(result);
+  }
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<float>("X", {N, 3}, X);
+  test.AddOutput<float>("Y", {N, 1}, results);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeRegressorManyTreesSingleRow) {
+  RunManyTreesTest(1);
+}
+
+TEST(MLOpTest, TreeRegressorManyTreesManyRows) {
+  RunManyTreesTest(37);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
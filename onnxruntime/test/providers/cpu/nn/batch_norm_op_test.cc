@@ -345,6 +345,21 @@ TEST(BatchNormTest, BatchNorm3d_Pytorch) {
   TestBatchNorm(input_data_map, input_shapes_map, epsilon, expected_output, input_shape);
 }
 
+TEST(BatchNormTest, ConstantScaleBiasMeanVar) {
+  // scale, B, mean and var are initializers, so the kernel folds them into a scale and shift per channel up front.
+  OpTester test("BatchNormalization");
+  test.AddAttribute("epsilon", 0.0f);
+  test.AddInput<float>("X", {2, 2, 1, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f,
+                                           3.0f, 2.0f, 1.0f, 7.0f, 5.0f, 3.0f});
+  test.AddInput<float>("scale", {2}, {1.0f, 2.0f}, true);
+  test.AddInput<float>("B", {2}, {0.0f, 1.0f}, true);
+  test.AddInput<float>("mean", {2}, {2.0f, 5.0f}, true);
+  test.AddInput<float>("var", {2}, {1.0f, 4.0f}, true);
+  test.AddOutput<float>("output", {2, 2, 1, 3}, {-1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 2.0f,
+                                                 1.0f, 0.0f, -1.0f, 3.0f, 1.0f, -1.0f});
+  test.Run();
+}
+
 TEST(BatchNormTest, InvalidScaleDim) {
   vector<float> X{0.329876f, -0.287158f, -0.411425f, 0.473621f, 0.18156f, -0.170596f, -0.329516f, -0.170733f, -0.121664f, 0.4372f,
                   -0.485668f, 0.218049f, -0.360263f, 0.107016f, 0.45358f, 0.325056f, 0.15995f, 0.098852f, -0.283453f, -0.373051f,
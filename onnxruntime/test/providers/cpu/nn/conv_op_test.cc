@@ -3,6 +3,11 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#ifdef USE_CUDA
+#include <cstdio>
+#include <fstream>
+#include "core/providers/cuda/cuda_execution_provider.h"
+#endif
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -141,6 +146,59 @@ TEST(ConvTest, Conv1D_Bias) {
   TestConvOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
 }
 
+#ifdef USE_CUDA
+// The algorithms of the convolutions are chosen by the cuDNN heuristics, or benchmarked and shared through a file.
+TEST(ConvTest, Conv1D_CudnnConvAlgoSearch) {
+  const std::basic_string<ORTCHAR_T> cache_path = ORT_TSTR("conv_1d_cudnn_conv_algo_cache.txt");
+  auto remove_cache = [&cache_path]() {
+#ifdef _WIN32
+    _wremove(cache_path.c_str());
+#else
+    std::remove(cache_path.c_str());
+#endif
+  };
+
+  auto run = [](cuda::CudnnConvAlgoSearch search, const std::basic_string<ORTCHAR_T>& path) {
+    OpTester test("Conv");
+    test.AddAttribute("dilations", vector<int64_t>{1});
+    test.AddAttribute("group", int64_t{1});
+    test.AddAttribute("kernel_shape", vector<int64_t>{1});
+    test.AddAttribute("pads", vector<int64_t>{0, 0});
+    test.AddAttribute("strides", vector<int64_t>{1});
+    test.AddInput<float>("X", {1, 1, 4}, {1.0f, -2.0f, 3.0f, 0.5f});
+    test.AddInput<float>("W", {1, 1, 1}, {2.0f});
+    test.AddOutput<float>("Y", {1, 1, 4}, {2.0f, -4.0f, 6.0f, 1.0f});
+
+    CUDAExecutionProviderInfo info;
+    info.cudnn_conv_algo_search = search;
+    info.cudnn_conv_algo_cache_path = path;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(std::make_unique<CUDAExecutionProvider>(info));
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  };
+
+  run(cuda::CudnnConvAlgoSearch::Heuristic, {});
+
+  // the provider saves the algorithm it benchmarked when its session is released
+  remove_cache();
+  run(cuda::CudnnConvAlgoSearch::Exhaustive, cache_path);
+  {
+    std::ifstream cache(cache_path);
+    ASSERT_TRUE(cache.good());
+    std::string line;
+    int entries = 0;
+    while (std::getline(cache, line)) {
+      entries += line.find(" Conv type=") != std::string::npos ? 1 : 0;
+    }
+    EXPECT_EQ(entries, 1);
+  }
+
+  // and the next one runs the cached algorithm
+  run(cuda::CudnnConvAlgoSearch::Heuristic, cache_path);
+  remove_cache();
+}
+#endif
+
 // Conv47
 TEST(ConvTest, Conv2D_1) {
   ConvOpAttributes attrs = {
@@ -165,6 +223,36 @@ TEST(ConvTest, Conv2D_1) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, false, true);  // asymmetric padding is not supported by cudnn
 }
 
+TEST(ConvTest, Conv2D_Float16) {
+  OpTester test("Conv");
+  test.AddAttribute("kernel_shape", vector<int64_t>{2, 2});
+  test.AddAttribute("pads", vector<int64_t>{0, 1, 0, 1});
+
+  // 1x1x2x3 image, 2x1x2x2 filter and bias, exactly representable in float16
+  vector<float> X = {1.0f, 2.0f, 3.0f,
+                     4.0f, 5.0f, 6.0f};
+  vector<float> W = {1.0f, 0.0f, 0.0f, 1.0f,
+                     0.5f, 0.5f, -1.0f, 2.0f};
+  vector<float> B = {1.0f, -1.0f};
+  vector<float> Y = {5.0f, 7.0f, 9.0f, 4.0f,
+                     7.5f, 6.5f, 8.5f, -5.5f};
+
+  vector<MLFloat16> f_X(X.size());
+  vector<MLFloat16> f_W(W.size());
+  vector<MLFloat16> f_B(B.size());
+  vector<MLFloat16> f_Y(Y.size());
+  ConvertFloatToMLFloat16(X.data(), f_X.data(), static_cast<int>(X.size()));
+  ConvertFloatToMLFloat16(W.data(), f_W.data(), static_cast<int>(W.size()));
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), static_cast<int>(B.size()));
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), static_cast<int>(Y.size()));
+
+  test.AddInput<MLFloat16>("X", {1, 1, 2, 3}, f_X);
+  test.AddInput<MLFloat16>("W", {2, 1, 2, 2}, f_W);
+  test.AddInput<MLFloat16>("B", {2}, f_B);
+  test.AddOutput<MLFloat16>("Y", {1, 2, 1, 4}, f_Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kMklDnnExecutionProvider});
+}
+
 TEST(ConvTest, Conv1D_Invalid_Input_Shape) {
   ConvOpAttributes attrs = {
       "",                     // auto_pad
@@ -545,5 +633,61 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+// 3x3 convolutions with enough channels use the Winograd algorithm. Cover both output tile sizes,
+// partial tiles at the output edges, and a constant W that is transformed once.
+TEST(ConvTest, Conv2D_Winograd) {
+  const int64_t C = 8;
+  const int64_t M = 12;
+
+  for (int64_t H : {4, 7}) {
+    const int64_t W_dim = H + 2;
+
+    vector<float> X(C * H * W_dim);
+    for (size_t i = 0; i < X.size(); i++) {
+      X[i] = static_cast<float>(static_cast<int>(i % 11) - 5) * 0.25f;
+    }
+    vector<float> W(M * C * 9);
+    for (size_t i = 0; i < W.size(); i++) {
+      W[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.125f;
+    }
+    vector<float> B(M);
+    for (size_t i = 0; i < B.size(); i++) {
+      B[i] = static_cast<float>(i) * 0.5f;
+    }
+
+    vector<float> expected_vals(M * H * W_dim);
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < H; oh++) {
+        for (int64_t ow = 0; ow < W_dim; ow++) {
+          float sum = B[m];
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = oh + kh - 1;
+                const int64_t iw = ow + kw - 1;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W_dim) {
+                  sum += X[(c * H + ih) * W_dim + iw] * W[((m * C + c) * 3 + kh) * 3 + kw];
+                }
+              }
+            }
+          }
+          expected_vals[(m * H + oh) * W_dim + ow] = sum;
+        }
+      }
+    }
+
+    for (bool is_initializer : {false, true}) {
+      OpTester test("Conv");
+      test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+      test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+      test.AddInput<float>("X", {1, C, H, W_dim}, X);
+      test.AddInput<float>("W", {M, C, 3, 3}, W, is_initializer);
+      test.AddInput<float>("B", {M}, B, is_initializer);
+      test.AddOutput<float>("Y", {1, M, H, W_dim}, expected_vals);
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
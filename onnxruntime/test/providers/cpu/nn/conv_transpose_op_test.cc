@@ -471,6 +471,68 @@ TEST(ConvTransposeTest, ConvTranspose_2D_Dilation_Group_1) {
   TestConvTransposeOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+TEST(ConvTransposeTest, ConvTranspose_2D_Pointwise_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{1, 1},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      1                             // group
+  };
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.5f, 2.0f, -3.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {1.0f, -2.0f, 0.5f, 3.0f, 1.0f, -1.0f};
+  vector<int64_t> W_shape = {2, 3, 1, 1};
+  vector<float> B = {0.5f, -1.0f, 2.0f};
+  vector<int64_t> B_shape = {3};
+  vector<int64_t> Y_shape = {1, 3, 2, 2};
+  auto expected_vals = {-1.5f, 4.0f, 9.5f, -4.5f,
+                        -4.0f, -4.5f, -5.0f, -12.0f,
+                        3.5f, 2.5f, 1.5f, 7.0f};
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
+
+TEST(ConvTransposeTest, ConvTranspose_2D_Group_Stride_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{2, 2},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{2, 2},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      2                             // group
+  };
+  vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.5f, 2.0f, -3.0f};
+  vector<int64_t> X_shape = {1, 2, 2, 2};
+  vector<float> W = {1.0f, 2.0f, 3.0f, 4.0f, 0.0f, -1.0f, 1.0f, 0.0f,
+                     0.5f, 0.5f, -1.0f, 2.0f, 2.0f, 0.0f, 0.0f, -2.0f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<float> B = {0.1f, 0.2f, 0.3f, 0.4f};
+  vector<int64_t> B_shape = {4};
+  vector<int64_t> Y_shape = {1, 4, 4, 4};
+  auto expected_vals = {1.1f, 2.1f, 2.1f, 4.1f,
+                        3.1f, 4.1f, 6.1f, 8.1f,
+                        3.1f, 6.1f, 4.1f, 8.1f,
+                        9.1f, 12.1f, 12.1f, 16.1f,
+
+                        0.2f, -0.8f, 0.2f, -1.8f,
+                        1.2f, 0.2f, 2.2f, 0.2f,
+                        0.2f, -2.8f, 0.2f, -3.8f,
+                        3.2f, 0.2f, 4.2f, 0.2f,
+
+                        -0.2f, -0.2f, 0.55f, 0.55f,
+                        1.3f, -1.7f, -0.2f, 1.3f,
+                        1.3f, 1.3f, -1.2f, -1.2f,
+                        -1.7f, 4.3f, 3.3f, -5.7f,
+
+                        -1.6f, 0.4f, 1.4f, 0.4f,
+                        0.4f, 2.4f, 0.4f, -0.6f,
+                        4.4f, 0.4f, -5.6f, 0.4f,
+                        0.4f, -3.6f, 0.4f, 6.4f};
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
 
 }  // namespace test
 }  // namespace onnxruntime
@@ -176,6 +176,29 @@ TEST(ConvTest, QLinearConv3DTest) {
   test.Run();
 }
 
+TEST(ConvTest, QLinearConvPerChannelTest) {
+  // Each output channel has its own filter scale and zero point. The bottom and right pads are the input zero point.
+  OpTester test("QLinearConv", 10);
+  test.AddAttribute<std::vector<int64_t>>("pads", {0, 0, 1, 1});
+
+  test.AddInput<uint8_t>("x", {1, 1, 3, 3}, {12, 30, 7, 0, 255, 64, 10, 90, 128});
+  test.AddInput<float>("x_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {10});
+
+  test.AddInput<uint8_t>("w", {2, 1, 2, 2}, {110, 90, 100, 140, 120, 200, 30, 125});
+  test.AddInput<float>("w_scale", {2}, {0.25f, 0.1f});
+  test.AddInput<uint8_t>("w_zero_point", {2}, {100, 120});
+
+  test.AddInput<float>("y_scale", {}, {4.0f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {128});
+  test.AddInput<int32_t>("b", {2}, {7, -23});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 3, 3},
+                          {255, 203, 127, 149, 255, 145, 103, 116, 165,
+                           174, 0, 67, 255, 99, 0, 208, 246, 128});
+  test.Run();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
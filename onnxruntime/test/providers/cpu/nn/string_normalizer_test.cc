@@ -166,6 +166,27 @@ TEST(ContribOpTest, StringNormalizerTest) {
     test.AddOutput<std::string>("Y", {6}, output);
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
+  // - case-INSENSETIVE approach en_US locale
+  // - a mix of ASCII strings, whose case is changed without the locale, and non-ASCII ones
+  // - filter out monday and école in any case
+  // - LOWER
+  {
+    OpTester test("StringNormalizer", opset_ver, domain);
+    InitTestAttr(test, "LOWER", false, {u8"MONDAY", u8"ÉCOLE"}, test_locale);
+    std::vector<int64_t> dims{5};
+    std::vector<std::string> input = {std::string(u8"Monday"),
+                                      std::string(u8"TUESDAY"),
+                                      std::string(u8"ÉCole"),
+                                      std::string(u8"Besançon"),
+                                      std::string(u8"Mon-Day 1")};
+    test.AddInput<std::string>("T", dims, input);
+
+    std::vector<std::string> output = {std::string(u8"tuesday"),
+                                       std::string(u8"besançon"),
+                                       std::string(u8"mon-day 1")};
+    test.AddOutput<std::string>("Y", {3}, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
 
   // Empty output case
   // - casesensitive approach
@@ -666,5 +666,33 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(TfIdfVectorizerTest, Int64_TF_UniAndBigrams_Skip0_ManyRows) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=0, Min=1, Max=2, weights empty, int64, with enough rows to be split across the threads
+  InitTestAttr(test, "TF", 1, 2, 0,
+               {0, 2},
+               {0, 1, 2, 3},  //4 output indexes
+               {},
+               {1, 2,         //1-grams
+                1, 2, 2, 1},  //bi-grams
+               {});
+
+  // even rows are 1, 2, 1, 2, ... and odd rows 2, 1, 2, 1, ...
+  const int64_t B = 256;
+  const int64_t C = 8;
+  std::vector<int64_t> input;
+  std::vector<float> output;
+  for (int64_t row = 0; row < B; ++row) {
+    for (int64_t i = 0; i < C; ++i) {
+      input.push_back((row + i) % 2 + 1);
+    }
+    output.insert(output.end(), {4, 4, row % 2 == 0 ? 4.0f : 3.0f, row % 2 == 0 ? 3.0f : 4.0f});
+  }
+  test.AddInput<int64_t>("T", {B, C}, input);
+  test.AddOutput<float>("Y", {B, 4}, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -288,6 +288,26 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, EqualScoresSelectLowestIndex) {
+  OpTester test("NonMaxSuppression", 10, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, 4, 4},
+                       {0.0f, 0.0f, 1.0f, 1.0f,
+                        0.0f, 0.0f, 1.0f, 1.0f,
+                        0.0f, 10.0f, 1.0f, 11.0f,
+                        0.0f, 10.0f, 1.0f, 11.0f});
+  test.AddInput<float>("scores", {1, 2, 4},
+                       {0.5f, 0.5f, 0.5f, 0.5f,
+                        0.1f, 0.8f, 0.3f, 0.9f});
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {4L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddOutput<int64_t>("selected_indices", {4, 3},
+                          {0L, 0L, 0L,
+                           0L, 0L, 2L,
+                           0L, 1L, 3L,
+                           0L, 1L, 1L});
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
@@ -1186,5 +1186,51 @@ TEST(ReductionOpTest, ArgMin_int32) {
   test.Run();
 }
 
+TEST(ReductionOpTest, ReduceProd_int32_middle_axes) {
+  // the reduced axes are neither leading nor trailing, so the input is reduced in place with strides
+  OpTester test("ReduceProd");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 2});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<int32_t>("data", {2, 2, 2, 2},
+                         {1, 2,
+                          3, 4,
+
+                          5, 6,
+                          7, 8,
+
+                          1, -1,
+                          2, -2,
+
+                          3, -3,
+                          4, -4});
+  test.AddOutput<int32_t>("reduced", {2, 2},
+                          {105, 384,
+                           24, 24});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ArgMin_wide_inner) {
+  // the inner dimension is split into several blocks
+  const int64_t inner = 1000;
+  std::vector<float> data(2 * 3 * inner);
+  std::vector<int64_t> expected(2 * inner);
+  for (int64_t o = 0; o < 2; o++) {
+    for (int64_t i = 0; i < inner; i++) {
+      const int64_t min_index = (o + i) % 3;
+      for (int64_t r = 0; r < 3; r++) {
+        data[(o * 3 + r) * inner + i] = r == min_index ? -static_cast<float>(i + 1) : static_cast<float>(r + i);
+      }
+      expected[o * inner + i] = min_index;
+    }
+  }
+
+  OpTester test("ArgMin");
+  test.AddAttribute("axis", (int64_t)1);
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {2, 3, inner}, data);
+  test.AddOutput<int64_t>("reduced", {2, 1, inner}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
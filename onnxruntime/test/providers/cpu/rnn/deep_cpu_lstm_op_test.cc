@@ -46,7 +46,8 @@ static void RunLstmTest(const std::vector<float>& X_data,
                         std::vector<string> activations = {},
                         std::vector<float> activation_alphas = {},
                         std::vector<float> activation_betas = {},
-                        bool hasClip = true) {
+                        bool hasClip = true,
+                        bool weights_are_initializers = false) {
   OpTester test("LSTM");
 
   int num_directions = (direction == "bidirectional") ? 2 : 1;
@@ -78,8 +79,8 @@ static void RunLstmTest(const std::vector<float>& X_data,
   std::vector<int64_t> R_dims = {num_directions, 4 * hidden_size, hidden_size};
 
   test.AddInput<float>("X", X_dims, X_data);
-  test.AddInput<float>("W", W_dims, W_data);
-  test.AddInput<float>("R", R_dims, R_data);
+  test.AddInput<float>("W", W_dims, W_data, weights_are_initializers);
+  test.AddInput<float>("R", R_dims, R_data, weights_are_initializers);
 
   if (B_data) {
     std::vector<int64_t> B_dims = {num_directions, 8 * hidden_size};
@@ -146,7 +147,8 @@ void SimpleWeightsNoBiasTwoRows(std::string direction,
                                 const std::vector<float>& Y_data,
                                 const std::vector<float>& Y_h_data,
                                 const std::vector<float>& Y_c_data,
-                                const std::vector<int>* seq_lengths = nullptr) {
+                                const std::vector<int>* seq_lengths = nullptr,
+                                bool weights_are_initializers = false) {
   int64_t seq_length = 2;
   int batch_size = 2;
   int64_t input_size = 1;
@@ -170,14 +172,16 @@ void SimpleWeightsNoBiasTwoRows(std::string direction,
 
   RunLstmTest(X_data, W_data, R_data, Y_data, Y_h_data, Y_c_data,
               input_size, batch_size, hidden_size, seq_length,
-              nullptr, nullptr, nullptr, nullptr, seq_lengths, direction);
+              nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 9999.f, true, false, {}, {}, {}, true,
+              weights_are_initializers);
 
   // need at least one output, so we need Y_h or Y_c to be requested (non-empty output to compare against) in order
   // to test Y not being returned (output_sequence == false)
   if (!Y_h_data.empty() || !Y_c_data.empty())
     RunLstmTest(X_data, W_data, R_data, Y_data, Y_h_data, Y_c_data,
                 input_size, batch_size, hidden_size, seq_length,
-                nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 999.f, /* output_sequence*/ false);
+                nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 999.f, /* output_sequence*/ false,
+                false, {}, {}, {}, true, weights_are_initializers);
 }
 
 TEST(LSTMTest, ForwardSimpleWeightsNoBiasTwoRows) {
@@ -253,6 +257,9 @@ TEST(LSTMTest, BidirectionalSimpleWeightsNoBiasTwoRows) {
 
   // cudnn don't support customized activation
   SimpleWeightsNoBiasTwoRows("bidirectional", Y_data, Y_h_data, Y_c_data);
+
+  // constant weights are packed for each direction when the kernel is created
+  SimpleWeightsNoBiasTwoRows("bidirectional", Y_data, Y_h_data, Y_c_data, nullptr, true);
 }
 
 TEST(LSTMTest, MixedSequenceLengths) {
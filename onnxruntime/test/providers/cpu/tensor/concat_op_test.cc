@@ -233,5 +233,28 @@ TEST(ConcatOpTest, Concat3D_3) {
   test.Run();
 }
 
+TEST(ConcatOpTest, Concat2D_LargeRows) {
+  // the rows are longer than the chunks the copies are split into
+  const int64_t row_size = 20000;
+  std::vector<float> input1(2 * row_size);
+  std::vector<float> input2(2 * row_size);
+  std::vector<float> expected;
+  for (int64_t i = 0; i < 2 * row_size; ++i) {
+    input1[i] = static_cast<float>(i);
+    input2[i] = static_cast<float>(-i);
+  }
+  for (int64_t row = 0; row < 2; ++row) {
+    expected.insert(expected.end(), input1.begin() + row * row_size, input1.begin() + (row + 1) * row_size);
+    expected.insert(expected.end(), input2.begin() + row * row_size, input2.begin() + (row + 1) * row_size);
+  }
+
+  OpTester test("Concat");
+  test.AddAttribute("axis", int64_t{1});
+  test.AddInput<float>("input1", {2, row_size}, input1);
+  test.AddInput<float>("input2", {2, row_size}, input2);
+  test.AddOutput<float>("concat_result", {2, 2 * row_size}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -47,5 +47,22 @@ TEST(QuantizeLinearOpTest, DynamicQuantizeLinear_Max_Adjusted) {
   test.Run();
 }
 
+// the range is found from the ranges of the blocks of a large input
+TEST(QuantizeLinearOpTest, DynamicQuantizeLinear_LargeInput) {
+  OpTester test("DynamicQuantizeLinear", 11);
+  const int64_t size = 50000;
+  std::vector<float> x(size, 0.0f);
+  std::vector<uint8_t> y(size, 100);
+  x[20000] = -1.0f;
+  y[20000] = 0;
+  x[40000] = 1.55f;
+  y[40000] = 255;
+  test.AddInput<float>("x", {size}, x);
+  test.AddOutput<uint8_t>("y", {size}, y);
+  test.AddOutput<float>("y_scale", {}, {2.55f / 255});
+  test.AddOutput<uint8_t>("y_zero_point", {}, {100});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -305,5 +305,33 @@ TEST(GatherOpTest, Gather_perf) {
   test.AddOutput<int32_t>("output", {800, 1, 100}, output);
   test.Run();
 }
+
+TEST(GatherOpTest, Gather_axis1_int64_many_indices) {
+  // gathers single 8 byte elements from many rows, split between threads
+  const int64_t rows = 37, columns = 50, num_indices = 300;
+  std::vector<int64_t> input(rows * columns);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<int64_t>(i) * 3;
+  }
+
+  std::vector<int64_t> indices(num_indices);
+  for (int64_t i = 0; i < num_indices; ++i) {
+    indices[i] = (i * 7) % columns;
+  }
+
+  std::vector<int64_t> output(rows * num_indices);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t i = 0; i < num_indices; ++i) {
+      output[r * num_indices + i] = input[r * columns + indices[i]];
+    }
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 1LL);
+  test.AddInput<int64_t>("data", {rows, columns}, input);
+  test.AddInput<int64_t>("indices", {num_indices}, indices);
+  test.AddOutput<int64_t>("output", {rows, num_indices}, output);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -206,5 +206,34 @@ TEST(OneHotOpTest, FloatString) {
                                                 "off", "off", "off", "off", "off", "off", "on", "off", "off", "off",});
   test.Run();
 }
+
+TEST(OneHotOpTest, IndicesOutOfRange) {
+  // indices outside [0, depth) and non integer indices give all off values
+  OpTester test("OneHot", 9);
+  test.AddInput<float>("indices", {4}, {-1.f, 3.f, 1.5f, 2.f});
+  test.AddInput<int64_t>("depth", {1}, {3});
+  test.AddInput<int64_t>("values", {2}, {5, 7});
+  test.AddOutput<int64_t>("output", {4, 3}, {5, 5, 5,
+                                             5, 5, 5,
+                                             5, 5, 5,
+                                             5, 5, 7});
+  test.Run();
+}
+
+TEST(OneHotOpTest, Axis_0_Large) {
+  const int64_t depth = 50;
+  std::vector<int64_t> indices(1000);
+  for (size_t i = 0; i < indices.size(); ++i) indices[i] = static_cast<int64_t>(i * 7 % depth);
+  std::vector<float> output(depth * indices.size(), 0.f);
+  for (size_t i = 0; i < indices.size(); ++i) output[indices[i] * indices.size() + i] = 1.f;
+
+  OpTester test("OneHot", 9);
+  test.AddAttribute("axis", int64_t{0});
+  test.AddInput<int64_t>("indices", {static_cast<int64_t>(indices.size())}, indices);
+  test.AddInput<int64_t>("depth", {1}, {depth});
+  test.AddInput<float>("values", {2}, {0.f, 1.f});
+  test.AddOutput<float>("output", {depth, static_cast<int64_t>(indices.size())}, output);
+  test.Run();
+}
 }
 }  // namespace onnxruntime
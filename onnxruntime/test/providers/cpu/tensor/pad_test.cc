@@ -72,6 +72,20 @@ TEST(TensorOpTest, Pad_Constant_2D_negative) {
   test.Run();
 }
 
+TEST(TensorOpTest, Pad_Constant_2D_negative_begin) {
+  OpTester test("Pad");
+
+  test.AddAttribute("pads", std::vector<int64_t>{0, -1, 0, 1});
+  test.AddAttribute("value", 1234.0f);
+  test.AddInput<float>("data", {2, 3},
+                       {11.0f, 21.0f, 31.0f,
+                        12.0f, 22.0f, 32.0f});
+  test.AddOutput<float>("output", {2, 3},
+                        {21.0f, 31.0f, 1234.0f,
+                         22.0f, 32.0f, 1234.0f});
+  test.Run();
+}
+
 TEST(TensorOpTest, Pad_3D_complex) {
   OpTester test("Pad");
 
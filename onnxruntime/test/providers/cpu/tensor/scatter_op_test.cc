@@ -146,5 +146,31 @@ TEST(ScatterOpTest, InvalidIndex) {
   test.AddOutput<float>("y", {4, 2, 1}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 5.0f, 0.0f});
   test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds, idx=4 data_dim=4");
 }
+TEST(ScatterOpTest, WithAxisManyRows) {
+  // the rows are updated in parallel when axis isn't 0
+  const int64_t rows = 64, columns = 8, updates_per_row = 2;
+  std::vector<float> input(rows * columns, 0.0f);
+  std::vector<int64_t> indices(rows * updates_per_row);
+  std::vector<float> updates(rows * updates_per_row);
+  std::vector<float> output(input);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t j = 0; j < updates_per_row; ++j) {
+      const int64_t index = (r + 3 * j) % columns;
+      const float update = static_cast<float>(r * 10 + j);
+      indices[r * updates_per_row + j] = index;
+      updates[r * updates_per_row + j] = update;
+      output[r * columns + index] = update;
+    }
+  }
+
+  OpTester test("Scatter", Scatter_ver);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddInput<float>("data", {rows, columns}, input);
+  test.AddInput<int64_t>("indices", {rows, updates_per_row}, indices);
+  test.AddInput<float>("updates", {rows, updates_per_row}, updates);
+  test.AddOutput<float>("y", {rows, columns}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -262,6 +262,48 @@ TEST(TensorOpTest, CastFromFloat16) {
   TestCastOp(input, int64_t_data, shape, TensorProto::INT64);
 }
 
+TEST(TensorOpTest, CastFloat16Large) {
+  // spans several conversion blocks, with a partial one at the end
+  const int64_t size = 1000;
+  std::vector<float> float_data(size);
+  std::vector<int32_t> int32_data(size);
+  std::vector<MLFloat16> float16_data(size);
+  for (int64_t i = 0; i < size; ++i) {
+    int32_data[i] = static_cast<int32_t>(i - size / 2);
+    float_data[i] = static_cast<float>(int32_data[i]) * 0.25f;
+    float16_data[i] = MLFloat16(math::floatToHalf(float_data[i]));
+  }
+
+  OpTester to_float16("Cast", 9);
+  to_float16.AddAttribute("to", int64_t{TensorProto::FLOAT16});
+  to_float16.AddInput<float>("input", {size}, float_data);
+  to_float16.AddOutput<MLFloat16>("output", {size}, float16_data);
+  to_float16.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  OpTester from_float16("Cast", 9);
+  from_float16.AddAttribute("to", int64_t{TensorProto::FLOAT});
+  from_float16.AddInput<MLFloat16>("input", {size}, float16_data);
+  from_float16.AddOutput<float>("output", {size}, float_data);
+  from_float16.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  std::vector<MLFloat16> int32_as_float16(size);
+  for (int64_t i = 0; i < size; ++i) {
+    int32_as_float16[i] = MLFloat16(math::floatToHalf(static_cast<float>(int32_data[i])));
+  }
+
+  OpTester int32_to_float16("Cast", 9);
+  int32_to_float16.AddAttribute("to", int64_t{TensorProto::FLOAT16});
+  int32_to_float16.AddInput<int32_t>("input", {size}, int32_data);
+  int32_to_float16.AddOutput<MLFloat16>("output", {size}, int32_as_float16);
+  int32_to_float16.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  OpTester float16_to_int32("Cast", 9);
+  float16_to_int32.AddAttribute("to", int64_t{TensorProto::INT32});
+  float16_to_int32.AddInput<MLFloat16>("input", {size}, int32_as_float16);
+  float16_to_int32.AddOutput<int32_t>("output", {size}, int32_data);
+  float16_to_int32.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(TensorOpTest, CastFromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   std::initializer_list<std::string> string_data = {"-inf", "+INF", "2.0f", "3.0f", "4.0f", "5.0f", "NaN", "nan"};
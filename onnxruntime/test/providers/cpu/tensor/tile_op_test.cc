@@ -63,6 +63,29 @@ void RunTestWrapper<bool>() {
   RunTest<bool>({true, false, true, false, true, false}, {2, 1, 3}, {1, 2, 1}, {3}, {true, false, true, true, false, true, false, true, false, false, true, false}, {2, 2, 3});
 }
 
+TEST(TensorOpTest, TileLarge) {
+  // enough output to split the copies of every axis over threads
+  const std::vector<int64_t> input_dims{3, 5, 7};
+  const std::vector<int64_t> repeats{4, 30, 50};
+  std::vector<int32_t> input(3 * 5 * 7);
+  for (size_t i = 0; i < input.size(); ++i) input[i] = static_cast<int32_t>(i);
+
+  std::vector<int64_t> output_dims(3);
+  for (size_t axis = 0; axis < 3; ++axis) output_dims[axis] = input_dims[axis] * repeats[axis];
+  std::vector<int32_t> output;
+  output.reserve(output_dims[0] * output_dims[1] * output_dims[2]);
+  for (int64_t i0 = 0; i0 < output_dims[0]; ++i0)
+    for (int64_t i1 = 0; i1 < output_dims[1]; ++i1)
+      for (int64_t i2 = 0; i2 < output_dims[2]; ++i2)
+        output.push_back(input[((i0 % 3) * 5 + i1 % 5) * 7 + i2 % 7]);
+
+  OpTester test("Tile");
+  test.AddInput<int32_t>("input", input_dims, input);
+  test.AddInput<int64_t>("repeats", {3}, repeats);
+  test.AddOutput<int32_t>("output", output_dims, output);
+  test.Run();
+}
+
 TEST(TensorOpTest, TileFloatType) {
   RunTestWrapper<float>();
 }
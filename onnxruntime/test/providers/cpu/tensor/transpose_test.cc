@@ -205,5 +205,60 @@ TEST(TransposeOpTest, NHWC2NCHW) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Shapes large enough for the tiled transpose to split the matrices between threads, with sizes that leave
+// partial tiles.
+template <typename T>
+void TransposeLargeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[perm[i]];
+  }
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+  const size_t size = static_cast<size_t>(input_strides[0] * input_shape[0]);
+
+  std::vector<T> input_vals(size);
+  for (size_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 251);
+  }
+  std::vector<T> expected_vals(size);
+  for (size_t i = 0; i < size; ++i) {
+    int64_t remaining = static_cast<int64_t>(i);
+    int64_t offset = 0;
+    for (size_t k = rank; k-- > 0;) {
+      offset += (remaining % expected_shape[k]) * input_strides[perm[k]];
+      remaining /= expected_shape[k];
+    }
+    expected_vals[i] = input_vals[offset];
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", expected_shape, expected_vals);
+  test.Run();
+}
+
+TEST(TransposeOpTest, NCHW2NHWCLarge) {
+  TransposeLargeTest<float>({2, 35, 17, 19}, {0, 2, 3, 1});
+  TransposeLargeTest<uint8_t>({2, 35, 17, 19}, {0, 2, 3, 1});
+}
+
+TEST(TransposeOpTest, NHWC2NCHWLarge) {
+  TransposeLargeTest<float>({2, 17, 19, 35}, {0, 3, 1, 2});
+  TransposeLargeTest<uint8_t>({2, 17, 19, 35}, {0, 3, 1, 2});
+}
+
+TEST(TransposeOpTest, TwoDimLarge) {
+  TransposeLargeTest<int32_t>({197, 771}, {1, 0});
+}
+
+TEST(TransposeOpTest, MovedBlocksLarge) {
+  TransposeLargeTest<float>({3, 37, 5, 64}, {0, 2, 1, 3});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -295,6 +295,54 @@ TEST(UpsampleOpTest, UpsampleOp4DBilinearTest) {
   test.Run();
 }
 
+TEST(UpsampleOpTest, UpsampleOp4DBilinearTest_MultiChannelFractionalScale) {
+  OpTester test("Upsample");
+
+  std::vector<float> scales{1.0f, 1.0f, 2.0f, 1.5f};
+  test.AddAttribute("mode", "linear");
+  test.AddAttribute("scales", scales);
+
+  const int64_t N = 1, C = 3, H = 3, W = 2;
+  std::vector<float> X = {1.0f, 3.0f,
+                          5.0f, 7.0f,
+                          9.0f, 11.0f,
+
+                          2.0f, 0.0f,
+                          4.0f, 8.0f,
+                          6.0f, 2.0f,
+
+                          0.0f, 10.0f,
+                          10.0f, 0.0f,
+                          20.0f, 20.0f};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+
+  std::vector<float> Y = {
+      1.0f, 2.333333f, 3.0f,
+      3.0f, 4.333333f, 5.0f,
+      5.0f, 6.333333f, 7.0f,
+      7.0f, 8.333333f, 9.0f,
+      9.0f, 10.333333f, 11.0f,
+      9.0f, 10.333333f, 11.0f,
+
+      2.0f, 0.666667f, 0.0f,
+      3.0f, 3.666667f, 4.0f,
+      4.0f, 6.666667f, 8.0f,
+      5.0f, 5.0f, 5.0f,
+      6.0f, 3.333333f, 2.0f,
+      6.0f, 3.333333f, 2.0f,
+
+      0.0f, 6.666667f, 10.0f,
+      5.0f, 5.0f, 5.0f,
+      10.0f, 3.333333f, 0.0f,
+      15.0f, 11.666667f, 10.0f,
+      20.0f, 20.0f, 20.0f,
+      20.0f, 20.0f, 20.0f};
+
+  test.AddOutput<float>("Y", {N, C, (int64_t)(H * scales[2]), (int64_t)(W * scales[3])}, Y);
+  test.Run();
+}
+
 TEST(UpsampleOpTest, UpsampleOp2DBilinearTest) {
   OpTester test("Upsample");
 
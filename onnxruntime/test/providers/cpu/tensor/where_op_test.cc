@@ -109,5 +109,26 @@ TEST(WhereOpTest, Broadcast) {
   WhereBroadcastTest<std::string>("true", "false");
 }
 
+TEST(WhereOpTest, BroadcastLarge) {
+  // the condition is broadcast on the columns, X on the rows and Y is a scalar, with rows long enough to be split
+  // into several blocks
+  const int64_t columns = 5000;
+  auto condition = {true, false, true};  // std::initializer_list<bool> for OpTester::AddInput<bool>()
+  std::vector<int64_t> X(columns);
+  for (int64_t column = 0; column < columns; ++column) X[column] = column;
+  std::vector<int64_t> result;
+  result.reserve(3 * columns);
+  for (bool row_condition : condition)
+    for (int64_t column = 0; column < columns; ++column)
+      result.push_back(row_condition ? X[column] : -1);
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<bool>("condition", {3, 1}, condition);
+  test.AddInput<int64_t>("X", {1, columns}, X);
+  test.AddInput<int64_t>("Y", {}, {-1});
+  test.AddOutput<int64_t>("output", {3, columns}, result);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
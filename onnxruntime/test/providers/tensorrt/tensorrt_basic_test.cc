@@ -7,6 +7,8 @@
 #include "gtest/gtest.h"
 #include "core/providers/tensorrt/tensorrt_execution_provider.h"
 
+#include <thread>
+
 using namespace std;
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::logging;
@@ -102,5 +104,139 @@ TEST(TensorrtExecutionProviderTest, FunctionTest) {
   ASSERT_TRUE(status.IsOK());
   VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
 }
+
+// Runs a model of a single Add of two (1, 4) float inputs on TensorRT, concurrent_runs times at the same time.
+static void RunAddModel(const TensorrtExecutionProviderInfo& epi, const std::string& model_file_name,
+                        int concurrent_runs = 1) {
+  onnxruntime::Model model("graph_add");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& input_arg_1 = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_arg_2 = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg_1, &input_arg_2}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  ASSERT_TRUE(onnxruntime::Model::Save(model, model_file_name).IsOK());
+
+  std::vector<int64_t> dims = {1, 4};
+  std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestTensorrtExecutionProvider()->GetAllocator(0, OrtMemTypeCPU), dims, values, &ml_value_x);
+  OrtValue ml_value_y;
+  CreateMLValue<float>(TestTensorrtExecutionProvider()->GetAllocator(0, OrtMemTypeCPU), dims, values, &ml_value_y);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+  feeds.insert(std::make_pair("Y", ml_value_y));
+  std::vector<std::string> output_names = {"M"};
+
+  SessionOptions so;
+  so.session_logid = "TensorrtExecutionProviderTest." + model_file_name;
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  InferenceSession session_object{so};
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<::onnxruntime::TensorrtExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto run = [&]() {
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session_object.Run(run_options, feeds, output_names, &fetches).IsOK());
+    VerifyOutputs(fetches, dims, {2.0f, 4.0f, 6.0f, 8.0f});
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < concurrent_runs; ++i) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(TensorrtExecutionProviderTest, EngineCacheTest) {
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.engine_cache_path = ORT_TSTR(".");
+
+  // the first session builds and caches the engine, the second one loads it
+  RunAddModel(epi, "trt_execution_provider_engine_cache_test_graph.onnx");
+  RunAddModel(epi, "trt_execution_provider_engine_cache_test_graph.onnx");
+}
+
+TEST(TensorrtExecutionProviderTest, Fp16Test) {
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.fp16_enable = true;
+
+  // the sums are exact in float16
+  RunAddModel(epi, "trt_execution_provider_fp16_test_graph.onnx");
+}
+
+TEST(TensorrtExecutionProviderTest, ConcurrentRunTest) {
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+
+  // the runs enqueue the engine on contexts of their own
+  RunAddModel(epi, "trt_execution_provider_concurrent_run_test_graph.onnx", 4);
+}
+
+TEST(TensorrtExecutionProviderTest, DynamicShapeTest) {
+  onnxruntime::Model model("graph_dynamic");
+  auto& graph = model.MainGraph();
+
+  // the second dim isn't fixed
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("n");
+
+  auto& input_arg_1 = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& input_arg_2 = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("M", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg_1, &input_arg_2}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::string model_file_name = "trt_execution_provider_dynamic_shape_test_graph.onnx";
+  ASSERT_TRUE(onnxruntime::Model::Save(model, model_file_name).IsOK());
+
+  SessionOptions so;
+  so.session_logid = "TensorrtExecutionProviderTest.DynamicShapeTest";
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  InferenceSession session_object{so};
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<::onnxruntime::TensorrtExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // an engine is built for each shape, and reused when it comes back
+  for (int64_t n : {4, 2, 4}) {
+    std::vector<int64_t> dims = {1, n};
+    std::vector<float> values(n);
+    std::vector<float> expected_values(n);
+    for (int64_t i = 0; i < n; ++i) {
+      values[i] = static_cast<float>(i + 1);
+      expected_values[i] = 2 * values[i];
+    }
+    OrtValue ml_value_x;
+    CreateMLValue<float>(TestTensorrtExecutionProvider()->GetAllocator(0, OrtMemTypeCPU), dims, values, &ml_value_x);
+    OrtValue ml_value_y;
+    CreateMLValue<float>(TestTensorrtExecutionProvider()->GetAllocator(0, OrtMemTypeCPU), dims, values, &ml_value_y);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value_x));
+    feeds.insert(std::make_pair("Y", ml_value_y));
+
+    std::vector<OrtValue> fetches;
+    ASSERT_TRUE(session_object.Run(run_options, feeds, {"M"}, &fetches).IsOK());
+    VerifyOutputs(fetches, dims, expected_values);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
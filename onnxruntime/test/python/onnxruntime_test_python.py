@@ -2,6 +2,7 @@
 # Licensed under the MIT License.
 
 # -*- coding: UTF-8 -*-
+import asyncio
 import unittest
 import os
 import numpy as np
@@ -93,6 +94,114 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelArrayLayouts(self):
+        # Contiguous inputs are used in place and the others are copied. The outputs stay valid after the session is
+        # gone and don't share memory with the inputs.
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        inputs = [x,
+                  np.asfortranarray(x),
+                  np.array([[1.0, 9.0, 2.0], [3.0, 9.0, 4.0], [5.0, 9.0, 6.0]], dtype=np.float32)[:, ::2],
+                  x.astype(np.dtype(np.float32).newbyteorder())]
+        results = [sess.run([], {"X": i})[0] for i in inputs]
+        del sess
+        for res in results:
+            self.assertFalse(np.shares_memory(res, x))
+            np.testing.assert_allclose(
+                output_expected, res, rtol=1e-05, atol=1e-08)
+
+    def testWarmup(self):
+        so = onnxrt.SessionOptions()
+        so.warmup_input_shapes = [{"X": [3, 2]}]
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"), sess_options=so)
+        self.assertEqual(so.warmup_input_shapes, [{"X": [3, 2]}])
+        sess.warmup([{}])
+        with self.assertRaises(RuntimeError):
+            sess.warmup([{"W": [3, 2]}])
+
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run(["Y"], {"X": x})
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(
+            output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunModelAsync(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        async def run_concurrently():
+            return await asyncio.gather(*[sess.run_async(["Y"], {"X": x * (i + 1)}) for i in range(4)])
+
+        loop = asyncio.new_event_loop()
+        try:
+            results = loop.run_until_complete(run_concurrently())
+            for i, res in enumerate(results):
+                np.testing.assert_allclose(
+                    output_expected * (i + 1) * (i + 1), res[0], rtol=1e-05, atol=1e-08)
+
+            # a failed run raises when it's awaited
+            with self.assertRaises(RuntimeError):
+                loop.run_until_complete(sess.run_async(["Y"], {"X": x.astype(np.int64)}))
+        finally:
+            loop.close()
+
+    def testRunModelWithIOBinding(self):
+        sess = onnxrt.InferenceSession(self.get_name("matmul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        io_binding = sess.io_binding()
+        io_binding.bind_input("X", x)
+        io_binding.bind_output("Y")
+        sess.run_with_iobinding(io_binding)
+        res = io_binding.copy_outputs_to_cpu()
+        output_expected = np.array([[5.0], [11.0], [17.0]], dtype=np.float32)
+        np.testing.assert_allclose(
+            output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunModelWithOrtValues(self):
+        sess = onnxrt.InferenceSession(self.get_name("matmul_1.onnx"))
+        x = onnxrt.OrtValue.ortvalue_from_numpy(np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32))
+        self.assertEqual(x.shape(), [3, 2])
+        self.assertEqual(x.element_type(), np.float32)
+        self.assertEqual(x.device_name(), "cpu")
+        output_expected = np.array([[5.0], [11.0], [17.0]], dtype=np.float32)
+
+        res = sess.run_with_ortvalues(["Y"], {"X": x})
+        self.assertIsInstance(res[0], onnxrt.OrtValue)
+        np.testing.assert_allclose(
+            output_expected, res[0].numpy(), rtol=1e-05, atol=1e-08)
+
+        io_binding = sess.io_binding()
+        io_binding.bind_ortvalue_input("X", x)
+        io_binding.bind_output("Y")
+        sess.run_with_iobinding(io_binding)
+        np.testing.assert_allclose(
+            output_expected, io_binding.get_outputs()[0].numpy(), rtol=1e-05, atol=1e-08)
+
+    def testOrtValueDlpack(self):
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ortvalue = onnxrt.OrtValue.ortvalue_from_numpy(x)
+        self.assertEqual(ortvalue.__dlpack_device__(), (1, 0))
+        self.assertFalse(hasattr(ortvalue, "__cuda_array_interface__"))
+
+        # the capsule shares the buffer and keeps it alive after the OrtValue is gone
+        capsule = ortvalue.to_dlpack()
+        del ortvalue
+        roundtrip = onnxrt.OrtValue.from_dlpack(capsule)
+        np.testing.assert_array_equal(x, roundtrip.numpy())
+        with self.assertRaises(RuntimeError):
+            onnxrt.OrtValue.from_dlpack(capsule)
+
+        sess = onnxrt.InferenceSession(self.get_name("matmul_1.onnx"))
+        res = sess.run_with_ortvalues(["Y"], {"X": roundtrip})
+        if hasattr(np, "from_dlpack"):
+            np.testing.assert_allclose(
+                np.array([[5.0], [11.0], [17.0]], dtype=np.float32), np.from_dlpack(res[0]), rtol=1e-05, atol=1e-08)
+
     def testRunModelMultipleThreads(self):
         so = onnxrt.SessionOptions()
         so.log_verbosity_level = 1
@@ -132,6 +241,24 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunMany(self):
+        # dimension 0 of X and Y is symbolic, so the feeds are run as one batch
+        sess = onnxrt.InferenceSession(self.get_name("matmul_2.onnx"))
+        x1 = np.array([[1.0, 2.0]], dtype=np.float32)
+        x2 = np.array([[3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run_many(["Y"], [{"X": x1}, {"X": x2}])
+        self.assertEqual(len(res), 2)
+        np.testing.assert_allclose(np.array([[5.0]], dtype=np.float32), res[0][0], rtol=1e-05, atol=1e-08)
+        np.testing.assert_allclose(np.array([[11.0], [17.0]], dtype=np.float32), res[1][0], rtol=1e-05, atol=1e-08)
+        self.assertEqual(sess.run_many(["Y"], []), [])
+
+        # dimension 0 of X is fixed, so the feeds are run one by one
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run_many(["Y"], [{"X": x}, {"X": 2 * x}])
+        np.testing.assert_allclose(x * x, res[0][0], rtol=1e-05, atol=1e-08)
+        np.testing.assert_allclose(4 * x * x, res[1][0], rtol=1e-05, atol=1e-08)
+
     def testBooleanInputs(self):
         sess = onnxrt.InferenceSession(self.get_name("logicaland.onnx"))
         a = np.array([[True, True], [False, False]], dtype=np.bool)
@@ -4,7 +4,7 @@
 # -*- coding: UTF-8 -*-
 import numpy as np
 import onnx
-from onnx import numpy_helper
+from onnx import helper, numpy_helper
 import onnxruntime as onnxrt
 import os
 from rnn_benchmark import perf_test, generate_model
@@ -81,6 +81,46 @@ class TestNuphar(unittest.TestCase):
         sess.run([], feed)
 
 
+    def test_schedule_tuning(self):
+        # a small elementwise graph with constant shapes, so Nuphar can time candidate schedules
+        shape = [4, 16, 64]
+        model = helper.make_model(helper.make_graph(
+            [helper.make_node('Add', ['A', 'B'], ['C']),
+             helper.make_node('Tanh', ['C'], ['D']),
+             helper.make_node('Mul', ['D', 'B'], ['Y'])],
+            'tuning',
+            [helper.make_tensor_value_info('A', onnx.TensorProto.FLOAT, shape),
+             helper.make_tensor_value_info('B', onnx.TensorProto.FLOAT, shape)],
+            [helper.make_tensor_value_info('Y', onnx.TensorProto.FLOAT, shape)]))
+        model_name = 'nuphar_tuning.onnx'
+        onnx.save(model, model_name)
+
+        tuning_log = os.path.join(os.getcwd(), 'nuphar_tuning.log')
+        if os.path.exists(tuning_log):
+            os.remove(tuning_log)
+
+        feed = {'A': np.random.rand(*shape).astype(np.float32),
+                'B': np.random.rand(*shape).astype(np.float32)}
+        expected = np.tanh(feed['A'] + feed['B']) * feed['B']
+
+        onnxrt.capi._pybind_state.set_nuphar_settings('nuphar_tuning:on, nuphar_tuning_repeat:2, nuphar_tuning_log:{}'.format(tuning_log))
+        sess = onnxrt.InferenceSession(model_name) # tuning happens when initializing session
+        np.testing.assert_allclose(sess.run([], feed)[0], expected, rtol=1e-5, atol=1e-6)
+
+        with open(tuning_log) as f:
+            records = [line.split() for line in f if line.strip()]
+        assert len(records) > 0
+        assert all(len(record) == 3 for record in records)
+
+        # the tuned schedules are picked up from the log without tuning again
+        onnxrt.capi._pybind_state.set_nuphar_settings('nuphar_tuning_log:{}'.format(tuning_log))
+        sess = onnxrt.InferenceSession(model_name)
+        np.testing.assert_allclose(sess.run([], feed)[0], expected, rtol=1e-5, atol=1e-6)
+        with open(tuning_log) as f:
+            assert len([line for line in f if line.strip()]) == len(records)
+
+        onnxrt.capi._pybind_state.set_nuphar_settings('')
+
     def test_rnn_benchmark(self):
         # make sure benchmarking scripts works
         # note: quantized model requires AVX2, otherwise it might be slow
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/admission.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+namespace protobufutil = google::protobuf::util;
+
+static const auto kNoDeadline = std::chrono::steady_clock::time_point::max();
+
+static void WaitForQueueDepth(const AdmissionController& controller, size_t depth) {
+  while (controller.QueueDepth() != depth) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(AdmissionTests, QueuedRequestsAreAdmittedByPriority) {
+  AdmissionOptions options;
+  options.max_concurrent_runs = 1;
+  options.max_queued_requests = 4;
+  AdmissionController controller(options);
+
+  std::mutex mutex;
+  std::vector<RequestPriority> admitted;
+  auto admit = [&](RequestPriority priority) {
+    return std::async(std::launch::async, [&, priority]() {
+      AdmissionController::Slot slot;
+      auto status = controller.Admit(priority, kNoDeadline, slot);
+      std::lock_guard<std::mutex> lock(mutex);
+      admitted.push_back(priority);
+      return status;
+    });
+  };
+
+  std::future<protobufutil::Status> low, high;
+  {
+    AdmissionController::Slot slot;
+    EXPECT_EQ(protobufutil::error::OK, controller.Admit(RequestPriority::Normal, kNoDeadline, slot).error_code());
+
+    low = admit(RequestPriority::Low);
+    WaitForQueueDepth(controller, 1);
+    high = admit(RequestPriority::High);
+    WaitForQueueDepth(controller, 2);
+  }
+
+  EXPECT_EQ(protobufutil::error::OK, low.get().error_code());
+  EXPECT_EQ(protobufutil::error::OK, high.get().error_code());
+  EXPECT_EQ(admitted, std::vector<RequestPriority>({RequestPriority::High, RequestPriority::Low}));
+}
+
+TEST(AdmissionTests, FullQueueRejectsLowerPriorities) {
+  AdmissionOptions options;
+  options.max_concurrent_runs = 1;
+  options.max_queued_requests = 1;
+  AdmissionController controller(options);
+
+  auto admit = [&](RequestPriority priority) {
+    return std::async(std::launch::async, [&, priority]() {
+      AdmissionController::Slot slot;
+      return controller.Admit(priority, kNoDeadline, slot);
+    });
+  };
+
+  std::future<protobufutil::Status> normal, high;
+  {
+    AdmissionController::Slot slot;
+    EXPECT_EQ(protobufutil::error::OK, controller.Admit(RequestPriority::Normal, kNoDeadline, slot).error_code());
+
+    normal = admit(RequestPriority::Normal);
+    WaitForQueueDepth(controller, 1);
+
+    // nothing queued has a lower priority to make room
+    AdmissionController::Slot rejected;
+    EXPECT_EQ(protobufutil::error::RESOURCE_EXHAUSTED,
+              controller.Admit(RequestPriority::Low, kNoDeadline, rejected).error_code());
+
+    // the queued request makes room for a higher priority one
+    high = admit(RequestPriority::High);
+    EXPECT_EQ(protobufutil::error::RESOURCE_EXHAUSTED, normal.get().error_code());
+    WaitForQueueDepth(controller, 1);
+  }
+
+  EXPECT_EQ(protobufutil::error::OK, high.get().error_code());
+  EXPECT_EQ(controller.QueueDepth(), 0u);
+}
+
+TEST(AdmissionTests, DeadlinePassesWhileQueued) {
+  AdmissionOptions options;
+  options.max_concurrent_runs = 1;
+  AdmissionController controller(options);
+
+  AdmissionController::Slot slot;
+  EXPECT_EQ(protobufutil::error::OK, controller.Admit(RequestPriority::Normal, kNoDeadline, slot).error_code());
+
+  AdmissionController::Slot expired;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+  EXPECT_EQ(protobufutil::error::DEADLINE_EXCEEDED,
+            controller.Admit(RequestPriority::High, deadline, expired).error_code());
+  EXPECT_EQ(controller.QueueDepth(), 0u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <fstream>
+#include <future>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "onnx-ml.pb.h"
+#include "server/batcher.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// Writes a model computing Y = X + X for X of shape [N, M], so it accepts a batch of any size.
+static void WriteAddModel(const std::string& model_file) {
+  onnx::ModelProto model;
+  model.set_ir_version(onnx::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(9);
+
+  auto* graph = model.mutable_graph();
+  graph->set_name("add");
+  auto* node = graph->add_node();
+  node->set_op_type("Add");
+  node->add_input("X");
+  node->add_input("X");
+  node->add_output("Y");
+
+  auto set_value_info = [](onnx::ValueInfoProto* value_info, const char* name) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(onnx::TensorProto_DataType_FLOAT);
+    tensor_type->mutable_shape()->add_dim()->set_dim_param("N");
+    tensor_type->mutable_shape()->add_dim()->set_dim_param("M");
+  };
+  set_value_info(graph->add_input(), "X");
+  set_value_info(graph->add_output(), "Y");
+
+  std::ofstream out(model_file, std::ios::binary);
+  model.SerializeToOstream(&out);
+}
+
+// Runs X through the batcher on another thread and returns Y.
+static std::future<std::vector<float>> RunAsync(RequestBatcher& batcher, const Ort::RunOptions& run_options,
+                                               std::vector<float>& x, std::vector<int64_t> shape) {
+  return std::async(std::launch::async, [&batcher, &run_options, &x, shape]() {
+    auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), shape.data(), shape.size()));
+    const std::vector<std::string> output_names{"Y"};
+
+    auto outputs = batcher.Run(run_options, {"X"}, std::move(inputs), output_names);
+    auto y_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+    EXPECT_EQ(y_shape[0], shape[0]);
+    const float* y = outputs[0].GetTensorMutableData<float>();
+    return std::vector<float>(y, y + outputs[0].GetTensorTypeAndShapeInfo().GetElementCount());
+  });
+}
+
+TEST(BatcherTests, ConcurrentRequestsAreBatched) {
+  const std::string model_file = "batcher_test_add.onnx";
+  WriteAddModel(model_file);
+
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel(model_file);
+
+  BatchingOptions options;
+  options.max_batch_size = 3;
+  // long enough for both requests to be queued, the batch runs as soon as it's full
+  options.max_queue_delay = std::chrono::seconds(10);
+  RequestBatcher batcher(env->GetSession(), options);
+
+  Ort::RunOptions run_options;
+  std::vector<float> x1{1.f, 2.f};
+  std::vector<float> x2{3.f, 4.f, 5.f, 6.f};
+  auto y1 = RunAsync(batcher, run_options, x1, {1, 2});
+  auto y2 = RunAsync(batcher, run_options, x2, {2, 2});
+
+  EXPECT_EQ(y1.get(), std::vector<float>({2.f, 4.f}));
+  EXPECT_EQ(y2.get(), std::vector<float>({6.f, 8.f, 10.f, 12.f}));
+  EXPECT_EQ(batcher.NumBatchedRuns(), 1u);
+}
+
+TEST(BatcherTests, VariableLengthRequestsArePadded) {
+  const std::string model_file = "batcher_test_add.onnx";
+  WriteAddModel(model_file);
+
+  ServerEnvironment* env = ServerEnv();
+  env->InitializeModel(model_file);
+
+  BatchingOptions options;
+  options.max_batch_size = 2;
+  options.max_queue_delay = std::chrono::seconds(10);
+  options.pad_variable_length_inputs = true;
+  RequestBatcher batcher(env->GetSession(), options);
+
+  Ort::RunOptions run_options;
+  std::vector<float> x1{1.f, 2.f};
+  std::vector<float> x2{3.f, 4.f, 5.f};
+  auto y1 = RunAsync(batcher, run_options, x1, {1, 2});
+  auto y2 = RunAsync(batcher, run_options, x2, {1, 3});
+
+  // the outputs keep the padded length
+  EXPECT_EQ(y1.get(), std::vector<float>({2.f, 4.f, 0.f}));
+  EXPECT_EQ(y2.get(), std::vector<float>({6.f, 8.f, 10.f}));
+  EXPECT_EQ(batcher.NumBatchedRuns(), 1u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -1094,6 +1094,33 @@ TEST(MLValueToTensorProtoTests, DoubleToInt64Data) {
   }
 }
 
+TEST(TensorProtoToMLValueTests, RawDataIsBorrowed) {
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  onnx::TensorProto tp;
+  tp.set_raw_data(values_mul_x.data(), values_mul_x.size() * sizeof(float));
+  for (auto const& dim : dims_mul_x) {
+    tp.add_dims(dim);
+  }
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Ort::Value ml_value{nullptr};
+  Ort::AllocatorWithDefaultOptions allocator;
+  ASSERT_TRUE(onnxruntime::server::TryWrapRawData(tp, *allocator.GetInfo(), ml_value));
+
+  // the tensor uses the storage of the TensorProto
+  EXPECT_EQ(static_cast<const void*>(ml_value.GetTensorMutableData<float>()),
+            static_cast<const void*>(tp.raw_data().data()));
+  EXPECT_EQ(ml_value.GetTensorTypeAndShapeInfo().GetShape(), dims_mul_x);
+
+  // raw_data that doesn't match the size of the tensor has to be copied
+  onnx::TensorProto tp_short = tp;
+  tp_short.set_raw_data(values_mul_x.data(), 4 * sizeof(float));
+  Ort::Value ml_value_short{nullptr};
+  EXPECT_FALSE(onnxruntime::server::TryWrapRawData(tp_short, *allocator.GetInfo(), ml_value_short));
+}
+
 void CreateMLValueBool(AllocatorPtr alloc, const std::vector<int64_t>& dims, const bool* value, Ort::Value& p_value) {
   TensorShape shape(dims);
   OrtValue* p_mlvalue = new OrtValue{};
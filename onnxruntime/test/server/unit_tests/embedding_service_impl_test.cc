@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "server/grpc/embedding_service_impl.h"
+#include "test_server_environment.h"
+#include <grpcpp/impl/grpc_library.h>
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+namespace test {
+static ::grpc::internal::GrpcLibraryInitializer g_initializer;
+
+// The test environment, holding rows 2 to 4 of table "embeddings", row r being {r, -r}.
+static std::shared_ptr<ServerEnvironment> GetEnvironment() {
+  auto* env = onnxruntime::server::test::ServerEnv();
+  if (env->GetEmbeddingShard("embeddings") == nullptr) {
+    env->AddEmbeddingShard(std::make_unique<EmbeddingShard>("embeddings", 2, 2,
+                                                            std::vector<float>{2.f, -2.f, 3.f, -3.f, 4.f, -4.f}));
+  }
+  return std::shared_ptr<ServerEnvironment>(env, [](ServerEnvironment*) {});
+}
+
+TEST(EmbeddingServiceImplTests, LookupRows) {
+  EmbeddingServiceImpl service{GetEnvironment()};
+  LookupRowsRequest request;
+  request.set_table("embeddings");
+  request.add_rows(4);
+  request.add_rows(2);
+  LookupRowsResponse response;
+  ::grpc::ServerContext context;
+  auto status = service.LookupRows(&context, &request, &response);
+  ASSERT_TRUE(status.ok());
+
+  const auto& values = response.values();
+  EXPECT_EQ(values.data_type(), onnx::TensorProto_DataType_FLOAT);
+  ASSERT_EQ(values.dims_size(), 2);
+  EXPECT_EQ(values.dims(0), 2);
+  EXPECT_EQ(values.dims(1), 2);
+  std::vector<float> rows(4);
+  ASSERT_EQ(values.raw_data().size(), rows.size() * sizeof(float));
+  std::memcpy(rows.data(), values.raw_data().data(), values.raw_data().size());
+  EXPECT_EQ(rows, std::vector<float>({4.f, -4.f, 2.f, -2.f}));
+}
+
+TEST(EmbeddingServiceImplTests, UnknownTableOrRow) {
+  EmbeddingServiceImpl service{GetEnvironment()};
+  LookupRowsRequest request;
+  request.set_table("other");
+  request.add_rows(2);
+  LookupRowsResponse response;
+  ::grpc::ServerContext context;
+  EXPECT_EQ(service.LookupRows(&context, &request, &response).error_code(), ::grpc::StatusCode::NOT_FOUND);
+
+  request.set_table("embeddings");
+  request.add_rows(5);
+  EXPECT_EQ(service.LookupRows(&context, &request, &response).error_code(), ::grpc::StatusCode::OUT_OF_RANGE);
+}
+
+}  // namespace test
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
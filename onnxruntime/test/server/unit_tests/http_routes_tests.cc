@@ -77,6 +77,17 @@ TEST(HttpRouteTests, PostRouteInvalidMethodTest) {
   run_route(predict_regex, http::verb::post, actions, false);
 }
 
+TEST(HttpRouteTests, GetRouteWithoutCapturesTest) {
+  auto metrics_regex = R"(/metrics)";
+
+  std::vector<test_data> actions{
+      std::make_tuple(http::verb::get, "/metrics", "", "", "", http::status::ok),
+      std::make_tuple(http::verb::get, "/metrics/foo", "", "", "", http::status::not_found),
+      std::make_tuple(http::verb::post, "/metrics", "", "", "", http::status::method_not_allowed)};
+
+  run_route(metrics_regex, http::verb::get, actions, true);
+}
+
 void run_route(const std::string& pattern, http::verb method, const std::vector<test_data>& data, bool does_validate_data) {
   Routes routes;
   EXPECT_TRUE(routes.RegisterController(method, pattern, do_something));
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+
+#include "server/metrics.h"
+#include "server/model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(MetricsTests, HistogramBucketsAreCumulative) {
+  Histogram histogram({1, 2, 4});
+  histogram.Observe(1);
+  histogram.Observe(3);
+  histogram.Observe(3);
+  histogram.Observe(8);
+
+  std::string out;
+  histogram.Render("size", "model=\"m\"", out);
+  EXPECT_EQ(out,
+            "size_bucket{model=\"m\",le=\"1\"} 1\n"
+            "size_bucket{model=\"m\",le=\"2\"} 1\n"
+            "size_bucket{model=\"m\",le=\"4\"} 3\n"
+            "size_bucket{model=\"m\",le=\"+Inf\"} 4\n"
+            "size_sum{model=\"m\"} 15\n"
+            "size_count{model=\"m\"} 4\n");
+}
+
+TEST(MetricsTests, RenderModelMetrics) {
+  ServerMetrics metrics;
+  auto& model_metrics = metrics.GetModelMetrics("a\"b", "1");
+  EXPECT_EQ(&model_metrics, &metrics.GetModelMetrics("a\"b", "1"));
+  model_metrics.requests += 3;
+  ++model_metrics.failures;
+  model_metrics.ObservePhase(RequestPhase::Run, std::chrono::milliseconds(20));
+
+  auto& repository = ServerEnv()->GetModelRepository();
+  repository.LoadModel("metrics_test", "2", "testdata/mul_1.onnx");
+  auto out = metrics.Render({repository.GetModel("metrics_test", "2")});
+  repository.UnloadModel("metrics_test", "2");
+
+  // the label values are escaped
+  EXPECT_NE(out.find("onnxruntime_server_requests_total{model=\"a\\\"b\",version=\"1\"} 3\n"), std::string::npos);
+  EXPECT_NE(out.find("onnxruntime_server_request_failures_total{model=\"a\\\"b\",version=\"1\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("onnxruntime_server_request_phase_seconds_bucket{model=\"a\\\"b\",version=\"1\",phase=\"run\","
+                     "le=\"0.025\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("onnxruntime_server_request_phase_seconds_count{model=\"a\\\"b\",version=\"1\",phase=\"decode\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("# TYPE onnxruntime_server_batch_size histogram\n"), std::string::npos);
+  EXPECT_NE(out.find("onnxruntime_server_queued_requests{model=\"metrics_test\",version=\"2\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("onnxruntime_server_arena_bytes_in_use{model=\"metrics_test\",version=\"2\"} "),
+            std::string::npos);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
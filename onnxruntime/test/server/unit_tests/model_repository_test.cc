@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+
+#include "server/model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// Runs Y = X * X with the model of testdata/mul_1.onnx.
+static std::vector<float> RunMul(Ort::Session& session, std::vector<float> x) {
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  std::vector<int64_t> shape{static_cast<int64_t>(x.size()) / 2, 2};
+  auto input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), shape.data(), shape.size());
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  auto outputs = session.Run(Ort::RunOptions{}, &input_name, &input, 1, &output_name, 1);
+  const float* y = outputs[0].GetTensorMutableData<float>();
+  return std::vector<float>(y, y + x.size());
+}
+
+TEST(ModelRepositoryTests, VersionsAreHotSwapped) {
+  const std::string model_file = "testdata/mul_1.onnx";
+  const std::string name = "repository_test";
+  auto& repository = ServerEnv()->GetModelRepository();
+
+  repository.LoadModel(name, "1", model_file);
+  repository.LoadModel(name, "10", model_file);
+  repository.LoadModel(name, "9", model_file);
+
+  // the latest version is the largest number
+  EXPECT_EQ(repository.GetModel(name, "")->version, "10");
+  EXPECT_EQ(repository.GetModel(name, "9")->version, "9");
+  EXPECT_EQ(repository.GetModel(name, "2"), nullptr);
+  EXPECT_EQ(repository.GetModel("not_loaded", ""), nullptr);
+
+  // a request still running on a replaced version keeps it alive
+  auto in_flight = repository.GetModel(name, "1");
+  repository.LoadModel(name, "1", model_file);
+  auto reloaded = repository.GetModel(name, "1");
+  EXPECT_NE(reloaded, in_flight);
+  EXPECT_EQ(reloaded->output_names, std::vector<std::string>({"Y"}));
+  EXPECT_EQ(RunMul(in_flight->replicas.front()->session, {1.f, 2.f}), std::vector<float>({1.f, 4.f}));
+  EXPECT_EQ(RunMul(reloaded->replicas.front()->session, {3.f, 4.f}), std::vector<float>({9.f, 16.f}));
+
+  // a version that fails to load leaves the one being served in place
+  EXPECT_THROW(repository.LoadModel(name, "9", "does/not/exist"), Ort::Exception);
+  EXPECT_NE(repository.GetModel(name, "9"), nullptr);
+
+  EXPECT_TRUE(repository.UnloadModel(name, "10"));
+  EXPECT_EQ(repository.GetModel(name, "")->version, "9");
+  EXPECT_TRUE(repository.UnloadModel(name, "9"));
+  EXPECT_TRUE(repository.UnloadModel(name, "1"));
+  EXPECT_FALSE(repository.UnloadModel(name, "1"));
+  EXPECT_EQ(repository.GetModel(name, ""), nullptr);
+}
+
+TEST(ModelRepositoryTests, ParseReplicaDevice) {
+  ReplicaDevice device;
+  EXPECT_TRUE(ParseReplicaDevice("cpu", device));
+  EXPECT_EQ(device.kind, ReplicaDevice::Kind::Cpu);
+  EXPECT_EQ(device.numa_node, -1);
+  EXPECT_TRUE(ParseReplicaDevice("cpu:1", device));
+  EXPECT_EQ(device.kind, ReplicaDevice::Kind::Cpu);
+  EXPECT_EQ(device.numa_node, 1);
+  EXPECT_EQ(device.ToString(), "cpu:1");
+  EXPECT_TRUE(ParseReplicaDevice("cuda:3", device));
+  EXPECT_EQ(device.kind, ReplicaDevice::Kind::Cuda);
+  EXPECT_EQ(device.device_id, 3);
+  EXPECT_EQ(device.numa_node, -1);
+  EXPECT_EQ(device.ToString(), "cuda:3");
+
+  EXPECT_FALSE(ParseReplicaDevice("gpu", device));
+  EXPECT_FALSE(ParseReplicaDevice("cuda:", device));
+  EXPECT_FALSE(ParseReplicaDevice("cuda:-1", device));
+  EXPECT_FALSE(ParseReplicaDevice("cuda:99999", device));
+  EXPECT_FALSE(ParseReplicaDevice("cpu:", device));
+  EXPECT_FALSE(ParseReplicaDevice("cpu:x", device));
+}
+
+TEST(ModelRepositoryTests, CpuReplicasCanBePinnedToANumaNode) {
+  const std::string name = "numa_replica_test";
+  auto& repository = ServerEnv()->GetModelRepository();
+  ReplicaDevice numa_node_0;
+  numa_node_0.numa_node = 0;
+  repository.SetReplicaDevices({ReplicaDevice{}, numa_node_0});
+  repository.LoadModel(name, "1", "testdata/mul_1.onnx");
+  repository.SetReplicaDevices({ReplicaDevice{}});
+
+  auto model = repository.GetModel(name, "1");
+  ASSERT_EQ(model->replicas.size(), 2u);
+  EXPECT_EQ(model->replicas[1]->device.ToString(), "cpu:0");
+
+  // the pinned replica has its own weights and thread pools, and computes the same outputs as the shared one
+  for (const auto& replica : model->replicas) {
+    EXPECT_EQ(RunMul(replica->session, {2.f, 3.f}), std::vector<float>({4.f, 9.f}));
+  }
+
+  EXPECT_TRUE(repository.UnloadModel(name, "1"));
+}
+
+TEST(ModelRepositoryTests, RequestsGoToTheLeastLoadedReplica) {
+  const std::string name = "replica_test";
+  auto& repository = ServerEnv()->GetModelRepository();
+  repository.SetReplicaDevices({ReplicaDevice{}, ReplicaDevice{}, ReplicaDevice{}});
+  repository.LoadModel(name, "1", "testdata/mul_1.onnx");
+  repository.SetReplicaDevices({ReplicaDevice{}});
+
+  auto model = repository.GetModel(name, "1");
+  ASSERT_EQ(model->replicas.size(), 3u);
+
+  // each request in flight makes its replica busier than the idle ones
+  ReplicaLease first(model->LeastLoadedReplica());
+  ReplicaLease second(model->LeastLoadedReplica());
+  ReplicaLease third(model->LeastLoadedReplica());
+  for (const auto& replica : model->replicas) {
+    EXPECT_EQ(replica->in_flight, 1u);
+  }
+  {
+    ReplicaLease fourth(model->LeastLoadedReplica());
+    EXPECT_EQ(fourth.replica().in_flight, 2u);
+  }
+  // a request that is done no longer counts
+  for (const auto& replica : model->replicas) {
+    EXPECT_EQ(replica->in_flight, 1u);
+  }
+
+  // the replicas are sessions of the same model
+  for (const auto& replica : model->replicas) {
+    EXPECT_EQ(RunMul(replica->session, {2.f, 3.f}), std::vector<float>({4.f, 9.f}));
+  }
+
+  EXPECT_TRUE(repository.UnloadModel(name, "1"));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -113,6 +113,63 @@ TEST(PredictionServiceImplTests, InvalidInputClientID) {
   EXPECT_FALSE(status.ok());
 }
 
+// A stream that reads the given requests and keeps the responses written to it.
+class FakePredictStream : public ::grpc::ServerReaderWriterInterface<PredictResponse, PredictRequest> {
+ public:
+  explicit FakePredictStream(std::vector<PredictRequest> requests) : requests_(std::move(requests)) {}
+
+  void SendInitialMetadata() override {}
+
+  bool NextMessageSize(uint32_t* sz) override {
+    if (next_ == requests_.size()) {
+      return false;
+    }
+    *sz = static_cast<uint32_t>(requests_[next_].ByteSizeLong());
+    return true;
+  }
+
+  bool Read(PredictRequest* msg) override {
+    if (next_ == requests_.size()) {
+      return false;
+    }
+    *msg = requests_[next_++];
+    return true;
+  }
+
+  bool Write(const PredictResponse& msg, ::grpc::WriteOptions /*options*/) override {
+    responses.push_back(msg);
+    return true;
+  }
+
+  std::vector<PredictResponse> responses;
+
+ private:
+  std::vector<PredictRequest> requests_;
+  size_t next_ = 0;
+};
+
+TEST(PredictionServiceImplTests, StreamResponsesAreInOrder) {
+  auto env = GetEnvironment();
+  env->InitializeModel("testdata/mul_1.onnx");
+  PredictionServiceImpl test{env};
+
+  std::vector<PredictRequest> requests;
+  for (int i = 0; i < 100; ++i) {
+    auto request = GetRequest();
+    (*request.mutable_inputs())["X"].set_float_data(0, static_cast<float>(i));
+    requests.push_back(std::move(request));
+  }
+
+  FakePredictStream stream{requests};
+  ::grpc::ServerContext context;
+  auto status = test.ProcessPredictStream(&context, &stream);
+  EXPECT_TRUE(status.ok());
+  ASSERT_EQ(stream.responses.size(), requests.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(stream.responses[i].outputs().at("Y").float_data(0), static_cast<float>(i * i));
+  }
+}
+
 }  // namespace test
 }  // namespace grpc
 }  // namespace server
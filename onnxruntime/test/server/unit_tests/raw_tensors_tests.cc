@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <google/protobuf/stubs/status.h>
+
+#include "gtest/gtest.h"
+
+#include "server/serializing/raw_tensors.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+namespace protobufutil = google::protobuf::util;
+
+TEST(RawTensorsTests, RoundTrip) {
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  std::vector<float> x{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  std::vector<int64_t> x_shape{2, 3};
+  std::vector<int8_t> mask{1, 0, 1};
+  std::vector<int64_t> mask_shape{3};
+  std::vector<std::string> names{"X", "mask"};
+  std::vector<Ort::Value> values;
+  values.push_back(Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), x_shape.data(), x_shape.size()));
+  values.push_back(Ort::Value::CreateTensor<int8_t>(memory_info, mask.data(), mask.size(), mask_shape.data(),
+                                                    mask_shape.size()));
+
+  std::string payload;
+  auto status = WriteRawTensors(names, values, payload);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  MemBufferArray buffers;
+  std::vector<std::string> parsed_names;
+  std::vector<Ort::Value> parsed_values;
+  status = ParseRawTensors(payload, *memory_info, buffers, parsed_names, parsed_values);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+  ASSERT_EQ(parsed_names, names);
+
+  auto x_info = parsed_values[0].GetTensorTypeAndShapeInfo();
+  EXPECT_EQ(x_info.GetElementType(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+  EXPECT_EQ(x_info.GetShape(), x_shape);
+  const float* x_data = parsed_values[0].GetTensorMutableData<float>();
+  EXPECT_EQ(std::vector<float>(x_data, x_data + x.size()), x);
+  // the data is borrowed from the payload
+  EXPECT_GE(reinterpret_cast<const char*>(x_data), payload.data());
+  EXPECT_LT(reinterpret_cast<const char*>(x_data), payload.data() + payload.size());
+
+  auto mask_info = parsed_values[1].GetTensorTypeAndShapeInfo();
+  EXPECT_EQ(mask_info.GetElementType(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8);
+  const int8_t* mask_data = parsed_values[1].GetTensorMutableData<int8_t>();
+  EXPECT_EQ(std::vector<int8_t>(mask_data, mask_data + mask.size()), mask);
+}
+
+TEST(RawTensorsTests, InvalidPayloads) {
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  std::vector<float> x{1.f, 2.f};
+  std::vector<int64_t> x_shape{2};
+  std::vector<std::string> names{"X"};
+  std::vector<Ort::Value> values;
+  values.push_back(Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), x_shape.data(), x_shape.size()));
+  std::string payload;
+  WriteRawTensors(names, values, payload);
+
+  auto parse = [&memory_info](const std::string& invalid_payload) {
+    MemBufferArray buffers;
+    std::vector<std::string> parsed_names;
+    std::vector<Ort::Value> parsed_values;
+    return ParseRawTensors(invalid_payload, *memory_info, buffers, parsed_names, parsed_values).error_code();
+  };
+
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, parse("JSON"));
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, parse(payload.substr(0, payload.size() - 1)));
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, parse(payload + '\0'));
+
+  // STRING tensors have no fixed size
+  std::string string_payload = payload;
+  int32_t string_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING;
+  memcpy(&string_payload[4 + 4 + 4 + names[0].size()], &string_type, sizeof(string_type));
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, parse(string_payload));
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/embedding_shard.h"
+#include "server/remote_embedding.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// Row r of the test tables is {r, r + 0.5}.
+static std::vector<float> MakeRows(int64_t first_row, int64_t row_count) {
+  std::vector<float> values;
+  for (int64_t r = first_row; r < first_row + row_count; ++r) {
+    values.push_back(static_cast<float>(r));
+    values.push_back(static_cast<float>(r) + 0.5f);
+  }
+  return values;
+}
+
+// Fetches from in-memory shards, counting the fetches and the rows fetched.
+struct FakeShards {
+  std::atomic<size_t> fetches{0};
+  std::atomic<size_t> rows_fetched{0};
+  std::atomic<bool> fail{false};
+
+  EmbeddingRowFetcherFactory Factory() {
+    return [this](const RemoteEmbeddingShard& shard) -> EmbeddingRowFetcher {
+      auto rows = std::make_shared<EmbeddingShard>("table", shard.first_row, 2,
+                                                   MakeRows(shard.first_row, shard.row_count));
+      return [this, rows](const std::string& table, const std::vector<int64_t>& indices, std::vector<float>& values) {
+        EXPECT_EQ(table, "table");
+        if (fail) {
+          throw Ort::Exception("The shard is down", ORT_FAIL);
+        }
+        ++fetches;
+        rows_fetched += indices.size();
+        values.clear();
+        for (auto index : indices) {
+          const float* row = rows->Row(index);
+          ASSERT_NE(row, nullptr);
+          values.insert(values.end(), row, row + 2);
+        }
+      };
+    };
+  }
+};
+
+static RemoteEmbeddingTableOptions MakeOptions(size_t cache_rows) {
+  RemoteEmbeddingTableOptions options;
+  options.name = "table";
+  options.row_size = 2;
+  // listed out of order
+  options.shards = {{"shard1:50051", 4, 6}, {"shard0:50051", 0, 4}};
+  options.cache_rows = cache_rows;
+  return options;
+}
+
+TEST(RemoteEmbeddingTests, RowCacheEvictsTheLeastRecentlyUsedRows) {
+  EmbeddingRowCache cache(2, 2);
+  const auto rows = MakeRows(0, 3);
+  cache.Insert(0, &rows[0]);
+  cache.Insert(1, &rows[2]);
+
+  float values[2];
+  EXPECT_TRUE(cache.Lookup(0, values));
+  EXPECT_EQ(values[1], 0.5f);
+
+  // 1 is the least recently used row
+  cache.Insert(2, &rows[4]);
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_FALSE(cache.Lookup(1, values));
+  EXPECT_TRUE(cache.Lookup(0, values));
+  EXPECT_TRUE(cache.Lookup(2, values));
+  EXPECT_EQ(values[0], 2.f);
+}
+
+TEST(RemoteEmbeddingTests, LookupGathersTheRowsOfAllTheShards) {
+  FakeShards shards;
+  RemoteEmbeddingTable table(MakeOptions(0), shards.Factory());
+  EXPECT_EQ(table.RowCount(), 10);
+
+  const std::vector<int64_t> indices{9, 0, 3, 4, 3, -1};
+  std::vector<float> values(indices.size() * 2);
+  table.Lookup(indices.data(), indices.size(), values.data());
+  EXPECT_EQ(values, std::vector<float>({9.f, 9.5f, 0.f, 0.5f, 3.f, 3.5f, 4.f, 4.5f, 3.f, 3.5f, 9.f, 9.5f}));
+
+  // one fetch per shard, each row fetched once
+  EXPECT_EQ(shards.fetches, 2u);
+  EXPECT_EQ(shards.rows_fetched, 4u);
+}
+
+TEST(RemoteEmbeddingTests, CachedRowsAreNotFetchedAgain) {
+  FakeShards shards;
+  RemoteEmbeddingTable table(MakeOptions(4), shards.Factory());
+
+  const std::vector<int64_t> indices{1, 5};
+  std::vector<float> values(4);
+  table.Lookup(indices.data(), indices.size(), values.data());
+  EXPECT_EQ(shards.rows_fetched, 2u);
+
+  const std::vector<int64_t> more_indices{5, 1, 2};
+  values.resize(6);
+  table.Lookup(more_indices.data(), more_indices.size(), values.data());
+  EXPECT_EQ(values, std::vector<float>({5.f, 5.5f, 1.f, 1.5f, 2.f, 2.5f}));
+  EXPECT_EQ(shards.rows_fetched, 3u);
+}
+
+TEST(RemoteEmbeddingTests, InvalidLookupsThrow) {
+  FakeShards shards;
+  RemoteEmbeddingTable table(MakeOptions(0), shards.Factory());
+
+  std::vector<float> values(2);
+  const int64_t out_of_range = 10;
+  EXPECT_THROW(table.Lookup(&out_of_range, 1, values.data()), Ort::Exception);
+
+  shards.fail = true;
+  const int64_t index = 0;
+  EXPECT_THROW(table.Lookup(&index, 1, values.data()), Ort::Exception);
+
+  // the table still serves lookups after a failed fetch
+  shards.fail = false;
+  table.Lookup(&index, 1, values.data());
+  EXPECT_EQ(values, std::vector<float>({0.f, 0.5f}));
+}
+
+TEST(RemoteEmbeddingTests, ShardsMustHoldAllTheRows) {
+  FakeShards shards;
+  auto options = MakeOptions(0);
+  options.shards[0].first_row = 5;
+  EXPECT_THROW(RemoteEmbeddingTable(options, shards.Factory()), Ort::Exception);
+}
+
+TEST(RemoteEmbeddingTests, ConcurrentLookups) {
+  FakeShards shards;
+  auto options = MakeOptions(3);
+  options.max_batch_rows = 8;
+  RemoteEmbeddingTable table(options, shards.Factory());
+
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&table, &mismatches, t]() {
+      for (int i = 0; i < 50; ++i) {
+        const std::vector<int64_t> indices{(t + i) % 10, (t * i) % 10, 9 - t};
+        std::vector<float> values(indices.size() * 2);
+        table.Lookup(indices.data(), indices.size(), values.data());
+        for (size_t k = 0; k < indices.size(); ++k) {
+          if (values[2 * k] != static_cast<float>(indices[k]) || values[2 * k + 1] != indices[k] + 0.5f) {
+            ++mismatches;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/response_cache.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+static std::vector<Ort::Value> MakeTensors(std::vector<float>& data) {
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  std::vector<int64_t> shape{static_cast<int64_t>(data.size())};
+  std::vector<Ort::Value> values;
+  values.push_back(Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size()));
+  return values;
+}
+
+static std::string MakeKey(std::vector<float> x) {
+  std::string key;
+  EXPECT_TRUE(ResponseCache::MakeKey({"X"}, MakeTensors(x), {"Y"}, key));
+  return key;
+}
+
+TEST(ResponseCacheTests, KeysMatchTheInputs) {
+  EXPECT_EQ(MakeKey({1.f, 2.f}), MakeKey({1.f, 2.f}));
+  EXPECT_NE(MakeKey({1.f, 2.f}), MakeKey({1.f, 3.f}));
+  EXPECT_NE(MakeKey({1.f, 2.f}), MakeKey({1.f, 2.f, 0.f}));
+
+  std::vector<float> x{1.f, 2.f};
+  std::string key_y, key_z;
+  EXPECT_TRUE(ResponseCache::MakeKey({"X"}, MakeTensors(x), {"Y"}, key_y));
+  EXPECT_TRUE(ResponseCache::MakeKey({"X"}, MakeTensors(x), {"Z"}, key_z));
+  EXPECT_NE(key_y, key_z);
+}
+
+TEST(ResponseCacheTests, LookupReturnsCopiesOfTheOutputs) {
+  ResponseCacheOptions options;
+  options.max_bytes = 1 << 20;
+  ResponseCache cache(options);
+
+  const auto key = MakeKey({1.f, 2.f});
+  std::vector<Ort::Value> outputs;
+  EXPECT_FALSE(cache.Lookup(key, outputs));
+
+  std::vector<float> y{2.f, 4.f};
+  auto y_values = MakeTensors(y);
+  cache.Insert(key, y_values);
+  y[0] = 0.f;
+
+  ASSERT_TRUE(cache.Lookup(key, outputs));
+  ASSERT_EQ(outputs.size(), 1u);
+  const float* cached = outputs[0].GetTensorMutableData<float>();
+  EXPECT_EQ(std::vector<float>(cached, cached + 2), std::vector<float>({2.f, 4.f}));
+}
+
+TEST(ResponseCacheTests, LeastRecentlyUsedEntriesAreEvicted) {
+  const auto key1 = MakeKey({1.f});
+  const auto key2 = MakeKey({2.f});
+  const auto key3 = MakeKey({3.f});
+  std::vector<float> y{0.f, 0.f, 0.f, 0.f};
+  auto y_values = MakeTensors(y);
+
+  // room for two entries
+  ResponseCacheOptions options;
+  options.max_bytes = 2 * (key1.size() + y.size() * sizeof(float) + sizeof(int64_t));
+  ResponseCache cache(options);
+  cache.Insert(key1, y_values);
+  cache.Insert(key2, y_values);
+  EXPECT_EQ(cache.SizeInBytes(), options.max_bytes);
+
+  std::vector<Ort::Value> outputs;
+  EXPECT_TRUE(cache.Lookup(key1, outputs));
+  cache.Insert(key3, y_values);
+  EXPECT_TRUE(cache.Lookup(key1, outputs));
+  EXPECT_FALSE(cache.Lookup(key2, outputs));
+  EXPECT_TRUE(cache.Lookup(key3, outputs));
+}
+
+TEST(ResponseCacheTests, EntriesExpire) {
+  ResponseCacheOptions options;
+  options.max_bytes = 1 << 20;
+  options.ttl = std::chrono::milliseconds(1);
+  ResponseCache cache(options);
+
+  const auto key = MakeKey({1.f});
+  std::vector<float> y{2.f};
+  auto y_values = MakeTensors(y);
+  cache.Insert(key, y_values);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  std::vector<Ort::Value> outputs;
+  EXPECT_FALSE(cache.Lookup(key, outputs));
+  EXPECT_EQ(cache.SizeInBytes(), 0u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
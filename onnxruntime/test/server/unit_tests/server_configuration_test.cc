@@ -45,6 +45,123 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
+TEST(ConfigParsingTests, BatchingArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("8"),
+      const_cast<char*>("--max_queue_delay_us"), const_cast<char*>("500"),
+      const_cast<char*>("--pad_batch_inputs")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(8, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 8);
+  EXPECT_EQ(config.max_queue_delay_us, 500);
+  EXPECT_TRUE(config.pad_batch_inputs);
+
+  char* invalid_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration invalid_config{};
+  res = invalid_config.ParseInput(5, invalid_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, AdmissionArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_concurrent_runs"), const_cast<char*>("4"),
+      const_cast<char*>("--max_queued_requests"), const_cast<char*>("16")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_concurrent_runs, 4);
+  EXPECT_EQ(config.max_queued_requests, 16);
+  EXPECT_EQ(config.response_cache_mb, 0);
+
+  char* invalid_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_queued_requests"), const_cast<char*>("-1")};
+
+  onnxruntime::server::ServerConfiguration invalid_config{};
+  res = invalid_config.ParseInput(5, invalid_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, ResponseCacheArgs) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--response_cache_mb"), const_cast<char*>("64"),
+      const_cast<char*>("--response_cache_ttl_ms"), const_cast<char*>("1000")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.response_cache_mb, 64);
+  EXPECT_EQ(config.response_cache_ttl_ms, 1000);
+}
+
+TEST(ConfigParsingTests, ReplicaDevices) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--replica_device"), const_cast<char*>("cuda:0"),
+      const_cast<char*>("--replica_device"), const_cast<char*>("cuda:1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  ASSERT_EQ(config.replica_devices.size(), 2u);
+  EXPECT_EQ(config.replica_devices[1].kind, onnxruntime::server::ReplicaDevice::Kind::Cuda);
+  EXPECT_EQ(config.replica_devices[1].device_id, 1);
+
+  char* bad_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--replica_device"), const_cast<char*>("gpu0")};
+
+  onnxruntime::server::ServerConfiguration bad_config{};
+  EXPECT_EQ(bad_config.ParseInput(5, bad_argv), Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, AdditionalModels) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--default_model_name"), const_cast<char*>("mul"),
+      const_cast<char*>("--additional_model"), const_cast<char*>("mul:2:testdata/mul_1.onnx"),
+      const_cast<char*>("--additional_model"), const_cast<char*>("other:1:testdata/mul_1.onnx"),
+      const_cast<char*>("--enable_model_control")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(10, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.model_name, "mul");
+  EXPECT_EQ(config.model_version, "1");
+  ASSERT_EQ(config.additional_models.size(), 2u);
+  EXPECT_EQ(config.additional_models[0].name, "mul");
+  EXPECT_EQ(config.additional_models[0].version, "2");
+  EXPECT_EQ(config.additional_models[0].path, "testdata/mul_1.onnx");
+  EXPECT_EQ(config.additional_models[1].name, "other");
+  EXPECT_TRUE(config.enable_model_control);
+
+  char* invalid_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--additional_model"), const_cast<char*>("mul:latest:testdata/mul_1.onnx")};
+
+  onnxruntime::server::ServerConfiguration invalid_config{};
+  res = invalid_config.ParseInput(5, invalid_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, Help) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
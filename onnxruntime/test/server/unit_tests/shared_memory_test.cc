@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/shared_memory.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+// A shared memory object of a client, mapped by the test like by the client.
+class SharedMemoryObject {
+ public:
+  explicit SharedMemoryObject(size_t byte_size)
+      : key_("/ort_server_test_" + std::to_string(getpid())), byte_size_(byte_size) {
+    const int fd = shm_open(key_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    EXPECT_NE(fd, -1);
+    EXPECT_EQ(ftruncate(fd, static_cast<off_t>(byte_size_)), 0);
+    data_ = mmap(nullptr, byte_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    EXPECT_NE(data_, MAP_FAILED);
+    close(fd);
+  }
+
+  ~SharedMemoryObject() {
+    munmap(data_, byte_size_);
+    shm_unlink(key_.c_str());
+  }
+
+  const std::string& Key() const { return key_; }
+  float* Floats(size_t offset) { return reinterpret_cast<float*>(static_cast<char*>(data_) + offset); }
+
+ private:
+  const std::string key_;
+  const size_t byte_size_;
+  void* data_ = nullptr;
+};
+
+static SharedMemoryTensor MakeTensor(const std::string& region, uint64_t offset, std::vector<int64_t> dims) {
+  SharedMemoryTensor tensor;
+  tensor.set_region(region);
+  tensor.set_offset(offset);
+  tensor.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+  }
+  return tensor;
+}
+
+TEST(SharedMemoryTests, RegionsShareTheMemoryOfTheClient) {
+  SharedMemoryObject object(4096);
+  SharedMemoryRegistry registry;
+  registry.Register("region", object.Key(), 1024, 1024);
+  auto region = registry.Get("region");
+  ASSERT_NE(region, nullptr);
+  EXPECT_EQ(region->ByteSize(), 1024u);
+
+  object.Floats(1024 + 8)[0] = 3.f;
+  EXPECT_EQ(static_cast<float*>(region->Data(8, 4))[0], 3.f);
+  static_cast<float*>(region->Data(16, 4))[0] = 5.f;
+  EXPECT_EQ(object.Floats(1024 + 16)[0], 5.f);
+
+  // out of the region
+  EXPECT_EQ(region->Data(1024, 1), nullptr);
+  EXPECT_EQ(region->Data(1020, 8), nullptr);
+  EXPECT_NE(region->Data(1020, 4), nullptr);
+}
+
+TEST(SharedMemoryTests, InvalidRegistrationsThrow) {
+  SharedMemoryObject object(4096);
+  SharedMemoryRegistry registry;
+  EXPECT_THROW(registry.Register("region", "/ort_server_test_missing", 0, 16), Ort::Exception);
+  EXPECT_THROW(registry.Register("region", object.Key(), 4000, 100), Ort::Exception);
+  EXPECT_THROW(registry.Register("region", object.Key(), 0, 0), Ort::Exception);
+
+  registry.Register("region", object.Key(), 0, 4096);
+  EXPECT_THROW(registry.Register("region", object.Key(), 0, 16), Ort::Exception);
+}
+
+TEST(SharedMemoryTests, UnregisteredRegionsStayMappedWhileInUse) {
+  SharedMemoryObject object(4096);
+  SharedMemoryRegistry registry;
+  registry.Register("region", object.Key(), 0, 4096);
+  auto region = registry.Get("region");
+
+  EXPECT_TRUE(registry.Unregister("region"));
+  EXPECT_FALSE(registry.Unregister("region"));
+  EXPECT_EQ(registry.Get("region"), nullptr);
+
+  object.Floats(0)[0] = 7.f;
+  EXPECT_EQ(static_cast<float*>(region->Data(0, 4))[0], 7.f);
+}
+
+TEST(SharedMemoryTests, PredictReadsAndWritesSharedMemory) {
+  SharedMemoryObject object(4096);
+  auto* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx");
+  env->GetSharedMemory().Register("predict_region", object.Key(), 0, 4096);
+
+  for (int i = 0; i < 6; ++i) {
+    object.Floats(0)[i] = static_cast<float>(i + 1);
+  }
+
+  Executor executor(env, "RequestId");
+  PredictRequest request;
+  PredictResponse response;
+  (*request.mutable_shared_memory_inputs())["X"] = MakeTensor("predict_region", 0, {3, 2});
+  (*request.mutable_shared_memory_outputs())["Y"] = MakeTensor("predict_region", 64, {3, 2});
+  auto status = executor.Predict("", "", request, response);
+  EXPECT_TRUE(status.ok()) << status.error_message();
+
+  // written to the region instead of the response
+  EXPECT_EQ(response.outputs_size(), 0);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(object.Floats(64)[i], static_cast<float>((i + 1) * (i + 1)));
+  }
+
+  env->GetSharedMemory().Unregister("predict_region");
+}
+
+TEST(SharedMemoryTests, PredictRejectsInvalidSharedMemoryTensors) {
+  SharedMemoryObject object(4096);
+  auto* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx");
+  env->GetSharedMemory().Register("invalid_region", object.Key(), 0, 64);
+
+  const std::vector<SharedMemoryTensor> invalid_tensors{
+      MakeTensor("missing_region", 0, {3, 2}),   // not registered
+      MakeTensor("invalid_region", 48, {3, 2}),  // out of the region
+      MakeTensor("invalid_region", 2, {3, 2}),   // misaligned
+      MakeTensor("invalid_region", 0, {-3, 2})};
+  for (const auto& tensor : invalid_tensors) {
+    Executor executor(env, "RequestId");
+    PredictRequest request;
+    PredictResponse response;
+    (*request.mutable_shared_memory_inputs())["X"] = tensor;
+    auto status = executor.Predict("", "", request, response);
+    EXPECT_EQ(status.error_code(), google::protobuf::util::error::Code::INVALID_ARGUMENT);
+  }
+
+  env->GetSharedMemory().Unregister("invalid_region");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
+
+#endif  // _WIN32
@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/http/json_handling.h"
+#include "server/tracing.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+class RecordingSpanExporter : public SpanExporter {
+ public:
+  void Export(TraceSpan span) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.push_back(std::move(span));
+  }
+
+  std::vector<TraceSpan> TakeSpans() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(spans_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<TraceSpan> spans_;
+};
+
+// Tracing is enabled once for the environment shared by the tests, whose tracer can't be replaced while the sessions
+// of its models report to it.
+static RecordingSpanExporter& EnableTracing() {
+  static RecordingSpanExporter* exporter = []() {
+    auto recording_exporter = std::make_unique<RecordingSpanExporter>();
+    auto* recorder = recording_exporter.get();
+    ServerEnv()->EnableTracing(std::move(recording_exporter));
+    return recorder;
+  }();
+  return *exporter;
+}
+
+static const TraceSpan* FindSpan(const std::vector<TraceSpan>& spans, const std::string& name) {
+  for (const auto& span : spans) {
+    if (span.name == name) {
+      return &span;
+    }
+  }
+  return nullptr;
+}
+
+static std::string FindAttribute(const TraceSpan& span, const std::string& key) {
+  for (const auto& attribute : span.attributes) {
+    if (attribute.first == key) {
+      return attribute.second;
+    }
+  }
+  return {};
+}
+
+TEST(TracingTests, ParseTraceParent) {
+  TraceContext context;
+  EXPECT_TRUE(ParseTraceParent("00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01", context));
+  EXPECT_EQ(context.trace_id, "0af7651916cd43dd8448eb211c80319c");
+  EXPECT_EQ(context.parent_span_id, "b7ad6b7169203331");
+
+  // later versions may have more fields
+  EXPECT_TRUE(ParseTraceParent("01-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01-extra", context));
+
+  const std::vector<std::string> invalid{
+      "",
+      "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331",
+      "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01-extra",
+      "ff-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01",
+      "00-0AF7651916CD43DD8448EB211C80319C-b7ad6b7169203331-01",
+      "00-00000000000000000000000000000000-b7ad6b7169203331-01",
+      "00-0af7651916cd43dd8448eb211c80319c-0000000000000000-01",
+      "00_0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01"};
+  for (const auto& traceparent : invalid) {
+    TraceContext unchanged{"trace", "parent"};
+    EXPECT_FALSE(ParseTraceParent(traceparent, unchanged)) << traceparent;
+    EXPECT_EQ(unchanged.trace_id, "trace");
+  }
+}
+
+TEST(TracingTests, TraceIdFromRequestId) {
+  EXPECT_EQ(TraceIdFromRequestId("72b68108-18a4-493c-ac75-d0abd82f0a11"), "72b6810818a4493cac75d0abd82f0a11");
+
+  // not a UUID
+  const auto trace_id = TraceIdFromRequestId("RequestId");
+  EXPECT_EQ(trace_id.size(), 32u);
+  EXPECT_NE(trace_id, TraceIdFromRequestId("RequestId"));
+  EXPECT_EQ(NewSpanId().size(), 16u);
+}
+
+TEST(TracingTests, OtlpJson) {
+  TraceSpan span;
+  span.trace_id = "0af7651916cd43dd8448eb211c80319c";
+  span.span_id = "b7ad6b7169203331";
+  span.name = "run \"1\"";
+  span.start_time_ns = 1000;
+  span.end_time_ns = 2000;
+  span.error = true;
+  span.status_message = "failed";
+  span.attributes.emplace_back("key", "value");
+
+  EXPECT_EQ(OtlpHttpExporter::ToJson({span}, "service"),
+            R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name","value":{"stringValue":"service"}}]},)"
+            R"("scopeSpans":[{"scope":{"name":"onnxruntime_server"},"spans":[{"traceId":"0af7651916cd43dd8448eb211c80319c",)"
+            R"("spanId":"b7ad6b7169203331","name":"run \"1\"","startTimeUnixNano":"1000","endTimeUnixNano":"2000",)"
+            R"("attributes":[{"key":"key","value":{"stringValue":"value"}}],"status":{"code":2,"message":"failed"}}]}]}]})");
+}
+
+TEST(TracingTests, OtlpExporterDropsSpansWhenTheQueueIsFull) {
+  OtlpExporterOptions options;
+  options.endpoint = "invalid endpoint";
+  EXPECT_THROW(OtlpHttpExporter(options, ServerEnv()->GetAppLogger()), Ort::Exception);
+
+  // nothing listens on the port, so the spans can't be sent either
+  options.endpoint = "127.0.0.1:1";
+  options.max_queued_spans = 1;
+  options.flush_interval = std::chrono::milliseconds(60000);
+  OtlpHttpExporter exporter(options, ServerEnv()->GetAppLogger());
+  exporter.Export(TraceSpan{});
+  exporter.Export(TraceSpan{});
+  EXPECT_GE(exporter.DroppedSpans(), 1u);
+}
+
+TEST(TracingTests, PredictSpansArePartOfTheTraceOfTheCaller) {
+  auto& exporter = EnableTracing();
+  auto* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx");
+  exporter.TakeSpans();
+
+  {
+    Executor executor(env, "RequestId");
+    executor.SetTraceParent("00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01");
+    PredictRequest request;
+    PredictResponse response;
+    ASSERT_TRUE(GetRequestFromJson(R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}}})",
+                                   request)
+                    .ok());
+    ASSERT_TRUE(executor.Predict("", "", request, response).ok());
+  }
+
+  const auto spans = exporter.TakeSpans();
+  for (const auto& span : spans) {
+    EXPECT_EQ(span.trace_id, "0af7651916cd43dd8448eb211c80319c") << span.name;
+    EXPECT_LE(span.start_time_ns, span.end_time_ns) << span.name;
+    EXPECT_FALSE(span.error) << span.name;
+  }
+
+  const auto* request_span = FindSpan(spans, "onnxruntime_server.predict");
+  ASSERT_NE(request_span, nullptr);
+  EXPECT_EQ(request_span->parent_span_id, "b7ad6b7169203331");
+  EXPECT_EQ(FindAttribute(*request_span, "onnxruntime_server.request_id"), "RequestId");
+
+  for (const auto* phase : {"decode", "run", "encode"}) {
+    const auto* phase_span = FindSpan(spans, phase);
+    ASSERT_NE(phase_span, nullptr) << phase;
+    EXPECT_EQ(phase_span->parent_span_id, request_span->span_id) << phase;
+  }
+
+  // the spans of the session are children of the run phase
+  const auto* session_run_span = FindSpan(spans, "onnxruntime.run");
+  ASSERT_NE(session_run_span, nullptr);
+  EXPECT_EQ(session_run_span->parent_span_id, FindSpan(spans, "run")->span_id);
+  const auto* partition_span = FindSpan(spans, "onnxruntime.partition");
+  ASSERT_NE(partition_span, nullptr);
+  EXPECT_EQ(partition_span->parent_span_id, session_run_span->span_id);
+  EXPECT_EQ(FindAttribute(*partition_span, "onnxruntime.provider"), "CPUExecutionProvider");
+  EXPECT_EQ(FindAttribute(*partition_span, "onnxruntime.node_count"), "1");
+}
+
+TEST(TracingTests, RunsOfUntracedTagsAreDropped) {
+  auto& exporter = EnableTracing();
+  auto* env = ServerEnv();
+  env->InitializeModel("testdata/mul_1.onnx");
+  exporter.TakeSpans();
+
+  // a run of the session that isn't for a request
+  std::vector<float> values{1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> shape{3, 2};
+  auto memory_info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  auto input = Ort::Value::CreateTensor<float>(memory_info, values.data(), values.size(), shape.data(), shape.size());
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  Ort::RunOptions run_options;
+  run_options.SetRunTag("untraced");
+  const_cast<Ort::Session&>(env->GetSession()).Run(run_options, &input_name, &input, 1, &output_name, 1);
+
+  EXPECT_TRUE(exporter.TakeSpans().empty());
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -3,11 +3,13 @@
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "providers.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <iostream>
 #include <fstream>
 #include <atomic>
+#include <future>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -218,6 +220,73 @@ TEST_F(CApiTest, custom_op_handler) {
   TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
 }
 
+// Same as MyCustomKernel, computing in parallel on the session thread pool through a scratch buffer
+struct MyParallelCustomKernel {
+  MyParallelCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* /*info*/) : ort_(ort) {
+  }
+
+  void Compute(OrtKernelContext* context) {
+    const OrtValue* input_X = ort_.KernelContext_GetInput(context, 0);
+    const OrtValue* input_Y = ort_.KernelContext_GetInput(context, 1);
+    const float* X = ort_.GetTensorData<float>(input_X);
+    const float* Y = ort_.GetTensorData<float>(input_Y);
+
+    OrtTensorDimensions dimensions(ort_, input_X);
+    OrtValue* output = ort_.KernelContext_GetOutput(context, 0, dimensions.data(), dimensions.size());
+    float* out = ort_.GetTensorMutableData<float>(output);
+
+    OrtTensorTypeAndShapeInfo* output_info = ort_.GetTensorTypeAndShape(output);
+    size_t size = ort_.GetTensorShapeElementCount(output_info);
+    ort_.ReleaseTensorTypeAndShapeInfo(output_info);
+
+    // out may be X, so the sums go through the scratch buffer
+    float* sums = static_cast<float*>(ort_.KernelContext_AllocateScratch(context, size * sizeof(float)));
+    ort_.KernelContext_ParallelFor(context, size, 1.0, [X, Y, sums](size_t first, size_t last) {
+      for (size_t i = first; i < last; i++) {
+        sums[i] = X[i] + Y[i];
+      }
+    });
+    std::copy(sums, sums + size, out);
+    ort_.KernelContext_FreeScratch(context, sums);
+
+    // the CPU execution provider has no stream to enqueue on
+    EXPECT_THROW(ort_.KernelContext_GetGPUResource(context, ORT_GPU_RESOURCE_COMPUTE_STREAM), Ort::Exception);
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+};
+
+struct MyParallelCustomOp : Ort::CustomOpBase<MyParallelCustomOp, MyParallelCustomKernel> {
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyParallelCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  int GetMayInplaceInput(size_t /*output_index*/) const { return 0; }
+};
+
+TEST_F(CApiTest, custom_op_parallel_for_and_scratch) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyParallelCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
+}
+
 #if defined(ENABLE_LANGUAGE_INTEROP_OPS) && !defined(_WIN32)  // on windows, PYTHONHOME must be set explicitly
 TEST_F(CApiTest, test_pyop) {
   std::cout << "Test model with pyop" << std::endl;
@@ -271,6 +340,32 @@ TEST_F(CApiTest, create_tensor) {
   tensor.GetStringTensorContent((void*)result.data(), data_len, offsets.data(), offsets.size());
 }
 
+TEST_F(CApiTest, string_tensor_from_buffer) {
+  const std::string buffer = "abcdefghij";
+  const size_t offsets[] = {0, 3, 3, 7};
+  int64_t expected_len = 4;
+  auto default_allocator = std::make_unique<MockedOrtAllocator>();
+
+  Ort::Value tensor = Ort::Value::CreateTensor(default_allocator.get(), &expected_len, 1, ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING);
+  tensor.FillStringTensor(buffer.data(), buffer.size(), offsets, 4);
+
+  std::vector<const char*> data(expected_len);
+  std::vector<size_t> lengths(expected_len);
+  tensor.GetStringTensorViews(data.data(), lengths.data(), data.size());
+  ASSERT_STREQ(data[0], "abc");
+  ASSERT_STREQ(data[1], "");
+  ASSERT_STREQ(data[2], "defg");
+  ASSERT_STREQ(data[3], "hij");
+  ASSERT_EQ(lengths, (std::vector<size_t>{3, 0, 4, 3}));
+
+  size_t data_len = tensor.GetStringTensorDataLength();
+  std::string result(data_len, '\0');
+  std::vector<size_t> result_offsets(expected_len);
+  tensor.GetStringTensorContent((void*)result.data(), data_len, result_offsets.data(), result_offsets.size());
+  ASSERT_EQ(result, buffer);
+  ASSERT_EQ(result_offsets, (std::vector<size_t>{0, 3, 3, 7}));
+}
+
 TEST_F(CApiTest, create_tensor_with_data) {
   float values[] = {3.0f, 1.0f, 2.f, 0.f};
   constexpr size_t values_length = sizeof(values) / sizeof(values[0]);
@@ -290,6 +385,176 @@ TEST_F(CApiTest, create_tensor_with_data) {
   ASSERT_EQ(1, tensor_info.GetDimensionsCount());
 }
 
+TEST_F(CApiTest, io_binding) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  Ort::AllocatorInfo info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+  const std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // let the run allocate Y on the device described by info
+  Ort::IoBinding binding(session);
+  binding.BindInput("X", x);
+  binding.BindOutput("Y", info);
+  session.Run(Ort::RunOptions{}, binding);
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  ASSERT_EQ(binding.GetOutputCount(), 1u);
+  char* output_name = binding.GetOutputName(0, allocator);
+  ASSERT_STREQ(output_name, "Y");
+  allocator.Free(output_name);
+
+  std::vector<Ort::Value> outputs = binding.GetOutputValues();
+  ASSERT_EQ(outputs.size(), 1u);
+  ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), x_dims);
+  float* y = outputs[0].GetTensorMutableData<float>();
+  for (size_t i = 0; i != expected_values_y.size(); ++i) {
+    ASSERT_EQ(expected_values_y[i], y[i]);
+  }
+
+  // rebind Y to a preallocated buffer and check the run writes into it
+  std::vector<float> y_values(expected_values_y.size());
+  Ort::Value y_bound = Ort::Value::CreateTensor<float>(info, y_values.data(), y_values.size(), x_dims.data(), x_dims.size());
+  binding.ClearOutputs();
+  binding.BindOutput("Y", y_bound);
+  session.Run(Ort::RunOptions{}, binding);
+  ASSERT_EQ(y_values, expected_values_y);
+}
+
+TEST_F(CApiTest, prepared_run) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  Ort::AllocatorInfo info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, 1, output_names, 1);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+  const std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // the first run allocates Y, the second writes into a preallocated buffer
+  Ort::Value y{nullptr};
+  session.Run(Ort::RunOptions{}, prepared_run, &x, &y);
+  ASSERT_EQ(y.GetTensorTypeAndShapeInfo().GetShape(), x_dims);
+  float* y_data = y.GetTensorMutableData<float>();
+  for (size_t i = 0; i != expected_values_y.size(); ++i) {
+    ASSERT_EQ(expected_values_y[i], y_data[i]);
+  }
+
+  std::vector<float> y_values(expected_values_y.size());
+  Ort::Value y_bound = Ort::Value::CreateTensor<float>(info, y_values.data(), y_values.size(), x_dims.data(), x_dims.size());
+  session.Run(Ort::RunOptions{}, prepared_run, &x, &y_bound);
+  ASSERT_EQ(y_values, expected_values_y);
+}
+
+TEST_F(CApiTest, run_async) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  Ort::AllocatorInfo info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+  struct RunResult {
+    std::promise<void> completed;
+    std::vector<float> y_values;
+    bool failed = false;
+  } result;
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::RunOptions run_options;
+  session.RunAsync(run_options, input_names, &x, 1, output_names, 1,
+                   [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+                     auto& result = *static_cast<RunResult*>(user_data);
+                     if (status != nullptr || num_outputs != 1) {
+                       result.failed = true;
+                       OrtReleaseStatus(status);
+                     } else {
+                       Ort::Value y{outputs[0]};
+                       const float* y_data = y.GetTensorMutableData<float>();
+                       result.y_values.assign(y_data, y_data + y.GetTensorTypeAndShapeInfo().GetElementCount());
+                     }
+                     result.completed.set_value();
+                   },
+                   &result);
+  result.completed.get_future().wait();
+
+  ASSERT_FALSE(result.failed);
+  ASSERT_EQ(result.y_values, std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+}
+
+TEST_F(CApiTest, env_allocators) {
+  MockedOrtAllocator allocator;
+  env_.RegisterAllocator(&allocator, false);
+  Ort::AllocatorInfo info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  {
+    // the CPU execution provider of the session allocates Y from the registered allocator
+    Ort::SessionOptions session_options;
+    session_options.EnableEnvAllocators();
+    Ort::Session session(env_, MODEL_URI, session_options);
+    std::vector<Ort::Value> outputs = session.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+    ASSERT_EQ(outputs.size(), 1u);
+    ASSERT_GT(allocator.MemoryInUse(), 0u);
+    const float* y = outputs[0].GetTensorMutableData<float>();
+    ASSERT_EQ(std::vector<float>(y, y + x_values.size()), std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+  }
+  allocator.LeakCheck();
+
+  {
+    // sessions that don't opt in keep their own allocators
+    Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+    std::vector<Ort::Value> outputs = session.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+    ASSERT_EQ(allocator.MemoryInUse(), 0u);
+  }
+
+  // an allocator for the same device can only be registered once
+  ASSERT_THROW(env_.RegisterAllocator(&allocator, true), Ort::Exception);
+}
+
+TEST_F(CApiTest, env_allocators_shared_arena) {
+  MockedOrtAllocator allocator;
+  env_.RegisterAllocator(&allocator, true);
+  Ort::AllocatorInfo info = Ort::AllocatorInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  {
+    Ort::SessionOptions session_options;
+    session_options.EnableEnvAllocators();
+    Ort::Session session1(env_, MODEL_URI, session_options);
+    Ort::Session session2(env_, MODEL_URI, session_options);
+    session1.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+    const size_t arena_bytes = allocator.MemoryInUse();
+    ASSERT_GT(arena_bytes, 0u);
+
+    // the second session reuses the region the first one made the arena allocate
+    std::vector<Ort::Value> outputs = session2.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+    ASSERT_EQ(allocator.MemoryInUse(), arena_bytes);
+    const float* y = outputs[0].GetTensorMutableData<float>();
+    ASSERT_EQ(std::vector<float>(y, y + x_values.size()), std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+  }
+
+  // the arena returns its regions when the environment releases it
+  env_ = Ort::Env(nullptr);
+  allocator.LeakCheck();
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   int ret = RUN_ALL_TESTS();
@@ -15,6 +15,7 @@ struct MockedOrtAllocator : OrtAllocator {
   void Free(void* p);
   const OrtMemoryInfo* Info() const;
 
+  size_t MemoryInUse() const { return memory_inuse.load(); }
   void LeakCheck();
 
  private: